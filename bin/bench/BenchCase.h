@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BIN_BENCH_BENCHCASE_H
+#define __BIN_BENCH_BENCHCASE_H
+
+#include <Macros.h>
+#include "BenchInstance.h"
+
+/**
+ * @addtogroup bin
+ * @{
+ */
+
+/** Function performing a single benchmark iteration. */
+typedef void BenchFunction(void);
+
+/**
+ * Benchmark which runs a plain function without setup or teardown.
+ */
+class LocalBench : public BenchInstance
+{
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param name Benchmark name
+     * @param func Function to run for each iteration
+     */
+    LocalBench(const char *name, BenchFunction func)
+        : BenchInstance(name)
+        , m_func(func)
+    {
+    }
+
+    /**
+     * Run one iteration
+     */
+    virtual void run()
+    {
+        m_func();
+    }
+
+  private:
+
+    /** Function to run */
+    BenchFunction *m_func;
+};
+
+/**
+ * Define and register a function based benchmark.
+ */
+#define BenchCase(name) \
+    void name (void); \
+    LocalBench bench_##name (QUOTE(name), name); \
+    void name (void)
+
+/**
+ * @}
+ */
+
+#endif /* __BIN_BENCH_BENCHCASE_H */
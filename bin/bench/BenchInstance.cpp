@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchSuite.h"
+#include "BenchInstance.h"
+
+BenchInstance::BenchInstance(const char *name, const Size bytes)
+    : m_name(name, true)
+    , m_bytes(bytes)
+{
+    BenchSuite::instance()->addBench(this);
+}
+
+BenchInstance::~BenchInstance()
+{
+}
+
+const String & BenchInstance::getName() const
+{
+    return m_name;
+}
+
+Size BenchInstance::getBytes() const
+{
+    return m_bytes;
+}
+
+bool BenchInstance::setup()
+{
+    return true;
+}
+
+void BenchInstance::teardown()
+{
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BIN_BENCH_BENCHINSTANCE_H
+#define __BIN_BENCH_BENCHINSTANCE_H
+
+#include <Types.h>
+#include <String.h>
+
+/**
+ * @addtogroup bin
+ * @{
+ */
+
+/**
+ * Represents a single named micro-benchmark.
+ *
+ * The benchmark runner calls setup() once, then run() for the configured
+ * number of warmup and measured iterations and finally teardown().
+ * Each call to run() performs exactly one iteration of the measured operation.
+ */
+class BenchInstance
+{
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param name Name of the benchmark
+     * @param bytes Number of bytes processed per iteration or zero if not applicable
+     */
+    BenchInstance(const char *name, const Size bytes = 0);
+
+    /**
+     * Destructor
+     */
+    virtual ~BenchInstance();
+
+    /**
+     * Retrieve benchmark name
+     *
+     * @return Benchmark name
+     */
+    const String & getName() const;
+
+    /**
+     * Retrieve number of bytes processed per iteration
+     *
+     * @return Bytes per iteration or zero if not applicable
+     */
+    Size getBytes() const;
+
+    /**
+     * Prepare resources needed by the benchmark.
+     *
+     * @return True on success, false if the benchmark cannot run
+     */
+    virtual bool setup();
+
+    /**
+     * Perform one iteration of the benchmark.
+     */
+    virtual void run() = 0;
+
+    /**
+     * Release resources allocated in setup().
+     */
+    virtual void teardown();
+
+  protected:
+
+    /** Name of the benchmark */
+    String m_name;
+
+    /** Bytes processed per iteration */
+    const Size m_bytes;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __BIN_BENCH_BENCHINSTANCE_H */
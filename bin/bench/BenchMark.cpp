@@ -18,15 +18,20 @@
 #include <FreeNOS/System.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <fcntl.h>
-#include <unistd.h>
-#include <sys/stat.h>
+#include <string.h>
+#include <ListIterator.h>
+#include "BenchSuite.h"
 #include "BenchMark.h"
 
 BenchMark::BenchMark(int argc, char **argv)
     : POSIXApplication(argc, argv)
 {
     parser().setDescription("Perform system benchmark tests");
+    parser().registerPositional("NAME", "Run only benchmarks starting with the given name(s)", 0);
+    parser().registerFlag('l', "list", "List all available benchmarks");
+    parser().registerFlag('i', "iterations", "Number of measured iterations (default 100)");
+    parser().registerFlag('w', "warmup", "Number of warmup iterations (default 10)");
+    parser().registerFlag('f', "format", "Output format: text, tap or xml (default text)");
 }
 
 BenchMark::~BenchMark()
@@ -35,60 +40,142 @@ BenchMark::~BenchMark()
 
 BenchMark::Result BenchMark::exec()
 {
-    u64 t1 = 0, t2 = 0;
-    ProcessInfo info;
-    Memory::Range range;
-    char *foo[128];
-    struct stat st;
-
-    // Retrieve current process ID with kernel trap
-    t1 = timestamp();
-    ProcessCtl(SELF, GetPID);
-    t2 = timestamp();
-    printf("SystemCall (GetPID) Ticks: %u\r\n", t2 - t1);
-
-    // Retrieve current process information
-    t1 = timestamp();
-    ProcessCtl(SELF, InfoPID, (Address) &info);
-    t2 = timestamp();
-    printf("SystemCall (InfoPID) Ticks: %u\r\n", t2 - t1);
-
-    // Perform task schedule
-    t1 = timestamp();
-    ProcessCtl(SELF, Schedule);
-    t2 = timestamp();
-    printf("SystemCall (Schedule) Ticks: %u\r\n", t2 - t1);
-
-    // Translate virtual memory address to physical memory address
-    range.virt = 0x80000000;
-    range.size = PAGESIZE;    
-    t1 = timestamp();
-    VMCtl(SELF, LookupVirtual, &range);
-    t2 = timestamp();
-    printf("SystemCall (VMCtl) Ticks: %u\r\n", t2 - t1);
-
-    // Perform inter-process communication call
-    t1 = timestamp();
-    stat("/etc", &st);
-    t2 = timestamp();
-    printf("IPC (stat) Ticks: %u\r\n", t2 - t1);
-
-    // Allocate heap memory
-    t1 = timestamp();
-    for (int i = 0; i < 128; i++)
-        foo[i] = new char[16];
-    t2 = timestamp();
-    printf("allocate() Ticks: %u (%u AVG)\r\n",
-            (u32)(t2 - t1), (u32)(t2 - t1) / 128);
-
-    // Release heap memory
-    t1 = timestamp();
-    for (int i = 0; i < 128; i++)
-        delete foo[i];
-    t2 = timestamp();
-    printf("release() Ticks: %u (%u AVG)\r\n",
-            (u32)(t2 - t1), (u32)(t2 - t1) / 128);
-
-    // Done
+    List<BenchInstance *> *benches = BenchSuite::instance()->getBenches();
+    List<BenchInstance *> selected;
+    BenchReporter::Format format = BenchReporter::Text;
+    Size iterations = DefaultIterations;
+    Size warmup = DefaultWarmup;
+
+    // List benchmarks only
+    if (arguments().get("list"))
+    {
+        for (ListIterator<BenchInstance *> i(benches); i.hasCurrent(); i++)
+        {
+            printf("%s\r\n", *i.current()->getName());
+        }
+        return Success;
+    }
+
+    // Parse options
+    if (arguments().get("iterations"))
+    {
+        iterations = atoi(arguments().get("iterations"));
+
+        if (iterations == 0 || iterations > MaximumIterations)
+        {
+            ERROR("number of iterations must be between 1 and " << MaximumIterations);
+            return InvalidArgument;
+        }
+    }
+
+    if (arguments().get("warmup"))
+    {
+        warmup = atoi(arguments().get("warmup"));
+    }
+
+    if (arguments().get("format"))
+    {
+        const char *fmt = arguments().get("format");
+
+        if (strcmp(fmt, "tap") == 0)
+            format = BenchReporter::TAP;
+        else if (strcmp(fmt, "xml") == 0)
+            format = BenchReporter::XML;
+        else if (strcmp(fmt, "text") != 0)
+        {
+            ERROR("unknown output format: " << fmt);
+            return InvalidArgument;
+        }
+    }
+
+    // Collect benchmarks to run
+    for (ListIterator<BenchInstance *> i(benches); i.hasCurrent(); i++)
+    {
+        if (isSelected(*i.current()))
+            selected.append(i.current());
+    }
+
+    if (selected.count() == 0)
+    {
+        ERROR("no matching benchmarks found");
+        return NotFound;
+    }
+
+    BenchReporter reporter(m_argv[0], format);
+    reporter.begin(selected);
+
+    for (ListIterator<BenchInstance *> i(selected); i.hasCurrent(); i++)
+    {
+        BenchResult result;
+        result.iterations = iterations;
+
+        if (runBench(*i.current(), warmup, result))
+            reporter.report(*i.current(), result);
+        else
+            reporter.skip(*i.current());
+    }
+
+    reporter.finish();
     return Success;
 }
+
+bool BenchMark::isSelected(const BenchInstance & bench) const
+{
+    const Vector<Argument *> & positionals = arguments().getPositionals();
+
+    if (positionals.count() == 0)
+        return true;
+
+    for (Size i = 0; i < positionals.count(); i++)
+    {
+        const char *name = *(positionals[i]->getValue());
+
+        if (strncmp(*bench.getName(), name, strlen(name)) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+bool BenchMark::runBench(BenchInstance & bench, const Size warmup, BenchResult & result)
+{
+    if (!bench.setup())
+    {
+        return false;
+    }
+
+    // Warmup caches, TLBs and lazily allocated resources
+    for (Size i = 0; i < warmup; i++)
+    {
+        bench.run();
+    }
+
+    // Time each iteration separately
+    for (Size i = 0; i < result.iterations; i++)
+    {
+        const u64 t1 = timestamp();
+        bench.run();
+        m_samples[i] = timestamp() - t1;
+    }
+
+    bench.teardown();
+
+    // Sort samples for the percentiles
+    for (Size i = 1; i < result.iterations; i++)
+    {
+        const u64 sample = m_samples[i];
+        Size j = i;
+
+        for (; j > 0 && m_samples[j - 1] > sample; j--)
+        {
+            m_samples[j] = m_samples[j - 1];
+        }
+        m_samples[j] = sample;
+    }
+
+    result.minimum = m_samples[0];
+    result.median = m_samples[result.iterations / 2];
+    result.percentile99 = m_samples[((result.iterations - 1) * 99) / 100];
+    result.maximum = m_samples[result.iterations - 1];
+    return true;
+}
@@ -19,6 +19,8 @@
 #define __BIN_BENCH_BENCHMARK_H
 
 #include <POSIXApplication.h>
+#include "BenchInstance.h"
+#include "BenchReporter.h"
 
 /**
  * @addtogroup bin
@@ -27,9 +29,25 @@
 
 /**
  * Perform system benchmarking tests.
+ *
+ * Runs the registered benchmarks from the BenchSuite. Each benchmark
+ * is first executed for a number of warmup iterations, after which each
+ * following iteration is timed individually. The minimum, median,
+ * 99th percentile and maximum ticks are reported.
  */
 class BenchMark : public POSIXApplication
 {
+  private:
+
+    /** Default number of measured iterations. */
+    static const Size DefaultIterations = 100;
+
+    /** Default number of warmup iterations. */
+    static const Size DefaultWarmup = 10;
+
+    /** Maximum number of measured iterations. */
+    static const Size MaximumIterations = 1000;
+
   public:
 
     /**
@@ -51,6 +69,33 @@ class BenchMark : public POSIXApplication
      * @return Result code
      */
     virtual Result exec();
+
+  private:
+
+    /**
+     * Check if a benchmark is selected on the command line.
+     *
+     * @param bench Benchmark to check
+     *
+     * @return True if no names are given or if a given name is a prefix of the benchmark name.
+     */
+    bool isSelected(const BenchInstance & bench) const;
+
+    /**
+     * Run a single benchmark and collect its statistics.
+     *
+     * @param bench Benchmark to run
+     * @param warmup Number of warmup iterations
+     * @param result Receives the measured statistics
+     *
+     * @return True on success, false if the benchmark could not run
+     */
+    bool runBench(BenchInstance & bench, const Size warmup, BenchResult & result);
+
+  private:
+
+    /** Timestamp of each measured iteration */
+    u64 m_samples[MaximumIterations];
 };
 
 /**
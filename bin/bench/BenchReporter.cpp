@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include "BenchReporter.h"
+
+BenchReporter::BenchReporter(const char *name, const Format format)
+    : m_name(name)
+    , m_format(format)
+    , m_count(1)
+{
+}
+
+void BenchReporter::begin(List<BenchInstance *> & benches)
+{
+    switch (m_format)
+    {
+        case TAP:
+            printf("1..%u # Start %s\r\n", benches.count(), m_name);
+            break;
+
+        case XML:
+            printf("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\r\n"
+                   "<benchmarks id=\"%s\" tests=\"%u\">\r\n",
+                    m_name, benches.count());
+            break;
+
+        case Text:
+            break;
+    }
+}
+
+void BenchReporter::report(BenchInstance & bench, const BenchResult & result)
+{
+    switch (m_format)
+    {
+        case Text:
+            printf("%s: min %u median %u p99 %u max %u ticks (%u iterations)",
+                    *bench.getName(), (u32) result.minimum, (u32) result.median,
+                    (u32) result.percentile99, (u32) result.maximum, result.iterations);
+
+            if (bench.getBytes())
+            {
+                printf(", ");
+                printThroughput(bench.getBytes(), result.median);
+                printf(" bytes/tick");
+            }
+            printf("\r\n");
+            break;
+
+        case TAP:
+            printf("ok %u %s # min=%u median=%u p99=%u max=%u iterations=%u",
+                    m_count, *bench.getName(), (u32) result.minimum, (u32) result.median,
+                    (u32) result.percentile99, (u32) result.maximum, result.iterations);
+
+            if (bench.getBytes())
+                printf(" bytes=%u", bench.getBytes());
+            printf("\r\n");
+            break;
+
+        case XML:
+            printf("   <benchmark id=\"%s.%s\" name=\"%s\" iterations=\"%u\" "
+                   "min=\"%u\" median=\"%u\" p99=\"%u\" max=\"%u\" bytes=\"%u\" />\r\n",
+                    m_name, *bench.getName(), *bench.getName(), result.iterations,
+                    (u32) result.minimum, (u32) result.median, (u32) result.percentile99,
+                    (u32) result.maximum, bench.getBytes());
+            break;
+    }
+
+    m_count++;
+}
+
+void BenchReporter::skip(BenchInstance & bench)
+{
+    switch (m_format)
+    {
+        case Text:
+            printf("%s: SKIP\r\n", *bench.getName());
+            break;
+
+        case TAP:
+            printf("ok %u %s # SKIP\r\n", m_count, *bench.getName());
+            break;
+
+        case XML:
+            printf("   <benchmark id=\"%s.%s\" name=\"%s\" skipped=\"true\" />\r\n",
+                    m_name, *bench.getName(), *bench.getName());
+            break;
+    }
+
+    m_count++;
+}
+
+void BenchReporter::finish()
+{
+    if (m_format == XML)
+    {
+        printf("</benchmarks>\r\n");
+    }
+}
+
+void BenchReporter::printThroughput(const Size bytes, const u64 ticks) const
+{
+    const u64 scaled = ticks ? (((u64) bytes * 100) / ticks) : 0;
+    const u32 fraction = (u32) (scaled % 100);
+
+    printf("%u.%u%u", (u32) (scaled / 100), fraction / 10, fraction % 10);
+}
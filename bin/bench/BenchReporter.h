@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BIN_BENCH_BENCHREPORTER_H
+#define __BIN_BENCH_BENCHREPORTER_H
+
+#include <Types.h>
+#include <List.h>
+#include "BenchInstance.h"
+
+/**
+ * @addtogroup bin
+ * @{
+ */
+
+/**
+ * Measured statistics of a single benchmark.
+ */
+typedef struct BenchResult
+{
+    /** Number of measured iterations. */
+    Size iterations;
+
+    /** Fastest iteration in ticks. */
+    u64 minimum;
+
+    /** Median iteration in ticks. */
+    u64 median;
+
+    /** 99th percentile iteration in ticks. */
+    u64 percentile99;
+
+    /** Slowest iteration in ticks. */
+    u64 maximum;
+}
+BenchResult;
+
+/**
+ * Writes benchmark results in human or machine readable form.
+ *
+ * The TAP and XML formats follow the output of the libtest reporters,
+ * such that benchmark runs can be collected and compared by the same tools.
+ */
+class BenchReporter
+{
+  public:
+
+    /**
+     * Output formats.
+     */
+    enum Format
+    {
+        Text,
+        TAP,
+        XML
+    };
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param name Name of the benchmark program
+     * @param format Output format
+     */
+    BenchReporter(const char *name, const Format format);
+
+    /**
+     * Report start of benchmarking.
+     *
+     * @param benches List of benchmarks that will run
+     */
+    void begin(List<BenchInstance *> & benches);
+
+    /**
+     * Report the result of a benchmark.
+     *
+     * @param bench Benchmark which completed
+     * @param result Measured statistics
+     */
+    void report(BenchInstance & bench, const BenchResult & result);
+
+    /**
+     * Report a benchmark which could not run.
+     *
+     * @param bench Benchmark which was skipped
+     */
+    void skip(BenchInstance & bench);
+
+    /**
+     * Report completion of all benchmarks.
+     */
+    void finish();
+
+  private:
+
+    /**
+     * Print throughput as bytes per tick with two decimals.
+     *
+     * @param bytes Bytes processed per iteration
+     * @param ticks Ticks per iteration
+     */
+    void printThroughput(const Size bytes, const u64 ticks) const;
+
+  private:
+
+    /** Name of the benchmark program */
+    const char *m_name;
+
+    /** Output format */
+    const Format m_format;
+
+    /** Number of benchmarks reported so far */
+    Size m_count;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __BIN_BENCH_BENCHREPORTER_H */
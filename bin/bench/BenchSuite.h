@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BIN_BENCH_BENCHSUITE_H
+#define __BIN_BENCH_BENCHSUITE_H
+
+#include <Singleton.h>
+#include <List.h>
+
+class BenchInstance;
+
+/**
+ * @addtogroup bin
+ * @{
+ */
+
+/**
+ * Registry of all benchmarks linked into the program.
+ */
+class BenchSuite : public StrictSingleton<BenchSuite>
+{
+  public:
+
+    /**
+     * Class constructor
+     */
+    BenchSuite();
+
+    /**
+     * Add a benchmark
+     *
+     * @param bench BenchInstance to add
+     */
+    void addBench(BenchInstance *bench);
+
+    /**
+     * Retrieve a list of all benchmarks
+     *
+     * @return List of BenchInstances
+     */
+    List<BenchInstance *> * getBenches();
+
+  private:
+
+    /** List of BenchInstances in the suite */
+    List<BenchInstance *> m_benches;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __BIN_BENCH_BENCHSUITE_H */
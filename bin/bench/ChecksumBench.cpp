@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <InternetChecksum.h>
+#include "BenchInstance.h"
+
+/**
+ * Measures Internet checksum throughput.
+ */
+class ChecksumBench : public BenchInstance
+{
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param name Benchmark name
+     * @param size Number of bytes to checksum per iteration
+     * @param offset Byte offset of the input from a 32-bit aligned address
+     */
+    ChecksumBench(const char *name, const Size size, const Size offset)
+        : BenchInstance(name, size)
+        , m_offset(offset)
+        , m_buffer(ZERO)
+        , m_result(0)
+    {
+    }
+
+    virtual bool setup()
+    {
+        m_buffer = new u8[m_bytes + sizeof(u32)];
+        if (!m_buffer)
+            return false;
+
+        for (Size i = 0; i < m_bytes + sizeof(u32); i++)
+            m_buffer[i] = i * 7;
+
+        return true;
+    }
+
+    virtual void run()
+    {
+        m_result += InternetChecksum::checksum(m_buffer + m_offset, m_bytes);
+    }
+
+    virtual void teardown()
+    {
+        delete[] m_buffer;
+        m_buffer = ZERO;
+    }
+
+  private:
+
+    /** Offset of the input in the buffer */
+    const Size m_offset;
+
+    /** Input buffer */
+    u8 *m_buffer;
+
+    /** Keeps the result alive */
+    volatile u16 m_result;
+};
+
+static ChecksumBench checksumPacket("net_checksum_1500", 1500, 0);
+static ChecksumBench checksumUnaligned("net_checksum_1500_unaligned", 1500, 1);
+static ChecksumBench checksumLarge("net_checksum_64k", 64 * 1024, 0);
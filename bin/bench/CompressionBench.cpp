@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include <Lz4Compressor.h>
+#include <Lz4Decompressor.h>
+#include "BenchInstance.h"
+
+/**
+ * Measures LZ4 decompression throughput.
+ */
+class Lz4Bench : public BenchInstance
+{
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param name Benchmark name
+     * @param size Number of uncompressed bytes per iteration
+     * @param period Length of the repeated pattern in the input data
+     */
+    Lz4Bench(const char *name, const Size size, const Size period)
+        : BenchInstance(name, size)
+        , m_period(period)
+        , m_frame(ZERO)
+        , m_frameSize(0)
+        , m_output(ZERO)
+    {
+    }
+
+    virtual bool setup()
+    {
+        u8 *input = new u8[m_bytes];
+        if (!input)
+            return false;
+
+        // Repeat a pattern, with some variation to mix literals and matches
+        for (Size i = 0; i < m_bytes; i++)
+            input[i] = (i % m_period) + ((i / 4096) & 0x3);
+
+        Lz4Compressor lz4(input, m_bytes);
+        m_frameSize = lz4.getMaximumSize();
+        m_frame = new u8[m_frameSize];
+        m_output = new u8[m_bytes];
+
+        const bool ok = m_frame && m_output &&
+                        lz4.compress(m_frame, m_frameSize) == Lz4Compressor::Success;
+        delete[] input;
+        return ok;
+    }
+
+    virtual void run()
+    {
+        Lz4Decompressor lz4(m_frame, m_frameSize);
+
+        if (lz4.initialize() == Lz4Decompressor::Success)
+            lz4.read(m_output, m_bytes);
+    }
+
+    virtual void teardown()
+    {
+        delete[] m_frame;
+        delete[] m_output;
+        m_frame = ZERO;
+        m_output = ZERO;
+    }
+
+  private:
+
+    /** Length of the repeated input pattern */
+    const Size m_period;
+
+    /** Compressed LZ4 frame */
+    u8 *m_frame;
+
+    /** Size of the compressed frame in bytes */
+    Size m_frameSize;
+
+    /** Decompression output buffer */
+    u8 *m_output;
+};
+
+static Lz4Bench lz4ShortOffset("lz4_decompress_short_256k", 256 * 1024, 3);
+static Lz4Bench lz4LongOffset("lz4_decompress_long_256k", 256 * 1024, 251);
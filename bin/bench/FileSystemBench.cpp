@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include "BenchCase.h"
+
+/**
+ * Measures file read performance for a given read size.
+ *
+ * Each iteration reads from the start of the file.
+ */
+class FileReadBench : public BenchInstance
+{
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param name Benchmark name
+     * @param path File to read from
+     * @param size Number of bytes to read per iteration
+     */
+    FileReadBench(const char *name, const char *path, const Size size)
+        : BenchInstance(name, size)
+        , m_path(path)
+        , m_fd(-1)
+        , m_buffer(ZERO)
+    {
+    }
+
+    virtual bool setup()
+    {
+        m_buffer = new u8[m_bytes];
+        if (!m_buffer)
+            return false;
+
+        m_fd = open(m_path, O_RDONLY);
+        return m_fd >= 0;
+    }
+
+    virtual void run()
+    {
+        lseek(m_fd, 0, SEEK_SET);
+        read(m_fd, m_buffer, m_bytes);
+    }
+
+    virtual void teardown()
+    {
+        if (m_fd >= 0)
+            close(m_fd);
+
+        delete[] m_buffer;
+        m_buffer = ZERO;
+        m_fd = -1;
+    }
+
+  private:
+
+    /** Path of the file to read */
+    const char *m_path;
+
+    /** File descriptor */
+    int m_fd;
+
+    /** Read buffer */
+    u8 *m_buffer;
+};
+
+static FileReadBench read512("fs_read_512", "/bin/bench", 512);
+static FileReadBench read4k("fs_read_4k", "/bin/bench", 4 * 1024);
+static FileReadBench read64k("fs_read_64k", "/bin/bench", 64 * 1024);
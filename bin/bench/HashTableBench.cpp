@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <HashTable.h>
+#include <String.h>
+#include "BenchInstance.h"
+
+/**
+ * Measures HashTable insert, lookup and remove of many keys.
+ */
+class HashTableBench : public BenchInstance
+{
+  public:
+
+    /** Operation performed on all keys per iteration */
+    enum Operation
+    {
+        Insert,
+        Lookup,
+        Remove
+    };
+
+    /**
+     * Constructor
+     *
+     * @param name Benchmark name
+     * @param operation Operation to measure
+     * @param count Number of keys per iteration
+     */
+    HashTableBench(const char *name, const Operation operation, const Size count)
+        : BenchInstance(name)
+        , m_operation(operation)
+        , m_count(count)
+        , m_table(ZERO)
+        , m_result(0)
+    {
+    }
+
+    virtual bool setup()
+    {
+        m_table = new HashTable<int, int>();
+        if (!m_table)
+            return false;
+
+        if (m_operation == Lookup)
+            fill();
+
+        return true;
+    }
+
+    virtual void run()
+    {
+        switch (m_operation)
+        {
+            case Insert:
+                delete m_table;
+                m_table = new HashTable<int, int>();
+                fill();
+                break;
+
+            case Lookup:
+                for (Size i = 0; i < m_count; i++)
+                    m_result += m_table->value(key(i));
+                break;
+
+            case Remove:
+                fill();
+                for (Size i = 0; i < m_count; i++)
+                    m_result += m_table->remove(key(i));
+                break;
+        }
+    }
+
+    virtual void teardown()
+    {
+        delete m_table;
+        m_table = ZERO;
+    }
+
+  private:
+
+    /**
+     * Spread keys over the integer range.
+     */
+    int key(const Size index) const
+    {
+        return (int) (index * 2654435761U);
+    }
+
+    /**
+     * Insert all keys.
+     */
+    void fill()
+    {
+        for (Size i = 0; i < m_count; i++)
+            m_table->insert(key(i), i);
+    }
+
+  private:
+
+    /** Operation to measure */
+    const Operation m_operation;
+
+    /** Number of keys */
+    const Size m_count;
+
+    /** Table under test */
+    HashTable<int, int> *m_table;
+
+    /** Keeps the result alive */
+    volatile int m_result;
+};
+
+/**
+ * Measures lookups of String keys.
+ */
+class HashTableStringBench : public BenchInstance
+{
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param name Benchmark name
+     * @param count Number of keys per iteration
+     */
+    HashTableStringBench(const char *name, const Size count)
+        : BenchInstance(name)
+        , m_count(count)
+        , m_keys(ZERO)
+        , m_result(0)
+    {
+    }
+
+    virtual bool setup()
+    {
+        m_keys = new String[m_count];
+        if (!m_keys)
+            return false;
+
+        for (Size i = 0; i < m_count; i++)
+        {
+            m_keys[i] << "/path/to/file" << (uint) i;
+            m_table.insert(m_keys[i], i);
+        }
+        return true;
+    }
+
+    virtual void run()
+    {
+        for (Size i = 0; i < m_count; i++)
+            m_result += m_table.value(m_keys[i]);
+    }
+
+    virtual void teardown()
+    {
+        m_table.clear();
+        delete[] m_keys;
+        m_keys = ZERO;
+    }
+
+  private:
+
+    /** Number of keys */
+    const Size m_count;
+
+    /** Keys to look up */
+    String *m_keys;
+
+    /** Table under test */
+    HashTable<String, int> m_table;
+
+    /** Keeps the result alive */
+    volatile int m_result;
+};
+
+static HashTableBench hashInsert("std_hashtable_insert_4k", HashTableBench::Insert, 4096);
+static HashTableBench hashLookup("std_hashtable_lookup_4k", HashTableBench::Lookup, 4096);
+static HashTableBench hashRemove("std_hashtable_remove_4k", HashTableBench::Remove, 4096);
+static HashTableStringBench hashString("std_hashtable_lookup_string_1k", 1024);
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include <sys/stat.h>
+#include <MemoryBlock.h>
+#include <MemoryChannel.h>
+#include "BenchCase.h"
+
+/**
+ * Inter-process communication round trip with the root filesystem.
+ */
+BenchCase(ipc_stat)
+{
+    struct stat st;
+    stat("/etc", &st);
+}
+
+/**
+ * Measures MemoryChannel throughput between a local producer and consumer.
+ */
+class MemoryChannelBench : public BenchInstance
+{
+  private:
+
+    /** Size of each message in bytes. */
+    static const Size MessageSize = 64;
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param name Benchmark name
+     * @param batch Number of messages written and read per iteration
+     */
+    MemoryChannelBench(const char *name, const Size batch)
+        : BenchInstance(name, batch * MessageSize)
+        , m_batch(batch)
+        , m_producer(Channel::Producer, MessageSize, true)
+        , m_consumer(Channel::Consumer, MessageSize, true)
+    {
+    }
+
+    virtual bool setup()
+    {
+        MemoryBlock::set(m_pages, 0, sizeof(m_pages));
+        MemoryBlock::set(m_messages, 0, sizeof(m_messages));
+
+        const Address data = (Address) &m_pages[0];
+        const Address feedback = (Address) &m_pages[PAGESIZE];
+
+        return m_producer.setVirtual(data, feedback) == Channel::Success &&
+               m_consumer.setVirtual(data, feedback) == Channel::Success;
+    }
+
+    virtual void run()
+    {
+        Size written = 0;
+
+        if (m_batch == 1)
+            m_producer.write(m_messages);
+        else
+            m_producer.writeBatch(m_messages, m_batch, written);
+
+        for (Size i = 0; i < m_batch; i++)
+        {
+            m_consumer.read(m_messages + (i * MessageSize));
+        }
+    }
+
+  private:
+
+    /** Messages per iteration */
+    const Size m_batch;
+
+    /** Producer side of the channel */
+    MemoryChannel m_producer;
+
+    /** Consumer side of the channel */
+    MemoryChannel m_consumer;
+
+    /** Data and feedback pages */
+    u8 m_pages[PAGESIZE * 2];
+
+    /** Message buffers */
+    u8 m_messages[MessageSize * 16];
+};
+
+static MemoryChannelBench channelSingle("channel_write_read", 1);
+static MemoryChannelBench channelBatch("channel_batch16", 16);
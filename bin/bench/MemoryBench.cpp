@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <MemoryBlock.h>
+#include "BenchCase.h"
+
+/**
+ * Allocate and release a single small object.
+ */
+BenchCase(alloc_single)
+{
+    char *obj = new char[16];
+    delete[] obj;
+}
+
+/**
+ * Allocate a number of small objects and release them in reverse order.
+ */
+BenchCase(alloc_churn)
+{
+    char *objs[32];
+
+    for (Size i = 0; i < 32; i++)
+        objs[i] = new char[16 + (i * 8)];
+
+    for (Size i = 32; i > 0; i--)
+        delete[] objs[i - 1];
+}
+
+/**
+ * Measures memory copy and fill throughput.
+ */
+class MemoryBench : public BenchInstance
+{
+  public:
+
+    /**
+     * Operations to benchmark.
+     */
+    enum Operation
+    {
+        ByteCopy,
+        Copy,
+        Move,
+        Set
+    };
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param name Benchmark name
+     * @param op Operation to benchmark
+     * @param size Number of bytes per iteration
+     */
+    MemoryBench(const char *name, const Operation op, const Size size)
+        : BenchInstance(name, size)
+        , m_operation(op)
+        , m_source(ZERO)
+        , m_destination(ZERO)
+    {
+    }
+
+    virtual bool setup()
+    {
+        m_source = new u8[m_bytes];
+        m_destination = new u8[m_bytes];
+
+        if (!m_source || !m_destination)
+            return false;
+
+        MemoryBlock::set(m_source, 0xaa, m_bytes);
+        return true;
+    }
+
+    virtual void run()
+    {
+        switch (m_operation)
+        {
+            case ByteCopy:
+            {
+                volatile u8 *dst = m_destination;
+                const u8 *src = m_source;
+
+                for (Size i = 0; i < m_bytes; i++)
+                    *dst++ = *src++;
+                break;
+            }
+
+            case Copy:
+                memcpy(m_destination, m_source, m_bytes);
+                break;
+
+            case Move:
+                memmove(m_source + 1, m_source, m_bytes - 1);
+                break;
+
+            case Set:
+                memset(m_destination, 0x55, m_bytes);
+                break;
+        }
+    }
+
+    virtual void teardown()
+    {
+        delete[] m_source;
+        delete[] m_destination;
+        m_source = ZERO;
+        m_destination = ZERO;
+    }
+
+  private:
+
+    /** Operation to benchmark */
+    const Operation m_operation;
+
+    /** Source buffer */
+    u8 *m_source;
+
+    /** Destination buffer */
+    u8 *m_destination;
+};
+
+static MemoryBench byteCopy("mem_bytecopy_64k", MemoryBench::ByteCopy, 64 * 1024);
+static MemoryBench memCopy("mem_memcpy_64k", MemoryBench::Copy, 64 * 1024);
+static MemoryBench memMove("mem_memmove_64k", MemoryBench::Move, 64 * 1024);
+static MemoryBench memSet("mem_memset_64k", MemoryBench::Set, 64 * 1024);
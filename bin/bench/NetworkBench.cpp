@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/socket.h>
+#include <NetworkClient.h>
+#include <IPV4.h>
+#include "BenchCase.h"
+
+/**
+ * Measures UDP round trips via the loopback network device.
+ */
+class UdpLoopbackBench : public BenchInstance
+{
+  private:
+
+    /** Local UDP port to send to and receive from */
+    static const u16 Port = 8088;
+
+    /** Size of each datagram in bytes */
+    static const Size DatagramSize = 64;
+
+  public:
+
+    /**
+     * Constructor
+     */
+    UdpLoopbackBench()
+        : BenchInstance("udp_loopback", DatagramSize)
+        , m_client(ZERO)
+        , m_socket(-1)
+        , m_address(0)
+    {
+    }
+
+    virtual bool setup()
+    {
+        m_client = new NetworkClient("loopback");
+
+        if (m_client->initialize() != NetworkClient::Success ||
+            m_client->createSocket(NetworkClient::UDP, &m_socket) != NetworkClient::Success)
+        {
+            teardown();
+            return false;
+        }
+
+        m_address = IPV4::toAddress("127.0.0.1");
+
+        if (m_client->bindSocket(m_socket, 0, Port) != NetworkClient::Success)
+        {
+            teardown();
+            return false;
+        }
+
+        return true;
+    }
+
+    virtual void run()
+    {
+        struct sockaddr addr;
+        addr.addr = m_address;
+        addr.port = Port;
+
+        ::sendto(m_socket, m_datagram, DatagramSize, 0, &addr, sizeof(addr));
+        ::recvfrom(m_socket, m_datagram, DatagramSize, 0, &addr, sizeof(addr));
+    }
+
+    virtual void teardown()
+    {
+        if (m_client && m_socket >= 0)
+            m_client->close(m_socket);
+
+        delete m_client;
+        m_client = ZERO;
+        m_socket = -1;
+    }
+
+  private:
+
+    /** Client for the loopback device */
+    NetworkClient *m_client;
+
+    /** UDP socket */
+    int m_socket;
+
+    /** Loopback IPV4 address */
+    IPV4::Address m_address;
+
+    /** Datagram buffer */
+    u8 m_datagram[DatagramSize];
+};
+
+static UdpLoopbackBench udpLoopback;
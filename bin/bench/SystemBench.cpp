@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "BenchCase.h"
+
+/**
+ * Minimal kernel trap round trip.
+ */
+BenchCase(syscall_getpid)
+{
+    ProcessCtl(SELF, GetPID);
+}
+
+/**
+ * Kernel trap which copies process information to userspace.
+ */
+BenchCase(syscall_infopid)
+{
+    ProcessInfo info;
+    ProcessCtl(SELF, InfoPID, (Address) &info);
+}
+
+/**
+ * Translate a virtual memory address to a physical address.
+ */
+BenchCase(syscall_vmctl)
+{
+    Memory::Range range;
+    range.virt = 0x80000000;
+    range.size = PAGESIZE;
+    VMCtl(SELF, LookupVirtual, &range);
+}
+
+/**
+ * Context switch latency, by yielding the processor to the scheduler.
+ *
+ * Includes two context switches when other processes are ready to run on
+ * the same core, or only the kernel entry and exit otherwise.
+ */
+BenchCase(sched_yield)
+{
+    ProcessCtl(SELF, Schedule);
+}
+
+/**
+ * Process startup latency, by running a program which exits immediately.
+ *
+ * Includes the spawn, the runtime initialization before main and the
+ * wait for the exit status.
+ */
+BenchCase(process_startup)
+{
+    const char *argv[] = { "/bin/sleep", "0", ZERO };
+    int status;
+
+    const int pid = forkexec(argv[0], argv);
+    if (pid != -1)
+        waitpid(pid, &status, 0);
+}
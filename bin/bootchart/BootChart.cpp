@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Log.h>
+#include <ProcessClient.h>
+#include <stdio.h>
+#include "BootChart.h"
+
+/** Names of the BootMilestone types */
+static const char *milestoneNames[] =
+{
+    "kernel-entry",
+    "heap-ready",
+    "loaded",
+    "server-ready",
+    "core-start",
+    "core-online",
+    "service-start",
+    "service-ready",
+    "init-done"
+};
+
+BootChart::BootChart(int argc, char **argv)
+    : POSIXApplication(argc, argv)
+    , m_events(new BootEvent[MaximumEvents])
+    , m_count(0)
+{
+    parser().setDescription("Print the boot timeline and its critical path");
+}
+
+BootChart::~BootChart()
+{
+    delete[] m_events;
+}
+
+BootChart::Result BootChart::exec()
+{
+    const API::Result result = TraceCtl(TraceBootRead, m_events, MaximumEvents);
+    if ((result & 0xffff) != API::Success)
+    {
+        ERROR("failed to read boot timeline: result = " << (int) (result & 0xffff));
+        return IOError;
+    }
+    m_count = result >> 16;
+
+    printf("%12s %12s %5s %14s %s\r\n", "TIME(ms)", "DELTA(ms)", "PID", "EVENT", "DETAILS");
+
+    for (Size i = 0; i < m_count; i++)
+    {
+        printEvent(m_events[i], i > 0 ? m_events[i].time - m_events[i - 1].time : 0);
+    }
+
+    printCriticalPath();
+    return Success;
+}
+
+void BootChart::printEvent(const BootEvent &event, const u64 delta) const
+{
+    const char *name = event.type < sizeof(milestoneNames) / sizeof(milestoneNames[0]) ?
+                       milestoneNames[event.type] : "unknown";
+    const uint usec = (uint) (event.time / 1000);
+    const uint deltaUsec = (uint) (delta / 1000);
+    char details[64];
+
+    switch (event.type)
+    {
+        case BootKernelEntry:
+        case BootCoreStarted:
+        case BootCoreOnline:
+            snprintf(details, sizeof(details), "core%u", event.arg);
+            break;
+
+        case BootProgramLoaded:
+        case BootServiceStarted:
+        case BootServiceReady:
+            snprintf(details, sizeof(details), "%.16s pid=%u", event.label, event.arg);
+            break;
+
+        // Name servers after their program, if still running
+        case BootServerReady:
+        {
+            const ProcessClient process;
+            ProcessClient::Info info;
+
+            if (process.processInfo(event.pid, info) == ProcessClient::Success)
+                snprintf(details, sizeof(details), "%s", *info.command);
+            else
+                snprintf(details, sizeof(details), "-");
+            break;
+        }
+
+        default:
+            snprintf(details, sizeof(details), "%.16s", event.label);
+            break;
+    }
+
+    printf("%8u.%03u %8u.%03u %5u %14s %s\r\n",
+           usec / 1000, usec % 1000, deltaUsec / 1000, deltaUsec % 1000,
+           event.pid, name, details);
+}
+
+void BootChart::printCriticalPath() const
+{
+    Size path[MaximumEvents];
+    Size length = 0;
+
+    if (m_count == 0)
+        return;
+
+    // Walk back from the end of init, or the last event if init is not done
+    Size index = findBefore(m_count, BootInitDone, ~0U);
+    if (index == m_count)
+        index = m_count - 1;
+
+    while (length < MaximumEvents)
+    {
+        path[length++] = index;
+
+        const Size previous = predecessor(index);
+        if (previous == index)
+            break;
+        index = previous;
+    }
+
+    printf("\r\ncritical path:\r\n");
+
+    for (Size i = length; i > 0; i--)
+    {
+        const BootEvent & event = m_events[path[i - 1]];
+        const u64 delta = i < length ? event.time - m_events[path[i]].time : 0;
+
+        printEvent(event, delta);
+    }
+}
+
+Size BootChart::predecessor(const Size index) const
+{
+    const BootEvent & event = m_events[index];
+    Size found = index;
+
+    switch (event.type)
+    {
+        case BootServerReady:
+            found = findBefore(index, BootProgramLoaded, event.pid);
+            break;
+
+        case BootCoreOnline:
+            found = findBefore(index, BootCoreStarted, event.arg);
+            break;
+
+        case BootServiceReady:
+            found = findBefore(index, BootServiceStarted, event.arg);
+            break;
+
+        // Services start once the service before them is ready
+        case BootServiceStarted:
+        case BootInitDone:
+            found = findBefore(index, BootServiceReady, ~0U);
+            break;
+
+        default:
+            break;
+    }
+
+    if (found == index && index > 0)
+        found = index - 1;
+
+    return found;
+}
+
+Size BootChart::findBefore(const Size index, const u32 type, const u32 arg) const
+{
+    for (Size i = index; i > 0; i--)
+    {
+        const BootEvent & event = m_events[i - 1];
+
+        if (event.type == type && (arg == ~0U || event.arg == arg))
+            return i - 1;
+    }
+
+    return index;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BIN_BOOTCHART_BOOTCHART_H
+#define __BIN_BOOTCHART_BOOTCHART_H
+
+#include <POSIXApplication.h>
+#include <FreeNOS/User.h>
+
+/**
+ * @addtogroup bin
+ * @{
+ */
+
+/**
+ * Print the boot timeline of the current core and its critical path.
+ *
+ * The critical path is the chain of milestones which the last milestone
+ * waited for, for example a service waits for its dependencies to be ready
+ * and a server waits for the kernel to load its program.
+ */
+class BootChart : public POSIXApplication
+{
+  private:
+
+    /** Maximum number of events to read. */
+    static const Size MaximumEvents = 128;
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param argc Argument count
+     * @param argv Argument values
+     */
+    BootChart(int argc, char **argv);
+
+    /**
+     * Destructor
+     */
+    virtual ~BootChart();
+
+    /**
+     * Execute the application.
+     *
+     * @return Result code
+     */
+    virtual Result exec();
+
+  private:
+
+    /**
+     * Output an event.
+     *
+     * @param event Event to output
+     * @param delta Nanoseconds since the event it is compared to
+     */
+    void printEvent(const BootEvent &event, const u64 delta) const;
+
+    /**
+     * Output the critical path towards the last milestone.
+     */
+    void printCriticalPath() const;
+
+    /**
+     * Find the event which an event waited for.
+     *
+     * @param index Index of the event
+     *
+     * @return Index of the earlier event or the same index if none
+     */
+    Size predecessor(const Size index) const;
+
+    /**
+     * Find the latest earlier event of a type.
+     *
+     * @param index Search before this index
+     * @param type BootMilestone type to find
+     * @param arg Argument to match or ~0 to match any
+     *
+     * @return Index of the event or the given index if not found
+     */
+    Size findBefore(const Size index, const u32 type, const u32 arg) const;
+
+  private:
+
+    /** Events read from the kernel */
+    BootEvent *m_events;
+
+    /** Number of events */
+    Size m_count;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __BIN_BOOTCHART_BOOTCHART_H */
@@ -16,7 +16,13 @@
  */
 
 #include <BufferedFile.h>
+#include <MemoryBlock.h>
 #include <Lz4Decompressor.h>
+#include <aio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
 #include "Decompress.h"
 
 Decompress::Decompress(int argc, char **argv)
@@ -68,11 +74,8 @@ Decompress::Result Decompress::decompressFile(const String inputFilename) const
     const String outputFilename =
         inputFilename.substring(0, inputFilename.length() - String::length(lz4Extension));
 
-    // Create buffered files
+    // Read the input file. It is mapped into memory if supported.
     BufferedFile input(*inputFilename);
-    BufferedFile output(*outputFilename);
-
-    // Read the input file
     if (input.read() != BufferedFile::Success)
     {
         ERROR("failed to read input file " << input.path());
@@ -88,29 +91,112 @@ Decompress::Result Decompress::decompressFile(const String inputFilename) const
         return IOError;
     }
 
-    // Allocate temporary buffer
-    const Size originalSize = lz4.getUncompressedSize();
-    u8 *uncompressed = new u8[originalSize];
-
-    // Decompress entire file
-    const Lz4Decompressor::Result readResult = lz4.read(uncompressed, originalSize);
-    if (readResult != Lz4Decompressor::Success)
+    // Open the output file
+    const int fd = ::open(*outputFilename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1)
     {
-        ERROR("failed to decompress file " << *inputFilename << ": result = " << (int) readResult);
-        delete[] uncompressed;
+        ERROR("failed to open output file " << *outputFilename << ": " << strerror(errno));
         return IOError;
     }
 
-    // Write to output file
-    const BufferedFile::Result writeResult = output.write(uncompressed, originalSize);
-    if (writeResult != BufferedFile::Success)
+    // Decompress into one block buffer while the other is written
+    const Size blockSize = lz4.getBlockMaximumSize();
+    u8 *buffers[2] = { new u8[blockSize], new u8[blockSize] };
+    struct aiocb writes[2];
+    bool pending[2] = { false, false };
+    Size position = 0, offset = 0, current = 0;
+    Result ret = Success;
+
+    MemoryBlock::set(writes, 0, sizeof(writes));
+
+    while (true)
     {
-        ERROR("failed to write output file " << *outputFilename << ": result = " << (int) writeResult);
-        delete[] uncompressed;
-        return IOError;
+        Size size = 0;
+
+        // The buffer can only be reused when its previous write is done
+        if (pending[current])
+        {
+            pending[current] = false;
+
+            if ((ret = waitWrite(&writes[current])) != Success)
+            {
+                ERROR("failed to write output file " << *outputFilename);
+                break;
+            }
+        }
+
+        const Lz4Decompressor::Result readResult = lz4.readBlock(position, buffers[current], size);
+        if (readResult != Lz4Decompressor::Success)
+        {
+            ERROR("failed to decompress file " << *inputFilename << ": result = " << (int) readResult);
+            ret = IOError;
+            break;
+        }
+
+        // End of the frame reached
+        if (size == 0)
+        {
+            break;
+        }
+
+        // Write the block in the background
+        writes[current].aio_fildes = fd;
+        writes[current].aio_buf    = buffers[current];
+        writes[current].aio_nbytes = size;
+        writes[current].aio_offset = offset;
+
+        if (::aio_write(&writes[current]) != 0)
+        {
+            ERROR("failed to write output file " << *outputFilename << ": " << strerror(errno));
+            ret = IOError;
+            break;
+        }
+
+        pending[current] = true;
+        offset += size;
+        current ^= 1;
+    }
+
+    // Wait for the remaining writes to complete
+    for (Size i = 0; i < 2; i++)
+    {
+        if (pending[i] && waitWrite(&writes[i]) != Success)
+        {
+            ERROR("failed to write output file " << *outputFilename);
+            ret = IOError;
+        }
+    }
+
+    if (ret == Success && offset != lz4.getUncompressedSize())
+    {
+        ERROR("decompressed " << offset << " bytes instead of " << (Size) lz4.getUncompressedSize());
+        ret = IOError;
     }
 
     // Cleanup resources
-    delete[] uncompressed;
+    ::close(fd);
+    delete[] buffers[0];
+    delete[] buffers[1];
+    return ret;
+}
+
+Decompress::Result Decompress::waitWrite(struct aiocb *request) const
+{
+    const struct aiocb *list[1] = { request };
+    int error;
+
+    while ((error = ::aio_error(request)) == EINPROGRESS)
+    {
+        ::aio_suspend(list, 1, ZERO);
+    }
+
+    const ssize_t written = ::aio_return(request);
+
+    if (error != 0 || written != (ssize_t) request->aio_nbytes)
+    {
+        ERROR("asynchronous write failed: " << strerror(error ? error : EIO));
+        return IOError;
+    }
+
     return Success;
 }
@@ -27,6 +27,11 @@
 
 /**
  * Decompress a compressed file
+ *
+ * The file is decompressed one block at a time into a pair of block
+ * buffers. While a block is decompressed into one buffer, the other
+ * buffer is written to the output file in the background, such that
+ * only two blocks of output are held in memory.
  */
 class Decompress : public POSIXApplication
 {
@@ -62,6 +67,15 @@ class Decompress : public POSIXApplication
      * @return Result code
      */
     Result decompressFile(const String inputFilename) const;
+
+    /**
+     * Wait for an asynchronous write to complete
+     *
+     * @param request The write request
+     *
+     * @return Result code
+     */
+    Result waitWrite(struct aiocb *request) const;
 };
 
 /**
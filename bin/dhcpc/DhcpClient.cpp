@@ -28,18 +28,23 @@
 #include <errno.h>
 #include <string.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include "DhcpClient.h"
 
+const char * DhcpClient::LeaseDirectory = "/tmp";
+
 DhcpClient::DhcpClient(int argc, char **argv)
     : POSIXApplication(argc, argv)
     , m_client(ZERO)
     , m_socket(0)
     , m_transactionId(1)
+    , m_timeout(InitialTimeoutMs)
 {
     MemoryBlock::set(&m_etherAddress, 0, sizeof(m_etherAddress));
 
     parser().setDescription("Dynamic Host Configuration Protocol (DHCP) client");
     parser().registerPositional("DEVICE", "device name of network adapter");
+    parser().registerFlag('l', "lease", "path to the lease cache file");
 }
 
 DhcpClient::~DhcpClient()
@@ -69,6 +74,12 @@ DhcpClient::Result DhcpClient::initialize()
     MemoryBlock::copy(&m_etherAddress, ethFile.buffer(), sizeof(m_etherAddress));
     DEBUG(device << " has address " << m_etherAddress);
 
+    // Select the lease cache file
+    if (arguments().get("lease"))
+        m_leasePath = arguments().get("lease");
+    else
+        m_leasePath << LeaseDirectory << "/dhcpc." << device << ".lease";
+
     // Create a network client
     m_client = new NetworkClient(device);
 
@@ -104,16 +115,59 @@ DhcpClient::Result DhcpClient::initialize()
 }
 
 DhcpClient::Result DhcpClient::exec()
+{
+    IPV4::Address ipAddr = 0, ipServer = 0, ipGateway = 0;
+    DhcpClient::Result result = NotFound;
+    Lease lease;
+
+    DEBUG("");
+
+    // Try to reuse the previous lease first
+    if (loadLease(lease) == Success)
+    {
+        result = reboot(lease, ipAddr, ipServer, ipGateway);
+    }
+
+    // Fallback to acquire a new lease
+    if (result != Success)
+    {
+        result = acquire(ipAddr, ipServer, ipGateway);
+        if (result != Success)
+        {
+            return result;
+        }
+    }
+
+    DEBUG("ipAddr = " << *IPV4::toString(ipAddr) <<
+          " ipServer = " << *IPV4::toString(ipServer) <<
+          " ipGateway = " << *IPV4::toString(ipGateway));
+
+    result = setIpAddress(arguments().get("DEVICE"), ipAddr);
+    if (result != Success)
+    {
+        return result;
+    }
+
+    // A failure to cache the lease only costs a slower next boot
+    saveLease(ipAddr, ipServer, ipGateway);
+    return Success;
+}
+
+DhcpClient::Result DhcpClient::acquire(IPV4::Address & ipAddr,
+                                       IPV4::Address & ipServer,
+                                       IPV4::Address & ipGateway)
 {
     DEBUG("");
 
+    m_timeout = InitialTimeoutMs;
+
     // Keep retrying until we have an address
-    for (Size i = 0; i < MaximumRetries; i++)
+    for (Size i = 0; i < MaximumRetries; i++, backoff())
     {
-        IPV4::Address ipAddr, ipServer, ipGateway;
         DhcpClient::Result result;
 
-        DEBUG("device = " << arguments().get("DEVICE") << " attempt = " << (i + 1));
+        DEBUG("device = " << arguments().get("DEVICE") << " attempt = " << (i + 1) <<
+              " timeout = " << m_timeout);
 
         m_transactionId++;
         ipAddr = ipServer = ipGateway = 0;
@@ -128,7 +182,7 @@ DhcpClient::Result DhcpClient::exec()
         result = offer(ipAddr, ipServer, ipGateway);
         if (result != DhcpClient::Success)
         {
-            ERROR("failed to receive offer: result = " << (int) result);
+            DEBUG("failed to receive offer: result = " << (int) result);
             continue;
         }
 
@@ -142,20 +196,131 @@ DhcpClient::Result DhcpClient::exec()
         result = acknowledge(ipAddr, ipServer, ipGateway);
         if (result != DhcpClient::Success)
         {
-            ERROR("failed to receive acknowledge: result = " << (int) result);
+            DEBUG("failed to receive acknowledge: result = " << (int) result);
+            continue;
+        }
+
+        return Success;
+    }
+
+    ERROR("no DHCP server responded after " << MaximumRetries << " attempts");
+    return NotFound;
+}
+
+DhcpClient::Result DhcpClient::reboot(const DhcpClient::Lease & lease,
+                                      IPV4::Address & ipAddr,
+                                      IPV4::Address & ipServer,
+                                      IPV4::Address & ipGateway)
+{
+    DEBUG("ipAddr = " << *IPV4::toString(lease.ipAddr));
+
+    m_timeout = InitialTimeoutMs;
+
+    for (Size i = 0; i < RebootRetries; i++, backoff())
+    {
+        DhcpClient::Result result;
+
+        m_transactionId++;
+
+        // The server identifier must not be filled in the INIT-REBOOT state
+        result = request(lease.ipAddr, 0, lease.ipGateway);
+        if (result != DhcpClient::Success)
+        {
+            ERROR("failed to send request: result = " << (int) result);
             continue;
         }
 
-        DEBUG("ipAddr = " << *IPV4::toString(ipAddr) <<
-              " ipServer = " << *IPV4::toString(ipServer) <<
-              " ipGateway = " << *IPV4::toString(ipGateway));
+        ipAddr = ipServer = 0;
+        ipGateway = lease.ipGateway;
 
-        return setIpAddress(arguments().get("DEVICE"), ipAddr);
+        result = acknowledge(ipAddr, ipServer, ipGateway);
+        if (result == DhcpClient::Success && ipAddr == lease.ipAddr)
+        {
+            return Success;
+        }
+        else if (result == DhcpClient::InvalidArgument)
+        {
+            // Most likely a Nak: the cached address is no longer valid
+            DEBUG("cached lease rejected");
+            break;
+        }
     }
 
     return NotFound;
 }
 
+DhcpClient::Result DhcpClient::loadLease(DhcpClient::Lease & lease) const
+{
+    struct stat st;
+
+    DEBUG("path = " << *m_leasePath);
+
+    // No cached lease is not an error
+    if (::stat(*m_leasePath, &st) != 0)
+    {
+        return NotFound;
+    }
+
+    BufferedFile file(*m_leasePath);
+
+    if (file.read() != BufferedFile::Success || file.size() < sizeof(lease))
+    {
+        return NotFound;
+    }
+    MemoryBlock::copy(&lease, file.buffer(), sizeof(lease));
+
+    // The lease must belong to this device
+    if (lease.magic != LeaseMagic ||
+        !MemoryBlock::compare(&lease.etherAddress, &m_etherAddress, sizeof(m_etherAddress)))
+    {
+        DEBUG("ignored stale lease in " << *m_leasePath);
+        return NotFound;
+    }
+
+    return Success;
+}
+
+DhcpClient::Result DhcpClient::saveLease(const IPV4::Address ipAddr,
+                                         const IPV4::Address ipServer,
+                                         const IPV4::Address ipGateway) const
+{
+    struct stat st;
+    Lease lease;
+
+    DEBUG("path = " << *m_leasePath);
+
+    lease.magic     = LeaseMagic;
+    lease.ipAddr    = ipAddr;
+    lease.ipServer  = ipServer;
+    lease.ipGateway = ipGateway;
+    MemoryBlock::copy(&lease.etherAddress, &m_etherAddress, sizeof(m_etherAddress));
+
+    // Create the lease file on first use
+    if (::stat(*m_leasePath, &st) != 0 && ::creat(*m_leasePath, S_IRUSR | S_IWUSR) < 0)
+    {
+        ERROR("failed to create lease file " << *m_leasePath << ": " << strerror(errno));
+        return IOError;
+    }
+
+    BufferedFile file(*m_leasePath);
+
+    if (file.write(&lease, sizeof(lease)) != BufferedFile::Success)
+    {
+        ERROR("failed to write lease file " << *m_leasePath);
+        return IOError;
+    }
+
+    return Success;
+}
+
+void DhcpClient::backoff()
+{
+    m_timeout *= 2;
+
+    if (m_timeout > MaximumTimeoutMs)
+        m_timeout = MaximumTimeoutMs;
+}
+
 DhcpClient::Result DhcpClient::setIpAddress(const char *device,
                                             const IPV4::Address ipAddr) const
 {
@@ -281,7 +446,11 @@ DhcpClient::Result DhcpClient::receiveBootResponse(const DhcpClient::MessageType
     DEBUG("");
 
     const DhcpClient::Result result = udpReceive(&pkt, size);
-    if (result != DhcpClient::Success)
+    if (result == DhcpClient::TimedOut)
+    {
+        return result;
+    }
+    else if (result != DhcpClient::Success)
     {
         ERROR("failed to receive UDP packet: result = " << (int) result);
         return IOError;
@@ -403,8 +572,13 @@ DhcpClient::Result DhcpClient::udpReceive(void *packet,
     struct sockaddr addr;
 
     // Wait for a packet in the UDP socket
-    const NetworkClient::Result result = m_client->waitSocket(NetworkClient::UDP, m_socket, ReceiveTimeoutMs);
-    if (result != NetworkClient::Success)
+    const NetworkClient::Result result = m_client->waitSocket(NetworkClient::UDP, m_socket, m_timeout);
+    if (result == NetworkClient::TimedOut)
+    {
+        DEBUG("timed out after " << m_timeout << " ms");
+        return TimedOut;
+    }
+    else if (result != NetworkClient::Success)
     {
         ERROR("failed to wait for UDP socket " << m_socket << ": result = " << (int) result);
         return IOError;
@@ -18,6 +18,7 @@
 #ifndef __BIN_DHCPC_DHCPCLIENT_H
 #define __BIN_DHCPC_DHCPCLIENT_H
 
+#include <String.h>
 #include <NetworkClient.h>
 #include <POSIXApplication.h>
 
@@ -46,11 +47,23 @@ class DhcpClient : public POSIXApplication
     /** Maximum number of retries to receive an IP address */
     static const Size MaximumRetries = 25;
 
+    /** Number of attempts to reuse a cached lease before falling back to discovery */
+    static const Size RebootRetries = 3;
+
     /** Magic number value for the packet header */
     static const u32 MagicValue = 0x63825363;
 
-    /** Timeout in milliseconds to wait for packet receive */
-    static const Size ReceiveTimeoutMs = 500;
+    /** Initial timeout in milliseconds to wait for packet receive */
+    static const Size InitialTimeoutMs = 4;
+
+    /** Upper bound in milliseconds for the exponential receive timeout */
+    static const Size MaximumTimeoutMs = 4000;
+
+    /** Magic number value to identify a lease file */
+    static const u32 LeaseMagic = 0x4c454153;
+
+    /** Directory holding cached leases, if no lease file is given */
+    static const char *LeaseDirectory;
 
     /**
      * Protocol packet header
@@ -111,6 +124,18 @@ class DhcpClient : public POSIXApplication
         EndMark              = 255
     };
 
+    /**
+     * Cached lease as stored in the lease file
+     */
+    struct Lease
+    {
+        u32 magic;
+        Ethernet::Address etherAddress;
+        IPV4::Address ipAddr;
+        IPV4::Address ipServer;
+        IPV4::Address ipGateway;
+    };
+
   public:
 
     /**
@@ -142,6 +167,66 @@ class DhcpClient : public POSIXApplication
 
   private:
 
+    /**
+     * Acquire an IP address with the full discover, offer, request and acknowledge exchange
+     *
+     * @param ipAddr Acknowledged IP address on output
+     * @param ipServer Server IP address on output
+     * @param ipGateway Gateway IP address on output
+     *
+     * @return Result code
+     */
+    Result acquire(IPV4::Address &ipAddr,
+                   IPV4::Address &ipServer,
+                   IPV4::Address &ipGateway);
+
+    /**
+     * Confirm a previously acquired IP address (INIT-REBOOT state)
+     *
+     * The cached address is requested directly from any server, skipping
+     * the discover and offer round trip. A server which does not agree
+     * with the address answers with a Nak, after which the caller
+     * falls back to acquire().
+     *
+     * @param lease Previous lease as read from the lease file
+     * @param ipAddr Acknowledged IP address on output
+     * @param ipServer Server IP address on output
+     * @param ipGateway Gateway IP address on output
+     *
+     * @return Result code
+     */
+    Result reboot(const Lease &lease,
+                  IPV4::Address &ipAddr,
+                  IPV4::Address &ipServer,
+                  IPV4::Address &ipGateway);
+
+    /**
+     * Read the cached lease from the lease file
+     *
+     * @param lease Lease output
+     *
+     * @return Result code
+     */
+    Result loadLease(Lease &lease) const;
+
+    /**
+     * Write the acquired lease to the lease file
+     *
+     * @param ipAddr Acknowledged IP address
+     * @param ipServer Server IP address
+     * @param ipGateway Gateway IP address
+     *
+     * @return Result code
+     */
+    Result saveLease(const IPV4::Address ipAddr,
+                     const IPV4::Address ipServer,
+                     const IPV4::Address ipGateway) const;
+
+    /**
+     * Double the receive timeout for the next retransmission
+     */
+    void backoff();
+
     /**
      * Set IP address on a device
      *
@@ -270,6 +355,12 @@ class DhcpClient : public POSIXApplication
 
     /** Transaction ID of the current request */
     u32 m_transactionId;
+
+    /** Current receive timeout in milliseconds */
+    Size m_timeout;
+
+    /** Path to the lease file */
+    String m_leasePath;
 };
 
 /**
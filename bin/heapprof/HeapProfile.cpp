@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Log.h>
+#include <ELF.h>
+#include <BufferedFile.h>
+#include <ProcessClient.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "HeapProfile.h"
+
+HeapProfile::HeapProfile(int argc, char **argv)
+    : POSIXApplication(argc, argv)
+{
+    parser().setDescription("Output the heap profile of a process");
+    parser().registerPositional("PID", "Process identifier of a program built with HEAPPROF=True");
+}
+
+HeapProfile::~HeapProfile()
+{
+}
+
+HeapProfile::Result HeapProfile::exec()
+{
+    const ProcessClient process;
+    const ProcessID pid = atoi(arguments().get("PID"));
+    ProfileAllocator::Profile *profile = new ProfileAllocator::Profile;
+    ProcessClient::Info info;
+
+    if (process.processInfo(pid, info) != ProcessClient::Success)
+    {
+        ERROR("no such process: " << arguments().get("PID"));
+        delete profile;
+        return NotFound;
+    }
+
+    const ProcessClient::Result result = process.heapProfile(pid, *profile);
+    if (result != ProcessClient::Success)
+    {
+        ERROR("no heap profile for PID " << pid << ": result = " << (int) result);
+        delete profile;
+        return NotFound;
+    }
+
+    printClasses(*profile);
+    printSamples(*profile, info.command);
+
+    delete profile;
+    return Success;
+}
+
+void HeapProfile::printClasses(const ProfileAllocator::Profile &profile) const
+{
+    String out;
+    char line[128];
+
+    // Bytes lost by rounding requests up to the object size of their class
+    const u64 rounding = profile.allocatedBytes - profile.requestedBytes;
+    const uint internal = profile.allocatedBytes ?
+        (uint) ((rounding * 100) / profile.allocatedBytes) : 0;
+
+    snprintf(line, sizeof(line), "%u allocations, %u releases, %u failures\r\n",
+             profile.allocations, profile.releases, profile.failures);
+    out << line;
+    snprintf(line, sizeof(line), "%uK in use, %uK peak, %u%% internal fragmentation\r\n\r\n",
+             profile.currentBytes / 1024, profile.peakBytes / 1024, internal);
+    out << line;
+    out << "      SIZE   ALLOCS   FREES  CURRENT     PEAK  POOLS POOLBYTES  FREE%\r\n";
+
+    for (Size i = 0; i < ProfileAllocator::SizeClasses; i++)
+    {
+        const ProfileAllocator::SizeClass &c = profile.classes[i];
+
+        if (c.allocations == 0 && c.pools == 0)
+            continue;
+
+        // Bytes owned by the pools which are not handed out
+        const uint unused = c.poolBytes > c.currentBytes ?
+            (uint) (((u64) (c.poolBytes - c.currentBytes) * 100) / c.poolBytes) : 0;
+
+        snprintf(line, sizeof(line), "  %8u %8u %7u %8u %8u %6u %9u %5u%%\r\n",
+                 (uint) (1U << i), c.allocations, c.releases, c.currentBytes,
+                 c.peakBytes, c.pools, c.poolBytes, unused);
+        out << line;
+    }
+    write(1, *out, out.length());
+}
+
+void HeapProfile::printSamples(const ProfileAllocator::Profile &profile,
+                               const String &command) const
+{
+    const Size count = profile.samples < ProfileAllocator::MaximumSamples ?
+                       profile.samples : ProfileAllocator::MaximumSamples;
+    ExecutableFormat *format = ZERO;
+    String path;
+    char line[128];
+
+    // Retrieve the program of the process
+    const List<String> words = command.split(' ');
+    if (words.count() > 0)
+    {
+        path = words.head()->data;
+    }
+
+    // Load the symbols of the program, if any
+    BufferedFile file(*path);
+    if (file.read() == BufferedFile::Success)
+    {
+        ELF::detect((const u8 *) file.buffer(), file.size(), &format);
+    }
+
+    // Group the samples by symbol
+    Symbol *symbols = new Symbol[ProfileAllocator::MaximumSamples];
+    Size numSymbols = 0;
+
+    for (Size i = 0; i < count; i++)
+    {
+        const ProfileAllocator::Sample &s = profile.recent[i];
+        const char *name = "[unknown]";
+        Address start = 0;
+        Size j;
+
+        if (format != ZERO)
+            ((ELF *) format)->symbol(s.site, &name, &start);
+
+        for (j = 0; j < numSymbols; j++)
+        {
+            if (symbols[j].name == name && symbols[j].start == start)
+                break;
+        }
+
+        if (j == numSymbols)
+        {
+            symbols[numSymbols].name  = name;
+            symbols[numSymbols].start = start;
+            symbols[numSymbols].hits  = 0;
+            symbols[numSymbols].bytes = 0;
+            numSymbols++;
+        }
+        symbols[j].hits++;
+        symbols[j].bytes += s.size;
+    }
+
+    // Order by descending number of samples
+    for (Size i = 1; i < numSymbols; i++)
+    {
+        const Symbol s = symbols[i];
+        Size j = i;
+
+        for (; j > 0 && symbols[j - 1].hits < s.hits; j--)
+            symbols[j] = symbols[j - 1];
+
+        symbols[j] = s;
+    }
+
+    // Output the allocation sites
+    String out;
+    snprintf(line, sizeof(line), "\r\n%u samples, one per %u allocations, last %u shown\r\n",
+             profile.samples, profile.sampleInterval, count);
+    out << line;
+    out << "  SAMPLES  AVGSIZE  SITE\r\n";
+
+    for (Size i = 0; i < numSymbols; i++)
+    {
+        snprintf(line, sizeof(line), "  %7u %8u  %s\r\n",
+                 symbols[i].hits, symbols[i].bytes / symbols[i].hits, symbols[i].name);
+        out << line;
+    }
+    write(1, *out, out.length());
+
+    delete[] symbols;
+    delete format;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BIN_HEAPPROF_HEAPPROFILE_H
+#define __BIN_HEAPPROF_HEAPPROFILE_H
+
+#include <POSIXApplication.h>
+#include <ProfileAllocator.h>
+
+/**
+ * @addtogroup bin
+ * @{
+ */
+
+/**
+ * Output the heap profile of a process.
+ *
+ * The process must be built with HEAPPROF=True.
+ */
+class HeapProfile : public POSIXApplication
+{
+  private:
+
+    /**
+     * Number of sampled allocations inside a single symbol.
+     */
+    typedef struct Symbol
+    {
+        /** Name of the symbol */
+        const char *name;
+
+        /** Start address of the symbol */
+        Address start;
+
+        /** Number of samples */
+        Size hits;
+
+        /** Sum of the requested sizes */
+        Size bytes;
+    }
+    Symbol;
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param argc Argument count
+     * @param argv Argument values
+     */
+    HeapProfile(int argc, char **argv);
+
+    /**
+     * Destructor
+     */
+    virtual ~HeapProfile();
+
+    /**
+     * Execute the application.
+     *
+     * @return Result code
+     */
+    virtual Result exec();
+
+  private:
+
+    /**
+     * Output the totals and the statistics per size class.
+     *
+     * @param profile Heap profile of the process
+     */
+    void printClasses(const ProfileAllocator::Profile &profile) const;
+
+    /**
+     * Output the sampled allocations grouped by symbol.
+     *
+     * @param profile Heap profile of the process
+     * @param command Command of the process
+     */
+    void printSamples(const ProfileAllocator::Profile &profile,
+                      const String &command) const;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __BIN_HEAPPROF_HEAPPROFILE_H */
@@ -18,6 +18,7 @@
 #include <Vector.h>
 #include <ExecutableFormat.h>
 #include <BootImage.h>
+#include <Lz4Compressor.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -31,6 +32,7 @@ BootImageCreate::BootImageCreate(int argc, char **argv)
 {
     parser().setDescription("Create system boot image");
     parser().registerFlag('p', "prefix", "Prefix each entry from the config file with the given path");
+    parser().registerFlag('c', "compress", "Compress program segments which are copied at boot");
     parser().registerPositional("CONFFILE", "Configuration file for the boot image");
     parser().registerPositional("OUTFILE", "Output file name of the boot image");
 }
@@ -72,6 +74,7 @@ Size BootImageCreate::readBootSymbols(const char *conf_file,
     {
         // Allocate new boot entry
         entry = new BootEntry;
+        memset(entry->compressed, 0, sizeof(entry->compressed));
 
         // Remove trailing newline
         if (strlen(line) < sizeof(line) - 1)
@@ -190,6 +193,63 @@ Size BootImageCreate::readBootSymbols(const char *conf_file,
     return totalEntries;
 }
 
+BootImageCreate::Result BootImageCreate::writeZeroes(FILE *fp, Size size) const
+{
+    static const u8 zeroes[PageSize] = { 0 };
+
+    while (size > 0)
+    {
+        const Size chunk = size < PageSize ? size : PageSize;
+
+        if (fwrite(zeroes, chunk, 1, fp) <= 0)
+            return IOError;
+
+        size -= chunk;
+    }
+
+    return Success;
+}
+
+BootImageCreate::Result BootImageCreate::compressRegion(BootEntry *entry,
+                                                       const Size index,
+                                                       BootSegment *segment) const
+{
+    const ExecutableFormat::Region & region = entry->regions[index];
+    u8 *contents = new u8[region.memorySize];
+    Size pages = (region.memorySize + PageSize - 1) / PageSize;
+
+    // Compress the region as it appears in memory, including zeroes
+    memset(contents, 0, region.memorySize);
+    memcpy(contents, entry->data + region.dataOffset, region.dataSize);
+
+    Lz4Compressor lz4(contents, region.memorySize);
+    Size size = lz4.getMaximumSize();
+    u8 *compressed = new u8[size];
+
+    if (lz4.compress(compressed, size) != Lz4Compressor::Success)
+    {
+        delete[] contents;
+        delete[] compressed;
+        return IOError;
+    }
+    delete[] contents;
+
+    // Only keep the compressed contents if that saves memory pages
+    if ((size + PageSize - 1) / PageSize >= pages)
+    {
+        delete[] compressed;
+        return Success;
+    }
+
+    printf("%s[%u]: compressed %u to %u bytes\r\n",
+            entry->symbol.name, (uint) index, (uint) region.memorySize, (uint) size);
+
+    entry->compressed[index] = compressed;
+    segment->dataSize = size;
+    segment->flags   |= BootSegmentCompressed;
+    return Success;
+}
+
 BootImageCreate::Result BootImageCreate::exec()
 {
     Vector<BootEntry *> input;
@@ -203,6 +263,7 @@ BootImageCreate::Result BootImageCreate::exec()
     const char *conf_file = arguments().get("CONFFILE");
     const char *out_file = arguments().get("OUTFILE");
     const char *prefix = arguments().get("prefix");
+    const bool compress = arguments().get("compress") != ZERO;
 
     // Read boot symbols
     if (readBootSymbols(conf_file, prefix, &input) == 0)
@@ -258,12 +319,27 @@ BootImageCreate::Result BootImageCreate::exec()
             segments[segCount].virtualAddress = input[i]->regions[j].virt;
             segments[segCount].size           = input[i]->regions[j].memorySize;
             segments[segCount].offset         = dataOffset;
-            
+            segments[segCount].access         = input[i]->regions[j].access;
+            segments[segCount].dataSize       = input[i]->regions[j].memorySize;
+            segments[segCount].flags          = 0;
+
+            // Compressed program segments are decompressed by the kernel
+            // straight into the pages of the program at boot
+            if (compress && segments[segCount].size > 0 &&
+               (input[i]->symbol.type == BootProgram || input[i]->symbol.type == BootPrivProgram) &&
+                compressRegion(input[i], j, &segments[segCount]) != Success)
+            {
+                fprintf(stderr, "%s: failed to compress BootSegment of `%s'\r\n",
+                        prog, input[i]->symbol.name);
+                return IOError;
+            }
+
             // Increment total segments size
             symbols[i].segmentsTotalSize += segments[segCount].size;
 
-            // Increment data pointer. Align on memory page boundary
-            dataOffset += segments[i].size;
+            // Increment data pointer. Align on memory page boundary, such that
+            // the kernel can map the segment directly from the boot image
+            dataOffset += segments[segCount].dataSize;
             lastDataOffset = dataOffset;
             dataOffset += PageSize - (dataOffset % PageSize);
             segCount++;
@@ -296,8 +372,10 @@ BootImageCreate::Result BootImageCreate::exec()
         // Loop regions/segments per boot symbol entry
         for (Size j = 0; j < input[i]->numRegions; j++)
         {
+            const ExecutableFormat::Region & region = input[i]->regions[j];
+
             // Adjust file pointer
-            if (fseek(fp, segments[symbols[i].segmentsOffset].offset,
+            if (fseek(fp, segments[symbols[i].segmentsOffset + j].offset,
                       SEEK_SET) == -1)
             {
                 fprintf(stderr, "%s: failed to seek to BootSegment contents in `%s': %s\r\n",
@@ -305,9 +383,24 @@ BootImageCreate::Result BootImageCreate::exec()
                 return IOError;
             }
 
-            // Write segment contents
-            if (fwrite(input[i]->data + input[i]->regions[j].dataOffset,
-                       input[i]->regions[j].memorySize, 1, fp) <= 0)
+            // Write compressed contents
+            if (input[i]->compressed[j])
+            {
+                if (fwrite(input[i]->compressed[j],
+                           segments[symbols[i].segmentsOffset + j].dataSize, 1, fp) <= 0)
+                {
+                    fprintf(stderr, "%s: failed to write BootSegment contents to `%s': %s\r\n",
+                            prog, out_file, strerror(errno));
+                    return IOError;
+                }
+                continue;
+            }
+
+            // Write segment contents, followed by zeroes up to the memory size
+            if ((region.dataSize > 0 &&
+                 fwrite(input[i]->data + region.dataOffset, region.dataSize, 1, fp) <= 0) ||
+                (region.memorySize > region.dataSize &&
+                 writeZeroes(fp, region.memorySize - region.dataSize) != Success))
             {
                 fprintf(stderr, "%s: failed to write BootSegment contents to `%s': %s\r\n",
                         prog, out_file, strerror(errno));
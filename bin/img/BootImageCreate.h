@@ -18,6 +18,7 @@
 #ifndef __BIN_IMG_BOOTIMAGECREATE_H
 #define __BIN_IMG_BOOTIMAGECREATE_H
 
+#include <stdio.h>
 #include <Application.h>
 #include <ExecutableFormat.h>
 #include <BootImage.h>
@@ -46,6 +47,9 @@ typedef struct BootEntry
 
     /** Number of memory regions. */
     Size numRegions;
+
+    /** Compressed contents per memory region, or ZERO to store the region as-is */
+    u8 *compressed[BOOTENTRY_MAX_REGIONS];
 }
 BootEntry;
 
@@ -105,6 +109,30 @@ class BootImageCreate : public Application
     Size readBootSymbols(const char *file,
                          const char *prefix,
                          Vector<BootEntry *> *entries);
+
+    /**
+     * Write zero bytes to the output file.
+     *
+     * @param fp Output file
+     * @param size Number of zero bytes to write
+     *
+     * @return Result code
+     */
+    Result writeZeroes(FILE *fp, Size size) const;
+
+    /**
+     * Compress the contents of a memory region.
+     *
+     * The region is only compressed if that saves at least one memory page
+     * in the boot image, otherwise the segment is stored uncompressed.
+     *
+     * @param entry BootEntry containing the region
+     * @param index Index of the memory region
+     * @param segment BootSegment to update with the stored size and flags
+     *
+     * @return Result code
+     */
+    Result compressRegion(BootEntry *entry, const Size index, BootSegment *segment) const;
 };
 
 /**
@@ -15,18 +15,27 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#ifndef __HOST__
+#include <FreeNOS/User.h>
+#include <FileSystemClient.h>
+#endif /* __HOST__ */
+#include <ListIterator.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include "Init.h"
 
 Init::Init(int argc, char **argv)
     : POSIXApplication(argc, argv)
+    , m_serviceCount(0)
 {
     parser().setDescription("Initialize system processes");
     parser().registerFlag('s', "script", "Set shell startup script");
+    parser().registerFlag('S', "services", "Set services file");
 }
 
 Init::~Init()
@@ -37,9 +46,28 @@ Init::Result Init::exec()
 {
     const char *script = arguments().get("script") ?
                          arguments().get("script") : "/etc/init.sh";
+    const char *services = arguments().get("services") ?
+                           arguments().get("services") : "/etc/services.conf";
     const char *av[] = { "/bin/sh", script, ZERO };
     int pid, status;
 
+    // Start services before the script, which may use them
+    if (readServices(services) == Success)
+    {
+        const u64 started = timestamp();
+        const Result result = startServices();
+
+        if (result != Success)
+            return result;
+
+        NOTICE("Started " << m_serviceCount << " services in " <<
+               (uint) ((timestamp() - started) / 1000) << " ms");
+    }
+
+#ifndef __HOST__
+    BootMark(BootInitDone);
+#endif /* __HOST__ */
+
     NOTICE("Starting init script: " << script);
 
     // Execute the run commands file
@@ -54,3 +82,177 @@ Init::Result Init::exec()
     waitpid(pid, &status, 0);
     return Success;
 }
+
+Init::Result Init::readServices(const char *path)
+{
+    struct stat st;
+    int fd;
+
+    if (stat(path, &st) != 0 || (fd = open(path, O_RDONLY)) < 0)
+    {
+        return NotFound;
+    }
+
+    char *buffer = new char[st.st_size + 1];
+    const int bytes = read(fd, buffer, st.st_size);
+    close(fd);
+
+    if (bytes != st.st_size)
+    {
+        ERROR("failed to read " << path << ": " << strerror(errno));
+        delete[] buffer;
+        return IOError;
+    }
+    buffer[bytes] = ZERO;
+
+    const List<String> lines = String(buffer).split('\n');
+    delete[] buffer;
+
+    for (ListIterator<String> i(lines); i.hasCurrent(); i++)
+    {
+        const List<String> fields = i.current().split(' ');
+
+        // Skip empty lines and comments
+        if (fields.count() == 0 || (*fields[0])[0] == '#')
+            continue;
+
+        if (fields.count() < 4)
+        {
+            ERROR("invalid service line: " << *i.current());
+            return InvalidArgument;
+        }
+
+        if (m_serviceCount >= MaximumServices)
+        {
+            ERROR("too many services in " << path);
+            return InvalidArgument;
+        }
+
+        Service *service = &m_services[m_serviceCount++];
+        service->name  = fields[0];
+        service->mount = fields[1] == "-" ? String() : fields[1];
+        service->pid   = 0;
+        service->ready = false;
+
+        if (!(fields[2] == "-"))
+            service->depends = fields[2].split(',');
+
+        for (Size j = 3; j < fields.count(); j++)
+            service->command.append(fields[j]);
+    }
+
+    return Success;
+}
+
+Init::Result Init::startServices()
+{
+    Size ready = 0;
+
+    while (ready < m_serviceCount)
+    {
+        Service *waiting = ZERO;
+
+        // Start all services with their dependencies ready
+        for (Size i = 0; i < m_serviceCount; i++)
+        {
+            Service *service = &m_services[i];
+
+            if (!service->pid && isStartable(service))
+            {
+                const Result result = startService(service);
+                if (result != Success)
+                    return result;
+            }
+
+            if (service->pid && !service->ready && !waiting)
+                waiting = service;
+        }
+
+        if (!waiting)
+        {
+            ERROR("unresolved service dependencies");
+            return InvalidArgument;
+        }
+
+        // Wait for the first started service
+        const Result result = waitService(waiting);
+        if (result != Success)
+            return result;
+
+        ready++;
+    }
+
+    return Success;
+}
+
+bool Init::isStartable(const Service *service) const
+{
+    for (ListIterator<String> i(service->depends); i.hasCurrent(); i++)
+    {
+        for (Size j = 0; j < m_serviceCount; j++)
+        {
+            if (m_services[j].name == i.current() && !m_services[j].ready)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+Init::Result Init::startService(Service *service)
+{
+    const char *argv[16];
+    Size argc = 0;
+
+    for (ListIterator<String> i(service->command); i.hasCurrent() && argc < 15; i++)
+        argv[argc++] = *i.current();
+    argv[argc] = ZERO;
+
+    service->started = timestamp();
+
+    const int pid = runProgram(argv[0], argv);
+    if (pid == -1)
+    {
+        ERROR("failed to start service " << *service->name << ": " << strerror(errno));
+        return IOError;
+    }
+
+    service->pid = pid;
+#ifndef __HOST__
+    BootMark(BootServiceStarted, pid, *service->name);
+#endif /* __HOST__ */
+    return Success;
+}
+
+Init::Result Init::waitService(Service *service)
+{
+#ifndef __HOST__
+    if (service->mount.length() > 0)
+    {
+        const FileSystemClient filesystem;
+        const FileSystem::Result result = filesystem.waitFileSystem(*service->mount);
+
+        if (result != FileSystem::Success)
+        {
+            ERROR("failed to wait for service " << *service->name << " at " <<
+                  *service->mount << ": result = " << (int) result);
+            return IOError;
+        }
+    }
+    BootMark(BootServiceReady, service->pid, *service->name);
+#endif /* __HOST__ */
+
+    service->ready = true;
+
+    INFO("service " << *service->name << " ready in " <<
+         (uint) ((timestamp() - service->started) / 1000) << " ms");
+    return Success;
+}
+
+u64 Init::timestamp() const
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, ZERO);
+    return ((u64) tv.tv_sec * 1000000) + tv.tv_usec;
+}
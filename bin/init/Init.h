@@ -18,7 +18,11 @@
 #ifndef __BIN_INIT_INIT_H
 #define __BIN_INIT_INIT_H
 
+#include <sys/time.h>
+#include <sys/types.h>
 #include <POSIXApplication.h>
+#include <String.h>
+#include <List.h>
 
 /**
  * @addtogroup bin
@@ -27,9 +31,35 @@
 
 /**
  * Initialize system processes.
+ *
+ * Before running the startup script, init starts the services listed
+ * in the services file. Each line names a service, the path it mounts
+ * when ready (or '-'), the services it depends on separated by
+ * commas (or '-') and its command line. Services start as soon as
+ * all their dependencies are ready, such that independent services
+ * start concurrently.
  */
 class Init : public POSIXApplication
 {
+  private:
+
+    /** Maximum number of services */
+    static const Size MaximumServices = 32;
+
+    /**
+     * System service started by init
+     */
+    struct Service
+    {
+        String name;            /**< Name used in dependencies */
+        String mount;           /**< Path mounted when ready or empty */
+        List<String> depends;   /**< Names of services to wait for */
+        List<String> command;   /**< Program path and arguments */
+        pid_t pid;              /**< Process identifier once started */
+        bool ready;             /**< True once the service is ready */
+        u64 started;            /**< Start time in microseconds */
+    };
+
   public:
 
     /**
@@ -51,6 +81,66 @@ class Init : public POSIXApplication
      * @return Result code
      */
     virtual Result exec();
+
+  private:
+
+    /**
+     * Read the services file.
+     *
+     * @param path Path to the services file
+     *
+     * @return Result code
+     */
+    Result readServices(const char *path);
+
+    /**
+     * Start all services in dependency order.
+     *
+     * @return Result code
+     */
+    Result startServices();
+
+    /**
+     * Check if all dependencies of a service are ready.
+     *
+     * @param service Service to check
+     *
+     * @return True if the service can start
+     */
+    bool isStartable(const Service *service) const;
+
+    /**
+     * Start a service.
+     *
+     * @param service Service to start
+     *
+     * @return Result code
+     */
+    Result startService(Service *service);
+
+    /**
+     * Wait until a started service is ready.
+     *
+     * @param service Service to wait for
+     *
+     * @return Result code
+     */
+    Result waitService(Service *service);
+
+    /**
+     * Get the current time.
+     *
+     * @return Time in microseconds
+     */
+    u64 timestamp() const;
+
+  private:
+
+    /** Services to start */
+    Service m_services[MaximumServices];
+
+    /** Number of services */
+    Size m_serviceCount;
 };
 
 /**
@@ -0,0 +1,450 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FileSystemClient.h>
+#include <FileDescriptor.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include "IOBench.h"
+
+IOBench::IOBench(int argc, char **argv)
+    : POSIXApplication(argc, argv)
+    , m_directory(ZERO)
+    , m_interface(Posix)
+    , m_write(false)
+    , m_random(false)
+    , m_blockSize(DefaultBlockSize)
+    , m_fileSize(DefaultFileSize)
+    , m_files(1)
+    , m_jobs(1)
+    , m_buffer(ZERO)
+{
+    parser().setDescription("Measure file system I/O performance");
+    parser().registerPositional("DIRECTORY", "Directory on the file system to test");
+    parser().registerFlag('m', "mode", "I/O pattern: read, write, randread or randwrite (default read)");
+    parser().registerFlag('b', "block", "Bytes per operation, 512 to 1m (default 4k)");
+    parser().registerFlag('s', "size", "Size of each file (default 1m)");
+    parser().registerFlag('n', "files", "Number of files per job (default 1)");
+    parser().registerFlag('j', "jobs", "Number of processes (default 1)");
+    parser().registerFlag('a', "api", "File access: posix or client (default posix)");
+    parser().registerFlag('x', "job", "Run only the given job (used for the processes of -j)");
+}
+
+IOBench::~IOBench()
+{
+    delete[] m_buffer;
+}
+
+IOBench::Result IOBench::exec()
+{
+    const char *mode = arguments().get("mode");
+    const char *api = arguments().get("api");
+    Report report;
+    Result result;
+
+    m_directory = arguments().get("DIRECTORY");
+
+    // Parse options
+    if (mode == ZERO || strcmp(mode, "read") == 0)
+        m_write = false;
+    else if (strcmp(mode, "write") == 0)
+        m_write = true;
+    else if (strcmp(mode, "randread") == 0)
+        m_random = true;
+    else if (strcmp(mode, "randwrite") == 0)
+        m_write = m_random = true;
+    else
+    {
+        ERROR("unknown mode: " << mode);
+        return InvalidArgument;
+    }
+
+    if (api == ZERO || strcmp(api, "posix") == 0)
+        m_interface = Posix;
+    else if (strcmp(api, "client") == 0)
+        m_interface = Client;
+    else
+    {
+        ERROR("unknown api: " << api);
+        return InvalidArgument;
+    }
+
+    if ((result = parseSize("block", m_blockSize, MinimumBlockSize, MaximumBlockSize)) != Success ||
+        (result = parseSize("size", m_fileSize, m_blockSize, MaximumFileSize)) != Success ||
+        (result = parseSize("files", m_files, 1, MaximumFiles)) != Success ||
+        (result = parseSize("jobs", m_jobs, 1, MaximumJobs)) != Success)
+    {
+        return result;
+    }
+
+    m_buffer = new u8[m_blockSize];
+    MemoryBlock::set(m_buffer, 0xaa, m_blockSize);
+
+    // Processes started for -j only run their own job
+    if (arguments().get("job"))
+    {
+        const Size job = atoi(arguments().get("job"));
+
+        if (job >= m_jobs)
+        {
+            ERROR("job must be less than " << m_jobs);
+            return InvalidArgument;
+        }
+
+        return runJob(job, report);
+    }
+
+    // Lay out the files before measuring
+    if ((result = prepareFiles(true)) != Success)
+    {
+        prepareFiles(false);
+        return result;
+    }
+
+    if (m_jobs == 1)
+    {
+        result = runJob(0, report);
+    }
+    else if ((result = runJobs(report)) == Success)
+    {
+        printReport("all jobs", report, ZERO);
+    }
+
+    prepareFiles(false);
+    return result;
+}
+
+IOBench::Result IOBench::parseSize(const char *name,
+                                   Size & value,
+                                   const Size minimum,
+                                   const Size maximum) const
+{
+    const char *arg = arguments().get(name);
+    char *end;
+
+    if (arg == ZERO)
+    {
+        return Success;
+    }
+
+    value = strtol(arg, &end, 10);
+
+    switch (*end)
+    {
+        case 'k': case 'K': value *= 1024; break;
+        case 'm': case 'M': value *= 1024 * 1024; break;
+        default: break;
+    }
+
+    if (value < minimum || value > maximum)
+    {
+        ERROR(name << " must be between " << minimum << " and " << maximum);
+        return InvalidArgument;
+    }
+
+    return Success;
+}
+
+IOBench::Result IOBench::runJobs(Report & report)
+{
+    const char **argv = new const char *[m_argc + 2];
+    char program[FileSystemPath::MaximumLength];
+    char jobArg[32];
+    int pids[MaximumJobs];
+    Result result = Success;
+
+    // Find the program like the shell does, if started without a path
+    if (m_argv[0][0] != '/')
+        snprintf(program, sizeof(program), "/bin/%s", m_argv[0]);
+    else
+        snprintf(program, sizeof(program), "%s", m_argv[0]);
+
+    // The processes get the same arguments plus their job index
+    for (int i = 0; i < m_argc; i++)
+    {
+        argv[i] = m_argv[i];
+    }
+    argv[m_argc] = jobArg;
+    argv[m_argc + 1] = ZERO;
+
+    const u64 start = now();
+
+    for (Size i = 0; i < m_jobs; i++)
+    {
+        snprintf(jobArg, sizeof(jobArg), "--job=%u", i);
+
+        if ((pids[i] = runProgram(program, argv)) == -1)
+        {
+            ERROR("failed to start job " << i << " with " << program);
+            m_jobs = i;
+            result = IOError;
+            break;
+        }
+    }
+
+    for (Size i = 0; i < m_jobs; i++)
+    {
+        int status;
+
+        if (waitpid(pids[i], &status, 0) == (pid_t) -1 || WEXITSTATUS(status) != 0)
+        {
+            ERROR("job " << i << " failed");
+            result = IOError;
+        }
+    }
+
+    // Combined throughput includes starting the processes
+    report.bytes = (u64) m_jobs * m_files * m_fileSize;
+    report.operations = (m_jobs * m_files * m_fileSize) / m_blockSize;
+    report.elapsed = now() - start;
+
+    delete[] argv;
+    return result;
+}
+
+IOBench::Result IOBench::runJob(const Size job, Report & report)
+{
+    const Size blocks = m_fileSize / m_blockSize;
+    u32 *latencies = new u32[m_files * blocks];
+    int fds[MaximumFiles];
+    char path[FileSystemPath::MaximumLength];
+    char name[64];
+    Result result = Success;
+    Size count = 0;
+
+    m_randomizer.seed(job + 1);
+
+    // Open the files of this job
+    for (Size i = 0; i < m_files; i++)
+    {
+        getPath(job, i, path, sizeof(path));
+
+        if ((fds[i] = openFile(path)) == -1)
+        {
+            ERROR("failed to open " << path);
+
+            for (Size j = 0; j < i; j++)
+                closeFile(fds[j]);
+
+            delete[] latencies;
+            return IOError;
+        }
+    }
+
+    const u64 start = now();
+
+    // Sequential jobs walk each file in turn, random jobs pick any block of any file
+    for (; count < m_files * blocks && result == Success; count++)
+    {
+        const Size index = m_random ? m_randomizer.next() % (m_files * blocks) : count;
+        const u64 t1 = now();
+
+        result = transfer(fds[index / blocks], (index % blocks) * m_blockSize, m_write);
+        latencies[count] = now() - t1;
+    }
+
+    report.elapsed = now() - start;
+    report.operations = count;
+    report.bytes = (u64) count * m_blockSize;
+
+    for (Size i = 0; i < m_files; i++)
+    {
+        closeFile(fds[i]);
+    }
+
+    if (result == Success)
+    {
+        snprintf(name, sizeof(name), "job %u", job);
+        printReport(name, report, latencies);
+    }
+
+    delete[] latencies;
+    return result;
+}
+
+IOBench::Result IOBench::prepareFiles(const bool create) const
+{
+    const FileSystemClient filesystem;
+    char path[FileSystemPath::MaximumLength];
+    Result result = Success;
+
+    for (Size job = 0; job < m_jobs; job++)
+    {
+        for (Size i = 0; i < m_files; i++)
+        {
+            getPath(job, i, path, sizeof(path));
+
+            if (!create)
+            {
+                filesystem.deleteFile(path);
+                continue;
+            }
+
+            // Fill the file, such that reads find data at every offset
+            if (filesystem.createFile(path, FileSystem::RegularFile, FileSystem::OwnerRW) != FileSystem::Success)
+            {
+                ERROR("failed to create " << path);
+                return IOError;
+            }
+
+            const int fd = open(path, O_RDWR);
+            if (fd == -1)
+            {
+                ERROR("failed to open " << path << ": " << strerror(errno));
+                return IOError;
+            }
+
+            for (Size offset = 0; offset < m_fileSize && result == Success; offset += m_blockSize)
+            {
+                if (write(fd, m_buffer, m_blockSize) != (ssize_t) m_blockSize)
+                {
+                    ERROR("failed to write " << path << ": " << strerror(errno));
+                    result = IOError;
+                }
+            }
+
+            close(fd);
+
+            if (result != Success)
+                return result;
+        }
+    }
+
+    return Success;
+}
+
+void IOBench::getPath(const Size job,
+                      const Size file,
+                      char *path,
+                      const Size size) const
+{
+    snprintf(path, size, "%s/iobench.%u.%u", m_directory, job, file);
+}
+
+int IOBench::openFile(const char *path) const
+{
+    if (m_interface == Posix)
+    {
+        return open(path, O_RDWR);
+    }
+
+    const FileSystemClient filesystem;
+    Size fd;
+
+    return filesystem.openFile(path, fd) == FileSystem::Success ? (int) fd : -1;
+}
+
+void IOBench::closeFile(const int fd) const
+{
+    if (m_interface == Posix)
+    {
+        close(fd);
+    }
+    else
+    {
+        const FileSystemClient filesystem;
+        filesystem.closeFile(fd);
+    }
+}
+
+IOBench::Result IOBench::transfer(const int fd, const Size offset, const bool write)
+{
+    if (m_interface == Posix)
+    {
+        lseek(fd, offset, SEEK_SET);
+
+        const ssize_t bytes = write ? ::write(fd, m_buffer, m_blockSize) :
+                                      ::read(fd, m_buffer, m_blockSize);
+        if (bytes != (ssize_t) m_blockSize)
+        {
+            ERROR("failed to " << (write ? "write" : "read") << " at offset " << offset <<
+                  ": " << strerror(errno));
+            return IOError;
+        }
+        return Success;
+    }
+
+    const FileSystemClient filesystem;
+    FileDescriptor::Entry *entry = FileDescriptor::instance()->getEntry(fd);
+    Size size = m_blockSize;
+
+    entry->position = offset;
+
+    const FileSystem::Result result = write ? filesystem.writeFile(fd, m_buffer, &size) :
+                                              filesystem.readFile(fd, m_buffer, &size);
+    if (result != FileSystem::Success || size != m_blockSize)
+    {
+        ERROR("failed to " << (write ? "write" : "read") << " at offset " << offset <<
+              ": result = " << (int) result);
+        return IOError;
+    }
+
+    return Success;
+}
+
+void IOBench::printReport(const char *name,
+                          const Report & report,
+                          u32 *latencies) const
+{
+    const u64 elapsed = report.elapsed ? report.elapsed : 1;
+    const Size count = report.operations;
+
+    printf("%s: %s%s bs=%u size=%u files=%u\r\n", name, m_random ? "rand" : "",
+           m_write ? "write" : "read", m_blockSize, m_fileSize, m_files);
+    printf("  %llu bytes in %llu usec: %llu KiB/s, %llu IOPS\r\n",
+           report.bytes, report.elapsed, (report.bytes * 1000000U) / (elapsed * 1024U),
+           ((u64) count * 1000000U) / elapsed);
+
+    if (latencies == ZERO || count == 0)
+    {
+        return;
+    }
+
+    // Sort the latencies for the percentiles
+    for (Size gap = count / 2; gap > 0; gap /= 2)
+    {
+        for (Size i = gap; i < count; i++)
+        {
+            const u32 value = latencies[i];
+            Size j = i;
+
+            for (; j >= gap && latencies[j - gap] > value; j -= gap)
+            {
+                latencies[j] = latencies[j - gap];
+            }
+            latencies[j] = value;
+        }
+    }
+
+    printf("  latency (usec): min=%u p50=%u p90=%u p99=%u max=%u\r\n",
+           latencies[0], latencies[count / 2], latencies[((count - 1) * 90) / 100],
+           latencies[((count - 1) * 99) / 100], latencies[count - 1]);
+}
+
+u64 IOBench::now() const
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, ZERO);
+    return ((u64) tv.tv_sec * 1000000U) + tv.tv_usec;
+}
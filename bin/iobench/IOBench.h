@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BIN_IOBENCH_IOBENCH_H
+#define __BIN_IOBENCH_IOBENCH_H
+
+#include <POSIXApplication.h>
+#include <Randomizer.h>
+
+/**
+ * @addtogroup bin
+ * @{
+ */
+
+/**
+ * Measure sustained file I/O performance of a mounted file system.
+ *
+ * Each job reads or writes its own set of files, sequentially or at
+ * random block aligned offsets, and reports the throughput, the number
+ * of operations per second and the latency percentiles. Multiple jobs
+ * run as separate processes at the same time. Files are accessed with
+ * POSIX read() and write(), or with the FileSystemClient directly.
+ */
+class IOBench : public POSIXApplication
+{
+  private:
+
+    /** Default number of bytes per operation */
+    static const Size DefaultBlockSize = 4096;
+
+    /** Minimum number of bytes per operation */
+    static const Size MinimumBlockSize = 512;
+
+    /** Maximum number of bytes per operation */
+    static const Size MaximumBlockSize = 1024 * 1024;
+
+    /** Default size of each file in bytes */
+    static const Size DefaultFileSize = 1024 * 1024;
+
+    /** Maximum size of each file in bytes */
+    static const Size MaximumFileSize = 64 * 1024 * 1024;
+
+    /** Maximum number of files per job */
+    static const Size MaximumFiles = 16;
+
+    /** Maximum number of jobs */
+    static const Size MaximumJobs = 8;
+
+    /**
+     * Interface used to access the files
+     */
+    enum Interface
+    {
+        Posix,
+        Client
+    };
+
+    /**
+     * Measurements of a single job
+     */
+    typedef struct Report
+    {
+        /** Number of bytes transferred */
+        u64 bytes;
+
+        /** Number of operations */
+        Size operations;
+
+        /** Total duration in microseconds */
+        u64 elapsed;
+    }
+    Report;
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param argc Argument count
+     * @param argv Argument values
+     */
+    IOBench(int argc, char **argv);
+
+    /**
+     * Destructor
+     */
+    virtual ~IOBench();
+
+    /**
+     * Execute the application.
+     *
+     * @return Result code
+     */
+    virtual Result exec();
+
+  private:
+
+    /**
+     * Parse a size argument with an optional k or m suffix.
+     *
+     * @param name Name of the argument
+     * @param value On input the default value, on output the parsed value
+     * @param minimum Smallest allowed value
+     * @param maximum Largest allowed value
+     *
+     * @return Result code
+     */
+    Result parseSize(const char *name,
+                     Size & value,
+                     const Size minimum,
+                     const Size maximum) const;
+
+    /**
+     * Start all jobs in separate processes and wait for them to finish.
+     *
+     * @param report Outputs the combined measurements
+     *
+     * @return Result code
+     */
+    Result runJobs(Report & report);
+
+    /**
+     * Run a single job in the current process.
+     *
+     * @param job Index of the job
+     * @param report Outputs the measurements
+     *
+     * @return Result code
+     */
+    Result runJob(const Size job, Report & report);
+
+    /**
+     * Create and fill all files, or delete them.
+     *
+     * @param create True to create the files, false to delete them
+     *
+     * @return Result code
+     */
+    Result prepareFiles(const bool create) const;
+
+    /**
+     * Get the path of a file.
+     *
+     * @param job Index of the job
+     * @param file Index of the file of the job
+     * @param path Output buffer for the path
+     * @param size Size of the output buffer
+     */
+    void getPath(const Size job,
+                 const Size file,
+                 char *path,
+                 const Size size) const;
+
+    /**
+     * Open a file.
+     *
+     * @param path Path of the file
+     *
+     * @return File descriptor or -1 on failure
+     */
+    int openFile(const char *path) const;
+
+    /**
+     * Close a file.
+     *
+     * @param fd File descriptor
+     */
+    void closeFile(const int fd) const;
+
+    /**
+     * Transfer a single block.
+     *
+     * @param fd File descriptor
+     * @param offset Offset in the file in bytes
+     * @param write True to write, false to read
+     *
+     * @return Result code
+     */
+    Result transfer(const int fd, const Size offset, const bool write);
+
+    /**
+     * Output measurements.
+     *
+     * @param name Name of the job(s)
+     * @param report Measurements
+     * @param latencies Latency of each operation in microseconds or ZERO
+     */
+    void printReport(const char *name,
+                     const Report & report,
+                     u32 *latencies) const;
+
+    /**
+     * Get the current time.
+     *
+     * @return Time in microseconds
+     */
+    u64 now() const;
+
+  private:
+
+    /** Directory to create the files in */
+    const char *m_directory;
+
+    /** Interface used to access the files */
+    Interface m_interface;
+
+    /** True to write, false to read */
+    bool m_write;
+
+    /** True for random offsets, false for sequential */
+    bool m_random;
+
+    /** Number of bytes per operation */
+    Size m_blockSize;
+
+    /** Size of each file in bytes */
+    Size m_fileSize;
+
+    /** Number of files per job */
+    Size m_files;
+
+    /** Number of jobs */
+    Size m_jobs;
+
+    /** Transfer buffer of one block */
+    u8 *m_buffer;
+
+    /** Generates random offsets */
+    Randomizer m_randomizer;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __BIN_IOBENCH_IOBENCH_H */
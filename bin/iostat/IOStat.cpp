@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FileSystemClient.h>
+#include <FileSystemMount.h>
+#include <MemoryBlock.h>
+#include <String.h>
+#include <List.h>
+#include <ListIterator.h>
+#include <Log.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "IOStat.h"
+
+IOStat::IOStat(int argc, char **argv)
+    : POSIXApplication(argc, argv)
+{
+    parser().setDescription("Report I/O statistics of mounted file systems");
+    parser().registerFlag('v', "verbose", "Also output the raw counters and latency histograms");
+    parser().registerPositional("PATH", "mount path to report (default all)", 0);
+}
+
+IOStat::Result IOStat::exec()
+{
+    const Vector<Argument *> & positionals = arguments().getPositionals();
+    const FileSystemClient filesystem;
+    const FileSystemMount *mounts;
+    Size numberOfMounts = 0;
+    Result result = Success;
+
+    printf("%-16s %8s %8s %8s %8s %10s %10s %6s %10s %5s\r\n",
+           "MOUNT", "READS", "WRITES", "STATS", "OTHER", "KB_READ",
+           "KB_WRITE", "ERRORS", "CYCLES", "HIT%");
+
+    // Report only the given mounts
+    if (positionals.count() > 0)
+    {
+        for (Size i = 0; i < positionals.count(); i++)
+        {
+            if (printMount(*(positionals[i]->getValue())) != Success)
+                result = IOError;
+        }
+        return result;
+    }
+
+    // Report all mounted file systems
+    mounts = filesystem.getFileSystems(numberOfMounts);
+    assert(mounts != NULL);
+
+    for (Size i = 0; i < numberOfMounts; i++)
+    {
+        if (mounts[i].path[0])
+        {
+            if (printMount(mounts[i].path) != Success)
+                result = IOError;
+        }
+    }
+
+    return result;
+}
+
+IOStat::Result IOStat::printMount(const char *mountPath) const
+{
+    char buf[MaximumFileSize];
+    String path;
+    Summary summary;
+    uint other = 0;
+    uint total = 0;
+    int fd, bytes;
+
+    // The statistics file lives in the sys directory of each mount
+    path << mountPath;
+    if (path.length() == 0 || mountPath[path.length() - 1] != '/')
+        path << "/";
+    path << "sys/iostat";
+
+    if ((fd = open(*path, O_RDONLY)) < 0)
+    {
+        ERROR("failed to open " << *path << ": " << strerror(errno));
+        return NotFound;
+    }
+
+    bytes = ::read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+
+    if (bytes < 0)
+    {
+        ERROR("failed to read " << *path << ": " << strerror(errno));
+        return IOError;
+    }
+    buf[bytes] = 0;
+
+    // Aggregate the counters
+    parse(buf, summary);
+
+    for (Size i = 0; i < IOStatistics::NumberOfOperations; i++)
+        total += summary.requests[i];
+
+    other = total - summary.requests[IOStatistics::Read] -
+                    summary.requests[IOStatistics::Write] -
+                    summary.requests[IOStatistics::Stat];
+
+    const uint lookups = summary.hits + summary.negative + summary.misses;
+
+    printf("%-16s %8u %8u %8u %8u %10u %10u %6u %10u %4u%%\r\n",
+           mountPath,
+           summary.requests[IOStatistics::Read],
+           summary.requests[IOStatistics::Write],
+           summary.requests[IOStatistics::Stat],
+           other,
+           summary.readKB,
+           summary.writeKB,
+           summary.errors,
+           total ? (uint) (summary.cycles / total) : 0,
+           lookups ? ((summary.hits + summary.negative) * 100) / lookups : 0);
+
+    if (arguments().get("verbose"))
+        printf("%s", buf);
+
+    return Success;
+}
+
+void IOStat::parse(const String &text, Summary &summary) const
+{
+    const List<String> lines = text.split('\n');
+
+    MemoryBlock::set(&summary, 0, sizeof(summary));
+
+    for (ListIterator<String> i(lines); i.hasCurrent(); i++)
+    {
+        const List<String> fields = i.current().split(' ');
+        const Size count = fields.count();
+
+        if (count == 0)
+            continue;
+
+        // Path lookup counters
+        if (fields[0] == "lookup" && count >= 7)
+        {
+            summary.hits     = fields[2].toLong();
+            summary.negative = fields[4].toLong();
+            summary.misses   = fields[6].toLong();
+            continue;
+        }
+
+        // Per operation counters
+        for (Size op = 0; op < IOStatistics::NumberOfOperations; op++)
+        {
+            if (fields[0] != IOStatistics::getName((IOStatistics::Operation) op) || count < 13)
+                continue;
+
+            const uint requests = fields[2].toLong();
+            const uint kbytes = fields[8].toLong();
+
+            summary.requests[op] = requests;
+            summary.errors += fields[4].toLong();
+            summary.cycles += (u64) fields[10].toLong() * requests;
+
+            if (op == IOStatistics::Read)
+                summary.readKB = kbytes;
+            else if (op == IOStatistics::Write)
+                summary.writeKB = kbytes;
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BIN_IOSTAT_IOSTAT_H
+#define __BIN_IOSTAT_IOSTAT_H
+
+#include <POSIXApplication.h>
+#include <IOStatistics.h>
+
+/**
+ * @addtogroup bin
+ * @{
+ */
+
+/**
+ * Report the I/O statistics of mounted file systems.
+ */
+class IOStat : public POSIXApplication
+{
+  private:
+
+    /** Maximum size of a statistics file. */
+    static const Size MaximumFileSize = 2048;
+
+    /**
+     * Aggregated counters of a single file system.
+     */
+    struct Summary
+    {
+        /** Requests per operation */
+        uint requests[IOStatistics::NumberOfOperations];
+
+        /** Number of failed requests */
+        uint errors;
+
+        /** Kilobytes read and written */
+        uint readKB, writeKB;
+
+        /** Total cycles spent on all requests */
+        u64 cycles;
+
+        /** Path lookups answered from the cache: positive, negative and misses */
+        uint hits, negative, misses;
+    };
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param argc Argument count
+     * @param argv Argument values
+     */
+    IOStat(int argc, char **argv);
+
+    /**
+     * Execute the application.
+     *
+     * @return Result code
+     */
+    virtual Result exec();
+
+  private:
+
+    /**
+     * Read and output the statistics of one file system.
+     *
+     * @param mountPath Mount path of the file system
+     *
+     * @return Result code
+     */
+    Result printMount(const char *mountPath) const;
+
+    /**
+     * Parse the contents of a statistics file.
+     *
+     * @param text Contents of the sys/iostat file
+     * @param summary Receives the aggregated counters
+     */
+    void parse(const String &text, Summary &summary) const;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __BIN_IOSTAT_IOSTAT_H */
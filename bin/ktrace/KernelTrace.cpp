@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Log.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "KernelTrace.h"
+
+KernelTrace::KernelTrace(int argc, char **argv)
+    : POSIXApplication(argc, argv)
+{
+    parser().setDescription("Drain and decode the kernel event trace");
+    parser().registerPositional("FILE", "trace file to read (default /sys/trace)", 0);
+}
+
+KernelTrace::Result KernelTrace::exec()
+{
+    const Vector<Argument *> & positionals = arguments().getPositionals();
+    const char *path = positionals.count() > 0 ? *(positionals[0]->getValue()) : "/sys/trace";
+    TraceRecord records[RecordBatch];
+    u64 start = 0;
+    bool first = true;
+    int fd;
+
+    // Open the trace file
+    if ((fd = open(path, O_RDONLY)) < 0)
+    {
+        ERROR("failed to open " << path << ": " << strerror(errno));
+        return NotFound;
+    }
+
+    printf("%10s %5s %12s %s\r\n", "CYCLES", "PID", "EVENT", "DETAILS");
+
+    // Drain records until the trace is empty
+    while (true)
+    {
+        const int bytes = ::read(fd, records, sizeof(records));
+        if (bytes < 0)
+        {
+            ERROR("failed to read " << path << ": " << strerror(errno));
+            close(fd);
+            return IOError;
+        }
+        else if (bytes == 0)
+        {
+            break;
+        }
+
+        for (Size i = 0; i < (Size) bytes / sizeof(TraceRecord); i++)
+        {
+            if (first)
+            {
+                start = records[i].timestamp;
+                first = false;
+            }
+            printRecord(records[i], start);
+        }
+    }
+
+    close(fd);
+    return Success;
+}
+
+void KernelTrace::printRecord(const TraceRecord &record, const u64 start) const
+{
+    const uint cycles = (uint) (record.timestamp - start);
+    char details[64];
+    const char *event = "unknown";
+
+    snprintf(details, sizeof(details), "%u %u", record.arg0, record.arg1);
+
+    switch (record.type)
+    {
+        case TraceLost:
+            event = "lost";
+            snprintf(details, sizeof(details), "%u records", record.arg0);
+            break;
+
+        case TraceSwitch:
+            event = "switch";
+            snprintf(details, sizeof(details), "next=%u %s", record.arg0,
+                     record.arg1 ? "voluntary" : "preempted");
+            break;
+
+        case TraceProcessEvent:
+            event = "event";
+            snprintf(details, sizeof(details), "target=%u type=%u", record.arg0, record.arg1);
+            break;
+
+        case TraceInterruptEnter:
+            event = "irq-enter";
+            snprintf(details, sizeof(details), "vector=%u", record.arg0);
+            break;
+
+        case TraceInterruptExit:
+            event = "irq-exit";
+            snprintf(details, sizeof(details), "vector=%u", record.arg0);
+            break;
+
+        case TraceWakeup:
+            event = "wakeup";
+            snprintf(details, sizeof(details), "target=%u", record.arg0);
+            break;
+
+        case TraceVMCtl:
+            event = "vmctl";
+            snprintf(details, sizeof(details), "target=%u op=%u", record.arg0, record.arg1);
+            break;
+
+        case TraceInherit:
+            event = "inherit";
+            snprintf(details, sizeof(details), "target=%u priority=%u", record.arg0, record.arg1);
+            break;
+    }
+
+    printf("%10u %5u %12s %s\r\n", cycles, record.pid, event, details);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BIN_KTRACE_KERNELTRACE_H
+#define __BIN_KTRACE_KERNELTRACE_H
+
+#include <POSIXApplication.h>
+#include <FreeNOS/User.h>
+
+/**
+ * @addtogroup bin
+ * @{
+ */
+
+/**
+ * Drain and decode the kernel event trace.
+ */
+class KernelTrace : public POSIXApplication
+{
+  private:
+
+    /** Number of records to read at once. */
+    static const Size RecordBatch = 32;
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param argc Argument count
+     * @param argv Argument values
+     */
+    KernelTrace(int argc, char **argv);
+
+    /**
+     * Execute the application.
+     *
+     * @return Result code
+     */
+    virtual Result exec();
+
+  private:
+
+    /**
+     * Output a decoded record.
+     *
+     * @param record Trace record to decode
+     * @param start Timestamp of the first record
+     */
+    void printRecord(const TraceRecord &record, const u64 start) const;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __BIN_KTRACE_KERNELTRACE_H */
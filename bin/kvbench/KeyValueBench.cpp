@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FileSystemPath.h>
+#include <MemoryBlock.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include "KeyValueBench.h"
+
+KeyValueBench::KeyValueBench(int argc, char **argv)
+    : POSIXApplication(argc, argv)
+    , m_mode(Put)
+    , m_operations(1000)
+    , m_keys(100)
+    , m_valueSize(64)
+    , m_jobs(1)
+{
+    parser().setDescription("Measure key-value store performance");
+    parser().registerFlag('m', "mode", "Operations: put, get or mixed (default put)");
+    parser().registerFlag('n', "operations", "Number of operations per job (default 1000)");
+    parser().registerFlag('k', "keys", "Number of keys per job (default 100)");
+    parser().registerFlag('s', "size", "Bytes per value (default 64)");
+    parser().registerFlag('j', "jobs", "Number of processes (default 1)");
+    parser().registerFlag('x', "job", "Run only the given job (used for the processes of -j)");
+}
+
+KeyValueBench::Result KeyValueBench::exec()
+{
+    const char *mode = arguments().get("mode");
+    Result result;
+
+    // Parse options
+    if (mode == ZERO || strcmp(mode, "put") == 0)
+        m_mode = Put;
+    else if (strcmp(mode, "get") == 0)
+        m_mode = Get;
+    else if (strcmp(mode, "mixed") == 0)
+        m_mode = Mixed;
+    else
+    {
+        ERROR("unknown mode: " << mode);
+        return InvalidArgument;
+    }
+
+    if ((result = parseNumber("operations", m_operations, 1, MaximumOperations)) != Success ||
+        (result = parseNumber("keys", m_keys, 1, MaximumKeys)) != Success ||
+        (result = parseNumber("size", m_valueSize, 1, KeyValue::MaximumValueSize)) != Success ||
+        (result = parseNumber("jobs", m_jobs, 1, MaximumJobs)) != Success)
+    {
+        return result;
+    }
+
+    MemoryBlock::set(m_value, 0xaa, sizeof(m_value));
+
+    // Processes started for -j only run their own job
+    if (arguments().get("job"))
+    {
+        const Size job = atoi(arguments().get("job"));
+
+        if (job >= m_jobs)
+        {
+            ERROR("job must be less than " << m_jobs);
+            return InvalidArgument;
+        }
+
+        return runJob(job);
+    }
+
+    return m_jobs == 1 ? runJob(0) : runJobs();
+}
+
+KeyValueBench::Result KeyValueBench::parseNumber(const char *name,
+                                                 Size & value,
+                                                 const Size minimum,
+                                                 const Size maximum) const
+{
+    const char *arg = arguments().get(name);
+
+    if (arg == ZERO)
+    {
+        return Success;
+    }
+
+    value = atoi(arg);
+
+    if (value < minimum || value > maximum)
+    {
+        ERROR(name << " must be between " << minimum << " and " << maximum);
+        return InvalidArgument;
+    }
+
+    return Success;
+}
+
+KeyValueBench::Result KeyValueBench::runJobs()
+{
+    const char **argv = new const char *[m_argc + 2];
+    char program[FileSystemPath::MaximumLength];
+    char jobArg[32];
+    int pids[MaximumJobs];
+    Result result = Success;
+
+    // Find the program like the shell does, if started without a path
+    if (m_argv[0][0] != '/')
+        snprintf(program, sizeof(program), "/bin/%s", m_argv[0]);
+    else
+        snprintf(program, sizeof(program), "%s", m_argv[0]);
+
+    // The processes get the same arguments plus their job index
+    for (int i = 0; i < m_argc; i++)
+    {
+        argv[i] = m_argv[i];
+    }
+    argv[m_argc] = jobArg;
+    argv[m_argc + 1] = ZERO;
+
+    const u64 start = now();
+
+    for (Size i = 0; i < m_jobs; i++)
+    {
+        snprintf(jobArg, sizeof(jobArg), "--job=%u", i);
+
+        if ((pids[i] = runProgram(program, argv)) == -1)
+        {
+            ERROR("failed to start job " << i << " with " << program);
+            m_jobs = i;
+            result = IOError;
+            break;
+        }
+    }
+
+    for (Size i = 0; i < m_jobs; i++)
+    {
+        int status;
+
+        if (waitpid(pids[i], &status, 0) == (pid_t) -1 || WEXITSTATUS(status) != 0)
+        {
+            ERROR("job " << i << " failed");
+            result = IOError;
+        }
+    }
+
+    // Combined throughput includes starting the processes and filling the keys
+    if (result == Success)
+    {
+        printReport("all jobs", m_jobs * m_operations, now() - start, ZERO);
+    }
+
+    delete[] argv;
+    return result;
+}
+
+KeyValueBench::Result KeyValueBench::runJob(const Size job)
+{
+    u32 *latencies = new u32[m_operations];
+    char key[KeyValue::MaximumKeySize];
+    char name[32];
+    KeyValue::Result result = KeyValue::Success;
+    Size count = 0;
+
+    m_randomizer.seed(job + 1);
+
+    // Reads need existing keys
+    if (m_mode != Put && fillKeys(job) != Success)
+    {
+        delete[] latencies;
+        return IOError;
+    }
+
+    const u64 start = now();
+
+    for (; count < m_operations && result == KeyValue::Success; count++)
+    {
+        const bool put = m_mode == Put || (m_mode == Mixed && (m_randomizer.next() & 1));
+        Size size = sizeof(m_value);
+        const u64 t1 = now();
+
+        getKey(job, m_randomizer.next() % m_keys, key);
+
+        if (put)
+            result = m_client.put(key, m_value, m_valueSize);
+        else
+            result = m_client.get(key, m_value, size);
+
+        latencies[count] = now() - t1;
+    }
+
+    const u64 elapsed = now() - start;
+
+    if (result != KeyValue::Success)
+    {
+        ERROR("operation failed: result = " << (int) result);
+        delete[] latencies;
+        return IOError;
+    }
+
+    snprintf(name, sizeof(name), "job %u", job);
+    printReport(name, count, elapsed, latencies);
+
+    delete[] latencies;
+    return Success;
+}
+
+KeyValueBench::Result KeyValueBench::fillKeys(const Size job) const
+{
+    char key[KeyValue::MaximumKeySize];
+
+    for (Size i = 0; i < m_keys; i++)
+    {
+        getKey(job, i, key);
+
+        const KeyValue::Result result = m_client.put(key, m_value, m_valueSize);
+        if (result != KeyValue::Success)
+        {
+            ERROR("failed to put " << key << ": result = " << (int) result);
+            return IOError;
+        }
+    }
+
+    return Success;
+}
+
+void KeyValueBench::getKey(const Size job, const Size index, char *key) const
+{
+    snprintf(key, KeyValue::MaximumKeySize, "kvbench.%u.%u", job, index);
+}
+
+void KeyValueBench::printReport(const char *name,
+                                const Size operations,
+                                const u64 elapsed,
+                                u32 *latencies) const
+{
+    static const char *modes[] = { "put", "get", "mixed" };
+    const u64 duration = elapsed ? elapsed : 1;
+
+    printf("%s: %s keys=%u size=%u\r\n", name, modes[m_mode], m_keys, m_valueSize);
+    printf("  %u operations in %llu usec: %llu ops/s\r\n",
+           operations, elapsed, ((u64) operations * 1000000U) / duration);
+
+    if (latencies == ZERO || operations == 0)
+    {
+        return;
+    }
+
+    // Sort the latencies for the percentiles
+    for (Size gap = operations / 2; gap > 0; gap /= 2)
+    {
+        for (Size i = gap; i < operations; i++)
+        {
+            const u32 value = latencies[i];
+            Size j = i;
+
+            for (; j >= gap && latencies[j - gap] > value; j -= gap)
+            {
+                latencies[j] = latencies[j - gap];
+            }
+            latencies[j] = value;
+        }
+    }
+
+    printf("  latency (usec): min=%u p50=%u p90=%u p99=%u max=%u\r\n",
+           latencies[0], latencies[operations / 2], latencies[((operations - 1) * 90) / 100],
+           latencies[((operations - 1) * 99) / 100], latencies[operations - 1]);
+}
+
+u64 KeyValueBench::now() const
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, ZERO);
+    return ((u64) tv.tv_sec * 1000000U) + tv.tv_usec;
+}
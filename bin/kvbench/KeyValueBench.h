@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BIN_KVBENCH_KEYVALUEBENCH_H
+#define __BIN_KVBENCH_KEYVALUEBENCH_H
+
+#include <POSIXApplication.h>
+#include <Randomizer.h>
+#include <KeyValueClient.h>
+
+/**
+ * @addtogroup bin
+ * @{
+ */
+
+/**
+ * Measure the performance of the key-value store server.
+ *
+ * Each job puts, gets, or randomly puts and gets values of its own set
+ * of keys and reports the number of operations per second and the latency
+ * percentiles. Multiple jobs run as separate processes at the same time,
+ * which lets the server commit their updates in groups.
+ */
+class KeyValueBench : public POSIXApplication
+{
+  private:
+
+    /** Maximum number of jobs */
+    static const Size MaximumJobs = 8;
+
+    /** Maximum number of operations per job */
+    static const Size MaximumOperations = 1000000;
+
+    /** Maximum number of keys per job */
+    static const Size MaximumKeys = 100000;
+
+    /**
+     * Operations performed by the jobs
+     */
+    enum Mode
+    {
+        Put,
+        Get,
+        Mixed
+    };
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param argc Argument count
+     * @param argv Argument values
+     */
+    KeyValueBench(int argc, char **argv);
+
+    /**
+     * Execute the application.
+     *
+     * @return Result code
+     */
+    virtual Result exec();
+
+  private:
+
+    /**
+     * Parse a number argument.
+     *
+     * @param name Name of the argument
+     * @param value On input the default value, on output the parsed value
+     * @param minimum Smallest allowed value
+     * @param maximum Largest allowed value
+     *
+     * @return Result code
+     */
+    Result parseNumber(const char *name,
+                       Size & value,
+                       const Size minimum,
+                       const Size maximum) const;
+
+    /**
+     * Start all jobs in separate processes and wait for them to finish.
+     *
+     * @return Result code
+     */
+    Result runJobs();
+
+    /**
+     * Run a single job in the current process.
+     *
+     * @param job Index of the job
+     *
+     * @return Result code
+     */
+    Result runJob(const Size job);
+
+    /**
+     * Put a value for each key of a job.
+     *
+     * @param job Index of the job
+     *
+     * @return Result code
+     */
+    Result fillKeys(const Size job) const;
+
+    /**
+     * Get the name of a key.
+     *
+     * @param job Index of the job
+     * @param index Index of the key of the job
+     * @param key Output buffer of KeyValue::MaximumKeySize bytes
+     */
+    void getKey(const Size job, const Size index, char *key) const;
+
+    /**
+     * Output measurements.
+     *
+     * @param name Name of the job(s)
+     * @param operations Number of operations
+     * @param elapsed Total duration in microseconds
+     * @param latencies Latency of each operation in microseconds or ZERO
+     */
+    void printReport(const char *name,
+                     const Size operations,
+                     const u64 elapsed,
+                     u32 *latencies) const;
+
+    /**
+     * Get the current time.
+     *
+     * @return Time in microseconds
+     */
+    u64 now() const;
+
+  private:
+
+    /** Client of the server */
+    const KeyValueClient m_client;
+
+    /** Operations performed by the jobs */
+    Mode m_mode;
+
+    /** Number of operations per job */
+    Size m_operations;
+
+    /** Number of keys per job */
+    Size m_keys;
+
+    /** Number of bytes of each value */
+    Size m_valueSize;
+
+    /** Number of jobs */
+    Size m_jobs;
+
+    /** Value data */
+    u8 m_value[KeyValue::MaximumValueSize];
+
+    /** Selects random keys and operations */
+    Randomizer m_randomizer;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __BIN_KVBENCH_KEYVALUEBENCH_H */
@@ -17,7 +17,6 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <dirent.h>
 #include <string.h>
 #include <errno.h>
 #include <unistd.h>
@@ -25,6 +24,8 @@
 #include <limits.h>
 #include <libgen.h>
 #include <TerminalCodes.h>
+#include <FileSystemClient.h>
+#include <Directory.h>
 #include "ListFiles.h"
 
 ListFiles::ListFiles(int argc, char **argv)
@@ -75,11 +76,8 @@ ListFiles::Result ListFiles::exec()
 
 ListFiles::Result ListFiles::printFiles(const String & path) const
 {
-    struct dirent *dent;
     struct stat st;
-    char tmp[PATH_MAX];
     String out;
-    DIR *d;
     Result r = Success;
 
     // Retrieve file status
@@ -92,30 +90,12 @@ ListFiles::Result ListFiles::printFiles(const String & path) const
     // Is the given file a directory?
     if (S_ISDIR(st.st_mode))
     {
-        // Attempt to open the directory
-        if (!(d = opendir(*path)))
-        {
-            ERROR("failed to open '" << *path << "': " << strerror(errno));
-            return IOError;
-        }
-
-        // Read directory
-        while ((dent = readdir(d)))
-        {
-            // Construct full path
-            snprintf(tmp, sizeof(tmp),
-                    "%s/%s", *path, dent->d_name);
-
-            if ((r = printSingleFile(tmp, out)) != Success)
-                break;
-        }
-        // Close it
-        closedir(d);
+        r = printDirectory(path, out);
     }
     // The given file is not a directory
     else
     {
-        r = printSingleFile(path, out);
+        r = printSingleFile(path, st, out);
     }
 
     // Final newline
@@ -129,18 +109,59 @@ ListFiles::Result ListFiles::printFiles(const String & path) const
     return r;
 }
 
-ListFiles::Result ListFiles::printSingleFile(const String & path, String & out) const
+ListFiles::Result ListFiles::printDirectory(const String & path, String & out) const
 {
-    const bool color = arguments().get("no-color") == ZERO;
-    struct stat st;
+    const FileSystemClient filesystem;
+    Size count = MaximumEntries;
+    Dirent *entries = new Dirent[count];
+    FileSystem::FileStat *stats = new FileSystem::FileStat[count];
+    char tmp[PATH_MAX];
+    Result r = Success;
 
-    // Retrieve file status
-    if (stat(*path, &st) != 0)
+    // Read all entries including their status
+    const FileSystem::Result result = filesystem.readDirectory(*path, entries, stats, count);
+    if (result != FileSystem::Success)
     {
-        ERROR("failed to stat '" << *path << "': " << strerror(errno));
+        ERROR("failed to open '" << *path << "': result = " << (int) result);
+        delete[] entries;
+        delete[] stats;
         return IOError;
     }
 
+    // Print all entries
+    for (Size i = 0; i < count; i++)
+    {
+        struct stat st;
+
+        // Construct full path
+        snprintf(tmp, sizeof(tmp),
+                "%s/%s", *path, entries[i].name);
+
+        // Retrieve the status separately if not included
+        if (stats[i].type != FileSystem::UnknownFile)
+        {
+            st.fromFileStat(&stats[i]);
+        }
+        else if (stat(tmp, &st) != 0)
+        {
+            ERROR("failed to stat '" << tmp << "': " << strerror(errno));
+            r = IOError;
+            break;
+        }
+
+        if ((r = printSingleFile(tmp, st, out)) != Success)
+            break;
+    }
+
+    delete[] entries;
+    delete[] stats;
+    return r;
+}
+
+ListFiles::Result ListFiles::printSingleFile(const String & path, const struct stat & st, String & out) const
+{
+    const bool color = arguments().get("no-color") == ZERO;
+
     // Apply long output
     if (arguments().get("long"))
     {
@@ -19,6 +19,7 @@
 #define __BIN_LS_LS_H
 
 #include <POSIXApplication.h>
+#include <sys/stat.h>
 
 /**
  * @addtogroup bin
@@ -30,6 +31,11 @@
  */
 class ListFiles : public POSIXApplication
 {
+  private:
+
+    /** Maximum number of entries listed in a directory */
+    static const Size MaximumEntries = 1024;
+
   public:
 
     /**
@@ -63,15 +69,26 @@ class ListFiles : public POSIXApplication
      */
     Result printFiles(const String & path) const;
 
+    /**
+     * List all files inside a directory
+     *
+     * @param path Path to the directory
+     * @param out String to write the output to
+     *
+     * @return Result code
+     */
+    Result printDirectory(const String & path, String & out) const;
+
     /**
      * List single file on the filesystem
      *
      * @param path Path to the file to list
+     * @param st File status of the file
      * @param out String to write the output to
      *
      * @return Result code
      */
-    Result printSingleFile(const String & path, String & out) const;
+    Result printSingleFile(const String & path, const struct stat & st, String & out) const;
 };
 
 /**
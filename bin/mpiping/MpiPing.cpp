@@ -17,19 +17,30 @@
 
 #include <Log.h>
 #include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
 #include "MpiPing.h"
 
 MpiPing::MpiPing(int argc, char **argv)
     : POSIXApplication(argc, argv)
     , m_mpiInitResult(MPI_Init(&m_argc, &m_argv))
     , m_id(0)
+    , m_peer(0)
+    , m_sendBuffer(ZERO)
+    , m_recvBuffer(ZERO)
 {
     parser().setDescription("Send ping message to cores via MPI");
+    parser().registerFlag('b', "benchmark", "Measure latency and bandwidth between rank 0 and 1");
+    parser().registerFlag('s', "size", "Largest message size in bytes of the benchmark (default 4MiB)");
+    parser().registerFlag('i', "iterations", "Number of measured iterations per size (default 100)");
 }
 
 MpiPing::~MpiPing()
 {
     DEBUG("");
+    delete[] m_sendBuffer;
+    delete[] m_recvBuffer;
 }
 
 MpiPing::Result MpiPing::initialize()
@@ -54,7 +65,15 @@ MpiPing::Result MpiPing::exec()
 {
     int result, cores;
 
-    if (m_id == 0)
+    if (arguments().get("benchmark"))
+    {
+        const Result benchResult = benchmark();
+        if (benchResult != Success)
+        {
+            return benchResult;
+        }
+    }
+    else if (m_id == 0)
     {
         result = MPI_Comm_size(MPI_COMM_WORLD, &cores);
         if (result != MPI_SUCCESS)
@@ -112,6 +131,210 @@ MpiPing::Result MpiPing::exec()
     return Success;
 }
 
+MpiPing::Result MpiPing::benchmark()
+{
+    Size maximumSize = DefaultMaximumSize;
+    Size iterations = DefaultIterations;
+    int cores;
+
+    if (arguments().get("size"))
+    {
+        maximumSize = atoi(arguments().get("size"));
+    }
+
+    if (arguments().get("iterations"))
+    {
+        iterations = atoi(arguments().get("iterations"));
+    }
+
+    if (maximumSize == 0 || iterations < 10)
+    {
+        ERROR("size must be non-zero and iterations must be at least 10");
+        return InvalidArgument;
+    }
+
+    int result = MPI_Comm_size(MPI_COMM_WORLD, &cores);
+    if (result != MPI_SUCCESS)
+    {
+        ERROR("failed to lookup MPI core count: result = " << result);
+        return IOError;
+    }
+
+    if (cores < 2)
+    {
+        ERROR("benchmark needs at least two cores");
+        return InvalidArgument;
+    }
+
+    // Only rank 0 and 1 take part
+    if (m_id > 1)
+    {
+        return Success;
+    }
+    m_peer = m_id == 0 ? 1 : 0;
+
+    m_sendBuffer = new u8[maximumSize];
+    m_recvBuffer = new u8[maximumSize];
+    if (!m_sendBuffer || !m_recvBuffer)
+    {
+        ERROR("failed to allocate benchmark buffers of " << maximumSize << " bytes");
+        return OutOfMemory;
+    }
+
+    for (Size i = 0; i < maximumSize; i++)
+    {
+        m_sendBuffer[i] = i;
+    }
+
+    if (m_id == 0)
+    {
+        printf("# mpiping benchmark: rank 0 <-> rank 1, %u cores, window %u, %u iterations\r\n",
+               cores, (uint) WindowSize, (uint) iterations);
+        printf("# size(B)    latency(us)  bw(MB/s)     bibw(MB/s)   rate(msg/s)\r\n");
+    }
+
+    for (Size size = 1; size <= maximumSize; size *= 2)
+    {
+        const Size count = size > LargeMessageSize ? iterations / 10 : iterations;
+        u64 latencyUsec, bandwidthUsec, bidirectionalUsec;
+
+        if (measureLatency(size, count, latencyUsec) != Success ||
+            measureBandwidth(size, count, false, bandwidthUsec) != Success ||
+            measureBandwidth(size, count, true, bidirectionalUsec) != Success)
+        {
+            ERROR("benchmark failed at message size " << size);
+            return IOError;
+        }
+
+        if (m_id == 0)
+        {
+            const u64 messages = (u64) WindowSize * count;
+            const u64 latency = (latencyUsec * 10) / (count * 2);
+            char latencyText[16];
+
+            // Bytes per microsecond equals megabytes per second
+            bandwidthUsec = bandwidthUsec ? bandwidthUsec : 1;
+            bidirectionalUsec = bidirectionalUsec ? bidirectionalUsec : 1;
+
+            snprintf(latencyText, sizeof(latencyText), "%u.%u",
+                     (uint) (latency / 10), (uint) (latency % 10));
+
+            printf("%12u %12s %12u %12u %12u\r\n", (uint) size, latencyText,
+                   (uint) ((messages * size) / bandwidthUsec),
+                   (uint) ((messages * size * 2) / bidirectionalUsec),
+                   (uint) ((messages * 1000000) / bandwidthUsec));
+        }
+    }
+
+    return Success;
+}
+
+MpiPing::Result MpiPing::measureLatency(const Size size,
+                                        const Size iterations,
+                                        u64 & usec)
+{
+    const Size warmup = iterations / 10;
+    MPI_Status status;
+    u64 start = 0;
+
+    for (Size i = 0; i < warmup + iterations; i++)
+    {
+        int result;
+
+        if (i == warmup)
+        {
+            start = timestamp();
+        }
+
+        if (m_id == 0)
+        {
+            result = MPI_Send(m_sendBuffer, size, MPI_BYTE, m_peer, 0, MPI_COMM_WORLD);
+            if (result == MPI_SUCCESS)
+                result = MPI_Recv(m_recvBuffer, size, MPI_BYTE, m_peer, 0, MPI_COMM_WORLD, &status);
+        }
+        else
+        {
+            result = MPI_Recv(m_recvBuffer, size, MPI_BYTE, m_peer, 0, MPI_COMM_WORLD, &status);
+            if (result == MPI_SUCCESS)
+                result = MPI_Send(m_sendBuffer, size, MPI_BYTE, m_peer, 0, MPI_COMM_WORLD);
+        }
+
+        if (result != MPI_SUCCESS)
+        {
+            ERROR("ping-pong with rank " << m_peer << " failed: result = " << result);
+            return IOError;
+        }
+    }
+
+    usec = timestamp() - start;
+    return Success;
+}
+
+MpiPing::Result MpiPing::measureBandwidth(const Size size,
+                                          const Size iterations,
+                                          const bool bidirectional,
+                                          u64 & usec)
+{
+    const Size warmup = iterations / 10;
+    MPI_Request requests[WindowSize * 2];
+    MPI_Status status;
+    u8 ack = 0;
+    u64 start = 0;
+
+    for (Size i = 0; i < warmup + iterations; i++)
+    {
+        const bool sender = bidirectional || m_id == 0;
+        const bool receiver = bidirectional || m_id != 0;
+        Size count = 0;
+        int result = MPI_SUCCESS;
+
+        if (i == warmup)
+        {
+            start = timestamp();
+        }
+
+        // Post a full window of receives before the sends
+        for (Size j = 0; receiver && j < WindowSize && result == MPI_SUCCESS; j++)
+        {
+            result = MPI_Irecv(m_recvBuffer, size, MPI_BYTE, m_peer, 0, MPI_COMM_WORLD, &requests[count++]);
+        }
+
+        for (Size j = 0; sender && j < WindowSize && result == MPI_SUCCESS; j++)
+        {
+            result = MPI_Isend(m_sendBuffer, size, MPI_BYTE, m_peer, 0, MPI_COMM_WORLD, &requests[count++]);
+        }
+
+        if (result == MPI_SUCCESS)
+        {
+            result = MPI_Waitall(count, requests, ZERO);
+        }
+
+        // The receiver acknowledges the window, such that the sender measures delivery
+        if (result == MPI_SUCCESS && !bidirectional)
+        {
+            result = m_id == 0 ? MPI_Recv(&ack, 1, MPI_BYTE, m_peer, 0, MPI_COMM_WORLD, &status) :
+                                 MPI_Send(&ack, 1, MPI_BYTE, m_peer, 0, MPI_COMM_WORLD);
+        }
+
+        if (result != MPI_SUCCESS)
+        {
+            ERROR("window transfer with rank " << m_peer << " failed: result = " << result);
+            return IOError;
+        }
+    }
+
+    usec = timestamp() - start;
+    return Success;
+}
+
+u64 MpiPing::timestamp()
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, ZERO);
+    return ((u64) tv.tv_sec * 1000000) + tv.tv_usec;
+}
+
 MpiPing::Result MpiPing::sendNumber(const Size coreId,
                                     const int number) const
 {
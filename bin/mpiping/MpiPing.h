@@ -27,6 +27,10 @@
 
 /**
  * Send a ping message via MPI to all available nodes.
+ *
+ * With the benchmark flag, ranks 0 and 1 instead sweep message sizes
+ * and report one-way latency, unidirectional and bidirectional bandwidth
+ * and message rate in a fixed table format.
  */
 class MpiPing : public POSIXApplication
 {
@@ -38,6 +42,18 @@ class MpiPing : public POSIXApplication
     /** Magic number send for the pong message */
     static const int PongMagicNumber = 0x12345678;
 
+    /** Default largest message size of the benchmark sweep */
+    static const Size DefaultMaximumSize = 4 * 1024 * 1024;
+
+    /** Default number of measured iterations for each message size */
+    static const Size DefaultIterations = 100;
+
+    /** Messages larger than this are measured with a tenth of the iterations */
+    static const Size LargeMessageSize = 64 * 1024;
+
+    /** Number of messages in flight while measuring bandwidth */
+    static const Size WindowSize = 32;
+
   public:
 
     /**
@@ -69,6 +85,48 @@ class MpiPing : public POSIXApplication
 
   private:
 
+    /**
+     * Run the benchmark sweep.
+     *
+     * @return Result code
+     */
+    Result benchmark();
+
+    /**
+     * Measure the round-trip time of messages between rank 0 and 1.
+     *
+     * @param size Message size in bytes
+     * @param iterations Number of measured round-trips
+     * @param usec Receives the elapsed time in microseconds
+     *
+     * @return Result code
+     */
+    Result measureLatency(const Size size,
+                          const Size iterations,
+                          u64 & usec);
+
+    /**
+     * Measure the time to transfer windows of messages between rank 0 and 1.
+     *
+     * @param size Message size in bytes
+     * @param iterations Number of measured windows
+     * @param bidirectional True to send in both directions at the same time
+     * @param usec Receives the elapsed time in microseconds
+     *
+     * @return Result code
+     */
+    Result measureBandwidth(const Size size,
+                            const Size iterations,
+                            const bool bidirectional,
+                            u64 & usec);
+
+    /**
+     * Get the current time.
+     *
+     * @return Time in microseconds
+     */
+    static u64 timestamp();
+
     /**
      * Send a message containing a number
      *
@@ -98,6 +156,15 @@ class MpiPing : public POSIXApplication
 
     /** MPI core identifier (rank) of the current process */
     int m_id;
+
+    /** Rank on the other side of the benchmark */
+    int m_peer;
+
+    /** Benchmark send buffer */
+    u8 *m_sendBuffer;
+
+    /** Benchmark receive buffer */
+    u8 *m_recvBuffer;
 };
 
 /**
@@ -17,6 +17,7 @@
 
 #include <Log.h>
 #include <String.h>
+#include <BitArray.h>
 #include <SystemClock.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -31,13 +32,23 @@ MpiPrime::MpiPrime(int argc, char **argv)
     : SievePrime(argc, argv)
     , m_mpiInitResult(MPI_Init(&m_argc, &m_argv))
     , m_id(0)
+    , m_cores(0)
+    , m_segmentSize(DefaultSegmentSize)
+    , m_primes(ZERO)
+    , m_primeCount(0)
+    , m_bitsPerCore(0)
+    , m_bitStart(0)
+    , m_bitEnd(0)
 {
     parser().setDescription("Calculate prime numbers in parallel");
+    parser().registerFlag('w', "weak", "NUMBER is the amount of numbers per core (weak scaling)");
+    parser().registerFlag('s', "segment", "Segment size in bytes (default 32KiB, use the L2 size to compare)");
 }
 
 MpiPrime::~MpiPrime()
 {
     DEBUG("");
+    delete[] m_primes;
 }
 
 MpiPrime::Result MpiPrime::initialize()
@@ -67,179 +78,243 @@ MpiPrime::Result MpiPrime::initialize()
 
 MpiPrime::Result MpiPrime::exec()
 {
-    int n, k;
-    u8 *root_map, *map;
-    String output;
-    SystemClock t1, t2;
-
-    // Retrieve maximum number (n)
-    t1.now();
-    n = atoi(arguments().get("NUMBER"));
-
-    // Make sure n is divisible by the number of workers
-    if ((n % m_cores) != 0)
+    const bool weak = arguments().get("weak") != ZERO;
+    const bool keep = arguments().get("stdout") != ZERO;
+    SystemClock t1, t2, t3;
+    Size n = atoi(arguments().get("NUMBER"));
+    Size count = 0, total = 0;
+    uint sieveTime, sieveMax = 0, sieveSum = 0;
+    u8 *map, *results = ZERO;
+
+    // With weak scaling every core receives the same amount of work
+    if (weak)
     {
-        n += m_cores;
-        n -= (n % m_cores);
+        n *= m_cores;
     }
 
-    int n_root = sqrt(n);
-    m_numbersPerCore = (n - n_root) / m_cores;
-    m_numberStart = n_root + (m_id * m_numbersPerCore);
-    m_numberEnd = m_numberStart + m_numbersPerCore;
+    if (n < 2)
+    {
+        ERROR("NUMBER must be at least 2");
+        return InvalidArgument;
+    }
 
-    // Allocate memory for root map
-    if ((root_map = (u8 *) malloc(n_root * sizeof(u8))) == NULL)
+    if (arguments().get("segment"))
     {
-        ERROR("malloc failed: " << strerror(errno));
-        return IOError;
+        m_segmentSize = atoi(arguments().get("segment"));
+
+        if (m_segmentSize == 0)
+        {
+            ERROR("segment size must be non-zero");
+            return InvalidArgument;
+        }
     }
 
-    // Initialize root map. Clear all entries
-    for (int i = 0; i < n_root; i++)
-        root_map[i] = 1;
+    // Divide the odd numbers in byte aligned parts
+    const Size bits = (n + 1) / 2;
+    m_bitsPerCore = (((bits + m_cores - 1) / m_cores) + 7) & ~7;
+    m_bitStart = m_id * m_bitsPerCore;
+    m_bitEnd = m_bitStart + m_bitsPerCore < bits ? m_bitStart + m_bitsPerCore : bits;
 
-    // Try to allocate memory for results
-    if ((map = (u8 *) malloc(m_numbersPerCore * sizeof(u8))) == NULL)
+    // Only keep all bits when the primes are printed
+    if ((map = new u8[keep ? m_bitsPerCore / 8 : m_segmentSize]) == NULL)
     {
-        ERROR("malloc failed: " << strerror(errno));
-        return IOError;
+        ERROR("failed to allocate prime map");
+        return OutOfMemory;
     }
 
-    // Initialize results map. Clear all entries
-    for (Size i = 0; i < m_numbersPerCore; i++)
-        map[i] = 1;
+    t1.now();
 
-    // We start with 2
-    k = 2;
-    t2.now();
+    Size root = sqrt(n);
+    while ((root + 1) * (root + 1) <= n)
+        root++;
 
-    if (m_id == 0)
+    Result result = searchBase(root);
+    if (result == Success)
     {
-        printf("Setup: ");
-        t1.printDiff(t2);
+        result = searchSegments(map, keep, count);
+    }
+
+    if (result != Success)
+    {
+        delete[] map;
+        return result;
     }
 
-    // Search for primes until done
-    t1.now();
-    searchParallel(k, n, root_map, map);
     t2.now();
+    sieveTime = elapsed(t1, t2);
 
-    printf("Search_parallel: ");
-    t1.printDiff(t2);
-    t1.now();
+    MPI_Reduce(&count, &total, 1, MPI_UNSIGNED, MPI_SUM, 0, MPI_COMM_WORLD);
+    t3.now();
 
-    // Free resources
-    MPI_Finalize();
-    free(map);
+    MPI_Reduce(&sieveTime, &sieveMax, 1, MPI_UNSIGNED, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&sieveTime, &sieveSum, 1, MPI_UNSIGNED, MPI_SUM, 0, MPI_COMM_WORLD);
 
+    if (keep)
+    {
+        if (m_id == 0 && (results = new u8[(m_bitsPerCore / 8) * m_cores]) == NULL)
+        {
+            ERROR("failed to allocate results map");
+            delete[] map;
+            return OutOfMemory;
+        }
+
+        MPI_Gather(map, m_bitsPerCore / 8, MPI_UNSIGNED_CHAR,
+                   results, m_bitsPerCore / 8, MPI_UNSIGNED_CHAR, 0, MPI_COMM_WORLD);
+
+        if (m_id == 0)
+        {
+            report(results, bits);
+            delete[] results;
+        }
+    }
+
+    // Only the master reports the results
     if (m_id == 0)
     {
-        t2.now();
-        printf("Finalize: ");
-        t1.printDiff(t2);
+        sieveMax = sieveMax ? sieveMax : 1;
+
+        printf("mpiprime: n=%u scaling=%s ranks=%u segment=%u primes=%u\r\n",
+               (uint) n, weak ? "weak" : "strong", (uint) m_cores, (uint) m_segmentSize, (uint) total);
+        printf("mpiprime: sieve_msec=%u efficiency=%u%% reduce_msec=%u total_msec=%u\r\n",
+               sieveMax, (uint) ((sieveSum * 100) / (sieveMax * m_cores)),
+               elapsed(t2, t3), elapsed(t1, t3));
     }
 
+    MPI_Finalize();
+    delete[] map;
     return Success;
 }
 
-MpiPrime::Result MpiPrime::searchParallel(int k, int n, u8 *rootMap, u8 *map)
+MpiPrime::Result MpiPrime::searchBase(const Size root)
 {
-    SystemClock t1, t2;
-    int sqrt_of_n = sqrt(n);
-
-    // Find all primes below sqrt(n) sequentially
-    t1.now();
-    searchSequential(sqrt_of_n, rootMap);
+    const Size bits = (root + 1) / 2;
+    BitArray composite(bits > 0 ? bits : 1);
 
-    if (m_id == 0)
+    // Sieve the odd numbers up to the root sequentially
+    for (Size i = 1; (2 * i + 1) * (2 * i + 1) <= root; i++)
     {
-        t2.now();
-        printf("sequential: ");
-        t1.printDiff(t2);
+        if (!composite.isSet(i))
+        {
+            const Size prime = 2 * i + 1;
 
-        t1.now();
+            for (Size j = (prime * prime) / 2; j < bits; j += prime)
+            {
+                composite.set(j);
+            }
+        }
     }
 
-    // Every worker calculates all primes k .. sqrt(n) sequentially
-    // and uses the result to mark it's part of the map, concurrently
-    // Note that no communication is needed
-    while (k < sqrt_of_n)
+    if ((m_primes = new Size[bits > 0 ? bits : 1]) == NULL)
     {
-        // Prime number?
-        if (!rootMap[k])
-        {
-            k++;
-            continue;
-        }
+        ERROR("failed to allocate base primes");
+        return OutOfMemory;
+    }
 
-        // Mark multiples of k in my range
-        for (Size i = m_numberStart; i < m_numberEnd; i++)
+    for (Size i = 1; i < bits; i++)
+    {
+        if (!composite.isSet(i))
         {
-            // Do we need to unmark this number? (no prime)
-            if (!(i % k))
-            {
-                map[i - m_numberStart] = 0;
-            }
+            m_primes[m_primeCount++] = 2 * i + 1;
         }
+    }
 
-        // Look for the next prime
-        k++;
+    return Success;
+}
+
+MpiPrime::Result MpiPrime::searchSegments(u8 *map,
+                                          const bool keep,
+                                          Size & count)
+{
+    const Size segmentBits = m_segmentSize * 8;
+    Size *next = new Size[m_primeCount + 1];
+
+    if (next == NULL)
+    {
+        ERROR("failed to allocate sieve offsets");
+        return OutOfMemory;
     }
 
-    if (m_id == 0)
+    // Find the first odd multiple of each prime in our range, starting at its square
+    for (Size i = 0; i < m_primeCount; i++)
     {
-        t2.now();
-        printf("parallel: ");
-        t1.printDiff(t2);
+        const Size prime = m_primes[i];
+        const Size low = (2 * m_bitStart) + 1;
+        Size multiple = prime * prime;
+
+        if (multiple < low)
+        {
+            multiple = ((low + prime - 1) / prime) * prime;
+
+            if (!(multiple & 1))
+                multiple += prime;
+        }
+        next[i] = multiple / 2;
     }
 
-    // Collect results of all workers
-    t1.now();
-    collect(n, rootMap, map);
+    // Bit zero is the number one, which stands in for the even prime two
+    count = 0;
 
-    if (m_id == 0)
+    // Each segment stays in the cache while all primes mark it
+    for (Size from = m_bitStart; from < m_bitEnd; from += segmentBits)
     {
-        t2.now();
-        printf("collect: ");
-        t1.printDiff(t2);
+        const Size to = from + segmentBits < m_bitEnd ? from + segmentBits : m_bitEnd;
+        BitArray segment(to - from, keep ? map + ((from - m_bitStart) / 8) : map);
 
-        t1.now();
+        for (Size i = 0; i < m_primeCount; i++)
+        {
+            Size bit = next[i];
+
+            for (; bit < to; bit += m_primes[i])
+            {
+                segment.set(bit - from);
+            }
+            next[i] = bit;
+        }
+
+        count += segment.count(false);
     }
 
+    delete[] next;
     return Success;
 }
 
-MpiPrime::Result MpiPrime::collect(int n, u8 *rootMap, u8 *map)
+MpiPrime::Result MpiPrime::report(const u8 *map,
+                                  const Size bits) const
 {
-    MPI_Status status;
-    const int sqrt_of_n = sqrt(n);
+    Size resultsWritten = 1;
+    String output;
 
-    // Every worker sends it's results to the master
-    if (m_id != 0)
-    {
-        // Send mybuf to the master
-        MPI_Send(map, m_numbersPerCore, MPI_UNSIGNED_CHAR, 0, 0, MPI_COMM_WORLD);
-    }
-    // The master gathers the parts of the list from every worker
-    else
-    {
-        Size resultsWritten = 0;
-        reportResult(sqrt_of_n, rootMap, resultsWritten);
-        reportResult(m_numbersPerCore, map, resultsWritten, sqrt_of_n);
+    output << " 2";
 
-        for (Size i = 1; i < m_cores; i++)
+    for (Size i = 1; i < bits; i++)
+    {
+        if (!(map[i / 8] & (1 << (i % 8))))
         {
-            // Receive from worker
-            MPI_Recv(map, m_numbersPerCore, MPI_UNSIGNED_CHAR, i, 0, MPI_COMM_WORLD, &status);
-
-            // Only the master reports the results.
-            reportResult(m_numbersPerCore, map, resultsWritten, (m_numbersPerCore * i) + sqrt_of_n);
+            output << " " << ((2 * i) + 1);
+            resultsWritten++;
         }
 
-        write(1, "\r\n", 2);
+        if (resultsWritten >= 32)
+        {
+            output << "\r\n";
+            write(1, *output, output.length());
+            output = "";
+            resultsWritten = 0;
+        }
     }
 
-    // Cleanup
+    output << "\r\n";
+    write(1, *output, output.length());
     return Success;
 }
+
+uint MpiPrime::elapsed(const SystemClock & t1,
+                       const SystemClock & t2)
+{
+    struct timeval v1, v2;
+
+    t1.value(v1);
+    t2.value(v2);
+
+    return ((v2.tv_sec - v1.tv_sec) * 1000) + ((v2.tv_usec - v1.tv_usec) / 1000);
+}
@@ -19,6 +19,7 @@
 #define __BIN_MPIPRIME_MPIPRIME_H
 
 #include <POSIXApplication.h>
+#include <SystemClock.h>
 #include "SievePrime.h"
 
 /**
@@ -28,11 +29,19 @@
 
 /**
  * Calculate prime numbers in parallel.
+ *
+ * Every rank sieves an equal share of the odd numbers, in segments
+ * which fit in the cache. Each segment is a bit-packed BitArray where
+ * bit i represents the odd number 2i + 1. The counts of all ranks
+ * are combined with MPI_Reduce.
  */
 class MpiPrime : public SievePrime
 {
   private:
 
+    /** Default segment size in bytes, which fits in a typical L1 data cache */
+    static const Size DefaultSegmentSize = 32 * 1024;
+
   public:
 
     /**
@@ -65,27 +74,48 @@ class MpiPrime : public SievePrime
   private:
 
     /**
-     * Calculate prime numbers in parallel
+     * Find the odd prime numbers up to the square root of the maximum
+     *
+     * @param root Largest number to search for primes
+     *
+     * @return Result code
+     */
+    Result searchBase(const Size root);
+
+    /**
+     * Sieve the odd numbers of this rank segment by segment
      *
-     * @param k Start number to search for primes
-     * @param n Upper limit to search for primes
-     * @param rootMap Pointer to the root primes array
-     * @param map Pointer to results array
+     * @param map Output bits for all numbers of this rank, or a single segment
+     * @param keep True if map holds all numbers of this rank
+     * @param count Receives the number of primes found
      *
      * @return Result code
      */
-    Result searchParallel(int k, int n, u8 *rootMap, u8 *map);
+    Result searchSegments(u8 *map,
+                          const bool keep,
+                          Size & count);
 
     /**
-     * Collect prime number results
+     * Print all prime numbers in the bit-packed map of all ranks
      *
-     * @param n Upper limit to search for primes
-     * @param rootMap Pointer to the root primes array
-     * @param map Pointer to results array
+     * @param map Bits of all odd numbers
+     * @param bits Number of valid bits
      *
      * @return Result code
      */
-    Result collect(int n, u8 *rootMap, u8 *map);
+    Result report(const u8 *map,
+                  const Size bits) const;
+
+    /**
+     * Calculate the time between two clocks
+     *
+     * @param t1 Start time
+     * @param t2 End time
+     *
+     * @return Milliseconds
+     */
+    static uint elapsed(const SystemClock & t1,
+                        const SystemClock & t2);
 
   private:
 
@@ -98,14 +128,23 @@ class MpiPrime : public SievePrime
     /** Total number of cores */
     Size m_cores;
 
-    /** Prime numbers calculated per core */
-    Size m_numbersPerCore;
+    /** Segment size in bytes */
+    Size m_segmentSize;
+
+    /** Odd prime numbers up to the square root of the maximum */
+    Size *m_primes;
+
+    /** Number of entries in m_primes */
+    Size m_primeCount;
+
+    /** Number of bits (odd numbers) per core, a multiple of eight */
+    Size m_bitsPerCore;
 
-    /** Prime numbers array range start for this core */
-    Size m_numberStart;
+    /** First bit of this core */
+    Size m_bitStart;
 
-    /** Prime numbers array range end for this core */
-    Size m_numberEnd;
+    /** End of the bits of this core */
+    Size m_bitEnd;
 };
 
 /**
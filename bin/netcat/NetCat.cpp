@@ -25,6 +25,8 @@
 #include <MemoryBlock.h>
 #include <NetworkClient.h>
 #include <NetworkSocket.h>
+#include <NetworkMeter.h>
+#include <NetworkQueue.h>
 #include <IPV4.h>
 #include <ICMP.h>
 #include "NetCat.h"
@@ -44,6 +46,11 @@ NetCat::NetCat(int argc, char **argv)
     parser().registerFlag('u', "udp", "use UDP for transport");
     parser().registerFlag('t', "tcp", "use TCP for transport");
     parser().registerFlag('l', "listen", "listen mode");
+    parser().registerFlag('r', "reuse-port", "share the listen port with other processes");
+    parser().registerFlag('e', "echo", "send received datagrams back to their sender");
+    parser().registerFlag('c', "count", "send or receive this number of datagrams and report the throughput");
+    parser().registerFlag('R', "rate", "number of datagrams per second to send");
+    parser().registerFlag('s', "size", "payload size of datagrams to send in bytes (default 1024)");
 }
 
 NetCat::~NetCat()
@@ -79,6 +86,14 @@ NetCat::Result NetCat::initialize()
     // Convert to port
     m_port = atoi(arguments().get("PORT"));
 
+    // Allow other listeners on the same port
+    if (arguments().get("reuse-port") &&
+        m_client->setReusePort(m_socket, true) != NetworkClient::Success)
+    {
+        ERROR("failed to set reuse port on socket");
+        return IOError;
+    }
+
     // Bind to a local port.
     if (m_client->bindSocket(m_socket, 0, arguments().get("listen") ? m_port : 0))
     {
@@ -97,7 +112,17 @@ NetCat::Result NetCat::exec()
     DEBUG("sending to host: " << arguments().get("HOST") <<
           " on port " << arguments().get("PORT"));
 
-    if (arguments().get("listen"))
+    const Size count = arguments().get("count") ? atoi(arguments().get("count")) : 0;
+
+    if (arguments().get("listen") && arguments().get("echo"))
+    {
+        return udpEcho();
+    }
+    else if (count)
+    {
+        return arguments().get("listen") ? udpSink(count) : udpSource(count);
+    }
+    else if (arguments().get("listen"))
     {
         // Keep receiving from UDP
         while (1)
@@ -211,3 +236,98 @@ NetCat::Result NetCat::udpReceive()
     m_lineBuf[r] = ZERO;
     return Success;
 }
+
+NetCat::Result NetCat::udpEcho()
+{
+    static u8 packet[NetworkQueue::PayloadBufferSize];
+    struct sockaddr addr;
+
+    DEBUG("");
+
+    while (true)
+    {
+        const int r = recvfrom(m_socket, packet, sizeof(packet) - sizeof(addr), 0, &addr, sizeof(addr));
+        if (r < 0)
+        {
+            ERROR("failed to receive UDP datagram: " << strerror(errno));
+            return IOError;
+        }
+
+        if (::sendto(m_socket, packet, r, 0, &addr, sizeof(addr)) < 0)
+        {
+            ERROR("failed to send UDP datagram: " << strerror(errno));
+            return IOError;
+        }
+    }
+
+    return Success;
+}
+
+NetCat::Result NetCat::udpSink(const Size count)
+{
+    static u8 packet[NetworkQueue::PayloadBufferSize];
+    struct sockaddr addr;
+    NetworkMeter meter;
+
+    DEBUG("count = " << count);
+
+    for (Size i = 0; i < count; i++)
+    {
+        const int r = recvfrom(m_socket, packet, sizeof(packet) - sizeof(addr), 0, &addr, sizeof(addr));
+        if (r < 0)
+        {
+            ERROR("failed to receive UDP datagram: " << strerror(errno));
+            return IOError;
+        }
+
+        // Measure from the first datagram on
+        if (i == 0)
+            meter.start();
+
+        meter.addPackets(1, r);
+    }
+
+    meter.stop();
+    printf("%s\r\n", *meter.toString());
+    return Success;
+}
+
+NetCat::Result NetCat::udpSource(const Size count)
+{
+    static u8 packet[MaximumSize];
+    const Size size = arguments().get("size") ? atoi(arguments().get("size")) : DefaultSize;
+    const Size rate = arguments().get("rate") ? atoi(arguments().get("rate")) : 0;
+    NetworkMeter meter;
+
+    DEBUG("count = " << count << " size = " << size << " rate = " << rate);
+
+    if (size == 0 || size > MaximumSize)
+    {
+        ERROR("size must be between 1 and " << MaximumSize << " bytes");
+        return InvalidArgument;
+    }
+
+    struct sockaddr addr;
+    addr.addr = m_host;
+    addr.port = m_port;
+
+    MemoryBlock::set(packet, 'x', size);
+    meter.start(rate);
+
+    for (Size i = 0; i < count; i++)
+    {
+        meter.pace();
+
+        if (::sendto(m_socket, packet, size, 0, &addr, sizeof(addr)) <= 0)
+        {
+            ERROR("failed to send UDP datagram: " << strerror(errno));
+            return IOError;
+        }
+
+        meter.addPackets(1, size);
+    }
+
+    meter.stop();
+    printf("%s\r\n", *meter.toString());
+    return Success;
+}
@@ -33,6 +33,14 @@
  */
 class NetCat : public POSIXApplication
 {
+  private:
+
+    /** Default payload size of generated datagrams in bytes */
+    static const Size DefaultSize = 1024;
+
+    /** Maximum payload size of generated datagrams in bytes */
+    static const Size MaximumSize = 1448;
+
   public:
 
     /**
@@ -69,6 +77,31 @@ class NetCat : public POSIXApplication
 
     Result udpReceive();
 
+    /**
+     * Send every received UDP datagram back to its sender
+     *
+     * @return Result code
+     */
+    Result udpEcho();
+
+    /**
+     * Receive UDP datagrams and report the throughput
+     *
+     * @param count Number of datagrams to receive
+     *
+     * @return Result code
+     */
+    Result udpSink(const Size count);
+
+    /**
+     * Send UDP datagrams and report the throughput
+     *
+     * @param count Number of datagrams to send
+     *
+     * @return Result code
+     */
+    Result udpSource(const Size count);
+
     Result printLine();
 
     /** Networking client */
@@ -34,7 +34,8 @@ NetCtl::NetCtl(int argc, char **argv)
     : POSIXApplication(argc, argv)
 {
     parser().setDescription("control network devices");
-    parser().registerPositional("ARGS", "optional key=value arguments", 0);
+    parser().registerFlag('s', "stats", "Show packet statistics of each device");
+    parser().registerPositional("ARGS", "optional key=value arguments: device=NAME mtu=BYTES", 0);
 }
 
 NetCtl::~NetCtl()
@@ -49,10 +50,33 @@ NetCtl::Result NetCtl::initialize()
 
 NetCtl::Result NetCtl::exec()
 {
+    const Vector<Argument *> & positionals = arguments().getPositionals();
+    const char *device = ZERO;
     Size numberOfMounts = 0;
+    Size mtu = 0;
 
     DEBUG("");
 
+    // Parse key=value arguments
+    for (Size i = 0; i < positionals.count(); i++)
+    {
+        const char *arg = *positionals[i]->getValue();
+
+        if (strncmp(arg, "device=", 7) == 0)
+        {
+            device = arg + 7;
+        }
+        else if (strncmp(arg, "mtu=", 4) == 0 && atoi(arg + 4) > 0)
+        {
+            mtu = atoi(arg + 4);
+        }
+        else
+        {
+            ERROR("invalid argument: " << arg);
+            return InvalidArgument;
+        }
+    }
+
     // Make a list of network devices
     // Get a list of mounts
     FileSystemClient filesystem;
@@ -63,7 +87,26 @@ NetCtl::Result NetCtl::exec()
     {
         if (mounts[i].path[0] && strncmp(mounts[i].path, "/network/", 9) == 0)
         {
+            if (device && strcmp(mounts[i].path + 9, device) != 0)
+            {
+                continue;
+            }
+
+            if (mtu)
+            {
+                const Result result = setMTU(mounts[i].path + 9, mtu);
+                if (result != Success)
+                {
+                    return result;
+                }
+            }
+
             showDevice(mounts[i].path + 9);
+
+            if (arguments().get("stats"))
+            {
+                showStatistics(mounts[i].path + 9);
+            }
         }
     }
     return Success;
@@ -73,7 +116,7 @@ NetCtl::Result NetCtl::showDevice(const char *deviceName)
 {
     DEBUG("");
 
-    String ipv4, ether, out;
+    String ipv4, ether, mtu, out;
     ether << "/network/" << deviceName << "/ethernet/address";
     ipv4  << "/network/" << deviceName << "/ipv4/address";
     out   << deviceName << " ipv4 ";
@@ -108,6 +151,84 @@ NetCtl::Result NetCtl::showDevice(const char *deviceName)
         close(fd);
     }
 
+    // The mtu file starts with the current MTU
+    mtu << "/network/" << deviceName << "/mtu";
+
+    fd = open(*mtu, O_RDONLY);
+    if (fd != -1)
+    {
+        char buf[64];
+
+        r = read(fd, buf, sizeof(buf) - 1);
+        if (r > 4)
+        {
+            buf[r] = 0;
+            out << " mtu " << atoi(buf + 4);
+        }
+        close(fd);
+    }
+
     printf("%s\r\n", *out);
     return Success;
 }
+
+NetCtl::Result NetCtl::showStatistics(const char *deviceName)
+{
+    DEBUG("");
+
+    String path;
+    path << "/network/" << deviceName << "/stats";
+
+    int fd = open(*path, O_RDONLY);
+    if (fd == -1)
+    {
+        ERROR("failed to open " << *path << ": " << strerror(errno));
+        return IOError;
+    }
+
+    // Output the statistics file with the proper line endings
+    char buf[128];
+    int r;
+
+    while ((r = read(fd, buf, sizeof(buf))) > 0)
+    {
+        for (int i = 0; i < r; i++)
+        {
+            if (buf[i] == '\n')
+                printf("\r\n");
+            else
+                printf("%c", buf[i]);
+        }
+    }
+
+    close(fd);
+    return r == -1 ? IOError : Success;
+}
+
+NetCtl::Result NetCtl::setMTU(const char *deviceName,
+                              const Size mtu)
+{
+    DEBUG("deviceName = " << deviceName << " mtu = " << mtu);
+
+    String path, value;
+    path  << "/network/" << deviceName << "/mtu";
+    value << (uint) mtu;
+
+    int fd = open(*path, O_WRONLY);
+    if (fd == -1)
+    {
+        ERROR("failed to open " << *path << ": " << strerror(errno));
+        return IOError;
+    }
+
+    const int r = write(fd, *value, value.length());
+    close(fd);
+
+    if (r == -1)
+    {
+        ERROR("failed to set MTU of " << deviceName << " to " << mtu << ": " << strerror(errno));
+        return InvalidArgument;
+    }
+
+    return Success;
+}
@@ -64,6 +64,24 @@ class NetCtl : public POSIXApplication
      */
     Result showDevice(const char *deviceName);
 
+    /**
+     * Output packet statistics of a device
+     *
+     * @param deviceName Name of the network device
+     * @return Result code
+     */
+    Result showStatistics(const char *deviceName);
+
+    /**
+     * Change the maximum transmission unit of a device
+     *
+     * @param deviceName Name of the network device
+     * @param mtu New MTU in bytes
+     * @return Result code
+     */
+    Result setMTU(const char *deviceName,
+                  const Size mtu);
+
 };
 
 /**
@@ -15,9 +15,12 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <FreeNOS/System.h>
 #include <MemoryBlock.h>
 #include <NetworkClient.h>
 #include <NetworkSocket.h>
+#include <NetworkMeter.h>
+#include <NetworkQueue.h>
 #include <IPV4.h>
 #include <ICMP.h>
 #include <stdio.h>
@@ -26,6 +29,7 @@
 #include <unistd.h>
 #include <errno.h>
 #include <string.h>
+#include <sys/socket.h>
 #include "NetPing.h"
 
 NetPing::NetPing(int argc, char **argv)
@@ -36,6 +40,10 @@ NetPing::NetPing(int argc, char **argv)
     parser().registerPositional("HOST", "host address to ping");
     parser().registerFlag('a', "arp", "send ARP pings");
     parser().registerFlag('i', "icmp", "send ICMP pings");
+    parser().registerFlag('u', "udp", "send UDP pings to the echo service at the given port");
+    parser().registerFlag('c', "count", "number of pings, sent back-to-back unless a rate is given");
+    parser().registerFlag('r', "rate", "number of pings per second");
+    parser().registerFlag('s', "size", "payload size of UDP pings in bytes (default 64)");
 }
 
 NetPing::~NetPing()
@@ -49,10 +57,16 @@ NetPing::Result NetPing::exec()
     const char *dev  = arguments().get("DEVICE");
     const char *host = arguments().get("HOST");
     const char *icmp = arguments().get("icmp");
+    const char *udp  = arguments().get("udp");
 
     DEBUG("sending on device: " << dev);
 
-    if (icmp)
+    if (udp)
+    {
+        DEBUG("sending UDP packets");
+        return udpPing(dev, host, atoi(udp));
+    }
+    else if (icmp)
     {
         DEBUG("sending ICMP packets");
         return icmpPing(dev, host);
@@ -159,44 +173,169 @@ NetPing::Result NetPing::icmpPing(const char *dev, const char *host)
         return IOError;
     }
 
-    // Send an echo request
-    ICMP::Header msg;
-    msg.type     = ICMP::EchoRequest;
-    msg.code     = 0;
-    msg.checksum = 0;
-    msg.id       = 1;
-    msg.sequence = 1;
+    const Size count = getCount();
+    NetworkMeter meter;
+    meter.start(getRate());
+
+    for (Size i = 0; i < count; i++)
+    {
+        meter.pace();
+
+        // Send an echo request
+        ICMP::Header msg;
+        msg.type     = ICMP::EchoRequest;
+        msg.code     = 0;
+        msg.checksum = 0;
+        msg.id       = 1;
+        msg.sequence = i + 1;
+
+        // Generate checksum
+        msg.checksum = IPV4::checksum(&msg, sizeof(msg));
+
+        // Send the packet
+        const u64 start = timestamp();
+
+        if (::write(sock, &msg, sizeof(msg)) <= 0)
+        {
+            ERROR("failed to send ICMP request: " << strerror(errno));
+            return IOError;
+        }
+
+        if (count == 1)
+            printf("Sending ICMP request to %s\r\n", host);
+
+        // Receive echo reply
+        if (::read(sock, &msg, sizeof(msg)) <= 0)
+        {
+            ERROR("failed to receive ICMP response: " << strerror(errno));
+            return IOError;
+        }
+
+        meter.addRoundTrip(timestamp() - start);
+        meter.addPackets(1, sizeof(msg));
+
+        // Check message type
+        if (msg.type != ICMP::EchoReply)
+        {
+            ERROR("invalid ICMP code in response: " << (int) msg.type);
+            return IOError;
+        }
+
+        // Print the ICMP address received
+        if (count == 1)
+            printf("Received ICMP response with id=%d sequence=%d\r\n",
+                    msg.id, msg.sequence);
+    }
+
+    meter.stop();
 
-    // Generate checksum
-    msg.checksum = IPV4::checksum(&msg, sizeof(msg));
+    if (count > 1)
+        printf("%s\r\n", *meter.toString());
 
-    // Send the packet
-    if (::write(sock, &msg, sizeof(msg)) <= 0)
+    // Finished
+    ::close(sock);
+    return Success;
+}
+
+NetPing::Result NetPing::udpPing(const char *dev, const char *host, const u16 port)
+{
+    NetworkClient client(dev);
+    NetworkClient::Result result;
+    static u8 payload[NetworkQueue::PayloadBufferSize];
+    const Size size = arguments().get("size") ? atoi(arguments().get("size")) : 64;
+    int sock;
+
+    DEBUG("port = " << port << " size = " << size);
+
+    if (size < sizeof(u32) || size > MaximumPayload)
     {
-        ERROR("failed to send ICMP request: " << strerror(errno));
-        return IOError;
+        ERROR("size must be between " << sizeof(u32) << " and " << MaximumPayload << " bytes");
+        return InvalidArgument;
     }
-    printf("Sending ICMP request to %s\r\n", host);
 
-    // Receive echo reply
-    if (::read(sock, &msg, sizeof(msg)) <= 0)
+    // Initialize networking client
+    result = client.initialize();
+    if (result != NetworkClient::Success)
     {
-        ERROR("failed to receive ICMP response: " << strerror(errno));
+        ERROR("failed to initialize network client for device: " << dev <<
+              ", result = " << (int) result);
         return IOError;
     }
 
-    // Check message type
-    if (msg.type != ICMP::EchoReply)
+    // Create an UDP socket on any local port
+    result = client.createSocket(NetworkClient::UDP, &sock);
+    if (result == NetworkClient::Success)
+        result = client.bindSocket(sock, 0, 0);
+
+    if (result != NetworkClient::Success)
     {
-        ERROR("invalid ICMP code in response: " << (int) msg.type);
+        ERROR("failed to create UDP socket: result = " << (int) result);
         return IOError;
     }
 
-    // Print the ICMP address received
-    printf("Received ICMP response with id=%d sequence=%d\r\n",
-            msg.id, msg.sequence);
+    struct sockaddr addr;
+    addr.addr = IPV4::toAddress(host);
+    addr.port = port;
 
-    // Finished
-    ::close(sock);
+    const Size count = getCount();
+    NetworkMeter meter;
+    meter.start(getRate());
+
+    for (Size i = 0; i < count; i++)
+    {
+        meter.pace();
+
+        // Each ping carries its sequence number
+        MemoryBlock::set(payload, i, size);
+        *(u32 *) payload = i;
+
+        const u64 start = timestamp();
+
+        if (::sendto(sock, payload, size, 0, &addr, sizeof(addr)) <= 0)
+        {
+            ERROR("failed to send UDP ping: " << strerror(errno));
+            return IOError;
+        }
+
+        // Skip late replies of earlier pings
+        do
+        {
+            struct sockaddr from;
+
+            if (::recvfrom(sock, payload, size, 0, &from, sizeof(from)) <= 0)
+            {
+                ERROR("failed to receive UDP pong: " << strerror(errno));
+                return IOError;
+            }
+        }
+        while (*(u32 *) payload != i);
+
+        meter.addRoundTrip(timestamp() - start);
+        meter.addPackets(1, size);
+
+        if (count == 1)
+            printf("Received UDP pong from %s port %u\r\n", host, port);
+    }
+
+    meter.stop();
+
+    if (count > 1)
+        printf("%s\r\n", *meter.toString());
+
+    client.close(sock);
     return Success;
 }
+
+Size NetPing::getCount() const
+{
+    const char *count = arguments().get("count");
+
+    return count && atoi(count) > 0 ? atoi(count) : 1;
+}
+
+Size NetPing::getRate() const
+{
+    const char *rate = arguments().get("rate");
+
+    return rate ? atoi(rate) : 0;
+}
@@ -32,6 +32,11 @@
  */
 class NetPing : public POSIXApplication
 {
+  private:
+
+    /** Maximum payload size of UDP pings in bytes */
+    static const Size MaximumPayload = 1448;
+
   public:
 
     /**
@@ -60,6 +65,25 @@ class NetPing : public POSIXApplication
      * Send ICMP ping/pong.
      */
     Result icmpPing(const char *dev, const char *host);
+
+    /**
+     * Send UDP ping/pong to an echo service.
+     */
+    Result udpPing(const char *dev, const char *host, const u16 port);
+
+    /**
+     * Get the number of pings to send.
+     *
+     * @return Number of pings
+     */
+    Size getCount() const;
+
+    /**
+     * Get the rate of pings.
+     *
+     * @return Pings per second or zero to send them back-to-back
+     */
+    Size getRate() const;
 };
 
 /**
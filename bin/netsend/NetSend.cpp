@@ -16,12 +16,19 @@
  */
 
 #include <MemoryBlock.h>
+#include <FileSystemClient.h>
 #include <NetworkClient.h>
 #include <NetworkSocket.h>
+#include <NetworkMeter.h>
 #include <String.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "NetSend.h"
 
 NetSend::NetSend(int argc, char **argv)
@@ -31,7 +38,10 @@ NetSend::NetSend(int argc, char **argv)
     parser().registerPositional("DEVICE", "device name of network adapter");
     parser().registerPositional("HOST", "host address to send to");
     parser().registerPositional("PORT", "UDP port to use");
-    parser().registerPositional("COUNT", "number of packets to send");
+    parser().registerPositional("COUNT", "number of packets to send, or times to send each FILE");
+    parser().registerPositional("FILE", "send the contents of the file(s) instead", 0);
+    parser().registerFlag('r', "rate", "Packets per second to send (default unlimited)");
+    parser().registerFlag('s', "size", "Payload size of each packet in bytes (default 1448)");
 }
 
 NetSend::~NetSend()
@@ -91,23 +101,61 @@ NetSend::Result NetSend::exec()
     addr.addr = host;
     addr.port = port;
 
+    // Send the given files, if any
+    const Vector<Argument *> & positionals = arguments().getPositionals();
+
+    for (Size i = 4; i < positionals.count(); i++)
+    {
+        const Result r = udpSpliceFile(*(positionals[i]->getValue()), addr, count);
+        if (r != Success)
+        {
+            return r;
+        }
+    }
+
+    if (positionals.count() > 4)
+    {
+        return Success;
+    }
+
+    const Size rate = arguments().get("rate") ? atoi(arguments().get("rate")) : 0;
+    const Size size = arguments().get("size") ? atoi(arguments().get("size")) : PacketSize;
+
+    if (size == 0 || size > PacketSize)
+    {
+        ERROR("size must be between 1 and " << PacketSize << " bytes");
+        return InvalidArgument;
+    }
+
     // Prepare I/O vector with generated packets for sending
-    static u8 pkts[NetworkQueue::MaxPackets][NetworkQueue::PayloadBufferSize];
+    static u8 pkts[NetworkQueue::BatchPackets][NetworkQueue::PayloadBufferSize];
     static struct iovec vec[QueueSize];
 
     for (Size i = 0; i < QueueSize; i++)
     {
-        MemoryBlock::set(pkts[i], i, PacketSize);
+        MemoryBlock::set(pkts[i], i, size);
 
         vec[i].iov_base = pkts[i];
-        vec[i].iov_len = PacketSize;
+        vec[i].iov_len = size;
     }
 
+    // Smaller batches keep a low rate evenly spread
+    Size batch = rate ? rate / BatchesPerSecond : QueueSize;
+    if (batch == 0)
+        batch = 1;
+    else if (batch > QueueSize)
+        batch = QueueSize;
+
+    NetworkMeter meter;
+    meter.start(rate);
+
     // Keep sending packets until we reach the number to send
     for (Size i = 0; i < count;)
     {
-        const Size num = count - i >= QueueSize ?
-                         QueueSize : count - i;
+        const Size num = count - i >= batch ?
+                         batch : count - i;
+
+        meter.pace();
 
         const Result r = udpSendMultiple(vec, num, addr);
         if (r != Success)
@@ -116,9 +164,13 @@ NetSend::Result NetSend::exec()
             return r;
         }
 
+        meter.addPackets(num, num * size);
         i += num;
     }
 
+    meter.stop();
+    printf("%s\r\n", *meter.toString());
+
     return Success;
 }
 
@@ -126,23 +178,77 @@ NetSend::Result NetSend::udpSendMultiple(const struct iovec *vec,
                                          const Size count,
                                          const struct sockaddr & addr) const
 {
-    struct msghdr msg;
+    struct mmsghdr msgs[NetworkQueue::BatchPackets];
+    const Size total = count < NetworkQueue::BatchPackets ? count : NetworkQueue::BatchPackets;
+    Size sent = 0;
 
     DEBUG("host = " << *IPV4::toString(addr.addr) << " port = " << addr.port << " count = " << count);
 
-    // Prepare the message header
-    msg.msg_name = (void *) &addr;
-    msg.msg_namelen = sizeof(addr);
-    msg.msg_iov = (struct iovec *) vec;
-    msg.msg_iovlen = count;
+    // Prepare a message header for each datagram
+    for (Size i = 0; i < total; i++)
+    {
+        MemoryBlock::set(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_name = (void *) &addr;
+        msgs[i].msg_hdr.msg_namelen = sizeof(addr);
+        msgs[i].msg_hdr.msg_iov = (struct iovec *) &vec[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // Send the datagrams in batches, until all are accepted
+    while (sent < total)
+    {
+        const int result = ::sendmmsg(m_socket, msgs + sent, total - sent, 0);
+        if (result <= 0)
+        {
+            ERROR("failed to send multiple UDP datagrams: " << strerror(errno));
+            return IOError;
+        }
+        sent += result;
+    }
+
+    return Success;
+}
+
+NetSend::Result NetSend::udpSpliceFile(const char *path,
+                                       const struct sockaddr & addr,
+                                       const Size count) const
+{
+    const FileSystemClient filesystem;
+    NetworkClient::SocketInfo info;
+    struct stat st;
+    int fd;
+
+    DEBUG("path = " << path << " count = " << count);
 
-    // Send the packet
-    int result = ::sendmsg(m_socket, &msg, 0);
-    if (result <= 0)
+    if (stat(path, &st) != 0 || (fd = open(path, O_RDONLY)) < 0)
     {
-        ERROR("failed to send multiple UDP datagrams: " << strerror(errno));
+        ERROR("failed to open " << path << ": " << strerror(errno));
         return IOError;
     }
 
+    // Every packet starts with the destination of the socket
+    info.address = addr.addr;
+    info.port    = addr.port;
+    info.action  = NetworkClient::SendSingle;
+
+    // Let the file system push the file into the socket, one packet per chunk
+    for (Size i = 0; i < count; i++)
+    {
+        Size size = st.st_size;
+
+        lseek(fd, 0, SEEK_SET);
+
+        const FileSystem::Result result = filesystem.spliceFile(fd, m_socket, &size, &info,
+                                                                sizeof(info), PacketSize);
+        if (result != FileSystem::Success || size != (Size) st.st_size)
+        {
+            ERROR("failed to splice " << path << " to UDP socket: result = " << (int) result <<
+                  " size = " << size);
+            close(fd);
+            return IOError;
+        }
+    }
+
+    close(fd);
     return Success;
 }
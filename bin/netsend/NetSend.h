@@ -37,8 +37,11 @@ class NetSend : public POSIXApplication
     /** Size of each packet to send in bytes */
     static const Size PacketSize = 1448;
 
+    /** Number of rate controlled batches to send per second */
+    static const Size BatchesPerSecond = 100;
+
     /** Number of packets to submit for transmission each iteration */
-    static const Size QueueSize = NetworkQueue::MaxPackets;
+    static const Size QueueSize = NetworkQueue::BatchPackets;
 
   public:
 
@@ -75,6 +78,8 @@ class NetSend : public POSIXApplication
     /**
      * Send multiple UDP packets
      *
+     * The packets are submitted in batches with sendmmsg().
+     *
      * @param vec I/O vector with multiple packets
      * @param count Number of entries in the I/O vector
      * @param addr The destination IP and port
@@ -85,6 +90,22 @@ class NetSend : public POSIXApplication
                            const Size count,
                            const struct sockaddr & addr) const;
 
+    /**
+     * Send the contents of a file as UDP packets
+     *
+     * The file system of the file writes the packets to
+     * the socket, without copying the file contents into this process.
+     *
+     * @param path Path to the file to send
+     * @param addr The destination IP and port
+     * @param count Number of times to send the file
+     *
+     * @return Result code
+     */
+    Result udpSpliceFile(const char *path,
+                         const struct sockaddr & addr,
+                         const Size count) const;
+
   private:
 
     /** Network client */
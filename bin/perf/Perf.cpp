@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Log.h>
+#include <ELF.h>
+#include <BufferedFile.h>
+#include <ProcessClient.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "Perf.h"
+
+Perf::Perf(int argc, char **argv)
+    : POSIXApplication(argc, argv)
+    , m_entries(new Entry[MaximumEntries])
+    , m_count(0)
+    , m_total(0)
+    , m_overflow(0)
+{
+    parser().setDescription("Sample running processes and output a flat profile");
+    parser().registerFlag('d', "duration", "Profiling duration in seconds (default 5)");
+}
+
+Perf::~Perf()
+{
+    delete[] m_entries;
+}
+
+Perf::Result Perf::exec()
+{
+    Size duration = DefaultDuration;
+
+    if (arguments().get("duration"))
+    {
+        duration = atoi(arguments().get("duration"));
+
+        if (duration == 0 || duration > MaximumDuration)
+        {
+            ERROR("duration must be between 1 and " << MaximumDuration << " seconds");
+            return InvalidArgument;
+        }
+    }
+
+    // Start sampling on this core
+    if (ProfileCtl(ProfileStart) != API::Success)
+    {
+        ERROR("failed to start profiler");
+        return IOError;
+    }
+
+    // Drain the kernel buffer every second to avoid it filling up
+    for (Size i = 0; i < duration; i++)
+    {
+        sleep(1);
+
+        const Result result = drain();
+        if (result != Success)
+        {
+            ProfileCtl(ProfileStop);
+            return result;
+        }
+    }
+
+    const API::Result stop = ProfileCtl(ProfileStop);
+    if ((stop & 0xffff) != API::Success)
+    {
+        ERROR("failed to stop profiler");
+        return IOError;
+    }
+
+    const Result result = drain();
+    if (result != Success)
+    {
+        return result;
+    }
+
+    // Summary of all samples
+    char line[128];
+    snprintf(line, sizeof(line), "%u samples, %u dropped, %u not recorded\r\n",
+             m_total, (uint) (stop >> 16), m_overflow);
+    write(1, line, String::length(line));
+
+    // Output the profile of each sampled process, in order of process ID
+    for (ProcessID pid = 0; pid < ProcessClient::MaximumProcesses; pid++)
+    {
+        Size hits = 0;
+
+        for (Size i = 0; i < m_count; i++)
+        {
+            if (m_entries[i].pid == pid)
+                hits += m_entries[i].hits;
+        }
+
+        if (hits > 0)
+        {
+            printProcess(pid, hits);
+        }
+    }
+
+    return Success;
+}
+
+Perf::Result Perf::drain()
+{
+    ProfileSample samples[SampleBatch];
+    Size count;
+
+    do
+    {
+        const API::Result result = ProfileCtl(ProfileRead, samples, SampleBatch);
+        if ((result & 0xffff) != API::Success)
+        {
+            ERROR("failed to read samples: result = " << (int) (result & 0xffff));
+            return IOError;
+        }
+
+        count = result >> 16;
+
+        for (Size i = 0; i < count; i++)
+        {
+            addSample(samples[i]);
+        }
+    }
+    while (count == SampleBatch);
+
+    return Success;
+}
+
+void Perf::addSample(const ProfileSample &sample)
+{
+    m_total++;
+
+    for (Size i = 0; i < m_count; i++)
+    {
+        Entry &e = m_entries[i];
+
+        if (e.pid == sample.pid && e.pc == sample.pc && e.kernel == sample.kernel)
+        {
+            e.hits++;
+            return;
+        }
+    }
+
+    if (m_count == MaximumEntries)
+    {
+        m_overflow++;
+        return;
+    }
+
+    Entry &e = m_entries[m_count++];
+    e.pid    = sample.pid;
+    e.pc     = sample.pc;
+    e.kernel = sample.kernel;
+    e.hits   = 1;
+}
+
+void Perf::printProcess(const ProcessID pid, const Size hits) const
+{
+    const ProcessClient process;
+    ProcessClient::Info info;
+    ExecutableFormat *format = ZERO;
+    String command = "[exited]";
+    String path;
+    char line[128];
+
+    // Retrieve the program of the process
+    if (process.processInfo(pid, info) == ProcessClient::Success)
+    {
+        command = info.command;
+    }
+
+    const List<String> words = command.split(' ');
+    if (words.count() > 0)
+    {
+        path = words.head()->data;
+    }
+
+    // Load the symbols of the program, if any
+    BufferedFile file(*path);
+    if (file.read() == BufferedFile::Success)
+    {
+        ELF::detect((const u8 *) file.buffer(), file.size(), &format);
+    }
+
+    // Group the samples of this process by symbol
+    Symbol *symbols = new Symbol[m_count];
+    Size numSymbols = 0;
+
+    for (Size i = 0; i < m_count; i++)
+    {
+        const Entry &e = m_entries[i];
+        const char *name = "[unknown]";
+        Address start = 0;
+        Size j;
+
+        if (e.pid != pid)
+            continue;
+
+        if (e.kernel)
+            name = "[kernel]";
+        else if (format != ZERO)
+            ((ELF *) format)->symbol(e.pc, &name, &start);
+
+        for (j = 0; j < numSymbols; j++)
+        {
+            if (symbols[j].name == name && symbols[j].start == start)
+                break;
+        }
+
+        if (j == numSymbols)
+        {
+            symbols[numSymbols].name  = name;
+            symbols[numSymbols].start = start;
+            symbols[numSymbols].hits  = 0;
+            numSymbols++;
+        }
+        symbols[j].hits += e.hits;
+    }
+
+    // Order by descending number of samples
+    for (Size i = 1; i < numSymbols; i++)
+    {
+        const Symbol s = symbols[i];
+        Size j = i;
+
+        for (; j > 0 && symbols[j - 1].hits < s.hits; j--)
+            symbols[j] = symbols[j - 1];
+
+        symbols[j] = s;
+    }
+
+    // Output the profile
+    String out;
+    snprintf(line, sizeof(line), "\r\nPID %u %s (%u samples, %u%%)\r\n",
+             pid, *command, hits, (hits * 100) / m_total);
+    out << line;
+    out << "  SAMPLES    %  SYMBOL\r\n";
+
+    for (Size i = 0; i < numSymbols; i++)
+    {
+        snprintf(line, sizeof(line), "  %7u %4u  %s\r\n",
+                 symbols[i].hits, (symbols[i].hits * 100) / hits, symbols[i].name);
+        out << line;
+    }
+    write(1, *out, out.length());
+
+    delete[] symbols;
+    delete format;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BIN_PERF_PERF_H
+#define __BIN_PERF_PERF_H
+
+#include <POSIXApplication.h>
+#include <FreeNOS/User.h>
+
+/**
+ * @addtogroup bin
+ * @{
+ */
+
+/**
+ * Sample the running processes and output a flat profile per process.
+ */
+class Perf : public POSIXApplication
+{
+  private:
+
+    /** Default profiling duration in seconds. */
+    static const Size DefaultDuration = 5;
+
+    /** Maximum profiling duration in seconds. */
+    static const Size MaximumDuration = 3600;
+
+    /** Maximum number of distinct program counters recorded. */
+    static const Size MaximumEntries = 2048;
+
+    /** Number of samples to read from the kernel at once. */
+    static const Size SampleBatch = 64;
+
+    /**
+     * Number of samples recorded at a single program counter.
+     */
+    typedef struct Entry
+    {
+        /** Process identifier */
+        ProcessID pid;
+
+        /** Program counter */
+        Address pc;
+
+        /** True if executing in the kernel */
+        bool kernel;
+
+        /** Number of samples */
+        Size hits;
+    }
+    Entry;
+
+    /**
+     * Number of samples inside a single symbol.
+     */
+    typedef struct Symbol
+    {
+        /** Name of the symbol */
+        const char *name;
+
+        /** Start address of the symbol */
+        Address start;
+
+        /** Number of samples */
+        Size hits;
+    }
+    Symbol;
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param argc Argument count
+     * @param argv Argument values
+     */
+    Perf(int argc, char **argv);
+
+    /**
+     * Destructor
+     */
+    virtual ~Perf();
+
+    /**
+     * Execute the application.
+     *
+     * @return Result code
+     */
+    virtual Result exec();
+
+  private:
+
+    /**
+     * Read all buffered samples from the kernel.
+     *
+     * @return Result code
+     */
+    Result drain();
+
+    /**
+     * Add a sample to the recorded entries.
+     *
+     * @param sample Sample received from the kernel
+     */
+    void addSample(const ProfileSample &sample);
+
+    /**
+     * Output the flat profile of a single process.
+     *
+     * @param pid Process identifier
+     * @param hits Total number of samples of the process
+     */
+    void printProcess(const ProcessID pid, const Size hits) const;
+
+  private:
+
+    /** Samples recorded per program counter */
+    Entry *m_entries;
+
+    /** Number of recorded entries */
+    Size m_count;
+
+    /** Total number of samples */
+    Size m_total;
+
+    /** Samples which did not fit in the entries table */
+    Size m_overflow;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __BIN_PERF_PERF_H */
@@ -26,37 +26,92 @@ ProcessList::ProcessList(int argc, char **argv)
     : POSIXApplication(argc, argv)
 {
     parser().setDescription("Output system process list");
+    parser().registerFlag('s', "sort", "Sort processes by consumed CPU cycles");
+    parser().registerFlag('m', "memory", "Sort processes by resident memory");
 }
 
 ProcessList::Result ProcessList::exec()
 {
     const ProcessClient process;
+    ProcessInfo *states = new ProcessInfo[ProcessClient::MaximumProcesses];
+    Size count = ProcessClient::MaximumProcesses;
     String out;
 
+    if (!states)
+    {
+        ERROR("failed to allocate process table");
+        return OutOfMemory;
+    }
+
+    // Retrieve all processes with a single kernel call
+    if (process.listProcesses(states, count) != ProcessClient::Success)
+    {
+        ERROR("failed to retrieve process list");
+        delete[] states;
+        return IOError;
+    }
+
+    if (arguments().get("sort") || arguments().get("memory"))
+    {
+        sortProcesses(states, count, arguments().get("memory") != ZERO);
+    }
+
     // Print header
-    out << "ID  PARENT  USER GROUP STATUS     CMD\r\n";
+    out << "ID  PARENT  USER GROUP STATUS     KCYCLES    VOLSW  INVOLSW  RSS(K)  SHR(K) CMD\r\n";
 
     // Loop processes
-    for (ProcessID pid = 0; pid < ProcessClient::MaximumProcesses; pid++)
+    for (Size i = 0; i < count; i++)
     {
         ProcessClient::Info info;
 
-        const ProcessClient::Result result = process.processInfo(pid, info);
+        const ProcessClient::Result result = process.processInfo(states[i], info);
         if (result == ProcessClient::Success)
         {
-            DEBUG("PID " << pid << " state = " << *info.textState);
-
-            // Output a line
-            char line[128];
-            snprintf(line, sizeof(line),
-                    "%3d %7d %4d %5d %10s %32s\r\n",
-                     pid, info.kernelState.parent,
-                     0, 0, *info.textState, *info.command);
-            out << line;
+            DEBUG("PID " << states[i].id << " state = " << *info.textState);
+            printProcess(out, states[i].id, info);
         }
     }
 
     // Output the table
     write(1, *out, out.length());
+    delete[] states;
     return Success;
 }
+
+void ProcessList::printProcess(String &out,
+                               const ProcessID pid,
+                               const ProcessClient::Info &info) const
+{
+    char line[128];
+
+    snprintf(line, sizeof(line),
+            "%3d %7d %4d %5d %10s %10u %8u %8u %7u %7u %32s\r\n",
+             pid, info.kernelState.parent,
+             0, 0, *info.textState,
+             (uint) (info.kernelState.cycles / 1000),
+             info.kernelState.voluntarySwitches,
+             info.kernelState.involuntarySwitches,
+             info.kernelState.residentPages * (PAGESIZE / 1024),
+             info.kernelState.sharedPages * (PAGESIZE / 1024),
+             *info.command);
+    out << line;
+}
+
+void ProcessList::sortProcesses(ProcessInfo *states,
+                                const Size count,
+                                const bool memory) const
+{
+    // Insert each process in descending order of cycles or resident pages
+    for (Size j = 1; j < count; j++)
+    {
+        const ProcessInfo state = states[j];
+        const u64 key = memory ? state.residentPages : state.cycles;
+        Size i = j;
+
+        for (; i > 0 && (memory ? states[i - 1].residentPages : states[i - 1].cycles) < key; i--)
+        {
+            states[i] = states[i - 1];
+        }
+        states[i] = state;
+    }
+}
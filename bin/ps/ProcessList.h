@@ -19,6 +19,7 @@
 #define __BIN_PS_PROCESSLIST_H
 
 #include <POSIXApplication.h>
+#include <ProcessClient.h>
 
 /**
  * @addtogroup bin
@@ -46,6 +47,30 @@ class ProcessList : public POSIXApplication
      * @return Result code
      */
     virtual Result exec();
+
+  private:
+
+    /**
+     * Output a line for the given process.
+     *
+     * @param out String to append the line to
+     * @param pid Process identifier
+     * @param info Process information
+     */
+    void printProcess(String &out,
+                      const ProcessID pid,
+                      const ProcessClient::Info &info) const;
+
+    /**
+     * Order processes by consumed CPU cycles or memory.
+     *
+     * @param states Process states to sort in descending order
+     * @param count Number of process states
+     * @param memory True to order by resident memory instead of CPU cycles
+     */
+    void sortProcesses(ProcessInfo *states,
+                       const Size count,
+                       const bool memory) const;
 };
 
 /**
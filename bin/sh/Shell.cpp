@@ -16,6 +16,7 @@
  */
 
 #include <TerminalCodes.h>
+#include <BufferedFile.h>
 #include "Shell.h"
 #include "ChangeDirCommand.h"
 #include "ExitCommand.h"
@@ -37,6 +38,9 @@
 /** Maximum number of supported command arguments. */
 #define MAX_ARGV 16
 
+/** Maximum number of commands in a pipeline. */
+#define MAX_STAGES 8
+
 Shell::Shell(int argc, char **argv)
     : POSIXApplication(argc, argv)
 {
@@ -62,9 +66,6 @@ Shell::~Shell()
 Shell::Result Shell::exec()
 {
     const Vector<Argument *> & positionals = arguments().getPositionals();
-    FILE *fp;
-    struct stat st;
-    char *contents;
 
     // Check if shell script was given as argument
     if (positionals.count() > 0)
@@ -72,48 +73,7 @@ Shell::Result Shell::exec()
         // Execute commands in each file
         for (Size i = 0; i < positionals.count(); i++)
         {
-            const char *file = *(positionals[i]->getValue());
-
-            // Query the file size
-            if (stat(file, &st) != 0)
-            {
-                ERROR("failed to stat() `" << file << "': " << strerror(errno));
-                continue;
-            }
-
-            // Open file
-            if ((fp = fopen(file, "r")) == NULL)
-            {
-                ERROR("failed to fopen() `" << file << "': " << strerror(errno));
-                continue;
-            }
-
-            // Allocate buffer storage
-            contents = new char[st.st_size + 1];
-
-            // Read the entire file into memory
-            if (fread(contents, st.st_size, 1, fp) != (size_t) 1U)
-            {
-                ERROR("failed to fread() `" << file << "': " << strerror(errno));
-                fclose(fp);
-                continue;
-            }
-            // Null terminate
-            contents[st.st_size] = 0;
-
-            // Parse it into lines
-            String contentString(contents);
-            List<String> lines = contentString.split('\n');
-
-            // Execute each command
-            for (ListIterator<String> i(lines); i.hasCurrent(); i++)
-            {
-                executeInput((char *) *i.current());
-            }
-
-            // Cleanup
-            delete[] contents;
-            fclose(fp);
+            executeFile(*(positionals[i]->getValue()));
         }
     }
     // Run an interactive Shell
@@ -160,7 +120,6 @@ Shell::Result Shell::runInteractive()
 
 int Shell::executeInput(const Size argc, const char **argv, const bool background)
 {
-    char tmp[128];
     ShellCommand *cmd;
     int pid, status;
 
@@ -176,20 +135,8 @@ int Shell::executeInput(const Size argc, const char **argv, const bool backgroun
     // Do we have a matching ShellCommand?
     if (!(cmd = getCommand(argv[0])))
     {
-        // If not, try to execute it as a file directly
-        if ((pid = runProgram(argv[0], argv)) != -1)
-        {
-            if (!background)
-            {
-                waitpid(pid, &status, 0);
-                return status;
-            } else
-                return EXIT_SUCCESS;
-        }
-
-        // Try to find it on the filesystem. (temporary hardcoded PATH)
-        else if (argv[0][0] != '/' && snprintf(tmp, sizeof(tmp), "/bin/%s", argv[0]) &&
-                (pid = runProgram(tmp, argv)) != -1)
+        // If not, try to execute it as a program
+        if ((pid = startProgram(argv)) != -1)
         {
             if (!background)
             {
@@ -220,7 +167,8 @@ int Shell::executeInput(const Size argc, const char **argv, const bool backgroun
 int Shell::executeInput(char *command)
 {
     char *argv[MAX_ARGV];
-    Size argc;
+    char *stages[MAX_STAGES];
+    Size argc, count = 1;
     bool background;
 
     // Valid argument?
@@ -229,6 +177,28 @@ int Shell::executeInput(char *command)
         return EXIT_SUCCESS;
     }
 
+    // Split a pipeline into its commands
+    stages[0] = command;
+
+    for (char *c = command; *c && command[0] != '#'; c++)
+    {
+        if (*c == '|')
+        {
+            if (count == MAX_STAGES)
+            {
+                ERROR("too many commands in pipeline (maximum " << MAX_STAGES << ")");
+                return EXIT_FAILURE;
+            }
+            *c = ZERO;
+            stages[count++] = c + 1;
+        }
+    }
+
+    if (count > 1)
+    {
+        return executePipeline(stages, count);
+    }
+
     // Attempt to extract arguments
     argc = parse(command, argv, MAX_ARGV, &background);
 
@@ -236,6 +206,172 @@ int Shell::executeInput(char *command)
     return executeInput(argc, (const char **)argv, background);
 }
 
+int Shell::executePipeline(char **stages, const Size count)
+{
+    char *argv[MAX_STAGES][MAX_ARGV];
+    int pids[MAX_STAGES];
+    int status = EXIT_SUCCESS;
+    int input = -1;
+    bool background = false;
+    Size started = 0;
+
+    // Only programs can run concurrently, as separate processes
+    for (Size i = 0; i < count; i++)
+    {
+        const Size argc = parse(stages[i], argv[i], MAX_ARGV - 1, &background);
+
+        if (argc == 0)
+        {
+            ERROR("missing command in pipeline");
+            return EXIT_FAILURE;
+        }
+        else if (getCommand(argv[i][0]))
+        {
+            ERROR(argv[i][0] << ": builtin commands cannot be used in a pipeline");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Keep our own standard input and output
+    const int savedInput = dup(0);
+    const int savedOutput = dup(1);
+    if (savedInput == -1 || savedOutput == -1)
+    {
+        ERROR("failed to duplicate standard input and output: " << strerror(errno));
+        return EXIT_FAILURE;
+    }
+    fflush(stdout);
+
+    // Start all commands, each reading the output of the previous one
+    for (Size i = 0; i < count; i++)
+    {
+        int fds[2] = { -1, -1 };
+
+        if (i < count - 1 && pipe(fds) != 0)
+            break;
+
+        dup2(input != -1 ? input : savedInput, 0);
+        dup2(fds[1] != -1 ? fds[1] : savedOutput, 1);
+
+        const int pid = startProgram((const char **) argv[i]);
+        const int error = errno;
+
+        // The commands hold the only ends of the pipes
+        if (input != -1)
+            close(input);
+        if (fds[1] != -1)
+            close(fds[1]);
+        input = fds[0];
+
+        if (pid == -1)
+        {
+            errno = error;
+            break;
+        }
+        pids[started++] = pid;
+    }
+
+    if (input != -1)
+        close(input);
+
+    dup2(savedInput, 0);
+    dup2(savedOutput, 1);
+    close(savedInput);
+    close(savedOutput);
+
+    if (started < count)
+    {
+        ERROR("exec `" << argv[started][0] << "' failed: " << strerror(errno));
+        status = EXIT_FAILURE;
+    }
+
+    // The status of a pipeline is the status of its last command
+    if (!background || started < count)
+    {
+        for (Size i = 0; i < started; i++)
+        {
+            waitpid(pids[i], &status, 0);
+        }
+    }
+
+    return status;
+}
+
+int Shell::startProgram(const char **argv)
+{
+    char tmp[128];
+    int pid;
+
+    // Try to execute it as a file directly
+    if ((pid = runProgram(argv[0], argv)) != -1)
+    {
+        return pid;
+    }
+
+    // Try to find it on the filesystem. (temporary hardcoded PATH)
+    if (argv[0][0] != '/' && snprintf(tmp, sizeof(tmp), "/bin/%s", argv[0]))
+    {
+        return runProgram(tmp, argv);
+    }
+
+    return -1;
+}
+
+Shell::Result Shell::executeFile(const char *path)
+{
+    BufferedFile script(path);
+    char line[1024];
+    Size length = 0;
+    const void *data;
+    Size size;
+
+    // Open the file for streaming
+    if (script.open() != BufferedFile::Success)
+    {
+        ERROR("failed to open `" << path << "'");
+        return IOError;
+    }
+
+    // Execute each line as soon as it is complete
+    while (true)
+    {
+        if (script.next(&data, &size) != BufferedFile::Success)
+        {
+            ERROR("failed to read `" << path << "'");
+            return IOError;
+        }
+        else if (size == 0)
+        {
+            break;
+        }
+
+        const char *chunk = (const char *) data;
+
+        for (Size i = 0; i < size; i++)
+        {
+            if (chunk[i] == '\n')
+            {
+                line[length] = ZERO;
+                executeInput(line);
+                length = 0;
+            }
+            else if (length < sizeof(line) - 1)
+            {
+                line[length++] = chunk[i];
+            }
+        }
+    }
+
+    // Execute the last line, if not terminated by a newline
+    if (length > 0)
+    {
+        line[length] = ZERO;
+        executeInput(line);
+    }
+
+    return Success;
+}
+
 char * Shell::getInput() const
 {
     static char line[1024];
@@ -304,9 +440,7 @@ void Shell::prompt() const
     printf(WHITE "(" GREEN "%s" WHITE ") " BLUE "%s" WHITE " # ",
            host, cwd);
 
-#ifdef __HOST__
     fflush(stdout);
-#endif /* __HOST__ */
 }
 
 HashTable<String, ShellCommand *> & Shell::getCommands()
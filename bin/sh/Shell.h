@@ -97,6 +97,28 @@ class Shell : public POSIXApplication
 
   private:
 
+    /**
+     * Executes a pipeline of programs.
+     *
+     * All programs run concurrently. The standard output of each
+     * program is connected by a pipe to the standard input of the next.
+     *
+     * @param stages Command input string of each program.
+     * @param count Number of programs.
+     *
+     * @return Exit status of the last program.
+     */
+    int executePipeline(char **stages, const Size count);
+
+    /**
+     * Start a program.
+     *
+     * @param argv Argument values, starting with the program name or path.
+     *
+     * @return Process identifier of the program or -1 on failure.
+     */
+    int startProgram(const char **argv);
+
     /**
      * Executes the Shell by entering an infinite loop.
      *
@@ -104,6 +126,17 @@ class Shell : public POSIXApplication
      */
     Result runInteractive();
 
+    /**
+     * Execute the commands in a file.
+     *
+     * Each line is executed as soon as it is read from the file.
+     *
+     * @param path Path to the file to execute.
+     *
+     * @return Result code
+     */
+    Result executeFile(const char *path);
+
     /**
      * Fetch a command text from standard input.
      * @return Pointer to a command text.
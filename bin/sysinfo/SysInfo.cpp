@@ -18,6 +18,7 @@
 #include <FreeNOS/User.h>
 #include <Timer.h>
 #include <CoreClient.h>
+#include <ProcessClient.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <fcntl.h>
@@ -28,6 +29,9 @@ SysInfo::SysInfo(int argc, char **argv)
     : POSIXApplication(argc, argv)
 {
     parser().setDescription("Print global system information");
+    parser().registerFlag('a', "api", "Print kernel API call statistics");
+    parser().registerFlag('r', "reset", "Reset kernel API call statistics");
+    parser().registerFlag('m', "memory", "Print memory usage per process");
 }
 
 SysInfo::~SysInfo()
@@ -42,6 +46,29 @@ SysInfo::Result SysInfo::exec()
     struct timeval tv;
     struct timezone tz;
 
+    // Reset kernel API statistics
+    if (arguments().get("reset"))
+    {
+        const API::Result r = APIStatsCtl(APIStatsReset, API::PrivExecNumber);
+        if (r != API::Success)
+        {
+            printf("failed to reset kernel API statistics: %d\n", (int) r);
+            return IOError;
+        }
+    }
+
+    // Print kernel API statistics
+    if (arguments().get("api"))
+    {
+        return printAPIStatistics();
+    }
+
+    // Print memory usage per process
+    if (arguments().get("memory"))
+    {
+        return printMemoryUsage();
+    }
+
     // Retrieve number of cores from the CoreServer
     const Core::Result result = coreClient.getCoreCount(numCores);
     if (result != Core::Success)
@@ -62,15 +89,161 @@ SysInfo::Result SysInfo::exec()
     printf("Memory Total:     %u KB\r\n"
            "Memory Available: %u KB\r\n"
            "Processor Cores:  %u\r\n"
-           "Timer:            %l ticks (%u hertz)\r\n"
-           "Uptime:           %l.%us\r\n",
+           "Timer:            %u ticks (%u hertz)\r\n"
+           "Uptime:           %u.%06us\r\n",
             info.memorySize / 1024,
             info.memoryAvail / 1024,
             numCores,
             (u32) timer.ticks,
             timer.frequency,
-            (u32) tv.tv_sec, tv.tv_usec);
+            (u32) tv.tv_sec, (u32) tv.tv_usec);
+
+    // Print free physical memory blocks per order
+    printf("Memory Blocks:   ");
+    for (Size i = 0; i < MEMORY_BLOCK_ORDERS; i++)
+    {
+        printf(" %u", info.memoryBlocks[i]);
+    }
+    printf("\r\n");
+    printf("Zero Pool:        %u pages (%u hits, %u misses)\r\n",
+            info.zeroPoolCount, info.zeroPoolHits, info.zeroPoolMisses);
+
+    // Only measured when the kernel is built with IRQOFF
+    if (info.irqOffMax)
+    {
+        printf("Interrupts Off:   %u cycles max at %x\r\n",
+                (uint) info.irqOffMax, (uint) info.irqOffSite);
+    }
+
+    // Idle residency and wakeup latency of this core
+    static const char *idleStates[] = { "halt", "poll", "deep" };
+    printf("Idle State:       %s (%u wakeups, %u cycles avg latency, %u max)\r\n",
+            info.idle.state < IdleStates ? idleStates[info.idle.state] : "unknown",
+            info.idle.wakeups,
+            info.idle.wakeups ? (uint) (info.idle.latency / info.idle.wakeups) : 0,
+            (uint) info.idle.latencyMax);
+    printf("Idle Residency:  ");
+    for (Size i = 0; i < IdleStates; i++)
+    {
+        printf(" %s=%u", idleStates[i], (uint) (info.idle.cycles[i] >> 10));
+    }
+    printf(" Kcycles\r\n");
 
     // Done
     return Success;
 }
+
+SysInfo::Result SysInfo::printAPIStatistics() const
+{
+    static const char *names[] =
+    {
+        "", "PrivExec", "ProcessCtl", "SystemInfo", "VMCopy", "VMCtl", "VMShare",
+        "VMCopyVector", "ProfileCtl", "PerfCtl", "TraceCtl", "APIStatsCtl",
+        "MultiCall"
+    };
+    const Size count = sizeof(names) / sizeof(names[0]);
+
+    printf("%16s %8s %8s %10s %10s\r\n", "API", "CALLS", "ERRORS", "AVG", "MAX");
+
+    for (Size i = 1; i < count; i++)
+    {
+        API::Statistics stats;
+
+        const API::Result result = APIStatsCtl(APIStatsRead, (API::Number) i, &stats);
+        if (result != API::Success)
+        {
+            printf("failed to read statistics of %s: %d\r\n", names[i], (int) result);
+            return IOError;
+        }
+
+        if (stats.calls == 0)
+            continue;
+
+        printf("%16s %8u %8u %10u %10u\r\n",
+                names[i], stats.calls, stats.errors,
+                (uint) (stats.cycles / stats.calls), (uint) stats.maxCycles);
+
+        // Print the log2 latency histogram
+        printf("%16s", "cycles:");
+        for (Size j = 0; j < API::HistogramBuckets; j++)
+        {
+            if (stats.histogram[j])
+                printf(" 2^%u=%u", j, stats.histogram[j]);
+        }
+        printf("\r\n");
+
+        // Print the calls per action
+        printf("%16s", "actions:");
+        for (Size j = 0; j < API::MaximumActions; j++)
+        {
+            if (stats.actions[j])
+                printf(" %u=%u", j, stats.actions[j]);
+        }
+        printf("\r\n");
+    }
+
+    return Success;
+}
+
+SysInfo::Result SysInfo::printMemoryUsage() const
+{
+    const ProcessClient process;
+    const SystemInformation info;
+    const Size pageKiloBytes = PAGESIZE / 1024;
+    ProcessInfo *states = new ProcessInfo[ProcessClient::MaximumProcesses];
+    Size count = ProcessClient::MaximumProcesses;
+    Size mapped = 0, resident = 0, shared = 0, tables = 0;
+
+    if (!states)
+    {
+        ERROR("failed to allocate process table");
+        return OutOfMemory;
+    }
+
+    if (process.listProcesses(states, count) != ProcessClient::Success)
+    {
+        ERROR("failed to retrieve process list");
+        delete[] states;
+        return IOError;
+    }
+
+    printf("%3s %10s %10s %10s %10s %s\r\n", "ID", "MAPPED(K)", "RSS(K)", "SHR(K)", "TABLES(K)", "CMD");
+
+    for (Size i = 0; i < count; i++)
+    {
+        ProcessClient::Info proc;
+
+        if (process.processInfo(states[i], proc) != ProcessClient::Success)
+            continue;
+
+        const ProcessInfo & state = proc.kernelState;
+
+        printf("%3u %10u %10u %10u %10u %s\r\n",
+                state.id,
+                state.mappedPages * pageKiloBytes,
+                state.residentPages * pageKiloBytes,
+                state.sharedPages * pageKiloBytes,
+                state.tablePages * pageKiloBytes,
+                *proc.command);
+
+        mapped += state.mappedPages;
+        resident += state.residentPages;
+        shared += state.sharedPages;
+        tables += state.tablePages;
+    }
+
+    // Shared pages may be mapped by several processes, thus the totals can exceed the memory in use
+    printf("%3s %10u %10u %10u %10u\r\n", "ALL",
+            mapped * pageKiloBytes, resident * pageKiloBytes,
+            shared * pageKiloBytes, tables * pageKiloBytes);
+    delete[] states;
+    printf("\r\n"
+           "Memory Total:     %u KB\r\n"
+           "Memory Available: %u KB\r\n"
+           "Memory Used:      %u KB\r\n",
+            info.memorySize / 1024,
+            info.memoryAvail / 1024,
+            (info.memorySize - info.memoryAvail) / 1024);
+
+    return Success;
+}
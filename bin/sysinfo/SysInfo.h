@@ -53,6 +53,22 @@ class SysInfo : public POSIXApplication
      * @return Result code
      */
     virtual Result exec();
+
+  private:
+
+    /**
+     * Print the call statistics of all kernel API functions.
+     *
+     * @return Result code
+     */
+    Result printAPIStatistics() const;
+
+    /**
+     * Print the memory usage of each process and the totals.
+     *
+     * @return Result code
+     */
+    Result printMemoryUsage() const;
 };
 
 /**
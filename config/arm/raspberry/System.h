@@ -21,6 +21,7 @@
 #include "Constant.h"
 #include <arm/ARMCore.h>
 #include <arm/ARMCacheV6.h>
+#include <arm/ARMPerformanceCounter.h>
 #include <arm/ARMIO.h>
 #include <arm/ARMPaging.h>
 #include <arm/ARMMap.h>
@@ -21,6 +21,7 @@
 #include "Constant.h"
 #include <intel/IntelCore.h>
 #include <intel/IntelCache.h>
+#include <intel/IntelPerformanceCounter.h>
 #include <intel/IntelIO.h>
 #include <intel/IntelState.h>
 #include <intel/IntelPaging.h>
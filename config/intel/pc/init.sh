@@ -1,35 +1,11 @@
 
+#
+# Servers and drivers are started by init from services.conf.
 #
 # VGA/keyboard console
 #
-/server/ps2/server &
-/bin/mount --wait=/dev/ps2
-
-/server/video/server &
-/bin/mount --wait=/dev/video
-
-/server/terminal/server &
-/bin/mount --wait=/console
 stdio /console/tty0 /console/tty0
 
-#
-# System Servers and Drivers.
-#
-/server/time/server &
-/bin/mount --wait=/dev/time
-
-/server/filesystem/tmp/server /tmp &
-/bin/mount --wait=/tmp
-
-/server/network/loopback/server &
-/bin/mount --wait=/network/loopback
-
-#
-# Serial console
-#
-/server/serial/server &
-/bin/mount --wait=/dev/serial
-
 # This ensures we wait until all cores
 # are booted by the CoreServer.
 /bin/sysinfo
@@ -17,6 +17,7 @@
 
 #include <FreeNOS/System.h>
 #include <Log.h>
+#include <MemoryBlock.h>
 
 API::API()
 {
@@ -24,12 +25,21 @@ API::API()
 
     // Register generic API handlers
     m_apis.fill(ZERO);
-    m_apis.insert(PrivExecNumber,   (Handler *) PrivExecHandler);
-    m_apis.insert(ProcessCtlNumber, (Handler *) ProcessCtlHandler);
-    m_apis.insert(SystemInfoNumber, (Handler *) SystemInfoHandler);
-    m_apis.insert(VMCopyNumber,     (Handler *) VMCopyHandler);
-    m_apis.insert(VMCtlNumber,      (Handler *) VMCtlHandler);
-    m_apis.insert(VMShareNumber,    (Handler *) VMShareHandler);
+    resetStatistics();
+    MemoryBlock::set(m_actionArg, 0, sizeof(m_actionArg));
+
+    registerHandler(PrivExecNumber,     (Handler *) PrivExecHandler, 1);
+    registerHandler(ProcessCtlNumber,   (Handler *) ProcessCtlHandler, 2);
+    registerHandler(SystemInfoNumber,   (Handler *) SystemInfoHandler, 0);
+    registerHandler(VMCopyNumber,       (Handler *) VMCopyHandler, 2);
+    registerHandler(VMCtlNumber,        (Handler *) VMCtlHandler, 2);
+    registerHandler(VMShareNumber,      (Handler *) VMShareHandler, 2);
+    registerHandler(VMCopyVectorNumber, (Handler *) VMCopyVectorHandler, 2);
+    registerHandler(ProfileCtlNumber,   (Handler *) ProfileCtlHandler, 1);
+    registerHandler(PerfCtlNumber,      (Handler *) PerfCtlHandler, 2);
+    registerHandler(TraceCtlNumber,     (Handler *) TraceCtlHandler, 1);
+    registerHandler(APIStatsCtlNumber,  (Handler *) APIStatsCtlHandler, 1);
+    registerHandler(MultiCallNumber,    (Handler *) MultiCallHandler, 0);
 }
 
 API::Result API::invoke(Number number,
@@ -41,10 +51,65 @@ API::Result API::invoke(Number number,
 {
     Handler **handler = (Handler **) m_apis.get(number);
 
-    if (handler && *handler)
-        return (*handler)(arg1, arg2, arg3, arg4, arg5);
-    else
+    if (!handler || !*handler)
         return InvalidArgument;
+
+    // Run the handler. Note that the latency includes the time a
+    // blocking call spends waiting on architectures which switch
+    // to another process from inside the handler.
+    const u64 start = timestamp();
+    IRQOFF_SITE(*handler);
+    const Result result = (*handler)(arg1, arg2, arg3, arg4, arg5);
+    const u64 end = timestamp();
+
+    if ((Size) number >= MaximumAPIs)
+        return result;
+
+    // Update call statistics
+    Statistics *stats = &m_stats[number];
+    const u64 cycles = end >= start ? end - start : 0;
+    const ulong args[] = { 0, arg1, arg2, arg3, arg4, arg5 };
+    const ulong action = args[m_actionArg[number]];
+    Size bucket = 0;
+
+    while (bucket < HistogramBuckets - 1 && (cycles >> (bucket + 1)) != 0)
+        bucket++;
+
+    stats->calls++;
+    stats->cycles += cycles;
+    stats->histogram[bucket]++;
+
+    if (cycles > stats->maxCycles)
+        stats->maxCycles = cycles;
+
+    if ((result & 0xffff) != Success)
+        stats->errors++;
+
+    if (action < MaximumActions)
+        stats->actions[action]++;
+
+    return result;
+}
+
+const API::Statistics * API::getStatistics(const Number number) const
+{
+    if ((Size) number >= MaximumAPIs)
+        return ZERO;
+
+    return &m_stats[number];
+}
+
+void API::resetStatistics()
+{
+    MemoryBlock::set(m_stats, 0, sizeof(m_stats));
+}
+
+void API::registerHandler(const Number number, Handler *handler, const Size actionArg)
+{
+    m_apis.insert(number, handler);
+
+    if ((Size) number < MaximumAPIs)
+        m_actionArg[number] = actionArg;
 }
 
 Log & operator << (Log &log, API::Operation op)
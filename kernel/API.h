@@ -53,7 +53,13 @@ class API
         SystemInfoNumber,
         VMCopyNumber,
         VMCtlNumber,
-        VMShareNumber
+        VMShareNumber,
+        VMCopyVectorNumber,
+        ProfileCtlNumber,
+        PerfCtlNumber,
+        TraceCtlNumber,
+        APIStatsCtlNumber,
+        MultiCallNumber
     }
     Number;
 
@@ -79,6 +85,41 @@ class API
         MaxValue = UINT_MAX
     };
 
+    /** Maximum number of API functions which can be registered. */
+    static const Size MaximumAPIs = 32;
+
+    /** Number of distinct actions counted per API function. */
+    static const Size MaximumActions = 32;
+
+    /** Number of log2 latency histogram buckets. */
+    static const Size HistogramBuckets = 32;
+
+    /**
+     * Call statistics of a single API function.
+     */
+    typedef struct Statistics
+    {
+        /** Number of calls. */
+        u32 calls;
+
+        /** Number of calls which did not return API::Success. */
+        u32 errors;
+
+        /** Total and maximum latency in timestamp() cycles. */
+        u64 cycles, maxCycles;
+
+        /**
+         * Number of calls per latency range. Bucket i counts the calls
+         * which took 2^i up to 2^(i+1) cycles, where bucket zero also
+         * includes zero cycles and the last bucket everything above.
+         */
+        u32 histogram[HistogramBuckets];
+
+        /** Number of calls per action (operation) argument of the API. */
+        u32 actions[MaximumActions];
+    }
+    Statistics;
+
     /**
      * Function which handles an kernel API (system call) request.
      * @return Status code of the APIHandler execution.
@@ -118,10 +159,42 @@ class API
                   ulong arg4,
                   ulong arg5);
 
+    /**
+     * Get call statistics of an API function.
+     *
+     * @param number API function number
+     *
+     * @return Statistics pointer or ZERO if the number is out of range.
+     */
+    const Statistics * getStatistics(const Number number) const;
+
+    /**
+     * Reset the call statistics of all API functions.
+     */
+    void resetStatistics();
+
+  private:
+
+    /**
+     * Register an API handler.
+     *
+     * @param number API function number
+     * @param handler Handler function
+     * @param actionArg Argument (1-5) which contains the action of the API,
+     *                  or zero if the API has no action argument.
+     */
+    void registerHandler(const Number number, Handler *handler, const Size actionArg);
+
   private:
 
     /** API handlers */
     Vector<Handler *> m_apis;
+
+    /** Call statistics per API function. */
+    Statistics m_stats[MaximumAPIs];
+
+    /** Argument which contains the action, per API function. */
+    u8 m_actionArg[MaximumAPIs];
 };
 
 /**
@@ -135,10 +208,16 @@ Log & operator << (Log &log, API::Operation op);
  * Include generic kernel API functions.
  */
 
+#include "API/APIStatsCtl.h"
+#include "API/MultiCall.h"
+#include "API/PerfCtl.h"
 #include "API/PrivExec.h"
+#include "API/ProfileCtl.h"
 #include "API/ProcessCtl.h"
 #include "API/SystemInfo.h"
+#include "API/TraceCtl.h"
 #include "API/VMCopy.h"
+#include "API/VMCopyVector.h"
 #include "API/VMCtl.h"
 #include "API/VMShare.h"
 #include "API/ProcessID.h"
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/System.h>
+#include <FreeNOS/Kernel.h>
+#include <MemoryBlock.h>
+#include <Log.h>
+#include "APIStatsCtl.h"
+
+API::Result APIStatsCtlHandler(const APIStatsOperation op,
+                               const API::Number number,
+                               API::Statistics *stats)
+{
+    API *api = Kernel::instance()->getAPI();
+
+    DEBUG("op = " << (uint) op << " number = " << (uint) number);
+
+    switch (op)
+    {
+        case APIStatsRead:
+        {
+            const API::Statistics *s = api->getStatistics(number);
+
+            if (!stats || !s)
+                return API::InvalidArgument;
+
+            MemoryBlock::copy(stats, s, sizeof(*stats));
+            break;
+        }
+
+        case APIStatsReset:
+            api->resetStatistics();
+            break;
+
+        default:
+            return API::InvalidArgument;
+    }
+
+    return API::Success;
+}
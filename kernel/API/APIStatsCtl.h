@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_API_APISTATSCTL_H
+#define __KERNEL_API_APISTATSCTL_H
+
+#include <Types.h>
+
+/**
+ * @addtogroup kernel
+ * @{
+ *
+ * @addtogroup kernelapi
+ * @{
+ */
+
+/**
+ * Available operations to perform using APIStatsCtl.
+ *
+ * @see APIStatsCtl
+ */
+typedef enum APIStatsOperation
+{
+    APIStatsRead = 0,
+    APIStatsReset
+}
+APIStatsOperation;
+
+/**
+ * Prototype for user applications. Read or reset kernel API call statistics.
+ *
+ * The kernel counts the calls, errors and latency of each API function on
+ * every core. The latency is measured in timestamp() cycles around the handler
+ * and kept as a log2 histogram. Calls are also counted per action, which is
+ * the operation argument of the API, for example the ProcessOperation of ProcessCtl.
+ *
+ * @param op The operation to perform.
+ * @param number API function to read for APIStatsRead. Ignored for APIStatsReset.
+ * @param stats Output statistics for APIStatsRead.
+ *
+ * @return API::Success on success and other API::ErrorCode on failure.
+ */
+inline API::Result APIStatsCtl(const APIStatsOperation op,
+                               const API::Number number,
+                               API::Statistics *stats = ZERO)
+{
+    return (API::Result) trapKernel3(API::APIStatsCtlNumber, op, number, (Address) stats);
+}
+
+/**
+ * @}
+ */
+
+#ifdef __KERNEL__
+
+/**
+ * @addtogroup kernelapi_handler
+ * @{
+ */
+
+/**
+ * Kernel handler prototype. Read or reset kernel API call statistics.
+ *
+ * @param op The operation to perform.
+ * @param number API function to read for APIStatsRead. Ignored for APIStatsReset.
+ * @param stats Output statistics for APIStatsRead.
+ *
+ * @return API::Success on success and other API::ErrorCode on failure.
+ */
+extern API::Result APIStatsCtlHandler(const APIStatsOperation op,
+                                      const API::Number number,
+                                      API::Statistics *stats);
+
+/**
+ * @}
+ */
+
+#endif /* __KERNEL__ */
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __KERNEL_API_APISTATSCTL_H */
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_API_IDLESTATE_H
+#define __KERNEL_API_IDLESTATE_H
+
+#include <Types.h>
+
+/**
+ * @addtogroup kernel
+ * @{
+ *
+ * @addtogroup kernelapi
+ * @{
+ */
+
+/**
+ * Ways for the idle process to wait for an interrupt.
+ *
+ * The idle process passes its state with the Idle operation,
+ * such that the kernel can account the time spent in each state.
+ *
+ * @see PrivExec
+ */
+typedef enum IdleState
+{
+    IdleHalt   = 0,
+    IdlePoll   = 1,
+    IdleDeep   = 2,
+    IdleStates = 3
+}
+IdleState;
+
+/**
+ * Time spent by a core in the idle process.
+ */
+typedef struct IdleStatistics
+{
+    /** Current IdleState of the idle process */
+    uint state;
+
+    /** Timestamp counter cycles spent in each IdleState */
+    u64 cycles[IdleStates];
+
+    /** Number of times the core switched from the idle process to another process */
+    Size wakeups;
+
+    /** Total and largest cycles from the last interrupt while idle to running the next process */
+    u64 latency, latencyMax;
+}
+IdleStatistics;
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __KERNEL_API_IDLESTATE_H */
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/System.h>
+#include <FreeNOS/Kernel.h>
+#include <FreeNOS/ProcessManager.h>
+#include "MultiCall.h"
+
+API::Result MultiCallHandler(MultiCallEntry *calls,
+                             const Size count)
+{
+    ProcessManager *procs = Kernel::instance()->getProcessManager();
+    Process *proc = procs->current();
+    API *api = Kernel::instance()->getAPI();
+    API::Result result = API::Success;
+
+    DEBUG("");
+
+    if (!calls || count == 0 || count > MULTICALL_MAX_CALLS)
+        return API::InvalidArgument;
+
+    for (Size i = 0; i < count; i++)
+    {
+        const MultiCallEntry *call = &calls[i];
+
+        // Nested batches are not allowed
+        if (call->number == API::MultiCallNumber)
+            return API::InvalidArgument;
+
+        result = api->invoke((API::Number) call->number, call->args[0], call->args[1],
+                             call->args[2], call->args[3], call->args[4]);
+
+        // The calls array is only accessible while this process is current
+        if (procs->current() != proc)
+            break;
+
+        calls[i].result = result;
+
+        if (result != API::Success && !(call->flags & MULTICALL_IGNORE_ERROR))
+            break;
+    }
+
+    return result;
+}
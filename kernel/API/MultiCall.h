@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_API_MULTICALL_H
+#define __KERNEL_API_MULTICALL_H
+
+#include <Types.h>
+
+/**
+ * @addtogroup kernel
+ * @{
+ *
+ * @addtogroup kernelapi
+ * @{
+ */
+
+/** Maximum number of calls executed by a single MultiCall() call. */
+#define MULTICALL_MAX_CALLS 16
+
+/** Continue with the next call even if this call does not return API::Success. */
+#define MULTICALL_IGNORE_ERROR 1
+
+/**
+ * Describes one kernel call of a MultiCall() call.
+ */
+typedef struct MultiCallEntry
+{
+    /** API::Number of the kernel call. */
+    ulong number;
+
+    /** Arguments of the kernel call. */
+    ulong args[5];
+
+    /** Flags, such as MULTICALL_IGNORE_ERROR. */
+    ulong flags;
+
+    /** Result of the kernel call. Unchanged if the call was not executed. */
+    ulong result;
+}
+MultiCallEntry;
+
+/**
+ * Prototype for user applications. Executes several kernel calls in one kernel entry.
+ *
+ * Calls are executed in order. Execution stops at the first call which does
+ * not return API::Success, unless it has the MULTICALL_IGNORE_ERROR flag set.
+ * Execution also stops after a call which switched to another process, thus
+ * only the last call may block.
+ *
+ * @param calls Array of calls to execute.
+ * @param count Number of calls, at most MULTICALL_MAX_CALLS.
+ *
+ * @return Result of the last executed call, or API::InvalidArgument.
+ */
+inline API::Result MultiCall(MultiCallEntry *calls,
+                             const Size count)
+{
+    return (API::Result) trapKernel2(API::MultiCallNumber, (Address) calls, count);
+}
+
+/**
+ * @}
+ */
+
+#ifdef __KERNEL__
+
+/**
+ * @addtogroup kernelapi_handler
+ * @{
+ */
+
+/**
+ * Kernel handler prototype. Executes several kernel calls in one kernel entry.
+ *
+ * @param calls Array of calls to execute.
+ * @param count Number of calls, at most MULTICALL_MAX_CALLS.
+ *
+ * @return Result of the last executed call, or API::InvalidArgument.
+ */
+extern API::Result MultiCallHandler(MultiCallEntry *calls,
+                                    const Size count);
+
+/**
+ * @}
+ */
+
+#endif /* __KERNEL__ */
+
+/**
+ * @}
+ */
+
+#endif /* __KERNEL_API_MULTICALL_H */
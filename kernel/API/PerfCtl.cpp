@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/System.h>
+#include <FreeNOS/Kernel.h>
+#include <FreeNOS/Process.h>
+#include <FreeNOS/ProcessManager.h>
+#include <Log.h>
+#include "PerfCtl.h"
+
+API::Result PerfCtlHandler(const ProcessID procID,
+                           const PerfOperation op,
+                           PerfCounterInfo *info)
+{
+    ProcessManager *procs = Kernel::instance()->getProcessManager();
+    PerformanceCounter *perf = Kernel::instance()->getPerformanceCounter();
+    Process *proc = ZERO;
+
+    DEBUG("op = " << (uint) op << " pid = " << procID);
+
+    if (!info)
+        return API::InvalidArgument;
+
+    // Without performance counters, there is nothing to program
+    if (perf == ZERO)
+    {
+        if (op == PerfRead)
+        {
+            MemoryBlock::set(info, 0, sizeof(*info));
+            return API::Success;
+        }
+        return API::NotFound;
+    }
+
+    switch (op)
+    {
+        case PerfConfigure:
+            for (Size i = 0; i < perf->count(); i++)
+            {
+                if (perf->configure(i, info->events[i]) != PerformanceCounter::Success)
+                {
+                    ERROR("failed to configure counter " << i << " for event " << (uint) info->events[i]);
+                    perf->configure(i, PerformanceCounter::None);
+                    procs->resetCounters();
+                    return API::InvalidArgument;
+                }
+            }
+            procs->resetCounters();
+            break;
+
+        case PerfRead:
+            if (procID != ANY)
+            {
+                if (procID == SELF)
+                    proc = procs->current();
+                else if (!(proc = procs->get(procID)))
+                    return API::NotFound;
+            }
+
+            // Charge the events of the current Process so far
+            procs->updateCounters();
+
+            MemoryBlock::set(info, 0, sizeof(*info));
+            info->count = perf->count();
+
+            for (Size i = 0; i < perf->count(); i++)
+            {
+                info->events[i] = perf->event(i);
+                info->values[i] = proc ? proc->getCounter(i) : perf->read(i);
+            }
+            break;
+
+        default:
+            return API::InvalidArgument;
+    }
+
+    return API::Success;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_API_PERFCTL_H
+#define __KERNEL_API_PERFCTL_H
+
+#include <Types.h>
+#include <PerformanceCounter.h>
+
+/**
+ * @addtogroup kernel
+ * @{
+ *
+ * @addtogroup kernelapi
+ * @{
+ */
+
+/**
+ * Available operations to perform using PerfCtl.
+ *
+ * @see PerfCtl
+ */
+typedef enum PerfOperation
+{
+    PerfConfigure = 0,
+    PerfRead
+}
+PerfOperation;
+
+/**
+ * Hardware performance counters of a core or process.
+ */
+typedef struct PerfCounterInfo
+{
+    /** Number of counters available on the core. */
+    Size count;
+
+    /** Event counted by each counter. */
+    PerformanceCounter::Event events[PerformanceCounter::MaximumCounters];
+
+    /** Value of each counter. */
+    u64 values[PerformanceCounter::MaximumCounters];
+}
+PerfCounterInfo;
+
+/**
+ * Prototype for user applications. Program and read the hardware performance counters.
+ *
+ * The counters are programmed for the whole core using PerfConfigure, which
+ * resets all values to zero. On each context switch the events counted are
+ * charged to the Process which was executing, such that PerfRead can return
+ * either the totals of the core or the events of a single Process.
+ *
+ * @param proc Process to read for PerfRead, or ANY for the totals of the core.
+ *             Ignored for PerfConfigure.
+ * @param op The operation to perform.
+ * @param info Input events for PerfConfigure, output counters for PerfRead.
+ *
+ * @return API::Success on success and other API::ErrorCode on failure.
+ */
+inline API::Result PerfCtl(const ProcessID proc,
+                           const PerfOperation op,
+                           PerfCounterInfo *info)
+{
+    return (API::Result) trapKernel3(API::PerfCtlNumber, proc, op, (Address) info);
+}
+
+/**
+ * @}
+ */
+
+#ifdef __KERNEL__
+
+/**
+ * @addtogroup kernelapi_handler
+ * @{
+ */
+
+/**
+ * Kernel handler prototype. Program and read the hardware performance counters.
+ *
+ * @param proc Process to read for PerfRead, or ANY for the totals of the core.
+ *             Ignored for PerfConfigure.
+ * @param op The operation to perform.
+ * @param info Input events for PerfConfigure, output counters for PerfRead.
+ *
+ * @return API::Success on success and other API::ErrorCode on failure.
+ */
+extern API::Result PerfCtlHandler(const ProcessID proc,
+                                  const PerfOperation op,
+                                  PerfCounterInfo *info);
+
+/**
+ * @}
+ */
+
+#endif /* __KERNEL__ */
+
+/**
+ * @}
+ */
+
+#endif /* __KERNEL_API_PERFCTL_H */
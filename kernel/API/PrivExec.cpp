@@ -17,6 +17,7 @@
 
 #include <FreeNOS/System.h>
 #include <FreeNOS/ProcessManager.h>
+#include <SplitAllocator.h>
 #include <Log.h>
 #include "PrivExec.h"
 
@@ -29,7 +30,11 @@ API::Result PrivExecHandler(const PrivOperation op,
     {
     case Idle: {
         ProcessManager *procs = Kernel::instance()->getProcessManager();
-        procs->setIdle(procs->current());
+
+        if (param >= IdleStates)
+            return API::InvalidArgument;
+
+        procs->setIdle(procs->current(), (IdleState) param);
         return API::Success;
     }
 
@@ -50,6 +55,12 @@ API::Result PrivExecHandler(const PrivOperation op,
         FATAL("panic in PID " << Kernel::instance()->getProcessManager()->current()->getID());
         return API::Success;
 
+    case ZeroPages:
+        if (Kernel::instance()->getAllocator()->fillZeroed(param) > 0)
+            return API::Success;
+        else
+            return API::AlreadyExists;
+
     default:
         ;
     }
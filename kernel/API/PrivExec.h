@@ -18,6 +18,8 @@
 #ifndef __KERNEL_API_PRIVEXEC_H
 #define __KERNEL_API_PRIVEXEC_H
 
+#include "IdleState.h"
+
 /**
  * @addtogroup kernel
  * @{
@@ -37,7 +39,8 @@ typedef enum PrivOperation
     RebootSystem   = 1,
     ShutdownSystem = 2,
     WriteConsole   = 3,
-    Panic          = 4
+    Panic          = 4,
+    ZeroPages      = 5
 }
 PrivOperation;
 
@@ -45,7 +48,8 @@ PrivOperation;
  * Prototype for user applications. Performs various privileged operations.
  *
  * @param op The operation to perform.
- * @param param Optional parameter value for the given operation
+ * @param param Optional parameter value for the given operation.
+ *              For Idle it is the IdleState of the calling process.
  *
  * @return API::Success on success and other API::ErrorCode on failure.
  */
@@ -24,6 +24,30 @@
 #include <Log.h>
 #include "ProcessCtl.h"
 
+/**
+ * Fill a process information structure.
+ *
+ * @param proc Process to describe
+ * @param info Output information structure
+ */
+static void fillInfo(Process *proc, ProcessInfo *info)
+{
+    MemoryContext::Usage usage;
+    proc->getMemoryContext()->getUsage(usage);
+
+    info->id    = proc->getID();
+    info->state = proc->getState();
+    info->parent = proc->getParent();
+    info->priority = proc->getPriority();
+    info->cycles = proc->getCycles();
+    info->voluntarySwitches = proc->getVoluntarySwitches();
+    info->involuntarySwitches = proc->getInvoluntarySwitches();
+    info->mappedPages = usage.mapped;
+    info->residentPages = usage.resident;
+    info->sharedPages = usage.shared;
+    info->tablePages = usage.tables;
+}
+
 API::Result ProcessCtlHandler(const ProcessID procID,
                               const ProcessOperation action,
                               const Address addr,
@@ -60,10 +84,34 @@ API::Result ProcessCtlHandler(const ProcessID procID,
     case KillPID:
         procs->remove(proc, addr); // Addr contains the exit status
 
-        if (procID == SELF)
+        // Also reschedule if the current thread was removed with its leader
+        if (procID == SELF || procs->current() == ZERO)
             procs->schedule();
         break;
 
+    case SpawnThread:
+    {
+        const ThreadInfo *thread = (const ThreadInfo *) addr;
+        Memory::Access access;
+
+        // The initial stack must be writable for the thread
+        if (!thread || procs->current()->getMemoryContext()->access(
+                thread->stack - sizeof(Address), &access) != MemoryContext::Success ||
+            (access & (Memory::User | Memory::Writable)) != (Memory::User | Memory::Writable))
+        {
+            ERROR("invalid thread stack for process ID " << procs->current()->getID());
+            return API::InvalidArgument;
+        }
+
+        proc = procs->createThread(thread->entry, thread->stack, thread->argument);
+        if (!proc)
+        {
+            ERROR("failed to create thread");
+            return API::IOError;
+        }
+        return (API::Result) (API::Success | (proc->getID() << 16));
+    }
+
     case GetPID:
         return (API::Result) procs->current()->getID();
 
@@ -102,7 +150,18 @@ API::Result ProcessCtlHandler(const ProcessID procID,
         }
         break;
 
+    case SetPriority:
+        if (procs->setPriority(proc, (Process::Priority) addr) != ProcessManager::Success)
+        {
+            ERROR("failed to set priority of PID " << proc->getID());
+            return API::InvalidArgument;
+        }
+        break;
+
     case Wakeup:
+        if (addr & InheritPriority)
+            procs->inheritPriority(proc, procs->current()->getPriority());
+
         // increment wakeup counter and set process ready
         if (procs->wakeup(proc) != ProcessManager::Success)
         {
@@ -111,7 +170,25 @@ API::Result ProcessCtlHandler(const ProcessID procID,
         }
         break;
 
+    case Handoff:
+        if (addr & InheritPriority)
+            procs->inheritPriority(proc, procs->current()->getPriority());
+
+        // wakeup the process and donate the rest of our timeslice
+        if (procs->handoff(proc) != ProcessManager::Success)
+        {
+            ERROR("failed to handoff to process ID " << proc->getID());
+            return API::IOError;
+        }
+        break;
+
     case WatchIRQ:
+        // Deliver the IRQ to the core of the watching process
+        if (Kernel::instance()->routeIRQ(addr) != Kernel::Success)
+        {
+            return API::IOError;
+        }
+
         if (procs->registerInterruptNotify(proc, addr) != ProcessManager::Success)
         {
             ERROR("failed to register IRQ #" << addr << " to process ID " << proc->getID());
@@ -132,11 +209,24 @@ API::Result ProcessCtlHandler(const ProcessID procID,
         break;
 
     case InfoPID:
-        info->id    = proc->getID();
-        info->state = proc->getState();
-        info->parent = proc->getParent();
+        fillInfo(proc, info);
         break;
 
+    case ListPIDs:
+    {
+        Size count = 0;
+
+        // Fill one record for each live process, up to the given maximum
+        for (ProcessID pid = 0; pid < MAX_PROCS && count < output; pid++)
+        {
+            Process *p = procs->get(pid);
+
+            if (p)
+                fillInfo(p, &info[count++]);
+        }
+        return (API::Result) (API::Success | (count << 16));
+    }
+
     case WaitPID:
         if (procs->wait(proc) != ProcessManager::Success)
         {
@@ -174,9 +264,50 @@ API::Result ProcessCtlHandler(const ProcessID procID,
 
     case EnterSleep:
         // Only sleeps the process if no pending wakeups
-        if (procs->sleep((const Timer::Info *)addr) == ProcessManager::Success)
+        if (procs->sleep((const Timer::Info *)addr, false, output) == ProcessManager::Success)
             procs->schedule();
         break;
+
+    case FutexWait:
+    case FutexWake:
+    {
+        MemoryContext *mem = procs->current()->getMemoryContext();
+        Memory::Access access;
+        Address phys;
+
+        if (addr & (sizeof(u32) - 1))
+            return API::InvalidArgument;
+
+        // Futexes are keyed on the physical address of the (shared) page
+        if (mem->lookup(addr, &phys) != MemoryContext::Success &&
+           (mem->mapDemand(addr) != MemoryContext::Success ||
+            mem->lookup(addr, &phys) != MemoryContext::Success))
+            return API::AccessViolation;
+
+        if (mem->access(addr, &access) != MemoryContext::Success ||
+            (access & (Memory::User | Memory::Readable)) != (Memory::User | Memory::Readable))
+            return API::AccessViolation;
+
+        phys += addr & ~PAGEMASK;
+
+        if (action == FutexWake)
+        {
+            const Size woken = procs->futexWake(phys, output);
+            return (API::Result) (API::Success | ((woken < 0xffff ? woken : 0xffff) << 16));
+        }
+
+        // Only sleep if the futex still has the expected value
+        if (*(volatile u32 *) addr != (u32) output)
+            return API::TemporaryUnavailable;
+
+        if (procs->futexWait(phys) != ProcessManager::Success)
+        {
+            ERROR("failed to wait on futex for process ID " << procs->current()->getID());
+            return API::IOError;
+        }
+        procs->schedule();
+        break;
+    }
     }
 
     return API::Success;
@@ -199,6 +330,12 @@ Log & operator << (Log &log, ProcessOperation op)
         case EnterSleep: log.append("EnterSleep"); break;
         case Schedule:  log.append("Schedule"); break;
         case Wakeup:    log.append("Wakeup"); break;
+        case SetPriority: log.append("SetPriority"); break;
+        case Handoff:   log.append("Handoff"); break;
+        case FutexWait: log.append("FutexWait"); break;
+        case FutexWake: log.append("FutexWake"); break;
+        case SpawnThread: log.append("SpawnThread"); break;
+        case ListPIDs:  log.append("ListPIDs"); break;
         default:        log.append("???"); break;
     }
     return log;
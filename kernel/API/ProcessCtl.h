@@ -53,12 +53,32 @@ typedef enum ProcessOperation
     Wakeup,
     Stop,
     Resume,
-    Reset
+    Reset,
+    SetPriority,
+    Handoff,
+    FutexWait,
+    FutexWake,
+    SpawnThread,
+    ListPIDs
 }
 ProcessOperation;
 
 /**
- * Process information structure, used for Info.
+ * Flags for the Wakeup and Handoff operations.
+ */
+typedef enum WakeupFlags
+{
+    /**
+     * Let the target inherit the priority of the caller, such as when a client
+     * sends a request to a server. The target keeps the inherited priority
+     * until it enters the Sleep state.
+     */
+    InheritPriority = 1 << 0
+}
+WakeupFlags;
+
+/**
+ * Process information structure, used for InfoPID and ListPIDs.
  */
 typedef struct ProcessInfo
 {
@@ -70,9 +90,53 @@ typedef struct ProcessInfo
 
     /** Defines the current state of the Process. */
     Process::State state;
+
+    /** Scheduling priority of the Process. */
+    Process::Priority priority;
+
+    /** CPU cycles consumed by the Process. */
+    u64 cycles;
+
+    /** Number of times the Process gave up the CPU itself. */
+    Size voluntarySwitches;
+
+    /** Number of times the Process was preempted. */
+    Size involuntarySwitches;
+
+    /** Pages mapped in the virtual memory of the Process. */
+    Size mappedPages;
+
+    /** Mapped pages of private memory. */
+    Size residentPages;
+
+    /** Mapped pages of memory owned elsewhere, such as shares and devices. */
+    Size sharedPages;
+
+    /** Pages used for the page tables of the Process. */
+    Size tablePages;
 }
 ProcessInfo;
 
+/**
+ * Thread information structure, used for SpawnThread.
+ */
+typedef struct ThreadInfo
+{
+    /** Entry point of the thread. */
+    Address entry;
+
+    /**
+     * Initial user stack pointer. The stack must be mapped writable
+     * in the calling Process. On architectures which pass arguments
+     * on the stack, the caller must store the argument there too.
+     */
+    Address stack;
+
+    /** Argument passed to the entry point in the first argument register. */
+    Address argument;
+}
+ThreadInfo;
+
 /** Operator to print a ProcessOperation to a Log */
 Log & operator << (Log &log, ProcessOperation op);
 
@@ -82,13 +146,33 @@ Log & operator << (Log &log, ProcessOperation op);
  * @param proc Target Process' ID.
  * @param op The operation to perform.
  * @param addr Input argument address, used for program entry point for Spawn,
- *             ProcessInfo pointer for Info.
- * @param output Output argument address (optional).
+ *             ProcessInfo pointer for Info, Process::Priority for SetPriority,
+ *             WakeupFlags for Wakeup and Handoff, the virtual address of
+ *             an aligned u32 for FutexWait and FutexWake, ThreadInfo
+ *             pointer for SpawnThread and ProcessInfo array for ListPIDs.
+ * @param output Output argument address (optional). For FutexWait the value
+ *               which the futex must have to sleep, for FutexWake the
+ *               maximum number of processes to wakeup, for ListPIDs the
+ *               number of entries in the ProcessInfo array and for EnterSleep
+ *               the number of ticks the wakeup may be delayed to coalesce it
+ *               with other wakeups.
  *
  * @return API::Success on success and other API::ErrorCode on failure.
  *         For WaitPID, the process exit status is stored in the upper 16-bits
  *         of this return value on success. For Spawn, the new PID is stored in
- *         the upper 16-bits.
+ *         the upper 16-bits, and likewise for SpawnThread. FutexWait returns API::TemporaryUnavailable if the
+ *         futex no longer has the given value. FutexWake stores the number of
+ *         processes woken up in the upper 16-bits, and ListPIDs the number
+ *         of ProcessInfo entries filled in ascending order of their ID.
+ *
+ * @note WatchIRQ routes the IRQ to the core of the calling process, such that
+ *       device servers can run on their own core. It fails if the interrupt
+ *       controller cannot deliver the IRQ to that core.
+ *
+ * @note Futexes are keyed on the physical address, such that processes can
+ *       synchronize on memory shared with VMShare. Only processes on the same
+ *       core are woken up. A FutexWait may also return when the process is
+ *       woken up by other means, so callers must check the value again.
  */
 inline API::Result ProcessCtl(const ProcessID proc,
                               const ProcessOperation op,
@@ -115,7 +199,7 @@ inline API::Result ProcessCtl(const ProcessID proc,
  * @param proc Target Process' ID.
  * @param op The operation to perform.
  * @param addr Input argument address, used for program entry point for Spawn,
- *             ProcessInfo pointer for Info.
+ *             ProcessInfo pointer for Info and Process::Priority for SetPriority.
  * @param output Output argument address (optional).
  *
  * @return API::Success on success and other API::ErrorCode on failure.
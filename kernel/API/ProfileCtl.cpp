@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/System.h>
+#include <FreeNOS/Kernel.h>
+#include <FreeNOS/Profiler.h>
+#include <Log.h>
+#include "ProfileCtl.h"
+
+API::Result ProfileCtlHandler(const ProfileOperation op,
+                              ProfileSample *samples,
+                              const Size count)
+{
+    Profiler *profiler = Kernel::instance()->getProfiler();
+
+    DEBUG("op = " << (uint) op << " count = " << count);
+
+    switch (op)
+    {
+        case ProfileStart:
+            profiler->start();
+            break;
+
+        case ProfileStop:
+        {
+            profiler->stop();
+
+            const Size dropped = profiler->dropped();
+            return (API::Result) (API::Success | ((dropped < 0xffff ? dropped : 0xffff) << 16));
+        }
+
+        case ProfileRead:
+        {
+            if (!samples || count > Profiler::MaximumSamples)
+                return API::InvalidArgument;
+
+            const Size num = profiler->read(samples, count);
+            return (API::Result) (API::Success | (num << 16));
+        }
+
+        default:
+            return API::InvalidArgument;
+    }
+
+    return API::Success;
+}
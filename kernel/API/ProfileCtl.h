@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_API_PROFILECTL_H
+#define __KERNEL_API_PROFILECTL_H
+
+#include <Types.h>
+
+/**
+ * @addtogroup kernel
+ * @{
+ *
+ * @addtogroup kernelapi
+ * @{
+ */
+
+/**
+ * Available operations to perform using ProfileCtl.
+ *
+ * @see ProfileCtl
+ */
+typedef enum ProfileOperation
+{
+    ProfileStart = 0,
+    ProfileStop,
+    ProfileRead
+}
+ProfileOperation;
+
+/**
+ * Single sample recorded by the kernel profiler.
+ */
+typedef struct ProfileSample
+{
+    /** Process which was interrupted. */
+    ProcessID pid;
+
+    /** Program counter at the moment of the interrupt. */
+    Address pc;
+
+    /** True if the interrupt occurred while executing the kernel. */
+    bool kernel;
+}
+ProfileSample;
+
+/**
+ * Prototype for user applications. Controls the sampling profiler of the current core.
+ *
+ * On each timer interrupt the profiler records the interrupted process and
+ * program counter in a ring buffer, which is drained using ProfileRead.
+ *
+ * @param op The operation to perform.
+ * @param samples Output array of samples for ProfileRead.
+ * @param count Maximum number of samples to read for ProfileRead.
+ *
+ * @return API::Success on success and other API::ErrorCode on failure.
+ *         For ProfileRead, the number of samples read is stored in the
+ *         upper 16-bits of this return value on success. For ProfileStop,
+ *         the number of samples dropped because the buffer was full.
+ */
+inline API::Result ProfileCtl(const ProfileOperation op,
+                              ProfileSample *samples = ZERO,
+                              const Size count = 0)
+{
+    return (API::Result) trapKernel3(API::ProfileCtlNumber, op, (Address) samples, count);
+}
+
+/**
+ * @}
+ */
+
+#ifdef __KERNEL__
+
+/**
+ * @addtogroup kernelapi_handler
+ * @{
+ */
+
+/**
+ * Kernel handler prototype. Controls the sampling profiler of the current core.
+ *
+ * @param op The operation to perform.
+ * @param samples Output array of samples for ProfileRead.
+ * @param count Maximum number of samples to read for ProfileRead.
+ *
+ * @return API::Success on success and other API::ErrorCode on failure.
+ *         For ProfileRead, the number of samples read is stored in the
+ *         upper 16-bits of this return value on success. For ProfileStop,
+ *         the number of samples dropped because the buffer was full.
+ */
+extern API::Result ProfileCtlHandler(const ProfileOperation op,
+                                     ProfileSample *samples,
+                                     const Size count);
+
+/**
+ * @}
+ */
+
+#endif /* __KERNEL__ */
+
+/**
+ * @}
+ */
+
+#endif /* __KERNEL_API_PROFILECTL_H */
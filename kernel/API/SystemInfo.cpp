@@ -18,6 +18,7 @@
 #include <FreeNOS/System.h>
 #include <FreeNOS/Config.h>
 #include <FreeNOS/Kernel.h>
+#include <FreeNOS/ProcessManager.h>
 #include <SplitAllocator.h>
 #include <CoreInfo.h>
 
@@ -34,13 +35,30 @@ API::Result SystemInfoHandler(SystemInformation *info)
     info->kernelSize       = core->kernel.size;
     info->memorySize       = memory->size();
     info->memoryAvail      = memory->available();
+
+    static_assert(MEMORY_BLOCK_ORDERS == BuddyAllocator::MaximumOrder + 1,
+                  "MEMORY_BLOCK_ORDERS must match the BuddyAllocator");
+
+    for (Size i = 0; i < MEMORY_BLOCK_ORDERS; i++)
+        info->memoryBlocks[i] = memory->freeBlocks(i);
+    info->zeroPoolCount    = memory->zeroPoolCount();
+    info->zeroPoolHits     = memory->zeroPoolHits();
+    info->zeroPoolMisses   = memory->zeroPoolMisses();
     info->coreId           = core->coreId;
 
     info->bootImageAddress = core->bootImageAddress;
     info->bootImageSize    = core->bootImageSize;
     info->timerCounter     = core->timerCounter;
+    info->timestampFrequency = core->timestampFrequency;
+    info->corePackage      = core->package;
+    info->coreCache        = core->cache;
+    info->coreNode         = core->node;
     info->coreChannelAddress = core->coreChannelAddress;
     info->coreChannelSize    = core->coreChannelSize;
+    info->runQueueSize       = Kernel::instance()->getProcessManager()->readyCount();
+    info->irqOffMax          = Kernel::instance()->getInterruptsOffMax(&info->irqOffSite);
+    info->idle               = Kernel::instance()->getProcessManager()->getIdleStatistics();
+    info->clockPageAddress   = Kernel::instance()->getClockPageAddress();
 
     MemoryBlock::copy(info->cmdline, coreInfo.kernelCommand, 64);
     return API::Success;
@@ -19,9 +19,13 @@
 #define __KERNEL_API_SYSTEMINFO_H
 
 #include <Types.h>
+#include "IdleState.h"
 
 struct SystemInformation;
 
+/** Number of physical memory block orders, equal to BuddyAllocator::MaximumOrder + 1 */
+#define MEMORY_BLOCK_ORDERS 11
+
 /**
  * @addtogroup kernel
  * @{
@@ -101,6 +105,12 @@ typedef struct SystemInformation
     /** Total and available memory in bytes. */
     Size memorySize, memoryAvail;
 
+    /** Number of free physical memory blocks of (1 << order) pages. */
+    Size memoryBlocks[MEMORY_BLOCK_ORDERS];
+
+    /** Pre-zeroed pages in the zero pool, and pool hits and misses. */
+    Size zeroPoolCount, zeroPoolHits, zeroPoolMisses;
+
     /** Core Identifier */
     uint coreId;
 
@@ -115,6 +125,27 @@ typedef struct SystemInformation
 
     /** Timer counter */
     uint timerCounter;
+
+    /** Timestamp counter frequency in kilohertz, or zero if unknown */
+    uint timestampFrequency;
+
+    /** Processor package, second level cache and NUMA domain of this core */
+    uint corePackage, coreCache, coreNode;
+
+    /** Number of processes ready to run on this core */
+    Size runQueueSize;
+
+    /** Longest kernel span with interrupts disabled in timestamp counter cycles, or zero if not measured */
+    u64 irqOffMax;
+
+    /** Code address of the kernel work in the longest span: a handler or a preemption point caller */
+    Address irqOffSite;
+
+    /** Idle residency and wakeup latency of this core */
+    IdleStatistics idle;
+
+    /** Physical address of the ClockPage of this core */
+    Address clockPageAddress;
 }
 SystemInformation;
 
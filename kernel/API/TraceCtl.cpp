@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/System.h>
+#include <FreeNOS/Kernel.h>
+#include <FreeNOS/Trace.h>
+#include <FreeNOS/BootTimeline.h>
+#include <FreeNOS/ProcessManager.h>
+#include <MemoryBlock.h>
+#include <Log.h>
+#include "TraceCtl.h"
+
+API::Result TraceCtlHandler(const TraceOperation op,
+                            const Address buffer,
+                            const Size count)
+{
+    Trace *trace = Kernel::instance()->getTrace();
+    TraceRecord *records = (TraceRecord *) buffer;
+    BootEvent *events = (BootEvent *) buffer;
+
+    DEBUG("op = " << (uint) op << " count = " << count);
+
+    switch (op)
+    {
+        case TraceBootMark:
+        {
+            if (!events || count != 1)
+                return API::InvalidArgument;
+
+            const ProcessID pid = Kernel::instance()->getProcessManager()->current()->getID();
+            char label[sizeof(events->label)];
+
+            MemoryBlock::copy(label, events->label, sizeof(label));
+            label[sizeof(label) - 1] = ZERO;
+
+            BootTimeline::record((BootMilestone) events->type, pid, events->arg, label);
+            return API::Success;
+        }
+
+        case TraceBootRead:
+        {
+            if (!events || count > BootTimeline::MaximumEvents)
+                return API::InvalidArgument;
+
+            const Size num = BootTimeline::read(events, count);
+            return (API::Result) (API::Success | (num << 16));
+        }
+
+        case TraceRead:
+        {
+            if (trace == ZERO)
+                return API::NotFound;
+
+            if (!records || count > Trace::MaximumRecords)
+                return API::InvalidArgument;
+
+            const Size num = trace->read(records, count);
+            return (API::Result) (API::Success | (num << 16));
+        }
+
+        default:
+            return API::InvalidArgument;
+    }
+}
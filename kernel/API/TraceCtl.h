@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_API_TRACECTL_H
+#define __KERNEL_API_TRACECTL_H
+
+#include <Types.h>
+
+/**
+ * @addtogroup kernel
+ * @{
+ *
+ * @addtogroup kernelapi
+ * @{
+ */
+
+/**
+ * Available operations to perform using TraceCtl.
+ *
+ * @see TraceCtl
+ */
+typedef enum TraceOperation
+{
+    TraceRead = 0,
+    TraceBootMark,
+    TraceBootRead
+}
+TraceOperation;
+
+/**
+ * Types of kernel trace records.
+ */
+typedef enum TraceType
+{
+    /** Records were overwritten before being read. arg0: number of records lost */
+    TraceLost = 0,
+
+    /** Context switch. arg0: next process ID, arg1: true if voluntary */
+    TraceSwitch,
+
+    /** ProcessEvent raised. arg0: target process ID, arg1: ProcessEventType */
+    TraceProcessEvent,
+
+    /** Interrupt handler entry. arg0: interrupt vector */
+    TraceInterruptEnter,
+
+    /** Interrupt handler exit. arg0: interrupt vector */
+    TraceInterruptExit,
+
+    /** Process woken up. arg0: target process ID */
+    TraceWakeup,
+
+    /** VMCtl call. arg0: target process ID, arg1: MemoryOperation */
+    TraceVMCtl,
+
+    /** Priority inherited from a client. arg0: target process ID, arg1: new priority */
+    TraceInherit
+}
+TraceType;
+
+/**
+ * Fixed size binary record of a kernel event.
+ */
+typedef struct TraceRecord
+{
+    /** Value of timestamp() when the event occurred. */
+    u64 timestamp;
+
+    /** Type of event. */
+    u32 type;
+
+    /** Process executing when the event occurred, or zero. */
+    ProcessID pid;
+
+    /** First event specific argument. */
+    u32 arg0;
+
+    /** Second event specific argument. */
+    u32 arg1;
+}
+TraceRecord;
+
+/**
+ * Milestones in the boot timeline.
+ */
+typedef enum BootMilestone
+{
+    /** Kernel started on the core. arg: core ID */
+    BootKernelEntry = 0,
+
+    /** Kernel heap initialized. */
+    BootHeapReady,
+
+    /** Boot image program loaded. arg: process ID, label: program name */
+    BootProgramLoaded,
+
+    /** Server entered its request loop. */
+    BootServerReady,
+
+    /** CoreServer started a secondary core. arg: core ID */
+    BootCoreStarted,
+
+    /** Secondary core booted its kernel. arg: core ID */
+    BootCoreOnline,
+
+    /** Init started a service. arg: process ID, label: service name */
+    BootServiceStarted,
+
+    /** Service is ready. arg: process ID, label: service name */
+    BootServiceReady,
+
+    /** Init finished starting services and runs the init script. */
+    BootInitDone
+}
+BootMilestone;
+
+/**
+ * Fixed size binary record of a boot milestone.
+ */
+typedef struct BootEvent
+{
+    /** Nanoseconds since the kernel entry, filled by TraceBootRead. */
+    u64 time;
+
+    /** Value of timestamp() when the milestone was reached. */
+    u64 timestamp;
+
+    /** Timer ticks when the milestone was reached. */
+    u32 ticks;
+
+    /** BootMilestone type. */
+    u32 type;
+
+    /** Process which reached the milestone, or zero for the kernel. */
+    ProcessID pid;
+
+    /** Milestone specific argument. */
+    u32 arg;
+
+    /** Milestone specific name. */
+    char label[16];
+}
+BootEvent;
+
+/**
+ * Prototype for user applications. Drain the kernel trace records of the current core.
+ *
+ * Tracing is only available if the kernel is built with TRACE enabled.
+ *
+ * @param op The operation to perform.
+ * @param records Output array of records for TraceRead.
+ * @param count Maximum number of records to read for TraceRead.
+ *
+ * @return API::Success on success and other API::ErrorCode on failure.
+ *         For TraceRead, the number of records read is stored in the
+ *         upper 16-bits of this return value on success.
+ *         API::NotFound if tracing is not built into the kernel.
+ */
+inline API::Result TraceCtl(const TraceOperation op,
+                            TraceRecord *records,
+                            const Size count)
+{
+    return (API::Result) trapKernel3(API::TraceCtlNumber, op, (Address) records, count);
+}
+
+/**
+ * Prototype for user applications. Access the boot timeline of the current core.
+ *
+ * The boot timeline is always available, also without TRACE.
+ *
+ * @param op TraceBootMark or TraceBootRead
+ * @param events Input event for TraceBootMark or output array for TraceBootRead.
+ * @param count Number of events to record or maximum number of events to read.
+ *
+ * @return API::Success on success and other API::ErrorCode on failure.
+ *         For TraceBootRead, the number of events read is stored in the
+ *         upper 16-bits of this return value on success.
+ */
+inline API::Result TraceCtl(const TraceOperation op,
+                            BootEvent *events,
+                            const Size count)
+{
+    return (API::Result) trapKernel3(API::TraceCtlNumber, op, (Address) events, count);
+}
+
+/**
+ * Prototype for user applications. Record a boot milestone of the current process.
+ *
+ * @param type Milestone reached
+ * @param arg Milestone specific argument
+ * @param label Milestone specific name or ZERO. Truncated to fit BootEvent.
+ *
+ * @return API::Success on success and other API::ErrorCode on failure.
+ */
+inline API::Result BootMark(const BootMilestone type,
+                            const u32 arg = 0,
+                            const char *label = ZERO)
+{
+    BootEvent event;
+    Size i = 0;
+
+    event.type = type;
+    event.arg  = arg;
+
+    for (; label && label[i] && i < sizeof(event.label) - 1; i++)
+        event.label[i] = label[i];
+    event.label[i] = ZERO;
+
+    return TraceCtl(TraceBootMark, &event, 1);
+}
+
+/**
+ * @}
+ */
+
+#ifdef __KERNEL__
+
+/**
+ * @addtogroup kernelapi_handler
+ * @{
+ */
+
+/**
+ * Kernel handler prototype. Drain the kernel trace records or access
+ * the boot timeline of the current core.
+ *
+ * @param op The operation to perform.
+ * @param buffer Array of TraceRecord for TraceRead or BootEvent for the boot operations.
+ * @param count Number of entries in the array.
+ *
+ * @return API::Success on success and other API::ErrorCode on failure.
+ *         For TraceRead and TraceBootRead, the number of entries read is
+ *         stored in the upper 16-bits of this return value on success.
+ *         API::NotFound if tracing is not built into the kernel.
+ */
+extern API::Result TraceCtlHandler(const TraceOperation op,
+                                   const Address buffer,
+                                   const Size count);
+
+/**
+ * @}
+ */
+
+#endif /* __KERNEL__ */
+
+/**
+ * @}
+ */
+
+#endif /* __KERNEL_API_TRACECTL_H */
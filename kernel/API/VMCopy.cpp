@@ -29,7 +29,7 @@ API::Result VMCopyHandler(const ProcessID procID,
 {
     ProcessManager *procs = Kernel::instance()->getProcessManager();
     MemoryContext::Result memResult = MemoryContext::Success;
-    Size bytes = 0, pageOff, total = 0;
+    Size bytes = 0, pageOff, total = 0, chunk = 0;
     Address paddr, vaddr;
     Address ourAddr = ours, theirAddr = theirs;
     Process *proc;
@@ -48,11 +48,20 @@ API::Result VMCopyHandler(const ProcessID procID,
     // Keep on going until all memory is processed
     while (total < sz)
     {
+        // Give the remote process its own copy of a shared page before writing
+        if (how == API::Write)
+            remote->copyOnWrite(theirAddr);
+
         // Update variables
         if (how == API::ReadPhys)
             paddr = theirAddr & PAGEMASK;
         else if (remote->lookup(theirAddr, &paddr) != MemoryContext::Success)
-            return API::AccessViolation;
+        {
+            // Back demand-zero pages before copying
+            if (remote->mapDemand(theirAddr) != MemoryContext::Success ||
+                remote->lookup(theirAddr, &paddr) != MemoryContext::Success)
+                return API::AccessViolation;
+        }
 
         assert(!(paddr & ~PAGEMASK));
         pageOff = theirAddr & ~PAGEMASK;
@@ -97,6 +106,14 @@ API::Result VMCopyHandler(const ProcessID procID,
         ourAddr   += bytes;
         theirAddr += bytes;
         total     += bytes;
+        chunk     += bytes;
+
+        // Let pending interrupts in between chunks of large copies
+        if (chunk >= Kernel::PreemptionChunkSize && total < sz)
+        {
+            Kernel::instance()->preemptionPoint();
+            chunk = 0;
+        }
     }
 
     return API::Success;
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/System.h>
+#include "VMCopy.h"
+#include "VMCopyVector.h"
+
+API::Result VMCopyVectorHandler(const ProcessID proc,
+                                const API::Operation how,
+                                const VMCopySegment *segments,
+                                const Size count)
+{
+    DEBUG("");
+
+    if (!segments || count > VMCOPY_MAX_SEGMENTS)
+        return API::InvalidArgument;
+
+    // Copy each segment, stopping at the first failure
+    for (Size i = 0; i < count; i++)
+    {
+        const API::Result result = VMCopyHandler(proc, how, segments[i].ours,
+                                                 segments[i].theirs, segments[i].size);
+        if (result != API::Success)
+            return result;
+    }
+
+    return API::Success;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_API_VMCOPYVECTOR_H
+#define __KERNEL_API_VMCOPYVECTOR_H
+
+#include <Types.h>
+
+/**
+ * @addtogroup kernel
+ * @{
+ *
+ * @addtogroup kernelapi
+ * @{
+ */
+
+/** Maximum number of segments copied by a single VMCopyVector() call. */
+#define VMCOPY_MAX_SEGMENTS 32
+
+/**
+ * Describes one copy of a VMCopyVector() call.
+ */
+typedef struct VMCopySegment
+{
+    /** Virtual address of the buffer of this process. */
+    Address ours;
+
+    /** Virtual address of the remote process' buffer. */
+    Address theirs;
+
+    /** Amount of memory to copy. */
+    Size size;
+}
+VMCopySegment;
+
+/**
+ * Prototype for user applications. Copies several pieces of virtual memory between two processes.
+ *
+ * @param proc Remote process.
+ * @param how Read or Write.
+ * @param segments Array of segments to copy, processed in order.
+ * @param count Number of segments, at most VMCOPY_MAX_SEGMENTS.
+ *
+ * @return API::Success on success and any other value on error.
+ */
+inline API::Result VMCopyVector(const ProcessID proc,
+                                const API::Operation how,
+                                const VMCopySegment *segments,
+                                const Size count)
+{
+    return (API::Result) trapKernel4(API::VMCopyVectorNumber, proc, how, (Address) segments, count);
+}
+
+/**
+ * @}
+ */
+
+#ifdef __KERNEL__
+
+/**
+ * @addtogroup kernelapi_handler
+ * @{
+ */
+
+/**
+ * Kernel handler prototype. Copies several pieces of virtual memory between two processes.
+ *
+ * @param proc Remote process.
+ * @param how Read or Write.
+ * @param segments Array of segments to copy, processed in order.
+ * @param count Number of segments, at most VMCOPY_MAX_SEGMENTS.
+ *
+ * @return API::Success on success and any other value on error.
+ */
+extern API::Result VMCopyVectorHandler(const ProcessID proc,
+                                       const API::Operation how,
+                                       const VMCopySegment *segments,
+                                       const Size count);
+
+/**
+ * @}
+ */
+
+#endif /* __KERNEL__ */
+
+/**
+ * @}
+ */
+
+#endif /* __KERNEL_API_VMCOPYVECTOR_H */
@@ -17,10 +17,35 @@
 
 #include <FreeNOS/System.h>
 #include <FreeNOS/ProcessManager.h>
+#include <FreeNOS/Trace.h>
 #include <SplitAllocator.h>
 #include "VMCtl.h"
 #include "ProcessID.h"
 
+/**
+ * Find unused virtual memory for a new mapping.
+ *
+ * Ranges of at least a large page start on a large page boundary,
+ * such that physically aligned memory can be mapped with large pages.
+ *
+ * @param mem Memory context of the process
+ * @param range Range with the size and physical address. Receives the virtual address.
+ *
+ * @return Result code
+ */
+static MemoryContext::Result findFreeRange(const MemoryContext *mem, Memory::Range *range)
+{
+    if (range->size >= SECTIONSIZE && !(range->phys & ~SECTIONMASK) &&
+        mem->findFree(range->size + SECTIONSIZE - PAGESIZE, MemoryMap::UserPrivate,
+                      &range->virt) == MemoryContext::Success)
+    {
+        range->virt = (range->virt + SECTIONSIZE - 1) & SECTIONMASK;
+        return MemoryContext::Success;
+    }
+
+    return mem->findFree(range->size, MemoryMap::UserPrivate, &range->virt);
+}
+
 API::Result VMCtlHandler(const ProcessID procID,
                          const MemoryOperation op,
                          Memory::Range *range)
@@ -40,6 +65,8 @@ API::Result VMCtlHandler(const ProcessID procID,
         return API::NotFound;
     }
 
+    TRACE(TraceVMCtl, proc->getID(), op);
+
     // Retrieve memory context
     MemoryContext *mem = proc->getMemoryContext();
 
@@ -49,6 +76,11 @@ API::Result VMCtlHandler(const ProcessID procID,
         case LookupVirtual:
             // Translate virtual address to physical address (page boundary)
             memResult = mem->lookup(range->virt, &range->phys);
+
+            // Demand-zero pages are backed before their first use
+            if (memResult != MemoryContext::Success && mem->mapDemand(range->virt) == MemoryContext::Success)
+                memResult = mem->lookup(range->virt, &range->phys);
+
             if (memResult != MemoryContext::Success)
             {
                 ERROR("failed to lookup virtual address " << (void *) range->virt <<
@@ -65,7 +97,7 @@ API::Result VMCtlHandler(const ProcessID procID,
         case MapSparse:
             if (!range->virt)
             {
-                memResult = mem->findFree(range->size, MemoryMap::UserPrivate, &range->virt);
+                memResult = findFreeRange(mem, range);
                 if (memResult != MemoryContext::Success)
                 {
                     ERROR("failed to find free virtual address in UserPrivate: " <<
@@ -87,6 +119,46 @@ API::Result VMCtlHandler(const ProcessID procID,
             }
             break;
 
+        case MapDemand:
+            memResult = mem->reserveRange(range);
+            if (memResult != MemoryContext::Success)
+            {
+                ERROR("failed to reserve demand-zero range at " << (void *)range->virt <<
+                      ": " << (int) memResult);
+                return API::IOError;
+            }
+            break;
+
+        case MapCopyOnWrite:
+            memResult = mem->mapCopyOnWrite(range);
+            if (memResult != MemoryContext::Success)
+            {
+                ERROR("failed to map copy-on-write range " << (void *)range->virt << "->" <<
+                      (void *) range->phys << ": " << (int) memResult);
+                return API::IOError;
+            }
+            break;
+
+        case MapShared:
+            if (!range->virt)
+            {
+                memResult = findFreeRange(mem, range);
+                if (memResult != MemoryContext::Success)
+                {
+                    ERROR("failed to find free virtual address in UserPrivate: " <<
+                         (int) memResult);
+                    return API::IOError;
+                }
+            }
+            memResult = mem->mapShared(range);
+            if (memResult != MemoryContext::Success)
+            {
+                ERROR("failed to map shared range " << (void *)range->virt << "->" <<
+                      (void *) range->phys << ": " << (int) memResult);
+                return API::IOError;
+            }
+            break;
+
         case UnMap:
             memResult = mem->unmapRange(range);
             if (memResult != MemoryContext::Success)
@@ -119,13 +191,13 @@ API::Result VMCtlHandler(const ProcessID procID,
 
         case CacheClean: {
             Arch::Cache cache;
-            cache.cleanData(range->virt);
+            cache.cleanRange(Cache::Data, range->virt, range->size);
             break;
         }
 
         case CacheInvalidate: {
             Arch::Cache cache;
-            const Cache::Result r = cache.invalidateAddress(Cache::Data, range->virt);
+            const Cache::Result r = cache.invalidateRange(Cache::Data, range->virt, range->size);
             if (r != Cache::Success)
             {
                 ERROR("failed to invalidate cache at address " << (void *) range->virt <<
@@ -137,12 +209,16 @@ API::Result VMCtlHandler(const ProcessID procID,
 
         case CacheCleanInvalidate: {
             Arch::Cache cache;
-            cache.cleanInvalidate(Cache::Data);
+            cache.cleanInvalidateRange(Cache::Data, range->virt, range->size);
             break;
         }
 
         case Access: {
-            const MemoryContext::Result mr = mem->access(range->virt, &range->access);
+            MemoryContext::Result mr = mem->access(range->virt, &range->access);
+
+            if (mr != MemoryContext::Success && mem->mapDemand(range->virt) == MemoryContext::Success)
+                mr = mem->access(range->virt, &range->access);
+
             if (mr == MemoryContext::Success)
                 ret = API::Success;
             else
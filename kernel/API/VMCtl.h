@@ -45,7 +45,10 @@ typedef enum MemoryOperation
     AddMem,
     CacheClean,
     CacheInvalidate,
-    CacheCleanInvalidate
+    CacheCleanInvalidate,
+    MapDemand,
+    MapCopyOnWrite,
+    MapShared
 }
 MemoryOperation;
 
@@ -54,7 +57,8 @@ MemoryOperation;
  *
  * @param procID Remote process.
  * @param op Determines which operation to perform.
- * @param range Describes the memory pages to operate on.
+ * @param range Describes the memory pages to operate on. Cache operations
+ *              only apply to the cache lines of the given virtual range.
  *
  * @return API::Success on success and other API::ErrorCode on failure.
  */
@@ -67,7 +67,16 @@ API::Result VMShareHandler(const ProcessID procID,
             break;
 
         case API::Delete:
-            if (procs->current()->getShares().removeShares(procID) != ProcessShares::Success)
+            if (share != ZERO)
+            {
+                switch (procs->current()->getShares().removeShare(procID, share->coreId, share->tagId))
+                {
+                    case ProcessShares::Success: return API::Success;
+                    case ProcessShares::NotFound: return API::NotFound;
+                    default: return API::IOError;
+                }
+            }
+            else if (procs->current()->getShares().removeShares(procID) != ProcessShares::Success)
                 ret = API::IOError;
             break;
 
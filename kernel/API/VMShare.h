@@ -34,7 +34,9 @@
  *
  * @param pid Remote process.
  * @param op Determines which operation to perform.
- * @param share Pointer to the MemoryShare to use in the operation
+ * @param share Pointer to the MemoryShare to use in the operation. For API::Delete,
+ *              only the share matching its coreId and tagId is removed, or ZERO
+ *              to remove all shares with the remote process.
  *
  * @return API::Success on success and other API::ErrorCode on failure.
  */
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/System.h>
+#include <MemoryBlock.h>
+#include "Kernel.h"
+#include "BootTimeline.h"
+
+BootEvent BootTimeline::m_events[BootTimeline::MaximumEvents];
+
+Size BootTimeline::m_count;
+
+void BootTimeline::record(const BootMilestone type,
+                          const ProcessID pid,
+                          const u32 arg,
+                          const char *label,
+                          const u64 when)
+{
+    Kernel *kernel = Kernel::instance();
+    Timer *timer = kernel ? kernel->getTimer() : ZERO;
+    Timer::Info info;
+
+    if (m_count >= MaximumEvents)
+        return;
+
+    BootEvent & event = m_events[m_count++];
+    MemoryBlock::set(&event, 0, sizeof(event));
+    event.timestamp = when ? when : timestamp();
+    event.type      = type;
+    event.pid       = pid;
+    event.arg       = arg;
+
+    if (timer && timer->getCurrent(&info) == Timer::Success)
+        event.ticks = info.ticks;
+
+    if (label)
+        MemoryBlock::copy(event.label, (char *) label, sizeof(event.label));
+}
+
+Size BootTimeline::read(BootEvent *events, const Size count)
+{
+    Kernel *kernel = Kernel::instance();
+    const Timer *timer = kernel ? kernel->getTimer() : ZERO;
+    const Size num = count < m_count ? count : m_count;
+    const Size hertz = timer ? timer->getFrequency() : 0;
+    Size kiloHertz = 0;
+
+    if (timer)
+        timer->getTickTimestamp(&kiloHertz);
+
+    for (Size i = 0; i < num; i++)
+    {
+        events[i] = m_events[i];
+
+        // Split the division to avoid overflowing on large cycle counts
+        if (kiloHertz)
+        {
+            const u64 cycles = m_events[i].timestamp - m_events[0].timestamp;
+            events[i].time = ((cycles / kiloHertz) * 1000000ULL) +
+                             (((cycles % kiloHertz) * 1000000ULL) / kiloHertz);
+        }
+        else if (hertz)
+            events[i].time = (u64) (m_events[i].ticks - m_events[0].ticks) * (1000000000ULL / hertz);
+        else
+            events[i].time = 0;
+    }
+
+    return num;
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_BOOTTIMELINE_H
+#define __KERNEL_BOOTTIMELINE_H
+
+#include <Types.h>
+#include "API.h"
+
+/**
+ * @addtogroup kernel
+ * @{
+ */
+
+/**
+ * Timestamped boot milestones of the core.
+ *
+ * The kernel records its own milestones and processes add theirs with
+ * TraceBootMark. Storage is static and needs no constructor, such that
+ * milestones before the kernel object exists are kept. Once full, further
+ * milestones are ignored: the start of the boot is the interesting part.
+ */
+class BootTimeline
+{
+  public:
+
+    /** Maximum number of events kept */
+    static const Size MaximumEvents = 128;
+
+  public:
+
+    /**
+     * Record a milestone.
+     *
+     * @param type Milestone reached
+     * @param pid Process which reached it or zero for the kernel
+     * @param arg Milestone specific argument
+     * @param label Milestone specific name or ZERO
+     * @param when Value of timestamp() when the milestone was reached or zero for now
+     */
+    static void record(const BootMilestone type,
+                       const ProcessID pid,
+                       const u32 arg,
+                       const char *label,
+                       const u64 when = 0);
+
+    /**
+     * Copy recorded milestones, oldest first.
+     *
+     * The time of each event is converted to nanoseconds since the first event,
+     * using the timestamp counter if its frequency is known and otherwise the
+     * timer ticks.
+     *
+     * @param events Output array of events
+     * @param count Maximum number of events to output
+     *
+     * @return Number of events written to the output array
+     */
+    static Size read(BootEvent *events, const Size count);
+
+  private:
+
+    /** Recorded events */
+    static BootEvent m_events[MaximumEvents];
+
+    /** Number of recorded events */
+    static Size m_count;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __KERNEL_BOOTTIMELINE_H */
@@ -24,11 +24,15 @@
 #include <PoolAllocator.h>
 #include <IntController.h>
 #include <BootImageStorage.h>
+#include <Lz4Decompressor.h>
 #include <CoreInfo.h>
 #include "Kernel.h"
 #include "Memory.h"
 #include "Process.h"
 #include "ProcessManager.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "BootTimeline.h"
 
 Kernel::Kernel(CoreInfo *info)
     : WeakSingleton<Kernel>(this)
@@ -50,10 +54,21 @@ Kernel::Kernel(CoreInfo *info)
 
     // Initialize other class members
     m_procs  = new ProcessManager();
+    m_profiler = new Profiler();
     m_api    = new API();
     m_coreInfo   = info;
     m_intControl = ZERO;
     m_timer      = ZERO;
+    m_perf       = ZERO;
+    m_irqOffStart   = 0;
+    m_irqOffSite    = ZERO;
+    m_irqOffMax     = 0;
+    m_irqOffMaxSite = ZERO;
+#ifdef __TRACE__
+    m_trace      = new Trace();
+#else
+    m_trace      = ZERO;
+#endif /* __TRACE__ */
 
     // Print memory map
     NOTICE("kernel @ " << (void *) info->kernel.phys << ".." <<
@@ -101,6 +116,15 @@ Kernel::Kernel(CoreInfo *info)
     for (Size i = 0; i < m_coreInfo->coreChannelSize; i += PAGESIZE)
         m_alloc->allocate(m_coreInfo->coreChannelAddress + i);
 
+    // Allocate the ClockPage which processes read the time from
+    Allocator::Range clockPhys = { 0, PAGESIZE, PAGESIZE }, clockVirt;
+    if (m_alloc->allocateZeroed(clockPhys, clockVirt) != Allocator::Success)
+    {
+        FATAL("failed to allocate ClockPage");
+    }
+    m_clockPage = (ClockPage *) clockVirt.address;
+    m_clockPageAddress = clockPhys.address;
+
     // Clear interrupts table
     m_interrupts.fill(ZERO);
 }
@@ -132,6 +156,7 @@ Error Kernel::initializeHeap()
 
     // Set default allocator
     Allocator::setDefault(pool);
+    BootTimeline::record(BootHeapReady, 0, 0, ZERO);
     return 0;
 }
 
@@ -145,6 +170,11 @@ ProcessManager * Kernel::getProcessManager()
     return m_procs;
 }
 
+Profiler * Kernel::getProfiler()
+{
+    return m_profiler;
+}
+
 API * Kernel::getAPI()
 {
     return m_api;
@@ -165,6 +195,65 @@ Timer * Kernel::getTimer()
     return m_timer;
 }
 
+PerformanceCounter * Kernel::getPerformanceCounter()
+{
+    return m_perf;
+}
+
+Trace * Kernel::getTrace()
+{
+    return m_trace;
+}
+
+Address Kernel::getClockPageAddress() const
+{
+    return m_clockPageAddress;
+}
+
+u64 Kernel::getInterruptsOffMax(Address *site) const
+{
+    *site = m_irqOffMaxSite;
+    return m_irqOffMax;
+}
+
+void Kernel::beginInterruptsOff(const Address site)
+{
+    m_irqOffStart = timestamp();
+    m_irqOffSite = site;
+}
+
+void Kernel::setInterruptsOffSite(const Address site)
+{
+    m_irqOffSite = site;
+}
+
+void Kernel::endInterruptsOff()
+{
+    const u64 now = timestamp();
+
+    // Processes which run for the first time did not start a span
+    if (m_irqOffStart == 0)
+        return;
+
+    u64 span = now - m_irqOffStart;
+
+    // Narrow 32-bit cycle counters wrap around between timestamps
+    if (now < m_irqOffStart)
+        span = (u32) span;
+
+    if (span > m_irqOffMax)
+    {
+        m_irqOffMax = span;
+        m_irqOffMaxSite = m_irqOffSite;
+    }
+
+    m_irqOffStart = 0;
+}
+
+void Kernel::preemptionPoint()
+{
+}
+
 void Kernel::enableIRQ(u32 irq, bool enabled)
 {
     if (m_intControl)
@@ -176,6 +265,22 @@ void Kernel::enableIRQ(u32 irq, bool enabled)
     }
 }
 
+Kernel::Result Kernel::routeIRQ(const u32 irq)
+{
+    if (m_intControl)
+    {
+        IntController::Result r = m_intControl->setAffinity(irq, m_coreInfo->coreId);
+        if (r != IntController::Success)
+        {
+            ERROR("failed to route IRQ #" << irq << " to core" << m_coreInfo->coreId <<
+                  ": " << (uint) r);
+            return IOError;
+        }
+    }
+
+    return Success;
+}
+
 Kernel::Result Kernel::sendIRQ(const uint coreId, const uint irq)
 {
     if (m_intControl)
@@ -209,10 +314,13 @@ void Kernel::hookIntVector(u32 vec, InterruptHandler h, ulong p)
 
 void Kernel::executeIntVector(u32 vec, CPUState *state)
 {
+    const u64 entry = timestamp();
+
     // Auto-Mask the IRQ. Any interrupt handler or user program
     // needs to re-enable the IRQ to receive it again. This prevents
     // interrupt loops in case the kernel cannot clear the IRQ immediately.
     enableIRQ(vec, false);
+    TRACE(TraceInterruptEnter, vec, 0);
 
     // Fetch the list of interrupt hooks (for this vector)
     List<InterruptHook *> *lst = m_interrupts[vec];
@@ -221,6 +329,7 @@ void Kernel::executeIntVector(u32 vec, CPUState *state)
         // Execute them all
         for (ListIterator<InterruptHook *> i(lst); i.hasCurrent(); i++)
         {
+            IRQOFF_SITE(i.current()->handler);
             i.current()->handler(state, i.current()->param, vec);
         }
     }
@@ -228,10 +337,12 @@ void Kernel::executeIntVector(u32 vec, CPUState *state)
     // Raise any interrupt notifications for processes. Note that the IRQ
     // base should be subtracted, since userspace doesn't know about re-mapped
     // IRQ's, such as is done for the PIC on intel
-    if (m_procs->interruptNotify(vec - m_intControl->getBase()) != ProcessManager::Success)
+    if (m_procs->interruptNotify(vec - m_intControl->getBase(), entry) != ProcessManager::Success)
     {
         FATAL("failed to raise interrupt notification for IRQ #" << vec);
     }
+
+    TRACE(TraceInterruptExit, vec, 0);
 }
 
 Kernel::Result Kernel::loadBootImage()
@@ -285,6 +396,28 @@ Kernel::Result Kernel::loadBootImage()
     return Success;
 }
 
+Kernel::Result Kernel::decompressBootSegment(const BootSegment &segment,
+                                             const Address phys) const
+{
+    const u8 *data = (const u8 *) m_alloc->toVirtual(m_coreInfo->bootImageAddress) + segment.offset;
+    Lz4Decompressor lz4(data, segment.dataSize);
+
+    if (lz4.initialize() != Lz4Decompressor::Success ||
+        lz4.getUncompressedSize() != segment.size)
+    {
+        ERROR("invalid compressed BootSegment at offset " << segment.offset);
+        return InvalidBootImage;
+    }
+
+    if (lz4.read((void *) m_alloc->toVirtual(phys), segment.size) != Lz4Decompressor::Success)
+    {
+        ERROR("failed to decompress BootSegment at offset " << segment.offset);
+        return InvalidBootImage;
+    }
+
+    return Success;
+}
+
 Kernel::Result Kernel::loadBootProgram(const BootImageStorage &bootImage,
                                        const BootSymbol &program)
 {
@@ -324,13 +457,30 @@ Kernel::Result Kernel::loadBootProgram(const BootImageStorage &bootImage,
             return ProcessError;
         }
 
-        // Map memory
         Memory::Range range;
-        range.phys = 0;
+        range.phys = m_coreInfo->bootImageAddress + segment.offset;
         range.virt = segment.virtualAddress;
         range.size = segment.size;
-        range.access = Memory::User | Memory::Readable | Memory::Writable | Memory::Executable;
+        range.access = Memory::User | (Memory::Access) segment.access;
+
+        // Map page aligned segments straight from the BootImage. Read-only segments
+        // execute in place, while processes loaded from the same program share
+        // the pages of writable segments until they are written.
+        if (!(segment.flags & BootSegmentCompressed) &&
+            !(range.phys & ~PAGEMASK) && !(range.virt & ~PAGEMASK))
+        {
+            const MemoryContext::Result cowResult = mem->mapCopyOnWrite(&range);
+            if (cowResult != MemoryContext::Success)
+            {
+                FATAL("failed to share BootSegment at " << (void *) segment.virtualAddress <<
+                      " for BootProgram " << program.name << ": result = " << (int) cowResult);
+                return ProcessError;
+            }
+            continue;
+        }
 
+        // Map memory
+        range.phys = 0;
         const MemoryContext::Result mapResult = mem->mapRangeContiguous(&range);
         if (mapResult != MemoryContext::Success)
         {
@@ -339,12 +489,25 @@ Kernel::Result Kernel::loadBootProgram(const BootImageStorage &bootImage,
             return ProcessError;
         }
 
+        // Decompress straight into the physical memory of the program
+        if (segment.flags & BootSegmentCompressed)
+        {
+            const Result lz4Result = decompressBootSegment(segment, range.phys);
+            if (lz4Result != Success)
+            {
+                FATAL("failed to decompress BootSegment at " << (void *) segment.virtualAddress <<
+                      " for BootProgram " << program.name);
+                return lz4Result;
+            }
+            continue;
+        }
+
         // Read from BootImage to physical memory of the program
         // This assumes direct access to that physical memory.
         const FileSystem::Result readResult = bootImage.read(
             segment.offset,
             (void *) m_alloc->toVirtual(range.phys),
-            segment.size
+            segment.dataSize
         );
 
         if (readResult != FileSystem::Success)
@@ -386,6 +549,7 @@ Kernel::Result Kernel::loadBootProgram(const BootImageStorage &bootImage,
 
     // Done
     NOTICE("loaded: " << program.name);
+    BootTimeline::record(BootProgramLoaded, 0, proc->getID(), program.name);
     return Success;
 }
 
@@ -393,6 +557,12 @@ int Kernel::run()
 {
     NOTICE("");
 
+    // Publish the timer state to processes
+    if (m_timer)
+    {
+        m_timer->setClockPage(m_clockPage);
+    }
+
     // Load boot image programs
     loadBootImage();
 
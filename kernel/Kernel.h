@@ -26,6 +26,7 @@
 #include <BootImage.h>
 #include <Memory.h>
 #include <CoreInfo.h>
+#include <ClockPage.h>
 
 /** Forward declarations. */
 class API;
@@ -33,9 +34,12 @@ class BootImageStorage;
 class MemoryContext;
 class Process;
 class ProcessManager;
+class Profiler;
 class SplitAllocator;
 class IntController;
+class PerformanceCounter;
 class Timer;
+class Trace;
 struct CPUState;
 
 /**
@@ -86,6 +90,26 @@ typedef struct InterruptHook
 }
 InterruptHook;
 
+/**
+ * Measure the spans of kernel execution with interrupts disabled.
+ *
+ * Expands to nothing unless the kernel is built with IRQOFF enabled.
+ *
+ * @param site Code address which identifies the kernel work in the span
+ */
+#ifdef __IRQOFF__
+#define IRQOFF_BEGIN(site) \
+    Kernel::instance()->beginInterruptsOff((Address) (site))
+#define IRQOFF_SITE(site) \
+    Kernel::instance()->setInterruptsOffSite((Address) (site))
+#define IRQOFF_END() \
+    Kernel::instance()->endInterruptsOff()
+#else
+#define IRQOFF_BEGIN(site)
+#define IRQOFF_SITE(site)
+#define IRQOFF_END()
+#endif /* __IRQOFF__ */
+
 /**
  * FreeNOS kernel implementation.
  */
@@ -104,6 +128,9 @@ class Kernel : public WeakSingleton<Kernel>
         IOError
     };
 
+    /** Bytes to process between two preemption points in long kernel operations */
+    static const Size PreemptionChunkSize = KiloByte(64);
+
     /**
      * Constructor function.
      *
@@ -137,6 +164,13 @@ class Kernel : public WeakSingleton<Kernel>
      */
     ProcessManager * getProcessManager();
 
+    /**
+     * Get sampling profiler.
+     *
+     * @return Kernel Profiler object pointer.
+     */
+    Profiler * getProfiler();
+
     /**
      * Get API.
      *
@@ -165,6 +199,65 @@ class Kernel : public WeakSingleton<Kernel>
      */
     Timer * getTimer();
 
+    /**
+     * Get hardware performance counters.
+     *
+     * @return PerformanceCounter object pointer or ZERO if not available
+     */
+    PerformanceCounter * getPerformanceCounter();
+
+    /**
+     * Get event trace ring buffer.
+     *
+     * @return Trace object pointer or ZERO if tracing is not enabled
+     */
+    Trace * getTrace();
+
+    /**
+     * Get the physical address of the ClockPage.
+     *
+     * @return Physical address of the ClockPage for this core
+     */
+    Address getClockPageAddress() const;
+
+    /**
+     * Get the longest span with interrupts disabled.
+     *
+     * @param site Receives the code address of the kernel work in the span
+     *
+     * @return Span in timestamp counter cycles or zero if not measured
+     */
+    u64 getInterruptsOffMax(Address *site) const;
+
+    /**
+     * Start a span with interrupts disabled.
+     *
+     * @param site Code address of the kernel work in the span
+     */
+    void beginInterruptsOff(const Address site);
+
+    /**
+     * Change the kernel work of the current span with interrupts disabled.
+     *
+     * @param site Code address of the kernel work in the span
+     */
+    void setInterruptsOffSite(const Address site);
+
+    /**
+     * End the current span with interrupts disabled.
+     */
+    void endInterruptsOff();
+
+    /**
+     * Briefly allow pending interrupts in a long kernel operation.
+     *
+     * The caller must leave the kernel state consistent, because interrupt
+     * handlers run before it continues. Process switches requested by those
+     * handlers are deferred until the kernel returns to the current process.
+     * The default implementation does nothing.
+     */
+    virtual void preemptionPoint();
+
     /**
      * Execute the kernel.
      */
@@ -178,6 +271,15 @@ class Kernel : public WeakSingleton<Kernel>
      */
     virtual void enableIRQ(u32 irq, bool enabled);
 
+    /**
+     * Route a hardware interrupt (IRQ) to this core.
+     *
+     * @param irq IRQ number.
+     *
+     * @return Result code
+     */
+    virtual Result routeIRQ(const u32 irq);
+
     /**
      * Send a inter-processor-interrupt (IPI) to another core.
      *
@@ -221,6 +323,17 @@ class Kernel : public WeakSingleton<Kernel>
     virtual Result loadBootProgram(const BootImageStorage &bootImage,
                                    const BootSymbol &program);
 
+    /**
+     * Decompress a boot program segment.
+     *
+     * @param segment Compressed BootSegment
+     * @param phys Physical address of the program memory to decompress to
+     *
+     * @return Result code
+     */
+    Result decompressBootSegment(const BootSegment &segment,
+                                 const Address phys) const;
+
   protected:
 
     /** Physical memory allocator */
@@ -229,6 +342,9 @@ class Kernel : public WeakSingleton<Kernel>
     /** Process Manager */
     ProcessManager *m_procs;
 
+    /** Sampling profiler */
+    Profiler *m_profiler;
+
     /** API handlers object */
     API *m_api;
 
@@ -243,6 +359,30 @@ class Kernel : public WeakSingleton<Kernel>
 
     /** Timer device. */
     Timer *m_timer;
+
+    /** Hardware performance counters. */
+    PerformanceCounter *m_perf;
+
+    /** Event trace ring buffer. */
+    Trace *m_trace;
+
+    /** Timer state published to processes. */
+    ClockPage *m_clockPage;
+
+    /** Physical address of the ClockPage. */
+    Address m_clockPageAddress;
+
+    /** Timestamp at the start of the current span with interrupts disabled, or zero. */
+    u64 m_irqOffStart;
+
+    /** Kernel work of the current span with interrupts disabled. */
+    Address m_irqOffSite;
+
+    /** Longest span with interrupts disabled in timestamp counter cycles. */
+    u64 m_irqOffMax;
+
+    /** Kernel work of the longest span with interrupts disabled. */
+    Address m_irqOffMaxSite;
 };
 
 /**
@@ -27,15 +27,34 @@ Process::Process(ProcessID id, Address entry, bool privileged, const MemoryMap &
     : m_id(id), m_map(map), m_shares(id)
 {
     m_state         = Stopped;
+    m_priority      = PriorityDefault;
+    m_basePriority  = PriorityDefault;
+    m_schedPrev     = ZERO;
+    m_schedNext     = ZERO;
     m_parent        = 0;
     m_waitId        = 0;
     m_waitResult    = 0;
+    m_waitHead      = ZERO;
+    m_waitPrev      = ZERO;
+    m_waitNext      = ZERO;
+    m_futexWaiting  = false;
+    m_futexAddress  = 0;
+    m_futexPrev     = ZERO;
+    m_futexNext     = ZERO;
+    m_leader        = ZERO;
+    m_userStack     = 0;
+    m_userArgument  = 0;
     m_wakeups       = 0;
+    m_cycles        = 0;
+    m_voluntarySwitches   = 0;
+    m_involuntarySwitches = 0;
     m_entry         = entry;
     m_privileged    = privileged;
     m_memoryContext = ZERO;
     m_kernelChannel = ZERO;
     MemoryBlock::set(&m_sleepTimer, 0, sizeof(m_sleepTimer));
+    m_sleepSlack    = 0;
+    MemoryBlock::set(m_counters, 0, sizeof(m_counters));
 }
 
 Process::~Process()
@@ -45,7 +64,8 @@ Process::~Process()
         delete m_kernelChannel;
     }
 
-    if (m_memoryContext)
+    // Threads leave the memory context to their leader
+    if (m_memoryContext && !m_leader)
     {
         m_memoryContext->releaseSection(m_map.range(MemoryMap::UserData));
         m_memoryContext->releaseSection(m_map.range(MemoryMap::UserHeap));
@@ -53,6 +73,7 @@ Process::~Process()
         m_memoryContext->releaseSection(m_map.range(MemoryMap::UserPrivate));
         m_memoryContext->releaseSection(m_map.range(MemoryMap::UserArgs));
         m_memoryContext->releaseSection(m_map.range(MemoryMap::UserShare), true);
+        m_memoryContext->releaseSection(m_map.range(MemoryMap::UserClock), true);
         delete m_memoryContext;
     }
 }
@@ -67,6 +88,11 @@ ProcessID Process::getParent() const
     return m_parent;
 }
 
+Process * Process::getLeader() const
+{
+    return m_leader;
+}
+
 ProcessID Process::getWait() const
 {
     return m_waitId;
@@ -82,6 +108,36 @@ Process::State Process::getState() const
     return m_state;
 }
 
+Process::Priority Process::getPriority() const
+{
+    return m_priority;
+}
+
+Process::Priority Process::getBasePriority() const
+{
+    return m_basePriority;
+}
+
+u64 Process::getCycles() const
+{
+    return m_cycles;
+}
+
+Size Process::getVoluntarySwitches() const
+{
+    return m_voluntarySwitches;
+}
+
+Size Process::getInvoluntarySwitches() const
+{
+    return m_involuntarySwitches;
+}
+
+u64 Process::getCounter(const Size index) const
+{
+    return index < PerformanceCounter::MaximumCounters ? m_counters[index] : 0;
+}
+
 ProcessShares & Process::getShares()
 {
     return m_shares;
@@ -92,6 +148,11 @@ const Timer::Info & Process::getSleepTimer() const
     return m_sleepTimer;
 }
 
+u32 Process::getSleepDeadline() const
+{
+    return m_sleepTimer.ticks + m_sleepSlack;
+}
+
 MemoryContext * Process::getMemoryContext()
 {
     return m_memoryContext;
@@ -107,6 +168,12 @@ void Process::setParent(ProcessID id)
     m_parent = id;
 }
 
+void Process::setPriority(const Priority priority)
+{
+    m_priority = priority;
+    m_basePriority = priority;
+}
+
 Process::Result Process::wait(ProcessID id)
 {
     if (m_state != Ready)
@@ -188,14 +255,13 @@ Process::Result Process::initialize()
     allocPhys.size = PAGESIZE * 2;
     allocPhys.alignment = PAGESIZE;
 
-    if (Kernel::instance()->getAllocator()->allocate(allocPhys, allocVirt) != Allocator::Success)
+    if (Kernel::instance()->getAllocator()->allocateZeroed(allocPhys, allocVirt) != Allocator::Success)
     {
         ERROR("failed to allocate kernel event channel pages");
         return OutOfMemory;
     }
 
-    // Initialize pages with zeroes
-    MemoryBlock::set((void *)allocVirt.address, 0, PAGESIZE*2);
+    // Write the zeroed pages back to memory
     cache.cleanData(allocVirt.address);
     cache.cleanData(allocVirt.address + PAGESIZE);
 
@@ -218,6 +284,20 @@ Process::Result Process::initialize()
     // Setup the kernel event channel
     m_kernelChannel->setVirtual(allocVirt.address, allocVirt.address + PAGESIZE);
 
+    // Map the ClockPage of this core read-only. Threads share it with their leader.
+    if (!m_leader)
+    {
+        range = m_map.range(MemoryMap::UserClock);
+        range.phys   = Kernel::instance()->getClockPageAddress();
+        range.access = Memory::User | Memory::Readable;
+
+        if (m_memoryContext->mapRangeContiguous(&range) != MemoryContext::Success)
+        {
+            ERROR("failed to map ClockPage");
+            return MemoryMapError;
+        }
+    }
+
     return Success;
 }
 
@@ -233,6 +313,7 @@ Process::Result Process::wakeup()
     {
         m_state = Ready;
         MemoryBlock::set(&m_sleepTimer, 0, sizeof(m_sleepTimer));
+        m_sleepSlack = 0;
         return Success;
     }
     else
@@ -241,7 +322,7 @@ Process::Result Process::wakeup()
     }
 }
 
-Process::Result Process::sleep(const Timer::Info *timer, bool ignoreWakeups)
+Process::Result Process::sleep(const Timer::Info *timer, bool ignoreWakeups, const u32 slack)
 {
     if (m_state != Ready)
     {
@@ -254,7 +335,10 @@ Process::Result Process::sleep(const Timer::Info *timer, bool ignoreWakeups)
         m_state = Sleeping;
 
         if (timer)
+        {
             MemoryBlock::copy(&m_sleepTimer, timer, sizeof(m_sleepTimer));
+            m_sleepSlack = slack;
+        }
 
         return Success;
     }
@@ -23,6 +23,7 @@
 #include <List.h>
 #include <MemoryMap.h>
 #include <Timer.h>
+#include <PerformanceCounter.h>
 #include "ProcessShares.h"
 
 /** @see IPCMessage.h. */
@@ -71,6 +72,20 @@ class Process
         Stopped
     };
 
+    /**
+     * Scheduling priority of the Process.
+     *
+     * Ready processes with a higher priority are always selected
+     * before processes with a lower priority. Processes with equal
+     * priority are selected in round-robin order.
+     */
+    enum Priority
+    {
+        PriorityMin     = 0,
+        PriorityDefault = 4,
+        PriorityMax     = 7
+    };
+
   public:
 
     /**
@@ -102,6 +117,13 @@ class Process
      */
     ProcessID getParent() const;
 
+    /**
+     * Retrieve the Process which owns our memory context.
+     *
+     * @return Process pointer if this Process is a thread, or ZERO otherwise.
+     */
+    Process * getLeader() const;
+
     /**
      * Get Wait ID.
      */
@@ -126,6 +148,52 @@ class Process
      */
     State getState() const;
 
+    /**
+     * Retrieve the scheduling priority.
+     *
+     * @return Current Priority of the Process.
+     */
+    Priority getPriority() const;
+
+    /**
+     * Retrieve the assigned scheduling priority.
+     *
+     * This is the priority without any priority inherited from clients.
+     *
+     * @return Assigned Priority of the Process.
+     */
+    Priority getBasePriority() const;
+
+    /**
+     * Get number of CPU cycles consumed.
+     *
+     * @return Cycles spent executing this Process, up to its last switch out.
+     */
+    u64 getCycles() const;
+
+    /**
+     * Get number of voluntary context switches.
+     *
+     * @return Times the Process gave up the CPU by sleeping, waiting or handoff.
+     */
+    Size getVoluntarySwitches() const;
+
+    /**
+     * Get number of involuntary context switches.
+     *
+     * @return Times the Process was preempted while still ready to run.
+     */
+    Size getInvoluntarySwitches() const;
+
+    /**
+     * Get a hardware performance counter value.
+     *
+     * @param index Counter number
+     *
+     * @return Events counted while executing this Process, up to the last update.
+     */
+    u64 getCounter(const Size index) const;
+
     /**
      * Get MMU memory context.
      *
@@ -187,10 +255,11 @@ class Process
      *
      * @param timer Timer on which the process must be woken up (if expired), or ZERO for no limit
      * @param ignoreWakeups True to enter Sleep state regardless of pending wakeups
+     * @param slack Number of ticks the wakeup may be delayed after the timer expires
      *
      * @return Result code
      */
-    Result sleep(const Timer::Info *timer, bool ignoreWakeups);
+    Result sleep(const Timer::Info *timer, bool ignoreWakeups, const u32 slack = 0);
 
     /**
      * Let Process wait for other Process to terminate.
@@ -236,11 +305,29 @@ class Process
      */
     const Timer::Info & getSleepTimer() const;
 
+    /**
+     * Get the latest tick at which the process must be woken up.
+     *
+     * @return Sleep timer ticks plus the allowed slack.
+     */
+    u32 getSleepDeadline() const;
+
     /**
      * Set parent process ID.
      */
     void setParent(ProcessID id);
 
+    /**
+     * Set scheduling priority.
+     *
+     * Sets both the assigned and the current priority.
+     *
+     * @param priority New Priority value
+     *
+     * @note The Process must not be on the Scheduler run queue
+     */
+    void setPriority(const Priority priority);
+
   protected:
 
     /** Process Identifier */
@@ -252,9 +339,57 @@ class Process
     /** Current process status. */
     State m_state;
 
+    /** Current scheduling priority, which may be inherited */
+    Priority m_priority;
+
+    /** Assigned scheduling priority */
+    Priority m_basePriority;
+
+    /** Previous Process in the Scheduler run queue */
+    Process *m_schedPrev;
+
+    /** Next Process in the Scheduler run queue */
+    Process *m_schedNext;
+
     /** Waits for exit of this Process. */
     ProcessID m_waitId;
 
+    /** First Process waiting for exit of this Process */
+    Process *m_waitHead;
+
+    /** Previous Process waiting for the same Process */
+    Process *m_waitPrev;
+
+    /** Next Process waiting for the same Process */
+    Process *m_waitNext;
+
+    /** True if waiting on a futex */
+    bool m_futexWaiting;
+
+    /** Physical address of the futex this Process waits on */
+    Address m_futexAddress;
+
+    /** Previous Process waiting on a futex */
+    Process *m_futexPrev;
+
+    /** Next Process waiting on a futex */
+    Process *m_futexNext;
+
+    /** Process which owns the memory context, if this Process is a thread */
+    Process *m_leader;
+
+    /** Threads which share the memory context of this Process */
+    List<Process *> m_threads;
+
+    /** Initial user stack pointer of a thread, or zero for the default stack */
+    Address m_userStack;
+
+    /** Argument passed to the entry point of a thread */
+    Address m_userArgument;
+
+    /** Interrupt vectors for which this Process receives notifications */
+    List<u32> m_interruptVectors;
+
     /** Wait exit result of the other Process. */
     uint m_waitResult;
 
@@ -273,6 +408,18 @@ class Process
     /** Number of wakeups received */
     Size m_wakeups;
 
+    /** CPU cycles consumed */
+    u64 m_cycles;
+
+    /** Number of voluntary context switches */
+    Size m_voluntarySwitches;
+
+    /** Number of involuntary context switches */
+    Size m_involuntarySwitches;
+
+    /** Hardware performance counter values */
+    u64 m_counters[PerformanceCounter::MaximumCounters];
+
     /**
      * Sleep timer value.
      * If non-zero, set the process in the Ready state
@@ -280,6 +427,9 @@ class Process
      */
     Timer::Info m_sleepTimer;
 
+    /** Number of ticks the wakeup may be delayed after the sleep timer expires. */
+    u32 m_sleepSlack;
+
     /** Contains virtual memory shares between this process and others. */
     ProcessShares m_shares;
 
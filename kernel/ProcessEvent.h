@@ -42,6 +42,9 @@ typedef struct ProcessEvent
     ProcessEventType type;
     Size number;
     ProcessShares::MemoryShare share;
+
+    /** Value of timestamp() at interrupt entry, for InterruptEvent. */
+    u64 timestamp;
 }
 ProcessEvent;
 
@@ -18,12 +18,21 @@
 #include <FreeNOS/System.h>
 #include <Log.h>
 #include <ListIterator.h>
+#include <MemoryBlock.h>
 #include "Scheduler.h"
 #include "ProcessEvent.h"
 #include "ProcessManager.h"
+#include "Trace.h"
 
 ProcessManager::ProcessManager()
     : m_procs()
+    , m_idleInterrupt(0)
+    , m_sleepTimerCount(0)
+    , m_futexHead(ZERO)
+    , m_futexTail(ZERO)
+    , m_switchTimestamp(0)
+    , m_switchDeferred(false)
+    , m_switchPending(false)
     , m_interruptNotifyList(256)
 {
     DEBUG("m_procs = " << MAX_PROCS);
@@ -32,6 +41,10 @@ ProcessManager::ProcessManager()
     m_current   = ZERO;
     m_idle      = ZERO;
     m_interruptNotifyList.fill(ZERO);
+    MemoryBlock::set(m_sleepTimers, 0, sizeof(m_sleepTimers));
+    MemoryBlock::set(m_sleepTimerIndex, 0, sizeof(m_sleepTimerIndex));
+    MemoryBlock::set(m_counterSnapshot, 0, sizeof(m_counterSnapshot));
+    MemoryBlock::set(&m_idleStats, 0, sizeof(m_idleStats));
 }
 
 ProcessManager::~ProcessManager()
@@ -92,6 +105,51 @@ Process * ProcessManager::create(const Address entry,
     return proc;
 }
 
+Process * ProcessManager::createThread(const Address entry,
+                                       const Address stack,
+                                       const Address argument)
+{
+    Process *leader = m_current->m_leader ? m_current->m_leader : m_current;
+    Size pid = 0;
+
+    // Insert a dummy to determine the next available PID
+    if (!m_procs.insert(pid, (Process *) ~ZERO))
+    {
+        return ZERO;
+    }
+
+    // Create the new thread with the same memory layout as the leader
+    Process *proc = new Arch::Process(pid, entry, leader->m_privileged, leader->m_map);
+    if (!proc)
+    {
+        ERROR("failed to allocate Process");
+        m_procs.remove(pid);
+        return ZERO;
+    }
+    proc->m_leader = leader;
+    proc->m_userStack = stack;
+    proc->m_userArgument = argument;
+
+    // Initialize the thread
+    const Process::Result result = proc->initialize();
+    if (result != Process::Success)
+    {
+        ERROR("failed to initialize thread: result = " << (int) result);
+        m_procs.remove(pid);
+        delete proc;
+        return ZERO;
+    }
+
+    // Overwrite dummy with actual Process
+    m_procs.insertAt(pid, proc);
+    leader->m_threads.append(proc);
+    proc->setParent(m_current->getID());
+    proc->setPriority(m_current->getBasePriority());
+    resume(proc);
+
+    return proc;
+}
+
 Process * ProcessManager::get(const ProcessID id)
 {
     return m_procs.get(id);
@@ -105,28 +163,45 @@ void ProcessManager::remove(Process *proc, const uint exitStatus)
     if (proc == m_current)
         m_current = ZERO;
 
+    // Threads cannot outlive the memory context of their leader
+    while (proc->m_threads.count() > 0)
+    {
+        remove(proc->m_threads.first(), exitStatus);
+        Kernel::instance()->preemptionPoint();
+    }
+
+    if (proc->m_leader)
+    {
+        proc->m_leader->m_threads.remove(proc);
+    }
+
+    // Stop waiting if this Process is waiting for another Process
+    if (proc->getState() == Process::Waiting)
+    {
+        removeWaiter(proc);
+    }
+
     // Notify processes which are waiting for this Process
-    const Size size = m_procs.size();
-    for (Size i = 0; i < size; i++)
+    while (proc->m_waitHead != ZERO)
     {
-        if (m_procs[i] != ZERO &&
-            m_procs[i]->getState() == Process::Waiting &&
-            m_procs[i]->getWait() == proc->getID())
+        Process *waiter = proc->m_waitHead;
+        removeWaiter(waiter);
+
+        const Process::Result result = waiter->join(exitStatus);
+        if (result != Process::Success)
         {
-            const Process::Result result = m_procs[i]->join(exitStatus);
-            if (result != Process::Success)
-            {
-                FATAL("failed to join() PID " << m_procs[i]->getID() <<
-                      ": result = " << (int) result);
-            }
+            FATAL("failed to join() PID " << waiter->getID() <<
+                  ": result = " << (int) result);
+        }
 
-            const Result r = enqueueProcess(m_procs[i]);
-            if (r != Success)
-            {
-                FATAL("failed to enqueue() PID " << m_procs[i]->getID() <<
-                      ": result = " << (int) r);
-            }
+        const Result r = enqueueProcess(waiter);
+        if (r != Success)
+        {
+            FATAL("failed to enqueue() PID " << waiter->getID() <<
+                  ": result = " << (int) r);
         }
+
+        Kernel::instance()->preemptionPoint();
     }
 
     // Unregister any interrupt events for this process
@@ -144,9 +219,8 @@ void ProcessManager::remove(Process *proc, const uint exitStatus)
         }
     }
 
-    const Size countRemoved = m_sleepTimerQueue.remove(proc);
-    assert(countRemoved <= 1U);
-    (void) countRemoved;
+    removeSleepTimer(proc);
+    removeFutexWaiter(proc);
 
     // Free the process memory
     delete proc;
@@ -154,8 +228,7 @@ void ProcessManager::remove(Process *proc, const uint exitStatus)
 
 ProcessManager::Result ProcessManager::schedule()
 {
-    const Timer *timer = Kernel::instance()->getTimer();
-    const Size sleepTimerCount = m_sleepTimerQueue.count();
+    Timer *timer = Kernel::instance()->getTimer();
 
     // Let the scheduler select a new process
     Process *proc = m_scheduler->select();
@@ -169,43 +242,97 @@ ProcessManager::Result ProcessManager::schedule()
         FATAL("no process found to run!");
     }
 
-    // Try to wakeup processes that are waiting for a timer to expire
-    for (Size i = 0; i < sleepTimerCount; i++)
+    // Wakeup processes of which the deadline passed. The heap keeps the earliest
+    // deadline on top, so only due timers are visited. Once a wakeup is due, the
+    // timers next on top which already expired are woken up as well, such that
+    // their wakeups coalesce into this one.
+    bool due = false;
+
+    while (m_sleepTimerCount > 0)
     {
-        Process *p = m_sleepTimerQueue.pop();
-        const Timer::Info & procTimer = p->getSleepTimer();
+        Process *p = m_sleepTimers[0];
+        Timer::Info deadline = p->getSleepTimer();
+        deadline.ticks = p->getSleepDeadline();
+
+        if (!timer->isExpired(deadline) && !(due && timer->isExpired(p->getSleepTimer())))
+            break;
+
+        removeSleepTimer(p);
 
-        if (timer->isExpired(procTimer))
+        const Result result = wakeup(p);
+        if (result != Success)
         {
-            const Result result = wakeup(p);
-            if (result != Success)
-            {
-                FATAL("failed to wakeup PID " << p->getID());
-            }
+            FATAL("failed to wakeup PID " << p->getID());
         }
-        else
+        due = true;
+    }
+
+    // Stop the periodic tick while idle, until the first sleep timer expires
+    if (proc == m_idle && m_scheduler->count() == 0)
+    {
+        Timer::Info info;
+        Size ticks = timer->getFrequency();
+
+        timer->getCurrent(&info);
+
+        if (m_sleepTimerCount > 0)
         {
-            m_sleepTimerQueue.push(p);
+            const u32 expiry = m_sleepTimers[0]->getSleepDeadline();
+            const u32 remaining = expiry > info.ticks ? expiry - info.ticks : 1;
+
+            if (remaining < ticks)
+                ticks = remaining;
         }
+
+        timer->setNextInterrupt(ticks);
+    }
+
+    // Interrupted at a preemption point: switch when the kernel returns
+    if (m_switchDeferred)
+    {
+        m_switchPending = true;
+        return Success;
     }
+    m_switchPending = false;
 
     // Only execute if its a different process
     if (proc != m_current)
     {
-        Process *previous = m_current;
-        m_current = proc;
-        proc->execute(previous);
+        switchProcess(proc, m_current != ZERO && m_current->getState() != Process::Ready);
     }
 
     return Success;
 }
 
+void ProcessManager::deferSwitch(const bool defer)
+{
+    m_switchDeferred = defer;
+}
+
+bool ProcessManager::isSwitchDeferred() const
+{
+    return m_switchDeferred;
+}
+
+ProcessManager::Result ProcessManager::schedulePending()
+{
+    if (!m_switchPending || m_switchDeferred)
+        return Success;
+
+    return schedule();
+}
+
 Process * ProcessManager::current()
 {
     return m_current;
 }
 
-void ProcessManager::setIdle(Process *proc)
+Size ProcessManager::readyCount() const
+{
+    return m_scheduler->count();
+}
+
+void ProcessManager::setIdle(Process *proc, const IdleState state)
 {
     const Result result = dequeueProcess(proc, true);
     if (result != Success)
@@ -214,6 +341,12 @@ void ProcessManager::setIdle(Process *proc)
     }
 
     m_idle = proc;
+    m_idleStats.state = state;
+}
+
+const IdleStatistics & ProcessManager::getIdleStatistics() const
+{
+    return m_idleStats;
 }
 
 ProcessManager::Result ProcessManager::wait(Process *proc)
@@ -224,6 +357,16 @@ ProcessManager::Result ProcessManager::wait(Process *proc)
         return IOError;
     }
 
+    // Add to the list of waiters of the other Process
+    m_current->m_waitPrev = ZERO;
+    m_current->m_waitNext = proc->m_waitHead;
+
+    if (proc->m_waitHead != ZERO)
+    {
+        proc->m_waitHead->m_waitPrev = m_current;
+    }
+    proc->m_waitHead = m_current;
+
     return dequeueProcess(m_current);
 }
 
@@ -271,9 +414,52 @@ ProcessManager::Result ProcessManager::reset(Process *proc, const Address entry)
     return Success;
 }
 
-ProcessManager::Result ProcessManager::sleep(const Timer::Info *timer, const bool ignoreWakeups)
+ProcessManager::Result ProcessManager::setPriority(Process *proc, const Process::Priority priority)
+{
+    if (priority > Process::PriorityMax)
+    {
+        ERROR("invalid priority " << (int) priority << " for PID " << proc->getID());
+        return InvalidArgument;
+    }
+
+    // Any inherited priority is dropped
+    proc->m_basePriority = priority;
+    return changePriority(proc, priority);
+}
+
+ProcessManager::Result ProcessManager::inheritPriority(Process *proc, const Process::Priority priority)
 {
-    const Process::Result result = m_current->sleep(timer, ignoreWakeups);
+    if (priority <= proc->m_priority)
+    {
+        return Success;
+    }
+
+    TRACE(TraceInherit, proc->getID(), priority);
+    return changePriority(proc, priority);
+}
+
+ProcessManager::Result ProcessManager::changePriority(Process *proc, const Process::Priority priority)
+{
+    // Move the Process to its new priority level, if currently scheduled
+    if (m_scheduler->contains(proc))
+    {
+        Result result = dequeueProcess(proc, true);
+        if (result != Success)
+        {
+            return result;
+        }
+
+        proc->m_priority = priority;
+        return enqueueProcess(proc, true);
+    }
+
+    proc->m_priority = priority;
+    return Success;
+}
+
+ProcessManager::Result ProcessManager::sleep(const Timer::Info *timer, const bool ignoreWakeups, const u32 slack)
+{
+    const Process::Result result = m_current->sleep(timer, ignoreWakeups, slack);
     switch (result)
     {
         case Process::WakeupPending:
@@ -288,9 +474,11 @@ ProcessManager::Result ProcessManager::sleep(const Timer::Info *timer, const boo
 
             if (timer)
             {
-                assert(!m_sleepTimerQueue.contains(m_current));
-                m_sleepTimerQueue.push(m_current);
+                insertSleepTimer(m_current);
             }
+
+            // Drop inherited priority, as the Process has no pending work
+            m_current->m_priority = m_current->m_basePriority;
             break;
         }
 
@@ -307,6 +495,8 @@ ProcessManager::Result ProcessManager::wakeup(Process *proc)
 {
     const Process::Result result = proc->wakeup();
 
+    TRACE(TraceWakeup, proc->getID(), 0);
+
     switch (result)
     {
         case Process::WakeupPending:
@@ -322,10 +512,80 @@ ProcessManager::Result ProcessManager::wakeup(Process *proc)
     }
 }
 
+ProcessManager::Result ProcessManager::handoff(Process *proc)
+{
+    const Result result = wakeup(proc);
+    if (result != Success)
+    {
+        return result;
+    }
+
+    // Switch directly only if the target can run now
+    if (proc != m_current && proc->getState() == Process::Ready)
+    {
+        switchProcess(proc, true);
+    }
+
+    return Success;
+}
+
+ProcessManager::Result ProcessManager::futexWait(const Address address)
+{
+    const Result result = sleep(ZERO, true);
+    if (result != Success)
+    {
+        return result;
+    }
+
+    // Append to the waiters list, such that wakeups are in FIFO order
+    m_current->m_futexWaiting = true;
+    m_current->m_futexAddress = address;
+    m_current->m_futexPrev = m_futexTail;
+    m_current->m_futexNext = ZERO;
+
+    if (m_futexTail != ZERO)
+        m_futexTail->m_futexNext = m_current;
+    else
+        m_futexHead = m_current;
+
+    m_futexTail = m_current;
+    return Success;
+}
+
+Size ProcessManager::futexWake(const Address address, const Size count)
+{
+    Process *proc = m_futexHead;
+    Size woken = 0;
+
+    while (proc != ZERO && woken < count)
+    {
+        Process *next = proc->m_futexNext;
+
+        if (proc->m_futexAddress == address)
+        {
+            // Removes the Process from the waiters list via enqueueProcess().
+            // A futex wakeup must not be left pending for the next sleep.
+            const Size wakeups = proc->m_wakeups;
+            const Result result = wakeup(proc);
+            if (result != Success)
+            {
+                FATAL("failed to wakeup PID " << proc->getID());
+            }
+            proc->m_wakeups = wakeups;
+            woken++;
+        }
+        proc = next;
+    }
+
+    return woken;
+}
+
 ProcessManager::Result ProcessManager::raiseEvent(Process *proc, const struct ProcessEvent *event)
 {
     const Process::Result result = proc->raiseEvent(event);
 
+    TRACE(TraceProcessEvent, proc->getID(), event->type);
+
     switch (result)
     {
         case Process::WakeupPending:
@@ -355,32 +615,41 @@ ProcessManager::Result ProcessManager::registerInterruptNotify(Process *proc, co
 
     // Append the Process
     m_interruptNotifyList[vec]->append(proc);
+    proc->m_interruptVectors.append(vec);
     return Success;
 }
 
 ProcessManager::Result ProcessManager::unregisterInterruptNotify(Process *proc)
 {
-    // Remove the Process from all notify lists
-    for (Size i = 0; i < m_interruptNotifyList.size(); i++)
+    // Remove the Process only from the notify lists it is registered on
+    for (ListIterator<u32> i(proc->m_interruptVectors); i.hasCurrent(); i++)
     {
-        List<Process *> *lst = m_interruptNotifyList[i];
+        List<Process *> *lst = m_interruptNotifyList[i.current()];
         if (lst)
         {
             lst->remove(proc);
         }
     }
 
+    proc->m_interruptVectors.clear();
     return Success;
 }
 
-ProcessManager::Result ProcessManager::interruptNotify(const u32 vector)
+ProcessManager::Result ProcessManager::interruptNotify(const u32 vector, const u64 entry)
 {
     List<Process *> *lst = m_interruptNotifyList[vector];
+    Process *driver = ZERO;
+
+    // The last interrupt before leaving the idle process is the one which woke the core
+    if (m_current != ZERO && m_current == m_idle)
+        m_idleInterrupt = entry;
+
     if (lst)
     {
         ProcessEvent event;
-        event.type   = InterruptEvent;
-        event.number = vector;
+        event.type      = InterruptEvent;
+        event.number    = vector;
+        event.timestamp = entry;
 
         for (ListIterator<Process *> i(lst); i.hasCurrent(); i++)
         {
@@ -390,9 +659,22 @@ ProcessManager::Result ProcessManager::interruptNotify(const u32 vector)
                       " on Process ID " << i.current()->getID());
                 return IOError;
             }
+
+            if (!driver && i.current() != m_current && i.current()->getState() == Process::Ready)
+                driver = i.current();
         }
     }
 
+    // Run the driver now instead of waiting for the next schedule
+    if (driver && (m_current == ZERO || m_current == m_idle ||
+                   driver->getPriority() >= m_current->getPriority()))
+    {
+        if (m_switchDeferred)
+            m_switchPending = true;
+        else
+            switchProcess(driver, false);
+    }
+
     return Success;
 }
 
@@ -404,9 +686,15 @@ ProcessManager::Result ProcessManager::enqueueProcess(Process *proc, const bool
         return IOError;
     }
 
-    const Size countRemoved = m_sleepTimerQueue.remove(proc);
-    assert(countRemoved <= 1U);
-    (void) countRemoved;
+    removeSleepTimer(proc);
+    removeFutexWaiter(proc);
+
+    // Resume periodic ticks, in case the timer was stopped while idle
+    Timer *timer = Kernel::instance()->getTimer();
+    if (timer)
+    {
+        timer->setNextInterrupt(1);
+    }
 
     return Success;
 }
@@ -421,3 +709,235 @@ ProcessManager::Result ProcessManager::dequeueProcess(Process *proc, const bool
 
     return Success;
 }
+
+void ProcessManager::removeWaiter(Process *proc)
+{
+    Process *target = m_procs.get(proc->getWait());
+
+    if (proc->m_waitPrev != ZERO)
+    {
+        proc->m_waitPrev->m_waitNext = proc->m_waitNext;
+    }
+    else if (target != ZERO && target->m_waitHead == proc)
+    {
+        target->m_waitHead = proc->m_waitNext;
+    }
+
+    if (proc->m_waitNext != ZERO)
+    {
+        proc->m_waitNext->m_waitPrev = proc->m_waitPrev;
+    }
+
+    proc->m_waitPrev = ZERO;
+    proc->m_waitNext = ZERO;
+}
+
+void ProcessManager::removeFutexWaiter(Process *proc)
+{
+    if (!proc->m_futexWaiting)
+    {
+        return;
+    }
+
+    if (proc->m_futexPrev != ZERO)
+        proc->m_futexPrev->m_futexNext = proc->m_futexNext;
+    else
+        m_futexHead = proc->m_futexNext;
+
+    if (proc->m_futexNext != ZERO)
+        proc->m_futexNext->m_futexPrev = proc->m_futexPrev;
+    else
+        m_futexTail = proc->m_futexPrev;
+
+    proc->m_futexWaiting = false;
+    proc->m_futexPrev = ZERO;
+    proc->m_futexNext = ZERO;
+}
+
+void ProcessManager::insertSleepTimer(Process *proc)
+{
+    assert(m_sleepTimerIndex[proc->getID()] == 0);
+    assert(m_sleepTimerCount < MAX_PROCS);
+
+    setSleepTimer(m_sleepTimerCount, proc);
+    siftSleepTimerUp(m_sleepTimerCount++);
+}
+
+void ProcessManager::removeSleepTimer(Process *proc)
+{
+    const Size position = m_sleepTimerIndex[proc->getID()];
+
+    if (position == 0)
+        return;
+
+    const Size index = position - 1;
+    assert(m_sleepTimers[index] == proc);
+
+    m_sleepTimerIndex[proc->getID()] = 0;
+    m_sleepTimerCount--;
+
+    // Fill the hole with the last entry and restore the heap order
+    if (index != m_sleepTimerCount)
+    {
+        setSleepTimer(index, m_sleepTimers[m_sleepTimerCount]);
+        siftSleepTimerUp(index);
+        siftSleepTimerDown(m_sleepTimerIndex[m_sleepTimers[index]->getID()] - 1);
+    }
+
+    m_sleepTimers[m_sleepTimerCount] = ZERO;
+}
+
+void ProcessManager::siftSleepTimerUp(Size index)
+{
+    Process *proc = m_sleepTimers[index];
+    const u32 ticks = proc->getSleepDeadline();
+
+    while (index > 0)
+    {
+        const Size parent = (index - 1) / 2;
+
+        if (m_sleepTimers[parent]->getSleepDeadline() <= ticks)
+            break;
+
+        setSleepTimer(index, m_sleepTimers[parent]);
+        index = parent;
+    }
+
+    setSleepTimer(index, proc);
+}
+
+void ProcessManager::siftSleepTimerDown(Size index)
+{
+    Process *proc = m_sleepTimers[index];
+    const u32 ticks = proc->getSleepDeadline();
+
+    while (true)
+    {
+        const Size left = (index * 2) + 1;
+        const Size right = left + 1;
+        Size child = left;
+
+        if (left >= m_sleepTimerCount)
+            break;
+
+        if (right < m_sleepTimerCount &&
+            m_sleepTimers[right]->getSleepDeadline() < m_sleepTimers[left]->getSleepDeadline())
+            child = right;
+
+        if (m_sleepTimers[child]->getSleepDeadline() >= ticks)
+            break;
+
+        setSleepTimer(index, m_sleepTimers[child]);
+        index = child;
+    }
+
+    setSleepTimer(index, proc);
+}
+
+void ProcessManager::setSleepTimer(const Size index, Process *proc)
+{
+    m_sleepTimers[index] = proc;
+    m_sleepTimerIndex[proc->getID()] = index + 1;
+}
+
+void ProcessManager::switchProcess(Process *proc, const bool voluntary)
+{
+    Process *previous = m_current;
+    const u64 now = timestamp();
+
+    if (previous != ZERO)
+    {
+        u64 elapsed = now - m_switchTimestamp;
+
+        // Narrow 32-bit cycle counters wrap around between switches
+        if (now < m_switchTimestamp)
+            elapsed = (u32) elapsed;
+
+        previous->m_cycles += elapsed;
+
+        if (voluntary)
+            previous->m_voluntarySwitches++;
+        else
+            previous->m_involuntarySwitches++;
+
+        if (previous == m_idle)
+            updateIdleStatistics(now, elapsed);
+    }
+
+    if (proc == m_idle)
+        m_idleInterrupt = 0;
+
+    // Ticks of the idle process do not count as busy time
+    Timer *timer = Kernel::instance()->getTimer();
+    if (timer && (proc == m_idle) != (previous == m_idle))
+        timer->setIdle(proc == m_idle);
+
+    updateCounters();
+    TRACE(TraceSwitch, proc->getID(), voluntary);
+
+    m_switchTimestamp = now;
+    m_current = proc;
+    proc->execute(previous);
+}
+
+void ProcessManager::updateIdleStatistics(const u64 now, const u64 elapsed)
+{
+    m_idleStats.cycles[m_idleStats.state] += elapsed;
+    m_idleStats.wakeups++;
+
+    if (m_idleInterrupt != 0)
+    {
+        u64 latency = now - m_idleInterrupt;
+
+        // Narrow 32-bit cycle counters wrap around between timestamps
+        if (now < m_idleInterrupt)
+            latency = (u32) latency;
+
+        m_idleStats.latency += latency;
+
+        if (latency > m_idleStats.latencyMax)
+            m_idleStats.latencyMax = latency;
+
+        m_idleInterrupt = 0;
+    }
+}
+
+void ProcessManager::updateCounters()
+{
+    const PerformanceCounter *perf = Kernel::instance()->getPerformanceCounter();
+
+    if (perf == ZERO)
+        return;
+
+    for (Size i = 0; i < perf->count(); i++)
+    {
+        if (perf->event(i) == PerformanceCounter::None)
+            continue;
+
+        const u64 value = perf->read(i);
+
+        if (m_current != ZERO)
+            m_current->m_counters[i] += (value - m_counterSnapshot[i]) & perf->mask();
+
+        m_counterSnapshot[i] = value;
+    }
+}
+
+void ProcessManager::resetCounters()
+{
+    const PerformanceCounter *perf = Kernel::instance()->getPerformanceCounter();
+
+    for (Size i = 0; i < MAX_PROCS; i++)
+    {
+        Process *proc = m_procs.get(i);
+        if (proc)
+        {
+            MemoryBlock::set(proc->m_counters, 0, sizeof(proc->m_counters));
+        }
+    }
+
+    for (Size i = 0; i < PerformanceCounter::MaximumCounters; i++)
+    {
+        m_counterSnapshot[i] = perf != ZERO ? perf->read(i) : 0;
+    }
+}
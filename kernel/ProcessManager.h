@@ -22,7 +22,8 @@
 #include <MemoryMap.h>
 #include <Vector.h>
 #include <List.h>
-#include <Queue.h>
+#include <Index.h>
+#include "API/IdleState.h"
 #include "Process.h"
 
 /* Forward declarations */
@@ -84,6 +85,24 @@ class ProcessManager
                      const bool readyToRun = false,
                      const bool privileged = false);
 
+    /**
+     * Create a new thread in the current Process.
+     *
+     * The thread is a schedulable Process which shares the memory
+     * context of its leader, which is the current Process or the
+     * leader of the current Process. When the leader is removed, all
+     * of its threads are removed as well.
+     *
+     * @param entry Thread entry point
+     * @param stack Initial user stack pointer
+     * @param argument Argument passed to the entry point
+     *
+     * @return Process pointer on success or ZERO on failure
+     */
+    Process * createThread(const Address entry,
+                           const Address stack,
+                           const Address argument);
+
     /**
      * Retrieve a Process by it's ID.
      *
@@ -105,6 +124,32 @@ class ProcessManager
      */
     Result schedule();
 
+    /**
+     * Defer process switches.
+     *
+     * While deferred, schedule() and interruptNotify() only record
+     * that a switch is pending. Used at kernel preemption points.
+     *
+     * @param defer True to defer process switches and false to allow them again
+     */
+    void deferSwitch(const bool defer);
+
+    /**
+     * Check if process switches are deferred.
+     *
+     * @return True if deferred
+     */
+    bool isSwitchDeferred() const;
+
+    /**
+     * Run a process switch which was deferred.
+     *
+     * Does nothing if no switch is pending or switches are still deferred.
+     *
+     * @return Result code
+     */
+    Result schedulePending();
+
     /**
      * Let current Process wait for another Process to terminate.
      *
@@ -140,15 +185,45 @@ class ProcessManager
      */
     Result reset(Process *proc, const Address entry);
 
+    /**
+     * Change the scheduling priority of a Process.
+     *
+     * @param proc Process pointer
+     * @param priority New scheduling priority
+     *
+     * @return Result code
+     */
+    Result setPriority(Process *proc, const Process::Priority priority);
+
+    /**
+     * Let a Process inherit the scheduling priority of a client.
+     *
+     * Raises the current priority of the Process if the given priority
+     * is higher. The Process returns to its assigned priority when it
+     * enters the Sleep state, which servers do once all pending requests
+     * are handled.
+     *
+     * @param proc Process pointer
+     * @param priority Priority of the client waiting for the Process
+     *
+     * @return Result code
+     */
+    Result inheritPriority(Process *proc, const Process::Priority priority);
+
     /**
      * Let current Process sleep until a timer expires or wakeup occurs.
      *
+     * Sleep timers with slack may be delayed up to the given number of ticks,
+     * such that the wakeups of processes which fall within the same window
+     * coalesce into one timer interrupt.
+     *
      * @param timer Timer on which the process must be woken up (if expired), or ZERO for no limit
      * @param ignoreWakeups True to enter Sleep state regardless of pending wakeups
+     * @param slack Number of ticks the wakeup may be delayed after the timer expires
      *
      * @return Result code
      */
-    Result sleep(const Timer::Info *timer = 0, const bool ignoreWakeups = false);
+    Result sleep(const Timer::Info *timer = 0, const bool ignoreWakeups = false, const u32 slack = 0);
 
     /**
      * Take Process out of Sleep state and mark ready for execution.
@@ -159,6 +234,43 @@ class ProcessManager
      */
     Result wakeup(Process *proc);
 
+    /**
+     * Wakeup a Process and switch to it directly.
+     *
+     * Donates the remainder of the timeslice of the current
+     * Process to the given Process, bypassing the Scheduler.
+     * The current Process stays ready for execution.
+     *
+     * @param proc Process pointer
+     *
+     * @return Result code
+     */
+    Result handoff(Process *proc);
+
+    /**
+     * Let the current Process sleep on a futex.
+     *
+     * The Process sleeps until futexWake() is called for the same
+     * physical address, or until it is woken up by other means.
+     *
+     * @param address Physical address of the futex
+     *
+     * @return Result code
+     */
+    Result futexWait(const Address address);
+
+    /**
+     * Wakeup processes sleeping on a futex.
+     *
+     * Processes are woken up in the order in which they started waiting.
+     *
+     * @param address Physical address of the futex
+     * @param count Maximum number of processes to wakeup
+     *
+     * @return Number of processes woken up
+     */
+    Size futexWake(const Address address, const Size count);
+
     /**
      * Raise kernel event for a Process
      *
@@ -191,16 +303,51 @@ class ProcessManager
     /**
      * Raise interrupt notifications for a interrupt vector
      *
+     * The first notified Process which became ready runs immediately,
+     * unless the current Process has a higher priority.
+     *
      * @param vector Interrupt vector
+     * @param entry Value of timestamp() when the interrupt was entered
      *
      * @return Result code
      */
-    Result interruptNotify(const u32 vector);
+    Result interruptNotify(const u32 vector, const u64 entry);
+
+    /**
+     * Charge hardware performance counter events to the current Process.
+     *
+     * Adds the events counted since the previous update to the current Process.
+     */
+    void updateCounters();
+
+    /**
+     * Reset the hardware performance counter values of all processes.
+     *
+     * Must be called after the performance counters are reprogrammed.
+     */
+    void resetCounters();
 
     /**
      * Set the idle process.
+     *
+     * @param proc Process to run when no other process is ready
+     * @param state Way in which the process waits for interrupts
      */
-    void setIdle(Process *proc);
+    void setIdle(Process *proc, const IdleState state);
+
+    /**
+     * Get the idle residency and wakeup latency of this core.
+     *
+     * @return Idle statistics
+     */
+    const IdleStatistics & getIdleStatistics() const;
+
+    /**
+     * Get number of processes ready to run.
+     *
+     * @return Number of processes on the Scheduler run queue
+     */
+    Size readyCount() const;
 
     /**
      * Current process running. NULL if no process running yet.
@@ -231,6 +378,87 @@ class ProcessManager
      */
     Result dequeueProcess(Process *proc, const bool ignoreState = false) const;
 
+    /**
+     * Change the current priority of a Process
+     *
+     * Moves the Process to the new priority level if it is on the Schedule queue.
+     *
+     * @param proc Process pointer
+     * @param priority New current priority
+     *
+     * @return Result code
+     */
+    Result changePriority(Process *proc, const Process::Priority priority);
+
+    /**
+     * Remove a process from the waiters list of the process it waits for
+     *
+     * @param proc Process pointer in the Waiting state
+     */
+    void removeWaiter(Process *proc);
+
+    /**
+     * Remove a process from the futex waiters list, if present
+     *
+     * @param proc Process pointer
+     */
+    void removeFutexWaiter(Process *proc);
+
+    /**
+     * Add a process to the sleep timer heap
+     *
+     * @param proc Process pointer with its sleep timer set
+     */
+    void insertSleepTimer(Process *proc);
+
+    /**
+     * Remove a process from the sleep timer heap, if present
+     *
+     * @param proc Process pointer
+     */
+    void removeSleepTimer(Process *proc);
+
+    /**
+     * Move a heap entry up until its parent expires earlier
+     *
+     * @param index Position in the sleep timer heap
+     */
+    void siftSleepTimerUp(Size index);
+
+    /**
+     * Move a heap entry down until its children expire later
+     *
+     * @param index Position in the sleep timer heap
+     */
+    void siftSleepTimerDown(Size index);
+
+    /**
+     * Store a process at the given position in the sleep timer heap
+     *
+     * @param index Position in the sleep timer heap
+     * @param proc Process pointer
+     */
+    void setSleepTimer(const Size index, Process *proc);
+
+    /**
+     * Switch execution to the given process
+     *
+     * Charges the cycles since the previous switch to the
+     * current Process and counts the type of context switch.
+     *
+     * @param proc Process pointer to execute
+     * @param voluntary True if the current Process gives up the CPU itself
+     */
+    void switchProcess(Process *proc, const bool voluntary);
+
+    /**
+     * Account a switch away from the idle process.
+     *
+     * @param now Timestamp of the switch
+     * @param elapsed Cycles spent in the idle process
+     */
+    void updateIdleStatistics(const u64 now, const u64 elapsed);
+
   private:
 
     /** All known Processes. */
@@ -245,8 +473,35 @@ class ProcessManager
     /** Idle process */
     Process *m_idle;
 
-    /** Queue with sleeping processes waiting for a Timer to expire. */
-    Queue<Process *, MAX_PROCS> m_sleepTimerQueue;
+    /** Time spent in the idle process */
+    IdleStatistics m_idleStats;
+
+    /** Entry timestamp of the last interrupt while the idle process ran, or zero */
+    u64 m_idleInterrupt;
+
+    /** Sleeping processes waiting for a Timer, as a min-heap on the deadline ticks. */
+    Process *m_sleepTimers[MAX_PROCS];
+
+    /** Number of processes in the sleep timer heap. */
+    Size m_sleepTimerCount;
+
+    /** Position plus one of each process ID in the sleep timer heap, or zero if not present. */
+    Size m_sleepTimerIndex[MAX_PROCS];
+
+    /** First and last Process waiting on a futex */
+    Process *m_futexHead, *m_futexTail;
+
+    /** Timestamp of the last context switch */
+    u64 m_switchTimestamp;
+
+    /** True while process switches are deferred */
+    bool m_switchDeferred;
+
+    /** True if a process switch was requested while deferred */
+    bool m_switchPending;
+
+    /** Hardware performance counter values at the last update */
+    u64 m_counterSnapshot[PerformanceCounter::MaximumCounters];
 
     /** Interrupt notification list */
     Vector<List<Process *> *> m_interruptNotifyList;
@@ -26,8 +26,20 @@
 
 ProcessShares::ProcessShares(ProcessID pid)
 {
-    m_pid    = pid;
-    m_memory = ZERO;
+    m_pid       = pid;
+    m_memory    = ZERO;
+    m_shares    = ZERO;
+    m_shareNext = ZERO;
+    m_peerNext  = ZERO;
+    m_capacity  = 0;
+    m_count     = 0;
+    m_free      = ChainEnd;
+
+    for (Size i = 0; i < ShareBuckets; i++)
+    {
+        m_shareHead[i] = ChainEnd;
+        m_peerHead[i]  = ChainEnd;
+    }
 }
 
 ProcessShares::~ProcessShares()
@@ -37,10 +49,9 @@ ProcessShares::~ProcessShares()
 
     // Make a list of unique process IDs which
     // have a share with this Process
-    Size size = m_shares.size();
-    for (Size i = 0; i < size; i++)
+    for (Size i = 0; i < m_capacity && m_count > 0; i++)
     {
-        MemoryShare *sh = m_shares.get(i);
+        MemoryShare *sh = m_shares[i];
         if (sh)
         {
             if (!pids.contains(sh->pid))
@@ -63,6 +74,10 @@ ProcessShares::~ProcessShares()
             procs->raiseEvent(proc, &event);
         }
     }
+
+    delete[] m_shares;
+    delete[] m_shareNext;
+    delete[] m_peerNext;
 }
 
 const ProcessID ProcessShares::getProcessID() const
@@ -134,8 +149,12 @@ ProcessShares::Result ProcessShares::createShare(ProcessID pid,
     }
 
     // insert into shares list
-    Size idx = 0;
-    m_shares.insert(idx, share);
+    if (insertShare(share) != Success)
+    {
+        ERROR("no free MemoryShare slots for PID " << pid);
+        delete share;
+        return OutOfMemory;
+    }
     return Success;
 }
 
@@ -148,11 +167,14 @@ ProcessShares::Result ProcessShares::createShare(ProcessShares & instance,
     MemoryContext *remoteMem = instance.getMemoryContext();
     Arch::Cache cache;
     Allocator::Range allocPhys, allocVirt;
-    Size idx = 0;
 
     if (share->range.size == 0)
         return InvalidArgument;
 
+    // Both processes need a free slot for the share
+    if (reserveSlot() != Success || instance.reserveSlot() != Success)
+        return OutOfMemory;
+
     // Check if the share already exists
     if (findShare(share->pid, share->coreId, share->tagId) != ZERO)
         return AlreadyExists;
@@ -186,14 +208,13 @@ ProcessShares::Result ProcessShares::createShare(ProcessShares & instance,
     allocPhys.size = share->range.size;
     allocPhys.alignment = PAGESIZE;
 
-    if (Kernel::instance()->getAllocator()->allocate(allocPhys, allocVirt) != Allocator::Success)
+    if (Kernel::instance()->getAllocator()->allocateZeroed(allocPhys, allocVirt) != Allocator::Success)
     {
         ERROR("failed to allocate pages for MemoryShare");
         return OutOfMemory;
     }
 
-    // Zero out the pages
-    MemoryBlock::set((void *) allocVirt.address, 0, share->range.size);
+    // Write the zeroed pages back to memory
     for (Size i = 0; i < share->range.size; i+=PAGESIZE)
         cache.cleanData(allocVirt.address + i);
 
@@ -234,8 +255,8 @@ ProcessShares::Result ProcessShares::createShare(ProcessShares & instance,
         return OutOfMemory;
     }
     // insert into shares list
-    m_shares.insert(idx, localShare);
-    instance.m_shares.insert(idx, remoteShare);
+    insertShare(localShare);
+    instance.insertShare(remoteShare);
 
     // raise event on the remote process
     ProcessManager *procs = Kernel::instance()->getProcessManager();
@@ -253,19 +274,99 @@ ProcessShares::Result ProcessShares::createShare(ProcessShares & instance,
 
 ProcessShares::Result ProcessShares::removeShares(ProcessID pid)
 {
-    const Size size = m_shares.size();
-    MemoryShare *s = 0;
-
-    for (Size i = 0; i < size; i++)
+    // Only visit the shares in the bucket of the peer
+    for (Size i = m_peerHead[peerBucket(pid)]; i != ChainEnd; )
     {
-        if ((s = m_shares.get(i)) != ZERO)
-        {
-            if (s->pid != pid)
-                continue;
+        const Size next = m_peerNext[i];
+        MemoryShare *s = m_shares[i];
 
+        if (s->pid == pid)
             releaseShare(s, i);
-        }
+
+        i = next;
+    }
+    return Success;
+}
+
+ProcessShares::Result ProcessShares::removeShare(const ProcessID pid,
+                                                 const Size coreId,
+                                                 const Size tagId)
+{
+    const Size idx = findIndex(pid, coreId, tagId);
+
+    if (idx == ChainEnd)
+        return NotFound;
+
+    return releaseShare(m_shares[idx], idx);
+}
+
+ProcessShares::Result ProcessShares::reserveSlot()
+{
+    if (m_free != ChainEnd)
+        return Success;
+
+    if (m_capacity >= MaximumMemoryShares)
+        return OutOfMemory;
+
+    // Double the number of slots
+    const Size capacity = m_capacity ? m_capacity * 2 : InitialMemoryShares;
+    MemoryShare **shares = new MemoryShare *[capacity];
+    u16 *shareNext = new u16[capacity];
+    u16 *peerNext = new u16[capacity];
+
+    if (!shares || !shareNext || !peerNext)
+    {
+        ERROR("failed to allocate " << capacity << " MemoryShare slots");
+        delete[] shares;
+        delete[] shareNext;
+        delete[] peerNext;
+        return OutOfMemory;
+    }
+
+    // Chains refer to slots by position, thus remain valid
+    if (m_capacity)
+    {
+        MemoryBlock::copy(shares, m_shares, m_capacity * sizeof(MemoryShare *));
+        MemoryBlock::copy(shareNext, m_shareNext, m_capacity * sizeof(u16));
+        MemoryBlock::copy(peerNext, m_peerNext, m_capacity * sizeof(u16));
+
+        delete[] m_shares;
+        delete[] m_shareNext;
+        delete[] m_peerNext;
+    }
+
+    // Add the new slots to the free list
+    for (Size i = capacity; i > m_capacity; i--)
+    {
+        shares[i - 1] = ZERO;
+        shareNext[i - 1] = m_free;
+        m_free = i - 1;
     }
+
+    m_shares    = shares;
+    m_shareNext = shareNext;
+    m_peerNext  = peerNext;
+    m_capacity  = capacity;
+    return Success;
+}
+
+ProcessShares::Result ProcessShares::insertShare(MemoryShare *share)
+{
+    if (reserveSlot() != Success)
+        return OutOfMemory;
+
+    const Size idx = m_free;
+    m_free = m_shareNext[idx];
+    m_shares[idx] = share;
+    m_count++;
+
+    const Size bucket = shareBucket(share->pid, share->coreId, share->tagId);
+    const Size peer = peerBucket(share->pid);
+
+    m_shareNext[idx]    = m_shareHead[bucket];
+    m_shareHead[bucket] = idx;
+    m_peerNext[idx]     = m_peerHead[peer];
+    m_peerHead[peer]    = idx;
     return Success;
 }
 
@@ -286,20 +387,18 @@ ProcessShares::Result ProcessShares::releaseShare(MemoryShare *s, Size idx)
         if (proc)
         {
             ProcessShares & shares = proc->getShares();
-            const Size size = shares.m_shares.size();
+            const Size bucket = shareBucket(m_pid, s->coreId, s->tagId);
 
-            // Mark all process shares detached in the other process
-            for (Size i = 0; i < size; i++)
+            // Mark the matching share detached in the other process
+            for (Size i = shares.m_shareHead[bucket]; i != ChainEnd; i = shares.m_shareNext[i])
             {
-                MemoryShare *otherShare = shares.m_shares.get(i);
-                if (otherShare)
-                {
-                    assert(otherShare->coreId == coreInfo.coreId);
+                MemoryShare *otherShare = shares.m_shares[i];
+                assert(otherShare->coreId == coreInfo.coreId);
 
-                    if (otherShare->pid == m_pid && otherShare->coreId == s->coreId)
-                    {
-                        otherShare->attached = false;
-                    }
+                if (otherShare->pid == m_pid && otherShare->coreId == s->coreId &&
+                    otherShare->tagId == s->tagId)
+                {
+                    otherShare->attached = false;
                 }
             }
         }
@@ -317,42 +416,71 @@ ProcessShares::Result ProcessShares::releaseShare(MemoryShare *s, Size idx)
     // Unmap the share
     m_memory->unmapRange(&s->range);
 
+    // Remove from the hash chains
+    unlink(m_shareHead[shareBucket(s->pid, s->coreId, s->tagId)], m_shareNext, idx);
+    unlink(m_peerHead[peerBucket(s->pid)], m_peerNext, idx);
+
     // Release the share object
     delete s;
 
-    // Remove share from our administration
-    if (!m_shares.remove(idx))
-    {
-        return NotFound;
-    }
-    else
-    {
-        return Success;
-    }
+    // Return the slot to the free list
+    m_shares[idx] = ZERO;
+    m_shareNext[idx] = m_free;
+    m_free = idx;
+    m_count--;
+    return Success;
 }
 
 ProcessShares::MemoryShare * ProcessShares::findShare(const ProcessID pid,
                                                       const Size coreId,
                                                       const Size tagId)
 {
-    const Size size = m_shares.size();
+    const Size idx = findIndex(pid, coreId, tagId);
+
+    return idx != ChainEnd ? m_shares[idx] : ZERO;
+}
+
+Size ProcessShares::findIndex(const ProcessID pid,
+                              const Size coreId,
+                              const Size tagId) const
+{
+    const Size bucket = shareBucket(pid, coreId, tagId);
 
-    for (Size i = 0; i < size; i++)
+    for (Size i = m_shareHead[bucket]; i != ChainEnd; i = m_shareNext[i])
     {
-        MemoryShare *s = m_shares.get(i);
+        const MemoryShare *s = m_shares[i];
+        assert(s->coreId == coreInfo.coreId);
 
-        if (s != ZERO)
+        if (s->pid == pid && s->coreId == coreId && s->tagId == tagId)
         {
-            assert(s->coreId == coreInfo.coreId);
-
-            if (s->pid == pid && s->coreId == coreId && s->tagId == tagId)
-            {
-                return s;
-            }
+            return i;
         }
     }
 
-    return ZERO;
+    return ChainEnd;
+}
+
+Size ProcessShares::shareBucket(const ProcessID pid,
+                                const Size coreId,
+                                const Size tagId)
+{
+    return (((pid * 31) + coreId) * 31 + tagId) % ShareBuckets;
+}
+
+Size ProcessShares::peerBucket(const ProcessID pid)
+{
+    return pid % ShareBuckets;
+}
+
+void ProcessShares::unlink(u16 & head, u16 *next, const Size idx)
+{
+    u16 *link = &head;
+
+    while (*link != ChainEnd && *link != idx)
+        link = &next[*link];
+
+    if (*link == idx)
+        *link = next[idx];
 }
 
 ProcessShares::Result ProcessShares::readShare(MemoryShare *share)
@@ -22,7 +22,6 @@
 #include <Macros.h>
 #include <List.h>
 #include <MemoryMap.h>
-#include <Index.h>
 
 class MemoryChannel;
 class MemoryContext;
@@ -35,13 +34,27 @@ class Process;
 
 /**
  * Manages memory shares for a Process.
+ *
+ * Shares are stored in a table of slots which is allocated on the first
+ * share and doubled in size when full. Slots are chained by position in
+ * two hash tables: one keyed by ProcessID, CoreID and TagID for lookups
+ * and one keyed by ProcessID for removing all shares of a peer.
  */
 class ProcessShares
 {
   private:
 
     /** Maximum number of memory shares that a single process can have. */
-    static const Size MaximumMemoryShares = 32u;
+    static const Size MaximumMemoryShares = 256u;
+
+    /** Number of share slots allocated by the first share. */
+    static const Size InitialMemoryShares = 4u;
+
+    /** Number of hash buckets for looking up memory shares. */
+    static const Size ShareBuckets = 32u;
+
+    /** Marks the end of a chain of memory shares. */
+    static const u16 ChainEnd = 0xffff;
 
   public:
 
@@ -146,13 +159,45 @@ class ProcessShares
      */
     Result removeShares(ProcessID pid);
 
+    /**
+     * Remove a single memory share
+     *
+     * The other process keeps its mapping of the share. The physical
+     * pages are released when both processes removed the share.
+     *
+     * @param pid ProcessID of the share
+     * @param coreId CoreID of the share
+     * @param tagId TagID of the share
+     *
+     * @return Result code
+     */
+    Result removeShare(const ProcessID pid,
+                       const Size coreId,
+                       const Size tagId);
+
   private:
 
+    /**
+     * Ensure there is at least one free share slot.
+     *
+     * @return Result code
+     */
+    Result reserveSlot();
+
+    /**
+     * Add a memory share to the administration.
+     *
+     * @param share MemoryShare object pointer
+     *
+     * @return Result code
+     */
+    Result insertShare(MemoryShare *share);
+
     /**
      * Release one memory share
      *
      * @param share MemoryShare object pointer
-     * @param idx Index position of the object
+     * @param idx Slot of the object
      *
      * @return Result code
      */
@@ -171,6 +216,50 @@ class ProcessShares
                             const Size coreId,
                             const Size tagId);
 
+    /**
+     * Retrieve the slot of a MemoryShare object.
+     *
+     * @param pid ProcessID value to match
+     * @param coreId CoreID value to match
+     * @param tagId TagID value to match
+     *
+     * @return Slot if found or ChainEnd if not
+     */
+    Size findIndex(const ProcessID pid,
+                   const Size coreId,
+                   const Size tagId) const;
+
+    /**
+     * Calculate the lookup hash bucket of a memory share.
+     *
+     * @param pid ProcessID of the share
+     * @param coreId CoreID of the share
+     * @param tagId TagID of the share
+     *
+     * @return Bucket number
+     */
+    static Size shareBucket(const ProcessID pid,
+                            const Size coreId,
+                            const Size tagId);
+
+    /**
+     * Calculate the peer hash bucket of a memory share.
+     *
+     * @param pid ProcessID of the share
+     *
+     * @return Bucket number
+     */
+    static Size peerBucket(const ProcessID pid);
+
+    /**
+     * Remove a slot from a chain.
+     *
+     * @param head First slot in the chain
+     * @param next Next slots of the chain
+     * @param idx Slot to remove
+     */
+    static void unlink(u16 & head, u16 *next, const Size idx);
+
   private:
 
     /** ProcessID associated to these shares */
@@ -179,8 +268,29 @@ class ProcessShares
     /** MemoryContext instance */
     MemoryContext *m_memory;
 
-    /** Contains all memory shares */
-    Index<MemoryShare, MaximumMemoryShares> m_shares;
+    /** Memory share per slot, or ZERO if the slot is free */
+    MemoryShare **m_shares;
+
+    /** Next share in the same lookup hash bucket, or the next free slot */
+    u16 *m_shareNext;
+
+    /** Next share in the same peer hash bucket */
+    u16 *m_peerNext;
+
+    /** Number of allocated slots */
+    Size m_capacity;
+
+    /** Number of used slots */
+    Size m_count;
+
+    /** First free slot */
+    u16 m_free;
+
+    /** First share in each lookup hash bucket */
+    u16 m_shareHead[ShareBuckets];
+
+    /** First share in each peer hash bucket */
+    u16 m_peerHead[ShareBuckets];
 };
 
 /**
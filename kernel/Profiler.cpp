@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/System.h>
+#include "Process.h"
+#include "Profiler.h"
+
+Profiler::Profiler()
+    : m_head(0)
+    , m_count(0)
+    , m_dropped(0)
+    , m_running(false)
+{
+}
+
+void Profiler::start()
+{
+    m_head    = 0;
+    m_count   = 0;
+    m_dropped = 0;
+    m_running = true;
+}
+
+void Profiler::stop()
+{
+    m_running = false;
+}
+
+void Profiler::sample(const Process *proc, const Address pc, const bool kernel)
+{
+    if (!m_running)
+        return;
+
+    if (m_count == MaximumSamples)
+    {
+        m_dropped++;
+        return;
+    }
+
+    ProfileSample &s = m_samples[(m_head + m_count) % MaximumSamples];
+    s.pid    = proc ? proc->getID() : 0;
+    s.pc     = pc;
+    s.kernel = kernel;
+    m_count++;
+}
+
+Size Profiler::read(ProfileSample *samples, const Size count)
+{
+    Size num = 0;
+
+    for (; num < count && m_count > 0; num++)
+    {
+        samples[num] = m_samples[m_head];
+        m_head = (m_head + 1) % MaximumSamples;
+        m_count--;
+    }
+
+    return num;
+}
+
+Size Profiler::dropped() const
+{
+    return m_dropped;
+}
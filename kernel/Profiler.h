@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_PROFILER_H
+#define __KERNEL_PROFILER_H
+
+#include <Types.h>
+#include "API.h"
+
+/** Forward declaration */
+class Process;
+
+/**
+ * @addtogroup kernel
+ * @{
+ */
+
+/**
+ * Statistical sampling profiler.
+ *
+ * Driven by the timer interrupt of the core, which records the interrupted
+ * Process and program counter. Samples are kept in a ring buffer until they
+ * are drained, and new samples are dropped while the buffer is full.
+ */
+class Profiler
+{
+  public:
+
+    /** Maximum number of samples buffered */
+    static const Size MaximumSamples = 1024;
+
+  public:
+
+    /**
+     * Constructor
+     */
+    Profiler();
+
+    /**
+     * Discard any buffered samples and start recording.
+     */
+    void start();
+
+    /**
+     * Stop recording. Buffered samples remain available.
+     */
+    void stop();
+
+    /**
+     * Record a sample, if recording.
+     *
+     * @param proc Process which was interrupted or ZERO if none
+     * @param pc Program counter at the moment of the interrupt
+     * @param kernel True if the interrupt occurred in kernel mode
+     */
+    void sample(const Process *proc, const Address pc, const bool kernel);
+
+    /**
+     * Drain buffered samples, oldest first.
+     *
+     * @param samples Output array of samples
+     * @param count Maximum number of samples to output
+     *
+     * @return Number of samples written to the output array
+     */
+    Size read(ProfileSample *samples, const Size count);
+
+    /**
+     * Get the number of samples dropped since the last start.
+     *
+     * @return Number of samples which did not fit in the buffer
+     */
+    Size dropped() const;
+
+  private:
+
+    /** Ring buffer of samples */
+    ProfileSample m_samples[MaximumSamples];
+
+    /** Position of the oldest sample in the ring buffer */
+    Size m_head;
+
+    /** Number of samples in the ring buffer */
+    Size m_count;
+
+    /** Number of samples dropped */
+    Size m_dropped;
+
+    /** True while recording */
+    bool m_running;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __KERNEL_PROFILER_H */
@@ -20,13 +20,26 @@
 #include "Scheduler.h"
 
 Scheduler::Scheduler()
+    : m_readyMap(0)
+    , m_count(0)
 {
     DEBUG("");
+
+    for (Size i = 0; i < PriorityLevels; i++)
+    {
+        m_head[i] = ZERO;
+        m_tail[i] = ZERO;
+    }
 }
 
 Size Scheduler::count() const
 {
-    return m_queue.count();
+    return m_count;
+}
+
+bool Scheduler::contains(const Process *proc) const
+{
+    return proc->m_schedPrev != ZERO || m_head[proc->m_priority] == proc;
 }
 
 Scheduler::Result Scheduler::enqueue(Process *proc, bool ignoreState)
@@ -37,7 +50,27 @@ Scheduler::Result Scheduler::enqueue(Process *proc, bool ignoreState)
         return InvalidArgument;
     }
 
-    m_queue.push(proc);
+    if (contains(proc))
+    {
+        ERROR("process ID " << proc->getID() << " is already in the schedule");
+        return InvalidArgument;
+    }
+
+    const Size level = proc->m_priority;
+
+    // Append to the tail of the priority level
+    proc->m_schedPrev = m_tail[level];
+    proc->m_schedNext = ZERO;
+
+    if (m_tail[level])
+        m_tail[level]->m_schedNext = proc;
+    else
+        m_head[level] = proc;
+
+    m_tail[level] = proc;
+    m_readyMap |= (1U << level);
+    m_count++;
+
     return Success;
 }
 
@@ -49,32 +82,57 @@ Scheduler::Result Scheduler::dequeue(Process *proc, bool ignoreState)
         return InvalidArgument;
     }
 
-    Size count = m_queue.count();
-
-    // Traverse the Queue to remove the Process
-    for (Size i = 0; i < count; i++)
+    if (!contains(proc))
     {
-        Process *p = m_queue.pop();
-
-        if (p == proc)
-            return Success;
-        else
-            m_queue.push(p);
+        FATAL("process ID " << proc->getID() << " is not in the schedule");
+        return InvalidArgument;
     }
 
-    FATAL("process ID " << proc->getID() << " is not in the schedule");
-    return InvalidArgument;
+    const Size level = proc->m_priority;
+
+    // Unlink from the priority level
+    if (proc->m_schedPrev)
+        proc->m_schedPrev->m_schedNext = proc->m_schedNext;
+    else
+        m_head[level] = proc->m_schedNext;
+
+    if (proc->m_schedNext)
+        proc->m_schedNext->m_schedPrev = proc->m_schedPrev;
+    else
+        m_tail[level] = proc->m_schedPrev;
+
+    proc->m_schedPrev = ZERO;
+    proc->m_schedNext = ZERO;
+
+    if (!m_head[level])
+        m_readyMap &= ~(1U << level);
+
+    m_count--;
+    return Success;
 }
 
 Process * Scheduler::select()
 {
-    if (m_queue.count() > 0)
+    if (!m_readyMap)
+    {
+        return (Process *) NULL;
+    }
+
+    // Find the highest priority level with a Ready process
+    const Size level = (sizeof(m_readyMap) * 8) - 1 - __builtin_clz(m_readyMap);
+    Process *p = m_head[level];
+
+    // Rotate to the tail for round-robin within the same level
+    if (p->m_schedNext)
     {
-        Process *p = m_queue.pop();
-        m_queue.push(p);
+        m_head[level] = p->m_schedNext;
+        m_head[level]->m_schedPrev = ZERO;
 
-        return p;
+        p->m_schedPrev = m_tail[level];
+        p->m_schedNext = ZERO;
+        m_tail[level]->m_schedNext = p;
+        m_tail[level] = p;
     }
 
-    return (Process *) NULL;
+    return p;
 }
@@ -19,9 +19,8 @@
 #define __KERNEL_SCHEDULER_H
 #ifndef __ASSEMBLER__
 
-#include <Vector.h>
+#include <Types.h>
 #include <Macros.h>
-#include <Queue.h>
 #include "Process.h"
 #include "ProcessManager.h"
 
@@ -32,9 +31,18 @@
 
 /**
  * Responsible for deciding which Process may execute on the local Core.
+ *
+ * Ready processes are kept in one intrusive list per Process::Priority level.
+ * A bitmap records which levels have at least one process, such that
+ * enqueue, dequeue and select are all constant time operations.
  */
 class Scheduler
 {
+  private:
+
+    /** Number of priority levels */
+    static const Size PriorityLevels = Process::PriorityMax + 1;
+
   public:
 
     /**
@@ -80,17 +88,38 @@ class Scheduler
      */
     Result dequeue(Process *proc, bool ignoreState);
 
+    /**
+     * Check if a Process is on the run schedule.
+     *
+     * @param proc Process pointer
+     *
+     * @return True if the Process is queued, false otherwise
+     */
+    bool contains(const Process *proc) const;
+
     /**
      * Select the next process to run.
      *
+     * Picks the first Process of the highest priority level
+     * which is non-empty and rotates it to the end of its level.
+     *
      * @return Process pointer or NULL if no matching process found
      */
     Process * select();
 
   private:
 
-    /** Contains processes ready to run */
-    Queue<Process *, MAX_PROCS> m_queue;
+    /** First Process on each priority level */
+    Process *m_head[PriorityLevels];
+
+    /** Last Process on each priority level */
+    Process *m_tail[PriorityLevels];
+
+    /** Bitmap of priority levels which have at least one Process */
+    uint m_readyMap;
+
+    /** Total number of processes on the schedule */
+    Size m_count;
 };
 
 /**
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/System.h>
+#include "Kernel.h"
+#include "Process.h"
+#include "ProcessManager.h"
+#include "Trace.h"
+
+Trace::Trace()
+    : m_head(0)
+    , m_tail(0)
+    , m_lost(0)
+{
+}
+
+void Trace::record(const TraceType type, const u32 arg0, const u32 arg1)
+{
+    const Process *proc = Kernel::instance()->getProcessManager()->current();
+    TraceRecord &r = m_records[m_head & (MaximumRecords - 1)];
+
+    r.timestamp = timestamp();
+    r.type      = type;
+    r.pid       = proc ? proc->getID() : 0;
+    r.arg0      = arg0;
+    r.arg1      = arg1;
+    m_head++;
+
+    // Overwrite the oldest record when full
+    if (m_head - m_tail > MaximumRecords)
+    {
+        m_tail++;
+        m_lost++;
+    }
+}
+
+Size Trace::read(TraceRecord *records, const Size count)
+{
+    Size num = 0;
+
+    if (count > 0 && m_lost > 0)
+    {
+        records[num].timestamp = timestamp();
+        records[num].type      = TraceLost;
+        records[num].pid       = 0;
+        records[num].arg0      = m_lost;
+        records[num].arg1      = 0;
+        m_lost = 0;
+        num++;
+    }
+
+    for (; num < count && m_tail != m_head; num++)
+    {
+        records[num] = m_records[m_tail & (MaximumRecords - 1)];
+        m_tail++;
+    }
+
+    return num;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_TRACE_H
+#define __KERNEL_TRACE_H
+
+#include <Types.h>
+#include "API.h"
+
+/**
+ * @addtogroup kernel
+ * @{
+ */
+
+/**
+ * Record a kernel trace event.
+ *
+ * Expands to nothing unless the kernel is built with TRACE enabled.
+ *
+ * @param type TraceType of the event
+ * @param arg0 First event specific argument
+ * @param arg1 Second event specific argument
+ */
+#ifdef __TRACE__
+#define TRACE(type, arg0, arg1) \
+    Kernel::instance()->getTrace()->record((type), (arg0), (arg1))
+#else
+#define TRACE(type, arg0, arg1)
+#endif /* __TRACE__ */
+
+/**
+ * Kernel event trace ring buffer.
+ *
+ * Each core has its own ring, which is only written by the kernel of
+ * that core with interrupts disabled and thus needs no locking. When the
+ * ring is full the oldest records are overwritten and counted as lost.
+ */
+class Trace
+{
+  public:
+
+    /** Number of records in the ring. Must be a power of two. */
+    static const Size MaximumRecords = 1024;
+
+  public:
+
+    /**
+     * Constructor
+     */
+    Trace();
+
+    /**
+     * Append a record.
+     *
+     * @param type TraceType of the event
+     * @param arg0 First event specific argument
+     * @param arg1 Second event specific argument
+     */
+    void record(const TraceType type, const u32 arg0, const u32 arg1);
+
+    /**
+     * Drain records, oldest first.
+     *
+     * If records were lost since the previous read, the first
+     * output record is a TraceLost record with the number lost.
+     *
+     * @param records Output array of records
+     * @param count Maximum number of records to output
+     *
+     * @return Number of records written to the output array
+     */
+    Size read(TraceRecord *records, const Size count);
+
+  private:
+
+    /** Ring of records */
+    TraceRecord m_records[MaximumRecords];
+
+    /** Number of records written since creation */
+    u32 m_head;
+
+    /** Number of records read or lost since creation */
+    u32 m_tail;
+
+    /** Number of records lost since the previous read */
+    u32 m_lost;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __KERNEL_TRACE_H */
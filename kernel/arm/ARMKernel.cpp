@@ -50,6 +50,30 @@ ARMKernel::ARMKernel(CoreInfo *info)
     ctrl.unset(ARMControl::BigEndian);
 #endif
 
+    // Allow access to the VFP, if present. The VFP itself stays
+    // disabled until the first VFP instruction of a Process.
+    cpacr_write(cpacr_read() | CPACR_VFP_ACCESS);
+    isb();
+    if (cpacr_read() & CPACR_VFP_ACCESS)
+    {
+        fpexc_write(0);
+    }
+
+#ifdef ARMV7
+    // Start the cycle counter used by timestamp() and allow
+    // reading it from user mode (PMCR, PMCNTENSET and PMUSERENR)
+    mcr(p15, 0, 0, c9, c12, (1 << 0) | (1 << 2));
+    mcr(p15, 0, 1, c9, c12, (1 << 31));
+    mcr(p15, 0, 0, c9, c14, 1);
+    isb();
+#endif /* ARMV7 */
+
+    // Use the PMU event counters, if present
+    if (m_perfCounter.count() > 0)
+    {
+        m_perf = &m_perfCounter;
+    }
+
     // First page is used for exception handlers
     m_alloc->allocate(info->memory.phys);
 
@@ -80,10 +104,19 @@ void ARMKernel::interrupt(CPUState state)
            Kernel::instance()->getProcessManager()->current()->getID());
 }
 
-void ARMKernel::undefinedInstruction(CPUState state)
+void ARMKernel::undefinedInstruction(volatile CPUState state)
 {
+    ARMProcess *proc = (ARMProcess *) Kernel::instance()->getProcessManager()->current();
+
+    // Retry the first VFP instruction of the Process, in ARM state only
+    if (proc && !(state.cpsr & (1 << 5)) && proc->activateFPU())
+    {
+        state.pc -= 4;
+        return;
+    }
+
     ARMCore core;
-    core.logException(&state);
+    core.logException((CPUState *) &state);
 
     FATAL("core" << coreInfo.coreId << ": procId = " <<
            Kernel::instance()->getProcessManager()->current()->getID());
@@ -92,6 +125,12 @@ void ARMKernel::undefinedInstruction(CPUState state)
 void ARMKernel::prefetchAbort(CPUState state)
 {
     ARMCore core;
+    ARMControl ctrl;
+
+    // Back demand-zero pages, copy shared pages on write and retry the instruction
+    if (demandFault(ctrl.read(ARMControl::InstructionFaultAddress)))
+        return;
+
     core.logException(&state);
 
     FATAL("core" << coreInfo.coreId << ": procId = " <<
@@ -101,12 +140,30 @@ void ARMKernel::prefetchAbort(CPUState state)
 void ARMKernel::dataAbort(CPUState state)
 {
     ARMCore core;
+    ARMControl ctrl;
+
+    // Back demand-zero pages, copy shared pages on write and retry the instruction
+    if (demandFault(ctrl.read(ARMControl::DataFaultAddress)))
+        return;
+
     core.logException(&state);
 
     FATAL("core" << coreInfo.coreId << ": procId = " <<
            Kernel::instance()->getProcessManager()->current()->getID());
 }
 
+bool ARMKernel::demandFault(const Address virt)
+{
+    Process *proc = Kernel::instance()->getProcessManager()->current();
+
+    if (proc == ZERO)
+        return false;
+
+    MemoryContext *mem = proc->getMemoryContext();
+
+    return mem->mapDemand(virt) == MemoryContext::Success ||
+           mem->copyOnWrite(virt) == MemoryContext::Success;
+}
 
 void ARMKernel::reserved(CPUState state)
 {
@@ -123,6 +180,7 @@ void ARMKernel::trap(volatile CPUState state)
     ARMProcess *proc = (ARMProcess *) mgr->current(), *proc2;
     ProcessID procId = proc->getID();
 
+    IRQOFF_BEGIN(trap);
     DEBUG("coreId = " << coreInfo.coreId << " procId = " << procId << " api = " << state.r0);
 
     // Execute the kernel call
@@ -151,4 +209,6 @@ void ARMKernel::trap(volatile CPUState state)
     }
     else
         state.r0 = r;
+
+    IRQOFF_END();
 }
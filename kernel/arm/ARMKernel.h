@@ -21,6 +21,7 @@
 #include <FreeNOS/Kernel.h>
 #include <FreeNOS/Process.h>
 #include <arm/ARMException.h>
+#include <arm/ARMPerformanceCounter.h>
 #include <Types.h>
 
 /** Forward declaration */
@@ -92,10 +93,22 @@ class ARMKernel : public Kernel
      */
     static void reserved(CPUState state);
 
+    /**
+     * Back a demand-zero page or copy a copy-on-write page of the current Process
+     *
+     * @param virt Faulting virtual address
+     *
+     * @return True if the page is backed and the instruction can be retried
+     */
+    static bool demandFault(const Address virt);
+
   protected:
 
     /** ARM exception handling subsystem. */
     ARMException m_exception;
+
+    /** Performance Monitors event counters. */
+    ARMPerformanceCounter m_perfCounter;
 };
 
 /**
@@ -23,6 +23,9 @@
 #define MEMALIGN8 8
 
 static bool firstProcess = true;
+
+/** Process which has its registers loaded in the VFP of this core */
+static ARMProcess *fpuOwner = ZERO;
 extern u8 svcStack[PAGESIZE * 4];
 
 ARMProcess::ARMProcess(ProcessID id, Address entry, bool privileged, const MemoryMap &map)
@@ -35,41 +38,49 @@ Process::Result ARMProcess::initialize()
     Memory::Range range;
     Allocator::Range alloc_args;
 
-    // Create MMU context
-    m_memoryContext = new ARMPaging(&m_map, Kernel::instance()->getAllocator());
-    if (!m_memoryContext)
-    {
-        ERROR("failed to create memory context");
-        return OutOfMemory;
-    }
-
-    // Initialize MMU context
-    const MemoryContext::Result memResult = m_memoryContext->initialize();
-    if (memResult != MemoryContext::Success)
-    {
-        ERROR("failed to initialize MemoryContext: result = " << (int) memResult);
-        return OutOfMemory;
-    }
-
-    // Allocate User stack
-    range = m_map.range(MemoryMap::UserStack);
-    range.access = Memory::Readable | Memory::Writable | Memory::User;
-    alloc_args.address = 0;
-    alloc_args.size = range.size;
-    alloc_args.alignment = PAGESIZE;
-
-    if (Kernel::instance()->getAllocator()->allocate(alloc_args) != Allocator::Success)
+    // Threads share the MMU context and memory of their leader
+    if (m_leader)
     {
-        ERROR("failed to allocate user stack");
-        return OutOfMemory;
+        m_memoryContext = m_leader->getMemoryContext();
     }
-    range.phys = alloc_args.address;
-
-    // Map User stack
-    if (m_memoryContext->mapRangeContiguous(&range) != MemoryContext::Success)
+    else
     {
-        ERROR("failed to map user stack");
-        return MemoryMapError;
+        // Create MMU context
+        m_memoryContext = new ARMPaging(&m_map, Kernel::instance()->getAllocator());
+        if (!m_memoryContext)
+        {
+            ERROR("failed to create memory context");
+            return OutOfMemory;
+        }
+
+        // Initialize MMU context
+        const MemoryContext::Result memResult = m_memoryContext->initialize();
+        if (memResult != MemoryContext::Success)
+        {
+            ERROR("failed to initialize MemoryContext: result = " << (int) memResult);
+            return OutOfMemory;
+        }
+
+        // Allocate User stack
+        range = m_map.range(MemoryMap::UserStack);
+        range.access = Memory::Readable | Memory::Writable | Memory::User;
+        alloc_args.address = 0;
+        alloc_args.size = range.size;
+        alloc_args.alignment = PAGESIZE;
+
+        if (Kernel::instance()->getAllocator()->allocate(alloc_args) != Allocator::Success)
+        {
+            ERROR("failed to allocate user stack");
+            return OutOfMemory;
+        }
+        range.phys = alloc_args.address;
+
+        // Map User stack
+        if (m_memoryContext->mapRangeContiguous(&range) != MemoryContext::Success)
+        {
+            ERROR("failed to map user stack");
+            return MemoryMapError;
+        }
     }
 
     // Fill usermode program registers
@@ -81,6 +92,10 @@ Process::Result ARMProcess::initialize()
 
 ARMProcess::~ARMProcess()
 {
+    if (fpuOwner == this)
+    {
+        fpuOwner = ZERO;
+    }
 }
 
 const CPUState * ARMProcess::cpuState() const
@@ -108,8 +123,17 @@ void ARMProcess::reset(const Address entry)
 {
     const Memory::Range range = m_map.range(MemoryMap::UserStack);
 
+    // The program starts with cleared VFP registers
+    MemoryBlock::set(m_fpuState, 0, sizeof(m_fpuState));
+    if (fpuOwner == this)
+    {
+        fpuOwner = ZERO;
+    }
+
     MemoryBlock::set(&m_cpuState, 0, sizeof(m_cpuState));
-    m_cpuState.sp = range.virt + range.size - MEMALIGN8;    // user stack pointer
+    m_cpuState.sp = m_userStack ? m_userStack
+                                : range.virt + range.size - MEMALIGN8; // user stack pointer
+    m_cpuState.r0 = m_userArgument;                         // thread argument
     m_cpuState.pc = entry;                                  // user program counter
     m_cpuState.cpsr = (m_privileged ? SYS_MODE : USR_MODE); // current program status (CPSR)
 }
@@ -119,6 +143,12 @@ void ARMProcess::execute(Process *previous)
     // Activates memory context of this process
     m_memoryContext->activate();
 
+    // Trap on the first VFP instruction, unless our registers are still loaded
+    if (cpacr_read() & CPACR_VFP_ACCESS)
+    {
+        fpexc_write(fpuOwner == this ? FPEXC_EN : 0);
+    }
+
     // First process starts from loadCoreState0
     if (firstProcess)
     {
@@ -135,3 +165,55 @@ void ARMProcess::execute(Process *previous)
                       "bx r0\n" : : "i" (sizeof(m_cpuState) - sizeof(m_cpuState.padding)) );
     }
 }
+
+bool ARMProcess::activateFPU()
+{
+    // Only a disabled VFP can be activated
+    if (!(cpacr_read() & CPACR_VFP_ACCESS) || (fpexc_read() & FPEXC_EN))
+    {
+        return false;
+    }
+
+    fpexc_write(FPEXC_EN);
+
+    if (fpuOwner != this)
+    {
+        // Registers d16-d31 are only present if MVFR0 reports 32 registers
+        const bool extended = (mrc(p10, 7, 0, c7, c0) & 0xf) == 2;
+
+        if (fpuOwner)
+        {
+            saveFPU(fpuOwner->m_fpuState, extended);
+        }
+        restoreFPU(m_fpuState, extended);
+        fpuOwner = this;
+    }
+
+    return true;
+}
+
+void ARMProcess::saveFPU(u64 *state, const bool extended)
+{
+    // vstmia d0-d15
+    asm volatile ("stc p11, cr0, [%0], #32*4" : "+r" (state) :: "memory");
+
+    // vstmia d16-d31
+    if (extended)
+        asm volatile ("stcl p11, cr0, [%0]" :: "r" (state) : "memory");
+
+    // vmrs fpscr
+    state[FPURegisters - 16] = mrc(p10, 7, 0, c1, c0);
+}
+
+void ARMProcess::restoreFPU(const u64 *state, const bool extended)
+{
+    // vldmia d0-d15
+    asm volatile ("ldc p11, cr0, [%0], #32*4" : "+r" (state) :: "memory");
+
+    // vldmia d16-d31
+    if (extended)
+        asm volatile ("ldcl p11, cr0, [%0]" :: "r" (state) : "memory");
+
+    // vmsr fpscr
+    mcr(p10, 7, 0, c1, c0, (u32) state[FPURegisters - 16]);
+}
@@ -33,6 +33,11 @@
  */
 class ARMProcess : public Process
 {
+  private:
+
+    /** Number of 64-bit VFP registers to save */
+    static const Size FPURegisters = 32;
+
   public:
 
     /**
@@ -93,10 +98,43 @@ class ARMProcess : public Process
      */
     virtual void execute(Process *previous);
 
+    /**
+     * Give this Process access to the VFP.
+     *
+     * Called on an undefined instruction while the VFP is disabled.
+     * Saves the VFP registers of the previous owner and restores those
+     * of this Process, then enables the VFP.
+     *
+     * @return True if the VFP was enabled, false if the instruction was not
+     *         caused by a disabled VFP.
+     */
+    bool activateFPU();
+
+  private:
+
+    /**
+     * Save the VFP registers.
+     *
+     * @param state Area to save d0-d31 and the FPSCR
+     * @param extended True to also save registers d16-d31
+     */
+    static void saveFPU(u64 *state, const bool extended);
+
+    /**
+     * Restore the VFP registers.
+     *
+     * @param state Area with saved d0-d31 and the FPSCR
+     * @param extended True to also restore registers d16-d31
+     */
+    static void restoreFPU(const u64 *state, const bool extended);
+
   private:
 
     /** Contains all the CPU registers for this task */
     CPUState m_cpuState;
+
+    /** Saved VFP registers, followed by the FPSCR */
+    u64 m_fpuState[FPURegisters + 1];
 };
 
 
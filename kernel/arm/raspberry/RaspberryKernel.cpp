@@ -17,6 +17,7 @@
 
 #include <FreeNOS/System.h>
 #include <FreeNOS/ProcessManager.h>
+#include <FreeNOS/Profiler.h>
 #include <Log.h>
 #include <SplitAllocator.h>
 #include <CoreInfo.h>
@@ -74,6 +75,7 @@ void RaspberryKernel::interrupt(volatile CPUState state)
     ARMProcess *proc = (ARMProcess *) Kernel::instance()->getProcessManager()->current(), *next;
     bool tick;
 
+    IRQOFF_BEGIN(interrupt);
     DEBUG("procId = " << proc->getID());
 
 #ifdef BCM2836
@@ -90,6 +92,7 @@ void RaspberryKernel::interrupt(volatile CPUState state)
     if (tick)
     {
         kernel->m_timer->tick();
+        kernel->m_profiler->sample(proc, state.pc, (state.cpsr & 0x1f) != USR_MODE);
         kernel->getProcessManager()->schedule();
     }
 
@@ -107,4 +110,6 @@ void RaspberryKernel::interrupt(volatile CPUState state)
         proc->setCpuState((const CPUState *)&state);
         MemoryBlock::copy((void *)&state, next->cpuState(), sizeof(state));
     }
+
+    IRQOFF_END();
 }
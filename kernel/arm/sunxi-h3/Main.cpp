@@ -18,6 +18,7 @@
 #include <FreeNOS/Config.h>
 #include <FreeNOS/Support.h>
 #include <FreeNOS/System.h>
+#include <FreeNOS/BootTimeline.h>
 #include <arm/ARMPaging.h>
 #include <arm/ARMControl.h>
 #include <arm/ARMCore.h>
@@ -35,6 +36,9 @@ static u32 ALIGN(16 * 1024) SECTION(".data") tmpPageDir[4096];
 
 extern C int kernel_main(void)
 {
+    // Start of the boot timeline, recorded once BSS is cleared
+    const u64 entry = timestamp();
+
 #ifdef ARMV7
     // Raise the SMP bit for ARMv7
     ARMControl ctrl;
@@ -87,6 +91,7 @@ extern C int kernel_main(void)
 
     // Clear BSS
     clearBSS();
+    BootTimeline::record(BootKernelEntry, 0, read_core_id(), ZERO, entry);
 
     // Initialize heap
     Kernel::initializeHeap();
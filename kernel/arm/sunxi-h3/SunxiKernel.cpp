@@ -17,6 +17,7 @@
 
 #include <FreeNOS/System.h>
 #include <FreeNOS/ProcessManager.h>
+#include <FreeNOS/Profiler.h>
 #include <Log.h>
 #include <SplitAllocator.h>
 #include <CoreInfo.h>
@@ -63,6 +64,7 @@ void SunxiKernel::interrupt(volatile CPUState state)
     uint irq;
     bool tick = false;
 
+    IRQOFF_BEGIN(interrupt);
     DEBUG("procId = " << proc->getID());
 
     IntController::Result result = kernel->m_intControl->nextPending(irq);
@@ -79,6 +81,7 @@ void SunxiKernel::interrupt(volatile CPUState state)
     if (tick)
     {
         kernel->m_timer->tick();
+        kernel->m_profiler->sample(proc, state.pc, (state.cpsr & 0x1f) != USR_MODE);
         kernel->getProcessManager()->schedule();
     }
 
@@ -89,4 +92,6 @@ void SunxiKernel::interrupt(volatile CPUState state)
         proc->setCpuState((const CPUState *)&state);
         MemoryBlock::copy((void *)&state, next->cpuState(), sizeof(state));
     }
+
+    IRQOFF_END();
 }
@@ -17,6 +17,7 @@
 
 #include <FreeNOS/ProcessManager.h>
 #include <FreeNOS/System.h>
+#include <FreeNOS/Profiler.h>
 #include <Macros.h>
 #include <List.h>
 #include <ListIterator.h>
@@ -31,15 +32,29 @@
 
 extern C void executeInterrupt(CPUState state)
 {
+    ProcessManager *procs = Kernel::instance()->getProcessManager();
+
+    IRQOFF_BEGIN(executeInterrupt);
     Kernel::instance()->executeIntVector(state.vector, &state);
+
+    // Switch process if an interrupt requested it at a preemption point
+    procs->schedulePending();
+    IRQOFF_END();
 }
 
 IntelKernel::IntelKernel(CoreInfo *info)
     : Kernel(info)
+    , m_ioapic(m_apic)
 {
     IntelMap map;
     IntelCore core;
 
+    // Use the performance monitoring counters, if present
+    if (m_perfCounter.count() > 0)
+    {
+        m_perf = &m_perfCounter;
+    }
+
     // First megabyte should not be used on Intel (I/O devices and tables)
     for (Size i = 0; i < MegaByte(1); i += PAGESIZE)
     {
@@ -57,8 +72,29 @@ IntelKernel::IntelKernel(CoreInfo *info)
     // Setup exception handlers
     for (int i = 0; i < 17; i++)
     {
-        hookIntVector(i, exception, 0);
+        if (i == INTEL_DEVERR)
+            hookIntVector(i, fpuUnavailable, 0);
+        else
+            hookIntVector(i, exception, 0);
+    }
+
+    // Enable lazy FPU/SSE context switching: the first
+    // FPU instruction of a Process raises INTEL_DEVERR.
+    if (cpuFeatures() & INTEL_CPUID_FXSR)
+    {
+        core.writeCR4(core.readCR4() | CR4_OSFXSR | CR4_OSXMMEXCPT);
     }
+    core.writeCR0((core.readCR0() & ~CR0_EM) | CR0_MP | CR0_TS);
+
+    // Let kernel writes to copy-on-write pages fault as well
+    core.writeCR0(core.readCR0() | CR0_WP);
+
+    // Keep the kernel mappings in the TLB when switching page directories
+    if (cpuFeatures() & INTEL_CPUID_PGE)
+    {
+        core.writeCR4(core.readCR4() | CR4_PGE);
+    }
+
     // Setup IRQ handlers
     for (int i = 17; i < 256; i++)
     {
@@ -81,6 +117,9 @@ IntelKernel::IntelKernel(CoreInfo *info)
         m_pic.initialize();
         m_intControl = &m_pic;
     }
+    // Other cores receive the IRQs routed to them via the I/O APIC
+    else if (m_ioapic.initialize() == IntController::Success)
+        m_intControl = &m_ioapic;
     else
         m_intControl = &m_apic;
 
@@ -98,9 +137,11 @@ IntelKernel::IntelKernel(CoreInfo *info)
         {
             m_apic.start(&m_pit);
             m_coreInfo->timerCounter = m_apic.getCounter();
+            m_coreInfo->timestampFrequency = m_apic.getTimestampFrequency();
         }
         else
-            m_apic.start(m_coreInfo->timerCounter, m_pit.getFrequency());
+            m_apic.start(m_coreInfo->timerCounter, m_pit.getFrequency(),
+                         m_coreInfo->timestampFrequency);
     }
     // Use PIT as system timer.
     else
@@ -135,6 +176,19 @@ IntelKernel::IntelKernel(CoreInfo *info)
     kernelTss.bitmap = sizeof(TSS);
     ltr(KERNEL_TSS_SEL);
 
+    // Enable fast system calls. The handler loads the
+    // kernel stack from the TSS, and the upper part of the
+    // TSS page serves as a temporary stack.
+    if (isSysenterSupported())
+    {
+        wrmsr(INTEL_MSR_SYSENTER_CS, KERNEL_CS_SEL);
+        wrmsr(INTEL_MSR_SYSENTER_ESP, ((Address) &kernelTss) + PAGESIZE);
+        wrmsr(INTEL_MSR_SYSENTER_EIP, (Address) &sysenterHandler);
+    }
+
+    // The kernel itself always uses the software interrupt
+    trapKernelMode() = IntelTrapInterrupt;
+
 }
 
 void IntelKernel::enableIRQ(u32 irq, bool enabled)
@@ -157,6 +211,20 @@ void IntelKernel::exception(CPUState *state, ulong param, ulong vector)
     IntelCore core;
     ProcessManager *procs = Kernel::instance()->getProcessManager();
 
+    // Back demand-zero pages on first access, copy shared pages
+    // on first write and then retry the instruction
+    if (vector == INTEL_PAGEFAULT && procs->current() != ZERO)
+    {
+        MemoryContext *mem = procs->current()->getMemoryContext();
+        const Address addr = core.readCR2();
+
+        if (mem->mapDemand(addr) == MemoryContext::Success ||
+            mem->copyOnWrite(addr) == MemoryContext::Success)
+        {
+            return;
+        }
+    }
+
     core.logException(state);
     FATAL("core" << coreInfo.coreId << ": Exception in Process: " << procs->current()->getID());
 
@@ -165,6 +233,18 @@ void IntelKernel::exception(CPUState *state, ulong param, ulong vector)
     procs->schedule();
 }
 
+void IntelKernel::fpuUnavailable(CPUState *state, ulong param, ulong vector)
+{
+    IntelProcess *proc = (IntelProcess *) Kernel::instance()->getProcessManager()->current();
+
+    if (!proc)
+    {
+        FATAL("core" << coreInfo.coreId << ": FPU used outside of a Process");
+    }
+
+    proc->activateFPU();
+}
+
 void IntelKernel::interrupt(CPUState *state, ulong param, ulong vector)
 {
     IntelKernel *kern = (IntelKernel *) Kernel::instance();
@@ -177,6 +257,23 @@ void IntelKernel::interrupt(CPUState *state, ulong param, ulong vector)
     }
 }
 
+void IntelKernel::preemptionPoint()
+{
+    // Already inside an interrupt taken at a preemption point
+    if (m_procs->isSwitchDeferred())
+        return;
+
+    IRQOFF_SITE(__builtin_return_address(0));
+    IRQOFF_END();
+    m_procs->deferSwitch(true);
+
+    // Interrupts are recognized after the instruction following sti
+    asm volatile ("sti; nop; cli" : : : "memory");
+
+    m_procs->deferSwitch(false);
+    IRQOFF_BEGIN(__builtin_return_address(0));
+}
+
 void IntelKernel::trap(CPUState *state, ulong param, ulong vector)
 {
     state->regs.eax = Kernel::instance()->getAPI()->invoke(
@@ -201,5 +298,6 @@ void IntelKernel::clocktick(CPUState *state, ulong param, ulong vector)
         kern->m_apic.clear(irq);
 
     kern->m_timer->tick();
+    kern->m_profiler->sample(kern->m_procs->current(), state->irq.eip, (state->irq.cs & 3) == 0);
     kern->getProcessManager()->schedule();
 }
@@ -22,6 +22,8 @@
 #include <intel/IntelPIT.h>
 #include <intel/IntelPIC.h>
 #include <intel/IntelAPIC.h>
+#include <intel/IntelIOAPIC.h>
+#include <intel/IntelPerformanceCounter.h>
 #include <Timer.h>
 #include <Types.h>
 #include <BootImage.h>
@@ -57,6 +59,14 @@ class IntelKernel : public Kernel
      */
     virtual void enableIRQ(u32 irq, bool enabled);
 
+    /**
+     * Briefly allow pending interrupts in a long kernel operation.
+     *
+     * Interrupts taken here run on the kernel stack of the current
+     * Process, with process switches deferred until the kernel returns.
+     */
+    virtual void preemptionPoint();
+
   private:
 
     /**
@@ -68,6 +78,15 @@ class IntelKernel : public Kernel
      */
     static void exception(CPUState *state, ulong param, ulong vector);
 
+    /**
+     * Called when a Process uses the FPU while it does not own it.
+     *
+     * @param state Contains CPU registers, interrupt vector and error code.
+     * @param param Not used.
+     * @param vector Not used.
+     */
+    static void fpuUnavailable(CPUState *state, ulong param, ulong vector);
+
     /**
      * Default interrupt handler.
      *
@@ -105,6 +124,12 @@ class IntelKernel : public Kernel
 
     /** PIC instance */
     IntelPIC m_pic;
+
+    /** I/O APIC instance (used by secondary cores if available) */
+    IntelIOAPIC m_ioapic;
+
+    /** Performance monitoring counters */
+    IntelPerformanceCounter m_perfCounter;
 };
 
 /**
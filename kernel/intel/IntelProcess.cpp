@@ -22,6 +22,15 @@
 #include <intel/IntelPaging.h>
 #include "IntelProcess.h"
 
+/** Default value of the FPU control word, as set by fninit */
+#define FPU_CONTROL_DEFAULT 0x37f
+
+/** Default value of the SSE control and status register */
+#define MXCSR_DEFAULT 0x1f80
+
+/** Process which has its state loaded in the FPU of this core */
+static IntelProcess *fpuOwner = ZERO;
+
 IntelProcess::IntelProcess(ProcessID id, Address entry, bool privileged, const MemoryMap &map)
     : Process(id, entry, privileged, map)
 {
@@ -32,41 +41,49 @@ Process::Result IntelProcess::initialize()
     Memory::Range range;
     Allocator::Range allocPhys, allocVirt;
 
-    // Create MMU context
-    m_memoryContext = new IntelPaging(&m_map, Kernel::instance()->getAllocator());
-    if (!m_memoryContext)
-    {
-        ERROR("failed to create memory context");
-        return OutOfMemory;
-    }
-
-    // Initialize MMU context
-    const MemoryContext::Result memResult = m_memoryContext->initialize();
-    if (memResult != MemoryContext::Success)
-    {
-        ERROR("failed to initialize MemoryContext: result = " << (int) memResult);
-        return OutOfMemory;
-    }
-
-    // Allocate User stack
-    range = m_map.range(MemoryMap::UserStack);
-    range.access = Memory::Readable | Memory::Writable | Memory::User;
-    allocPhys.address = 0;
-    allocPhys.size = range.size;
-    allocPhys.alignment = PAGESIZE;
-
-    if (Kernel::instance()->getAllocator()->allocate(allocPhys) != Allocator::Success)
+    // Threads share the MMU context and memory of their leader
+    if (m_leader)
     {
-        ERROR("failed to allocate user stack");
-        return OutOfMemory;
+        m_memoryContext = m_leader->getMemoryContext();
     }
-    range.phys = allocPhys.address;
-
-    // Map User stack
-    if (m_memoryContext->mapRangeContiguous(&range) != MemoryContext::Success) 
+    else
     {
-        ERROR("failed to map user stack");
-        return MemoryMapError;
+        // Create MMU context
+        m_memoryContext = new IntelPaging(&m_map, Kernel::instance()->getAllocator());
+        if (!m_memoryContext)
+        {
+            ERROR("failed to create memory context");
+            return OutOfMemory;
+        }
+
+        // Initialize MMU context
+        const MemoryContext::Result memResult = m_memoryContext->initialize();
+        if (memResult != MemoryContext::Success)
+        {
+            ERROR("failed to initialize MemoryContext: result = " << (int) memResult);
+            return OutOfMemory;
+        }
+
+        // Allocate User stack
+        range = m_map.range(MemoryMap::UserStack);
+        range.access = Memory::Readable | Memory::Writable | Memory::User;
+        allocPhys.address = 0;
+        allocPhys.size = range.size;
+        allocPhys.alignment = PAGESIZE;
+
+        if (Kernel::instance()->getAllocator()->allocate(allocPhys) != Allocator::Success)
+        {
+            ERROR("failed to allocate user stack");
+            return OutOfMemory;
+        }
+        range.phys = allocPhys.address;
+
+        // Map User stack
+        if (m_memoryContext->mapRangeContiguous(&range) != MemoryContext::Success) 
+        {
+            ERROR("failed to map user stack");
+            return MemoryMapError;
+        }
     }
 
     // Allocate Kernel stack
@@ -91,6 +108,11 @@ Process::Result IntelProcess::initialize()
 
 IntelProcess::~IntelProcess()
 {
+    if (fpuOwner == this)
+    {
+        fpuOwner = ZERO;
+    }
+
     // Release the kernel stack memory page
     SplitAllocator *alloc = Kernel::instance()->getAllocator();
     alloc->release((Address)alloc->toPhysical(m_kernelStackBase) - KernelStackSize);
@@ -99,10 +121,25 @@ IntelProcess::~IntelProcess()
 void IntelProcess::reset(const Address entry)
 {
     const Memory::Range range = m_map.range(MemoryMap::UserStack);
-    const Address userStack = range.virt + range.size - MEMALIGN;
+    const Address userStack = m_userStack ? m_userStack : range.virt + range.size - MEMALIGN;
     const u16 dataSel = m_privileged ? KERNEL_DS_SEL : USER_DS_SEL;
     const u16 codeSel = m_privileged ? KERNEL_CS_SEL : USER_CS_SEL;
 
+    // The program starts with a clean FPU
+    u8 *fpu = getFPUState();
+    MemoryBlock::set(m_fpuState, 0, sizeof(m_fpuState));
+    *(u16 *) fpu = FPU_CONTROL_DEFAULT;
+
+    if (IntelCore().readCR4() & CR4_OSFXSR)
+        *(u32 *) (fpu + 24) = MXCSR_DEFAULT;
+    else
+        *(u16 *) (fpu + 8) = 0xffff;
+
+    if (fpuOwner == this)
+    {
+        fpuOwner = ZERO;
+    }
+
     // Reset saved kernel stack pointer
     m_kernelStack = m_kernelStackBase - sizeof(CPUState)
                                       - sizeof(IRQRegs0)
@@ -117,6 +154,7 @@ void IntelProcess::reset(const Address entry)
     regs->seg.gs     = dataSel;
     regs->seg.es     = dataSel;
     regs->seg.ds     = dataSel;
+    regs->regs.eax   = m_userArgument;
     regs->regs.ebp   = userStack;
     regs->regs.esp0  = m_kernelStack;
     regs->irq.eip    = m_entry;
@@ -149,7 +187,54 @@ void IntelProcess::execute(Process *previous)
     // Activate the memory context of this process
     m_memoryContext->activate();
 
+    // Trap on the first FPU instruction, unless our state is still loaded
+    IntelCore core;
+    const u32 cr0 = core.readCR0();
+
+    if (fpuOwner == this)
+    {
+        if (cr0 & CR0_TS)
+            clts();
+    }
+    else if (!(cr0 & CR0_TS))
+    {
+        core.writeCR0(cr0 | CR0_TS);
+    }
+
     // Switch kernel stack (includes saved userspace registers)
     switchCoreState( p ? &p->m_kernelStack : ZERO,
                      m_kernelStack );
 }
+
+void IntelProcess::activateFPU()
+{
+    const bool fxsr = (IntelCore().readCR4() & CR4_OSFXSR) != 0;
+
+    clts();
+
+    if (fpuOwner == this)
+        return;
+
+    // Save the registers of the previous owner
+    if (fpuOwner)
+    {
+        if (fxsr)
+            asm volatile ("fxsave (%0)" :: "r" (fpuOwner->getFPUState()) : "memory");
+        else
+            asm volatile ("fnsave (%0)" :: "r" (fpuOwner->getFPUState()) : "memory");
+    }
+
+    // Restore our own registers
+    if (fxsr)
+        asm volatile ("fxrstor (%0)" :: "r" (getFPUState()) : "memory");
+    else
+        asm volatile ("frstor (%0)" :: "r" (getFPUState()) : "memory");
+
+    fpuOwner = this;
+}
+
+u8 * IntelProcess::getFPUState()
+{
+    const Address base = (Address) m_fpuState;
+    return (u8 *) ((base + FPUStateAlign - 1) & ~(FPUStateAlign - 1));
+}
@@ -42,6 +42,12 @@ class IntelProcess : public Process
     /** Size of the kernel stack */
     static const Size KernelStackSize = PAGESIZE;
 
+    /** Size of the FPU/SSE state saved by fxsave */
+    static const Size FPUStateSize = 512;
+
+    /** Required alignment of the FPU/SSE state */
+    static const Size FPUStateAlign = 16;
+
   public:
 
     /**
@@ -83,6 +89,24 @@ class IntelProcess : public Process
      */
     virtual void execute(Process *previous);
 
+    /**
+     * Give this Process access to the FPU.
+     *
+     * Called on the first FPU/SSE instruction after a context switch.
+     * Saves the FPU state of the previous owner and restores the state
+     * of this Process.
+     */
+    void activateFPU();
+
+  private:
+
+    /**
+     * Get the aligned FPU state area.
+     *
+     * @return Pointer to the FPU state
+     */
+    u8 * getFPUState();
+
   private:
 
     /** Current kernel stack address (changes during execution). */
@@ -91,6 +115,9 @@ class IntelProcess : public Process
     /** Base kernel stack (fixed) */
     Address m_kernelStackBase;
 
+    /** Saved FPU/SSE registers, in fxsave or fnsave format */
+    u8 m_fpuState[FPUStateSize + FPUStateAlign];
+
 };
 
 namespace Arch
@@ -18,6 +18,7 @@
 #include <FreeNOS/Config.h>
 #include <FreeNOS/Support.h>
 #include <FreeNOS/System.h>
+#include <FreeNOS/BootTimeline.h>
 #include <intel/IntelKernel.h>
 #include <i8250.h>
 #include <DeviceLog.h>
@@ -27,6 +28,9 @@
 
 extern C int kernel_main(CoreInfo *info)
 {
+    // Start of the boot timeline
+    BootTimeline::record(BootKernelEntry, 0, info->coreId, ZERO);
+
     // Initialize heap
     Kernel::initializeHeap();
 
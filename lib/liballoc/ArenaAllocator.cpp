@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Assert.h>
+#include "ArenaAllocator.h"
+
+ArenaAllocator::Scope::Scope(ArenaAllocator *arena, const bool makeDefault)
+    : m_arena(arena)
+    , m_mark(arena->mark())
+    , m_previous(Allocator::getDefault())
+    , m_default(makeDefault)
+{
+    if (m_default)
+    {
+        Allocator::setDefault(arena);
+    }
+}
+
+ArenaAllocator::Scope::~Scope()
+{
+    if (m_default)
+    {
+        Allocator::setDefault(m_previous);
+    }
+
+    m_arena->reset(m_mark);
+}
+
+ArenaAllocator::ArenaAllocator(Allocator *parent, const Size chunkSize)
+    : m_chunk(ZERO)
+    , m_offset(0)
+    , m_chunkSize(chunkSize)
+    , m_size(0)
+{
+    assert(parent != NULL);
+    assert(chunkSize > sizeof(Chunk));
+    setParent(parent);
+}
+
+ArenaAllocator::~ArenaAllocator()
+{
+    const Mark empty = { ZERO, 0 };
+    reset(empty);
+}
+
+Size ArenaAllocator::size() const
+{
+    return m_size;
+}
+
+Size ArenaAllocator::available() const
+{
+    return m_chunk ? m_chunk->size - m_offset : 0;
+}
+
+Allocator::Result ArenaAllocator::allocate(Allocator::Range & args)
+{
+    const Size align = args.alignment ? args.alignment : DefaultAlignment;
+
+    // Try to fit the allocation in the current chunk
+    if (m_chunk)
+    {
+        const Address start = aligned(((Address) m_chunk) + m_offset, align);
+        const Address end = ((Address) m_chunk) + m_chunk->size;
+
+        if (start <= end && args.size <= end - start)
+        {
+            args.address = start;
+            m_offset = (start + args.size) - (Address) m_chunk;
+            return Success;
+        }
+    }
+
+    // Start a new chunk which is large enough
+    Range range;
+    range.size = sizeof(Chunk) + args.size + align;
+    range.alignment = 0;
+
+    if (range.size < args.size)
+        return InvalidSize;
+    else if (range.size < m_chunkSize)
+        range.size = m_chunkSize;
+
+    if (parent()->allocate(range) != Success)
+        return OutOfMemory;
+
+    Chunk *chunk = (Chunk *) range.address;
+    chunk->prev = m_chunk;
+    chunk->size = range.size;
+
+    m_chunk  = chunk;
+    m_offset = sizeof(Chunk);
+    m_size  += chunk->size;
+
+    args.address = aligned(range.address + m_offset, align);
+    m_offset = (args.address + args.size) - range.address;
+    return Success;
+}
+
+Allocator::Result ArenaAllocator::release(const Address addr)
+{
+    for (const Chunk *chunk = m_chunk; chunk != ZERO; chunk = chunk->prev)
+    {
+        if (addr > (Address) chunk && addr < ((Address) chunk) + chunk->size)
+        {
+            return Success;
+        }
+    }
+
+    return parent()->release(addr);
+}
+
+ArenaAllocator::Mark ArenaAllocator::mark() const
+{
+    const Mark m = { m_chunk, m_offset };
+    return m;
+}
+
+void ArenaAllocator::reset(const ArenaAllocator::Mark & mark)
+{
+    // Return all chunks started after the mark
+    while (m_chunk != mark.chunk)
+    {
+        assert(m_chunk != ZERO);
+
+        Chunk *prev = m_chunk->prev;
+        m_size -= m_chunk->size;
+        parent()->release((Address) m_chunk);
+        m_chunk = prev;
+    }
+
+    m_offset = mark.offset;
+}
+
+void ArenaAllocator::reset()
+{
+    Mark first = { m_chunk, sizeof(Chunk) };
+
+    if (first.chunk == ZERO)
+    {
+        return;
+    }
+
+    while (first.chunk->prev != ZERO)
+    {
+        first.chunk = first.chunk->prev;
+    }
+
+    reset(first);
+}
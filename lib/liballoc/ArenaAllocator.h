@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBALLOC_ARENAALLOCATOR_H
+#define __LIBALLOC_ARENAALLOCATOR_H
+
+#include <Types.h>
+#include "Allocator.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup liballoc
+ * @{
+ */
+
+/**
+ * Allocates memory by incrementing a pointer inside chunks from the parent Allocator.
+ *
+ * Individual allocations are never released. Instead, all allocations made
+ * after a Mark are released at once by resetting to it, which returns the
+ * chunks allocated since then to the parent. A Scope does this automatically,
+ * and can make the ArenaAllocator the default for new() for its lifetime.
+ */
+class ArenaAllocator : public Allocator
+{
+  private:
+
+    /** Default size of a chunk in bytes */
+    static const Size DefaultChunkSize = 4096U;
+
+    /** Default alignment of allocations in bytes */
+    static const Size DefaultAlignment = sizeof(u64);
+
+    /**
+     * Header at the start of each chunk.
+     */
+    typedef struct Chunk
+    {
+        /** Previously allocated chunk */
+        Chunk *prev;
+
+        /** Size of the chunk in bytes, including this header */
+        Size size;
+    }
+    Chunk;
+
+  public:
+
+    /**
+     * Position in the ArenaAllocator to reset to.
+     */
+    typedef struct Mark
+    {
+        /** Current chunk */
+        Chunk *chunk;
+
+        /** Offset of the next allocation inside the chunk */
+        Size offset;
+    }
+    Mark;
+
+    /**
+     * Releases all allocations made during its lifetime.
+     */
+    class Scope
+    {
+      public:
+
+        /**
+         * Constructor.
+         *
+         * @param arena ArenaAllocator to allocate from.
+         * @param makeDefault True to make the ArenaAllocator the default Allocator.
+         */
+        Scope(ArenaAllocator *arena, const bool makeDefault = false);
+
+        /**
+         * Destructor.
+         *
+         * Restores the default Allocator and resets the ArenaAllocator.
+         */
+        ~Scope();
+
+      private:
+
+        /** The ArenaAllocator */
+        ArenaAllocator *m_arena;
+
+        /** Position at the start of the Scope */
+        Mark m_mark;
+
+        /** Previous default Allocator */
+        Allocator *m_previous;
+
+        /** True if the ArenaAllocator was made the default */
+        const bool m_default;
+    };
+
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param parent Allocator which provides the chunks.
+     * @param chunkSize Minimum size of each chunk in bytes.
+     */
+    ArenaAllocator(Allocator *parent, const Size chunkSize = DefaultChunkSize);
+
+    /**
+     * Destructor.
+     */
+    virtual ~ArenaAllocator();
+
+    /**
+     * Get memory size.
+     *
+     * @return Size of all chunks in bytes.
+     */
+    virtual Size size() const;
+
+    /**
+     * Get memory available.
+     *
+     * @return Bytes left in the current chunk.
+     */
+    virtual Size available() const;
+
+    /**
+     * Allocate memory.
+     *
+     * @param args Contains the requested size and alignment on input.
+     *             On output, contains the actual allocated address.
+     *
+     * @return Result value.
+     */
+    virtual Result allocate(Range & args);
+
+    /**
+     * Release memory.
+     *
+     * Memory inside the chunks is only released by reset().
+     * Other addresses are released by the parent, such that delete()
+     * of older objects works while this is the default Allocator.
+     *
+     * @param addr Points to memory previously returned by allocate().
+     *
+     * @return Result value.
+     */
+    virtual Result release(const Address addr);
+
+    /**
+     * Get the current position.
+     *
+     * @return Mark to pass to reset().
+     */
+    Mark mark() const;
+
+    /**
+     * Release all allocations made after the given position.
+     *
+     * @param mark Position previously returned by mark().
+     */
+    void reset(const Mark & mark);
+
+    /**
+     * Release all allocations.
+     *
+     * The first chunk is kept for reuse.
+     */
+    void reset();
+
+  private:
+
+    /** Current chunk or ZERO if none */
+    Chunk *m_chunk;
+
+    /** Offset of the next allocation inside the current chunk */
+    Size m_offset;
+
+    /** Minimum size of each chunk */
+    const Size m_chunkSize;
+
+    /** Total size of all chunks */
+    Size m_size;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBALLOC_ARENAALLOCATOR_H */
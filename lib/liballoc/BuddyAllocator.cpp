@@ -0,0 +1,341 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Assert.h>
+#include <MemoryBlock.h>
+#include "BuddyAllocator.h"
+
+/**
+ * Get the position of the lowest set bit.
+ *
+ * @param value Non-zero input value
+ *
+ * @return Bit position
+ */
+static inline Size lowestBit(const u32 value)
+{
+    return __builtin_ctz(value);
+}
+
+BuddyAllocator::BuddyAllocator(const Allocator::Range range,
+                               const Size chunkSize)
+    : Allocator(range)
+    , m_chunkSize(chunkSize)
+    , m_chunks(range.size / chunkSize)
+    , m_bitmap(ZERO)
+{
+    Size words = 0;
+
+    // Calculate the size of all bitmaps
+    for (Size order = 0; order <= MaximumOrder; order++)
+    {
+        const Size freeWords = ((m_chunks >> order) + 31) / 32;
+
+        m_summaryWords[order] = (freeWords + 31) / 32;
+        words += freeWords + m_summaryWords[order];
+    }
+
+    m_bitmap = new u32[words];
+    MemoryBlock::set(m_bitmap, 0, words * sizeof(u32));
+
+    // Divide the storage over the orders
+    u32 *ptr = m_bitmap;
+
+    for (Size order = 0; order <= MaximumOrder; order++)
+    {
+        m_free[order] = ptr;
+        ptr += ((m_chunks >> order) + 31) / 32;
+        m_summary[order] = ptr;
+        ptr += m_summaryWords[order];
+        m_hint[order] = 0;
+        m_count[order] = 0;
+    }
+
+    // All memory is free initially
+    insertRange(0, m_chunks);
+}
+
+BuddyAllocator::~BuddyAllocator()
+{
+    delete[] m_bitmap;
+}
+
+Size BuddyAllocator::chunkSize() const
+{
+    return m_chunkSize;
+}
+
+Size BuddyAllocator::available() const
+{
+    Size chunks = 0;
+
+    for (Size order = 0; order <= MaximumOrder; order++)
+        chunks += m_count[order] << order;
+
+    return chunks * m_chunkSize;
+}
+
+Size BuddyAllocator::freeBlocks(const Size order) const
+{
+    return order <= MaximumOrder ? m_count[order] : 0;
+}
+
+Allocator::Result BuddyAllocator::allocate(Allocator::Range & args)
+{
+    Size count = args.size / m_chunkSize;
+    Size alignment = 1, order = 0, index = 0;
+
+    if ((args.size % m_chunkSize) || !count)
+        count++;
+
+    if (args.alignment)
+    {
+        if (args.alignment % m_chunkSize)
+            return InvalidAlignment;
+
+        alignment = args.alignment / m_chunkSize;
+
+        if (alignment & (alignment - 1))
+            return InvalidAlignment;
+    }
+
+    // Find the smallest order which fits both size and alignment
+    while (order <= MaximumOrder && ((1U << order) < count || (1U << order) < alignment))
+        order++;
+
+    if (order > MaximumOrder)
+    {
+        const Result result = allocateLarge(count, alignment, &index);
+        if (result != Success)
+            return result;
+    }
+    else
+    {
+        Size current = order;
+
+        while (current <= MaximumOrder && !findBlock(current, &index))
+            current++;
+
+        if (current > MaximumOrder)
+            return OutOfMemory;
+
+        removeBlock(index, current);
+
+        // Split the block down to the requested order
+        while (current > order)
+        {
+            current--;
+            insertBlock(index + (1U << current), current);
+        }
+
+        // Return the unused tail of the block
+        if (count < (1U << order))
+            insertRange(index + count, (1U << order) - count);
+    }
+
+    args.address = base() + (index * m_chunkSize);
+    assert(isAllocated(args.address));
+    return Success;
+}
+
+Allocator::Result BuddyAllocator::allocateLarge(const Size count,
+                                                const Size alignment,
+                                                Size *index)
+{
+    const Size blockSize = 1U << MaximumOrder;
+    const Size blocks = (count + blockSize - 1) / blockSize;
+    const Size step = alignment > blockSize ? alignment / blockSize : 1;
+    const Size total = m_chunks >> MaximumOrder;
+
+    // Search for consecutive free blocks of the maximum order
+    for (Size first = 0; first + blocks <= total; first += step)
+    {
+        Size found = 0;
+
+        while (found < blocks && isFreeBlock((first + found) << MaximumOrder, MaximumOrder))
+            found++;
+
+        if (found == blocks)
+        {
+            for (Size i = 0; i < blocks; i++)
+                removeBlock((first + i) << MaximumOrder, MaximumOrder);
+
+            *index = first << MaximumOrder;
+
+            // Return the unused tail of the last block
+            if (count < blocks * blockSize)
+                insertRange(*index + count, (blocks * blockSize) - count);
+
+            return Success;
+        }
+    }
+
+    return OutOfMemory;
+}
+
+Allocator::Result BuddyAllocator::allocateAt(const Address addr)
+{
+    assert(!isAllocated(addr));
+
+    const Size target = (addr - base()) / m_chunkSize;
+
+    // Find the free block which contains the chunk
+    for (Size order = 0; order <= MaximumOrder; order++)
+    {
+        Size index = target & ~((1U << order) - 1);
+
+        if (isFreeBlock(index, order))
+        {
+            removeBlock(index, order);
+
+            // Split down to the single chunk, keeping the other halves free
+            while (order > 0)
+            {
+                order--;
+                const Size half = 1U << order;
+
+                if (target >= index + half)
+                {
+                    insertBlock(index, order);
+                    index += half;
+                }
+                else
+                    insertBlock(index + half, order);
+            }
+            return Success;
+        }
+    }
+
+    return InvalidAddress;
+}
+
+bool BuddyAllocator::isAllocated(const Address chunk) const
+{
+    assert(chunk >= base());
+    assert(chunk < base() + size());
+    assert(((chunk - base()) % m_chunkSize) == 0);
+
+    const Size target = (chunk - base()) / m_chunkSize;
+
+    for (Size order = 0; order <= MaximumOrder; order++)
+    {
+        if (isFreeBlock(target & ~((1U << order) - 1), order))
+            return false;
+    }
+
+    return true;
+}
+
+Allocator::Result BuddyAllocator::release(const Address chunk)
+{
+    if (!isAllocated(chunk))
+        return InvalidAddress;
+
+    Size index = (chunk - base()) / m_chunkSize;
+    Size order = 0;
+
+    // Coalesce with free buddy blocks
+    while (order < MaximumOrder)
+    {
+        const Size buddy = index ^ (1U << order);
+
+        if (!isFreeBlock(buddy, order))
+            break;
+
+        removeBlock(buddy, order);
+        index &= ~(1U << order);
+        order++;
+    }
+
+    insertBlock(index, order);
+    return Success;
+}
+
+void BuddyAllocator::insertRange(Size index, const Size count)
+{
+    const Size end = index + count;
+
+    while (index < end)
+    {
+        Size order = MaximumOrder;
+
+        // Use the largest aligned block which fits
+        while (order > 0 && ((index & ((1U << order) - 1)) || index + (1U << order) > end))
+            order--;
+
+        insertBlock(index, order);
+        index += 1U << order;
+    }
+}
+
+void BuddyAllocator::insertBlock(const Size index, const Size order)
+{
+    const Size bit = index >> order;
+    const Size word = bit / 32;
+
+    m_free[order][word] |= 1U << (bit % 32);
+    m_summary[order][word / 32] |= 1U << (word % 32);
+    m_count[order]++;
+
+    if (word / 32 < m_hint[order])
+        m_hint[order] = word / 32;
+}
+
+void BuddyAllocator::removeBlock(const Size index, const Size order)
+{
+    const Size bit = index >> order;
+    const Size word = bit / 32;
+
+    m_free[order][word] &= ~(1U << (bit % 32));
+    m_count[order]--;
+
+    if (!m_free[order][word])
+        m_summary[order][word / 32] &= ~(1U << (word % 32));
+}
+
+bool BuddyAllocator::isFreeBlock(const Size index, const Size order) const
+{
+    const Size bit = index >> order;
+
+    if (index + (1U << order) > m_chunks)
+        return false;
+
+    return m_free[order][bit / 32] & (1U << (bit % 32));
+}
+
+bool BuddyAllocator::findBlock(const Size order, Size *index)
+{
+    if (!m_count[order])
+        return false;
+
+    for (Size i = m_hint[order]; i < m_summaryWords[order]; i++)
+    {
+        const u32 summary = m_summary[order][i];
+
+        if (summary)
+        {
+            const Size word = (i * 32) + lowestBit(summary);
+            const Size bit = (word * 32) + lowestBit(m_free[order][word]);
+
+            m_hint[order] = i;
+            *index = bit << order;
+            return true;
+        }
+    }
+
+    return false;
+}
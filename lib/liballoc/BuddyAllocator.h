@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBALLOC_BUDDYALLOCATOR_H
+#define __LIBALLOC_BUDDYALLOCATOR_H
+
+#include <Types.h>
+#include "Allocator.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup liballoc
+ * @{
+ */
+
+/**
+ * Binary buddy memory allocator.
+ *
+ * All memory is divided in same sized chunks, which are grouped in
+ * free blocks of 2^order chunks. Each order has a bitmap of its free blocks
+ * and a summary bitmap of its non-empty bitmap words, which keeps
+ * allocating and releasing at a logarithmic cost.
+ *
+ * Allocations are rounded up to a block, and the unused tail of the
+ * block is returned directly. Allocated chunks are released one-by-one
+ * and coalesced with their free buddy blocks into larger free blocks.
+ */
+class BuddyAllocator : public Allocator
+{
+  public:
+
+    /** Largest order of a free block, in chunks (1 << order) */
+    static const Size MaximumOrder = 10;
+
+  public:
+
+    /**
+     * Constructor function.
+     *
+     * @param range Block of continguous memory to manage.
+     * @param chunkSize The input memory range will be divided into equally sized chunks.
+     *                  The chunkSize must be greater than zero.
+     */
+    BuddyAllocator(const Range range,
+                   const Size chunkSize);
+
+    /**
+     * Destructor.
+     */
+    virtual ~BuddyAllocator();
+
+    /**
+     * Get chunk size.
+     *
+     * @return Chunk size.
+     */
+    Size chunkSize() const;
+
+    /**
+     * Get available memory.
+     *
+     * @return Available memory.
+     */
+    virtual Size available() const;
+
+    /**
+     * Get number of free blocks of an order.
+     *
+     * @param order Block order, up to MaximumOrder.
+     *
+     * @return Number of free blocks of 2^order chunks.
+     */
+    Size freeBlocks(const Size order) const;
+
+    /**
+     * Allocate memory.
+     *
+     * @param args Contains the requested size and alignment on input.
+     *             The alignment value must be a power of two multiple of the chunk size.
+     *             On output, contains the actual allocated address.
+     *
+     * @return Result value.
+     */
+    virtual Result allocate(Range & args);
+
+    /**
+     * Allocate a specific address.
+     *
+     * @param addr Allocate a specific address.
+     *
+     * @return Result value.
+     */
+    Result allocateAt(const Address addr);
+
+    /**
+     * Check if a chunk is allocated.
+     *
+     * @return True if allocated, false otherwise.
+     */
+    bool isAllocated(const Address chunk) const;
+
+    /**
+     * Release memory chunk.
+     *
+     * @param chunk The memory chunk to release.
+     *
+     * @return Result value.
+     */
+    virtual Result release(const Address chunk);
+
+  private:
+
+    /**
+     * Allocate consecutive blocks of the maximum order.
+     *
+     * @param count Number of chunks to allocate.
+     * @param alignment Alignment in chunks.
+     * @param index Index of the first allocated chunk on output.
+     *
+     * @return Result value.
+     */
+    Result allocateLarge(const Size count, const Size alignment, Size *index);
+
+    /**
+     * Mark a range of chunks free without coalescing.
+     *
+     * @param index Index of the first chunk.
+     * @param count Number of chunks.
+     */
+    void insertRange(Size index, const Size count);
+
+    /**
+     * Add a free block.
+     *
+     * @param index Index of the first chunk in the block.
+     * @param order Block order.
+     */
+    void insertBlock(const Size index, const Size order);
+
+    /**
+     * Remove a free block.
+     *
+     * @param index Index of the first chunk in the block.
+     * @param order Block order.
+     */
+    void removeBlock(const Size index, const Size order);
+
+    /**
+     * Check if a block is free.
+     *
+     * @param index Index of the first chunk in the block.
+     * @param order Block order.
+     *
+     * @return True if the block is free and fits in the memory range.
+     */
+    bool isFreeBlock(const Size index, const Size order) const;
+
+    /**
+     * Find the lowest free block of an order.
+     *
+     * @param order Block order.
+     * @param index Index of the first chunk in the block on output.
+     *
+     * @return True if found, false otherwise.
+     */
+    bool findBlock(const Size order, Size *index);
+
+  private:
+
+    /** Size of each chunk. */
+    const Size m_chunkSize;
+
+    /** Total number of chunks. */
+    const Size m_chunks;
+
+    /** Storage for all bitmaps. */
+    u32 *m_bitmap;
+
+    /** Bitmap of free blocks per order. */
+    u32 *m_free[MaximumOrder + 1];
+
+    /** Bitmap of non-zero words in the free blocks bitmap per order. */
+    u32 *m_summary[MaximumOrder + 1];
+
+    /** Number of words in the summary bitmap per order. */
+    Size m_summaryWords[MaximumOrder + 1];
+
+    /** Lowest summary word which may be non-zero per order. */
+    Size m_hint[MaximumOrder + 1];
+
+    /** Number of free blocks per order. */
+    Size m_count[MaximumOrder + 1];
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBALLOC_BUDDYALLOCATOR_H */
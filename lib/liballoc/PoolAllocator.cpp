@@ -25,6 +25,7 @@ PoolAllocator::PoolAllocator(Allocator *parent)
     assert(parent != NULL);
     setParent(parent);
     MemoryBlock::set(m_pools, 0, sizeof(m_pools));
+    MemoryBlock::set(m_magazines, 0, sizeof(m_magazines));
 }
 
 Size PoolAllocator::size() const
@@ -80,6 +81,7 @@ void PoolAllocator::calculateUsage(Size & totalSize, Size & totalUsed) const
             totalUsed += sizeof(Pool);
             totalUsed += pool->bitmapSize;
             totalUsed += (pool->size() - pool->available());
+            totalUsed -= (pool->cached * pool->chunkSize());
         }
     }
 }
@@ -87,6 +89,7 @@ void PoolAllocator::calculateUsage(Size & totalSize, Size & totalUsed) const
 Allocator::Result PoolAllocator::allocate(Allocator::Range & args)
 {
     const Size inputSize = aligned(args.size, sizeof(u32));
+    const Size index = calculatePoolIndex(inputSize);
     Pool *pool = ZERO;
 
     // Verify input arguments
@@ -98,9 +101,29 @@ Allocator::Result PoolAllocator::allocate(Allocator::Range & args)
     {
         return InvalidSize;
     }
+    else if (index > MaximumPoolSize)
+    {
+        args.address = 0;
+        return OutOfMemory;
+    }
+
+    // Try to re-use a released object from the magazine
+    Magazine & magazine = m_magazines[index];
+    if (magazine.count > 0)
+    {
+        const Address actualAddr = magazine.objects[--magazine.count];
+        const ObjectPrefix *prefix = (const ObjectPrefix *) actualAddr;
+
+        assert(prefix->signature == ObjectSignature);
+        assert(prefix->pool->cached > 0);
+        prefix->pool->cached--;
+
+        args.address = actualAddr + sizeof(ObjectPrefix);
+        return Success;
+    }
 
     // Find the proper pool first
-    pool = retrievePool(inputSize);
+    pool = retrievePool(index);
 
     // Attempt to allocate
     if (pool)
@@ -112,7 +135,7 @@ Allocator::Result PoolAllocator::allocate(Allocator::Range & args)
             prefix->signature = ObjectSignature;
             prefix->pool = pool;
 
-            ObjectPostfix *postfix = (ObjectPostfix *) (args.address + sizeof(ObjectPrefix) + inputSize);
+            ObjectPostfix *postfix = (ObjectPostfix *) (args.address + pool->chunkSize() - sizeof(ObjectPostfix));
             postfix->signature = ObjectSignature;
 
             args.address += sizeof(ObjectPrefix);
@@ -131,58 +154,114 @@ Allocator::Result PoolAllocator::release(const Address addr)
 {
     const Address actualAddr = addr - sizeof(ObjectPrefix);
     const ObjectPrefix *prefix = (const ObjectPrefix *) (actualAddr);
-    ObjectPostfix *postfix = ZERO;
 
     // Verify the object prefix signature
     assert(prefix->signature == ObjectSignature);
     assert(prefix->pool != NULL);
 
-    // Do a reverse memory scan to find the object postfix.
-    for (Size i = prefix->pool->chunkSize() - sizeof(u32); i > sizeof(ObjectPrefix); i -= sizeof(u32))
-    {
-        postfix = (ObjectPostfix *)(actualAddr + i);
-        if (postfix->signature == ObjectSignature)
-            break;
-    }
+    Pool *pool = prefix->pool;
+    Magazine & magazine = m_magazines[pool->index];
 
     // Verify the object postfix signature
-    assert(postfix != ZERO);
+    const ObjectPostfix *postfix = (const ObjectPostfix *) (actualAddr + pool->chunkSize() - sizeof(ObjectPostfix));
     assert(postfix->signature == ObjectSignature);
 
-    // Release the object
-    Result result = prefix->pool->release(actualAddr);
-    assert(result == Success);
+    // Give the pool back to the parent if this was its last object in use
+    if (pool->available() + ((pool->cached + 1) * pool->chunkSize()) == pool->size())
+    {
+        drainMagazine(pool);
+
+        Result result = pool->release(actualAddr);
+        assert(result == Success);
 
-    // Also try to release the pool itself, if no longer used
-    if (prefix->pool->available() == prefix->pool->size())
+        releasePool(pool);
+        return result;
+    }
+    // Keep the object in the magazine for re-use
+    else if (magazine.count < MagazineSize)
     {
-        releasePool(prefix->pool);
+        magazine.objects[magazine.count++] = actualAddr;
+        pool->cached++;
+        return Success;
     }
+    // Release the object to the pool
+    else
+    {
+        Result result = pool->release(actualAddr);
+        assert(result == Success);
+        return result;
+    }
+}
 
-    return result;
+Size PoolAllocator::sizeClass(const Size size) const
+{
+    return calculatePoolIndex(aligned(size, sizeof(u32)));
 }
 
-PoolAllocator::Pool * PoolAllocator::retrievePool(const Size inputSize)
+Size PoolAllocator::objectClass(const Address addr) const
 {
-    const Size requestedSize = inputSize + sizeof(ObjectPrefix) + sizeof(ObjectPostfix);
-    Size index, nPools = 1, objectSize = 0;
-    Pool *pool = ZERO;
+    const ObjectPrefix *prefix = (const ObjectPrefix *) (addr - sizeof(ObjectPrefix));
 
-    // Find the correct pool index
-    for (index = MinimumPoolSize; index <= MaximumPoolSize; index++)
+    assert(prefix->signature == ObjectSignature);
+    return prefix->pool->index;
+}
+
+void PoolAllocator::poolUsage(const Size index, Size & pools, Size & bytes) const
+{
+    pools = 0;
+    bytes = 0;
+
+    for (const Pool *pool = m_pools[index]; pool != NULL; pool = pool->next)
     {
-        objectSize = calculateObjectSize(index);
+        pools++;
+        bytes += sizeof(Pool) + pool->bitmapSize + pool->size();
+    }
+}
 
-        if (requestedSize <= objectSize)
-            break;
+void PoolAllocator::drainMagazine(Pool *pool)
+{
+    Magazine & magazine = m_magazines[pool->index];
+    Size i = 0;
+
+    while (pool->cached > 0 && i < magazine.count)
+    {
+        const ObjectPrefix *prefix = (const ObjectPrefix *) magazine.objects[i];
+
+        if (prefix->pool == pool)
+        {
+            pool->release(magazine.objects[i]);
+            magazine.objects[i] = magazine.objects[--magazine.count];
+            pool->cached--;
+        }
+        else
+        {
+            i++;
+        }
     }
 
-    // Handle too large object requests
-    if (requestedSize > objectSize)
+    assert(pool->cached == 0);
+}
+
+Size PoolAllocator::calculatePoolIndex(const Size inputSize) const
+{
+    const Size requestedSize = inputSize + sizeof(ObjectPrefix) + sizeof(ObjectPostfix);
+    Size index;
+
+    for (index = MinimumPoolSize; index <= MaximumPoolSize; index++)
     {
-        return ZERO;
+        if (requestedSize <= calculateObjectSize(index))
+            break;
     }
 
+    return index;
+}
+
+PoolAllocator::Pool * PoolAllocator::retrievePool(const Size index)
+{
+    const Size objectSize = calculateObjectSize(index);
+    Size nPools = 1;
+    Pool *pool = ZERO;
+
     // Do we need to allocate an initial pool?
     if (!m_pools[index])
     {
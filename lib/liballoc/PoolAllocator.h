@@ -37,14 +37,15 @@
  * Allocates memory from pools each having the size of a power of two.
  * Each pool is pre-allocated and has a bitmap representing free blocks.
  *
- * @todo While this Allocator works well, its performance can be improved. The BitAllocator
- *       contains a BitArray that scans its internal array for "free bits". If the caller
- *       is unfortunate, the whole array needs to be scanned, adding overhead. The Linux kernel
- *       uses a buddy allocator, that basically combines a bit array and a linked list for optimal performance.
+ * Released objects are first kept in a per-size magazine, which is a small
+ * stack of free objects. Allocations are served from the magazine when possible,
+ * such that both allocate and release are O(1) in the common case. The pool bitmaps
+ * are only used when the magazine is empty on allocate or full on release, or when
+ * a pool becomes completely unused and is given back to the parent Allocator.
  */
 class PoolAllocator : public Allocator
 {
-  private:
+  public:
 
     /** Minimum power of two for a pool size. */
     static const Size MinimumPoolSize = 2;
@@ -52,9 +53,14 @@ class PoolAllocator : public Allocator
     /** Maximum power of two size a pool can be (128MiB). */
     static const Size MaximumPoolSize = 27;
 
+  private:
+
     /** Signature value is used to detect object corruption/overflows */
     static const u32 ObjectSignature = 0xF7312A56;
 
+    /** Maximum number of free objects cached per pool size. */
+    static const Size MagazineSize = 16;
+
     /**
      * Allocates same-sized objects from a contiguous block of memory.
      */
@@ -68,6 +74,7 @@ class PoolAllocator : public Allocator
         , prev(ZERO)
         , next(ZERO)
         , index(0)
+        , cached(0)
         , bitmapSize(bitmapSize)
         {
         }
@@ -75,9 +82,19 @@ class PoolAllocator : public Allocator
         Pool *prev;            /**< Points to the previous pool of this size (if any). */
         Pool *next;            /**< Points to the next pool of this size (if any). */
         Size index;            /**< Index number in the m_pools array where this Pool is stored. */
+        Size cached;           /**< Number of free objects of this Pool stored in the magazine. */
         const Size bitmapSize; /**< Size in bytes of the bitmap array. */
     } Pool;
 
+    /**
+     * Stack of released objects which are still marked allocated in their Pool.
+     */
+    typedef struct Magazine
+    {
+        Size count;                      /**< Number of objects in the magazine. */
+        Address objects[MagazineSize];   /**< Object addresses, including the ObjectPrefix. */
+    } Magazine;
+
     /**
      * This data structure is prepended in memory before each object
      */
@@ -88,7 +105,7 @@ class PoolAllocator : public Allocator
     } ObjectPrefix;
 
     /**
-     * Appended in memory after each object
+     * Stored in memory at the end of each object chunk
      */
     typedef struct ObjectPostfix
     {
@@ -139,6 +156,34 @@ class PoolAllocator : public Allocator
      */
     virtual Result release(const Address addr);
 
+    /**
+     * Get the size class of an allocation.
+     *
+     * @param size Requested size of the object in bytes
+     *
+     * @return Pool index, which is the power of two of the object size
+     *         including its administration, or a value above MaximumPoolSize if too large.
+     */
+    Size sizeClass(const Size size) const;
+
+    /**
+     * Get the size class of an allocated object.
+     *
+     * @param addr Points to memory previously returned by allocate().
+     *
+     * @return Pool index of the object
+     */
+    Size objectClass(const Address addr) const;
+
+    /**
+     * Get the pools of a size class.
+     *
+     * @param index Pool index
+     * @param pools Receives the number of pools
+     * @param bytes Receives the bytes owned by the pools, including their administration
+     */
+    void poolUsage(const Size index, Size & pools, Size & bytes) const;
+
   private:
 
     /**
@@ -168,13 +213,22 @@ class PoolAllocator : public Allocator
     void calculateUsage(Size & totalSize, Size & totalUsed) const;
 
     /**
-     * Find a Pool of sufficient size.
+     * Calculate the Pool index for an object.
      *
      * @param inputSize Requested size of object to store
      *
+     * @return Index number in m_pools or a value above MaximumPoolSize if too large.
+     */
+    Size calculatePoolIndex(const Size inputSize) const;
+
+    /**
+     * Find a Pool with free space.
+     *
+     * @param index Index number in m_pools
+     *
      * @return Pool object pointer on success or NULL on failure.
      */
-    Pool * retrievePool(const Size inputSize);
+    Pool * retrievePool(const Size index);
 
     /**
      * Creates a new Pool instance.
@@ -195,10 +249,20 @@ class PoolAllocator : public Allocator
      */
     Result releasePool(Pool *pool);
 
+    /**
+     * Move all objects of a Pool from the magazine back to the Pool.
+     *
+     * @param pool Pool object pointer
+     */
+    void drainMagazine(Pool *pool);
+
   private:
 
     /** Array of memory pools. Index represents the power of two. */
     Pool *m_pools[MaximumPoolSize + 1];
+
+    /** Magazines with free objects for each pool index. */
+    Magazine m_magazines[MaximumPoolSize + 1];
 };
 
 /**
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Assert.h>
+#include <MemoryBlock.h>
+#include "ProfileAllocator.h"
+
+ProfileAllocator::ProfileAllocator(PoolAllocator *parent,
+                                   ProfileAllocator::Profile *profile,
+                                   const Size sampleInterval)
+    : m_pool(parent)
+    , m_profile(profile)
+{
+    assert(parent != NULL);
+    assert(sampleInterval > 0);
+    setParent(parent);
+
+    MemoryBlock::set(m_profile, 0, sizeof(*m_profile));
+    m_profile->sampleInterval = sampleInterval;
+    m_profile->signature = ProfileSignature;
+}
+
+Size ProfileAllocator::size() const
+{
+    return m_pool->size();
+}
+
+const ProfileAllocator::Profile & ProfileAllocator::profile() const
+{
+    return *m_profile;
+}
+
+Allocator::Result ProfileAllocator::allocate(Allocator::Range & args)
+{
+    const Size requested = args.size;
+    const Size index = m_pool->sizeClass(requested);
+    const Result result = m_pool->allocate(args);
+
+    if (result != Success)
+    {
+        m_profile->failures++;
+        return result;
+    }
+
+    const Size objectSize = 1U << index;
+    SizeClass & sizeClass = m_profile->classes[index];
+
+    sizeClass.allocations++;
+    sizeClass.currentBytes += objectSize;
+    if (sizeClass.currentBytes > sizeClass.peakBytes)
+        sizeClass.peakBytes = sizeClass.currentBytes;
+
+    m_profile->allocations++;
+    m_profile->requestedBytes += requested;
+    m_profile->allocatedBytes += objectSize;
+    m_profile->currentBytes += objectSize;
+    if (m_profile->currentBytes > m_profile->peakBytes)
+        m_profile->peakBytes = m_profile->currentBytes;
+
+    // The return address is only valid in this function itself
+    if (m_profile->allocations % m_profile->sampleInterval == 0)
+        sample((Address) __builtin_return_address(0), requested);
+
+    return Success;
+}
+
+Allocator::Result ProfileAllocator::release(const Address addr)
+{
+    // The object administration is gone after releasing
+    const Size index = m_pool->objectClass(addr);
+    const Result result = m_pool->release(addr);
+
+    if (result == Success)
+    {
+        const Size objectSize = 1U << index;
+        SizeClass & sizeClass = m_profile->classes[index];
+
+        sizeClass.releases++;
+        sizeClass.currentBytes -= objectSize;
+        m_profile->releases++;
+        m_profile->currentBytes -= objectSize;
+    }
+
+    return result;
+}
+
+void ProfileAllocator::sample(const Address site, const Size size)
+{
+    Sample & s = m_profile->recent[m_profile->samples % MaximumSamples];
+
+    s.site = site;
+    s.size = size;
+    m_profile->samples++;
+
+    for (Size i = PoolAllocator::MinimumPoolSize; i < SizeClasses; i++)
+    {
+        SizeClass & sizeClass = m_profile->classes[i];
+        m_pool->poolUsage(i, sizeClass.pools, sizeClass.poolBytes);
+    }
+}
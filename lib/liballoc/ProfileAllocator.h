@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBALLOC_PROFILEALLOCATOR_H
+#define __LIBALLOC_PROFILEALLOCATOR_H
+
+#include <Types.h>
+#include <Macros.h>
+#include "Allocator.h"
+#include "PoolAllocator.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup liballoc
+ * @{
+ */
+
+/**
+ * Records heap usage statistics of a PoolAllocator.
+ *
+ * Forwards all allocations to the PoolAllocator and counts them per size
+ * class, together with the current and peak number of bytes in use. Every
+ * n-th allocation is sampled: the return address of its caller is recorded
+ * as the allocation site and the pool usage of each size class is refreshed.
+ *
+ * The statistics are kept in a Profile, which is plain data such that
+ * other processes can read it. Byte counts are in object sizes, which
+ * include the administration of the PoolAllocator.
+ */
+class ProfileAllocator : public Allocator
+{
+  public:
+
+    /** Identifies a valid Profile */
+    static const u32 ProfileSignature = 0x46525048;
+
+    /** Number of size classes, indexed by the power of two object size */
+    static const Size SizeClasses = PoolAllocator::MaximumPoolSize + 1;
+
+    /** Number of most recent allocation samples kept */
+    static const Size MaximumSamples = 64;
+
+    /** Default number of allocations per sample */
+    static const Size DefaultSampleInterval = 32;
+
+    /**
+     * Statistics of a single size class.
+     */
+    typedef struct SizeClass
+    {
+        u32 allocations;   /**< Number of successful allocations */
+        u32 releases;      /**< Number of released objects */
+        Size currentBytes; /**< Bytes of objects in use */
+        Size peakBytes;    /**< Highest value of currentBytes */
+        Size pools;        /**< Number of pools at the last sample */
+        Size poolBytes;    /**< Bytes owned by the pools at the last sample */
+    }
+    SizeClass;
+
+    /**
+     * Sampled allocation.
+     */
+    typedef struct Sample
+    {
+        Address site;      /**< Return address of the caller of allocate() */
+        Size size;         /**< Requested size in bytes */
+    }
+    Sample;
+
+    /**
+     * Heap usage statistics.
+     */
+    typedef struct Profile
+    {
+        u32 signature;                       /**< Set to ProfileSignature */
+        u32 sampleInterval;                  /**< Number of allocations per sample */
+        u32 allocations;                     /**< Number of successful allocations */
+        u32 releases;                        /**< Number of released objects */
+        u32 failures;                        /**< Number of failed allocations */
+        u32 samples;                         /**< Number of samples taken */
+        u64 requestedBytes;                  /**< Sum of all requested sizes */
+        u64 allocatedBytes;                  /**< Sum of all allocated object sizes */
+        Size currentBytes;                   /**< Bytes of objects in use */
+        Size peakBytes;                      /**< Highest value of currentBytes */
+        SizeClass classes[SizeClasses];      /**< Statistics per size class */
+        Sample recent[MaximumSamples];       /**< Ring of the most recent samples */
+    }
+    Profile;
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param parent PoolAllocator to profile
+     * @param profile Memory to store the statistics
+     * @param sampleInterval Number of allocations per sample
+     */
+    ProfileAllocator(PoolAllocator *parent,
+                     Profile *profile,
+                     const Size sampleInterval = DefaultSampleInterval);
+
+    /**
+     * Get memory size.
+     *
+     * @return Size of memory owned by the parent.
+     */
+    virtual Size size() const;
+
+    /**
+     * Get the statistics.
+     *
+     * @return Profile reference
+     */
+    const Profile & profile() const;
+
+    /**
+     * Allocate memory.
+     *
+     * @param args Contains the requested size and alignment on input.
+     *             On output, contains the actual allocated address.
+     *
+     * @return Result value.
+     */
+    virtual Result allocate(Range & args);
+
+    /**
+     * Release memory.
+     *
+     * @param addr Points to memory previously returned by allocate().
+     *
+     * @return Result value.
+     */
+    virtual Result release(const Address addr);
+
+  private:
+
+    /**
+     * Take a sample of an allocation and refresh the pool usage.
+     *
+     * @param site Return address of the caller of allocate()
+     * @param size Requested size in bytes
+     */
+    void sample(const Address site, const Size size);
+
+  private:
+
+    /** The profiled allocator */
+    PoolAllocator *m_pool;
+
+    /** Statistics */
+    Profile *m_profile;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBALLOC_PROFILEALLOCATOR_H */
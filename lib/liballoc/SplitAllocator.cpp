@@ -15,6 +15,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <MemoryBlock.h>
 #include "SplitAllocator.h"
 
 SplitAllocator::SplitAllocator(const Allocator::Range physRange,
@@ -24,17 +25,32 @@ SplitAllocator::SplitAllocator(const Allocator::Range physRange,
     , m_alloc(physRange, pageSize)
     , m_virtRange(virtRange)
     , m_pageSize(pageSize)
+    , m_zeroCount(0)
+    , m_zeroHits(0)
+    , m_zeroMisses(0)
+    , m_sharedCount(0)
 {
+    for (Size i = 0; i < MaximumSharedPages; i++)
+        m_sharedRefs[i] = 0;
 }
 
 Size SplitAllocator::available() const
 {
-    return m_alloc.available();
+    return m_alloc.available() + (m_zeroCount * m_pageSize);
 }
 
 Allocator::Result SplitAllocator::allocate(Allocator::Range & args)
 {
-    return m_alloc.allocate(args);
+    Result r = m_alloc.allocate(args);
+
+    // Give the pre-zeroed pages back before reporting out of memory
+    if (r != Success && m_zeroCount > 0)
+    {
+        releaseZeroed();
+        r = m_alloc.allocate(args);
+    }
+
+    return r;
 }
 
 Allocator::Result SplitAllocator::allocateSparse(const Allocator::Range & args,
@@ -42,6 +58,9 @@ Allocator::Result SplitAllocator::allocateSparse(const Allocator::Range & args,
 {
     const Size allocSize = m_pageSize * 8U;
 
+    if (args.size > m_alloc.available())
+        releaseZeroed();
+
     if (args.size > m_alloc.available())
     {
         return OutOfMemory;
@@ -69,7 +88,7 @@ Allocator::Result SplitAllocator::allocateSparse(const Allocator::Range & args,
 Allocator::Result SplitAllocator::allocate(Allocator::Range & phys,
                                            Allocator::Range & virt)
 {
-    Result r = m_alloc.allocate(phys);
+    Result r = SplitAllocator::allocate(phys);
 
     if (r == Success)
     {
@@ -81,25 +100,170 @@ Allocator::Result SplitAllocator::allocate(Allocator::Range & phys,
     return r;
 }
 
+Allocator::Result SplitAllocator::allocateZeroed(Allocator::Range & phys,
+                                                 Allocator::Range & virt)
+{
+    if (m_zeroCount > 0 && phys.size <= m_pageSize && phys.alignment <= m_pageSize)
+    {
+        phys.address   = m_zeroPool[--m_zeroCount];
+        phys.size      = m_pageSize;
+        phys.alignment = m_pageSize;
+        virt.address   = toVirtual(phys.address);
+        virt.size      = phys.size;
+        virt.alignment = phys.alignment;
+        m_zeroHits++;
+        return Success;
+    }
+
+    const Result r = allocate(phys, virt);
+    if (r == Success)
+    {
+        MemoryBlock::set((void *) virt.address, 0, phys.size);
+        m_zeroMisses++;
+    }
+
+    return r;
+}
+
+Size SplitAllocator::fillZeroed(const Size count)
+{
+    Size added = 0;
+
+    while (added < count && m_zeroCount < ZeroPoolSize)
+    {
+        Range phys;
+        phys.address = 0;
+        phys.size = m_pageSize;
+        phys.alignment = m_pageSize;
+
+        if (m_alloc.allocate(phys) != Success)
+            break;
+
+        MemoryBlock::set((void *) toVirtual(phys.address), 0, m_pageSize);
+        m_zeroPool[m_zeroCount++] = phys.address;
+        added++;
+    }
+
+    return added;
+}
+
+void SplitAllocator::releaseZeroed()
+{
+    while (m_zeroCount > 0)
+        m_alloc.release(m_zeroPool[--m_zeroCount]);
+}
+
+Size SplitAllocator::zeroPoolCount() const
+{
+    return m_zeroCount;
+}
+
+Size SplitAllocator::zeroPoolHits() const
+{
+    return m_zeroHits;
+}
+
+Size SplitAllocator::zeroPoolMisses() const
+{
+    return m_zeroMisses;
+}
+
 Allocator::Result SplitAllocator::allocate(const Address addr)
 {
     return m_alloc.allocateAt(addr);
 }
 
+Allocator::Result SplitAllocator::share(const Address addr)
+{
+    if (addr & (m_pageSize - 1) || !m_alloc.isAllocated(addr))
+        return InvalidAddress;
+
+    const Size slot = sharedSlot(addr);
+
+    if (m_sharedRefs[slot])
+    {
+        m_sharedRefs[slot]++;
+        return Success;
+    }
+
+    // Keep enough slots empty for short lookups
+    if (m_sharedCount >= (MaximumSharedPages / 4) * 3)
+        return OutOfMemory;
+
+    m_sharedPages[slot] = addr;
+    m_sharedRefs[slot] = 2;
+    m_sharedCount++;
+    return Success;
+}
+
+Size SplitAllocator::references(const Address addr) const
+{
+    if (!m_alloc.isAllocated(addr))
+        return 0;
+
+    const Size slot = sharedSlot(addr);
+    return m_sharedRefs[slot] ? m_sharedRefs[slot] : 1;
+}
+
 Allocator::Result SplitAllocator::release(const Address addr)
 {
+    const Size slot = sharedSlot(addr);
+
+    // Shared pages stay allocated until the last reference is gone
+    if (m_sharedRefs[slot])
+    {
+        if (--m_sharedRefs[slot] == 1)
+            removeShared(slot);
+
+        return Success;
+    }
+
     return m_alloc.release(addr);
 }
 
+Size SplitAllocator::sharedSlot(const Address addr) const
+{
+    Size slot = (addr / m_pageSize) & (MaximumSharedPages - 1);
+
+    while (m_sharedRefs[slot] && m_sharedPages[slot] != addr)
+        slot = (slot + 1) & (MaximumSharedPages - 1);
+
+    return slot;
+}
+
+void SplitAllocator::removeShared(Size slot)
+{
+    const Size mask = MaximumSharedPages - 1;
+    Size next = (slot + 1) & mask;
+
+    m_sharedRefs[slot] = 0;
+    m_sharedCount--;
+
+    // Move back entries which would no longer be found past the new hole
+    while (m_sharedRefs[next])
+    {
+        const Size home = (m_sharedPages[next] / m_pageSize) & mask;
+
+        if (((next - home) & mask) >= ((next - slot) & mask))
+        {
+            m_sharedPages[slot] = m_sharedPages[next];
+            m_sharedRefs[slot]  = m_sharedRefs[next];
+            m_sharedRefs[next]  = 0;
+            slot = next;
+        }
+        next = (next + 1) & mask;
+    }
+}
+
 Address SplitAllocator::toVirtual(const Address phys) const
 {
-    const Size mappingDiff = base() - m_virtRange.address;
+    const Address mappingDiff = base() - m_virtRange.address;
     return phys - mappingDiff;
 }
 
 Address SplitAllocator::toPhysical(const Address virt) const
 {
-    const Size mappingDiff = base() - m_virtRange.address;
+    const Address mappingDiff = base() - m_virtRange.address;
     return virt + mappingDiff;
 }
 
@@ -107,3 +271,8 @@ bool SplitAllocator::isAllocated(const Address page) const
 {
     return m_alloc.isAllocated(page);
 }
+
+Size SplitAllocator::freeBlocks(const Size order) const
+{
+    return m_alloc.freeBlocks(order);
+}
@@ -21,7 +21,7 @@
 #include <Types.h>
 #include <Callback.h>
 #include "Allocator.h"
-#include "BitAllocator.h"
+#include "BuddyAllocator.h"
 
 /**
  * @addtogroup lib
@@ -36,6 +36,14 @@
  */
 class SplitAllocator : public Allocator
 {
+  public:
+
+    /** Maximum number of pre-zeroed pages kept in the zero pool. */
+    static const Size ZeroPoolSize = 64;
+
+    /** Size of the shared page table. Up to three quarters of it can be in use. */
+    static const Size MaximumSharedPages = 8192;
+
   public:
 
     /**
@@ -90,6 +98,52 @@ class SplitAllocator : public Allocator
      */
     Result allocate(Range & phys, Range & virt);
 
+    /**
+     * Allocate zeroed physical/virtual memory.
+     *
+     * Single page requests are served from the pool of pre-zeroed
+     * pages when possible. Other requests, or a request on an empty pool,
+     * are allocated and cleared synchronously.
+     *
+     * @param phys Contains the requested size and alignment on input.
+     *             The alignment value must be a multiple of the pageSize.
+     *             On output, contains the actual allocated physical address.
+     * @param virt Contains the allocated memory translated for virtual addressing.
+     *
+     * @return Result code
+     */
+    Result allocateZeroed(Range & phys, Range & virt);
+
+    /**
+     * Add pre-zeroed pages to the zero pool.
+     *
+     * @param count Maximum number of pages to add.
+     *
+     * @return Number of pages added to the pool.
+     */
+    Size fillZeroed(const Size count);
+
+    /**
+     * Get number of pages in the zero pool.
+     *
+     * @return Number of pre-zeroed pages available.
+     */
+    Size zeroPoolCount() const;
+
+    /**
+     * Get number of zeroed allocations served from the pool.
+     *
+     * @return Number of pool hits.
+     */
+    Size zeroPoolHits() const;
+
+    /**
+     * Get number of zeroed allocations cleared synchronously.
+     *
+     * @return Number of pool misses.
+     */
+    Size zeroPoolMisses() const;
+
     /**
      * Allocate one physical memory page.
      *
@@ -99,9 +153,32 @@ class SplitAllocator : public Allocator
      */
     Result allocate(const Address addr);
 
+    /**
+     * Add a reference to an allocated physical memory page.
+     *
+     * Shared pages are only returned to the physical memory
+     * allocator once every reference is released.
+     *
+     * @param addr Physical memory page address
+     *
+     * @return Result code
+     */
+    Result share(const Address addr);
+
+    /**
+     * Get number of references to a physical memory page.
+     *
+     * @param addr Physical memory page address
+     *
+     * @return Number of references or zero if the page is not allocated
+     */
+    Size references(const Address addr) const;
+
     /**
      * Release memory page.
      *
+     * For shared pages only a single reference is released.
+     *
      * @param addr Physical memory address of page to release.
      *
      * @return Result value.
@@ -135,16 +212,69 @@ class SplitAllocator : public Allocator
      */
     bool isAllocated(const Address page) const;
 
+    /**
+     * Get number of free physical memory blocks.
+     *
+     * @param order Block order, up to BuddyAllocator::MaximumOrder.
+     *
+     * @return Number of free blocks of (1 << order) pages.
+     */
+    Size freeBlocks(const Size order) const;
+
+  private:
+
+    /**
+     * Return all pages in the zero pool to the physical memory allocator.
+     */
+    void releaseZeroed();
+
+    /**
+     * Find the shared page table slot for a physical page.
+     *
+     * @param addr Physical memory page address
+     *
+     * @return Slot containing the page, or the empty slot where it belongs.
+     */
+    Size sharedSlot(const Address addr) const;
+
+    /**
+     * Remove an entry from the shared page table.
+     *
+     * @param slot Slot of the entry to remove
+     */
+    void removeShared(Size slot);
+
   private:
 
     /** Physical memory allocator. */
-    BitAllocator m_alloc;
+    BuddyAllocator m_alloc;
 
     /** Virtual memory range to manage. */
     const Range m_virtRange;
 
     /** Size of a memory page. */
     const Size m_pageSize;
+
+    /** Physical addresses of pre-zeroed pages. */
+    Address m_zeroPool[ZeroPoolSize];
+
+    /** Number of pages in the zero pool. */
+    Size m_zeroCount;
+
+    /** Zeroed allocations served from the pool. */
+    Size m_zeroHits;
+
+    /** Zeroed allocations cleared synchronously. */
+    Size m_zeroMisses;
+
+    /** Physical addresses of shared pages, as an open addressing hash table. */
+    Address m_sharedPages[MaximumSharedPages];
+
+    /** Number of references for each shared page, or zero for an empty slot. */
+    Size m_sharedRefs[MaximumSharedPages];
+
+    /** Number of entries in the shared page table. */
+    Size m_sharedCount;
 };
 
 /**
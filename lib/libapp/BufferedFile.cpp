@@ -15,6 +15,11 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#ifndef __HOST__
+#include <FileSystemClient.h>
+#else
+#include <sys/mman.h>
+#endif /* __HOST__ */
 #include <Log.h>
 #include <Assert.h>
 #include <Macros.h>
@@ -29,15 +34,15 @@ BufferedFile::BufferedFile(const char *path)
     : m_path(path)
     , m_buffer(ZERO)
     , m_size(0)
+    , m_mapped(false)
+    , m_fd(-1)
+    , m_offset(0)
 {
 }
 
 BufferedFile::~BufferedFile()
 {
-    if (m_buffer != ZERO)
-    {
-        delete[] m_buffer;
-    }
+    release();
 }
 
 const char * BufferedFile::path() const
@@ -60,6 +65,23 @@ BufferedFile::Result BufferedFile::read()
     struct stat st;
     int fp;
 
+    release();
+
+#ifndef __HOST__
+    // Avoid copying the file if it can be mapped
+    const FileSystemClient filesystem;
+    const void *data;
+    Size size;
+
+    if (filesystem.mapFile(m_path, &data, &size) == FileSystem::Success)
+    {
+        m_buffer = (u8 *) data;
+        m_size   = size;
+        m_mapped = true;
+        return Success;
+    }
+#endif /* __HOST__ */
+
     // Retrieve file information
     if (::stat(m_path, &st) != 0)
     {
@@ -75,11 +97,23 @@ BufferedFile::Result BufferedFile::read()
         return IOError;
     }
 
-    // (Re)allocate the internal buffer
-    if (m_buffer != ZERO)
+#ifdef __HOST__
+    // Map the file to page it in on demand instead of copying it
+    if (m_size > 0)
     {
-        delete[] m_buffer;
+        void *data = ::mmap(ZERO, m_size, PROT_READ, MAP_PRIVATE, fp, 0);
+
+        if (data != MAP_FAILED)
+        {
+            ::close(fp);
+            m_buffer = (u8 *) data;
+            m_mapped = true;
+            return Success;
+        }
     }
+#endif /* __HOST__ */
+
+    // Allocate the internal buffer
     m_buffer = new u8[m_size];
     assert(m_buffer != ZERO);
 
@@ -96,6 +130,62 @@ BufferedFile::Result BufferedFile::read()
     return Success;
 }
 
+BufferedFile::Result BufferedFile::open()
+{
+    release();
+
+#ifndef __HOST__
+    // Hand out chunks of the mapping directly, if supported
+    const FileSystemClient filesystem;
+    const void *data;
+    Size size;
+
+    if (filesystem.mapFile(m_path, &data, &size) == FileSystem::Success)
+    {
+        m_buffer = (u8 *) data;
+        m_size   = size;
+        m_mapped = true;
+        return Success;
+    }
+#endif /* __HOST__ */
+
+    // Open the file
+    if ((m_fd = ::open(m_path, O_RDONLY)) == -1)
+    {
+        ERROR("failed to open input file " << m_path << ": " << strerror(errno));
+        return NotFound;
+    }
+
+    // Allocate the read-ahead window
+    m_buffer = new u8[ChunkSize * ReadAheadChunks];
+    assert(m_buffer != ZERO);
+    return Success;
+}
+
+BufferedFile::Result BufferedFile::next(const void **data, Size *size)
+{
+    // Read the next window of chunks when the current window is consumed
+    if (!m_mapped && m_offset >= m_size && m_fd != -1)
+    {
+        const ssize_t result = ::read(m_fd, m_buffer, ChunkSize * ReadAheadChunks);
+        if (result < 0)
+        {
+            ERROR("failed to read input file " << m_path << ": " << strerror(errno));
+            return IOError;
+        }
+
+        m_size   = result;
+        m_offset = 0;
+    }
+
+    // Return at most a chunk of the remaining contents
+    const Size remaining = m_offset < m_size ? m_size - m_offset : 0;
+    *data = m_buffer + m_offset;
+    *size = remaining < ChunkSize ? remaining : ChunkSize;
+    m_offset += *size;
+    return Success;
+}
+
 BufferedFile::Result BufferedFile::write(const void *data, const Size size) const
 {
     int fp;
@@ -119,3 +209,34 @@ BufferedFile::Result BufferedFile::write(const void *data, const Size size) cons
     ::close(fp);
     return Success;
 }
+
+void BufferedFile::release()
+{
+    if (m_buffer != ZERO)
+    {
+        if (m_mapped)
+        {
+#ifndef __HOST__
+            const FileSystemClient filesystem;
+            filesystem.unmapFile(m_buffer);
+#else
+            ::munmap(m_buffer, m_size);
+#endif /* __HOST__ */
+        }
+        else
+        {
+            delete[] m_buffer;
+        }
+    }
+
+    if (m_fd != -1)
+    {
+        ::close(m_fd);
+    }
+
+    m_buffer = ZERO;
+    m_size   = 0;
+    m_mapped = false;
+    m_fd     = -1;
+    m_offset = 0;
+}
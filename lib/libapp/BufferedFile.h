@@ -33,6 +33,14 @@
  */
 class BufferedFile
 {
+  public:
+
+    /** Maximum number of bytes returned by each call to next() */
+    static const Size ChunkSize = 4096;
+
+    /** Number of chunks read at once in streaming mode */
+    static const Size ReadAheadChunks = 8;
+
   public:
 
     /**
@@ -81,10 +89,38 @@ class BufferedFile
     /**
      * Read the file (buffered)
      *
+     * The file is mapped into memory if supported by its file system
+     * (or by the host operating system), otherwise it is copied into a buffer.
+     *
      * @return Result code
      */
     Result read();
 
+    /**
+     * Open the file for streaming
+     *
+     * In streaming mode the file contents are retrieved in chunks
+     * using next(), such that processing can start before the complete
+     * file is read. The file is mapped into memory if supported by its
+     * file system, otherwise it is read ahead in a fixed size window of
+     * chunks. The buffer() and size() functions do not apply to streaming.
+     *
+     * @return Result code
+     */
+    Result open();
+
+    /**
+     * Retrieve the next chunk of the file in streaming mode
+     *
+     * @param data On output points to the chunk contents, which
+     *             remain valid until the next call to next()
+     * @param size On output the size of the chunk in bytes,
+     *             which is zero at the end of the file
+     *
+     * @return Result code
+     */
+    Result next(const void **data, Size *size);
+
     /**
      * Write the file (unbuffered)
      *
@@ -97,6 +133,13 @@ class BufferedFile
      */
     Result write(const void *data, const Size size) const;
 
+  private:
+
+    /**
+     * Release the file contents
+     */
+    void release();
+
   private:
 
     /** Path to the file */
@@ -107,6 +150,15 @@ class BufferedFile
 
     /** Size of the file in bytes */
     Size m_size;
+
+    /** True if m_buffer is mapped by the file system or the host */
+    bool m_mapped;
+
+    /** File descriptor in streaming mode or -1 if not reading from the file */
+    int m_fd;
+
+    /** Offset in m_buffer of the next chunk in streaming mode */
+    Size m_offset;
 };
 
 /**
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBARCH_ATOMIC_H
+#define __LIBARCH_ATOMIC_H
+
+#include <Types.h>
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libarch
+ * @{
+ */
+
+/**
+ * Memory ordering constraints of atomic operations.
+ */
+enum MemoryOrder
+{
+    MemoryRelaxed        = __ATOMIC_RELAXED,
+    MemoryAcquire        = __ATOMIC_ACQUIRE,
+    MemoryRelease        = __ATOMIC_RELEASE,
+    MemoryAcquireRelease = __ATOMIC_ACQ_REL,
+    MemorySequential     = __ATOMIC_SEQ_CST
+};
+
+/**
+ * Order memory accesses around this point.
+ *
+ * @param order Memory ordering constraint.
+ */
+inline void memoryFence(const MemoryOrder order = MemorySequential)
+{
+    __atomic_thread_fence(order);
+}
+
+/**
+ * Hint the core that it is spinning on a shared value.
+ *
+ * Reduces power and pipeline flushes while busy waiting.
+ */
+inline void cpuRelax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    asm volatile ("pause" ::: "memory");
+#elif defined(__arm__) && (__ARM_ARCH >= 7 || defined(__ARM_ARCH_6K__) || defined(__ARM_ARCH_6KZ__))
+    asm volatile ("yield" ::: "memory");
+#else
+    asm volatile ("" ::: "memory");
+#endif
+}
+
+/**
+ * Value which is accessed atomically by multiple cores.
+ *
+ * The compiler emits the required barriers for the architecture
+ * (dmb on ARM, locked instructions on Intel). An Atomic has the same
+ * layout as its value, thus it can be placed in memory shared between processes.
+ */
+template <class T> class Atomic
+{
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param value Initial value.
+     */
+    Atomic(const T value = 0)
+        : m_value(value)
+    {
+    }
+
+    /**
+     * Read the value.
+     *
+     * @param order Memory ordering constraint.
+     *
+     * @return Current value.
+     */
+    T load(const MemoryOrder order = MemorySequential) const
+    {
+        return __atomic_load_n(&m_value, order);
+    }
+
+    /**
+     * Write the value.
+     *
+     * @param value New value.
+     * @param order Memory ordering constraint.
+     */
+    void store(const T value, const MemoryOrder order = MemorySequential)
+    {
+        __atomic_store_n(&m_value, value, order);
+    }
+
+    /**
+     * Replace the value.
+     *
+     * @param value New value.
+     * @param order Memory ordering constraint.
+     *
+     * @return Previous value.
+     */
+    T exchange(const T value, const MemoryOrder order = MemorySequential)
+    {
+        return __atomic_exchange_n(&m_value, value, order);
+    }
+
+    /**
+     * Replace the value only if it equals the expected value.
+     *
+     * @param expected Expected value. On failure, receives the current value.
+     * @param value New value.
+     * @param order Memory ordering constraint on success.
+     *
+     * @return True if the value was replaced, false otherwise.
+     */
+    bool compareExchange(T & expected, const T value, const MemoryOrder order = MemorySequential)
+    {
+        return __atomic_compare_exchange_n(&m_value, &expected, value, false,
+                                           order, MemoryRelaxed);
+    }
+
+    /**
+     * Add to the value.
+     *
+     * @param value Value to add.
+     * @param order Memory ordering constraint.
+     *
+     * @return Previous value.
+     */
+    T fetchAdd(const T value, const MemoryOrder order = MemorySequential)
+    {
+        return __atomic_fetch_add(&m_value, value, order);
+    }
+
+    /**
+     * Subtract from the value.
+     *
+     * @param value Value to subtract.
+     * @param order Memory ordering constraint.
+     *
+     * @return Previous value.
+     */
+    T fetchSub(const T value, const MemoryOrder order = MemorySequential)
+    {
+        return __atomic_fetch_sub(&m_value, value, order);
+    }
+
+  private:
+
+    /** The value */
+    T m_value;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBARCH_ATOMIC_H */
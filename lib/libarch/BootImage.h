@@ -33,7 +33,7 @@
 #define BOOTIMAGE_MAGIC1        ('N') + ('O' << 8) + ('S' << 16) + (0x1 << 24)
 
 /** Version of the boot image layout. */
-#define BOOTIMAGE_REVISION      2
+#define BOOTIMAGE_REVISION      4
 
 /** Maximum length of BootSymbol names. */
 #define BOOTIMAGE_NAMELEN       32
@@ -103,6 +103,15 @@ typedef struct BootSymbol
 }
 BootSymbol;
 
+/**
+ * Boot segment flags.
+ */
+typedef enum BootSegmentFlags
+{
+    BootSegmentCompressed = 1 << 0 /**< Contents are stored as an LZ4 frame */
+}
+BootSegmentFlags;
+
 /**
  * Memory segment.
  */
@@ -116,6 +125,15 @@ typedef struct BootSegment
 
     /** Offset in the boot image of the segment contents. */
     u32 offset;
+
+    /** Number of bytes stored in the boot image at the offset. */
+    u32 dataSize;
+
+    /** Segment flags, see BootSegmentFlags. */
+    u32 flags;
+
+    /** Memory access flags of the segment. */
+    u32 access;
 }
 BootSegment;
 
@@ -106,6 +106,44 @@ class Cache
      */
     virtual Result invalidateAddress(Type type, Address addr) = 0;
 
+    /**
+     * Clean a range of memory.
+     *
+     * Only the cache lines which contain the range are written back.
+     *
+     * @param type Cache type to clean
+     * @param addr Virtual memory address of the first byte to clean
+     * @param size Number of bytes to clean
+     *
+     * @return Result code
+     */
+    virtual Result cleanRange(Type type, Address addr, Size size) = 0;
+
+    /**
+     * Invalidate a range of memory.
+     *
+     * Cache lines which partially overlap the range are invalidated
+     * entirely, thus the range should be aligned to the cache line size.
+     *
+     * @param type Cache type to invalidate
+     * @param addr Virtual memory address of the first byte to invalidate
+     * @param size Number of bytes to invalidate
+     *
+     * @return Result code
+     */
+    virtual Result invalidateRange(Type type, Address addr, Size size) = 0;
+
+    /**
+     * Clean and invalidate a range of memory.
+     *
+     * @param type Cache type to clean and invalidate
+     * @param addr Virtual memory address of the first byte to clean and invalidate
+     * @param size Number of bytes to clean and invalidate
+     *
+     * @return Result code
+     */
+    virtual Result cleanInvalidateRange(Type type, Address addr, Size size) = 0;
+
     /**
      * Clean one data page.
      *
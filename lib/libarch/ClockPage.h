@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBARCH_CLOCKPAGE_H
+#define __LIBARCH_CLOCKPAGE_H
+
+#include <Macros.h>
+#include <Types.h>
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libarch
+ * @{
+ */
+
+/**
+ * Timer state published by the kernel on each core.
+ *
+ * The kernel updates the page on every timer tick and maps it read-only
+ * into every process at the MemoryMap::UserClock region. Processes read
+ * the current time from it without entering the kernel.
+ *
+ * The sequence number is odd while the kernel updates the page. Readers
+ * retry until they observe the same even sequence number before and after
+ * reading the other fields.
+ *
+ * If the timestamp counter frequency is non-zero, the time since the
+ * tick is the timestamp counter cycles since the timestamp field,
+ * converted to nanoseconds as (cycles * timestampMult) >> timestampShift.
+ *
+ * The load of the core over an interval is the increase of busyTicks
+ * divided by the increase of ticks. While the core is idle without
+ * periodic ticks the page is not updated, but busyTicks does not change.
+ */
+typedef struct ClockPage
+{
+    /** Incremented before and after each update. */
+    volatile u32 sequence;
+
+    /** Timer ticks at the last update. */
+    u32 ticks;
+
+    /** Frequency of the timer in hertz. */
+    u32 frequency;
+
+    /** Frequency of the timestamp counter in kHz or zero if not available. */
+    u32 timestampFrequency;
+
+    /** Timestamp counter value at the start of the tick. */
+    u64 timestamp;
+
+    /** Multiplier for converting timestamp counter cycles to nanoseconds. */
+    u32 timestampMult;
+
+    /** Shift for converting timestamp counter cycles to nanoseconds. */
+    u32 timestampShift;
+
+    /** Timer ticks in which the core ran a process other than the idle process. */
+    u32 busyTicks;
+}
+ALIGN(8) ClockPage;
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBARCH_CLOCKPAGE_H */
@@ -28,8 +28,11 @@
 
 #define KERNEL_PATHLEN 64
 
-/** Needed by IntelBoot16.S. Depends on sizeof(Memory::Access) which is an emum */
-#define COREINFO_SIZE  (KERNEL_PATHLEN + (8 * 4) + (4 * 4) + (4 * 4))
+/**
+ * Needed by IntelBoot32.S. Depends on sizeof(Memory::Access) which is an emum.
+ * The CoreInfo struct has 11 words before and 11 words after the kernel command.
+ */
+#define COREINFO_SIZE  (KERNEL_PATHLEN + (11 * 4) + (11 * 4))
 
 /**
  * @}
@@ -98,6 +101,18 @@ typedef struct CoreInfo
     /** Arch-specific timer counter */
     uint timerCounter;
 
+    /** Frequency of the timestamp counter in kilohertz, or zero if unknown */
+    uint timestampFrequency;
+
+    /** Physical processor package of the core */
+    uint package;
+
+    /** Second level cache of the core. Cores with the same value share it */
+    uint cache;
+
+    /** NUMA proximity domain of the core */
+    uint node;
+
     bool operator == (const struct CoreInfo & info) const
     {
         return false;
@@ -15,13 +15,57 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <MemoryBlock.h>
+#include <ListIterator.h>
 #include "CoreManager.h"
 
 CoreManager::CoreManager()
 {
+    clearTopology();
 }
 
 List<uint> & CoreManager::getCores()
 {
     return m_cores;
 }
+
+const CoreManager::Topology * CoreManager::getTopology(const uint coreId) const
+{
+    return coreId < MaximumCores ? &m_topology[coreId] : ZERO;
+}
+
+CoreManager::Distance CoreManager::getDistance(const uint coreA, const uint coreB) const
+{
+    const Topology *a = getTopology(coreA);
+    const Topology *b = getTopology(coreB);
+
+    if (coreA == coreB)
+        return SameCore;
+    else if (!a || !b || a->node != b->node)
+        return Remote;
+    else if (a->package != b->package)
+        return SameNode;
+    else if (a->cache != b->cache)
+        return SamePackage;
+    else
+        return SameCache;
+}
+
+void CoreManager::clearTopology()
+{
+    MemoryBlock::set(m_topology, 0, sizeof(m_topology));
+}
+
+void CoreManager::setTopology(const Size cacheShift, const Size packageShift)
+{
+    for (ListIterator<uint> i(m_cores); i.hasCurrent(); i++)
+    {
+        const uint coreId = i.current();
+
+        if (coreId < MaximumCores)
+        {
+            m_topology[coreId].cache   = coreId >> cacheShift;
+            m_topology[coreId].package = coreId >> packageShift;
+        }
+    }
+}
@@ -35,10 +35,11 @@
  */
 class CoreManager
 {
-  private:
-
   public:
 
+    /** Maximum number of core identities with a topology */
+    static const Size MaximumCores = 256;
+
     /**
      * Result codes.
      */
@@ -50,6 +51,31 @@ class CoreManager
         InvalidArgument
     };
 
+    /**
+     * Position of a core in the processor topology.
+     *
+     * Cores with the same value at a level share that level.
+     */
+    typedef struct Topology
+    {
+        uint package;   /**< Physical processor package */
+        uint cache;     /**< Second level cache */
+        uint node;      /**< NUMA proximity domain */
+    }
+    Topology;
+
+    /**
+     * Distance between two cores in the processor topology.
+     */
+    enum Distance
+    {
+        SameCore,
+        SameCache,
+        SamePackage,
+        SameNode,
+        Remote
+    };
+
     /**
      * Constructor
      */
@@ -62,6 +88,25 @@ class CoreManager
      */
     List<uint> & getCores();
 
+    /**
+     * Get the topology of a core.
+     *
+     * @param coreId Core identity.
+     *
+     * @return Topology pointer or ZERO if the core identity is out of range.
+     */
+    const Topology * getTopology(const uint coreId) const;
+
+    /**
+     * Get the distance between two cores.
+     *
+     * @param coreA Core identity.
+     * @param coreB Core identity.
+     *
+     * @return Closest topology level which both cores share.
+     */
+    Distance getDistance(const uint coreA, const uint coreB) const;
+
     /**
      * Initialize the CoreManager.
      *
@@ -85,10 +130,31 @@ class CoreManager
      */
     virtual Result boot(CoreInfo *info) = 0;
 
+  protected:
+
+    /**
+     * Clear the topology of all cores.
+     */
+    void clearTopology();
+
+    /**
+     * Set the cache and package of the cores from their identities.
+     *
+     * Core identities of cores which share a level
+     * only differ in the bits below the shift of that level.
+     *
+     * @param cacheShift Number of core identity bits below the L2 cache level.
+     * @param packageShift Number of core identity bits below the package level.
+     */
+    void setTopology(const Size cacheShift, const Size packageShift);
+
   protected:
 
     /** List of core ids found. */
     List<uint> m_cores;
+
+    /** Topology of each core, by core identity. */
+    Topology m_topology[MaximumCores];
 };
 
 /**
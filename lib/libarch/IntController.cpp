@@ -41,3 +41,8 @@ IntController::Result IntController::send(const uint targetCoreId, const uint ir
 {
     return IOError;
 }
+
+IntController::Result IntController::setAffinity(const uint irq, const uint coreId)
+{
+    return coreId == 0 ? Success : IOError;
+}
@@ -122,6 +122,17 @@ class IntController
      */
     virtual Result send(const uint targetCoreId, const uint irq);
 
+    /**
+     * Route a hardware interrupt (IRQ) to a core.
+     *
+     * @param irq Interrupt Request number
+     * @param coreId Core which receives the interrupt
+     *
+     * @return Result code. The default implementation delivers
+     *         all interrupts to core0 and returns IOError for other cores.
+     */
+    virtual Result setAffinity(const uint irq, const uint coreId);
+
   protected:
 
     /** Interrupt number base offset */
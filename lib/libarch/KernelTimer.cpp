@@ -15,7 +15,9 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <FreeNOS/System.h>
 #include <FreeNOS/User.h>
+#include <Atomic.h>
 #include <Log.h>
 #include "KernelTimer.h"
 #include <MemoryBlock.h>
@@ -23,6 +25,15 @@
 Timer::Result KernelTimer::tick()
 {
     Timer::Info info;
+    u64 nanoseconds;
+
+    // Avoid entering the kernel if possible
+    if (getClock(&nanoseconds, &info) == Timer::Success)
+    {
+        m_frequency = info.frequency;
+        m_ticks     = info.ticks;
+        return Timer::Success;
+    }
 
     const API::Result result = ProcessCtl(SELF, InfoTimer, (Address) &info);
     if (result != API::Success)
@@ -36,3 +47,54 @@ Timer::Result KernelTimer::tick()
 
     return Timer::Success;
 }
+
+Timer::Result KernelTimer::getClock(u64 *nanoseconds, Info *info)
+{
+#ifdef __HOST__
+    return Timer::NotSupported;
+#else
+    static const ClockPage *page = ZERO;
+    u32 sequence, ticks, frequency, mult, shift;
+    u64 cycles;
+
+    if (!page)
+    {
+        const Arch::MemoryMap map;
+        page = (const ClockPage *) map.range(MemoryMap::UserClock).virt;
+    }
+
+    // Retry if the kernel updated the page while reading it
+    do
+    {
+        sequence = page->sequence;
+        memoryFence(MemoryAcquire);
+
+        if (page->timestampFrequency == 0 || page->frequency == 0)
+        {
+            return Timer::NotSupported;
+        }
+
+        ticks     = page->ticks;
+        frequency = page->frequency;
+        mult      = page->timestampMult;
+        shift     = page->timestampShift;
+        cycles    = timestamp() - page->timestamp;
+
+        memoryFence(MemoryAcquire);
+    }
+    while ((sequence & 1) || sequence != page->sequence);
+
+    const u64 tickNanoseconds = 1000000000U / frequency;
+    const u64 sinceTick = (cycles * mult) >> shift;
+
+    *nanoseconds = (ticks * tickNanoseconds) + sinceTick;
+
+    if (info)
+    {
+        info->ticks = ticks + (sinceTick / tickNanoseconds);
+        info->frequency = frequency;
+    }
+
+    return Timer::Success;
+#endif /* __HOST__ */
+}
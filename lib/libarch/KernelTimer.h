@@ -31,7 +31,11 @@
 /**
  * Provides the timer of the kernel
  *
+ * The timer state is read from the ClockPage of the kernel when it
+ * has a timestamp counter, and with ProcessCtl otherwise.
+ *
  * @see ProcessCtl
+ * @see ClockPage
  */
 class KernelTimer : public Timer
 {
@@ -46,6 +50,18 @@ class KernelTimer : public Timer
      * @return Result code
      */
     virtual Result tick();
+
+    /**
+     * Get the time since boot from the ClockPage.
+     *
+     * Does not enter the kernel.
+     *
+     * @param nanoseconds Receives the number of nanoseconds since boot.
+     * @param info Optional Timer Info object pointer for the current ticks.
+     *
+     * @return Success, or NotSupported if the ClockPage has no timestamp counter.
+     */
+    static Result getClock(u64 *nanoseconds, Info *info = ZERO);
 };
 
 /**
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBARCH_MCSLOCK_H
+#define __LIBARCH_MCSLOCK_H
+
+#include <Types.h>
+#include <Macros.h>
+#include "Atomic.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libarch
+ * @{
+ */
+
+/**
+ * Queue based spinlock.
+ *
+ * Each waiting core spins on its own Node instead of the lock itself,
+ * such that releasing the lock only touches the cache line of the next
+ * waiter. Nodes are linked by pointer, thus all cores using the lock
+ * must share the same address space, such as the kernel.
+ */
+class McsLock
+{
+  public:
+
+    /**
+     * Queue entry of a core which holds or waits for the lock.
+     */
+    typedef struct Node
+    {
+        /** Next waiting core. */
+        Atomic<Node *> next;
+
+        /** Non-zero while waiting for the lock. */
+        Atomic<u32> waiting;
+    }
+    Node;
+
+  public:
+
+    /**
+     * Constructor.
+     */
+    McsLock()
+        : m_tail(ZERO)
+    {
+    }
+
+    /**
+     * Wait until the lock is acquired.
+     *
+     * @param node Queue entry of the caller, which must stay valid until unlock().
+     */
+    void lock(Node *node)
+    {
+        node->next.store(ZERO, MemoryRelaxed);
+        node->waiting.store(1, MemoryRelaxed);
+
+        Node *prev = m_tail.exchange(node, MemoryAcquireRelease);
+        if (prev != ZERO)
+        {
+            prev->next.store(node, MemoryRelease);
+
+            while (node->waiting.load(MemoryAcquire))
+            {
+                cpuRelax();
+            }
+        }
+    }
+
+    /**
+     * Acquire the lock only if it is free.
+     *
+     * @param node Queue entry of the caller.
+     *
+     * @return True if acquired, false otherwise.
+     */
+    bool tryLock(Node *node)
+    {
+        Node *expected = ZERO;
+
+        node->next.store(ZERO, MemoryRelaxed);
+        node->waiting.store(0, MemoryRelaxed);
+
+        return m_tail.compareExchange(expected, node, MemoryAcquire);
+    }
+
+    /**
+     * Release the lock to the next waiting core.
+     *
+     * @param node Queue entry which was passed to lock().
+     */
+    void unlock(Node *node)
+    {
+        Node *next = node->next.load(MemoryAcquire);
+
+        if (next == ZERO)
+        {
+            // No waiters: release the lock
+            Node *expected = node;
+            if (m_tail.compareExchange(expected, ZERO, MemoryRelease))
+            {
+                return;
+            }
+
+            // A core is enqueueing itself: wait until it is linked
+            while ((next = node->next.load(MemoryAcquire)) == ZERO)
+            {
+                cpuRelax();
+            }
+        }
+
+        next->waiting.store(0, MemoryRelease);
+    }
+
+  private:
+
+    /** Last core in the queue, or ZERO if the lock is free. */
+    Atomic<Node *> m_tail;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBARCH_MCSLOCK_H */
@@ -20,6 +20,7 @@
 #pragma GCC optimize ("O0")
 
 #include <FreeNOS/System.h>
+#include <MemoryBlock.h>
 #include <SplitAllocator.h>
 #include "MemoryContext.h"
 
@@ -31,7 +32,13 @@ MemoryContext::MemoryContext(MemoryMap *map, SplitAllocator *alloc)
     , m_mapRangeSparseCallback(this, &MemoryContext::mapRangeSparseCallback)
     , m_savedRange(ZERO)
     , m_numSparsePages(ZERO)
+    , m_demandCount(ZERO)
+    , m_copyCount(ZERO)
+    , m_batchDepth(ZERO)
+    , m_batchStart(ZERO)
+    , m_batchEnd(ZERO)
 {
+    MemoryBlock::set(&m_usage, 0, sizeof(m_usage));
 }
 
 MemoryContext::~MemoryContext()
@@ -43,9 +50,45 @@ MemoryContext * MemoryContext::getCurrent()
     return m_current;
 }
 
+MemoryContext::Result MemoryContext::mapLarge(Memory::Range *range)
+{
+    return InvalidSize;
+}
+
+MemoryContext::Result MemoryContext::unmapLarge(Address virt)
+{
+    return InvalidAddress;
+}
+
+MemoryContext::Result MemoryContext::mapPages(const Memory::Range & range)
+{
+    for (Size i = 0; i < range.size; i += PAGESIZE)
+    {
+        const Result r = map(range.virt + i, range.phys + i, range.access);
+        if (r != Success)
+            return r;
+    }
+
+    return Success;
+}
+
+MemoryContext::Result MemoryContext::unmapPages(const Memory::Range & range)
+{
+    for (Size i = 0; i < range.size; i += PAGESIZE)
+    {
+        const Result r = unmap(range.virt + i);
+        if (r != Success)
+            return r;
+    }
+
+    return Success;
+}
+
 MemoryContext::Result MemoryContext::mapRangeContiguous(Memory::Range *range)
 {
+    const bool shared = range->phys != ZERO;
     Result r = Success;
+    Size i = 0;
 
     // Allocate a block of contiguous physical pages, if needed.
     if (!range->phys)
@@ -55,21 +98,56 @@ MemoryContext::Result MemoryContext::mapRangeContiguous(Memory::Range *range)
         alloc_args.size = range->size;
         alloc_args.alignment = PAGESIZE;
 
-        if (m_alloc->allocate(alloc_args) != Allocator::Success)
+        // Prefer physical memory which can be mapped with large pages
+        if (!(range->virt & ~SECTIONMASK) && range->size >= SECTIONSIZE)
+        {
+            alloc_args.alignment = SECTIONSIZE;
+
+            if (m_alloc->allocate(alloc_args) != Allocator::Success)
+                alloc_args.alignment = PAGESIZE;
+        }
+
+        if (alloc_args.alignment == PAGESIZE &&
+            m_alloc->allocate(alloc_args) != Allocator::Success)
             return OutOfMemory;
 
         range->phys = alloc_args.address;
     }
 
+    beginBatch();
+
     // Insert virtual page(s)
-    for (Size i = 0; i < range->size; i += PAGESIZE)
+    while (i < range->size)
     {
-        if ((r = map(range->virt + i,
-                     range->phys + i,
-                     range->access)) != Success)
+        // Use a large page if the addresses are aligned and the range is big enough
+        if (!((range->virt + i) & ~SECTIONMASK) &&
+            !((range->phys + i) & ~SECTIONMASK) &&
+            range->size - i >= SECTIONSIZE)
+        {
+            Memory::Range section = { range->virt + i, range->phys + i,
+                                      SECTIONSIZE, range->access };
+
+            if (mapLarge(&section) == Success)
+            {
+                i += SECTIONSIZE;
+                continue;
+            }
+        }
+
+        // Map small pages up to the next large page boundary at once
+        const Size remain = SECTIONSIZE - ((range->virt + i) & ~SECTIONMASK);
+        const Memory::Range pages = { range->virt + i, range->phys + i,
+                                      range->size - i < remain ? range->size - i : remain,
+                                      range->access };
+
+        if ((r = mapPages(pages)) != Success)
             break;
+
+        i += pages.size;
     }
 
+    endBatch();
+    addUsage(i / PAGESIZE, shared);
     return r;
 }
 
@@ -86,20 +164,324 @@ MemoryContext::Result MemoryContext::mapRangeSparse(Memory::Range *range)
     alloc_args.alignment = 0;
 
     // This invokes our callback for each new page that is allocated
-    if (m_alloc->allocateSparse(alloc_args, &m_mapRangeSparseCallback) != Allocator::Success)
+    beginBatch();
+    const Allocator::Result result = m_alloc->allocateSparse(alloc_args, &m_mapRangeSparseCallback);
+    endBatch();
+    addUsage(m_numSparsePages / PAGESIZE, false);
+
+    return result == Allocator::Success ? Success : OutOfMemory;
+}
+
+MemoryContext::Result MemoryContext::reserveRange(const Memory::Range *range)
+{
+    if ((range->virt & ~PAGEMASK) || !range->virt)
+        return InvalidAddress;
+
+    if ((range->size & ~PAGEMASK) || !range->size)
+        return InvalidSize;
+
+    return insertRange(m_demandRanges, m_demandCount, MaximumDemandRanges, range);
+}
+
+MemoryContext::Result MemoryContext::mapDemand(Address virt)
+{
+    const Memory::Range *range = findRange(m_demandRanges, m_demandCount, virt);
+    Allocator::Range allocPhys, allocVirt;
+    Address phys;
+
+    if (!range)
+        return InvalidAddress;
+
+    if (lookup(virt, &phys) == Success)
+        return AlreadyExists;
+
+    // Allocate and clear a new physical page
+    allocPhys.address = 0;
+    allocPhys.size = PAGESIZE;
+    allocPhys.alignment = PAGESIZE;
+
+    if (m_alloc->allocateZeroed(allocPhys, allocVirt) != Allocator::Success)
+        return OutOfMemory;
+
+    const Result r = map(virt & PAGEMASK, allocPhys.address, range->access);
+    if (r != Success)
+        m_alloc->release(allocPhys.address);
+    else
+        addUsage(1, false);
+
+    return r;
+}
+
+MemoryContext::Result MemoryContext::mapCopyOnWrite(const Memory::Range *range)
+{
+    const Size size = (range->size + PAGESIZE - 1) & PAGEMASK;
+    const Memory::Access access = range->access & ~Memory::Writable;
+    Result r = Success;
+
+    if ((range->virt & ~PAGEMASK) || !range->virt || (range->phys & ~PAGEMASK))
+        return InvalidAddress;
+
+    if (!size)
+        return InvalidSize;
+
+    // Remember which pages become writable after copying
+    if (range->access & Memory::Writable)
+    {
+        const Memory::Range copy = { range->virt, ZERO, size, range->access };
+
+        if ((r = insertRange(m_copyRanges, m_copyCount, MaximumCopyRanges, &copy)) != Success)
+            return r;
+    }
+
+    beginBatch();
+
+    for (Size i = 0; i < size && r == Success; i += PAGESIZE)
+    {
+        const Address phys = range->phys + i;
+
+        switch (m_alloc->share(phys))
+        {
+            case Allocator::Success:
+                if ((r = map(range->virt + i, phys, access)) != Success)
+                    m_alloc->release(phys);
+                break;
+
+            // Without room to track another shared page, copy it right away
+            case Allocator::OutOfMemory:
+                r = mapCopy(range->virt + i, phys, range->access);
+                break;
+
+            default:
+                r = InvalidAddress;
+                break;
+        }
+
+        // Copy-on-write pages count as private memory
+        if (r == Success)
+            addUsage(1, false);
+    }
+
+    endBatch();
+    return r;
+}
+
+MemoryContext::Result MemoryContext::mapShared(const Memory::Range *range)
+{
+    const Size size = (range->size + PAGESIZE - 1) & PAGEMASK;
+    Result r = Success;
+    Size i = 0;
+
+    if ((range->virt & ~PAGEMASK) || !range->virt || (range->phys & ~PAGEMASK))
+        return InvalidAddress;
+
+    if (!size)
+        return InvalidSize;
+
+    beginBatch();
+
+    while (i < size && r == Success)
+    {
+        // Use a large page if the addresses are aligned and the range is big enough
+        const bool large = !((range->virt + i) & ~SECTIONMASK) &&
+                           !((range->phys + i) & ~SECTIONMASK) &&
+                           size - i >= SECTIONSIZE;
+        const Size chunk = large ? SECTIONSIZE : PAGESIZE;
+        Size count = 0;
+
+        // Each page of the chunk gains a reference before it is mapped
+        for (; count < chunk; count += PAGESIZE)
+        {
+            switch (m_alloc->share(range->phys + i + count))
+            {
+                case Allocator::Success:
+                    continue;
+
+                case Allocator::OutOfMemory:
+                    r = OutOfMemory;
+                    break;
+
+                default:
+                    r = InvalidAddress;
+                    break;
+            }
+            break;
+        }
+
+        if (r == Success && large)
+        {
+            Memory::Range section = { range->virt + i, range->phys + i,
+                                      SECTIONSIZE, range->access };
+
+            if (mapLarge(&section) == Success)
+            {
+                i += SECTIONSIZE;
+                continue;
+            }
+        }
+
+        // Map small pages and drop the references of pages which are not mapped
+        const Size base = i;
+
+        for (Size j = 0; j < count; j += PAGESIZE)
+        {
+            if (r == Success)
+                r = map(range->virt + base + j, range->phys + base + j, range->access);
+
+            if (r == Success)
+                i += PAGESIZE;
+            else
+                m_alloc->release(range->phys + base + j);
+        }
+    }
+
+    endBatch();
+    addUsage(i / PAGESIZE, true);
+    return r;
+}
+
+MemoryContext::Result MemoryContext::copyOnWrite(Address virt)
+{
+    const Memory::Range *range = findRange(m_copyRanges, m_copyCount, virt);
+    const Address page = virt & PAGEMASK;
+    Memory::Access current;
+    Address phys;
+
+    if (!range)
+        return InvalidAddress;
+
+    if (lookup(page, &phys) != Success || access(page, &current) != Success)
+        return InvalidAddress;
+
+    if (current & Memory::Writable)
+        return AlreadyExists;
+
+    // Replace the read-only mapping. Copy the page
+    // only if another user still references it.
+    const bool shared = m_alloc->references(phys) > 1;
+    unmap(page);
+
+    const Result r = shared ? mapCopy(page, phys, range->access)
+                            : map(page, phys, range->access);
+    if (r != Success)
+    {
+        map(page, phys, current);
+        return r;
+    }
+
+    if (shared)
+        m_alloc->release(phys);
+
+    return Success;
+}
+
+MemoryContext::Result MemoryContext::mapCopy(Address virt, Address phys, Memory::Access access)
+{
+    Allocator::Range allocPhys, allocVirt;
+    allocPhys.address = 0;
+    allocPhys.size = PAGESIZE;
+    allocPhys.alignment = PAGESIZE;
+
+    if (m_alloc->allocate(allocPhys, allocVirt) != Allocator::Success)
         return OutOfMemory;
 
+    MemoryBlock::copy((void *) allocVirt.address, (void *) m_alloc->toVirtual(phys), PAGESIZE);
+
+    const Result r = map(virt, allocPhys.address, access);
+    if (r != Success)
+        m_alloc->release(allocPhys.address);
+
+    return r;
+}
+
+MemoryContext::Result MemoryContext::insertRange(Memory::Range *ranges,
+                                                 Size & count,
+                                                 const Size maximum,
+                                                 const Memory::Range *range)
+{
+    for (Size i = 0; i < count; i++)
+    {
+        Memory::Range & r = ranges[i];
+
+        // Reject overlapping ranges
+        if (range->virt < r.virt + r.size && r.virt < range->virt + range->size)
+            return AlreadyExists;
+    }
+
+    // Try to extend a range which ends where this one begins
+    for (Size i = 0; i < count; i++)
+    {
+        Memory::Range & r = ranges[i];
+
+        if (r.virt + r.size == range->virt && r.access == range->access)
+        {
+            r.size += range->size;
+            return Success;
+        }
+    }
+
+    if (count >= maximum)
+        return OutOfMemory;
+
+    ranges[count].virt   = range->virt;
+    ranges[count].phys   = ZERO;
+    ranges[count].size   = range->size;
+    ranges[count].access = range->access;
+    count++;
     return Success;
 }
 
+const Memory::Range * MemoryContext::findRange(const Memory::Range *ranges,
+                                               const Size count,
+                                               const Address virt)
+{
+    for (Size i = 0; i < count; i++)
+    {
+        const Memory::Range & r = ranges[i];
+
+        if (virt >= r.virt && virt < r.virt + r.size)
+            return &r;
+    }
+
+    return ZERO;
+}
+
 MemoryContext::Result MemoryContext::unmapRange(Memory::Range *range)
 {
     Result r = Success;
+    Size removed = 0;
+
+    beginBatch();
+
+    for (Size i = 0; i < range->size; )
+    {
+        // Remove a large page at once, if it is fully covered by the range
+        if (!((range->virt + i) & ~SECTIONMASK) &&
+            range->size - i >= SECTIONSIZE &&
+            unmapLarge(range->virt + i) == Success)
+        {
+            removed += SECTIONSIZE / PAGESIZE;
+            i += SECTIONSIZE;
+            continue;
+        }
 
-    for (Size i = 0; i < range->size; i += PAGESIZE)
-        if ((r = unmap(range->virt + i)) != Success)
+        // Remove small pages up to the next large page boundary at once
+        const Size remain = SECTIONSIZE - ((range->virt + i) & ~SECTIONMASK);
+        const Memory::Range pages = { range->virt + i, ZERO,
+                                      range->size - i < remain ? range->size - i : remain,
+                                      range->access };
+        const Size mapped = countMapped(pages);
+
+        if ((r = unmapPages(pages)) != Success)
             break;
 
+        removed += mapped;
+        i += pages.size;
+    }
+
+    endBatch();
+
+    // Unmapping leaves the memory allocated, which is mostly memory owned elsewhere
+    removeUsage(removed, true);
     return r;
 }
 
@@ -122,7 +504,7 @@ MemoryContext::Result MemoryContext::findFree(Size size, MemoryMap::Region regio
 
     while (addr < r.virt+r.size && currentSize < size)
     {
-        if (lookup(addr, &tmp) == InvalidAddress)
+        if (lookup(addr, &tmp) == InvalidAddress && !findRange(m_demandRanges, m_demandCount, addr))
         {
             currentSize += PAGESIZE;
         }
@@ -143,18 +525,109 @@ MemoryContext::Result MemoryContext::findFree(Size size, MemoryMap::Region regio
         return OutOfMemory;
 }
 
+void MemoryContext::getUsage(MemoryContext::Usage & usage) const
+{
+    usage = m_usage;
+    usage.tables = countTables();
+}
+
 void MemoryContext::mapRangeSparseCallback(Address *phys)
 {
-    Result r = Success;
+    const Memory::Range pages = { m_savedRange->virt + m_numSparsePages, *phys,
+                                  8U * PAGESIZE, m_savedRange->access };
+    const Result r = mapPages(pages);
+
+    if (r == Success)
+        m_numSparsePages += pages.size;
 
-    for (Size i = 0; i < 8U * PAGESIZE; i += PAGESIZE)
+    assert(r == Success);
+}
+
+void MemoryContext::invalidateTLB(const Address virt, const Size size)
+{
+    // Only record the range while batching
+    if (m_batchDepth)
     {
-        r = map(m_savedRange->virt + m_numSparsePages, (*phys) + i, m_savedRange->access);
-        if (r != Success)
-            break;
+        if (m_batchStart == m_batchEnd)
+        {
+            m_batchStart = virt;
+            m_batchEnd = virt + size;
+        }
+        else
+        {
+            if (virt < m_batchStart)
+                m_batchStart = virt;
 
-        m_numSparsePages += PAGESIZE;
+            if (virt + size > m_batchEnd)
+                m_batchEnd = virt + size;
+        }
+        return;
     }
 
-    assert(r == Success);
+    if (size > TLBFlushThreshold * PAGESIZE)
+        flushTLBAll();
+    else
+        for (Size i = 0; i < size; i += PAGESIZE)
+            flushTLB(virt + i);
+}
+
+void MemoryContext::beginBatch()
+{
+    if (m_batchDepth++ == 0)
+        m_batchStart = m_batchEnd = 0;
+}
+
+void MemoryContext::endBatch()
+{
+    if (--m_batchDepth == 0 && m_batchEnd != m_batchStart)
+        invalidateTLB(m_batchStart, m_batchEnd - m_batchStart);
+}
+
+void MemoryContext::flushTLB(const Address virt)
+{
+}
+
+void MemoryContext::flushTLBAll()
+{
+}
+
+Size MemoryContext::countTables() const
+{
+    return 0;
+}
+
+Size MemoryContext::countMapped(const Memory::Range & range) const
+{
+    Size count = 0;
+    Address phys;
+
+    for (Size i = 0; i < range.size; i += PAGESIZE)
+    {
+        if (lookup(range.virt + i, &phys) == Success)
+            count++;
+    }
+
+    return count;
+}
+
+void MemoryContext::addUsage(const Size pages, const bool shared)
+{
+    m_usage.mapped += pages;
+
+    if (shared)
+        m_usage.shared += pages;
+    else
+        m_usage.resident += pages;
+}
+
+void MemoryContext::removeUsage(const Size pages, const bool shared)
+{
+    Size & preferred = shared ? m_usage.shared : m_usage.resident;
+    Size & other = shared ? m_usage.resident : m_usage.shared;
+    const Size first = pages < preferred ? pages : preferred;
+    const Size rest = pages - first < other ? pages - first : other;
+
+    preferred -= first;
+    other -= rest;
+    m_usage.mapped -= first + rest;
 }
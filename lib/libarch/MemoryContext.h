@@ -41,6 +41,17 @@ class SplitAllocator;
  */
 class MemoryContext
 {
+  private:
+
+    /** Maximum number of demand-zero ranges per context */
+    static const Size MaximumDemandRanges = 8;
+
+    /** Maximum number of copy-on-write ranges per context */
+    static const Size MaximumCopyRanges = 8;
+
+    /** Number of pages above which the whole TLB is flushed instead of each page */
+    static const Size TLBFlushThreshold = 32;
+
   public:
 
     /**
@@ -56,6 +67,29 @@ class MemoryContext
     }
     Result;
 
+    /**
+     * Memory usage of a context in pages.
+     *
+     * Private memory is allocated for the context itself, including
+     * copy-on-write pages. Shared memory is mapped from physical pages
+     * owned elsewhere, such as memory shares and device registers.
+     */
+    typedef struct Usage
+    {
+        /** Pages mapped in the context */
+        Size mapped;
+
+        /** Mapped pages of private memory */
+        Size resident;
+
+        /** Mapped pages of shared memory */
+        Size shared;
+
+        /** Pages used for the page tables of the context */
+        Size tables;
+    }
+    Usage;
+
     /**
      * Constructor.
      *
@@ -137,9 +171,59 @@ class MemoryContext
      */
     virtual Result access(Address virt, Memory::Access *access) const = 0;
 
+    /**
+     * Map a contiguous range using large pages.
+     *
+     * Both the virtual and physical address must be aligned
+     * to SECTIONSIZE and the size must be a multiple of SECTIONSIZE.
+     *
+     * @param range Range object describing the range of physical pages.
+     *
+     * @return Result code. The default implementation
+     *         has no large pages and returns InvalidSize.
+     */
+    virtual Result mapLarge(Memory::Range *range);
+
+    /**
+     * Unmap a single large page.
+     *
+     * @param virt Virtual address aligned to SECTIONSIZE.
+     *
+     * @return Result code. InvalidAddress if the virtual
+     *         address is not mapped by a large page.
+     */
+    virtual Result unmapLarge(Address virt);
+
+    /**
+     * Map a range of contiguous physical pages using small pages only.
+     *
+     * The page table entries are filled in bulk and the TLB
+     * is invalidated once for the whole range.
+     *
+     * @param range Range object describing the range of physical pages.
+     *
+     * @return Result code. The default implementation calls map() for each page.
+     */
+    virtual Result mapPages(const Memory::Range & range);
+
+    /**
+     * Unmap a range of small pages.
+     *
+     * The page table entries are cleared in bulk and the TLB
+     * is invalidated once for the whole range.
+     *
+     * @param range Range object describing the range of virtual addresses.
+     *
+     * @return Result code. The default implementation calls unmap() for each page.
+     */
+    virtual Result unmapPages(const Memory::Range & range);
+
     /**
      * Map a range of contiguous physical pages to virtual addresses.
      *
+     * Large pages are used for the parts of the range which
+     * are suitably aligned, and small pages for the remainder.
+     *
      * @param range Range object describing the range of physical pages.
      *
      * @return Result code.
@@ -155,6 +239,74 @@ class MemoryContext
      */
     virtual Result mapRangeSparse(Memory::Range *range);
 
+    /**
+     * Reserve a range of demand-zero virtual memory.
+     *
+     * No physical memory is allocated up front. Each page
+     * in the range is backed by a zeroed physical page
+     * on first access, using mapDemand().
+     *
+     * @param range Range object describing the virtual addresses and access flags.
+     *
+     * @return Result code
+     */
+    Result reserveRange(const Memory::Range *range);
+
+    /**
+     * Back a demand-zero page with physical memory.
+     *
+     * @param virt Virtual address inside a reserved range.
+     *
+     * @return Result code. InvalidAddress if the address is not
+     *         reserved and AlreadyExists if it is already backed.
+     */
+    Result mapDemand(Address virt);
+
+    /**
+     * Map shared physical pages as copy-on-write.
+     *
+     * Each physical page gains a reference and is mapped without
+     * the Writable flag. If the range is Writable, the first write
+     * to a page is resolved by copyOnWrite(). Pages which cannot be
+     * shared anymore are copied immediately.
+     *
+     * @param range Range object describing the virtual and physical
+     *              addresses and the access flags. The physical pages
+     *              must be allocated.
+     *
+     * @return Result code
+     */
+    Result mapCopyOnWrite(const Memory::Range *range);
+
+    /**
+     * Map physical pages which are shared with other contexts.
+     *
+     * Each physical page gains a reference, such that the pages
+     * stay allocated until every context released them. Writes
+     * are visible to all contexts. Large pages are used for the
+     * parts of the range which are aligned on both addresses.
+     *
+     * @param range Range object describing the virtual and physical
+     *              addresses and the access flags. The physical pages
+     *              must be allocated.
+     *
+     * @return Result code
+     */
+    Result mapShared(const Memory::Range *range);
+
+    /**
+     * Give a copy-on-write page its own writable physical page.
+     *
+     * The page is copied only if its physical page is still shared,
+     * otherwise it is made writable in place.
+     *
+     * @param virt Virtual address inside a copy-on-write range.
+     *
+     * @return Result code. InvalidAddress if the address is not
+     *         copy-on-write and AlreadyExists if it is already writable.
+     */
+    Result copyOnWrite(Address virt);
+
     /**
      * Unmaps a range of virtual memory.
      *
@@ -212,6 +364,16 @@ class MemoryContext
      */
     virtual Result findFree(Size size, MemoryMap::Region region, Address *virt) const;
 
+    /**
+     * Get the memory usage of the context.
+     *
+     * The mapping counters are maintained when ranges are mapped and
+     * unmapped, except by releaseSection() which tears down a context.
+     *
+     * @param usage Receives the page counters
+     */
+    void getUsage(Usage & usage) const;
+
     /**
      * Callback to provide intermediate Range object during mapRangeSparse()
      *
@@ -221,6 +383,121 @@ class MemoryContext
      */
     virtual void mapRangeSparseCallback(Address *phys);
 
+  protected:
+
+    /**
+     * Invalidate the TLB entries of a range of pages.
+     *
+     * Inside a batch the range is only recorded and invalidated
+     * by endBatch(). Otherwise each page is invalidated with
+     * flushTLB(), or the whole TLB with flushTLBAll() if the
+     * range exceeds TLBFlushThreshold pages.
+     *
+     * @param virt Virtual address of the first page
+     * @param size Number of bytes in the range
+     */
+    void invalidateTLB(const Address virt, const Size size);
+
+    /**
+     * Start deferring TLB invalidations.
+     *
+     * Batches may be nested.
+     */
+    void beginBatch();
+
+    /**
+     * Invalidate the TLB entries recorded since the outermost beginBatch().
+     */
+    void endBatch();
+
+    /**
+     * Invalidate the TLB entry of a single page.
+     *
+     * @param virt Virtual address of the page
+     */
+    virtual void flushTLB(const Address virt);
+
+    /**
+     * Invalidate all TLB entries of this context.
+     */
+    virtual void flushTLBAll();
+
+    /**
+     * Count the pages used for the page tables of this context.
+     *
+     * @return Number of pages. The default implementation returns zero.
+     */
+    virtual Size countTables() const;
+
+    /**
+     * Count the mapped pages in a range.
+     *
+     * @param range Range object describing the range of virtual addresses.
+     *
+     * @return Number of mapped pages
+     */
+    Size countMapped(const Memory::Range & range) const;
+
+    /**
+     * Account for pages which are mapped.
+     *
+     * @param pages Number of pages
+     * @param shared True for shared memory, false for private memory
+     */
+    void addUsage(const Size pages, const bool shared);
+
+    /**
+     * Account for pages which are no longer mapped.
+     *
+     * Pages are taken from the preferred counter first, since
+     * the counters do not record the kind of each page.
+     *
+     * @param pages Number of pages
+     * @param shared True to prefer shared memory, false for private memory
+     */
+    void removeUsage(const Size pages, const bool shared);
+
+  private:
+
+    /**
+     * Map a private copy of a physical page.
+     *
+     * @param virt Virtual address to map
+     * @param phys Physical address of the page to copy
+     * @param access Access flags for the new mapping
+     *
+     * @return Result code
+     */
+    Result mapCopy(Address virt, Address phys, Memory::Access access);
+
+    /**
+     * Add a page-aligned range to a list of ranges.
+     *
+     * @param ranges List of ranges
+     * @param count Number of ranges in the list, updated on output
+     * @param maximum Capacity of the list
+     * @param range Range to add. Extends an adjacent range with the same access if possible.
+     *
+     * @return Result code
+     */
+    static Result insertRange(Memory::Range *ranges,
+                              Size & count,
+                              const Size maximum,
+                              const Memory::Range *range);
+
+    /**
+     * Find the range containing a virtual address.
+     *
+     * @param ranges List of ranges
+     * @param count Number of ranges in the list
+     * @param virt Virtual address
+     *
+     * @return Pointer to the range or ZERO if not found
+     */
+    static const Memory::Range * findRange(const Memory::Range *ranges,
+                                           const Size count,
+                                           const Address virt);
+
   protected:
 
     /** Physical memory allocator */
@@ -240,6 +517,32 @@ class MemoryContext
 
     /** Number of pages allocated via mapRangeSparse Callback. */
     Size m_numSparsePages;
+
+  private:
+
+    /** Reserved demand-zero ranges. */
+    Memory::Range m_demandRanges[MaximumDemandRanges];
+
+    /** Number of reserved demand-zero ranges. */
+    Size m_demandCount;
+
+    /** Copy-on-write ranges, with the access flags to use after copying. */
+    Memory::Range m_copyRanges[MaximumCopyRanges];
+
+    /** Number of copy-on-write ranges. */
+    Size m_copyCount;
+
+    /** Nesting depth of beginBatch() calls. */
+    Size m_batchDepth;
+
+    /** First virtual address with a deferred TLB invalidation. */
+    Address m_batchStart;
+
+    /** End of the virtual addresses with a deferred TLB invalidation. */
+    Address m_batchEnd;
+
+    /** Mapping counters. The page tables are counted on request. */
+    Usage m_usage;
 };
 
 /**
@@ -31,6 +31,7 @@ MemoryMap::MemoryMap(const MemoryMap &map)
     setRange(UserPrivate,   map.m_regions[UserPrivate]);
     setRange(UserShare,     map.m_regions[UserShare]);
     setRange(UserArgs,      map.m_regions[UserArgs]);
+    setRange(UserClock,     map.m_regions[UserClock]);
 }
 
 Memory::Range MemoryMap::range(MemoryMap::Region region) const
@@ -28,7 +28,7 @@
  * @{
  */
 
-#define MEMORYMAP_MAX_REGIONS 8
+#define MEMORYMAP_MAX_REGIONS 9
 
 /**
  * Describes virtual memory map layout
@@ -58,7 +58,8 @@ class MemoryMap
         UserStack,     /**<< User stack */
         UserPrivate,   /**<< User private dynamic memory mappings */
         UserShare,     /**<< User shared dynamic memory mappings */
-        UserArgs       /**<< Used for copying program arguments and file descriptors */
+        UserArgs,      /**<< Used for copying program arguments and file descriptors */
+        UserClock      /**<< Read-only ClockPage of the kernel */
     }
     Region;
 
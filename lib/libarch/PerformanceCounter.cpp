@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PerformanceCounter.h"
+
+PerformanceCounter::PerformanceCounter()
+    : m_count(0)
+    , m_mask(0)
+{
+    for (Size i = 0; i < MaximumCounters; i++)
+    {
+        m_events[i] = None;
+    }
+}
+
+Size PerformanceCounter::count() const
+{
+    return m_count;
+}
+
+u64 PerformanceCounter::mask() const
+{
+    return m_mask;
+}
+
+PerformanceCounter::Event PerformanceCounter::event(const Size index) const
+{
+    return index < m_count ? m_events[index] : None;
+}
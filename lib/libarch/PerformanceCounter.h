@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBARCH_PERFORMANCECOUNTER_H
+#define __LIBARCH_PERFORMANCECOUNTER_H
+
+#include <Types.h>
+#include <Macros.h>
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libarch
+ * @{
+ */
+
+/**
+ * Hardware performance counters interface.
+ *
+ * Each core has a small number of counters which are
+ * programmed to count one hardware event each.
+ */
+class PerformanceCounter
+{
+  public:
+
+    /** Maximum number of counters supported */
+    static const Size MaximumCounters = 4;
+
+    /**
+     * Result codes
+     */
+    enum Result
+    {
+        Success,
+        InvalidArgument,
+        NotSupported
+    };
+
+    /**
+     * Hardware events
+     */
+    enum Event
+    {
+        None = 0,
+        Cycles,
+        Instructions,
+        CacheMisses,
+        BranchMisses,
+        TLBMisses
+    };
+
+  public:
+
+    /**
+     * Constructor
+     */
+    PerformanceCounter();
+
+    /**
+     * Get number of available counters.
+     *
+     * @return Number of counters, at most MaximumCounters
+     */
+    Size count() const;
+
+    /**
+     * Get the mask of valid counter bits.
+     *
+     * @return Mask to apply to the difference between two counter values
+     */
+    u64 mask() const;
+
+    /**
+     * Get the event counted by a counter.
+     *
+     * @param index Counter number
+     *
+     * @return Event or None if the counter is disabled
+     */
+    Event event(const Size index) const;
+
+    /**
+     * Program a counter, which also resets it to zero.
+     *
+     * @param index Counter number
+     * @param event Event to count or None to disable the counter
+     *
+     * @return Result code
+     */
+    virtual Result configure(const Size index, const Event event) = 0;
+
+    /**
+     * Read the value of a counter.
+     *
+     * @param index Counter number
+     *
+     * @return Current counter value
+     */
+    virtual u64 read(const Size index) const = 0;
+
+  protected:
+
+    /** Number of available counters */
+    Size m_count;
+
+    /** Mask of valid counter bits */
+    u64 m_mask;
+
+    /** Event counted by each counter */
+    Event m_events[MaximumCounters];
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBARCH_PERFORMANCECOUNTER_H */
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBARCH_TICKETLOCK_H
+#define __LIBARCH_TICKETLOCK_H
+
+#include <Types.h>
+#include "Atomic.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libarch
+ * @{
+ */
+
+/**
+ * Spinlock which grants the lock in the order it was requested.
+ *
+ * Each core takes a ticket and waits until the owner counter reaches it.
+ * The lock contains no pointers, thus it can be placed in memory shared
+ * between processes and cores. Zeroed memory is an unlocked TicketLock.
+ */
+class TicketLock
+{
+  public:
+
+    /**
+     * Constructor.
+     */
+    TicketLock()
+        : m_next(0)
+        , m_owner(0)
+    {
+    }
+
+    /**
+     * Wait until the lock is acquired.
+     */
+    void lock()
+    {
+        const Size ticket = m_next.fetchAdd(1, MemoryRelaxed);
+
+        while (m_owner.load(MemoryAcquire) != ticket)
+        {
+            cpuRelax();
+        }
+    }
+
+    /**
+     * Acquire the lock only if it is free.
+     *
+     * @return True if acquired, false otherwise.
+     */
+    bool tryLock()
+    {
+        Size ticket = m_owner.load(MemoryRelaxed);
+
+        return m_next.compareExchange(ticket, ticket + 1, MemoryAcquire);
+    }
+
+    /**
+     * Release the lock to the next waiting core.
+     */
+    void unlock()
+    {
+        m_owner.store(m_owner.load(MemoryRelaxed) + 1, MemoryRelease);
+    }
+
+    /**
+     * Check if the lock is held.
+     *
+     * @return True if held, false otherwise.
+     */
+    bool isLocked() const
+    {
+        return m_next.load(MemoryRelaxed) != m_owner.load(MemoryRelaxed);
+    }
+
+  private:
+
+    /** Next ticket to hand out. */
+    Atomic<Size> m_next;
+
+    /** Ticket which currently owns the lock. */
+    Atomic<Size> m_owner;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBARCH_TICKETLOCK_H */
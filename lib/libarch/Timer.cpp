@@ -16,12 +16,20 @@
  */
 
 #include <MemoryBlock.h>
+#include <Atomic.h>
 #include "Timer.h"
 
 Timer::Timer()
     : m_ticks(0)
     , m_frequency(0)
     , m_int(0)
+    , m_interval(1)
+    , m_delayed(false)
+    , m_delayedCount(0)
+    , m_delayedFirst(0)
+    , m_idle(false)
+    , m_busyTicks(0)
+    , m_clockPage(ZERO)
 {
 }
 
@@ -56,6 +64,23 @@ Timer::Result Timer::getCurrent(Info *info,
     return Success;
 }
 
+void Timer::setClockPage(ClockPage *page)
+{
+    m_clockPage = page;
+    publish();
+}
+
+void Timer::setIdle(const bool idle)
+{
+    m_idle = idle;
+}
+
+u64 Timer::getTickTimestamp(Size *frequency) const
+{
+    *frequency = 0;
+    return 0;
+}
+
 Timer::Result Timer::initialize()
 {
     return Success;
@@ -73,15 +98,101 @@ Timer::Result Timer::stop()
 
 Timer::Result Timer::tick()
 {
-    m_ticks++;
+    m_ticks += m_interval;
+
+    if (!m_idle)
+        m_busyTicks += m_interval;
+
+    m_interval = 1;
+    m_delayed = false;
+    publish();
     return Success;
 }
 
+Timer::Result Timer::setNextInterrupt(const Size ticks)
+{
+    return ticks <= 1 ? Success : NotSupported;
+}
+
+u32 Timer::calculateNextInterrupt(const u32 remaining,
+                                  const Size ticks,
+                                  const u32 counterPerTick,
+                                  const u32 maximum)
+{
+    u32 next = remaining;
+    Size interval = ticks ? ticks : 1;
+
+    // Account for ticks which passed since the delayed interrupt was programmed
+    if (m_delayed)
+    {
+        const u32 elapsed = m_delayedCount - remaining;
+
+        if (elapsed >= m_delayedFirst)
+        {
+            const u32 passed = elapsed - m_delayedFirst;
+            m_ticks += 1 + (passed / counterPerTick);
+            next = counterPerTick - (passed % counterPerTick);
+        }
+        else
+        {
+            next = m_delayedFirst - elapsed;
+        }
+    }
+
+    // Limit to the maximum counter value of the hardware
+    if (interval > maximum / counterPerTick)
+    {
+        interval = maximum / counterPerTick;
+    }
+
+    m_interval = interval;
+    m_delayed = true;
+    m_delayedFirst = next;
+    m_delayedCount = next + ((interval - 1) * counterPerTick);
+
+    return m_delayedCount;
+}
+
 Timer::Result Timer::wait(u32 microseconds) const
 {
     return Success;
 }
 
+void Timer::publish()
+{
+    Size frequency = 0;
+
+    if (!m_clockPage)
+        return;
+
+    const u64 timestamp = getTickTimestamp(&frequency);
+
+    m_clockPage->sequence++;
+    memoryFence(MemoryRelease);
+
+    m_clockPage->ticks = m_ticks;
+    m_clockPage->frequency = m_frequency;
+    m_clockPage->timestamp = timestamp;
+    m_clockPage->busyTicks = m_busyTicks;
+
+    // Nanoseconds per cycle in fixed point. The shift leaves room for many
+    // ticks worth of cycles in the 64-bit product, which dynamic ticks need.
+    if (m_clockPage->timestampFrequency != frequency)
+    {
+        u32 shift = 24;
+
+        while (frequency && shift > 0 && (1000000ULL << shift) / frequency > 0xffffffffULL)
+            shift--;
+
+        m_clockPage->timestampFrequency = frequency;
+        m_clockPage->timestampMult = frequency ? (1000000ULL << shift) / frequency : 0;
+        m_clockPage->timestampShift = shift;
+    }
+
+    memoryFence(MemoryRelease);
+    m_clockPage->sequence++;
+}
+
 bool Timer::isExpired(const Timer::Info & info) const
 {
     if (!info.frequency)
@@ -20,6 +20,7 @@
 
 #include <Macros.h>
 #include <Types.h>
+#include "ClockPage.h"
 
 /**
  * @addtogroup lib
@@ -54,7 +55,8 @@ class Timer
         Success,
         NotFound,
         IOError,
-        InvalidFrequency
+        InvalidFrequency,
+        NotSupported
     };
 
     /**
@@ -96,6 +98,22 @@ class Timer
     virtual Result getCurrent(Info *info,
                               const Size msecOffset = 0);
 
+    /**
+     * Set the page to publish the timer state to.
+     *
+     * @param page ClockPage to update on each tick or ZERO to stop publishing.
+     */
+    void setClockPage(ClockPage *page);
+
+    /**
+     * Set whether the core runs the idle process.
+     *
+     * Ticks are counted as busy ticks while the core is not idle.
+     *
+     * @param idle True if the core switched to the idle process
+     */
+    void setIdle(const bool idle);
+
     /**
      * Initialize the timer.
      *
@@ -133,6 +151,20 @@ class Timer
      */
     virtual Result tick();
 
+    /**
+     * Delay the next timer interrupt.
+     *
+     * Used for dynamic ticks while the core is idle. The next timer interrupt
+     * is generated after the given number of ticks, and tick() accounts for all
+     * of them at once. After that interrupt the timer returns to periodic ticks.
+     * A value of one cancels a delayed interrupt at the next tick boundary.
+     *
+     * @param ticks Number of ticks until the next interrupt.
+     *
+     * @return Result code.
+     */
+    virtual Result setNextInterrupt(const Size ticks);
+
     /**
      * Busy wait a number of microseconds.
      *
@@ -153,6 +185,37 @@ class Timer
      */
     bool isExpired(const Info & info) const;
 
+    /**
+     * Get the timestamp counter value at the start of the current tick.
+     *
+     * @param frequency Receives the timestamp counter frequency in kHz
+     *                  or zero if the timer does not track a timestamp counter.
+     *
+     * @return Timestamp counter value
+     */
+    virtual u64 getTickTimestamp(Size *frequency) const;
+
+  protected:
+
+    /**
+     * Calculate the counter value for a delayed interrupt.
+     *
+     * Accounts for the ticks that passed since a previously delayed interrupt
+     * was programmed, such that the tick count stays correct when the delay
+     * is changed before the interrupt fires.
+     *
+     * @param remaining Counter value remaining until the currently programmed interrupt
+     * @param ticks Number of ticks until the next interrupt
+     * @param counterPerTick Counter value for a single tick
+     * @param maximum Maximum counter value supported by the hardware
+     *
+     * @return Counter value to program
+     */
+    u32 calculateNextInterrupt(const u32 remaining,
+                               const Size ticks,
+                               const u32 counterPerTick,
+                               const u32 maximum);
+
   protected:
 
     /** The current timer ticks */
@@ -163,6 +226,36 @@ class Timer
 
     /** Timer interrupt number. */
     Size m_int;
+
+    /** Number of ticks to account on the next interrupt. */
+    Size m_interval;
+
+    /** True if the next interrupt is delayed by setNextInterrupt(). */
+    bool m_delayed;
+
+    /** Counter value of the delayed interrupt when it was programmed. */
+    u32 m_delayedCount;
+
+    /** Counter value until the first tick boundary of the delayed interrupt. */
+    u32 m_delayedFirst;
+
+    /** True while the core runs the idle process. */
+    bool m_idle;
+
+    /** Ticks in which the core was not idle. */
+    Size m_busyTicks;
+
+  private:
+
+    /**
+     * Write the current tick to the ClockPage.
+     */
+    void publish();
+
+  private:
+
+    /** Page to publish the timer state to, if any. */
+    ClockPage *m_clockPage;
 };
 
 /**
@@ -114,3 +114,77 @@ ARMCacheV6::Result ARMCacheV6::invalidateAddress(ARMCacheV6::Type type, Address
 {
     return ARMCacheV6::NotSupported;
 }
+
+ARMCacheV6::Result ARMCacheV6::cleanRange(ARMCacheV6::Type type, Address addr, Size size)
+{
+    const Address end = addr + size;
+
+    for (Address line = addr & ~(LineSize - 1); line < end; line += LineSize)
+    {
+        switch (type)
+        {
+            case Instruction:
+                break;
+
+            case Data:
+                mcr(p15, 0, 1, c7, c10, line);
+                break;
+
+            case Unified:
+                return ARMCacheV6::IOError;
+        }
+    }
+
+    dsb();
+    return Success;
+}
+
+ARMCacheV6::Result ARMCacheV6::invalidateRange(ARMCacheV6::Type type, Address addr, Size size)
+{
+    const Address end = addr + size;
+
+    for (Address line = addr & ~(LineSize - 1); line < end; line += LineSize)
+    {
+        switch (type)
+        {
+            case Instruction:
+                mcr(p15, 0, 1, c7, c5, line);
+                break;
+
+            case Data:
+                mcr(p15, 0, 1, c7, c6, line);
+                break;
+
+            case Unified:
+                return ARMCacheV6::IOError;
+        }
+    }
+
+    dsb();
+    return Success;
+}
+
+ARMCacheV6::Result ARMCacheV6::cleanInvalidateRange(ARMCacheV6::Type type, Address addr, Size size)
+{
+    const Address end = addr + size;
+
+    for (Address line = addr & ~(LineSize - 1); line < end; line += LineSize)
+    {
+        switch (type)
+        {
+            case Instruction:
+                mcr(p15, 0, 1, c7, c5, line);
+                break;
+
+            case Data:
+                mcr(p15, 0, 1, c7, c14, line);
+                break;
+
+            case Unified:
+                return ARMCacheV6::IOError;
+        }
+    }
+
+    dsb();
+    return Success;
+}
@@ -80,20 +80,35 @@ ARMCacheV7::Result ARMCacheV7::cleanInvalidate(ARMCacheV7::Type type)
 }
 
 ARMCacheV7::Result ARMCacheV7::cleanInvalidateAddress(Type type, Address addr)
+{
+    return cleanInvalidateRange(type, addr & PAGEMASK, PAGESIZE);
+}
+
+ARMCacheV7::Result ARMCacheV7::cleanAddress(ARMCacheV7::Type type, Address addr)
+{
+    return cleanRange(type, addr & PAGEMASK, PAGESIZE);
+}
+
+ARMCacheV7::Result ARMCacheV7::invalidateAddress(ARMCacheV7::Type type, Address addr)
+{
+    return invalidateRange(type, addr & PAGEMASK, PAGESIZE);
+}
+
+ARMCacheV7::Result ARMCacheV7::cleanRange(ARMCacheV7::Type type, Address addr, Size size)
 {
     const u32 lineSize = getCacheLineSize();
-    const u32 pageAddr = addr & PAGEMASK;
+    const Address end = addr + size;
 
-    for (Address i = 0; i < PAGESIZE; i += lineSize)
+    for (Address line = addr & ~(lineSize - 1); line < end; line += lineSize)
     {
         switch (type)
         {
             case Instruction:
-                mcr(p15, 0, 1, c7, c5, pageAddr + i);
+                mcr(p15, 0, 1, c7,  c5, line);
                 break;
 
             case Data:
-                mcr(p15, 0, 1, c7, c14, pageAddr + i);
+                mcr(p15, 0, 1, c7, c10, line);
                 break;
 
             case Unified:
@@ -101,27 +116,26 @@ ARMCacheV7::Result ARMCacheV7::cleanInvalidateAddress(Type type, Address addr)
         }
     }
 
-    isb();
     dsb();
+    isb();
 
     return Success;
 }
 
-ARMCacheV7::Result ARMCacheV7::cleanAddress(ARMCacheV7::Type type, Address addr)
+ARMCacheV7::Result ARMCacheV7::invalidateRange(ARMCacheV7::Type type, Address addr, Size size)
 {
     const u32 lineSize = getCacheLineSize();
-    const u32 pageAddr = addr & PAGEMASK;
+    const Address end = addr + size;
 
-    for (Address i = 0; i < PAGESIZE; i += lineSize)
+    for (Address line = addr & ~(lineSize - 1); line < end; line += lineSize)
     {
         switch (type)
         {
             case Instruction:
-                mcr(p15, 0, 1, c7,  c5, pageAddr + i);
-                break;
+                return ARMCacheV7::IOError;
 
             case Data:
-                mcr(p15, 0, 1, c7, c10, pageAddr + i);
+                mcr(p15, 0, 1, c7, c6, line);
                 break;
 
             case Unified:
@@ -130,25 +144,24 @@ ARMCacheV7::Result ARMCacheV7::cleanAddress(ARMCacheV7::Type type, Address addr)
     }
 
     dsb();
-    isb();
-
     return Success;
 }
 
-ARMCacheV7::Result ARMCacheV7::invalidateAddress(ARMCacheV7::Type type, Address addr)
+ARMCacheV7::Result ARMCacheV7::cleanInvalidateRange(ARMCacheV7::Type type, Address addr, Size size)
 {
     const u32 lineSize = getCacheLineSize();
-    const u32 pageAddr = addr & PAGEMASK;
+    const Address end = addr + size;
 
-    for (Address i = 0; i < PAGESIZE; i += lineSize)
+    for (Address line = addr & ~(lineSize - 1); line < end; line += lineSize)
     {
         switch (type)
         {
             case Instruction:
-                return ARMCacheV7::IOError;
+                mcr(p15, 0, 1, c7, c5, line);
+                break;
 
             case Data:
-                mcr(p15, 0, 1, c7, c6, pageAddr + i);
+                mcr(p15, 0, 1, c7, c14, line);
                 break;
 
             case Unified:
@@ -156,7 +169,9 @@ ARMCacheV7::Result ARMCacheV7::invalidateAddress(ARMCacheV7::Type type, Address
         }
     }
 
+    isb();
     dsb();
+
     return Success;
 }
 
@@ -107,6 +107,39 @@ class ARMCacheV7 : public Cache
      */
     virtual Result invalidateAddress(Type type, Address addr);
 
+    /**
+     * Clean a range of memory.
+     *
+     * @param type Cache type to clean
+     * @param addr Virtual memory address of the first byte to clean
+     * @param size Number of bytes to clean
+     *
+     * @return Result code
+     */
+    virtual Result cleanRange(Type type, Address addr, Size size);
+
+    /**
+     * Invalidate a range of memory.
+     *
+     * @param type Cache type to invalidate
+     * @param addr Virtual memory address of the first byte to invalidate
+     * @param size Number of bytes to invalidate
+     *
+     * @return Result code
+     */
+    virtual Result invalidateRange(Type type, Address addr, Size size);
+
+    /**
+     * Clean and invalidate a range of memory.
+     *
+     * @param type Cache type to clean and invalidate
+     * @param addr Virtual memory address of the first byte to clean and invalidate
+     * @param size Number of bytes to clean and invalidate
+     *
+     * @return Result code
+     */
+    virtual Result cleanInvalidateRange(Type type, Address addr, Size size);
+
   private:
 
     /**
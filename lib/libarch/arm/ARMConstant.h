@@ -123,6 +123,9 @@
 /** Mask for large 1MiB section mappings. */
 #define SECTIONMASK     0xfff00000
 
+/** Size of a large 1MiB section mapping. */
+#define SECTIONSIZE     0x100000
+
 /** Memory address alignment. */
 #define MEMALIGN        4
 
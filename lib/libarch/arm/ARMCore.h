@@ -89,12 +89,26 @@
     asm volatile("mcrr " QUOTE(coproc) ", " QUOTE(opcode1) ", %Q0, %R0, " QUOTE(CRm) "\n" : : "r"(val) : "memory"); \
 })
 
+#ifdef ARMV7
+/**
+ * Reads the CPU's timestamp counter.
+ *
+ * Uses the 32-bit cycle counter (PMCCNTR) of the Performance Monitors
+ * extension, which is enabled by the kernel for both kernel and user mode.
+ * The value wraps around, thus only the lower 32-bits of a difference between
+ * two timestamps are meaningful.
+ *
+ * @return 64-bit integer.
+ */
+#define timestamp() ((u64) mrc(p15, 0, 0, c9, c13))
+#else
 /**
  * Reads the CPU's timestamp counter.
  *
  * @return 64-bit integer.
  */
 #define timestamp() 0
+#endif /* ARMV7 */
 
 /**
  * Reboot the system
@@ -133,6 +147,36 @@
 #define sysctrl_write(val) \
     mcr(p15, 0, 0, c1, c0, (val))
 
+/**
+ * Read Coprocessor Access Control Register (CPACR)
+ */
+#define cpacr_read() \
+    (mrc(p15, 0, 2, c1, c0))
+
+/**
+ * Write Coprocessor Access Control Register (CPACR)
+ */
+#define cpacr_write(val) \
+    mcr(p15, 0, 2, c1, c0, (val))
+
+/** CPACR bits for full access to the VFP coprocessors cp10 and cp11 */
+#define CPACR_VFP_ACCESS (0xf << 20)
+
+/**
+ * Read Floating-Point Exception Control register (FPEXC)
+ */
+#define fpexc_read() \
+    (mrc(p10, 7, 0, c8, c0))
+
+/**
+ * Write Floating-Point Exception Control register (FPEXC)
+ */
+#define fpexc_write(val) \
+    mcr(p10, 7, 0, c8, c0, (val))
+
+/** FPEXC bit to enable the VFP */
+#define FPEXC_EN (1 << 30)
+
 /**
  * Read unique core identifier.
  *
@@ -169,6 +213,14 @@ inline void tlb_flush_all()
     mcr(p15, 0, 1, c8, c7, (page)); \
 })
 
+/**
+ * Invalidate all non-global TLB entries tagged with an ASID.
+ */
+#define tlb_invalidate_asid(asid) \
+({ \
+    mcr(p15, 0, 2, c8, c7, (asid)); \
+})
+
 /**
  * Data Memory Barrier
  *
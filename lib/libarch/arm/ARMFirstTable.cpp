@@ -17,7 +17,6 @@
 
 #include <FreeNOS/System.h>
 #include <SplitAllocator.h>
-#include <MemoryBlock.h>
 #include "ARMCore.h"
 #include "ARMConstant.h"
 #include "ARMFirstTable.h"
@@ -96,6 +95,9 @@
 /* System access permissions flag */
 #define PAGE1_AP_SYS    (1 << 10)
 
+/* Not-global flag: translation is tagged with the ASID */
+#define PAGE1_NOTGLOBAL (1 << 17)
+
 /**
  * @}
  */
@@ -142,14 +144,12 @@ MemoryContext::Result ARMFirstTable::map(Address virt,
         allocPhys.size = sizeof(ARMSecondTable);
         allocPhys.alignment = PAGESIZE;
 
-        if (alloc->allocate(allocPhys, allocVirt) != Allocator::Success)
+        if (alloc->allocateZeroed(allocPhys, allocVirt) != Allocator::Success)
             return MemoryContext::OutOfMemory;
 
-        MemoryBlock::set((void *)allocVirt.address, 0, PAGESIZE);
-
         // Assign to the page directory. Do not assign permission flags (only for direct sections).
         m_tables[ DIRENTRY(virt) ] = allocPhys.address | PAGE1_TABLE;
-        cache.cleanData(&m_tables[DIRENTRY(virt)]);
+        cache.cleanRange(Cache::Data, (Address) &m_tables[DIRENTRY(virt)], sizeof(m_tables[0]));
         table = getSecondTable(virt, alloc);
     }
     return table->map(virt, phys, access);
@@ -160,10 +160,10 @@ MemoryContext::Result ARMFirstTable::mapLarge(Memory::Range range,
 {
     Arch::Cache cache;
 
-    if (range.size & 0xfffff)
+    if (range.size & ~SECTIONMASK)
         return MemoryContext::InvalidSize;
 
-    if ((range.phys & ~PAGEMASK) || (range.virt & ~PAGEMASK))
+    if ((range.phys & ~SECTIONMASK) || (range.virt & ~SECTIONMASK))
         return MemoryContext::InvalidAddress;
 
     for (Size i = 0; i < range.size; i += MegaByte(1))
@@ -172,8 +172,38 @@ MemoryContext::Result ARMFirstTable::mapLarge(Memory::Range range,
             return MemoryContext::AlreadyExists;
 
         m_tables[ DIRENTRY(range.virt + i) ] = (range.phys + i) | PAGE1_SECTION | flags(range.access);
-        cache.cleanData(&m_tables[DIRENTRY(range.virt + i)]);
+        cache.cleanRange(Cache::Data, (Address) &m_tables[DIRENTRY(range.virt + i)], sizeof(m_tables[0]));
+    }
+    return MemoryContext::Success;
+}
+
+MemoryContext::Result ARMFirstTable::mapRange(Memory::Range range,
+                                              SplitAllocator *alloc)
+{
+    for (Size i = 0; i < range.size; )
+    {
+        const Size remain = SECTIONSIZE - ((range.virt + i) & ~SECTIONMASK);
+        const Size chunk = range.size - i < remain ? range.size - i : remain;
+
+        // The first page allocates the second level table, if needed
+        MemoryContext::Result r = map(range.virt + i, range.phys + i, range.access, alloc);
+        if (r != MemoryContext::Success)
+            return r;
+
+        // Fill the remainder of the second level table at once
+        if (chunk > PAGESIZE)
+        {
+            const Memory::Range rest = { range.virt + i + PAGESIZE, range.phys + i + PAGESIZE,
+                                         chunk - PAGESIZE, range.access };
+
+            r = getSecondTable(range.virt + i, alloc)->mapRange(rest);
+            if (r != MemoryContext::Success)
+                return r;
+        }
+
+        i += chunk;
     }
+
     return MemoryContext::Success;
 }
 
@@ -184,17 +214,87 @@ MemoryContext::Result ARMFirstTable::unmap(Address virt, SplitAllocator *alloc)
 
     if (!table)
     {
-        if (m_tables[DIRENTRY(virt)] & PAGE1_SECTION)
+        if (!(m_tables[DIRENTRY(virt)] & PAGE1_SECTION))
+            return MemoryContext::InvalidAddress;
+
+        const MemoryContext::Result r = splitLarge(virt, alloc);
+        if (r != MemoryContext::Success)
+            return r;
+
+        table = getSecondTable(virt, alloc);
+    }
+
+    return table->unmap(virt);
+}
+
+MemoryContext::Result ARMFirstTable::unmapLarge(Address virt)
+{
+    Arch::Cache cache;
+
+    if (virt & ~SECTIONMASK)
+        return MemoryContext::InvalidAddress;
+
+    if (!(m_tables[DIRENTRY(virt)] & PAGE1_SECTION))
+        return MemoryContext::InvalidAddress;
+
+    m_tables[DIRENTRY(virt)] = PAGE1_NONE;
+    cache.cleanRange(Cache::Data, (Address) &m_tables[DIRENTRY(virt)], sizeof(m_tables[0]));
+    return MemoryContext::Success;
+}
+
+MemoryContext::Result ARMFirstTable::unmapRange(Memory::Range range,
+                                                SplitAllocator *alloc)
+{
+    for (Size i = 0; i < range.size; )
+    {
+        const Size remain = SECTIONSIZE - ((range.virt + i) & ~SECTIONMASK);
+        const Size chunk = range.size - i < remain ? range.size - i : remain;
+
+        // The first page splits a section, if needed
+        MemoryContext::Result r = unmap(range.virt + i, alloc);
+        if (r != MemoryContext::Success)
+            return r;
+
+        // Clear the remainder of the second level table at once
+        if (chunk > PAGESIZE)
         {
-            m_tables[DIRENTRY(virt)] = PAGE1_NONE;
-            cache.cleanData(&m_tables[DIRENTRY(virt)]);
-            return MemoryContext::Success;
+            const Memory::Range rest = { range.virt + i + PAGESIZE, ZERO,
+                                         chunk - PAGESIZE, range.access };
+
+            getSecondTable(range.virt + i, alloc)->unmapRange(rest);
         }
-        else
-            return MemoryContext::InvalidAddress;
+
+        i += chunk;
     }
-    else
-        return table->unmap(virt);
+
+    return MemoryContext::Success;
+}
+
+MemoryContext::Result ARMFirstTable::splitLarge(Address virt,
+                                                SplitAllocator *alloc)
+{
+    const u32 entry = m_tables[ DIRENTRY(virt) ];
+    const Memory::Access access = largeAccess(entry);
+    const Address base = virt & SECTIONMASK;
+    Arch::Cache cache;
+    Allocator::Range allocPhys, allocVirt;
+
+    // Allocate a new page table
+    allocPhys.address = 0;
+    allocPhys.size = sizeof(ARMSecondTable);
+    allocPhys.alignment = PAGESIZE;
+
+    if (alloc->allocateZeroed(allocPhys, allocVirt) != Allocator::Success)
+        return MemoryContext::OutOfMemory;
+
+    // Fill the page table with the same mappings before it becomes visible
+    ARMSecondTable *table = (ARMSecondTable *) allocVirt.address;
+    for (Size i = 0; i < MegaByte(1); i += PAGESIZE)
+        table->map(base + i, (entry & SECTIONMASK) + i, access);
+
+    m_tables[ DIRENTRY(virt) ] = allocPhys.address | PAGE1_TABLE;
+    cache.cleanRange(Cache::Data, (Address) &m_tables[DIRENTRY(virt)], sizeof(m_tables[0]));
+    return MemoryContext::Success;
 }
 
 MemoryContext::Result ARMFirstTable::translate(Address virt,
@@ -224,11 +324,36 @@ MemoryContext::Result ARMFirstTable::access(Address virt,
 {
     ARMSecondTable *table = getSecondTable(virt, alloc);
     if (!table)
+    {
+        if (m_tables[DIRENTRY(virt)] & PAGE1_SECTION)
+        {
+            *access = largeAccess(m_tables[DIRENTRY(virt)]);
+            return MemoryContext::Success;
+        }
         return MemoryContext::InvalidAddress;
+    }
     else
         return table->access(virt, access);
 }
 
+Memory::Access ARMFirstTable::largeAccess(u32 entry) const
+{
+    const u32 caching = entry & (PAGE1_TEX | PAGE1_CACHE | PAGE1_BUFFER);
+    Memory::Access access = Memory::Readable;
+
+    // Permissions
+    if (!(entry & PAGE1_NOEXEC))  access |= Memory::Executable;
+    if ((entry & PAGE1_AP_USER))  access |= Memory::User;
+    if (!(entry & PAGE1_APX))     access |= Memory::Writable;
+
+    // Caching
+    if (caching == PAGE1_DEVICE_SHARED) access |= Memory::Device;
+    else if (caching == PAGE1_UNCACHED) access |= Memory::Uncached;
+    else                                access |= Memory::InnerCached | Memory::OuterCached;
+
+    return access;
+}
+
 u32 ARMFirstTable::flags(Memory::Access access) const
 {
     u32 f = PAGE1_AP_SYS;
@@ -238,6 +363,11 @@ u32 ARMFirstTable::flags(Memory::Access access) const
     if ((access & Memory::User))        f |= PAGE1_AP_USER;
     if (!(access & Memory::Writable))   f |= PAGE1_APX;
 
+#ifdef ARMV7
+    // User mappings are private to the ASID of the MemoryContext
+    if ((access & Memory::User))        f |= PAGE1_NOTGLOBAL;
+#endif
+
     // Caching
     if (access & Memory::Device)        f |= PAGE1_DEVICE_SHARED;
     else if (access & Memory::Uncached) f |= PAGE1_UNCACHED;
@@ -274,6 +404,26 @@ MemoryContext::Result ARMFirstTable::releaseRange(const Memory::Range range,
     // Walk the full range of memory specified
     for (Size addr = range.virt; addr < range.virt + range.size; addr += PAGESIZE)
     {
+        if (m_tables[ DIRENTRY(addr) ] & PAGE1_SECTION)
+        {
+            // Release a section at once if fully covered
+            if (!(addr & ~SECTIONMASK) && range.virt + range.size - addr >= MegaByte(1))
+            {
+                phys = m_tables[ DIRENTRY(addr) ] & SECTIONMASK;
+
+                for (Size i = 0; i < MegaByte(1); i += PAGESIZE)
+                    releasePhysical(alloc, phys + i);
+
+                unmapLarge(addr);
+                addr += MegaByte(1) - PAGESIZE;
+                continue;
+            }
+            else if (splitLarge(addr, alloc) != MemoryContext::Success)
+            {
+                return MemoryContext::OutOfMemory;
+            }
+        }
+
         ARMSecondTable *table = getSecondTable(addr, alloc);
         if (table == ZERO)
         {
@@ -310,6 +460,18 @@ MemoryContext::Result ARMFirstTable::releaseSection(const Memory::Range range,
         ARMSecondTable *table = getSecondTable(addr, alloc);
         if (!table)
         {
+            // Release sections directly
+            if (m_tables[ DIRENTRY(addr) ] & PAGE1_SECTION)
+            {
+                if (!tablesOnly)
+                {
+                    phys = m_tables[ DIRENTRY(addr) ] & SECTIONMASK;
+
+                    for (Size i = 0; i < MegaByte(1); i += PAGESIZE)
+                        releasePhysical(alloc, phys + i);
+                }
+                m_tables[ DIRENTRY(addr) ] = 0;
+            }
             continue;
         }
 
@@ -331,3 +493,16 @@ MemoryContext::Result ARMFirstTable::releaseSection(const Memory::Range range,
 
     return MemoryContext::Success;
 }
+
+Size ARMFirstTable::countTables() const
+{
+    Size count = 0;
+
+    for (Size i = 0; i < sizeof(m_tables) / sizeof(m_tables[0]); i++)
+    {
+        if (m_tables[i] & PAGE1_TABLE)
+            count++;
+    }
+
+    return count;
+}
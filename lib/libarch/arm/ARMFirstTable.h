@@ -72,9 +72,26 @@ class ARMFirstTable
     MemoryContext::Result mapLarge(Memory::Range range,
                                    SplitAllocator *alloc);
 
+    /**
+     * Map a range of contiguous physical pages.
+     *
+     * Each second level table covered by the range is looked
+     * up once and its entries are written back to memory at once.
+     *
+     * @param range Virtual to physical memory range.
+     * @param alloc Physical memory allocator for extra page tables.
+     *
+     * @return Result code
+     */
+    MemoryContext::Result mapRange(Memory::Range range,
+                                   SplitAllocator *alloc);
+
     /**
      * Remove virtual address mapping.
      *
+     * A section containing the address is first
+     * split into a second level table, if needed.
+     *
      * @param virt Virtual address.
      * @param alloc Physical memory allocator
      *
@@ -83,6 +100,29 @@ class ARMFirstTable
     MemoryContext::Result unmap(Address virt,
                                 SplitAllocator *alloc);
 
+    /**
+     * Remove a 1 megabyte section mapping.
+     *
+     * @param virt Virtual address aligned to 1 megabyte.
+     *
+     * @return Result code
+     */
+    MemoryContext::Result unmapLarge(Address virt);
+
+    /**
+     * Remove the mappings of a range of pages.
+     *
+     * Each second level table covered by the range is looked
+     * up once and its entries are written back to memory at once.
+     *
+     * @param range Range of virtual addresses.
+     * @param alloc Physical memory allocator
+     *
+     * @return Result code
+     */
+    MemoryContext::Result unmapRange(Memory::Range range,
+                                     SplitAllocator *alloc);
+
     /**
      * Translate virtual address to physical address.
      *
@@ -133,6 +173,13 @@ class ARMFirstTable
     MemoryContext::Result releaseRange(const Memory::Range range,
                                        SplitAllocator *alloc);
 
+    /**
+     * Count the second level page tables.
+     *
+     * @return Number of second level page tables present
+     */
+    Size countTables() const;
+
   private:
 
     /**
@@ -155,6 +202,26 @@ class ARMFirstTable
     ARMSecondTable * getSecondTable(Address virt,
                                     SplitAllocator *alloc) const;
 
+    /**
+     * Replace a section mapping by a second level table with the same mappings
+     *
+     * @param virt Virtual address inside the section
+     * @param alloc Physical memory allocator for the new table
+     *
+     * @return Result code
+     */
+    MemoryContext::Result splitLarge(Address virt,
+                                     SplitAllocator *alloc);
+
+    /**
+     * Convert first level section flags to Memory::Access.
+     *
+     * @param entry First level page table entry
+     *
+     * @return Memory access flags
+     */
+    Memory::Access largeAccess(u32 entry) const;
+
     /**
      * Convert Memory::Access to first level page table flags.
      *
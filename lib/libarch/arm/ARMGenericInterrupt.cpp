@@ -134,6 +134,23 @@ bool ARMGenericInterrupt::isTriggered(uint irq)
     return false;
 }
 
+ARMGenericInterrupt::Result ARMGenericInterrupt::setAffinity(const uint irq,
+                                                             const uint coreId)
+{
+    if (irq >= m_numIrqs || coreId >= MaximumCores)
+        return InvalidIRQ;
+
+    if (irq < NumberOfPrivateInterrupts)
+        return Success;
+
+    // Each target register holds one byte of target cores for four IRQs
+    const Address reg = GICD_ITARGETSR + (irq & ~3);
+    const Size shift = (irq % 4) * 8;
+
+    m_dist.write(reg, (m_dist.read(reg) & ~(0xff << shift)) | ((1 << coreId) << shift));
+    return Success;
+}
+
 Size ARMGenericInterrupt::numRegisters(Size bits) const
 {
     if (m_numIrqs % 32)
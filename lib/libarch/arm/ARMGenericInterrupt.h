@@ -42,6 +42,12 @@ class ARMGenericInterrupt : public IntController
     /** Total number of software generated interrupts (SGI) */
     static const Size NumberOfSoftwareInterrupts = 16;
 
+    /** Total number of banked interrupts (SGI and PPI) */
+    static const Size NumberOfPrivateInterrupts = 32;
+
+    /** Maximum number of CPU interfaces */
+    static const Size MaximumCores = 8;
+
     /**
      * Distributor register interface
      */
@@ -177,6 +183,19 @@ class ARMGenericInterrupt : public IntController
      */
     virtual bool isTriggered(uint irq);
 
+    /**
+     * Route a shared peripheral interrupt (SPI) to a core.
+     *
+     * Private and software generated interrupts are banked
+     * per core and always delivered to the local core.
+     *
+     * @param irq Interrupt Request number
+     * @param coreId Core which receives the interrupt
+     *
+     * @return Result code
+     */
+    virtual Result setAffinity(const uint irq, const uint coreId);
+
   private:
 
     /**
@@ -73,31 +73,145 @@ class ARMIO : public IO
     /**
      * Read a number of 32-bit values.
      *
+     * Word aligned buffers are copied in bursts of four words using
+     * load and store multiple, with a single barrier before and after.
+     *
      * @param addr Address of the starting 32-bit value.
      * @param count Number of bytes to read.
      * @param buf Output buffer.
      */
     inline void read(Address addr, Size count, void *buf) const
     {
-        for (Size i = 0; i < count; i+= sizeof(u32))
+        const volatile u32 *src = (const volatile u32 *) (addr + m_base);
+        u8 *dst = (u8 *) buf;
+
+        dmb();
+
+        if (!((Address) dst & (sizeof(u32) - 1)))
         {
-            *(u32 *)(((u8 *)buf) + i) = read(addr + i);
+            for (; count >= sizeof(u32) * 4; count -= sizeof(u32) * 4)
+            {
+                asm volatile("ldmia %[src]!, {r3-r6}\n"
+                             "stmia %[dst]!, {r3-r6}\n"
+                             : [src]"+r"(src), [dst]"+r"(dst)
+                             : : "r3", "r4", "r5", "r6", "memory");
+            }
         }
+
+        for (; count > 0; src++)
+        {
+            const u32 value = *src;
+
+            if (count >= sizeof(u32) && !((Address) dst & (sizeof(u32) - 1)))
+            {
+                *(u32 *) dst = value;
+                dst   += sizeof(u32);
+                count -= sizeof(u32);
+                continue;
+            }
+
+            for (Size i = 0; i < sizeof(u32) && count > 0; i++, count--)
+            {
+                *dst++ = value >> (i * 8);
+            }
+        }
+
+        dmb();
     }
 
     /**
      * Write a number of 32-bit values.
      *
+     * Word aligned buffers are copied in bursts of four words using
+     * load and store multiple, with a single barrier before and after.
+     * A partial last value is padded with zeroes.
+     *
      * @param addr Address of the starting 32-bit value.
      * @param count Number of bytes to write.
      * @param buf Input buffer.
      */
     inline void write(Address addr, Size count, const void *buf)
     {
-        for (Size i = 0; i < count; i+= sizeof(u32))
+        volatile u32 *dst = (volatile u32 *) (addr + m_base);
+        const u8 *src = (const u8 *) buf;
+
+        dmb();
+
+        if (!((Address) src & (sizeof(u32) - 1)))
+        {
+            for (; count >= sizeof(u32) * 4; count -= sizeof(u32) * 4)
+            {
+                asm volatile("ldmia %[src]!, {r3-r6}\n"
+                             "stmia %[dst]!, {r3-r6}\n"
+                             : [src]"+r"(src), [dst]"+r"(dst)
+                             : : "r3", "r4", "r5", "r6", "memory");
+            }
+        }
+
+        for (; count > 0; dst++)
+        {
+            u32 value = 0;
+
+            if (count >= sizeof(u32) && !((Address) src & (sizeof(u32) - 1)))
+            {
+                *dst   = *(const u32 *) src;
+                src   += sizeof(u32);
+                count -= sizeof(u32);
+                continue;
+            }
+
+            for (Size i = 0; i < sizeof(u32) && count > 0; i++, count--)
+            {
+                value |= ((u32) *src++) << (i * 8);
+            }
+            *dst = value;
+        }
+
+        dmb();
+    }
+
+    /**
+     * Read 32-bit values from a single memory mapped FIFO register.
+     *
+     * @param addr Address of the FIFO register.
+     * @param count Number of bytes to read, a multiple of four.
+     * @param buf Output buffer.
+     */
+    inline void readFifo(const Address addr, const Size count, void *buf) const
+    {
+        const volatile u32 *ptr = (const volatile u32 *) (addr + m_base);
+        u32 *dst = (u32 *) buf;
+
+        dmb();
+
+        for (Size i = 0; i < count / sizeof(u32); i++)
         {
-            write(addr + i, *(u32 *) (((u8 *)buf) + i));
+            dst[i] = *ptr;
         }
+
+        dmb();
+    }
+
+    /**
+     * Write 32-bit values to a single memory mapped FIFO register.
+     *
+     * @param addr Address of the FIFO register.
+     * @param count Number of bytes to write, a multiple of four.
+     * @param buf Input buffer.
+     */
+    inline void writeFifo(const Address addr, const Size count, const void *buf)
+    {
+        volatile u32 *ptr = (volatile u32 *) (addr + m_base);
+        const u32 *src = (const u32 *) buf;
+
+        dmb();
+
+        for (Size i = 0; i < count / sizeof(u32); i++)
+        {
+            *ptr = src[i];
+        }
+
+        dmb();
     }
 
     /**
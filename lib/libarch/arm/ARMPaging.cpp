@@ -25,11 +25,19 @@
 #include "ARMPaging.h"
 #include "ARMFirstTable.h"
 
+/** Current ASID generation of this core */
+static u32 asidGeneration = 1;
+
+/** Next free ASID in the current generation */
+static u32 asidNext = 1;
+
 ARMPaging::ARMPaging(MemoryMap *map, SplitAllocator *alloc)
     : MemoryContext(map, alloc)
     , m_firstTable(0)
     , m_firstTableAddr(0)
     , m_kernelBaseAddr(coreInfo.memory.phys)
+    , m_asid(0)
+    , m_asidGeneration(0)
 {
 }
 
@@ -49,6 +57,8 @@ ARMPaging::ARMPaging(MemoryMap *map,
     , m_firstTable((ARMFirstTable *) firstTableAddress)
     , m_firstTableAddr(firstTableAddress)
     , m_kernelBaseAddr(kernelBaseAddress)
+    , m_asid(0)
+    , m_asidGeneration(0)
 {
 }
 
@@ -86,7 +96,7 @@ MemoryContext::Result ARMPaging::initialize()
     // Temporary stack is used for kernel initialization code
     // and for SMP the temporary stack is shared between cores.
     // This is needed in order to perform early-MMU enable.
-    m_firstTable->unmap(TMPSTACKADDR, m_alloc);
+    m_firstTable->unmapLarge(TMPSTACKADDR);
 
     const Memory::Range tmpStackRange = {
         TMPSTACKADDR, TMPSTACKADDR, MegaByte(1), Memory::Readable|Memory::Writable
@@ -96,7 +106,7 @@ MemoryContext::Result ARMPaging::initialize()
 
     // Unmap I/O zone
     for (Size i = 0; i < IO_SIZE; i += MegaByte(1))
-        m_firstTable->unmap(IO_BASE + i, m_alloc);
+        m_firstTable->unmapLarge(IO_BASE + i);
 
     // Map the I/O zone as Device / Uncached memory.
     Memory::Range io;
@@ -203,6 +213,10 @@ MemoryContext::Result ARMPaging::activate(bool initializeMMU)
     if (initializeMMU)
     {
         enableMMU();
+#ifdef ARMV7
+        ctrl.write(ARMControl::ContextID, assignASID());
+        isb();
+#endif /* ARMV7 */
     }
     // MMU already enabled, we only need to change first level table and flush caches.
     else
@@ -217,14 +231,26 @@ MemoryContext::Result ARMPaging::activate(bool initializeMMU)
         m_cache.cleanInvalidate(Cache::Unified);
 #endif /* ARMV6 */
 
+#ifdef ARMV7
+        // Use the reserved ASID while both tables may be walked
+        ctrl.write(ARMControl::ContextID, 0);
+        isb();
+#endif /* ARMV7 */
+
         // Switch first page table and re-enable L1 caching
         ctrl.write(ARMControl::TranslationTable0, (((u32) m_firstTableAddr) |
             (1 << 3) | /* outer write-back, write-allocate */
             (1 << 6)   /* inner write-back, write-allocate */
         ));
 
+#ifdef ARMV7
+        // User translations are tagged with the ASID, so no flush is needed
+        isb();
+        ctrl.write(ARMControl::ContextID, assignASID());
+#else
         // Flush TLB caches
         tlb_flush_all();
+#endif /* ARMV7 */
 
         // Synchronize execution stream
         isb();
@@ -240,8 +266,7 @@ MemoryContext::Result ARMPaging::map(Address virt, Address phys, Memory::Access
     Result r = m_firstTable->map(virt, phys, acc, m_alloc);
 
     // Flush the TLB to refresh the mapping
-    if (m_current == this)
-        tlb_invalidate(virt);
+    invalidateTLB(virt, PAGESIZE);
 
     // Synchronize execution stream.
     isb();
@@ -258,14 +283,122 @@ MemoryContext::Result ARMPaging::unmap(Address virt)
     Result r = m_firstTable->unmap(virt, m_alloc);
 
     // Flush TLB to refresh the mapping
+    invalidateTLB(virt, PAGESIZE);
+
+    // Synchronize execution stream
+    isb();
+    return r;
+}
+
+MemoryContext::Result ARMPaging::mapPages(const Memory::Range & range)
+{
+    // Modify page tables
+    Result r = m_firstTable->mapRange(range, m_alloc);
+
+    // Flush the TLB to refresh the mappings
+    invalidateTLB(range.virt, range.size);
+
+    // Synchronize execution stream.
+    isb();
+    return r;
+}
+
+MemoryContext::Result ARMPaging::unmapPages(const Memory::Range & range)
+{
+    // Clean the given data pages in cache
     if (m_current == this)
-        tlb_invalidate(virt);
+        m_cache.cleanInvalidateRange(Cache::Data, range.virt, range.size);
+
+    // Modify page tables
+    Result r = m_firstTable->unmapRange(range, m_alloc);
+
+    // Flush TLB to refresh the mappings
+    invalidateTLB(range.virt, range.size);
+
+    // Synchronize execution stream
+    isb();
+    return r;
+}
+
+MemoryContext::Result ARMPaging::mapLarge(Memory::Range *range)
+{
+    // Modify page tables
+    Result r = m_firstTable->mapLarge(*range, m_alloc);
+
+    // Flush the TLB to refresh the mappings
+    for (Size i = 0; i < range->size; i += SECTIONSIZE)
+        flushTLB(range->virt + i);
+
+    // Synchronize execution stream.
+    isb();
+    return r;
+}
+
+MemoryContext::Result ARMPaging::unmapLarge(Address virt)
+{
+    Address phys;
+
+    // Clean the data pages of the section in cache
+    if (m_current == this && lookup(virt, &phys) == Success)
+        for (Size i = 0; i < SECTIONSIZE; i += PAGESIZE)
+            m_cache.cleanInvalidateAddress(Cache::Data, virt + i);
+
+    // Modify page tables
+    Result r = m_firstTable->unmapLarge(virt);
+
+    // Flush TLB to refresh the mapping
+    flushTLB(virt);
 
     // Synchronize execution stream
     isb();
     return r;
 }
 
+u32 ARMPaging::assignASID()
+{
+    if (m_asidGeneration != asidGeneration)
+    {
+        // Start a new generation when all ASIDs are in use
+        if (asidNext > MaximumASID)
+        {
+            asidGeneration++;
+            asidNext = 1;
+            tlb_flush_all();
+            dsb();
+        }
+
+        m_asid = asidNext++;
+        m_asidGeneration = asidGeneration;
+    }
+
+    return m_asid;
+}
+
+void ARMPaging::flushTLB(const Address virt)
+{
+#ifdef ARMV7
+    // Translations of an inactive context remain cached under its ASID
+    if (m_asidGeneration == asidGeneration)
+        tlb_invalidate((virt & PAGEMASK) | m_asid);
+    else if (m_current == this)
+        tlb_invalidate(virt & PAGEMASK);
+#else
+    if (m_current == this)
+        tlb_invalidate(virt);
+#endif /* ARMV7 */
+}
+
+void ARMPaging::flushTLBAll()
+{
+    // The kernel mappings are global and only cached from the active tables
+    if (m_current == this)
+        tlb_flush_all();
+#ifdef ARMV7
+    else if (m_asidGeneration == asidGeneration)
+        tlb_invalidate_asid(m_asid);
+#endif /* ARMV7 */
+}
+
 MemoryContext::Result ARMPaging::lookup(Address virt, Address *phys) const
 {
     return m_firstTable->translate(virt, phys, m_alloc);
@@ -284,5 +417,15 @@ MemoryContext::Result ARMPaging::releaseSection(const Memory::Range & range,
 
 MemoryContext::Result ARMPaging::releaseRange(Memory::Range *range)
 {
-    return m_firstTable->releaseRange(*range, m_alloc);
+    const Size mapped = countMapped(*range);
+    const MemoryContext::Result r = m_firstTable->releaseRange(*range, m_alloc);
+
+    removeUsage(r == Success ? mapped : mapped - countMapped(*range), false);
+    return r;
+}
+
+Size ARMPaging::countTables() const
+{
+    // The kernel is mapped with sections only, thus all second level tables are of the user
+    return (sizeof(ARMFirstTable) / PAGESIZE) + m_firstTable->countTables();
 }
@@ -42,6 +42,11 @@ class ARMFirstTable;
  */
 class ARMPaging : public MemoryContext
 {
+  private:
+
+    /** Highest Address Space Identifier (ASID) available. Zero is reserved. */
+    static const u32 MaximumASID = 255;
+
   public:
 
     /**
@@ -107,6 +112,42 @@ class ARMPaging : public MemoryContext
      */
     virtual Result unmap(Address virt);
 
+    /**
+     * Map a contiguous range using large pages.
+     *
+     * @param range Range object describing the range of physical pages.
+     *
+     * @return Result code
+     */
+    virtual Result mapLarge(Memory::Range *range);
+
+    /**
+     * Unmap a single large page.
+     *
+     * @param virt Virtual address aligned to SECTIONSIZE.
+     *
+     * @return Result code
+     */
+    virtual Result unmapLarge(Address virt);
+
+    /**
+     * Map a range of contiguous physical pages using small pages only.
+     *
+     * @param range Range object describing the range of physical pages.
+     *
+     * @return Result code
+     */
+    virtual Result mapPages(const Memory::Range & range);
+
+    /**
+     * Unmap a range of small pages.
+     *
+     * @param range Range object describing the range of virtual addresses.
+     *
+     * @return Result code
+     */
+    virtual Result unmapPages(const Memory::Range & range);
+
     /**
      * Translate virtual address to physical address.
      *
@@ -169,6 +210,40 @@ class ARMPaging : public MemoryContext
      */
     Result enableMMU();
 
+    /**
+     * Get the Address Space Identifier (ASID)
+     *
+     * Assigns a new ASID if this context does not have one in the current
+     * generation. When all ASIDs are used, a new generation starts and
+     * the TLB is flushed.
+     *
+     * @return ASID of this context
+     */
+    u32 assignASID();
+
+  protected:
+
+    /**
+     * Invalidate the TLB entry of a page in this context
+     *
+     * @param virt Virtual address of the page
+     */
+    virtual void flushTLB(const Address virt);
+
+    /**
+     * Invalidate all TLB entries of this context
+     *
+     * An inactive context only invalidates the entries tagged with its ASID.
+     */
+    virtual void flushTLBAll();
+
+    /**
+     * Count the first level and second level page tables.
+     *
+     * @return Number of pages
+     */
+    virtual Size countTables() const;
+
   private:
 
     /** Pointer to the first level page table. */
@@ -182,6 +257,12 @@ class ARMPaging : public MemoryContext
 
     /** Caching implementation */
     Arch::Cache m_cache;
+
+    /** Address Space Identifier, valid in generation m_asidGeneration */
+    u32 m_asid;
+
+    /** ASID generation in which m_asid was assigned, zero if none */
+    u32 m_asidGeneration;
 };
 
 namespace Arch
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ARMCore.h"
+#include "ARMPerformanceCounter.h"
+
+ARMPerformanceCounter::ARMPerformanceCounter()
+{
+#ifdef ARMV7
+    const Size counters = (mrc(p15, 0, 0, c9, c12) >> 11) & 0x1f;
+
+    m_count = counters < MaximumCounters ? counters : MaximumCounters;
+    m_mask = 0xffffffff;
+#endif /* ARMV7 */
+}
+
+ARMPerformanceCounter::Result ARMPerformanceCounter::configure(const Size index,
+                                                               const Event event)
+{
+    u32 code;
+
+    if (index >= m_count)
+        return InvalidArgument;
+
+    switch (event)
+    {
+        case None:         code = 0;    break;
+        case Cycles:       code = 0x11; break;
+        case Instructions: code = 0x08; break;
+        case CacheMisses:  code = 0x03; break;
+        case BranchMisses: code = 0x10; break;
+        case TLBMisses:    code = 0x05; break;
+        default:
+            return InvalidArgument;
+    }
+
+    // Stop the counter, select it and reset it (PMCNTENCLR, PMSELR, PMXEVCNTR)
+    mcr(p15, 0, 2, c9, c12, (1 << index));
+    mcr(p15, 0, 5, c9, c12, index);
+    isb();
+    mcr(p15, 0, 2, c9, c13, 0);
+
+    if (event != None)
+    {
+        // Program the event and start the counter (PMXEVTYPER, PMCNTENSET)
+        mcr(p15, 0, 1, c9, c13, code);
+        mcr(p15, 0, 1, c9, c12, (1 << index));
+    }
+
+    m_events[index] = event;
+    return Success;
+}
+
+u64 ARMPerformanceCounter::read(const Size index) const
+{
+    if (index >= m_count)
+        return 0;
+
+    mcr(p15, 0, 5, c9, c12, index);
+    isb();
+    return mrc(p15, 0, 2, c9, c13);
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBARCH_ARM_ARMPERFORMANCECOUNTER_H
+#define __LIBARCH_ARM_ARMPERFORMANCECOUNTER_H
+
+#include <Types.h>
+#include <Macros.h>
+#include <PerformanceCounter.h>
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libarch
+ * @{
+ *
+ * @addtogroup libarch_arm
+ * @{
+ */
+
+/**
+ * ARMv7 Performance Monitors event counters.
+ *
+ * Uses the programmable event counters of the PMU. The cycle
+ * counter is reserved for timestamp() and is not used here.
+ */
+class ARMPerformanceCounter : public PerformanceCounter
+{
+  public:
+
+    /**
+     * Constructor
+     *
+     * Detects the number of event counters using the PMCR register.
+     */
+    ARMPerformanceCounter();
+
+    /**
+     * Program a counter, which also resets it to zero.
+     *
+     * @param index Counter number
+     * @param event Event to count or None to disable the counter
+     *
+     * @return Result code
+     */
+    virtual Result configure(const Size index, const Event event);
+
+    /**
+     * Read the value of a counter.
+     *
+     * @param index Counter number
+     *
+     * @return Current counter value
+     */
+    virtual u64 read(const Size index) const;
+};
+
+namespace Arch
+{
+    typedef ARMPerformanceCounter PerformanceCounter;
+};
+
+/**
+ * @}
+ * @}
+ * @}
+ */
+
+#endif /* __LIBARCH_ARM_ARMPERFORMANCECOUNTER_H */
@@ -90,6 +90,9 @@
 /* System access permissions flag */
 #define PAGE2_AP_SYS    (1 << 4)
 
+/* Not-global flag: translation is tagged with the ASID */
+#define PAGE2_NOTGLOBAL (1 << 11)
+
 /**
  * @}
  */
@@ -116,7 +119,7 @@ MemoryContext::Result ARMSecondTable::map(Address virt,
 
     // Insert mapping
     m_pages[ TABENTRY(virt) ] = (phys & PAGEMASK) | PAGE2_PRESENT | flags(access);
-    cache.cleanData(&m_pages[TABENTRY(virt)]);
+    cache.cleanRange(Cache::Data, (Address) &m_pages[TABENTRY(virt)], sizeof(m_pages[0]));
     return MemoryContext::Success;
 }
 
@@ -125,7 +128,45 @@ MemoryContext::Result ARMSecondTable::unmap(Address virt)
     Arch::Cache cache;
 
     m_pages[ TABENTRY(virt) ] = PAGE2_NONE;
-    cache.cleanData(&m_pages[TABENTRY(virt)]);
+    cache.cleanRange(Cache::Data, (Address) &m_pages[TABENTRY(virt)], sizeof(m_pages[0]));
+    return MemoryContext::Success;
+}
+
+MemoryContext::Result ARMSecondTable::mapRange(Memory::Range range)
+{
+    MemoryContext::Result r = MemoryContext::Success;
+    Arch::Cache cache;
+    Size i;
+
+    for (i = 0; i < range.size; i += PAGESIZE)
+    {
+        // Check if the address is already mapped
+        if (m_pages[ TABENTRY(range.virt + i) ] & PAGE2_PRESENT)
+        {
+            r = MemoryContext::AlreadyExists;
+            break;
+        }
+
+        m_pages[ TABENTRY(range.virt + i) ] = ((range.phys + i) & PAGEMASK) | PAGE2_PRESENT | flags(range.access);
+    }
+
+    // Write back all inserted mappings at once
+    cache.cleanRange(Cache::Data, (Address) &m_pages[TABENTRY(range.virt)],
+                     (i / PAGESIZE) * sizeof(m_pages[0]));
+    return r;
+}
+
+MemoryContext::Result ARMSecondTable::unmapRange(Memory::Range range)
+{
+    Arch::Cache cache;
+    Size i;
+
+    for (i = 0; i < range.size; i += PAGESIZE)
+        m_pages[ TABENTRY(range.virt + i) ] = PAGE2_NONE;
+
+    // Write back all removed mappings at once
+    cache.cleanRange(Cache::Data, (Address) &m_pages[TABENTRY(range.virt)],
+                     (i / PAGESIZE) * sizeof(m_pages[0]));
     return MemoryContext::Success;
 }
 
@@ -174,6 +215,11 @@ u32 ARMSecondTable::flags(Memory::Access access) const
     if ((access & Memory::User))        f |= PAGE2_AP_USER;
     if (!(access & Memory::Writable))   f |= PAGE2_APX;
 
+#ifdef ARMV7
+    // User mappings are private to the ASID of the MemoryContext
+    if ((access & Memory::User))        f |= PAGE2_NOTGLOBAL;
+#endif
+
     // Caching
     if (access & Memory::Device)        f |= PAGE2_DEVICE_SHARED;
     else if (access & Memory::Uncached) f |= PAGE2_UNCACHED;
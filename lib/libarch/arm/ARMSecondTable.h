@@ -62,6 +62,28 @@ class ARMSecondTable
      */
     MemoryContext::Result unmap(Address virt);
 
+    /**
+     * Map a range of contiguous physical pages inside this table.
+     *
+     * The modified entries are written back to memory at once.
+     *
+     * @param range Virtual to physical memory range.
+     *
+     * @return Result code
+     */
+    MemoryContext::Result mapRange(Memory::Range range);
+
+    /**
+     * Remove the mappings of a range of pages inside this table.
+     *
+     * The modified entries are written back to memory at once.
+     *
+     * @param range Range of virtual addresses.
+     *
+     * @return Result code
+     */
+    MemoryContext::Result unmapRange(Memory::Range range);
+
     /**
      * Translate virtual address to physical address.
      *
@@ -39,6 +39,11 @@ u32 ARMTimer::getSystemFrequency(void) const
     return f;
 }
 
+s32 ARMTimer::getPL1PhysicalTimerValue() const
+{
+    return (s32) mrc(p15, 0, 0, c14, c2);
+}
+
 void ARMTimer::setPL1PhysicalTimerValue(const u32 value)
 {
     mcr(p15, 0, 0, c14, c2, value);
@@ -64,3 +69,17 @@ ARMTimer::Result ARMTimer::tick()
 
     return Timer::tick();
 }
+
+ARMTimer::Result ARMTimer::setNextInterrupt(const Size ticks)
+{
+    const s32 remaining = getPL1PhysicalTimerValue();
+
+    // Already ticking periodically, or the timer interrupt is pending
+    if ((!m_delayed && ticks <= 1) || remaining <= 0 || m_initialTimerCounter == 0)
+    {
+        return Success;
+    }
+
+    setPL1PhysicalTimerValue(calculateNextInterrupt(remaining, ticks, m_initialTimerCounter, 0x7fffffff));
+    return Success;
+}
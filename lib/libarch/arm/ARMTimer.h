@@ -69,6 +69,15 @@ class ARMTimer : public Timer
      */
     virtual Result tick();
 
+    /**
+     * Delay the next timer interrupt.
+     *
+     * @param ticks Number of ticks until the next interrupt.
+     *
+     * @return Result code.
+     */
+    virtual Result setNextInterrupt(const Size ticks);
+
   private:
 
     /**
@@ -78,6 +87,13 @@ class ARMTimer : public Timer
      */
     u32 getSystemFrequency(void) const;
 
+    /**
+     * Get Physical Timer 1 value
+     *
+     * @return Remaining timer value, negative if expired
+     */
+    s32 getPL1PhysicalTimerValue() const;
+
     /**
      * Set Physical Timer 1 value
      *
@@ -53,6 +53,11 @@ SunxiClockControl::Result SunxiClockControl::enable(const SunxiClockControl::Clo
             bit = 0;
             break;
 
+        case ClockMmc0:
+            offset = 0x060;
+            bit = 8;
+            break;
+
         default:
             ERROR("unsupported clock: " << (int) clock);
             return InvalidArgument;
@@ -81,6 +86,11 @@ SunxiClockControl::Result SunxiClockControl::deassert(const SunxiClockControl::R
             bit = 2;
             break;
 
+        case ResetMmc0:
+            offset = 0x2c0;
+            bit = 8;
+            break;
+
         default:
             ERROR("unsupported reset: " << (int) reset);
             return InvalidArgument;
@@ -89,3 +99,108 @@ SunxiClockControl::Result SunxiClockControl::deassert(const SunxiClockControl::R
     m_io.set(offset, (1 << bit));
     return Success;
 }
+
+SunxiClockControl::Result SunxiClockControl::setRate(const SunxiClockControl::Clock clock,
+                                                     const Size hertz)
+{
+    DEBUG("clock = " << (int) clock << " hertz = " << hertz);
+
+    if (clock == ClockCpu)
+        return setCpuRate(hertz);
+
+    if (clock != ClockMmc0 || hertz == 0)
+    {
+        ERROR("unsupported clock: " << (int) clock);
+        return InvalidArgument;
+    }
+
+    // Low rates come from the oscillator, higher rates from PLL_PERIPH0
+    const u32 pll = m_io.read(PllPeripheral0);
+    const bool usePll = hertz > OscillatorRate;
+    const Size source = usePll ? (OscillatorRate * (((pll >> 8) & 0x1f) + 1) *
+                                  (((pll >> 4) & 0x3) + 1)) / 2 : OscillatorRate;
+    Size divider = CEIL(source, hertz);
+    Size shift = 0;
+    u32 outputPhase = 0, samplePhase = 0;
+
+    // The rate is divided by a power of two and a factor up to 16
+    while (divider > 16)
+    {
+        shift++;
+        divider = (divider + 1) / 2;
+    }
+
+    if (shift > 3)
+    {
+        ERROR("rate too low: " << hertz);
+        return InvalidArgument;
+    }
+
+    // Delay the output and sample clocks to meet the card timing
+    if (hertz > 25000000)
+    {
+        outputPhase = 3;
+        samplePhase = 4;
+    }
+    else if (hertz > 400000)
+    {
+        samplePhase = 5;
+    }
+
+    m_io.write(MmcClock0, ModuleClockEnable |
+                          (usePll ? ModuleSourcePll : 0) |
+                          (samplePhase << ModuleSampleShift) |
+                          (shift << ModuleDividerShift) |
+                          (outputPhase << ModuleOutputShift) |
+                          (divider - 1));
+    return Success;
+}
+
+Size SunxiClockControl::getRate(const SunxiClockControl::Clock clock) const
+{
+    if (clock != ClockCpu)
+        return 0;
+
+    // Rate = 24MHz * N * K / (M * P)
+    const u32 pll = m_io.read(PllCpu);
+    const Size n = ((pll >> PllFactorNShift) & 0x1f) + 1;
+    const Size k = ((pll >> PllFactorKShift) & 0x3) + 1;
+    const Size m = (pll & 0x3) + 1;
+    const Size p = 1 << ((pll >> 16) & 0x3);
+
+    return (OscillatorRate * n * k) / (m * p);
+}
+
+SunxiClockControl::Result SunxiClockControl::setCpuRate(const Size hertz)
+{
+    Size n = 0, k;
+
+    // Find factors with N at most 32, which keeps the PLL in its range
+    for (k = 1; k <= 4; k++)
+    {
+        if (hertz % (OscillatorRate * k) == 0 && hertz / (OscillatorRate * k) <= 32)
+        {
+            n = hertz / (OscillatorRate * k);
+            break;
+        }
+    }
+
+    if (n == 0)
+    {
+        ERROR("unsupported CPU rate: " << hertz);
+        return InvalidArgument;
+    }
+
+    // Run from the oscillator while the PLL changes
+    const u32 config = m_io.read(CpuAxiConfig) & ~CpuSourceMask;
+    m_io.write(CpuAxiConfig, config | CpuSourceOscillator);
+
+    m_io.write(PllCpu, PllEnable | ((n - 1) << PllFactorNShift) | ((k - 1) << PllFactorKShift));
+
+    // Wait for the lock, with a limit for machines which do not report it
+    for (Size i = 0; i < PllLockRetries && !(m_io.read(PllCpu) & PllLock); i++)
+        ;
+
+    m_io.write(CpuAxiConfig, config | CpuSourcePll);
+    return Success;
+}
@@ -49,8 +49,51 @@ class SunxiClockControl
      */
     enum Registers
     {
+        PllCpu         = 0x000,
+        PllPeripheral0 = 0x028,
+        CpuAxiConfig   = 0x050,
+        MmcClock0      = 0x088
     };
 
+    /**
+     * PLL_CPUX register flags
+     */
+    enum PllCpuFlags
+    {
+        PllEnable       = (1 << 31),
+        PllLock         = (1 << 28),
+        PllFactorNShift = 8,
+        PllFactorKShift = 4
+    };
+
+    /**
+     * CPU clock source selection in the CPUX/AXI configuration register
+     */
+    enum CpuSource
+    {
+        CpuSourceMask       = (3 << 16),
+        CpuSourceOscillator = (1 << 16),
+        CpuSourcePll        = (2 << 16)
+    };
+
+    /**
+     * Module clock register flags
+     */
+    enum ModuleClockFlags
+    {
+        ModuleClockEnable    = (1 << 31),
+        ModuleSourcePll      = (1 << 24),
+        ModuleDividerShift   = 16,
+        ModuleOutputShift    = 8,
+        ModuleSampleShift    = 20
+    };
+
+    /** Frequency of the 24MHz oscillator */
+    static const Size OscillatorRate = 24000000;
+
+    /** Number of reads of PLL_CPUX to wait for the lock */
+    static const Size PllLockRetries = 100000;
+
   public:
 
     /**
@@ -60,6 +103,8 @@ class SunxiClockControl
     {
         ClockEmacTx = 1,
         ClockEphy,
+        ClockMmc0,
+        ClockCpu
     };
 
     /**
@@ -69,6 +114,7 @@ class SunxiClockControl
     {
         ResetEmacTx = 1,
         ResetEphy,
+        ResetMmc0
     };
 
     /**
@@ -108,6 +154,40 @@ class SunxiClockControl
      */
     Result deassert(const Reset reset);
 
+    /**
+     * Set the rate of a module clock
+     *
+     * The actual rate is the closest rate at or below the requested rate.
+     *
+     * @param clock Clock identification
+     * @param hertz Requested rate in hertz
+     *
+     * @return Result code
+     */
+    Result setRate(const Clock clock, const Size hertz);
+
+    /**
+     * Get the rate of a clock
+     *
+     * @param clock Clock identification
+     *
+     * @return Rate in hertz or zero if not supported
+     */
+    Size getRate(const Clock clock) const;
+
+  private:
+
+    /**
+     * Set the rate of the CPU clock
+     *
+     * The CPU runs from the oscillator while PLL_CPUX locks to the new rate.
+     *
+     * @param hertz Multiple of 24MHz
+     *
+     * @return Result code
+     */
+    Result setCpuRate(const Size hertz);
+
   private:
 
     /** Memory I/O object */
@@ -41,3 +41,18 @@ HostCache::Result HostCache::invalidateAddress(HostCache::Type type, Address add
 {
     return Success;
 }
+
+HostCache::Result HostCache::cleanRange(HostCache::Type type, Address addr, Size size)
+{
+    return Success;
+}
+
+HostCache::Result HostCache::invalidateRange(HostCache::Type type, Address addr, Size size)
+{
+    return Success;
+}
+
+HostCache::Result HostCache::cleanInvalidateRange(HostCache::Type type, Address addr, Size size)
+{
+    return Success;
+}
@@ -52,6 +52,12 @@
 /** Mask to find the page. */
 #define PAGEMASK        0xfffff000
 
+/** Mask for large 4MiB mappings. */
+#define SECTIONMASK     0xffc00000
+
+/** Size of a large 4MiB mapping. */
+#define SECTIONSIZE     0x400000
+
 /** Memory address alignment. */
 #define MEMALIGN        4
 
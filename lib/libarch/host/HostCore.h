@@ -32,6 +32,13 @@
  * @{
  */
 
+/**
+ * Reads a monotonic timestamp of the host.
+ *
+ * @return 64-bit integer with the host time in nanoseconds.
+ */
+extern u64 timestamp();
+
 /**
  * @}
  * @}
@@ -91,6 +91,42 @@ class HostIO : public IO
         }
     }
 
+    /**
+     * Read 32-bit values from a single memory mapped FIFO register.
+     *
+     * @param addr Address of the FIFO register.
+     * @param count Number of bytes to read, a multiple of four.
+     * @param buf Output buffer.
+     */
+    inline void readFifo(const Address addr, const Size count, void *buf) const
+    {
+        const volatile u32 *ptr = (const volatile u32 *)((const volatile u8 *)m_base + addr);
+        u32 *dst = (u32 *) buf;
+
+        for (Size i = 0; i < count / sizeof(u32); i++)
+        {
+            dst[i] = *ptr;
+        }
+    }
+
+    /**
+     * Write 32-bit values to a single memory mapped FIFO register.
+     *
+     * @param addr Address of the FIFO register.
+     * @param count Number of bytes to write, a multiple of four.
+     * @param buf Input buffer.
+     */
+    inline void writeFifo(const Address addr, const Size count, const void *buf)
+    {
+        volatile u32 *ptr = (volatile u32 *)((volatile u8 *)m_base + addr);
+        const u32 *src = (const u32 *) buf;
+
+        for (Size i = 0; i < count / sizeof(u32); i++)
+        {
+            *ptr = src[i];
+        }
+    }
+
     /**
      * Set bits in memory mapped register.
      *
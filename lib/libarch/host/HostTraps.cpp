@@ -25,6 +25,8 @@
 #include "HostShares.h"
 #include "HostTraps.h"
 
+static API::Result hostApiHandler(ulong api, ulong arg1, ulong arg2, ulong arg3, ulong arg4, ulong arg5);
+
 static API::Result hostPrivExecHandler(PrivOperation op, Address addr)
 {
     switch (op)
@@ -124,6 +126,23 @@ static API::Result hostVMCopyHandler(ProcessID procID, API::Operation how, Addre
     return API::IOError;
 }
 
+static API::Result hostVMCopyVectorHandler(ProcessID procID, API::Operation how,
+                                           const VMCopySegment *segments, Size count)
+{
+    if (!segments || count > VMCOPY_MAX_SEGMENTS)
+        return API::InvalidArgument;
+
+    for (Size i = 0; i < count; i++)
+    {
+        const API::Result result = hostVMCopyHandler(procID, how, segments[i].ours,
+                                                     segments[i].theirs, segments[i].size);
+        if (result != API::Success)
+            return result;
+    }
+
+    return API::Success;
+}
+
 static API::Result hostVMCtlHandler(ProcessID procID,
                                     MemoryOperation op,
                                     Memory::Range *range)
@@ -148,6 +167,7 @@ static API::Result hostVMCtlHandler(ProcessID procID,
                 if (range->phys == ZERO)
                 {
                     range->virt = (Address) new u8[range->size];
+                    range->phys = range->virt;
                 }
                 else
                 {
@@ -157,6 +177,15 @@ static API::Result hostVMCtlHandler(ProcessID procID,
             return API::Success;
         }
 
+        case MapShared:
+        {
+            if (range->virt == ZERO)
+            {
+                range->virt = range->phys;
+            }
+            return API::Success;
+        }
+
         case Release:
         {
             if (range->virt != 0 && range->size != 0)
@@ -188,7 +217,11 @@ static API::Result hostVMShareHandler(ProcessID procID,
                 return API::NotFound;
 
         case API::Delete:
-            return HostShareManager::instance()->deleteShares(procID);
+            // Shares cannot be removed individually on the host
+            if (share != ZERO)
+                return API::InvalidArgument;
+            else
+                return HostShareManager::instance()->deleteShares(procID);
 
         default:
             break;
@@ -197,6 +230,29 @@ static API::Result hostVMShareHandler(ProcessID procID,
     return API::InvalidArgument;
 }
 
+static API::Result hostMultiCallHandler(MultiCallEntry *calls, Size count)
+{
+    API::Result result = API::Success;
+
+    if (!calls || count == 0 || count > MULTICALL_MAX_CALLS)
+        return API::InvalidArgument;
+
+    for (Size i = 0; i < count; i++)
+    {
+        if (calls[i].number == API::MultiCallNumber)
+            return API::InvalidArgument;
+
+        result = hostApiHandler(calls[i].number, calls[i].args[0], calls[i].args[1],
+                                calls[i].args[2], calls[i].args[3], calls[i].args[4]);
+        calls[i].result = result;
+
+        if (result != API::Success && !(calls[i].flags & MULTICALL_IGNORE_ERROR))
+            break;
+    }
+
+    return result;
+}
+
 static API::Result hostApiHandler(ulong api, ulong arg1, ulong arg2, ulong arg3, ulong arg4, ulong arg5)
 {
     switch (api)
@@ -219,6 +275,12 @@ static API::Result hostApiHandler(ulong api, ulong arg1, ulong arg2, ulong arg3,
         case API::VMShareNumber:
             return hostVMShareHandler(arg1, (API::Operation) arg2, (ProcessShares::MemoryShare *) arg3);
 
+        case API::VMCopyVectorNumber:
+            return hostVMCopyVectorHandler(arg1, (API::Operation) arg2, (const VMCopySegment *) arg3, arg4);
+
+        case API::MultiCallNumber:
+            return hostMultiCallHandler((MultiCallEntry *) arg1, arg2);
+
         default:
             break;
     }
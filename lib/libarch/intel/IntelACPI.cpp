@@ -17,6 +17,7 @@
 
 #include <FreeNOS/System.h>
 #include <Log.h>
+#include "IntelCore.h"
 #include "IntelACPI.h"
 
 IntelACPI::IntelACPI()
@@ -94,10 +95,69 @@ IntelACPI::Result IntelACPI::scanAPIC(MultipleAPICTable *madt)
     return Success;
 }
 
+IntelACPI::Result IntelACPI::scanAffinity(ResourceAffinityTable *srat)
+{
+    Size j = 0, length = srat->header.length - sizeof(ResourceAffinityTable);
+
+    // Search for processor affinity entries
+    while (j < length)
+    {
+        MultipleAPICTableEntry *entry = (MultipleAPICTableEntry *) (((u8 *)(&srat->entry[0])) + j);
+
+        if (entry->length == 0)
+            break;
+
+        switch (entry->type)
+        {
+            case 0:
+            {
+                ResourceAffinityProc *proc = (ResourceAffinityProc *) entry;
+
+                if (proc->flags & 1)
+                {
+                    DEBUG("core" << proc->apicId << " in domain " << proc->domainLow);
+                    m_topology[proc->apicId].node = proc->domainLow |
+                                                   (proc->domainHigh[0] << 8) |
+                                                   (proc->domainHigh[1] << 16) |
+                                                   (proc->domainHigh[2] << 24);
+                }
+                break;
+            }
+
+            case 2:
+            {
+                ResourceAffinityX2Proc *proc = (ResourceAffinityX2Proc *) entry;
+
+                if ((proc->flags & 1) && proc->apicId < MaximumCores)
+                {
+                    DEBUG("core" << proc->apicId << " in domain " << proc->domain);
+                    m_topology[proc->apicId].node = proc->domain;
+                }
+                break;
+            }
+        }
+        j += entry->length;
+    }
+    return Success;
+}
+
+void IntelACPI::scanTable(SystemDescriptorHeader *hdr)
+{
+    DEBUG("table : " << (void *) hdr->signature);
+
+    if (hdr->signature == MultipleAPICTableSignature)
+        scanAPIC((MultipleAPICTable *) hdr);
+    else if (hdr->signature == ResourceAffinityTableSignature)
+        scanAffinity((ResourceAffinityTable *) hdr);
+}
+
 IntelACPI::Result IntelACPI::discover()
 {
     SystemDescriptorHeader *hdr = (SystemDescriptorHeader *) m_rootIO.getBase();
+    Size cacheShift, packageShift;
+
     m_cores.clear();
+    clearTopology();
 
     // Detect the Root/ExtendedSystemTable
     if (hdr->signature == RootSystemTableSignature)
@@ -111,13 +171,7 @@ IntelACPI::Result IntelACPI::discover()
             IntelIO io;
 
             io.map(rst->entry[i], PAGESIZE);
-            hdr = (SystemDescriptorHeader *) io.getBase();
-
-            DEBUG("entry " << i << " : " << (void *) hdr->signature);
-
-            if (hdr->signature == MultipleAPICTableSignature)
-                scanAPIC((MultipleAPICTable *) hdr);
-
+            scanTable((SystemDescriptorHeader *) io.getBase());
             io.unmap();
         }
     }
@@ -132,16 +186,15 @@ IntelACPI::Result IntelACPI::discover()
             IntelIO io;
 
             io.map(xst->entry[i], PAGESIZE);
-            hdr = (SystemDescriptorHeader *) io.getBase();
-
-            DEBUG("entry " << i << " : " << (void *) hdr->signature);
-
-            if (hdr->signature == MultipleAPICTableSignature)
-                scanAPIC((MultipleAPICTable *) hdr);
-
+            scanTable((SystemDescriptorHeader *) io.getBase());
             io.unmap();
         }
     }
+
+    // Find the caches and packages shared by the cores
+    cpuTopology(cacheShift, packageShift);
+    setTopology(cacheShift, packageShift);
+
     return Success;
 }
 
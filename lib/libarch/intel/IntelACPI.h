@@ -61,6 +61,9 @@ class IntelACPI : public CoreManager
     /** Signature for the Multiple APIC Descriptor Table (MADT). */
     static const u32 MultipleAPICTableSignature = 0x43495041;
 
+    /** Signature for the System Resource Affinity Table (SRAT). */
+    static const u32 ResourceAffinityTableSignature = 0x54415253;
+
     /**
      * Root System Description Pointer (ACPI v1.0).
      */
@@ -158,6 +161,48 @@ class IntelACPI : public CoreManager
     } __attribute__((packed))
     MultipleAPICTable;
 
+    /**
+     * System Resource Affinity Table (SRAT) processor APIC entry.
+     */
+    typedef struct ResourceAffinityProc
+    {
+        MultipleAPICTableEntry header;
+        u8  domainLow;
+        u8  apicId;
+        u32 flags;
+        u8  sapicId;
+        u8  domainHigh[3];
+        u32 clockDomain;
+    } __attribute__((packed))
+    ResourceAffinityProc;
+
+    /**
+     * System Resource Affinity Table (SRAT) processor x2APIC entry.
+     */
+    typedef struct ResourceAffinityX2Proc
+    {
+        MultipleAPICTableEntry header;
+        u16 reserved;
+        u32 domain;
+        u32 apicId;
+        u32 flags;
+        u32 clockDomain;
+        u32 reserved2;
+    } __attribute__((packed))
+    ResourceAffinityX2Proc;
+
+    /**
+     * System Resource Affinity Table (SRAT).
+     */
+    typedef struct ResourceAffinityTable
+    {
+        SystemDescriptorHeader header;
+        u32 reserved1;
+        u64 reserved2;
+        MultipleAPICTableEntry entry[];
+    } __attribute__((packed))
+    ResourceAffinityTable;
+
     /**
      * Hardware registers.
      */
@@ -204,6 +249,20 @@ class IntelACPI : public CoreManager
      */
     Result scanAPIC(MultipleAPICTable *madt);
 
+    /**
+     * Scan for the NUMA proximity domains of cores in the affinity table.
+     *
+     * @return Result code.
+     */
+    Result scanAffinity(ResourceAffinityTable *srat);
+
+    /**
+     * Scan a system descriptor table.
+     *
+     * @param hdr Header of the table.
+     */
+    void scanTable(SystemDescriptorHeader *hdr);
+
   private:
 
     /** I/O object for searching the RootSystemDescriptor. */
@@ -19,6 +19,7 @@
 #include <MemoryContext.h>
 #include <CoreInfo.h>
 #include <FreeNOS/System.h>
+#include "IntelCore.h"
 #include "IntelPIT.h"
 #include "IntelAPIC.h"
 
@@ -39,6 +40,10 @@ IntelAPIC::IntelAPIC()
     m_frequency = 0;
     m_int = TimerVector;
     m_initialCounter = 0;
+    m_timestampFrequency = 0;
+    m_deadlineMode = false;
+    m_timestampPerTick = 0;
+    m_timestampTick = 0;
     m_io.setBase(IOBase);
 }
 
@@ -52,9 +57,15 @@ uint IntelAPIC::getCounter() const
     return m_io.read(InitialCount);
 }
 
+uint IntelAPIC::getTimestampFrequency() const
+{
+    return m_timestampFrequency;
+}
+
 Timer::Result IntelAPIC::start(IntelPIT *pit)
 {
     u32 t1, t2, loops = 20;
+    u64 ts1, ts2;
 
     // Start the APIC timer
     m_io.write(DivideConfig, Divide16);
@@ -66,15 +77,17 @@ Timer::Result IntelAPIC::start(IntelPIT *pit)
     // wait for the next PIT trigger.
     pit->waitTrigger();
 
-    // Collect the current APIC timer counter
+    // Collect the current APIC timer counter and timestamp
     t1 = m_io.read(CurrentCount);
+    ts1 = timestamp();
 
     // Wait for several PIT triggers
     for (uint i = 0; i < loops; i++)
         pit->waitTrigger();
 
-    // Measure the current APIC timer counter again.
+    // Measure the current APIC timer counter and timestamp again.
     t2 = m_io.read(CurrentCount);
+    ts2 = timestamp();
 
     // Configure the APIC timer to run at the same frequency as the PIT.
     m_initialCounter = (t1 - t2) / loops;
@@ -87,9 +100,33 @@ Timer::Result IntelAPIC::start(IntelPIT *pit)
     NOTICE("Detected " << busFreq / 1000000 << "."
                        << busFreq % 1000000 << " Mhz APIC bus");
     NOTICE("APIC counter set at " << m_initialCounter);
+
+    // The timestamp counter provides exact deadlines and busy waits
+    m_timestampFrequency = (((ts2 - ts1) / loops) * pit->getFrequency()) / 1000;
+    NOTICE("Detected " << m_timestampFrequency / 1000 << "."
+                       << m_timestampFrequency % 1000 << " Mhz timestamp counter");
+    setupDeadline();
     return Timer::Success;
 }
 
+void IntelAPIC::setupDeadline()
+{
+    m_deadlineMode = false;
+
+    if (m_timestampFrequency == 0 || m_frequency == 0)
+        return;
+
+    m_timestampPerTick = ((u64) m_timestampFrequency * 1000) / m_frequency;
+    m_timestampTick = timestamp();
+
+    // Delayed interrupts use the TSC-deadline mode, if the processor has it
+    if (cpuExtendedFeatures() & INTEL_CPUID_TSC_DEADLINE)
+    {
+        m_deadlineMode = true;
+        NOTICE("Using APIC TSC-deadline mode");
+    }
+}
+
 Timer::Result IntelAPIC::wait(u32 microseconds) const
 {
     if (!isKernel)
@@ -113,6 +150,13 @@ Timer::Result IntelAPIC::wait(u32 microseconds) const
         if (ProcessCtl(SELF, WaitTimer, (Address) &info) != API::Success)
             return Timer::IOError;
     }
+    else if (m_timestampFrequency != 0)
+    {
+        const u64 end = timestamp() + (((u64) microseconds * m_timestampFrequency) / 1000);
+
+        while (timestamp() < end)
+            ;
+    }
     else
     {
         Size usecPerInt = 1000000 / m_frequency;
@@ -134,15 +178,17 @@ Timer::Result IntelAPIC::wait(u32 microseconds) const
     return Timer::Success;
 }
 
-Timer::Result IntelAPIC::start(u32 initialCounter, uint hertz)
+Timer::Result IntelAPIC::start(u32 initialCounter, uint hertz, uint timestampFrequency)
 {
     // Set members
     m_frequency = hertz;
     m_initialCounter = initialCounter;
+    m_timestampFrequency = timestampFrequency;
 
     // Start the APIC timer
     m_io.write(DivideConfig, Divide16);
     m_io.write(InitialCount, m_initialCounter);
+    setupDeadline();
     return start();
 }
 
@@ -159,6 +205,73 @@ Timer::Result IntelAPIC::stop()
     return Timer::Success;
 }
 
+Timer::Result IntelAPIC::tick()
+{
+    // Account for all ticks which passed until the deadline
+    if (m_delayed && m_deadlineMode)
+    {
+        const u64 passed = (timestamp() - m_timestampTick) / m_timestampPerTick;
+
+        m_interval = passed > 1 ? passed : 1;
+        m_timestampTick += m_interval * m_timestampPerTick;
+    }
+    else if (m_timestampPerTick)
+    {
+        m_timestampTick = timestamp();
+    }
+
+    // Writing the initial counter after the mode also restarts from the deadline mode
+    if (m_delayed)
+    {
+        m_io.write(Timer, TimerVector | PeriodicMode);
+        m_io.write(InitialCount, m_initialCounter);
+    }
+
+    return Timer::tick();
+}
+
+u64 IntelAPIC::getTickTimestamp(Size *frequency) const
+{
+    *frequency = m_timestampPerTick ? m_timestampFrequency : 0;
+    return m_timestampTick;
+}
+
+Timer::Result IntelAPIC::setNextInterrupt(const Size ticks)
+{
+    if (m_deadlineMode)
+    {
+        // Already in periodic mode
+        if (!m_delayed && ticks <= 1)
+        {
+            return Timer::Success;
+        }
+
+        // The deadline is at a tick boundary after the current time
+        const u64 passed = (timestamp() - m_timestampTick) / m_timestampPerTick;
+        const u64 interval = ticks > passed ? ticks : passed + 1;
+
+        m_delayed = true;
+        m_io.write(Timer, TimerVector | DeadlineMode);
+        wrmsr64(INTEL_MSR_TSC_DEADLINE, m_timestampTick + (interval * m_timestampPerTick));
+        return Timer::Success;
+    }
+
+    const u32 remaining = m_io.read(CurrentCount);
+
+    // Already in periodic mode, or the delayed interrupt is pending
+    if ((!m_delayed && ticks <= 1) || (m_delayed && remaining == 0) || m_initialCounter == 0)
+    {
+        return Timer::Success;
+    }
+
+    const u32 count = calculateNextInterrupt(remaining, ticks, m_initialCounter, 0xffffffff);
+
+    // Switch to one-shot mode and restart the counter
+    m_io.write(Timer, TimerVector);
+    m_io.write(InitialCount, count);
+    return Timer::Success;
+}
+
 Timer::Result IntelAPIC::initialize()
 {
     // Map the registers into the address space
@@ -107,7 +107,8 @@ class IntelAPIC : public IntController, public Timer
     enum TimerFlags
     {
         TimerMasked  = (1 << 16),
-        PeriodicMode = (1 << 17)
+        PeriodicMode = (1 << 17),
+        DeadlineMode = (1 << 18)
     };
 
   public:
@@ -131,6 +132,13 @@ class IntelAPIC : public IntController, public Timer
      */
     uint getCounter() const;
 
+    /**
+     * Get the frequency of the timestamp counter.
+     *
+     * @return Frequency in kilohertz or zero if not calibrated.
+     */
+    uint getTimestampFrequency() const;
+
     /**
      * Initialize the APIC.
      *
@@ -149,6 +157,8 @@ class IntelAPIC : public IntController, public Timer
     /**
      * Start the timer using PIT as reference timer.
      *
+     * Both the APIC bus and the timestamp counter are calibrated.
+     *
      * @param pit PIT instance used to measure the APIC bus speed for clock calibration.
      * @return Result code.
      */
@@ -159,9 +169,10 @@ class IntelAPIC : public IntController, public Timer
      *
      * @param initialCounter The value of the InitialCount register.
      * @param hertz Hertz associated to the initial counter.
+     * @param timestampFrequency Frequency of the timestamp counter in kilohertz, or zero if unknown.
      * @return Result code.
      */
-    Timer::Result start(uint initialCounter, uint hertz);
+    Timer::Result start(uint initialCounter, uint hertz, uint timestampFrequency = 0);
 
     /**
      * (Re)start the APIC timer.
@@ -181,6 +192,28 @@ class IntelAPIC : public IntController, public Timer
      */
     virtual Timer::Result stop();
 
+    /**
+     * Process timer tick.
+     *
+     * Restores periodic mode after a delayed interrupt.
+     *
+     * @return Result code
+     */
+    virtual Timer::Result tick();
+
+    /**
+     * Delay the next timer interrupt.
+     *
+     * Programs the APIC timer in TSC-deadline mode if supported,
+     * and in one-shot mode otherwise. A deadline is exact at the
+     * tick boundary and does not depend on the remaining counter.
+     *
+     * @param ticks Number of ticks until the next interrupt.
+     *
+     * @return Result code.
+     */
+    virtual Timer::Result setNextInterrupt(const Size ticks);
+
     /**
      * Enable hardware interrupt (IRQ).
      *
@@ -228,6 +261,24 @@ class IntelAPIC : public IntController, public Timer
      */
     IntController::Result sendIPI(uint coreId, uint vector);
 
+  protected:
+
+    /**
+     * Get the timestamp counter value at the start of the current tick.
+     *
+     * @param frequency Receives the timestamp counter frequency in kHz.
+     *
+     * @return Timestamp counter value
+     */
+    virtual u64 getTickTimestamp(Size *frequency) const;
+
+  private:
+
+    /**
+     * Setup the TSC-deadline mode, if supported.
+     */
+    void setupDeadline();
+
   private:
 
     /** I/O object */
@@ -235,6 +286,18 @@ class IntelAPIC : public IntController, public Timer
 
     /** Saved initial counter value for APIC timer */
     uint m_initialCounter;
+
+    /** Frequency of the timestamp counter in kilohertz */
+    uint m_timestampFrequency;
+
+    /** True if delayed interrupts use the TSC-deadline mode */
+    bool m_deadlineMode;
+
+    /** Timestamp counter increments per timer tick */
+    u64 m_timestampPerTick;
+
+    /** Timestamp counter at the last tick boundary */
+    u64 m_timestampTick;
 };
 
 /**
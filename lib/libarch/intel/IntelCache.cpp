@@ -41,3 +41,18 @@ IntelCache::Result IntelCache::invalidateAddress(IntelCache::Type type, Address
 {
     return Success;
 }
+
+IntelCache::Result IntelCache::cleanRange(IntelCache::Type type, Address addr, Size size)
+{
+    return Success;
+}
+
+IntelCache::Result IntelCache::invalidateRange(IntelCache::Type type, Address addr, Size size)
+{
+    return Success;
+}
+
+IntelCache::Result IntelCache::cleanInvalidateRange(IntelCache::Type type, Address addr, Size size)
+{
+    return Success;
+}
@@ -35,6 +35,9 @@
 
 /**
  * Intel cache management implementation.
+ *
+ * Intel processors keep the caches coherent with DMA and between
+ * virtual mappings of the same memory, thus no maintenance is needed.
  */
 class IntelCache : public Cache
 {
@@ -90,6 +93,39 @@ class IntelCache : public Cache
      * @return Result code
      */
     virtual Result invalidateAddress(Type type, Address addr);
+
+    /**
+     * Clean a range of memory.
+     *
+     * @param type Cache type to clean
+     * @param addr Virtual memory address of the first byte to clean
+     * @param size Number of bytes to clean
+     *
+     * @return Result code
+     */
+    virtual Result cleanRange(Type type, Address addr, Size size);
+
+    /**
+     * Invalidate a range of memory.
+     *
+     * @param type Cache type to invalidate
+     * @param addr Virtual memory address of the first byte to invalidate
+     * @param size Number of bytes to invalidate
+     *
+     * @return Result code
+     */
+    virtual Result invalidateRange(Type type, Address addr, Size size);
+
+    /**
+     * Clean and invalidate a range of memory.
+     *
+     * @param type Cache type to clean and invalidate
+     * @param addr Virtual memory address of the first byte to clean and invalidate
+     * @param size Number of bytes to clean and invalidate
+     *
+     * @return Result code
+     */
+    virtual Result cleanInvalidateRange(Type type, Address addr, Size size);
 };
 
 namespace Arch
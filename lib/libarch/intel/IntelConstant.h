@@ -37,6 +37,18 @@
 /** Protected Mode. */
 #define CR0_PE          0x00000001
 
+/** Monitor Coprocessor. */
+#define CR0_MP          0x00000002
+
+/** FPU Emulation. */
+#define CR0_EM          0x00000004
+
+/** Task Switched (FPU access traps). */
+#define CR0_TS          0x00000008
+
+/** Write Protect (read-only pages also apply to the kernel). */
+#define CR0_WP          0x00010000
+
 /** Paged Mode. */
 #define CR0_PG          0x80000000
 
@@ -44,6 +56,15 @@
 #define CR4_TSD         0x00000004
 #define CR4_PSE         (1 << 4)
 
+/** Page Global Enable. */
+#define CR4_PGE         (1 << 7)
+
+/** Operating system supports FXSAVE/FXRSTOR and SSE. */
+#define CR4_OSFXSR      (1 << 9)
+
+/** Operating system supports unmasked SSE exceptions. */
+#define CR4_OSXMMEXCPT  (1 << 10)
+
 /** Kernel Code Segment. */
 #define KERNEL_CS       1
 #define KERNEL_CS_SEL   0x8
@@ -94,6 +115,9 @@
 /** Mask for large 4MiB mappings. */
 #define SECTIONMASK     0xffc00000
 
+/** Size of a large 4MiB mapping. */
+#define SECTIONSIZE     0x400000
+
 /** Memory address alignment. */
 #define MEMALIGN        4
 
@@ -160,3 +160,27 @@ void IntelCore::writeCR3(u32 cr3) const
     asm volatile("mov %0, %%eax\n"
                  "mov %%eax, %%cr3" :: "r" (cr3));
 }
+
+volatile u32 IntelCore::readCR0() const
+{
+    volatile u32 cr0;
+    asm volatile("mov %%cr0, %0\n" : "=r" (cr0));
+    return cr0;
+}
+
+void IntelCore::writeCR0(u32 cr0) const
+{
+    asm volatile("mov %0, %%cr0" :: "r" (cr0));
+}
+
+volatile u32 IntelCore::readCR4() const
+{
+    volatile u32 cr4;
+    asm volatile("mov %%cr4, %0\n" : "=r" (cr4));
+    return cr4;
+}
+
+void IntelCore::writeCR4(u32 cr4) const
+{
+    asm volatile("mov %0, %%cr4" :: "r" (cr4));
+}
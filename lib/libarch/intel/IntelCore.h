@@ -45,6 +45,18 @@ inline u64 timestamp()
     return val;
 }
 
+/**
+ * Memory Fence
+ *
+ * Ensures that all loads and stores before the fence are globally
+ * visible before any load or store after it. Needed for memory shared
+ * with devices, where a store must be visible before a following load.
+ */
+inline void mfence()
+{
+    asm volatile ("mfence" ::: "memory");
+}
+
 /**
  * Reboot the system (by sending the a reset signal on the keyboard I/O port)
  */
@@ -84,6 +96,184 @@ inline u64 timestamp()
     asm volatile ("ltr %0\n" :: "r"(tr)); \
 })
 
+/**
+ * Write a Model Specific Register (MSR).
+ *
+ * @param msr MSR number to write.
+ * @param value 32-bit value to write.
+ */
+#define wrmsr(msr, value) \
+({ \
+    asm volatile ("wrmsr\n" :: "c"(msr), "a"(value), "d"(0)); \
+})
+
+/**
+ * Write a 64-bit Model Specific Register (MSR).
+ *
+ * @param msr MSR number to write.
+ * @param value 64-bit value to write.
+ */
+inline void wrmsr64(const u32 msr, const u64 value)
+{
+    asm volatile ("wrmsr\n" :: "c"(msr), "a"((u32) value), "d"((u32) (value >> 32)));
+}
+
+/**
+ * Read a Model Specific Register (MSR).
+ *
+ * @param msr MSR number to read.
+ *
+ * @return 64-bit value of the MSR.
+ */
+inline u64 rdmsr(const u32 msr)
+{
+    u32 lo, hi;
+    asm volatile ("rdmsr\n" : "=a"(lo), "=d"(hi) : "c"(msr));
+    return ((u64) hi << 32) | lo;
+}
+
+/**
+ * Clear the Task Switched flag in CR0, allowing FPU access.
+ */
+#define clts() \
+    asm volatile ("clts")
+
+/**
+ * Read the CPUID feature flags.
+ *
+ * @return Feature flags in EDX of CPUID leaf 1.
+ */
+inline u32 cpuFeatures()
+{
+    ulong eax = 1, ebx, ecx, edx;
+
+    asm volatile ("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    return edx;
+}
+
+/**
+ * Find the processor topology levels in the APIC IDs with CPUID.
+ *
+ * APIC IDs of cores which share a level only differ in the bits below
+ * the shift of that level. Without cache information the L2 cache
+ * is assumed to be private to each core.
+ *
+ * @param cacheShift On output, number of APIC ID bits below the L2 cache level.
+ * @param packageShift On output, number of APIC ID bits below the package level.
+ */
+inline void cpuTopology(Size & cacheShift, Size & packageShift)
+{
+    ulong eax = 0, ebx, ecx = 0, edx;
+    Size shared;
+
+    asm volatile ("cpuid" : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+    const ulong maximumLeaf = eax;
+
+    // Logical processors in the package, if Hyper-Threading is supported
+    eax = 1;
+    asm volatile ("cpuid" : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+    shared = (edx & (1 << 28)) ? (ebx >> 16) & 0xff : 1;
+
+    for (packageShift = 0; (1U << packageShift) < shared; packageShift++)
+        ;
+
+    // Logical processors sharing the L2 cache, from the deterministic cache parameters
+    cacheShift = 0;
+
+    for (ulong i = 0; maximumLeaf >= 4; i++)
+    {
+        eax = 4;
+        ecx = i;
+        asm volatile ("cpuid" : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+
+        // Stop at the last cache
+        if ((eax & 0x1f) == 0)
+            break;
+
+        if (((eax >> 5) & 0x7) == 2)
+        {
+            shared = ((eax >> 14) & 0xfff) + 1;
+
+            for (cacheShift = 0; (1U << cacheShift) < shared; cacheShift++)
+                ;
+            break;
+        }
+    }
+}
+
+/**
+ * Read the extended CPUID feature flags.
+ *
+ * @return Feature flags in ECX of CPUID leaf 1.
+ */
+inline u32 cpuExtendedFeatures()
+{
+    ulong eax = 1, ebx, ecx, edx;
+
+    asm volatile ("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    return ecx;
+}
+
+/** Extended CPUID feature flag for MONITOR/MWAIT support. */
+#define INTEL_CPUID_MONITOR (1 << 3)
+
+/**
+ * Read the MWAIT C-states of the processor.
+ *
+ * @return Number of MWAIT sub-states of C-state N in bits 4N..4N+3,
+ *         or zero if MONITOR/MWAIT is not supported.
+ */
+inline u32 cpuMwaitStates()
+{
+    ulong eax = 0, ebx, ecx, edx;
+
+    asm volatile ("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+
+    if (eax < 5 || !(cpuExtendedFeatures() & INTEL_CPUID_MONITOR))
+        return 0;
+
+    eax = 5;
+    asm volatile ("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    return edx;
+}
+
+/**
+ * Wait for an interrupt in the given C-state.
+ *
+ * @param address Memory address to monitor for writes.
+ * @param hint C-state and sub-state in the MWAIT hint format.
+ */
+inline void cpuMwait(const volatile void *address, const ulong hint)
+{
+    asm volatile ("monitor" :: "a"(address), "c"(0), "d"(0));
+    asm volatile ("mwait" :: "a"(hint), "c"(0));
+}
+
+/** CPUID feature flag for FXSAVE/FXRSTOR support. */
+#define INTEL_CPUID_FXSR (1 << 24)
+
+/** CPUID feature flag for global pages support. */
+#define INTEL_CPUID_PGE (1 << 13)
+
+/** Extended CPUID feature flag for the APIC timer TSC-deadline mode. */
+#define INTEL_CPUID_TSC_DEADLINE (1 << 24)
+
+/**
+ * @name Intel Model Specific Registers
+ * @{
+ */
+
+#define INTEL_MSR_SYSENTER_CS   0x174
+#define INTEL_MSR_SYSENTER_ESP  0x175
+#define INTEL_MSR_SYSENTER_EIP  0x176
+#define INTEL_MSR_PMC0          0x0c1
+#define INTEL_MSR_PERFEVTSEL0   0x186
+#define INTEL_MSR_TSC_DEADLINE  0x6e0
+
+/**
+ * @}
+ */
+
 /**
  * Flushes the Translation Lookaside Buffers (TLB) for a single page.
  *
@@ -294,6 +484,30 @@ class IntelCore
      * Write the CR3 register
      */
     void writeCR3(u32 cr3) const;
+
+    /**
+     * Read the CR0 register.
+     *
+     * @return CR0 register value.
+     */
+    volatile u32 readCR0() const;
+
+    /**
+     * Write the CR0 register
+     */
+    void writeCR0(u32 cr0) const;
+
+    /**
+     * Read the CR4 register.
+     *
+     * @return CR4 register value.
+     */
+    volatile u32 readCR4() const;
+
+    /**
+     * Write the CR4 register
+     */
+    void writeCR4(u32 cr4) const;
 };
 
 #ifdef __KERNEL__
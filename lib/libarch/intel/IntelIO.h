@@ -88,6 +88,21 @@ class IntelIO : public IO
         return w;
     }
 
+    /**
+     * Read a long from a port.
+     *
+     * @param port The I/O port to read from.
+     *
+     * @return Long 32-bit number read from the port.
+     */
+    inline u32 inl(u16 port) const
+    {
+        u32 l;
+        port += m_portBase;
+        asm volatile ("inl %%dx, %%eax" : "=a" (l) : "d" (port));
+        return l;
+    }
+
     /**
      * Output a byte to a port.
      *
@@ -124,6 +139,42 @@ class IntelIO : public IO
         asm volatile ("outl %%eax,%%dx"::"a" (l),"d" (port));
     }
 
+    /**
+     * Read a block of words from a port.
+     *
+     * Transfers at the speed of the port with a single string instruction.
+     *
+     * @param port The I/O port to read from.
+     * @param buffer Output buffer.
+     * @param count Number of words to read.
+     */
+    inline void insw(u16 port, void *buffer, Size count) const
+    {
+        port += m_portBase;
+        asm volatile ("cld; rep insw"
+                      : "+D" (buffer), "+c" (count)
+                      : "d" (port)
+                      : "memory");
+    }
+
+    /**
+     * Output a block of words to a port.
+     *
+     * Transfers at the speed of the port with a single string instruction.
+     *
+     * @param port Port to write to.
+     * @param buffer Input buffer.
+     * @param count Number of words to write.
+     */
+    inline void outsw(u16 port, const void *buffer, Size count)
+    {
+        port += m_portBase;
+        asm volatile ("cld; rep outsw"
+                      : "+S" (buffer), "+c" (count)
+                      : "d" (port)
+                      : "memory");
+    }
+
     /**
      * Read memory mapped register.
      *
@@ -179,6 +230,42 @@ class IntelIO : public IO
         }
     }
 
+    /**
+     * Read 32-bit values from a single memory mapped FIFO register.
+     *
+     * @param addr Address of the FIFO register.
+     * @param count Number of bytes to read, a multiple of four.
+     * @param buf Output buffer.
+     */
+    inline void readFifo(const Address addr, const Size count, void *buf) const
+    {
+        const volatile u32 *ptr = (const volatile u32 *)((const volatile u8 *)m_base + addr);
+        u32 *dst = (u32 *) buf;
+
+        for (Size i = 0; i < count / sizeof(u32); i++)
+        {
+            dst[i] = *ptr;
+        }
+    }
+
+    /**
+     * Write 32-bit values to a single memory mapped FIFO register.
+     *
+     * @param addr Address of the FIFO register.
+     * @param count Number of bytes to write, a multiple of four.
+     * @param buf Input buffer.
+     */
+    inline void writeFifo(const Address addr, const Size count, const void *buf)
+    {
+        volatile u32 *ptr = (volatile u32 *)((volatile u8 *)m_base + addr);
+        const u32 *src = (const u32 *) buf;
+
+        for (Size i = 0; i < count / sizeof(u32); i++)
+        {
+            *ptr = src[i];
+        }
+    }
+
     /**
      * Set bits in memory mapped register.
      *
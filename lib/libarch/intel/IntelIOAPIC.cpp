@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IntelIOAPIC.h"
+
+IntelIOAPIC::IntelIOAPIC(IntelAPIC & apic)
+    : IntController()
+    , m_apic(apic)
+    , m_numEntries(0)
+{
+    m_base = InterruptBase;
+}
+
+IntelIOAPIC::Result IntelIOAPIC::initialize()
+{
+    // Map the registers into the address space
+    if (m_io.map(IOBase) != IntelIO::Success)
+        return IOError;
+
+    // The version register reads all ones if no I/O APIC is present
+    const u32 version = read(Version);
+    if (version == 0xffffffff)
+        return IOError;
+
+    m_numEntries = ((version >> 16) & 0xff) + 1;
+    return Success;
+}
+
+IntelIOAPIC::Result IntelIOAPIC::enable(uint irq)
+{
+    // Only unmask entries which are routed by setAffinity()
+    if (!isRoutable(irq) || !(read(entry(irq)) & VectorMask))
+        return InvalidIRQ;
+
+    write(entry(irq), read(entry(irq)) & ~RedirectionMasked);
+    return Success;
+}
+
+IntelIOAPIC::Result IntelIOAPIC::disable(uint irq)
+{
+    if (!isRoutable(irq))
+        return InvalidIRQ;
+
+    write(entry(irq), read(entry(irq)) | RedirectionMasked);
+    return Success;
+}
+
+IntelIOAPIC::Result IntelIOAPIC::clear(uint irq)
+{
+    return m_apic.clear(irq);
+}
+
+IntelIOAPIC::Result IntelIOAPIC::send(const uint targetCoreId, const uint irq)
+{
+    return m_apic.send(targetCoreId, irq);
+}
+
+IntelIOAPIC::Result IntelIOAPIC::setAffinity(const uint irq, const uint coreId)
+{
+    if (!isRoutable(irq))
+        return InvalidIRQ;
+
+    // Fixed delivery to the physical APIC ID, edge triggered and active high
+    write(entry(irq), RedirectionMasked);
+    write(entry(irq) + 1, coreId << 24);
+    write(entry(irq), RedirectionMasked | (InterruptBase + irq));
+    return Success;
+}
+
+bool IntelIOAPIC::isRoutable(const uint irq) const
+{
+    return irq < NumberOfIRQs && entry(irq) < Redirection + (m_numEntries * 2);
+}
+
+uint IntelIOAPIC::entry(const uint irq) const
+{
+    return Redirection + ((irq == 0 ? 2 : irq) * 2);
+}
+
+u32 IntelIOAPIC::read(const uint reg)
+{
+    m_io.write(RegisterSelect, reg);
+    return m_io.read(RegisterWindow);
+}
+
+void IntelIOAPIC::write(const uint reg, const u32 value)
+{
+    m_io.write(RegisterSelect, reg);
+    m_io.write(RegisterWindow, value);
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBARCH_INTEL_IOAPIC_H
+#define __LIBARCH_INTEL_IOAPIC_H
+
+#include <Types.h>
+#include <IntController.h>
+#include "IntelIO.h"
+#include "IntelAPIC.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libarch
+ * @{
+ *
+ * @addtogroup libarch_intel
+ * @{
+ */
+
+/**
+ * Intel I/O Advanced Programmable Interrupt Controller (I/O APIC).
+ *
+ * Routes the legacy ISA interrupts to the local APIC of a chosen core,
+ * using the same interrupt vectors as the PIC. The end-of-interrupt and
+ * inter-processor interrupts are handled by the local APIC of the core.
+ */
+class IntelIOAPIC : public IntController
+{
+  public:
+
+    /** I/O APIC memory mapped I/O register base offset (physical address). */
+    static const uint IOBase = 0xfec00000;
+
+  private:
+
+    /** Base offset for interrupt vectors, equal to the PIC. */
+    static const uint InterruptBase = 32;
+
+    /** Number of legacy ISA interrupts which can be routed. */
+    static const uint NumberOfIRQs = 16;
+
+    /**
+     * Memory mapped registers.
+     */
+    enum Registers
+    {
+        RegisterSelect = 0x00,
+        RegisterWindow = 0x10
+    };
+
+    /**
+     * Indirect registers, accessed via the register window.
+     */
+    enum IndirectRegisters
+    {
+        Version     = 0x01,
+        Redirection = 0x10
+    };
+
+    /**
+     * Redirection table entry flags.
+     */
+    enum RedirectionFlags
+    {
+        VectorMask        = 0xff,
+        RedirectionMasked = (1 << 16)
+    };
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param apic Local APIC of this core.
+     */
+    IntelIOAPIC(IntelAPIC & apic);
+
+    /**
+     * Initialize the I/O APIC.
+     *
+     * The redirection table is shared by all cores and is not reset.
+     * All entries are masked after power on.
+     *
+     * @return Result code. IOError if no I/O APIC is present.
+     */
+    Result initialize();
+
+    /**
+     * Enable hardware interrupt (IRQ).
+     *
+     * @param irq Interrupt Request number.
+     *
+     * @return Result code.
+     */
+    virtual Result enable(uint irq);
+
+    /**
+     * Disable hardware interrupt (IRQ).
+     *
+     * @param irq Interrupt Request number.
+     *
+     * @return Result code.
+     */
+    virtual Result disable(uint irq);
+
+    /**
+     * Clear hardware interrupt (IRQ).
+     *
+     * Signals end-of-interrupt to the local APIC.
+     *
+     * @param irq Interrupt Request number to clear.
+     *
+     * @return Result code.
+     */
+    virtual Result clear(uint irq);
+
+    /**
+     * Send an inter-processor-interrupt (IPI).
+     *
+     * @param targetCoreId Target processor that will receive the interrupt
+     * @param irq Interrupt number to send
+     *
+     * @return Result code
+     */
+    virtual Result send(const uint targetCoreId, const uint irq);
+
+    /**
+     * Route a hardware interrupt (IRQ) to a core.
+     *
+     * The entry stays masked until the IRQ is enabled.
+     *
+     * @param irq Interrupt Request number.
+     * @param coreId Core which receives the interrupt.
+     *
+     * @return Result code.
+     */
+    virtual Result setAffinity(const uint irq, const uint coreId);
+
+  private:
+
+    /**
+     * Check if an IRQ has a redirection table entry.
+     *
+     * @param irq Interrupt Request number.
+     *
+     * @return True if the IRQ can be routed.
+     */
+    bool isRoutable(const uint irq) const;
+
+    /**
+     * Get the redirection table entry of an IRQ.
+     *
+     * The timer (IRQ 0) is connected to input 2, other
+     * ISA interrupts are connected to the input with the same number.
+     *
+     * @param irq Interrupt Request number.
+     *
+     * @return Index of the first register of the entry.
+     */
+    uint entry(const uint irq) const;
+
+    /**
+     * Read an indirect register.
+     *
+     * @param reg Register index
+     *
+     * @return Register value
+     */
+    u32 read(const uint reg);
+
+    /**
+     * Write an indirect register.
+     *
+     * @param reg Register index
+     * @param value Value to write
+     */
+    void write(const uint reg, const u32 value);
+
+  private:
+
+    /** I/O instance */
+    IntelIO m_io;
+
+    /** Local APIC of this core */
+    IntelAPIC & m_apic;
+
+    /** Number of entries in the redirection table */
+    uint m_numEntries;
+};
+
+/**
+ * @}
+ * @}
+ * @}
+ */
+
+#endif /* __LIBARCH_INTEL_IOAPIC_H */
@@ -18,6 +18,7 @@
 #include <FreeNOS/System.h>
 #include <Log.h>
 #include "IntelConstant.h"
+#include "IntelCore.h"
 #include "IntelMP.h"
 #include "IntelBoot.h"
 
@@ -57,9 +58,11 @@ IntelMP::Result IntelMP::discover()
 {
     MPConfig *mpc = 0;
     MPEntry *entry;
+    Size cacheShift, packageShift;
 
     // Clear previous discoveries
     m_cores.clear();
+    clearTopology();
 
     // Try to find MPTable in the BIOS memory.
     mpc = scanMemory(m_bios.getBase());
@@ -84,6 +87,10 @@ IntelMP::Result IntelMP::discover()
     for (uint i = 0; i < mpc->count; i++)
         entry = parseEntry(entry);
 
+    // Find the caches and packages shared by the cores
+    cpuTopology(cacheShift, packageShift);
+    setTopology(cacheShift, packageShift);
+
     return Success;
 }
 
@@ -105,6 +112,11 @@ IntelMP::Result IntelMP::boot(CoreInfo *info)
         return IOError;
     }
 
+    return Success;
+}
+
+IntelMP::Result IntelMP::waitBooted()
+{
     // Wait until the core raises the 'booted' flag in CoreInfo
     while (1)
     {
@@ -162,12 +162,22 @@ class IntelMP : public CoreManager
     /**
      * Boot a processor.
      *
+     * Returns after sending the startup IPI. Use waitBooted()
+     * before booting the next processor.
+     *
      * @param info CoreInfo object pointer.
      *
      * @return Result code.
      */
     virtual Result boot(CoreInfo *info);
 
+    /**
+     * Wait until the last booted processor has started.
+     *
+     * @return Result code.
+     */
+    Result waitBooted();
+
   private:
 
     /**
@@ -45,4 +45,7 @@ IntelMap::IntelMap()
 
     m_regions[UserArgs].virt      = 0xe0000000;
     m_regions[UserArgs].size      = KiloByte(128);
+
+    m_regions[UserClock].virt     = 0xe0020000;
+    m_regions[UserClock].size     = KiloByte(4);
 }
@@ -16,7 +16,6 @@
  */
 
 #include <SplitAllocator.h>
-#include <MemoryBlock.h>
 #include "IntelConstant.h"
 #include "IntelPageDirectory.h"
 
@@ -38,12 +37,38 @@
 #define DIRENTRY(vaddr) \
     ((vaddr) >> DIRSHIFT)
 
+bool IntelPageDirectory::isEmpty(const Address from, const Size size) const
+{
+    for (Size i = 0; i < size; i += MegaByte(4))
+    {
+        if (m_tables[ DIRENTRY(from + i) ] != 0)
+            return false;
+    }
+
+    return true;
+}
+
+Size IntelPageDirectory::countTables(const Address from, const Size size) const
+{
+    Size count = 0;
+
+    for (Size i = 0; i < size; i += MegaByte(4))
+    {
+        const u32 entry = m_tables[ DIRENTRY(from + i) ];
+
+        if ((entry & PAGE_PRESENT) && !(entry & PAGE_SECTION))
+            count++;
+    }
+
+    return count;
+}
+
 IntelPageTable * IntelPageDirectory::getPageTable(Address virt, SplitAllocator *alloc) const
 {
     u32 entry = m_tables[ DIRENTRY(virt) ];
 
     // Check if the page table is present.
-    if (!(entry & PAGE_PRESENT))
+    if (!(entry & PAGE_PRESENT) || (entry & PAGE_SECTION))
         return ZERO;
     else
         return (IntelPageTable *) alloc->toVirtual(entry & PAGEMASK);
@@ -72,16 +97,18 @@ MemoryContext::Result IntelPageDirectory::map(Address virt,
     // Check if the page table is present.
     if (!table)
     {
+        // Reject if already mapped as a 4 megabyte page
+        if (m_tables[ DIRENTRY(virt) ] & PAGE_PRESENT)
+            return MemoryContext::AlreadyExists;
+
         allocPhys.address = 0;
         allocPhys.size = sizeof(IntelPageTable);
         allocPhys.alignment = PAGESIZE;
 
         // Allocate a new page table
-        if (alloc->allocate(allocPhys, allocVirt) != Allocator::Success)
+        if (alloc->allocateZeroed(allocPhys, allocVirt) != Allocator::Success)
             return MemoryContext::OutOfMemory;
 
-        MemoryBlock::set((void *)allocVirt.address, 0, sizeof(IntelPageTable));
-
         // Assign to the page directory
         m_tables[ DIRENTRY(virt) ] = allocPhys.address | PAGE_PRESENT | PAGE_WRITE | flags(access);
         table = getPageTable(virt, alloc);
@@ -89,13 +116,130 @@ MemoryContext::Result IntelPageDirectory::map(Address virt,
     return table->map(virt, phys, access);
 }
 
+MemoryContext::Result IntelPageDirectory::mapLarge(Memory::Range range)
+{
+    if (range.size & ~SECTIONMASK)
+        return MemoryContext::InvalidSize;
+
+    if ((range.phys & ~SECTIONMASK) || (range.virt & ~SECTIONMASK))
+        return MemoryContext::InvalidAddress;
+
+    for (Size i = 0; i < range.size; i += MegaByte(4))
+    {
+        if (m_tables[ DIRENTRY(range.virt + i) ] & PAGE_PRESENT)
+            return MemoryContext::AlreadyExists;
+
+        m_tables[ DIRENTRY(range.virt + i) ] = (range.phys + i) | PAGE_PRESENT | PAGE_SECTION | flags(range.access);
+    }
+    return MemoryContext::Success;
+}
+
+MemoryContext::Result IntelPageDirectory::mapRange(Memory::Range range,
+                                                   SplitAllocator *alloc)
+{
+    for (Size i = 0; i < range.size; )
+    {
+        const Size remain = SECTIONSIZE - ((range.virt + i) & ~SECTIONMASK);
+        const Size chunk = range.size - i < remain ? range.size - i : remain;
+
+        // The first page allocates the page table, if needed
+        MemoryContext::Result r = map(range.virt + i, range.phys + i, range.access, alloc);
+        if (r != MemoryContext::Success)
+            return r;
+
+        // Fill the remainder of the page table directly
+        IntelPageTable *table = getPageTable(range.virt + i, alloc);
+
+        for (Size j = PAGESIZE; j < chunk; j += PAGESIZE)
+        {
+            r = table->map(range.virt + i + j, range.phys + i + j, range.access);
+            if (r != MemoryContext::Success)
+                return r;
+        }
+
+        i += chunk;
+    }
+
+    return MemoryContext::Success;
+}
+
 MemoryContext::Result IntelPageDirectory::unmap(Address virt, SplitAllocator *alloc)
 {
     IntelPageTable *table = getPageTable(virt, alloc);
     if (!table)
+    {
+        if (!(m_tables[ DIRENTRY(virt) ] & PAGE_SECTION))
+            return MemoryContext::InvalidAddress;
+
+        const MemoryContext::Result r = splitLarge(virt, alloc);
+        if (r != MemoryContext::Success)
+            return r;
+
+        table = getPageTable(virt, alloc);
+    }
+
+    return table->unmap(virt);
+}
+
+MemoryContext::Result IntelPageDirectory::unmapLarge(Address virt)
+{
+    if (virt & ~SECTIONMASK)
         return MemoryContext::InvalidAddress;
-    else
-        return table->unmap(virt);
+
+    if (!(m_tables[ DIRENTRY(virt) ] & PAGE_SECTION))
+        return MemoryContext::InvalidAddress;
+
+    m_tables[ DIRENTRY(virt) ] = PAGE_NONE;
+    return MemoryContext::Success;
+}
+
+MemoryContext::Result IntelPageDirectory::unmapRange(Memory::Range range,
+                                                     SplitAllocator *alloc)
+{
+    for (Size i = 0; i < range.size; )
+    {
+        const Size remain = SECTIONSIZE - ((range.virt + i) & ~SECTIONMASK);
+        const Size chunk = range.size - i < remain ? range.size - i : remain;
+
+        // The first page splits a 4 megabyte mapping, if needed
+        MemoryContext::Result r = unmap(range.virt + i, alloc);
+        if (r != MemoryContext::Success)
+            return r;
+
+        // Clear the remainder of the page table directly
+        IntelPageTable *table = getPageTable(range.virt + i, alloc);
+
+        for (Size j = PAGESIZE; j < chunk; j += PAGESIZE)
+            table->unmap(range.virt + i + j);
+
+        i += chunk;
+    }
+
+    return MemoryContext::Success;
+}
+
+MemoryContext::Result IntelPageDirectory::splitLarge(Address virt, SplitAllocator *alloc)
+{
+    const u32 entry = m_tables[ DIRENTRY(virt) ];
+    const Memory::Access access = largeAccess(entry);
+    const Address base = virt & SECTIONMASK;
+    Allocator::Range allocPhys, allocVirt;
+
+    allocPhys.address = 0;
+    allocPhys.size = sizeof(IntelPageTable);
+    allocPhys.alignment = PAGESIZE;
+
+    // Allocate a new page table
+    if (alloc->allocateZeroed(allocPhys, allocVirt) != Allocator::Success)
+        return MemoryContext::OutOfMemory;
+
+    // Fill the page table with the same mappings before it becomes visible
+    IntelPageTable *table = (IntelPageTable *) allocVirt.address;
+    for (Size i = 0; i < MegaByte(4); i += PAGESIZE)
+        table->map(base + i, (entry & SECTIONMASK) + i, access);
+
+    m_tables[ DIRENTRY(virt) ] = allocPhys.address | PAGE_PRESENT | PAGE_WRITE | flags(access);
+    return MemoryContext::Success;
 }
 
 MemoryContext::Result IntelPageDirectory::translate(Address virt,
@@ -125,11 +269,28 @@ MemoryContext::Result IntelPageDirectory::access(Address virt,
 {
     IntelPageTable *table = getPageTable(virt, alloc);
     if (!table)
+    {
+        if (m_tables[DIRENTRY(virt)] & PAGE_SECTION)
+        {
+            *access = largeAccess(m_tables[DIRENTRY(virt)]);
+            return MemoryContext::Success;
+        }
         return MemoryContext::InvalidAddress;
+    }
     else
         return table->access(virt, access);
 }
 
+Memory::Access IntelPageDirectory::largeAccess(u32 entry) const
+{
+    Memory::Access access = Memory::Readable;
+
+    if (entry & PAGE_WRITE) access |= Memory::Writable;
+    if (entry & PAGE_USER)  access |= Memory::User;
+
+    return access;
+}
+
 u32 IntelPageDirectory::flags(Memory::Access access) const
 {
     u32 f = 0;
@@ -168,6 +329,26 @@ MemoryContext::Result IntelPageDirectory::releaseRange(const Memory::Range range
     // Walk the full range of memory specified
     for (Size addr = range.virt; addr < range.virt + range.size; addr += PAGESIZE)
     {
+        if (m_tables[ DIRENTRY(addr) ] & PAGE_SECTION)
+        {
+            // Release a 4 megabyte page at once if fully covered
+            if (!(addr & ~SECTIONMASK) && range.virt + range.size - addr >= MegaByte(4))
+            {
+                phys = m_tables[ DIRENTRY(addr) ] & SECTIONMASK;
+
+                for (Size i = 0; i < MegaByte(4); i += PAGESIZE)
+                    releasePhysical(alloc, phys + i);
+
+                m_tables[ DIRENTRY(addr) ] = PAGE_NONE;
+                addr += MegaByte(4) - PAGESIZE;
+                continue;
+            }
+            else if (splitLarge(addr, alloc) != MemoryContext::Success)
+            {
+                return MemoryContext::OutOfMemory;
+            }
+        }
+
         IntelPageTable *table = getPageTable(addr, alloc);
         if (table == ZERO)
         {
@@ -204,6 +385,18 @@ MemoryContext::Result IntelPageDirectory::releaseSection(const Memory::Range ran
         IntelPageTable *table = getPageTable(addr, alloc);
         if (!table)
         {
+            // Release 4 megabyte pages directly
+            if (m_tables[ DIRENTRY(addr) ] & PAGE_SECTION)
+            {
+                if (!tablesOnly)
+                {
+                    phys = m_tables[ DIRENTRY(addr) ] & SECTIONMASK;
+
+                    for (Size i = 0; i < MegaByte(4); i += PAGESIZE)
+                        releasePhysical(alloc, phys + i);
+                }
+                m_tables[ DIRENTRY(addr) ] = 0;
+            }
             continue;
         }
 
@@ -56,6 +56,26 @@ class IntelPageDirectory
                                Address from,
                                Address to);
 
+    /**
+     * Check that a range has no mappings.
+     *
+     * @param from Virtual address to start checking from
+     * @param size Number of bytes to check
+     *
+     * @return True if no page tables or sections are present in the range
+     */
+    bool isEmpty(const Address from, const Size size) const;
+
+    /**
+     * Count the page tables in a range.
+     *
+     * @param from Virtual address to start counting from
+     * @param size Number of bytes to check
+     *
+     * @return Number of page tables present in the range
+     */
+    Size countTables(const Address from, const Size size) const;
+
     /**
      * Map a virtual address to a physical address.
      *
@@ -71,9 +91,36 @@ class IntelPageDirectory
                               Memory::Access access,
                               SplitAllocator *alloc);
 
+    /**
+     * Map a contigous range of virtual memory to physical memory.
+     *
+     * This function can map at the granularity of 4 megabyte memory chunks.
+     *
+     * @param range Virtual to physical memory range.
+     *
+     * @return Result code
+     */
+    MemoryContext::Result mapLarge(Memory::Range range);
+
+    /**
+     * Map a range of contiguous physical pages.
+     *
+     * Each page table covered by the range is looked up once.
+     *
+     * @param range Virtual to physical memory range.
+     * @param alloc Physical memory allocator for extra page tables.
+     *
+     * @return Result code
+     */
+    MemoryContext::Result mapRange(Memory::Range range,
+                                   SplitAllocator *alloc);
+
     /**
      * Remove virtual address mapping.
      *
+     * A 4 megabyte mapping containing the address is
+     * first split into a page table, if needed.
+     *
      * @param virt Virtual address.
      * @param alloc Memory allocator used by the caller
      *
@@ -82,6 +129,28 @@ class IntelPageDirectory
     MemoryContext::Result unmap(Address virt,
                                 SplitAllocator *alloc);
 
+    /**
+     * Remove a 4 megabyte mapping.
+     *
+     * @param virt Virtual address aligned to 4 megabytes.
+     *
+     * @return Result code
+     */
+    MemoryContext::Result unmapLarge(Address virt);
+
+    /**
+     * Remove the mappings of a range of pages.
+     *
+     * Each page table covered by the range is looked up once.
+     *
+     * @param range Range of virtual addresses.
+     * @param alloc Memory allocator used by the caller
+     *
+     * @return Result code
+     */
+    MemoryContext::Result unmapRange(Memory::Range range,
+                                     SplitAllocator *alloc);
+
     /**
      * Translate virtual address to physical address.
      *
@@ -153,6 +222,25 @@ class IntelPageDirectory
      */
     IntelPageTable * getPageTable(Address virt, SplitAllocator *alloc) const;
 
+    /**
+     * Replace a 4 megabyte mapping by a page table with the same mappings
+     *
+     * @param virt Virtual address inside the 4 megabyte mapping
+     * @param alloc Memory allocator for the new page table
+     *
+     * @return Result code
+     */
+    MemoryContext::Result splitLarge(Address virt, SplitAllocator *alloc);
+
+    /**
+     * Convert page directory flags of a 4 megabyte mapping to Memory::Access.
+     *
+     * @param entry Page directory entry
+     *
+     * @return Memory access flags
+     */
+    Memory::Access largeAccess(u32 entry) const;
+
     /**
      * Convert Memory::Access to page directory flags.
      *
@@ -16,10 +16,14 @@
  */
 
 #include <SplitAllocator.h>
-#include <MemoryBlock.h>
+#include "IntelConstant.h"
 #include "IntelCore.h"
 #include "IntelPaging.h"
 
+Address IntelPaging::m_pageDirectoryCache[IntelPaging::PageDirectoryCacheSize];
+
+Size IntelPaging::m_pageDirectoryCacheCount = 0;
+
 IntelPaging::IntelPaging(MemoryMap *map, SplitAllocator *alloc)
     : MemoryContext(map, alloc)
     , m_pageDirectory(0)
@@ -40,7 +44,19 @@ IntelPaging::~IntelPaging()
 {
     if (m_pageDirectoryAllocated)
     {
-        m_alloc->release(m_pageDirectoryAddr);
+        const Memory::Range kernel = m_map->range(MemoryMap::KernelPrivate);
+        const Address userBase = kernel.virt + kernel.size;
+
+        // Keep the page directory for reuse if all user mappings are released
+        if (m_pageDirectoryCacheCount < PageDirectoryCacheSize &&
+            m_pageDirectory->isEmpty(userBase, 0 - userBase))
+        {
+            m_pageDirectoryCache[m_pageDirectoryCacheCount++] = m_pageDirectoryAddr;
+        }
+        else
+        {
+            m_alloc->release(m_pageDirectoryAddr);
+        }
     }
 }
 
@@ -58,8 +74,14 @@ MemoryContext::Result IntelPaging::initialize()
     phys.size = sizeof(IntelPageDirectory);
     phys.alignment = sizeof(IntelPageDirectory);
 
+    // Reuse a released page directory, which has no user mappings left
+    if (m_pageDirectoryCacheCount > 0)
+    {
+        phys.address = m_pageDirectoryCache[--m_pageDirectoryCacheCount];
+        virt.address = m_alloc->toVirtual(phys.address);
+    }
     // Allocate page directory from low physical memory.
-    if (m_alloc->allocate(phys, virt) != Allocator::Success)
+    else if (m_alloc->allocateZeroed(phys, virt) != Allocator::Success)
     {
         return MemoryContext::OutOfMemory;
     }
@@ -68,9 +90,6 @@ MemoryContext::Result IntelPaging::initialize()
     m_pageDirectoryAddr = phys.address;
     m_pageDirectory = (IntelPageDirectory *) virt.address;
 
-    // Initialize the page directory
-    MemoryBlock::set(m_pageDirectory, 0, sizeof(IntelPageDirectory));
-
     // Lookup the currently active page directory
     IntelPageDirectory *currentDirectory =
         (IntelPageDirectory *) m_alloc->toVirtual(core.readCR3());
@@ -105,8 +124,8 @@ MemoryContext::Result IntelPaging::map(Address virt, Address phys, Memory::Acces
     MemoryContext::Result r = m_pageDirectory->map(virt, phys, acc, m_alloc);
 
     // Flush TLB entry
-    if (r == Success && m_current == this)
-        tlb_flush(virt);
+    if (r == Success)
+        invalidateTLB(virt, PAGESIZE);
 
     return r;
 }
@@ -116,12 +135,69 @@ MemoryContext::Result IntelPaging::unmap(Address virt)
     MemoryContext::Result r = m_pageDirectory->unmap(virt, m_alloc);
 
     // Flush TLB entry
-    if (r == Success && m_current == this)
-        tlb_flush(virt);
+    if (r == Success)
+        invalidateTLB(virt, PAGESIZE);
+
+    return r;
+}
+
+MemoryContext::Result IntelPaging::mapPages(const Memory::Range & range)
+{
+    MemoryContext::Result r = m_pageDirectory->mapRange(range, m_alloc);
+
+    // Flush TLB entries
+    invalidateTLB(range.virt, range.size);
+    return r;
+}
+
+MemoryContext::Result IntelPaging::unmapPages(const Memory::Range & range)
+{
+    MemoryContext::Result r = m_pageDirectory->unmapRange(range, m_alloc);
+
+    // Flush TLB entries
+    invalidateTLB(range.virt, range.size);
+    return r;
+}
+
+MemoryContext::Result IntelPaging::mapLarge(Memory::Range *range)
+{
+    MemoryContext::Result r = m_pageDirectory->mapLarge(*range);
+
+    // Flush TLB entries
+    if (r == Success)
+        for (Size i = 0; i < range->size; i += SECTIONSIZE)
+            flushTLB(range->virt + i);
 
     return r;
 }
 
+MemoryContext::Result IntelPaging::unmapLarge(Address virt)
+{
+    MemoryContext::Result r = m_pageDirectory->unmapLarge(virt);
+
+    // Flush TLB entry
+    if (r == Success)
+        flushTLB(virt);
+
+    return r;
+}
+
+void IntelPaging::flushTLB(const Address virt)
+{
+    if (m_current == this)
+        tlb_flush(virt);
+}
+
+void IntelPaging::flushTLBAll()
+{
+    // Reloading CR3 keeps the global kernel mappings
+    if (m_current == this)
+    {
+        IntelCore core;
+        core.writeCR3(m_pageDirectoryAddr);
+    }
+}
+
 MemoryContext::Result IntelPaging::lookup(Address virt, Address *phys) const
 {
     return m_pageDirectory->translate(virt, phys, m_alloc);
@@ -140,5 +216,18 @@ MemoryContext::Result IntelPaging::releaseSection(const Memory::Range & range,
 
 MemoryContext::Result IntelPaging::releaseRange(Memory::Range *range)
 {
-    return m_pageDirectory->releaseRange(*range, m_alloc);
+    const Size mapped = countMapped(*range);
+    const MemoryContext::Result r = m_pageDirectory->releaseRange(*range, m_alloc);
+
+    removeUsage(r == Success ? mapped : mapped - countMapped(*range), false);
+    return r;
+}
+
+Size IntelPaging::countTables() const
+{
+    const Memory::Range kernel = m_map->range(MemoryMap::KernelPrivate);
+    const Address userBase = kernel.virt + kernel.size;
+
+    // The page tables of the kernel are shared by all contexts
+    return 1 + m_pageDirectory->countTables(userBase, 0 - userBase);
 }
@@ -42,6 +42,11 @@ class SplitAllocator;
  */
 class IntelPaging : public MemoryContext
 {
+  private:
+
+    /** Maximum number of released page directories kept for reuse. */
+    static const Size PageDirectoryCacheSize = 8;
+
   public:
 
     /**
@@ -112,6 +117,42 @@ class IntelPaging : public MemoryContext
      */
     virtual Result unmap(Address virt);
 
+    /**
+     * Map a contiguous range using large pages.
+     *
+     * @param range Range object describing the range of physical pages.
+     *
+     * @return Result code
+     */
+    virtual Result mapLarge(Memory::Range *range);
+
+    /**
+     * Unmap a single large page.
+     *
+     * @param virt Virtual address aligned to SECTIONSIZE.
+     *
+     * @return Result code
+     */
+    virtual Result unmapLarge(Address virt);
+
+    /**
+     * Map a range of contiguous physical pages using small pages only.
+     *
+     * @param range Range object describing the range of physical pages.
+     *
+     * @return Result code
+     */
+    virtual Result mapPages(const Memory::Range & range);
+
+    /**
+     * Unmap a range of small pages.
+     *
+     * @param range Range object describing the range of virtual addresses.
+     *
+     * @return Result code
+     */
+    virtual Result unmapPages(const Memory::Range & range);
+
     /**
      * Translate virtual address to physical address.
      *
@@ -156,6 +197,27 @@ class IntelPaging : public MemoryContext
      */
     virtual Result releaseRange(Memory::Range *range);
 
+  protected:
+
+    /**
+     * Invalidate the TLB entry of a single page.
+     *
+     * @param virt Virtual address of the page
+     */
+    virtual void flushTLB(const Address virt);
+
+    /**
+     * Invalidate all non-global TLB entries.
+     */
+    virtual void flushTLBAll();
+
+    /**
+     * Count the page directory and the page tables of user mappings.
+     *
+     * @return Number of pages
+     */
+    virtual Size countTables() const;
+
   private:
 
     /** Pointer to page directory in kernel's virtual memory. */
@@ -166,6 +228,15 @@ class IntelPaging : public MemoryContext
 
     /** Set to true if page directory was allocated by this class */
     bool m_pageDirectoryAllocated;
+
+    /**
+     * Physical addresses of released page directories without user mappings.
+     * They still contain the kernel mappings and are reused before allocating.
+     */
+    static Address m_pageDirectoryCache[PageDirectoryCacheSize];
+
+    /** Number of page directories in the cache */
+    static Size m_pageDirectoryCacheCount;
 };
 
 namespace Arch
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IntelCore.h"
+#include "IntelPerformanceCounter.h"
+
+IntelPerformanceCounter::IntelPerformanceCounter()
+    : m_unavailable(0)
+{
+    ulong eax = 0, ebx, ecx, edx;
+
+    // Determine if the CPUID leaf is present
+    asm volatile ("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    if (eax < CPUIDLeaf)
+        return;
+
+    eax = CPUIDLeaf;
+    asm volatile ("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+
+    // Version zero means no architectural performance monitoring
+    if ((eax & 0xff) == 0)
+        return;
+
+    const Size counters = (eax >> 8) & 0xff;
+    const Size width = (eax >> 16) & 0xff;
+
+    m_count = counters < MaximumCounters ? counters : MaximumCounters;
+    m_mask = width >= 64 ? ~((u64) 0) : (((u64) 1 << width) - 1);
+    m_unavailable = ebx;
+}
+
+IntelPerformanceCounter::Result IntelPerformanceCounter::configure(const Size index,
+                                                                   const Event event)
+{
+    u32 code, umask, bit;
+
+    if (index >= m_count)
+        return InvalidArgument;
+
+    switch (event)
+    {
+        case None:         code = 0;    umask = 0;    bit = 0; break;
+        case Cycles:       code = 0x3c; umask = 0x00; bit = 0; break;
+        case Instructions: code = 0xc0; umask = 0x00; bit = 1; break;
+        case CacheMisses:  code = 0x2e; umask = 0x41; bit = 4; break;
+        case BranchMisses: code = 0xc5; umask = 0x00; bit = 6; break;
+        default:
+            return NotSupported;
+    }
+
+    if (event != None && (m_unavailable & (1 << bit)))
+        return NotSupported;
+
+    // Stop and reset the counter before programming the new event
+    wrmsr(INTEL_MSR_PERFEVTSEL0 + index, 0);
+    wrmsr(INTEL_MSR_PMC0 + index, 0);
+
+    if (event != None)
+    {
+        wrmsr(INTEL_MSR_PERFEVTSEL0 + index,
+              code | (umask << 8) | SelectUser | SelectKernel | SelectEnable);
+    }
+
+    m_events[index] = event;
+    return Success;
+}
+
+u64 IntelPerformanceCounter::read(const Size index) const
+{
+    return index < m_count ? rdmsr(INTEL_MSR_PMC0 + index) & m_mask : 0;
+}
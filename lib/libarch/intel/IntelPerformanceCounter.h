@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBARCH_INTEL_INTELPERFORMANCECOUNTER_H
+#define __LIBARCH_INTEL_INTELPERFORMANCECOUNTER_H
+
+#include <Types.h>
+#include <Macros.h>
+#include <PerformanceCounter.h>
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libarch
+ * @{
+ *
+ * @addtogroup libarch_intel
+ * @{
+ */
+
+/**
+ * Intel architectural performance monitoring counters.
+ *
+ * Uses the general purpose counters described by CPUID leaf 0xA,
+ * which count in both user and kernel mode.
+ */
+class IntelPerformanceCounter : public PerformanceCounter
+{
+  private:
+
+    /** CPUID leaf describing architectural performance monitoring */
+    static const u32 CPUIDLeaf = 0xa;
+
+    /** PERFEVTSEL flag to count in user mode */
+    static const u32 SelectUser = (1 << 16);
+
+    /** PERFEVTSEL flag to count in kernel mode */
+    static const u32 SelectKernel = (1 << 17);
+
+    /** PERFEVTSEL flag to enable the counter */
+    static const u32 SelectEnable = (1 << 22);
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * Detects the number and width of the counters using CPUID.
+     */
+    IntelPerformanceCounter();
+
+    /**
+     * Program a counter, which also resets it to zero.
+     *
+     * @param index Counter number
+     * @param event Event to count or None to disable the counter
+     *
+     * @return Result code. NotSupported for TLBMisses, which
+     *         has no architectural event on Intel.
+     */
+    virtual Result configure(const Size index, const Event event);
+
+    /**
+     * Read the value of a counter.
+     *
+     * @param index Counter number
+     *
+     * @return Current counter value
+     */
+    virtual u64 read(const Size index) const;
+
+  private:
+
+    /** Architectural events which are not available, from CPUID EBX */
+    u32 m_unavailable;
+};
+
+namespace Arch
+{
+    typedef IntelPerformanceCounter PerformanceCounter;
+};
+
+/**
+ * @}
+ * @}
+ * @}
+ */
+
+#endif /* __LIBARCH_INTEL_INTELPERFORMANCECOUNTER_H */
@@ -65,6 +65,16 @@ extern C void loadCoreState();
  */
 extern C void interruptHandler();
 
+/**
+ * System call handler for the sysenter instruction.
+ *
+ * Creates the same CPUState as interruptHandler() does for
+ * a kernel trap, and returns to userspace using sysexit.
+ *
+ * @see trapKernelFast
+ */
+extern C void sysenterHandler();
+
 /**
  * Process an interrupt.
  *
@@ -41,6 +41,84 @@
  * @{
  */
 
+/**
+ * Kernel trap entry methods.
+ */
+enum IntelTrapMode
+{
+    IntelTrapUnknown   = 0,
+    IntelTrapInterrupt = 1,
+    IntelTrapSysenter  = 2
+};
+
+/** CPUID feature flag (EDX) for sysenter/sysexit support. */
+#define INTEL_CPUID_SEP (1 << 11)
+
+/**
+ * Enter the kernel via sysenter.
+ *
+ * The sysexit instruction returns with the user stack pointer in ECX
+ * and the return address in EDX, which the kernel finds at the top of
+ * the user stack pointed to by EBP. The argument registers ECX and EDX
+ * and the frame pointer EBP are saved and restored on the user stack.
+ */
+#define INTEL_SYSENTER \
+    "pushl %%ebp\n" \
+    "pushl %%edx\n" \
+    "pushl %%ecx\n" \
+    "pushl $1f\n" \
+    "movl %%esp, %%ebp\n" \
+    "sysenter\n" \
+    "1:\n" \
+    "addl $4, %%esp\n" \
+    "popl %%ecx\n" \
+    "popl %%edx\n" \
+    "popl %%ebp\n"
+
+/**
+ * Check if the processor supports sysenter/sysexit.
+ *
+ * @return True if supported, false otherwise.
+ */
+inline bool isSysenterSupported()
+{
+    ulong eax = 1, ebx, ecx, edx;
+
+    asm volatile ("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    return (edx & INTEL_CPUID_SEP) != 0;
+}
+
+/**
+ * Retrieve the kernel trap entry method of this program.
+ *
+ * @return Reference to the IntelTrapMode in use
+ */
+inline ulong & trapKernelMode()
+{
+    static ulong mode = IntelTrapUnknown;
+    return mode;
+}
+
+/**
+ * Check if kernel traps should use sysenter.
+ *
+ * The entry method is detected once using CPUID. The
+ * kernel itself always uses the software interrupt.
+ *
+ * @return True to use sysenter, false for the software interrupt.
+ */
+inline bool trapKernelFast()
+{
+    ulong & mode = trapKernelMode();
+
+    if (mode == IntelTrapUnknown)
+    {
+        mode = isSysenterSupported() ? IntelTrapSysenter : IntelTrapInterrupt;
+    }
+
+    return mode == IntelTrapSysenter;
+}
+
 /**
  * Perform a kernel trap with 1 argument.
  *
@@ -52,7 +130,10 @@
 inline ulong trapKernel1(ulong num, ulong arg1)
 {
     ulong ret;
-    asm volatile ("int $0x90" : "=a"(ret) : "a"(num), "c"(arg1) : "memory");
+    if (trapKernelFast())
+        asm volatile (INTEL_SYSENTER : "=a"(ret) : "a"(num), "c"(arg1) : "memory");
+    else
+        asm volatile ("int $0x90" : "=a"(ret) : "a"(num), "c"(arg1) : "memory");
     return ret;
 }
 
@@ -68,7 +149,10 @@ inline ulong trapKernel1(ulong num, ulong arg1)
 inline ulong trapKernel2(ulong num, ulong arg1, ulong arg2)
 {
     ulong ret;
-    asm volatile ("int $0x90" : "=a"(ret) : "a"(num), "c"(arg1), "b"(arg2) : "memory");
+    if (trapKernelFast())
+        asm volatile (INTEL_SYSENTER : "=a"(ret) : "a"(num), "c"(arg1), "b"(arg2) : "memory");
+    else
+        asm volatile ("int $0x90" : "=a"(ret) : "a"(num), "c"(arg1), "b"(arg2) : "memory");
     return ret;
 }
 
@@ -85,8 +169,12 @@ inline ulong trapKernel2(ulong num, ulong arg1, ulong arg2)
 inline ulong trapKernel3(ulong num, ulong arg1, ulong arg2, ulong arg3)
 {
     ulong ret;
-    asm volatile ("int $0x90" : "=a"(ret) : "a"(num), "c"(arg1), "b"(arg2),
-                        "d"(arg3) : "memory");
+    if (trapKernelFast())
+        asm volatile (INTEL_SYSENTER : "=a"(ret) : "a"(num), "c"(arg1), "b"(arg2),
+                            "d"(arg3) : "memory");
+    else
+        asm volatile ("int $0x90" : "=a"(ret) : "a"(num), "c"(arg1), "b"(arg2),
+                            "d"(arg3) : "memory");
     return ret;
 }
 
@@ -105,8 +193,12 @@ inline ulong trapKernel4(ulong num, ulong arg1, ulong arg2, ulong arg3,
              ulong arg4)
 {
     ulong ret;
-    asm volatile ("int $0x90" : "=a"(ret) : "a"(num), "c"(arg1), "b"(arg2),
-                        "d"(arg3), "S"(arg4) : "memory");
+    if (trapKernelFast())
+        asm volatile (INTEL_SYSENTER : "=a"(ret) : "a"(num), "c"(arg1), "b"(arg2),
+                            "d"(arg3), "S"(arg4) : "memory");
+    else
+        asm volatile ("int $0x90" : "=a"(ret) : "a"(num), "c"(arg1), "b"(arg2),
+                            "d"(arg3), "S"(arg4) : "memory");
     return ret;
 }
 
@@ -126,8 +218,12 @@ inline ulong trapKernel5(ulong num, ulong arg1, ulong arg2, ulong arg3,
              ulong arg4, ulong arg5)
 {
     ulong ret;
-    asm volatile ("int $0x90" : "=a"(ret) : "a"(num), "c"(arg1), "b"(arg2),
-                 "d"(arg3), "S"(arg4), "D"(arg5) : "memory");
+    if (trapKernelFast())
+        asm volatile (INTEL_SYSENTER : "=a"(ret) : "a"(num), "c"(arg1), "b"(arg2),
+                     "d"(arg3), "S"(arg4), "D"(arg5) : "memory");
+    else
+        asm volatile ("int $0x90" : "=a"(ret) : "a"(num), "c"(arg1), "b"(arg2),
+                     "d"(arg3), "S"(arg4), "D"(arg5) : "memory");
     return ret;
 }
 
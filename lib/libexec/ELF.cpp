@@ -20,11 +20,16 @@
 
 ELF::ELF(const u8 *image, const Size size)
     : ExecutableFormat(image, size)
+    , m_index(ZERO)
+    , m_indexCount(0)
+    , m_indexResult(NotFound)
+    , m_indexed(false)
 {
 }
 
 ELF::~ELF()
 {
+    delete[] m_index;
 }
 
 ELF::Result ELF::detect(const u8 *image, const Size size, ExecutableFormat **fmt)
@@ -76,7 +81,17 @@ ELF::Result ELF::regions(ELF::Region *regions, Size *count) const
         regions[numRegions].dataOffset = segments[numSegments].offset;
         regions[numRegions].dataSize   = segments[numSegments].fileSize;
         regions[numRegions].memorySize = segments[numSegments].memorySize;
-        regions[numRegions++].access   = Memory::User | Memory::Readable | Memory::Writable | Memory::Executable;
+        regions[numRegions].access     = Memory::User;
+
+        // Apply the segment permissions
+        if (segments[numSegments].flags & ELF_SEGMENT_FLAG_READ)
+            regions[numRegions].access |= Memory::Readable;
+        if (segments[numSegments].flags & ELF_SEGMENT_FLAG_WRITE)
+            regions[numRegions].access |= Memory::Writable;
+        if (segments[numSegments].flags & ELF_SEGMENT_FLAG_EXEC)
+            regions[numRegions].access |= Memory::Executable;
+
+        numRegions++;
     }
 
     // All done
@@ -90,3 +105,171 @@ ELF::Result ELF::entry(Address *entry) const
     *entry = header->entry;
     return Success;
 }
+
+ELF::Result ELF::symbol(const Address addr, const char **name, Address *start) const
+{
+    if (!m_indexed)
+    {
+        m_indexResult = buildIndex();
+        m_indexed = true;
+    }
+
+    if (m_indexResult != Success)
+    {
+        return m_indexResult;
+    }
+
+    // Find the last function which starts at or before the address
+    Size low = 0, high = m_indexCount;
+
+    while (low < high)
+    {
+        const Size mid = low + ((high - low) / 2);
+
+        if (m_index[mid].start <= addr)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    // Aliases share the same start address but may differ in size
+    for (Size i = low; i > 0 && m_index[i - 1].start == m_index[low - 1].start; i--)
+    {
+        const IndexEntry &entry = m_index[i - 1];
+
+        if (addr < entry.end)
+        {
+            *name  = entry.name;
+            *start = entry.start;
+            return Success;
+        }
+    }
+
+    return NotFound;
+}
+
+void ELF::siftDown(IndexEntry *entries, Size root, const Size count)
+{
+    const IndexEntry value = entries[root];
+
+    for (Size child = (root * 2) + 1; child < count; child = (root * 2) + 1)
+    {
+        if (child + 1 < count && entries[child + 1].start > entries[child].start)
+            child++;
+
+        if (entries[child].start <= value.start)
+            break;
+
+        entries[root] = entries[child];
+        root = child;
+    }
+
+    entries[root] = value;
+}
+
+ELF::Result ELF::buildIndex() const
+{
+    const ELFHeader *header = (const ELFHeader *) m_image;
+    const ELFSection *sections = (const ELFSection *) (m_image + header->sectionHeaderOffset);
+    const Size numSections = header->sectionHeaderEntryCount;
+    Size count = 0;
+
+    // Section header table must be inside the image
+    if (header->sectionHeaderEntrySize != sizeof(ELFSection) ||
+        header->sectionHeaderOffset > m_size ||
+        numSections > (m_size - header->sectionHeaderOffset) / sizeof(ELFSection))
+    {
+        return InvalidFormat;
+    }
+
+    // First count the function symbols, then fill the index
+    for (Size pass = 0; pass < 2; pass++)
+    {
+        if (pass == 1)
+        {
+            if (count == 0)
+                return NotFound;
+
+            m_index = new IndexEntry[count];
+            if (m_index == ZERO)
+                return OutOfMemory;
+
+            count = 0;
+        }
+
+        for (Size i = 0; i < numSections; i++)
+        {
+            if (sections[i].type != ELF_SECTION_SYMTAB || sections[i].link >= numSections)
+                continue;
+
+            const ELFSection &table = sections[i];
+            const ELFSection &strings = sections[table.link];
+
+            // Both tables must be inside the image and the strings terminated
+            if (table.offset > m_size || table.size > m_size - table.offset ||
+                strings.offset > m_size || strings.size > m_size - strings.offset ||
+                strings.size == 0 || m_image[strings.offset + strings.size - 1] != 0)
+            {
+                continue;
+            }
+
+            const ELFSymbol *symbols = (const ELFSymbol *) (m_image + table.offset);
+            const Size numSymbols = table.size / sizeof(ELFSymbol);
+
+            for (Size j = 0; j < numSymbols; j++)
+            {
+                const ELFSymbol &sym = symbols[j];
+
+                if (ELF_SYMBOL_TYPE(sym.info) != ELF_SYMBOL_FUNC || sym.name >= strings.size)
+                    continue;
+
+                if (pass == 1)
+                {
+                    IndexEntry &entry = m_index[count];
+                    entry.start = sym.value;
+                    entry.end   = sym.size == 0 ? 0 : sym.value + sym.size;
+
+                    if (sym.size != 0 && entry.end < entry.start)
+                        entry.end = ~((Address) 0);
+                    entry.name  = (const char *) (m_image + strings.offset + sym.name);
+                }
+                count++;
+            }
+        }
+    }
+
+    // Heap sort the index by start address
+    for (Size i = count / 2; i > 0; i--)
+    {
+        siftDown(m_index, i - 1, count);
+    }
+
+    for (Size i = count; i > 1; i--)
+    {
+        const IndexEntry top = m_index[0];
+        m_index[0] = m_index[i - 1];
+        m_index[i - 1] = top;
+        siftDown(m_index, 0, i - 1);
+    }
+
+    // Symbols without a size extend up to the next function
+    for (Size i = 0; i < count; i++)
+    {
+        if (m_index[i].end != 0)
+            continue;
+
+        m_index[i].end = ~((Address) 0);
+
+        for (Size j = i + 1; j < count; j++)
+        {
+            if (m_index[j].start > m_index[i].start)
+            {
+                m_index[i].end = m_index[j].start;
+                break;
+            }
+        }
+    }
+
+    m_indexCount = count;
+    return Success;
+}
@@ -36,6 +36,24 @@
  */
 class ELF : public ExecutableFormat
 {
+  private:
+
+    /**
+     * Function symbol in the lookup index.
+     */
+    typedef struct IndexEntry
+    {
+        /** Start address of the function */
+        Address start;
+
+        /** First address after the function */
+        Address end;
+
+        /** Name of the function inside the image */
+        const char *name;
+    }
+    IndexEntry;
+
   public:
 
     /**
@@ -73,6 +91,25 @@ class ELF : public ExecutableFormat
      */
     virtual Result entry(Address *entry) const;
 
+    /**
+     * Lookup the function symbol containing a virtual address.
+     *
+     * Searches the symbol tables of the ELF image for the function
+     * with the highest start address which contains the given address.
+     * Symbols without a size are assumed to extend up to the next symbol.
+     *
+     * The first lookup builds an index of all function symbols sorted
+     * by address, such that further lookups are a binary search.
+     *
+     * @param addr Virtual address to lookup
+     * @param name Outputs a pointer to the symbol name inside the image
+     * @param start Outputs the start address of the symbol
+     *
+     * @return Result code. NotFound if the address is not in any function
+     *         or the image has no symbol table.
+     */
+    Result symbol(const Address addr, const char **name, Address *start) const;
+
     /**
      * Read ELF header from memory.
      *
@@ -83,6 +120,38 @@ class ELF : public ExecutableFormat
      * @return Result code
      */
     static Result detect(const u8 *image, const Size size, ExecutableFormat **fmt);
+
+  private:
+
+    /**
+     * Build the sorted index of function symbols.
+     *
+     * @return Result code
+     */
+    Result buildIndex() const;
+
+    /**
+     * Restore the heap order below an index entry.
+     *
+     * @param entries Index entries
+     * @param root Entry to move down
+     * @param count Number of entries in the heap
+     */
+    static void siftDown(IndexEntry *entries, Size root, const Size count);
+
+  private:
+
+    /** Function symbols sorted by start address, built on first lookup */
+    mutable IndexEntry *m_index;
+
+    /** Number of entries in the index */
+    mutable Size m_indexCount;
+
+    /** Result of building the index */
+    mutable Result m_indexResult;
+
+    /** True once the index is built */
+    mutable bool m_indexed;
 };
 
 /**
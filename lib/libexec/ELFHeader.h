@@ -286,6 +286,24 @@ ELFHeader;
 /** Reserved for processor-specific semantics. */
 #define ELF_SEGMENT_HIPROC      0x7fffffff
 
+/**
+ * @}
+ */
+
+/**
+ * @name Segment flags
+ * @{
+ */
+
+/** Executable segment. */
+#define ELF_SEGMENT_FLAG_EXEC   0x1
+
+/** Writable segment. */
+#define ELF_SEGMENT_FLAG_WRITE  0x2
+
+/** Readable segment. */
+#define ELF_SEGMENT_FLAG_READ   0x4
+
 /**
  * @}
  */
@@ -321,6 +339,110 @@ typedef struct ELFSegment
 }
 ELFSegment;
 
+/**
+ * @name Section types
+ * @{
+ */
+
+/** Inactive section. */
+#define ELF_SECTION_NULL        0
+
+/** Program defined information. */
+#define ELF_SECTION_PROGBITS    1
+
+/** Symbol table. */
+#define ELF_SECTION_SYMTAB      2
+
+/** String table. */
+#define ELF_SECTION_STRTAB      3
+
+/**
+ * @}
+ */
+
+/**
+ * ELF section header in the executable file.
+ */
+typedef struct ELFSection
+{
+    /** Offset of the section name in the section header string table. */
+    u32 name;
+
+    /** Section type. */
+    u32 type;
+
+    /** Section attribute flags. */
+    u32 flags;
+
+    /** Virtual address of the section in memory, if loaded. */
+    u32 virtualAddress;
+
+    /** Offset in the file of this section. */
+    u32 offset;
+
+    /** Size of the section in bytes. */
+    u32 size;
+
+    /** Index of an associated section, e.g. the string table of a symbol table. */
+    u32 link;
+
+    /** Extra type dependent information. */
+    u32 info;
+
+    /** Address alignment constraint. */
+    u32 alignment;
+
+    /** Size of each entry, for sections containing a table. */
+    u32 entrySize;
+}
+ELFSection;
+
+/**
+ * @name Symbol types
+ * @{
+ */
+
+/** Symbol with unspecified type. */
+#define ELF_SYMBOL_NOTYPE       0
+
+/** Data object. */
+#define ELF_SYMBOL_OBJECT       1
+
+/** Function or other executable code. */
+#define ELF_SYMBOL_FUNC         2
+
+/** Extract the symbol type from the info field. */
+#define ELF_SYMBOL_TYPE(info)   ((info) & 0xf)
+
+/**
+ * @}
+ */
+
+/**
+ * ELF symbol table entry.
+ */
+typedef struct ELFSymbol
+{
+    /** Offset of the symbol name in the associated string table. */
+    u32 name;
+
+    /** Value of the symbol, which is the virtual address for executables. */
+    u32 value;
+
+    /** Size of the object or function. */
+    u32 size;
+
+    /** Symbol type and binding attributes. */
+    u8 info;
+
+    /** Symbol visibility. */
+    u8 other;
+
+    /** Index of the section this symbol is defined in. */
+    u16 sectionIndex;
+}
+ELFSymbol;
+
 /**
  * @}
  * @}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ByteOrder.h>
+#include <MemoryBlock.h>
+#include "Lz4Compressor.h"
+
+Lz4Compressor::Lz4Compressor(const void *data, const Size size)
+    : m_inputData(static_cast<const u8 *>(data))
+    , m_inputSize(size)
+{
+}
+
+Size Lz4Compressor::getMaximumSize() const
+{
+    const Size blocks = (m_inputSize + BlockSize - 1) / BlockSize;
+
+    return FrameHeaderSize + m_inputSize + sizeof(u32) +
+           (blocks * (sizeof(u32) + (BlockSize / 255) + 16));
+}
+
+Lz4Compressor::Result Lz4Compressor::compress(void *buffer, Size & size) const
+{
+    u8 *output = static_cast<u8 *>(buffer);
+    Size outputOffset = FrameHeaderSize;
+
+    // The decompressor requires a non-zero content size
+    if (m_inputSize == 0 || size < getMaximumSize())
+    {
+        return InvalidArgument;
+    }
+
+    // Write the frame header
+    writeLe32(output, FrameMagic);
+    output[4] = FrameFlags;
+    output[5] = FrameBlockDescriptor;
+    writeLe64(output + 6, m_inputSize);
+    output[14] = (headerChecksum(output + 4, 10) >> 8) & 0xff;
+
+    // Write all blocks
+    for (Size offset = 0; offset < m_inputSize; offset += BlockSize)
+    {
+        const Size blockSize = m_inputSize - offset < BlockSize ? m_inputSize - offset : BlockSize;
+        u8 *block = output + outputOffset + sizeof(u32);
+        Size compressed = compressBlock(m_inputData + offset, blockSize, block);
+
+        // Store the block as-is if compression does not help
+        if (compressed >= blockSize)
+        {
+            MemoryBlock::copy(block, m_inputData + offset, blockSize);
+            writeLe32(output + outputOffset, blockSize | BlockUncompressed);
+            compressed = blockSize;
+        }
+        else
+        {
+            writeLe32(output + outputOffset, compressed);
+        }
+
+        outputOffset += sizeof(u32) + compressed;
+    }
+
+    // Terminate the frame with the EndMark
+    writeLe32(output + outputOffset, 0);
+    size = outputOffset + sizeof(u32);
+    return Success;
+}
+
+Size Lz4Compressor::compressBlock(const u8 *input, const Size inputSize, u8 *output) const
+{
+    u32 positions[1 << HashBits];
+    Size inputOffset = 0, anchor = 0, outputOffset = 0;
+
+    MemoryBlock::set(positions, 0, sizeof(positions));
+
+    // Find matches, which must leave room for the last literals
+    while (inputSize > MatchStartLimit && inputOffset < inputSize - MatchStartLimit)
+    {
+        const u32 sequence = readLe32(input + inputOffset);
+        const Size hash = (sequence * 2654435761U) >> (32 - HashBits);
+        const Size candidate = positions[hash];
+        positions[hash] = inputOffset + 1;
+
+        // Positions are stored plus one, such that zero means unused
+        if (candidate == 0 || inputOffset - (candidate - 1) > MaximumOffset ||
+            readLe32(input + candidate - 1) != sequence)
+        {
+            inputOffset++;
+            continue;
+        }
+
+        const Size match = candidate - 1;
+        const Size literals = inputOffset - anchor;
+        Size length = MinimumMatch;
+
+        while (inputOffset + length < inputSize - LastLiterals &&
+               input[match + length] == input[inputOffset + length])
+        {
+            length++;
+        }
+
+        // Write the token, literals, offset and match length
+        u8 *token = output + outputOffset++;
+        *token = ((literals < 15 ? literals : 15) << 4) |
+                  (length - MinimumMatch < 15 ? length - MinimumMatch : 15);
+
+        if (literals >= 15)
+        {
+            outputOffset += integerEncode(literals - 15, output + outputOffset);
+        }
+        MemoryBlock::copy(output + outputOffset, input + anchor, literals);
+        outputOffset += literals;
+
+        writeLe16(output + outputOffset, inputOffset - match);
+        outputOffset += sizeof(u16);
+
+        if (length - MinimumMatch >= 15)
+        {
+            outputOffset += integerEncode(length - MinimumMatch - 15, output + outputOffset);
+        }
+
+        inputOffset += length;
+        anchor = inputOffset;
+    }
+
+    // The block ends with a sequence of only literals
+    const Size literals = inputSize - anchor;
+    output[outputOffset++] = (literals < 15 ? literals : 15) << 4;
+
+    if (literals >= 15)
+    {
+        outputOffset += integerEncode(literals - 15, output + outputOffset);
+    }
+    MemoryBlock::copy(output + outputOffset, input + anchor, literals);
+
+    return outputOffset + literals;
+}
+
+Size Lz4Compressor::integerEncode(Size value, u8 *output) const
+{
+    Size count = 0;
+
+    for (; value >= 0xff; value -= 0xff)
+    {
+        output[count++] = 0xff;
+    }
+
+    output[count++] = value;
+    return count;
+}
+
+u32 Lz4Compressor::headerChecksum(const u8 *data, const Size size) const
+{
+    static const u32 prime1 = 2654435761U, prime2 = 2246822519U, prime3 = 3266489917U;
+    static const u32 prime4 = 668265263U, prime5 = 374761393U;
+    u32 hash = prime5 + size;
+    Size i = 0;
+
+    for (; i + sizeof(u32) <= size; i += sizeof(u32))
+    {
+        hash += readLe32(data + i) * prime3;
+        hash = ((hash << 17) | (hash >> 15)) * prime4;
+    }
+
+    for (; i < size; i++)
+    {
+        hash += data[i] * prime5;
+        hash = ((hash << 11) | (hash >> 21)) * prime1;
+    }
+
+    hash ^= hash >> 15;
+    hash *= prime2;
+    hash ^= hash >> 13;
+    hash *= prime3;
+    hash ^= hash >> 16;
+    return hash;
+}
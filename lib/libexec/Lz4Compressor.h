@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBEXEC_LZ4COMPRESSOR_H
+#define __LIB_LIBEXEC_LZ4COMPRESSOR_H
+
+#include <Types.h>
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libexec
+ * @{
+ */
+
+/**
+ * Compress data into a LZ4 frame which can be read by Lz4Decompressor.
+ *
+ * Uses a single pass with a hash table of recent positions, which favors
+ * speed and simplicity over the compression ratio. The frame has
+ * independent blocks of at most 64KiB and includes the content size.
+ *
+ * @see Lz4Decompressor
+ */
+class Lz4Compressor
+{
+  private:
+
+    /** Magic number value marks the start of the frame header */
+    static const u32 FrameMagic = 0x184D2204;
+
+    /** Frame FLG byte: version 01, independent blocks and content size present */
+    static const u8 FrameFlags = 0x68;
+
+    /** Frame BD byte: maximum block size of 64KiB */
+    static const u8 FrameBlockDescriptor = 0x40;
+
+    /** Size of the frame header in bytes, including magic and header checksum */
+    static const Size FrameHeaderSize = 15;
+
+    /** Maximum number of input bytes per block */
+    static const Size BlockSize = 64 * 1024;
+
+    /** Blocks stored without compression have this bit set in their size */
+    static const u32 BlockUncompressed = (1U << 31);
+
+    /** Minimum number of bytes of a match */
+    static const Size MinimumMatch = 4;
+
+    /** The last match must start at least this number of bytes before the end of a block */
+    static const Size MatchStartLimit = 12;
+
+    /** The last bytes of a block are always literals */
+    static const Size LastLiterals = 5;
+
+    /** Maximum distance of a match */
+    static const Size MaximumOffset = 65535;
+
+    /** Number of bits of the position hash table index */
+    static const Size HashBits = 12;
+
+  public:
+
+    /**
+     * Result codes
+     */
+    enum Result
+    {
+        Success,
+        InvalidArgument
+    };
+
+  public:
+
+    /**
+     * Constructor function.
+     *
+     * @param data Input data buffer
+     * @param size Size in bytes of the input buffer
+     */
+    Lz4Compressor(const void *data, const Size size);
+
+    /**
+     * Get the maximum size of the compressed frame.
+     *
+     * @return Size in bytes which is always sufficient for the output of compress()
+     */
+    Size getMaximumSize() const;
+
+    /**
+     * Compress the input data.
+     *
+     * @param buffer Output buffer
+     * @param size On input, size of the output buffer. On output, size of the frame.
+     *
+     * @return Result code
+     */
+    Result compress(void *buffer, Size & size) const;
+
+  private:
+
+    /**
+     * Compress a single block
+     *
+     * @param input Uncompressed block data
+     * @param inputSize Number of uncompressed bytes
+     * @param output Output buffer of at least the size of the input plus overhead
+     *
+     * @return Number of compressed bytes written
+     */
+    Size compressBlock(const u8 *input, const Size inputSize, u8 *output) const;
+
+    /**
+     * Encode the remainder of a length after the token
+     *
+     * @param value Length value minus the part stored in the token
+     * @param output Output buffer
+     *
+     * @return Number of bytes written
+     */
+    Size integerEncode(Size value, u8 *output) const;
+
+    /**
+     * Calculate the xxHash32 checksum of the frame descriptor
+     *
+     * @param data Input bytes
+     * @param size Number of input bytes, which must be less than 16
+     *
+     * @return Checksum value
+     */
+    u32 headerChecksum(const u8 *data, const Size size) const;
+
+  private:
+
+    /** Uncompressed input data */
+    const u8 *m_inputData;
+
+    /** Total size in bytes of the uncompressed input data */
+    const Size m_inputSize;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBEXEC_LZ4COMPRESSOR_H */
@@ -176,6 +176,143 @@ Lz4Decompressor::Result Lz4Decompressor::read(void *buffer,
     return Success;
 }
 
+Size Lz4Decompressor::getBlockCount() const
+{
+    const u8 *input = m_inputData + m_frameDescSize + sizeof(u32);
+    const u8 *inputEnd = m_inputData + m_inputSize;
+    Size count = 0;
+
+    while (input + sizeof(u32) <= inputEnd)
+    {
+        const u32 blockSize = readLe32(input) & ~(1 << 31);
+
+        if (blockSize == EndMark)
+        {
+            break;
+        }
+
+        input += sizeof(u32) + blockSize + (m_blockChecksums ? sizeof(u32) : 0);
+        count++;
+    }
+
+    return count;
+}
+
+Lz4Decompressor::Result Lz4Decompressor::readBlocks(void *buffer,
+                                                    const Size size,
+                                                    const Size firstBlock,
+                                                    const Size blockCount) const
+{
+    const u8 *input = m_inputData + m_frameDescSize + sizeof(u32);
+    const u8 *inputEnd = m_inputData + m_inputSize;
+    u8 *output = static_cast<u8 *>(buffer);
+    const Size totalSize = size < m_contentSize ? size : m_contentSize;
+
+    for (Size i = 0; i < firstBlock + blockCount; i++)
+    {
+        // Fetch the next block
+        if (input + sizeof(u32) > inputEnd)
+        {
+            return InvalidArgument;
+        }
+        const u32 blockSizeByte = readLe32(input);
+        const u32 blockSize = blockSizeByte & ~(1 << 31);
+        const bool isCompressed = blockSizeByte & (1 << 31) ? false : true;
+        const Size outputOffset = i * m_blockMaximumSize;
+
+        if (blockSize == EndMark || blockSize > m_blockMaximumSize ||
+            input + sizeof(u32) + blockSize > inputEnd || outputOffset >= totalSize)
+        {
+            return InvalidArgument;
+        }
+        input += sizeof(u32);
+
+        // Blocks before the first block are only skipped
+        if (i >= firstBlock)
+        {
+            const Size outputSize = totalSize - outputOffset < m_blockMaximumSize ?
+                                    totalSize - outputOffset : m_blockMaximumSize;
+            Size uncompSize;
+
+            if (isCompressed)
+            {
+                uncompSize = decompress(input, blockSize, output + outputOffset, outputSize);
+            }
+            else
+            {
+                uncompSize = blockSize < outputSize ? blockSize : outputSize;
+                MemoryBlock::copy(output + outputOffset, input, uncompSize);
+            }
+
+            // Blocks can only be placed independently if all but the last are full
+            if (uncompSize != outputSize)
+            {
+                ERROR("block " << i << " decompressed to " << uncompSize << " bytes instead of " << outputSize);
+                return IOError;
+            }
+        }
+
+        // Move to the next block
+        input += blockSize;
+        if (m_blockChecksums)
+        {
+            input += sizeof(u32);
+        }
+    }
+
+    return Success;
+}
+
+Size Lz4Decompressor::getBlockMaximumSize() const
+{
+    return m_blockMaximumSize;
+}
+
+Lz4Decompressor::Result Lz4Decompressor::readBlock(Size & position,
+                                                   void *buffer,
+                                                   Size & size) const
+{
+    const u8 *input = m_inputData + m_frameDescSize + sizeof(u32) + position;
+    const u8 *inputEnd = m_inputData + m_inputSize;
+
+    size = 0;
+
+    // Fetch the next block
+    if (input + sizeof(u32) > inputEnd)
+    {
+        return InvalidArgument;
+    }
+    const u32 blockSizeByte = readLe32(input);
+    const u32 blockSize = blockSizeByte & ~(1 << 31);
+    const bool isCompressed = blockSizeByte & (1 << 31) ? false : true;
+
+    // Last block has the EndMark as size value
+    if (blockSize == EndMark)
+    {
+        return Success;
+    }
+
+    if (blockSize > m_blockMaximumSize || input + sizeof(u32) + blockSize > inputEnd)
+    {
+        return InvalidArgument;
+    }
+    input += sizeof(u32);
+
+    if (isCompressed)
+    {
+        size = decompress(input, blockSize, static_cast<u8 *>(buffer), m_blockMaximumSize);
+    }
+    else
+    {
+        MemoryBlock::copy(buffer, input, blockSize);
+        size = blockSize;
+    }
+
+    // Move to the next block
+    position += sizeof(u32) + blockSize + (m_blockChecksums ? sizeof(u32) : 0);
+    return Success;
+}
+
 inline const u32 Lz4Decompressor::integerDecode(const u32 initial,
                                                 const u8 *next,
                                                 Size &byteCount) const
@@ -201,6 +338,40 @@ inline const u32 Lz4Decompressor::integerDecode(const u32 initial,
     return value;
 }
 
+inline void Lz4Decompressor::copyMatch(u8 *output,
+                                       const Size offset,
+                                       const Size count) const
+{
+    const u8 *match = output - offset;
+
+    // Non-overlapping matches are copied at once
+    if (offset >= count)
+    {
+        MemoryBlock::copy(output, match, count);
+    }
+    // Runs of a single byte are filled
+    else if (offset == 1)
+    {
+        MemoryBlock::set(output, *match, count);
+    }
+    // Overlapping matches repeat the pattern of offset bytes. Each copy
+    // doubles the repeated pattern before it, such that the source and
+    // destination of every copy do not overlap.
+    else
+    {
+        Size copied = 0;
+
+        while (copied < count)
+        {
+            const Size chunk = (offset + copied) < (count - copied) ?
+                               (offset + copied) : (count - copied);
+
+            MemoryBlock::copy(output + copied, match, chunk);
+            copied += chunk;
+        }
+    }
+}
+
 const u32 Lz4Decompressor::decompress(const u8 *input,
                                       const Size inputSize,
                                       u8 *output,
@@ -222,7 +393,6 @@ const u32 Lz4Decompressor::decompress(const u8 *input,
         // Read literals count
         const u32 literalsCount = integerDecode(token >> 4, input, literalBytes);
         input += literalBytes;
-        DEBUG("token = " << token << " literalsCount = " << literalsCount << " literalBytes = " << literalBytes);
 
         // Copy literals
         if (literalsCount > 0)
@@ -240,8 +410,7 @@ const u32 Lz4Decompressor::decompress(const u8 *input,
 
         // Read match offset
         const u16 off = readLe16(input);
-        assert(off <= outputOffset);
-        const u32 matchOffset = outputOffset - off;
+        assert(off != 0 && off <= outputOffset);
         input += sizeof(u16);
 
         // Read match length
@@ -249,8 +418,7 @@ const u32 Lz4Decompressor::decompress(const u8 *input,
         input += matchBytes;
 
         // Copy the match from previous decoded bytes
-        DEBUG("matchOffset = " << matchOffset << " matchCount = " << matchCount);
-        MemoryBlock::copy(output + outputOffset, output + matchOffset, matchCount);
+        copyMatch(output + outputOffset, off, matchCount);
         outputOffset += matchCount;
     }
 
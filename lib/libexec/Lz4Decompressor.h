@@ -109,6 +109,58 @@ class Lz4Decompressor
      */
     Result read(void *buffer, const Size size) const;
 
+    /**
+     * Get the number of blocks in the frame.
+     *
+     * @return Number of data blocks
+     */
+    Size getBlockCount() const;
+
+    /**
+     * Decompress a range of blocks.
+     *
+     * Blocks are independent and every block except the last contains
+     * the maximum block size of uncompressed data. Therefore disjoint
+     * ranges of blocks can be decompressed concurrently into the same buffer.
+     *
+     * @param buffer Output buffer for the complete uncompressed content.
+     * @param size Size of the output buffer in bytes.
+     * @param firstBlock Index of the first block to decompress.
+     * @param blockCount Number of blocks to decompress.
+     *
+     * @return Result code
+     */
+    Result readBlocks(void *buffer,
+                      const Size size,
+                      const Size firstBlock,
+                      const Size blockCount) const;
+
+    /**
+     * Get the maximum size of a block.
+     *
+     * @return Maximum number of bytes of uncompressed data in a block
+     */
+    Size getBlockMaximumSize() const;
+
+    /**
+     * Decompress the next block.
+     *
+     * Allows streaming the frame one block at a time, such that the
+     * output only needs a buffer of the maximum block size.
+     *
+     * @param position Offset of the block relative to the first block.
+     *                 Zero for the first block. On output contains
+     *                 the offset of the next block.
+     * @param buffer Output buffer of at least getBlockMaximumSize() bytes.
+     * @param size On output contains the number of bytes decompressed,
+     *             which is zero at the end of the frame.
+     *
+     * @return Result code
+     */
+    Result readBlock(Size & position,
+                     void *buffer,
+                     Size & size) const;
+
   private:
 
     /**
@@ -126,6 +178,17 @@ class Lz4Decompressor
                          u8 *output,
                          const Size outputSize) const;
 
+    /**
+     * Copy a match from previously decoded bytes
+     *
+     * @param output Output position to copy the match to
+     * @param offset Distance in bytes back to the start of the match
+     * @param count Number of bytes to copy
+     */
+    inline void copyMatch(u8 *output,
+                          const Size offset,
+                          const Size count) const;
+
     /**
      * Decode input data as integer (little-endian, 32-bit unsigned)
      *
@@ -114,9 +114,10 @@ void DeviceServer::interruptHandler(Size vector)
         for (ListIterator<Device *> i(lst); i.hasCurrent(); i++)
         {
             i.current()->interrupt(vector);
+            i.current()->notifyReady();
         }
     }
 
-    // Keep retrying any pending requests, if any
+    // Retry the pending requests of the interrupted Devices, if any
     retryAllRequests();
 }
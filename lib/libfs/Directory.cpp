@@ -39,7 +39,8 @@ FileSystem::Result Directory::read(IOBuffer & buffer,
                                    Size & size,
                                    const Size offset)
 {
-    Size bytes = 0;
+    IOBuffer::Segment segments[IOBuffer::MaximumSegments];
+    Size bytes = 0, count = 0;
 
     // Loop our list of Dirents
     for (ListIterator<Dirent *> i(&entries); i.hasCurrent(); i++)
@@ -47,14 +48,44 @@ FileSystem::Result Directory::read(IOBuffer & buffer,
         // Can we read another entry?
         if (bytes + sizeof(Dirent) <= size)
         {
-            buffer.write(i.current(), sizeof(Dirent), bytes);
+            segments[count].buffer = (Address) i.current();
+            segments[count].size   = sizeof(Dirent);
+            segments[count].offset = bytes;
             bytes += sizeof(Dirent);
+
+            // Write the collected entries at once
+            if (++count == IOBuffer::MaximumSegments)
+            {
+                const FileSystem::Result result = buffer.writeVector(segments, count);
+                if (result != FileSystem::Success)
+                    return result;
+                count = 0;
+            }
         }
         else break;
     }
 
     // Report results
     size = bytes;
+    return count ? buffer.writeVector(segments, count) : FileSystem::Success;
+}
+
+FileSystem::Result Directory::getEntries(Dirent *output,
+                                         Size & count,
+                                         const Size index)
+{
+    Size current = 0, num = 0;
+
+    // Loop our list of Dirents
+    for (ListIterator<Dirent *> i(&entries); i.hasCurrent() && num < count; i++)
+    {
+        if (current++ >= index)
+        {
+            output[num++] = *i.current();
+        }
+    }
+
+    count = num;
     return FileSystem::Success;
 }
 
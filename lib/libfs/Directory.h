@@ -96,6 +96,25 @@ class Directory : public File
                                     Size & size,
                                     const Size offset);
 
+    /**
+     * Retrieve directory entries.
+     *
+     * Copies the entries into local memory, such that the FileSystemServer
+     * can pack them for ReadDirectory requests. The default implementation
+     * returns the private List of Dirent entries. Filesystems which implement
+     * their own read() should implement their version of getEntries().
+     *
+     * @param output Output array of Dirent entries.
+     * @param count Maximum number of entries on input.
+     *              On output, the actual number of entries retrieved.
+     * @param index Index of the first entry to retrieve.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result getEntries(Dirent *output,
+                                          Size & count,
+                                          const Size index);
+
     /**
      * Retrieve a File from storage.
      *
@@ -28,6 +28,7 @@ File::File(const u32 inode,
     , m_gid(gid)
     , m_access(FileSystem::OwnerRWX)
     , m_size(0)
+    , m_readyCallback(ZERO)
 {
 }
 
@@ -80,3 +81,16 @@ bool File::canWrite() const
 {
     return true;
 }
+
+void File::setReadyCallback(CallbackFunction *callback)
+{
+    m_readyCallback = callback;
+}
+
+void File::notifyReady()
+{
+    if (m_readyCallback != ZERO)
+    {
+        m_readyCallback->execute(this);
+    }
+}
@@ -19,6 +19,7 @@
 #define __LIB_LIBFS_FILE_H
 
 #include <Types.h>
+#include <Callback.h>
 #include "FileSystemMessage.h"
 #include "FileSystem.h"
 #include "IOBuffer.h"
@@ -127,6 +128,22 @@ class File
      */
     virtual bool canWrite() const;
 
+    /**
+     * Set the callback for readiness notifications.
+     *
+     * @param callback Executed with this File as parameter by notifyReady()
+     */
+    void setReadyCallback(CallbackFunction *callback);
+
+    /**
+     * Signal that the File may have become readable or writable.
+     *
+     * Must be called when a read or write which previously returned
+     * RetryAgain may now complete, such that only the requests waiting
+     * for this File are retried.
+     */
+    void notifyReady();
+
   protected:
 
     /** Inode number */
@@ -146,6 +163,9 @@ class File
 
     /** Size of the file, in bytes. */
     Size m_size;
+
+    /** Callback for readiness notifications, if any. */
+    CallbackFunction *m_readyCallback;
 };
 
 /**
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include <String.h>
+#include "FileAttributeCache.h"
+#include "FileSystemPathTokenizer.h"
+
+FileAttributeCache::FileAttributeCache()
+    : m_lease(1)
+{
+    clear();
+}
+
+void FileAttributeCache::setLease(const u32 ticks)
+{
+    m_lease = ticks;
+}
+
+bool FileAttributeCache::lookup(const char *path, const u32 now, FileSystem::FileStat &st)
+{
+    const u32 pathHash = FileSystemPathTokenizer::hash(path, String::length(path));
+    Entry *entry = find(path, pathHash);
+
+    if (entry == ZERO)
+    {
+        return false;
+    }
+
+    // Drop the entry when its lease expired
+    if (now - entry->ticks >= m_lease)
+    {
+        entry->used = false;
+        return false;
+    }
+
+    st = entry->stat;
+    return true;
+}
+
+void FileAttributeCache::insert(const char *path,
+                                const FileSystem::FileStat &st,
+                                const u32 generation,
+                                const u32 now)
+{
+    const Size length = String::length(path);
+
+    if (length >= FileSystemPath::MaximumLength)
+    {
+        return;
+    }
+
+    const u32 pathHash = FileSystemPathTokenizer::hash(path, length);
+    Entry *entry = find(path, pathHash);
+
+    // Use a free entry or replace the oldest
+    for (Size i = 0; i < MaximumEntries && entry == ZERO; i++)
+    {
+        if (!m_entries[i].used)
+        {
+            entry = &m_entries[i];
+        }
+    }
+
+    if (entry == ZERO)
+    {
+        entry = &m_entries[0];
+
+        for (Size i = 1; i < MaximumEntries; i++)
+        {
+            if (now - m_entries[i].ticks > now - entry->ticks)
+            {
+                entry = &m_entries[i];
+            }
+        }
+    }
+
+    entry->used       = true;
+    entry->pid        = st.pid;
+    entry->generation = generation;
+    entry->ticks      = now;
+    entry->pathHash   = pathHash;
+    entry->stat       = st;
+    MemoryBlock::copy(entry->path, path, length + 1);
+}
+
+void FileAttributeCache::update(const ProcessID pid, const u32 generation)
+{
+    for (Size i = 0; i < MaximumEntries; i++)
+    {
+        if (m_entries[i].used && m_entries[i].pid == pid &&
+            m_entries[i].generation != generation)
+        {
+            m_entries[i].used = false;
+        }
+    }
+}
+
+void FileAttributeCache::invalidate(const char *path)
+{
+    Entry *entry = find(path, FileSystemPathTokenizer::hash(path, String::length(path)));
+
+    if (entry != ZERO)
+    {
+        entry->used = false;
+    }
+}
+
+void FileAttributeCache::clear()
+{
+    MemoryBlock::set(m_entries, 0, sizeof(m_entries));
+}
+
+Size FileAttributeCache::count() const
+{
+    Size num = 0;
+
+    for (Size i = 0; i < MaximumEntries; i++)
+    {
+        if (m_entries[i].used)
+        {
+            num++;
+        }
+    }
+
+    return num;
+}
+
+FileAttributeCache::Entry * FileAttributeCache::find(const char *path, const u32 pathHash)
+{
+    for (Size i = 0; i < MaximumEntries; i++)
+    {
+        if (m_entries[i].used && m_entries[i].pathHash == pathHash &&
+            MemoryBlock::compare(m_entries[i].path, path))
+        {
+            return &m_entries[i];
+        }
+    }
+
+    return ZERO;
+}
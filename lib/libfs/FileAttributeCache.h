@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBFS_FILEATTRIBUTECACHE_H
+#define __LIB_LIBFS_FILEATTRIBUTECACHE_H
+
+#include <FreeNOS/API/ProcessID.h>
+#include <Types.h>
+#include "FileSystem.h"
+#include "FileSystemPath.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libfs
+ * @{
+ */
+
+/**
+ * Remembers file status results of recent statFile requests.
+ *
+ * Each entry is valid for a short lease after it was retrieved. Entries
+ * are also dropped as soon as the file system reports a new change
+ * generation in any of its responses, which happens after a file is
+ * created, deleted or written.
+ */
+class FileAttributeCache
+{
+  public:
+
+    /** Maximum number of file status entries remembered */
+    static const Size MaximumEntries = 16;
+
+  private:
+
+    /**
+     * Cached file status
+     */
+    typedef struct Entry
+    {
+        /** True if the entry is in use */
+        bool used;
+
+        /** File system which returned the status */
+        ProcessID pid;
+
+        /** Change generation of the file system when retrieved */
+        u32 generation;
+
+        /** Timer ticks when retrieved */
+        u32 ticks;
+
+        /** Hash of the full path */
+        u32 pathHash;
+
+        /** Full path of the file, null-terminated */
+        char path[FileSystemPath::MaximumLength];
+
+        /** File status */
+        FileSystem::FileStat stat;
+    }
+    Entry;
+
+  public:
+
+    /**
+     * Constructor
+     */
+    FileAttributeCache();
+
+    /**
+     * Set the lease of new and existing entries.
+     *
+     * @param ticks Number of timer ticks an entry remains valid
+     */
+    void setLease(const u32 ticks);
+
+    /**
+     * Find the status of a file.
+     *
+     * @param path Full path of the file
+     * @param now Current timer ticks
+     * @param st Outputs the file status if found
+     *
+     * @return True if a valid entry is found
+     */
+    bool lookup(const char *path, const u32 now, FileSystem::FileStat &st);
+
+    /**
+     * Remember the status of a file.
+     *
+     * @param path Full path of the file
+     * @param st File status
+     * @param generation Change generation of the file system in the response
+     * @param now Current timer ticks
+     */
+    void insert(const char *path,
+                const FileSystem::FileStat &st,
+                const u32 generation,
+                const u32 now);
+
+    /**
+     * Drop entries of a file system which changed.
+     *
+     * @param pid File system which sent a response
+     * @param generation Change generation in the response
+     */
+    void update(const ProcessID pid, const u32 generation);
+
+    /**
+     * Drop the entry of a file.
+     *
+     * @param path Full path of the file
+     */
+    void invalidate(const char *path);
+
+    /**
+     * Drop all entries.
+     */
+    void clear();
+
+    /**
+     * Get number of entries in use.
+     *
+     * @return Number of entries
+     */
+    Size count() const;
+
+  private:
+
+    /**
+     * Find the entry of a file.
+     *
+     * @param path Full path of the file
+     * @param pathHash Hash of the path
+     *
+     * @return Entry pointer or ZERO if not found
+     */
+    Entry * find(const char *path, const u32 pathHash);
+
+  private:
+
+    /** All entries */
+    Entry m_entries[MaximumEntries];
+
+    /** Number of timer ticks an entry remains valid */
+    u32 m_lease;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBFS_FILEATTRIBUTECACHE_H */
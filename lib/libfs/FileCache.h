@@ -19,6 +19,7 @@
 #define __LIB_LIBFS_FILECACHE_H
 
 #include <HashTable.h>
+#include <StringView.h>
 #include "File.h"
 
 /**
@@ -41,11 +42,9 @@ typedef struct FileCache
      * @param n Entry name of the File in the parent, if any.
      * @param p Our parent. ZERO if we have no parent.
      */
-    FileCache(File *f, const char *n, FileCache *p)
-            : file(f), parent(p)
+    FileCache(File *f, const StringView & n, FileCache *p)
+            : file(f), name(n), parent(p), nameHash(0), hashNext(ZERO)
     {
-        name = n;
-
         if (p && p != this)
         {
             p->entries.insert(name, this);
@@ -63,6 +62,12 @@ typedef struct FileCache
 
     /** Parent */
     FileCache *parent;
+
+    /** Hash of the name, as used by the dentry hash of the FileSystemServer */
+    u32 nameHash;
+
+    /** Next entry in the same bucket of the dentry hash */
+    FileCache *hashNext;
 }
 FileCache;
 
@@ -15,44 +15,92 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <MemoryBlock.h>
+#include <BitOperations.h>
 #include "FileDescriptor.h"
 
 FileDescriptor::FileDescriptor()
     : m_array(ZERO)
+    , m_count(0)
+    , m_used(0)
+    , m_full(0)
 {
+    MemoryBlock::set(m_map, 0, sizeof(m_map));
 }
 
 FileDescriptor::Entry * FileDescriptor::getArray(Size & count)
 {
-    count = m_count;
+    count = m_used;
     return m_array;
 }
 
 void FileDescriptor::setArray(Entry *array,
-                              const Size count)
+                              const Size count,
+                              const Size used)
 {
     m_array = array;
-    m_count = count;
+    m_count = count < MaximumFiles ? count : MaximumFiles;
+    m_used = 0;
+    m_full = 0;
+    MemoryBlock::set(m_map, 0, sizeof(m_map));
+
+    // Only the entries which may be open are read
+    for (Size i = 0; i < used && i < m_count; i++)
+    {
+        if (m_array[i].open)
+        {
+            setUsed(i);
+        }
+    }
+}
+
+FileDescriptor::Result FileDescriptor::findFree(Size & index) const
+{
+    if (m_full == ~0U)
+    {
+        return FileDescriptor::OutOfFiles;
+    }
+
+    // The lowest word with an unused entry, then the lowest unused entry in it
+    const Size word = countTrailingZeros(~m_full);
+    index = (word * EntriesPerWord) + countTrailingZeros(~m_map[word]);
+
+    return index < m_count ? FileDescriptor::Success : FileDescriptor::OutOfFiles;
 }
 
 FileDescriptor::Result FileDescriptor::openEntry(const u32 inode,
                                                  const ProcessID filesystem,
                                                  Size & index)
 {
-    // Insert into file descriptor table
-    for (index = 0; index < m_count; index++)
+    const Result result = findFree(index);
+
+    if (result == FileDescriptor::Success)
     {
-        if (!m_array[index].open)
-        {
-            m_array[index].open  = true;
-            m_array[index].position = 0;
-            m_array[index].inode = inode;
-            m_array[index].pid = filesystem;
-            return FileDescriptor::Success;
-        }
+        m_array[index].open  = true;
+        m_array[index].position = 0;
+        m_array[index].inode = inode;
+        m_array[index].pid = filesystem;
+        m_array[index].pipe = ZERO;
+        m_array[index].writer = false;
+        setUsed(index);
+    }
+
+    return result;
+}
+
+FileDescriptor::Result FileDescriptor::openPipe(const Address pipe,
+                                                const bool writer,
+                                                Size & index)
+{
+    const Result result = openEntry(0, 0, index);
+
+    if (result == FileDescriptor::Success)
+    {
+        m_array[index].pipe = pipe;
+        m_array[index].writer = writer;
     }
 
-    return FileDescriptor::OutOfFiles;
+    return result;
 }
 
 FileDescriptor::Entry * FileDescriptor::getEntry(const Size index)
@@ -65,6 +113,19 @@ FileDescriptor::Entry * FileDescriptor::getEntry(const Size index)
     return &m_array[index];
 }
 
+FileDescriptor::Result FileDescriptor::copyEntry(const Size index,
+                                                 const Size target)
+{
+    if (index >= m_count || target >= m_count || !m_array[index].open)
+    {
+        return FileDescriptor::InvalidArgument;
+    }
+
+    m_array[target] = m_array[index];
+    setUsed(target);
+    return FileDescriptor::Success;
+}
+
 FileDescriptor::Result FileDescriptor::closeEntry(const Size index)
 {
     if (index >= m_count)
@@ -73,5 +134,40 @@ FileDescriptor::Result FileDescriptor::closeEntry(const Size index)
     }
 
     m_array[index].open = false;
+    setUnused(index);
     return FileDescriptor::Success;
 }
+
+void FileDescriptor::setUsed(const Size index)
+{
+    const Size word = index / EntriesPerWord;
+
+    m_map[word] |= 1U << (index % EntriesPerWord);
+
+    if (m_map[word] == ~0U)
+    {
+        m_full |= 1U << word;
+    }
+
+    if (index >= m_used)
+    {
+        m_used = index + 1;
+    }
+}
+
+void FileDescriptor::setUnused(const Size index)
+{
+    Size word = index / EntriesPerWord;
+
+    m_map[word] &= ~(1U << (index % EntriesPerWord));
+    m_full &= ~(1U << word);
+
+    // Lower the highest open entry to the last word with open entries
+    if (index + 1 == m_used)
+    {
+        while (word > 0 && m_map[word] == 0)
+            word--;
+
+        m_used = m_map[word] ? ((word + 1) * EntriesPerWord) - countLeadingZeros(m_map[word]) : 0;
+    }
+}
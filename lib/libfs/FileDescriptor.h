@@ -32,6 +32,11 @@
 
 /**
  * Abstracts files which are opened by a user process.
+ *
+ * A bitmap of open entries finds the lowest unused descriptor, as POSIX
+ * requires, with a count trailing zeros per 32 entries. Entries above the
+ * highest open descriptor are not read, such that the memory of the table
+ * can be backed on demand as it grows.
  */
 class FileDescriptor : public StrictSingleton<FileDescriptor>
 {
@@ -49,6 +54,8 @@ class FileDescriptor : public StrictSingleton<FileDescriptor>
         ProcessID pid; /**@< Process identifier of the filesystem */
         Size position; /**@< Current position indicator. */
         bool open;     /**@< State of the file descriptor. */
+        Address pipe;  /**@< Pipe buffer or ZERO if not a pipe. */
+        bool writer;   /**@< True for the write end of a pipe. */
     };
 
     /**
@@ -61,6 +68,14 @@ class FileDescriptor : public StrictSingleton<FileDescriptor>
         OutOfFiles
     };
 
+  private:
+
+    /** Number of entries per word in the bitmap */
+    static const Size EntriesPerWord = sizeof(u32) * 8;
+
+    static_assert(MaximumFiles <= EntriesPerWord * EntriesPerWord,
+                  "each word of the bitmap must have a bit in the summary word");
+
   public:
 
     /**
@@ -71,7 +86,7 @@ class FileDescriptor : public StrictSingleton<FileDescriptor>
     /**
      * Get entry table
      *
-     * @param count Maximum number of entries
+     * @param count Number of entries up to and including the highest open entry
      *
      * @return Entry table pointer
      */
@@ -82,9 +97,21 @@ class FileDescriptor : public StrictSingleton<FileDescriptor>
      *
      * @param array Pointer to array with file descriptor entries
      * @param count Number of Entry structures in the array
+     * @param used Number of entries at the start of the array which may be open.
+     *             Other entries must be zero. By default all entries are read.
      */
     void setArray(Entry *array,
-                  const Size count);
+                  const Size count,
+                  const Size used = MaximumFiles);
+
+    /**
+     * Find the lowest unused entry
+     *
+     * @param index On output contains the index number of the entry
+     *
+     * @return Result code
+     */
+    Result findFree(Size & index) const;
 
     /**
      * Add new file descriptor entry
@@ -99,6 +126,19 @@ class FileDescriptor : public StrictSingleton<FileDescriptor>
                      const ProcessID filesystem,
                      Size & index);
 
+    /**
+     * Add new pipe end entry
+     *
+     * @param pipe Address of the pipe buffer
+     * @param writer True for the write end, false for the read end
+     * @param index On output contains the index number for the entry
+     *
+     * @return Result code
+     */
+    Result openPipe(const Address pipe,
+                    const bool writer,
+                    Size & index);
+
     /**
      * Retrieve a file descriptor Entry
      *
@@ -108,6 +148,17 @@ class FileDescriptor : public StrictSingleton<FileDescriptor>
      */
     Entry * getEntry(const Size index);
 
+    /**
+     * Copy an open entry to another entry
+     *
+     * @param index Index of the open entry to copy
+     * @param target Index of the entry to overwrite
+     *
+     * @return Result code
+     */
+    Result copyEntry(const Size index,
+                     const Size target);
+
     /**
      * Remove file descriptor entry
      *
@@ -117,6 +168,22 @@ class FileDescriptor : public StrictSingleton<FileDescriptor>
      */
     Result closeEntry(const Size index);
 
+  private:
+
+    /**
+     * Mark an entry as open in the bitmap
+     *
+     * @param index Index in the array of entries
+     */
+    void setUsed(const Size index);
+
+    /**
+     * Mark an entry as unused in the bitmap
+     *
+     * @param index Index in the array of entries
+     */
+    void setUnused(const Size index);
+
   private:
 
     /** Pointer to array of entries */
@@ -124,6 +191,15 @@ class FileDescriptor : public StrictSingleton<FileDescriptor>
 
     /** Number of entries in the array */
     Size m_count;
+
+    /** One more than the index of the highest open entry */
+    Size m_used;
+
+    /** Bitmap of open entries */
+    u32 m_map[MaximumFiles / EntriesPerWord];
+
+    /** Bitmap of words in m_map without unused entries */
+    u32 m_full;
 };
 
 /**
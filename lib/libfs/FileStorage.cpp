@@ -15,6 +15,10 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <Assert.h>
+#include <Log.h>
+#include <ListIterator.h>
+#include <ChannelClient.h>
 #include "FileDescriptor.h"
 #include "FileStorage.h"
 
@@ -22,6 +26,7 @@ FileStorage::FileStorage(const char *path, const Size offset)
     : m_path(path)
     , m_fd(0)
     , m_offset(offset)
+    , m_callback(this, &FileStorage::responseReceived)
 {
 }
 
@@ -40,6 +45,8 @@ FileSystem::Result FileStorage::read(const u64 offset, void *buffer, const Size
 {
     Size sz = size;
 
+    assert(m_pending.count() == 0);
+
     FileDescriptor::Entry *fd = FileDescriptor::instance()->getEntry(m_fd);
     if (!fd || !fd->open)
     {
@@ -56,6 +63,8 @@ FileSystem::Result FileStorage::write(const u64 offset, void *buffer, const Size
 {
     Size sz = size;
 
+    assert(m_pending.count() == 0);
+
     FileDescriptor::Entry *fd = FileDescriptor::instance()->getEntry(m_fd);
     if (!fd || !fd->open)
     {
@@ -72,3 +81,88 @@ u64 FileStorage::capacity() const
 {
     return m_stat.size;
 }
+
+FileSystem::Result FileStorage::submit(Request *req)
+{
+    FileDescriptor::Entry *fd = FileDescriptor::instance()->getEntry(m_fd);
+    if (!fd || !fd->open)
+    {
+        return FileSystem::IOError;
+    }
+
+    FileSystemMessage msg;
+    msg.type   = ChannelMessage::Request;
+    msg.action = req->operation == Read ? FileSystem::ReadFile : FileSystem::WriteFile;
+    msg.inode  = fd->inode;
+    msg.buffer = (char *) req->buffer;
+    msg.size   = req->size;
+    msg.offset = m_offset + req->offset;
+
+    const ChannelClient::Result result =
+        ChannelClient::instance()->sendRequest(fd->pid, &msg, sizeof(msg), &m_callback);
+    if (result != ChannelClient::Success)
+    {
+        ERROR("failed to send request to PID " << fd->pid << ": result = " << (int) result);
+        return FileSystem::IpcError;
+    }
+
+    m_pending.append(req);
+    return FileSystem::Success;
+}
+
+FileSystem::Result FileStorage::wait()
+{
+    FileDescriptor::Entry *fd = FileDescriptor::instance()->getEntry(m_fd);
+    if (!fd || !fd->open)
+    {
+        return FileSystem::IOError;
+    }
+
+    // Responses arrive on the same channel as those of synchronous requests
+    while (m_pending.count() > 0)
+    {
+        FileSystemMessage msg;
+
+        const ChannelClient::Result result =
+            ChannelClient::instance()->syncReceiveFrom(&msg, sizeof(msg), fd->pid);
+        if (result != ChannelClient::Success)
+        {
+            ERROR("failed to receive from PID " << fd->pid << ": result = " << (int) result);
+            return FileSystem::IpcError;
+        }
+
+        if (msg.type != ChannelMessage::Response ||
+            ChannelClient::instance()->processResponse(fd->pid, &msg) != ChannelClient::Success)
+        {
+            ERROR("unexpected message from PID " << fd->pid << " with identifier " << msg.identifier);
+        }
+    }
+
+    return FileSystem::Success;
+}
+
+void FileStorage::responseReceived(FileSystemMessage *msg)
+{
+    for (ListIterator<Request *> i(m_pending); i.hasCurrent(); i++)
+    {
+        Request *req = i.current();
+
+        if ((char *) req->buffer == msg->buffer && m_offset + req->offset == msg->offset)
+        {
+            i.remove();
+
+            req->result = msg->result;
+            if (req->result == FileSystem::Success && msg->size != req->size)
+            {
+                ERROR("short transfer at offset " << msg->offset << ": " <<
+                      msg->size << " of " << req->size << " bytes");
+                req->result = FileSystem::IOError;
+            }
+
+            complete(req);
+            return;
+        }
+    }
+
+    ERROR("no request for response at offset " << msg->offset);
+}
@@ -19,7 +19,10 @@
 #define __FILESYSTEM_FILESTORAGE_H
 
 #include <Types.h>
+#include <Callback.h>
+#include <List.h>
 #include "FileSystemClient.h"
+#include "FileSystemMessage.h"
 #include "Storage.h"
 
 /**
@@ -57,6 +60,8 @@ class FileStorage : public Storage
     /**
      * Read a contiguous set of data.
      *
+     * Must not be used while submitted requests are pending.
+     *
      * @param offset Offset to start reading from.
      * @param buffer Output buffer.
      * @param size Number of bytes to copied.
@@ -68,6 +73,8 @@ class FileStorage : public Storage
     /**
      * Write a contiguous set of data.
      *
+     * Must not be used while submitted requests are pending.
+     *
      * @param offset Offset to start writing to.
      * @param buffer Input buffer.
      * @param size Number of bytes to written.
@@ -83,6 +90,35 @@ class FileStorage : public Storage
      */
     virtual u64 capacity() const;
 
+    /**
+     * Submit an asynchronous request.
+     *
+     * Sends the request to the file system of the file without
+     * waiting for the response, which is received by the ChannelServer
+     * of the calling process or by wait().
+     *
+     * @param req Request to transfer
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result submit(Request *req);
+
+    /**
+     * Wait until all submitted requests are completed.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result wait();
+
+  private:
+
+    /**
+     * Called when a response to a submitted request is received.
+     *
+     * @param msg Response message
+     */
+    void responseReceived(FileSystemMessage *msg);
+
   private:
 
     /** Path to the file */
@@ -99,6 +135,12 @@ class FileStorage : public Storage
 
     /** Offset used as a base for I/O. */
     Size m_offset;
+
+    /** Submitted requests waiting for a response */
+    List<Request *> m_pending;
+
+    /** Executes responseReceived() */
+    Callback<FileStorage, FileSystemMessage> m_callback;
 };
 
 /**
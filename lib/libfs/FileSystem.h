@@ -43,9 +43,36 @@ namespace FileSystem
         WaitFile,
         MountFileSystem,
         WaitFileSystem,
-        GetFileSystems
+        GetFileSystems,
+        ReadFileBulk,
+        WriteFileBulk,
+        ReadDirectory,
+        ReadDirectoryPlus,
+        MapFile,
+        SpliceFile
     };
 
+    /** Memory share tag identifier of the bulk transfer buffer */
+    const Size BulkShareTag = 1;
+
+    /** Memory share tag identifier of the first file mapping, followed by one tag per mapping */
+    const Size MapShareTag = 3;
+
+    /** Maximum number of files mapped by a process at the same time */
+    const Size MaximumFileMappings = 8;
+
+    /** Size in bytes of the bulk transfer buffer shared with a file system */
+    const Size BulkTransferSize = 64 * 1024;
+
+    /** Minimum number of bytes to use bulk transfers for ReadFile and WriteFile */
+    const Size BulkTransferThreshold = 4096;
+
+    /** Maximum number of bytes written before each chunk by SpliceFile */
+    const Size SpliceHeaderSize = 64;
+
+    /** Maximum number of bytes returned by ReadDirectory and ReadDirectoryPlus */
+    const Size DirectoryBufferSize = 4096;
+
     /**
      * Result code for filesystem Actions.
      */
@@ -131,6 +158,57 @@ namespace FileSystem
         u16 current;   /**@< Indicates the currently active status flags */
     };
 
+    /**
+     * Describes a file descriptor to wait for
+     */
+    struct WaitDescriptor
+    {
+        int fd;        /**@< File descriptor number */
+        u16 requested; /**@< Requested status flags of the file */
+        u16 current;   /**@< Indicates the currently active status flags */
+    };
+
+    /**
+     * Describes the target file of a SpliceFile request.
+     *
+     * The file system writes each chunk of the source file to the target
+     * file with a separate write, preceded by the header bytes. This
+     * allows splicing into datagram sockets, which take the destination
+     * address as a header on every write.
+     */
+    struct SpliceInfo
+    {
+        ProcessID pid;                  /**@< Process identifier of the target file system */
+        u32 inode;                      /**@< Inode number of the target file */
+        Size offset;                    /**@< Offset in the target file to start writing */
+        Size chunkSize;                 /**@< Maximum number of bytes per write, or zero for no limit */
+        Size headerSize;                /**@< Number of header bytes */
+        u8 header[SpliceHeaderSize];    /**@< Header written before each chunk */
+    };
+
+    /**
+     * Packed directory entry returned by ReadDirectory and ReadDirectoryPlus.
+     *
+     * The record is followed by a FileStat if the RecordStat flag is set,
+     * and then by the null-terminated name. The length includes padding
+     * such that the next record is aligned.
+     */
+    struct DirectoryRecord
+    {
+        u16 length;     /**@< Length of the record in bytes */
+        u16 nameLength; /**@< Length of the name, excluding the null terminator */
+        u16 type;       /**@< File type, as a FileType */
+        u16 flags;      /**@< Indicates which optional fields are present */
+    };
+
+    /**
+     * DirectoryRecord flags
+     */
+    enum DirectoryRecordFlags
+    {
+        RecordStat = (1 << 0) /**@< The record contains the FileStat of the entry */
+    };
+
     /**
      * WaitSet status flags
      */
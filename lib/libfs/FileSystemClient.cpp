@@ -15,15 +15,30 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <FreeNOS/User.h>
 #include <Log.h>
 #include <ChannelClient.h>
 #include <KernelTimer.h>
 #include "FileSystemMessage.h"
 #include "FileDescriptor.h"
 #include "FileSystemClient.h"
+#include "Pipe.h"
+#include "Directory.h"
 
 FileSystemMount FileSystemClient::m_mounts[MaximumFileSystemMounts] = {};
 
+FileSystemClient::BulkBuffer FileSystemClient::m_bulkBuffers[MaximumFileSystemMounts] = {};
+
+FileSystemClient::FileMapping FileSystemClient::m_mappings[FileSystem::MaximumFileMappings] = {};
+
+FileSystemMountTree FileSystemClient::m_mountTree;
+
+FileSystemMountTree::Cursor FileSystemClient::m_currentDirectoryCursor;
+
+bool FileSystemClient::m_currentDirectoryResolved = false;
+
+FileAttributeCache FileSystemClient::m_attributes;
+
 String * FileSystemClient::m_currentDirectory = (String *) NULL;
 
 FileSystemClient::FileSystemClient(const ProcessID pid)
@@ -37,19 +52,7 @@ inline FileSystem::Result FileSystemClient::request(const char *path,
     const ProcessID mnt = m_pid == ANY ? findMount(path) : m_pid;
     char fullpath[FileSystemPath::MaximumLength];
 
-    // Use the current directory as prefix for relative paths
-    if (path[0] != '/' && m_currentDirectory != NULL)
-    {
-        const Size copied = MemoryBlock::copy(fullpath, **m_currentDirectory, sizeof(fullpath));
-
-        if (copied < sizeof(fullpath))
-            MemoryBlock::copy(fullpath + copied, path, sizeof(fullpath) - copied);
-    }
-    else
-    {
-        MemoryBlock::copy(fullpath, path, sizeof(fullpath));
-    }
-
+    getFullPath(path, fullpath);
     msg.buffer = fullpath;
 
     return request(mnt, msg);
@@ -62,11 +65,12 @@ inline FileSystem::Result FileSystemClient::request(const ProcessID pid,
     if (r != ChannelClient::Success)
     {
         ERROR("failed to send request to PID " << pid <<
-              " for path " << msg.buffer << ": result = " << (int) r);
+              " for action " << (int) msg.action << ": result = " << (int) r);
         return FileSystem::IpcError;
     }
     else if (msg.result != FileSystem::RedirectRequest)
     {
+        m_attributes.update(pid, msg.generation);
         return msg.result;
     }
 
@@ -75,6 +79,10 @@ inline FileSystem::Result FileSystemClient::request(const ProcessID pid,
     assert(msg.pid != ROOTFS_PID);
     assert(msg.action != FileSystem::ReadFile);
     assert(msg.action != FileSystem::WriteFile);
+    assert(msg.action != FileSystem::ReadFileBulk);
+    assert(msg.action != FileSystem::WriteFileBulk);
+    assert(msg.action != FileSystem::MapFile);
+    assert(msg.action != FileSystem::SpliceFile);
 
     // Extend mounts table
     for (Size i = 0; i < MaximumFileSystemMounts; i++)
@@ -85,6 +93,7 @@ inline FileSystem::Result FileSystemClient::request(const ProcessID pid,
             MemoryBlock::copy(m_mounts[i].path, msg.buffer, msg.pathMountLength + 1);
             m_mounts[i].procID  = msg.pid;
             m_mounts[i].options = ZERO;
+            updateMounts();
             break;
         }
     }
@@ -99,48 +108,62 @@ inline FileSystem::Result FileSystemClient::request(const ProcessID pid,
     }
 
     assert (msg.result != FileSystem::RedirectRequest);
+    m_attributes.update(msg.pid, msg.generation);
     return msg.result;
 }
 
-ProcessID FileSystemClient::findMount(const char *path) const
+void FileSystemClient::getFullPath(const char *path, char *fullpath) const
 {
-    FileSystemMount *m = ZERO;
-    Size length = 0;
-    char fullpath[FileSystemPath::MaximumLength];
-
     // Use the current directory as prefix for relative paths
     if (path[0] != '/' && m_currentDirectory != NULL)
     {
-        const Size copied = MemoryBlock::copy(fullpath, **m_currentDirectory, sizeof(fullpath));
+        const Size copied = MemoryBlock::copy(fullpath, **m_currentDirectory, FileSystemPath::MaximumLength);
 
-        if (copied < sizeof(fullpath))
-            MemoryBlock::copy(fullpath + copied, path, sizeof(fullpath) - copied);
+        if (copied < FileSystemPath::MaximumLength)
+            MemoryBlock::copy(fullpath + copied, path, FileSystemPath::MaximumLength - copied);
     }
     else
     {
-        MemoryBlock::copy(fullpath, path, sizeof(fullpath));
+        MemoryBlock::copy(fullpath, path, FileSystemPath::MaximumLength);
     }
+}
 
-    // Find the longest match
-    for (Size i = 0; i < MaximumFileSystemMounts; i++)
+ProcessID FileSystemClient::findMount(const char *path) const
+{
+    FileSystemMountTree::Cursor cursor;
+
+    // Relative paths continue from the resolved current directory
+    if (path[0] != '/' && m_currentDirectory != NULL)
     {
-        if (m_mounts[i].path[0])
+        if (!m_currentDirectoryResolved)
         {
-            String str(m_mounts[i].path, false);
-            Size len = str.length();
-
-            // Only choose this mount, if it matches,
-            // and is longer than the last match.
-            if (str.compareTo(fullpath, true, len) == 0 && len > length)
-            {
-                length = len;
-                m = &m_mounts[i];
-            }
+            m_mountTree.begin(m_currentDirectoryCursor);
+            m_mountTree.walk(m_currentDirectoryCursor, **m_currentDirectory,
+                             FileSystemPath::MaximumLength);
+            m_currentDirectoryResolved = true;
         }
+        cursor = m_currentDirectoryCursor;
+    }
+    else
+    {
+        m_mountTree.begin(cursor);
     }
 
+    m_mountTree.walk(cursor, path, FileSystemPath::MaximumLength);
+
     // All done
-    return m ? m->procID : ROOTFS_PID;
+    return cursor.found ? cursor.pid : ROOTFS_PID;
+}
+
+void FileSystemClient::updateMounts() const
+{
+    if (!m_mountTree.rebuild(m_mounts, MaximumFileSystemMounts))
+    {
+        ERROR("failed to insert all file system mounts");
+    }
+
+    m_currentDirectoryResolved = false;
+    m_attributes.clear();
 }
 
 const String * FileSystemClient::getCurrentDirectory() const
@@ -152,6 +175,7 @@ void FileSystemClient::setCurrentDirectory(const String &directory)
 {
     assert(m_currentDirectory != NULL);
     *m_currentDirectory = directory;
+    m_currentDirectoryResolved = false;
 }
 
 void FileSystemClient::setCurrentDirectory(String *directory)
@@ -164,6 +188,7 @@ void FileSystemClient::setCurrentDirectory(String *directory)
     {
         m_currentDirectory = directory;
     }
+    m_currentDirectoryResolved = false;
 }
 
 FileSystem::Result FileSystemClient::createFile(const char *path,
@@ -186,13 +211,167 @@ FileSystem::Result FileSystemClient::createFile(const char *path,
 FileSystem::Result FileSystemClient::statFile(const char *path,
                                               FileSystem::FileStat *st) const
 {
+    return statFile(path, st, m_pid == ANY);
+}
+
+FileSystem::Result FileSystemClient::statFile(const char *path,
+                                              FileSystem::FileStat *st,
+                                              const bool useCache) const
+{
+    char fullpath[FileSystemPath::MaximumLength];
+    Timer::Info timer;
+    const bool cached = useCache && ProcessCtl(SELF, InfoTimer, (Address) &timer) == API::Success;
+
+    // Use the cached file status while its lease is valid
+    if (cached)
+    {
+        getFullPath(path, fullpath);
+        m_attributes.setLease((timer.frequency * AttributeLeaseMsec) / 1000);
+
+        if (m_attributes.lookup(fullpath, timer.ticks, *st))
+        {
+            return FileSystem::Success;
+        }
+    }
+
     FileSystemMessage msg;
     msg.type   = ChannelMessage::Request;
     msg.action = FileSystem::StatFile;
     msg.buffer = (char *)path;
     msg.stat   = st;
 
-    return request(path, msg);
+    const FileSystem::Result result = request(path, msg);
+
+    // Other file types may change without a request, such as devices
+    if (cached && result == FileSystem::Success &&
+       (st->type == FileSystem::RegularFile || st->type == FileSystem::DirectoryFile))
+    {
+        m_attributes.insert(fullpath, *st, msg.generation, timer.ticks);
+    }
+
+    return result;
+}
+
+void FileSystemClient::statFiles(const char **paths,
+                                 FileSystem::FileStat *st,
+                                 FileSystem::Result *results,
+                                 const Size count) const
+{
+    FileSystemMessage msgs[MaximumBatchSize];
+    char fullpaths[MaximumBatchSize][FileSystemPath::MaximumLength];
+    Size i = 0;
+
+    while (i < count)
+    {
+        const ProcessID pid = m_pid == ANY ? findMount(paths[i]) : m_pid;
+        Size num = 0;
+
+        // Collect consecutive requests for the same file system
+        while (i + num < count && num < MaximumBatchSize &&
+              (num == 0 || m_pid != ANY || findMount(paths[i + num]) == pid))
+        {
+            getFullPath(paths[i + num], fullpaths[num]);
+
+            msgs[num].type   = ChannelMessage::Request;
+            msgs[num].action = FileSystem::StatFile;
+            msgs[num].buffer = fullpaths[num];
+            msgs[num].stat   = &st[i + num];
+            num++;
+        }
+
+        const ChannelClient::Result r =
+            ChannelClient::instance()->syncSendReceiveBatch(msgs, num, sizeof(FileSystemMessage), pid);
+
+        for (Size j = 0; j < num; j++)
+        {
+            if (r != ChannelClient::Success)
+            {
+                results[i + j] = FileSystem::IpcError;
+            }
+            // Redirected requests are resent individually, which also updates the mounts table
+            else if (msgs[j].result == FileSystem::RedirectRequest)
+            {
+                results[i + j] = statFile(paths[i + j], &st[i + j]);
+            }
+            else
+            {
+                m_attributes.update(pid, msgs[j].generation);
+                results[i + j] = msgs[j].result;
+            }
+        }
+
+        i += num;
+    }
+}
+
+FileSystem::Result FileSystemClient::readDirectory(const char *path,
+                                                   Dirent *entries,
+                                                   FileSystem::FileStat *stats,
+                                                   Size & count) const
+{
+    u8 *buffer = new u8[FileSystem::DirectoryBufferSize];
+    FileSystem::Result result = FileSystem::Success;
+    Size num = 0, index = 0;
+
+    do
+    {
+        const ProcessID pid = m_pid == ANY ? findMount(path) : m_pid;
+
+        // The path is read from the same buffer which receives the entries
+        getFullPath(path, (char *) buffer);
+
+        FileSystemMessage msg;
+        msg.type   = ChannelMessage::Request;
+        msg.action = stats ? FileSystem::ReadDirectoryPlus : FileSystem::ReadDirectory;
+        msg.buffer = (char *) buffer;
+        msg.size   = FileSystem::DirectoryBufferSize;
+        msg.offset = index;
+
+        result = request(pid, msg);
+        if (result != FileSystem::Success)
+        {
+            break;
+        }
+
+        // Unpack the records
+        for (Size pos = 0; pos < msg.size && num < count; num++)
+        {
+            const FileSystem::DirectoryRecord *record = (const FileSystem::DirectoryRecord *) (buffer + pos);
+            const u8 *field = (const u8 *) (record + 1);
+
+            if (record->length < sizeof(*record) || record->length > msg.size - pos)
+            {
+                ERROR("invalid directory record from PID " << pid);
+                result = FileSystem::IOError;
+                break;
+            }
+
+            if (record->flags & FileSystem::RecordStat)
+            {
+                if (stats)
+                {
+                    MemoryBlock::copy(&stats[num], field, sizeof(FileSystem::FileStat));
+                }
+                field += sizeof(FileSystem::FileStat);
+            }
+            else if (stats)
+            {
+                MemoryBlock::set(&stats[num], 0, sizeof(FileSystem::FileStat));
+                stats[num].type = FileSystem::UnknownFile;
+            }
+
+            MemoryBlock::copy(entries[num].name, (char *) field, DIRENT_LEN);
+            entries[num].type = (FileSystem::FileType) record->type;
+            pos += record->length;
+        }
+
+        index = msg.offset;
+    }
+    while (result == FileSystem::Success && index != ZERO && num < count);
+
+    delete[] buffer;
+    count = num;
+    return result;
 }
 
 FileSystem::Result FileSystemClient::openFile(const char *path,
@@ -200,7 +379,8 @@ FileSystem::Result FileSystemClient::openFile(const char *path,
 {
     FileSystem::FileStat st;
 
-    const FileSystem::Result result = statFile(path, &st);
+    // Always retrieve the current inode, as a cached one may be deleted
+    const FileSystem::Result result = statFile(path, &st, false);
     if (result == FileSystem::Success)
     {
         FileDescriptor *fd = FileDescriptor::instance();
@@ -217,15 +397,162 @@ FileSystem::Result FileSystemClient::openFile(const char *path,
 
 FileSystem::Result FileSystemClient::closeFile(const Size descriptor) const
 {
+    const FileDescriptor::Entry *fd = FileDescriptor::instance()->getEntry(descriptor);
+    const Address pipe = fd && fd->open ? fd->pipe : ZERO;
+    const bool writer = fd && fd->writer;
+
     const FileDescriptor::Result result = FileDescriptor::instance()->closeEntry(descriptor);
     if (result != FileDescriptor::Success)
     {
         return FileSystem::IOError;
     }
 
+    // Unmap the pipe buffer after closing its last end in this process
+    if (pipe != ZERO)
+    {
+        Pipe p(pipe);
+        p.detach(writer);
+
+        if (!isPipeUsed(pipe, descriptor))
+        {
+            p.release();
+        }
+    }
+
     return FileSystem::Success;
 }
 
+void FileSystemClient::closeFiles() const
+{
+    Size count = 0;
+    const FileDescriptor::Entry *entries = FileDescriptor::instance()->getArray(count);
+
+    for (Size i = 0; entries != ZERO && i < count; i++)
+    {
+        if (entries[i].open)
+        {
+            closeFile(i);
+        }
+    }
+}
+
+FileSystem::Result FileSystemClient::createPipe(Size & readDescriptor,
+                                                Size & writeDescriptor) const
+{
+    FileDescriptor *fd = FileDescriptor::instance();
+    Address buffer;
+
+    const FileSystem::Result result = Pipe::create(buffer);
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+
+    if (fd->openPipe(buffer, false, readDescriptor) != FileDescriptor::Success)
+    {
+        Pipe(buffer).release();
+        return FileSystem::IOError;
+    }
+
+    if (fd->openPipe(buffer, true, writeDescriptor) != FileDescriptor::Success)
+    {
+        fd->closeEntry(readDescriptor);
+        Pipe(buffer).release();
+        return FileSystem::IOError;
+    }
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result FileSystemClient::duplicateFile(const Size descriptor,
+                                                   const Size target) const
+{
+    const FileDescriptor::Entry *fd = FileDescriptor::instance()->getEntry(descriptor);
+    FileDescriptor::Entry *copy = FileDescriptor::instance()->getEntry(target);
+
+    if (!fd || !fd->open)
+    {
+        return FileSystem::NotFound;
+    }
+    else if (!copy)
+    {
+        return FileSystem::InvalidArgument;
+    }
+    else if (descriptor == target)
+    {
+        return FileSystem::Success;
+    }
+
+    // The pipe end gains a reference before the target is closed,
+    // such that the pipe buffer stays mapped if both are the same pipe
+    if (fd->pipe != ZERO)
+    {
+        Pipe(fd->pipe).attach(fd->writer);
+    }
+
+    if (copy->open)
+    {
+        closeFile(target);
+    }
+
+    FileDescriptor::instance()->copyEntry(descriptor, target);
+    return FileSystem::Success;
+}
+
+FileSystem::Result FileSystemClient::inheritFiles(const ProcessID pid) const
+{
+    Size count = 0;
+    const FileDescriptor::Entry *entries = FileDescriptor::instance()->getArray(count);
+
+    // Map each pipe buffer once, at its first descriptor
+    for (Size i = 0; entries != ZERO && i < count; i++)
+    {
+        Size first = 0;
+
+        if (!entries[i].open || entries[i].pipe == ZERO)
+            continue;
+
+        while (!entries[first].open || entries[first].pipe != entries[i].pipe)
+            first++;
+
+        if (first == i)
+        {
+            const FileSystem::Result result = Pipe(entries[i].pipe).share(pid);
+            if (result != FileSystem::Success)
+            {
+                return result;
+            }
+        }
+    }
+
+    // The new process holds a copy of each pipe end
+    for (Size i = 0; entries != ZERO && i < count; i++)
+    {
+        if (entries[i].open && entries[i].pipe != ZERO)
+        {
+            Pipe(entries[i].pipe).attach(entries[i].writer);
+        }
+    }
+
+    return FileSystem::Success;
+}
+
+bool FileSystemClient::isPipeUsed(const Address pipe, const Size descriptor) const
+{
+    Size count = 0;
+    const FileDescriptor::Entry *entries = FileDescriptor::instance()->getArray(count);
+
+    for (Size i = 0; entries != ZERO && i < count; i++)
+    {
+        if (i != descriptor && entries[i].open && entries[i].pipe == pipe)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 FileSystem::Result FileSystemClient::readFile(const Size descriptor,
                                               void *buf,
                                               Size *size) const
@@ -236,6 +563,23 @@ FileSystem::Result FileSystemClient::readFile(const Size descriptor,
         return FileSystem::NotFound;
     }
 
+    // Pipes move the bytes through shared memory
+    if (fd->pipe != ZERO)
+    {
+        return fd->writer ? FileSystem::InvalidArgument : Pipe(fd->pipe).read(buf, size);
+    }
+
+    // Large unaligned transfers are copied via the shared bulk buffer.
+    // Page aligned buffers are directly mapped by the file system instead.
+    if (*size >= FileSystem::BulkTransferThreshold && ((Address) buf & ~PAGEMASK))
+    {
+        u8 *bulk = getBulkBuffer(fd->pid);
+        if (bulk != ZERO)
+        {
+            return transferBulk(fd, bulk, FileSystem::ReadFileBulk, (u8 *) buf, size);
+        }
+    }
+
     FileSystemMessage msg;
     msg.type     = ChannelMessage::Request;
     msg.action   = FileSystem::ReadFile;
@@ -264,6 +608,23 @@ FileSystem::Result FileSystemClient::writeFile(const Size descriptor,
         return FileSystem::NotFound;
     }
 
+    // Pipes move the bytes through shared memory
+    if (fd->pipe != ZERO)
+    {
+        return !fd->writer ? FileSystem::InvalidArgument : Pipe(fd->pipe).write(buf, size);
+    }
+
+    // Large unaligned transfers are copied via the shared bulk buffer.
+    // Page aligned buffers are directly mapped by the file system instead.
+    if (*size >= FileSystem::BulkTransferThreshold && ((Address) buf & ~PAGEMASK))
+    {
+        u8 *bulk = getBulkBuffer(fd->pid);
+        if (bulk != ZERO)
+        {
+            return transferBulk(fd, bulk, FileSystem::WriteFileBulk, (u8 *) buf, size);
+        }
+    }
+
     FileSystemMessage msg;
     msg.type     = ChannelMessage::Request;
     msg.action   = FileSystem::WriteFile;
@@ -282,6 +643,296 @@ FileSystem::Result FileSystemClient::writeFile(const Size descriptor,
     return result;
 }
 
+FileSystem::Result FileSystemClient::mapFile(const char *path,
+                                             const void **data,
+                                             Size *size) const
+{
+#ifdef __HOST__
+    // HostShares cannot distinguish shares by their tag
+    return FileSystem::NotSupported;
+#else
+    FileSystem::FileStat st;
+    Size slot = FileSystem::MaximumFileMappings;
+
+    // Always retrieve the current inode, as a cached one may be deleted
+    const FileSystem::Result result = statFile(path, &st, false);
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+    else if (st.type != FileSystem::RegularFile)
+    {
+        return FileSystem::NotSupported;
+    }
+    else if (st.size == 0)
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    // Each mapping uses a distinct share tag
+    for (Size i = 0; i < FileSystem::MaximumFileMappings; i++)
+    {
+        if (m_mappings[i].data == ZERO)
+        {
+            slot = i;
+            break;
+        }
+    }
+
+    if (slot == FileSystem::MaximumFileMappings)
+    {
+        return FileSystem::IOError;
+    }
+
+    const SystemInformation info;
+    ProcessShares::MemoryShare share;
+    share.pid    = st.pid;
+    share.coreId = info.coreId;
+    share.tagId  = FileSystem::MapShareTag + slot;
+    share.range.size = (st.size + PAGESIZE - 1) & PAGEMASK;
+    share.range.virt = 0;
+    share.range.phys = 0;
+    share.range.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    const API::Result shareResult = VMShare(st.pid, API::Create, &share);
+    if (shareResult != API::Success)
+    {
+        ERROR("VMShare failed for PID " << st.pid << ": result = " << (int) shareResult);
+        return FileSystem::IOError;
+    }
+
+    // Let the file system fill the shared pages
+    FileSystemMessage msg;
+    msg.type     = ChannelMessage::Request;
+    msg.action   = FileSystem::MapFile;
+    msg.inode    = st.inode;
+    msg.buffer   = (char *) share.tagId;
+    msg.size     = st.size;
+    msg.offset   = 0;
+
+    const FileSystem::Result mapResult = request(st.pid, msg);
+    if (mapResult != FileSystem::Success)
+    {
+        VMShare(st.pid, API::Delete, &share);
+        return mapResult;
+    }
+
+    m_mappings[slot].pid  = st.pid;
+    m_mappings[slot].data = (const void *) share.range.virt;
+    *data = m_mappings[slot].data;
+    *size = msg.size;
+    return FileSystem::Success;
+#endif /* __HOST__ */
+}
+
+FileSystem::Result FileSystemClient::unmapFile(const void *data) const
+{
+    for (Size i = 0; i < FileSystem::MaximumFileMappings; i++)
+    {
+        if (data != ZERO && m_mappings[i].data == data)
+        {
+            const SystemInformation info;
+            ProcessShares::MemoryShare share;
+            share.pid    = m_mappings[i].pid;
+            share.coreId = info.coreId;
+            share.tagId  = FileSystem::MapShareTag + i;
+
+            // Releases the pages, as the file system already removed its side of the share
+            const API::Result result = VMShare(share.pid, API::Delete, &share);
+            m_mappings[i].data = ZERO;
+
+            if (result != API::Success)
+            {
+                ERROR("VMShare failed for PID " << share.pid << ": result = " << (int) result);
+                return FileSystem::IOError;
+            }
+            return FileSystem::Success;
+        }
+    }
+
+    return FileSystem::NotFound;
+}
+
+FileSystem::Result FileSystemClient::spliceFile(const Size descriptor,
+                                                const Size targetDescriptor,
+                                                Size *size,
+                                                const void *header,
+                                                const Size headerSize,
+                                                const Size chunkSize) const
+{
+    FileDescriptor::Entry *fd = FileDescriptor::instance()->getEntry(descriptor);
+    FileDescriptor::Entry *target = FileDescriptor::instance()->getEntry(targetDescriptor);
+    FileSystem::SpliceInfo info;
+    Size total = 0;
+
+    if (!fd || !fd->open || !target || !target->open)
+    {
+        return FileSystem::NotFound;
+    }
+    else if (fd->pipe != ZERO || target->pipe != ZERO)
+    {
+        return FileSystem::NotSupported;
+    }
+    else if (headerSize > FileSystem::SpliceHeaderSize)
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    info.pid        = target->pid;
+    info.inode      = target->inode;
+    info.chunkSize  = chunkSize;
+    info.headerSize = headerSize;
+    MemoryBlock::copy(info.header, header, headerSize);
+
+    // The file system may splice less than requested per request
+    while (total < *size)
+    {
+        FileSystemMessage msg;
+        msg.type     = ChannelMessage::Request;
+        msg.action   = FileSystem::SpliceFile;
+        msg.inode    = fd->inode;
+        msg.buffer   = (char *) &info;
+        msg.size     = *size - total;
+        msg.offset   = fd->position;
+        info.offset  = target->position;
+
+        const FileSystem::Result result = request(fd->pid, msg);
+        if (result != FileSystem::Success)
+        {
+            if (total == 0)
+            {
+                return result;
+            }
+            break;
+        }
+
+        total += msg.size;
+        fd->position += msg.size;
+        target->position += msg.size;
+
+        // Nothing spliced indicates end-of-file
+        if (msg.size == 0)
+        {
+            break;
+        }
+    }
+
+    *size = total;
+    return FileSystem::Success;
+}
+
+u8 * FileSystemClient::getBulkBuffer(const ProcessID pid) const
+{
+#ifdef __HOST__
+    // HostShares cannot distinguish shares by their tag
+    return ZERO;
+#else
+    BulkBuffer *entry = ZERO;
+
+    for (Size i = 0; i < MaximumFileSystemMounts; i++)
+    {
+        if (m_bulkBuffers[i].buffer != ZERO && m_bulkBuffers[i].pid == pid)
+        {
+            return m_bulkBuffers[i].buffer;
+        }
+        else if (m_bulkBuffers[i].buffer == ZERO && entry == ZERO)
+        {
+            entry = &m_bulkBuffers[i];
+        }
+    }
+
+    // No free slot left, fallback to regular transfers
+    if (entry == ZERO)
+    {
+        return ZERO;
+    }
+
+    const SystemInformation info;
+    ProcessShares::MemoryShare share;
+    share.pid    = pid;
+    share.coreId = info.coreId;
+    share.tagId  = FileSystem::BulkShareTag;
+    share.range.size = FileSystem::BulkTransferSize;
+    share.range.virt = 0;
+    share.range.phys = 0;
+    share.range.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    API::Result r = VMShare(pid, API::Create, &share);
+    if (r == API::AlreadyExists)
+    {
+        r = VMShare(SELF, API::Read, &share);
+    }
+
+    if (r != API::Success)
+    {
+        ERROR("VMShare failed for PID " << pid << ": result = " << (int) r);
+        return ZERO;
+    }
+
+    entry->pid    = pid;
+    entry->buffer = (u8 *) share.range.virt;
+    return entry->buffer;
+#endif /* __HOST__ */
+}
+
+FileSystem::Result FileSystemClient::transferBulk(FileDescriptor::Entry *fd,
+                                                  u8 *bulk,
+                                                  const FileSystem::Action action,
+                                                  u8 *buf,
+                                                  Size *size) const
+{
+    FileSystem::Result result = FileSystem::Success;
+    Size total = 0;
+
+    while (total < *size)
+    {
+        const Size chunk = *size - total < FileSystem::BulkTransferSize ?
+                           *size - total : FileSystem::BulkTransferSize;
+
+        if (action == FileSystem::WriteFileBulk)
+        {
+            MemoryBlock::copy(bulk, buf + total, chunk);
+        }
+
+        FileSystemMessage msg;
+        msg.type     = ChannelMessage::Request;
+        msg.action   = action;
+        msg.inode    = fd->inode;
+        msg.buffer   = ZERO;
+        msg.size     = chunk;
+        msg.offset   = fd->position;
+
+        result = request(fd->pid, msg);
+        if (result != FileSystem::Success)
+        {
+            break;
+        }
+
+        if (action == FileSystem::ReadFileBulk)
+        {
+            MemoryBlock::copy(buf + total, bulk, msg.size);
+        }
+
+        total += msg.size;
+        fd->position += msg.size;
+
+        // Short transfers indicate end-of-file or no more data available
+        if (msg.size < chunk)
+        {
+            break;
+        }
+    }
+
+    // Report bytes which are transferred before any failure
+    if (total > 0 || result == FileSystem::Success)
+    {
+        *size = total;
+        return FileSystem::Success;
+    }
+
+    return result;
+}
+
 
 FileSystem::Result FileSystemClient::deleteFile(const char *path) const
 {
@@ -321,6 +972,134 @@ FileSystem::Result FileSystemClient::waitFile(const char *filesystemPath,
     return request(pid, msg);
 }
 
+FileSystem::Result FileSystemClient::waitDescriptors(FileSystem::WaitDescriptor *descriptors,
+                                                     const Size count,
+                                                     const Size msecTimeout) const
+{
+    FileDescriptor::Entry *entries[MaximumWaitDescriptors];
+    ProcessID servers[MaximumWaitDescriptors];
+    Size serverCount = 0;
+
+    if (count == 0 || count > MaximumWaitDescriptors)
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    // Collect the file systems of all descriptors
+    for (Size i = 0; i < count; i++)
+    {
+        Size j = 0;
+
+        entries[i] = FileDescriptor::instance()->getEntry(descriptors[i].fd);
+        descriptors[i].current = 0;
+
+        if (!entries[i] || !entries[i]->open)
+        {
+            return FileSystem::NotFound;
+        }
+        else if (entries[i]->pipe != ZERO)
+        {
+            return FileSystem::NotSupported;
+        }
+
+        while (j < serverCount && servers[j] != entries[i]->pid)
+            j++;
+
+        if (j == serverCount)
+            servers[serverCount++] = entries[i]->pid;
+    }
+
+    KernelTimer timer;
+    Timer::Info deadline;
+    timer.tick();
+    timer.getCurrent(&deadline, msecTimeout);
+
+    // Let the file system wait for any of its files
+    if (serverCount == 1)
+    {
+        return waitFileSystemDescriptors(servers[0], descriptors, entries, count,
+                                         msecTimeout != 0 ? &deadline : ZERO);
+    }
+
+    // Wait on each file system in turn for a short time
+    while (true)
+    {
+        for (Size i = 0; i < serverCount; i++)
+        {
+            Timer::Info slice;
+            timer.tick();
+            timer.getCurrent(&slice, WaitSliceMsec / serverCount);
+
+            if (msecTimeout != 0 && timer.isExpired(deadline))
+            {
+                return FileSystem::TimedOut;
+            }
+            else if (msecTimeout != 0 && slice.ticks > deadline.ticks)
+            {
+                slice = deadline;
+            }
+
+            const FileSystem::Result result = waitFileSystemDescriptors(servers[i], descriptors, entries,
+                                                                        count, &slice);
+            if (result != FileSystem::TimedOut)
+            {
+                return result;
+            }
+        }
+    }
+
+    return FileSystem::TimedOut;
+}
+
+FileSystem::Result FileSystemClient::waitFileSystemDescriptors(const ProcessID pid,
+                                                               FileSystem::WaitDescriptor *descriptors,
+                                                               FileDescriptor::Entry **entries,
+                                                               const Size count,
+                                                               const Timer::Info *timeout) const
+{
+    FileSystem::WaitSet waitSet[MaximumWaitDescriptors];
+    Size index[MaximumWaitDescriptors];
+    Size num = 0;
+
+    for (Size i = 0; i < count; i++)
+    {
+        if (entries[i]->pid == pid)
+        {
+            waitSet[num].inode     = entries[i]->inode;
+            waitSet[num].requested = descriptors[i].requested;
+            waitSet[num].current   = 0;
+            index[num++] = i;
+        }
+    }
+
+    FileSystemMessage msg;
+    msg.type = ChannelMessage::Request;
+    msg.action = FileSystem::WaitFile;
+    msg.buffer = (char *) waitSet;
+    msg.size = num * sizeof(FileSystem::WaitSet);
+
+    if (timeout != ZERO)
+    {
+        msg.timeout = *timeout;
+    }
+    else
+    {
+        msg.timeout.ticks = 0;
+        msg.timeout.frequency = 0;
+    }
+
+    const FileSystem::Result result = request(pid, msg);
+    if (result == FileSystem::Success)
+    {
+        for (Size i = 0; i < num; i++)
+        {
+            descriptors[index[i]].current = waitSet[i].current;
+        }
+    }
+
+    return result;
+}
+
 FileSystem::Result FileSystemClient::mountFileSystem(const char *mountPath) const
 {
     FileSystemMessage msg;
@@ -352,6 +1131,7 @@ FileSystemMount * FileSystemClient::getFileSystems(Size &numberOfMounts) const
     const FileSystem::Result result = request(ROOTFS_PID, msg);
     if (result == FileSystem::Success)
     {
+        updateMounts();
         numberOfMounts = MaximumFileSystemMounts;
         return m_mounts;
     }
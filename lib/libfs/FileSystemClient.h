@@ -21,10 +21,15 @@
 #include <FreeNOS/API/ProcessID.h>
 #include <Types.h>
 #include <Memory.h>
+#include <Timer.h>
 #include "FileSystem.h"
 #include "FileSystemMount.h"
+#include "FileSystemMountTree.h"
+#include "FileAttributeCache.h"
+#include "FileDescriptor.h"
 
 struct FileSystemMessage;
+struct Dirent;
 
 /**
  * @addtogroup lib
@@ -44,7 +49,21 @@ class FileSystemClient
   private:
 
     /** Maximum number of mounted filesystems. */
-    static const Size MaximumFileSystemMounts = 16;
+    static const Size MaximumFileSystemMounts = FileSystemMountTree::MaximumMounts;
+
+    /** Maximum number of requests sent in a single batch. */
+    static const Size MaximumBatchSize = 16;
+
+    /** Number of milliseconds a cached file status remains valid. */
+    static const Size AttributeLeaseMsec = 100;
+
+    /** Number of milliseconds to wait on each file system when waiting on several. */
+    static const Size WaitSliceMsec = 10;
+
+  public:
+
+    /** Maximum number of file descriptors in a single wait. */
+    static const Size MaximumWaitDescriptors = 32;
 
   public:
 
@@ -96,6 +115,9 @@ class FileSystemClient
     /**
      * Retrieve status of a file.
      *
+     * The status of regular files and directories is cached for a short lease,
+     * or until the file system reports a change in any response.
+     *
      * @param path Path to the file
      * @param st Output buffer for the file status
      *
@@ -104,6 +126,42 @@ class FileSystemClient
     FileSystem::Result statFile(const char *path,
                                 FileSystem::FileStat *st) const;
 
+    /**
+     * Retrieve status of multiple files.
+     *
+     * Requests for consecutive files on the same file system
+     * are sent as a single batch, which avoids a full round trip per file.
+     *
+     * @param paths Array of paths to the files
+     * @param st Array of output buffers for the file status
+     * @param results Array of output result codes for each file
+     * @param count Number of files in the arrays
+     */
+    void statFiles(const char **paths,
+                   FileSystem::FileStat *st,
+                   FileSystem::Result *results,
+                   const Size count) const;
+
+    /**
+     * Read the entries of a directory.
+     *
+     * The file system returns the entries in packed form, which takes a single
+     * request for each FileSystem::DirectoryBufferSize bytes of entries.
+     *
+     * @param path Path to the directory
+     * @param entries Output array for the directory entries
+     * @param stats Optional output array for the status of each entry, or ZERO.
+     *              Entries for which no status is available get the UnknownFile type.
+     * @param count Maximum number of entries on input.
+     *              On output, the actual number of entries read.
+     *
+     * @return Result code
+     */
+    FileSystem::Result readDirectory(const char *path,
+                                     Dirent *entries,
+                                     FileSystem::FileStat *stats,
+                                     Size & count) const;
+
     /**
      * Open a file
      *
@@ -124,6 +182,52 @@ class FileSystemClient
      */
     FileSystem::Result closeFile(const Size descriptor) const;
 
+    /**
+     * Close all files
+     *
+     * Closing the pipe ends lets other processes see
+     * end-of-file or a broken pipe.
+     */
+    void closeFiles() const;
+
+    /**
+     * Create a pipe
+     *
+     * Bytes written to the write end can be read from the read end,
+     * also by other processes which inherited the descriptors.
+     *
+     * @param readDescriptor Outputs the file descriptor number of the read end
+     * @param writeDescriptor Outputs the file descriptor number of the write end
+     *
+     * @return Result code
+     */
+    FileSystem::Result createPipe(Size & readDescriptor,
+                                  Size & writeDescriptor) const;
+
+    /**
+     * Duplicate a file descriptor
+     *
+     * @param descriptor File descriptor number to duplicate
+     * @param target File descriptor number of the copy. It is closed first if open.
+     *
+     * @return Result code
+     */
+    FileSystem::Result duplicateFile(const Size descriptor,
+                                     const Size target) const;
+
+    /**
+     * Prepare the open files for inheritance by a new process
+     *
+     * Must be called before the file descriptors are copied into the
+     * new process. Pipe buffers are mapped into the new process and
+     * its pipe ends are counted as open.
+     *
+     * @param pid Process identifier of the new process
+     *
+     * @return Result code
+     */
+    FileSystem::Result inheritFiles(const ProcessID pid) const;
+
     /**
      * Read a file.
      *
@@ -150,6 +254,70 @@ class FileSystemClient
                                  const void *buf,
                                  Size *size) const;
 
+    /**
+     * Map the contents of a regular file into memory.
+     *
+     * The file system reads the file directly into memory shared
+     * with the current process, instead of copying it through
+     * the IPC buffers. Changes to the file after the mapping is
+     * created are not visible in the mapping.
+     *
+     * @param path Path to the file
+     * @param data On output, address of the file contents
+     * @param size On output, size of the file in bytes
+     *
+     * @return Result code
+     */
+    FileSystem::Result mapFile(const char *path,
+                               const void **data,
+                               Size *size) const;
+
+    /**
+     * Remove a mapping created by mapFile().
+     *
+     * @param data Address of the file contents returned by mapFile()
+     *
+     * @return Result code
+     */
+    FileSystem::Result unmapFile(const void *data) const;
+
+    /**
+     * Copy bytes from a file directly into another file.
+     *
+     * The file system of the source file reads the bytes and writes
+     * them to the target file, which must be served by another file
+     * system, such as a socket of a network server. The bytes do not
+     * pass through the current process. Each chunk is written with a
+     * separate write which starts with the given header.
+     *
+     * @param descriptor File descriptor number of the source file
+     * @param targetDescriptor File descriptor number of the target file
+     * @param size On input, number of bytes to copy. On output, actual bytes copied.
+     * @param header Bytes to write before each chunk, or ZERO for none
+     * @param headerSize Number of header bytes, at most FileSystem::SpliceHeaderSize
+     * @param chunkSize Maximum number of bytes per write, or zero for no limit
+     *
+     * @return Result code
+     */
+    FileSystem::Result spliceFile(const Size descriptor,
+                                  const Size targetDescriptor,
+                                  Size *size,
+                                  const void *header = ZERO,
+                                  const Size headerSize = 0,
+                                  const Size chunkSize = 0) const;
+
+    /**
+     * Retrieve the bulk transfer buffer shared with a file system.
+     *
+     * The buffer is created on first use with VMShare() and remains
+     * shared with the file system for the lifetime of the process.
+     *
+     * @param pid Process identifier of the target file system.
+     *
+     * @return Pointer to the bulk buffer on success or ZERO if not available.
+     */
+    u8 * getBulkBuffer(const ProcessID pid) const;
+
     /**
      * Remove a file from the file system.
      *
@@ -174,6 +342,25 @@ class FileSystemClient
                                 const Size count,
                                 const Size msecTimeout) const;
 
+    /**
+     * Wait for one or more file descriptors to become readable/writable
+     *
+     * The descriptors may belong to different file systems. When all belong
+     * to the same file system, a single request waits for any of them.
+     * Otherwise, each file system is waited on for a short time in turn,
+     * until any descriptor is ready or the timeout expires.
+     *
+     * @param descriptors Pointer to a WaitDescriptor array. On output, the current
+     *                    status flags are filled in for each descriptor.
+     * @param count Number of WaitDescriptor entries
+     * @param msecTimeout Timeout in milliseconds of the wait or ZERO for infinite wait
+     *
+     * @return Result code
+     */
+    FileSystem::Result waitDescriptors(FileSystem::WaitDescriptor *descriptors,
+                                       const Size count,
+                                       const Size msecTimeout) const;
+
     /**
      * Mount the current process as a file system on the rootfs.
      *
@@ -205,6 +392,46 @@ class FileSystemClient
 
   private:
 
+    /**
+     * Check if a pipe buffer is used by any other open file descriptor
+     *
+     * @param pipe Address of the pipe buffer
+     * @param descriptor File descriptor number to ignore
+     *
+     * @return True if in use, false otherwise
+     */
+    bool isPipeUsed(const Address pipe, const Size descriptor) const;
+
+    /**
+     * Retrieve status of a file.
+     *
+     * @param path Path to the file
+     * @param st Output buffer for the file status
+     * @param useCache True to use and fill the cached file status
+     *
+     * @return Result code
+     */
+    FileSystem::Result statFile(const char *path,
+                                FileSystem::FileStat *st,
+                                const bool useCache) const;
+
+    /**
+     * Wait for the file descriptors which belong to the given file system
+     *
+     * @param pid Process identifier of the file system
+     * @param descriptors Pointer to a WaitDescriptor array
+     * @param entries File descriptor entry of each descriptor
+     * @param count Number of WaitDescriptor entries
+     * @param timeout Time at which the wait expires or ZERO for infinite wait
+     *
+     * @return Result code
+     */
+    FileSystem::Result waitFileSystemDescriptors(const ProcessID pid,
+                                                 FileSystem::WaitDescriptor *descriptors,
+                                                 FileDescriptor::Entry **entries,
+                                                 const Size count,
+                                                 const Timer::Info *timeout) const;
+
     /**
      * Send an IPC request to the target file system
      *
@@ -225,6 +452,14 @@ class FileSystemClient
      */
     FileSystem::Result request(const ProcessID pid, FileSystemMessage &msg) const;
 
+    /**
+     * Construct the full path for the given path.
+     *
+     * @param path Path to the file, can be relative or absolute.
+     * @param fullpath Output buffer of FileSystemPath::MaximumLength bytes.
+     */
+    void getFullPath(const char *path, char *fullpath) const;
+
     /**
      * Retrieve the ProcessID of the FileSystemMount for the given path.
      *
@@ -234,11 +469,69 @@ class FileSystemClient
      */
     ProcessID findMount(const char *path) const;
 
+    /**
+     * Rebuild the mount tree after the mounts table has changed.
+     */
+    void updateMounts() const;
+
+    /**
+     * Read or write a file using the bulk transfer buffer.
+     *
+     * @param fd File descriptor entry of the file
+     * @param bulk Pointer to the bulk buffer shared with the file system
+     * @param action Either ReadFileBulk or WriteFileBulk
+     * @param buf Buffer for the bytes to read or write
+     * @param size On input, number of bytes to transfer. On output, actual bytes transferred.
+     *
+     * @return Result code
+     */
+    FileSystem::Result transferBulk(FileDescriptor::Entry *fd,
+                                    u8 *bulk,
+                                    const FileSystem::Action action,
+                                    u8 *buf,
+                                    Size *size) const;
+
   private:
 
+    /**
+     * Bulk transfer buffer which is shared with a file system
+     */
+    struct BulkBuffer
+    {
+        ProcessID pid;  /**@< Process identifier of the file system */
+        u8 *buffer;     /**@< Local address of the shared buffer */
+    };
+
+    /**
+     * File contents which are mapped with mapFile()
+     */
+    struct FileMapping
+    {
+        ProcessID pid;      /**@< Process identifier of the file system */
+        const void *data;   /**@< Local address of the mapping or ZERO if unused */
+    };
+
     /** FileSystem mounts table */
     static FileSystemMount m_mounts[MaximumFileSystemMounts];
 
+    /** Prefix tree of the mounts table for efficient lookups */
+    static FileSystemMountTree m_mountTree;
+
+    /** Position in the mount tree after walking the current directory */
+    static FileSystemMountTree::Cursor m_currentDirectoryCursor;
+
+    /** True if m_currentDirectoryCursor is valid for the current directory and mounts */
+    static bool m_currentDirectoryResolved;
+
+    /** Bulk transfer buffers shared with file systems */
+    static BulkBuffer m_bulkBuffers[MaximumFileSystemMounts];
+
+    /** Mapped files. The position in the table determines the share tag. */
+    static FileMapping m_mappings[FileSystem::MaximumFileMappings];
+
+    /** Recently retrieved file status */
+    static FileAttributeCache m_attributes;
+
     /** Current directory path is prefixed to relative path inputs */
     static String *m_currentDirectory;
 
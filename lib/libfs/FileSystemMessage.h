@@ -38,7 +38,7 @@ typedef struct FileSystemMessage : public ChannelMessage
 {
     FileSystem::Action action;     /**< Action to perform. */
     FileSystem::Result result;     /**< Result code. */
-    char *buffer;                  /**< Points to a buffer for I/O. */
+    char *buffer;                  /**< Points to a buffer for I/O, or the offset in the bulk buffer */
     Size size;                     /**< Size of the buffer. */
     Size offset;                   /**< Offset in the file for I/O. */
     u32 inode;                     /**< Inode number of the file */
@@ -46,6 +46,7 @@ typedef struct FileSystemMessage : public ChannelMessage
     Timer::Info timeout;           /**< Timeout value for the action */
     ProcessID pid;                 /**< Process identifier (used for redirection) */
     Size pathMountLength;          /**< Length of the mounted path (used for redirection) */
+    u32 generation;                /**< Change generation of the file system (set in responses) */
 }
 FileSystemMessage;
 
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include "FileSystemMountTree.h"
+
+FileSystemMountTree::FileSystemMountTree()
+{
+    clear();
+}
+
+void FileSystemMountTree::clear()
+{
+    MemoryBlock::set(m_nodes, 0, sizeof(m_nodes));
+    m_count = 1;
+}
+
+bool FileSystemMountTree::rebuild(const FileSystemMount *mounts, const Size count)
+{
+    bool result = true;
+
+    clear();
+
+    for (Size i = 0; i < count; i++)
+    {
+        if (mounts[i].path[0] && !insert(mounts[i].path, mounts[i].procID))
+        {
+            result = false;
+        }
+    }
+
+    return result;
+}
+
+bool FileSystemMountTree::insert(const char *path, const ProcessID pid)
+{
+    Size length = 0, pos = 0;
+    u8 node = 0;
+
+    while (length < FileSystemPath::MaximumLength && path[length])
+        length++;
+
+    while (pos < length)
+    {
+        u8 *link = &m_nodes[node].child;
+
+        // Find the child which continues the path
+        while (*link && m_nodes[*link].label[0] != path[pos])
+            link = &m_nodes[*link].sibling;
+
+        // Add a new leaf if no child matches
+        if (*link == ZERO)
+        {
+            const u8 leaf = createNode(path + pos, length - pos);
+            if (leaf == ZERO)
+            {
+                return false;
+            }
+
+            *link = leaf;
+            node = leaf;
+            break;
+        }
+
+        // Count the characters in common with the child
+        Node *child = &m_nodes[*link];
+        Size common = 1;
+
+        while (common < child->length && pos + common < length &&
+               child->label[common] == path[pos + common])
+        {
+            common++;
+        }
+
+        // Split the child if the path diverges inside its label
+        if (common < child->length)
+        {
+            const u8 split = createNode(child->label, common);
+            if (split == ZERO)
+            {
+                return false;
+            }
+
+            m_nodes[split].child   = *link;
+            m_nodes[split].sibling = child->sibling;
+            child->label  += common;
+            child->length -= common;
+            child->sibling = ZERO;
+            *link = split;
+        }
+
+        node = *link;
+        pos += common;
+    }
+
+    // Keep the first file system mounted on the same path
+    if (!m_nodes[node].mounted)
+    {
+        m_nodes[node].mounted = true;
+        m_nodes[node].pid     = pid;
+    }
+
+    return true;
+}
+
+void FileSystemMountTree::begin(Cursor &cursor) const
+{
+    cursor.node    = 0;
+    cursor.matched = 0;
+    cursor.stopped = false;
+    cursor.found   = m_nodes[0].mounted;
+    cursor.pid     = m_nodes[0].pid;
+}
+
+void FileSystemMountTree::walk(Cursor &cursor, const char *path, const Size maximumLength) const
+{
+    for (Size i = 0; i < maximumLength && path[i] && !cursor.stopped; i++)
+    {
+        const Node *node = &m_nodes[cursor.node];
+
+        // Continue inside the label of the current node
+        if (cursor.matched < node->length)
+        {
+            if (node->label[cursor.matched] != path[i])
+            {
+                cursor.stopped = true;
+                break;
+            }
+            cursor.matched++;
+        }
+        // Continue with a child node
+        else
+        {
+            const u8 child = findChild(cursor.node, path[i]);
+            if (child == ZERO)
+            {
+                cursor.stopped = true;
+                break;
+            }
+            cursor.node    = child;
+            cursor.matched = 1;
+            node = &m_nodes[child];
+        }
+
+        // Remember the longest mount path so far
+        if (cursor.matched == node->length && node->mounted)
+        {
+            cursor.found = true;
+            cursor.pid   = node->pid;
+        }
+    }
+}
+
+bool FileSystemMountTree::find(const char *path, ProcessID &pid) const
+{
+    Cursor cursor;
+
+    begin(cursor);
+    walk(cursor, path, FileSystemPath::MaximumLength);
+
+    if (cursor.found)
+    {
+        pid = cursor.pid;
+    }
+
+    return cursor.found;
+}
+
+Size FileSystemMountTree::count() const
+{
+    return m_count;
+}
+
+u8 FileSystemMountTree::findChild(const u8 node, const char ch) const
+{
+    for (u8 i = m_nodes[node].child; i != ZERO; i = m_nodes[i].sibling)
+    {
+        if (m_nodes[i].label[0] == ch)
+        {
+            return i;
+        }
+    }
+
+    return ZERO;
+}
+
+u8 FileSystemMountTree::createNode(const char *label, const Size length)
+{
+    if (m_count >= MaximumNodes)
+    {
+        return ZERO;
+    }
+
+    Node *node = &m_nodes[m_count];
+    node->label   = label;
+    node->length  = length;
+    node->child   = ZERO;
+    node->sibling = ZERO;
+    node->mounted = false;
+    node->pid     = ZERO;
+
+    return m_count++;
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBFS_FILESYSTEMMOUNTTREE_H
+#define __LIB_LIBFS_FILESYSTEMMOUNTTREE_H
+
+#include <FreeNOS/API/ProcessID.h>
+#include <Types.h>
+#include "FileSystemMount.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libfs
+ * @{
+ */
+
+/**
+ * Prefix tree of file system mount paths.
+ *
+ * Finds the longest mount path which is a prefix of a given path,
+ * in time proportional to the path length instead of the number of mounts.
+ * Each node holds a substring of a mount path, which is referenced instead
+ * of copied, so the mount paths must remain valid while the tree is used.
+ *
+ * A walk over a path can be stopped and resumed with a Cursor, which allows
+ * to resolve a common prefix such as the current directory only once.
+ */
+class FileSystemMountTree
+{
+  public:
+
+    /** Maximum number of mount paths in the tree */
+    static const Size MaximumMounts = 16;
+
+    /** Maximum number of nodes: the root plus at most two nodes per mount */
+    static const Size MaximumNodes = (MaximumMounts * 2) + 1;
+
+    /**
+     * Position of a walk through the tree.
+     */
+    typedef struct Cursor
+    {
+        /** Current node */
+        u8 node;
+
+        /** Number of characters matched in the label of the current node */
+        u8 matched;
+
+        /** True if the walk left the tree and no longer matches */
+        bool stopped;
+
+        /** True if a mount path matched so far */
+        bool found;
+
+        /** ProcessID of the longest matched mount path */
+        ProcessID pid;
+    }
+    Cursor;
+
+  private:
+
+    /**
+     * Node in the tree
+     */
+    typedef struct Node
+    {
+        /** Characters of a mount path on the edge towards this node, not null-terminated */
+        const char *label;
+
+        /** Number of characters in the label */
+        u8 length;
+
+        /** First child node, or zero if none */
+        u8 child;
+
+        /** Next sibling node, or zero if none */
+        u8 sibling;
+
+        /** True if a mount path ends at this node */
+        bool mounted;
+
+        /** ProcessID of the mount ending at this node */
+        ProcessID pid;
+    }
+    Node;
+
+  public:
+
+    /**
+     * Constructor
+     */
+    FileSystemMountTree();
+
+    /**
+     * Remove all mount paths.
+     */
+    void clear();
+
+    /**
+     * Replace the tree contents with a mounts table.
+     *
+     * @param mounts FileSystemMount array, where unused entries have an empty path
+     * @param count Number of entries in the array
+     *
+     * @return True if all mounts are inserted, false if the tree is full
+     */
+    bool rebuild(const FileSystemMount *mounts, const Size count);
+
+    /**
+     * Insert a mount path.
+     *
+     * If the same path is inserted more than once, the first ProcessID is kept.
+     *
+     * @param path Null-terminated mount path
+     * @param pid ProcessID of the mounted file system
+     *
+     * @return True on success, false if the tree is full
+     */
+    bool insert(const char *path, const ProcessID pid);
+
+    /**
+     * Prepare a Cursor to walk from the root of the tree.
+     *
+     * @param cursor Cursor to initialize
+     */
+    void begin(Cursor &cursor) const;
+
+    /**
+     * Continue a walk with more characters of a path.
+     *
+     * @param cursor Cursor to advance
+     * @param path Characters to walk, null-terminated
+     * @param maximumLength Maximum number of characters to walk
+     */
+    void walk(Cursor &cursor, const char *path, const Size maximumLength) const;
+
+    /**
+     * Find the mount of a path.
+     *
+     * @param path Null-terminated absolute path
+     * @param pid Outputs the ProcessID of the longest mount path matching the path
+     *
+     * @return True if a mount is found
+     */
+    bool find(const char *path, ProcessID &pid) const;
+
+    /**
+     * Get number of nodes in use.
+     *
+     * @return Number of nodes including the root
+     */
+    Size count() const;
+
+  private:
+
+    /**
+     * Find the child of a node which starts with the given character.
+     *
+     * @param node Index of the parent node
+     * @param ch Character to find
+     *
+     * @return Index of the child node or zero if not found
+     */
+    u8 findChild(const u8 node, const char ch) const;
+
+    /**
+     * Allocate a new node.
+     *
+     * @param label Characters on the edge to the node
+     * @param length Number of characters in the label
+     *
+     * @return Index of the node or zero if the tree is full
+     */
+    u8 createNode(const char *label, const Size length);
+
+  private:
+
+    /** All nodes, where the first is the root */
+    Node m_nodes[MaximumNodes];
+
+    /** Number of nodes in use */
+    Size m_count;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBFS_FILESYSTEMMOUNTTREE_H */
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <HashFunction.h>
+#include "FileSystemPathTokenizer.h"
+
+FileSystemPathTokenizer::FileSystemPathTokenizer(const char *path,
+                                                 const Size maximumLength,
+                                                 const char separator)
+    : m_path(path)
+    , m_end(0)
+    , m_separator(separator)
+    , m_position(0)
+    , m_length(0)
+    , m_hash(0)
+{
+    while (m_end < maximumLength && m_path[m_end])
+    {
+        m_end++;
+    }
+}
+
+bool FileSystemPathTokenizer::next()
+{
+    m_position = skipSeparators(m_position + m_length);
+    m_length = 0;
+
+    while (m_position + m_length < m_end && m_path[m_position + m_length] != m_separator)
+    {
+        m_length++;
+    }
+
+    m_hash = hash(m_path + m_position, m_length);
+    return m_length != 0;
+}
+
+bool FileSystemPathTokenizer::hasNext() const
+{
+    return skipSeparators(m_position + m_length) < m_end;
+}
+
+const char * FileSystemPathTokenizer::current() const
+{
+    return m_path + m_position;
+}
+
+Size FileSystemPathTokenizer::length() const
+{
+    return m_length;
+}
+
+u32 FileSystemPathTokenizer::hash() const
+{
+    return m_hash;
+}
+
+u32 FileSystemPathTokenizer::hash(const char *component, const Size length)
+{
+    u32 value = FNV_INIT;
+
+    for (Size i = 0; i < length; i++)
+    {
+        value *= FNV_PRIME;
+        value ^= component[i];
+    }
+
+    return value;
+}
+
+Size FileSystemPathTokenizer::skipSeparators(Size position) const
+{
+    while (position < m_end && m_path[position] == m_separator)
+    {
+        position++;
+    }
+
+    return position;
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBFS_FILESYSTEMPATHTOKENIZER_H
+#define __LIB_LIBFS_FILESYSTEMPATHTOKENIZER_H
+
+#include <Types.h>
+#include "FileSystemPath.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libfs
+ * @{
+ */
+
+/**
+ * Splits a filesystem path into components without allocating memory.
+ *
+ * Each component refers directly into the input path and is not
+ * null-terminated. Empty components, caused by repeated separators,
+ * are skipped.
+ */
+class FileSystemPathTokenizer
+{
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param path Input path, which must remain valid while tokenizing
+     * @param maximumLength Maximum number of bytes to read from the path
+     * @param separator Pathname separator
+     */
+    FileSystemPathTokenizer(const char *path,
+                            const Size maximumLength = FileSystemPath::MaximumLength,
+                            const char separator = '/');
+
+    /**
+     * Advance to the next component.
+     *
+     * @return True if a component is available, false at the end of the path
+     */
+    bool next();
+
+    /**
+     * Check if components follow the current component.
+     *
+     * @return True if the current component is not the last
+     */
+    bool hasNext() const;
+
+    /**
+     * Get the current component.
+     *
+     * @return Pointer to the first character of the component inside the path
+     */
+    const char * current() const;
+
+    /**
+     * Get the length of the current component.
+     *
+     * @return Length in bytes
+     */
+    Size length() const;
+
+    /**
+     * Get the hash of the current component.
+     *
+     * @return FNV hash value
+     */
+    u32 hash() const;
+
+    /**
+     * Compute the hash of a component.
+     *
+     * @param component Characters of the component
+     * @param length Length of the component in bytes
+     *
+     * @return FNV hash value
+     */
+    static u32 hash(const char *component, const Size length);
+
+  private:
+
+    /**
+     * Get the position of the next component.
+     *
+     * @param position Position to start searching
+     *
+     * @return Position of the next non-separator character or m_end
+     */
+    Size skipSeparators(Size position) const;
+
+  private:
+
+    /** Input path */
+    const char *m_path;
+
+    /** Position after the last character of the path */
+    Size m_end;
+
+    /** Separator character */
+    const char m_separator;
+
+    /** Position of the current component */
+    Size m_position;
+
+    /** Length of the current component */
+    Size m_length;
+
+    /** Hash of the current component */
+    u32 m_hash;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBFS_FILESYSTEMPATHTOKENIZER_H */
@@ -18,7 +18,20 @@
 #include <MemoryBlock.h>
 #include "FileSystemRequest.h"
 
+FileSystemRequest::FileSystemRequest()
+    : m_timestamp(0)
+    , m_next(ZERO)
+{
+}
+
 FileSystemRequest::FileSystemRequest(FileSystemMessage *msg)
+    : m_timestamp(0)
+    , m_next(ZERO)
+{
+    setMessage(msg);
+}
+
+void FileSystemRequest::setMessage(FileSystemMessage *msg)
 {
     MemoryBlock::copy(&m_msg, msg, sizeof(m_msg));
     m_ioBuffer.setMessage(&m_msg);
@@ -33,3 +46,13 @@ IOBuffer & FileSystemRequest::getBuffer()
 {
     return m_ioBuffer;
 }
+
+u64 FileSystemRequest::getTimestamp() const
+{
+    return m_timestamp;
+}
+
+void FileSystemRequest::setTimestamp(const u64 timestamp)
+{
+    m_timestamp = timestamp;
+}
@@ -18,6 +18,7 @@
 #ifndef __FILESYSTEM_FILE_SYSTEM_REQUEST_H
 #define __FILESYSTEM_FILE_SYSTEM_REQUEST_H
 
+#include <IntrusiveList.h>
 #include "FileSystemMessage.h"
 #include "IOBuffer.h"
 
@@ -36,11 +37,25 @@ class FileSystemRequest
 {
   public:
 
+    /**
+     * Default constructor
+     */
+    FileSystemRequest();
+
     /**
      * Constructor
      */
     FileSystemRequest(FileSystemMessage *msg);
 
+    /**
+     * Set message.
+     *
+     * Copies the message and prepares the IOBuffer for it.
+     *
+     * @param msg FileSystemMessage pointer
+     */
+    void setMessage(FileSystemMessage *msg);
+
     /**
      * Get message.
      *
@@ -55,6 +70,25 @@ class FileSystemRequest
      */
     IOBuffer & getBuffer();
 
+    /**
+     * Get the time at which the request was received.
+     *
+     * @return Timestamp in cycles
+     */
+    u64 getTimestamp() const;
+
+    /**
+     * Set the time at which the request was received.
+     *
+     * @param timestamp Timestamp in cycles
+     */
+    void setTimestamp(const u64 timestamp);
+
+  public:
+
+    /** Links the request into a list of ongoing requests. */
+    ListHook<FileSystemRequest> hook;
+
   private:
 
     /** Message that was received */
@@ -62,6 +96,14 @@ class FileSystemRequest
 
     /** Wrapper for doing I/O on the FileSystemMessage buffer. */
     IOBuffer m_ioBuffer;
+
+    /** Time at which the request was received. */
+    u64 m_timestamp;
+
+    /** Next free request, when owned by a FileSystemRequestPool. */
+    FileSystemRequest *m_next;
+
+    friend class FileSystemRequestPool;
 };
 
 /**
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include <Assert.h>
+#include "FileSystemRequestPool.h"
+
+FileSystemRequestPool::FileSystemRequestPool()
+    : m_free(ZERO)
+    , m_count(0)
+    , m_highWaterMark(0)
+{
+    m_memory = new u8[(MaximumRequests + 1) * PAGESIZE];
+    assert(m_memory != NULL);
+
+    // Align the I/O buffers on a page boundary
+    u8 *buffers = (u8 *) (((Address) m_memory + PAGESIZE - 1) & ~((Address) PAGESIZE - 1));
+
+    for (Size i = MaximumRequests; i > 0; i--)
+    {
+        FileSystemRequest *req = &m_requests[i - 1];
+
+        req->getBuffer().setStorage(buffers + ((i - 1) * PAGESIZE), PAGESIZE);
+        req->m_next = m_free;
+        m_free = req;
+    }
+}
+
+FileSystemRequestPool::~FileSystemRequestPool()
+{
+    delete[] m_memory;
+}
+
+FileSystemRequest * FileSystemRequestPool::allocate(FileSystemMessage *msg)
+{
+    FileSystemRequest *req = m_free;
+
+    if (req != ZERO)
+    {
+        m_free = req->m_next;
+        req->m_next = ZERO;
+        req->setMessage(msg);
+    }
+    else
+    {
+        req = new FileSystemRequest(msg);
+        assert(req != NULL);
+    }
+
+    if (++m_count > m_highWaterMark)
+    {
+        m_highWaterMark = m_count;
+    }
+
+    return req;
+}
+
+void FileSystemRequestPool::release(FileSystemRequest *req)
+{
+    assert(m_count > 0);
+    m_count--;
+
+    if (isPooled(req))
+    {
+        req->getBuffer().release();
+        req->m_next = m_free;
+        m_free = req;
+    }
+    else
+    {
+        delete req;
+    }
+}
+
+Size FileSystemRequestPool::getCount() const
+{
+    return m_count;
+}
+
+Size FileSystemRequestPool::getHighWaterMark() const
+{
+    return m_highWaterMark;
+}
+
+bool FileSystemRequestPool::isPooled(const FileSystemRequest *req) const
+{
+    return req >= &m_requests[0] && req < &m_requests[MaximumRequests];
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBFS_FILESYSTEMREQUESTPOOL_H
+#define __LIB_LIBFS_FILESYSTEMREQUESTPOOL_H
+
+#include <Types.h>
+#include "FileSystemRequest.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libfs
+ * @{
+ */
+
+/**
+ * Fixed-capacity pool of preallocated FileSystemRequests.
+ *
+ * Each request in the pool has a page-aligned I/O buffer of one page,
+ * such that buffered transfers of up to one page do not allocate memory.
+ * Free requests are kept in an intrusive list. When the pool is
+ * exhausted, requests are allocated from the heap instead.
+ */
+class FileSystemRequestPool
+{
+  public:
+
+    /** Number of preallocated requests */
+    static const Size MaximumRequests = 16;
+
+  public:
+
+    /**
+     * Constructor
+     */
+    FileSystemRequestPool();
+
+    /**
+     * Destructor
+     */
+    ~FileSystemRequestPool();
+
+    /**
+     * Get a request for the given message.
+     *
+     * @param msg FileSystemMessage pointer to copy into the request
+     *
+     * @return FileSystemRequest pointer
+     */
+    FileSystemRequest * allocate(FileSystemMessage *msg);
+
+    /**
+     * Return a request to the pool.
+     *
+     * @param req FileSystemRequest pointer returned by allocate()
+     */
+    void release(FileSystemRequest *req);
+
+    /**
+     * Get number of requests in use.
+     *
+     * @return Number of requests which are not yet released
+     */
+    Size getCount() const;
+
+    /**
+     * Get the high-water mark.
+     *
+     * @return Maximum number of requests in use at the same time
+     */
+    Size getHighWaterMark() const;
+
+  private:
+
+    /**
+     * Check if a request is part of the preallocated requests.
+     *
+     * @param req FileSystemRequest pointer
+     *
+     * @return True if preallocated, false if allocated from the heap
+     */
+    bool isPooled(const FileSystemRequest *req) const;
+
+  private:
+
+    /** Preallocated requests */
+    FileSystemRequest m_requests[MaximumRequests];
+
+    /** First free preallocated request */
+    FileSystemRequest *m_free;
+
+    /** Memory of the I/O buffers, including space for page alignment */
+    u8 *m_memory;
+
+    /** Number of requests in use */
+    Size m_count;
+
+    /** Maximum number of requests in use at the same time */
+    Size m_highWaterMark;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBFS_FILESYSTEMREQUESTPOOL_H */
@@ -22,9 +22,13 @@
 #include <HashIterator.h>
 #include <DatastoreClient.h>
 #include <KernelTimer.h>
+#include <ChannelClient.h>
 #include "FileSystemClient.h"
 #include "FileSystemMount.h"
+#include "FileSystemPathTokenizer.h"
 #include "FileSystemServer.h"
+#include "IOStatisticsFile.h"
+#include "IPCStatisticsFile.h"
 
 FileSystemServer::FileSystemServer(Directory *root, const char *path)
     : ChannelServer<FileSystemServer, FileSystemMessage>(this)
@@ -32,8 +36,15 @@ FileSystemServer::FileSystemServer(Directory *root, const char *path)
     , m_root(ZERO)
     , m_mountPath(path)
     , m_mounts(ZERO)
-    , m_requests(new List<FileSystemRequest *>())
+    , m_readyPool(ReadyPoolSize)
+    , m_readyFiles(&m_readyPool)
+    , m_notifyAll(false)
+    , m_readOnly(false)
+    , m_generation(0)
+    , m_readyCallback(this, &FileSystemServer::fileReady)
 {
+    MemoryBlock::set(m_dentries, 0, sizeof(m_dentries));
+    m_ioStats.reset();
     setRoot(root);
 
     // Register message handlers
@@ -42,17 +53,32 @@ FileSystemServer::FileSystemServer(Directory *root, const char *path)
     addIPCHandler(FileSystem::DeleteFile, &FileSystemServer::pathHandler, false);
     addIPCHandler(FileSystem::ReadFile,   &FileSystemServer::pathHandler, false);
     addIPCHandler(FileSystem::WriteFile,  &FileSystemServer::pathHandler, false);
+    addIPCHandler(FileSystem::ReadFileBulk,  &FileSystemServer::pathHandler, false);
+    addIPCHandler(FileSystem::WriteFileBulk, &FileSystemServer::pathHandler, false);
     addIPCHandler(FileSystem::WaitFile,   &FileSystemServer::pathHandler, false);
     addIPCHandler(FileSystem::MountFileSystem, &FileSystemServer::mountHandler);
     addIPCHandler(FileSystem::WaitFileSystem,  &FileSystemServer::pathHandler, false);
     addIPCHandler(FileSystem::GetFileSystems,  &FileSystemServer::getFileSystemsHandler);
+    addIPCHandler(FileSystem::ReadDirectory,     &FileSystemServer::pathHandler, false);
+    addIPCHandler(FileSystem::ReadDirectoryPlus, &FileSystemServer::pathHandler, false);
+    addIPCHandler(FileSystem::MapFile,           &FileSystemServer::pathHandler, false);
+    addIPCHandler(FileSystem::SpliceFile,        &FileSystemServer::pathHandler, false);
 }
 
 FileSystemServer::~FileSystemServer()
 {
-    if (m_requests)
+    while (!m_requests.isEmpty())
     {
-        delete m_requests;
+        m_pool.release(m_requests.pop());
+    }
+
+    for (HashIterator<u32, RequestList *> i(m_waiters); i.hasCurrent(); i++)
+    {
+        while (!i.current()->isEmpty())
+        {
+            m_pool.release(i.current()->pop());
+        }
+        delete i.current();
     }
 
     clearFileCache(m_root);
@@ -63,6 +89,11 @@ const char * FileSystemServer::getMountPath() const
     return m_mountPath;
 }
 
+void FileSystemServer::setReadOnly(const bool readOnly)
+{
+    m_readOnly = readOnly;
+}
+
 u32 FileSystemServer::getNextInode()
 {
     static u32 next = 2;
@@ -76,6 +107,12 @@ u32 FileSystemServer::getNextInode()
 
 FileSystem::Result FileSystemServer::mount()
 {
+    // Export request statistics under our own mount
+    if (registerIOStatistics() != FileSystem::Success)
+    {
+        ERROR("failed to register I/O statistics");
+    }
+
     // The rootfs server manages the mounts table. Retrieve it from the datastore.
     if (m_pid == ROOTFS_PID)
     {
@@ -90,6 +127,12 @@ FileSystem::Result FileSystemServer::mount()
 
         // Fill the mounts table
         MemoryBlock::set(m_mounts, 0, sizeof(FileSystemMount) * MaximumFileSystemMounts);
+
+        // Export our own message statistics next to those of other servers
+        if (registerStatistics(m_pid, m_stats) != FileSystem::Success)
+        {
+            ERROR("failed to register IPC statistics");
+        }
         return FileSystem::Success;
     }
     // Other file systems send a request to root file system to mount.
@@ -122,11 +165,12 @@ FileSystem::Result FileSystemServer::registerFile(File *file, const char *path)
     }
 
     // Also add to the parent directory
-    Directory *parent = getParentDirectory(path);
+    StringView base;
+    FileCache *parent = findParentCache(path, base);
     if (parent != ZERO)
     {
-        const FileSystemPath p(path);
-        parent->insert(file->getType(), *p.base());
+        const String name(base);
+        static_cast<Directory *>(parent->file)->insert(file->getType(), *name);
         return FileSystem::Success;
     }
     else
@@ -194,15 +238,81 @@ FileSystem::Result FileSystemServer::unregisterFile(const char *path)
 void FileSystemServer::pathHandler(FileSystemMessage *msg)
 {
     // Prepare request
-    FileSystemRequest req(msg);
+    FileSystemRequest *req = m_pool.allocate(msg);
+    req->setTimestamp(timestamp());
+    const bool inodeRequest = msg->action == FileSystem::ReadFile ||
+                              msg->action == FileSystem::WriteFile ||
+                              msg->action == FileSystem::ReadFileBulk ||
+                              msg->action == FileSystem::WriteFileBulk ||
+                              msg->action == FileSystem::MapFile ||
+                              msg->action == FileSystem::SpliceFile;
 
     // Process the request.
-    if (processRequest(req) == FileSystem::RetryAgain)
+    if (processRequest(*req) == FileSystem::RetryAgain)
     {
-        FileSystemRequest *reqCopy = new FileSystemRequest(msg);
-        assert(reqCopy != NULL);
-        m_requests->append(reqCopy);
+        if (inodeRequest)
+        {
+            waitForInode(req);
+        }
+        else
+        {
+            m_requests.append(req);
+        }
+        return;
     }
+
+    completeRequest(req, false);
+
+    // Completed I/O may unblock other requests for the same File
+    if (inodeRequest && m_waiters.contains(msg->inode))
+    {
+        notifyInode(msg->inode);
+    }
+}
+
+void FileSystemServer::completeRequest(FileSystemRequest *req, const bool retried)
+{
+    const FileSystemMessage *msg = req->getMessage();
+
+    m_ioStats.record(msg->action, msg->result, msg->size,
+                     timestamp() - req->getTimestamp(), retried);
+    m_pool.release(req);
+}
+
+void FileSystemServer::waitForInode(FileSystemRequest *req)
+{
+    const u32 inode = req->getMessage()->inode;
+    RequestList * const *lst = m_waiters.get(inode);
+
+    if (lst != ZERO)
+    {
+        (*lst)->append(req);
+    }
+    else
+    {
+        RequestList *waiters = new RequestList();
+        assert(waiters != NULL);
+        waiters->append(req);
+        m_waiters.insert(inode, waiters);
+    }
+}
+
+void FileSystemServer::fileReady(File *file)
+{
+    notifyInode(file->getInode());
+}
+
+void FileSystemServer::notifyInode(const u32 inode)
+{
+    if (!m_readyFiles.contains(inode))
+    {
+        m_readyFiles.append(inode);
+    }
+}
+
+void FileSystemServer::notifyAllFiles()
+{
+    m_notifyAll = true;
 }
 
 bool FileSystemServer::redirectRequest(const char *path, FileSystemMessage *msg)
@@ -246,6 +356,7 @@ bool FileSystemServer::redirectRequest(const char *path, FileSystemMessage *msg)
 FileSystem::Result FileSystemServer::inodeHandler(FileSystemRequest &req)
 {
     FileSystemMessage *msg = req.getMessage();
+    ProcessShares::MemoryShare share;
     File *file = ZERO;
 
     DEBUG(m_self << ": inode = " << msg->inode << " action = " << msg->action);
@@ -260,7 +371,38 @@ FileSystem::Result FileSystemServer::inodeHandler(FileSystemRequest &req)
     }
     file = (*f);
 
-    if (msg->action == FileSystem::ReadFile)
+    // Bulk transfers use the buffer shared by the remote process
+    if ((msg->action == FileSystem::ReadFileBulk || msg->action == FileSystem::WriteFileBulk) &&
+        req.getBuffer().getBuffer() == ZERO)
+    {
+        const Address offset = (Address) msg->buffer;
+        u8 *bulk = getBulkBuffer(msg->from);
+
+        if (bulk == ZERO || offset > FileSystem::BulkTransferSize ||
+            msg->size > FileSystem::BulkTransferSize - offset)
+        {
+            ERROR(m_self << ": invalid bulk transfer from PID " << msg->from);
+            msg->result = FileSystem::InvalidArgument;
+            sendResponse(msg);
+            return msg->result;
+        }
+        req.getBuffer().setSharedBuffer(bulk + offset);
+    }
+    // Mapped files are read into the memory shared by the remote process
+    else if (msg->action == FileSystem::MapFile)
+    {
+        if (!getMapShare(msg, share))
+        {
+            ERROR(m_self << ": invalid file mapping from PID " << msg->from);
+            msg->result = FileSystem::InvalidArgument;
+            sendResponse(msg);
+            return msg->result;
+        }
+        req.getBuffer().setSharedBuffer((u8 *) share.range.virt);
+    }
+
+    if (msg->action == FileSystem::ReadFile || msg->action == FileSystem::ReadFileBulk ||
+        msg->action == FileSystem::MapFile)
     {
         msg->result = file->read(req.getBuffer(), msg->size, msg->offset);
 
@@ -274,7 +416,7 @@ FileSystem::Result FileSystemServer::inodeHandler(FileSystemRequest &req)
 
         DEBUG(m_self << ": read = " << (int)msg->result);
     }
-    else if (msg->action == FileSystem::WriteFile)
+    else if (msg->action == FileSystem::WriteFile || msg->action == FileSystem::WriteFileBulk)
     {
         if (!req.getBuffer().getCount())
         {
@@ -284,6 +426,11 @@ FileSystem::Result FileSystemServer::inodeHandler(FileSystemRequest &req)
         msg->result = file->write(req.getBuffer(), msg->size, msg->offset);
         DEBUG(m_self << ": write = " << (int)msg->result);
     }
+    else if (msg->action == FileSystem::SpliceFile)
+    {
+        msg->result = spliceFile(req, file);
+        DEBUG(m_self << ": splice = " << (int)msg->result);
+    }
     else
     {
         msg->result = FileSystem::NotSupported;
@@ -292,6 +439,16 @@ FileSystem::Result FileSystemServer::inodeHandler(FileSystemRequest &req)
     // Only send reply if completed (not RetryAgain)
     if (msg->result != FileSystem::RetryAgain)
     {
+        // The remote process keeps the only mapping of the file contents
+        if (msg->action == FileSystem::MapFile)
+        {
+            const API::Result result = VMShare(msg->from, API::Delete, &share);
+            if (result != API::Success)
+            {
+                ERROR(m_self << ": failed to remove file mapping of PID " << msg->from <<
+                      ": result = " << (int) result);
+            }
+        }
         sendResponse(msg);
     }
 
@@ -363,11 +520,7 @@ FileSystem::Result FileSystemServer::waitFileHandler(FileSystemRequest &req)
         }
         else
         {
-            if (!m_expiry.frequency || m_expiry.ticks > msg->timeout.ticks)
-            {
-                m_expiry.ticks = msg->timeout.ticks;
-            }
-            m_expiry.frequency = msg->timeout.frequency;
+            setExpiry(msg->timeout);
         }
     }
 
@@ -380,6 +533,229 @@ FileSystem::Result FileSystemServer::waitFileHandler(FileSystemRequest &req)
     return msg->result;
 }
 
+FileSystem::Result FileSystemServer::readDirectory(FileSystemRequest &req, FileCache *cache)
+{
+    FileSystemMessage *msg = req.getMessage();
+    static u8 records[FileSystem::DirectoryBufferSize];
+    static Dirent entries[MaximumDirectoryEntries];
+    const bool withStat = msg->action == FileSystem::ReadDirectoryPlus;
+    const Size size = msg->size < sizeof(records) ? msg->size : sizeof(records);
+    Size bytes = 0, index = msg->offset;
+    bool full = false, end = false;
+
+    if (cache->file->getType() != FileSystem::DirectoryFile)
+    {
+        return FileSystem::NotSupported;
+    }
+    Directory *dir = (Directory *) cache->file;
+
+    // Pack entries until the buffer is full
+    while (!full && !end)
+    {
+        Size count = MaximumDirectoryEntries;
+
+        const FileSystem::Result result = dir->getEntries(entries, count, index);
+        if (result != FileSystem::Success)
+        {
+            return result;
+        }
+        end = count < MaximumDirectoryEntries;
+
+        for (Size i = 0; i < count; i++)
+        {
+            const Size nameLength = String::length(entries[i].name);
+            FileCache *child = ZERO;
+            FileSystem::FileStat st;
+
+            // Retrieve the status of the entry, if requested
+            if (withStat)
+            {
+                const u32 nameHash = FileSystemPathTokenizer::hash(entries[i].name, nameLength);
+
+                if (nameLength == 1 && entries[i].name[0] == '.')
+                    child = cache;
+                else if (nameLength == 2 && entries[i].name[0] == '.' && entries[i].name[1] == '.')
+                    child = cache->parent ? cache->parent : cache;
+                else
+                    child = lookupChild(cache, entries[i].name, nameLength, nameHash);
+
+                if (child != ZERO && child->file->status(st) == FileSystem::Success)
+                    st.pid = m_self;
+                else
+                    child = ZERO;
+            }
+
+            // Align each record to the next native word
+            const Size unaligned = sizeof(FileSystem::DirectoryRecord) +
+                                   (child ? sizeof(FileSystem::FileStat) : 0) + nameLength + 1;
+            const Size length = (unaligned + sizeof(Size) - 1) & ~(sizeof(Size) - 1);
+
+            if (bytes + length > size)
+            {
+                full = true;
+                break;
+            }
+
+            // Fill the record
+            FileSystem::DirectoryRecord *record = (FileSystem::DirectoryRecord *) (records + bytes);
+            u8 *field = (u8 *) (record + 1);
+            record->length     = length;
+            record->nameLength = nameLength;
+            record->type       = entries[i].type;
+            record->flags      = ZERO;
+
+            if (child != ZERO)
+            {
+                record->flags |= FileSystem::RecordStat;
+                MemoryBlock::copy(field, &st, sizeof(st));
+                field += sizeof(st);
+            }
+            MemoryBlock::copy(field, entries[i].name, nameLength + 1);
+
+            bytes += length;
+            index++;
+        }
+    }
+
+    // The buffer must fit at least one entry
+    if (bytes == 0 && full)
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    // Copy the records to the remote process
+    if (bytes != 0)
+    {
+        const FileSystem::Result result = req.getBuffer().write(records, bytes, 0);
+        if (result != FileSystem::Success)
+        {
+            return result;
+        }
+    }
+
+    msg->size   = bytes;
+    msg->offset = full ? index : ZERO;
+    return FileSystem::Success;
+}
+
+FileSystem::Result FileSystemServer::spliceFile(FileSystemRequest &req, File *file)
+{
+    static FileSystemMessage writes[MaximumSpliceWrites];
+    static Size sizes[MaximumSpliceWrites];
+    FileSystemMessage *msg = req.getMessage();
+    FileSystem::SpliceInfo info;
+    FileSystem::Result result = FileSystem::Success;
+    Size total = 0;
+    bool more = true;
+
+    // Copy the description of the target file
+    const API::Result copyResult = VMCopy(msg->from, API::Read, (Address) &info,
+                                         (Address) msg->buffer, sizeof(info));
+    if (copyResult != API::Success)
+    {
+        ERROR("VMCopy failed for SpliceInfo: result = " << (int) copyResult <<
+              " from = " << msg->from);
+        return FileSystem::IOError;
+    }
+
+    // Both this file system and the requesting process wait for the target
+    if (info.pid == m_pid || info.pid == msg->from ||
+        info.headerSize > FileSystem::SpliceHeaderSize ||
+        info.chunkSize > FileSystem::BulkTransferSize - info.headerSize)
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    // Each write uses a separate slot in the bulk buffer
+    const Size chunk = info.chunkSize ? info.chunkSize : FileSystem::BulkTransferSize - info.headerSize;
+    const Size slotSize = info.headerSize + chunk;
+    const Size slots = FileSystem::BulkTransferSize / slotSize < MaximumSpliceWrites ?
+                       FileSystem::BulkTransferSize / slotSize : MaximumSpliceWrites;
+    const FileSystemClient target(info.pid);
+    u8 *bulk = target.getBulkBuffer(info.pid);
+
+    if (bulk == ZERO)
+    {
+        return FileSystem::NotSupported;
+    }
+
+    while (more && total < msg->size)
+    {
+        Size count = 0, queued = 0;
+
+        // Read as many chunks as fit in the bulk buffer
+        while (count < slots && total + queued < msg->size)
+        {
+            u8 *slot = bulk + (count * slotSize);
+            const Size wanted = msg->size - total - queued < chunk ? msg->size - total - queued : chunk;
+            Size bytes = wanted;
+
+            req.getBuffer().setSharedBuffer(slot + info.headerSize);
+            result = file->read(req.getBuffer(), bytes, msg->offset + total + queued);
+            if (result != FileSystem::Success || bytes == 0)
+            {
+                more = false;
+                break;
+            }
+            MemoryBlock::copy(slot, info.header, info.headerSize);
+
+            writes[count].type   = ChannelMessage::Request;
+            writes[count].action = FileSystem::WriteFileBulk;
+            writes[count].inode  = info.inode;
+            writes[count].buffer = (char *) (Address) (count * slotSize);
+            writes[count].size   = info.headerSize + bytes;
+            writes[count].offset = info.offset + total + queued;
+            sizes[count] = bytes;
+            queued += bytes;
+            count++;
+
+            // Short reads indicate end-of-file
+            if (bytes < wanted)
+            {
+                more = false;
+                break;
+            }
+        }
+
+        if (count == 0)
+        {
+            break;
+        }
+
+        // Write all chunks to the target file at once
+        const ChannelClient::Result ipcResult =
+            ChannelClient::instance()->syncSendReceiveBatch(writes, count, sizeof(FileSystemMessage), info.pid);
+        if (ipcResult != ChannelClient::Success)
+        {
+            ERROR("failed to splice to PID " << info.pid << ": result = " << (int) ipcResult);
+            result = FileSystem::IpcError;
+            break;
+        }
+
+        // Only count the chunks written before any failure
+        for (Size i = 0; i < count; i++)
+        {
+            if (writes[i].result != FileSystem::Success)
+            {
+                result = writes[i].result;
+                more = false;
+                break;
+            }
+            total += sizes[i];
+        }
+    }
+
+    // Report bytes which are spliced before any failure
+    msg->size = total;
+
+    if (total > 0 || result == FileSystem::Success)
+    {
+        return FileSystem::Success;
+    }
+
+    return result;
+}
+
 FileSystem::Result FileSystemServer::processRequest(FileSystemRequest &req)
 {
     char buf[FileSystemPath::MaximumLength];
@@ -388,8 +764,20 @@ FileSystem::Result FileSystemServer::processRequest(FileSystemRequest &req)
     FileSystemMessage *msg = req.getMessage();
     FileSystem::FileStat st;
 
+    // Modifications are refused in read-only mode
+    if (m_readOnly &&
+       (msg->action == FileSystem::CreateFile || msg->action == FileSystem::DeleteFile ||
+        msg->action == FileSystem::WriteFile  || msg->action == FileSystem::WriteFileBulk))
+    {
+        msg->result = FileSystem::PermissionDenied;
+        sendResponse(msg);
+        return msg->result;
+    }
+
     // Retrieve file by inode or by file path?
-    if (msg->action == FileSystem::ReadFile || msg->action == FileSystem::WriteFile)
+    if (msg->action == FileSystem::ReadFile || msg->action == FileSystem::WriteFile ||
+        msg->action == FileSystem::ReadFileBulk || msg->action == FileSystem::WriteFileBulk ||
+        msg->action == FileSystem::MapFile || msg->action == FileSystem::SpliceFile)
     {
         return inodeHandler(req);
     }
@@ -418,11 +806,16 @@ FileSystem::Result FileSystemServer::processRequest(FileSystemRequest &req)
         return msg->result;
     }
 
-    const FileSystemPath path(buf + String::length(m_mountPath));
+    const Size mountLength = String::length(m_mountPath);
+    const char *path = buf + mountLength;
 
     // Do we have this file cached?
-    if ((cache = findFileCache(path)) ||
-        (cache = lookupFile(path)))
+    if ((cache = findFileCache(path, FileSystemPath::MaximumLength - mountLength)))
+    {
+        file = cache->file;
+        m_ioStats.cacheHits++;
+    }
+    else if ((cache = lookupFile(path, FileSystemPath::MaximumLength - mountLength)))
     {
         file = cache->file;
     }
@@ -467,7 +860,7 @@ FileSystem::Result FileSystemServer::processRequest(FileSystemRequest &req)
                     }
                     else
                     {
-                        msg->result = registerFile(file, *path.full());
+                        msg->result = registerFile(file, path);
                     }
                 }
             }
@@ -475,7 +868,7 @@ FileSystem::Result FileSystemServer::processRequest(FileSystemRequest &req)
             break;
 
         case FileSystem::DeleteFile:
-            msg->result = unregisterFile(*path.full());
+            msg->result = unregisterFile(path);
             DEBUG(m_self << ": delete = " << (int)msg->result);
             break;
 
@@ -504,8 +897,18 @@ FileSystem::Result FileSystemServer::processRequest(FileSystemRequest &req)
             DEBUG(m_self << ": stat = " << (int)msg->result);
             break;
 
+        case FileSystem::ReadDirectory:
+        case FileSystem::ReadDirectoryPlus:
+            msg->result = readDirectory(req, cache);
+            DEBUG(m_self << ": readdir = " << (int)msg->result);
+            break;
+
         case FileSystem::ReadFile:
         case FileSystem::WriteFile:
+        case FileSystem::ReadFileBulk:
+        case FileSystem::WriteFileBulk:
+        case FileSystem::MapFile:
+        case FileSystem::SpliceFile:
         case FileSystem::WaitFile:
             break;
 
@@ -533,10 +936,28 @@ FileSystem::Result FileSystemServer::processRequest(FileSystemRequest &req)
     return msg->result;
 }
 
-void FileSystemServer::sendResponse(FileSystemMessage *msg) const
+void FileSystemServer::sendResponse(FileSystemMessage *msg)
 {
     msg->type = ChannelMessage::Response;
 
+    // Let clients drop cached file status after changes
+    if (msg->result == FileSystem::Success)
+    {
+        switch (msg->action)
+        {
+            case FileSystem::CreateFile:
+            case FileSystem::DeleteFile:
+            case FileSystem::WriteFile:
+            case FileSystem::WriteFileBulk:
+                m_generation++;
+                break;
+
+            default:
+                break;
+        }
+    }
+    msg->generation = m_generation;
+
     DEBUG(m_self << ": sending response to PID " << msg->from <<
                     " for action = " << (int) msg->action <<
                     " with result = " << (int) msg->result);
@@ -562,6 +983,9 @@ void FileSystemServer::mountHandler(FileSystemMessage *msg)
 {
     char buf[FileSystemPath::MaximumLength + 1];
 
+    // The reply is sent by the ChannelServer
+    msg->generation = m_generation;
+
     // Copy the file path
     const API::Result result = VMCopy(msg->from, API::Read, (Address) buf,
                                      (Address) msg->buffer, FileSystemPath::MaximumLength);
@@ -611,6 +1035,9 @@ void FileSystemServer::mountHandler(FileSystemMessage *msg)
 
 void FileSystemServer::getFileSystemsHandler(FileSystemMessage *msg)
 {
+    // The reply is sent by the ChannelServer
+    msg->generation = m_generation;
+
     // Copy mounts table to the requesting process
     const Size mountsSize = sizeof(FileSystemMount) * MaximumFileSystemMounts;
     const Size numBytes = msg->size < mountsSize ? msg->size : mountsSize;
@@ -632,18 +1059,240 @@ bool FileSystemServer::retryRequests()
 
     DEBUG("");
 
-    for (ListIterator<FileSystemRequest *> i(m_requests); i.hasCurrent(); i++)
+    // Retry requests which do not wait for a specific File
+    for (FileSystemRequest *req = m_requests.head(), *next; req != ZERO; req = next)
     {
-        FileSystem::Result result = processRequest(*i.current());
+        next = m_requests.next(req);
+
+        FileSystem::Result result = processRequest(*req);
         if (result != FileSystem::RetryAgain)
         {
-            delete i.current();
-            i.remove();
+            m_requests.remove(req);
+            completeRequest(req, true);
             restartNeeded = true;
         }
     }
 
-    return restartNeeded;
+    if (m_notifyAll)
+    {
+        m_notifyAll = false;
+
+        for (HashIterator<u32, RequestList *> i(m_waiters); i.hasCurrent(); i++)
+        {
+            notifyInode(i.key());
+        }
+    }
+
+    // Retry only the requests of Files which may have become ready.
+    // Files which become ready again meanwhile are handled by the next retry.
+    for (Size count = m_readyFiles.count(); count > 0; count--)
+    {
+        const u32 inode = m_readyFiles.first();
+        m_readyFiles.remove(m_readyFiles.head());
+
+        RequestList * const *lst = m_waiters.get(inode);
+        if (lst == ZERO)
+        {
+            continue;
+        }
+        RequestList *waiters = *lst;
+        bool completed = false;
+
+        for (FileSystemRequest *req = waiters->head(), *next; req != ZERO; req = next)
+        {
+            next = waiters->next(req);
+
+            FileSystem::Result result = processRequest(*req);
+            if (result != FileSystem::RetryAgain)
+            {
+                waiters->remove(req);
+                completeRequest(req, true);
+                completed = true;
+            }
+        }
+
+        if (waiters->count() == 0)
+        {
+            m_waiters.remove(inode);
+            delete waiters;
+        }
+        // Completed I/O may unblock the remaining requests for the same File
+        else if (completed)
+        {
+            notifyInode(inode);
+        }
+    }
+
+    return restartNeeded || m_readyFiles.count() != 0 || m_notifyAll;
+}
+
+void FileSystemServer::onProcessTerminated(const ProcessID pid)
+{
+    DEBUG("pid = " << pid);
+
+    // Shared memory of the process is already removed by the ChannelServer
+    m_bulkBuffers.remove(pid);
+
+    // Drop pending requests of the process
+    dropRequests(m_requests, pid);
+
+    for (HashIterator<u32, RequestList *> i(m_waiters); i.hasCurrent(); )
+    {
+        RequestList *waiters = i.current();
+
+        dropRequests(*waiters, pid);
+
+        if (waiters->count() == 0)
+        {
+            delete waiters;
+            i.remove();
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    // Remove exported statistics, the shared memory is already unmapped
+    if (m_pid == ROOTFS_PID)
+    {
+        String path;
+        path << "sys/ipc/" << (uint) pid;
+        unregisterFile(*path);
+    }
+}
+
+void FileSystemServer::dropRequests(RequestList & list, const ProcessID pid)
+{
+    for (FileSystemRequest *req = list.head(), *next; req != ZERO; req = next)
+    {
+        next = list.next(req);
+
+        if (req->getMessage()->from == pid)
+        {
+            list.remove(req);
+            m_pool.release(req);
+        }
+    }
+}
+
+void FileSystemServer::onShareCreated(const ProcessShares::MemoryShare & share)
+{
+    if (m_pid == ROOTFS_PID && share.tagId == IPCStatistics::ShareTag &&
+        share.range.size >= sizeof(IPCStatistics))
+    {
+        const FileSystem::Result result =
+            registerStatistics(share.pid, (const IPCStatistics *) share.range.virt);
+
+        if (result != FileSystem::Success)
+        {
+            ERROR("failed to register IPC statistics of PID " << share.pid <<
+                  ": result = " << (int) result);
+        }
+    }
+}
+
+FileSystem::Result FileSystemServer::registerStatistics(const ProcessID pid,
+                                                        const IPCStatistics *stats)
+{
+    const char *dirs[] = { "sys", "sys/ipc" };
+    String path;
+
+    // Create the directories on first use
+    for (Size i = 0; i < sizeof(dirs) / sizeof(dirs[0]); i++)
+    {
+        if (findFileCache(dirs[i]) == ZERO)
+        {
+            Directory *dir = new Directory(getNextInode());
+            assert(dir != NULL);
+
+            const FileSystem::Result result = registerDirectory(dir, dirs[i]);
+            if (result != FileSystem::Success)
+            {
+                return result;
+            }
+        }
+    }
+
+    // Replace statistics of a previous instance
+    path << "sys/ipc/" << (uint) pid;
+    unregisterFile(*path);
+
+    return registerFile(new IPCStatisticsFile(getNextInode(), stats), *path);
+}
+
+FileSystem::Result FileSystemServer::registerIOStatistics()
+{
+    // Create the directory on first use
+    if (findFileCache("sys") == ZERO)
+    {
+        Directory *dir = new Directory(getNextInode());
+        assert(dir != NULL);
+
+        const FileSystem::Result result = registerDirectory(dir, "sys");
+        if (result != FileSystem::Success)
+        {
+            return result;
+        }
+    }
+
+    return registerFile(new IOStatisticsFile(getNextInode(), &m_ioStats), "sys/iostat");
+}
+
+u8 * FileSystemServer::getBulkBuffer(const ProcessID pid)
+{
+    u8 * const *cached = m_bulkBuffers.get(pid);
+    if (cached != ZERO)
+    {
+        return *cached;
+    }
+
+    const SystemInformation info;
+    ProcessShares::MemoryShare share;
+    share.pid    = pid;
+    share.coreId = info.coreId;
+    share.tagId  = FileSystem::BulkShareTag;
+
+    const API::Result result = VMShare(SELF, API::Read, &share);
+    if (result != API::Success)
+    {
+        ERROR("failed to read bulk buffer share for PID " << pid << ": result = " << (int) result);
+        return ZERO;
+    }
+
+    if (share.range.size < FileSystem::BulkTransferSize)
+    {
+        ERROR("bulk buffer share of PID " << pid << " is too small: size = " << share.range.size);
+        return ZERO;
+    }
+
+    u8 *bulk = (u8 *) share.range.virt;
+    m_bulkBuffers.insert(pid, bulk);
+    return bulk;
+}
+
+bool FileSystemServer::getMapShare(const FileSystemMessage *msg,
+                                   ProcessShares::MemoryShare & share) const
+{
+    const SystemInformation info;
+    share.pid    = msg->from;
+    share.coreId = info.coreId;
+    share.tagId  = (Address) msg->buffer;
+
+    if (share.tagId < FileSystem::MapShareTag ||
+        share.tagId >= FileSystem::MapShareTag + FileSystem::MaximumFileMappings)
+    {
+        return false;
+    }
+
+    const API::Result result = VMShare(SELF, API::Read, &share);
+    if (result != API::Success)
+    {
+        ERROR("failed to read file mapping share for PID " << msg->from << ": result = " << (int) result);
+        return false;
+    }
+
+    return msg->offset == 0 && msg->size <= share.range.size;
 }
 
 void FileSystemServer::setRoot(Directory *newRoot)
@@ -658,87 +1307,106 @@ void FileSystemServer::setRoot(Directory *newRoot)
 
 Directory * FileSystemServer::getParentDirectory(const char *path)
 {
-    const FileSystemPath p(path);
-    Directory *parent = ZERO;
+    StringView base;
+    FileCache *cache = findParentCache(path, base);
+
+    return cache != ZERO ? static_cast<Directory *>(cache->file) : ZERO;
+}
+
+FileCache * FileSystemServer::findParentCache(const char *path, StringView & base) const
+{
+    FileSystemPathTokenizer tokens(path, String::length(path));
 
-    if (p.parent().length() > 0)
+    // Find the last component, which refers into the path
+    base = StringView(path, 0);
+
+    while (tokens.next())
     {
-        FileCache *cache = findFileCache(*p.parent());
-        if (cache != ZERO)
-        {
-            parent = static_cast<Directory *>(cache->file);
-        }
+        base = StringView(tokens.current(), tokens.length());
     }
-    else
+
+    // The parent is everything before it, which is the root for an empty path
+    return findFileCache(path, base.data() - path);
+}
+
+FileCache * FileSystemServer::lookupFile(const char *path, const Size maximumLength)
+{
+    FileSystemPathTokenizer tokens(path, maximumLength);
+    FileCache *c = m_root;
+
+    // Loop the entire path
+    while (tokens.next() && c != ZERO)
     {
-        parent = static_cast<Directory *>(m_root->file);
+        c = lookupChild(c, tokens.current(), tokens.length(), tokens.hash());
     }
 
-    return parent;
+    // All done
+    return c;
 }
 
-FileCache * FileSystemServer::lookupFile(const FileSystemPath &path)
+FileCache * FileSystemServer::lookupChild(FileCache *parent,
+                                          const char *name,
+                                          const Size length,
+                                          const u32 nameHash)
 {
-    const List<String> &entries = path.split();
-    FileCache *c = m_root;
+    char entryName[FileSystemPath::MaximumLength + 1];
+    FileCache *entry = lookupDentry(parent, name, length, nameHash);
     File *file = ZERO;
     Directory *dir;
 
-    // Loop the entire path
-    for (ListIterator<String> i(entries); i.hasCurrent(); i++)
+    // Do we have this entry cached already?
+    if (entry != ZERO)
     {
-        // Do we have this entry cached already?
-        if (!c->entries.contains(i.current()))
-        {
-            // If this isn't a directory, we cannot perform a lookup
-            if (c->file->getType() != FileSystem::DirectoryFile)
-            {
-                return ZERO;
-            }
-            dir = (Directory *) c->file;
+        return entry;
+    }
 
-            // Fetch the file, if possible
-            if (!(file = dir->lookup(*i.current())))
-            {
-                return ZERO;
-            }
-            // Insert into the FileCache
-            c = new FileCache(file, *i.current(), c);
-            assert(c != NULL);
+    // If this isn't a directory, we cannot perform a lookup
+    if (parent->file->getType() != FileSystem::DirectoryFile || length > FileSystemPath::MaximumLength)
+    {
+        return ZERO;
+    }
+    dir = (Directory *) parent->file;
 
-            // Add file to the inode map
-            if (!m_inodeMap.insert(file->getInode(), file))
-            {
-                return ZERO;
-            }
-        }
-        // Move to the next entry
-        else if (c != ZERO)
-        {
-            c = (FileCache *) c->entries.value(i.current());
-        }
-        else
-        {
-            break;
-        }
+    // Answer repeated misses from memory
+    if (m_negative.contains(parent, name, length, nameHash))
+    {
+        m_ioStats.negativeHits++;
+        return ZERO;
     }
 
+    // Null-terminate the entry name
+    MemoryBlock::copy((void *) entryName, name, length);
+    entryName[length] = ZERO;
 
-    // All done
-    return c;
+    // Fetch the file, if possible
+    m_ioStats.lookups++;
+
+    if (!(file = dir->lookup(entryName)))
+    {
+        m_negative.insert(parent, name, length, nameHash);
+        return ZERO;
+    }
+    // Insert into the FileCache
+    entry = new FileCache(file, entryName, parent);
+    assert(entry != NULL);
+    insertDentry(entry);
+
+    // Add file to the inode map
+    if (!m_inodeMap.insert(file->getInode(), file))
+    {
+        return ZERO;
+    }
+    file->setReadyCallback(&m_readyCallback);
+    return entry;
 }
 
 FileCache * FileSystemServer::insertFileCache(File *file, const char *pathStr)
 {
-    const FileSystemPath path(pathStr);
-    FileCache *parent = ZERO;
+    StringView base;
 
     // Lookup our parent
-    if (path.parent().length() == 0)
-    {
-        parent = m_root;
-    }
-    else if (!(parent = findFileCache(path.parent())))
+    FileCache *parent = findParentCache(pathStr, base);
+    if (parent == ZERO)
     {
         return ZERO;
     }
@@ -748,17 +1416,28 @@ FileCache * FileSystemServer::insertFileCache(File *file, const char *pathStr)
     {
         return ZERO;
     }
+    file->setReadyCallback(&m_readyCallback);
 
     // Create new cache
-    FileCache *c = new FileCache(file, *path.base(), parent);
+    FileCache *c = new FileCache(file, base, parent);
     assert(c != NULL);
+    insertDentry(c);
     return c;
 }
 
-FileCache * FileSystemServer::findFileCache(const char *path) const
+FileCache * FileSystemServer::findFileCache(const char *path, const Size maximumLength) const
 {
-    const FileSystemPath p(path);
-    return findFileCache(p);
+    FileSystemPathTokenizer tokens(path, maximumLength);
+    FileCache *c = m_root;
+
+    // Loop the entire path, the root is found for an empty path
+    while (c != ZERO && tokens.next())
+    {
+        c = lookupDentry(c, tokens.current(), tokens.length(), tokens.hash());
+    }
+
+    // Return what we got
+    return c;
 }
 
 FileCache * FileSystemServer::findFileCache(const String &path) const
@@ -768,27 +1447,69 @@ FileCache * FileSystemServer::findFileCache(const String &path) const
 
 FileCache * FileSystemServer::findFileCache(const FileSystemPath &path) const
 {
-    const List<String> &entries = path.split();
-    FileCache *c = m_root;
+    return findFileCache(*path.full());
+}
 
-    // Root is treated special
-    if (path.parent().length() == 0 && path.length() == 0)
+FileCache * FileSystemServer::lookupDentry(const FileCache *parent,
+                                           const char *name,
+                                           const Size length,
+                                           const u32 nameHash) const
+{
+    for (FileCache *c = m_dentries[getDentryBucket(parent, nameHash)]; c != ZERO; c = c->hashNext)
     {
-        return m_root;
+        if (c->parent == parent && c->nameHash == nameHash &&
+            c->name.length() == length && MemoryBlock::compare(*c->name, name, length))
+        {
+            return c;
+        }
     }
 
-    // Loop the entire path
-    for (ListIterator<String> i(entries); i.hasCurrent(); i++)
+    return ZERO;
+}
+
+void FileSystemServer::insertDentry(FileCache *cache)
+{
+    assert(cache->parent != ZERO);
+
+    cache->nameHash = FileSystemPathTokenizer::hash(*cache->name, cache->name.length());
+
+    // The name exists from now on
+    m_negative.invalidate(cache->parent, *cache->name, cache->name.length(), cache->nameHash);
+
+    // The parent entries table also replaces an entry with the same name
+    FileCache *previous = lookupDentry(cache->parent, *cache->name,
+                                       cache->name.length(), cache->nameHash);
+    if (previous != ZERO)
+    {
+        removeDentry(previous);
+    }
+
+    const Size bucket = getDentryBucket(cache->parent, cache->nameHash);
+    cache->hashNext = m_dentries[bucket];
+    m_dentries[bucket] = cache;
+}
+
+void FileSystemServer::removeDentry(FileCache *cache)
+{
+    if (cache->parent == ZERO)
     {
-        if (!c->entries.contains(i.current()))
+        return;
+    }
+
+    for (FileCache **c = &m_dentries[getDentryBucket(cache->parent, cache->nameHash)]; *c != ZERO; c = &(*c)->hashNext)
+    {
+        if (*c == cache)
         {
-            return ZERO;
+            *c = cache->hashNext;
+            cache->hashNext = ZERO;
+            return;
         }
-        c = (FileCache *) c->entries.value(i.current());
     }
+}
 
-    // Return what we got
-    return c;
+Size FileSystemServer::getDentryBucket(const FileCache *parent, const u32 nameHash) const
+{
+    return (nameHash ^ (u32) (((Address) parent) >> 4)) % DentryHashSize;
 }
 
 void FileSystemServer::removeFileFromCache(FileCache *cache, File *file)
@@ -854,7 +1575,16 @@ void FileSystemServer::clearFileCache(FileCache *cache)
         }
 
         m_inodeMap.remove(cache->file->getInode());
+
+        // Waiting requests complete with NotFound on the next retry
+        if (m_waiters.contains(cache->file->getInode()))
+        {
+            notifyInode(cache->file->getInode());
+        }
         delete cache->file;
     }
+    // Missing entries of a removed directory must not match a new FileCache at the same address
+    m_negative.invalidate(cache);
+    removeDentry(cache);
     delete cache;
 }
@@ -28,7 +28,10 @@
 #include "FileSystemPath.h"
 #include "FileSystemMessage.h"
 #include "FileSystemRequest.h"
+#include "FileSystemRequestPool.h"
 #include "FileSystemMount.h"
+#include "NegativeLookupCache.h"
+#include "IOStatistics.h"
 
 /**
  * @addtogroup lib
@@ -51,6 +54,21 @@ class FileSystemServer : public ChannelServer<FileSystemServer, FileSystemMessag
     /** Maximum number of WaitSet entries supported */
     static const Size MaximumWaitSetCount = 32;
 
+    /** Number of buckets in the dentry hash */
+    static const Size DentryHashSize = 256;
+
+    /** Number of directory entries retrieved at once for ReadDirectory */
+    static const Size MaximumDirectoryEntries = 16;
+
+    /** Maximum number of writes to the target file sent at once by SpliceFile */
+    static const Size MaximumSpliceWrites = 64;
+
+    /** Number of preallocated nodes for the list of ready Files */
+    static const Size ReadyPoolSize = 32;
+
+    /** Ongoing requests, linked through their own hook */
+    typedef IntrusiveList<FileSystemRequest, &FileSystemRequest::hook> RequestList;
+
   public:
 
     /**
@@ -73,12 +91,22 @@ class FileSystemServer : public ChannelServer<FileSystemServer, FileSystemMessag
      */
     const char * getMountPath() const;
 
+    /**
+     * Set read-only mode
+     *
+     * A read-only file system refuses requests which create,
+     * delete or write files with FileSystem::PermissionDenied.
+     *
+     * @param readOnly True to refuse modifications
+     */
+    void setReadOnly(const bool readOnly);
+
     /**
      * Get next unused inode
      *
      * @return Inode number
      */
-    u32 getNextInode();
+    virtual u32 getNextInode();
 
     /**
      * Mount the FileSystem.
@@ -158,12 +186,56 @@ class FileSystemServer : public ChannelServer<FileSystemServer, FileSystemMessag
     /**
      * Retry any pending requests
      *
+     * Requests for a File specified by its inode are only retried
+     * once the File signals that it may have become ready.
+     *
      * @return True if retry is needed again, false if all requests processed
      */
     virtual bool retryRequests();
 
+    /**
+     * Signal that all Files may have become readable or writable.
+     *
+     * Used for state changes which may unblock requests of any File,
+     * such that all waiting requests are retried once.
+     */
+    void notifyAllFiles();
+
+    /**
+     * Called whenever another Process is terminated
+     *
+     * @param pid ProcessID of the terminating process
+     */
+    virtual void onProcessTerminated(const ProcessID pid);
+
+    /**
+     * Called when another Process creates an application specific memory share
+     *
+     * The root file system exports shared IPCStatistics as /sys/ipc/<pid>.
+     *
+     * @param share Memory share with a non-zero tag
+     */
+    virtual void onShareCreated(const ProcessShares::MemoryShare & share);
+
   protected:
 
+    /**
+     * Export the IPCStatistics of a server as sys/ipc/<pid>.
+     *
+     * @param pid ProcessID of the server
+     * @param stats Statistics of the server
+     *
+     * @return Result code
+     */
+    FileSystem::Result registerStatistics(const ProcessID pid, const IPCStatistics *stats);
+
+    /**
+     * Export the I/O statistics of this file system as sys/iostat.
+     *
+     * @return Result code
+     */
+    FileSystem::Result registerIOStatistics();
+
     /**
      * Process a FileSystemRequest.
      *
@@ -172,6 +244,35 @@ class FileSystemServer : public ChannelServer<FileSystemServer, FileSystemMessag
      */
     FileSystem::Result processRequest(FileSystemRequest &req);
 
+    /**
+     * Called when a File may have become readable or writable.
+     *
+     * @param file File pointer
+     */
+    void fileReady(File *file);
+
+    /**
+     * Schedule the requests waiting for an inode to be retried.
+     *
+     * @param inode Inode number
+     */
+    void notifyInode(const u32 inode);
+
+    /**
+     * Park a request until its File becomes ready.
+     *
+     * @param req FileSystemRequest pointer for a File specified by its inode
+     */
+    void waitForInode(FileSystemRequest *req);
+
+    /**
+     * Release the requests of a process.
+     *
+     * @param list List of ongoing requests
+     * @param pid ProcessID of the terminated process
+     */
+    void dropRequests(RequestList & list, const ProcessID pid);
+
     /**
      * Handle a request for a File specified by its inode
      *
@@ -190,12 +291,71 @@ class FileSystemServer : public ChannelServer<FileSystemServer, FileSystemMessag
      */
     FileSystem::Result waitFileHandler(FileSystemRequest &req);
 
+    /**
+     * Handle a ReadDirectory or ReadDirectoryPlus request
+     *
+     * Packs as many DirectoryRecord entries as fit in the buffer, starting
+     * at the entry index given by the message offset. On output, the offset
+     * contains the index of the next entry or ZERO if all entries are returned.
+     *
+     * @param req FileSystemRequest reference
+     * @param cache FileCache of the directory
+     *
+     * @return Result code
+     */
+    FileSystem::Result readDirectory(FileSystemRequest &req, FileCache *cache);
+
+    /**
+     * Handle a SpliceFile request
+     *
+     * Reads chunks of the file directly into the bulk buffer shared with
+     * the file system of the target file, and sends a batch of WriteFileBulk
+     * requests for them. The data never enters the requesting process.
+     * On output, the message size contains the number of bytes spliced.
+     *
+     * @param req FileSystemRequest reference
+     * @param file Source File to read from
+     *
+     * @return Result code
+     */
+    FileSystem::Result spliceFile(FileSystemRequest &req, File *file);
+
+    /**
+     * Release a completed request and update the IOStatistics.
+     *
+     * @param req FileSystemRequest which is completed
+     * @param retried True if the request waited before completing
+     */
+    void completeRequest(FileSystemRequest *req, const bool retried);
+
+    /**
+     * Retrieve the bulk transfer buffer shared by a process.
+     *
+     * @param pid ProcessID of the remote process
+     *
+     * @return Pointer to the bulk buffer on success or ZERO if not shared.
+     */
+    u8 * getBulkBuffer(const ProcessID pid);
+
+    /**
+     * Retrieve the memory share for a MapFile request.
+     *
+     * @param msg MapFile request with the share tag in the buffer field
+     * @param share On output, the memory share created by the remote process
+     *
+     * @return True if the share is valid for the request and false otherwise
+     */
+    bool getMapShare(const FileSystemMessage *msg, ProcessShares::MemoryShare & share) const;
+
     /**
      * Send response for a FileSystemMessage
      *
+     * Advances the change generation if the message changed a file,
+     * and includes the change generation in the response.
+     *
      * @param msg The FileSystemMessage to send response for
      */
-    void sendResponse(FileSystemMessage *msg) const;
+    void sendResponse(FileSystemMessage *msg);
 
     /**
      * Try to forward the given FileSystemMessage to a mount file system.
@@ -230,28 +390,60 @@ class FileSystemServer : public ChannelServer<FileSystemServer, FileSystemMessag
      */
     Directory * getParentDirectory(const char *path);
 
+    /**
+     * Find the cached parent directory of a path.
+     *
+     * @param path Full path of a file.
+     * @param base Receives the last component of the path, which refers into the path.
+     *
+     * @return Pointer to the FileCache of the parent on success, ZERO otherwise.
+     */
+    FileCache * findParentCache(const char *path, StringView & base) const;
+
+    /**
+     * Retrieve a child of a directory from the FileCache or storage.
+     *
+     * @param parent FileCache of the directory
+     * @param name Name of the child, which does not need to be null-terminated
+     * @param length Length of the name in bytes
+     * @param nameHash Hash of the name
+     *
+     * @return Pointer to a FileCache on success, ZERO otherwise.
+     */
+    FileCache * lookupChild(FileCache *parent,
+                            const char *name,
+                            const Size length,
+                            const u32 nameHash);
+
     /**
      * Retrieve a File from storage.
      *
      * This function is responsible for walking the
-     * given FileSystemPath, retrieving each uncached File into
+     * given path, retrieving each uncached File into
      * the FileCache, and returning a pointer to corresponding FileCache
      * of the last entry in the given path.
      *
      * @param path A path to lookup from storage.
+     * @param maximumLength Maximum number of bytes to read from the path.
      *
      * @return Pointer to a FileCache on success, ZERO otherwise.
      */
-    FileCache * lookupFile(const FileSystemPath &path);
+    FileCache * lookupFile(const char *path,
+                           const Size maximumLength = FileSystemPath::MaximumLength);
 
     /**
      * Search the cache for an entry.
      *
+     * Resolves each path component with one probe of the dentry hash,
+     * without allocating memory.
+     *
      * @param path Full path of the file to find.
+     * @param maximumLength Maximum number of bytes to read from the path.
      *
      * @return Pointer to FileCache object on success, NULL on failure.
      */
-    FileCache * findFileCache(const char *path) const;
+    FileCache * findFileCache(const char *path,
+                              const Size maximumLength = FileSystemPath::MaximumLength) const;
 
     /**
      * Search the cache for an entry.
@@ -281,6 +473,48 @@ class FileSystemServer : public ChannelServer<FileSystemServer, FileSystemMessag
      */
     FileCache * insertFileCache(File *file, const char *pathFormat);
 
+    /**
+     * Find a cached entry in the dentry hash.
+     *
+     * @param parent Parent FileCache of the entry
+     * @param name Name of the entry, which does not need to be null-terminated
+     * @param length Length of the name in bytes
+     * @param nameHash Hash of the name
+     *
+     * @return Pointer to FileCache object on success, NULL on failure.
+     */
+    FileCache * lookupDentry(const FileCache *parent,
+                             const char *name,
+                             const Size length,
+                             const u32 nameHash) const;
+
+    /**
+     * Add a FileCache to the dentry hash.
+     *
+     * Replaces an existing entry with the same parent and name,
+     * and forgets a negative lookup of the name.
+     *
+     * @param cache FileCache with a parent
+     */
+    void insertDentry(FileCache *cache);
+
+    /**
+     * Remove a FileCache from the dentry hash, if present.
+     *
+     * @param cache FileCache pointer
+     */
+    void removeDentry(FileCache *cache);
+
+    /**
+     * Get the dentry hash bucket for an entry.
+     *
+     * @param parent Parent FileCache of the entry
+     * @param nameHash Hash of the name of the entry
+     *
+     * @return Bucket index
+     */
+    Size getDentryBucket(const FileCache *parent, const u32 nameHash) const;
+
     /**
      * Remove a File from the cache.
      *
@@ -307,14 +541,50 @@ class FileSystemServer : public ChannelServer<FileSystemServer, FileSystemMessag
     /** Contains a mapping of inode number to file of all cached files */
     HashTable<u32, File *> m_inodeMap;
 
+    /** Cached entries keyed by their parent and name hash, chained via FileCache::hashNext */
+    FileCache *m_dentries[DentryHashSize];
+
+    /** Entries which were not found by a Directory lookup */
+    NegativeLookupCache m_negative;
+
+    /** Statistics of completed requests, exported as sys/iostat. */
+    IOStatistics m_ioStats;
+
     /** Mount point path. */
     const char *m_mountPath;
 
     /** Table with mounted file systems (only used by the root file system). */
     FileSystemMount *m_mounts;
 
-    /** Contains ongoing requests */
-    List<FileSystemRequest *> *m_requests;
+    /** Bulk transfer buffers shared by client processes */
+    HashTable<ProcessID, u8 *> m_bulkBuffers;
+
+    /** Preallocated requests for incoming messages */
+    FileSystemRequestPool m_pool;
+
+    /** Contains ongoing requests which do not wait for a specific File */
+    RequestList m_requests;
+
+    /** Ongoing requests per inode, waiting for the File to become ready */
+    HashTable<u32, RequestList *> m_waiters;
+
+    /** Preallocated nodes for the list of ready Files */
+    List<u32>::NodePool m_readyPool;
+
+    /** Inodes of Files which may have become ready since the last retry */
+    List<u32> m_readyFiles;
+
+    /** True if all waiting requests must be retried */
+    bool m_notifyAll;
+
+    /** True if requests which modify the file system are refused */
+    bool m_readOnly;
+
+    /** Incremented when a file is created, deleted or written, returned in each response */
+    u32 m_generation;
+
+    /** Callback registered on Files for readiness notifications */
+    Callback<FileSystemServer, File> m_readyCallback;
 };
 
 /**
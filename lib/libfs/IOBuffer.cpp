@@ -24,7 +24,10 @@
 IOBuffer::IOBuffer()
     : m_message(ZERO)
     , m_directMapped(false)
+    , m_shared(false)
     , m_buffer(ZERO)
+    , m_storage(ZERO)
+    , m_storageSize(0)
     , m_size(0)
     , m_count(0)
 {
@@ -33,7 +36,10 @@ IOBuffer::IOBuffer()
 IOBuffer::IOBuffer(const FileSystemMessage *msg)
     : m_message(msg)
     , m_directMapped(false)
+    , m_shared(false)
     , m_buffer(ZERO)
+    , m_storage(ZERO)
+    , m_storageSize(0)
     , m_size(0)
     , m_count(0)
 {
@@ -42,7 +48,12 @@ IOBuffer::IOBuffer(const FileSystemMessage *msg)
 
 IOBuffer::~IOBuffer()
 {
-    if (m_buffer)
+    release();
+}
+
+void IOBuffer::release()
+{
+    if (m_buffer && !m_shared && m_buffer != m_storage)
     {
         if (m_directMapped)
         {
@@ -50,7 +61,6 @@ IOBuffer::~IOBuffer()
             if (r != API::Success)
             {
                 ERROR("failed to unmap remote buffer using VMCtl: result = " << (int) r);
-                return;
             }
         }
         else
@@ -58,10 +68,17 @@ IOBuffer::~IOBuffer()
             delete[] m_buffer;
         }
     }
+
+    m_buffer       = ZERO;
+    m_directMapped = false;
+    m_shared       = false;
 }
 
 void IOBuffer::setMessage(const FileSystemMessage *msg)
 {
+    // Release the buffer of a previous message
+    release();
+
     if (msg->action == FileSystem::ReadFile || msg->action == FileSystem::WriteFile)
     {
         // If the remote buffer is page aligned, we can directly map it (unbuffered)
@@ -89,12 +106,22 @@ void IOBuffer::setMessage(const FileSystemMessage *msg)
             m_directMapped = true;
             m_buffer = (u8 *) m_directMapRange.virt;
         }
+        else if (m_storage != ZERO && msg->size <= m_storageSize)
+        {
+            m_buffer = m_storage;
+        }
         else
         {
             m_buffer = new u8[msg->size];
             assert(m_buffer != NULL);
         }
     }
+    else if (msg->action == FileSystem::ReadFileBulk || msg->action == FileSystem::WriteFileBulk ||
+             msg->action == FileSystem::MapFile || msg->action == FileSystem::SpliceFile)
+    {
+        // The buffer is assigned by the FileSystemServer via setSharedBuffer()
+        m_buffer = ZERO;
+    }
     else
     {
         assert(m_buffer == NULL);
@@ -106,6 +133,19 @@ void IOBuffer::setMessage(const FileSystemMessage *msg)
     m_count  = 0;
 }
 
+void IOBuffer::setSharedBuffer(u8 *buffer)
+{
+    m_buffer       = buffer;
+    m_directMapped = true;
+    m_shared       = true;
+}
+
+void IOBuffer::setStorage(u8 *buffer, const Size size)
+{
+    m_storage     = buffer;
+    m_storageSize = size;
+}
+
 Size IOBuffer::getCount() const
 {
     return m_count;
@@ -201,6 +241,61 @@ FileSystem::Result IOBuffer::write(const void *buffer, const Size size, const Si
     }
 }
 
+FileSystem::Result IOBuffer::readVector(const IOBuffer::Segment *segments,
+                                        const Size count)
+{
+    return copyVector(false, segments, count);
+}
+
+FileSystem::Result IOBuffer::writeVector(const IOBuffer::Segment *segments,
+                                         const Size count)
+{
+    return copyVector(true, segments, count);
+}
+
+FileSystem::Result IOBuffer::copyVector(const bool write,
+                                        const IOBuffer::Segment *segments,
+                                        const Size count)
+{
+    VMCopySegment vector[VMCOPY_MAX_SEGMENTS];
+
+    m_count = 0;
+
+    if (m_directMapped)
+    {
+        for (Size i = 0; i < count; i++)
+        {
+            if (write)
+                MemoryBlock::copy(m_buffer + segments[i].offset, (void *) segments[i].buffer, segments[i].size);
+            else
+                MemoryBlock::copy((void *) segments[i].buffer, m_buffer + segments[i].offset, segments[i].size);
+        }
+        return FileSystem::Success;
+    }
+
+    for (Size i = 0; i < count; )
+    {
+        Size num = 0;
+
+        for (; i < count && num < VMCOPY_MAX_SEGMENTS; i++, num++)
+        {
+            vector[num].ours   = segments[i].buffer;
+            vector[num].theirs = (Address) m_message->buffer + segments[i].offset;
+            vector[num].size   = segments[i].size;
+        }
+
+        const API::Result result = VMCopyVector(m_message->from, write ? API::Write : API::Read,
+                                                vector, num);
+        if (result != API::Success)
+        {
+            ERROR("VMCopyVector failed for PID " << m_message->from << ": result = " << (int) result);
+            return FileSystem::IOError;
+        }
+    }
+
+    return FileSystem::Success;
+}
+
 FileSystem::Result IOBuffer::flushWrite()
 {
     if (m_directMapped)
@@ -36,6 +36,27 @@
  */
 class IOBuffer
 {
+  public:
+
+    /** Number of segments worth collecting for a single readVector() or writeVector(). */
+    static const Size MaximumSegments = 32;
+
+    /**
+     * Local memory to copy in a vectored read or write.
+     */
+    typedef struct Segment
+    {
+        /** Local memory address. */
+        Address buffer;
+
+        /** Number of bytes to copy. */
+        Size size;
+
+        /** Offset inside the I/O buffer. */
+        Size offset;
+    }
+    Segment;
+
   public:
 
     /**
@@ -79,6 +100,37 @@ class IOBuffer
      */
     void setMessage(const FileSystemMessage *msg);
 
+    /**
+     * Use memory shared with the remote process as buffer.
+     *
+     * Used for ReadFileBulk and WriteFileBulk requests, where the
+     * remote process has already shared the memory with the file system.
+     * The memory remains owned by the caller and is not released.
+     *
+     * @param buffer Local address inside the shared memory region
+     */
+    void setSharedBuffer(u8 *buffer);
+
+    /**
+     * Set preallocated memory for buffered transfers.
+     *
+     * Messages of up to the given size, which cannot be direct-mapped,
+     * use the storage instead of a newly allocated buffer. The storage
+     * remains owned by the caller and is not released.
+     *
+     * @param buffer Storage memory
+     * @param size Size of the storage in bytes
+     */
+    void setStorage(u8 *buffer, const Size size);
+
+    /**
+     * Release the buffer of the current message, if any.
+     *
+     * Unmaps a direct-mapped buffer or frees an allocated buffer.
+     * The preallocated storage and shared buffers are kept.
+     */
+    void release();
+
     /**
      * Get filesystem message.
      *
@@ -119,6 +171,32 @@ class IOBuffer
                              const Size size,
                              const Size offset = ZERO);
 
+    /**
+     * Read several pieces of the I/O buffer at once.
+     *
+     * Uses a single VMCopyVector() call for up to MaximumSegments segments.
+     *
+     * @param segments Local buffers to fill and their offsets inside the I/O buffer.
+     * @param count Number of segments.
+     *
+     * @return Result code
+     */
+    FileSystem::Result readVector(const Segment *segments,
+                                  const Size count);
+
+    /**
+     * Write several pieces to the I/O buffer at once.
+     *
+     * Uses a single VMCopyVector() call for up to MaximumSegments segments.
+     *
+     * @param segments Local buffers to write and their offsets inside the I/O buffer.
+     * @param count Number of segments.
+     *
+     * @return Result code
+     */
+    FileSystem::Result writeVector(const Segment *segments,
+                                   const Size count);
+
     /**
      * Buffered read bytes from the I/O buffer.
      *
@@ -153,6 +231,21 @@ class IOBuffer
      */
     u8 operator[] (Size index) const;
 
+  private:
+
+    /**
+     * Copy several pieces between local memory and the remote buffer.
+     *
+     * @param write True to write to the remote buffer, false to read from it.
+     * @param segments Local buffers and their offsets inside the I/O buffer.
+     * @param count Number of segments.
+     *
+     * @return Result code
+     */
+    FileSystem::Result copyVector(const bool write,
+                                  const Segment *segments,
+                                  const Size count);
+
   private:
 
     /**
@@ -170,12 +263,21 @@ class IOBuffer
     /** True if using directly memory-mapped memory (unbuffered) */
     bool m_directMapped;
 
+    /** True if the buffer is inside memory shared with the remote process */
+    bool m_shared;
+
     /** Contains the memory address range of the direct memory mapping */
     Memory::Range m_directMapRange;
 
     /** Buffer for storing temporary data. */
     u8 *m_buffer;
 
+    /** Preallocated storage for buffered transfers, if any. */
+    u8 *m_storage;
+
+    /** Size of the preallocated storage in bytes. */
+    Size m_storageSize;
+
     /** Buffer size. */
     Size m_size;
 
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include "IOStatistics.h"
+
+void IOStatistics::reset()
+{
+    MemoryBlock::set(this, 0, sizeof(*this));
+}
+
+void IOStatistics::record(const FileSystem::Action action,
+                          const FileSystem::Result result,
+                          const Size bytes,
+                          const u64 cycles,
+                          const bool retried)
+{
+    if (result == FileSystem::RedirectRequest)
+    {
+        redirects++;
+        return;
+    }
+
+    const Operation op = getOperation(action);
+    Counters *c = &operations[op];
+    Size bucket = 0;
+
+    while (bucket < HistogramBuckets - 1 && (cycles >> (bucket + 1)) != 0)
+        bucket++;
+
+    c->requests++;
+    c->cycles += cycles;
+    c->histogram[bucket]++;
+
+    if (retried)
+        c->retried++;
+
+    if (result != FileSystem::Success)
+        c->errors++;
+    else if (op == Read || op == Write)
+        c->bytes += bytes;
+}
+
+IOStatistics::Operation IOStatistics::getOperation(const FileSystem::Action action)
+{
+    switch (action)
+    {
+        case FileSystem::ReadFile:
+        case FileSystem::ReadFileBulk:
+        case FileSystem::MapFile:
+        case FileSystem::SpliceFile:
+            return Read;
+
+        case FileSystem::WriteFile:
+        case FileSystem::WriteFileBulk:
+            return Write;
+
+        case FileSystem::StatFile:
+            return Stat;
+
+        case FileSystem::ReadDirectory:
+        case FileSystem::ReadDirectoryPlus:
+            return Readdir;
+
+        case FileSystem::CreateFile:
+            return Create;
+
+        case FileSystem::DeleteFile:
+            return Delete;
+
+        default:
+            return Other;
+    }
+}
+
+const char * IOStatistics::getName(const Operation op)
+{
+    static const char *names[] = { "read", "write", "stat", "readdir", "create", "delete", "other" };
+
+    return op < NumberOfOperations ? names[op] : "unknown";
+}
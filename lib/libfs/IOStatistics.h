@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBFS_IOSTATISTICS_H
+#define __LIB_LIBFS_IOSTATISTICS_H
+
+#include <Types.h>
+#include "FileSystem.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libfs
+ * @{
+ */
+
+/**
+ * File system request statistics of a FileSystemServer.
+ *
+ * Requests are counted per operation when they complete, including
+ * the time spent waiting for a File to become ready. This differs from
+ * the IPCStatistics, which only include the time spent in the handler.
+ */
+class IOStatistics
+{
+  public:
+
+    /** Number of log2 service time histogram buckets. */
+    static const Size HistogramBuckets = 24;
+
+    /**
+     * Operations with separate statistics.
+     */
+    enum Operation
+    {
+        Read = 0,
+        Write,
+        Stat,
+        Readdir,
+        Create,
+        Delete,
+        Other,
+        NumberOfOperations
+    };
+
+    /**
+     * Statistics of a single operation.
+     */
+    typedef struct Counters
+    {
+        /** Number of completed requests. */
+        u32 requests;
+
+        /** Number of requests completed with an error. */
+        u32 errors;
+
+        /** Number of requests which waited for the File before completing. */
+        u32 retried;
+
+        /** Number of bytes transferred by successful requests. */
+        u64 bytes;
+
+        /** Total cycles from receiving the requests until the responses. */
+        u64 cycles;
+
+        /** Histogram of service times, bucket N counts [2^N, 2^(N+1)) cycles. */
+        u32 histogram[HistogramBuckets];
+    }
+    Counters;
+
+  public:
+
+    /**
+     * Clear all statistics.
+     */
+    void reset();
+
+    /**
+     * Record a completed request.
+     *
+     * @param action Action of the request
+     * @param result Result code of the request
+     * @param bytes Number of bytes transferred
+     * @param cycles Service time in cycles
+     * @param retried True if the request waited for the File
+     */
+    void record(const FileSystem::Action action,
+                const FileSystem::Result result,
+                const Size bytes,
+                const u64 cycles,
+                const bool retried);
+
+    /**
+     * Get the operation of a request action.
+     *
+     * @param action Action of the request
+     *
+     * @return Operation value
+     */
+    static Operation getOperation(const FileSystem::Action action);
+
+    /**
+     * Get the name of an operation.
+     *
+     * @param op Operation value
+     *
+     * @return Null-terminated name
+     */
+    static const char * getName(const Operation op);
+
+  public:
+
+    /** Number of requests redirected to another file system. */
+    u32 redirects;
+
+    /** Number of path requests answered from the file cache. */
+    u32 cacheHits;
+
+    /** Number of lookups answered by the negative lookup cache. */
+    u32 negativeHits;
+
+    /** Number of lookups performed by a Directory, as the entry was not cached. */
+    u32 lookups;
+
+    /** Statistics per operation. */
+    Counters operations[NumberOfOperations];
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBFS_IOSTATISTICS_H */
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <String.h>
+#include "IOBuffer.h"
+#include "IOStatisticsFile.h"
+
+IOStatisticsFile::IOStatisticsFile(const u32 inode, const IOStatistics *stats)
+    : File(inode)
+    , m_stats(stats)
+{
+    m_access = FileSystem::OwnerR | FileSystem::GroupR | FileSystem::OtherR;
+}
+
+IOStatisticsFile::~IOStatisticsFile()
+{
+}
+
+FileSystem::Result IOStatisticsFile::read(IOBuffer & buffer,
+                                          Size & size,
+                                          const Size offset)
+{
+    String tmp;
+
+    // Format the current counters, skipping unused operations
+    for (Size i = 0; i < IOStatistics::NumberOfOperations; i++)
+    {
+        const IOStatistics::Counters *c = &m_stats->operations[i];
+        Size last = 0;
+
+        if (c->requests == 0)
+            continue;
+
+        tmp << IOStatistics::getName((IOStatistics::Operation) i);
+        tmp << " requests " << (uint) c->requests;
+        tmp << " errors " << (uint) c->errors;
+        tmp << " retried " << (uint) c->retried;
+        tmp << " kbytes " << (uint) (c->bytes / 1024);
+        tmp << " cycles " << (uint) (c->cycles / c->requests) << " histogram";
+
+        for (Size j = 0; j < IOStatistics::HistogramBuckets; j++)
+        {
+            if (c->histogram[j] != 0)
+                last = j;
+        }
+
+        for (Size j = 0; j <= last; j++)
+            tmp << " " << (uint) c->histogram[j];
+
+        tmp << "\n";
+    }
+
+    tmp << "lookup hits " << (uint) m_stats->cacheHits;
+    tmp << " negative " << (uint) m_stats->negativeHits;
+    tmp << " misses " << (uint) m_stats->lookups << "\n";
+    tmp << "redirects " << (uint) m_stats->redirects << "\n";
+
+    // Bounds checking
+    if (offset >= tmp.length())
+    {
+        size = 0;
+        return FileSystem::Success;
+    }
+
+    // How much bytes to copy?
+    const Size bytes = tmp.length() - offset > size ? size : tmp.length() - offset;
+    size = bytes;
+
+    return buffer.write(*tmp + offset, bytes);
+}
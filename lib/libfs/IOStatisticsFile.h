@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBFS_IOSTATISTICSFILE_H
+#define __LIB_LIBFS_IOSTATISTICSFILE_H
+
+#include <Types.h>
+#include "IOStatistics.h"
+#include "File.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libfs
+ * @{
+ */
+
+/**
+ * Provides the IOStatistics of a FileSystemServer as a text file.
+ *
+ * Each operation line gives the number of requests, errors and requests
+ * which waited for their File, the kilobytes transferred and the average
+ * and log2 histogram of the service time in cycles. Followed by the file
+ * cache lookup counters and the number of redirected requests.
+ */
+class IOStatisticsFile : public File
+{
+  public:
+
+    /**
+     * Constructor function.
+     *
+     * @param inode Inode number for this File
+     * @param stats Statistics to report
+     */
+    IOStatisticsFile(const u32 inode, const IOStatistics *stats);
+
+    /**
+     * Destructor function.
+     */
+    virtual ~IOStatisticsFile();
+
+    /**
+     * @brief Read bytes from the file.
+     *
+     * @param buffer Input/Output buffer to output bytes to.
+     * @param size Maximum number of bytes to read on input.
+     *             On output, the actual number of bytes read.
+     * @param offset Offset inside the file to start reading.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result read(IOBuffer & buffer,
+                                    Size & size,
+                                    const Size offset);
+
+  private:
+
+    /** Statistics to report */
+    const IOStatistics *m_stats;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBFS_IOSTATISTICSFILE_H */
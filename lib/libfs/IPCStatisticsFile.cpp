@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <String.h>
+#include "IOBuffer.h"
+#include "IPCStatisticsFile.h"
+
+IPCStatisticsFile::IPCStatisticsFile(const u32 inode, const IPCStatistics *stats)
+    : File(inode)
+    , m_stats(stats)
+{
+    m_access = FileSystem::OwnerR | FileSystem::GroupR | FileSystem::OtherR;
+}
+
+IPCStatisticsFile::~IPCStatisticsFile()
+{
+}
+
+FileSystem::Result IPCStatisticsFile::read(IOBuffer & buffer,
+                                           Size & size,
+                                           const Size offset)
+{
+    String tmp;
+
+    // Format the current counters, skipping unused actions
+    tmp << "retries " << (uint) m_stats->retries << "\n";
+    tmp << "unknown " << (uint) m_stats->unknown << "\n";
+
+    for (Size i = 0; i < IPCStatistics::MaximumActions; i++)
+    {
+        const IPCStatistics::Handler *h = &m_stats->handlers[i];
+
+        if (h->handled == 0)
+            continue;
+
+        tmp << "action " << (uint) i << " handled " << (uint) h->handled;
+        tmp << " cycles " << (uint) (h->cycles / h->handled);
+        tmp << " depth " << (uint) (h->totalDepth / h->handled);
+        tmp << " maxdepth " << (uint) h->maxDepth << " histogram";
+        writeHistogram(tmp, h);
+    }
+
+    if (m_stats->interrupts.handled != 0)
+    {
+        const IPCStatistics::Handler *h = &m_stats->interrupts;
+
+        tmp << "interrupts handled " << (uint) h->handled;
+        tmp << " latency " << (uint) (h->cycles / h->handled) << " histogram";
+        writeHistogram(tmp, h);
+    }
+
+    // Bounds checking
+    if (offset >= tmp.length())
+    {
+        size = 0;
+        return FileSystem::Success;
+    }
+
+    // How much bytes to copy?
+    const Size bytes = tmp.length() - offset > size ? size : tmp.length() - offset;
+    size = bytes;
+
+    return buffer.write(*tmp + offset, bytes);
+}
+
+void IPCStatisticsFile::writeHistogram(String & out, const IPCStatistics::Handler *h)
+{
+    Size last = 0;
+
+    for (Size j = 0; j < IPCStatistics::HistogramBuckets; j++)
+    {
+        if (h->histogram[j] != 0)
+            last = j;
+    }
+
+    for (Size j = 0; j <= last; j++)
+        out << " " << (uint) h->histogram[j];
+
+    out << "\n";
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBFS_IPCSTATISTICSFILE_H
+#define __LIB_LIBFS_IPCSTATISTICSFILE_H
+
+#include <Types.h>
+#include <IPCStatistics.h>
+#include <String.h>
+#include "File.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ * @addtogroup libfs
+ * @{
+ */
+
+/**
+ * Provides the IPCStatistics of a ChannelServer as a text file.
+ *
+ * Each line describes one message action, with the number of messages
+ * handled, the average and log2 histogram of the service time in cycles
+ * and the average and maximum queue depth seen at dequeue. A separate line
+ * describes the interrupts handled, with the average and log2 histogram
+ * of the latency from interrupt entry in the kernel to the handler.
+ */
+class IPCStatisticsFile : public File
+{
+  public:
+
+    /**
+     * Constructor function.
+     *
+     * @param inode Inode number for this File
+     * @param stats Statistics to report
+     */
+    IPCStatisticsFile(const u32 inode, const IPCStatistics *stats);
+
+    /**
+     * Destructor function.
+     */
+    virtual ~IPCStatisticsFile();
+
+    /**
+     * @brief Read bytes from the file.
+     *
+     * @param buffer Input/Output buffer to output bytes to.
+     * @param size Maximum number of bytes to read on input.
+     *             On output, the actual number of bytes read.
+     * @param offset Offset inside the file to start reading.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result read(IOBuffer & buffer,
+                                    Size & size,
+                                    const Size offset);
+
+  private:
+
+    /**
+     * Format a log2 histogram, without the trailing empty buckets.
+     *
+     * @param out Output string
+     * @param h Statistics containing the histogram
+     */
+    static void writeHistogram(String & out, const IPCStatistics::Handler *h);
+
+  private:
+
+    /** Statistics to report */
+    const IPCStatistics *m_stats;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBFS_IPCSTATISTICSFILE_H */
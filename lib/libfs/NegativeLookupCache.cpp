@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include "NegativeLookupCache.h"
+
+NegativeLookupCache::NegativeLookupCache()
+    : m_head(ZERO)
+    , m_tail(ZERO)
+    , m_count(0)
+{
+    // All entries start unused, in LRU order
+    for (Size i = 0; i < MaximumEntries; i++)
+    {
+        m_entries[i].parent = ZERO;
+        m_entries[i].prev   = i > 0 ? &m_entries[i - 1] : ZERO;
+        m_entries[i].next   = i < MaximumEntries - 1 ? &m_entries[i + 1] : ZERO;
+    }
+
+    m_head = &m_entries[0];
+    m_tail = &m_entries[MaximumEntries - 1];
+}
+
+bool NegativeLookupCache::contains(const FileCache *parent,
+                                   const char *name,
+                                   const Size length,
+                                   const u32 nameHash)
+{
+    Entry *entry = find(parent, name, length, nameHash);
+
+    if (entry != ZERO)
+    {
+        touch(entry);
+        return true;
+    }
+
+    return false;
+}
+
+void NegativeLookupCache::insert(const FileCache *parent,
+                                 const char *name,
+                                 const Size length,
+                                 const u32 nameHash)
+{
+    if (length > FileSystemPath::MaximumLength || find(parent, name, length, nameHash) != ZERO)
+    {
+        return;
+    }
+
+    // Replace the least recently used entry, which is unused if any are left
+    Entry *entry = m_tail;
+
+    if (entry->parent == ZERO)
+    {
+        m_count++;
+    }
+
+    entry->parent   = parent;
+    entry->nameHash = nameHash;
+    entry->length   = length;
+    MemoryBlock::copy((void *) entry->name, name, length);
+    touch(entry);
+}
+
+void NegativeLookupCache::invalidate(const FileCache *parent,
+                                     const char *name,
+                                     const Size length,
+                                     const u32 nameHash)
+{
+    Entry *entry = find(parent, name, length, nameHash);
+
+    if (entry != ZERO)
+    {
+        release(entry);
+    }
+}
+
+void NegativeLookupCache::invalidate(const FileCache *parent)
+{
+    for (Size i = 0; i < MaximumEntries; i++)
+    {
+        if (m_entries[i].parent == parent)
+        {
+            release(&m_entries[i]);
+        }
+    }
+}
+
+Size NegativeLookupCache::count() const
+{
+    return m_count;
+}
+
+NegativeLookupCache::Entry * NegativeLookupCache::find(const FileCache *parent,
+                                                       const char *name,
+                                                       const Size length,
+                                                       const u32 nameHash) const
+{
+    // Used entries are at the front of the LRU list
+    for (Entry *entry = m_head; entry != ZERO && entry->parent != ZERO; entry = entry->next)
+    {
+        if (entry->parent == parent && entry->nameHash == nameHash &&
+            entry->length == length && MemoryBlock::compare(entry->name, name, length))
+        {
+            return entry;
+        }
+    }
+
+    return ZERO;
+}
+
+void NegativeLookupCache::touch(Entry *entry)
+{
+    unlink(entry);
+
+    entry->prev = ZERO;
+    entry->next = m_head;
+
+    if (m_head != ZERO)
+    {
+        m_head->prev = entry;
+    }
+    m_head = entry;
+
+    if (m_tail == ZERO)
+    {
+        m_tail = entry;
+    }
+}
+
+void NegativeLookupCache::release(Entry *entry)
+{
+    unlink(entry);
+
+    entry->parent = ZERO;
+    entry->prev   = m_tail;
+    entry->next   = ZERO;
+
+    if (m_tail != ZERO)
+    {
+        m_tail->next = entry;
+    }
+    m_tail = entry;
+
+    if (m_head == ZERO)
+    {
+        m_head = entry;
+    }
+
+    m_count--;
+}
+
+void NegativeLookupCache::unlink(Entry *entry)
+{
+    if (entry->prev != ZERO)
+    {
+        entry->prev->next = entry->next;
+    }
+    else
+    {
+        m_head = entry->next;
+    }
+
+    if (entry->next != ZERO)
+    {
+        entry->next->prev = entry->prev;
+    }
+    else
+    {
+        m_tail = entry->prev;
+    }
+}
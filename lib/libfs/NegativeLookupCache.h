@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBFS_NEGATIVELOOKUPCACHE_H
+#define __LIB_LIBFS_NEGATIVELOOKUPCACHE_H
+
+#include <Types.h>
+#include "FileCache.h"
+#include "FileSystemPath.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libfs
+ * @{
+ */
+
+/**
+ * Remembers directory entries which were not found.
+ *
+ * Each entry records the parent FileCache and the name of a missing
+ * entry, such that repeated lookups of the same missing path do not
+ * reach the Directory implementation again. The number of entries is
+ * bounded, and the least recently used entry is replaced when full.
+ */
+class NegativeLookupCache
+{
+  public:
+
+    /** Maximum number of missing entries remembered */
+    static const Size MaximumEntries = 64;
+
+  private:
+
+    /**
+     * Missing directory entry
+     */
+    typedef struct Entry
+    {
+        /** Parent directory of the entry, or ZERO if unused */
+        const FileCache *parent;
+
+        /** Hash of the name */
+        u32 nameHash;
+
+        /** Length of the name in bytes */
+        Size length;
+
+        /** Name of the entry, not null-terminated */
+        char name[FileSystemPath::MaximumLength];
+
+        /** Previous entry in the LRU list, towards the most recently used */
+        struct Entry *prev;
+
+        /** Next entry in the LRU list, towards the least recently used */
+        struct Entry *next;
+    }
+    Entry;
+
+  public:
+
+    /**
+     * Constructor
+     */
+    NegativeLookupCache();
+
+    /**
+     * Check if an entry is known to be missing.
+     *
+     * Marks the entry as most recently used if found.
+     *
+     * @param parent Parent directory of the entry
+     * @param name Name of the entry, which does not need to be null-terminated
+     * @param length Length of the name in bytes
+     * @param nameHash Hash of the name
+     *
+     * @return True if the entry is known to be missing
+     */
+    bool contains(const FileCache *parent,
+                  const char *name,
+                  const Size length,
+                  const u32 nameHash);
+
+    /**
+     * Remember a missing entry.
+     *
+     * @param parent Parent directory of the entry
+     * @param name Name of the entry, which does not need to be null-terminated
+     * @param length Length of the name in bytes
+     * @param nameHash Hash of the name
+     */
+    void insert(const FileCache *parent,
+                const char *name,
+                const Size length,
+                const u32 nameHash);
+
+    /**
+     * Forget a missing entry, when it is created.
+     *
+     * @param parent Parent directory of the entry
+     * @param name Name of the entry, which does not need to be null-terminated
+     * @param length Length of the name in bytes
+     * @param nameHash Hash of the name
+     */
+    void invalidate(const FileCache *parent,
+                    const char *name,
+                    const Size length,
+                    const u32 nameHash);
+
+    /**
+     * Forget all missing entries of a directory, when it is removed.
+     *
+     * @param parent Parent directory of the entries
+     */
+    void invalidate(const FileCache *parent);
+
+    /**
+     * Get number of missing entries remembered.
+     *
+     * @return Number of entries
+     */
+    Size count() const;
+
+  private:
+
+    /**
+     * Find a missing entry.
+     *
+     * @return Entry pointer or ZERO if not found
+     */
+    Entry * find(const FileCache *parent,
+                 const char *name,
+                 const Size length,
+                 const u32 nameHash) const;
+
+    /**
+     * Move an entry to the most recently used position.
+     *
+     * @param entry Entry pointer
+     */
+    void touch(Entry *entry);
+
+    /**
+     * Move an entry to the least recently used position and mark it unused.
+     *
+     * @param entry Entry pointer
+     */
+    void release(Entry *entry);
+
+    /**
+     * Remove an entry from the LRU list.
+     *
+     * @param entry Entry pointer
+     */
+    void unlink(Entry *entry);
+
+  private:
+
+    /** All entries, linked in LRU order */
+    Entry m_entries[MaximumEntries];
+
+    /** Most recently used entry */
+    Entry *m_head;
+
+    /** Least recently used entry */
+    Entry *m_tail;
+
+    /** Number of used entries */
+    Size m_count;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBFS_NEGATIVELOOKUPCACHE_H */
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include "Pipe.h"
+
+Pipe::Pipe(const Address buffer)
+    : m_header((Header *) buffer)
+    , m_data((u8 *) buffer + PAGESIZE)
+{
+}
+
+FileSystem::Result Pipe::create(Address & buffer)
+{
+    Memory::Range range;
+    range.virt   = ZERO;
+    range.phys   = ZERO;
+    range.size   = BufferSize;
+    range.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    if (VMCtl(SELF, MapContiguous, &range) != API::Success)
+    {
+        return FileSystem::IOError;
+    }
+
+    // Both sides start with a single open end
+    Header *header = (Header *) range.virt;
+    MemoryBlock::set(header, 0, sizeof(Header));
+    header->writer.ends.store(1);
+    header->reader.ends.store(1);
+
+    buffer = range.virt;
+    return FileSystem::Success;
+}
+
+FileSystem::Result Pipe::share(const ProcessID pid) const
+{
+    Memory::Range range;
+    range.virt   = (Address) m_header;
+    range.phys   = ZERO;
+    range.size   = BufferSize;
+    range.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    // The buffer is physically contiguous
+    if (VMCtl(SELF, LookupVirtual, &range) != API::Success ||
+        VMCtl(pid, MapShared, &range) != API::Success)
+    {
+        return FileSystem::IOError;
+    }
+
+    return FileSystem::Success;
+}
+
+void Pipe::release() const
+{
+    Memory::Range range;
+    range.virt   = (Address) m_header;
+    range.phys   = ZERO;
+    range.size   = BufferSize;
+    range.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    VMCtl(SELF, Release, &range);
+}
+
+void Pipe::attach(const bool writer)
+{
+    (writer ? m_header->writer : m_header->reader).ends.fetchAdd(1);
+}
+
+void Pipe::detach(const bool writer)
+{
+    Side & side = writer ? m_header->writer : m_header->reader;
+
+    side.ends.fetchSub(1);
+    signal(side);
+}
+
+FileSystem::Result Pipe::read(void *buffer, Size *size)
+{
+    Side & writer = m_header->writer;
+    Side & reader = m_header->reader;
+    u32 head, tail;
+
+    lock(reader);
+
+    // Wait for data or the last write end to close
+    while (true)
+    {
+        const u32 events = writer.events.load();
+
+        head = writer.index.load(MemoryAcquire);
+        tail = reader.index.load(MemoryRelaxed);
+
+        if (head != tail)
+        {
+            break;
+        }
+        else if (writer.ends.load() == 0)
+        {
+            unlock(reader);
+            *size = 0;
+            return FileSystem::Success;
+        }
+
+        wait(writer, events);
+    }
+
+    // Copy out, in two parts if the data wraps around the end
+    const Size available = head - tail;
+    const Size count = *size < available ? *size : available;
+    const Size offset = tail & (DataSize - 1);
+    const Size first = count < DataSize - offset ? count : DataSize - offset;
+
+    MemoryBlock::copy(buffer, m_data + offset, first);
+    MemoryBlock::copy((u8 *) buffer + first, m_data, count - first);
+
+    reader.index.store(tail + count, MemoryRelease);
+    signal(reader);
+    unlock(reader);
+
+    *size = count;
+    return FileSystem::Success;
+}
+
+FileSystem::Result Pipe::write(const void *buffer, Size *size)
+{
+    Side & writer = m_header->writer;
+    Side & reader = m_header->reader;
+    Size done = 0;
+
+    lock(writer);
+
+    while (done < *size)
+    {
+        const u32 events = reader.events.load();
+
+        // Nobody will ever read the data
+        if (reader.ends.load() == 0)
+        {
+            break;
+        }
+
+        const u32 head = writer.index.load(MemoryRelaxed);
+        const u32 tail = reader.index.load(MemoryAcquire);
+        const Size space = DataSize - (head - tail);
+
+        if (space == 0)
+        {
+            wait(reader, events);
+            continue;
+        }
+
+        // Copy in, in two parts if the space wraps around the end
+        const Size count = *size - done < space ? *size - done : space;
+        const Size offset = head & (DataSize - 1);
+        const Size first = count < DataSize - offset ? count : DataSize - offset;
+
+        MemoryBlock::copy(m_data + offset, (const u8 *) buffer + done, first);
+        MemoryBlock::copy(m_data, (const u8 *) buffer + done + first, count - first);
+
+        writer.index.store(head + count, MemoryRelease);
+        signal(writer);
+        done += count;
+    }
+
+    unlock(writer);
+
+    if (done == 0 && *size != 0)
+    {
+        return FileSystem::IOError;
+    }
+
+    *size = done;
+    return FileSystem::Success;
+}
+
+void Pipe::wait(Side & side, const u32 events)
+{
+    // Returns immediately if the side changed after the events were read
+    side.waiting.store(1);
+    ProcessCtl(SELF, FutexWait, (Address) &side.events, events);
+}
+
+void Pipe::signal(Side & side)
+{
+    side.events.fetchAdd(1);
+
+    if (side.waiting.exchange(0) != 0)
+    {
+        ProcessCtl(SELF, FutexWake, (Address) &side.events, 1);
+    }
+}
+
+void Pipe::lock(Side & side)
+{
+    u32 value = 0;
+
+    // Uncontended case: no system call needed
+    if (side.lock.compareExchange(value, 1))
+    {
+        return;
+    }
+
+    // Mark the lock contended and sleep until it is released
+    if (value != 2)
+        value = side.lock.exchange(2);
+
+    while (value != 0)
+    {
+        ProcessCtl(SELF, FutexWait, (Address) &side.lock, 2);
+        value = side.lock.exchange(2);
+    }
+}
+
+void Pipe::unlock(Side & side)
+{
+    // Only wakeup a waiter if the lock was contended
+    if (side.lock.fetchSub(1) != 1)
+    {
+        side.lock.store(0);
+        ProcessCtl(SELF, FutexWake, (Address) &side.lock, 1);
+    }
+}
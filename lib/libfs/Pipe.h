@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBFS_PIPE_H
+#define __LIB_LIBFS_PIPE_H
+
+#include <FreeNOS/User.h>
+#include <Atomic.h>
+#include <Types.h>
+#include "FileSystem.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libfs
+ * @{
+ */
+
+/**
+ * Ring buffer of bytes in memory shared between processes.
+ *
+ * The first page of the buffer holds the indices and the number of open
+ * ends, followed by the data. Each process holding an end maps the same
+ * physical pages at the same virtual address, such that bytes move with a
+ * single copy on each side and without involving a file system.
+ *
+ * Readers sleep with FutexWait until data arrives or the last write end is
+ * closed, and writers likewise until space is available or the last read
+ * end is closed. Waiters sleep on an event counter which the other side
+ * increments after each transfer and close, such that no wakeup is lost.
+ * The futex is only woken when the other side announced that it waits.
+ *
+ * @note Futex wakeups only reach processes on the same core.
+ */
+class Pipe
+{
+  public:
+
+    /** Number of data bytes the buffer can hold, must be a power of two */
+    static const Size DataSize = PAGESIZE * 4;
+
+    /** Size of the shared memory, including the header page */
+    static const Size BufferSize = DataSize + PAGESIZE;
+
+    /**
+     * State of one side of the pipe.
+     */
+    typedef struct Side
+    {
+        /** Total number of bytes moved by this side */
+        Atomic<u32> index;
+
+        /** Incremented after each transfer and close of this side */
+        Atomic<u32> events;
+
+        /** Non-zero if the other side sleeps on the events */
+        Atomic<u32> waiting;
+
+        /** Number of open ends of this side in all processes */
+        Atomic<u32> ends;
+
+        /** Serializes transfers by multiple ends */
+        Atomic<u32> lock;
+    }
+    Side;
+
+    /**
+     * Header of the shared memory.
+     */
+    typedef struct Header
+    {
+        /** Write side */
+        Side writer;
+
+        /** Read side */
+        Side reader;
+    }
+    Header;
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param buffer Address of the mapped pipe buffer
+     */
+    Pipe(const Address buffer);
+
+    /**
+     * Allocate a new pipe buffer with one read end and one write end.
+     *
+     * @param buffer On output the address of the pipe buffer
+     *
+     * @return Result code
+     */
+    static FileSystem::Result create(Address & buffer);
+
+    /**
+     * Map the pipe buffer into another process at the same address.
+     *
+     * @param pid Process identifier
+     *
+     * @return Result code
+     */
+    FileSystem::Result share(const ProcessID pid) const;
+
+    /**
+     * Unmap the pipe buffer from the current process.
+     *
+     * The memory is released once no process has it mapped.
+     */
+    void release() const;
+
+    /**
+     * Add an open end.
+     *
+     * @param writer True for a write end, false for a read end
+     */
+    void attach(const bool writer);
+
+    /**
+     * Remove an open end.
+     *
+     * Wakes up the other side, which sees end-of-file or
+     * a broken pipe once the last end of this side is closed.
+     *
+     * @param writer True for a write end, false for a read end
+     */
+    void detach(const bool writer);
+
+    /**
+     * Read bytes from the pipe.
+     *
+     * Sleeps until at least one byte is available or no write end is open.
+     *
+     * @param buffer Output buffer
+     * @param size Maximum number of bytes on input, bytes read on output.
+     *             Zero on output at end-of-file.
+     *
+     * @return Result code
+     */
+    FileSystem::Result read(void *buffer, Size *size);
+
+    /**
+     * Write bytes to the pipe.
+     *
+     * Sleeps until all bytes are written or no read end is open.
+     *
+     * @param buffer Input buffer
+     * @param size Number of bytes on input, bytes written on output.
+     *
+     * @return Result code. IOError if no read end is open.
+     */
+    FileSystem::Result write(const void *buffer, Size *size);
+
+  private:
+
+    /**
+     * Sleep until the events counter of a side changes.
+     *
+     * @param side Side to wait for
+     * @param events Last seen value of the events counter
+     */
+    void wait(Side & side, const u32 events);
+
+    /**
+     * Announce a change of a side and wakeup its waiter, if any.
+     *
+     * @param side Side which changed
+     */
+    void signal(Side & side);
+
+    /**
+     * Acquire the transfer lock of a side.
+     *
+     * @param side Side to lock
+     */
+    void lock(Side & side);
+
+    /**
+     * Release the transfer lock of a side.
+     *
+     * @param side Side to unlock
+     */
+    void unlock(Side & side);
+
+  private:
+
+    /** Shared header */
+    Header *m_header;
+
+    /** Shared data bytes */
+    u8 *m_data;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBFS_PIPE_H */
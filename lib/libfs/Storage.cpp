@@ -30,3 +30,24 @@ FileSystem::Result Storage::write(const u64 offset, void *buffer, const Size siz
 {
     return FileSystem::NotSupported;
 }
+
+FileSystem::Result Storage::submit(Request *req)
+{
+    if (req->operation == Read)
+        req->result = read(req->offset, req->buffer, req->size);
+    else
+        req->result = write(req->offset, req->buffer, req->size);
+
+    complete(req);
+    return FileSystem::Success;
+}
+
+FileSystem::Result Storage::wait()
+{
+    return FileSystem::Success;
+}
+
+void Storage::complete(Request *req)
+{
+    req->callback->execute(req);
+}
@@ -19,6 +19,7 @@
 #define __LIB_LIBFS_STORAGE_H
 
 #include <Types.h>
+#include <Callback.h>
 #include "FileSystem.h"
 
 /**
@@ -31,9 +32,40 @@
 
 /**
  * Provides a storage device to build filesystems on top.
+ *
+ * Besides the synchronous read() and write(), a Storage accepts
+ * asynchronous requests with submit(). Each submitted request completes
+ * by executing its callback with the request as parameter. By default
+ * requests are transferred synchronously inside submit(), which devices
+ * that can overlap transfers with other work should override.
  */
 class Storage
 {
+  public:
+
+    /**
+     * Transfer direction of a Request.
+     */
+    enum Operation
+    {
+        Read,
+        Write
+    };
+
+    /**
+     * Asynchronous transfer request.
+     */
+    struct Request
+    {
+        Operation operation;          /**@< Read or write the data */
+        u64 offset;                   /**@< Offset in storage to start the transfer */
+        u8 *buffer;                   /**@< Buffer with or for the data */
+        Size size;                    /**@< Number of bytes to transfer */
+        FileSystem::Result result;    /**@< Result code, valid on completion */
+        CallbackFunction *callback;   /**@< Executed with this Request on completion */
+        Request *next;                /**@< Next request in a queue */
+    };
+
   public:
 
     /**
@@ -75,12 +107,41 @@ class Storage
      */
     virtual FileSystem::Result write(const u64 offset, void *buffer, const Size size);
 
+    /**
+     * Submit an asynchronous request.
+     *
+     * The request must stay valid until its callback is executed,
+     * which may happen before this function returns. If a failure
+     * is returned instead, the callback is not executed.
+     *
+     * @param req Request to transfer
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result submit(Request *req);
+
+    /**
+     * Wait until all submitted requests are completed.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result wait();
+
     /**
      * Retrieve maximum storage capacity.
      *
      * @return Storage capacity.
      */
     virtual u64 capacity() const = 0;
+
+  protected:
+
+    /**
+     * Complete a request.
+     *
+     * @param req Request with its result set
+     */
+    void complete(Request *req);
 };
 
 /**
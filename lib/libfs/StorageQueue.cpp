@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Assert.h>
+#include <Log.h>
+#include <MemoryBlock.h>
+#include "StorageQueue.h"
+
+StorageQueue::StorageQueue(Storage *storage)
+    : m_storage(storage)
+    , m_queue(ZERO)
+    , m_active(ZERO)
+    , m_callback(this, &StorageQueue::transferDone)
+    , m_position(0)
+    , m_dispatching(false)
+    , m_transfers(0)
+    , m_merged(0)
+{
+    m_buffer = new u8[MaximumTransfer];
+    assert(m_buffer != NULL);
+}
+
+StorageQueue::~StorageQueue()
+{
+    delete[] m_buffer;
+}
+
+FileSystem::Result StorageQueue::submit(Storage::Request *req)
+{
+    if (req->size == 0 || req->buffer == ZERO)
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    // Insert after requests with the same or a lower offset
+    Storage::Request **pos = &m_queue;
+    while (*pos != ZERO && (*pos)->offset <= req->offset)
+    {
+        pos = &(*pos)->next;
+    }
+    req->next = *pos;
+    *pos = req;
+
+    dispatch();
+    return FileSystem::Success;
+}
+
+FileSystem::Result StorageQueue::wait()
+{
+    while (m_active != ZERO || m_queue != ZERO)
+    {
+        if (m_active == ZERO)
+        {
+            dispatch();
+            continue;
+        }
+
+        const Size transfers = m_transfers;
+        const FileSystem::Result result = m_storage->wait();
+        if (result != FileSystem::Success)
+        {
+            ERROR("failed to wait for storage: result = " << (int) result);
+            return result;
+        }
+
+        // The storage must have completed the transfer
+        if (m_active != ZERO && m_transfers == transfers)
+        {
+            ERROR("storage transfer at offset " << (Size) m_transfer.offset << " did not complete");
+            return FileSystem::IOError;
+        }
+    }
+
+    return FileSystem::Success;
+}
+
+bool StorageQueue::isBusy() const
+{
+    return m_active != ZERO || m_queue != ZERO;
+}
+
+Size StorageQueue::getTransfers() const
+{
+    return m_transfers;
+}
+
+Size StorageQueue::getMerged() const
+{
+    return m_merged;
+}
+
+void StorageQueue::dispatch()
+{
+    // Transfers completed inside submit() continue in the loop below
+    if (m_dispatching)
+    {
+        return;
+    }
+    m_dispatching = true;
+
+    while (m_active == ZERO && m_queue != ZERO)
+    {
+        Storage::Request *first = dequeue();
+
+        m_transfer.operation = first->operation;
+        m_transfer.offset    = first->offset;
+        m_transfer.size      = 0;
+        m_transfer.result    = FileSystem::Success;
+        m_transfer.callback  = &m_callback;
+        m_transfer.next      = ZERO;
+
+        // Merged requests are transferred via the queue buffer
+        if (first->next == ZERO)
+        {
+            m_transfer.buffer = first->buffer;
+            m_transfer.size   = first->size;
+        }
+        else
+        {
+            m_transfer.buffer = m_buffer;
+
+            for (Storage::Request *req = first; req != ZERO; req = req->next)
+            {
+                if (req->operation == Storage::Write)
+                {
+                    MemoryBlock::copy(m_buffer + m_transfer.size, req->buffer, req->size);
+                }
+                m_transfer.size += req->size;
+            }
+        }
+
+        m_active = first;
+        m_transfers++;
+
+        const FileSystem::Result result = m_storage->submit(&m_transfer);
+        if (result != FileSystem::Success)
+        {
+            ERROR("failed to submit transfer at offset " << (Size) m_transfer.offset <<
+                  ": result = " << (int) result);
+            m_transfer.result = result;
+            transferDone(&m_transfer);
+        }
+    }
+
+    m_dispatching = false;
+}
+
+Storage::Request * StorageQueue::dequeue()
+{
+    Storage::Request *prev = ZERO, *first = m_queue;
+
+    // Continue the sweep from the end of the previous transfer, or wrap around
+    while (first != ZERO && first->offset < m_position)
+    {
+        prev  = first;
+        first = first->next;
+    }
+    if (first == ZERO)
+    {
+        prev  = ZERO;
+        first = m_queue;
+    }
+
+    // Merge the requests which continue where the previous one ends
+    Storage::Request *last = first;
+    Size total = first->size;
+
+    while (last->next != ZERO &&
+           last->next->operation == first->operation &&
+           last->offset + last->size == last->next->offset &&
+           total + last->next->size <= MaximumTransfer)
+    {
+        last   = last->next;
+        total += last->size;
+        m_merged++;
+    }
+
+    // Remove the requests from the queue
+    if (prev != ZERO)
+        prev->next = last->next;
+    else
+        m_queue = last->next;
+
+    last->next = ZERO;
+    return first;
+}
+
+void StorageQueue::transferDone(Storage::Request *transfer)
+{
+    Storage::Request *req = m_active;
+    const bool merged = req->next != ZERO;
+
+    m_active   = ZERO;
+    m_position = transfer->offset + transfer->size;
+
+    // Copy out all data first, because callbacks may start the next transfer
+    for (Storage::Request *r = req; r != ZERO; r = r->next)
+    {
+        if (merged && r->operation == Storage::Read && transfer->result == FileSystem::Success)
+        {
+            MemoryBlock::copy(r->buffer, m_buffer + (r->offset - transfer->offset), r->size);
+        }
+        r->result = transfer->result;
+    }
+
+    while (req != ZERO)
+    {
+        Storage::Request *next = req->next;
+        req->next = ZERO;
+        req->callback->execute(req);
+        req = next;
+    }
+
+    dispatch();
+}
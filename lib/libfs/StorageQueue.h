@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBFS_STORAGEQUEUE_H
+#define __LIB_LIBFS_STORAGEQUEUE_H
+
+#include <Types.h>
+#include <Callback.h>
+#include "Storage.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libfs
+ * @{
+ */
+
+/**
+ * Block layer request queue in front of a Storage device.
+ *
+ * Submitted requests are kept sorted by their offset and one transfer
+ * is given to the Storage at a time. The next transfer is chosen in a
+ * single sweep over the storage (circular elevator), starting with the
+ * lowest request at or after the end of the previous transfer. Requests
+ * which continue where the chosen request ends are merged into the same
+ * transfer, up to MaximumTransfer bytes.
+ */
+class StorageQueue
+{
+  public:
+
+    /** Maximum number of bytes of merged requests in a single transfer */
+    static const Size MaximumTransfer = 64 * 1024;
+
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param storage Storage device to transfer requests with
+     */
+    StorageQueue(Storage *storage);
+
+    /**
+     * Destructor.
+     */
+    ~StorageQueue();
+
+    /**
+     * Queue an asynchronous request.
+     *
+     * The callback of the request is executed when the transfer
+     * is completed, which may happen before this function returns.
+     *
+     * @param req Request to queue
+     *
+     * @return Result code
+     */
+    FileSystem::Result submit(Storage::Request *req);
+
+    /**
+     * Wait until all queued requests are completed.
+     *
+     * @return Result code
+     */
+    FileSystem::Result wait();
+
+    /**
+     * Check if any requests are queued or in transfer.
+     *
+     * @return True if requests are not yet completed
+     */
+    bool isBusy() const;
+
+    /**
+     * Get number of transfers given to the Storage.
+     *
+     * @return Number of transfers
+     */
+    Size getTransfers() const;
+
+    /**
+     * Get number of requests merged into the transfer of another request.
+     *
+     * @return Number of merged requests
+     */
+    Size getMerged() const;
+
+  private:
+
+    /**
+     * Start transfers until the Storage is busy or the queue is empty.
+     */
+    void dispatch();
+
+    /**
+     * Remove the next transfer from the queue.
+     *
+     * @return First Request of the transfer, linked to the merged requests
+     */
+    Storage::Request * dequeue();
+
+    /**
+     * Called when the Storage completes a transfer.
+     *
+     * @param transfer Transfer request given to the Storage
+     */
+    void transferDone(Storage::Request *transfer);
+
+  private:
+
+    /** Storage device to transfer requests with */
+    Storage *m_storage;
+
+    /** Queued requests, sorted by offset */
+    Storage::Request *m_queue;
+
+    /** Requests of the current transfer, or ZERO if idle */
+    Storage::Request *m_active;
+
+    /** Current transfer given to the Storage */
+    Storage::Request m_transfer;
+
+    /** Executes transferDone() */
+    Callback<StorageQueue, Storage::Request> m_callback;
+
+    /** Buffer for transfers of merged requests */
+    u8 *m_buffer;
+
+    /** Storage offset at the end of the previous transfer */
+    u64 m_position;
+
+    /** True while dispatch() is starting transfers */
+    bool m_dispatching;
+
+    /** Number of transfers given to the Storage */
+    Size m_transfers;
+
+    /** Number of merged requests */
+    Size m_merged;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBFS_STORAGEQUEUE_H */
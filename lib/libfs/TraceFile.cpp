@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include "IOBuffer.h"
+#include "TraceFile.h"
+
+TraceFile::TraceFile(const u32 inode)
+    : File(inode)
+{
+    m_access = FileSystem::OwnerR;
+}
+
+TraceFile::~TraceFile()
+{
+}
+
+FileSystem::Result TraceFile::read(IOBuffer & buffer,
+                                   Size & size,
+                                   const Size offset)
+{
+    TraceRecord records[RecordBatch];
+    const Size maximum = size / sizeof(TraceRecord);
+    Size total = 0;
+
+    while (total < maximum)
+    {
+        const Size wanted = maximum - total < RecordBatch ? maximum - total : RecordBatch;
+        const API::Result result = TraceCtl(TraceRead, records, wanted);
+
+        if ((result & 0xffff) == API::NotFound)
+            return FileSystem::NotSupported;
+        else if ((result & 0xffff) != API::Success)
+            return FileSystem::IOError;
+
+        const Size count = result >> 16;
+        if (count == 0)
+            break;
+
+        const FileSystem::Result writeResult = buffer.write(records, count * sizeof(TraceRecord),
+                                                            total * sizeof(TraceRecord));
+        if (writeResult != FileSystem::Success)
+            return writeResult;
+
+        total += count;
+    }
+
+    size = total * sizeof(TraceRecord);
+    return FileSystem::Success;
+}
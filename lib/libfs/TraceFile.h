@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBFS_TRACEFILE_H
+#define __LIB_LIBFS_TRACEFILE_H
+
+#include <Types.h>
+#include "File.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ * @addtogroup libfs
+ * @{
+ */
+
+/**
+ * Provides a File abstraction of the kernel event trace.
+ *
+ * Reading drains binary TraceRecord entries from the kernel trace
+ * ring of the current core. A read of zero bytes means the ring is empty.
+ */
+class TraceFile : public File
+{
+  private:
+
+    /** Number of records to read from the kernel at once */
+    static const Size RecordBatch = 32;
+
+  public:
+
+    /**
+     * Default constructor.
+     *
+     * @param inode Inode number for this File
+     */
+    TraceFile(const u32 inode);
+
+    /**
+     * Destructor.
+     */
+    virtual ~TraceFile();
+
+    /**
+     * @brief Read bytes from the file.
+     *
+     * @param buffer Input/Output buffer to output bytes to.
+     * @param size Maximum number of bytes to read on input.
+     *             On output, the actual number of bytes read,
+     *             which is always a multiple of the record size.
+     * @param offset Ignored, since records are consumed when read.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result read(IOBuffer & buffer,
+                                    Size & size,
+                                    const Size offset);
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBFS_TRACEFILE_H */
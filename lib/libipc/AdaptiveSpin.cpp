@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/System.h>
+#include "AdaptiveSpin.h"
+
+AdaptiveSpin::AdaptiveSpin(const u32 limit)
+    : m_limit(limit)
+    , m_average(limit / 2)
+    , m_budget(limit)
+    , m_start(0)
+{
+}
+
+u32 AdaptiveSpin::getBudget() const
+{
+    return m_budget;
+}
+
+u32 AdaptiveSpin::getAverage() const
+{
+    return m_average;
+}
+
+void AdaptiveSpin::setLimit(const u32 limit)
+{
+    m_limit = limit;
+    update(m_average);
+}
+
+Channel::Result AdaptiveSpin::read(Channel *channel, void *buffer)
+{
+    m_start = timestamp();
+
+    do
+    {
+        if (channel->read(buffer) == Channel::Success)
+        {
+            update(timestamp() - m_start);
+            return Channel::Success;
+        }
+    }
+    while (timestamp() - m_start < m_budget);
+
+    return Channel::NotFound;
+}
+
+void AdaptiveSpin::blocked()
+{
+    update(timestamp() - m_start);
+}
+
+void AdaptiveSpin::update(const u64 latency)
+{
+    const u32 sample = latency < (u64) ~0U ? (u32) latency : ~0U;
+
+    if (sample >= m_average)
+        m_average += (sample - m_average) >> AverageShift;
+    else
+        m_average -= (m_average - sample) >> AverageShift;
+
+    // Only spin if messages typically arrive within the limit
+    m_budget = m_average <= m_limit / 2 ? m_average * 2 : 0;
+}
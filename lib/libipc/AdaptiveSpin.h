@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBIPC_ADAPTIVESPIN_H
+#define __LIBIPC_ADAPTIVESPIN_H
+
+#include <Types.h>
+#include "Channel.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libipc
+ * @{
+ */
+
+/**
+ * Polls a Channel for a limited number of cycles before the caller blocks.
+ *
+ * The spin budget is learned from the recent latencies of messages on the
+ * Channel. When messages typically arrive within the limit, the budget is
+ * twice the average latency, such that most messages are received without
+ * blocking. When messages are slower, the budget drops to zero and the
+ * caller blocks immediately instead of burning CPU cycles.
+ */
+class AdaptiveSpin
+{
+  public:
+
+    /** Default maximum spin budget in timestamp() cycles. */
+    static const u32 DefaultLimit = 20000;
+
+    /** Weight of a new latency in the moving average, as a power of two. */
+    static const Size AverageShift = 3;
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param limit Maximum spin budget in timestamp() cycles
+     */
+    AdaptiveSpin(const u32 limit = DefaultLimit);
+
+    /**
+     * Get the current spin budget.
+     *
+     * @return Number of timestamp() cycles to spin
+     */
+    u32 getBudget() const;
+
+    /**
+     * Get the average message latency.
+     *
+     * @return Average latency in timestamp() cycles
+     */
+    u32 getAverage() const;
+
+    /**
+     * Change the maximum spin budget.
+     *
+     * @param limit Maximum spin budget in timestamp() cycles
+     */
+    void setLimit(const u32 limit);
+
+    /**
+     * Poll the Channel for a message within the spin budget.
+     *
+     * Starts measuring the latency of the message. On success the
+     * latency is recorded directly. Otherwise the caller should block
+     * until the message is received and then call blocked().
+     *
+     * @param channel Channel to read from
+     * @param buffer Output buffer for the message
+     *
+     * @return Channel::Success if a message was read or Channel::NotFound otherwise
+     */
+    Channel::Result read(Channel *channel, void *buffer);
+
+    /**
+     * Record the latency of a message received after blocking.
+     */
+    void blocked();
+
+    /**
+     * Record the latency of a message.
+     *
+     * @param latency Latency in timestamp() cycles
+     */
+    void update(const u64 latency);
+
+  private:
+
+    /** Maximum spin budget */
+    u32 m_limit;
+
+    /** Moving average of the message latency */
+    u32 m_average;
+
+    /** Current spin budget */
+    u32 m_budget;
+
+    /** Timestamp at which the last read() started */
+    u64 m_start;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBIPC_ADAPTIVESPIN_H */
@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Assert.h>
+#include <Log.h>
+#include <MemoryBlock.h>
+#include "BroadcastChannel.h"
+
+BroadcastChannel::BroadcastChannel(const Channel::Mode mode,
+                                   const Size messageSize)
+    : Channel(mode, messageSize)
+    , m_maximumMessages((PAGESIZE - sizeof(BroadcastHead)) / messageSize)
+    , m_cursor(0)
+    , m_lost(0)
+{
+    assert(messageSize > 0);
+    assert(messageSize < (PAGESIZE / 2));
+}
+
+BroadcastChannel::~BroadcastChannel()
+{
+}
+
+BroadcastChannel::Result BroadcastChannel::setVirtual(const Address data,
+                                                      const Size dataSize,
+                                                      const bool hardReset)
+{
+    if (dataSize < sizeof(BroadcastHead) + (m_messageSize * 2))
+    {
+        ERROR("data size " << dataSize << " too small for message size " << m_messageSize);
+        return InvalidSize;
+    }
+
+    m_data.setBase(data);
+    m_maximumMessages = (dataSize - sizeof(BroadcastHead)) / m_messageSize;
+    m_lost = 0;
+
+    if (m_mode == Producer && hardReset)
+    {
+        const Size zero[2] = { 0, 0 };
+        m_data.write(0, sizeof(zero), zero);
+    }
+
+    // Consumers only receive messages published after subscribing
+    m_cursor = getSequence();
+    return Success;
+}
+
+BroadcastChannel::Result BroadcastChannel::setPhysical(const Address data,
+                                                       const Size dataSize,
+                                                       const bool hardReset)
+{
+    Memory::Access access = Memory::User | Memory::Readable;
+
+    if (m_mode == Producer)
+        access |= Memory::Writable;
+
+    const IO::Result result = m_data.map(data, dataSize, access);
+    if (result != IO::Success)
+    {
+        ERROR("failed to map data physical address " << (void*)data << ": " << (int)result);
+        return IOError;
+    }
+
+    return setVirtual(m_data.getBase(), dataSize, hardReset);
+}
+
+BroadcastChannel::Result BroadcastChannel::unmap()
+{
+    return m_data.unmap() == IO::Success ? Success : IOError;
+}
+
+BroadcastChannel::Result BroadcastChannel::read(void *buffer)
+{
+    if (m_mode != Consumer)
+        return InvalidMode;
+
+    while (true)
+    {
+        const Size sequence = getSequence();
+        if (sequence == m_cursor)
+            return NotFound;
+
+        // Skip messages which the producer overwrites or is about to overwrite
+        const Size reserved = getReserved();
+        if (reserved - m_cursor >= m_maximumMessages)
+        {
+            const Size oldest = reserved - m_maximumMessages + 1;
+            m_lost += oldest - m_cursor;
+            m_cursor = oldest;
+
+            if (sequence == m_cursor)
+                return NotFound;
+        }
+
+        m_data.read(getMessageOffset(m_cursor), m_messageSize, buffer);
+
+        // Retry if the producer started overwriting the message while copying
+        if (getReserved() - m_cursor >= m_maximumMessages)
+            continue;
+
+        m_cursor++;
+        return Success;
+    }
+}
+
+BroadcastChannel::Result BroadcastChannel::write(const void *buffer)
+{
+    Size written;
+
+    return writeBatch(buffer, 1, written);
+}
+
+BroadcastChannel::Result BroadcastChannel::writeBatch(const void *buffer,
+                                                      const Size count,
+                                                      Size & written)
+{
+    const u8 *messages = (const u8 *) buffer;
+    const Size reserved = m_cursor + count;
+
+    if (m_mode != Producer)
+        return InvalidMode;
+
+    // Announce the slots being overwritten before touching them
+    m_data.write(sizeof(Size), sizeof(reserved), &reserved);
+
+    for (written = 0; written < count; written++, m_cursor++)
+    {
+        m_data.write(getMessageOffset(m_cursor), m_messageSize,
+                     messages + (written * m_messageSize));
+    }
+
+    // Publish all messages with a single sequence update
+    m_data.write(0, sizeof(m_cursor), &m_cursor);
+    return Success;
+}
+
+BroadcastChannel::Result BroadcastChannel::flush()
+{
+#ifndef INTEL
+    if (m_mode != Producer)
+        return Success;
+
+    const Address base = m_data.getBase();
+    const Size size = sizeof(BroadcastHead) + (m_maximumMessages * m_messageSize);
+
+    // Flush caches in usermode via the kernel.
+    if (!isKernel)
+    {
+#ifndef __HOST__
+        Memory::Range range;
+        range.virt = base;
+        range.size = size;
+
+        const API::Result result = VMCtl(SELF, CacheClean, &range);
+        if (result != API::Success)
+        {
+            ERROR("failed to clean data cache at " << (void *) base <<
+                  ": result = " << (int) result);
+            return IOError;
+        }
+#endif /* __HOST__ */
+    }
+    // Clean the range from the cache directly
+    else
+    {
+        Arch::Cache cache;
+        cache.cleanRange(Cache::Data, base, size);
+    }
+#endif /* INTEL */
+
+    return Success;
+}
+
+BroadcastChannel::Result BroadcastChannel::wakeup()
+{
+    if (m_mode != Producer)
+        return InvalidMode;
+
+#ifndef __HOST__
+    if (!isKernel)
+    {
+        const API::Result result = ProcessCtl(SELF, FutexWake, m_data.getBase(), ~0U);
+        if ((result & 0xffff) != API::Success)
+        {
+            ERROR("failed to wakeup consumers: result = " << (int) result);
+            return IOError;
+        }
+    }
+#endif /* __HOST__ */
+
+    return Success;
+}
+
+BroadcastChannel::Result BroadcastChannel::wait()
+{
+    if (m_mode != Consumer)
+        return InvalidMode;
+
+    if (getSequence() != m_cursor)
+        return Success;
+
+#ifndef __HOST__
+    if (!isKernel)
+    {
+        const API::Result result = ProcessCtl(SELF, FutexWait, m_data.getBase(), m_cursor);
+        if (result != API::Success && result != API::TemporaryUnavailable)
+        {
+            ERROR("failed to wait for producer: result = " << (int) result);
+            return IOError;
+        }
+        return Success;
+    }
+#endif /* __HOST__ */
+
+    return NotSupported;
+}
+
+Size BroadcastChannel::getLost() const
+{
+    return m_lost;
+}
@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBIPC_BROADCASTCHANNEL_H
+#define __LIBIPC_BROADCASTCHANNEL_H
+
+#include <FreeNOS/System.h>
+#include <Types.h>
+#include "Channel.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libipc
+ * @{
+ */
+
+/**
+ * One-writer, many-reader broadcast channel using shared memory.
+ *
+ * The producer publishes fixed-size messages in a ring on the data pages,
+ * which are shared read-only with any number of consumers. There is no
+ * feedback page: each consumer keeps its own cursor, and the producer never
+ * waits for slow consumers. A consumer which falls behind by more than the
+ * ring capacity skips the overwritten messages and counts them as lost.
+ *
+ * The published sequence number in the BroadcastHead doubles as a futex,
+ * such that the producer can wakeup all waiting consumers on the same core
+ * in a single system call after publishing a batch of messages.
+ */
+class BroadcastChannel : public Channel
+{
+  private:
+
+    /** Size of a cache line in bytes, used for padding the BroadcastHead. */
+    static const Size CacheLineSize = 64U;
+
+    /**
+     * Defines in-memory ring header
+     */
+    typedef struct BroadcastHead
+    {
+        /** Sequence number of the next message to publish. */
+        Size sequence;
+
+        /** Sequence number up to which the producer is writing messages. */
+        Size reserved;
+
+        /** Padding to keep the sequence on a separate cache line. */
+        u8 padding[CacheLineSize - (sizeof(Size) * 2)];
+    }
+    BroadcastHead;
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param mode Channel mode is either a producer or consumer
+     * @param messageSize Size of each individual message in bytes
+     */
+    BroadcastChannel(const Mode mode, const Size messageSize);
+
+    /**
+     * Destructor.
+     */
+    virtual ~BroadcastChannel();
+
+    /**
+     * Set memory pages by virtual address.
+     *
+     * A consumer starts reading at the currently published sequence,
+     * thus it only receives messages published after subscribing.
+     *
+     * @param data Virtual memory address of the data pages.
+     *             Read/Write for the producer, Read-only for consumers.
+     * @param dataSize Size of the data pages in bytes.
+     * @param hardReset Producer only: true to restart at sequence zero or
+     *                  false to continue at the sequence in the data pages.
+     *
+     * @return Result code.
+     */
+    Result setVirtual(const Address data,
+                      const Size dataSize = PAGESIZE,
+                      const bool hardReset = true);
+
+    /**
+     * Set memory pages by physical address.
+     *
+     * @param data Physical memory address of the data pages.
+     * @param dataSize Size of the data pages in bytes.
+     * @param hardReset Producer only: true to restart at sequence zero.
+     *
+     * @return Result code.
+     */
+    Result setPhysical(const Address data,
+                       const Size dataSize = PAGESIZE,
+                       const bool hardReset = true);
+
+    /**
+     * Unmap memory pages from virtual address space
+     *
+     * @return Result code
+     */
+    Result unmap();
+
+    /**
+     * Read the next message.
+     *
+     * @param buffer Output buffer for the message.
+     *
+     * @return Success, NotFound if no new message is published or InvalidMode.
+     */
+    virtual Result read(void *buffer);
+
+    /**
+     * Publish a message.
+     *
+     * @param buffer Input buffer for the message.
+     *
+     * @return Result code.
+     */
+    virtual Result write(const void *buffer);
+
+    /**
+     * Publish multiple messages.
+     *
+     * Copies all messages and then updates the sequence once.
+     * Only the last ring capacity minus one messages remain readable.
+     *
+     * @param buffer Input buffer with count messages stored consecutively.
+     * @param count Number of messages in the buffer.
+     * @param written On output, the number of messages written.
+     *
+     * @return Result code.
+     */
+    virtual Result writeBatch(const void *buffer, const Size count, Size & written);
+
+    /**
+     * Flush message buffers.
+     *
+     * @return Result code.
+     */
+    virtual Result flush();
+
+    /**
+     * Wakeup all consumers waiting on this channel.
+     *
+     * @return Result code.
+     */
+    Result wakeup();
+
+    /**
+     * Wait until a new message is published.
+     *
+     * Returns immediately if a message is available.
+     *
+     * @return Result code.
+     */
+    Result wait();
+
+    /**
+     * Get the number of messages a consumer did not read in time.
+     *
+     * @return Number of lost messages
+     */
+    Size getLost() const;
+
+    bool operator == (const BroadcastChannel & ch) const
+    {
+        return false;
+    }
+
+    bool operator != (const BroadcastChannel & ch) const
+    {
+        return false;
+    }
+
+  private:
+
+    /**
+     * Read the published sequence number.
+     *
+     * @return Sequence number of the next message to be published
+     */
+    inline Size getSequence() const
+    {
+        Size sequence;
+        m_data.read(0, sizeof(sequence), &sequence);
+        return sequence;
+    }
+
+    /**
+     * Read the reserved sequence number.
+     *
+     * @return Sequence number up to which messages may be overwritten
+     */
+    inline Size getReserved() const
+    {
+        Size reserved;
+        m_data.read(sizeof(Size), sizeof(reserved), &reserved);
+        return reserved;
+    }
+
+    /**
+     * Get offset of a message in the data pages.
+     *
+     * @param sequence Sequence number of the message
+     *
+     * @return Byte offset in the data pages
+     */
+    inline Size getMessageOffset(const Size sequence) const
+    {
+        return sizeof(BroadcastHead) + ((sequence % m_maximumMessages) * m_messageSize);
+    }
+
+  private:
+
+    /** The data pages */
+    Arch::IO m_data;
+
+    /** Maximum number of messages that can be stored. */
+    Size m_maximumMessages;
+
+    /** Next sequence to publish (producer) or to read (consumer). */
+    Size m_cursor;
+
+    /** Number of messages overwritten before the consumer read them. */
+    Size m_lost;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBIPC_BROADCASTCHANNEL_H */
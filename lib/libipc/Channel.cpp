@@ -42,7 +42,28 @@ Channel::Result Channel::write(const void *buffer)
     return NotSupported;
 }
 
+Channel::Result Channel::writeBatch(const void *buffer, const Size count, Size & written)
+{
+    const u8 *messages = (const u8 *) buffer;
+
+    for (written = 0; written < count; written++)
+    {
+        const Result result = write(messages + (written * m_messageSize));
+        if (result != Success)
+        {
+            return written > 0 ? Success : result;
+        }
+    }
+
+    return Success;
+}
+
 Channel::Result Channel::flush()
 {
     return NotSupported;
 }
+
+Size Channel::pending() const
+{
+    return 0;
+}
@@ -99,6 +99,22 @@ class Channel
      */
     virtual Result write(const void *buffer);
 
+    /**
+     * Write multiple messages.
+     *
+     * The default implementation writes the messages one
+     * by one using write(). Channel implementations may override
+     * this function to publish all messages at once.
+     *
+     * @param buffer Input buffer with count messages stored consecutively.
+     * @param count Number of messages in the buffer.
+     * @param written On output, the number of messages written.
+     *
+     * @return Success if at least one message was written,
+     *         ChannelFull if no space was available or other Result code.
+     */
+    virtual Result writeBatch(const void *buffer, const Size count, Size & written);
+
     /**
      * Flush message buffers.
      *
@@ -108,6 +124,13 @@ class Channel
      */
     virtual Result flush();
 
+    /**
+     * Get the number of messages waiting to be read.
+     *
+     * @return Number of queued messages, or zero if unknown
+     */
+    virtual Size pending() const;
+
   protected:
 
     /** Channel mode. */
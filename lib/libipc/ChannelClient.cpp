@@ -47,7 +47,7 @@ ChannelClient::Result ChannelClient::connect(const ProcessID pid, const Size mes
     const SystemInformation info;
 
     // Allocate consumer
-    MemoryChannel *cons = new MemoryChannel(Channel::Consumer, messageSize);
+    MemoryChannel *cons = new MemoryChannel(Channel::Consumer, messageSize, true);
     if (!cons)
     {
         ERROR("failed to allocate consumer MemoryChannel");
@@ -55,7 +55,7 @@ ChannelClient::Result ChannelClient::connect(const ProcessID pid, const Size mes
     }
 
     // Allocate producer
-    MemoryChannel *prod = new MemoryChannel(Channel::Producer, messageSize);
+    MemoryChannel *prod = new MemoryChannel(Channel::Producer, messageSize, true);
     if (!prod)
     {
         ERROR("failed to allocate producer MemoryChannel");
@@ -81,9 +81,16 @@ ChannelClient::Result ChannelClient::connect(const ProcessID pid, const Size mes
         // from a previous shared memory channel (e.g. if a PID is re-used)
         for (Size i = 0; i < MaxConnectRetries && r == API::TemporaryUnavailable; i++)
         {
-            ProcessCtl(pid, Wakeup, 0);
-            ProcessCtl(SELF, Schedule, 0);
-            r = VMShare(pid, API::Create, &share);
+            // Wakeup the other process, yield and retry in one kernel call.
+            // The retry is skipped if the yield switched to another process.
+            MultiCallEntry calls[] =
+            {
+                { API::ProcessCtlNumber, { pid, Wakeup, 0, 0, 0 }, MULTICALL_IGNORE_ERROR, API::Success },
+                { API::ProcessCtlNumber, { SELF, Schedule, 0, 0, 0 }, 0, API::Success },
+                { API::VMShareNumber, { pid, API::Create, (Address) &share, 0, 0 }, 0, API::TemporaryUnavailable }
+            };
+            MultiCall(calls, 3);
+            r = (Error) calls[2].result;
         }
 
         if (r != API::Success)
@@ -212,8 +219,8 @@ ChannelClient::Result ChannelClient::sendRequest(const ProcessID pid,
         return IOError;
     }
 
-    // Wakeup the receiver
-    ProcessCtl(pid, Wakeup, 0);
+    // Wakeup the receiver, which handles the request at our priority
+    ProcessCtl(pid, Wakeup, InheritPriority);
     return Success;
 }
 
@@ -283,8 +290,26 @@ ChannelClient::Result ChannelClient::syncReceiveFrom(void *buffer, const Size ms
         return NotFound;
     }
 
-    while (ch->read(buffer) != Channel::Success)
-        ProcessCtl(SELF, EnterSleep, 0);
+    if (!m_spin.get(pid))
+    {
+        AdaptiveSpin *spin = new AdaptiveSpin();
+        assert(spin != NULL);
+        m_spin.insert(pid, spin);
+    }
+
+    // Poll shortly for fast replies, before blocking for a wakeup
+    AdaptiveSpin *spin = m_spin[pid];
+
+    if (spin->read(ch, buffer) != Channel::Success)
+    {
+        if (Log::instance())
+            Log::instance()->flush();
+
+        while (ch->read(buffer) != Channel::Success)
+            ProcessCtl(SELF, EnterSleep, 0);
+
+        spin->blocked();
+    }
 
     return Success;
 }
@@ -303,11 +328,12 @@ ChannelClient::Result ChannelClient::syncSendTo(const void *buffer, const Size m
         switch (ch->write(buffer))
         {
             case Channel::Success:
-                ProcessCtl(pid, Wakeup, 0);
+                // Switch directly to the receiver to handle the message
+                ProcessCtl(pid, Handoff, InheritPriority);
                 return Success;
 
             case Channel::ChannelFull:
-                ProcessCtl(pid, Wakeup, 0);
+                ProcessCtl(pid, Wakeup, InheritPriority);
                 break;
 
             default:
@@ -337,3 +363,94 @@ ChannelClient::Result ChannelClient::syncSendReceive(void *buffer, const Size ms
 
     return Success;
 }
+
+ChannelClient::Result ChannelClient::syncSendReceiveBatch(void *buffers,
+                                                          const Size count,
+                                                          const Size msgSize,
+                                                          const ProcessID pid)
+{
+    u8 *messages = (u8 *) buffers;
+    Size sent = 0, received = 0;
+
+    // Limit outstanding requests, such that all responses fit in the reply channel
+    Size limit = (PAGESIZE / msgSize) / 2;
+    if (limit > MaximumRequests)
+        limit = MaximumRequests;
+    else if (limit == 0)
+        limit = 1;
+
+    Channel *prod = findProducer(pid, msgSize);
+    Channel *cons = findConsumer(pid, msgSize);
+    if (!prod || !cons)
+    {
+        ERROR("failed to find channels for PID " << pid);
+        return NotFound;
+    }
+
+    u8 *response = new u8[msgSize];
+    assert(response != NULL);
+
+    // Assign identifiers to match responses with requests
+    for (Size i = 0; i < count; i++)
+    {
+        ((ChannelMessage *) (messages + (i * msgSize)))->identifier = i;
+    }
+
+    while (received < count)
+    {
+        const Size queued = sent;
+
+        // Queue as many requests as the channels can hold
+        if (sent < count && sent - received < limit)
+        {
+            Size batch = count - sent, written = 0;
+            if (batch > limit - (sent - received))
+                batch = limit - (sent - received);
+
+            const Channel::Result r = prod->writeBatch(messages + (sent * msgSize), batch, written);
+            if (r != Channel::Success && r != Channel::ChannelFull)
+            {
+                ERROR("failed to write to Channel for PID " << pid << ": result = " << (int) r);
+                delete[] response;
+                return IOError;
+            }
+            sent += written;
+        }
+
+        // Wakeup the receiver once for all queued requests
+        if (sent != queued)
+        {
+            ProcessCtl(pid, Wakeup, InheritPriority);
+        }
+
+        // Collect all available responses
+        bool progress = false;
+
+        while (cons->read(response) == Channel::Success)
+        {
+            const Size id = ((ChannelMessage *) response)->identifier;
+
+            if (id < sent)
+            {
+                MemoryBlock::copy(messages + (id * msgSize), response, msgSize);
+                received++;
+                progress = true;
+            }
+            else
+            {
+                ERROR("unexpected response with identifier " << id << " from PID " << pid);
+            }
+        }
+
+        if (!progress && received < count)
+        {
+            if (Log::instance())
+                Log::instance()->flush();
+
+            ProcessCtl(SELF, EnterSleep, 0);
+        }
+    }
+
+    delete[] response;
+    return Success;
+}
@@ -21,6 +21,8 @@
 #include <Singleton.h>
 #include <Callback.h>
 #include <Index.h>
+#include <HashTable.h>
+#include "AdaptiveSpin.h"
 #include "ChannelRegistry.h"
 #include "Channel.h"
 #include "ChannelMessage.h"
@@ -171,6 +173,9 @@ class ChannelClient : public StrictSingleton<ChannelClient>
     /**
      * Synchronous receive from one process.
      *
+     * Polls the channel for a learned number of cycles before
+     * sleeping, such that fast replies need no wakeup.
+     *
      * @param buffer Message buffer for output
      * @param msgSize Message size to use.
      * @param pid ProcessID for the channel
@@ -201,6 +206,26 @@ class ChannelClient : public StrictSingleton<ChannelClient>
      */
     virtual Result syncSendReceive(void *buffer, const Size msgSize, const ProcessID pid);
 
+    /**
+     * Synchronous send and receive of a batch of messages to/from one process.
+     *
+     * All messages are written to the channel before waking up the
+     * receiver, such that the receiver can process the whole batch
+     * at once. Responses are matched to the requests by their identifier
+     * and may arrive in any order.
+     *
+     * @param buffers Array of count messages to send/receive
+     * @param count Number of messages in the array
+     * @param msgSize Message size to use.
+     * @param pid ProcessID for the channel
+     *
+     * @return Result code
+     */
+    virtual Result syncSendReceiveBatch(void *buffers,
+                                        const Size count,
+                                        const Size msgSize,
+                                        const ProcessID pid);
+
   private:
 
     /**
@@ -231,6 +256,9 @@ class ChannelClient : public StrictSingleton<ChannelClient>
     /** Contains ongoing requests */
     Index<Request, MaximumRequests> m_requests;
 
+    /** Spin budget for replies per process */
+    HashTable<ProcessID, AdaptiveSpin *> m_spin;
+
     /** Current Process ID */
     const ProcessID m_pid;
 };
@@ -30,6 +30,9 @@ ChannelRegistry::~ChannelRegistry()
 
     for (HashIterator<ProcessID, Channel *> i(m_producer); i.hasCurrent(); i++)
         delete i.current();
+
+    for (HashIterator<Size, Channel *> i(m_broadcast); i.hasCurrent(); i++)
+        delete i.current();
 }
 
 Channel * ChannelRegistry::getConsumer(const ProcessID pid)
@@ -60,6 +63,20 @@ HashTable<ProcessID, Channel *> & ChannelRegistry::getProducers()
     return m_producer;
 }
 
+Channel * ChannelRegistry::getBroadcast(const Size id)
+{
+    Channel * const *ch = m_broadcast.get(id);
+    if (ch)
+        return *ch;
+    else
+        return ZERO;
+}
+
+HashTable<Size, Channel *> & ChannelRegistry::getBroadcasts()
+{
+    return m_broadcast;
+}
+
 ChannelRegistry::Result ChannelRegistry::registerConsumer(
     const ProcessID pid,
     Channel *channel)
@@ -99,3 +116,23 @@ ChannelRegistry::Result ChannelRegistry::unregisterProducer(const ProcessID pid)
     else
         return NotFound;
 }
+
+ChannelRegistry::Result ChannelRegistry::registerBroadcast(
+    const Size id,
+    Channel *channel)
+{
+    m_broadcast.insert(id, channel);
+    return Success;
+}
+
+ChannelRegistry::Result ChannelRegistry::unregisterBroadcast(const Size id)
+{
+    Channel *ch = getBroadcast(id);
+    if (ch)
+        delete ch;
+
+    if (m_broadcast.remove(id) > 0)
+        return Success;
+    else
+        return NotFound;
+}
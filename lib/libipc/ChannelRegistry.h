@@ -94,6 +94,22 @@ class ChannelRegistry
      */
     HashTable<ProcessID, Channel *> & getProducers();
 
+    /**
+     * Get one broadcast channel.
+     *
+     * @param id Identifier of the broadcast channel
+     *
+     * @return Channel pointer if found or ZERO
+     */
+    Channel * getBroadcast(const Size id);
+
+    /**
+     * Get all broadcast channels
+     *
+     * @return HashTable with all broadcast channels
+     */
+    HashTable<Size, Channel *> & getBroadcasts();
+
     /**
      * Register consumer channel.
      *
@@ -132,6 +148,28 @@ class ChannelRegistry
      */
     Result unregisterProducer(const ProcessID pid);
 
+    /**
+     * Register broadcast channel.
+     *
+     * Broadcast channels are shared by many processes, thus
+     * they are registered by an identifier instead of a ProcessID.
+     *
+     * @param id Identifier of the broadcast channel
+     * @param channel Channel object
+     *
+     * @return Result code
+     */
+    Result registerBroadcast(const Size id, Channel *channel);
+
+    /**
+     * Unregister broadcast channel.
+     *
+     * @param id Identifier of the broadcast channel
+     *
+     * @return Result code
+     */
+    Result unregisterBroadcast(const Size id);
+
   private:
 
     /** Contains registered consumer channels */
@@ -139,6 +177,9 @@ class ChannelRegistry
 
     /** Contains registered producer channels */
     HashTable<ProcessID, Channel *> m_producer;
+
+    /** Contains registered broadcast channels */
+    HashTable<Size, Channel *> m_broadcast;
 };
 
 /**
@@ -23,11 +23,15 @@
 #include <FreeNOS/ProcessEvent.h>
 #include <FreeNOS/ProcessShares.h>
 #include <HashIterator.h>
+#include <List.h>
+#include <ListIterator.h>
 #include <Timer.h>
 #include <Vector.h>
 #include "MemoryChannel.h"
 #include "ChannelClient.h"
 #include "ChannelRegistry.h"
+#include "IPCStatistics.h"
+#include "CoroutineScheduler.h"
 
 /**
  * @addtogroup lib
@@ -83,6 +87,21 @@ template <class Base, class MsgType> class ChannelServer
     /** Maximum number of IPC/IRQ handlers. */
     static const Size MaximumHandlerCount = 255u;
 
+    /** Maximum number of messages read from one channel per round. */
+    static const Size MessageBudget = 16u;
+
+    /** Maximum number of outstanding timeouts. */
+    static const Size MaximumTimeouts = 8u;
+
+    /**
+     * Outstanding timeout.
+     */
+    struct Timeout
+    {
+        Timer::Info expiry;     /**< Time at which the timeout expires */
+        u32 slack;              /**< Ticks the timeout may be delayed */
+    };
+
   protected:
 
     /** Member function pointer inside Base, to handle IPC messages. */
@@ -116,12 +135,12 @@ template <class Base, class MsgType> class ChannelServer
         , m_kernelEvent(Channel::Consumer, sizeof(ProcessEvent))
         , m_ipcHandlers()
         , m_irqHandlers()
+        , m_timeoutCount(0)
+        , m_stats(ZERO)
     {
         m_self = ProcessCtl(SELF, GetPID, 0);
-
-        // Reset timeout values
-        m_expiry.frequency = 0;
-        m_expiry.ticks = 0;
+        m_time.frequency = 0;
+        m_time.ticks = 0;
 
         // Setup kernel event channel
         const SystemInformation info;
@@ -140,6 +159,9 @@ template <class Base, class MsgType> class ChannelServer
                                      share.range.virt + PAGESIZE, false);
         }
 
+        // Share message statistics with the root file system
+        setupStatistics();
+
         // Try to recover channels after a restart
         recoverChannels();
     }
@@ -160,11 +182,17 @@ template <class Base, class MsgType> class ChannelServer
      */
     int run()
     {
+        // Mark the end of server startup in the boot timeline
+        BootMark(BootServerReady);
+
         // Enter loop
         while (true)
         {
             processAll();
-            sleepUntilWakeup();
+
+            // Only sleep once all channels are drained and nothing is polled
+            if (m_ready.count() == 0 && !m_coroutines.hasReady() && !m_instance->isPolling())
+                sleepUntilWakeup();
         }
 
         // Satify compiler
@@ -174,11 +202,16 @@ template <class Base, class MsgType> class ChannelServer
     /**
      * Set a sleep timeout
      *
+     * Each call adds a timeout, next to those which are still pending.
+     * The timeout() function is called once for all timeouts which expired.
+     *
      * @param msec Milliseconds to sleep (approximately)
+     * @param slack Milliseconds the timeout may be delayed, such that the
+     *              kernel can coalesce it with the wakeups of other processes
      */
-    void setTimeout(const uint msec)
+    void setTimeout(const uint msec, const uint slack = 0)
     {
-        DEBUG("msec = " << msec);
+        DEBUG("msec = " << msec << " slack = " << slack);
 
         if (ProcessCtl(SELF, InfoTimer, (Address) &m_time) != API::Success)
         {
@@ -187,12 +220,104 @@ template <class Base, class MsgType> class ChannelServer
         }
 
         const Size msecPerTick = 1000 / m_time.frequency;
-        m_expiry.frequency = m_time.frequency;
-        m_expiry.ticks     = m_time.ticks + ((msec / msecPerTick) + 1);
+        Timer::Info expiry;
+        expiry.frequency = m_time.frequency;
+        expiry.ticks     = m_time.ticks + ((msec / msecPerTick) + 1);
+
+        setExpiry(expiry, slack / msecPerTick);
+    }
+
+    /**
+     * Set a sleep timeout at an absolute time
+     *
+     * A timeout of which the window of expiry plus slack overlaps with a
+     * pending timeout is merged with it. When all timeouts are in use,
+     * the new timeout is absorbed by the earlier ones.
+     *
+     * @param expiry Time at which the timeout expires
+     * @param slack Ticks the timeout may be delayed
+     */
+    void setExpiry(const Timer::Info & expiry, const u32 slack = 0)
+    {
+        u32 ticks = expiry.ticks;
+        u32 deadline = expiry.ticks + slack;
+        Size index = 0;
+
+        // Merge with an overlapping timeout, within the windows of both
+        for (Size i = 0; i < m_timeoutCount; i++)
+        {
+            const u32 start = m_timeouts[i].expiry.ticks;
+            const u32 end = start + m_timeouts[i].slack;
+
+            if (start <= deadline && ticks <= end)
+            {
+                ticks    = start > ticks ? start : ticks;
+                deadline = end < deadline ? end : deadline;
+
+                for (Size j = i + 1; j < m_timeoutCount; j++)
+                    m_timeouts[j - 1] = m_timeouts[j];
+
+                m_timeoutCount--;
+                break;
+            }
+        }
+
+        // Keep the timeouts sorted on their expiry
+        while (index < m_timeoutCount && m_timeouts[index].expiry.ticks <= ticks)
+            index++;
+
+        if (m_timeoutCount == MaximumTimeouts)
+        {
+            if (index == MaximumTimeouts)
+                return;
+
+            m_timeoutCount--;
+        }
+
+        for (Size i = m_timeoutCount; i > index; i--)
+            m_timeouts[i] = m_timeouts[i - 1];
+
+        m_timeouts[index].expiry.frequency = expiry.frequency;
+        m_timeouts[index].expiry.ticks     = ticks;
+        m_timeouts[index].slack            = deadline - ticks;
+        m_timeoutCount++;
+    }
+
+    /**
+     * Check for pending timeouts
+     *
+     * @return True if at least one timeout is pending
+     */
+    bool hasTimeout() const
+    {
+        return m_timeoutCount > 0;
     }
 
   protected:
 
+    /**
+     * Start a coroutine in the event loop.
+     *
+     * The coroutine runs until its first suspension point and is resumed
+     * after notifyCoroutines() is called with the event it waits for.
+     *
+     * @param coroutine Coroutine allocated with new, owned by the server.
+     */
+    void startCoroutine(Coroutine *coroutine)
+    {
+        m_coroutines.start(coroutine);
+    }
+
+    /**
+     * Resume the coroutines waiting for an event.
+     *
+     * @param event Event address, such as the completed request.
+     */
+    void notifyCoroutines(const Address event)
+    {
+        m_coroutines.notify(event);
+    }
+
     /**
      * Register a new IPC message action handler.
      *
@@ -223,6 +348,7 @@ template <class Base, class MsgType> class ChannelServer
     {
         DEBUG("");
 
+        m_coroutines.notifyAll();
         retryAllRequests();
     }
 
@@ -236,6 +362,19 @@ template <class Base, class MsgType> class ChannelServer
         return false;
     }
 
+    /**
+     * Check if the server polls for events instead of waiting for them
+     *
+     * The server does not sleep while polling, such that
+     * retryRequests() is called again after the channels are served.
+     *
+     * @return True if polling, false otherwise
+     */
+    virtual bool isPolling() const
+    {
+        return false;
+    }
+
     /**
      * Called whenever another Process is terminated
      *
@@ -245,17 +384,68 @@ template <class Base, class MsgType> class ChannelServer
     {
     }
 
+    /**
+     * Called when another Process creates an application specific memory share
+     *
+     * @param share Memory share with a non-zero tag
+     */
+    virtual void onShareCreated(const ProcessShares::MemoryShare & share)
+    {
+    }
+
     /**
      * Keep retrying requests until all served
      */
     void retryAllRequests()
     {
         while (m_instance->retryRequests())
-            ;
+            m_stats->retries++;
     }
 
   private:
 
+    /**
+     * Allocate the message statistics.
+     *
+     * Other servers on the same core as the root file system place their
+     * statistics in memory shared with it, such that it can export them.
+     * Otherwise the statistics are only kept locally.
+     */
+    void setupStatistics()
+    {
+        if (m_self != ROOTFS_PID)
+        {
+            const SystemInformation info;
+            ProcessShares::MemoryShare share;
+            share.pid    = ROOTFS_PID;
+            share.coreId = info.coreId;
+            share.tagId  = IPCStatistics::ShareTag;
+            share.range.size = PAGESIZE;
+            share.range.virt = 0;
+            share.range.phys = 0;
+            share.range.access = Memory::User | Memory::Readable | Memory::Writable;
+
+            API::Result result = VMShare(ROOTFS_PID, API::Create, &share);
+            if (result == API::Success)
+            {
+                m_stats = (IPCStatistics *) share.range.virt;
+                m_stats->reset();
+                return;
+            }
+            // Continue counting after a restart
+            else if (result == API::AlreadyExists &&
+                     VMShare(SELF, API::Read, &share) == API::Success)
+            {
+                m_stats = (IPCStatistics *) share.range.virt;
+                return;
+            }
+        }
+
+        m_stats = new IPCStatistics;
+        assert(m_stats != NULL);
+        m_stats->reset();
+    }
+
     /**
      * Process all current events and channels.
      */
@@ -269,6 +459,9 @@ template <class Base, class MsgType> class ChannelServer
 
         // Retry requests until all served (EAGAIN or return value)
         retryAllRequests();
+
+        // Resume coroutines which were notified
+        m_coroutines.runReady();
     }
 
     /**
@@ -280,23 +473,49 @@ template <class Base, class MsgType> class ChannelServer
         // woken up by an external (wakeup) interrupt.
         DEBUG("EnterSleep");
         Address expiry = 0;
+        u32 slack = 0;
 
-        if (m_expiry.frequency)
-            expiry = (Address) &m_expiry;
+        // Sleep until the first timeout, delayed no further than any deadline
+        if (m_timeoutCount > 0)
+        {
+            const u32 first = m_timeouts[0].expiry.ticks;
+            u32 deadline = first + m_timeouts[0].slack;
 
-        const Error r = ProcessCtl(SELF, EnterSleep, expiry, (Address) (m_expiry.frequency ? &m_time : 0));
+            for (Size i = 1; i < m_timeoutCount; i++)
+            {
+                if (m_timeouts[i].expiry.ticks + m_timeouts[i].slack < deadline)
+                    deadline = m_timeouts[i].expiry.ticks + m_timeouts[i].slack;
+            }
+
+            expiry = (Address) &m_timeouts[0].expiry;
+            slack  = deadline - first;
+        }
+
+        // Write out batched log lines before going idle
+        if (Log::instance())
+            Log::instance()->flush();
+
+        const Error r = ProcessCtl(SELF, EnterSleep, expiry, slack);
         DEBUG("EnterSleep returned: " << (int)r);
 
-        // Check for sleep timeout
-        if (m_expiry.frequency)
+        // Check for sleep timeouts
+        if (m_timeoutCount > 0)
         {
             if (ProcessCtl(SELF, InfoTimer, (Address) &m_time) != API::Success)
             {
                 ERROR("failed to retrieve system timer");
             }
-            else if (m_expiry.ticks < m_time.ticks)
+            else if (m_timeouts[0].expiry.ticks <= m_time.ticks)
             {
-                m_expiry.frequency = 0;
+                Size expired = 0;
+
+                while (expired < m_timeoutCount && m_timeouts[expired].expiry.ticks <= m_time.ticks)
+                    expired++;
+
+                for (Size i = expired; i < m_timeoutCount; i++)
+                    m_timeouts[i - expired] = m_timeouts[i];
+
+                m_timeoutCount -= expired;
                 timeout();
             }
         }
@@ -332,7 +551,7 @@ template <class Base, class MsgType> class ChannelServer
         // Create consumer
         if (!m_registry.getConsumer(pid))
         {
-            MemoryChannel *consumer = new MemoryChannel(Channel::Consumer, sizeof(MsgType));
+            MemoryChannel *consumer = new MemoryChannel(Channel::Consumer, sizeof(MsgType), true);
             assert(consumer != NULL);
             consumer->setVirtual(consAddr, consAddr + PAGESIZE, hardReset);
             m_registry.registerConsumer(pid, consumer);
@@ -341,7 +560,7 @@ template <class Base, class MsgType> class ChannelServer
         // Create producer
         if (!m_registry.getProducer(pid))
         {
-            MemoryChannel *producer = new MemoryChannel(Channel::Producer, sizeof(MsgType));
+            MemoryChannel *producer = new MemoryChannel(Channel::Producer, sizeof(MsgType), true);
             assert(producer != NULL);
             producer->setVirtual(prodAddr,
                                  prodAddr + PAGESIZE,
@@ -401,8 +620,18 @@ template <class Base, class MsgType> class ChannelServer
             {
                 case ShareCreated:
                 {
-                    DEBUG(m_self << ": share created for PID: " << event.share.pid);
-                    accept(event.share.pid, event.share.range);
+                    DEBUG(m_self << ": share created for PID: " << event.share.pid <<
+                          " tag = " << event.share.tagId);
+
+                    // Only tag zero is used for channels, other shares are application specific
+                    if (event.share.tagId == 0)
+                    {
+                        accept(event.share.pid, event.share.range);
+                    }
+                    else
+                    {
+                        onShareCreated(event.share);
+                    }
                     break;
                 }
                 case InterruptEvent:
@@ -412,6 +641,14 @@ template <class Base, class MsgType> class ChannelServer
                     const MessageHandler<IRQHandlerFunction> *h = m_irqHandlers.get(event.number);
                     if (h)
                     {
+                        const u64 now = timestamp();
+                        u64 latency = now - event.timestamp;
+
+                        // Narrow 32-bit cycle counters wrap around
+                        if (now < event.timestamp)
+                            latency = (u32) latency;
+
+                        m_stats->recordInterrupt(latency);
                         (m_instance->*h->exec) (event.number);
                     }
                     else
@@ -457,69 +694,110 @@ template <class Base, class MsgType> class ChannelServer
     }
 
     /**
-     * Read each Channel for messages.
+     * Read messages from all channels with pending messages.
+     *
+     * Channels which became non-empty are only found by their ring head,
+     * without copying messages. Each ready channel is then served in
+     * round-robin order with at most MessageBudget messages. Channels which
+     * still have pending messages are served again in the next call, after
+     * any newly ready channels.
      *
      * @return Result code
      */
     Result readChannels()
     {
+        List<ProcessID> ready;
         MsgType msg;
 
-        // Try to receive message on each consumer channel
+        // Newly ready channels go before channels left over from the previous round
         for (HashIterator<ProcessID, Channel *> i(m_registry.getConsumers()); i.hasCurrent(); i++)
         {
-            Channel *ch = i.current();
-            DEBUG(m_self << ": trying to receive from PID " << i.key());
+            if (i.current()->pending() != 0 && !m_ready.contains(i.key()))
+                ready.append(i.key());
+        }
+
+        for (ListIterator<ProcessID> i(m_ready); i.hasCurrent(); i++)
+            ready.append(i.current());
+
+        m_ready.clear();
 
-            // Read all messages in the consumer channel
-            while (ch->read(&msg) == Channel::Success)
+        // Serve each ready channel up to the message budget
+        for (ListIterator<ProcessID> i(ready); i.hasCurrent(); i++)
+        {
+            const ProcessID pid = i.current();
+            Channel *ch = m_registry.getConsumer(pid);
+            Size count = 0;
+
+            if (!ch)
+                continue;
+
+            DEBUG(m_self << ": trying to receive from PID " << pid);
+
+            while (count < MessageBudget && ch->read(&msg) == Channel::Success)
             {
                 DEBUG(m_self << ": received message");
-                msg.from = i.key();
-
-                // Is the message a response from earlier client request?
-                if (msg.type == ChannelMessage::Response)
-                {
-                    if (m_client->processResponse(msg.from, &msg) != ChannelClient::Success)
-                    {
-                        ERROR(m_self << ": failed to process client response from PID " <<
-                               msg.from << " with identifier " << msg.identifier);
-                    }
-                }
-                // Message is a request to us
-                else
-                {
-                    const MessageHandler<IPCHandlerFunction> *h = m_ipcHandlers.get(msg.action);
-                    if (h)
-                    {
-                        (m_instance->*h->exec) (&msg);
-
-                        // Send reply
-                        if (h->sendReply)
-                        {
-                            Channel *ch = m_registry.getProducer(i.key());
-                            if (!ch)
-                            {
-                                ERROR(m_self << ": no producer channel found for PID: " << i.key());
-                            }
-                            else if (ch->write(&msg) != Channel::Success)
-                            {
-                                ERROR(m_self << ": failed to send reply message to PID: " << i.key());
-                            }
-                            else
-                                ProcessCtl(i.key(), Wakeup, 0);
-                        }
-                    }
-                    else
-                    {
-                        ERROR(m_self << ": invalid action " << (int)msg.action << " from PID " << i.key());
-                    }
-                }
+                msg.from = pid;
+                handleMessage(&msg, ch->pending() + 1);
+                count++;
             }
+
+            if (ch->pending() != 0)
+                m_ready.append(pid);
         }
         return Success;
     }
 
+    /**
+     * Handle a single received message.
+     *
+     * @param msg Message received from the channel of msg->from
+     * @param depth Number of queued messages at dequeue, including this message
+     */
+    void handleMessage(MsgType *msg, const Size depth)
+    {
+        // Is the message a response from earlier client request?
+        if (msg->type == ChannelMessage::Response)
+        {
+            if (m_client->processResponse(msg->from, msg) != ChannelClient::Success)
+            {
+                ERROR(m_self << ": failed to process client response from PID " <<
+                       msg->from << " with identifier " << msg->identifier);
+            }
+            return;
+        }
+
+        // Message is a request to us
+        const MessageHandler<IPCHandlerFunction> *h = m_ipcHandlers.get(msg->action);
+        if (!h)
+        {
+            ERROR(m_self << ": invalid action " << (int)msg->action << " from PID " << msg->from);
+            return;
+        }
+
+        const ProcessID from = msg->from;
+        const Size action = msg->action;
+        const u64 start = timestamp();
+
+        (m_instance->*h->exec) (msg);
+        m_stats->record(action, timestamp() - start, depth);
+
+        // Send reply
+        if (h->sendReply)
+        {
+            Channel *ch = m_registry.getProducer(from);
+            if (!ch)
+            {
+                ERROR(m_self << ": no producer channel found for PID: " << from);
+            }
+            else if (ch->write(msg) != Channel::Success)
+            {
+                ERROR(m_self << ": failed to send reply message to PID: " << from);
+            }
+            else
+                ProcessCtl(from, Handoff, 0);
+        }
+    }
+
   protected:
 
     /** Server object instance. */
@@ -546,8 +824,20 @@ template <class Base, class MsgType> class ChannelServer
     /** System timer value */
     Timer::Info m_time;
 
-    /** System timer expiration value */
-    Timer::Info m_expiry;
+    /** Outstanding timeouts, sorted on their expiry */
+    Timeout m_timeouts[MaximumTimeouts];
+
+    /** Number of outstanding timeouts */
+    Size m_timeoutCount;
+
+    /** Message handling statistics */
+    IPCStatistics *m_stats;
+
+    /** Channels with messages left after their budget, in round-robin order */
+    List<ProcessID> m_ready;
+
+    /** Coroutines of the server */
+    CoroutineScheduler m_coroutines;
 };
 
 /**
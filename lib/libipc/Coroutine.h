@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBIPC_COROUTINE_H
+#define __LIBIPC_COROUTINE_H
+
+#include <Types.h>
+#include <IntrusiveList.h>
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libipc
+ * @{
+ */
+
+/**
+ * Start the body of a coroutine.
+ *
+ * The body of Coroutine::run() must start with CO_BEGIN and end with CO_END.
+ * A suspended body resumes at the statement after the suspension point.
+ */
+#define CO_BEGIN \
+    switch (m_resumePoint) { case 0:
+
+/**
+ * Suspend until a condition is true.
+ *
+ * The coroutine is resumed when the event is notified, after which the
+ * condition is evaluated again. If the condition is already true, the
+ * coroutine continues without suspending.
+ *
+ * @param event Address identifying the event, such as the object waited for
+ * @param condition Expression which is true once the wait is complete
+ */
+#define CO_AWAIT(event, condition) \
+    do { \
+        m_resumePoint = __LINE__; \
+        m_event = (Address) (event); \
+        case __LINE__: \
+        if (!(condition)) \
+            return Coroutine::Waiting; \
+        m_event = 0; \
+    } while (0)
+
+/**
+ * Suspend and resume again in the next round of the scheduler.
+ */
+#define CO_YIELD() \
+    do { \
+        m_resumePoint = __LINE__; \
+        return Coroutine::Ready; \
+        case __LINE__:; \
+    } while (0)
+
+/**
+ * Finish the coroutine.
+ */
+#define CO_RETURN() \
+    do { \
+        m_resumePoint = 0; \
+        return Coroutine::Finished; \
+    } while (0)
+
+/**
+ * End the body of a coroutine.
+ */
+#define CO_END \
+    } m_resumePoint = 0; return Coroutine::Finished
+
+/**
+ * Stackless coroutine.
+ *
+ * Handlers which must wait for a completion, such as a storage read or
+ * an address resolution, are written as a single function which suspends
+ * with CO_AWAIT and is resumed by the CoroutineScheduler when the event
+ * is notified. This replaces continuation state in request objects.
+ *
+ * Only the resume point is kept over a suspension: the stack is not.
+ * Variables which live across a suspension must be members. A body can
+ * have at most one suspension point per source line and no switch
+ * statement around a suspension point.
+ */
+class Coroutine
+{
+  public:
+
+    /**
+     * State of a coroutine after it runs.
+     */
+    enum State
+    {
+        Ready,
+        Waiting,
+        Finished
+    };
+
+  public:
+
+    /**
+     * Constructor
+     */
+    Coroutine();
+
+    /**
+     * Destructor
+     */
+    virtual ~Coroutine();
+
+    /**
+     * Get the event the coroutine waits for.
+     *
+     * @return Event address or zero if not waiting
+     */
+    Address getEvent() const;
+
+    /**
+     * Get the state after the last run.
+     *
+     * @return State
+     */
+    State getState() const;
+
+    /**
+     * Run until the next suspension point.
+     *
+     * @return State of the coroutine
+     */
+    State resume();
+
+  protected:
+
+    /**
+     * Body of the coroutine.
+     *
+     * @return State of the coroutine
+     */
+    virtual State run() = 0;
+
+  public:
+
+    /** Links the coroutine into a list of the CoroutineScheduler. */
+    ListHook<Coroutine> hook;
+
+  protected:
+
+    /** Line of the suspension point to resume at, or zero to start. */
+    Size m_resumePoint;
+
+    /** Event the coroutine waits for or zero. */
+    Address m_event;
+
+  private:
+
+    /** State after the last run. */
+    State m_state;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBIPC_COROUTINE_H */
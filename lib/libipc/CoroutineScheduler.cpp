@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CoroutineScheduler.h"
+
+CoroutineScheduler::CoroutineScheduler()
+{
+}
+
+CoroutineScheduler::~CoroutineScheduler()
+{
+    Coroutine *coroutine;
+
+    while ((coroutine = m_ready.pop()) != ZERO)
+        delete coroutine;
+
+    while ((coroutine = m_waiting.pop()) != ZERO)
+        delete coroutine;
+}
+
+void CoroutineScheduler::start(Coroutine *coroutine)
+{
+    resume(coroutine);
+}
+
+Size CoroutineScheduler::notify(const Address event)
+{
+    Coroutine *coroutine = m_waiting.head();
+    Size count = 0;
+
+    while (coroutine)
+    {
+        Coroutine *next = m_waiting.next(coroutine);
+
+        if (coroutine->getEvent() == event)
+        {
+            m_waiting.remove(coroutine);
+            m_ready.append(coroutine);
+            count++;
+        }
+        coroutine = next;
+    }
+
+    return count;
+}
+
+void CoroutineScheduler::notifyAll()
+{
+    Coroutine *coroutine;
+
+    while ((coroutine = m_waiting.pop()) != ZERO)
+        m_ready.append(coroutine);
+}
+
+bool CoroutineScheduler::hasReady() const
+{
+    return !m_ready.isEmpty();
+}
+
+Size CoroutineScheduler::count() const
+{
+    return m_ready.count() + m_waiting.count();
+}
+
+Size CoroutineScheduler::runReady()
+{
+    CoroutineList round;
+    Coroutine *coroutine;
+    Size count = 0;
+
+    while ((coroutine = m_ready.pop()) != ZERO)
+        round.append(coroutine);
+
+    while ((coroutine = round.pop()) != ZERO)
+    {
+        resume(coroutine);
+        count++;
+    }
+
+    return count;
+}
+
+void CoroutineScheduler::resume(Coroutine *coroutine)
+{
+    switch (coroutine->resume())
+    {
+        case Coroutine::Ready:
+            m_ready.append(coroutine);
+            break;
+
+        case Coroutine::Waiting:
+            m_waiting.append(coroutine);
+            break;
+
+        case Coroutine::Finished:
+            delete coroutine;
+            break;
+    }
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBIPC_COROUTINESCHEDULER_H
+#define __LIBIPC_COROUTINESCHEDULER_H
+
+#include <Types.h>
+#include <IntrusiveList.h>
+#include "Coroutine.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libipc
+ * @{
+ */
+
+/**
+ * Runs coroutines of a single server.
+ *
+ * Coroutines are either ready to run or waiting for an event. The
+ * ChannelServer runs the ready coroutines once per round of its event
+ * loop and does not sleep while any coroutine is ready. Completion
+ * handlers call notify() with the event to make its waiters ready.
+ */
+class CoroutineScheduler
+{
+  private:
+
+    /** List of coroutines */
+    typedef IntrusiveList<Coroutine, &Coroutine::hook> CoroutineList;
+
+  public:
+
+    /**
+     * Constructor
+     */
+    CoroutineScheduler();
+
+    /**
+     * Destructor
+     *
+     * Deletes all coroutines which did not finish.
+     */
+    ~CoroutineScheduler();
+
+    /**
+     * Start a coroutine.
+     *
+     * The coroutine runs until its first suspension point. The scheduler
+     * takes ownership and deletes the coroutine once it is finished.
+     *
+     * @param coroutine Coroutine allocated with new
+     */
+    void start(Coroutine *coroutine);
+
+    /**
+     * Make the coroutines waiting for an event ready.
+     *
+     * @param event Event address
+     *
+     * @return Number of coroutines which became ready
+     */
+    Size notify(const Address event);
+
+    /**
+     * Make all waiting coroutines ready.
+     *
+     * Used when completions are not notified individually, such as on timeouts.
+     */
+    void notifyAll();
+
+    /**
+     * Check for coroutines which are ready to run.
+     *
+     * @return True if any coroutine is ready
+     */
+    bool hasReady() const;
+
+    /**
+     * Get the number of coroutines which did not finish.
+     *
+     * @return Number of ready and waiting coroutines
+     */
+    Size count() const;
+
+    /**
+     * Run each ready coroutine once.
+     *
+     * Coroutines which become ready while running are run in the next round.
+     *
+     * @return Number of coroutines which ran
+     */
+    Size runReady();
+
+  private:
+
+    /**
+     * Run a coroutine and queue it by its new state.
+     *
+     * @param coroutine Coroutine which is not on any list
+     */
+    void resume(Coroutine *coroutine);
+
+  private:
+
+    /** Coroutines which are ready to run */
+    CoroutineList m_ready;
+
+    /** Coroutines which wait for an event */
+    CoroutineList m_waiting;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBIPC_COROUTINESCHEDULER_H */
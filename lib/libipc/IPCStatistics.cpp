@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include "IPCStatistics.h"
+
+void IPCStatistics::reset()
+{
+    MemoryBlock::set(this, 0, sizeof(*this));
+}
+
+void IPCStatistics::record(const Size action, const u64 cycles, const Size depth)
+{
+    if (action >= MaximumActions)
+    {
+        unknown++;
+        return;
+    }
+
+    Handler *h = &handlers[action];
+
+    h->handled++;
+    h->cycles += cycles;
+    h->totalDepth += depth;
+    h->histogram[bucket(cycles)]++;
+
+    if (depth > h->maxDepth)
+        h->maxDepth = depth;
+}
+
+void IPCStatistics::recordInterrupt(const u64 latency)
+{
+    interrupts.handled++;
+    interrupts.cycles += latency;
+    interrupts.histogram[bucket(latency)]++;
+}
+
+Size IPCStatistics::bucket(const u64 cycles)
+{
+    Size bucket = 0;
+
+    while (bucket < HistogramBuckets - 1 && (cycles >> (bucket + 1)) != 0)
+        bucket++;
+
+    return bucket;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBIPC_IPCSTATISTICS_H
+#define __LIBIPC_IPCSTATISTICS_H
+
+#include <Types.h>
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libipc
+ * @{
+ */
+
+/**
+ * Message handling statistics of a ChannelServer.
+ *
+ * The statistics are plain data without virtual functions, such
+ * that they can be placed in a memory page shared with the root
+ * file system, which exports them as /sys/ipc/<pid>.
+ */
+class IPCStatistics
+{
+  public:
+
+    /** Number of message actions with separate statistics. */
+    static const Size MaximumActions = 32;
+
+    /** Number of log2 service time histogram buckets. */
+    static const Size HistogramBuckets = 24;
+
+    /**
+     * Memory share tag used to share statistics with the root file system.
+     *
+     * @note Must differ from the file system share tags, as every process
+     *       may also share bulk buffers and file mappings with the root file system.
+     */
+    static const Size ShareTag = 2;
+
+    /**
+     * Statistics of a single message handler.
+     */
+    typedef struct Handler
+    {
+        /** Number of messages handled. */
+        u32 handled;
+
+        /** Largest number of queued messages seen at dequeue. */
+        u32 maxDepth;
+
+        /** Sum of queued messages seen at dequeue. */
+        u64 totalDepth;
+
+        /** Total cycles spent in the handler. */
+        u64 cycles;
+
+        /** Histogram of service times, bucket N counts [2^N, 2^(N+1)) cycles. */
+        u32 histogram[HistogramBuckets];
+    }
+    Handler;
+
+  public:
+
+    /**
+     * Clear all statistics.
+     */
+    void reset();
+
+    /**
+     * Record a handled message.
+     *
+     * @param action Action of the message
+     * @param cycles Service time in cycles
+     * @param depth Number of queued messages at dequeue, including this message
+     */
+    void record(const Size action, const u64 cycles, const Size depth);
+
+    /**
+     * Record a handled interrupt.
+     *
+     * @param latency Cycles from the interrupt entry in the kernel to the handler
+     */
+    void recordInterrupt(const u64 latency);
+
+  private:
+
+    /**
+     * Get the histogram bucket of a number of cycles.
+     *
+     * @param cycles Number of cycles
+     *
+     * @return Bucket index
+     */
+    static Size bucket(const u64 cycles);
+
+  public:
+
+    /** Number of retryRequests() iterations. */
+    u32 retries;
+
+    /** Number of messages with an action beyond MaximumActions. */
+    u32 unknown;
+
+    /** Statistics per message action. */
+    Handler handlers[MaximumActions];
+
+    /** Interrupts handled, with the latency from interrupt entry as service time. */
+    Handler interrupts;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBIPC_IPCSTATISTICS_H */
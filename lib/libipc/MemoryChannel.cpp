@@ -20,11 +20,14 @@
 #include <MemoryBlock.h>
 #include "MemoryChannel.h"
 
-MemoryChannel::MemoryChannel(const Channel::Mode mode, const Size messageSize)
+MemoryChannel::MemoryChannel(const Channel::Mode mode,
+                             const Size messageSize,
+                             const bool coherent)
     : Channel(mode, messageSize)
-    , m_maximumMessages((PAGESIZE / messageSize) - 1U)
+    , m_maximumMessages((PAGESIZE - sizeof(RingHead)) / messageSize)
+    , m_coherent(coherent)
 {
-    assert(messageSize >= sizeof(RingHead));
+    assert(messageSize > 0);
     assert(messageSize < (PAGESIZE / 2));
 
     reset(true);
@@ -42,12 +45,14 @@ MemoryChannel::Result MemoryChannel::reset(const bool hardReset)
     }
     else if (m_mode == Channel::Producer)
     {
-        m_data.read(0, sizeof(m_head), &m_head);
+        m_data.read(0, sizeof(m_head.index), &m_head.index);
     }
     else if (m_mode == Channel::Consumer)
     {
-        m_feedback.read(0, sizeof(m_head), &m_head);
+        m_feedback.read(0, sizeof(m_head.index), &m_head.index);
     }
+
+    m_flushIndex = m_head.index;
     return Success;
 }
 
@@ -115,81 +120,147 @@ MemoryChannel::Result MemoryChannel::unmap()
 
 MemoryChannel::Result MemoryChannel::read(void *buffer)
 {
-    RingHead head;
+    Size writeIndex;
 
     // Read the current ring head
-    m_data.read(0, sizeof(head), &head);
+    m_data.read(0, sizeof(writeIndex), &writeIndex);
 
     // Check if a message is present
-    if (head.index == m_head.index)
+    if (writeIndex == m_head.index)
         return NotFound;
 
     // Read one message
-    m_data.read((m_head.index+1) * m_messageSize, m_messageSize, buffer);
+    m_data.read(getMessageOffset(m_head.index), m_messageSize, buffer);
 
     // Increment head index
     m_head.index = (m_head.index + 1) % m_maximumMessages;
 
     // Update read index
-    m_feedback.write(0, sizeof(m_head), &m_head);
+    m_feedback.write(0, sizeof(m_head.index), &m_head.index);
     return Success;
 }
 
 MemoryChannel::Result MemoryChannel::write(const void *buffer)
 {
-    RingHead reader;
+    Size written;
+
+    return writeBatch(buffer, 1, written);
+}
+
+MemoryChannel::Result MemoryChannel::writeBatch(const void *buffer,
+                                                const Size count,
+                                                Size & written)
+{
+    const u8 *messages = (const u8 *) buffer;
+    Size readIndex;
 
     // Read current ring head
-    m_feedback.read(0, sizeof(RingHead), &reader);
+    m_feedback.read(0, sizeof(readIndex), &readIndex);
 
-    // Check if buffer space is available for the message
-    if (((m_head.index + 1) % m_maximumMessages) == reader.index)
-        return ChannelFull;
+    // Copy messages while buffer space is available
+    for (written = 0; written < count; written++)
+    {
+        const Size next = (m_head.index + 1) % m_maximumMessages;
+        if (next == readIndex)
+            break;
+
+        m_data.write(getMessageOffset(m_head.index), m_messageSize,
+                     messages + (written * m_messageSize));
+        m_head.index = next;
+    }
 
-    // write the message
-    m_data.write((m_head.index+1) * m_messageSize, m_messageSize, buffer);
+    if (written == 0)
+        return ChannelFull;
 
-    // Increment write index
-    m_head.index = (m_head.index + 1) % m_maximumMessages;
-    m_data.write(0, sizeof(m_head), &m_head);
+    // Publish all messages with a single write index update
+    m_data.write(0, sizeof(m_head.index), &m_head.index);
     return Success;
 }
 
+Size MemoryChannel::pending() const
+{
+    Size writeIndex, readIndex;
+
+    if (m_mode == Consumer)
+    {
+        m_data.read(0, sizeof(writeIndex), &writeIndex);
+        readIndex = m_head.index;
+    }
+    else
+    {
+        m_feedback.read(0, sizeof(readIndex), &readIndex);
+        writeIndex = m_head.index;
+    }
+
+    return (writeIndex + m_maximumMessages - readIndex) % m_maximumMessages;
+}
+
 MemoryChannel::Result MemoryChannel::flush()
 {
+    if (m_coherent)
+        return Success;
+
 #ifndef INTEL
     if (m_mode == Producer)
-        flushPage(m_data.getBase());
+    {
+        const Address base = m_data.getBase();
+
+        // Flush the messages written since the previous flush, which may wrap around
+        if (m_head.index < m_flushIndex)
+        {
+            flushRange(base + getMessageOffset(m_flushIndex),
+                      (m_maximumMessages - m_flushIndex) * m_messageSize);
+            m_flushIndex = 0;
+        }
+
+        // The first message slot directly follows the ring head
+        if (m_flushIndex == 0)
+        {
+            flushRange(base, getMessageOffset(m_head.index));
+        }
+        else
+        {
+            flushRange(base + getMessageOffset(m_flushIndex),
+                      (m_head.index - m_flushIndex) * m_messageSize);
+            flushRange(base, sizeof(m_head.index));
+        }
+
+        m_flushIndex = m_head.index;
+    }
     else if (m_mode == Consumer)
-        flushPage(m_feedback.getBase());
+        flushRange(m_feedback.getBase(), sizeof(m_head.index));
 #endif /* INTEL */
 
     return Success;
 }
 
-MemoryChannel::Result MemoryChannel::flushPage(const Address page) const
+MemoryChannel::Result MemoryChannel::flushRange(const Address address, const Size size) const
 {
+    if (size == 0)
+        return Success;
+
     // Flush caches in usermode via the kernel.
     if (!isKernel)
     {
 #ifndef __HOST__
         Memory::Range range;
-        range.virt = page;
+        range.virt = address;
+        range.size = size;
 
         const API::Result result = VMCtl(SELF, CacheClean, &range);
         if (result != API::Success)
         {
-            ERROR("failed to clean data cache at " << (void *) page <<
+            ERROR("failed to clean data cache at " << (void *) address <<
                   ": result = " << (int) result);
             return IOError;
         }
 #endif /* __HOST__ */
     }
-    // Clean both pages from the cache directly
+    // Clean the range from the cache directly
     else
     {
         Arch::Cache cache;
-        cache.cleanData(page);
+        cache.cleanRange(Cache::Data, address, size);
     }
 
     return Success;
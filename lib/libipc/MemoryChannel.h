@@ -39,11 +39,18 @@
  * to the data page. The feedback page is written only by the
  * consumer, where it stores the feedback information from its
  * consumption.
+ *
+ * Each page starts with a RingHead which occupies a full cache line,
+ * such that the producer and consumer indices never share a cache line
+ * with each other or with message payloads.
  */
 class MemoryChannel : public Channel
 {
   private:
 
+    /** Size of a cache line in bytes, used for padding the RingHead. */
+    static const Size CacheLineSize = 64U;
+
     /**
      * Defines in-memory ring header
      */
@@ -51,6 +58,9 @@ class MemoryChannel : public Channel
     {
         /** Index where the ring buffer starts. */
         Size index;
+
+        /** Padding to keep the index on a separate cache line. */
+        u8 padding[CacheLineSize - sizeof(Size)];
     }
     RingHead;
 
@@ -61,8 +71,13 @@ class MemoryChannel : public Channel
      *
      * @param mode Channel mode is either a producer or consumer
      * @param messageSize Size of each individual message in bytes
+     * @param coherent True if the channel pages are cache coherent for both
+     *                 sides, such as for channels between processes on the
+     *                 same core. Coherent channels skip cache maintenance on flush.
      */
-    MemoryChannel(const Mode mode, const Size messageSize);
+    MemoryChannel(const Mode mode,
+                  const Size messageSize,
+                  const bool coherent = false);
 
     /**
      * Destructor.
@@ -130,15 +145,37 @@ class MemoryChannel : public Channel
      */
     virtual Result write(const void *buffer);
 
+    /**
+     * Write multiple messages.
+     *
+     * Copies as many messages as fit in the ring and then
+     * updates the ring head once for all of them.
+     *
+     * @param buffer Input buffer with count messages stored consecutively.
+     * @param count Number of messages in the buffer.
+     * @param written On output, the number of messages written.
+     *
+     * @return Success if at least one message was written or ChannelFull.
+     */
+    virtual Result writeBatch(const void *buffer, const Size count, Size & written);
+
     /**
      * Flush message buffers.
      *
      * Ensures that all messages are written through caches.
+     * Does nothing for coherent channels.
      *
      * @return Result code.
      */
     virtual Result flush();
 
+    /**
+     * Get the number of messages waiting to be read.
+     *
+     * @return Number of queued messages
+     */
+    virtual Size pending() const;
+
     bool operator == (const MemoryChannel & ch) const
     {
         return false;
@@ -162,13 +199,26 @@ class MemoryChannel : public Channel
     Result reset(const bool hardReset);
 
     /**
-     * Flush memory page.
+     * Flush a range of memory from the cache.
      *
-     * @param page Memory page to flush
+     * @param address Virtual address of the first byte to flush
+     * @param size Number of bytes to flush
      *
      * @return Result code.
      */
-    Result flushPage(const Address page) const;
+    Result flushRange(const Address address, const Size size) const;
+
+    /**
+     * Get offset of a message slot in the data page.
+     *
+     * @param index Index of the message slot
+     *
+     * @return Byte offset in the data page
+     */
+    inline Size getMessageOffset(const Size index) const
+    {
+        return sizeof(RingHead) + (index * m_messageSize);
+    }
 
   private:
 
@@ -183,6 +233,12 @@ class MemoryChannel : public Channel
 
     /** Local RingHead. */
     RingHead m_head;
+
+    /** Index of the first message slot written since the last flush. */
+    Size m_flushIndex;
+
+    /** True if the channel pages need no cache maintenance. */
+    const bool m_coherent;
 };
 
 /**
@@ -0,0 +1,309 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Assert.h>
+#include <Log.h>
+#include <MemoryBlock.h>
+#include "RecordChannel.h"
+
+RecordChannel::RecordChannel(const Channel::Mode mode,
+                             const Size inlineSize,
+                             const bool coherent)
+    : Channel(mode, inlineSize)
+    , m_ringSize(PAGESIZE - sizeof(RecordHead))
+    , m_overflowSize(0)
+    , m_coherent(coherent)
+{
+    assert(inlineSize > 0);
+
+    reset(true);
+}
+
+RecordChannel::~RecordChannel()
+{
+}
+
+RecordChannel::Result RecordChannel::reset(const bool hardReset)
+{
+    if (hardReset)
+    {
+        MemoryBlock::set(&m_head, 0, sizeof(m_head));
+    }
+    else if (m_mode == Channel::Producer)
+    {
+        m_data.read(0, sizeof(Size) * 2, &m_head);
+    }
+    else if (m_mode == Channel::Consumer)
+    {
+        m_feedback.read(0, sizeof(Size) * 2, &m_head);
+    }
+    return Success;
+}
+
+RecordChannel::Result RecordChannel::setVirtual(const Address data,
+                                                const Address feedback,
+                                                const Size dataSize,
+                                                const bool hardReset)
+{
+    RecordHeader largest;
+    largest.length = m_messageSize;
+    largest.flags = 0;
+
+    // The ring must hold two of the largest records, as a record never wraps
+    if (dataSize <= sizeof(RecordHead) ||
+        ((dataSize - sizeof(RecordHead)) / 2) < getRecordSize(largest) + RecordAlignment)
+    {
+        ERROR("data size " << dataSize << " too small for inline size " << m_messageSize);
+        return InvalidSize;
+    }
+
+    m_data.setBase(data);
+    m_feedback.setBase(feedback);
+    m_ringSize = (dataSize - sizeof(RecordHead)) & ~(RecordAlignment - 1);
+
+    return reset(hardReset);
+}
+
+RecordChannel::Result RecordChannel::setPhysical(const Address data,
+                                                 const Address feedback,
+                                                 const Size dataSize,
+                                                 const bool hardReset)
+{
+    Memory::Access dataAccess = Memory::User | Memory::Readable;
+    Memory::Access feedAccess = Memory::User | Memory::Readable;
+
+    switch (m_mode)
+    {
+        case Consumer:
+            feedAccess |= Memory::Writable;
+            break;
+
+        case Producer:
+            dataAccess |= Memory::Writable;
+            break;
+    }
+
+    IO::Result result = m_data.map(data, dataSize, dataAccess);
+    if (result != IO::Success)
+    {
+        ERROR("failed to map data physical address " << (void*)data << ": " << (int)result);
+        return IOError;
+    }
+
+    result = m_feedback.map(feedback, PAGESIZE, feedAccess);
+    if (result != IO::Success)
+    {
+        ERROR("failed to map feedback physical address " << (void*)feedback << ": " << (int)result);
+        return IOError;
+    }
+
+    return setVirtual(m_data.getBase(), m_feedback.getBase(), dataSize, hardReset);
+}
+
+RecordChannel::Result RecordChannel::setOverflow(const Address overflow, const Size size)
+{
+    m_overflow.setBase(overflow);
+    m_overflowSize = size;
+    return Success;
+}
+
+RecordChannel::Result RecordChannel::unmap()
+{
+    Result result = Success;
+
+    if (m_data.unmap() != IO::Success)
+    {
+        result = IOError;
+    }
+
+    if (m_feedback.unmap() != IO::Success)
+    {
+        result = IOError;
+    }
+
+    return result;
+}
+
+RecordChannel::Result RecordChannel::readRecord(void *buffer,
+                                                const Size size,
+                                                Size & length)
+{
+    RecordHeader header;
+    Size writeIndex;
+
+    // Read the current ring head
+    m_data.read(0, sizeof(writeIndex), &writeIndex);
+
+    // Check if a record is present
+    if (writeIndex == m_head.index)
+        return NotFound;
+
+    // Skip padding at the end of the ring, which is always followed by a record
+    m_data.read(getRecordOffset(m_head.index), sizeof(header), &header);
+    if (header.flags & Padding)
+    {
+        m_head.index = 0;
+
+        if (writeIndex == m_head.index)
+            return NotFound;
+
+        m_data.read(getRecordOffset(m_head.index), sizeof(header), &header);
+    }
+
+    // Leave the record in the ring if it does not fit the buffer
+    length = header.length;
+    if (length > size)
+        return InvalidSize;
+
+    // Copy the payload
+    if (header.flags & Overflow)
+    {
+        m_overflow.read(0, length, buffer);
+        m_head.overflow++;
+    }
+    else
+    {
+        m_data.read(getRecordOffset(m_head.index) + sizeof(header), length, buffer);
+    }
+
+    m_head.index = (m_head.index + getRecordSize(header)) % m_ringSize;
+
+    // Update read index and overflow acknowledgement
+    m_feedback.write(0, sizeof(Size) * 2, &m_head);
+    return Success;
+}
+
+RecordChannel::Result RecordChannel::writeRecord(const void *buffer,
+                                                 const Size length)
+{
+    RecordHeader header;
+    Size feedback[2];
+
+    header.length = length;
+    header.flags = length > m_messageSize ? Overflow : 0;
+
+    // Read the consumer's read index and overflow acknowledgement
+    m_feedback.read(0, sizeof(feedback), &feedback);
+
+    if (header.flags & Overflow)
+    {
+        if (length > m_overflowSize)
+            return InvalidSize;
+
+        // The previous overflow record must be consumed first
+        if (feedback[1] != m_head.overflow)
+            return ChannelFull;
+    }
+
+    // Records never wrap: pad the remainder of the ring if needed
+    const Size needed = getRecordSize(header);
+    const Size contiguous = m_ringSize - m_head.index;
+    const Size padding = contiguous < needed ? contiguous : 0;
+    const Size used = (m_head.index + m_ringSize - feedback[0]) % m_ringSize;
+
+    // Keep one alignment unit free to distinguish a full ring from an empty one
+    if (used + padding + needed + RecordAlignment > m_ringSize)
+        return ChannelFull;
+
+    if (padding)
+    {
+        RecordHeader pad;
+        pad.length = 0;
+        pad.flags = Padding;
+        m_data.write(getRecordOffset(m_head.index), sizeof(pad), &pad);
+        m_head.index = 0;
+    }
+
+    // Copy the payload and header
+    if (header.flags & Overflow)
+    {
+        m_overflow.write(0, length, buffer);
+        m_head.overflow++;
+    }
+    else
+    {
+        m_data.write(getRecordOffset(m_head.index) + sizeof(header), length, buffer);
+    }
+    m_data.write(getRecordOffset(m_head.index), sizeof(header), &header);
+
+    // Publish the record by updating the write index last
+    m_head.index = (m_head.index + needed) % m_ringSize;
+    m_data.write(sizeof(Size), sizeof(Size), &m_head.overflow);
+    m_data.write(0, sizeof(Size), &m_head.index);
+    return Success;
+}
+
+RecordChannel::Result RecordChannel::read(void *buffer)
+{
+    Size length;
+
+    return readRecord(buffer, m_messageSize, length);
+}
+
+RecordChannel::Result RecordChannel::write(const void *buffer)
+{
+    return writeRecord(buffer, m_messageSize);
+}
+
+RecordChannel::Result RecordChannel::flush()
+{
+    if (m_coherent)
+        return Success;
+
+#ifndef INTEL
+    if (m_mode == Producer)
+    {
+        flushRange(m_data.getBase(), sizeof(RecordHead) + m_ringSize);
+
+        if (m_overflowSize)
+            flushRange(m_overflow.getBase(), m_overflowSize);
+    }
+    else if (m_mode == Consumer)
+        flushRange(m_feedback.getBase(), sizeof(Size) * 2);
+#endif /* INTEL */
+
+    return Success;
+}
+
+RecordChannel::Result RecordChannel::flushRange(const Address base, const Size size) const
+{
+    // Flush caches in usermode via the kernel.
+    if (!isKernel)
+    {
+#ifndef __HOST__
+        Memory::Range range;
+        range.virt = base;
+        range.size = size;
+
+        const API::Result result = VMCtl(SELF, CacheClean, &range);
+        if (result != API::Success)
+        {
+            ERROR("failed to clean data cache at " << (void *) base <<
+                  ": result = " << (int) result);
+            return IOError;
+        }
+#endif /* __HOST__ */
+    }
+    // Clean the range from the cache directly
+    else
+    {
+        Arch::Cache cache;
+        cache.cleanRange(Cache::Data, base, size);
+    }
+
+    return Success;
+}
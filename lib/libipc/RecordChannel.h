@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBIPC_RECORDCHANNEL_H
+#define __LIBIPC_RECORDCHANNEL_H
+
+#include <FreeNOS/System.h>
+#include <Types.h>
+#include "Channel.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libipc
+ * @{
+ */
+
+/**
+ * Unidirectional point-to-point channel with variable-length records.
+ *
+ * Uses the same data and feedback page layout as the MemoryChannel, but
+ * the data area holds a byte ring of records instead of fixed-size message
+ * slots. Each record starts with a RecordHeader and carries its payload
+ * inline, such that small payloads are transferred without a separate copy.
+ *
+ * The message size of the channel is the maximum inline payload size.
+ * Larger records are written to optional overflow pages which are shared
+ * between producer and consumer. Only one overflow record can be in
+ * flight: the producer waits for the consumer to acknowledge it in the
+ * feedback page before reusing the overflow pages.
+ */
+class RecordChannel : public Channel
+{
+  private:
+
+    /** Size of a cache line in bytes, used for padding the RecordHead. */
+    static const Size CacheLineSize = 64U;
+
+    /** Alignment of records in the data ring. */
+    static const Size RecordAlignment = 8U;
+
+    /**
+     * Defines in-memory ring header
+     */
+    typedef struct RecordHead
+    {
+        /** Byte offset in the ring where the next record starts. */
+        Size index;
+
+        /** Number of overflow records written (data) or consumed (feedback). */
+        Size overflow;
+
+        /** Padding to keep the indices on a separate cache line. */
+        u8 padding[CacheLineSize - (sizeof(Size) * 2)];
+    }
+    RecordHead;
+
+    /**
+     * Record flags
+     */
+    enum RecordFlags
+    {
+        Padding  = 1 << 0,
+        Overflow = 1 << 1
+    };
+
+    /**
+     * Header in front of each record in the ring
+     */
+    typedef struct RecordHeader
+    {
+        /** Payload length in bytes. */
+        u32 length;
+
+        /** Record flags. */
+        u32 flags;
+    }
+    RecordHeader;
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param mode Channel mode is either a producer or consumer
+     * @param inlineSize Maximum payload size in bytes of records stored in the ring
+     * @param coherent True if the channel pages are cache coherent for both sides.
+     *                 Coherent channels skip cache maintenance on flush.
+     */
+    RecordChannel(const Mode mode,
+                  const Size inlineSize,
+                  const bool coherent = false);
+
+    /**
+     * Destructor.
+     */
+    virtual ~RecordChannel();
+
+    /**
+     * Set memory pages by virtual address.
+     *
+     * @param data Virtual memory address of the data pages.
+     *             Read/Write for the producer, Read-only for the consumer.
+     * @param feedback Virtual memory address of the feedback page.
+     *        Read/write for the consumer, read-only for the producer.
+     * @param dataSize Size of the data pages in bytes. Must hold at least
+     *                 two records of the maximum inline size.
+     * @param hardReset Perform a hard reset after setting pages.
+     *
+     * @return Result code.
+     */
+    Result setVirtual(const Address data,
+                      const Address feedback,
+                      const Size dataSize = PAGESIZE,
+                      const bool hardReset = true);
+
+    /**
+     * Set memory pages by physical address.
+     *
+     * @param data Physical memory address of the data pages.
+     * @param feedback Physical memory address of the feedback page.
+     * @param dataSize Size of the data pages in bytes.
+     * @param hardReset Perform a hard reset after setting pages.
+     *
+     * @return Result code.
+     */
+    Result setPhysical(const Address data,
+                       const Address feedback,
+                       const Size dataSize = PAGESIZE,
+                       const bool hardReset = true);
+
+    /**
+     * Attach overflow pages for records larger than the inline size.
+     *
+     * @param overflow Virtual memory address of the overflow pages.
+     *                 Read/Write for the producer, Read-only for the consumer.
+     * @param size Size of the overflow pages in bytes.
+     *
+     * @return Result code.
+     */
+    Result setOverflow(const Address overflow, const Size size);
+
+    /**
+     * Unmap memory pages from virtual address space
+     *
+     * @return Result code
+     */
+    Result unmap();
+
+    /**
+     * Read a record.
+     *
+     * @param buffer Output buffer for the record payload.
+     * @param size Size of the output buffer in bytes.
+     * @param length On output, the payload length of the record.
+     *
+     * @return Success if a record was read, NotFound if the channel is empty or
+     *         InvalidSize if the record does not fit in the buffer. In that case
+     *         the record is not consumed and length contains the required size.
+     */
+    Result readRecord(void *buffer, const Size size, Size & length);
+
+    /**
+     * Write a record.
+     *
+     * @param buffer Input buffer with the record payload.
+     * @param length Payload length in bytes.
+     *
+     * @return Success if the record was written, ChannelFull if no space is
+     *         available or InvalidSize if the record is too large.
+     */
+    Result writeRecord(const void *buffer, const Size length);
+
+    /**
+     * Read a record of at most the inline size.
+     *
+     * @param buffer Output buffer for the message.
+     *
+     * @return Result code.
+     */
+    virtual Result read(void *buffer);
+
+    /**
+     * Write a record of exactly the inline size.
+     *
+     * @param buffer Input buffer for the message.
+     *
+     * @return Result code.
+     */
+    virtual Result write(const void *buffer);
+
+    /**
+     * Flush message buffers.
+     *
+     * Ensures that all records are written through caches.
+     * Does nothing for coherent channels.
+     *
+     * @return Result code.
+     */
+    virtual Result flush();
+
+  private:
+
+    /**
+     * Reset to initial state.
+     *
+     * @param hardReset True to start at the beginning of the ring or
+     *                  false to read the RecordHead back from the pages.
+     *
+     * @return Result code.
+     */
+    Result reset(const bool hardReset);
+
+    /**
+     * Flush a range of memory from the cache.
+     *
+     * @param base Virtual address of the first byte to flush
+     * @param size Number of bytes to flush
+     *
+     * @return Result code.
+     */
+    Result flushRange(const Address base, const Size size) const;
+
+    /**
+     * Get the number of ring bytes occupied by a record.
+     *
+     * @param header Record header
+     *
+     * @return Size in bytes including the RecordHeader
+     */
+    inline Size getRecordSize(const RecordHeader & header) const
+    {
+        const Size payload = (header.flags & Overflow) ? 0 : header.length;
+
+        return sizeof(RecordHeader) +
+            ((payload + RecordAlignment - 1) & ~(RecordAlignment - 1));
+    }
+
+    /**
+     * Get offset of a ring position in the data pages.
+     *
+     * @param index Byte offset in the ring
+     *
+     * @return Byte offset in the data pages
+     */
+    inline Size getRecordOffset(const Size index) const
+    {
+        return sizeof(RecordHead) + index;
+    }
+
+  private:
+
+    /** The data pages */
+    Arch::IO m_data;
+
+    /** The feedback page */
+    Arch::IO m_feedback;
+
+    /** The overflow pages */
+    Arch::IO m_overflow;
+
+    /** Size of the ring in the data pages in bytes. */
+    Size m_ringSize;
+
+    /** Size of the overflow pages in bytes, or zero if not attached. */
+    Size m_overflowSize;
+
+    /** Local RecordHead. */
+    RecordHead m_head;
+
+    /** True if the channel pages need no cache maintenance. */
+    const bool m_coherent;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBIPC_RECORDCHANNEL_H */
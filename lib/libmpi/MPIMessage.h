@@ -18,6 +18,8 @@
 #ifndef __LIBMPI_MPIMESSAGE_H
 #define __LIBMPI_MPIMESSAGE_H
 
+#include <Types.h>
+
 /**
  * @addtogroup lib
  * @{
@@ -26,13 +28,27 @@
  * @{
  */
 
+/**
+ * Message in a MemoryChannel between MPI processes.
+ *
+ * Each message carries a run of data elements as raw bytes,
+ * such that a buffer is transferred in a few large messages.
+ * Large buffers are described by physical address instead (rendezvous),
+ * which the receiver copies from directly.
+ */
 typedef struct MPIMessage
 {
-    union
-    {
-        int integer;
-        u8 uchar;
-    };
+    /** Number of payload bytes in a message */
+    static const Size PayloadSize = 252;
+
+    /** Flag in size which marks a rendezvous descriptor instead of inline data */
+    static const u32 Rendezvous = (1U << 31);
+
+    /** Number of valid bytes in data */
+    u32 size;
+
+    /** Packed data elements */
+    u8 data[PayloadSize];
 }
 MPIMessage;
 
@@ -0,0 +1,678 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include "MpiBackend.h"
+
+/**
+ * Combine arrays element-wise.
+ *
+ * Plain loops without dependencies between elements, such that
+ * the compiler can vectorize them.
+ */
+template <class T> static void combineElements(const MPI_Op op,
+                                               T *inout,
+                                               const T *in,
+                                               const Size count)
+{
+    switch (op)
+    {
+        case MPI_MAX:
+            for (Size i = 0; i < count; i++)
+                inout[i] = inout[i] > in[i] ? inout[i] : in[i];
+            break;
+
+        case MPI_MIN:
+            for (Size i = 0; i < count; i++)
+                inout[i] = inout[i] < in[i] ? inout[i] : in[i];
+            break;
+
+        case MPI_SUM:
+            for (Size i = 0; i < count; i++)
+                inout[i] += in[i];
+            break;
+
+        case MPI_LAND:
+            for (Size i = 0; i < count; i++)
+                inout[i] = (inout[i] != 0) & (in[i] != 0);
+            break;
+    }
+}
+
+MpiBackend::MpiBackend()
+    : m_serial(0)
+{
+}
+
+MpiBackend::Result MpiBackend::startSend(const void *buf,
+                                         int count,
+                                         MPI_Datatype datatype,
+                                         int dest,
+                                         int tag,
+                                         MPI_Comm comm,
+                                         MPI_Request *request)
+{
+    return startRequest(true, (void *) buf, count, datatype, dest, tag, comm, request);
+}
+
+MpiBackend::Result MpiBackend::startReceive(void *buf,
+                                            int count,
+                                            MPI_Datatype datatype,
+                                            int source,
+                                            int tag,
+                                            MPI_Comm comm,
+                                            MPI_Request *request)
+{
+    return startRequest(false, buf, count, datatype, source, tag, comm, request);
+}
+
+MpiBackend::Result MpiBackend::wait(MPI_Request *request,
+                                   MPI_Status *status)
+{
+    Request *req = getRequest(*request);
+
+    if (req == ZERO)
+    {
+        return *request == MPI_REQUEST_NULL ? MPI_SUCCESS : MPI_ERR_REQUEST;
+    }
+
+    while (!req->complete)
+    {
+        if (progressAll() == 0 && !req->complete)
+        {
+            waitIdle();
+        }
+    }
+
+    return finish(request);
+}
+
+MpiBackend::Result MpiBackend::test(MPI_Request *request,
+                                   int *flag,
+                                   MPI_Status *status)
+{
+    Request *req = getRequest(*request);
+
+    if (req == ZERO)
+    {
+        *flag = *request == MPI_REQUEST_NULL;
+        return *request == MPI_REQUEST_NULL ? MPI_SUCCESS : MPI_ERR_REQUEST;
+    }
+
+    if (!req->complete)
+    {
+        progressAll();
+    }
+
+    *flag = req->complete;
+    return req->complete ? finish(request) : MPI_SUCCESS;
+}
+
+MpiBackend::Result MpiBackend::waitAll(int count,
+                                      MPI_Request *requests,
+                                      MPI_Status *statuses)
+{
+    Result result = MPI_SUCCESS;
+    bool done = false;
+
+    // Verify all handles before waiting
+    for (int i = 0; i < count; i++)
+    {
+        if (requests[i] != MPI_REQUEST_NULL && getRequest(requests[i]) == ZERO)
+        {
+            return MPI_ERR_REQUEST;
+        }
+    }
+
+    // Advance all requests together until each is complete
+    while (!done)
+    {
+        done = true;
+
+        for (int i = 0; i < count && done; i++)
+        {
+            const Request *req = getRequest(requests[i]);
+            done = req == ZERO || req->complete;
+        }
+
+        if (!done && progressAll() == 0)
+        {
+            waitIdle();
+        }
+    }
+
+    // Release the requests and report the first error
+    for (int i = 0; i < count; i++)
+    {
+        const Result finishResult = finish(&requests[i]);
+        if (result == MPI_SUCCESS)
+        {
+            result = finishResult;
+        }
+    }
+
+    return result;
+}
+
+MpiBackend::Result MpiBackend::barrier(MPI_Comm comm)
+{
+    u8 token = 0, result;
+
+    // The hub answers once every rank arrived
+    return allReduce(&token, &result, 1, MPI_UNSIGNED_CHAR, MPI_SUM, comm);
+}
+
+MpiBackend::Result MpiBackend::broadcast(void *buffer,
+                                         int count,
+                                         MPI_Datatype datatype,
+                                         int root,
+                                         MPI_Comm comm)
+{
+    int rank, size;
+
+    const Result topoResult = getTopology(comm, root, rank, size);
+    if (topoResult != MPI_SUCCESS)
+    {
+        return topoResult;
+    }
+
+    // Other roots first pass the data to the hub
+    if (root != 0)
+    {
+        Result result = MPI_SUCCESS;
+
+        if (rank == root)
+        {
+            result = send(buffer, count, datatype, 0, 0, comm);
+        }
+        else if (rank == 0)
+        {
+            result = receive(buffer, count, datatype, root, 0, comm, ZERO);
+        }
+
+        if (result != MPI_SUCCESS)
+        {
+            return result;
+        }
+    }
+
+    if (rank == 0)
+    {
+        return exchange(true, (u8 *) buffer, 0, count, datatype, size, root, comm);
+    }
+    else if (rank != root)
+    {
+        return receive(buffer, count, datatype, 0, 0, comm, ZERO);
+    }
+
+    return MPI_SUCCESS;
+}
+
+MpiBackend::Result MpiBackend::reduce(const void *sendbuf,
+                                      void *recvbuf,
+                                      int count,
+                                      MPI_Datatype datatype,
+                                      MPI_Op op,
+                                      int root,
+                                      MPI_Comm comm)
+{
+    const Size bytes = count * MpiDatatype::getSize(datatype);
+    int rank, size;
+
+    const Result topoResult = getTopology(comm, root, rank, size);
+    if (topoResult != MPI_SUCCESS)
+    {
+        return topoResult;
+    }
+
+    if (!MpiDatatype::isBasic(datatype))
+    {
+        return MPI_ERR_TYPE;
+    }
+
+    if (op != MPI_MAX && op != MPI_MIN && op != MPI_SUM && op != MPI_LAND)
+    {
+        return MPI_ERR_OP;
+    }
+
+    // Contribute to the hub and wait for the result at the root
+    if (rank != 0)
+    {
+        Result result = send(sendbuf, count, datatype, 0, 0, comm);
+
+        if (result == MPI_SUCCESS && rank == root)
+        {
+            result = receive(recvbuf, count, datatype, 0, 0, comm, ZERO);
+        }
+        return result;
+    }
+
+    // The hub receives the contributions of all ranks concurrently
+    u8 *parts = new u8[bytes * size];
+    if (!parts)
+    {
+        return MPI_ERR_NO_MEM;
+    }
+
+    Result result = exchange(false, parts, bytes, count, datatype, size, 0, comm);
+    if (result == MPI_SUCCESS)
+    {
+        u8 *target = root == 0 ? (u8 *) recvbuf : parts;
+
+        // Combine in rank order, such that the result does not depend on timing
+        MemoryBlock::copy(target, sendbuf, bytes);
+
+        for (int i = 1; i < size; i++)
+        {
+            combine(op, datatype, target, parts + (bytes * i), count);
+        }
+
+        if (root != 0)
+        {
+            result = send(target, count, datatype, root, 0, comm);
+        }
+    }
+
+    delete[] parts;
+    return result;
+}
+
+MpiBackend::Result MpiBackend::allReduce(const void *sendbuf,
+                                         void *recvbuf,
+                                         int count,
+                                         MPI_Datatype datatype,
+                                         MPI_Op op,
+                                         MPI_Comm comm)
+{
+    const Result reduceResult = reduce(sendbuf, recvbuf, count, datatype, op, 0, comm);
+    if (reduceResult != MPI_SUCCESS)
+    {
+        return reduceResult;
+    }
+
+    return broadcast(recvbuf, count, datatype, 0, comm);
+}
+
+MpiBackend::Result MpiBackend::gather(const void *sendbuf,
+                                      void *recvbuf,
+                                      int count,
+                                      MPI_Datatype datatype,
+                                      int root,
+                                      MPI_Comm comm)
+{
+    const Size bytes = count * MpiDatatype::getExtent(datatype);
+    int rank, size;
+
+    const Result topoResult = getTopology(comm, root, rank, size);
+    if (topoResult != MPI_SUCCESS)
+    {
+        return topoResult;
+    }
+
+    // Contribute to the hub, the root receives all parts from the hub
+    if (rank != 0)
+    {
+        Result result = send(sendbuf, count, datatype, 0, 0, comm);
+
+        if (result == MPI_SUCCESS && rank == root)
+        {
+            result = receive(recvbuf, count * size, datatype, 0, 0, comm, ZERO);
+        }
+        return result;
+    }
+
+    u8 *target = root == 0 ? (u8 *) recvbuf : new u8[bytes * size];
+    if (!target)
+    {
+        return MPI_ERR_NO_MEM;
+    }
+
+    // The hub receives the parts of all ranks concurrently
+    MpiDatatype::copy(target, sendbuf, count, datatype);
+    Result result = exchange(false, target, bytes, count, datatype, size, 0, comm);
+
+    if (root != 0)
+    {
+        if (result == MPI_SUCCESS)
+        {
+            result = send(target, count * size, datatype, root, 0, comm);
+        }
+        delete[] target;
+    }
+
+    return result;
+}
+
+MpiBackend::Result MpiBackend::scatter(const void *sendbuf,
+                                       void *recvbuf,
+                                       int count,
+                                       MPI_Datatype datatype,
+                                       int root,
+                                       MPI_Comm comm)
+{
+    const Size bytes = count * MpiDatatype::getExtent(datatype);
+    u8 *source = (u8 *) sendbuf;
+    int rank, size;
+
+    const Result topoResult = getTopology(comm, root, rank, size);
+    if (topoResult != MPI_SUCCESS)
+    {
+        return topoResult;
+    }
+
+    // Other roots pass all parts to the hub, then receive their own part back
+    if (rank != 0)
+    {
+        Result result = MPI_SUCCESS;
+
+        if (rank == root)
+        {
+            result = send(sendbuf, count * size, datatype, 0, 0, comm);
+        }
+
+        if (result == MPI_SUCCESS)
+        {
+            result = receive(recvbuf, count, datatype, 0, 0, comm, ZERO);
+        }
+        return result;
+    }
+
+    if (root != 0)
+    {
+        source = new u8[bytes * size];
+        if (!source)
+        {
+            return MPI_ERR_NO_MEM;
+        }
+
+        const Result recvResult = receive(source, count * size, datatype, root, 0, comm, ZERO);
+        if (recvResult != MPI_SUCCESS)
+        {
+            delete[] source;
+            return recvResult;
+        }
+    }
+
+    // The hub sends the parts to all ranks concurrently
+    MpiDatatype::copy(recvbuf, source, count, datatype);
+    const Result result = exchange(true, source, bytes, count, datatype, size, 0, comm);
+
+    if (root != 0)
+    {
+        delete[] source;
+    }
+
+    return result;
+}
+
+MpiBackend::Result MpiBackend::progress(Request *request)
+{
+    const Result result = request->send ?
+        send(request->buffer, request->count, request->datatype,
+             request->peer, request->tag, request->comm) :
+        receive(request->buffer, request->count, request->datatype,
+                request->peer, request->tag, request->comm, ZERO);
+
+    request->complete = true;
+    return result;
+}
+
+void MpiBackend::waitIdle()
+{
+}
+
+MpiBackend::Result MpiBackend::getTopology(MPI_Comm comm,
+                                           const int root,
+                                           int & rank,
+                                           int & size)
+{
+    Result result = getCommRank(comm, &rank);
+    if (result != MPI_SUCCESS)
+    {
+        return result;
+    }
+
+    result = getCommSize(comm, &size);
+    if (result != MPI_SUCCESS)
+    {
+        return result;
+    }
+
+    return root < 0 || root >= size ? MPI_ERR_ROOT : MPI_SUCCESS;
+}
+
+MpiBackend::Result MpiBackend::exchange(const bool send,
+                                        u8 *buffer,
+                                        const Size stride,
+                                        const int count,
+                                        const MPI_Datatype datatype,
+                                        const int size,
+                                        const int skip,
+                                        MPI_Comm comm)
+{
+    MPI_Request requests[CollectiveBatch];
+    Result result = MPI_SUCCESS;
+    Size pending = 0;
+
+    for (int i = 1; i < size && result == MPI_SUCCESS; i++)
+    {
+        if (i == skip)
+        {
+            continue;
+        }
+
+        u8 *part = buffer + (stride * i);
+        result = send ? startSend(part, count, datatype, i, 0, comm, &requests[pending]) :
+                        startReceive(part, count, datatype, i, 0, comm, &requests[pending]);
+        if (result == MPI_SUCCESS)
+        {
+            pending++;
+        }
+
+        // Limit the number of outstanding requests
+        if (pending == CollectiveBatch)
+        {
+            result = waitAll(pending, requests, ZERO);
+            pending = 0;
+        }
+    }
+
+    if (pending > 0)
+    {
+        const Result waitResult = waitAll(pending, requests, ZERO);
+        if (result == MPI_SUCCESS)
+        {
+            result = waitResult;
+        }
+    }
+
+    return result;
+}
+
+void MpiBackend::combine(const MPI_Op op,
+                         const MPI_Datatype datatype,
+                         void *inout,
+                         const void *in,
+                         const Size count)
+{
+    switch (datatype)
+    {
+        case MPI_CHAR:
+            combineElements<char>(op, (char *) inout, (const char *) in, count);
+            break;
+
+        case MPI_SHORT:
+            combineElements<short>(op, (short *) inout, (const short *) in, count);
+            break;
+
+        case MPI_LONG:
+            combineElements<long>(op, (long *) inout, (const long *) in, count);
+            break;
+
+        case MPI_INT:
+            combineElements<int>(op, (int *) inout, (const int *) in, count);
+            break;
+
+        case MPI_UNSIGNED_CHAR:
+        case MPI_BYTE:
+            combineElements<u8>(op, (u8 *) inout, (const u8 *) in, count);
+            break;
+
+        case MPI_UNSIGNED_SHORT:
+            combineElements<unsigned short>(op, (unsigned short *) inout, (const unsigned short *) in, count);
+            break;
+
+        case MPI_UNSIGNED:
+            combineElements<unsigned>(op, (unsigned *) inout, (const unsigned *) in, count);
+            break;
+
+        case MPI_UNSIGNED_LONG:
+            combineElements<unsigned long>(op, (unsigned long *) inout, (const unsigned long *) in, count);
+            break;
+
+        case MPI_LONG_LONG:
+            combineElements<long long>(op, (long long *) inout, (const long long *) in, count);
+            break;
+
+        case MPI_UNSIGNED_LONG_LONG:
+            combineElements<unsigned long long>(op, (unsigned long long *) inout,
+                                                (const unsigned long long *) in, count);
+            break;
+
+        case MPI_FLOAT:
+            combineElements<float>(op, (float *) inout, (const float *) in, count);
+            break;
+
+        case MPI_DOUBLE:
+            combineElements<double>(op, (double *) inout, (const double *) in, count);
+            break;
+
+        default:
+            break;
+    }
+}
+
+MpiBackend::Result MpiBackend::startRequest(const bool send,
+                                            void *buf,
+                                            int count,
+                                            MPI_Datatype datatype,
+                                            int peer,
+                                            int tag,
+                                            MPI_Comm comm,
+                                            MPI_Request *request)
+{
+    Size position = 0;
+
+    if (count < 0)
+    {
+        return MPI_ERR_COUNT;
+    }
+
+    Request *req = new Request;
+    if (!req)
+    {
+        return MPI_ERR_NO_MEM;
+    }
+
+    req->send = send;
+    req->buffer = (u8 *) buf;
+    req->count = count;
+    req->datatype = datatype;
+    req->peer = peer;
+    req->tag = tag;
+    req->comm = comm;
+    req->serial = m_serial++;
+    req->offset = 0;
+    req->complete = false;
+    req->result = MPI_SUCCESS;
+
+    // Handles start at one, such that zero is MPI_REQUEST_NULL
+    if (!m_requests.insert(position, req))
+    {
+        delete req;
+        return MPI_ERR_NO_MEM;
+    }
+    *request = position + 1;
+    return MPI_SUCCESS;
+}
+
+Size MpiBackend::progressAll()
+{
+    Size progressed = 0;
+
+    for (Size i = 0; i < MaximumRequests; i++)
+    {
+        Request *req = m_requests.get(i);
+        bool blocked = false;
+
+        if (req == ZERO || req->complete)
+        {
+            continue;
+        }
+
+        // Older requests on the same channel must complete first
+        for (Size j = 0; j < MaximumRequests && !blocked; j++)
+        {
+            const Request *other = m_requests.get(j);
+
+            blocked = other != ZERO && !other->complete &&
+                      other->send == req->send && other->peer == req->peer &&
+                      (s32) (other->serial - req->serial) < 0;
+        }
+
+        if (blocked)
+        {
+            continue;
+        }
+
+        const Size offset = req->offset;
+
+        req->result = progress(req);
+        if (req->result != MPI_SUCCESS)
+        {
+            req->complete = true;
+        }
+
+        if (req->complete || req->offset != offset)
+        {
+            progressed++;
+        }
+    }
+
+    return progressed;
+}
+
+MpiBackend::Request * MpiBackend::getRequest(const MPI_Request handle) const
+{
+    return handle == MPI_REQUEST_NULL ? ZERO : m_requests.get(handle - 1);
+}
+
+MpiBackend::Result MpiBackend::finish(MPI_Request *request)
+{
+    Request *req = getRequest(*request);
+
+    if (req == ZERO)
+    {
+        return MPI_SUCCESS;
+    }
+
+    const Result result = req->result;
+    m_requests.remove(*request - 1);
+    delete req;
+    *request = MPI_REQUEST_NULL;
+    return result;
+}
@@ -20,6 +20,8 @@
 
 #include <Types.h>
 #include <Factory.h>
+#include <Index.h>
+#include "MpiDatatype.h"
 #include "mpi.h"
 
 /**
@@ -32,6 +34,17 @@
 
 /**
  * Represents a Message Passing Interface (MPI) implementation backend.
+ *
+ * Non-blocking operations are kept as requests which are advanced by
+ * progress() from wait() and test(). Requests to the same peer in the
+ * same direction complete in the order in which they are started.
+ *
+ * Collective operations are built on the point-to-point operations. Ranks
+ * only have a channel to rank zero, thus rank zero acts as the hub which
+ * exchanges data with all other ranks concurrently.
+ *
+ * @note Blocking send() and receive() are not ordered against outstanding
+ *       requests to the same peer. Wait for those requests first.
  */
 class MpiBackend : public AbstractFactory<MpiBackend>
 {
@@ -46,8 +59,39 @@ class MpiBackend : public AbstractFactory<MpiBackend>
      */
     typedef int Result;
 
+    /** Maximum number of outstanding non-blocking requests */
+    static const Size MaximumRequests = 64;
+
+    /** Maximum number of requests started at once by collective operations */
+    static const Size CollectiveBatch = 32;
+
+  protected:
+
+    /**
+     * Non-blocking send or receive operation
+     */
+    struct Request
+    {
+        bool send;             /**< True for a send, false for a receive */
+        u8 *buffer;            /**< Input or output data buffer */
+        int count;             /**< Number of data items */
+        MPI_Datatype datatype; /**< Type of data */
+        int peer;              /**< Destination or source (core id) */
+        int tag;               /**< Data identifier */
+        MPI_Comm comm;         /**< Communication reference */
+        u32 serial;            /**< Order in which the request was started */
+        Size offset;           /**< Number of bytes transferred so far */
+        bool complete;         /**< True when the transfer is finished */
+        Result result;         /**< Result code of the transfer */
+    };
+
   public:
 
+    /**
+     * Constructor
+     */
+    MpiBackend();
+
     /**
      * Initialize the backend
      *
@@ -127,6 +171,323 @@ class MpiBackend : public AbstractFactory<MpiBackend>
                            int tag,
                            MPI_Comm comm,
                            MPI_Status *status) = 0;
+
+    /**
+     * Start non-blocking send
+     *
+     * @param buf Input data buffer
+     * @param count Number of data items
+     * @param datatype Type of data
+     * @param dest Destination to send to (core id)
+     * @param tag Optional data identifier to send
+     * @param comm Communication reference
+     * @param request Output the request handle
+     *
+     * @return Result code
+     */
+    Result startSend(const void *buf,
+                     int count,
+                     MPI_Datatype datatype,
+                     int dest,
+                     int tag,
+                     MPI_Comm comm,
+                     MPI_Request *request);
+
+    /**
+     * Start non-blocking receive
+     *
+     * @param buf Output data buffer
+     * @param count Number of data items
+     * @param datatype Type of data
+     * @param source Source to receive data from (core id)
+     * @param tag Optional data identifier to receive
+     * @param comm Communication reference
+     * @param request Output the request handle
+     *
+     * @return Result code
+     */
+    Result startReceive(void *buf,
+                        int count,
+                        MPI_Datatype datatype,
+                        int source,
+                        int tag,
+                        MPI_Comm comm,
+                        MPI_Request *request);
+
+    /**
+     * Wait until a request completes
+     *
+     * @param request Request handle, set to MPI_REQUEST_NULL on completion
+     * @param status Output the MPI status
+     *
+     * @return Result code of the request
+     */
+    Result wait(MPI_Request *request,
+                MPI_Status *status);
+
+    /**
+     * Check if a request completed, without waiting
+     *
+     * @param request Request handle, set to MPI_REQUEST_NULL on completion
+     * @param flag Output non-zero if the request completed
+     * @param status Output the MPI status
+     *
+     * @return Result code of the request
+     */
+    Result test(MPI_Request *request,
+                int *flag,
+                MPI_Status *status);
+
+    /**
+     * Wait until all given requests complete
+     *
+     * All requests are advanced together, thus transfers with
+     * different peers proceed in parallel.
+     *
+     * @param count Number of requests
+     * @param requests Array of request handles
+     * @param statuses Output array of MPI status or ZERO
+     *
+     * @return Result code, the first error of any request
+     */
+    Result waitAll(int count,
+                   MPI_Request *requests,
+                   MPI_Status *statuses);
+
+    /**
+     * Block until all ranks reached the barrier
+     *
+     * @param comm Communication reference
+     *
+     * @return Result code
+     */
+    Result barrier(MPI_Comm comm);
+
+    /**
+     * Send data from the root to all other ranks
+     *
+     * @param buffer Input data buffer at the root, output at other ranks
+     * @param count Number of data items
+     * @param datatype Type of data
+     * @param root Rank which owns the data
+     * @param comm Communication reference
+     *
+     * @return Result code
+     */
+    Result broadcast(void *buffer,
+                     int count,
+                     MPI_Datatype datatype,
+                     int root,
+                     MPI_Comm comm);
+
+    /**
+     * Combine data of all ranks element-wise at the root
+     *
+     * @param sendbuf Input data buffer
+     * @param recvbuf Output data buffer, only used at the root
+     * @param count Number of data items
+     * @param datatype Type of data
+     * @param op Reduction operation
+     * @param root Rank which receives the result
+     * @param comm Communication reference
+     *
+     * @return Result code
+     */
+    Result reduce(const void *sendbuf,
+                  void *recvbuf,
+                  int count,
+                  MPI_Datatype datatype,
+                  MPI_Op op,
+                  int root,
+                  MPI_Comm comm);
+
+    /**
+     * Combine data of all ranks element-wise at every rank
+     *
+     * @param sendbuf Input data buffer
+     * @param recvbuf Output data buffer
+     * @param count Number of data items
+     * @param datatype Type of data
+     * @param op Reduction operation
+     * @param comm Communication reference
+     *
+     * @return Result code
+     */
+    Result allReduce(const void *sendbuf,
+                     void *recvbuf,
+                     int count,
+                     MPI_Datatype datatype,
+                     MPI_Op op,
+                     MPI_Comm comm);
+
+    /**
+     * Collect data of all ranks at the root, ordered by rank
+     *
+     * @param sendbuf Input data buffer
+     * @param recvbuf Output buffer for the data of all ranks, only used at the root
+     * @param count Number of data items per rank
+     * @param datatype Type of data
+     * @param root Rank which receives the data
+     * @param comm Communication reference
+     *
+     * @return Result code
+     */
+    Result gather(const void *sendbuf,
+                  void *recvbuf,
+                  int count,
+                  MPI_Datatype datatype,
+                  int root,
+                  MPI_Comm comm);
+
+    /**
+     * Distribute consecutive parts of the data at the root to all ranks
+     *
+     * @param sendbuf Input buffer with the data for all ranks, only used at the root
+     * @param recvbuf Output data buffer
+     * @param count Number of data items per rank
+     * @param datatype Type of data
+     * @param root Rank which owns the data
+     * @param comm Communication reference
+     *
+     * @return Result code
+     */
+    Result scatter(const void *sendbuf,
+                   void *recvbuf,
+                   int count,
+                   MPI_Datatype datatype,
+                   int root,
+                   MPI_Comm comm);
+
+  protected:
+
+    /**
+     * Advance a request
+     *
+     * The default implementation performs the entire transfer with send() or receive().
+     * Backends that transfer data without blocking should transfer as much as possible
+     * and set the complete flag when all data is transferred.
+     *
+     * @param request Request to advance
+     *
+     * @return Result code
+     */
+    virtual Result progress(Request *request);
+
+    /**
+     * Called when waiting and none of the requests made progress
+     */
+    virtual void waitIdle();
+
+  private:
+
+    /**
+     * Retrieve rank and size of a communicator and verify the root rank
+     *
+     * @param comm Communication reference
+     * @param root Root rank of the collective operation
+     * @param rank Output the rank number
+     * @param size Output the communication size
+     *
+     * @return Result code
+     */
+    Result getTopology(MPI_Comm comm,
+                       const int root,
+                       int & rank,
+                       int & size);
+
+    /**
+     * Transfer data with all ranks except zero concurrently
+     *
+     * @param send True to send, false to receive
+     * @param buffer Data buffer, the part of rank i starts at i times stride
+     * @param stride Number of bytes between the parts of consecutive ranks
+     * @param count Number of data items per rank
+     * @param datatype Type of data
+     * @param size Communication size
+     * @param skip Rank to leave out, or zero for none
+     * @param comm Communication reference
+     *
+     * @return Result code
+     */
+    Result exchange(const bool send,
+                    u8 *buffer,
+                    const Size stride,
+                    const int count,
+                    const MPI_Datatype datatype,
+                    const int size,
+                    const int skip,
+                    MPI_Comm comm);
+
+    /**
+     * Combine two arrays of data elements
+     *
+     * @param op Reduction operation
+     * @param datatype Type of data
+     * @param inout First operand and output of the result
+     * @param in Second operand
+     * @param count Number of data items
+     */
+    static void combine(const MPI_Op op,
+                        const MPI_Datatype datatype,
+                        void *inout,
+                        const void *in,
+                        const Size count);
+
+    /**
+     * Create a new request
+     *
+     * @param send True for a send, false for a receive
+     * @param buf Input or output data buffer
+     * @param count Number of data items
+     * @param datatype Type of data
+     * @param peer Destination or source (core id)
+     * @param tag Optional data identifier
+     * @param comm Communication reference
+     * @param request Output the request handle
+     *
+     * @return Result code
+     */
+    Result startRequest(const bool send,
+                        void *buf,
+                        int count,
+                        MPI_Datatype datatype,
+                        int peer,
+                        int tag,
+                        MPI_Comm comm,
+                        MPI_Request *request);
+
+    /**
+     * Advance all requests which are not blocked by older requests
+     *
+     * @return Number of requests which transferred data
+     */
+    Size progressAll();
+
+    /**
+     * Lookup a request by handle
+     *
+     * @param handle Request handle
+     *
+     * @return Request pointer or ZERO if not found
+     */
+    Request * getRequest(const MPI_Request handle) const;
+
+    /**
+     * Finish a completed request
+     *
+     * @param request Request handle, set to MPI_REQUEST_NULL
+     *
+     * @return Result code of the request
+     */
+    Result finish(MPI_Request *request);
+
+  private:
+
+    /** Outstanding non-blocking requests */
+    Index<Request, MaximumRequests> m_requests;
+
+    /** Serial number for the next request */
+    u32 m_serial;
 };
 
 /**
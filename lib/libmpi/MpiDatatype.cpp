@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Macros.h>
+#include <MemoryBlock.h>
+#include "MpiDatatype.h"
+
+MpiDatatype::Type MpiDatatype::m_types[MpiDatatype::MaximumTypes];
+
+bool MpiDatatype::isBasic(const MPI_Datatype datatype)
+{
+    return datatype <= MPI_BYTE;
+}
+
+bool MpiDatatype::isContiguous(const MPI_Datatype datatype)
+{
+    const Type *type = getType(datatype);
+
+    return type ? type->contiguous : isBasic(datatype);
+}
+
+Size MpiDatatype::getSize(const MPI_Datatype datatype)
+{
+    switch (datatype)
+    {
+        case MPI_CHAR:
+        case MPI_UNSIGNED_CHAR:
+        case MPI_BYTE:
+            return sizeof(u8);
+
+        case MPI_SHORT:
+        case MPI_UNSIGNED_SHORT:
+            return sizeof(short);
+
+        case MPI_INT:
+        case MPI_UNSIGNED:
+            return sizeof(int);
+
+        case MPI_LONG:
+        case MPI_UNSIGNED_LONG:
+            return sizeof(long);
+
+        case MPI_LONG_LONG:
+        case MPI_UNSIGNED_LONG_LONG:
+            return sizeof(long long);
+
+        case MPI_FLOAT:
+            return sizeof(float);
+
+        case MPI_DOUBLE:
+            return sizeof(double);
+
+        default:
+        {
+            const Type *type = getType(datatype);
+            return type && type->committed ? type->size : 0;
+        }
+    }
+}
+
+Size MpiDatatype::getExtent(const MPI_Datatype datatype)
+{
+    const Type *type = getType(datatype);
+
+    if (type)
+    {
+        return type->extent;
+    }
+
+    return isBasic(datatype) ? getSize(datatype) : 0;
+}
+
+MpiDatatype::Result MpiDatatype::create(const int count,
+                                        const int blocklength,
+                                        const int stride,
+                                        const MPI_Datatype oldtype,
+                                        MPI_Datatype *newtype)
+{
+    Type *old = getType(oldtype);
+
+    if (count < 0 || blocklength < 0 || stride < 0)
+    {
+        return MPI_ERR_ARG;
+    }
+
+    if (!old && !isBasic(oldtype))
+    {
+        return MPI_ERR_TYPE;
+    }
+
+    for (Size i = 0; i < MaximumTypes; i++)
+    {
+        Type *type = &m_types[i];
+
+        if (type->references != 0)
+        {
+            continue;
+        }
+
+        const Size oldSize = old ? old->size : getSize(oldtype);
+        const Size oldExtent = getExtent(oldtype);
+
+        type->oldtype = oldtype;
+        type->count = count;
+        type->blocklength = blocklength;
+        type->stride = stride * oldExtent;
+        type->size = count * blocklength * oldSize;
+        type->extent = count == 0 ? 0 : ((count - 1) * type->stride) + (blocklength * oldExtent);
+        type->references = 1;
+        type->contiguous = isContiguous(oldtype) && (count <= 1 || type->stride == blocklength * oldExtent);
+        type->committed = false;
+
+        if (old)
+        {
+            old->references++;
+        }
+
+        *newtype = DerivedBase + i;
+        return MPI_SUCCESS;
+    }
+
+    return MPI_ERR_NO_MEM;
+}
+
+MpiDatatype::Result MpiDatatype::commit(MPI_Datatype *datatype)
+{
+    Type *type = getType(*datatype);
+
+    if (!type)
+    {
+        return isBasic(*datatype) ? MPI_SUCCESS : MPI_ERR_TYPE;
+    }
+
+    type->committed = true;
+    return MPI_SUCCESS;
+}
+
+MpiDatatype::Result MpiDatatype::release(MPI_Datatype *datatype)
+{
+    if (!getType(*datatype))
+    {
+        return MPI_ERR_TYPE;
+    }
+
+    dereference(*datatype);
+    *datatype = MPI_DATATYPE_NULL;
+    return MPI_SUCCESS;
+}
+
+Size MpiDatatype::pack(const void *buffer,
+                       const Size count,
+                       const MPI_Datatype datatype,
+                       const Size offset,
+                       void *output,
+                       const Size size)
+{
+    return transfer(true, (u8 *) buffer, count, datatype, offset, (u8 *) output, size);
+}
+
+Size MpiDatatype::unpack(void *buffer,
+                         const Size count,
+                         const MPI_Datatype datatype,
+                         const Size offset,
+                         const void *input,
+                         const Size size)
+{
+    return transfer(false, (u8 *) buffer, count, datatype, offset, (u8 *) input, size);
+}
+
+void MpiDatatype::copy(void *dest,
+                       const void *source,
+                       const Size count,
+                       const MPI_Datatype datatype)
+{
+    const Size size = count * getSize(datatype);
+    u8 packed[256];
+
+    if (isContiguous(datatype))
+    {
+        MemoryBlock::copy(dest, source, size);
+        return;
+    }
+
+    for (Size offset = 0; offset < size; )
+    {
+        const Size bytes = pack(source, count, datatype, offset, packed, sizeof(packed));
+        unpack(dest, count, datatype, offset, packed, bytes);
+        offset += bytes;
+    }
+}
+
+MpiDatatype::Type * MpiDatatype::getType(const MPI_Datatype datatype)
+{
+    if (datatype < DerivedBase || datatype - DerivedBase >= MaximumTypes)
+    {
+        return ZERO;
+    }
+
+    Type *type = &m_types[datatype - DerivedBase];
+    return type->references != 0 ? type : ZERO;
+}
+
+void MpiDatatype::dereference(const MPI_Datatype datatype)
+{
+    Type *type = getType(datatype);
+
+    if (type && --type->references == 0)
+    {
+        dereference(type->oldtype);
+    }
+}
+
+Size MpiDatatype::transfer(const bool pack,
+                           u8 *buffer,
+                           const Size count,
+                           const MPI_Datatype datatype,
+                           const Size offset,
+                           u8 *packed,
+                           const Size size)
+{
+    const Type *type = getType(datatype);
+    const Size elementSize = type ? type->size : getSize(datatype);
+    const Size total = count * elementSize;
+    Size done = 0;
+
+    if (offset >= total)
+    {
+        return 0;
+    }
+
+    // Data without gaps is a single copy
+    if (!type || type->contiguous)
+    {
+        const Size bytes = total - offset < size ? total - offset : size;
+
+        if (pack)
+            MemoryBlock::copy(packed, buffer + offset, bytes);
+        else
+            MemoryBlock::copy(buffer + offset, packed, bytes);
+
+        return bytes;
+    }
+
+    // Walk the blocks from the element and block which contain the offset
+    const Size blockSize = type->size / type->count;
+
+    for (Size element = offset / elementSize, skip = offset % elementSize;
+         element < count && done < size; element++, skip = 0)
+    {
+        u8 *base = buffer + (element * type->extent);
+
+        for (Size block = skip / blockSize, inner = skip % blockSize;
+             block < type->count && done < size; block++, inner = 0)
+        {
+            done += transfer(pack, base + (block * type->stride), type->blocklength,
+                             type->oldtype, inner, packed + done, size - done);
+        }
+    }
+
+    return done;
+}
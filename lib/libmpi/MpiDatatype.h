@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __LIB_LIBMPI_MPIDATATYPE_H
+#define __LIB_LIBMPI_MPIDATATYPE_H
+
+#include <Types.h>
+#include "mpi.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libmpi
+ * @{
+ */
+
+/**
+ * Layout of predefined and derived MPI datatypes.
+ *
+ * A derived datatype is a vector of equally spaced blocks of an older datatype,
+ * which may itself be derived. The transport only moves packed bytes:
+ * pack() and unpack() convert between the layout of a buffer and its packed
+ * form at any packed offset, such that strided data is gathered directly
+ * into (and scattered directly out of) message payloads.
+ */
+class MpiDatatype
+{
+  public:
+
+    /** Result code */
+    typedef int Result;
+
+    /** Maximum number of derived datatypes */
+    static const Size MaximumTypes = 64;
+
+    /** Identifier of the first derived datatype */
+    static const MPI_Datatype DerivedBase = 0x100;
+
+  private:
+
+    /**
+     * Derived datatype
+     */
+    struct Type
+    {
+        MPI_Datatype oldtype;   /**< Type of the elements in each block */
+        Size count;             /**< Number of blocks */
+        Size blocklength;       /**< Number of elements in each block */
+        Size stride;            /**< Bytes between the starts of two blocks */
+        Size size;              /**< Number of data bytes */
+        Size extent;            /**< Bytes from the first to the last data byte */
+        Size references;        /**< The handle and the types derived from it */
+        bool contiguous;        /**< True if the data has no gaps */
+        bool committed;         /**< True if the type can be used for communication */
+    };
+
+  public:
+
+    /**
+     * Check for a predefined datatype.
+     *
+     * @param datatype Type of data
+     *
+     * @return True if predefined
+     */
+    static bool isBasic(const MPI_Datatype datatype);
+
+    /**
+     * Check if a datatype has no gaps between its data bytes.
+     *
+     * @param datatype Type of data
+     *
+     * @return True if a buffer of this type is its packed form
+     */
+    static bool isContiguous(const MPI_Datatype datatype);
+
+    /**
+     * Get the number of data bytes of a single element.
+     *
+     * @param datatype Type of data
+     *
+     * @return Size in bytes or zero if the datatype is invalid or not committed
+     */
+    static Size getSize(const MPI_Datatype datatype);
+
+    /**
+     * Get the distance between two consecutive elements in a buffer.
+     *
+     * @param datatype Type of data
+     *
+     * @return Extent in bytes or zero if the datatype is invalid
+     */
+    static Size getExtent(const MPI_Datatype datatype);
+
+    /**
+     * Create a vector datatype.
+     *
+     * @param count Number of blocks
+     * @param blocklength Number of elements in each block
+     * @param stride Number of elements between the starts of two blocks
+     * @param oldtype Type of the elements
+     * @param newtype Receives the new datatype on success
+     *
+     * @return MPI_SUCCESS on success and other codes on error
+     */
+    static Result create(const int count,
+                         const int blocklength,
+                         const int stride,
+                         const MPI_Datatype oldtype,
+                         MPI_Datatype *newtype);
+
+    /**
+     * Make a datatype usable for communication.
+     *
+     * @param datatype Type of data
+     *
+     * @return MPI_SUCCESS on success and other codes on error
+     */
+    static Result commit(MPI_Datatype *datatype);
+
+    /**
+     * Release a derived datatype.
+     *
+     * Types derived from it remain valid.
+     *
+     * @param datatype Type of data, set to MPI_DATATYPE_NULL
+     *
+     * @return MPI_SUCCESS on success and other codes on error
+     */
+    static Result release(MPI_Datatype *datatype);
+
+    /**
+     * Copy packed bytes out of a buffer.
+     *
+     * @param buffer Input buffer with the layout of the datatype
+     * @param count Number of elements in the buffer
+     * @param datatype Type of the elements
+     * @param offset First packed byte to copy
+     * @param output Output for packed bytes
+     * @param size Maximum number of bytes to copy
+     *
+     * @return Number of bytes copied
+     */
+    static Size pack(const void *buffer,
+                     const Size count,
+                     const MPI_Datatype datatype,
+                     const Size offset,
+                     void *output,
+                     const Size size);
+
+    /**
+     * Copy packed bytes into a buffer.
+     *
+     * @param buffer Output buffer with the layout of the datatype
+     * @param count Number of elements in the buffer
+     * @param datatype Type of the elements
+     * @param offset First packed byte to copy
+     * @param input Packed bytes
+     * @param size Maximum number of bytes to copy
+     *
+     * @return Number of bytes copied
+     */
+    static Size unpack(void *buffer,
+                       const Size count,
+                       const MPI_Datatype datatype,
+                       const Size offset,
+                       const void *input,
+                       const Size size);
+
+    /**
+     * Copy the data bytes of elements between buffers of the same layout.
+     *
+     * @param dest Output buffer
+     * @param source Input buffer
+     * @param count Number of elements
+     * @param datatype Type of the elements
+     */
+    static void copy(void *dest,
+                     const void *source,
+                     const Size count,
+                     const MPI_Datatype datatype);
+
+  private:
+
+    /**
+     * Get a derived datatype.
+     *
+     * @param datatype Type of data
+     *
+     * @return Type pointer or ZERO if not a valid derived type
+     */
+    static Type * getType(const MPI_Datatype datatype);
+
+    /**
+     * Drop a reference to a derived datatype.
+     *
+     * @param datatype Type of data
+     */
+    static void dereference(const MPI_Datatype datatype);
+
+    /**
+     * Copy between a buffer and its packed form.
+     *
+     * @param pack True to copy out of the buffer, false to copy into it
+     * @param buffer Buffer with the layout of the datatype
+     * @param count Number of elements in the buffer
+     * @param datatype Type of the elements
+     * @param offset First packed byte to copy
+     * @param packed Packed bytes
+     * @param size Maximum number of bytes to copy
+     *
+     * @return Number of bytes copied
+     */
+    static Size transfer(const bool pack,
+                         u8 *buffer,
+                         const Size count,
+                         const MPI_Datatype datatype,
+                         const Size offset,
+                         u8 *packed,
+                         const Size size);
+
+  private:
+
+    /** Derived datatypes */
+    static Type m_types[MaximumTypes];
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBMPI_MPIDATATYPE_H */
@@ -20,6 +20,8 @@
 #include <string.h>
 #include <errno.h>
 #include <libgen.h>
+#include <poll.h>
+#include <time.h>
 #include <sys/stat.h>
 #include <sys/socket.h>
 #include <Log.h>
@@ -49,10 +51,13 @@ MpiHost::Result MpiHost::initialize(int *argc,
     }
 
     // Add ourselves as the master node
-    Node *master = new Node;
+    Node *master = new Node();
     master->ipAddress = 0;
     master->udpPort = 0;
     master->coreId = 0;
+    master->fragmentSize = FragmentSize;
+    master->sendSequence = 0;
+    master->receiveSequence = 0;
 
     // Register the master
     if (!m_nodes.insert(master))
@@ -174,62 +179,104 @@ MpiHost::Result MpiHost::send(const void *buf,
                               int tag,
                               MPI_Comm comm)
 {
-    Size datasize = 0;
+    static u8 packet[MpiProxy::MaximumPacketSize];
+    bool acked[MpiProxy::FragmentWindow];
+    int timeoutMs = RetransmitTimeoutMs;
+    Size retries = 0;
 
-    // Get datatype size
-    switch (datatype)
+    if (MpiDatatype::getSize(datatype) == 0)
     {
-        case MPI_INT:
-            datasize = sizeof(int);
-            break;
-
-        case MPI_UNSIGNED_CHAR:
-            datasize = sizeof(u8);
-            break;
-
-        default: {
-            ERROR("unsupported datatype = " << (int) datatype);
-            return MPI_ERR_ARG;
-        }
+        ERROR("unsupported datatype = " << (int) datatype);
+        return MPI_ERR_ARG;
     }
 
-    // Large payloads are not yet supported
-    if ((count * datasize) + sizeof(MpiProxy::Header) > MpiProxy::MaximumPacketSize)
+    if (count < 0)
     {
-        ERROR("data count too high: maximum is " <<
-              (MpiProxy::MaximumPacketSize - sizeof(MpiProxy::Header)));
-        return MPI_ERR_ARG;
+        ERROR("invalid data count: " << count);
+        return MPI_ERR_COUNT;
     }
 
     // Find the destination node
-    const Node *node = m_nodes.get(dest);
+    Node *node = m_nodes.get(dest);
     if (node == ZERO)
     {
         ERROR("nodeId " << dest << " not found");
         return MPI_ERR_ARG;
     }
 
-    // Construct packet to send
-    u8 packet[MpiProxy::MaximumPacketSize];
-    MpiProxy::Header *hdr = (MpiProxy::Header *) packet;
-    hdr->operation = MpiProxy::MpiOpSend;
-    hdr->result = 0;
-    hdr->coreId = node->coreId;
-    hdr->rankId = dest;
-    hdr->datatype = datatype;
-    hdr->datacount = count;
+    // Split the packed data in fragments which are numbered continuously per node
+    const Size size = count * MpiDatatype::getSize(datatype);
+    const u32 first = node->sendSequence;
+    const u32 last = first + ((size + node->fragmentSize - 1) / node->fragmentSize);
+    u32 base = first, next = first;
 
-    // Append payload after the header
-    MemoryBlock::copy(packet + sizeof(MpiProxy::Header), buf, count * datasize);
+    MemoryBlock::set(acked, 0, sizeof(acked));
 
-    // Send the packet
-    const Result sendResult = sendPacket(dest, packet, sizeof(MpiProxy::Header) + (count * datasize));
-    if (sendResult != MPI_SUCCESS)
+    while (base != last)
     {
-        ERROR("failed to send packet to nodeId " << dest << ": result = " << (int) sendResult);
-        return sendResult;
+        // Transmit new fragments while the window is not full
+        for (; next != last && next - base < MpiProxy::FragmentWindow; next++)
+        {
+            const Result sendResult = sendFragment(dest, buf, count, datatype, first, next);
+            if (sendResult != MPI_SUCCESS)
+            {
+                ERROR("failed to send fragment " << next << " to nodeId " << dest <<
+                      ": result = " << (int) sendResult);
+                return sendResult;
+            }
+        }
+
+        // Wait for an acknowledge
+        Size packetSize = sizeof(packet);
+        const Result recvResult = receivePacket(dest, MpiProxy::MpiOpAck, packet, packetSize, timeoutMs);
+        if (recvResult == MPI_ERR_PENDING)
+        {
+            if (++retries > MaximumRetries)
+            {
+                ERROR("no acknowledge from nodeId " << dest << " for fragment " << base);
+                return MPI_ERR_IO;
+            }
+            timeoutMs = timeoutMs * 2 < MaximumTimeoutMs ? timeoutMs * 2 : MaximumTimeoutMs;
+
+            // Retransmit only the fragments which are not yet acknowledged
+            for (u32 seq = base; seq != next; seq++)
+            {
+                if (!acked[seq % MpiProxy::FragmentWindow])
+                {
+                    const Result sendResult = sendFragment(dest, buf, count, datatype, first, seq);
+                    if (sendResult != MPI_SUCCESS)
+                    {
+                        return sendResult;
+                    }
+                }
+            }
+            continue;
+        }
+        else if (recvResult != MPI_SUCCESS)
+        {
+            ERROR("failed to receive UDP packet for rankId = " << dest << ": result = " << (int) recvResult);
+            return recvResult;
+        }
+
+        const MpiProxy::Header *ack = (const MpiProxy::Header *) packet;
+        retries = 0;
+        timeoutMs = RetransmitTimeoutMs;
+
+        // Remember fragments that the remote node buffered out of order
+        if (ack->sequence - base < next - base)
+        {
+            acked[ack->sequence % MpiProxy::FragmentWindow] = true;
+        }
+
+        // Slide the window up to the next fragment expected by the remote node
+        while (base != next && (s32) (ack->datacount - base) > 0)
+        {
+            acked[base % MpiProxy::FragmentWindow] = false;
+            base++;
+        }
     }
 
+    node->sendSequence = last;
     return MPI_SUCCESS;
 }
 
@@ -241,70 +288,271 @@ MpiHost::Result MpiHost::receive(void *buf,
                                  MPI_Comm comm,
                                  MPI_Status *status)
 {
-    static u8 packet[MpiProxy::MaximumPacketSize];
+    bool complete = false;
+
+    if (MpiDatatype::getSize(datatype) == 0)
+    {
+        return MPI_ERR_UNSUPPORTED_DATAREP;
+    }
+
+    if (count < 0)
+    {
+        ERROR("invalid data count: " << count);
+        return MPI_ERR_COUNT;
+    }
 
     // Find the source node
-    const Node *node = m_nodes.get(source);
+    Node *node = m_nodes.get(source);
     if (node == ZERO)
     {
         ERROR("nodeId " << source << " not found");
         return MPI_ERR_RANK;
     }
 
-    // Send receive data request to the remote node
-    MpiProxy::Header *hdr = (MpiProxy::Header *) packet;
-    hdr->operation = MpiProxy::MpiOpRecv;
-    hdr->coreId = node->coreId;
-    hdr->rankId = source;
-    hdr->datatype = datatype;
-    hdr->datacount = count;
+    if (node->receiving)
+    {
+        ERROR("nodeId " << source << " has a non-blocking receive in progress");
+        return MPI_ERR_PENDING;
+    }
 
-    // Send the packet
-    const Result sendResult = sendPacket(source, packet, sizeof(MpiProxy::Header));
-    if (sendResult != MPI_SUCCESS)
+    Result result = beginReceive(source, count * MpiDatatype::getSize(datatype));
+
+    // Wait for packets of any node until all fragments arrived
+    while (result == MPI_SUCCESS)
     {
-        ERROR("failed to send packet to nodeId " << source << ": result = " << (int) sendResult);
-        return sendResult;
+        result = advanceReceive(source, buf, count, datatype, complete);
+        if (result != MPI_SUCCESS || complete)
+        {
+            break;
+        }
+
+        const u64 now = currentTime();
+        result = pump(node->deadline > now ? node->deadline - now : 0);
     }
 
-    // Now receive the data response(s)
-    for (int i = 0; i < count;)
+    if (result != MPI_SUCCESS && node->receiving)
     {
-        Size packetSize = sizeof(packet);
+        endReceive(node);
+    }
 
-        // Receive data packet from the source node
-        const Result recvResult = receivePacket(source, MpiProxy::MpiOpRecv, packet, packetSize);
-        if (recvResult != MPI_SUCCESS)
+    return result;
+}
+
+MpiHost::Result MpiHost::progress(Request *request)
+{
+    // Sends wait for their acknowledges, meanwhile packets of other nodes are queued
+    if (request->send)
+    {
+        return MpiBackend::progress(request);
+    }
+
+    const Size size = request->count * MpiDatatype::getSize(request->datatype);
+    Node *node = m_nodes.get(request->peer);
+    bool complete = false;
+
+    if (node == ZERO)
+    {
+        return MPI_ERR_RANK;
+    }
+
+    if (MpiDatatype::getSize(request->datatype) == 0)
+    {
+        return MPI_ERR_UNSUPPORTED_DATAREP;
+    }
+
+    if (!node->receiving)
+    {
+        const Result beginResult = beginReceive(request->peer, size);
+        if (beginResult != MPI_SUCCESS)
         {
-            ERROR("failed to receive UDP packet for rankId = " << source << ": result = " << (int) recvResult);
-            return recvResult;
+            return beginResult;
         }
+    }
+
+    Result result = pump(0);
+    if (result == MPI_SUCCESS)
+    {
+        result = advanceReceive(request->peer, request->buffer, request->count,
+                                request->datatype, complete);
+    }
+
+    if (result != MPI_SUCCESS)
+    {
+        if (node->receiving)
+        {
+            endReceive(node);
+        }
+        return result;
+    }
+
+    // Report progress, such that waiting only idles when nothing arrived
+    request->offset = complete ? size : node->receivedCount * node->fragmentSize;
+    request->complete = complete;
+    return MPI_SUCCESS;
+}
+
+void MpiHost::waitIdle()
+{
+    const u64 now = currentTime();
+    u64 wakeup = now + RetransmitTimeoutMs;
+
+    // Wake up for the earliest retransmit
+    for (Size i = 1; i < m_nodes.count(); i++)
+    {
+        const Node *node = m_nodes.get(i);
+
+        if (node != ZERO && node->receiving && node->deadline < wakeup)
+        {
+            wakeup = node->deadline;
+        }
+    }
+
+    pump(wakeup > now ? wakeup - now : 0);
+}
+
+MpiHost::Result MpiHost::beginReceive(const Size nodeId,
+                                      const Size size)
+{
+    Node *node = m_nodes.get(nodeId);
+    MpiProxy::Header request;
+
+    node->fragments = (size + node->fragmentSize - 1) / node->fragmentSize;
+    node->receiveSize = size;
+    node->receivedCount = 0;
+    node->retries = 0;
+    node->timeoutMs = RetransmitTimeoutMs;
+    node->deadline = currentTime() + RetransmitTimeoutMs;
+
+    // Keep track of which fragments are received
+    node->received = new u8[node->fragments + 1];
+    if (!node->received)
+    {
+        ERROR("failed to allocate fragment map: " << strerror(errno));
+        return MPI_ERR_NO_MEM;
+    }
+    MemoryBlock::set(node->received, 0, node->fragments + 1);
+    node->receiving = true;
+
+    // Send receive data request to the remote node. Only packed bytes travel the network.
+    request.operation = MpiProxy::MpiOpRecv;
+    request.result = 0;
+    request.coreId = node->coreId;
+    request.rankId = nodeId;
+    request.datatype = MPI_BYTE;
+    request.datacount = size;
+    request.sequence = node->receiveSequence;
+
+    return sendPacket(nodeId, &request, sizeof(request));
+}
+
+MpiHost::Result MpiHost::advanceReceive(const Size nodeId,
+                                        void *buf,
+                                        const Size count,
+                                        const MPI_Datatype datatype,
+                                        bool & complete)
+{
+    Node *node = m_nodes.get(nodeId);
+    const u32 first = node->receiveSequence;
+    bool progressed = false;
+
+    // Place the queued fragments in any order
+    for (ListIterator<Packet *> i(m_packetBuffers[nodeId]); i.hasCurrent(); )
+    {
+        Packet *pkt = i.current();
+        const MpiProxy::Header *header = (const MpiProxy::Header *) pkt->data;
+        const u32 index = header->sequence - first;
 
-        // The packet must be a data response
-        const MpiProxy::Header *header = (const MpiProxy::Header *) packet;
         if (header->operation != MpiProxy::MpiOpRecv)
         {
-            ERROR("invalid response received: op = " << header->operation);
+            i++;
             continue;
         }
 
-        // Process all the received data
-        for (Size j = 0; j < header->datacount; j++, i++)
+        // Ignore duplicates and fragments of earlier messages
+        if (index < node->fragments && !node->received[index])
         {
-            const u8 *data = ((const u8 *)(header + 1)) + j;
+            const Size offset = index * node->fragmentSize;
 
-            switch (datatype)
+            if (header->datacount > node->receiveSize - offset ||
+                sizeof(*header) + header->datacount > pkt->size)
             {
-                case MPI_INT:
-                    *(((int *) buf) + i) = *(int *)(data);
-                    break;
+                ERROR("invalid fragment " << header->sequence << " from nodeId " << nodeId <<
+                      ": datacount = " << header->datacount);
+            }
+            else
+            {
+                // Scatter the data of the fragment to its position in the output buffer
+                MpiDatatype::unpack(buf, count, datatype, offset, header + 1, header->datacount);
+                node->received[index] = 1;
+                node->receivedCount++;
+                progressed = true;
+            }
+        }
+
+        delete[] pkt->data;
+        delete pkt;
+        i.remove();
+    }
+
+    if (node->receivedCount == node->fragments)
+    {
+        node->receiveSequence = first + node->fragments;
+        endReceive(node);
+        complete = true;
+        return MPI_SUCCESS;
+    }
+
+    const u64 now = currentTime();
+
+    if (progressed)
+    {
+        node->retries = 0;
+        node->timeoutMs = RetransmitTimeoutMs;
+        node->deadline = now + node->timeoutMs;
+        return MPI_SUCCESS;
+    }
+    else if (now < node->deadline)
+    {
+        return MPI_SUCCESS;
+    }
+
+    if (++node->retries > MaximumRetries)
+    {
+        ERROR("no data from nodeId " << nodeId << " after " << node->receivedCount <<
+              " of " << node->fragments << " fragments");
+        return MPI_ERR_IO;
+    }
+    node->timeoutMs = node->timeoutMs * 2 < MaximumTimeoutMs ? node->timeoutMs * 2 : MaximumTimeoutMs;
+    node->deadline = now + node->timeoutMs;
+
+    MpiProxy::Header request;
+    request.operation = MpiProxy::MpiOpRecv;
+    request.result = 0;
+    request.coreId = node->coreId;
+    request.rankId = nodeId;
+    request.datatype = MPI_BYTE;
+    request.datacount = node->receiveSize;
+    request.sequence = first;
+
+    // The request itself may be lost. Otherwise request the missing fragments only.
+    if (node->receivedCount == 0)
+    {
+        return sendPacket(nodeId, &request, sizeof(request));
+    }
 
-                case MPI_UNSIGNED_CHAR:
-                    *(((u8 *) buf) + i) = *data;
-                    break;
+    request.operation = MpiProxy::MpiOpResend;
 
-                default:
-                    return MPI_ERR_UNSUPPORTED_DATAREP;
+    for (Size i = 0, requested = 0; i < node->fragments && requested < MpiProxy::FragmentWindow; i++)
+    {
+        if (!node->received[i])
+        {
+            request.sequence = first + i;
+            requested++;
+
+            const Result sendResult = sendPacket(nodeId, &request, sizeof(request));
+            if (sendResult != MPI_SUCCESS)
+            {
+                return sendResult;
             }
         }
     }
@@ -312,6 +560,132 @@ MpiHost::Result MpiHost::receive(void *buf,
     return MPI_SUCCESS;
 }
 
+void MpiHost::endReceive(Node *node)
+{
+    delete[] node->received;
+    node->received = ZERO;
+    node->receiving = false;
+}
+
+MpiHost::Result MpiHost::pump(const int timeoutMs)
+{
+    static u8 packet[MpiProxy::MaximumPacketSize];
+    struct pollfd fds;
+    int waitMs = timeoutMs;
+
+    fds.fd = m_sock;
+    fds.events = POLLIN;
+
+    // Wait for the first datagram only, then drain what is already there
+    for (Size count = 0; count < MaximumPumpPackets; count++, waitMs = 0)
+    {
+        struct sockaddr_in addr;
+        socklen_t len = sizeof(addr);
+
+        fds.revents = 0;
+
+        const int pollResult = poll(&fds, 1, waitMs);
+        if (pollResult < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            ERROR("failed to poll UDP socket " << m_sock << ": " << strerror(errno));
+            return MPI_ERR_IO;
+        }
+        else if (pollResult == 0)
+        {
+            break;
+        }
+
+        const int r = recvfrom(m_sock, packet, sizeof(packet), 0,
+                               (struct sockaddr *) &addr, &len);
+        if (r < 0)
+        {
+            ERROR("failed to receive UDP datagram on socket " << m_sock << ": " << strerror(errno));
+            return MPI_ERR_IO;
+        }
+        else if ((Size) r < sizeof(MpiProxy::Header))
+        {
+            continue;
+        }
+
+        const MpiProxy::Header *hdr = (const MpiProxy::Header *) packet;
+        const Size nodeId = findNode(addr, hdr);
+
+        DEBUG("received " << r << " bytes from " << inet_ntoa(addr.sin_addr) <<
+              ":" << htons(addr.sin_port) << " with coreId = " << hdr->coreId <<
+              " rankId = " << hdr->rankId);
+
+        if (nodeId == 0)
+        {
+            ERROR("nodeId not found for packet from " << inet_ntoa(addr.sin_addr) <<
+                  " at port " << htons(addr.sin_port));
+            continue;
+        }
+
+        // Queue the packet at its node
+        Packet *pkt = new Packet;
+        if (!pkt)
+        {
+            ERROR("failed to allocate Packet struct for buffering: " << strerror(errno));
+            return MPI_ERR_NO_MEM;
+        }
+
+        pkt->data = new u8[r];
+        if (!pkt->data)
+        {
+            ERROR("failed to allocate memory for buffered packet: " << strerror(errno));
+            delete pkt;
+            return MPI_ERR_NO_MEM;
+        }
+
+        MemoryBlock::copy(pkt->data, packet, r);
+        pkt->size = r;
+        m_packetBuffers[nodeId]->append(pkt);
+    }
+
+    return MPI_SUCCESS;
+}
+
+Size MpiHost::findNode(const struct sockaddr_in & addr,
+                       const MpiProxy::Header *header) const
+{
+    const Node *node = m_nodes.get(header->rankId);
+
+    // The rank in the header is a hint for a quick lookup
+    if (node != ZERO && header->rankId != 0 &&
+        addr.sin_addr.s_addr == node->ipAddress &&
+        htons(addr.sin_port) == node->udpPort &&
+        header->coreId == node->coreId)
+    {
+        return header->rankId;
+    }
+
+    for (Size i = 1; i < m_nodes.count(); i++)
+    {
+        node = m_nodes.get(i);
+
+        if (node != ZERO &&
+            addr.sin_addr.s_addr == node->ipAddress &&
+            htons(addr.sin_port) == node->udpPort &&
+            header->coreId == node->coreId)
+        {
+            return i;
+        }
+    }
+
+    return 0;
+}
+
+u64 MpiHost::currentTime()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((u64) ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+}
+
 MpiHost::Result MpiHost::parseHostsFile(const char *hostsfile)
 {
     struct stat st;
@@ -388,6 +762,7 @@ MpiHost::Result MpiHost::parseHostsFile(const char *hostsfile)
         node->ipAddress = inet_addr(*nodeLine[0]);
         node->udpPort = atoi(*nodeLine[1]);
         node->coreId = atoi(*nodeLine[2]);
+        node->fragmentSize = FragmentSize;
 
         if (!m_nodes.insert(idx, node))
         {
@@ -496,6 +871,12 @@ MpiHost::Result MpiHost::startProcesses(int argc,
                        i << ": result = " << (int) recvResult);
                 return recvResult;
             }
+
+            // The acknowledge reports the packet size which the node supports
+            if (hdr->datacount > sizeof(MpiProxy::Header) && hdr->datacount <= MpiProxy::MaximumPacketSize)
+            {
+                m_nodes[i]->fragmentSize = hdr->datacount - sizeof(MpiProxy::Header);
+            }
         }
         startCount = 0;
     }
@@ -534,10 +915,39 @@ MpiHost::Result MpiHost::sendPacket(const Size nodeId,
     return MPI_SUCCESS;
 }
 
+MpiHost::Result MpiHost::sendFragment(const Size nodeId,
+                                      const void *buf,
+                                      const Size count,
+                                      const MPI_Datatype datatype,
+                                      const u32 first,
+                                      const u32 sequence) const
+{
+    const Size fragmentSize = m_nodes.get(nodeId)->fragmentSize;
+    const Size offset = (sequence - first) * fragmentSize;
+    const Size remaining = (count * MpiDatatype::getSize(datatype)) - offset;
+    u8 packet[MpiProxy::MaximumPacketSize];
+
+    // Construct packet to send
+    MpiProxy::Header *hdr = (MpiProxy::Header *) packet;
+    hdr->operation = MpiProxy::MpiOpSend;
+    hdr->result = 0;
+    hdr->coreId = m_nodes.get(nodeId)->coreId;
+    hdr->rankId = nodeId;
+    hdr->datatype = MPI_BYTE;
+    hdr->datacount = remaining < fragmentSize ? remaining : fragmentSize;
+    hdr->sequence = sequence;
+
+    // Gather the payload directly after the header
+    MpiDatatype::pack(buf, count, datatype, offset, packet + sizeof(MpiProxy::Header), hdr->datacount);
+
+    return sendPacket(nodeId, packet, sizeof(MpiProxy::Header) + hdr->datacount);
+}
+
 MpiHost::Result MpiHost::receivePacket(const Size nodeId,
                                        const MpiProxy::Operation operation,
                                        void *packet,
-                                       Size & size)
+                                       Size & size,
+                                       const int timeoutMs)
 {
     // Lookup the given node
     const Node *node = m_nodes.get(nodeId);
@@ -547,111 +957,59 @@ MpiHost::Result MpiHost::receivePacket(const Size nodeId,
         return MPI_ERR_ARG;
     }
 
-    in_addr nodeAddr;
-    nodeAddr.s_addr = node->ipAddress;
-    DEBUG("nodeId = " << nodeId << " addr = " << inet_ntoa(nodeAddr) <<
-          " operation = " << (int) operation << " size = " << size);
+    const u64 deadline = currentTime() + (timeoutMs >= 0 ? timeoutMs : 0);
 
-    // Process buffered packets first
-    for (ListIterator<Packet *> i(m_packetBuffers[nodeId]); i.hasCurrent(); i++)
-    {
-        Packet *pkt = i.current();
-        const MpiProxy::Header *hdr = (const MpiProxy::Header *) pkt->data;
+    DEBUG("nodeId = " << nodeId << " operation = " << (int) operation << " size = " << size);
 
-        if (hdr->operation == operation)
-        {
-            MemoryBlock::copy(packet, pkt->data, pkt->size);
-            size = pkt->size;
-            delete[] pkt->data;
-            delete pkt;
-            i.remove();
-            return MPI_SUCCESS;
-        }
-    }
-
-
-    // Keep receiving new packets until we have a matching packet
     while (true)
     {
-        struct sockaddr_in addr;
-        socklen_t len = sizeof(addr);
-        const Size recvSize = size;
-
-        // Receive UDP datagram
-        int r = recvfrom(m_sock, packet, recvSize, 0,
-                         (struct sockaddr *) &addr, &len);
-        if (r < 0)
-        {
-            ERROR("failed to receive UDP datagram on socket " << m_sock << ": " << strerror(errno));
-            return MPI_ERR_IO;
-        }
-
-        const MpiProxy::Header *hdr = (const MpiProxy::Header *) packet;
-
-        DEBUG("received " << r << " bytes from " << inet_ntoa(addr.sin_addr) <<
-              ":" << htons(addr.sin_port) << " with coreId = " << hdr->coreId <<
-              " rankId = " << hdr->rankId);
-
-        // Is this packet targeted for the given node?
-        if (addr.sin_addr.s_addr == node->ipAddress &&
-            htons(addr.sin_port) == node->udpPort &&
-            hdr->coreId == node->coreId)
-        {
-            // Verify the MPI operation
-            if (hdr->operation != operation)
-            {
-                ERROR("invalid MPI operation received in packet from node" << nodeId <<
-                      " (" << inet_ntoa(nodeAddr) << "): " << (int) hdr->operation <<
-                      " != " << (int) operation);
-                return MPI_ERR_IO;
-            }
-
-            DEBUG("done");
-            size = r;
-            return MPI_SUCCESS;
-        }
-        // Add the packet to internal buffers for later retrieval
-        else
+        // Take the first queued packet of the node with the operation
+        for (ListIterator<Packet *> i(m_packetBuffers[nodeId]); i.hasCurrent(); )
         {
-            Size otherNodeId = 0;
+            Packet *pkt = i.current();
+            const MpiProxy::Header *hdr = (const MpiProxy::Header *) pkt->data;
 
-            // Find the corresponding node
-            for (Size i = 0; i < m_nodes.count(); i++)
+            if (hdr->operation == operation && pkt->size <= size)
             {
-                if (addr.sin_addr.s_addr == m_nodes[i]->ipAddress &&
-                    htons(addr.sin_port) == m_nodes[i]->udpPort &&
-                    hdr->coreId == m_nodes[i]->coreId)
-                {
-                    otherNodeId = i;
-                    break;
-                }
+                MemoryBlock::copy(packet, pkt->data, pkt->size);
+                size = pkt->size;
+                delete[] pkt->data;
+                delete pkt;
+                i.remove();
+                return MPI_SUCCESS;
             }
-
-            if (otherNodeId == 0)
+            // Keep fragments of a receive in progress
+            else if (hdr->operation == MpiProxy::MpiOpRecv && node->receiving)
             {
-                ERROR("nodeId not found for packet from " << inet_ntoa(addr.sin_addr) <<
-                      " at port " << htons(addr.sin_port));
+                i++;
             }
+            // Drop late packets of an earlier operation, such as duplicate acknowledges
             else
             {
-                Packet *pkt = new Packet;
-                if (!pkt)
-                {
-                    ERROR("failed to allocate Packet struct for buffering: " << strerror(errno));
-                    return MPI_ERR_NO_MEM;
-                }
+                DEBUG("dropped MPI operation " << (int) hdr->operation << " from node" << nodeId <<
+                      ", expected " << (int) operation);
+                delete[] pkt->data;
+                delete pkt;
+                i.remove();
+            }
+        }
 
-                pkt->data = new u8[r];
-                if (!pkt->data)
-                {
-                    ERROR("failed to allocate memory for buffered packet: " << strerror(errno));
-                    return MPI_ERR_NO_MEM;
-                }
+        int waitMs = -1;
 
-                MemoryBlock::copy(pkt->data, hdr, r);
-                pkt->size = r;
-                m_packetBuffers[otherNodeId]->append(pkt);
+        if (timeoutMs >= 0)
+        {
+            const u64 now = currentTime();
+            if (now >= deadline)
+            {
+                return MPI_ERR_PENDING;
             }
+            waitMs = deadline - now;
+        }
+
+        const Result pumpResult = pump(waitMs);
+        if (pumpResult != MPI_SUCCESS)
+        {
+            return pumpResult;
         }
     }
 
@@ -35,6 +35,11 @@
 
 /**
  * Implements a MPI backend for the host OS which communicates with mpiproxy servers
+ *
+ * All nodes share a single UDP socket. Every wait polls that socket and sorts
+ * each datagram into the queue of its source node, so packets of one node
+ * never wait behind another. Each node has at most one receive in progress,
+ * such that non-blocking receives from different nodes progress concurrently.
  */
 class MpiHost : public MpiBackend
 {
@@ -43,6 +48,21 @@ class MpiHost : public MpiBackend
     /** Maximum number of supported nodes */
     static const Size MaximumNodes = 512;
 
+    /** Initial time in milliseconds to wait for a fragment or acknowledge */
+    static const int RetransmitTimeoutMs = 50;
+
+    /** Upper bound for the retransmit timeout after backing off */
+    static const int MaximumTimeoutMs = 1000;
+
+    /** Number of consecutive timeouts after which a transfer fails */
+    static const Size MaximumRetries = 64;
+
+    /** Number of packed data bytes in a single fragment, until the node reports its packet size */
+    static const Size FragmentSize = MpiProxy::DefaultPacketSize - sizeof(MpiProxy::Header);
+
+    /** Maximum number of datagrams taken from the socket in a single pass */
+    static const Size MaximumPumpPackets = 64;
+
   private:
 
     /**
@@ -53,6 +73,17 @@ class MpiHost : public MpiBackend
         in_addr_t ipAddress; /**@< IP address of the node */
         u16 udpPort;         /**@< UDP port of the node */
         u32 coreId;          /**@< Local identifier of the core at the node */
+        Size fragmentSize;   /**@< Number of packed data bytes in a single fragment */
+        u32 sendSequence;    /**@< Next fragment sequence number for MpiOpSend */
+        u32 receiveSequence; /**@< Next fragment sequence number for MpiOpRecv */
+        bool receiving;      /**@< True while a MpiOpRecv is in progress */
+        Size receiveSize;    /**@< Number of packed bytes of the current MpiOpRecv */
+        u8 *received;        /**@< Marks the fragments of the current MpiOpRecv which arrived */
+        Size fragments;      /**@< Number of fragments of the current MpiOpRecv */
+        Size receivedCount;  /**@< Number of fragments which arrived */
+        Size retries;        /**@< Number of consecutive timeouts */
+        int timeoutMs;       /**@< Current retransmit timeout */
+        u64 deadline;        /**@< Time in milliseconds at which to retransmit */
     };
 
     /**
@@ -114,6 +145,9 @@ class MpiHost : public MpiBackend
     /**
      * Synchronous send data
      *
+     * The data is split into fragments which are sent within a sliding
+     * window. Only fragments which are not acknowledged are retransmitted.
+     *
      * @param buf Input data buffer
      * @param count Number of data items
      * @param datatype Type of data
@@ -133,6 +167,9 @@ class MpiHost : public MpiBackend
     /**
      * Synchronous receive data
      *
+     * Fragments are reassembled by sequence number in any order.
+     * Missing fragments are requested again with MpiOpResend.
+     *
      * @param buf Output data buffer
      * @param count Number of data items
      * @param datatype Type of data
@@ -151,8 +188,90 @@ class MpiHost : public MpiBackend
                            MPI_Comm comm,
                            MPI_Status *status);
 
+  protected:
+
+    /**
+     * Make progress on a non-blocking request
+     *
+     * Receives advance without waiting, sends complete at once.
+     *
+     * @param request Request to progress
+     *
+     * @return Result code
+     */
+    virtual Result progress(Request *request);
+
+    /**
+     * Wait until a packet arrives from any node or a retransmit is due.
+     */
+    virtual void waitIdle();
+
   private:
 
+    /**
+     * Request data from a remote node
+     *
+     * @param nodeId Identification number of the node
+     * @param size Number of packed bytes to receive
+     *
+     * @return Result code
+     */
+    Result beginReceive(const Size nodeId,
+                        const Size size);
+
+    /**
+     * Place the queued fragments of the current receive of a node
+     *
+     * Retransmits the request or asks for missing fragments when the deadline expired.
+     *
+     * @param nodeId Identification number of the node
+     * @param buf Output data buffer
+     * @param count Number of data items
+     * @param datatype Type of data
+     * @param complete Set to true when all fragments arrived
+     *
+     * @return Result code
+     */
+    Result advanceReceive(const Size nodeId,
+                          void *buf,
+                          const Size count,
+                          const MPI_Datatype datatype,
+                          bool & complete);
+
+    /**
+     * Finish the current receive of a node
+     *
+     * @param node Node to finish the receive of
+     */
+    void endReceive(Node *node);
+
+    /**
+     * Move datagrams from the socket to the queue of their node
+     *
+     * @param timeoutMs Maximum time to wait for the first datagram, or negative to wait forever
+     *
+     * @return Result code
+     */
+    Result pump(const int timeoutMs);
+
+    /**
+     * Find the node which sent a packet
+     *
+     * @param addr Address of the sender
+     * @param header Header of the packet
+     *
+     * @return Node identification number, or zero if not found
+     */
+    Size findNode(const struct sockaddr_in & addr,
+                  const MpiProxy::Header *header) const;
+
+    /**
+     * Get a monotonic timestamp
+     *
+     * @return Time in milliseconds
+     */
+    static u64 currentTime();
+
     /**
      * Parse the given hosts file
      *
@@ -186,20 +305,44 @@ class MpiHost : public MpiBackend
                       const void *packet,
                       const Size size) const;
 
+    /**
+     * Send a single data fragment of a MpiOpSend to a remote node
+     *
+     * @param nodeId Identification number of the node
+     * @param buf Input data buffer of the entire message
+     * @param count Number of data items in the entire message
+     * @param datatype Type of data
+     * @param first Sequence number of the first fragment of the message
+     * @param sequence Sequence number of the fragment to send
+     *
+     * @return Result code
+     */
+    Result sendFragment(const Size nodeId,
+                        const void *buf,
+                        const Size count,
+                        const MPI_Datatype datatype,
+                        const u32 first,
+                        const u32 sequence) const;
+
     /**
      * Receive UDP packet from remote node
      *
+     * Queued packets from the node with a different operation are dropped,
+     * except for fragments of a receive which is in progress.
+     *
      * @param nodeId Identification number of the node to receive from
      * @param operation Expected MPI operation value of the packet
      * @param packet Payload output
      * @param size Output for number of bytes received
+     * @param timeoutMs Maximum time to wait in milliseconds or negative to wait forever
      *
-     * @return Result code
+     * @return Result code, MPI_ERR_PENDING if the timeout expired
      */
     Result receivePacket(const Size nodeId,
                          const MpiProxy::Operation operation,
                          void *packet,
-                         Size & size);
+                         Size & size,
+                         const int timeoutMs = -1);
 
   private:
 
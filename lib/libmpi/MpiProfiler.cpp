@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <Macros.h>
+#include <MemoryBlock.h>
+#include "MpiProfiler.h"
+
+const char * MpiProfiler::Argument = "--mpi-profile";
+
+const char * MpiProfiler::Names[NumberOfCalls] =
+{
+    "MPI_Send",
+    "MPI_Recv",
+    "MPI_Isend",
+    "MPI_Irecv",
+    "MPI_Wait",
+    "MPI_Test",
+    "MPI_Waitall",
+    "MPI_Barrier",
+    "MPI_Bcast",
+    "MPI_Reduce",
+    "MPI_Allreduce",
+    "MPI_Gather",
+    "MPI_Scatter"
+};
+
+MpiProfiler::MpiProfiler()
+    : m_enabled(false)
+{
+    MemoryBlock::set(m_counters, 0, sizeof(m_counters));
+}
+
+void MpiProfiler::initialize(int *argc,
+                             char ***argv)
+{
+    for (int i = 1; i < *argc; i++)
+    {
+        if (strcmp((*argv)[i], Argument) == 0)
+        {
+            m_enabled = true;
+
+            // Hide the argument from the program
+            for (int j = i; j < (*argc) - 1; j++)
+            {
+                (*argv)[j] = (*argv)[j + 1];
+            }
+            (*argc)--;
+            break;
+        }
+    }
+}
+
+u64 MpiProfiler::start() const
+{
+    return m_enabled ? now() : 0;
+}
+
+void MpiProfiler::record(const Call call,
+                         const u64 startTime,
+                         const Size bytes)
+{
+    if (m_enabled)
+    {
+        m_counters[call].calls++;
+        m_counters[call].bytes += bytes;
+        m_counters[call].usec += now() - startTime;
+    }
+}
+
+void MpiProfiler::report(const int rank) const
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    for (Size i = 0; i < NumberOfCalls; i++)
+    {
+        if (m_counters[i].calls != 0)
+        {
+            printf("mpiprofile: rank=%d call=%s calls=%u kbytes=%u msec=%u\r\n",
+                   rank, Names[i], m_counters[i].calls,
+                   (unsigned) (m_counters[i].bytes / 1024),
+                   (unsigned) (m_counters[i].usec / 1000));
+        }
+    }
+}
+
+u64 MpiProfiler::now()
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, ZERO);
+    return ((u64) tv.tv_sec * 1000000ULL) + tv.tv_usec;
+}
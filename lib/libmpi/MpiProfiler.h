@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBMPI_MPIPROFILER_H
+#define __LIB_LIBMPI_MPIPROFILER_H
+
+#include <Types.h>
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libmpi
+ * @{
+ */
+
+/**
+ * Lightweight profiler for MPI calls.
+ *
+ * Counts calls, bytes and time spent per MPI function of the local rank.
+ * The profiler is enabled by passing the --mpi-profile argument to the program.
+ * At MPI_Finalize every rank prints a summary with one line per function:
+ *
+ *     mpiprofile: rank=<rank> call=<name> calls=<count> kbytes=<KiB> msec=<time>
+ *
+ * Bytes and time are accumulated exactly and scaled down only for printing,
+ * because printf() of libposix has no 64-bit conversions.
+ */
+class MpiProfiler
+{
+  public:
+
+    /** Argument which enables the profiler */
+    static const char *Argument;
+
+    /**
+     * Profiled MPI functions
+     */
+    enum Call
+    {
+        Send = 0,
+        Recv,
+        Isend,
+        Irecv,
+        Wait,
+        Test,
+        Waitall,
+        Barrier,
+        Bcast,
+        Reduce,
+        Allreduce,
+        Gather,
+        Scatter,
+        NumberOfCalls
+    };
+
+  private:
+
+    /**
+     * Statistics of a single MPI function
+     */
+    struct Counter
+    {
+        u32 calls;  /**< Number of calls */
+        u64 bytes;  /**< Number of data bytes passed */
+        u64 usec;   /**< Time spent in microseconds */
+    };
+
+  public:
+
+    /**
+     * Constructor
+     */
+    MpiProfiler();
+
+    /**
+     * Enable the profiler if requested by the program arguments
+     *
+     * The profiling argument is removed from the arguments.
+     *
+     * @param argc Argument count pointer
+     * @param argv Argument values array pointer
+     */
+    void initialize(int *argc,
+                    char ***argv);
+
+    /**
+     * Get a timestamp for the start of a call
+     *
+     * @return Time in microseconds or zero if disabled
+     */
+    u64 start() const;
+
+    /**
+     * Record a finished call
+     *
+     * @param call MPI function which was called
+     * @param startTime Timestamp returned by start()
+     * @param bytes Number of data bytes passed
+     */
+    void record(const Call call,
+                const u64 startTime,
+                const Size bytes);
+
+    /**
+     * Print the summary of all calls
+     *
+     * @param rank Rank number of the local process
+     */
+    void report(const int rank) const;
+
+  private:
+
+    /**
+     * Get the current time
+     *
+     * @return Time in microseconds
+     */
+    static u64 now();
+
+  private:
+
+    /** Names of the profiled MPI functions */
+    static const char *Names[NumberOfCalls];
+
+    /** True if calls are recorded */
+    bool m_enabled;
+
+    /** Statistics per MPI function */
+    Counter m_counters[NumberOfCalls];
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBMPI_MPIPROFILER_H */
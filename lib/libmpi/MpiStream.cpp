@@ -0,0 +1,363 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <FreeNOS/User.h>
+#include <MemoryBlock.h>
+#include "MpiStream.h"
+
+MpiStream::MpiStream()
+{
+    reset();
+}
+
+void MpiStream::write(MemoryChannel *channel,
+                      const void *buffer,
+                      const Size size)
+{
+    write(channel, buffer, size, MPI_BYTE);
+}
+
+void MpiStream::write(MemoryChannel *channel,
+                      const void *buffer,
+                      const Size count,
+                      const MPI_Datatype datatype)
+{
+    const Size size = count * MpiDatatype::getSize(datatype);
+    Size written = 0;
+
+    // Large buffers without gaps are copied by the reader directly
+    if (size >= RendezvousSize && MpiDatatype::isContiguous(datatype))
+    {
+        written = writeRendezvous(channel, buffer, size);
+    }
+
+    // Yield while the ring is full
+    while (written < size)
+    {
+        const Size bytes = tryWrite(channel, buffer, count, datatype, written);
+        if (bytes == 0)
+            ProcessCtl(SELF, Schedule, 0);
+
+        written += bytes;
+    }
+}
+
+Size MpiStream::tryWrite(MemoryChannel *channel,
+                         const void *buffer,
+                         const Size count,
+                         const MPI_Datatype datatype,
+                         const Size offset)
+{
+    MPIMessage batch[BatchMessages];
+    const Size size = (count * MpiDatatype::getSize(datatype)) - offset;
+    Size messages = 0, packed = 0, written = 0;
+
+    // Gather the next bytes in full messages
+    for (; messages < BatchMessages && packed < size; messages++)
+    {
+        const Size bytes = size - packed < MPIMessage::PayloadSize ?
+                           size - packed : MPIMessage::PayloadSize;
+
+        batch[messages].size = bytes;
+        MpiDatatype::pack(buffer, count, datatype, offset + packed, batch[messages].data, bytes);
+        packed += bytes;
+    }
+
+    // Publish as many messages as fit at once
+    if (messages == 0 || channel->writeBatch(batch, messages, written) != Channel::Success)
+        return 0;
+
+    return written < messages ? written * MPIMessage::PayloadSize : packed;
+}
+
+void MpiStream::read(MemoryChannel *channel,
+                     void *buffer,
+                     const Size size,
+                     AdaptiveSpin *spin)
+{
+    read(channel, buffer, size, MPI_BYTE, spin);
+}
+
+void MpiStream::read(MemoryChannel *channel,
+                     void *buffer,
+                     const Size count,
+                     const MPI_Datatype datatype,
+                     AdaptiveSpin *spin)
+{
+    const Size size = count * MpiDatatype::getSize(datatype);
+    Size done = 0;
+
+    while (done < size)
+    {
+        // Receive the next message when the current one is consumed
+        if (m_offset >= m_length)
+        {
+            // Poll the ring without system calls first, then yield the core
+            if (!spin || !receive(channel, spin))
+            {
+                while (!receive(channel, ZERO))
+                {
+                    ProcessCtl(SELF, Schedule, 0);
+                }
+
+                if (spin)
+                    spin->blocked();
+            }
+        }
+
+        done += consume(buffer, count, datatype, done, size - done);
+    }
+}
+
+Size MpiStream::tryRead(MemoryChannel *channel,
+                        void *buffer,
+                        const Size count,
+                        const MPI_Datatype datatype,
+                        const Size offset)
+{
+    const Size size = (count * MpiDatatype::getSize(datatype)) - offset;
+    Size done = 0;
+
+    while (done < size)
+    {
+        // Receive the next message when the current one is consumed
+        if (m_offset >= m_length && !receive(channel, ZERO))
+            break;
+
+        done += consume(buffer, count, datatype, offset + done, size - done);
+    }
+
+    return done;
+}
+
+void MpiStream::reset()
+{
+    m_message.size = 0;
+    m_length = 0;
+    m_offset = 0;
+}
+
+Size MpiStream::writeRendezvous(MemoryChannel *channel,
+                                const void *buffer,
+                                const Size size)
+{
+    static Memory::Range ackPage;
+    static u32 sequence = 0;
+    const Address base = (const Address) buffer;
+    Size done = 0;
+
+    // Allocate an uncached page for acknowledges, such that no cache maintenance is needed
+    if (ackPage.virt == ZERO)
+    {
+        ackPage.virt = 0;
+        ackPage.phys = 0;
+        ackPage.size = PAGESIZE;
+        ackPage.access = Memory::User | Memory::Readable | Memory::Writable | Memory::Uncached;
+
+        if (VMCtl(SELF, MapContiguous, &ackPage) != API::Success)
+        {
+            ackPage.virt = ZERO;
+            return 0;
+        }
+        MemoryBlock::set((void *) ackPage.virt, 0, PAGESIZE);
+    }
+
+    // Write back the buffer from our cache, such that the reader sees the data
+    Memory::Range dirty;
+    dirty.virt = base;
+    dirty.size = size;
+    VMCtl(SELF, CacheClean, &dirty);
+
+    // Publish descriptors with the physical extents of the buffer
+    for (bool translated = true; translated && done < size; )
+    {
+        MPIMessage msg;
+        Descriptor *desc = (Descriptor *) msg.data;
+
+        msg.size = MPIMessage::Rendezvous;
+        desc->ack = ackPage.phys;
+        desc->sequence = sequence + 1;
+        desc->count = 0;
+
+        while (done < size && desc->count < MaximumExtents)
+        {
+            Memory::Range range;
+            range.virt = base + done;
+
+            // The remainder is written inline when a page cannot be translated
+            if (VMCtl(SELF, LookupVirtual, &range) != API::Success)
+            {
+                translated = false;
+                break;
+            }
+
+            const Size chunk = PAGESIZE - (range.virt & ~PAGEMASK) < size - done ?
+                               PAGESIZE - (range.virt & ~PAGEMASK) : size - done;
+
+            // Merge physically contiguous pages into a single extent
+            if (desc->count > 0 &&
+                desc->extents[desc->count - 1].phys + desc->extents[desc->count - 1].size == range.phys)
+            {
+                desc->extents[desc->count - 1].size += chunk;
+            }
+            else
+            {
+                desc->extents[desc->count].phys = range.phys;
+                desc->extents[desc->count].size = chunk;
+                desc->count++;
+            }
+            done += chunk;
+        }
+
+        if (desc->count == 0)
+            break;
+
+        while (channel->write(&msg) != Channel::Success)
+            ProcessCtl(SELF, Schedule, 0);
+
+        sequence++;
+    }
+
+    // The buffer may only change after the reader copied all descriptors
+    while (*((volatile u32 *) ackPage.virt) != sequence)
+        ProcessCtl(SELF, Schedule, 0);
+
+    return done;
+}
+
+bool MpiStream::receive(MemoryChannel *channel,
+                        AdaptiveSpin *spin)
+{
+    const Channel::Result result = spin ? spin->read(channel, &m_message) :
+                                          channel->read(&m_message);
+    if (result != Channel::Success)
+        return false;
+
+    m_offset = 0;
+    m_length = m_message.size;
+
+    // The data of a rendezvous is the sum of its extents
+    if (m_message.size & MPIMessage::Rendezvous)
+    {
+        const Descriptor *desc = (const Descriptor *) m_message.data;
+        m_length = 0;
+
+        for (Size i = 0; i < desc->count; i++)
+            m_length += desc->extents[i].size;
+    }
+
+    return true;
+}
+
+Size MpiStream::consume(u8 *buffer,
+                        const Size size)
+{
+    const Size available = m_length - m_offset;
+    const Size bytes = size < available ? size : available;
+
+    if (!(m_message.size & MPIMessage::Rendezvous))
+    {
+        MemoryBlock::copy(buffer, m_message.data + m_offset, bytes);
+        m_offset += bytes;
+        return bytes;
+    }
+
+    const Descriptor *desc = (const Descriptor *) m_message.data;
+    Size copied = 0, start = 0;
+
+    // Copy directly from the pages of the writer
+    for (Size i = 0; i < desc->count && copied < bytes; i++)
+    {
+        const Extent & ext = desc->extents[i];
+
+        if (m_offset < start + ext.size)
+        {
+            const Size skip = m_offset - start;
+            const Size chunk = ext.size - skip < bytes - copied ?
+                               ext.size - skip : bytes - copied;
+            Memory::Range range;
+
+            range.phys = (ext.phys + skip) & PAGEMASK;
+            range.virt = 0;
+            range.size = ((ext.phys + skip + chunk + PAGESIZE - 1) & PAGEMASK) - range.phys;
+            range.access = Memory::User | Memory::Readable;
+
+            if (VMCtl(SELF, MapContiguous, &range) != API::Success)
+                break;
+
+            // Drop stale lines of an earlier rendezvous from the same pages
+            Memory::Range lines;
+            lines.virt = range.virt + ((ext.phys + skip) & ~PAGEMASK);
+            lines.size = chunk;
+            VMCtl(SELF, CacheInvalidate, &lines);
+
+            MemoryBlock::copy(buffer + copied, (void *) (range.virt + ((ext.phys + skip) & ~PAGEMASK)), chunk);
+            VMCtl(SELF, UnMap, &range);
+
+            copied += chunk;
+            m_offset += chunk;
+        }
+        start += ext.size;
+    }
+
+    // Acknowledge the descriptor when all of its data is copied
+    if (m_offset >= m_length)
+    {
+        Memory::Range range;
+
+        range.phys = desc->ack & PAGEMASK;
+        range.virt = 0;
+        range.size = PAGESIZE;
+        range.access = Memory::User | Memory::Readable | Memory::Writable | Memory::Uncached;
+
+        if (VMCtl(SELF, MapContiguous, &range) == API::Success)
+        {
+            *((volatile u32 *) (range.virt + (desc->ack & ~PAGEMASK))) = desc->sequence;
+            VMCtl(SELF, UnMap, &range);
+        }
+    }
+
+    return copied;
+}
+
+Size MpiStream::consume(void *buffer,
+                        const Size count,
+                        const MPI_Datatype datatype,
+                        const Size offset,
+                        const Size size)
+{
+    const Size available = m_length - m_offset;
+    const Size bytes = size < available ? size : available;
+    u8 packed[PAGESIZE / 4];
+
+    if (MpiDatatype::isContiguous(datatype))
+    {
+        return consume(((u8 *) buffer) + offset, size);
+    }
+
+    // Scatter inline data directly out of the message
+    if (!(m_message.size & MPIMessage::Rendezvous))
+    {
+        MpiDatatype::unpack(buffer, count, datatype, offset, m_message.data + m_offset, bytes);
+        m_offset += bytes;
+        return bytes;
+    }
+
+    // Rendezvous data is only reachable through temporary mappings
+    const Size copied = consume(packed, bytes < sizeof(packed) ? bytes : sizeof(packed));
+    MpiDatatype::unpack(buffer, count, datatype, offset, packed, copied);
+    return copied;
+}
@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __LIB_LIBMPI_MPISTREAM_H
+#define __LIB_LIBMPI_MPISTREAM_H
+
+#include <Types.h>
+#include <MemoryChannel.h>
+#include <AdaptiveSpin.h>
+#include "MPIMessage.h"
+#include "MpiDatatype.h"
+#include "mpi.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libmpi
+ * @{
+ */
+
+/**
+ * Transfers buffers of data elements over a MemoryChannel.
+ *
+ * Elements are packed in MPIMessages as raw bytes, such that each message
+ * carries up to MPIMessage::PayloadSize bytes instead of a single element.
+ * Elements of derived datatypes are gathered directly from (and scattered
+ * directly into) the strided buffer, without an intermediate packed copy.
+ * A reader keeps the remainder of a partially consumed message,
+ * thus the sizes of reads do not need to match the sizes of writes.
+ *
+ * Blocking writes of large buffers use a rendezvous instead: the writer
+ * publishes descriptors with the physical extents of the buffer and the reader
+ * copies directly from those pages, then acknowledges via a shared word.
+ * The data is copied once, instead of once into and once out of the ring.
+ */
+class MpiStream
+{
+  public:
+
+    /** Number of messages packed before writing them to the channel at once */
+    static const Size BatchMessages = 8;
+
+    /** Minimum number of bytes in a write for using a rendezvous */
+    static const Size RendezvousSize = PAGESIZE * 4;
+
+  private:
+
+    /**
+     * Physically contiguous part of a rendezvous buffer
+     */
+    struct Extent
+    {
+        Address phys;   /**< Physical address of the first byte */
+        Size size;      /**< Number of bytes */
+    };
+
+    /**
+     * Rendezvous descriptor inside the payload of a MPIMessage
+     */
+    struct Descriptor
+    {
+        Address ack;    /**< Physical address of the acknowledge word of the writer */
+        u32 sequence;   /**< Value to store in the acknowledge word when copied */
+        u32 count;      /**< Number of extents */
+        Extent extents[(MPIMessage::PayloadSize - sizeof(Address) - (sizeof(u32) * 2)) / sizeof(Extent)];
+    };
+
+    /** Maximum number of extents in a single descriptor */
+    static const Size MaximumExtents = sizeof(((Descriptor *) 0)->extents) / sizeof(Extent);
+
+  public:
+
+    /**
+     * Constructor
+     */
+    MpiStream();
+
+    /**
+     * Write a buffer to the channel.
+     *
+     * Yields the processor while the channel is full. Buffers of at least
+     * RendezvousSize bytes are passed by rendezvous, in which case this
+     * function returns after the reader copied the data.
+     *
+     * @param channel Producer MemoryChannel
+     * @param buffer Input buffer
+     * @param size Number of bytes to write
+     */
+    static void write(MemoryChannel *channel,
+                      const void *buffer,
+                      const Size size);
+
+    /**
+     * Write a buffer of data elements to the channel.
+     *
+     * @param channel Producer MemoryChannel
+     * @param buffer Input buffer
+     * @param count Number of elements to write
+     * @param datatype Type of the elements
+     */
+    static void write(MemoryChannel *channel,
+                      const void *buffer,
+                      const Size count,
+                      const MPI_Datatype datatype);
+
+    /**
+     * Write as much of a buffer as fits in the channel, without waiting.
+     *
+     * @param channel Producer MemoryChannel
+     * @param buffer Input buffer
+     * @param count Number of elements in the buffer
+     * @param datatype Type of the elements
+     * @param offset Number of packed bytes which are already written
+     *
+     * @return Number of bytes written
+     */
+    static Size tryWrite(MemoryChannel *channel,
+                         const void *buffer,
+                         const Size count,
+                         const MPI_Datatype datatype,
+                         const Size offset);
+
+    /**
+     * Read a buffer from the channel.
+     *
+     * Yields the processor until enough messages are received.
+     *
+     * @param channel Consumer MemoryChannel
+     * @param buffer Output buffer
+     * @param size Number of bytes to read
+     * @param spin Optional spin budget for polling the channel before yielding
+     */
+    void read(MemoryChannel *channel,
+              void *buffer,
+              const Size size,
+              AdaptiveSpin *spin = ZERO);
+
+    /**
+     * Read a buffer of data elements from the channel.
+     *
+     * @param channel Consumer MemoryChannel
+     * @param buffer Output buffer
+     * @param count Number of elements to read
+     * @param datatype Type of the elements
+     * @param spin Optional spin budget for polling the channel before yielding
+     */
+    void read(MemoryChannel *channel,
+              void *buffer,
+              const Size count,
+              const MPI_Datatype datatype,
+              AdaptiveSpin *spin = ZERO);
+
+    /**
+     * Read as much of a buffer as is available in the channel, without waiting.
+     *
+     * @param channel Consumer MemoryChannel
+     * @param buffer Output buffer
+     * @param count Number of elements in the buffer
+     * @param datatype Type of the elements
+     * @param offset Number of packed bytes which are already read
+     *
+     * @return Number of bytes read
+     */
+    Size tryRead(MemoryChannel *channel,
+                 void *buffer,
+                 const Size count,
+                 const MPI_Datatype datatype,
+                 const Size offset);
+
+    /**
+     * Discard the remainder of the current message.
+     */
+    void reset();
+
+  private:
+
+    /**
+     * Write a buffer to the channel by rendezvous.
+     *
+     * @param channel Producer MemoryChannel
+     * @param buffer Input buffer
+     * @param size Number of bytes to write
+     *
+     * @return Number of bytes passed by rendezvous, the rest must be written inline
+     */
+    static Size writeRendezvous(MemoryChannel *channel,
+                                const void *buffer,
+                                const Size size);
+
+    /**
+     * Receive the next message from the channel.
+     *
+     * @param channel Consumer MemoryChannel
+     * @param spin Optional spin budget for polling the channel
+     *
+     * @return True if a message was received
+     */
+    bool receive(MemoryChannel *channel,
+                 AdaptiveSpin *spin);
+
+    /**
+     * Copy bytes out of the current message.
+     *
+     * Acknowledges a rendezvous descriptor when all of its data is copied.
+     *
+     * @param buffer Output buffer
+     * @param size Maximum number of bytes to copy
+     *
+     * @return Number of bytes copied
+     */
+    Size consume(u8 *buffer,
+                 const Size size);
+
+    /**
+     * Copy bytes out of the current message into a buffer of data elements.
+     *
+     * @param buffer Output buffer
+     * @param count Number of elements in the buffer
+     * @param datatype Type of the elements
+     * @param offset First packed byte to copy
+     * @param size Maximum number of bytes to copy
+     *
+     * @return Number of bytes copied
+     */
+    Size consume(void *buffer,
+                 const Size count,
+                 const MPI_Datatype datatype,
+                 const Size offset,
+                 const Size size);
+
+  private:
+
+    /** Message which is currently read */
+    MPIMessage m_message;
+
+    /** Number of data bytes in the current message */
+    Size m_length;
+
+    /** Number of bytes of the current message which are read */
+    Size m_offset;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBMPI_MPISTREAM_H */
@@ -82,7 +82,6 @@ MpiTarget::Result MpiTarget::send(const void *buf,
                                   int tag,
                                   MPI_Comm comm)
 {
-    MPIMessage msg;
     MemoryChannel *ch;
 
     if (!(ch = m_writeChannels.get(dest)))
@@ -90,28 +89,12 @@ MpiTarget::Result MpiTarget::send(const void *buf,
         return MPI_ERR_RANK;
     }
 
-    for (int i = 0; i < count; i++)
+    if (MpiDatatype::getSize(datatype) == 0)
     {
-        switch (datatype)
-        {
-            case MPI_INT:
-                msg.integer = *(((int *) buf) + i);
-                break;
-
-            case MPI_UNSIGNED_CHAR:
-                msg.uchar = *(((u8 *) buf) + i);
-                break;
-
-            default:
-                return MPI_ERR_UNSUPPORTED_DATAREP;
-        }
-
-        while (ch->write(&msg) != Channel::Success)
-        {
-            ProcessCtl(SELF, Schedule, 0);
-        }
+        return MPI_ERR_UNSUPPORTED_DATAREP;
     }
 
+    MpiStream::write(ch, buf, count, datatype);
     return MPI_SUCCESS;
 }
 
@@ -123,7 +106,6 @@ MpiTarget::Result MpiTarget::receive(void *buf,
                                      MPI_Comm comm,
                                      MPI_Status *status)
 {
-    MPIMessage msg;
     MemoryChannel *ch;
 
     if (!(ch = m_readChannels.get(source)))
@@ -131,31 +113,55 @@ MpiTarget::Result MpiTarget::receive(void *buf,
         return MPI_ERR_RANK;
     }
 
-    for (int i = 0; i < count; i++)
+    if (MpiDatatype::getSize(datatype) == 0)
+    {
+        return MPI_ERR_UNSUPPORTED_DATAREP;
+    }
+
+    m_readStreams[source].read(ch, buf, count, datatype, &m_readSpin[source]);
+    return MPI_SUCCESS;
+}
+
+MpiTarget::Result MpiTarget::progress(Request *request)
+{
+    const Size size = request->count * MpiDatatype::getSize(request->datatype);
+    MemoryChannel *ch;
+
+    if (MpiDatatype::getSize(request->datatype) == 0)
     {
-        while (ch->read(&msg) != Channel::Success)
+        return MPI_ERR_UNSUPPORTED_DATAREP;
+    }
+
+    if (request->send)
+    {
+        if (!(ch = m_writeChannels.get(request->peer)))
         {
-            ProcessCtl(SELF, Schedule, 0);
+            return MPI_ERR_RANK;
         }
 
-        switch (datatype)
+        request->offset += MpiStream::tryWrite(ch, request->buffer, request->count,
+                                               request->datatype, request->offset);
+    }
+    else
+    {
+        if (!(ch = m_readChannels.get(request->peer)))
         {
-            case MPI_INT:
-                *(((int *) buf) + i) = msg.integer;
-                break;
-
-            case MPI_UNSIGNED_CHAR:
-                *(((u8 *) buf) + i) = msg.uchar;
-                break;
-
-            default:
-                return MPI_ERR_UNSUPPORTED_DATAREP;
+            return MPI_ERR_RANK;
         }
+
+        request->offset += m_readStreams[request->peer].tryRead(ch, request->buffer, request->count,
+                                                                request->datatype, request->offset);
     }
 
+    request->complete = request->offset >= size;
     return MPI_SUCCESS;
 }
 
+void MpiTarget::waitIdle()
+{
+    ProcessCtl(SELF, Schedule, 0);
+}
+
 MpiTarget::Result MpiTarget::initializeMaster(int *argc,
                                               char ***argv)
 {
@@ -247,26 +253,43 @@ MpiTarget::Result MpiTarget::initializeMaster(int *argc,
     MemoryBlock::set((void *) m_memChannelBase.virt, 0, m_memChannelBase.size);
 
     // now create the slaves using coreservers.
-    for (Size i = 1; i < m_coreCount; i++)
+    if (m_coreCount > 1)
     {
-        String programCmd;
-
-        // Format program command with MPI specific arguments for the slaves
-        programCmd << programPath << " --slave " <<
-            Number::Hex << (void *)(m_memChannelBase.phys) << " " <<
-            Number::Dec << i << " " << m_coreCount;
+        const Size slaveCount = m_coreCount - 1;
+        String *programCmds = new String[slaveCount];
+        const char **commands = new const char *[slaveCount];
+        Size *coreIds = new Size[slaveCount];
 
-        // Append additional user arguments
-        for (int j = 1; j < *argc; j++)
+        for (Size i = 1; i < m_coreCount; i++)
         {
-            programCmd << " " << (*argv)[j];
+            String & programCmd = programCmds[i - 1];
+
+            // Format program command with MPI specific arguments for the slaves
+            programCmd << programPath << " --slave " <<
+                Number::Hex << (void *)(m_memChannelBase.phys) << " " <<
+                Number::Dec << i << " " << m_coreCount;
+
+            // Append additional user arguments
+            for (int j = 1; j < *argc; j++)
+            {
+                programCmd << " " << (*argv)[j];
+            }
+
+            // Let the CoreServer place consecutive ranks on cores which share caches
+            commands[i - 1] = *programCmd;
+            coreIds[i - 1] = Core::AnyCore;
         }
 
-        const Core::Result result = coreClient.createProcess(i, (const Address) programBuffer,
-                                                             lz4.getUncompressedSize(), *programCmd);
+        // Let the CoreServer start all slaves in parallel
+        const Core::Result result = coreClient.createProcesses(slaveCount, coreIds, (const Address) programBuffer,
+                                                               lz4.getUncompressedSize(), commands);
+        delete[] coreIds;
+        delete[] commands;
+        delete[] programCmds;
+
         if (result != Core::Success)
         {
-            ERROR("failed to create process on core" << i << ": result = " << (int) result);
+            ERROR("failed to create processes on " << slaveCount << " cores: result = " << (int) result);
             return MPI_ERR_SPAWN;
         }
     }
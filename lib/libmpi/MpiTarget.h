@@ -21,7 +21,9 @@
 #include <Types.h>
 #include <Index.h>
 #include <MemoryChannel.h>
+#include <AdaptiveSpin.h>
 #include "MpiBackend.h"
+#include "MpiStream.h"
 
 /**
  * @addtogroup lib
@@ -131,6 +133,24 @@ class MpiTarget : public MpiBackend
                            MPI_Comm comm,
                            MPI_Status *status);
 
+  protected:
+
+    /**
+     * Advance a request
+     *
+     * Transfers as many messages as the channel allows without waiting.
+     *
+     * @param request Request to advance
+     *
+     * @return Result code
+     */
+    virtual Result progress(Request *request);
+
+    /**
+     * Yield the processor while waiting for requests
+     */
+    virtual void waitIdle();
+
   private:
 
     /**
@@ -211,6 +231,12 @@ class MpiTarget : public MpiBackend
 
     /** Stores all channels for sending data to other cores */
     Index<MemoryChannel, MaximumChannels> m_writeChannels;
+
+    /** Spin budget for receiving data from each core */
+    AdaptiveSpin m_readSpin[MaximumChannels];
+
+    /** Partially received messages from each core */
+    MpiStream m_readStreams[MaximumChannels];
 };
 
 /**
@@ -17,55 +17,446 @@
 
 #include <Assert.h>
 #include "MpiBackend.h"
+#include "MpiProfiler.h"
 #include "mpi.h"
 
 static MpiBackend *mpiBackend = MpiBackend::create();
 
-extern C int MPI_Init(int *argc, char ***argv)
+static MpiProfiler mpiProfiler;
+
+extern C int PMPI_Init(int *argc, char ***argv)
 {
     assert(mpiBackend != ZERO);
-    return mpiBackend->initialize(argc, argv);
+
+    const int result = mpiBackend->initialize(argc, argv);
+    if (result == MPI_SUCCESS)
+    {
+        mpiProfiler.initialize(argc, argv);
+    }
+
+    return result;
 }
 
-extern C int MPI_Finalize(void)
+extern C int PMPI_Finalize(void)
 {
+    int rank = 0;
+
     assert(mpiBackend != ZERO);
+
+    mpiBackend->getCommRank(MPI_COMM_WORLD, &rank);
+    mpiProfiler.report(rank);
+
     return mpiBackend->terminate();
 }
 
-extern C int MPI_Send(const void *buf,
-                      int count,
-                      MPI_Datatype datatype,
-                      int dest,
-                      int tag,
-                      MPI_Comm comm)
+extern C int PMPI_Send(const void *buf,
+                       int count,
+                       MPI_Datatype datatype,
+                       int dest,
+                       int tag,
+                       MPI_Comm comm)
 {
     assert(mpiBackend != ZERO);
     return mpiBackend->send(buf, count, datatype, dest, tag, comm);
 }
 
-extern C int MPI_Recv(void *buf,
-                      int count,
-                      MPI_Datatype datatype,
-                      int source,
-                      int tag,
-                      MPI_Comm comm,
-                      MPI_Status *status)
+extern C int PMPI_Recv(void *buf,
+                       int count,
+                       MPI_Datatype datatype,
+                       int source,
+                       int tag,
+                       MPI_Comm comm,
+                       MPI_Status *status)
 {
     assert(mpiBackend != ZERO);
     return mpiBackend->receive(buf, count, datatype, source, tag, comm, status);
 }
 
-extern C int MPI_Comm_rank(MPI_Comm comm,
-                           int *rank)
+extern C int PMPI_Isend(const void *buf,
+                        int count,
+                        MPI_Datatype datatype,
+                        int dest,
+                        int tag,
+                        MPI_Comm comm,
+                        MPI_Request *request)
+{
+    assert(mpiBackend != ZERO);
+    return mpiBackend->startSend(buf, count, datatype, dest, tag, comm, request);
+}
+
+extern C int PMPI_Irecv(void *buf,
+                        int count,
+                        MPI_Datatype datatype,
+                        int source,
+                        int tag,
+                        MPI_Comm comm,
+                        MPI_Request *request)
+{
+    assert(mpiBackend != ZERO);
+    return mpiBackend->startReceive(buf, count, datatype, source, tag, comm, request);
+}
+
+extern C int PMPI_Wait(MPI_Request *request,
+                       MPI_Status *status)
+{
+    assert(mpiBackend != ZERO);
+    return mpiBackend->wait(request, status);
+}
+
+extern C int PMPI_Test(MPI_Request *request,
+                       int *flag,
+                       MPI_Status *status)
+{
+    assert(mpiBackend != ZERO);
+    return mpiBackend->test(request, flag, status);
+}
+
+extern C int PMPI_Waitall(int count,
+                          MPI_Request *requests,
+                          MPI_Status *statuses)
+{
+    assert(mpiBackend != ZERO);
+    return mpiBackend->waitAll(count, requests, statuses);
+}
+
+extern C int PMPI_Barrier(MPI_Comm comm)
+{
+    assert(mpiBackend != ZERO);
+    return mpiBackend->barrier(comm);
+}
+
+extern C int PMPI_Bcast(void *buffer,
+                        int count,
+                        MPI_Datatype datatype,
+                        int root,
+                        MPI_Comm comm)
+{
+    assert(mpiBackend != ZERO);
+    return mpiBackend->broadcast(buffer, count, datatype, root, comm);
+}
+
+extern C int PMPI_Reduce(const void *sendbuf,
+                         void *recvbuf,
+                         int count,
+                         MPI_Datatype datatype,
+                         MPI_Op op,
+                         int root,
+                         MPI_Comm comm)
+{
+    assert(mpiBackend != ZERO);
+    return mpiBackend->reduce(sendbuf, recvbuf, count, datatype, op, root, comm);
+}
+
+extern C int PMPI_Allreduce(const void *sendbuf,
+                            void *recvbuf,
+                            int count,
+                            MPI_Datatype datatype,
+                            MPI_Op op,
+                            MPI_Comm comm)
+{
+    assert(mpiBackend != ZERO);
+    return mpiBackend->allReduce(sendbuf, recvbuf, count, datatype, op, comm);
+}
+
+extern C int PMPI_Gather(const void *sendbuf,
+                         int sendcount,
+                         MPI_Datatype sendtype,
+                         void *recvbuf,
+                         int recvcount,
+                         MPI_Datatype recvtype,
+                         int root,
+                         MPI_Comm comm)
+{
+    assert(mpiBackend != ZERO);
+
+    // Only the root receives, thus rely on the send signature
+    return mpiBackend->gather(sendbuf, recvbuf, sendcount, sendtype, root, comm);
+}
+
+extern C int PMPI_Scatter(const void *sendbuf,
+                          int sendcount,
+                          MPI_Datatype sendtype,
+                          void *recvbuf,
+                          int recvcount,
+                          MPI_Datatype recvtype,
+                          int root,
+                          MPI_Comm comm)
+{
+    assert(mpiBackend != ZERO);
+
+    // Only the root sends, thus rely on the receive signature
+    return mpiBackend->scatter(sendbuf, recvbuf, recvcount, recvtype, root, comm);
+}
+
+extern C int PMPI_Comm_rank(MPI_Comm comm,
+                            int *rank)
 {
     assert(mpiBackend != ZERO);
     return mpiBackend->getCommRank(comm, rank);
 }
 
-extern C int MPI_Comm_size(MPI_Comm comm,
-                           int *size)
+extern C int PMPI_Comm_size(MPI_Comm comm,
+                            int *size)
 {
     assert(mpiBackend != ZERO);
     return mpiBackend->getCommSize(comm, size);
 }
+
+extern C int PMPI_Type_contiguous(int count,
+                                  MPI_Datatype oldtype,
+                                  MPI_Datatype *newtype)
+{
+    return MpiDatatype::create(1, count, count, oldtype, newtype);
+}
+
+extern C int PMPI_Type_vector(int count,
+                              int blocklength,
+                              int stride,
+                              MPI_Datatype oldtype,
+                              MPI_Datatype *newtype)
+{
+    return MpiDatatype::create(count, blocklength, stride, oldtype, newtype);
+}
+
+extern C int PMPI_Type_commit(MPI_Datatype *datatype)
+{
+    return MpiDatatype::commit(datatype);
+}
+
+extern C int PMPI_Type_free(MPI_Datatype *datatype)
+{
+    return MpiDatatype::release(datatype);
+}
+
+extern C int PMPI_Type_size(MPI_Datatype datatype,
+                            int *size)
+{
+    const Size bytes = MpiDatatype::getSize(datatype);
+    if (bytes == 0 && !MpiDatatype::isBasic(datatype))
+    {
+        return MPI_ERR_TYPE;
+    }
+
+    *size = bytes;
+    return MPI_SUCCESS;
+}
+
+/*
+ * Default MPI entry points. Each records the call in the built-in profiler
+ * and calls the PMPI entry point. Tools may replace these weak symbols.
+ */
+
+extern C WEAK int MPI_Init(int *argc, char ***argv)
+{
+    return PMPI_Init(argc, argv);
+}
+
+extern C WEAK int MPI_Finalize(void)
+{
+    return PMPI_Finalize();
+}
+
+extern C WEAK int MPI_Send(const void *buf,
+                           int count,
+                           MPI_Datatype datatype,
+                           int dest,
+                           int tag,
+                           MPI_Comm comm)
+{
+    const u64 start = mpiProfiler.start();
+    const int result = PMPI_Send(buf, count, datatype, dest, tag, comm);
+    mpiProfiler.record(MpiProfiler::Send, start, count * MpiDatatype::getSize(datatype));
+    return result;
+}
+
+extern C WEAK int MPI_Recv(void *buf,
+                           int count,
+                           MPI_Datatype datatype,
+                           int source,
+                           int tag,
+                           MPI_Comm comm,
+                           MPI_Status *status)
+{
+    const u64 start = mpiProfiler.start();
+    const int result = PMPI_Recv(buf, count, datatype, source, tag, comm, status);
+    mpiProfiler.record(MpiProfiler::Recv, start, count * MpiDatatype::getSize(datatype));
+    return result;
+}
+
+extern C WEAK int MPI_Isend(const void *buf,
+                            int count,
+                            MPI_Datatype datatype,
+                            int dest,
+                            int tag,
+                            MPI_Comm comm,
+                            MPI_Request *request)
+{
+    const u64 start = mpiProfiler.start();
+    const int result = PMPI_Isend(buf, count, datatype, dest, tag, comm, request);
+    mpiProfiler.record(MpiProfiler::Isend, start, count * MpiDatatype::getSize(datatype));
+    return result;
+}
+
+extern C WEAK int MPI_Irecv(void *buf,
+                            int count,
+                            MPI_Datatype datatype,
+                            int source,
+                            int tag,
+                            MPI_Comm comm,
+                            MPI_Request *request)
+{
+    const u64 start = mpiProfiler.start();
+    const int result = PMPI_Irecv(buf, count, datatype, source, tag, comm, request);
+    mpiProfiler.record(MpiProfiler::Irecv, start, count * MpiDatatype::getSize(datatype));
+    return result;
+}
+
+extern C WEAK int MPI_Wait(MPI_Request *request,
+                           MPI_Status *status)
+{
+    const u64 start = mpiProfiler.start();
+    const int result = PMPI_Wait(request, status);
+    mpiProfiler.record(MpiProfiler::Wait, start, 0);
+    return result;
+}
+
+extern C WEAK int MPI_Test(MPI_Request *request,
+                           int *flag,
+                           MPI_Status *status)
+{
+    const u64 start = mpiProfiler.start();
+    const int result = PMPI_Test(request, flag, status);
+    mpiProfiler.record(MpiProfiler::Test, start, 0);
+    return result;
+}
+
+extern C WEAK int MPI_Waitall(int count,
+                              MPI_Request *requests,
+                              MPI_Status *statuses)
+{
+    const u64 start = mpiProfiler.start();
+    const int result = PMPI_Waitall(count, requests, statuses);
+    mpiProfiler.record(MpiProfiler::Waitall, start, 0);
+    return result;
+}
+
+extern C WEAK int MPI_Barrier(MPI_Comm comm)
+{
+    const u64 start = mpiProfiler.start();
+    const int result = PMPI_Barrier(comm);
+    mpiProfiler.record(MpiProfiler::Barrier, start, 0);
+    return result;
+}
+
+extern C WEAK int MPI_Bcast(void *buffer,
+                            int count,
+                            MPI_Datatype datatype,
+                            int root,
+                            MPI_Comm comm)
+{
+    const u64 start = mpiProfiler.start();
+    const int result = PMPI_Bcast(buffer, count, datatype, root, comm);
+    mpiProfiler.record(MpiProfiler::Bcast, start, count * MpiDatatype::getSize(datatype));
+    return result;
+}
+
+extern C WEAK int MPI_Reduce(const void *sendbuf,
+                             void *recvbuf,
+                             int count,
+                             MPI_Datatype datatype,
+                             MPI_Op op,
+                             int root,
+                             MPI_Comm comm)
+{
+    const u64 start = mpiProfiler.start();
+    const int result = PMPI_Reduce(sendbuf, recvbuf, count, datatype, op, root, comm);
+    mpiProfiler.record(MpiProfiler::Reduce, start, count * MpiDatatype::getSize(datatype));
+    return result;
+}
+
+extern C WEAK int MPI_Allreduce(const void *sendbuf,
+                                void *recvbuf,
+                                int count,
+                                MPI_Datatype datatype,
+                                MPI_Op op,
+                                MPI_Comm comm)
+{
+    const u64 start = mpiProfiler.start();
+    const int result = PMPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm);
+    mpiProfiler.record(MpiProfiler::Allreduce, start, count * MpiDatatype::getSize(datatype));
+    return result;
+}
+
+extern C WEAK int MPI_Gather(const void *sendbuf,
+                             int sendcount,
+                             MPI_Datatype sendtype,
+                             void *recvbuf,
+                             int recvcount,
+                             MPI_Datatype recvtype,
+                             int root,
+                             MPI_Comm comm)
+{
+    const u64 start = mpiProfiler.start();
+    const int result = PMPI_Gather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm);
+    mpiProfiler.record(MpiProfiler::Gather, start, sendcount * MpiDatatype::getSize(sendtype));
+    return result;
+}
+
+extern C WEAK int MPI_Scatter(const void *sendbuf,
+                              int sendcount,
+                              MPI_Datatype sendtype,
+                              void *recvbuf,
+                              int recvcount,
+                              MPI_Datatype recvtype,
+                              int root,
+                              MPI_Comm comm)
+{
+    const u64 start = mpiProfiler.start();
+    const int result = PMPI_Scatter(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm);
+    mpiProfiler.record(MpiProfiler::Scatter, start, recvcount * MpiDatatype::getSize(recvtype));
+    return result;
+}
+
+extern C WEAK int MPI_Comm_rank(MPI_Comm comm,
+                                int *rank)
+{
+    return PMPI_Comm_rank(comm, rank);
+}
+
+extern C WEAK int MPI_Comm_size(MPI_Comm comm,
+                                int *size)
+{
+    return PMPI_Comm_size(comm, size);
+}
+
+extern C WEAK int MPI_Type_contiguous(int count,
+                                      MPI_Datatype oldtype,
+                                      MPI_Datatype *newtype)
+{
+    return PMPI_Type_contiguous(count, oldtype, newtype);
+}
+
+extern C WEAK int MPI_Type_vector(int count,
+                                  int blocklength,
+                                  int stride,
+                                  MPI_Datatype oldtype,
+                                  MPI_Datatype *newtype)
+{
+    return PMPI_Type_vector(count, blocklength, stride, oldtype, newtype);
+}
+
+extern C WEAK int MPI_Type_commit(MPI_Datatype *datatype)
+{
+    return PMPI_Type_commit(datatype);
+}
+
+extern C WEAK int MPI_Type_free(MPI_Datatype *datatype)
+{
+    return PMPI_Type_free(datatype);
+}
+
+extern C WEAK int MPI_Type_size(MPI_Datatype datatype,
+                                int *size)
+{
+    return PMPI_Type_size(datatype, size);
+}
@@ -40,10 +40,16 @@ typedef uint MPI_Comm;
 /** Status holder */
 typedef uint MPI_Status;
 
+/** Handle of a non-blocking operation */
+typedef uint MPI_Request;
+
+/** Datatype identifier */
+typedef uint MPI_Datatype;
+
 /**
  * Named Predefined Datatypes
  */
-typedef enum
+enum
 {
     MPI_CHAR = 0,
     MPI_SHORT,
@@ -52,9 +58,33 @@ typedef enum
     MPI_UNSIGNED_CHAR,
     MPI_UNSIGNED_SHORT,
     MPI_UNSIGNED,
-    MPI_UNSIGNED_LONG
+    MPI_UNSIGNED_LONG,
+    MPI_LONG_LONG,
+    MPI_UNSIGNED_LONG_LONG,
+    MPI_FLOAT,
+    MPI_DOUBLE,
+    MPI_BYTE
+};
+
+/**
+ * Reserved datatypes.
+ */
+enum
+{
+    MPI_DATATYPE_NULL = 0xffffffff
+};
+
+/**
+ * Predefined reduction operations
+ */
+typedef enum
+{
+    MPI_MAX = 0,
+    MPI_MIN,
+    MPI_SUM,
+    MPI_LAND
 }
-MPI_Datatype;
+MPI_Op;
 
 /**
  * Reserved communicators.
@@ -65,6 +95,14 @@ enum
     MPI_COMM_SELF
 };
 
+/**
+ * Reserved requests.
+ */
+enum
+{
+    MPI_REQUEST_NULL = 0
+};
+
 /**
  * MPI Error Codes.
  */
@@ -181,9 +219,6 @@ extern C int MPI_Comm_size(MPI_Comm comm,
 
 /**
  * @name Point-to-Point Communication
- *
- * @todo MPI_Scatter, MPI_Gather not yet supported.
- *
  * @{
  */
 
@@ -202,6 +237,236 @@ extern C int MPI_Recv(void *buf,
                       MPI_Comm comm,
                       MPI_Status *status);
 
+extern C int MPI_Isend(const void *buf,
+                       int count,
+                       MPI_Datatype datatype,
+                       int dest,
+                       int tag,
+                       MPI_Comm comm,
+                       MPI_Request *request);
+
+extern C int MPI_Irecv(void *buf,
+                       int count,
+                       MPI_Datatype datatype,
+                       int source,
+                       int tag,
+                       MPI_Comm comm,
+                       MPI_Request *request);
+
+extern C int MPI_Wait(MPI_Request *request,
+                      MPI_Status *status);
+
+extern C int MPI_Test(MPI_Request *request,
+                      int *flag,
+                      MPI_Status *status);
+
+extern C int MPI_Waitall(int count,
+                         MPI_Request *requests,
+                         MPI_Status *statuses);
+
+/**
+ * @}
+ */
+
+/**
+ * @name Collective Communication
+ *
+ * All ranks of the communicator must call the same collective operations in the same order.
+ *
+ * @{
+ */
+
+extern C int MPI_Barrier(MPI_Comm comm);
+
+extern C int MPI_Bcast(void *buffer,
+                       int count,
+                       MPI_Datatype datatype,
+                       int root,
+                       MPI_Comm comm);
+
+extern C int MPI_Reduce(const void *sendbuf,
+                        void *recvbuf,
+                        int count,
+                        MPI_Datatype datatype,
+                        MPI_Op op,
+                        int root,
+                        MPI_Comm comm);
+
+extern C int MPI_Allreduce(const void *sendbuf,
+                           void *recvbuf,
+                           int count,
+                           MPI_Datatype datatype,
+                           MPI_Op op,
+                           MPI_Comm comm);
+
+extern C int MPI_Gather(const void *sendbuf,
+                        int sendcount,
+                        MPI_Datatype sendtype,
+                        void *recvbuf,
+                        int recvcount,
+                        MPI_Datatype recvtype,
+                        int root,
+                        MPI_Comm comm);
+
+extern C int MPI_Scatter(const void *sendbuf,
+                         int sendcount,
+                         MPI_Datatype sendtype,
+                         void *recvbuf,
+                         int recvcount,
+                         MPI_Datatype recvtype,
+                         int root,
+                         MPI_Comm comm);
+
+/**
+ * @}
+ */
+
+/**
+ * @name Derived Datatypes
+ * @{
+ */
+
+extern C int MPI_Type_contiguous(int count,
+                                 MPI_Datatype oldtype,
+                                 MPI_Datatype *newtype);
+
+extern C int MPI_Type_vector(int count,
+                             int blocklength,
+                             int stride,
+                             MPI_Datatype oldtype,
+                             MPI_Datatype *newtype);
+
+extern C int MPI_Type_commit(MPI_Datatype *datatype);
+
+extern C int MPI_Type_free(MPI_Datatype *datatype);
+
+extern C int MPI_Type_size(MPI_Datatype datatype,
+                           int *size);
+
+/**
+ * @}
+ */
+
+/**
+ * @name Profiling Interface
+ *
+ * Every MPI function is also available with the PMPI prefix. The MPI
+ * functions are weak symbols, such that a profiling tool can replace them
+ * and call the PMPI function to perform the operation.
+ *
+ * @{
+ */
+
+extern C int PMPI_Init(int *argc, char ***argv);
+
+extern C int PMPI_Finalize(void);
+
+extern C int PMPI_Comm_rank(MPI_Comm comm,
+                            int *rank);
+
+extern C int PMPI_Comm_size(MPI_Comm comm,
+                            int *size);
+
+extern C int PMPI_Send(const void *buf,
+                       int count,
+                       MPI_Datatype datatype,
+                       int dest,
+                       int tag,
+                       MPI_Comm comm);
+
+extern C int PMPI_Recv(void *buf,
+                       int count,
+                       MPI_Datatype datatype,
+                       int source,
+                       int tag,
+                       MPI_Comm comm,
+                       MPI_Status *status);
+
+extern C int PMPI_Isend(const void *buf,
+                        int count,
+                        MPI_Datatype datatype,
+                        int dest,
+                        int tag,
+                        MPI_Comm comm,
+                        MPI_Request *request);
+
+extern C int PMPI_Irecv(void *buf,
+                        int count,
+                        MPI_Datatype datatype,
+                        int source,
+                        int tag,
+                        MPI_Comm comm,
+                        MPI_Request *request);
+
+extern C int PMPI_Wait(MPI_Request *request,
+                       MPI_Status *status);
+
+extern C int PMPI_Test(MPI_Request *request,
+                       int *flag,
+                       MPI_Status *status);
+
+extern C int PMPI_Waitall(int count,
+                          MPI_Request *requests,
+                          MPI_Status *statuses);
+
+extern C int PMPI_Barrier(MPI_Comm comm);
+
+extern C int PMPI_Bcast(void *buffer,
+                        int count,
+                        MPI_Datatype datatype,
+                        int root,
+                        MPI_Comm comm);
+
+extern C int PMPI_Reduce(const void *sendbuf,
+                         void *recvbuf,
+                         int count,
+                         MPI_Datatype datatype,
+                         MPI_Op op,
+                         int root,
+                         MPI_Comm comm);
+
+extern C int PMPI_Allreduce(const void *sendbuf,
+                            void *recvbuf,
+                            int count,
+                            MPI_Datatype datatype,
+                            MPI_Op op,
+                            MPI_Comm comm);
+
+extern C int PMPI_Gather(const void *sendbuf,
+                         int sendcount,
+                         MPI_Datatype sendtype,
+                         void *recvbuf,
+                         int recvcount,
+                         MPI_Datatype recvtype,
+                         int root,
+                         MPI_Comm comm);
+
+extern C int PMPI_Scatter(const void *sendbuf,
+                          int sendcount,
+                          MPI_Datatype sendtype,
+                          void *recvbuf,
+                          int recvcount,
+                          MPI_Datatype recvtype,
+                          int root,
+                          MPI_Comm comm);
+
+extern C int PMPI_Type_contiguous(int count,
+                                  MPI_Datatype oldtype,
+                                  MPI_Datatype *newtype);
+
+extern C int PMPI_Type_vector(int count,
+                              int blocklength,
+                              int stride,
+                              MPI_Datatype oldtype,
+                              MPI_Datatype *newtype);
+
+extern C int PMPI_Type_commit(MPI_Datatype *datatype);
+
+extern C int PMPI_Type_free(MPI_Datatype *datatype);
+
+extern C int PMPI_Type_size(MPI_Datatype datatype,
+                            int *size);
+
 /**
  * @}
  */
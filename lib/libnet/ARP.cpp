@@ -26,6 +26,8 @@ ARP::ARP(NetworkServer &server,
          NetworkDevice &device,
          NetworkProtocol &parent)
     : NetworkProtocol(server, device, parent)
+    , m_pendingCount(0)
+    , m_generation(0)
 {
     m_ip = 0;
 }
@@ -63,6 +65,12 @@ ARP::ARPCache * ARP::getCacheEntry(const IPV4::Address ipAddr)
 
 ARP::ARPCache * ARP::insertCacheEntry(const IPV4::Address ipAddr)
 {
+    // Keep the cache bounded
+    if (m_cache.count() >= MaxEntries && !evictCacheEntry())
+    {
+        return ZERO;
+    }
+
     ARPCache *entry = new ARPCache;
     MemoryBlock::set(entry, 0, sizeof(*entry));
     entry->valid  = false;
@@ -72,30 +80,100 @@ ARP::ARPCache * ARP::insertCacheEntry(const IPV4::Address ipAddr)
     return entry;
 }
 
+bool ARP::evictCacheEntry()
+{
+    Timer::Info now;
+    m_kernelTimer.tick();
+    m_kernelTimer.getCurrent(&now);
+
+    IPV4::Address oldest = 0;
+    u32 oldestAge = 0;
+    bool found = false;
+
+    for (HashIterator<IPV4::Address, ARPCache *> i(m_cache); i.hasCurrent(); i++)
+    {
+        const u32 age = now.ticks - i.current()->lastUsed;
+
+        if (i.current()->pendingCount == 0 && (!found || age > oldestAge))
+        {
+            oldest = i.key();
+            oldestAge = age;
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        return false;
+    }
+
+    DEBUG("evicting " << *IPV4::toString(oldest));
+    if (m_cache.at(oldest)->valid)
+        m_generation++;
+    delete m_cache.at(oldest);
+    m_cache.remove(oldest);
+    return true;
+}
+
 void ARP::updateCacheEntry(const IPV4::Address ipAddr,
                            const Ethernet::Address *ethAddr)
 {
     ARPCache *entry = getCacheEntry(ipAddr);
     if (entry)
     {
+        if (entry->valid && !MemoryBlock::compare(&entry->ethAddr, ethAddr, sizeof(Ethernet::Address)))
+            m_generation++;
+
         entry->valid = true;
+        entry->refreshing = false;
+        entry->retryCount = 0;
         MemoryBlock::copy(&entry->ethAddr, ethAddr, sizeof(Ethernet::Address));
+
+        m_kernelTimer.tick();
+        m_kernelTimer.getCurrent(&entry->refresh, ReachableTime - RefreshTime);
+        m_kernelTimer.getCurrent(&entry->expiry, ReachableTime);
+
+        // Transmit all packets which waited for this address
+        for (Size i = 0; i < entry->pendingCount; i++)
+        {
+            NetworkQueue::Packet *pkt = entry->pending[i];
+            Ethernet::Header *ether = (Ethernet::Header *) pkt->data;
+
+            MemoryBlock::copy(&ether->destination, ethAddr, sizeof(Ethernet::Address));
+            pkt->flags &= ~NetworkQueue::ResolvePending;
+
+            const FileSystem::Result result = m_parent.transmitPacket(pkt);
+            if (result != FileSystem::Success)
+            {
+                ERROR("failed to transmit pending packet: result = " << (int) result);
+            }
+        }
+        m_pendingCount -= entry->pendingCount;
+        entry->pendingCount = 0;
+
+        // Sockets of any protocol may wait for the resolved address
+        m_server.notifyAllFiles();
     }
 }
 
+void ARP::dropPending(ARPCache *entry)
+{
+    for (Size i = 0; i < entry->pendingCount; i++)
+    {
+        m_device.getTransmitQueue()->release(entry->pending[i]);
+    }
+
+    DEBUG("dropped " << entry->pendingCount << " pending packets");
+    countDrop(ARPPending, entry->pendingCount);
+    m_pendingCount -= entry->pendingCount;
+    entry->pendingCount = 0;
+}
+
 FileSystem::Result ARP::lookupAddress(const IPV4::Address *ipAddr,
                                       Ethernet::Address *ethAddr)
 {
     DEBUG("");
 
-    // See if we have the IP cached
-    const ARPCache *entry = getCacheEntry(*ipAddr);
-    if (entry && entry->valid)
-    {
-        MemoryBlock::copy(ethAddr, &entry->ethAddr, sizeof(Ethernet::Address));
-        return FileSystem::Success;
-    }
-
     // Is this a broadcast address?
     if (*ipAddr == 0xffffffff)
     {
@@ -103,10 +181,50 @@ FileSystem::Result ARP::lookupAddress(const IPV4::Address *ipAddr,
         return FileSystem::Success;
     }
 
-    // See if timeout has expired for re-transmission
-    m_kernelTimer.tick();
+    // Devices which receive their own packets need no resolving
+    if (m_device.getCapabilities() & NetworkDevice::LocalDelivery)
+    {
+        return m_device.getAddress(ethAddr);
+    }
+
+    ARPCache *entry = getCacheEntry(*ipAddr);
+    if (!entry)
+    {
+        m_server.setTimeout(RetransmitTime, RetransmitSlack);
+        return FileSystem::RetryAgain;
+    }
+
     Timer::Info inf;
+    m_kernelTimer.tick();
     m_kernelTimer.getCurrent(&inf);
+    entry->lastUsed = inf.ticks;
+
+    // See if we have the IP cached
+    if (entry->valid)
+    {
+        if (!m_kernelTimer.isExpired(entry->expiry))
+        {
+            MemoryBlock::copy(ethAddr, &entry->ethAddr, sizeof(Ethernet::Address));
+
+            // Refresh the entry before it expires, while it remains usable
+            if (!entry->refreshing && m_kernelTimer.isExpired(entry->refresh))
+            {
+                DEBUG("refreshing entry");
+                entry->refreshing = true;
+                sendRequest(*ipAddr);
+            }
+            return FileSystem::Success;
+        }
+
+        DEBUG("entry expired");
+        entry->valid = false;
+        m_generation++;
+        entry->refreshing = false;
+        entry->retryCount = 0;
+        entry->time.ticks = 0;
+    }
+
+    // See if timeout has expired for re-transmission
     DEBUG("entry->time.ticks = " << entry->time.ticks <<
           " entry->time.freq = " << entry->time.frequency <<
           " kernelTimer.ticks = " << inf.ticks <<
@@ -126,10 +244,82 @@ FileSystem::Result ARP::lookupAddress(const IPV4::Address *ipAddr,
     }
 
     // Make sure we are called again in about 500msec (or earlier)
-    m_server.setTimeout(500);
+    m_server.setTimeout(RetransmitTime, RetransmitSlack);
     return FileSystem::RetryAgain;
 }
 
+u32 ARP::getGeneration() const
+{
+    return m_generation;
+}
+
+bool ARP::canQueuePacket(const IPV4::Address ipAddr)
+{
+    const ARPCache * const *entry = m_cache.get(ipAddr);
+
+    return entry && (*entry)->pendingCount < MaxPending;
+}
+
+FileSystem::Result ARP::queuePacket(NetworkQueue::Packet *pkt)
+{
+    const IPV4::Header *ip = (const IPV4::Header *) (pkt->data + sizeof(Ethernet::Header));
+    const IPV4::Address address = readBe32(&ip->destination);
+
+    ARPCache *entry = getCacheEntry(address);
+    if (!entry)
+    {
+        m_device.getTransmitQueue()->release(pkt);
+        return FileSystem::RetryAgain;
+    }
+
+    // The reply may have arrived already
+    if (entry->valid)
+    {
+        Ethernet::Header *ether = (Ethernet::Header *) pkt->data;
+        MemoryBlock::copy(&ether->destination, &entry->ethAddr, sizeof(Ethernet::Address));
+        pkt->flags &= ~NetworkQueue::ResolvePending;
+        return m_parent.transmitPacket(pkt);
+    }
+
+    if (entry->pendingCount >= MaxPending)
+    {
+        m_device.getTransmitQueue()->release(pkt);
+        return FileSystem::RetryAgain;
+    }
+
+    DEBUG("address = " << *IPV4::toString(address) << " pending = " << entry->pendingCount);
+    entry->pending[entry->pendingCount++] = pkt;
+    m_pendingCount++;
+    m_server.setTimeout(RetransmitTime, RetransmitSlack);
+    return FileSystem::Success;
+}
+
+void ARP::processTimers()
+{
+    if (m_pendingCount == 0)
+    {
+        return;
+    }
+
+    m_kernelTimer.tick();
+
+    for (HashIterator<IPV4::Address, ARPCache *> i(m_cache); i.hasCurrent(); i++)
+    {
+        ARPCache *entry = i.current();
+
+        if (entry->pendingCount > 0 && m_kernelTimer.isExpired(entry->time))
+        {
+            // Drops the pending packets after the last retry
+            sendRequest(i.key());
+        }
+    }
+
+    if (m_pendingCount > 0)
+    {
+        m_server.setTimeout(RetransmitTime, RetransmitSlack);
+    }
+}
+
 FileSystem::Result ARP::sendRequest(const IPV4::Address address)
 {
     DEBUG("address = " << *IPV4::toString(address));
@@ -142,15 +332,15 @@ FileSystem::Result ARP::sendRequest(const IPV4::Address address)
     }
 
     // Update the cache entry administration
-    entry->valid = false;
     entry->retryCount++;
     if (entry->retryCount > MaxRetries)
     {
         entry->retryCount = 0;
+        dropPending(entry);
         return FileSystem::NotFound;
     }
     m_kernelTimer.tick();
-    m_kernelTimer.getCurrent(&entry->time, 500);
+    m_kernelTimer.getCurrent(&entry->time, RetransmitTime);
 
     // Destination is broadcast ethernet address
     Ethernet::Address destAddr;
@@ -191,7 +381,8 @@ FileSystem::Result ARP::sendRequest(const IPV4::Address address)
     writeBe32(&arp->ipTarget, address);
 
     // Send the packet using the network device
-    return m_device.transmit(pkt);
+    countTransmit(sizeof(ARP::Header));
+    return m_parent.transmitPacket(pkt);
 }
 
 FileSystem::Result ARP::sendReply(const Ethernet::Address *ethAddr, const IPV4::Address ipAddr)
@@ -240,7 +431,8 @@ FileSystem::Result ARP::sendReply(const Ethernet::Address *ethAddr, const IPV4::
     writeBe32(&arp->ipTarget, ipAddr);
 
     // Send the packet using the network device
-    return m_device.transmit(pkt);
+    countTransmit(sizeof(ARP::Header));
+    return m_parent.transmitPacket(pkt);
 }
 
 FileSystem::Result ARP::process(const NetworkQueue::Packet *pkt, const Size offset)
@@ -253,6 +445,7 @@ FileSystem::Result ARP::process(const NetworkQueue::Packet *pkt, const Size offs
     IPV4::Address ipAddr;
 
     m_ip->getAddress(&ipAddr);
+    countReceive(pkt, offset);
 
     DEBUG("target = " << *IPV4::toString(ipTarget) << " sender = " << *IPV4::toString(ipSender) <<
           " ipAddr = " << *IPV4::toString(ipAddr) << " operation = " << operation <<
@@ -276,5 +469,6 @@ FileSystem::Result ARP::process(const NetworkQueue::Packet *pkt, const Size offs
     }
 
     // Unknown ARP operation
+    countDrop(Unsupported);
     return FileSystem::InvalidArgument;
 }
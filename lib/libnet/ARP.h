@@ -46,6 +46,24 @@ class ARP : public NetworkProtocol
     /** Maximum number of retries for ARP lookup */
     static const Size MaxRetries = 3;
 
+    /** Maximum number of entries in the ARP cache */
+    static const Size MaxEntries = 64;
+
+    /** Maximum number of packets waiting for resolution per entry */
+    static const Size MaxPending = 4;
+
+    /** Milliseconds between re-transmissions of a request */
+    static const Size RetransmitTime = 500;
+
+    /** Milliseconds a re-transmission may be delayed to coalesce wakeups */
+    static const Size RetransmitSlack = 100;
+
+    /** Milliseconds a resolved entry stays valid */
+    static const Size ReachableTime = 60000;
+
+    /** Milliseconds before expiry to refresh a resolved entry */
+    static const Size RefreshTime = 5000;
+
     /**
      * ARP table cache entry
      */
@@ -53,8 +71,14 @@ class ARP : public NetworkProtocol
     {
         Ethernet::Address ethAddr;
         Timer::Info time;
+        Timer::Info refresh;
+        Timer::Info expiry;
+        u32 lastUsed;
         Size retryCount;
         bool valid;
+        bool refreshing;
+        NetworkQueue::Packet *pending[MaxPending];
+        Size pendingCount;
     }
     ARPCache;
 
@@ -150,6 +174,47 @@ class ARP : public NetworkProtocol
     FileSystem::Result lookupAddress(const IPV4::Address *ipAddr,
                                      Ethernet::Address *ethAddr);
 
+    /**
+     * Get the generation of the ARP cache
+     *
+     * The generation changes whenever a resolved address changes,
+     * expires or is evicted. Callers which keep a resolved address
+     * must look it up again once the generation changed.
+     *
+     * @return Generation number
+     */
+    u32 getGeneration() const;
+
+    /**
+     * Check if a packet for an unresolved address can be queued
+     *
+     * @param ipAddr Destination IP address of the packet
+     *
+     * @return True if queuePacket() can accept a packet for the address
+     */
+    bool canQueuePacket(const IPV4::Address ipAddr);
+
+    /**
+     * Queue a packet until its destination is resolved
+     *
+     * The packet is transmitted as soon as the ARP reply arrives, or released
+     * when all retries of the request have failed. If the address is resolved
+     * already the packet is transmitted immediately.
+     *
+     * @param pkt Packet with an IPV4 header for an unresolved destination
+     *
+     * @return Result code
+     */
+    FileSystem::Result queuePacket(NetworkQueue::Packet *pkt);
+
+    /**
+     * Re-transmit requests for packets waiting on resolution
+     *
+     * Must be called regularly. Arranges a server timeout while
+     * packets are waiting.
+     */
+    void processTimers();
+
     /**
      * Send ARP request
      *
@@ -210,6 +275,20 @@ class ARP : public NetworkProtocol
     void updateCacheEntry(const IPV4::Address ipAddr,
                           const Ethernet::Address *ethAddr);
 
+    /**
+     * Remove the least recently used entry without waiting packets
+     *
+     * @return True if an entry was removed
+     */
+    bool evictCacheEntry();
+
+    /**
+     * Release all packets waiting on resolution of an entry
+     *
+     * @param entry ARPCache object pointer
+     */
+    void dropPending(ARPCache *entry);
+
   private:
 
     /** The single ARP socket */
@@ -221,6 +300,12 @@ class ARP : public NetworkProtocol
     /** Contains a cached mapping from IP to Ethernet addresses */
     HashTable<IPV4::Address, ARPCache *> m_cache;
 
+    /** Total number of packets waiting on resolution */
+    Size m_pendingCount;
+
+    /** Changes when a resolved address is no longer valid */
+    u32 m_generation;
+
     /** Provides access to the kernel timer */
     KernelTimer m_kernelTimer;
 };
@@ -23,7 +23,7 @@
 
 ARPSocket::ARPSocket(const u32 inode,
                      ARP *arp)
-    : NetworkSocket(inode, arp->getMaximumPacketSize(), ANY)
+    : NetworkSocket(inode, arp->getMaximumFrameSize(), ANY)
 {
     m_arp = arp;
     m_ipAddr = 0;
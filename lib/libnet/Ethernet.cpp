@@ -15,6 +15,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <FreeNOS/System.h>
 #include <ByteOrder.h>
 #include <MemoryBlock.h>
 #include "NetworkServer.h"
@@ -123,8 +124,29 @@ FileSystem::Result Ethernet::getTransmitPacket(NetworkQueue::Packet **pkt,
     return FileSystem::Success;
 }
 
+FileSystem::Result Ethernet::transmitPacket(NetworkQueue::Packet *pkt)
+{
+    countTransmit(pkt->size);
+    return m_device.transmit(pkt);
+}
+
 FileSystem::Result Ethernet::process(const NetworkQueue::Packet *pkt,
                                      const Size offset)
+{
+    const u64 start = timestamp();
+
+    countReceive(pkt, offset);
+
+    const FileSystem::Result result = dispatch(pkt, offset);
+    const u64 end = timestamp();
+
+    // Narrow 32-bit cycle counters may wrap around
+    m_stats.processCycles += end >= start ? end - start : (u32) (end - start);
+    return result;
+}
+
+FileSystem::Result Ethernet::dispatch(const NetworkQueue::Packet *pkt,
+                                      const Size offset)
 {
     const Ethernet::Header *ether = (const Ethernet::Header *) (pkt->data + offset);
     const u16 type = readBe16(&ether->type);
@@ -148,6 +170,7 @@ FileSystem::Result Ethernet::process(const NetworkQueue::Packet *pkt,
             break;
     }
 
+    countDrop(Unsupported);
     return FileSystem::InvalidArgument;
 }
 
@@ -137,6 +137,15 @@ class Ethernet : public NetworkProtocol
                                                  const Identifier protocol,
                                                  const Size payloadSize);
 
+    /**
+     * Transmit a packet obtained from getTransmitPacket
+     *
+     * @param pkt Packet to transmit
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result transmitPacket(NetworkQueue::Packet *pkt);
+
     /**
      * Convert address to string
      *
@@ -162,6 +171,9 @@ class Ethernet : public NetworkProtocol
     /**
      * Process incoming network packet.
      *
+     * The time spent is accounted in the statistics of this protocol,
+     * which therefore covers the processing of all upper-layer protocols.
+     *
      * @param pkt Incoming packet pointer
      * @param offset Offset for processing
      *
@@ -170,6 +182,19 @@ class Ethernet : public NetworkProtocol
     virtual FileSystem::Result process(const NetworkQueue::Packet *pkt,
                                        const Size offset);
 
+  private:
+
+    /**
+     * Dispatch incoming network packet to the upper-layer protocol.
+     *
+     * @param pkt Incoming packet pointer
+     * @param offset Offset for processing
+     *
+     * @return Result code
+     */
+    FileSystem::Result dispatch(const NetworkQueue::Packet *pkt,
+                                const Size offset);
+
   private:
 
     /** Current ethernet address */
@@ -52,6 +52,8 @@ FileSystem::Result ICMP::process(const NetworkQueue::Packet *pkt,
     const ICMP::Header *hdr = (const ICMP::Header *) (pkt->data + offset);
     const IPV4::Address source = readBe32(&iphdr->source);
 
+    countReceive(pkt, offset);
+
     DEBUG("source = " << *IPV4::toString(source) << " type = " <<
           hdr->type << " code = " << hdr->code << " id = " << hdr->id);
 
@@ -181,10 +183,13 @@ FileSystem::Result ICMP::sendPacket(const IPV4::Address ip,
     MemoryBlock::copy(pkt->data + pkt->size, payload, amount);
     pkt->size += amount;
 
-    // Calculate checksum
+    // Calculate checksum, unless the device inserts it
     write16(&header->checksum, 0);
-    write16(&header->checksum, IPV4::checksum(header, sizeof(ICMP::Header) + amount));
+
+    if (!(pkt->flags & NetworkQueue::ChecksumOffload))
+        write16(&header->checksum, IPV4::checksum(header, sizeof(ICMP::Header) + amount));
 
     // Transmit the packet
-    return m_device.transmit(pkt);
+    countTransmit(sizeof(ICMP::Header) + amount);
+    return m_parent.transmitPacket(pkt);
 }
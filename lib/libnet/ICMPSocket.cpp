@@ -25,7 +25,7 @@
 ICMPSocket::ICMPSocket(const u32 inode,
                        ICMP *icmp,
                        const ProcessID pid)
-    : NetworkSocket(inode, icmp->getMaximumPacketSize(), pid)
+    : NetworkSocket(inode, icmp->getMaximumFrameSize(), pid)
 {
     m_icmp = icmp;
     m_gotReply = false;
@@ -94,5 +94,6 @@ void ICMPSocket::setReply(const ICMP::Header *header)
     {
         MemoryBlock::copy(&m_reply, header, sizeof(ICMP::Header));
         m_gotReply = true;
+        notifyReady();
     }
 }
@@ -23,19 +23,26 @@
 #include "NetworkServer.h"
 #include "NetworkDevice.h"
 #include "IPV4.h"
+#include "InternetChecksum.h"
 #include "IPV4Address.h"
 #include "UDP.h"
+#include "TCP.h"
 #include "ICMP.h"
 
 IPV4::IPV4(NetworkServer &server,
            NetworkDevice &device,
            NetworkProtocol &parent)
     : NetworkProtocol(server, device, parent)
+    , m_reassemblyQueue(MaximumDatagramSize, MaximumReassembly * 2)
+    , m_reassemblyCount(0)
 {
     m_address = 0;
     m_icmp = 0;
     m_udp = 0;
+    m_tcp = 0;
     m_id = 1;
+
+    MemoryBlock::set(m_reassembly, 0, sizeof(m_reassembly));
 }
 
 IPV4::~IPV4()
@@ -67,6 +74,11 @@ void IPV4::setUDP(::UDP *udp)
     m_udp = udp;
 }
 
+void IPV4::setTCP(::TCP *tcp)
+{
+    m_tcp = tcp;
+}
+
 FileSystem::Result IPV4::getAddress(IPV4::Address *address)
 {
     *address = m_address;
@@ -138,15 +150,26 @@ FileSystem::Result IPV4::getTransmitPacket(NetworkQueue::Packet **pkt,
 {
     Ethernet::Address ethAddr;
 
+    bool resolved = true;
+
     // Find the ethernet address using ARP first
     FileSystem::Result result = m_arp->lookupAddress((const IPV4::Address *)address, &ethAddr);
     if (result != FileSystem::Success)
     {
-        if (result != FileSystem::RetryAgain)
+        // Let ARP hold the packet until the address is resolved, if possible
+        if (result == FileSystem::RetryAgain && m_arp->canQueuePacket(*(const IPV4::Address *)address))
         {
-            ERROR("failed to perform ARP lookup: result = " << (int) result);
+            MemoryBlock::set(&ethAddr, 0, sizeof(ethAddr));
+            resolved = false;
+        }
+        else
+        {
+            if (result != FileSystem::RetryAgain)
+            {
+                ERROR("failed to perform ARP lookup: result = " << (int) result);
+            }
+            return result;
         }
-        return result;
     }
 
     // Get a fresh ethernet packet
@@ -161,6 +184,9 @@ FileSystem::Result IPV4::getTransmitPacket(NetworkQueue::Packet **pkt,
         return result;
     }
 
+    if (!resolved)
+        (*pkt)->flags |= NetworkQueue::ResolvePending;
+
     // Fill IP header
     Header *hdr = (Header *) ((*pkt)->data + (*pkt)->size);
     hdr->versionIHL     = (sizeof(Header) / sizeof(u32)) | (4 << 4);
@@ -173,7 +199,13 @@ FileSystem::Result IPV4::getTransmitPacket(NetworkQueue::Packet **pkt,
     writeBe32(&hdr->source, m_address);
     writeBe32(&hdr->destination, *(u32 *)address);
     hdr->checksum       = 0;
-    hdr->checksum       = checksum(hdr, sizeof(Header));
+
+    // Let the device insert the IP and payload checksums, if supported
+    if (m_device.getCapabilities() & NetworkDevice::TransmitChecksum)
+        (*pkt)->flags |= NetworkQueue::ChecksumOffload;
+    else
+        hdr->checksum   = checksum(hdr, sizeof(Header));
+
     (*pkt)->size += sizeof(Header);
     m_id++;
 
@@ -181,30 +213,132 @@ FileSystem::Result IPV4::getTransmitPacket(NetworkQueue::Packet **pkt,
     return FileSystem::Success;
 }
 
-const u16 IPV4::checksum(const void *buffer, const Size length)
+FileSystem::Result IPV4::getTransmitPacket(NetworkQueue::Packet **pkt,
+                                           IPV4::HeaderTemplate *tmpl,
+                                           const IPV4::Address address,
+                                           const NetworkProtocol::Identifier protocol,
+                                           const Size payloadSize)
 {
-    const u16 *ptr = (const u16 *) buffer;
-    Size len = length;
-    uint sum = 0;
+    // Reuse the prebuilt headers while the resolved address is current
+    if (tmpl->valid &&
+        tmpl->destination == address &&
+        tmpl->protocol == protocol &&
+        tmpl->source == m_address &&
+        tmpl->generation == m_arp->getGeneration() &&
+        tmpl->uses < TemplateUses)
+    {
+        *pkt = m_device.getTransmitQueue()->get();
+        if (!*pkt)
+        {
+            return FileSystem::RetryAgain;
+        }
+
+        MemoryBlock::copy((*pkt)->data, tmpl->headers, sizeof(tmpl->headers));
+        (*pkt)->size  = sizeof(tmpl->headers);
+        (*pkt)->flags = tmpl->flags;
+
+        Header *hdr = (Header *) ((*pkt)->data + sizeof(Ethernet::Header));
+        writeBe16(&hdr->length, payloadSize + sizeof(Header));
+        writeBe16(&hdr->identification, m_id);
+
+        // The template checksum covers a zero length and identification
+        if (!(tmpl->flags & NetworkQueue::ChecksumOffload))
+        {
+            u16 sum = read16(&hdr->checksum);
+            sum = InternetChecksum::update(sum, 0, read16(&hdr->length));
+            sum = InternetChecksum::update(sum, 0, read16(&hdr->identification));
+            write16(&hdr->checksum, sum);
+        }
+
+        tmpl->uses++;
+        m_id++;
+        return FileSystem::Success;
+    }
+
+    tmpl->valid = false;
 
-    // Calculate sum of the buffer
-    while (len > 1)
+    const FileSystem::Result result = getTransmitPacket(pkt, &address, sizeof(address), protocol, payloadSize);
+    if (result != FileSystem::Success || ((*pkt)->flags & NetworkQueue::ResolvePending))
     {
-        sum += read16(ptr);
-        ptr++;
-        len -= 2;
+        return result;
     }
 
-    // Add left-over byte, if any
-    if (len > 0)
-        sum += (readBe16(ptr) << 8);
+    // Keep the headers of this packet without the per-packet fields
+    MemoryBlock::copy(tmpl->headers, (*pkt)->data, sizeof(tmpl->headers));
+
+    Header *hdr = (Header *) (tmpl->headers + sizeof(Ethernet::Header));
+    hdr->length = 0;
+    hdr->identification = 0;
+    hdr->checksum = 0;
 
-    // Enforce 16-bit checksum
-    while (sum >> 16)
-        sum = (sum >> 16) + (sum & 0xFFFF);
+    if (!((*pkt)->flags & NetworkQueue::ChecksumOffload))
+        hdr->checksum = checksum(hdr, sizeof(Header));
 
-    // Convert to one's complement
-    return (~sum);
+    tmpl->source      = m_address;
+    tmpl->destination = address;
+    tmpl->protocol    = protocol;
+    tmpl->generation  = m_arp->getGeneration();
+    tmpl->flags       = (*pkt)->flags & NetworkQueue::ChecksumOffload;
+    tmpl->uses        = 0;
+    tmpl->valid       = true;
+    return FileSystem::Success;
+}
+
+FileSystem::Result IPV4::getTransmitFragment(NetworkQueue::Packet **pkt,
+                                             const IPV4::Address address,
+                                             const NetworkProtocol::Identifier protocol,
+                                             const u16 identification,
+                                             const Size offset,
+                                             const Size payloadSize,
+                                             const bool more)
+{
+    Ethernet::Address ethAddr;
+
+    assert(offset % FragmentUnit == 0);
+
+    // All fragments are transmitted at once, thus cannot wait for ARP
+    const FileSystem::Result lookupResult = m_arp->lookupAddress(&address, &ethAddr);
+    if (lookupResult != FileSystem::Success)
+    {
+        return lookupResult;
+    }
+
+    const FileSystem::Result result = getTransmitPacket(pkt, &address, sizeof(address),
+                                                        protocol, payloadSize);
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+
+    // Turn the header into a fragment header
+    Header *hdr = (Header *) ((*pkt)->data + (*pkt)->size - sizeof(Header));
+    writeBe16(&hdr->identification, identification);
+    writeBe16(&hdr->fragmentOffset, (offset / FragmentUnit) | (more ? MoreFragments : 0));
+    hdr->checksum = 0;
+    hdr->checksum = checksum(hdr, sizeof(Header));
+    (*pkt)->flags &= ~NetworkQueue::ChecksumOffload;
+
+    return FileSystem::Success;
+}
+
+u16 IPV4::nextIdentification()
+{
+    return m_id++;
+}
+
+FileSystem::Result IPV4::transmitPacket(NetworkQueue::Packet *pkt)
+{
+    countTransmit(pkt->size - sizeof(Ethernet::Header));
+
+    if (pkt->flags & NetworkQueue::ResolvePending)
+        return m_arp->queuePacket(pkt);
+    else
+        return m_parent.transmitPacket(pkt);
+}
+
+const u16 IPV4::checksum(const void *buffer, const Size length)
+{
+    return InternetChecksum::checksum(buffer, length);
 }
 
 FileSystem::Result IPV4::process(const NetworkQueue::Packet *pkt,
@@ -215,12 +349,38 @@ FileSystem::Result IPV4::process(const NetworkQueue::Packet *pkt,
     const Header *hdr = (const Header *) (pkt->data + offset);
     const u32 destination = readBe32(&hdr->destination);
 
+    countReceive(pkt, offset);
+
     if (destination != m_address && destination != 0xffffffff && m_address != 0)
     {
         DEBUG("dropped packet for " << *IPV4::toString(destination));
+        countDrop(Filtered);
         return FileSystem::NotFound;
     }
 
+    // Verify the header checksum, unless the device did already
+    if (!(pkt->flags & NetworkQueue::ChecksumVerified) &&
+        checksum(hdr, (hdr->versionIHL & 0xf) * sizeof(u32)) != 0)
+    {
+        DEBUG("dropped packet with invalid header checksum");
+        countDrop(BadChecksum);
+        return FileSystem::InvalidArgument;
+    }
+
+    // Collect the fragments of a datagram first
+    if (readBe16(&hdr->fragmentOffset) & (MoreFragments | FragmentOffset))
+    {
+        return reassemble(pkt, offset);
+    }
+
+    return deliver(pkt, offset);
+}
+
+FileSystem::Result IPV4::deliver(const NetworkQueue::Packet *pkt,
+                                 const Size offset)
+{
+    const Header *hdr = (const Header *) (pkt->data + offset);
+
     switch (hdr->protocol)
     {
         case ICMP:
@@ -229,9 +389,166 @@ FileSystem::Result IPV4::process(const NetworkQueue::Packet *pkt,
         case UDP:
             return m_udp->process(pkt, offset + sizeof(Header));
 
+        case TCP:
+            return m_tcp->process(pkt, offset + sizeof(Header));
+
         default:
             break;
     }
 
+    countDrop(Unsupported);
     return FileSystem::InvalidArgument;
 }
+
+FileSystem::Result IPV4::reassemble(const NetworkQueue::Packet *pkt,
+                                    const Size offset)
+{
+    const Header *hdr = (const Header *) (pkt->data + offset);
+    const u16 fragment = readBe16(&hdr->fragmentOffset);
+    const Size position = (fragment & FragmentOffset) * FragmentUnit;
+    const Size length = readBe16(&hdr->length);
+    const bool more = fragment & MoreFragments;
+
+    DEBUG("identification = " << readBe16(&hdr->identification) <<
+          " offset = " << position << " length = " << length << " more = " << more);
+
+    // Fragments other than the last must fill whole units, and all must fit the buffer
+    if (length <= sizeof(Header) || offset + length > pkt->size ||
+        (more && (length - sizeof(Header)) % FragmentUnit) ||
+        sizeof(Ethernet::Header) + length + position > m_reassemblyQueue.getBufferSize())
+    {
+        DEBUG("dropped invalid fragment");
+        countDrop(Fragmentation);
+        return FileSystem::InvalidArgument;
+    }
+
+    Reassembly *entry = getReassembly(hdr);
+    if (!entry)
+    {
+        DEBUG("dropped fragment: no reassembly buffer available");
+        countDrop(Fragmentation);
+        return FileSystem::RetryAgain;
+    }
+
+    // Place the payload at its position behind the headers of the datagram
+    const Size size = length - sizeof(Header);
+    MemoryBlock::copy(entry->packet->data + sizeof(Ethernet::Header) + sizeof(Header) + position,
+                      pkt->data + offset + sizeof(Header), size);
+
+    // Count each unit once, such that duplicates and overlaps are harmless
+    for (Size i = position / FragmentUnit; i < (position + size + FragmentUnit - 1) / FragmentUnit; i++)
+    {
+        if (!(entry->received[i / 8] & (1 << (i % 8))))
+        {
+            entry->received[i / 8] |= (1 << (i % 8));
+            entry->units++;
+        }
+    }
+
+    if (!more)
+    {
+        entry->length = position + size;
+    }
+
+    // Wait for the missing fragments
+    if (entry->length == 0 || entry->units < (entry->length + FragmentUnit - 1) / FragmentUnit)
+    {
+        return FileSystem::Success;
+    }
+
+    // The datagram is complete: make its header describe an unfragmented datagram
+    NetworkQueue::Packet *datagram = entry->packet;
+    Header *datagramHdr = (Header *) (datagram->data + sizeof(Ethernet::Header));
+    datagram->size = sizeof(Ethernet::Header) + sizeof(Header) + entry->length;
+    writeBe16(&datagramHdr->length, sizeof(Header) + entry->length);
+    datagramHdr->fragmentOffset = 0;
+    datagram->flags = 0;
+    datagram->hash = NetworkDevice::flowHash(datagram);
+
+    // Sockets which queue the datagram take their own reference
+    const FileSystem::Result result = deliver(datagram, sizeof(Ethernet::Header));
+    releaseReassembly(entry);
+    return result;
+}
+
+IPV4::Reassembly * IPV4::getReassembly(const IPV4::Header *hdr)
+{
+    const Address source = readBe32(&hdr->source);
+    const Address destination = readBe32(&hdr->destination);
+    const u16 identification = readBe16(&hdr->identification);
+    Reassembly *unused = ZERO;
+
+    for (Size i = 0; i < MaximumReassembly; i++)
+    {
+        Reassembly *entry = &m_reassembly[i];
+
+        if (entry->packet == ZERO)
+        {
+            unused = unused ? unused : entry;
+        }
+        else if (entry->source == source && entry->destination == destination &&
+                 entry->identification == identification && entry->protocol == hdr->protocol)
+        {
+            return entry;
+        }
+    }
+
+    if (!unused || !(unused->packet = m_reassemblyQueue.get()))
+    {
+        return ZERO;
+    }
+
+    // The headers of the first fragment received are kept for the datagram
+    const Size headers = sizeof(Ethernet::Header) + sizeof(Header);
+    MemoryBlock::copy(unused->packet->data, ((const u8 *) hdr) - sizeof(Ethernet::Header), headers);
+    MemoryBlock::set(unused->received, 0, sizeof(unused->received));
+
+    unused->source = source;
+    unused->destination = destination;
+    unused->identification = identification;
+    unused->protocol = hdr->protocol;
+    unused->length = 0;
+    unused->units = 0;
+
+    m_kernelTimer.tick();
+    m_kernelTimer.getCurrent(&unused->expiry, ReassemblyTimeout);
+    m_server.setTimeout(ReassemblyTimeout, ReassemblySlack);
+    m_reassemblyCount++;
+
+    return unused;
+}
+
+void IPV4::releaseReassembly(IPV4::Reassembly *entry)
+{
+    m_reassemblyQueue.release(entry->packet);
+    entry->packet = ZERO;
+    m_reassemblyCount--;
+}
+
+void IPV4::processTimers()
+{
+    if (m_reassemblyCount == 0)
+    {
+        return;
+    }
+
+    m_kernelTimer.tick();
+
+    for (Size i = 0; i < MaximumReassembly; i++)
+    {
+        Reassembly *entry = &m_reassembly[i];
+
+        if (entry->packet != ZERO && m_kernelTimer.isExpired(entry->expiry))
+        {
+            DEBUG("dropped incomplete datagram " << entry->identification <<
+                  " from " << *IPV4::toString(entry->source));
+            countDrop(Fragmentation);
+            releaseReassembly(entry);
+        }
+    }
+
+    if (m_reassemblyCount > 0)
+    {
+        m_server.setTimeout(ReassemblyTimeout, ReassemblySlack);
+    }
+}
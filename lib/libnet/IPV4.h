@@ -20,11 +20,16 @@
 
 #include <Types.h>
 #include <String.h>
+#include <Timer.h>
+#include <KernelTimer.h>
 #include "NetworkProtocol.h"
+#include "NetworkQueue.h"
+#include "Ethernet.h"
 
 class ICMP;
 class ARP;
 class UDP;
+class TCP;
 
 /**
  * @addtogroup lib
@@ -36,6 +41,13 @@ class UDP;
 
 /**
  * Internet Protocol Version 4
+ *
+ * Datagrams larger than the MTU are sent in fragments by the upper-layer
+ * protocol using getTransmitFragment(). Received fragments are reassembled
+ * in a small queue of buffers which hold a complete datagram each, with the
+ * ethernet header at the start like received frames. A datagram
+ * which does not complete within ReassemblyTimeout is dropped, as are new
+ * datagrams while all reassembly buffers are in use.
  */
 class IPV4 : public NetworkProtocol
 {
@@ -94,6 +106,73 @@ class IPV4 : public NetworkProtocol
     }
     PseudoHeader;
 
+    /**
+     * Prebuilt link and IP headers for repeated transmission to one destination.
+     *
+     * Filled by getTransmitPacket() on the first packet and reused until the
+     * resolved link address changes. Only the length, identification and
+     * header checksum are patched for each packet.
+     */
+    typedef struct HeaderTemplate
+    {
+        bool valid;
+        Address source;
+        Address destination;
+        Identifier protocol;
+        u32 generation;   /**< ARP cache generation when the address was resolved */
+        Size uses;        /**< Number of packets built from the template */
+        u32 flags;        /**< Packet flags to apply */
+        u8 headers[sizeof(Ethernet::Header) + sizeof(Header)];
+    }
+    HeaderTemplate;
+
+    /** Number of packets built from a HeaderTemplate before the destination is resolved again */
+    static const Size TemplateUses = 1024;
+
+    /**
+     * Flags and offset in the fragmentOffset field
+     */
+    enum FragmentFlags
+    {
+        DontFragment   = 0x4000,
+        MoreFragments  = 0x2000,
+        FragmentOffset = 0x1fff
+    };
+
+    /** Fragment offsets and sizes are in units of this number of bytes */
+    static const Size FragmentUnit = 8;
+
+    /** Largest datagram which can be reassembled, including the ethernet and IP headers */
+    static const Size MaximumDatagramSize = NetworkQueue::MaximumBufferSize;
+
+    /** Maximum number of datagrams reassembled at the same time */
+    static const Size MaximumReassembly = 4;
+
+    /** Time in milliseconds to wait for the missing fragments of a datagram */
+    static const Size ReassemblyTimeout = 5000;
+
+    /** Milliseconds the reassembly timeout may be delayed to coalesce wakeups */
+    static const Size ReassemblySlack = 1000;
+
+  private:
+
+    /**
+     * Datagram which is being reassembled from fragments
+     */
+    typedef struct Reassembly
+    {
+        Address source;
+        Address destination;
+        u16 identification;
+        u8 protocol;
+        NetworkQueue::Packet *packet; /**< Buffer for the complete datagram, or ZERO if unused */
+        Size length;                  /**< Payload length, known when the last fragment arrived */
+        Size units;                   /**< Number of received fragment units */
+        Timer::Info expiry;           /**< Time at which the datagram is dropped */
+        u8 received[MaximumDatagramSize / FragmentUnit / 8]; /**< Received fragment units */
+    }
+    Reassembly;
+
   public:
 
     /**
@@ -140,6 +219,13 @@ class IPV4 : public NetworkProtocol
      */
     void setUDP(::UDP *udp);
 
+    /**
+     * Set TCP instance
+     *
+     * @param tcp TCP instance
+     */
+    void setTCP(::TCP *tcp);
+
     /**
      * Get current IP address
      *
@@ -192,6 +278,76 @@ class IPV4 : public NetworkProtocol
                                                  const Identifier protocol,
                                                  const Size payloadSize);
 
+    /**
+     * Get a new packet for transmission using prebuilt headers
+     *
+     * Skips the address lookup and header construction if the
+     * template is current, and refills the template otherwise.
+     *
+     * @param pkt On output contains a pointer to a Packet
+     * @param tmpl Header template for the destination
+     * @param address Destination IP address
+     * @param protocol Identifier for the protocol to create the packet for
+     * @param payloadSize Number of payload bytes
+     *
+     * @return Result code
+     */
+    FileSystem::Result getTransmitPacket(NetworkQueue::Packet **pkt,
+                                         HeaderTemplate *tmpl,
+                                         const Address address,
+                                         const Identifier protocol,
+                                         const Size payloadSize);
+
+    /**
+     * Get a new packet for transmission of one fragment of a datagram
+     *
+     * The destination must be resolved, such that all fragments can be
+     * transmitted at once. Checksums of fragments are never offloaded,
+     * because the payload checksum covers all fragments.
+     *
+     * @param pkt On output contains a pointer to a Packet
+     * @param address Destination IP address
+     * @param protocol Identifier for the protocol to create the packet for
+     * @param identification Identification shared by all fragments of the datagram
+     * @param offset Offset of the fragment payload in the datagram payload,
+     *               which must be a multiple of FragmentUnit
+     * @param payloadSize Number of payload bytes in the fragment
+     * @param more True if more fragments follow
+     *
+     * @return Result code
+     */
+    FileSystem::Result getTransmitFragment(NetworkQueue::Packet **pkt,
+                                           const Address address,
+                                           const Identifier protocol,
+                                           const u16 identification,
+                                           const Size offset,
+                                           const Size payloadSize,
+                                           const bool more);
+
+    /**
+     * Get the identification for a new fragmented datagram
+     *
+     * @return Identification value
+     */
+    u16 nextIdentification();
+
+    /**
+     * Transmit a packet obtained from getTransmitPacket
+     *
+     * @param pkt Packet to transmit
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result transmitPacket(NetworkQueue::Packet *pkt);
+
+    /**
+     * Drop datagrams which did not complete reassembly in time
+     *
+     * Must be called regularly. Arranges a server timeout while
+     * datagrams are being reassembled.
+     */
+    void processTimers();
+
     /**
      * Process incoming network packet.
      *
@@ -225,6 +381,46 @@ class IPV4 : public NetworkProtocol
      */
     Protocol getProtocolByIdentifier(const NetworkProtocol::Identifier id) const;
 
+    /**
+     * Pass a complete datagram to the upper-layer protocol
+     *
+     * @param pkt Packet with the datagram
+     * @param offset Offset of the IP header
+     *
+     * @return Result code
+     */
+    FileSystem::Result deliver(const NetworkQueue::Packet *pkt,
+                               const Size offset);
+
+    /**
+     * Add a received fragment to its datagram
+     *
+     * Delivers the datagram when all its fragments are received.
+     *
+     * @param pkt Packet with the fragment
+     * @param offset Offset of the IP header
+     *
+     * @return Result code
+     */
+    FileSystem::Result reassemble(const NetworkQueue::Packet *pkt,
+                                  const Size offset);
+
+    /**
+     * Find or start the reassembly of a datagram
+     *
+     * @param hdr IP header of a fragment
+     *
+     * @return Reassembly pointer or ZERO if no buffer is available
+     */
+    Reassembly * getReassembly(const Header *hdr);
+
+    /**
+     * Stop the reassembly of a datagram and release its buffer
+     *
+     * @param entry Reassembly to stop
+     */
+    void releaseReassembly(Reassembly *entry);
+
   private:
 
     /** Current IP address */
@@ -239,8 +435,23 @@ class IPV4 : public NetworkProtocol
     /** UDP instance */
     ::UDP *m_udp;
 
+    /** TCP instance */
+    ::TCP *m_tcp;
+
     /** Packet ID for IPV4 */
     u16 m_id;
+
+    /** Buffers for datagrams being reassembled, of which half may be held by sockets */
+    NetworkQueue m_reassemblyQueue;
+
+    /** Datagrams being reassembled */
+    Reassembly m_reassembly[MaximumReassembly];
+
+    /** Number of datagrams being reassembled */
+    Size m_reassemblyCount;
+
+    /** Provides access to the kernel timer */
+    KernelTimer m_kernelTimer;
 };
 
 /**
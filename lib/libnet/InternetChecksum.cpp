@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ByteOrder.h>
+#include "InternetChecksum.h"
+
+const u16 InternetChecksum::sum(const void *buffer,
+                                const Size length,
+                                const u32 initial)
+{
+    const u8 *data = (const u8 *) buffer;
+    u64 total = initial;
+
+    if (length == 0)
+        return fold(total);
+
+    // An odd start shifts all words by one byte. Sum the remainder
+    // on aligned words and swap the result back (RFC 1071, section 2).
+    if ((Address) data & 1)
+    {
+        u16 first = 0;
+        ((u8 *) &first)[0] = data[0];
+
+        total += first;
+        total += SWAP16(fold(accumulate(data + 1, length - 1)));
+    }
+    else
+        total += accumulate(data, length);
+
+    return fold(total);
+}
+
+const u16 InternetChecksum::checksum(const void *buffer,
+                                     const Size length,
+                                     const u32 initial)
+{
+    return ~sum(buffer, length, initial);
+}
+
+const u32 InternetChecksum::pseudoHeader(const u32 source,
+                                         const u32 destination,
+                                         const u8 protocol,
+                                         const u16 length)
+{
+    u32 total = 0;
+
+    total += (source >> 16) + (source & 0xffff);
+    total += (destination >> 16) + (destination & 0xffff);
+    total += (u16) cpu_to_be16(protocol);
+    total += (u16) cpu_to_be16(length);
+
+    return total;
+}
+
+const u16 InternetChecksum::update(const u16 checksum,
+                                   const u16 oldValue,
+                                   const u16 newValue)
+{
+    u32 total = (u16) ~checksum;
+
+    total += (u16) ~oldValue;
+    total += newValue;
+
+    return ~fold(total);
+}
+
+const u16 InternetChecksum::update32(const u16 checksum,
+                                     const u32 oldValue,
+                                     const u32 newValue)
+{
+    const u16 high = update(checksum, oldValue >> 16, newValue >> 16);
+
+    return update(high, oldValue & 0xffff, newValue & 0xffff);
+}
+
+const u64 InternetChecksum::accumulate(const u8 *data,
+                                       Size length)
+{
+    u64 total = 0;
+
+    // Align to 32-bits
+    if (((Address) data & 2) && length >= sizeof(u16))
+    {
+        total += *(const u16 *) data;
+        data   += sizeof(u16);
+        length -= sizeof(u16);
+    }
+
+    // Add 32 bytes per iteration. The wide accumulator
+    // absorbs the carries, which are folded only once at the end.
+    const u32 *words = (const u32 *) data;
+
+    while (length >= 32)
+    {
+        total += words[0];
+        total += words[1];
+        total += words[2];
+        total += words[3];
+        total += words[4];
+        total += words[5];
+        total += words[6];
+        total += words[7];
+        words  += 8;
+        length -= 32;
+    }
+
+    while (length >= sizeof(u32))
+    {
+        total += *words++;
+        length -= sizeof(u32);
+    }
+
+    data = (const u8 *) words;
+
+    if (length >= sizeof(u16))
+    {
+        total += *(const u16 *) data;
+        data   += sizeof(u16);
+        length -= sizeof(u16);
+    }
+
+    // Left-over byte is padded with zero
+    if (length > 0)
+    {
+        u16 last = 0;
+        ((u8 *) &last)[0] = data[0];
+        total += last;
+    }
+
+    return total;
+}
+
+const u16 InternetChecksum::fold(u64 value)
+{
+    while (value >> 16)
+        value = (value & 0xffff) + (value >> 16);
+
+    return value;
+}
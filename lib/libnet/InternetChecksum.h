@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBNET_INTERNETCHECKSUM_H
+#define __LIB_LIBNET_INTERNETCHECKSUM_H
+
+#include <Types.h>
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libnet
+ * @{
+ */
+
+/**
+ * Internet checksum routines (RFC 1071 and RFC 1624).
+ *
+ * The one's complement sum is independent of the byte order, so all
+ * sums are calculated on native words and must be stored as such.
+ * Partial sums can be chained by passing them as the initial value.
+ */
+class InternetChecksum
+{
+  public:
+
+    /**
+     * Calculate the folded one's complement sum of a buffer
+     *
+     * @param buffer Input buffer, which may have any alignment
+     * @param length Number of bytes in the buffer
+     * @param initial Partial sum to add, e.g. of a pseudo header
+     *
+     * @return Folded 16-bit sum, not complemented
+     */
+    static const u16 sum(const void *buffer,
+                         const Size length,
+                         const u32 initial = 0);
+
+    /**
+     * Calculate the Internet checksum of a buffer
+     *
+     * @param buffer Input buffer, which may have any alignment
+     * @param length Number of bytes in the buffer
+     * @param initial Partial sum to add, e.g. of a pseudo header
+     *
+     * @return One's complement of the sum
+     */
+    static const u16 checksum(const void *buffer,
+                              const Size length,
+                              const u32 initial = 0);
+
+    /**
+     * Calculate the partial sum of an IPV4 pseudo header
+     *
+     * @param source Source address as stored in the IP header
+     * @param destination Destination address as stored in the IP header
+     * @param protocol IP protocol number
+     * @param length Length of the transport header plus payload in bytes
+     *
+     * @return Partial sum for use as initial value of checksum()
+     */
+    static const u32 pseudoHeader(const u32 source,
+                                  const u32 destination,
+                                  const u8 protocol,
+                                  const u16 length);
+
+    /**
+     * Update a checksum for a changed 16-bit field
+     *
+     * Uses equation 3 of RFC 1624, which avoids the negative zero
+     * result of the equation in RFC 1141.
+     *
+     * @param checksum Current checksum value as stored
+     * @param oldValue Previous value of the field as stored
+     * @param newValue New value of the field as stored
+     *
+     * @return Updated checksum value
+     */
+    static const u16 update(const u16 checksum,
+                            const u16 oldValue,
+                            const u16 newValue);
+
+    /**
+     * Update a checksum for a changed 32-bit field
+     *
+     * @param checksum Current checksum value as stored
+     * @param oldValue Previous value of the field as stored
+     * @param newValue New value of the field as stored
+     *
+     * @return Updated checksum value
+     *
+     * @see update
+     */
+    static const u16 update32(const u16 checksum,
+                              const u32 oldValue,
+                              const u32 newValue);
+
+  private:
+
+    /**
+     * Add all words of a buffer to a wide accumulator
+     *
+     * @param data Input buffer, which must be 16-bit aligned
+     * @param length Number of bytes in the buffer
+     *
+     * @return Unfolded sum
+     */
+    static const u64 accumulate(const u8 *data,
+                                Size length);
+
+    /**
+     * Fold a wide sum into 16-bits
+     *
+     * @param value Unfolded sum
+     *
+     * @return Folded 16-bit sum
+     */
+    static const u16 fold(u64 value);
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBNET_INTERNETCHECKSUM_H */
@@ -15,6 +15,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <FreeNOS/User.h>
 #include <Log.h>
 #include <String.h>
 #include <FileSystemClient.h>
@@ -97,6 +98,10 @@ NetworkClient::Result NetworkClient::createSocket(const NetworkClient::SocketTyp
             path << "/udp/factory";
             break;
 
+        case TCP:
+            path << "/tcp/factory";
+            break;
+
         default:
             return NotFound;
     }
@@ -128,36 +133,255 @@ NetworkClient::Result NetworkClient::bindSocket(const int sock,
     return writeSocketInfo(sock, addr, port, Listen);
 }
 
-NetworkClient::Result NetworkClient::waitSocket(const NetworkClient::SocketType type,
-                                                const int sock,
-                                                const Size msecTimeout)
+NetworkClient::Result NetworkClient::setQueueSize(const int sock,
+                                                  const Size packets)
 {
     const FileSystemClient fs;
+    SocketInfo info;
+    Size sz = sizeof(info);
 
-    DEBUG("type = " << (int) type << " sock = " << sock);
+    DEBUG("sock = " << sock << " packets = " << packets);
 
-    if (type != NetworkClient::UDP)
+    // The number of packets is passed in the address field
+    info.address = packets;
+    info.port    = 0;
+    info.action  = SetQueueSize;
+
+    const FileSystem::Result result = fs.writeFile(sock, &info, &sz);
+    if (result != FileSystem::Success)
     {
-        ERROR("protocol not supported: " << (int) type);
-        return NetworkClient::NotSupported;
+        ERROR("failed to set queue size of socket " << sock <<
+              ": result = " << (int) result);
+        return IOError;
+    }
+
+    return Success;
+}
+
+NetworkClient::Result NetworkClient::shutdownSocket(const int sock)
+{
+    const FileSystemClient fs;
+    SocketInfo info;
+    Size sz = sizeof(info);
+
+    DEBUG("sock = " << sock);
+
+    info.address = 0;
+    info.port    = 0;
+    info.action  = Shutdown;
+
+    const FileSystem::Result result = fs.writeFile(sock, &info, &sz);
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to shutdown socket " << sock <<
+              ": result = " << (int) result);
+        return IOError;
+    }
+
+    return Success;
+}
+
+NetworkClient::Result NetworkClient::setNoDelay(const int sock,
+                                                const bool noDelay)
+{
+    const FileSystemClient fs;
+    SocketInfo info;
+    Size sz = sizeof(info);
+
+    DEBUG("sock = " << sock << " noDelay = " << noDelay);
+
+    // The setting is passed in the address field
+    info.address = noDelay ? 1 : 0;
+    info.port    = 0;
+    info.action  = SetNoDelay;
+
+    const FileSystem::Result result = fs.writeFile(sock, &info, &sz);
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to set no delay on socket " << sock <<
+              ": result = " << (int) result);
+        return IOError;
     }
 
+    return Success;
+}
+
+NetworkClient::Result NetworkClient::setReusePort(const int sock,
+                                                  const bool reusePort)
+{
+    const FileSystemClient fs;
+    SocketInfo info;
+    Size sz = sizeof(info);
+
+    DEBUG("sock = " << sock << " reusePort = " << reusePort);
+
+    // The setting is passed in the address field
+    info.address = reusePort ? 1 : 0;
+    info.port    = 0;
+    info.action  = SetReusePort;
+
+    const FileSystem::Result result = fs.writeFile(sock, &info, &sz);
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to set reuse port on socket " << sock <<
+              ": result = " << (int) result);
+        return IOError;
+    }
+
+    return Success;
+}
+
+NetworkClient::Result NetworkClient::setCoalesce(const int sock,
+                                                 const bool coalesce)
+{
+    const FileSystemClient fs;
+    SocketInfo info;
+    Size sz = sizeof(info);
+
+    DEBUG("sock = " << sock << " coalesce = " << coalesce);
+
+    // The setting is passed in the address field
+    info.address = coalesce ? 1 : 0;
+    info.port    = 0;
+    info.action  = SetCoalesce;
+
+    const FileSystem::Result result = fs.writeFile(sock, &info, &sz);
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to set coalesce on socket " << sock <<
+              ": result = " << (int) result);
+        return IOError;
+    }
+
+    return Success;
+}
+
+NetworkClient::Result NetworkClient::mapReceiveRing(const int sock,
+                                                    const Size size,
+                                                    SocketRing & ring,
+                                                    const Size slotSize)
+{
+#ifdef __HOST__
+    // HostShares cannot distinguish shares by their tag
+    return NotSupported;
+#else
+    const FileSystemClient fs;
+    const SystemInformation sysInfo;
+    ProcessShares::MemoryShare share;
+    SocketInfo info;
+    Size sz = sizeof(info);
+
+    DEBUG("sock = " << sock << " size = " << size << " slotSize = " << slotSize);
+
     // Get file descriptor of the socket
     FileDescriptor::Entry *fd = FileDescriptor::instance()->getEntry(sock);
     if (!fd || !fd->open)
     {
         ERROR("failed to get FileDescriptor for socket " << sock << ": " << (fd ? "closed" : "not found"));
-        return NetworkClient::NotFound;
+        return NotFound;
     }
 
-    // Prepare a wait set
-    FileSystem::WaitSet waitSet;
-    waitSet.inode     = fd->inode;
+    // Share memory with the network server
+    share.pid    = fd->pid;
+    share.coreId = sysInfo.coreId;
+    share.tagId  = RingShareTag + sock;
+    share.range.size = (size + PAGESIZE - 1) & PAGEMASK;
+    share.range.virt = 0;
+    share.range.phys = 0;
+    share.range.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    const API::Result shareResult = VMShare(fd->pid, API::Create, &share);
+    if (shareResult != API::Success)
+    {
+        ERROR("VMShare failed for PID " << fd->pid << ": result = " << (int) shareResult);
+        return IOError;
+    }
+
+    if (!ring.setBase(share.range.virt, share.range.size, true, slotSize))
+    {
+        ERROR("invalid receive ring: size = " << share.range.size << " slotSize = " << slotSize);
+        VMShare(fd->pid, API::Delete, &share);
+        return IOError;
+    }
+
+    // The share tag is passed in the address field
+    info.address = share.tagId;
+    info.port    = 0;
+    info.action  = SetReceiveRing;
+
+    const FileSystem::Result result = fs.writeFile(sock, &info, &sz);
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to set receive ring of socket " << sock <<
+              ": result = " << (int) result);
+        VMShare(fd->pid, API::Delete, &share);
+        ring.setBase(0, 0, false);
+        return IOError;
+    }
+
+    return Success;
+#endif /* __HOST__ */
+}
+
+NetworkClient::Result NetworkClient::getMTU(Size *mtu) const
+{
+    const FileSystemClient fs;
+    String path = m_deviceName;
+    char buf[64];
+    Size fd, sz = sizeof(buf) - 1;
+
+    path << "/mtu";
+
+    const FileSystem::Result openResult = fs.openFile(*path, fd);
+    if (openResult != FileSystem::Success)
+    {
+        ERROR("failed to open " << *path << ": result = " << (int) openResult);
+        return IOError;
+    }
+
+    const FileSystem::Result readResult = fs.readFile(fd, buf, &sz);
+    fs.closeFile(fd);
+
+    if (readResult != FileSystem::Success)
+    {
+        ERROR("failed to read " << *path << ": result = " << (int) readResult);
+        return IOError;
+    }
+
+    // The file starts with the current MTU in text format
+    buf[sz] = 0;
+    const String text(buf, false);
+    if (!text.startsWith("mtu "))
+    {
+        ERROR("unexpected contents of " << *path);
+        return IOError;
+    }
+
+    *mtu = String(buf + 4, false).toLong();
+    return Success;
+}
+
+NetworkClient::Result NetworkClient::waitSocket(const NetworkClient::SocketType type,
+                                                const int sock,
+                                                const Size msecTimeout)
+{
+    const FileSystemClient fs;
+
+    DEBUG("type = " << (int) type << " sock = " << sock);
+
+    if (type != NetworkClient::UDP && type != NetworkClient::TCP)
+    {
+        ERROR("protocol not supported: " << (int) type);
+        return NetworkClient::NotSupported;
+    }
+
+    // Wait until the socket is readable (has data)
+    FileSystem::WaitDescriptor waitSet;
+    waitSet.fd        = sock;
     waitSet.requested = FileSystem::Readable;
     waitSet.current   = 0;
 
-    // Wait until the file is readable (has data)
-    const FileSystem::Result waitResult = fs.waitFile(*m_deviceName, &waitSet, 1, msecTimeout);
+    const FileSystem::Result waitResult = fs.waitDescriptors(&waitSet, 1, msecTimeout);
     if (waitResult != FileSystem::Success)
     {
         if (waitResult == FileSystem::TimedOut)
@@ -165,10 +389,14 @@ NetworkClient::Result NetworkClient::waitSocket(const NetworkClient::SocketType
             DEBUG("operation timed out");
             return TimedOut;
         }
+        else if (waitResult == FileSystem::NotFound)
+        {
+            ERROR("failed to get FileDescriptor for socket " << sock);
+            return NotFound;
+        }
         else
         {
-            ERROR("failed to wait for socket " << sock << " with inode " <<
-                   waitSet.inode << ": result = " << (int) waitResult);
+            ERROR("failed to wait for socket " << sock << ": result = " << (int) waitResult);
             return IOError;
         }
     }
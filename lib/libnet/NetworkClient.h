@@ -21,6 +21,7 @@
 #include <Types.h>
 #include "IPV4.h"
 #include "Ethernet.h"
+#include "SocketRing.h"
 
 /**
  * @addtogroup lib
@@ -53,9 +54,20 @@ class NetworkClient
         Connect,
         Listen,
         SendSingle,
-        SendMultiple
+        SendMultiple,
+        SetQueueSize,
+        Shutdown,
+        SetNoDelay,
+        SendBatch,
+        ReceiveBatch,
+        SetReceiveRing,
+        SetReusePort,
+        SetCoalesce
     };
 
+    /** First share tag of receive rings, followed by one tag per socket index */
+    static const Size RingShareTag = 16;
+
     /**
      * Socket information
      *
@@ -82,6 +94,40 @@ class NetworkClient
         Size size;
     };
 
+    /**
+     * Describes a single datagram of a batch operation.
+     *
+     * The SendBatch and ReceiveBatch actions are followed by an array
+     * of these structs, which is processed with a single request. Each
+     * datagram has its own buffer and peer. On ReceiveBatch, the size
+     * gives the capacity of the buffer and is updated with the payload
+     * size, together with the address and port of the sender.
+     */
+    struct BatchPacket
+    {
+        Address buffer;
+        Size size;
+        IPV4::Address address;
+        u16 port;
+    };
+
+    /**
+     * Describes a single datagram of a coalesced read.
+     *
+     * When coalescing is enabled on a socket, a read returns as many queued
+     * datagrams as fit in the buffer. Each datagram starts with this record
+     * and is followed by its payload, padded to a multiple of RecordAlignment.
+     */
+    struct DatagramRecord
+    {
+        IPV4::Address address;
+        u16 port;
+        u16 size;
+    };
+
+    /** Alignment of each DatagramRecord in a coalesced read */
+    static const Size RecordAlignment = 4;
+
     /**
      * Socket types
      */
@@ -163,6 +209,101 @@ class NetworkClient
                       const IPV4::Address addr = 0,
                       const u16 port = 0);
 
+    /**
+     * Change the number of packets in the receive queue of a socket.
+     *
+     * The socket must be connected or bound and have no packets queued.
+     *
+     * @param sock Socket index
+     * @param packets Number of packets to queue at most
+     *
+     * @return Result code
+     */
+    Result setQueueSize(const int sock,
+                        const Size packets);
+
+    /**
+     * Close the sending side of a connected socket.
+     *
+     * The peer receives the end of the stream once all
+     * data written so far is acknowledged.
+     *
+     * @param sock Socket index
+     *
+     * @return Result code
+     */
+    Result shutdownSocket(const int sock);
+
+    /**
+     * Enable or disable the delay for small segments of a connected socket.
+     *
+     * @param sock Socket index
+     * @param noDelay True to send small segments immediately
+     *
+     * @return Result code
+     */
+    Result setNoDelay(const int sock,
+                      const bool noDelay);
+
+    /**
+     * Allow other sockets to bind the same UDP port.
+     *
+     * Must be set before binding. Datagrams for a port which is shared by
+     * multiple sockets are distributed by a hash of the source address and port,
+     * such that all datagrams of a single peer arrive at the same socket.
+     *
+     * @param sock Socket index
+     * @param reusePort True to share the port with other sockets
+     *
+     * @return Result code
+     */
+    Result setReusePort(const int sock,
+                        const bool reusePort);
+
+    /**
+     * Return all queued datagrams which fit in the buffer of a read.
+     *
+     * Each datagram is described by a DatagramRecord followed by its payload.
+     * A single datagram which does not fit in the buffer is truncated.
+     * The ReceiveBatch action is not affected, but recvfrom() expects a
+     * single datagram per read and cannot be used on such a socket.
+     *
+     * @param sock Socket index
+     * @param coalesce True to return multiple datagrams per read
+     *
+     * @return Result code
+     */
+    Result setCoalesce(const int sock,
+                       const bool coalesce);
+
+    /**
+     * Receive datagrams of a socket directly in shared memory.
+     *
+     * The network server writes each datagram received on the socket to the
+     * ring, which the client consumes without further requests. Use waitSocket()
+     * to wait for the ring to have data. The socket must be bound.
+     *
+     * @param sock Socket index
+     * @param size Size of the ring in bytes, rounded up to whole pages
+     * @param ring On output, the ring to consume datagrams from
+     * @param slotSize Size of each slot in bytes, which limits the datagram size
+     *
+     * @return Result code
+     */
+    Result mapReceiveRing(const int sock,
+                          const Size size,
+                          SocketRing & ring,
+                          const Size slotSize = SocketRing::SlotSize);
+
+    /**
+     * Get the maximum transmission unit of the network device.
+     *
+     * @param mtu On output, the largest IP packet size in bytes
+     *
+     * @return Result code
+     */
+    Result getMTU(Size *mtu) const;
+
     /**
      * Wait until the given socket has data to receive.
      *
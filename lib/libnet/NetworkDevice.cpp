@@ -15,14 +15,26 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <ByteOrder.h>
 #include "NetworkDevice.h"
+#include "NetworkQueueFile.h"
+#include "NetworkMTUFile.h"
+#include "NetworkStatisticsFile.h"
+#include "NetworkServer.h"
 
 NetworkDevice::NetworkDevice(const u32 inode,
-                             NetworkServer &server)
+                             NetworkServer &server,
+                             const Size receiveSize,
+                             const Size transmitSize,
+                             const Size maximumMTU)
     : Device(inode, FileSystem::CharacterDeviceFile)
-    , m_maximumPacketSize(1500)
-    , m_receive(m_maximumPacketSize)
-    , m_transmit(m_maximumPacketSize)
+    , m_maximumMTU(maximumMTU)
+    , m_mtu(DefaultMTU < maximumMTU ? DefaultMTU : maximumMTU)
+    , m_maximumPacketSize(m_mtu + sizeof(Ethernet::Header))
+    , m_polling(false)
+    , m_capabilities(0)
+    , m_receive(maximumMTU + sizeof(Ethernet::Header), receiveSize)
+    , m_transmit(maximumMTU + sizeof(Ethernet::Header), transmitSize)
     , m_server(server)
 
 {
@@ -33,6 +45,7 @@ NetworkDevice::NetworkDevice(const u32 inode,
     m_ipv4 = new IPV4(m_server, *this, *m_eth);
     m_icmp = new ICMP(m_server, *this, *m_ipv4);
     m_udp = new UDP(m_server, *this, *m_ipv4);
+    m_tcp = new TCP(m_server, *this, *m_ipv4);
 }
 
 NetworkDevice::~NetworkDevice()
@@ -54,6 +67,24 @@ FileSystem::Result NetworkDevice::initialize()
     m_ipv4->initialize();
     m_icmp->initialize();
     m_udp->initialize();
+    m_tcp->initialize();
+
+    // Publish queue statistics
+    m_server.registerFile(new NetworkQueueFile(m_server.getNextInode(), &m_receive, &m_transmit),
+                          "/queues");
+
+    // Publish the MTU setting
+    m_server.registerFile(new NetworkMTUFile(m_server.getNextInode(), this), "/mtu");
+
+    // Publish protocol statistics
+    NetworkStatisticsFile *stats = new NetworkStatisticsFile(m_server.getNextInode());
+    stats->addProtocol("ethernet", m_eth);
+    stats->addProtocol("arp", m_arp);
+    stats->addProtocol("ipv4", m_ipv4);
+    stats->addProtocol("icmp", m_icmp);
+    stats->addProtocol("udp", m_udp);
+    stats->addProtocol("tcp", m_tcp);
+    m_server.registerFile(stats, "/stats");
 
     // Connect objects
     m_eth->setIP(m_ipv4);
@@ -62,6 +93,8 @@ FileSystem::Result NetworkDevice::initialize()
     m_ipv4->setICMP(m_icmp);
     m_ipv4->setARP(m_arp);
     m_ipv4->setUDP(m_udp);
+    m_ipv4->setTCP(m_tcp);
+    m_udp->setIP(m_ipv4);
 
     return FileSystem::Success;
 }
@@ -71,6 +104,37 @@ const Size NetworkDevice::getMaximumPacketSize() const
     return m_maximumPacketSize;
 }
 
+const Size NetworkDevice::getMaximumFrameSize() const
+{
+    return m_maximumMTU + sizeof(Ethernet::Header);
+}
+
+const Size NetworkDevice::getMTU() const
+{
+    return m_mtu;
+}
+
+FileSystem::Result NetworkDevice::setMTU(const Size mtu)
+{
+    DEBUG("mtu = " << mtu);
+
+    if (mtu < MinimumMTU || mtu > m_maximumMTU)
+    {
+        ERROR("invalid MTU " << mtu << ": supported range is " <<
+              MinimumMTU << " to " << m_maximumMTU);
+        return FileSystem::InvalidArgument;
+    }
+
+    m_mtu = mtu;
+    m_maximumPacketSize = mtu + sizeof(Ethernet::Header);
+    return FileSystem::Success;
+}
+
+const u32 NetworkDevice::getCapabilities() const
+{
+    return m_capabilities;
+}
+
 NetworkQueue * NetworkDevice::getReceiveQueue()
 {
     return &m_receive;
@@ -86,18 +150,73 @@ void NetworkDevice::unregisterSockets(const ProcessID pid)
     DEBUG("pid = " << pid);
 
     m_udp->unregisterSockets(pid);
+    m_tcp->unregisterSockets(pid);
     m_icmp->unregisterSockets(pid);
 }
 
-FileSystem::Result NetworkDevice::process(const NetworkQueue::Packet *pkt,
+void NetworkDevice::processTimers()
+{
+    m_arp->processTimers();
+    m_ipv4->processTimers();
+    m_tcp->processTimers();
+}
+
+FileSystem::Result NetworkDevice::process(NetworkQueue::Packet *pkt,
                                           const Size offset)
 {
     DEBUG("");
 
+    // Steer the packet by its flow
+    pkt->hash = flowHash(pkt, offset);
+
     // Let the protocols process the packet
     return m_eth->process(pkt, offset);
 }
 
+u32 NetworkDevice::flowHash(const NetworkQueue::Packet *pkt,
+                            const Size offset)
+{
+    const Ethernet::Header *ether = (const Ethernet::Header *) (pkt->data + offset);
+    const IPV4::Header *ip = (const IPV4::Header *) (ether + 1);
+    const Size ipOffset = offset + sizeof(Ethernet::Header);
+
+    if (pkt->size < ipOffset + sizeof(IPV4::Header) ||
+        readBe16(&ether->type) != Ethernet::IPV4)
+    {
+        return 0;
+    }
+
+    u32 hash = read32(&ip->source) ^ read32(&ip->destination);
+
+    // Both UDP and TCP start with the source and destination ports
+    const Size headerSize = (ip->versionIHL & 0xf) * sizeof(u32);
+    if ((ip->protocol == IPV4::UDP || ip->protocol == IPV4::TCP) &&
+        pkt->size >= ipOffset + headerSize + sizeof(u32))
+    {
+        hash ^= read32(pkt->data + ipOffset + headerSize);
+    }
+
+    // Mix all bits, such that the hash is never zero for IPV4
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3b;
+    hash ^= hash >> 16;
+
+    return hash ? hash : 1;
+}
+
+bool NetworkDevice::isPolling() const
+{
+    return m_polling;
+}
+
+FileSystem::Result NetworkDevice::poll()
+{
+    DEBUG("");
+
+    m_polling = false;
+    return FileSystem::Success;
+}
+
 FileSystem::Result NetworkDevice::startDMA()
 {
     DEBUG("");
@@ -25,6 +25,7 @@
 #include "IPV4.h"
 #include "ICMP.h"
 #include "UDP.h"
+#include "TCP.h"
 #include "NetworkQueue.h"
 
 /**
@@ -40,6 +41,24 @@
  */
 class NetworkDevice : public Device
 {
+  public:
+
+    /**
+     * Offload capabilities of the device
+     */
+    enum Capabilities
+    {
+        TransmitChecksum = (1 << 0), /**@< Inserts checksums of packets flagged with ChecksumOffload */
+        ReceiveChecksum  = (1 << 1), /**@< Flags received packets with valid checksums as ChecksumVerified */
+        LocalDelivery    = (1 << 2)  /**@< Transmitted packets are received by the device itself */
+    };
+
+    /** Maximum transmission unit of standard ethernet */
+    static const Size DefaultMTU = 1500;
+
+    /** Smallest maximum transmission unit allowed for IPV4 */
+    static const Size MinimumMTU = 68;
+
   public:
 
     /**
@@ -47,9 +66,15 @@ class NetworkDevice : public Device
      *
      * @param inode Inode number
      * @param server NetworkServer reference
+     * @param receiveSize Number of packets in the receive queue
+     * @param transmitSize Number of packets in the transmit queue
+     * @param maximumMTU Largest maximum transmission unit the device can receive
      */
     NetworkDevice(const u32 inode,
-                  NetworkServer &server);
+                  NetworkServer &server,
+                  const Size receiveSize = NetworkQueue::DefaultPackets,
+                  const Size transmitSize = NetworkQueue::DefaultPackets,
+                  const Size maximumMTU = DefaultMTU);
 
     /**
      * Destructor
@@ -66,10 +91,42 @@ class NetworkDevice : public Device
     /**
      * Get maximum packet size
      *
+     * This is the largest ethernet frame the protocols may
+     * transmit, which follows from the current MTU.
+     *
      * @return Maximum packet size
      */
     const Size getMaximumPacketSize() const;
 
+    /**
+     * Get the size of the largest frame the device can receive.
+     *
+     * Sockets size their queues with this value, such that
+     * the MTU can be raised while sockets are open.
+     *
+     * @return Maximum frame size in bytes
+     */
+    const Size getMaximumFrameSize() const;
+
+    /**
+     * Get maximum transmission unit
+     *
+     * @return Largest IP packet size in bytes
+     */
+    const Size getMTU() const;
+
+    /**
+     * Change the maximum transmission unit
+     *
+     * Frames up to the largest supported MTU are always received.
+     * The MTU limits the size of transmitted packets only.
+     *
+     * @param mtu Largest IP packet size in bytes
+     *
+     * @return Result code
+     */
+    FileSystem::Result setMTU(const Size mtu);
+
     /**
      * Read ethernet address.
      *
@@ -88,6 +145,13 @@ class NetworkDevice : public Device
      */
     virtual FileSystem::Result setAddress(const Ethernet::Address *address) = 0;
 
+    /**
+     * Get offload capabilities
+     *
+     * @return Capabilities bitmask
+     */
+    const u32 getCapabilities() const;
+
     /**
      * Get receive queue
      */
@@ -105,6 +169,15 @@ class NetworkDevice : public Device
      */
     void unregisterSockets(const ProcessID pid);
 
+    /**
+     * Process expired protocol timers
+     *
+     * Re-transmits address resolution requests for waiting packets,
+     * drops datagrams which did not complete reassembly in time
+     * and handles the retransmission and acknowledgement timers of TCP.
+     */
+    void processTimers();
+
     /**
      * Add a network packet to the transmit queue.
      *
@@ -117,14 +190,48 @@ class NetworkDevice : public Device
     /**
      * Process a received network packet.
      *
+     * Before the protocols process the packet, its flow hash is calculated
+     * in software, such that all packets of a flow are steered alike.
+     *
      * @param packet Network packet received by the device
      * @param offset Network packet payload offset
      *
      * @return Result code
      */
-    virtual FileSystem::Result process(const NetworkQueue::Packet *packet,
+    virtual FileSystem::Result process(NetworkQueue::Packet *packet,
                                        const Size offset = 0);
 
+    /**
+     * Calculate the flow hash of a received packet.
+     *
+     * The hash covers the IPV4 source and destination addresses
+     * and, for UDP and TCP, the source and destination ports.
+     *
+     * @param packet Network packet with an ethernet frame
+     * @param offset Offset of the ethernet header
+     *
+     * @return Flow hash or zero if the packet is not IPV4
+     */
+    static u32 flowHash(const NetworkQueue::Packet *packet,
+                        const Size offset = 0);
+
+    /**
+     * Check if the device is in polling mode.
+     *
+     * In polling mode the device has masked its receive interrupt
+     * and receives frames when poll() is called.
+     *
+     * @return True if poll() must be called
+     */
+    bool isPolling() const;
+
+    /**
+     * Receive a batch of frames while in polling mode.
+     *
+     * @return Success if no more frames are pending or RetryAgain otherwise
+     */
+    virtual FileSystem::Result poll();
+
     /**
      * Start DMA processing
      *
@@ -134,9 +241,21 @@ class NetworkDevice : public Device
 
   protected:
 
-    /** Maximum size of each packet */
+    /** Largest maximum transmission unit supported by the device */
+    const Size m_maximumMTU;
+
+    /** Current maximum transmission unit */
+    Size m_mtu;
+
+    /** Maximum size of each packet, following from the current MTU */
     Size m_maximumPacketSize;
 
+    /** True if received frames are polled instead of signaled by interrupts */
+    bool m_polling;
+
+    /** Offload capabilities */
+    u32 m_capabilities;
+
     NetworkQueue m_receive;
 
     NetworkQueue m_transmit;
@@ -152,6 +271,8 @@ class NetworkDevice : public Device
     ICMP *m_icmp;
 
     UDP *m_udp;
+
+    TCP *m_tcp;
 };
 
 /**
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <String.h>
+#include "IOBuffer.h"
+#include "NetworkDevice.h"
+#include "NetworkMTUFile.h"
+
+NetworkMTUFile::NetworkMTUFile(const u32 inode,
+                               NetworkDevice *device)
+    : File(inode)
+    , m_device(device)
+{
+}
+
+NetworkMTUFile::~NetworkMTUFile()
+{
+}
+
+FileSystem::Result NetworkMTUFile::read(IOBuffer & buffer,
+                                        Size & size,
+                                        const Size offset)
+{
+    String tmp;
+    tmp << "mtu " << (uint) m_device->getMTU();
+    tmp << " maximum " << (uint) (m_device->getMaximumFrameSize() - sizeof(Ethernet::Header)) << "\n";
+
+    // Bounds checking
+    if (offset >= tmp.length())
+    {
+        size = 0;
+        return FileSystem::Success;
+    }
+
+    // How much bytes to copy?
+    const Size bytes = tmp.length() - offset > size ? size : tmp.length() - offset;
+    size = bytes;
+
+    return buffer.write(*tmp + offset, bytes);
+}
+
+FileSystem::Result NetworkMTUFile::write(IOBuffer & buffer,
+                                         Size & size,
+                                         const Size offset)
+{
+    char tmp[16];
+    const Size bytes = size < sizeof(tmp) - 1 ? size : sizeof(tmp) - 1;
+
+    const FileSystem::Result result = buffer.read(tmp, bytes);
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+    tmp[bytes] = 0;
+
+    const String value(tmp, false);
+    return m_device->setMTU(value.toLong());
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include <FreeNOS/System.h>
+#include "NetworkMeter.h"
+
+NetworkMeter::NetworkMeter()
+    : m_startTicks(0)
+    , m_stopTicks(0)
+    , m_startCycles(0)
+    , m_stopCycles(0)
+    , m_rate(0)
+    , m_packets(0)
+    , m_bytes(0)
+    , m_samples(new u64[MaximumSamples])
+    , m_roundTrips(0)
+{
+}
+
+NetworkMeter::~NetworkMeter()
+{
+    delete[] m_samples;
+}
+
+void NetworkMeter::start(const Size rate)
+{
+    Timer::Info info;
+
+    m_rate       = rate;
+    m_packets    = 0;
+    m_bytes      = 0;
+    m_roundTrips = 0;
+
+    m_timer.tick();
+    m_timer.getCurrent(&info);
+    m_startTicks  = info.ticks;
+    m_stopTicks   = info.ticks;
+    m_startCycles = timestamp();
+    m_stopCycles  = m_startCycles;
+}
+
+void NetworkMeter::stop()
+{
+    Timer::Info info;
+
+    m_stopCycles = timestamp();
+    m_timer.tick();
+    m_timer.getCurrent(&info);
+    m_stopTicks = info.ticks;
+}
+
+void NetworkMeter::pace()
+{
+    if (m_rate == 0)
+    {
+        return;
+    }
+
+    // Packet N is due N / rate seconds after the start
+    while (true)
+    {
+        Timer::Info info;
+        m_timer.tick();
+        m_timer.getCurrent(&info);
+
+        const u64 elapsed = info.ticks - m_startTicks;
+        if (elapsed * m_rate >= (u64) m_packets * info.frequency)
+        {
+            break;
+        }
+
+        // Give up the processor until the next packet is due
+        ProcessCtl(SELF, Schedule, 0);
+    }
+}
+
+void NetworkMeter::addPackets(const Size packets, const Size bytes)
+{
+    m_packets += packets;
+    m_bytes   += bytes;
+}
+
+void NetworkMeter::addRoundTrip(const u64 cycles)
+{
+    if (m_roundTrips < MaximumSamples)
+    {
+        m_samples[m_roundTrips] = cycles;
+    }
+    m_roundTrips++;
+}
+
+Size NetworkMeter::getRoundTrips() const
+{
+    return m_roundTrips;
+}
+
+String NetworkMeter::toString()
+{
+    const Size msec = getElapsedMilliseconds();
+    String s;
+
+    s << (uint) m_packets << " packets, " << (uint) m_bytes << " bytes in " <<
+         (uint) (msec / 1000) << "." << (uint) ((msec % 1000) / 100) << "s";
+
+    if (msec != 0)
+    {
+        s << ": " << (uint) (((u64) m_packets * 1000) / msec) << " packets/s, " <<
+             (uint) (((u64) m_bytes * 1000) / msec) << " bytes/s";
+    }
+
+    if (m_packets != 0 && m_stopCycles > m_startCycles)
+    {
+        s << ", " << (uint) ((m_stopCycles - m_startCycles) / m_packets) << " cycles/packet";
+    }
+
+    if (m_roundTrips != 0)
+    {
+        const Size count = m_roundTrips < MaximumSamples ? m_roundTrips : MaximumSamples;
+
+        // Sort samples for the percentiles
+        for (Size i = 1; i < count; i++)
+        {
+            const u64 sample = m_samples[i];
+            Size j = i;
+
+            for (; j > 0 && m_samples[j - 1] > sample; j--)
+            {
+                m_samples[j] = m_samples[j - 1];
+            }
+            m_samples[j] = sample;
+        }
+
+        s << "\r\nrtt min " << (uint) m_samples[0] <<
+             " p50 " << (uint) getPercentile(500) <<
+             " p99 " << (uint) getPercentile(990) <<
+             " p999 " << (uint) getPercentile(999) <<
+             " max " << (uint) m_samples[count - 1] <<
+             " cycles (" << (uint) m_roundTrips << " round trips)";
+    }
+
+    return s;
+}
+
+Size NetworkMeter::getElapsedMilliseconds() const
+{
+    const Size frequency = m_timer.getFrequency();
+
+    if (frequency == 0)
+    {
+        return 0;
+    }
+
+    return ((u64) (m_stopTicks - m_startTicks) * 1000) / frequency;
+}
+
+u64 NetworkMeter::getPercentile(const Size permille) const
+{
+    const Size count = m_roundTrips < MaximumSamples ? m_roundTrips : MaximumSamples;
+
+    return m_samples[((count - 1) * permille) / 1000];
+}
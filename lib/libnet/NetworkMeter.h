@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBNET_NETWORKMETER_H
+#define __LIB_LIBNET_NETWORKMETER_H
+
+#include <Types.h>
+#include <String.h>
+#include <KernelTimer.h>
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libnet
+ * @{
+ */
+
+/**
+ * Measures latency and throughput of network traffic.
+ *
+ * Used by the flood and rate controlled modes of the network utilities.
+ * Round trip times are recorded in timestamp() cycles and summarized
+ * with percentiles. Throughput is measured with the kernel timer.
+ */
+class NetworkMeter
+{
+  public:
+
+    /** Maximum number of round trip samples kept */
+    static const Size MaximumSamples = 4096u;
+
+  public:
+
+    /**
+     * Constructor
+     */
+    NetworkMeter();
+
+    /**
+     * Destructor
+     */
+    ~NetworkMeter();
+
+    /**
+     * Start measuring.
+     *
+     * @param rate Packets per second to pace at, or zero to flood
+     */
+    void start(const Size rate = 0);
+
+    /**
+     * Stop measuring.
+     */
+    void stop();
+
+    /**
+     * Wait until the next packet is due at the configured rate.
+     */
+    void pace();
+
+    /**
+     * Account transferred packets.
+     *
+     * @param packets Number of packets
+     * @param bytes Number of payload bytes
+     */
+    void addPackets(const Size packets, const Size bytes);
+
+    /**
+     * Account a round trip.
+     *
+     * @param cycles Round trip time in timestamp() cycles
+     */
+    void addRoundTrip(const u64 cycles);
+
+    /**
+     * Get the number of round trips accounted.
+     *
+     * @return Number of round trips
+     */
+    Size getRoundTrips() const;
+
+    /**
+     * Summarize the measurements.
+     *
+     * @return Text with the throughput, cycles per packet and round trip percentiles
+     */
+    String toString();
+
+  private:
+
+    /**
+     * Get the elapsed time.
+     *
+     * @return Elapsed time in milliseconds
+     */
+    Size getElapsedMilliseconds() const;
+
+    /**
+     * Get a percentile of the sorted round trip samples.
+     *
+     * @param permille Percentile in thousandths
+     *
+     * @return Round trip in timestamp() cycles
+     */
+    u64 getPercentile(const Size permille) const;
+
+  private:
+
+    /** Kernel timer for the elapsed time */
+    KernelTimer m_timer;
+
+    /** Kernel timer ticks at start */
+    u32 m_startTicks;
+
+    /** Kernel timer ticks at stop */
+    u32 m_stopTicks;
+
+    /** Value of timestamp() at start */
+    u64 m_startCycles;
+
+    /** Value of timestamp() at stop */
+    u64 m_stopCycles;
+
+    /** Packets per second to pace at, or zero */
+    Size m_rate;
+
+    /** Number of packets transferred */
+    Size m_packets;
+
+    /** Number of payload bytes transferred */
+    Size m_bytes;
+
+    /** Round trip samples */
+    u64 *m_samples;
+
+    /** Number of round trips accounted */
+    Size m_roundTrips;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBNET_NETWORKMETER_H */
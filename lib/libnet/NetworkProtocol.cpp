@@ -15,6 +15,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <MemoryBlock.h>
 #include "NetworkDevice.h"
 #include "NetworkProtocol.h"
 #include "NetworkServer.h"
@@ -27,6 +28,7 @@ NetworkProtocol::NetworkProtocol(NetworkServer &server,
     , m_device(device)
     , m_parent(parent)
 {
+    MemoryBlock::set(&m_stats, 0, sizeof(m_stats));
 }
 
 NetworkProtocol::~NetworkProtocol()
@@ -38,6 +40,11 @@ const Size NetworkProtocol::getMaximumPacketSize() const
     return m_device.getMaximumPacketSize();
 }
 
+const Size NetworkProtocol::getMaximumFrameSize() const
+{
+    return m_device.getMaximumFrameSize();
+}
+
 FileSystem::Result NetworkProtocol::getTransmitPacket(NetworkQueue::Packet **pkt,
                                                       const void *address,
                                                       const Size addressSize,
@@ -46,3 +53,39 @@ FileSystem::Result NetworkProtocol::getTransmitPacket(NetworkQueue::Packet **pkt
 {
     return FileSystem::NotSupported;
 }
+
+FileSystem::Result NetworkProtocol::transmitPacket(NetworkQueue::Packet *pkt)
+{
+    return m_device.transmit(pkt);
+}
+
+const NetworkProtocol::Statistics & NetworkProtocol::getStatistics() const
+{
+    return m_stats;
+}
+
+const char * NetworkProtocol::getDropReasonName(const NetworkProtocol::DropReason reason)
+{
+    static const char *names[] = {
+        "queue", "checksum", "socket", "arp", "filtered", "unsupported", "fragments"
+    };
+
+    return reason < DropReasonCount ? names[reason] : "unknown";
+}
+
+void NetworkProtocol::countReceive(const NetworkQueue::Packet *pkt, const Size offset)
+{
+    m_stats.receivePackets++;
+    m_stats.receiveBytes += pkt->size - offset;
+}
+
+void NetworkProtocol::countTransmit(const Size bytes)
+{
+    m_stats.transmitPackets++;
+    m_stats.transmitBytes += bytes;
+}
+
+void NetworkProtocol::countDrop(const NetworkProtocol::DropReason reason, const Size count)
+{
+    m_stats.drops[reason] += count;
+}
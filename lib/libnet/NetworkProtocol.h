@@ -53,6 +53,48 @@ class NetworkProtocol : public Directory
         TCP
     };
 
+  public:
+
+    /**
+     * Reasons for dropping a packet
+     */
+    enum DropReason
+    {
+        QueueFull = 0, /**@< No packet buffer or socket queue space available */
+        BadChecksum,   /**@< Header or payload checksum is invalid */
+        NoSocket,      /**@< No socket is bound to the destination */
+        ARPPending,    /**@< Destination address could not be resolved in time */
+        Filtered,      /**@< Packet is not addressed to this host */
+        Unsupported,   /**@< Packet type or protocol is not supported */
+        Fragmentation, /**@< Fragmented datagram could not be reassembled */
+        DropReasonCount
+    };
+
+    /**
+     * Protocol statistics.
+     */
+    typedef struct Statistics
+    {
+        /** Number of packets received. */
+        u32 receivePackets;
+
+        /** Number of bytes received, including the protocol header. */
+        u32 receiveBytes;
+
+        /** Number of packets transmitted. */
+        u32 transmitPackets;
+
+        /** Number of bytes transmitted, including the protocol header. */
+        u32 transmitBytes;
+
+        /** Number of dropped packets for each DropReason. */
+        u32 drops[DropReasonCount];
+
+        /** Number of timestamp() cycles spent in process(), if measured. */
+        u64 processCycles;
+    }
+    Statistics;
+
   public:
 
     /**
@@ -79,6 +121,13 @@ class NetworkProtocol : public Directory
      */
     virtual const Size getMaximumPacketSize() const;
 
+    /**
+     * Get the size of the largest frame the device can receive.
+     *
+     * @return Frame size in bytes
+     */
+    virtual const Size getMaximumFrameSize() const;
+
     /**
      * Perform initialization.
      *
@@ -103,6 +152,17 @@ class NetworkProtocol : public Directory
                                                  const Identifier protocol,
                                                  const Size payloadSize);
 
+    /**
+     * Transmit a packet obtained from getTransmitPacket
+     *
+     * The default implementation gives the packet to the device.
+     *
+     * @param pkt Packet to transmit
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result transmitPacket(NetworkQueue::Packet *pkt);
+
     /**
      * Process incoming network packet.
      *
@@ -114,6 +174,47 @@ class NetworkProtocol : public Directory
     virtual FileSystem::Result process(const NetworkQueue::Packet *pkt,
                                        const Size offset) = 0;
 
+    /**
+     * Get protocol statistics.
+     *
+     * @return Statistics reference
+     */
+    const Statistics & getStatistics() const;
+
+    /**
+     * Get the name of a drop reason.
+     *
+     * @param reason DropReason to get the name of
+     *
+     * @return Name of the drop reason
+     */
+    static const char * getDropReasonName(const DropReason reason);
+
+  protected:
+
+    /**
+     * Account a received packet.
+     *
+     * @param pkt Received packet
+     * @param offset Offset of the protocol header in the packet
+     */
+    void countReceive(const NetworkQueue::Packet *pkt, const Size offset);
+
+    /**
+     * Account a transmitted packet.
+     *
+     * @param bytes Number of bytes including the protocol header
+     */
+    void countTransmit(const Size bytes);
+
+    /**
+     * Account a dropped packet.
+     *
+     * @param reason Reason for dropping the packet
+     * @param count Number of packets dropped
+     */
+    void countDrop(const DropReason reason, const Size count = 1);
+
   protected:
 
     /** Network server instance */
@@ -124,6 +225,9 @@ class NetworkProtocol : public Directory
 
     /** Parent upper-layer protocol instance */
     NetworkProtocol &m_parent;
+
+    /** Packet statistics */
+    Statistics m_stats;
 };
 
 /**
@@ -18,16 +18,88 @@
 #include <FreeNOS/User.h>
 #include <Log.h>
 #include <String.h>
+#include <MemoryBlock.h>
 #include "NetworkQueue.h"
 
 NetworkQueue::NetworkQueue(const Size packetSize,
                            const Size queueSize)
+    : m_bufferSize(PayloadBufferSize)
+    , m_size(0)
+    , m_packets(ZERO)
+    , m_free(ZERO)
+    , m_freeHead(0)
+    , m_freeCount(0)
+    , m_reserved(0)
+    , m_borrowed(0)
+    , m_data(ZERO)
+    , m_dataHead(0)
+    , m_dataCount(0)
+    , m_exhausted(false)
 {
-    assert(queueSize <= MaxPackets);
+    MemoryBlock::set(&m_stats, 0, sizeof(m_stats));
+    MemoryBlock::set(&m_payloadRange, 0, sizeof(m_payloadRange));
+
+    // Round up the payload buffers to a power of two which holds a packet
+    while (m_bufferSize < packetSize && m_bufferSize < MaximumBufferSize)
+    {
+        m_bufferSize <<= 1;
+    }
+
+    allocate(queueSize);
+}
+
+NetworkQueue::~NetworkQueue()
+{
+    deallocate();
+}
+
+Size NetworkQueue::getSize() const
+{
+    return m_size;
+}
+
+Size NetworkQueue::getBufferSize() const
+{
+    return m_bufferSize;
+}
+
+const NetworkQueue::Statistics & NetworkQueue::getStatistics() const
+{
+    return m_stats;
+}
+
+bool NetworkQueue::resize(const Size queueSize)
+{
+    if (queueSize == 0 || queueSize > MaximumPackets)
+    {
+        ERROR("invalid queue size: " << queueSize);
+        return false;
+    }
+
+    // Packets in use still point to the current payload buffer
+    if (m_freeCount != m_size || m_borrowed != 0)
+    {
+        ERROR("cannot resize queue with " << (m_size - m_freeCount) << " packets in use");
+        return false;
+    }
+
+    if (queueSize == m_size)
+    {
+        return true;
+    }
+
+    deallocate();
+    return allocate(queueSize);
+}
+
+bool NetworkQueue::allocate(const Size queueSize)
+{
+    assert(queueSize > 0);
+    assert(queueSize <= MaximumPackets);
 
     m_payloadRange.virt = ZERO;
     m_payloadRange.phys = ZERO;
-    m_payloadRange.size = PayloadBufferSize * queueSize;
+    m_payloadRange.size = m_bufferSize * queueSize;
     m_payloadRange.access = Memory::User | Memory::Readable | Memory::Writable;
 
     // Ensure size is page aligned
@@ -41,77 +113,225 @@ NetworkQueue::NetworkQueue(const Size packetSize,
     if (result != API::Success)
     {
         ERROR("failed to allocate payload buffer: result = " << (int) result);
+        m_payloadRange.size = 0;
+        return false;
     }
-    else
+
+    // Allocate packet objects and rings
+    m_packets = new Packet[queueSize];
+    m_free = new Packet *[queueSize];
+    m_data = new Packet *[queueSize];
+    assert(m_packets != NULL);
+    assert(m_free != NULL);
+    assert(m_data != NULL);
+
+    for (Size i = 0; i < queueSize; i++)
     {
-        // Allocate packet objects
-        for (Size i = 0; i < queueSize; i++)
-        {
-            Packet *packet = new Packet;
-            packet->size = 0;
-            packet->data = (u8 *) (m_payloadRange.virt + (i * PayloadBufferSize));
-            m_free.insertAt(i, packet);
-        }
+        m_packets[i].size = 0;
+        m_packets[i].flags = 0;
+        m_packets[i].hash = 0;
+        m_packets[i].refs = 0;
+        m_packets[i].queue = this;
+        m_packets[i].data = (u8 *) (m_payloadRange.virt + (i * m_bufferSize));
+        m_free[i] = &m_packets[i];
     }
+
+    m_size = queueSize;
+    m_freeHead = 0;
+    m_freeCount = queueSize;
+    m_reserved = 0;
+    m_borrowed = 0;
+    m_dataHead = 0;
+    m_dataCount = 0;
+    m_exhausted = false;
+    return true;
 }
 
-NetworkQueue::~NetworkQueue()
+void NetworkQueue::deallocate()
 {
-    for (Size i = 0; i < m_free.size(); i++)
+    delete[] m_packets;
+    delete[] m_free;
+    delete[] m_data;
+    m_packets = ZERO;
+    m_free = ZERO;
+    m_data = ZERO;
+    m_size = 0;
+    m_freeCount = 0;
+    m_dataCount = 0;
+
+    if (m_payloadRange.size != 0)
     {
-        Packet *p = m_free.get(i);
-        if (p)
-        {
-            delete p;
-        }
+        VMCtl(SELF, Release, &m_payloadRange);
+        m_payloadRange.size = 0;
     }
-
-    VMCtl(SELF, Release, &m_payloadRange);
 }
 
 NetworkQueue::Packet * NetworkQueue::get()
 {
-    for (Size i = 0; i < m_free.size(); i++)
+    // Reserved packets and packets borrowed in the data ring are not available
+    if (m_freeCount <= m_reserved + m_borrowed)
     {
-        Packet *p = m_free.get(i);
-        if (p)
+        m_stats.drops++;
+
+        // Count each period in which the queue is exhausted once
+        if (!m_exhausted)
         {
-            p->size = 0;
-            m_free.remove(i);
-            return p;
+            m_stats.overruns++;
+            m_exhausted = true;
         }
+        return ZERO;
     }
-    return ZERO;
+
+    Packet *p = m_free[m_freeHead];
+    m_freeHead = (m_freeHead + 1) % m_size;
+    m_freeCount--;
+    p->size = 0;
+    p->flags = 0;
+    p->hash = 0;
+    p->refs = 1;
+
+    updateHighWater();
+
+    return p;
 }
 
 void NetworkQueue::release(NetworkQueue::Packet *packet)
 {
+    // Packets of other queues are only borrowed
+    if (packet->queue != this)
+    {
+        assert(m_borrowed > 0);
+        m_borrowed--;
+        packet->queue->release(packet);
+        return;
+    }
+
+    assert(packet->refs > 0);
+
+    // The first holder to let go no longer needs a replacement
+    if (packet->flags & Reserved)
+    {
+        packet->flags &= ~Reserved;
+        m_reserved--;
+    }
+
+    if (--packet->refs > 0)
+    {
+        return;
+    }
+
+    assert(m_freeCount < m_size);
+
     packet->size = 0;
-    m_free.insert(packet);
+    m_free[(m_freeHead + m_freeCount) % m_size] = packet;
+    m_freeCount++;
+    m_exhausted = false;
+}
+
+bool NetworkQueue::hold(NetworkQueue::Packet *packet)
+{
+    assert(packet->queue == this);
+    assert(packet->refs > 0);
+
+    // Reserve a replacement for the current holder once
+    if (!(packet->flags & Reserved) && packet->refs == 1)
+    {
+        if (m_freeCount <= m_reserved + m_borrowed)
+        {
+            return false;
+        }
+
+        packet->flags |= Reserved;
+        m_reserved++;
+    }
+
+    packet->refs++;
+    return true;
+}
+
+NetworkQueue::Packet * NetworkQueue::recycle(NetworkQueue::Packet *packet)
+{
+    if (!(packet->flags & Reserved))
+    {
+        return packet;
+    }
+
+    // Drop our reference, which also releases the reservation
+    release(packet);
+
+    Packet *p = get();
+    assert(p != ZERO);
+    return p;
 }
 
 void NetworkQueue::push(NetworkQueue::Packet *packet)
 {
-    m_data.insert(packet);
+    // Each packet is either unused or has data, so the ring cannot overflow
+    assert(m_dataCount < m_size);
+
+    m_data[(m_dataHead + m_dataCount) % m_size] = packet;
+    m_dataCount++;
+    m_stats.packets++;
+}
+
+bool NetworkQueue::share(const NetworkQueue::Packet *packet)
+{
+    // Sharing only changes the reference count, never the payload
+    Packet *p = (Packet *) packet;
+
+    // Each borrowed packet takes the place of an unused packet
+    if (m_freeCount <= m_reserved + m_borrowed || !p->queue->hold(p))
+    {
+        return false;
+    }
+
+    m_borrowed++;
+    push(p);
+    updateHighWater();
+    return true;
+}
+
+void NetworkQueue::updateHighWater()
+{
+    const Size used = m_size - m_freeCount + m_borrowed;
+
+    if (used > m_stats.highWater)
+    {
+        m_stats.highWater = used;
+    }
 }
 
 NetworkQueue::Packet * NetworkQueue::pop()
 {
-    for (Size i = 0; i < m_data.size(); i++)
+    if (m_dataCount == 0)
     {
-        Packet *p = m_data.get(i);
-        if (p)
-        {
-            m_data.remove(i);
-            return p;
-        }
+        return ZERO;
     }
-    return ZERO;
+
+    Packet *p = m_data[m_dataHead];
+    m_dataHead = (m_dataHead + 1) % m_size;
+    m_dataCount--;
+    return p;
+}
+
+NetworkQueue::Packet * NetworkQueue::peek() const
+{
+    return m_dataCount > 0 ? m_data[m_dataHead] : ZERO;
+}
+
+Size NetworkQueue::getTailroom(const NetworkQueue::Packet *packet)
+{
+    return packet->queue->m_bufferSize - packet->size;
 }
 
 bool NetworkQueue::hasData() const
 {
-    return m_data.count() > 0;
+    return m_dataCount > 0;
+}
+
+Address NetworkQueue::getPhysicalAddress(const NetworkQueue::Packet *packet) const
+{
+    return m_payloadRange.phys + ((Address) packet->data - m_payloadRange.virt);
 }
 
 Log & operator << (Log &log, const NetworkQueue::Packet & pkt)
@@ -19,7 +19,6 @@
 #define __LIB_LIBNET_NETWORKQUEUE_H
 
 #include <Types.h>
-#include <Index.h>
 #include <Memory.h>
 #include <Log.h>
 
@@ -33,16 +32,48 @@
 
 /**
  * Networking packet queue implementation.
+ *
+ * Packets are kept in two fixed size rings: one with unused packets
+ * and one with packets holding data. Both rings are sized when the queue
+ * is allocated, such that getting, releasing, pushing and popping are O(1).
+ *
+ * Packets are reference counted and remember the queue which owns their
+ * payload. A packet of one queue can be shared into the data ring of another
+ * queue without copying the payload, and returns to its owner when the last
+ * reference is released.
  */
 class NetworkQueue
 {
   public:
 
-    /** Size of payload memory buffer */
+    /** Size of payload memory buffer for standard ethernet frames */
     static const Size PayloadBufferSize = 2048;
 
-    /** Maximum number of packets available */
-    static const Size MaxPackets = 64u;
+    /** Maximum size of a payload memory buffer, which holds a reassembled datagram */
+    static const Size MaximumBufferSize = 65536;
+
+    /** Default number of packets in a queue */
+    static const Size DefaultPackets = 64u;
+
+    /** Maximum number of packets in a queue */
+    static const Size MaximumPackets = 1024u;
+
+    /** Number of extra packets in a receive queue, which sockets may hold without copying */
+    static const Size SharedPackets = 64u;
+
+    /** Maximum number of packets transferred in one batch */
+    static const Size BatchPackets = 64u;
+
+    /**
+     * Packet flags
+     */
+    enum PacketFlags
+    {
+        ChecksumOffload  = (1 << 0), /**@< Device inserts the IP and payload checksums */
+        ChecksumVerified = (1 << 1), /**@< Device verified the IP and payload checksums */
+        ResolvePending   = (1 << 2), /**@< Link-layer destination address is not yet resolved */
+        Reserved         = (1 << 3)  /**@< Internal: an unused packet is reserved to replace this packet */
+    };
 
     /**
      * Represents a network packet
@@ -51,25 +82,84 @@ class NetworkQueue
     {
         Size size;
         u8 *data;
+        u32 flags;
+        u32 hash;   /**@< Flow hash of a received packet, or zero if none */
+        u32 refs;   /**@< Number of references, or zero if unused */
+        NetworkQueue *queue; /**@< Queue which owns the payload */
     }
     Packet;
 
+    /**
+     * Queue statistics.
+     */
+    typedef struct Statistics
+    {
+        /** Number of packets pushed with data. */
+        u32 packets;
+
+        /** Number of requests for a packet while none was unused. */
+        u32 drops;
+
+        /** Number of times the queue ran out of unused packets. */
+        u32 overruns;
+
+        /** Highest number of packets in use at the same time. */
+        u32 highWater;
+    }
+    Statistics;
+
   public:
 
     /**
      * Constructor
      *
+     * The payload buffer of each packet is the packet size rounded up to
+     * a power of two of at least PayloadBufferSize, which matches the
+     * receive buffer sizes that network controllers can be programmed with.
+     *
      * @param packetSize The size of each packet in bytes
      * @param queueSize The size of the queue in number of packets
      */
     NetworkQueue(const Size packetSize,
-                 const Size queueSize = MaxPackets);
+                 const Size queueSize = DefaultPackets);
 
     /**
      * Destructor
      */
     virtual ~NetworkQueue();
 
+    /**
+     * Get the number of packets in the queue.
+     *
+     * @return Queue size in number of packets
+     */
+    Size getSize() const;
+
+    /**
+     * Get the size of the payload buffer of each packet.
+     *
+     * @return Buffer size in bytes
+     */
+    Size getBufferSize() const;
+
+    /**
+     * Get queue statistics.
+     *
+     * @return Statistics reference
+     */
+    const Statistics & getStatistics() const;
+
+    /**
+     * Change the number of packets in the queue.
+     *
+     * Only possible when all packets are unused.
+     *
+     * @param queueSize New size of the queue in number of packets
+     *
+     * @return True on success and false otherwise
+     */
+    bool resize(const Size queueSize);
+
     /**
      * Get unused packet
      */
@@ -77,19 +167,74 @@ class NetworkQueue
 
     /**
      * Put unused packet back.
+     *
+     * Drops one reference to the packet. The packet becomes unused in the queue
+     * which owns it when no references are left.
      */
     void release(Packet *packet);
 
+    /**
+     * Take an additional reference to a packet of this queue.
+     *
+     * The first additional reference reserves an unused packet, which
+     * the current holder receives from recycle() to continue with.
+     *
+     * @param packet Packet of this queue
+     *
+     * @return True on success and false if no unused packet can be reserved
+     */
+    bool hold(Packet *packet);
+
+    /**
+     * Get the packet to continue with after processing.
+     *
+     * Device drivers call this after processing a received packet
+     * to find the buffer to receive the next frame in.
+     *
+     * @param packet Packet of this queue which was processed
+     *
+     * @return The same packet if it is not shared, otherwise the reserved
+     *         unused packet, in which case the reference to the shared packet is dropped
+     */
+    Packet * recycle(Packet *packet);
+
     /**
      * Enqueue packet with data.
      */
     void push(Packet *packet);
 
+    /**
+     * Enqueue a packet of another queue with data, without copying.
+     *
+     * The packet is held until it is released from this queue.
+     *
+     * @param packet Packet of another queue
+     *
+     * @return True on success and false if the packet must be copied instead
+     */
+    bool share(const Packet *packet);
+
     /**
      * Retrieve packet with data.
      */
     Packet * pop();
 
+    /**
+     * Get the next packet with data without removing it.
+     *
+     * @return Packet pointer or ZERO if none
+     */
+    Packet * peek() const;
+
+    /**
+     * Get the number of bytes after the data of a packet.
+     *
+     * @param packet Packet of any queue
+     *
+     * @return Number of bytes which can be appended to the packet
+     */
+    static Size getTailroom(const Packet *packet);
+
     /**
      * Check if data packets are available
      *
@@ -97,13 +242,79 @@ class NetworkQueue
      */
     bool hasData() const;
 
+    /**
+     * Get the physical address of the payload of a packet.
+     *
+     * The payload of all packets is physically contiguous,
+     * which allows devices to use it for DMA directly.
+     *
+     * @param packet Packet of this queue
+     *
+     * @return Physical address of the packet payload
+     */
+    Address getPhysicalAddress(const Packet *packet) const;
+
   private:
 
-    /** Contains unused packets */
-    Index<Packet, MaxPackets> m_free;
+    /**
+     * Allocate packets and payload memory.
+     *
+     * @param queueSize Number of packets to allocate
+     *
+     * @return True on success and false otherwise
+     */
+    bool allocate(const Size queueSize);
+
+    /**
+     * Release packets and payload memory.
+     */
+    void deallocate();
+
+    /**
+     * Update the highest number of packets in use, including borrowed packets.
+     */
+    void updateHighWater();
+
+  private:
+
+    /** Size of the payload buffer of each packet */
+    Size m_bufferSize;
+
+    /** Number of packets in the queue */
+    Size m_size;
+
+    /** Packet objects */
+    Packet *m_packets;
+
+    /** Ring of unused packets */
+    Packet **m_free;
+
+    /** Position of the first unused packet */
+    Size m_freeHead;
+
+    /** Number of unused packets */
+    Size m_freeCount;
+
+    /** Number of unused packets reserved to replace held packets */
+    Size m_reserved;
+
+    /** Number of packets of other queues in the data ring */
+    Size m_borrowed;
+
+    /** Ring of packets with data */
+    Packet **m_data;
+
+    /** Position of the first packet with data */
+    Size m_dataHead;
+
+    /** Number of packets with data */
+    Size m_dataCount;
+
+    /** True if the last request for an unused packet failed */
+    bool m_exhausted;
 
-    /** Contains packets with data */
-    Index<Packet, MaxPackets> m_data;
+    /** Queue statistics */
+    Statistics m_stats;
 
     /** Defines the memory range of mapped payload data */
     Memory::Range m_payloadRange;
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <String.h>
+#include "IOBuffer.h"
+#include "NetworkQueueFile.h"
+
+NetworkQueueFile::NetworkQueueFile(const u32 inode,
+                                   const NetworkQueue *receive,
+                                   const NetworkQueue *transmit)
+    : File(inode)
+    , m_receive(receive)
+    , m_transmit(transmit)
+{
+    m_access = FileSystem::OwnerR | FileSystem::GroupR | FileSystem::OtherR;
+}
+
+NetworkQueueFile::~NetworkQueueFile()
+{
+}
+
+FileSystem::Result NetworkQueueFile::read(IOBuffer & buffer,
+                                          Size & size,
+                                          const Size offset)
+{
+    const NetworkQueue *queues[] = { m_receive, m_transmit };
+    const char *names[] = { "receive", "transmit" };
+    String tmp;
+
+    for (Size i = 0; i < 2; i++)
+    {
+        const NetworkQueue::Statistics & stats = queues[i]->getStatistics();
+
+        tmp << names[i] << " size " << (uint) queues[i]->getSize();
+        tmp << " packets " << (uint) stats.packets;
+        tmp << " drops " << (uint) stats.drops;
+        tmp << " overruns " << (uint) stats.overruns;
+        tmp << " highwater " << (uint) stats.highWater << "\n";
+    }
+
+    // Bounds checking
+    if (offset >= tmp.length())
+    {
+        size = 0;
+        return FileSystem::Success;
+    }
+
+    // How much bytes to copy?
+    const Size bytes = tmp.length() - offset > size ? size : tmp.length() - offset;
+    size = bytes;
+
+    return buffer.write(*tmp + offset, bytes);
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBNET_NETWORKQUEUEFILE_H
+#define __LIB_LIBNET_NETWORKQUEUEFILE_H
+
+#include <Types.h>
+#include "File.h"
+#include "NetworkQueue.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libnet
+ * @{
+ */
+
+/**
+ * Provides the statistics of the receive and transmit queues as a text file.
+ *
+ * Each line gives the queue size, the number of packets pushed, dropped
+ * packets, overruns and the highest number of packets in use.
+ */
+class NetworkQueueFile : public File
+{
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param inode Inode number
+     * @param receive Receive queue to report
+     * @param transmit Transmit queue to report
+     */
+    NetworkQueueFile(const u32 inode,
+                     const NetworkQueue *receive,
+                     const NetworkQueue *transmit);
+
+    /**
+     * Destructor
+     */
+    virtual ~NetworkQueueFile();
+
+    /**
+     * Read bytes from the file.
+     *
+     * @param buffer Input/Output buffer to output bytes to.
+     * @param size Maximum number of bytes to read on input.
+     *             On output, the actual number of bytes read.
+     * @param offset Offset inside the file to start reading.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result read(IOBuffer & buffer,
+                                    Size & size,
+                                    const Size offset);
+
+  private:
+
+    /** Receive queue */
+    const NetworkQueue *m_receive;
+
+    /** Transmit queue */
+    const NetworkQueue *m_transmit;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBNET_NETWORKQUEUEFILE_H */
@@ -44,6 +44,8 @@ void NetworkServer::onProcessTerminated(const ProcessID pid)
 {
     DEBUG("pid = " << pid);
 
+    DeviceServer::onProcessTerminated(pid);
+
     if (m_device != ZERO)
     {
         m_device->unregisterSockets(pid);
@@ -54,6 +56,25 @@ bool NetworkServer::retryRequests()
 {
     assert(m_device != ZERO);
 
+    // Receive the next batch of frames from a polling device
+    if (m_device->isPolling())
+    {
+        const FileSystem::Result pollResult = m_device->poll();
+        if (pollResult != FileSystem::Success && pollResult != FileSystem::RetryAgain)
+        {
+            ERROR("failed to poll device: result = " << (int) pollResult);
+        }
+    }
+
+    // Re-transmit ARP requests and run the TCP timers
+    m_device->processTimers();
+
+    // Released transmit packets may unblock writes on any socket
+    if (m_readyFiles.contains(m_device->getInode()))
+    {
+        notifyAllFiles();
+    }
+
     // Process all pending requests
     while (DeviceServer::retryRequests())
     {
@@ -69,3 +90,8 @@ bool NetworkServer::retryRequests()
     // All requests done
     return false;
 }
+
+bool NetworkServer::isPolling() const
+{
+    return m_device != ZERO && m_device->isPolling();
+}
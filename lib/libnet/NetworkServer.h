@@ -79,6 +79,13 @@ class NetworkServer : public DeviceServer
      */
     virtual bool retryRequests();
 
+    /**
+     * Keep running while the NetworkDevice polls for received frames
+     *
+     * @return True if the device is in polling mode
+     */
+    virtual bool isPolling() const;
+
   private:
 
     /** Network device instance */
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <String.h>
+#include "IOBuffer.h"
+#include "NetworkStatisticsFile.h"
+
+NetworkStatisticsFile::NetworkStatisticsFile(const u32 inode)
+    : File(inode)
+    , m_count(0)
+{
+    m_access = FileSystem::OwnerR | FileSystem::GroupR | FileSystem::OtherR;
+}
+
+NetworkStatisticsFile::~NetworkStatisticsFile()
+{
+}
+
+bool NetworkStatisticsFile::addProtocol(const char *name,
+                                        const NetworkProtocol *protocol)
+{
+    if (m_count >= MaximumProtocols)
+    {
+        return false;
+    }
+
+    m_names[m_count] = name;
+    m_protocols[m_count] = protocol;
+    m_count++;
+    return true;
+}
+
+FileSystem::Result NetworkStatisticsFile::read(IOBuffer & buffer,
+                                               Size & size,
+                                               const Size offset)
+{
+    String tmp;
+
+    for (Size i = 0; i < m_count; i++)
+    {
+        const NetworkProtocol::Statistics & stats = m_protocols[i]->getStatistics();
+
+        tmp << m_names[i];
+        tmp << " rx " << (uint) stats.receivePackets << " " << (uint) stats.receiveBytes;
+        tmp << " tx " << (uint) stats.transmitPackets << " " << (uint) stats.transmitBytes;
+        tmp << " drops";
+
+        for (Size j = 0; j < NetworkProtocol::DropReasonCount; j++)
+        {
+            tmp << " " << NetworkProtocol::getDropReasonName((NetworkProtocol::DropReason) j);
+            tmp << " " << (uint) stats.drops[j];
+        }
+
+        if (stats.processCycles != 0)
+        {
+            tmp << " kcycles " << (uint) (stats.processCycles / 1000);
+        }
+        tmp << "\n";
+    }
+
+    // Bounds checking
+    if (offset >= tmp.length())
+    {
+        size = 0;
+        return FileSystem::Success;
+    }
+
+    // How much bytes to copy?
+    const Size bytes = tmp.length() - offset > size ? size : tmp.length() - offset;
+    size = bytes;
+
+    return buffer.write(*tmp + offset, bytes);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBNET_NETWORKSTATISTICSFILE_H
+#define __LIB_LIBNET_NETWORKSTATISTICSFILE_H
+
+#include <Types.h>
+#include "File.h"
+#include "NetworkProtocol.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libnet
+ * @{
+ */
+
+/**
+ * Provides the packet statistics of the network protocols as a text file.
+ *
+ * Each line gives the received and transmitted packets and bytes
+ * of one protocol, followed by the number of drops for each reason.
+ * The ethernet line also includes the thousands of timestamp() cycles
+ * spent processing received packets.
+ */
+class NetworkStatisticsFile : public File
+{
+  public:
+
+    /** Maximum number of protocols to report */
+    static const Size MaximumProtocols = 8u;
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param inode Inode number
+     */
+    NetworkStatisticsFile(const u32 inode);
+
+    /**
+     * Destructor
+     */
+    virtual ~NetworkStatisticsFile();
+
+    /**
+     * Add a protocol to report.
+     *
+     * @param name Name of the protocol
+     * @param protocol Protocol to report
+     *
+     * @return True on success and false if too many protocols are added
+     */
+    bool addProtocol(const char *name,
+                     const NetworkProtocol *protocol);
+
+    /**
+     * Read bytes from the file.
+     *
+     * @param buffer Input/Output buffer to output bytes to.
+     * @param size Maximum number of bytes to read on input.
+     *             On output, the actual number of bytes read.
+     * @param offset Offset inside the file to start reading.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result read(IOBuffer & buffer,
+                                    Size & size,
+                                    const Size offset);
+
+  private:
+
+    /** Protocol names */
+    const char *m_names[MaximumProtocols];
+
+    /** Protocols to report */
+    const NetworkProtocol *m_protocols[MaximumProtocols];
+
+    /** Number of protocols to report */
+    Size m_count;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBNET_NETWORKSTATISTICSFILE_H */
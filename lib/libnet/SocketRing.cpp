@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SocketRing.h"
+
+SocketRing::SocketRing()
+    : m_slots(0)
+    , m_slotSize(SlotSize)
+{
+}
+
+bool SocketRing::setBase(const Address base,
+                         const Size size,
+                         const bool reset,
+                         const Size slotSize)
+{
+    m_slots = 0;
+
+    if (base == 0 || size < SlotSize)
+    {
+        return false;
+    }
+
+    m_io.setBase(base);
+
+    // The client may have written any slot size: only accept aligned sizes in range
+    const Size slotBytes = reset ? slotSize : m_io.read(SlotSizeIndex);
+    if (slotBytes < SlotSize || slotBytes > MaximumSlotSize || slotBytes % sizeof(u32))
+    {
+        return false;
+    }
+
+    const Size slots = size / slotBytes;
+    if (slots < MinimumSlots + 1)
+    {
+        return false;
+    }
+
+    m_slots = slots - 1;
+    m_slotSize = slotBytes;
+
+    if (reset)
+    {
+        m_io.write(ProducerIndex, 0);
+        m_io.write(ConsumerIndex, 0);
+        m_io.write(DropCounter, 0);
+        m_io.write(SlotSizeIndex, slotBytes);
+    }
+
+    return true;
+}
+
+bool SocketRing::isValid() const
+{
+    return m_slots != 0;
+}
+
+Size SocketRing::getSlots() const
+{
+    return m_slots;
+}
+
+Size SocketRing::getPayloadSize() const
+{
+    return m_slotSize - sizeof(Slot);
+}
+
+u32 SocketRing::getDrops() const
+{
+    return m_slots ? m_io.read(DropCounter) : 0;
+}
+
+bool SocketRing::hasData() const
+{
+    return m_slots && m_io.read(ProducerIndex) != m_io.read(ConsumerIndex);
+}
+
+SocketRing::Slot * SocketRing::reserve()
+{
+    if (!m_slots)
+        return ZERO;
+
+    const u32 producer = m_io.read(ProducerIndex);
+    const u32 consumer = m_io.read(ConsumerIndex);
+
+    // The consumer may have written any index: treat it as full if inconsistent
+    if (producer - consumer >= m_slots)
+    {
+        m_io.write(DropCounter, m_io.read(DropCounter) + 1);
+        return ZERO;
+    }
+
+    return getSlot(producer);
+}
+
+void SocketRing::push()
+{
+    // The barrier of the write orders the slot contents before the index
+    m_io.write(ProducerIndex, m_io.read(ProducerIndex) + 1);
+}
+
+const SocketRing::Slot * SocketRing::front() const
+{
+    if (!hasData())
+        return ZERO;
+
+    return getSlot(m_io.read(ConsumerIndex));
+}
+
+void SocketRing::pop()
+{
+    m_io.write(ConsumerIndex, m_io.read(ConsumerIndex) + 1);
+}
+
+SocketRing::Slot * SocketRing::getSlot(const u32 index) const
+{
+    return (Slot *) (m_io.getBase() + ((1 + (index % m_slots)) * m_slotSize));
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBNET_SOCKETRING_H
+#define __LIB_LIBNET_SOCKETRING_H
+
+#include <FreeNOS/System.h>
+#include <Types.h>
+#include "IPV4.h"
+#include "NetworkQueue.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libnet
+ * @{
+ */
+
+/**
+ * Ring of received datagrams in memory shared between a socket and its client.
+ *
+ * The ring consists of fixed size slots. The first slot holds the producer
+ * index, consumer index, drop counter and the size of each slot. Each following
+ * slot starts with a Slot header describing the sender and size of the payload
+ * behind it. The network server is the only producer and the client the only consumer.
+ *
+ * Both indices count freely and are used modulo the number of slots. The
+ * client chooses the slot size, for example to hold jumbo frames. The number
+ * of slots is derived from the slot size and the size of the shared memory,
+ * such that neither side depends on the other for the layout of the ring.
+ */
+class SocketRing
+{
+  public:
+
+    /** Default size of each slot in bytes */
+    static const Size SlotSize = NetworkQueue::PayloadBufferSize;
+
+    /** Maximum size of each slot in bytes */
+    static const Size MaximumSlotSize = NetworkQueue::MaximumBufferSize;
+
+    /** Minimum number of datagram slots */
+    static const Size MinimumSlots = 2u;
+
+    /**
+     * Describes the datagram in a slot.
+     */
+    typedef struct Slot
+    {
+        IPV4::Address address;
+        u16 port;
+        u16 size;
+    }
+    Slot;
+
+  public:
+
+    /**
+     * Constructor
+     */
+    SocketRing();
+
+    /**
+     * Assign the memory of the ring.
+     *
+     * @param base Virtual address of the shared memory
+     * @param size Size of the shared memory in bytes
+     * @param reset True to clear the indices and drop counter and store the slot size
+     * @param slotSize Size of each slot in bytes if reset is true,
+     *                 otherwise the slot size is read from the ring
+     *
+     * @return True if the memory holds at least MinimumSlots of a valid size and false otherwise
+     */
+    bool setBase(const Address base,
+                 const Size size,
+                 const bool reset,
+                 const Size slotSize = SlotSize);
+
+    /**
+     * Check if the ring has memory assigned.
+     *
+     * @return Boolean
+     */
+    bool isValid() const;
+
+    /**
+     * Get the number of datagram slots.
+     *
+     * @return Number of slots
+     */
+    Size getSlots() const;
+
+    /**
+     * Get the maximum payload size of a slot.
+     *
+     * @return Size in bytes
+     */
+    Size getPayloadSize() const;
+
+    /**
+     * Get the number of datagrams dropped because the ring was full.
+     *
+     * @return Number of dropped datagrams
+     */
+    u32 getDrops() const;
+
+    /**
+     * Check if the ring has datagrams for the consumer.
+     *
+     * @return Boolean
+     */
+    bool hasData() const;
+
+    /**
+     * Get the next unused slot for the producer.
+     *
+     * Counts a dropped datagram if the ring is full.
+     *
+     * @return Slot pointer or ZERO if the ring is full
+     */
+    Slot * reserve();
+
+    /**
+     * Publish the slot returned by reserve() to the consumer.
+     */
+    void push();
+
+    /**
+     * Get the oldest datagram for the consumer.
+     *
+     * @return Slot pointer or ZERO if the ring is empty
+     */
+    const Slot * front() const;
+
+    /**
+     * Return the slot returned by front() to the producer.
+     */
+    void pop();
+
+  private:
+
+    /**
+     * Offsets of the ring indices in the first slot
+     */
+    enum IndexOffsets
+    {
+        ProducerIndex = 0,
+        ConsumerIndex = 4,
+        DropCounter   = 8,
+        SlotSizeIndex = 12
+    };
+
+    /**
+     * Get a slot by its index.
+     *
+     * @param index Producer or consumer index
+     *
+     * @return Slot pointer
+     */
+    Slot * getSlot(const u32 index) const;
+
+  private:
+
+    /** Provides access to the indices with the required memory barriers */
+    Arch::IO m_io;
+
+    /** Number of datagram slots */
+    Size m_slots;
+
+    /** Size of each slot in bytes */
+    Size m_slotSize;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBNET_SOCKETRING_H */
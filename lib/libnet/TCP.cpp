@@ -0,0 +1,350 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ByteOrder.h>
+#include <Randomizer.h>
+#include "NetworkServer.h"
+#include "NetworkDevice.h"
+#include "Ethernet.h"
+#include "InternetChecksum.h"
+#include "TCP.h"
+#include "TCPSocket.h"
+#include "TCPFactory.h"
+
+TCP::TCP(NetworkServer &server,
+         NetworkDevice &device,
+         NetworkProtocol &parent)
+    : NetworkProtocol(server, device, parent)
+    , m_factory(ZERO)
+{
+}
+
+TCP::~TCP()
+{
+}
+
+FileSystem::Result TCP::initialize()
+{
+    DEBUG("");
+
+    m_factory = new TCPFactory(m_server.getNextInode(), this);
+    m_server.registerDirectory(this, "/tcp");
+    m_server.registerFile(m_factory, "/tcp/factory");
+
+    return FileSystem::Success;
+}
+
+TCPSocket * TCP::createSocket(String & path,
+                              const ProcessID pid)
+{
+    Size pos = 0;
+
+    DEBUG("");
+
+    TCPSocket *sock = new TCPSocket(m_server.getNextInode(), this, pid);
+    if (!sock)
+    {
+        ERROR("failed to allocate TCP socket");
+        return ZERO;
+    }
+
+    if (!m_sockets.insert(pos, sock))
+    {
+        ERROR("failed to insert TCP socket");
+        delete sock;
+        return ZERO;
+    }
+    String filepath;
+    filepath << "/tcp/" << pos;
+
+    path << m_server.getMountPath() << filepath;
+    const FileSystem::Result result = m_server.registerFile(sock, *filepath);
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to register TCP socket: result = " << (int) result);
+        m_sockets.remove(pos);
+        delete sock;
+        return ZERO;
+    }
+
+    return sock;
+}
+
+void TCP::unregisterSockets(const ProcessID pid)
+{
+    DEBUG("pid = " << pid);
+
+    for (Size i = 0; i < MaxTcpSockets; i++)
+    {
+        TCPSocket *sock = m_sockets[i];
+        if (sock != ZERO && sock->getProcessID() == pid)
+        {
+            // Resets the connection and releases the port
+            sock->abort();
+
+            m_sockets.remove(i);
+            String path;
+            path << "/tcp/" << i;
+            const FileSystem::Result result = m_server.unregisterFile(*path);
+            if (result != FileSystem::Success)
+            {
+                ERROR("failed to unregister TCPSocket at " << *path <<
+                      " for PID " << pid << ": result = " << (int) result);
+            }
+        }
+    }
+}
+
+FileSystem::Result TCP::process(const NetworkQueue::Packet *pkt,
+                                const Size offset)
+{
+    const IPV4::Header *ip = (const IPV4::Header *)(pkt->data + sizeof(Ethernet::Header));
+    const Header *hdr = (const Header *)(pkt->data + sizeof(Ethernet::Header) + sizeof(IPV4::Header));
+    const Size available = pkt->size - sizeof(Ethernet::Header) - sizeof(IPV4::Header);
+    const Size total = be16_to_cpu(ip->length) - sizeof(IPV4::Header);
+    const Size headerSize = (hdr->dataOffset >> 4) * sizeof(u32);
+    const u16 port = be16_to_cpu(hdr->destPort);
+
+    DEBUG("port = " << port);
+
+    countReceive(pkt, offset);
+
+    // Verify the segment lengths
+    if (available < sizeof(Header) || total > available ||
+        headerSize < sizeof(Header) || headerSize > total)
+    {
+        DEBUG("dropped packet with invalid length");
+        countDrop(Unsupported);
+        return FileSystem::InvalidArgument;
+    }
+
+    // Verify the checksum, unless the device did already
+    if (!(pkt->flags & NetworkQueue::ChecksumVerified) && checksum(ip, hdr, total) != 0)
+    {
+        DEBUG("dropped packet with invalid checksum");
+        countDrop(BadChecksum);
+        return FileSystem::InvalidArgument;
+    }
+
+    m_timer.tick();
+
+    // Deliver the segment to the socket of its connection
+    TCPSocket * const *sock = m_ports.get(port);
+    if (sock && (*sock)->accepts(readBe32(&ip->source), be16_to_cpu(hdr->sourcePort)))
+    {
+        return (*sock)->process(pkt);
+    }
+
+    // Reset the sender, unless the segment is a reset itself
+    DEBUG("no connection for port = " << port);
+    countDrop(NoSocket);
+
+    if (!(hdr->flags & Reset))
+    {
+        sendReset(ip, hdr, total - headerSize);
+    }
+
+    return FileSystem::NotFound;
+}
+
+void TCP::processTimers()
+{
+    bool running = false;
+
+    for (Size i = 0; i < MaxTcpSockets; i++)
+    {
+        TCPSocket *sock = m_sockets[i];
+        if (sock != ZERO && sock->hasTimers())
+        {
+            if (!running)
+            {
+                m_timer.tick();
+                running = true;
+            }
+            sock->processTimers();
+        }
+    }
+
+    // Keep checking while any socket has a running timer
+    for (Size i = 0; i < MaxTcpSockets; i++)
+    {
+        TCPSocket *sock = m_sockets[i];
+        if (sock != ZERO && sock->hasTimers())
+        {
+            m_server.setTimeout(TimerInterval);
+            break;
+        }
+    }
+}
+
+FileSystem::Result TCP::bind(TCPSocket *sock,
+                             u16 & port)
+{
+    DEBUG("port = " << port);
+
+    // Pick a free port from the dynamic range (RFC 6335)
+    if (!port)
+    {
+        Randomizer random;
+        const u16 start = 49152 + (random.next() % 16384);
+
+        for (Size i = 0; i < 16384; i++)
+        {
+            const u16 candidate = 49152 + ((start - 49152 + i) % 16384);
+
+            if (!m_ports.get(candidate))
+            {
+                port = candidate;
+                break;
+            }
+        }
+
+        if (!port)
+        {
+            return FileSystem::IOError;
+        }
+    }
+    else
+    {
+        TCPSocket * const *other = m_ports.get(port);
+
+        if (other && *other != sock)
+        {
+            return FileSystem::AlreadyExists;
+        }
+    }
+
+    m_ports.insert(port, sock);
+    return FileSystem::Success;
+}
+
+void TCP::unbind(const TCPSocket *sock,
+                 const u16 port)
+{
+    DEBUG("port = " << port);
+
+    TCPSocket * const *bound = m_ports.get(port);
+    if (bound && *bound == sock)
+    {
+        m_ports.remove(port);
+    }
+}
+
+FileSystem::Result TCP::sendSegment(const IPV4::Address address,
+                                    const Header *header,
+                                    const Size headerSize,
+                                    const u8 *data,
+                                    const Size dataSize,
+                                    const u8 *wrapData,
+                                    const Size wrapSize)
+{
+    NetworkQueue::Packet *pkt;
+    const Size length = headerSize + dataSize + wrapSize;
+
+    DEBUG("address = " << *IPV4::toString(address) << " length = " << length);
+
+    // Get a fresh packet
+    const FileSystem::Result result = m_parent.getTransmitPacket(&pkt, &address, sizeof(address),
+                                                                 NetworkProtocol::TCP, length);
+    if (result != FileSystem::Success)
+    {
+        if (result != FileSystem::RetryAgain)
+        {
+            ERROR("failed to get transmit packet: result = " << (int) result);
+        }
+        return result;
+    }
+
+    // Fill the header and payload
+    u8 *segment = pkt->data + pkt->size;
+    Header *hdr = (Header *) segment;
+
+    MemoryBlock::copy(segment, header, headerSize);
+    MemoryBlock::copy(segment + headerSize, data, dataSize);
+    MemoryBlock::copy(segment + headerSize + dataSize, wrapData, wrapSize);
+    write16(&hdr->checksum, 0);
+
+    // Calculate final checksum, unless the device inserts it
+    if (!(pkt->flags & NetworkQueue::ChecksumOffload))
+    {
+        write16(&hdr->checksum, checksum((IPV4::Header *)(pkt->data + pkt->size - sizeof(IPV4::Header)),
+                                          hdr, length));
+    }
+
+    // Increment packet size
+    pkt->size += length;
+    countTransmit(length);
+
+    // Transmit now
+    return m_parent.transmitPacket(pkt);
+}
+
+FileSystem::Result TCP::sendReset(const IPV4::Header *ip,
+                                  const Header *header,
+                                  const Size length)
+{
+    Header reset;
+
+    DEBUG("");
+
+    writeBe16(&reset.sourcePort, be16_to_cpu(header->destPort));
+    writeBe16(&reset.destPort, be16_to_cpu(header->sourcePort));
+    reset.dataOffset = (sizeof(Header) / sizeof(u32)) << 4;
+    reset.window = 0;
+    reset.urgent = 0;
+
+    // Choose the sequence numbers such that the peer accepts the reset (RFC 793, page 36)
+    if (header->flags & Acknowledge)
+    {
+        reset.sequence = header->acknowledge;
+        reset.acknowledge = 0;
+        reset.flags = Reset;
+    }
+    else
+    {
+        const Size segmentLength = length + ((header->flags & Synchronize) ? 1 : 0) +
+                                            ((header->flags & Finish) ? 1 : 0);
+        reset.sequence = 0;
+        writeBe32(&reset.acknowledge, be32_to_cpu(header->sequence) + segmentLength);
+        reset.flags = Reset | Acknowledge;
+    }
+
+    return sendSegment(readBe32(&ip->source), &reset, sizeof(reset));
+}
+
+const Size TCP::getMaximumSegmentSize() const
+{
+    return getMaximumPacketSize() - sizeof(Ethernet::Header) -
+           sizeof(IPV4::Header) - sizeof(Header);
+}
+
+Timer & TCP::getTimer()
+{
+    return m_timer;
+}
+
+const u16 TCP::checksum(const IPV4::Header *ip,
+                        const Header *header,
+                        const Size length)
+{
+    const u32 pseudo = InternetChecksum::pseudoHeader(read32(&ip->source),
+                                                      read32(&ip->destination),
+                                                      IPV4::TCP,
+                                                      length);
+
+    return InternetChecksum::checksum(header, length, pseudo);
+}
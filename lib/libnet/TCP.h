@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBNET_TCP_H
+#define __LIB_LIBNET_TCP_H
+
+#include <Types.h>
+#include <Index.h>
+#include <String.h>
+#include <HashTable.h>
+#include <KernelTimer.h>
+#include "NetworkProtocol.h"
+#include "IPV4.h"
+
+class TCPFactory;
+class TCPSocket;
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libnet
+ * @{
+ */
+
+/**
+ * Transmission Control Protocol (TCP)
+ *
+ * Each TCPSocket is bound to a unique local port and carries a single
+ * connection. Listening sockets become the connection of the first
+ * peer which connects to them.
+ */
+class TCP : public NetworkProtocol
+{
+  private:
+
+    static const Size MaxTcpSockets = 32u;
+
+    /** Milliseconds between timer checks while timers are running */
+    static const Size TimerInterval = 20;
+
+  public:
+
+    /**
+     * Segment header flags
+     */
+    enum Flags
+    {
+        Finish      = (1 << 0),
+        Synchronize = (1 << 1),
+        Reset       = (1 << 2),
+        Push        = (1 << 3),
+        Acknowledge = (1 << 4),
+        Urgent      = (1 << 5)
+    };
+
+    /**
+     * Segment header option kinds
+     */
+    enum Option
+    {
+        OptionEnd         = 0,
+        OptionNop         = 1,
+        OptionSegmentSize = 2,
+        OptionWindowScale = 3
+    };
+
+    /**
+     * Packet header format
+     */
+    typedef struct Header
+    {
+        u16 sourcePort;
+        u16 destPort;
+        u32 sequence;
+        u32 acknowledge;
+        u8  dataOffset;
+        u8  flags;
+        u16 window;
+        u16 checksum;
+        u16 urgent;
+    }
+    Header;
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param server Reference to the NetworkServer instance
+     * @param device Reference to the NetworkDevice instance
+     * @param parent Parent upper-layer protocol
+     */
+    TCP(NetworkServer &server,
+        NetworkDevice &device,
+        NetworkProtocol &parent);
+
+    /**
+     * Destructor
+     */
+    virtual ~TCP();
+
+    /**
+     * Perform initialization.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result initialize();
+
+    /**
+     * Creates a TCP socket
+     *
+     * @param path On output contains the path of the socket
+     * @param pid ProcessID which owns the socket
+     *
+     * @return TCPSocket object instance
+     */
+    TCPSocket * createSocket(String & path,
+                             const ProcessID pid);
+
+    /**
+     * Remove sockets for a process
+     *
+     * Open connections of the process are reset.
+     *
+     * @param pid ProcessID to remove sockets for
+     */
+    void unregisterSockets(const ProcessID pid);
+
+    /**
+     * Process incoming network packet.
+     *
+     * @param pkt Incoming packet pointer
+     * @param offset Offset for processing
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result process(const NetworkQueue::Packet *pkt,
+                                       const Size offset);
+
+    /**
+     * Process expired timers of all sockets
+     *
+     * Must be called regularly. Arranges a server timeout while
+     * any socket has a running timer.
+     */
+    void processTimers();
+
+    /**
+     * Bind to TCP port
+     *
+     * @param sock TCP socket
+     * @param port The port to bind to, or ZERO to pick a free ephemeral port
+     *
+     * @return Result code
+     */
+    FileSystem::Result bind(TCPSocket *sock,
+                            u16 & port);
+
+    /**
+     * Release a TCP port
+     *
+     * @param sock TCP socket which is bound to the port
+     * @param port The port to release
+     */
+    void unbind(const TCPSocket *sock,
+                const u16 port);
+
+    /**
+     * Send a segment
+     *
+     * The payload is given in two parts, to allow sending directly
+     * from a ring buffer. The checksum is calculated here.
+     *
+     * @param address Destination IP address
+     * @param header Segment header including options
+     * @param headerSize Number of bytes in the header including options
+     * @param data First part of the payload
+     * @param dataSize Number of bytes in the first part
+     * @param wrapData Second part of the payload
+     * @param wrapSize Number of bytes in the second part
+     *
+     * @return Result code
+     */
+    FileSystem::Result sendSegment(const IPV4::Address address,
+                                   const Header *header,
+                                   const Size headerSize,
+                                   const u8 *data = ZERO,
+                                   const Size dataSize = 0,
+                                   const u8 *wrapData = ZERO,
+                                   const Size wrapSize = 0);
+
+    /**
+     * Get the maximum payload size of a segment
+     *
+     * @return Number of bytes
+     */
+    const Size getMaximumSegmentSize() const;
+
+    /**
+     * Get the timer used for all sockets
+     *
+     * @return Timer reference, which is updated before calling into sockets
+     */
+    Timer & getTimer();
+
+    /**
+     * Calculate TCP checksum
+     *
+     * @param ip Pointer to the IPV4 header to use
+     * @param header TCP header
+     * @param length Total number of bytes of the header and payload
+     *
+     * @return TCP checksum value for the given segment
+     */
+    static const u16 checksum(const IPV4::Header *ip,
+                              const Header *header,
+                              const Size length);
+
+    /**
+     * Reply with a reset to a segment which has no connection
+     *
+     * @param ip IP header of the segment
+     * @param header TCP header of the segment
+     * @param length Number of payload bytes in the segment
+     *
+     * @return Result code
+     */
+    FileSystem::Result sendReset(const IPV4::Header *ip,
+                                 const Header *header,
+                                 const Size length);
+
+  private:
+
+    /** Factory for creating new TCP sockets */
+    TCPFactory *m_factory;
+
+    /** Contains all TCP sockets */
+    Index<TCPSocket, MaxTcpSockets> m_sockets;
+
+    /** Maps local port numbers to sockets */
+    HashTable<u16, TCPSocket *> m_ports;
+
+    /** Provides access to the kernel timer */
+    KernelTimer m_timer;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBNET_TCP_H */
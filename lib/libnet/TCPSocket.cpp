@@ -0,0 +1,1319 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/System.h>
+#include <ByteOrder.h>
+#include <MemoryBlock.h>
+#include <Randomizer.h>
+#include "Ethernet.h"
+#include "TCP.h"
+#include "TCPSocket.h"
+
+/**
+ * Compare sequence numbers, taking wrap-around into account
+ */
+static inline bool sequenceBefore(const u32 a, const u32 b)
+{
+    return (s32) (a - b) < 0;
+}
+
+TCPSocket::TCPSocket(const u32 inode,
+                     TCP *tcp,
+                     const ProcessID pid)
+    : NetworkSocket(inode, tcp->getMaximumFrameSize(), pid)
+    , m_tcp(tcp)
+    , m_state(Closed)
+    , m_error(false)
+    , m_remoteAddress(0)
+    , m_remotePort(0)
+    , m_sendUnacked(0)
+    , m_sendNext(0)
+    , m_sendMaximum(0)
+    , m_sendWindow(0)
+    , m_sendWindowSeq(0)
+    , m_sendWindowAck(0)
+    , m_initialSend(0)
+    , m_receiveNext(0)
+    , m_sendScale(0)
+    , m_receiveScale(0)
+    , m_peerScaling(false)
+    , m_segmentSize(DefaultSegmentSize)
+    , m_sendBuffer(ZERO)
+    , m_sendHead(0)
+    , m_sendCount(0)
+    , m_receiveBuffer(ZERO)
+    , m_receiveHead(0)
+    , m_receiveCount(0)
+    , m_advertisedWindow(0)
+    , m_congestionWindow(0)
+    , m_slowStartThreshold(SendBufferSize)
+    , m_duplicateAcks(0)
+    , m_recovering(false)
+    , m_recover(0)
+    , m_smoothedRoundTrip(0)
+    , m_roundTripVariance(0)
+    , m_retransmitTimeout(InitialTimeout)
+    , m_retries(0)
+    , m_timing(false)
+    , m_timedSequence(0)
+    , m_timedStart(0)
+    , m_unackedSegments(0)
+    , m_noDelay(false)
+    , m_finishPending(false)
+    , m_finishSent(false)
+    , m_peerFinished(false)
+    , m_outputBlocked(false)
+    , m_sending(false)
+{
+    MemoryBlock::set(&m_retransmitTimer, 0, sizeof(m_retransmitTimer));
+    MemoryBlock::set(&m_ackTimer, 0, sizeof(m_ackTimer));
+    MemoryBlock::set(&m_closeTimer, 0, sizeof(m_closeTimer));
+}
+
+TCPSocket::~TCPSocket()
+{
+    delete[] m_sendBuffer;
+    delete[] m_receiveBuffer;
+}
+
+const u16 TCPSocket::getPort() const
+{
+    return m_info.port;
+}
+
+const TCPSocket::State TCPSocket::getState() const
+{
+    return m_state;
+}
+
+bool TCPSocket::accepts(const IPV4::Address address,
+                        const u16 port) const
+{
+    switch (m_state)
+    {
+        case Closed:
+            return false;
+
+        case Listen:
+            return true;
+
+        default:
+            return address == m_remoteAddress && port == m_remotePort;
+    }
+}
+
+FileSystem::Result TCPSocket::read(IOBuffer & buffer,
+                                   Size & size,
+                                   const Size offset)
+{
+    DEBUG("size = " << size << " available = " << m_receiveCount);
+
+    if (m_receiveCount == 0)
+    {
+        if (m_error)
+        {
+            return FileSystem::IOError;
+        }
+        else if (m_peerFinished || m_state == Closed)
+        {
+            size = 0;
+            return FileSystem::Success;
+        }
+        return FileSystem::RetryAgain;
+    }
+
+    // Copy from the receive buffer, which may wrap around
+    const Size amount = size < m_receiveCount ? size : m_receiveCount;
+    const Size first = amount < ReceiveBufferSize - m_receiveHead ?
+                       amount : ReceiveBufferSize - m_receiveHead;
+    IOBuffer::Segment segments[2];
+
+    segments[0].buffer = (Address) (m_receiveBuffer + m_receiveHead);
+    segments[0].size   = first;
+    segments[0].offset = 0;
+    segments[1].buffer = (Address) m_receiveBuffer;
+    segments[1].size   = amount - first;
+    segments[1].offset = first;
+
+    const FileSystem::Result result = buffer.writeVector(segments, amount > first ? 2 : 1);
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+
+    m_receiveHead   = (m_receiveHead + amount) % ReceiveBufferSize;
+    m_receiveCount -= amount;
+    size = amount;
+
+    // Tell the peer when the window opened considerably (RFC 1122, 4.2.3.3)
+    if (m_state == Established || m_state == FinWait1 || m_state == FinWait2)
+    {
+        const Size threshold = 2 * m_segmentSize < ReceiveBufferSize / 2 ?
+                               2 * m_segmentSize : ReceiveBufferSize / 2;
+
+        if (getReceiveWindow() >= m_advertisedWindow + threshold)
+        {
+            m_tcp->getTimer().tick();
+            sendAcknowledge();
+        }
+    }
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result TCPSocket::write(IOBuffer & buffer,
+                                    Size & size,
+                                    const Size offset)
+{
+    NetworkClient::SocketInfo info;
+
+    DEBUG("size = " << size);
+
+    if (size < sizeof(info))
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    const FileSystem::Result readResult = buffer.read(&info, sizeof(info));
+    if (readResult != FileSystem::Success)
+    {
+        return readResult;
+    }
+
+    m_tcp->getTimer().tick();
+
+    // Handle the socket operation
+    switch (info.action)
+    {
+        case NetworkClient::Connect:
+            return connect(&info);
+
+        case NetworkClient::Listen:
+            return listen(&info);
+
+        case NetworkClient::Shutdown:
+            return shutdown();
+
+        case NetworkClient::SetNoDelay:
+            m_noDelay = info.address != 0;
+            output();
+            return FileSystem::Success;
+
+        case NetworkClient::SendSingle:
+        {
+            Size written = 0;
+            const FileSystem::Result result = send(buffer, size - sizeof(info), sizeof(info), written);
+            if (result == FileSystem::Success)
+            {
+                size = sizeof(info) + written;
+            }
+            return result;
+        }
+
+        default:
+            return FileSystem::NotSupported;
+    }
+}
+
+bool TCPSocket::canRead() const
+{
+    return m_receiveCount > 0 || m_peerFinished || m_error ||
+          (m_state == Closed && m_remotePort != 0);
+}
+
+bool TCPSocket::canWrite() const
+{
+    return (m_state == Established || m_state == CloseWait) &&
+            m_sendCount < SendBufferSize;
+}
+
+FileSystem::Result TCPSocket::process(const NetworkQueue::Packet *pkt)
+{
+    const IPV4::Header *ip = (const IPV4::Header *) (pkt->data + sizeof(Ethernet::Header));
+    const TCP::Header *hdr = (const TCP::Header *) (ip + 1);
+    const Size headerSize = (hdr->dataOffset >> 4) * sizeof(u32);
+    const Size length = readBe16(&ip->length) - sizeof(IPV4::Header) - headerSize;
+    const u8 *payload = ((const u8 *) hdr) + headerSize;
+    const u32 seq = readBe32(&hdr->sequence);
+    const u32 ack = readBe32(&hdr->acknowledge);
+    const u8 flags = hdr->flags;
+
+    DEBUG("state = " << (int) m_state << " flags = " << (int) flags <<
+          " seq = " << seq << " ack = " << ack << " length = " << length);
+
+    switch (m_state)
+    {
+        case Closed:
+            return FileSystem::Success;
+
+        case Listen:
+        {
+            if (flags & TCP::Reset)
+            {
+                return FileSystem::Success;
+            }
+            else if (flags & TCP::Acknowledge)
+            {
+                return m_tcp->sendReset(ip, hdr, length);
+            }
+            else if (!(flags & TCP::Synchronize))
+            {
+                return FileSystem::Success;
+            }
+
+            // Accept the connection
+            m_remoteAddress = readBe32(&ip->source);
+            m_remotePort    = readBe16(&hdr->sourcePort);
+            m_receiveNext   = seq + 1;
+            m_receiveScale  = WindowScale;
+            parseOptions(hdr);
+            initializeSend();
+
+            // The window of a SYN segment is never scaled
+            m_sendWindow    = readBe16(&hdr->window);
+            m_sendWindowSeq = seq;
+            m_sendWindowAck = m_initialSend;
+            m_state         = SynReceived;
+            m_sendNext      = m_initialSend + 1;
+            m_sendMaximum   = m_sendNext;
+
+            startRetransmitTimer();
+            sendSegment(m_initialSend, TCP::Synchronize | TCP::Acknowledge);
+            return FileSystem::Success;
+        }
+
+        case SynSent:
+            processSynSent(ip, hdr, length);
+            return FileSystem::Success;
+
+        default:
+            break;
+    }
+
+    // Check if the segment is inside the receive window (RFC 793, page 69)
+    const Size window = getReceiveWindow();
+    const Size segmentLength = length + ((flags & TCP::Synchronize) ? 1 : 0) +
+                                        ((flags & TCP::Finish) ? 1 : 0);
+    const bool startInside = seq == m_receiveNext ||
+                             (!sequenceBefore(seq, m_receiveNext) &&
+                               sequenceBefore(seq, m_receiveNext + window));
+    const bool endInside = segmentLength > 0 &&
+                           !sequenceBefore(seq + segmentLength - 1, m_receiveNext) &&
+                            sequenceBefore(seq + segmentLength - 1, m_receiveNext + window);
+
+    if (!startInside && !endInside)
+    {
+        if (!(flags & TCP::Reset))
+        {
+            sendAcknowledge();
+        }
+        return FileSystem::Success;
+    }
+
+    if (flags & TCP::Reset)
+    {
+        DEBUG("connection reset by peer");
+        close(true);
+        return FileSystem::Success;
+    }
+
+    if (flags & TCP::Synchronize)
+    {
+        abort();
+        return FileSystem::Success;
+    }
+
+    if (!(flags & TCP::Acknowledge))
+    {
+        return FileSystem::Success;
+    }
+
+    // The acknowledgement of our SYN completes a passive open
+    if (m_state == SynReceived)
+    {
+        if (ack != m_initialSend + 1)
+        {
+            return m_tcp->sendReset(ip, hdr, length);
+        }
+
+        m_sendUnacked   = ack;
+        m_sendWindow    = readBe16(&hdr->window) << m_sendScale;
+        m_sendWindowSeq = seq;
+        m_sendWindowAck = ack;
+        establish();
+    }
+
+    if (processAcknowledge(hdr, seq, ack, length))
+    {
+        processData(hdr, seq, payload, length);
+        output();
+    }
+
+    return FileSystem::Success;
+}
+
+bool TCPSocket::hasTimers() const
+{
+    return m_retransmitTimer.frequency != 0 ||
+           m_ackTimer.frequency != 0 ||
+           m_closeTimer.frequency != 0 ||
+           m_outputBlocked;
+}
+
+void TCPSocket::processTimers()
+{
+    const Timer & timer = m_tcp->getTimer();
+
+    if (timer.isExpired(m_ackTimer))
+    {
+        m_ackTimer.frequency = 0;
+        sendAcknowledge();
+    }
+
+    if (timer.isExpired(m_retransmitTimer))
+    {
+        m_retransmitTimer.frequency = 0;
+        retransmit();
+    }
+
+    if (timer.isExpired(m_closeTimer))
+    {
+        m_closeTimer.frequency = 0;
+        close(false);
+    }
+
+    if (m_outputBlocked)
+    {
+        output();
+    }
+}
+
+void TCPSocket::abort()
+{
+    switch (m_state)
+    {
+        case Closed:
+            return;
+
+        case Listen:
+        case SynSent:
+            close(false);
+            return;
+
+        default:
+            sendSegment(m_sendNext, TCP::Reset);
+            close(true);
+            return;
+    }
+}
+
+FileSystem::Result TCPSocket::connect(const NetworkClient::SocketInfo *dest)
+{
+    DEBUG("address = " << *IPV4::toString(dest->address) << " port = " << dest->port);
+
+    // The request is retried until the handshake completes
+    switch (m_state)
+    {
+        case SynSent:
+        case SynReceived:
+            return FileSystem::RetryAgain;
+
+        case Closed:
+            if (m_remotePort != 0)
+            {
+                return m_error ? FileSystem::IOError : FileSystem::InvalidArgument;
+            }
+            break;
+
+        default:
+            return FileSystem::Success;
+    }
+
+    if (dest->port == 0 || !allocateBuffers())
+    {
+        return dest->port == 0 ? FileSystem::InvalidArgument : FileSystem::IOError;
+    }
+
+    u16 port = m_info.port;
+    const FileSystem::Result result = m_tcp->bind(this, port);
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+
+    m_info.port     = port;
+    m_remoteAddress = dest->address;
+    m_remotePort    = dest->port;
+    m_receiveScale  = WindowScale;
+    initializeSend();
+    m_state = SynSent;
+
+    m_sendNext    = m_initialSend + 1;
+    m_sendMaximum = m_sendNext;
+    startRetransmitTimer();
+    sendSegment(m_initialSend, TCP::Synchronize);
+
+    // The handshake completes immediately on a loopback device
+    return m_state == Established ? FileSystem::Success : FileSystem::RetryAgain;
+}
+
+FileSystem::Result TCPSocket::listen(const NetworkClient::SocketInfo *local)
+{
+    DEBUG("port = " << local->port);
+
+    if (m_state == Listen)
+    {
+        return FileSystem::Success;
+    }
+    else if (m_state != Closed || m_remotePort != 0)
+    {
+        return FileSystem::InvalidArgument;
+    }
+    else if (!allocateBuffers())
+    {
+        return FileSystem::IOError;
+    }
+
+    u16 port = local->port;
+    const FileSystem::Result result = m_tcp->bind(this, port);
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+
+    MemoryBlock::copy(&m_info, local, sizeof(m_info));
+    m_info.port = port;
+    m_state = Listen;
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result TCPSocket::shutdown()
+{
+    DEBUG("state = " << (int) m_state);
+
+    switch (m_state)
+    {
+        case Listen:
+        case SynSent:
+            close(false);
+            break;
+
+        case SynReceived:
+            return FileSystem::RetryAgain;
+
+        case Established:
+            m_finishPending = true;
+            m_state = FinWait1;
+            output();
+            break;
+
+        case CloseWait:
+            m_finishPending = true;
+            m_state = LastAck;
+            output();
+            break;
+
+        default:
+            break;
+    }
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result TCPSocket::send(IOBuffer & buffer,
+                                   const Size size,
+                                   const Size offset,
+                                   Size & written)
+{
+    switch (m_state)
+    {
+        case SynSent:
+        case SynReceived:
+            return FileSystem::RetryAgain;
+
+        case Established:
+        case CloseWait:
+            break;
+
+        default:
+            return m_error ? FileSystem::IOError : FileSystem::InvalidArgument;
+    }
+
+    // Wait until the data fits, or half of the buffer for large writes
+    const Size space = SendBufferSize - m_sendCount;
+    const Size wanted = size < SendBufferSize / 2 ? size : SendBufferSize / 2;
+
+    if (space < wanted)
+    {
+        return FileSystem::RetryAgain;
+    }
+
+    // Append to the send buffer, which may wrap around
+    const Size amount = size < space ? size : space;
+    const Size tail = (m_sendHead + m_sendCount) % SendBufferSize;
+    const Size first = amount < SendBufferSize - tail ? amount : SendBufferSize - tail;
+
+    FileSystem::Result result = buffer.read(m_sendBuffer + tail, first, offset);
+    if (result == FileSystem::Success && amount > first)
+    {
+        result = buffer.read(m_sendBuffer, amount - first, offset + first);
+    }
+
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+
+    m_sendCount += amount;
+    written = amount;
+    output();
+
+    return FileSystem::Success;
+}
+
+bool TCPSocket::allocateBuffers()
+{
+    if (!m_sendBuffer)
+        m_sendBuffer = new u8[SendBufferSize];
+
+    if (!m_receiveBuffer)
+        m_receiveBuffer = new u8[ReceiveBufferSize];
+
+    return m_sendBuffer != ZERO && m_receiveBuffer != ZERO;
+}
+
+void TCPSocket::processSynSent(const IPV4::Header *ip,
+                               const TCP::Header *hdr,
+                               const Size length)
+{
+    const u32 seq = readBe32(&hdr->sequence);
+    const u32 ack = readBe32(&hdr->acknowledge);
+    const u8 flags = hdr->flags;
+
+    if ((flags & TCP::Acknowledge) && ack != m_initialSend + 1)
+    {
+        if (!(flags & TCP::Reset))
+        {
+            m_tcp->sendReset(ip, hdr, length);
+        }
+        return;
+    }
+
+    if (flags & TCP::Reset)
+    {
+        if (flags & TCP::Acknowledge)
+        {
+            DEBUG("connection refused");
+            close(true);
+        }
+        return;
+    }
+
+    if (!(flags & TCP::Synchronize))
+    {
+        return;
+    }
+
+    m_receiveNext = seq + 1;
+    parseOptions(hdr);
+
+    if (flags & TCP::Acknowledge)
+    {
+        m_sendUnacked   = ack;
+        m_sendNext      = ack;
+        m_sendMaximum   = ack;
+
+        // The window of a SYN segment is never scaled
+        m_sendWindow    = readBe16(&hdr->window);
+        m_sendWindowSeq = seq;
+        m_sendWindowAck = ack;
+        establish();
+        sendAcknowledge();
+    }
+    else
+    {
+        // Simultaneous open
+        m_state = SynReceived;
+        sendSegment(m_initialSend, TCP::Synchronize | TCP::Acknowledge);
+    }
+}
+
+bool TCPSocket::processAcknowledge(const TCP::Header *hdr,
+                                   const u32 seq,
+                                   const u32 ack,
+                                   const Size length)
+{
+    const Size window = readBe16(&hdr->window) << m_sendScale;
+
+    // Acknowledges data which is not sent yet
+    if (sequenceBefore(m_sendMaximum, ack))
+    {
+        sendAcknowledge();
+        return false;
+    }
+
+    if (sequenceBefore(m_sendUnacked, ack))
+    {
+        const Size acked = ack - m_sendUnacked;
+        const Size dataAcked = acked < m_sendCount ? acked : m_sendCount;
+
+        // Sample the round trip time of the timed segment
+        if (m_timing && !sequenceBefore(ack, m_timedSequence))
+        {
+            m_timing = false;
+            updateRoundTrip(getMilliseconds() - m_timedStart);
+        }
+
+        // Release acknowledged data. Our FIN takes the last sequence number.
+        m_sendHead   = (m_sendHead + dataAcked) % SendBufferSize;
+        m_sendCount -= dataAcked;
+        if (acked > dataAcked)
+            m_finishSent = true;
+
+        m_sendUnacked = ack;
+        if (sequenceBefore(m_sendNext, ack))
+            m_sendNext = ack;
+
+        // Update the congestion window (RFC 5681, RFC 6582)
+        if (m_recovering)
+        {
+            if (!sequenceBefore(ack, m_recover))
+            {
+                m_recovering = false;
+                m_congestionWindow = m_slowStartThreshold;
+            }
+            else
+            {
+                // Partial acknowledgement: the next segment is lost as well
+                sendSegment(m_sendUnacked, TCP::Acknowledge, 0,
+                            m_sendCount < m_segmentSize ? m_sendCount : m_segmentSize);
+                m_congestionWindow = m_congestionWindow > dataAcked ?
+                                     m_congestionWindow - dataAcked + m_segmentSize : m_segmentSize;
+            }
+        }
+        else if (m_congestionWindow < m_slowStartThreshold)
+        {
+            m_congestionWindow += dataAcked < m_segmentSize ? dataAcked : m_segmentSize;
+        }
+        else
+        {
+            const Size increment = (m_segmentSize * m_segmentSize) / m_congestionWindow;
+            m_congestionWindow += increment > 0 ? increment : 1;
+        }
+
+        if (m_congestionWindow > SendBufferSize * 2)
+            m_congestionWindow = SendBufferSize * 2;
+
+        m_duplicateAcks = 0;
+        m_retries = 0;
+
+        if (m_sendNext != m_sendUnacked)
+            startRetransmitTimer();
+        else
+            m_retransmitTimer.frequency = 0;
+
+        // All data and our FIN are acknowledged
+        if (m_finishSent && m_sendCount == 0 && m_sendUnacked == m_sendMaximum)
+        {
+            switch (m_state)
+            {
+                case FinWait1:
+                    m_state = FinWait2;
+                    break;
+
+                case Closing:
+                    enterTimeWait();
+                    return false;
+
+                case LastAck:
+                    close(false);
+                    return false;
+
+                default:
+                    break;
+            }
+        }
+
+        notifyReady();
+    }
+    else if (ack == m_sendUnacked && length == 0 && window == m_sendWindow &&
+             !(hdr->flags & (TCP::Synchronize | TCP::Finish)) && m_sendNext != m_sendUnacked)
+    {
+        // Duplicate acknowledgement
+        m_duplicateAcks++;
+
+        if (m_duplicateAcks == DuplicateThreshold && !m_recovering)
+        {
+            const Size inFlight = m_sendNext - m_sendUnacked;
+
+            DEBUG("fast retransmit seq = " << m_sendUnacked);
+            m_slowStartThreshold = inFlight / 2 > 2 * m_segmentSize ? inFlight / 2 : 2 * m_segmentSize;
+            m_recover = m_sendMaximum;
+            m_recovering = true;
+            m_timing = false;
+
+            sendSegment(m_sendUnacked, TCP::Acknowledge, 0,
+                        m_sendCount < m_segmentSize ? m_sendCount : m_segmentSize);
+            m_congestionWindow = m_slowStartThreshold + DuplicateThreshold * m_segmentSize;
+        }
+        else if (m_recovering)
+        {
+            m_congestionWindow += m_segmentSize;
+        }
+    }
+
+    // Update the send window (RFC 793, page 72)
+    if (sequenceBefore(m_sendWindowSeq, seq) ||
+       (m_sendWindowSeq == seq && !sequenceBefore(ack, m_sendWindowAck)))
+    {
+        m_sendWindow    = window;
+        m_sendWindowSeq = seq;
+        m_sendWindowAck = ack;
+    }
+
+    return true;
+}
+
+void TCPSocket::processData(const TCP::Header *hdr,
+                            const u32 seq,
+                            const u8 *payload,
+                            const Size length)
+{
+    if (m_state != Established && m_state != FinWait1 && m_state != FinWait2)
+    {
+        return;
+    }
+
+    if (length > 0)
+    {
+        Size skip = 0;
+
+        // Segments received out of order are dropped
+        if (sequenceBefore(m_receiveNext, seq))
+        {
+            sendAcknowledge();
+            return;
+        }
+
+        // Skip data which we already received
+        skip = m_receiveNext - seq;
+        if (skip >= length)
+        {
+            sendAcknowledge();
+            return;
+        }
+
+        // Append to the receive buffer, which may wrap around
+        const Size window = getReceiveWindow();
+        const Size amount = length - skip < window ? length - skip : window;
+        const Size tail = (m_receiveHead + m_receiveCount) % ReceiveBufferSize;
+        const Size first = amount < ReceiveBufferSize - tail ? amount : ReceiveBufferSize - tail;
+
+        MemoryBlock::copy(m_receiveBuffer + tail, payload + skip, first);
+        MemoryBlock::copy(m_receiveBuffer, payload + skip + first, amount - first);
+        m_receiveCount += amount;
+        m_receiveNext  += amount;
+
+        if (amount > 0)
+        {
+            notifyReady();
+        }
+
+        // The remainder did not fit
+        if (amount < length - skip)
+        {
+            sendAcknowledge();
+            return;
+        }
+    }
+
+    if ((hdr->flags & TCP::Finish) && seq + length == m_receiveNext)
+    {
+        DEBUG("connection closed by peer");
+        m_receiveNext++;
+        m_peerFinished = true;
+        sendAcknowledge();
+        notifyReady();
+
+        switch (m_state)
+        {
+            case Established:
+                m_state = CloseWait;
+                break;
+
+            case FinWait1:
+                if (m_finishSent && m_sendCount == 0 && m_sendUnacked == m_sendMaximum)
+                    enterTimeWait();
+                else
+                    m_state = Closing;
+                break;
+
+            case FinWait2:
+                enterTimeWait();
+                break;
+
+            default:
+                break;
+        }
+    }
+    else if (length > 0)
+    {
+        scheduleAcknowledge();
+    }
+}
+
+void TCPSocket::parseOptions(const TCP::Header *hdr)
+{
+    const u8 *option = (const u8 *) (hdr + 1);
+    const u8 *end = ((const u8 *) hdr) + ((hdr->dataOffset >> 4) * sizeof(u32));
+    const Size maximum = m_tcp->getMaximumSegmentSize();
+
+    m_segmentSize = DefaultSegmentSize < maximum ? DefaultSegmentSize : maximum;
+    m_peerScaling = false;
+    m_sendScale   = 0;
+
+    while (option < end && *option != TCP::OptionEnd)
+    {
+        if (*option == TCP::OptionNop)
+        {
+            option++;
+            continue;
+        }
+
+        if (option + 1 >= end || option[1] < 2 || option + option[1] > end)
+        {
+            break;
+        }
+
+        switch (*option)
+        {
+            case TCP::OptionSegmentSize:
+                if (option[1] == 4)
+                {
+                    const Size size = readBe16(option + 2);
+                    m_segmentSize = size < maximum ? size : maximum;
+                }
+                break;
+
+            case TCP::OptionWindowScale:
+                if (option[1] == 3)
+                {
+                    m_peerScaling = true;
+                    m_sendScale = option[2] > 14 ? 14 : option[2];
+                }
+                break;
+
+            default:
+                break;
+        }
+        option += option[1];
+    }
+
+    // Scaling is only used if both sides announce it
+    if (!m_peerScaling)
+    {
+        m_receiveScale = 0;
+    }
+}
+
+void TCPSocket::initializeSend()
+{
+    Randomizer random;
+
+    // Combine a clock with a random offset for the initial sequence number
+    m_initialSend        = random.next() + (getMilliseconds() << 8);
+    m_sendUnacked        = m_initialSend;
+    m_sendNext           = m_initialSend;
+    m_sendMaximum        = m_initialSend;
+    m_sendHead           = 0;
+    m_sendCount          = 0;
+    m_retransmitTimeout  = InitialTimeout;
+    m_retries            = 0;
+
+    // Time the handshake
+    m_timing        = true;
+    m_timedSequence = m_initialSend + 1;
+    m_timedStart    = getMilliseconds();
+}
+
+void TCPSocket::establish()
+{
+    DEBUG("connection established");
+
+    m_state = Established;
+    m_sendNext = m_sendUnacked;
+    m_sendMaximum = m_sendUnacked;
+    m_congestionWindow = InitialWindow * m_segmentSize;
+    m_slowStartThreshold = SendBufferSize;
+    m_retries = 0;
+    m_retransmitTimer.frequency = 0;
+
+    if (m_timing)
+    {
+        m_timing = false;
+        updateRoundTrip(getMilliseconds() - m_timedStart);
+    }
+
+    notifyReady();
+}
+
+void TCPSocket::enterTimeWait()
+{
+    m_state = TimeWait;
+    m_retransmitTimer.frequency = 0;
+    m_tcp->getTimer().getCurrent(&m_closeTimer, TimeWaitTime);
+}
+
+void TCPSocket::output(const bool force)
+{
+    bool probe = force;
+
+    switch (m_state)
+    {
+        case Established:
+        case CloseWait:
+        case FinWait1:
+        case Closing:
+        case LastAck:
+            break;
+
+        default:
+            return;
+    }
+
+    // Segments may be acknowledged while sending, e.g. on a loopback device.
+    // The loop below picks up any change in the windows.
+    if (m_sending)
+    {
+        return;
+    }
+
+    m_sending = true;
+    m_outputBlocked = false;
+
+    while (true)
+    {
+        const Size inFlight = m_sendNext - m_sendUnacked;
+        const Size sentData = inFlight - (m_finishSent ? 1 : 0);
+        const Size unsent = m_sendCount - sentData;
+        const Size window = m_sendWindow < m_congestionWindow ? m_sendWindow : m_congestionWindow;
+        const Size usable = window > inFlight ? window - inFlight : 0;
+        const u32 seq = m_sendNext;
+        Size length = unsent < usable ? unsent : usable;
+
+        if (length > m_segmentSize)
+            length = m_segmentSize;
+
+        // Probe a zero window with a single byte
+        if (probe && length == 0 && unsent > 0)
+            length = 1;
+
+        if (length == 0)
+        {
+            // Send our FIN after all data
+            if (unsent == 0 && m_finishPending && !m_finishSent)
+            {
+                m_finishSent = true;
+                m_sendNext++;
+                if (sequenceBefore(m_sendMaximum, m_sendNext))
+                    m_sendMaximum = m_sendNext;
+                if (!m_retransmitTimer.frequency)
+                    startRetransmitTimer();
+
+                if (sendSegment(seq, TCP::Finish | TCP::Acknowledge) != FileSystem::Success)
+                {
+                    m_finishSent = false;
+                    m_sendNext = seq;
+                    m_outputBlocked = true;
+                }
+            }
+            // Wait for the peer to open its window
+            else if (unsent > 0 && inFlight == 0 && !m_retransmitTimer.frequency)
+            {
+                startRetransmitTimer();
+            }
+            break;
+        }
+
+        // Avoid small segments (Nagle, RFC 896) and silly windows (RFC 1122)
+        if (length < m_segmentSize && !probe && inFlight > 0)
+        {
+            if (length < unsent || (!m_noDelay && !m_finishPending))
+                break;
+        }
+
+        const bool last = length == unsent;
+        const bool finish = last && m_finishPending && !m_finishSent;
+        const u8 flags = TCP::Acknowledge | (last ? TCP::Push : 0) | (finish ? TCP::Finish : 0);
+
+        // Time one segment of new data at a time (Karn's algorithm)
+        const bool timing = !m_timing && !sequenceBefore(seq, m_sendMaximum);
+        if (timing)
+        {
+            m_timing = true;
+            m_timedSequence = seq + length;
+            m_timedStart = getMilliseconds();
+        }
+
+        // Update the administration first, as the acknowledgement may arrive while sending
+        const u32 maximum = m_sendMaximum;
+        m_sendNext += length + (finish ? 1 : 0);
+        m_finishSent = m_finishSent || finish;
+        if (sequenceBefore(m_sendMaximum, m_sendNext))
+            m_sendMaximum = m_sendNext;
+        if (!m_retransmitTimer.frequency)
+            startRetransmitTimer();
+
+        if (sendSegment(seq, flags, sentData, length) != FileSystem::Success)
+        {
+            m_sendNext = seq;
+            m_sendMaximum = maximum;
+            m_finishSent = m_finishSent && !finish;
+            m_timing = m_timing && !timing;
+            m_outputBlocked = true;
+            break;
+        }
+        probe = false;
+    }
+
+    m_sending = false;
+}
+
+FileSystem::Result TCPSocket::sendSegment(const u32 seq,
+                                          const u8 flags,
+                                          const Size offset,
+                                          const Size length)
+{
+    u8 buffer[sizeof(TCP::Header) + 8];
+    TCP::Header *hdr = (TCP::Header *) buffer;
+    Size headerSize = sizeof(TCP::Header);
+    Size window = getReceiveWindow();
+
+    // Windows in SYN segments are never scaled
+    if (flags & TCP::Synchronize)
+    {
+        if (window > 0xffff)
+            window = 0xffff;
+        m_advertisedWindow = window;
+    }
+    else
+    {
+        window >>= m_receiveScale;
+        if (window > 0xffff)
+            window = 0xffff;
+        m_advertisedWindow = window << m_receiveScale;
+    }
+
+    writeBe16(&hdr->sourcePort, m_info.port);
+    writeBe16(&hdr->destPort, m_remotePort);
+    writeBe32(&hdr->sequence, seq);
+    writeBe32(&hdr->acknowledge, (flags & TCP::Acknowledge) ? m_receiveNext : 0);
+    writeBe16(&hdr->window, window);
+    hdr->flags   = flags;
+    hdr->urgent  = 0;
+
+    // Announce our segment size and window scale
+    if (flags & TCP::Synchronize)
+    {
+        u8 *option = buffer + headerSize;
+
+        option[0] = TCP::OptionSegmentSize;
+        option[1] = 4;
+        writeBe16(option + 2, m_tcp->getMaximumSegmentSize());
+        headerSize += 4;
+
+        if (m_state == SynSent || m_peerScaling)
+        {
+            option[4] = TCP::OptionNop;
+            option[5] = TCP::OptionWindowScale;
+            option[6] = 3;
+            option[7] = m_receiveScale;
+            headerSize += 4;
+        }
+    }
+    hdr->dataOffset = (headerSize / sizeof(u32)) << 4;
+
+    // The payload may wrap around the end of the send buffer
+    const Size start = (m_sendHead + offset) % SendBufferSize;
+    const Size first = length < SendBufferSize - start ? length : SendBufferSize - start;
+
+    const FileSystem::Result result = m_tcp->sendSegment(m_remoteAddress, hdr, headerSize,
+                                                         length ? m_sendBuffer + start : ZERO, first,
+                                                         m_sendBuffer, length - first);
+    if (result == FileSystem::Success && (flags & TCP::Acknowledge))
+    {
+        m_unackedSegments = 0;
+        m_ackTimer.frequency = 0;
+    }
+
+    return result;
+}
+
+void TCPSocket::sendAcknowledge()
+{
+    if (sendSegment(m_sendNext, TCP::Acknowledge) != FileSystem::Success &&
+        !m_ackTimer.frequency)
+    {
+        m_tcp->getTimer().getCurrent(&m_ackTimer, DelayedAckTime);
+    }
+}
+
+void TCPSocket::scheduleAcknowledge()
+{
+    // Acknowledge at least every second segment (RFC 1122, 4.2.3.2)
+    if (++m_unackedSegments >= 2)
+    {
+        sendAcknowledge();
+    }
+    else if (!m_ackTimer.frequency)
+    {
+        m_tcp->getTimer().getCurrent(&m_ackTimer, DelayedAckTime);
+    }
+}
+
+void TCPSocket::retransmit()
+{
+    DEBUG("state = " << (int) m_state << " retries = " << m_retries);
+
+    const Size inFlight = m_sendNext - m_sendUnacked;
+    const bool probe = inFlight == 0 && (m_state == Established || m_state == CloseWait);
+
+    // Window probes continue as long as the peer acknowledges them
+    if (!probe && ++m_retries > MaxRetries)
+    {
+        DEBUG("connection timed out");
+        abort();
+        m_error = true;
+        return;
+    }
+
+    m_retransmitTimeout *= 2;
+    if (m_retransmitTimeout > MaximumTimeout)
+        m_retransmitTimeout = MaximumTimeout;
+    m_timing = false;
+
+    switch (m_state)
+    {
+        case SynSent:
+            sendSegment(m_initialSend, TCP::Synchronize);
+            startRetransmitTimer();
+            return;
+
+        case SynReceived:
+            sendSegment(m_initialSend, TCP::Synchronize | TCP::Acknowledge);
+            startRetransmitTimer();
+            return;
+
+        default:
+            break;
+    }
+
+    if (probe)
+    {
+        output(true);
+    }
+    else
+    {
+        // Restart from the oldest unacknowledged byte with one segment (RFC 5681)
+        m_slowStartThreshold = inFlight / 2 > 2 * m_segmentSize ? inFlight / 2 : 2 * m_segmentSize;
+        m_congestionWindow = m_segmentSize;
+        m_recovering = false;
+        m_duplicateAcks = 0;
+        m_sendNext = m_sendUnacked;
+        m_finishSent = false;
+        output();
+    }
+
+    if (!m_retransmitTimer.frequency && (m_sendNext != m_sendUnacked || m_sendCount > 0))
+    {
+        startRetransmitTimer();
+    }
+}
+
+void TCPSocket::startRetransmitTimer()
+{
+    m_tcp->getTimer().getCurrent(&m_retransmitTimer, m_retransmitTimeout);
+}
+
+void TCPSocket::updateRoundTrip(const Size msec)
+{
+    // Estimate the retransmission timeout (RFC 6298)
+    if (m_smoothedRoundTrip == 0)
+    {
+        m_smoothedRoundTrip = (msec << 3) + 1;
+        m_roundTripVariance = msec << 1;
+    }
+    else
+    {
+        slong delta = (slong) msec - (slong) (m_smoothedRoundTrip >> 3);
+
+        m_smoothedRoundTrip = (slong) m_smoothedRoundTrip + delta;
+        if (delta < 0)
+            delta = -delta;
+        m_roundTripVariance = m_roundTripVariance + delta - (m_roundTripVariance >> 2);
+    }
+
+    m_retransmitTimeout = (m_smoothedRoundTrip >> 3) + m_roundTripVariance;
+
+    if (m_retransmitTimeout < MinimumTimeout)
+        m_retransmitTimeout = MinimumTimeout;
+    else if (m_retransmitTimeout > MaximumTimeout)
+        m_retransmitTimeout = MaximumTimeout;
+
+    DEBUG("rtt = " << msec << " rto = " << m_retransmitTimeout);
+}
+
+void TCPSocket::close(const bool error)
+{
+    DEBUG("error = " << error);
+
+    if (m_state != Closed)
+    {
+        m_tcp->unbind(this, m_info.port);
+    }
+
+    m_state = Closed;
+    m_error = m_error || error;
+    m_retransmitTimer.frequency = 0;
+    m_ackTimer.frequency = 0;
+    m_closeTimer.frequency = 0;
+    m_outputBlocked = false;
+
+    if (error)
+    {
+        m_sendCount = 0;
+    }
+
+    notifyReady();
+}
+
+const Size TCPSocket::getReceiveWindow() const
+{
+    return ReceiveBufferSize - m_receiveCount;
+}
+
+const u32 TCPSocket::getMilliseconds() const
+{
+    Timer::Info now;
+
+    m_tcp->getTimer().getCurrent(&now);
+    if (!now.frequency)
+        return 0;
+
+    return ((u64) now.ticks * 1000) / now.frequency;
+}
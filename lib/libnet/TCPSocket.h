@@ -0,0 +1,547 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBNET_TCPSOCKET_H
+#define __LIB_LIBNET_TCPSOCKET_H
+
+#include <Types.h>
+#include <Timer.h>
+#include "NetworkSocket.h"
+#include "NetworkQueue.h"
+#include "NetworkClient.h"
+#include "IPV4.h"
+#include "TCP.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libnet
+ * @{
+ */
+
+/**
+ * Transmission Control Protocol (TCP) socket.
+ *
+ * Writing a SocketInfo with the Connect or Listen action opens the
+ * connection. Data is written with the SendSingle action followed by the
+ * payload, and read as a plain byte stream. A read of zero bytes indicates
+ * that the peer closed the connection.
+ *
+ * The socket uses a sliding window with window scaling (RFC 7323), slow start
+ * and congestion avoidance, fast retransmit (RFC 5681), delayed acknowledgements
+ * and the Nagle algorithm (RFC 1122). Segments received out of order are
+ * dropped and answered with a duplicate acknowledgement.
+ */
+class TCPSocket : public NetworkSocket
+{
+  private:
+
+    /** Size of the send buffer in bytes */
+    static const Size SendBufferSize = 128 * 1024;
+
+    /** Size of the receive buffer in bytes */
+    static const Size ReceiveBufferSize = 128 * 1024;
+
+    /** Window scale shift we advertise, which covers the receive buffer */
+    static const u8 WindowScale = 2;
+
+    /** Segment size assumed when the peer does not announce one */
+    static const Size DefaultSegmentSize = 536;
+
+    /** Initial congestion window in segments (RFC 6928) */
+    static const Size InitialWindow = 10;
+
+    /** Number of duplicate acknowledgements which trigger fast retransmit */
+    static const Size DuplicateThreshold = 3;
+
+    /** Maximum number of retransmissions before the connection is aborted */
+    static const Size MaxRetries = 8;
+
+    /** Initial retransmission timeout in milliseconds */
+    static const Size InitialTimeout = 1000;
+
+    /** Minimum retransmission timeout in milliseconds */
+    static const Size MinimumTimeout = 200;
+
+    /** Maximum retransmission timeout in milliseconds */
+    static const Size MaximumTimeout = 60000;
+
+    /** Milliseconds to delay an acknowledgement */
+    static const Size DelayedAckTime = 40;
+
+    /** Milliseconds to stay in the TimeWait state */
+    static const Size TimeWaitTime = 2000;
+
+  public:
+
+    /**
+     * Connection states (RFC 793)
+     */
+    enum State
+    {
+        Closed,
+        Listen,
+        SynSent,
+        SynReceived,
+        Established,
+        FinWait1,
+        FinWait2,
+        CloseWait,
+        Closing,
+        LastAck,
+        TimeWait
+    };
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param inode Inode number
+     * @param tcp TCP protocol instance
+     * @param pid ProcessID which owns this socket
+     */
+    TCPSocket(const u32 inode,
+              TCP *tcp,
+              const ProcessID pid);
+
+    /**
+     * Destructor
+     */
+    virtual ~TCPSocket();
+
+    /**
+     * Get associated local port.
+     *
+     * @return Local port
+     */
+    const u16 getPort() const;
+
+    /**
+     * Get connection state
+     *
+     * @return State
+     */
+    const State getState() const;
+
+    /**
+     * Check if a segment belongs to the connection of this socket
+     *
+     * @param address Source IP address of the segment
+     * @param port Source port of the segment
+     *
+     * @return True if the socket listens or is connected to the given peer
+     */
+    bool accepts(const IPV4::Address address,
+                 const u16 port) const;
+
+    /**
+     * Receive TCP data
+     *
+     * @param buffer Input/Output buffer to output bytes to.
+     * @param size Maximum number of bytes to read on input.
+     *             On output, the actual number of bytes read.
+     * @param offset Offset inside the file to start reading.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result read(IOBuffer & buffer,
+                                    Size & size,
+                                    const Size offset);
+
+    /**
+     * Perform a socket action or send TCP data
+     *
+     * @param buffer Input/Output buffer to input bytes from.
+     * @param size Maximum number of bytes to write on input.
+     *             On output, the actual number of bytes written.
+     * @param offset Offset inside the file to start writing.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result write(IOBuffer & buffer,
+                                     Size & size,
+                                     const Size offset);
+
+    /**
+     * Check if the File has data ready for reading.
+     *
+     * @return True if data, end of stream or an error can be read
+     */
+    virtual bool canRead() const;
+
+    /**
+     * Check if the File can be written to.
+     *
+     * @return True if the send buffer has free space
+     */
+    virtual bool canWrite() const;
+
+    /**
+     * Process incoming network packet.
+     *
+     * @param pkt Incoming packet pointer
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result process(const NetworkQueue::Packet *pkt);
+
+    /**
+     * Check if any timer of the socket is running
+     *
+     * @return True if processTimers() must be called
+     */
+    bool hasTimers() const;
+
+    /**
+     * Handle expired timers
+     */
+    void processTimers();
+
+    /**
+     * Abort the connection by sending a reset
+     */
+    void abort();
+
+  private:
+
+    /**
+     * Start an active open
+     *
+     * @param dest Address and port of the peer
+     *
+     * @return Result code
+     */
+    FileSystem::Result connect(const NetworkClient::SocketInfo *dest);
+
+    /**
+     * Start a passive open
+     *
+     * @param local Local port to listen on
+     *
+     * @return Result code
+     */
+    FileSystem::Result listen(const NetworkClient::SocketInfo *local);
+
+    /**
+     * Close the sending side of the connection
+     *
+     * @return Result code
+     */
+    FileSystem::Result shutdown();
+
+    /**
+     * Append data to the send buffer
+     *
+     * @param buffer Input buffer
+     * @param size Number of bytes to send
+     * @param offset Offset of the data in the input buffer
+     * @param written On output the number of bytes added
+     *
+     * @return Result code
+     */
+    FileSystem::Result send(IOBuffer & buffer,
+                            const Size size,
+                            const Size offset,
+                            Size & written);
+
+    /**
+     * Allocate the send and receive buffers
+     *
+     * @return True on success
+     */
+    bool allocateBuffers();
+
+    /**
+     * Handle a segment in the SynSent state
+     *
+     * @param ip IP header of the segment
+     * @param hdr TCP header of the segment
+     * @param length Number of payload bytes
+     */
+    void processSynSent(const IPV4::Header *ip,
+                        const TCP::Header *hdr,
+                        const Size length);
+
+    /**
+     * Handle an acknowledgement in a synchronized state
+     *
+     * @param hdr TCP header of the segment
+     * @param seq Sequence number of the segment
+     * @param ack Acknowledgement number of the segment
+     * @param length Number of payload bytes
+     *
+     * @return False if processing of the segment must stop
+     */
+    bool processAcknowledge(const TCP::Header *hdr,
+                            const u32 seq,
+                            const u32 ack,
+                            const Size length);
+
+    /**
+     * Handle payload and FIN in a synchronized state
+     *
+     * @param hdr TCP header of the segment
+     * @param seq Sequence number of the segment
+     * @param payload Payload of the segment
+     * @param length Number of payload bytes
+     */
+    void processData(const TCP::Header *hdr,
+                     const u32 seq,
+                     const u8 *payload,
+                     const Size length);
+
+    /**
+     * Read the options of a SYN segment
+     *
+     * @param hdr TCP header of the segment
+     */
+    void parseOptions(const TCP::Header *hdr);
+
+    /**
+     * Initialize send state for a new connection
+     */
+    void initializeSend();
+
+    /**
+     * Enter the Established state
+     */
+    void establish();
+
+    /**
+     * Enter the TimeWait state
+     */
+    void enterTimeWait();
+
+    /**
+     * Transmit as much buffered data as the windows allow
+     *
+     * @param force Send at least one byte, also into a zero window
+     */
+    void output(const bool force = false);
+
+    /**
+     * Transmit a segment
+     *
+     * @param seq Sequence number of the segment
+     * @param flags TCP flags
+     * @param offset Offset of the payload from the oldest unacknowledged byte
+     * @param length Number of payload bytes
+     *
+     * @return Result code
+     */
+    FileSystem::Result sendSegment(const u32 seq,
+                                   const u8 flags,
+                                   const Size offset = 0,
+                                   const Size length = 0);
+
+    /**
+     * Send an acknowledgement immediately
+     */
+    void sendAcknowledge();
+
+    /**
+     * Schedule an acknowledgement for received data
+     */
+    void scheduleAcknowledge();
+
+    /**
+     * Retransmit after the retransmission timer expired
+     */
+    void retransmit();
+
+    /**
+     * Start the retransmission timer
+     */
+    void startRetransmitTimer();
+
+    /**
+     * Add a round trip time sample
+     *
+     * @param msec Measured round trip time in milliseconds
+     */
+    void updateRoundTrip(const Size msec);
+
+    /**
+     * Enter the Closed state
+     *
+     * @param error True if the connection failed
+     */
+    void close(const bool error);
+
+    /**
+     * Get the number of bytes we can receive
+     *
+     * @return Free bytes in the receive buffer
+     */
+    const Size getReceiveWindow() const;
+
+    /**
+     * Get the current time in milliseconds
+     *
+     * @return Milliseconds since an arbitrary point in time
+     */
+    const u32 getMilliseconds() const;
+
+  private:
+
+    /** TCP protocol instance */
+    TCP *m_tcp;
+
+    /** Connection state */
+    State m_state;
+
+    /** True if the connection was refused, reset or timed out */
+    bool m_error;
+
+    /** Address of the peer */
+    IPV4::Address m_remoteAddress;
+
+    /** Port of the peer */
+    u16 m_remotePort;
+
+    /** Oldest unacknowledged sequence number */
+    u32 m_sendUnacked;
+
+    /** Next sequence number to send */
+    u32 m_sendNext;
+
+    /** Highest sequence number sent */
+    u32 m_sendMaximum;
+
+    /** Send window of the peer in bytes */
+    Size m_sendWindow;
+
+    /** Sequence number of the segment which last updated the send window */
+    u32 m_sendWindowSeq;
+
+    /** Acknowledgement number of the segment which last updated the send window */
+    u32 m_sendWindowAck;
+
+    /** Initial send sequence number */
+    u32 m_initialSend;
+
+    /** Next sequence number expected from the peer */
+    u32 m_receiveNext;
+
+    /** Shift applied to the window of the peer */
+    u8 m_sendScale;
+
+    /** Shift applied to our advertised window */
+    u8 m_receiveScale;
+
+    /** True if the peer announced window scaling */
+    bool m_peerScaling;
+
+    /** Maximum payload size of segments we send */
+    Size m_segmentSize;
+
+    /** Send buffer, starting at the oldest unacknowledged byte */
+    u8 *m_sendBuffer;
+
+    /** Index of the oldest unacknowledged byte in the send buffer */
+    Size m_sendHead;
+
+    /** Number of bytes in the send buffer */
+    Size m_sendCount;
+
+    /** Receive buffer */
+    u8 *m_receiveBuffer;
+
+    /** Index of the next byte to read in the receive buffer */
+    Size m_receiveHead;
+
+    /** Number of bytes in the receive buffer */
+    Size m_receiveCount;
+
+    /** Window last advertised to the peer in bytes */
+    Size m_advertisedWindow;
+
+    /** Congestion window in bytes */
+    Size m_congestionWindow;
+
+    /** Slow start threshold in bytes */
+    Size m_slowStartThreshold;
+
+    /** Number of duplicate acknowledgements received */
+    Size m_duplicateAcks;
+
+    /** True during fast recovery */
+    bool m_recovering;
+
+    /** Highest sequence number sent when fast recovery started */
+    u32 m_recover;
+
+    /** Smoothed round trip time in milliseconds, times eight */
+    Size m_smoothedRoundTrip;
+
+    /** Round trip time variation in milliseconds, times four */
+    Size m_roundTripVariance;
+
+    /** Retransmission timeout in milliseconds */
+    Size m_retransmitTimeout;
+
+    /** Number of consecutive retransmissions */
+    Size m_retries;
+
+    /** True while a round trip time is measured */
+    bool m_timing;
+
+    /** Sequence number which ends the timed segment */
+    u32 m_timedSequence;
+
+    /** Time in milliseconds at which the timed segment was sent */
+    u32 m_timedStart;
+
+    /** Retransmission timer, which is stopped if the frequency is zero */
+    Timer::Info m_retransmitTimer;
+
+    /** Delayed acknowledgement timer, which is stopped if the frequency is zero */
+    Timer::Info m_ackTimer;
+
+    /** TimeWait timer, which is stopped if the frequency is zero */
+    Timer::Info m_closeTimer;
+
+    /** Number of full segments received which are not yet acknowledged */
+    Size m_unackedSegments;
+
+    /** True to disable the Nagle algorithm */
+    bool m_noDelay;
+
+    /** True if our FIN must be sent after the buffered data */
+    bool m_finishPending;
+
+    /** True if our FIN is sent */
+    bool m_finishSent;
+
+    /** True if the peer sent its FIN */
+    bool m_peerFinished;
+
+    /** True if buffered data could not be transmitted */
+    bool m_outputBlocked;
+
+    /** True while output() is transmitting segments */
+    bool m_sending;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBNET_TCPSOCKET_H */
@@ -19,6 +19,7 @@
 #include "NetworkServer.h"
 #include "NetworkDevice.h"
 #include "UDP.h"
+#include "InternetChecksum.h"
 #include "UDPSocket.h"
 #include "UDPFactory.h"
 
@@ -26,11 +27,16 @@ UDP::UDP(NetworkServer &server,
          NetworkDevice &device,
          NetworkProtocol &parent)
     : NetworkProtocol(server, device, parent)
+    , m_ipv4(ZERO)
 {
 }
 
 UDP::~UDP()
 {
+    for (HashIterator<u16, PortGroup *> it(m_ports); it.hasCurrent(); it++)
+    {
+        delete it.current();
+    }
 }
 
 FileSystem::Result UDP::initialize()
@@ -83,11 +89,21 @@ void UDP::unregisterSockets(const ProcessID pid)
 {
     DEBUG("pid = " << pid);
 
-    for (HashIterator<u16, UDPSocket *> it(m_ports); it.hasCurrent();)
+    for (HashIterator<u16, PortGroup *> it(m_ports); it.hasCurrent();)
     {
-        UDPSocket *sock = it.current();
-        if (sock->getProcessID() == pid)
+        PortGroup *group = it.current();
+
+        for (Size i = 0; i < group->count;)
         {
+            if (group->sockets[i]->getProcessID() == pid)
+                group->sockets[i] = group->sockets[--group->count];
+            else
+                i++;
+        }
+
+        if (group->count == 0)
+        {
+            delete group;
             it.remove();
         }
         else
@@ -117,28 +133,55 @@ void UDP::unregisterSockets(const ProcessID pid)
 FileSystem::Result UDP::process(const NetworkQueue::Packet *pkt,
                                 const Size offset)
 {
+    const IPV4::Header *ip = (const IPV4::Header *)(pkt->data + sizeof(Ethernet::Header));
     const Header *hdr = (const Header *)(pkt->data + sizeof(Ethernet::Header) + sizeof(IPV4::Header));
-    const u16 port = be16_to_cpu(hdr->destPort);
+    const u16 port = hdr->destPort;
+    const Size length = hdr->length;
+    const Size available = pkt->size - sizeof(Ethernet::Header) - sizeof(IPV4::Header);
 
     DEBUG("port = " << port);
 
+    countReceive(pkt, offset);
+
+    // Verify the checksum if present, unless the device did already
+    if (!(pkt->flags & NetworkQueue::ChecksumVerified) && hdr->checksum != 0 &&
+        (length < sizeof(Header) || length > available ||
+         checksum(ip, hdr, length - sizeof(Header)) != 0))
+    {
+        DEBUG("dropped packet with invalid checksum");
+        countDrop(BadChecksum);
+        return FileSystem::InvalidArgument;
+    }
+
     // Process the packet if we have a socket on that port
-    UDPSocket **sock = (UDPSocket **) m_ports.get(port);
-    if (!sock)
+    PortGroup * const *group = m_ports.get(port);
+    if (!group)
     {
         DEBUG("dropped");
+        countDrop(NoSocket);
         return FileSystem::NotFound;
     }
 
-    (*sock)->process(pkt);
+    UDPSocket *sock = (*group)->count == 1 ? (*group)->sockets[0] : selectSocket(*group, pkt);
+    const FileSystem::Result result = sock->process(pkt);
+    if (result != FileSystem::Success)
+    {
+        countDrop(QueueFull);
+    }
     return FileSystem::Success;
 }
 
+void UDP::setIP(::IPV4 *ip)
+{
+    m_ipv4 = ip;
+}
+
 FileSystem::Result UDP::sendPacket(const NetworkClient::SocketInfo *src,
                                    const NetworkClient::SocketInfo *dest,
                                    IOBuffer & buffer,
                                    const Size size,
-                                   const Size offset)
+                                   const Size offset,
+                                   IPV4::HeaderTemplate *tmpl)
 {
     NetworkQueue::Packet *pkt;
     Header *hdr;
@@ -146,9 +189,17 @@ FileSystem::Result UDP::sendPacket(const NetworkClient::SocketInfo *src,
     DEBUG("address = " << *IPV4::toString(dest->address) <<
           " port = " << dest->port << " size = " << size);
 
-    // Get a fresh packet
-    const FileSystem::Result result = m_parent.getTransmitPacket(&pkt, &dest->address, sizeof(dest->address),
-                                                                 NetworkProtocol::UDP, sizeof(Header) + size);
+    // Datagrams larger than the MTU are sent in fragments
+    if (sizeof(Header) + size > getMaximumPacketSize() - sizeof(Ethernet::Header) - sizeof(IPV4::Header))
+    {
+        return sendFragments(src, dest, buffer, size, offset);
+    }
+
+    // Get a fresh packet, with prebuilt headers if possible
+    const FileSystem::Result result = tmpl != ZERO ?
+        m_ipv4->getTransmitPacket(&pkt, tmpl, dest->address, NetworkProtocol::UDP, sizeof(Header) + size) :
+        m_parent.getTransmitPacket(&pkt, &dest->address, sizeof(dest->address),
+                                   NetworkProtocol::UDP, sizeof(Header) + size);
     if (result != FileSystem::Success)
     {
         if (result != FileSystem::RetryAgain)
@@ -160,29 +211,144 @@ FileSystem::Result UDP::sendPacket(const NetworkClient::SocketInfo *src,
 
     // Fill UDP header
     hdr = (Header *) (pkt->data + pkt->size);
-    writeBe16(&hdr->sourcePort, src->port);
-    writeBe16(&hdr->destPort, dest->port);
-    writeBe16(&hdr->length, size + sizeof(Header));
-    writeBe16(&hdr->checksum, 0);
+    hdr->sourcePort = src->port;
+    hdr->destPort   = dest->port;
+    hdr->length     = size + sizeof(Header);
+    hdr->checksum   = 0;
 
     // Insert payload. The payload is read from the given offset in the IOBuffer.
     // Note that the payload must not overwrite past the packet buffer
-    const Size maximum = getMaximumPacketSize();
-    const Size needed = pkt->size + size;
-
-    buffer.read(pkt->data + pkt->size + sizeof(Header),
-                needed > maximum ? maximum : needed, offset);
+    const Size maximum = getMaximumPacketSize() - pkt->size - sizeof(Header);
+    const FileSystem::Result readResult = buffer.read(pkt->data + pkt->size + sizeof(Header),
+                                                      size > maximum ? maximum : size, offset);
+    if (readResult != FileSystem::Success)
+    {
+        ERROR("failed to read payload: result = " << (int) readResult);
+        m_device.getTransmitQueue()->release(pkt);
+        return readResult;
+    }
 
-    // Calculate final checksum
-    write16(&hdr->checksum, checksum((IPV4::Header *)(pkt->data + pkt->size - sizeof(IPV4::Header)),
-                                      hdr, size));
-    DEBUG("checksum = " << (uint) hdr->checksum);
+    // Calculate final checksum, unless the device inserts it
+    if (!(pkt->flags & NetworkQueue::ChecksumOffload))
+    {
+        write16(&hdr->checksum, checksum((IPV4::Header *)(pkt->data + pkt->size - sizeof(IPV4::Header)),
+                                          hdr, size));
+        DEBUG("checksum = " << (uint) hdr->checksum);
+    }
 
     // Increment packet size
     pkt->size += sizeof(Header) + size;
+    countTransmit(sizeof(Header) + size);
+
+    // Transmit now
+    return m_parent.transmitPacket(pkt);
+}
+
+FileSystem::Result UDP::sendFragments(const NetworkClient::SocketInfo *src,
+                                      const NetworkClient::SocketInfo *dest,
+                                      IOBuffer & buffer,
+                                      const Size size,
+                                      const Size offset)
+{
+    const Size total = sizeof(Header) + size;
+    const Size perFragment = (getMaximumPacketSize() - sizeof(Ethernet::Header) - sizeof(IPV4::Header)) &
+                            ~(IPV4::FragmentUnit - 1);
+    const Size count = (total + perFragment - 1) / perFragment;
+    const u16 identification = m_ipv4->nextIdentification();
+    NetworkQueue::Packet *fragments[MaxFragments];
+    FileSystem::Result result = FileSystem::Success;
+    Header *hdr = ZERO;
+    u32 sum = 0;
+    Size prepared = 0;
+
+    DEBUG("size = " << size << " fragments = " << count);
+
+    if (total > 0xffff - sizeof(IPV4::Header) || count > MaxFragments)
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    // Fill all fragments, which start with the UDP header
+    for (Size position = 0; prepared < count; prepared++, position += perFragment)
+    {
+        const Size fragmentSize = total - position < perFragment ? total - position : perFragment;
+        NetworkQueue::Packet *pkt;
+
+        result = m_ipv4->getTransmitFragment(&pkt, dest->address, NetworkProtocol::UDP, identification,
+                                             position, fragmentSize, prepared + 1 < count);
+        if (result != FileSystem::Success)
+        {
+            break;
+        }
+        fragments[prepared] = pkt;
+
+        u8 *payload = pkt->data + pkt->size;
+
+        if (position == 0)
+        {
+            const IPV4::Header *ip = (const IPV4::Header *)(payload - sizeof(IPV4::Header));
+
+            hdr = (Header *) payload;
+            hdr->sourcePort = src->port;
+            hdr->destPort   = dest->port;
+            hdr->length     = total;
+            hdr->checksum   = 0;
+            sum = InternetChecksum::pseudoHeader(read32(&ip->source), read32(&ip->destination),
+                                                 IPV4::UDP, total);
+
+            result = buffer.read(hdr + 1, fragmentSize - sizeof(Header), offset);
+        }
+        else
+        {
+            result = buffer.read(payload, fragmentSize, offset + position - sizeof(Header));
+        }
+
+        if (result != FileSystem::Success)
+        {
+            ERROR("failed to read payload: result = " << (int) result);
+            prepared++;
+            break;
+        }
+
+        // Fragments other than the last have an even size, thus the sums can be chained
+        sum = InternetChecksum::sum(payload, fragmentSize, sum);
+        pkt->size += fragmentSize;
+    }
+
+    if (result != FileSystem::Success)
+    {
+        if (result != FileSystem::RetryAgain)
+        {
+            ERROR("failed to prepare fragments: result = " << (int) result);
+        }
+
+        for (Size i = 0; i < prepared; i++)
+        {
+            m_device.getTransmitQueue()->release(fragments[i]);
+        }
+        return result;
+    }
+
+    write16(&hdr->checksum, (u16) ~sum);
+    countTransmit(total);
 
     // Transmit now
-    return m_device.transmit(pkt);
+    for (Size i = 0; i < count; i++)
+    {
+        result = m_parent.transmitPacket(fragments[i]);
+        if (result != FileSystem::Success)
+        {
+            ERROR("failed to transmit fragment " << i << ": result = " << (int) result);
+
+            for (Size j = i + 1; j < count; j++)
+            {
+                m_device.getTransmitQueue()->release(fragments[j]);
+            }
+            return result;
+        }
+    }
+
+    return FileSystem::Success;
 }
 
 FileSystem::Result UDP::bind(UDPSocket *sock,
@@ -195,57 +361,90 @@ FileSystem::Result UDP::bind(UDPSocket *sock,
         return FileSystem::InvalidArgument;
     }
 
-    m_ports.insert(port, sock);
+    PortGroup * const *existing = m_ports.get(port);
+    if (!existing)
+    {
+        PortGroup *group = new PortGroup;
+        if (!group)
+        {
+            ERROR("failed to allocate UDP port group");
+            return FileSystem::IOError;
+        }
+        group->count = 1;
+        group->sockets[0] = sock;
+        m_ports.insert(port, group);
+        return FileSystem::Success;
+    }
+
+    PortGroup *group = *existing;
+
+    for (Size i = 0; i < group->count; i++)
+    {
+        if (group->sockets[i] == sock)
+            return FileSystem::Success;
+    }
+
+    // The port is only shared if all sockets allow it
+    if (!sock->isReusePort() || !group->sockets[0]->isReusePort())
+    {
+        return FileSystem::AlreadyExists;
+    }
+
+    if (group->count >= MaxPortSockets)
+    {
+        return FileSystem::RetryAgain;
+    }
+
+    group->sockets[group->count++] = sock;
     return FileSystem::Success;
 }
 
-const ulong UDP::calculateSum(const u16 *ptr,
-                              const Size bytes)
+void UDP::unbind(const UDPSocket *sock,
+                 const u16 port)
 {
-    ulong sum = 0;
-    Size remain = bytes;
+    DEBUG("port = " << port);
 
-    for (;remain > 0; remain -= sizeof(u16), ptr++)
+    PortGroup * const *existing = m_ports.get(port);
+    if (!existing)
     {
-        if (remain == sizeof(u8))
+        return;
+    }
+
+    PortGroup *group = *existing;
+
+    for (Size i = 0; i < group->count; i++)
+    {
+        if (group->sockets[i] == sock)
         {
-            sum += read8(ptr);
+            group->sockets[i] = group->sockets[--group->count];
             break;
         }
-        else
-        {
-            sum += read16(ptr);
-        }
     }
 
-    return sum;
+    if (group->count == 0)
+    {
+        m_ports.remove(port);
+        delete group;
+    }
+}
+
+UDPSocket * UDP::selectSocket(const PortGroup *group,
+                              const NetworkQueue::Packet *pkt) const
+{
+    // Each flow is consistently delivered to the same socket
+    return group->sockets[pkt->hash % group->count];
 }
 
 const u16 UDP::checksum(const IPV4::Header *ip,
                         const UDP::Header *udp,
                         const Size datalen)
 {
-    IPV4::PseudoHeader phr;
-    ulong sum = 0;
-
-    // Setup a pseudo header
-    phr.reserved = 0;
-    phr.protocol = IPV4::UDP;
-    phr.source = read32(&ip->source);
-    phr.destination = read32(&ip->destination);
-    writeBe16(&phr.length, sizeof(Header) + datalen);
-    DEBUG("ip src = " << *IPV4::toString(phr.source) <<
-          " dst = " << *IPV4::toString(phr.destination));
-
-    // Sum the pseudo header
-    sum += calculateSum((u16 *) &phr, sizeof(phr));
-    sum += calculateSum((u16 *) udp, sizeof(*udp) + datalen);
-
-    // Keep only last 16 bits and add carry bits
-    sum = (sum >> 16) + (sum & 0xffff);
-    sum += (sum >> 16);
-
-    // Take one's complement
-    sum = ~sum;
-    return (u16) sum;
+    const u32 pseudo = InternetChecksum::pseudoHeader(read32(&ip->source),
+                                                      read32(&ip->destination),
+                                                      IPV4::UDP,
+                                                      sizeof(Header) + datalen);
+    DEBUG("ip src = " << *IPV4::toString(read32(&ip->source)) <<
+          " dst = " << *IPV4::toString(read32(&ip->destination)));
+
+    return InternetChecksum::checksum(udp, sizeof(*udp) + datalen, pseudo);
 }
@@ -19,6 +19,7 @@
 #define __LIB_LIBNET_UDP_H
 
 #include <Types.h>
+#include <ByteOrder.h>
 #include <Index.h>
 #include <String.h>
 #include <HashTable.h>
@@ -44,6 +45,25 @@ class UDP : public NetworkProtocol
 
     static const Size MaxUdpSockets = 128u;
 
+    /** Maximum number of sockets sharing a single port */
+    static const Size MaxPortSockets = 16u;
+
+    /** Maximum number of fragments of a single datagram */
+    static const Size MaxFragments = NetworkQueue::BatchPackets;
+
+    /**
+     * Sockets bound to a single port
+     */
+    typedef struct PortGroup
+    {
+        /** Number of sockets bound */
+        Size count;
+
+        /** Bound sockets */
+        UDPSocket *sockets[MaxPortSockets];
+    }
+    PortGroup;
+
   public:
 
     /**
@@ -51,9 +71,9 @@ class UDP : public NetworkProtocol
      */
     typedef struct Header
     {
-        u16 sourcePort;
-        u16 destPort;
-        u16 length;
+        be16_t sourcePort;
+        be16_t destPort;
+        be16_t length;
         u16 checksum;
     }
     Header;
@@ -120,16 +140,42 @@ class UDP : public NetworkProtocol
     FileSystem::Result bind(UDPSocket *sock,
                             const u16 port);
 
+    /**
+     * Release an UDP port
+     *
+     * @param sock UDP socket which is bound to the port
+     * @param port The port to release
+     */
+    void unbind(const UDPSocket *sock,
+                const u16 port);
+
+    /**
+     * Set IPV4 instance
+     *
+     * @param ip IPV4 instance
+     */
+    void setIP(::IPV4 *ip);
+
     /**
      * Send packet
      *
+     * Datagrams which do not fit in the MTU are sent in fragments.
+     *
+     * @param src Local address and port
+     * @param dest Destination address and port
+     * @param buffer Input buffer with the payload
+     * @param size Number of payload bytes
+     * @param offset Offset of the payload in the buffer
+     * @param tmpl Optional prebuilt headers of the sending socket
+     *
      * @return Result code
      */
     FileSystem::Result sendPacket(const NetworkClient::SocketInfo *src,
                                   const NetworkClient::SocketInfo *dest,
                                   IOBuffer & buffer,
                                   const Size size,
-                                  const Size offset);
+                                  const Size offset,
+                                  IPV4::HeaderTemplate *tmpl = ZERO);
 
     /**
      * Calculate ICMP checksum
@@ -147,26 +193,49 @@ class UDP : public NetworkProtocol
   private:
 
     /**
-     * Calculate sum of artibrary data
+     * Send a datagram in IPV4 fragments.
+     *
+     * All fragments are prepared before the first is transmitted,
+     * because the checksum in the first fragment covers the entire payload.
      *
-     * @param ptr Pointer to the data to sum
-     * @param bytes Number of bytes to add to the sum
+     * @param src Local address and port
+     * @param dest Destination address and port
+     * @param buffer Input buffer with the payload
+     * @param size Number of payload bytes
+     * @param offset Offset of the payload in the buffer
      *
-     * @return Sum value for the input data
+     * @return Result code
      */
-    static const ulong calculateSum(const u16 *ptr,
-                                    const Size bytes);
+    FileSystem::Result sendFragments(const NetworkClient::SocketInfo *src,
+                                     const NetworkClient::SocketInfo *dest,
+                                     IOBuffer & buffer,
+                                     const Size size,
+                                     const Size offset);
+
+    /**
+     * Select the socket to receive a datagram on a shared port.
+     *
+     * @param group Sockets bound to the destination port
+     * @param pkt Packet with the datagram
+     *
+     * @return Socket chosen by the flow hash of the packet
+     */
+    UDPSocket * selectSocket(const PortGroup *group,
+                             const NetworkQueue::Packet *pkt) const;
 
   private:
 
+    /** IPV4 instance */
+    ::IPV4 *m_ipv4;
+
     /** Factory for creating new UDP sockets */
     UDPFactory *m_factory;
 
     /** Contains all UDP sockets */
     Index<UDPSocket, MaxUdpSockets> m_sockets;
 
-    /** Maps UDP ports to UDP sockets */
-    HashTable<u16, UDPSocket *> m_ports;
+    /** Maps UDP ports to the sockets bound to them */
+    HashTable<u16, PortGroup *> m_ports;
 };
 
 /**
@@ -15,6 +15,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <FreeNOS/User.h>
 #include <FreeNOS/System.h>
 #include <ByteOrder.h>
 #include <Randomizer.h>
@@ -22,18 +23,60 @@
 #include "UDP.h"
 #include "UDPSocket.h"
 
+/**
+ * Prepare a message which describes all payload buffers of a batch.
+ *
+ * The lowest payload address serves as the base, such that each payload
+ * is reached with an offset. The message has no file transfer action,
+ * thus it is never mapped or buffered by the IOBuffer.
+ *
+ * @return True if all payloads are reachable from the base
+ */
+static bool prepareBatch(FileSystemMessage & msg,
+                         const ProcessID from,
+                         const NetworkClient::BatchPacket *packets,
+                         const Size count)
+{
+    Address base = packets[0].buffer;
+
+    for (Size i = 1; i < count; i++)
+    {
+        if (packets[i].buffer < base)
+            base = packets[i].buffer;
+    }
+
+    for (Size i = 0; i < count; i++)
+    {
+        if ((Address) (Size) (packets[i].buffer - base) != packets[i].buffer - base)
+            return false;
+    }
+
+    MemoryBlock::set(&msg, 0, sizeof(msg));
+    msg.from   = from;
+    msg.buffer = (char *) base;
+    return true;
+}
+
 UDPSocket::UDPSocket(const u32 inode,
                      UDP *udp,
                      const ProcessID pid)
-    : NetworkSocket(inode, udp->getMaximumPacketSize(), pid)
+    : NetworkSocket(inode, udp->getMaximumFrameSize(), pid)
     , m_udp(udp)
     , m_port(0)
-    , m_queue(udp->getMaximumPacketSize())
+    , m_reusePort(false)
+    , m_coalesce(false)
+    , m_queue(udp->getMaximumFrameSize())
 {
+    MemoryBlock::set(&m_ringShare, 0, sizeof(m_ringShare));
+    MemoryBlock::set(&m_template, 0, sizeof(m_template));
 }
 
 UDPSocket::~UDPSocket()
 {
+    if (m_ring.isValid())
+    {
+        VMShare(m_ringShare.pid, API::Delete, &m_ringShare);
+    }
 }
 
 const u16 UDPSocket::getPort() const
@@ -41,12 +84,28 @@ const u16 UDPSocket::getPort() const
     return m_port;
 }
 
+bool UDPSocket::isReusePort() const
+{
+    return m_reusePort;
+}
+
 FileSystem::Result UDPSocket::read(IOBuffer & buffer,
                                    Size & size,
                                    const Size offset)
 {
     DEBUG("");
 
+    // Datagrams are consumed from the ring by the client itself
+    if (m_ring.isValid())
+    {
+        return FileSystem::NotSupported;
+    }
+
+    if (m_coalesce)
+    {
+        return readCoalesced(buffer, size);
+    }
+
     NetworkQueue::Packet *pkt = m_queue.pop();
     if (!pkt)
     {
@@ -56,22 +115,103 @@ FileSystem::Result UDPSocket::read(IOBuffer & buffer,
     IPV4::Header *ipHdr = (IPV4::Header *)(pkt->data + sizeof(Ethernet::Header));
     UDP::Header *udpHdr = (UDP::Header *)(pkt->data + sizeof(Ethernet::Header) + sizeof(IPV4::Header));
     NetworkClient::SocketInfo info;
+    IOBuffer::Segment segments[2];
     Size payloadSize = pkt->size - sizeof(Ethernet::Header)
                                  - sizeof(IPV4::Header)
                                  - sizeof(UDP::Header);
 
     // Fill socket info
     info.address = readBe32(&ipHdr->source);
-    info.port    = readBe16(&udpHdr->sourcePort);
-    buffer.write(&info, sizeof(info));
+    info.port    = udpHdr->sourcePort;
 
-    // Fill payload
+    // Fill socket info and payload
     Size sz = size > payloadSize ? payloadSize : size;
-    buffer.write(udpHdr+1, sz, sizeof(info));
+    segments[0].buffer = (Address) &info;
+    segments[0].size   = sizeof(info);
+    segments[0].offset = 0;
+    segments[1].buffer = (Address) (udpHdr + 1);
+    segments[1].size   = sz;
+    segments[1].offset = sizeof(info);
+
+    const FileSystem::Result result = buffer.writeVector(segments, 2);
     m_queue.release(pkt);
     size = sz + sizeof(info);
 
-    return FileSystem::Success;
+    return result;
+}
+
+FileSystem::Result UDPSocket::readCoalesced(IOBuffer & buffer,
+                                            Size & size)
+{
+    NetworkClient::DatagramRecord records[NetworkQueue::BatchPackets];
+    NetworkQueue::Packet *received[NetworkQueue::BatchPackets];
+    IOBuffer::Segment segments[NetworkQueue::BatchPackets * 2];
+    Size num = 0, total = 0;
+
+    DEBUG("size = " << size);
+
+    if (size < sizeof(NetworkClient::DatagramRecord))
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    // Collect the queued datagrams which fit entirely. Only the
+    // first datagram is truncated, if needed, to make progress.
+    while (num < NetworkQueue::BatchPackets)
+    {
+        NetworkQueue::Packet *pkt = m_queue.peek();
+        if (!pkt)
+            break;
+
+        const IPV4::Header *ipHdr = (const IPV4::Header *)(pkt->data + sizeof(Ethernet::Header));
+        const UDP::Header *udpHdr = (const UDP::Header *)(ipHdr + 1);
+        Size payloadSize = pkt->size - sizeof(Ethernet::Header)
+                                     - sizeof(IPV4::Header)
+                                     - sizeof(UDP::Header);
+
+        if (total + sizeof(NetworkClient::DatagramRecord) + payloadSize > size)
+        {
+            if (num > 0)
+                break;
+
+            payloadSize = size - sizeof(NetworkClient::DatagramRecord);
+        }
+        m_queue.pop();
+
+        NetworkClient::DatagramRecord & record = records[num];
+        record.address = readBe32(&ipHdr->source);
+        record.port    = udpHdr->sourcePort;
+        record.size    = payloadSize;
+
+        segments[num * 2].buffer     = (Address) &record;
+        segments[num * 2].size       = sizeof(record);
+        segments[num * 2].offset     = total;
+        segments[num * 2 + 1].buffer = (Address) (udpHdr + 1);
+        segments[num * 2 + 1].size   = payloadSize;
+        segments[num * 2 + 1].offset = total + sizeof(record);
+        received[num++] = pkt;
+
+        // The next record starts aligned
+        total += sizeof(record) + payloadSize;
+        total += (NetworkClient::RecordAlignment - (total % NetworkClient::RecordAlignment)) %
+                  NetworkClient::RecordAlignment;
+    }
+
+    if (num == 0)
+    {
+        return FileSystem::RetryAgain;
+    }
+
+    // Copy all records and payloads at once
+    const FileSystem::Result result = buffer.writeVector(segments, num * 2);
+
+    for (Size i = 0; i < num; i++)
+    {
+        m_queue.release(received[i]);
+    }
+
+    size = total > size ? size : total;
+    return result;
 }
 
 FileSystem::Result UDPSocket::write(IOBuffer & buffer,
@@ -98,42 +238,82 @@ FileSystem::Result UDPSocket::write(IOBuffer & buffer,
             }
 
             DEBUG("addr =" << m_info.address << " port = " << m_info.port);
-            return m_udp->bind(this, m_info.port);
+
+            // Release the previously bound port, if any
+            if (m_port != 0 && m_port != m_info.port)
+            {
+                m_udp->unbind(this, m_port);
+                m_port = 0;
+            }
+
+            const FileSystem::Result result = m_udp->bind(this, m_info.port);
+            if (result == FileSystem::Success)
+            {
+                m_port = m_info.port;
+            }
+            return result;
         }
 
+        case NetworkClient::SetReusePort:
+            m_reusePort = dest.address != 0;
+            return FileSystem::Success;
+
+        case NetworkClient::SetCoalesce:
+            m_coalesce = dest.address != 0;
+            return FileSystem::Success;
+
+        case NetworkClient::SetQueueSize:
+            return m_queue.resize(dest.address) ? FileSystem::Success : FileSystem::InvalidArgument;
+
         case NetworkClient::SendSingle:
-            return m_udp->sendPacket(&m_info, &dest, buffer, size - sizeof(dest), sizeof(dest));
+            return m_udp->sendPacket(&m_info, &dest, buffer, size - sizeof(dest), sizeof(dest), &m_template);
+
+        case NetworkClient::SendBatch:
+            return sendBatch(buffer, size, dest);
+
+        case NetworkClient::ReceiveBatch:
+            return m_ring.isValid() ? FileSystem::NotSupported : receiveBatch(buffer, size);
+
+        case NetworkClient::SetReceiveRing:
+            return mapReceiveRing(buffer.getMessage()->from, dest.address);
 
         case NetworkClient::SendMultiple:
         {
-            NetworkClient::PacketInfo packetInfo;
+            NetworkClient::PacketInfo packets[NetworkQueue::BatchPackets];
             FileSystemMessage msg;
             IOBuffer io;
             Size packetOffset = 0;
+            Size count = (size - sizeof(dest)) / sizeof(NetworkClient::PacketInfo);
+
+            if (count == 0)
+                return FileSystem::Success;
+            else if (count > NetworkQueue::BatchPackets)
+                count = NetworkQueue::BatchPackets;
 
-            // Read the first packet info to find the base address for all packets.
+            // Read the array of PacketInfo structs that describe
+            // all the packets that need to be transferred at once
+            const FileSystem::Result readResult = buffer.read(packets, count * sizeof(NetworkClient::PacketInfo),
+                                                              sizeof(dest));
+            if (readResult != FileSystem::Success)
+                return readResult;
+
+            // The first packet info gives the base address for all packets.
             //
             // Note that it is assumed here that all packet buffers
             // originate from the same base address and that each new packet
             // starts after NetworkQueue::PayloadBufferSize bytes.
-            buffer.read(&packetInfo, sizeof(packetInfo), sizeof(dest));
-
-            // Prepare dummy filesystem message for the I/O buffer
             msg.from = buffer.getMessage()->from;
             msg.action = FileSystem::WriteFile;
-            msg.buffer = (char *)packetInfo.address;
-            msg.size = NetworkQueue::MaxPackets * PAGESIZE;
+            msg.buffer = (char *)packets[0].address;
+            msg.size = NetworkQueue::BatchPackets * PAGESIZE;
             io.setMessage(&msg);
 
-            // read the array of PacketInfo structs that describe
-            // all the packets that need to be transferred
-            for (Size i = sizeof(dest); i < size; i += sizeof(NetworkClient::PacketInfo))
+            for (Size i = 0; i < count; i++)
             {
-                buffer.read(&packetInfo, sizeof(packetInfo), i);
-                DEBUG("packet[" << ((i - sizeof(dest)) / sizeof(NetworkClient::PacketInfo)) <<
-                      "] size = " << packetInfo.size << " offset = " << packetOffset);
+                const NetworkClient::PacketInfo & packetInfo = packets[i];
+                DEBUG("packet[" << i << "] size = " << packetInfo.size << " offset = " << packetOffset);
 
-                const FileSystem::Result r = m_udp->sendPacket(&m_info, &dest, io, packetInfo.size, packetOffset);
+                const FileSystem::Result r = m_udp->sendPacket(&m_info, &dest, io, packetInfo.size, packetOffset, &m_template);
                 if (r != FileSystem::Success)
                 {
                     ERROR("failed to send packet: result = " << (int) r);
@@ -151,25 +331,245 @@ FileSystem::Result UDPSocket::write(IOBuffer & buffer,
     }
 }
 
+FileSystem::Result UDPSocket::sendBatch(IOBuffer & buffer,
+                                        Size & size,
+                                        const NetworkClient::SocketInfo & dest)
+{
+    NetworkClient::BatchPacket packets[NetworkQueue::BatchPackets];
+    FileSystemMessage msg;
+    IOBuffer io;
+    Size count = (size - sizeof(dest)) / sizeof(NetworkClient::BatchPacket);
+    Size sent = 0;
+
+    if (count == 0)
+        return FileSystem::Success;
+    else if (count > NetworkQueue::BatchPackets)
+        count = NetworkQueue::BatchPackets;
+
+    const FileSystem::Result readResult = buffer.read(packets, count * sizeof(NetworkClient::BatchPacket),
+                                                      sizeof(dest));
+    if (readResult != FileSystem::Success)
+        return readResult;
+
+    // The payloads are read from anywhere in the client
+    if (!prepareBatch(msg, buffer.getMessage()->from, packets, count))
+        return FileSystem::InvalidArgument;
+
+    io.setMessage(&msg);
+
+    for (; sent < count; sent++)
+    {
+        const NetworkClient::BatchPacket & packet = packets[sent];
+        NetworkClient::SocketInfo peer;
+
+        peer.address = packet.address ? packet.address : dest.address;
+        peer.port    = packet.address ? packet.port : dest.port;
+        peer.action  = NetworkClient::SendSingle;
+
+        DEBUG("packet[" << sent << "] size = " << packet.size);
+
+        const FileSystem::Result result = m_udp->sendPacket(&m_info, &peer, io, packet.size,
+                                                            packet.buffer - (Address) msg.buffer,
+                                                            &m_template);
+        if (result != FileSystem::Success)
+        {
+            // Report the datagrams sent so far
+            if (sent > 0)
+                break;
+
+            if (result != FileSystem::RetryAgain)
+                ERROR("failed to send packet: result = " << (int) result);
+            return result;
+        }
+    }
+
+    size = sizeof(dest) + (sent * sizeof(NetworkClient::BatchPacket));
+    return FileSystem::Success;
+}
+
+FileSystem::Result UDPSocket::receiveBatch(IOBuffer & buffer,
+                                           Size & size)
+{
+    NetworkClient::BatchPacket packets[NetworkQueue::BatchPackets];
+    NetworkQueue::Packet *received[NetworkQueue::BatchPackets];
+    IOBuffer::Segment segments[NetworkQueue::BatchPackets];
+    FileSystemMessage msg;
+    IOBuffer io;
+    Size count = (size - sizeof(NetworkClient::SocketInfo)) / sizeof(NetworkClient::BatchPacket);
+    Size num = 0;
+
+    if (count == 0)
+        return FileSystem::Success;
+    else if (count > NetworkQueue::BatchPackets)
+        count = NetworkQueue::BatchPackets;
+
+    if (!m_queue.hasData())
+        return FileSystem::RetryAgain;
+
+    const FileSystem::Result readResult = buffer.read(packets, count * sizeof(NetworkClient::BatchPacket),
+                                                      sizeof(NetworkClient::SocketInfo));
+    if (readResult != FileSystem::Success)
+        return readResult;
+
+    // The payloads are written to anywhere in the client
+    if (!prepareBatch(msg, buffer.getMessage()->from, packets, count))
+        return FileSystem::InvalidArgument;
+
+    // Collect the payloads of all queued datagrams which fit
+    for (; num < count; num++)
+    {
+        NetworkQueue::Packet *pkt = m_queue.pop();
+        if (!pkt)
+            break;
+
+        const IPV4::Header *ipHdr = (const IPV4::Header *)(pkt->data + sizeof(Ethernet::Header));
+        const UDP::Header *udpHdr = (const UDP::Header *)(ipHdr + 1);
+        const Size payloadSize = pkt->size - sizeof(Ethernet::Header)
+                                           - sizeof(IPV4::Header)
+                                           - sizeof(UDP::Header);
+        NetworkClient::BatchPacket & packet = packets[num];
+
+        packet.size    = packet.size > payloadSize ? payloadSize : packet.size;
+        packet.address = readBe32(&ipHdr->source);
+        packet.port    = udpHdr->sourcePort;
+
+        segments[num].buffer = (Address) (udpHdr + 1);
+        segments[num].size   = packet.size;
+        segments[num].offset = packet.buffer - (Address) msg.buffer;
+        received[num] = pkt;
+    }
+
+    // Copy all payloads at once
+    io.setMessage(&msg);
+
+    FileSystem::Result result = io.writeVector(segments, num);
+
+    for (Size i = 0; i < num; i++)
+    {
+        m_queue.release(received[i]);
+    }
+
+    // Update the descriptors with the size and sender of each datagram
+    if (result == FileSystem::Success)
+    {
+        result = buffer.write(packets, num * sizeof(NetworkClient::BatchPacket),
+                              sizeof(NetworkClient::SocketInfo));
+    }
+
+    size = sizeof(NetworkClient::SocketInfo) + (num * sizeof(NetworkClient::BatchPacket));
+    return result;
+}
+
+FileSystem::Result UDPSocket::mapReceiveRing(const ProcessID pid,
+                                             const Size tagId)
+{
+    const SystemInformation info;
+
+    if (m_ring.isValid() || tagId < NetworkClient::RingShareTag)
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    m_ringShare.pid    = pid;
+    m_ringShare.coreId = info.coreId;
+    m_ringShare.tagId  = tagId;
+
+    const API::Result result = VMShare(SELF, API::Read, &m_ringShare);
+    if (result != API::Success)
+    {
+        ERROR("failed to read receive ring share for PID " << pid << ": result = " << (int) result);
+        return FileSystem::IOError;
+    }
+
+    // The client already initialized the indices
+    if (!m_ring.setBase(m_ringShare.range.virt, m_ringShare.range.size, false))
+    {
+        ERROR("receive ring of PID " << pid << " too small: size = " << m_ringShare.range.size);
+        VMShare(pid, API::Delete, &m_ringShare);
+        return FileSystem::InvalidArgument;
+    }
+
+    // Move datagrams received so far to the ring
+    for (NetworkQueue::Packet *pkt = m_queue.pop(); pkt != ZERO; pkt = m_queue.pop())
+    {
+        pushRing(pkt);
+        m_queue.release(pkt);
+    }
+
+    if (m_ring.hasData())
+    {
+        notifyReady();
+    }
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result UDPSocket::pushRing(const NetworkQueue::Packet *pkt)
+{
+    SocketRing::Slot *slot = m_ring.reserve();
+    if (!slot)
+    {
+        DEBUG("udp socket ring full");
+        return FileSystem::RetryAgain;
+    }
+
+    const IPV4::Header *ipHdr = (const IPV4::Header *)(pkt->data + sizeof(Ethernet::Header));
+    const UDP::Header *udpHdr = (const UDP::Header *)(ipHdr + 1);
+    const Size payloadSize = pkt->size - sizeof(Ethernet::Header)
+                                       - sizeof(IPV4::Header)
+                                       - sizeof(UDP::Header);
+
+    // Write the payload directly in the memory of the client
+    slot->address = readBe32(&ipHdr->source);
+    slot->port    = udpHdr->sourcePort;
+    slot->size    = payloadSize > m_ring.getPayloadSize() ? m_ring.getPayloadSize() : payloadSize;
+    MemoryBlock::copy(slot + 1, udpHdr + 1, slot->size);
+    m_ring.push();
+
+    return FileSystem::Success;
+}
+
 bool UDPSocket::canRead() const
 {
-    return m_queue.hasData();
+    return m_ring.isValid() ? m_ring.hasData() : m_queue.hasData();
 }
 
 FileSystem::Result UDPSocket::process(const NetworkQueue::Packet *pkt)
 {
     DEBUG("");
 
-    NetworkQueue::Packet *buf = m_queue.get();
-    if (!buf)
+    if (m_ring.isValid())
     {
-        ERROR("udp socket queue full");
-        return FileSystem::IOError;
+        const FileSystem::Result result = pushRing(pkt);
+        if (result == FileSystem::Success)
+        {
+            notifyReady();
+        }
+        return result;
     }
 
-    buf->size = pkt->size;
-    MemoryBlock::copy(buf->data, pkt->data, pkt->size);
-    m_queue.push(buf);
+    // Queue the received frame itself if possible, otherwise a copy
+    if (!m_queue.share(pkt))
+    {
+        // Reassembled datagrams may exceed the buffers of the socket
+        if (pkt->size > m_queue.getBufferSize())
+        {
+            DEBUG("udp datagram of " << pkt->size << " bytes exceeds socket buffer");
+            return FileSystem::IOError;
+        }
+
+        NetworkQueue::Packet *buf = m_queue.get();
+        if (!buf)
+        {
+            ERROR("udp socket queue full");
+            return FileSystem::IOError;
+        }
+
+        buf->size = pkt->size;
+        MemoryBlock::copy(buf->data, pkt->data, pkt->size);
+        m_queue.push(buf);
+    }
+    notifyReady();
 
     return FileSystem::Success;
 }
@@ -22,6 +22,7 @@
 #include "NetworkSocket.h"
 #include "NetworkQueue.h"
 #include "NetworkClient.h"
+#include "SocketRing.h"
 
 class UDP;
 
@@ -38,6 +39,12 @@ class UDP;
  *
  * UDP sockets accept payloads to send when writing
  * and read payloads when receiving payloads.
+ *
+ * Optionally, received payloads are written directly into a SocketRing in
+ * memory shared with the client, instead of queueing them for reading.
+ *
+ * The headers of sent datagrams are kept as a template, such that repeated
+ * sends to the same destination skip the address lookup and header construction.
  */
 class UDPSocket : public NetworkSocket
 {
@@ -62,6 +69,13 @@ class UDPSocket : public NetworkSocket
      */
     const u16 getPort() const;
 
+    /**
+     * Check if the port may be shared with other sockets.
+     *
+     * @return True if other sockets with this option may bind the same port
+     */
+    bool isReusePort() const;
+
     /**
      * Receive UDP data
      *
@@ -108,6 +122,66 @@ class UDPSocket : public NetworkSocket
      */
     virtual FileSystem::Result process(const NetworkQueue::Packet *pkt);
 
+  private:
+
+    /**
+     * Send a batch of datagrams
+     *
+     * @param buffer Input/Output buffer with the SocketInfo and BatchPacket array
+     * @param size Number of bytes in the buffer on input.
+     *             On output, the number of bytes for the datagrams sent.
+     * @param dest Default destination for datagrams without an address
+     *
+     * @return Result code
+     */
+    FileSystem::Result sendBatch(IOBuffer & buffer,
+                                 Size & size,
+                                 const NetworkClient::SocketInfo & dest);
+
+    /**
+     * Receive all queued datagrams which fit in the buffer
+     *
+     * @param buffer Input/Output buffer to output DatagramRecords and payloads to
+     * @param size Maximum number of bytes to read on input.
+     *             On output, the actual number of bytes read.
+     *
+     * @return Result code
+     */
+    FileSystem::Result readCoalesced(IOBuffer & buffer,
+                                     Size & size);
+
+    /**
+     * Receive a batch of datagrams
+     *
+     * @param buffer Input/Output buffer with the SocketInfo and BatchPacket array
+     * @param size Number of bytes in the buffer on input.
+     *             On output, the number of bytes for the datagrams received.
+     *
+     * @return Result code
+     */
+    FileSystem::Result receiveBatch(IOBuffer & buffer,
+                                    Size & size);
+
+    /**
+     * Receive datagrams in memory shared with the client
+     *
+     * @param pid Process which created the shared memory
+     * @param tagId Tag of the shared memory
+     *
+     * @return Result code
+     */
+    FileSystem::Result mapReceiveRing(const ProcessID pid,
+                                      const Size tagId);
+
+    /**
+     * Write the payload of a datagram to the receive ring
+     *
+     * @param pkt Packet with the datagram
+     *
+     * @return Result code
+     */
+    FileSystem::Result pushRing(const NetworkQueue::Packet *pkt);
+
   private:
 
     /** UDP protocol instance */
@@ -116,8 +190,23 @@ class UDPSocket : public NetworkSocket
     /** Local port */
     u16 m_port;
 
+    /** True if the port may be shared with other sockets */
+    bool m_reusePort;
+
+    /** True if a read returns all queued datagrams which fit */
+    bool m_coalesce;
+
     /** Incoming packet queue */
     NetworkQueue m_queue;
+
+    /** Prebuilt headers for the last destination */
+    IPV4::HeaderTemplate m_template;
+
+    /** Shared memory of the receive ring, if any */
+    ProcessShares::MemoryShare m_ringShare;
+
+    /** Incoming datagrams in memory shared with the client */
+    SocketRing m_ring;
 };
 
 /**
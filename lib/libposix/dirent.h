@@ -93,7 +93,7 @@ struct dirent
  */
 typedef struct DIR
 {
-    /** File descriptor returned by opendir(). */
+    /** File descriptor returned by opendir(), or -1 if not opened. */
     int fd;
 
     /** Input buffer. */
@@ -21,8 +21,11 @@
 
 int closedir(DIR *dirp)
 {
-    // Close file handle
-    close(dirp->fd);
+    // Close file handle, if any
+    if (dirp->fd >= 0)
+    {
+        close(dirp->fd);
+    }
 
     // Free buffers
     delete dirp->buffer;
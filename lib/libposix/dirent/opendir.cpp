@@ -17,57 +17,56 @@
 
 #include <FreeNOS/User.h>
 #include <FileSystem.h>
+#include <FileSystemClient.h>
 #include <Directory.h>
 #include <errno.h>
 #include "dirent.h"
-#include "fcntl.h"
-#include "unistd.h"
-#include "sys/stat.h"
+#include "string.h"
 
 DIR * opendir(const char *dirname)
 {
+    const FileSystemClient filesystem;
+    Size count = 1024;
     Dirent *dirent;
     DIR *dir;
-    int fd;
-    struct stat st;
-    Error e;
 
-    // First stat the directory
-    if (stat(dirname, &st) < 0)
-    {
-        return (ZERO);
-    }
+    // Allocate Dirents
+    dirent = new Dirent[count];
 
-    // Try to open the directory
-    if ((fd = open(dirname, ZERO)) < 0)
+    // Read them all, in packed form
+    const FileSystem::Result result = filesystem.readDirectory(dirname, dirent, ZERO, count);
+    switch (result)
     {
-        return (ZERO);
-    }
+        case FileSystem::Success:
+            break;
 
-    // Allocate Dirents
-    dirent = new Dirent[1024];
-    memset(dirent, 0, 1024 * sizeof(Dirent));
+        case FileSystem::NotFound:
+            delete[] dirent;
+            errno = ENOENT;
+            return (ZERO);
+
+        case FileSystem::NotSupported:
+            delete[] dirent;
+            errno = ENOTDIR;
+            return (ZERO);
+
+        default:
+            delete[] dirent;
+            errno = EIO;
+            return (ZERO);
+    }
 
     // Allocate DIR object
     dir = new DIR;
-    dir->fd        = fd;
+    dir->fd        = -1;
     dir->buffer    = new struct dirent[1024];
     memset(dir->buffer, 0, 1024 * sizeof(struct dirent));
     dir->current   = 0;
     dir->count     = 0;
     dir->eof       = false;
 
-    // Read them all
-    if ((e = read(fd, dirent, sizeof(Dirent) * 1024)) < 0)
-    {
-        e = errno;
-        closedir(dir);
-        errno = e;
-        return (ZERO);
-    }
-
     // Fill in the dirent structs
-    for (Size i = 0; i < e / sizeof(Dirent); i++)
+    for (Size i = 0; i < count; i++)
     {
         u8 types[] =
         {
@@ -78,12 +77,13 @@ DIR * opendir(const char *dirname)
             DT_LNK,
             DT_FIFO,
             DT_SOCK,
+            DT_UNKNOWN,
         };
         strlcpy((dir->buffer)[i].d_name, dirent[i].name, DIRLEN);
         (dir->buffer)[i].d_type = types[dirent[i].type];
     }
-    dir->count = e / sizeof(Dirent);
-    delete dirent;
+    dir->count = count;
+    delete[] dirent;
 
     // Set errno
     errno = ESUCCESS;
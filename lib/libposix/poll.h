@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBPOSIX_POLL_H
+#define __LIB_LIBPOSIX_POLL_H
+
+#include <Macros.h>
+#include "sys/types.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libposix
+ * @{
+ */
+
+/**
+ * @name Poll event flags
+ * @{
+ */
+
+/** Data other than high-priority data may be read without blocking. */
+#define POLLIN      (1 << 0)
+
+/** Normal data may be read without blocking. */
+#define POLLRDNORM  (1 << 1)
+
+/** Normal data may be written without blocking. */
+#define POLLOUT     (1 << 2)
+
+/** Equivalent to POLLOUT. */
+#define POLLWRNORM  POLLOUT
+
+/** An error has occurred (only in revents). */
+#define POLLERR     (1 << 3)
+
+/** Device has been disconnected (only in revents). */
+#define POLLHUP     (1 << 4)
+
+/** Invalid file descriptor (only in revents). */
+#define POLLNVAL    (1 << 5)
+
+/**
+ * @}
+ */
+
+/**
+ * Type for the number of file descriptors to poll.
+ */
+typedef unsigned int nfds_t;
+
+/**
+ * Describes a file descriptor to poll.
+ */
+struct pollfd
+{
+    /** File descriptor, or negative to ignore the entry. */
+    int fd;
+
+    /** Requested events. */
+    short events;
+
+    /** Returned events. */
+    short revents;
+};
+
+/**
+ * Wait until any of the given file descriptors is ready.
+ *
+ * The file descriptors may belong to different file systems. A timeout of
+ * zero checks the file descriptors with the shortest wait of one timer tick.
+ *
+ * @param fds Array of pollfd structures.
+ * @param nfds Number of entries in the array.
+ * @param timeout Timeout in milliseconds, or negative for infinite wait.
+ *
+ * @return Number of entries with returned events, zero on timeout,
+ *         or -1 and errno set on failure.
+ */
+extern C int poll(struct pollfd fds[], nfds_t nfds, int timeout);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBPOSIX_POLL_H */
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FileSystemClient.h>
+#include <FileDescriptor.h>
+#include "errno.h"
+#include "poll.h"
+
+extern C int poll(struct pollfd fds[], nfds_t nfds, int timeout)
+{
+    const FileSystemClient filesystem;
+    FileSystem::WaitDescriptor waitSet[FileSystemClient::MaximumWaitDescriptors];
+    Size index[FileSystemClient::MaximumWaitDescriptors];
+    Size count = 0;
+    int ready = 0;
+
+    if (nfds > FileSystemClient::MaximumWaitDescriptors)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Convert the requested events, and report invalid descriptors immediately
+    for (Size i = 0; i < nfds; i++)
+    {
+        fds[i].revents = 0;
+
+        if (fds[i].fd < 0)
+            continue;
+
+        const FileDescriptor::Entry *fd = FileDescriptor::instance()->getEntry(fds[i].fd);
+        if (!fd || !fd->open)
+        {
+            fds[i].revents = POLLNVAL;
+            ready++;
+            continue;
+        }
+
+        waitSet[count].fd        = fds[i].fd;
+        waitSet[count].requested = 0;
+        waitSet[count].current   = 0;
+
+        if (fds[i].events & (POLLIN | POLLRDNORM))
+            waitSet[count].requested |= FileSystem::Readable;
+
+        if (fds[i].events & POLLOUT)
+            waitSet[count].requested |= FileSystem::Writable;
+
+        index[count++] = i;
+    }
+
+    if (ready > 0 || count == 0)
+    {
+        return ready;
+    }
+
+    // Wait until any of the files is ready
+    const FileSystem::Result result = filesystem.waitDescriptors(waitSet, count,
+                                                                 timeout < 0 ? 0 :
+                                                                 timeout == 0 ? 1 : timeout);
+    switch (result)
+    {
+        case FileSystem::Success:
+            break;
+
+        case FileSystem::TimedOut:
+            return 0;
+
+        default:
+            errno = EIO;
+            return -1;
+    }
+
+    // Convert the returned events
+    for (Size i = 0; i < count; i++)
+    {
+        struct pollfd *pfd = &fds[index[i]];
+
+        if (waitSet[i].current & FileSystem::Readable)
+            pfd->revents |= pfd->events & (POLLIN | POLLRDNORM);
+
+        if (waitSet[i].current & FileSystem::Writable)
+            pfd->revents |= POLLOUT;
+
+        if (pfd->revents)
+            ready++;
+    }
+
+    return ready;
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBPOSIX_PTHREAD_H
+#define __LIBPOSIX_PTHREAD_H
+
+#include <Macros.h>
+#include <Types.h>
+#include "sys/types.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libposix
+ * @{
+ */
+
+/** Maximum number of threads created with pthread_create() per process. */
+#define PTHREAD_THREADS_MAX 64
+
+/** Size of the stack of each thread in bytes. */
+#define PTHREAD_STACK_SIZE  (PAGESIZE * 16)
+
+/** Static initializer for a pthread_mutex_t. */
+#define PTHREAD_MUTEX_INITIALIZER { 0 }
+
+/** Thread identifier, which is the ProcessID of the thread. */
+typedef pid_t pthread_t;
+
+/**
+ * Thread attributes. Currently unused.
+ */
+typedef struct pthread_attr
+{
+    /** Reserved. */
+    int reserved;
+}
+pthread_attr_t;
+
+/**
+ * Mutex attributes. Currently unused.
+ */
+typedef struct pthread_mutexattr
+{
+    /** Reserved. */
+    int reserved;
+}
+pthread_mutexattr_t;
+
+/**
+ * Mutual exclusion lock, which blocks on a futex when contended.
+ */
+typedef struct pthread_mutex
+{
+    /** Zero if unlocked, one if locked and two if locked with waiters. */
+    volatile u32 value;
+}
+pthread_mutex_t;
+
+/**
+ * Create a new thread.
+ *
+ * The thread shares the address space of the calling process and
+ * starts executing start_routine with arg as its sole argument.
+ *
+ * @param thread Receives the identifier of the new thread.
+ * @param attr Thread attributes, ignored.
+ * @param start_routine Entry point of the thread.
+ * @param arg Argument for start_routine.
+ *
+ * @return Zero on success, or an error number on failure.
+ *
+ * @note The heap and the IPC clients of the runtime are not thread-safe.
+ *       Callers must serialize access to such shared state with a mutex.
+ */
+extern C int pthread_create(pthread_t *thread, const pthread_attr_t *attr,
+                            void *(*start_routine)(void *), void *arg);
+
+/**
+ * Wait for termination of a thread.
+ *
+ * @param thread Thread to wait for.
+ * @param value_ptr Receives the exit value of the thread, if not NULL.
+ *
+ * @return Zero on success, or an error number on failure.
+ */
+extern C int pthread_join(pthread_t thread, void **value_ptr);
+
+/**
+ * Terminate the calling thread.
+ *
+ * When called from the initial thread, the whole process terminates.
+ *
+ * @param value_ptr Exit value for pthread_join().
+ */
+extern C void pthread_exit(void *value_ptr);
+
+/**
+ * Get the identifier of the calling thread.
+ *
+ * @return Thread identifier.
+ */
+extern C pthread_t pthread_self(void);
+
+/**
+ * Initialize a mutex.
+ *
+ * @param mutex Mutex to initialize.
+ * @param attr Mutex attributes, ignored.
+ *
+ * @return Zero on success, or an error number on failure.
+ */
+extern C int pthread_mutex_init(pthread_mutex_t *mutex, const pthread_mutexattr_t *attr);
+
+/**
+ * Destroy a mutex.
+ *
+ * @param mutex Mutex to destroy.
+ *
+ * @return Zero on success, or EBUSY if the mutex is locked.
+ */
+extern C int pthread_mutex_destroy(pthread_mutex_t *mutex);
+
+/**
+ * Lock a mutex, sleeping until it becomes available.
+ *
+ * @param mutex Mutex to lock.
+ *
+ * @return Zero on success, or an error number on failure.
+ */
+extern C int pthread_mutex_lock(pthread_mutex_t *mutex);
+
+/**
+ * Lock a mutex if it is available.
+ *
+ * @param mutex Mutex to lock.
+ *
+ * @return Zero on success, or EBUSY if the mutex is locked.
+ */
+extern C int pthread_mutex_trylock(pthread_mutex_t *mutex);
+
+/**
+ * Unlock a mutex and wakeup one waiter, if any.
+ *
+ * @param mutex Mutex to unlock.
+ *
+ * @return Zero on success, or an error number on failure.
+ */
+extern C int pthread_mutex_unlock(pthread_mutex_t *mutex);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBPOSIX_PTHREAD_H */
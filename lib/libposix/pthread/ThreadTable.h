@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBPOSIX_PTHREAD_THREADTABLE_H
+#define __LIBPOSIX_PTHREAD_THREADTABLE_H
+
+#include <Types.h>
+#include <Memory.h>
+#include "pthread.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libposix
+ * @{
+ */
+
+/**
+ * Administration of a thread created with pthread_create().
+ */
+typedef struct ThreadEntry
+{
+    /** True if the entry is in use. */
+    bool used;
+
+    /** True if the thread called pthread_exit(). */
+    bool finished;
+
+    /** Thread identifier. */
+    pthread_t id;
+
+    /** Entry point of the thread. */
+    void *(*start)(void *);
+
+    /** Argument for the entry point. */
+    void *arg;
+
+    /** Exit value of the thread. */
+    void *result;
+
+    /** Stack memory of the thread. */
+    Memory::Range stack;
+}
+ThreadEntry;
+
+/** Threads created by this process. */
+extern ThreadEntry threadTable[PTHREAD_THREADS_MAX];
+
+/** Protects the thread table. */
+extern pthread_mutex_t threadTableLock;
+
+/**
+ * Find the entry of a thread.
+ *
+ * @param id Thread identifier.
+ *
+ * @return ThreadEntry pointer or ZERO if not found.
+ * @note The caller must hold the threadTableLock.
+ */
+extern ThreadEntry * findThread(const pthread_t id);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBPOSIX_PTHREAD_THREADTABLE_H */
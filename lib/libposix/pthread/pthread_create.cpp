@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include "pthread.h"
+#include "errno.h"
+#include "ThreadTable.h"
+
+/**
+ * Entry point of all threads.
+ *
+ * @param arg ThreadEntry of the new thread
+ */
+static void threadStart(void *arg)
+{
+    ThreadEntry *entry = (ThreadEntry *) arg;
+
+    // The creator may not have stored the identifier yet
+    entry->id = ProcessCtl(SELF, GetPID);
+
+    pthread_exit(entry->start(entry->arg));
+}
+
+int pthread_create(pthread_t *thread, const pthread_attr_t *attr,
+                   void *(*start_routine)(void *), void *arg)
+{
+    ThreadEntry *entry = ZERO;
+    ThreadInfo info;
+
+    // Claim a free entry in the thread table
+    pthread_mutex_lock(&threadTableLock);
+
+    for (Size i = 0; i < PTHREAD_THREADS_MAX; i++)
+    {
+        if (!threadTable[i].used)
+        {
+            entry = &threadTable[i];
+            entry->used = true;
+            entry->finished = false;
+            entry->id = ANY;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&threadTableLock);
+
+    if (!entry)
+        return EAGAIN;
+
+    entry->start  = start_routine;
+    entry->arg    = arg;
+    entry->result = ZERO;
+
+    // Allocate the stack
+    entry->stack.virt   = 0;
+    entry->stack.phys   = 0;
+    entry->stack.size   = PTHREAD_STACK_SIZE;
+    entry->stack.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    if (VMCtl(SELF, MapContiguous, &entry->stack) != API::Success)
+    {
+        entry->used = false;
+        return ENOMEM;
+    }
+
+    // Store the argument also on the stack, below a zero return address
+    Address *stack = (Address *) (entry->stack.virt + entry->stack.size) - 4;
+    stack[0] = 0;
+    stack[1] = (Address) entry;
+
+    info.entry    = (Address) threadStart;
+    info.stack    = (Address) stack;
+    info.argument = (Address) entry;
+
+    const ulong result = (ulong) ProcessCtl(SELF, SpawnThread, (Address) &info);
+    if ((result & 0xffff) != API::Success)
+    {
+        VMCtl(SELF, Release, &entry->stack);
+        entry->used = false;
+        return EAGAIN;
+    }
+
+    entry->id = result >> 16;
+
+    if (thread)
+        *thread = entry->id;
+
+    return 0;
+}
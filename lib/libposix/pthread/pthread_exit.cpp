@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include "pthread.h"
+#include "ThreadTable.h"
+
+void pthread_exit(void *value_ptr)
+{
+    pthread_mutex_lock(&threadTableLock);
+    ThreadEntry *entry = findThread(ProcessCtl(SELF, GetPID));
+
+    if (entry)
+    {
+        entry->result = value_ptr;
+        entry->finished = true;
+    }
+
+    pthread_mutex_unlock(&threadTableLock);
+
+    // Removes only this thread, or the whole process for the initial thread
+    for (;;)
+        ProcessCtl(SELF, KillPID, 0);
+}
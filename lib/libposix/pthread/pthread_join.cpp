@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include "pthread.h"
+#include "errno.h"
+#include "sys/wait.h"
+#include "ThreadTable.h"
+
+int pthread_join(pthread_t thread, void **value_ptr)
+{
+    int status;
+
+    pthread_mutex_lock(&threadTableLock);
+    ThreadEntry *entry = findThread(thread);
+    pthread_mutex_unlock(&threadTableLock);
+
+    if (!entry)
+        return ESRCH;
+
+    // The thread may already have been removed by the kernel
+    if (waitpid(thread, &status, 0) == (pid_t) -1 && !entry->finished)
+        return ESRCH;
+
+    if (value_ptr)
+        *value_ptr = entry->result;
+
+    VMCtl(SELF, Release, &entry->stack);
+
+    pthread_mutex_lock(&threadTableLock);
+    entry->used = false;
+    pthread_mutex_unlock(&threadTableLock);
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include "pthread.h"
+#include "errno.h"
+
+int pthread_mutex_init(pthread_mutex_t *mutex, const pthread_mutexattr_t *attr)
+{
+    mutex->value = 0;
+    return 0;
+}
+
+int pthread_mutex_destroy(pthread_mutex_t *mutex)
+{
+    return mutex->value != 0 ? EBUSY : 0;
+}
+
+int pthread_mutex_lock(pthread_mutex_t *mutex)
+{
+    // Uncontended case: no system call needed
+    u32 value = __sync_val_compare_and_swap(&mutex->value, 0, 1);
+
+    if (value != 0)
+    {
+        // Mark the mutex contended and sleep until it is released
+        if (value != 2)
+            value = __sync_lock_test_and_set(&mutex->value, 2);
+
+        while (value != 0)
+        {
+            ProcessCtl(SELF, FutexWait, (Address) &mutex->value, 2);
+            value = __sync_lock_test_and_set(&mutex->value, 2);
+        }
+    }
+
+    return 0;
+}
+
+int pthread_mutex_trylock(pthread_mutex_t *mutex)
+{
+    return __sync_val_compare_and_swap(&mutex->value, 0, 1) == 0 ? 0 : EBUSY;
+}
+
+int pthread_mutex_unlock(pthread_mutex_t *mutex)
+{
+    // Only wakeup a waiter if the mutex was contended
+    if (__sync_fetch_and_sub(&mutex->value, 1) != 1)
+    {
+        __sync_lock_release(&mutex->value);
+        ProcessCtl(SELF, FutexWake, (Address) &mutex->value, 1);
+    }
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBPOSIX_SCHED_H
+#define __LIB_LIBPOSIX_SCHED_H
+
+#include <Macros.h>
+#include "sys/types.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libposix
+ * @{
+ */
+
+/** Maximum number of processor cores in a cpu_set_t. */
+#define CPU_SETSIZE 32
+
+/**
+ * Set of processor cores.
+ */
+typedef struct cpu_set
+{
+    /** One bit per core identifier. */
+    unsigned long bits;
+}
+cpu_set_t;
+
+/** Remove all cores from the set. */
+#define CPU_ZERO(set)       ((set)->bits = 0)
+
+/** Add a core to the set. */
+#define CPU_SET(cpu, set)   ((set)->bits |= (1UL << (cpu)))
+
+/** Remove a core from the set. */
+#define CPU_CLR(cpu, set)   ((set)->bits &= ~(1UL << (cpu)))
+
+/** Test whether a core is in the set. */
+#define CPU_ISSET(cpu, set) (((set)->bits & (1UL << (cpu))) != 0)
+
+/**
+ * Get the processor cores on which a process may run.
+ *
+ * Processes never migrate between cores, thus the set contains
+ * exactly the core on which the process was created.
+ *
+ * @param pid Process to query, or zero for the calling process.
+ * @param cpusetsize Size of the set in bytes.
+ * @param mask Output set of processor cores.
+ *
+ * @return Zero on success, or -1 and errno set on failure.
+ */
+extern C int sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t *mask);
+
+/**
+ * Set the processor cores on which a process may run.
+ *
+ * Since processes cannot migrate, this only succeeds when the
+ * set contains the core on which the process currently runs.
+ * To place a new process on a given set of cores, pass the
+ * mask to CoreClient::createProcess instead.
+ *
+ * @param pid Process to change, or zero for the calling process.
+ * @param cpusetsize Size of the set in bytes.
+ * @param mask Set of processor cores.
+ *
+ * @return Zero on success, or -1 and errno set on failure.
+ */
+extern C int sched_setaffinity(pid_t pid, size_t cpusetsize, const cpu_set_t *mask);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBPOSIX_SCHED_H */
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include "sched.h"
+#include "errno.h"
+
+int sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t *mask)
+{
+    ProcessInfo info;
+
+    if (!mask || cpusetsize < sizeof(cpu_set_t))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // All visible processes run on the same core as we do
+    if (ProcessCtl(pid ? pid : SELF, InfoPID, (Address) &info) != API::Success)
+    {
+        errno = ESRCH;
+        return -1;
+    }
+
+    const SystemInformation sysInfo;
+
+    if (sysInfo.coreId >= CPU_SETSIZE)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    CPU_ZERO(mask);
+    CPU_SET(sysInfo.coreId, mask);
+    return 0;
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sched.h"
+#include "errno.h"
+
+int sched_setaffinity(pid_t pid, size_t cpusetsize, const cpu_set_t *mask)
+{
+    cpu_set_t current;
+
+    if (!mask || cpusetsize < sizeof(cpu_set_t))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (sched_getaffinity(pid, sizeof(current), &current) != 0)
+    {
+        return -1;
+    }
+
+    // The process cannot move away from its current core
+    if ((mask->bits & current.bits) == 0)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    return 0;
+}
@@ -54,6 +54,21 @@
  * @{
  */
 
+/** End-of-file return value. */
+#define EOF             (-1)
+
+/** Size of automatically allocated stream buffers. */
+#define BUFSIZ          1024
+
+/** Fully buffered stream. */
+#define _IOFBF          0
+
+/** Line buffered stream. */
+#define _IOLBF          1
+
+/** Unbuffered stream. */
+#define _IONBF          2
+
 /**
  * A structure containing information about a file.
  */
@@ -61,9 +76,39 @@ typedef struct FILE
 {
     /** File descriptor. */
     int fd;
+
+    /** Buffering mode: _IOFBF, _IOLBF or _IONBF. */
+    int mode;
+
+    /** Stream state flags. */
+    int flags;
+
+    /** Buffer memory or NULL if not yet allocated. */
+    char *buffer;
+
+    /** Size of the buffer in bytes. */
+    size_t size;
+
+    /** Number of bytes in the buffer. */
+    size_t count;
+
+    /** Position of the next unread byte in the buffer. */
+    size_t position;
+
+    /** Next stream opened with fopen(). */
+    struct FILE *next;
 }
 FILE;
 
+/** Standard input stream. */
+extern C FILE *stdin;
+
+/** Standard output stream. */
+extern C FILE *stdout;
+
+/** Standard error stream. */
+extern C FILE *stderr;
+
 /**
  * @brief Open a stream.
  *
@@ -164,6 +209,42 @@ extern C size_t fwrite(const void *ptr, size_t size,
  */
 extern C int fclose(FILE *stream);
 
+/**
+ * @brief Flush a stream.
+ *
+ * If stream points to an output stream, fflush() shall cause any
+ * unwritten data for that stream to be written to the file.
+ * If stream is a null pointer, fflush() shall perform this
+ * flushing action on all streams.
+ *
+ * @param stream File stream to flush or NULL for all streams.
+ *
+ * @return Upon successful completion, fflush() shall return 0;
+ *         otherwise, it shall return EOF and set errno to indicate the error.
+ */
+extern C int fflush(FILE *stream);
+
+/**
+ * @brief Assign buffering to a stream.
+ *
+ * The setvbuf() function may be used after the stream pointed to by
+ * stream is associated with an open file but before any other operation.
+ * The type determines how the stream is buffered: _IOFBF for full
+ * buffering, _IOLBF for line buffering and _IONBF for no buffering.
+ * If buf is not a null pointer, the array it points to is used
+ * instead of a buffer allocated by setvbuf().
+ *
+ * @param stream File stream to change.
+ * @param buf Buffer to use or NULL to allocate one.
+ * @param type Buffering mode.
+ * @param size Size of the buffer in bytes.
+ *
+ * @return Upon successful completion, setvbuf() shall return 0.
+ *         Otherwise, it shall return a non-zero value if an invalid
+ *         value is given for type or if the request cannot be honored.
+ */
+extern C int setvbuf(FILE *stream, char *buf, int type, size_t size);
+
 /**
  * @}
  */
@@ -183,25 +264,47 @@ extern C int fclose(FILE *stream);
  * Write a formatted string into a buffer.
  *
  * @param buffer String buffer to write to.
- * @param size Maximum number of bytes to write.
+ * @param size Size of the buffer, including the terminating ZERO byte.
  * @param fmt Formatted string.
  * @param ... Argument list.
  *
- * @return Number of bytes written to the buffer.
+ * @return Number of bytes written to the buffer, excluding the terminating ZERO byte.
  */
-extern C int snprintf(char *buffer, unsigned int size, const char *fmt, ...);
+extern C int snprintf(char *buffer, unsigned int size, const char *fmt, ...) FORMAT(3, 4);
 
 /**
  * Write a formatted string into a buffer.
  *
  * @param buffer String buffer to write to.
- * @param size Maximum number of bytes to write.
+ * @param size Size of the buffer, including the terminating ZERO byte.
  * @param fmt Formatted string.
  * @param args Argument list.
  *
- * @return Number of bytes written to the buffer.
+ * @return Number of bytes written to the buffer, excluding the terminating ZERO byte.
+ */
+extern C int vsnprintf(char *buffer, unsigned int size, const char *fmt, va_list args) FORMAT(3, 0);
+
+/**
+ * Output a formatted string to a stream.
+ *
+ * @param stream File stream to write to.
+ * @param format Formatted string.
+ * @param ... Argument list.
+ *
+ * @return Number of bytes written or error code on failure.
+ */
+extern C int fprintf(FILE *stream, const char *format, ...) FORMAT(2, 3);
+
+/**
+ * Output a formatted string to a stream, using a variable argument list.
+ *
+ * @param stream File stream to write to.
+ * @param format Formatted string.
+ * @param args Argument list.
+ *
+ * @return Number of bytes written or error code on failure.
  */
-extern C int vsnprintf(char *buffer, unsigned int size, const char *fmt, va_list args);
+extern C int vfprintf(FILE *stream, const char *format, va_list args) FORMAT(2, 0);
 
 /**
  * Output a formatted string to standard output.
@@ -211,7 +314,7 @@ extern C int vsnprintf(char *buffer, unsigned int size, const char *fmt, va_list
  *
  * @return Number of bytes written or error code on failure.
  */
-extern C int printf(const char *format, ...);
+extern C int printf(const char *format, ...) FORMAT(1, 2);
 
 /**
  * Output a formatted string to standard output, using a variable argument list.
@@ -221,7 +324,7 @@ extern C int printf(const char *format, ...);
  *
  * @return Number of bytes written or error code on failure.
  */
-extern C int vprintf(const char *format, va_list args);
+extern C int vprintf(const char *format, va_list args) FORMAT(1, 0);
 
 /**
  * @}
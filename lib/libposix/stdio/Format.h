@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBPOSIX_STDIO_FORMAT_H
+#define __LIBPOSIX_STDIO_FORMAT_H
+
+#include "stdarg.h"
+#include "stdio.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libposix
+ * @{
+ */
+
+/**
+ * Destination of formatted output.
+ *
+ * Characters are written directly into the buffer. When it is full,
+ * the flush function is called to make room. Without a flush function,
+ * the remaining output is discarded.
+ */
+typedef struct FormatOutput
+{
+    /** Buffer to write characters to. */
+    char *buffer;
+
+    /** Size of the buffer in bytes. */
+    size_t size;
+
+    /** Number of characters in the buffer. */
+    size_t count;
+
+    /** Total number of characters stored, including flushed characters. */
+    size_t total;
+
+    /** True if the flush function failed. */
+    bool error;
+
+    /**
+     * Make room in a full buffer.
+     *
+     * @param out Output to flush, which must reset its buffer, size and count.
+     *
+     * @return True on success, false on failure.
+     */
+    bool (*flush)(struct FormatOutput *out);
+
+    /** Argument for the flush function. */
+    void *context;
+}
+FormatOutput;
+
+/**
+ * Format a string in a single pass.
+ *
+ * Supports the conversions %d, %i, %u, %x, %p, %c, %s and %%, the length
+ * modifiers l and ll, and the flags 0 and -. A field width pads the value
+ * with spaces after it and truncates longer strings and characters.
+ * The 0 flag pads numbers with zeros before them instead. Hexadecimal
+ * numbers have a 0x prefix.
+ *
+ * @param out Destination of the formatted output.
+ * @param format Formatted string.
+ * @param args Argument list.
+ *
+ * @return Number of characters stored.
+ */
+extern size_t formatOutput(FormatOutput *out, const char *format, va_list args);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBPOSIX_STDIO_FORMAT_H */
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBPOSIX_STDIO_STREAM_H
+#define __LIBPOSIX_STDIO_STREAM_H
+
+#include "stdio.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libposix
+ * @{
+ */
+
+/**
+ * Stream state flags.
+ */
+enum StreamFlags
+{
+    StreamReading   = (1 << 0), /**< Buffer holds data read from the file */
+    StreamWriting   = (1 << 1), /**< Buffer holds data to write to the file */
+    StreamOwnBuffer = (1 << 2), /**< Buffer was allocated by the stream */
+    StreamError     = (1 << 3), /**< A read or write error occurred */
+    StreamEnd       = (1 << 4)  /**< End-of-file was reached */
+};
+
+/** First stream opened with fopen(). */
+extern FILE *openStreams;
+
+/**
+ * Initialize a stream.
+ *
+ * @param stream Stream to initialize.
+ * @param fd File descriptor of the stream.
+ * @param mode Buffering mode.
+ */
+extern void initStream(FILE *stream, const int fd, const int mode);
+
+/**
+ * Allocate the buffer of a stream, if needed.
+ *
+ * @param stream Stream to allocate the buffer for.
+ *
+ * @return True if the stream has a buffer, false if it is unbuffered.
+ */
+extern bool allocateStreamBuffer(FILE *stream);
+
+/**
+ * Write out the pending data of a stream.
+ *
+ * @param stream Stream to flush.
+ *
+ * @return Zero on success or EOF on failure.
+ */
+extern int flushStream(FILE *stream);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBPOSIX_STDIO_STREAM_H */
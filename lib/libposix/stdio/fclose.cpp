@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009 Niek Linnenbank
+ * Copyright (C) 2026 Niek Linnenbank
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -19,13 +19,32 @@
 #include "stdio.h"
 #include "stdlib.h"
 #include "errno.h"
+#include "Stream.h"
 
 int fclose(FILE *stream)
 {
+    // Write out pending data
+    const int result = flushStream(stream);
+
+    // Remove from the list of open streams
+    for (FILE **f = &openStreams; *f; f = &(*f)->next)
+    {
+        if (*f == stream)
+        {
+            *f = stream->next;
+            break;
+        }
+    }
+
     // Close and free
     close(stream->fd);
+    if (stream->flags & StreamOwnBuffer)
+        free(stream->buffer);
     free(stream);
 
+    if (result != 0)
+        return EOF;
+
     // Success
     errno = 0;
     return 0;
@@ -20,6 +20,8 @@
 #include "stdio.h"
 #include "stdlib.h"
 #include "errno.h"
+#include "unistd.h"
+#include "Stream.h"
 
 FILE * fopen(const char *filename,
              const char *mode)
@@ -31,9 +33,25 @@ FILE * fopen(const char *filename,
     {
         // Read
         case 'r':
+        {
+            const int fd = open(filename, ZERO);
+            if (fd < 0)
+                return (FILE *) NULL;
+
             f = (FILE *) malloc(sizeof(FILE));
-            f->fd = open(filename, ZERO);
+            if (!f)
+            {
+                close(fd);
+                errno = ENOMEM;
+                return (FILE *) NULL;
+            }
+
+            // Files are fully buffered
+            initStream(f, fd, _IOFBF);
+            f->next = openStreams;
+            openStreams = f;
             return f;
+        }
 
         // Unsupported
         default:
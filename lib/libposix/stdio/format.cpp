@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include <String.h>
+#include "Format.h"
+
+/** Maximum length of a converted number including its prefix. */
+#define NUMBER_LENGTH 24
+
+/**
+ * Store characters in the output.
+ *
+ * @param out Destination of the output.
+ * @param data Characters to store or ZERO to store the fill character.
+ * @param fill Fill character.
+ * @param length Number of characters.
+ */
+static void store(FormatOutput *out, const char *data, const char fill, size_t length)
+{
+    while (length > 0)
+    {
+        // Make room if the buffer is full
+        if (out->count == out->size)
+        {
+            if (!out->flush || out->error)
+                return;
+
+            if (!out->flush(out))
+            {
+                out->error = true;
+                return;
+            }
+        }
+
+        const size_t room = out->size - out->count;
+        const size_t bytes = length < room ? length : room;
+
+        if (data)
+        {
+            MemoryBlock::copy(out->buffer + out->count, data, bytes);
+            data += bytes;
+        }
+        else
+        {
+            MemoryBlock::set(out->buffer + out->count, fill, bytes);
+        }
+
+        out->count += bytes;
+        out->total += bytes;
+        length -= bytes;
+    }
+}
+
+/**
+ * Store a converted number with its padding.
+ *
+ * @param out Destination of the output.
+ * @param prefix Sign and base prefix.
+ * @param digits First digit.
+ * @param end Position after the last digit.
+ * @param width Field width or zero if none.
+ * @param zero True to pad with zeros before the number.
+ */
+static void storeNumber(FormatOutput *out,
+                        const char *prefix,
+                        const char *digits,
+                        const char *end,
+                        const size_t width,
+                        const bool zero)
+{
+    const size_t prefixLength = String::length(prefix);
+    const size_t length = prefixLength + (end - digits);
+    const size_t padding = width > length ? width - length : 0;
+
+    store(out, prefix, 0, prefixLength);
+
+    if (zero)
+        store(out, ZERO, '0', padding);
+
+    store(out, digits, 0, end - digits);
+
+    if (!zero)
+        store(out, ZERO, ' ', padding);
+}
+
+size_t formatOutput(FormatOutput *out, const char *format, va_list args)
+{
+    const char *fmt = format;
+
+    while (*fmt)
+    {
+        // Store the text up to the next conversion at once
+        const char *text = fmt;
+
+        while (*fmt && *fmt != '%')
+            fmt++;
+
+        store(out, text, 0, fmt - text);
+
+        if (!*fmt++)
+            break;
+
+        // Flags
+        bool zero = false;
+
+        for (;; fmt++)
+        {
+            if (*fmt == '0')
+                zero = true;
+            else if (*fmt != '-')
+                break;
+        }
+
+        // Field width
+        size_t width = 0;
+        bool hasWidth = false;
+
+        for (; *fmt >= '0' && *fmt <= '9'; fmt++)
+        {
+            width = (width * 10) + (*fmt - '0');
+            hasWidth = true;
+        }
+
+        // Length modifiers
+        Size longs = 0;
+
+        for (; *fmt == 'l'; fmt++)
+            longs++;
+
+        char number[NUMBER_LENGTH];
+        char *end = number + sizeof(number);
+        const char *prefix = "";
+        u64 value;
+
+        switch (*fmt)
+        {
+            case 'd':
+            case 'i':
+            {
+                const s64 signedValue = longs >= 2 ? va_arg(args, long long) :
+                                        longs == 1 ? va_arg(args, long) :
+                                                     va_arg(args, int);
+                if (signedValue < 0)
+                {
+                    prefix = "-";
+                    value = -(u64) signedValue;
+                }
+                else
+                    value = signedValue;
+
+                storeNumber(out, prefix, String::formatNumber(value, Number::Dec, end),
+                            end, width, zero);
+                break;
+            }
+
+            case 'u':
+            case 'x':
+                value = longs >= 2 ? va_arg(args, unsigned long long) :
+                        longs == 1 ? va_arg(args, unsigned long) :
+                                     va_arg(args, unsigned int);
+
+                if (*fmt == 'x')
+                    prefix = "0x";
+
+                storeNumber(out, prefix,
+                            String::formatNumber(value, *fmt == 'x' ? Number::Hex : Number::Dec, end),
+                            end, width, zero);
+                break;
+
+            case 'p':
+                value = (Address) va_arg(args, void *);
+                storeNumber(out, "0x", String::formatNumber(value, Number::Hex, end),
+                            end, width, zero);
+                break;
+
+            case 'c':
+            {
+                const char ch = va_arg(args, int);
+
+                store(out, &ch, 0, 1);
+                store(out, ZERO, ' ', width > 1 ? width - 1 : 0);
+                break;
+            }
+
+            case 's':
+            {
+                const char *str = va_arg(args, const char *);
+                size_t length = 0;
+
+                if (!str)
+                    str = "(null)";
+
+                // A field width also limits the length of the string
+                while (str[length] && (!hasWidth || length < width))
+                    length++;
+
+                store(out, str, 0, length);
+                store(out, ZERO, ' ', hasWidth ? width - length : 0);
+                break;
+            }
+
+            case '%':
+                store(out, "%", 0, 1);
+                break;
+
+            // Unsupported conversions are stored as-is
+            default:
+                store(out, "%", 0, 1);
+
+                if (!*fmt)
+                    return out->total;
+
+                store(out, fmt, 0, 1);
+                break;
+        }
+        fmt++;
+    }
+
+    return out->total;
+}
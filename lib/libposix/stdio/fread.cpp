@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009 Niek Linnenbank
+ * Copyright (C) 2026 Niek Linnenbank
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -19,24 +19,66 @@
 #include <sys/types.h>
 #include "stdio.h"
 #include "stdlib.h"
+#include "string.h"
 #include "errno.h"
+#include "Stream.h"
 
 size_t fread(void *ptr, size_t size,
              size_t nitems, FILE *stream)
 {
-    size_t i;
+    const size_t total = size * nitems;
     char *buf = (char *) ptr;
+    size_t copied = 0;
 
-    // Read items
-    for (i = 0; i < nitems; i++)
+    if (total == 0)
+        return 0;
+
+    // Write out pending output first
+    if ((stream->flags & StreamWriting) && flushStream(stream) != 0)
+        return 0;
+
+    while (copied < total)
     {
-        ssize_t num = read(stream->fd, buf, size);
-        if (num < 0 || (size_t)num != size)
+        // Take data from the buffer first
+        if (stream->position < stream->count)
+        {
+            const size_t available = stream->count - stream->position;
+            const size_t bytes = available < total - copied ? available : total - copied;
+
+            memcpy(buf + copied, stream->buffer + stream->position, bytes);
+            stream->position += bytes;
+            copied += bytes;
+            continue;
+        }
+
+        // Read large requests and unbuffered streams directly,
+        // otherwise refill the buffer
+        const bool direct = !allocateStreamBuffer(stream) || total - copied >= stream->size;
+        const ssize_t num = direct ? read(stream->fd, buf + copied, total - copied)
+                                   : read(stream->fd, stream->buffer, stream->size);
+        if (num < 0)
+        {
+            stream->flags |= StreamError;
+            break;
+        }
+        else if (num == 0)
+        {
+            stream->flags |= StreamEnd;
             break;
+        }
 
-        buf += size;
+        if (direct)
+        {
+            copied += num;
+        }
+        else
+        {
+            stream->count    = num;
+            stream->position = 0;
+            stream->flags   |= StreamReading;
+        }
     }
 
     // Done
-    return i;
+    return copied / size;
 }
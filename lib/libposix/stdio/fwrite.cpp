@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009 Niek Linnenbank
+ * Copyright (C) 2026 Niek Linnenbank
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -19,24 +19,80 @@
 #include <sys/types.h>
 #include "stdio.h"
 #include "stdlib.h"
+#include "string.h"
 #include "errno.h"
+#include "Stream.h"
 
-size_t fwrite(const void *ptr, size_t size,
-              size_t nitems, FILE *stream)
+/**
+ * Write data to the file of a stream without buffering.
+ *
+ * @param stream Stream to write to.
+ * @param buf Data to write.
+ * @param size Number of bytes to write.
+ *
+ * @return Number of bytes written.
+ */
+static size_t writeDirect(FILE *stream, const char *buf, const size_t size)
 {
-    size_t i;
-    char *buf = (char *) ptr;
+    size_t written = 0;
 
-    // Write items
-    for (i = 0; i < nitems; i++)
+    while (written < size)
     {
-        ssize_t num = write(stream->fd, buf, size);
-        if (num < 0 || (size_t)num != size)
+        const ssize_t num = write(stream->fd, buf + written, size - written);
+        if (num <= 0)
+        {
+            stream->flags |= StreamError;
             break;
+        }
+        written += num;
+    }
+
+    return written;
+}
 
-        buf += size;
+size_t fwrite(const void *ptr, size_t size,
+              size_t nitems, FILE *stream)
+{
+    const size_t total = size * nitems;
+    const char *buf = (const char *) ptr;
+
+    if (total == 0)
+        return 0;
+
+    // Give back unread input first
+    if ((stream->flags & StreamReading) && flushStream(stream) != 0)
+        return 0;
+
+    // Unbuffered streams write the data at once
+    if (!allocateStreamBuffer(stream))
+        return writeDirect(stream, buf, total) / size;
+
+    // Make room in the buffer
+    if (stream->count + total > stream->size && flushStream(stream) != 0)
+        return 0;
+
+    // Data which does not fit in the buffer is written directly
+    if (total >= stream->size)
+        return writeDirect(stream, buf, total) / size;
+
+    memcpy(stream->buffer + stream->count, buf, total);
+    stream->count += total;
+    stream->flags |= StreamWriting;
+
+    // Line buffered streams are written out on each newline
+    if (stream->mode == _IOLBF)
+    {
+        for (size_t i = total; i > 0; i--)
+        {
+            if (buf[i - 1] == '\n')
+            {
+                if (flushStream(stream) != 0)
+                    return 0;
+                break;
+            }
+        }
     }
 
     // Done
-    return i;
+    return nitems;
 }
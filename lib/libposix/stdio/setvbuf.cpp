@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "errno.h"
+#include "Stream.h"
+
+int setvbuf(FILE *stream, char *buf, int type, size_t size)
+{
+    // Validate arguments
+    if ((type != _IOFBF && type != _IOLBF && type != _IONBF) ||
+        (type != _IONBF && buf && size == 0))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Write out pending data using the current buffer
+    if (flushStream(stream) != 0)
+        return -1;
+
+    // Release the current buffer
+    if (stream->flags & StreamOwnBuffer)
+    {
+        free(stream->buffer);
+        stream->flags &= ~StreamOwnBuffer;
+    }
+
+    // Assign the new buffer. Without a given buffer, one is allocated on first use
+    stream->mode     = type;
+    stream->buffer   = type != _IONBF ? buf : ZERO;
+    stream->size     = type != _IONBF ? size : 0;
+    stream->count    = 0;
+    stream->position = 0;
+    return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FileDescriptor.h>
+#include <unistd.h>
+#include "stdio.h"
+#include "stdlib.h"
+#include "errno.h"
+#include "Stream.h"
+
+/** Buffer of the standard output stream. */
+static char standardOutputBuffer[BUFSIZ];
+
+/**
+ * Standard stream objects.
+ *
+ * Standard output is line buffered. Standard input and error are unbuffered,
+ * since programs also read their input directly and errors must not be delayed.
+ * The streams are statically initialized, such that they can be used by
+ * constructors of other static objects.
+ */
+static FILE standardStreams[3] =
+{
+    { 0, _IONBF, 0, ZERO, 0, 0, 0, ZERO },
+    { 1, _IOLBF, 0, standardOutputBuffer, sizeof(standardOutputBuffer), 0, 0, ZERO },
+    { 2, _IONBF, 0, ZERO, 0, 0, 0, ZERO }
+};
+
+FILE *stdin  = &standardStreams[0];
+FILE *stdout = &standardStreams[1];
+FILE *stderr = &standardStreams[2];
+FILE *openStreams = ZERO;
+
+/**
+ * Write out pending output when the program terminates
+ */
+static void __attribute__((destructor)) cleanupStreams()
+{
+    fflush(ZERO);
+}
+
+void initStream(FILE *stream, const int fd, const int mode)
+{
+    stream->fd       = fd;
+    stream->mode     = mode;
+    stream->flags    = 0;
+    stream->buffer   = ZERO;
+    stream->size     = 0;
+    stream->count    = 0;
+    stream->position = 0;
+    stream->next     = ZERO;
+}
+
+bool allocateStreamBuffer(FILE *stream)
+{
+    if (stream->mode == _IONBF)
+        return false;
+
+    if (!stream->buffer)
+    {
+        const size_t size = stream->size ? stream->size : BUFSIZ;
+
+        stream->buffer = (char *) malloc(size);
+        if (!stream->buffer)
+        {
+            stream->mode = _IONBF;
+            return false;
+        }
+        stream->size   = size;
+        stream->flags |= StreamOwnBuffer;
+    }
+
+    return true;
+}
+
+int flushStream(FILE *stream)
+{
+    // Give back unread input by moving the file offset back
+    if (stream->flags & StreamReading)
+    {
+        FileDescriptor::Entry *fd = FileDescriptor::instance()->getEntry(stream->fd);
+        const size_t unread = stream->count - stream->position;
+
+        stream->flags &= ~StreamReading;
+        stream->count = stream->position = 0;
+
+        if (!fd || !fd->open)
+        {
+            errno = ENOENT;
+            return EOF;
+        }
+        fd->position -= unread;
+        return 0;
+    }
+
+    if (!(stream->flags & StreamWriting))
+        return 0;
+
+    // Take the pending data out of the buffer before writing, which
+    // prevents another flush of the same data from within write()
+    const size_t pending = stream->count;
+    size_t written = 0;
+
+    stream->flags &= ~StreamWriting;
+    stream->count = 0;
+
+    while (written < pending)
+    {
+        const ssize_t result = write(stream->fd, stream->buffer + written, pending - written);
+        if (result <= 0)
+        {
+            stream->flags |= StreamError;
+            return EOF;
+        }
+        written += result;
+    }
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdarg.h"
+#include "stdio.h"
+#include "Stream.h"
+#include "Format.h"
+
+/** Size of the buffer used to format output for unbuffered streams. */
+#define STAGING_SIZE 128
+
+/**
+ * Write out a stream buffer which is filled with formatted output.
+ *
+ * @param out Formatted output in the buffer of the stream.
+ *
+ * @return True on success, false on failure.
+ */
+static bool flushBuffered(FormatOutput *out)
+{
+    FILE *stream = (FILE *) out->context;
+
+    stream->count += out->count;
+    stream->flags |= StreamWriting;
+
+    if (flushStream(stream) != 0)
+        return false;
+
+    out->buffer = stream->buffer;
+    out->size   = stream->size;
+    out->count  = 0;
+    return true;
+}
+
+/**
+ * Write formatted output to an unbuffered stream.
+ *
+ * @param out Formatted output in the staging buffer.
+ *
+ * @return True on success, false on failure.
+ */
+static bool flushUnbuffered(FormatOutput *out)
+{
+    const size_t count = out->count;
+
+    out->count = 0;
+    return fwrite(out->buffer, 1, count, (FILE *) out->context) == count;
+}
+
+int vfprintf(FILE *stream, const char *format, va_list args)
+{
+    char staging[STAGING_SIZE];
+    FormatOutput out;
+
+    // Give back unread input first
+    if ((stream->flags & StreamReading) && flushStream(stream) != 0)
+        return -1;
+
+    out.count   = 0;
+    out.total   = 0;
+    out.error   = false;
+    out.context = stream;
+
+    // Buffered streams receive the output directly in their buffer
+    const bool buffered = allocateStreamBuffer(stream);
+    if (buffered)
+    {
+        out.buffer = stream->buffer + stream->count;
+        out.size   = stream->size - stream->count;
+        out.flush  = flushBuffered;
+    }
+    else
+    {
+        out.buffer = staging;
+        out.size   = sizeof(staging);
+        out.flush  = flushUnbuffered;
+    }
+
+    // Write formatted string
+    formatOutput(&out, format, args);
+
+    if (buffered)
+    {
+        bool newline = false;
+
+        for (size_t i = 0; i < out.count && !newline; i++)
+            newline = out.buffer[i] == '\n';
+
+        if (out.count != 0)
+        {
+            stream->count += out.count;
+            stream->flags |= StreamWriting;
+        }
+
+        // Line buffered streams are written out on each newline
+        if (!out.error && newline && stream->mode == _IOLBF && flushStream(stream) != 0)
+            out.error = true;
+    }
+    else if (!out.error && out.count != 0 && !flushUnbuffered(&out))
+    {
+        out.error = true;
+    }
+
+    // Done
+    return out.error ? -1 : out.total;
+}
@@ -16,10 +16,18 @@
  */
 
 #include <FreeNOS/User.h>
+#include <FileSystemClient.h>
+#include "stdio.h"
 #include "stdlib.h"
 
 extern C void exit(int status)
 {
+    // Write out pending output of all streams
+    fflush(ZERO);
+
+    // Let the other ends of our pipes see end-of-file
+    FileSystemClient().closeFiles();
+
     // Request immediate termination
     ProcessCtl(SELF, KillPID, status);
 }
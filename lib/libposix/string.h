@@ -125,6 +125,17 @@ extern C void * memset(void *dest, int ch, size_t count);
  */
 extern C void * memcpy(void *dest, const void *src, size_t count);
 
+/**
+ * Copy memory which may overlap from one place to another.
+ *
+ * @param dest Destination address.
+ * @param src Source address.
+ * @param count Number of bytes to copy.
+ *
+ * @return The destination address.
+ */
+extern C void * memmove(void *dest, const void *src, size_t count);
+
 /**
  * Calculate the length of a string.
  *
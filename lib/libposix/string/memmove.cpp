@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include "string.h"
+
+void * memmove(void *dest, const void *src, size_t count)
+{
+    const char *sp = (const char *) src;
+    char *dp = (char *) dest;
+
+    // Forward copy is safe if the destination does not overlap the end of the source
+    if (dp <= sp || dp >= sp + count)
+    {
+        MemoryBlock::copy(dest, src, count);
+    }
+    // Otherwise copy backwards, starting at the end
+    else
+    {
+        for (sp += count, dp += count; count != 0; count--)
+        {
+            *--dp = *--sp;
+        }
+    }
+
+    return (dest);
+}
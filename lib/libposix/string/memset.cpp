@@ -15,15 +15,10 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <MemoryBlock.h>
 #include "string.h"
 
 void * memset(void *dest, int ch, size_t count)
 {
-    char *temp;
-
-    for(temp = (char *) dest; count != 0; count--)
-    {
-        *temp++ = ch;
-    }
-    return (dest);
+    return MemoryBlock::set(dest, ch, count);
 }
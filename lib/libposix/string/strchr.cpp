@@ -15,13 +15,10 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <String.h>
 #include "string.h"
 
 char * strchr(const char *s, int c)
 {
-    while (*s && *s != c)
-    {
-        s++;
-    }
-    return (char *) (*s ? s : NULL);
+    return (char *) String::find(s, c);
 }
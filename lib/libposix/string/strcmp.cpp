@@ -15,14 +15,10 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <String.h>
 #include "string.h"
 
 int strcmp( const char *dest, const char *src )
 {
-    while ( *dest && *src && *dest == *src )
-    {
-        dest++;
-        src++;
-    }
-    return (*dest - *src);
+    return String::compare(dest, src);
 }
@@ -16,12 +16,10 @@
  */
 
 #include <sys/types.h>
+#include <String.h>
 #include "string.h"
 
 size_t strlen(const char *str)
 {
-    const char *s;
-
-    for (s = str; *s; ++s);
-    return (s - str);
+    return String::length(str);
 }
@@ -15,16 +15,10 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <String.h>
 #include "string.h"
 
 int strncmp( const char *dest, const char *src, size_t count )
 {
-    while (*dest && *src && *dest == *src && count)
-    {
-        if (--count)
-        {
-            dest++, src++;
-        }
-    }
-    return (*dest - *src);
+    return count ? String::compare(dest, src, count) : 0;
 }
@@ -63,6 +63,17 @@ struct msghdr
     int           msg_flags;
 };
 
+/**
+ * Describes a single datagram of a batch operation
+ */
+struct mmsghdr
+{
+    struct msghdr msg_hdr;
+    unsigned int  msg_len;
+};
+
+struct timespec;
+
 /**
  * Connect a socket to an address/port.
  *
@@ -115,6 +126,38 @@ extern C int sendto(int sockfd, const void *buf, size_t len, int flags,
  */
 extern C int sendmsg(int sockfd, const struct msghdr *msg, int flags);
 
+/**
+ * Send multiple datagrams with a single request.
+ *
+ * Each message describes one datagram, with its destination in msg_name
+ * and its payload in the first I/O vector.
+ *
+ * @param sockfd Socket file descriptor
+ * @param msgvec Array of messages to send. On output msg_len contains the bytes sent.
+ * @param vlen Number of messages in the array
+ * @param flags Optional flags for the send operation
+ *
+ * @return Number of messages sent on success and -1 on error
+ */
+extern C int sendmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags);
+
+/**
+ * Receive multiple datagrams with a single request.
+ *
+ * Blocks until at least one datagram is available. Each message receives
+ * one datagram in its first I/O vector and the sender in msg_name.
+ *
+ * @param sockfd Socket file descriptor
+ * @param msgvec Array of messages to fill. On output msg_len contains the bytes received.
+ * @param vlen Number of messages in the array
+ * @param flags Optional flags for the receive operation
+ * @param timeout Not supported, must be NULL
+ *
+ * @return Number of messages received on success and -1 on error
+ */
+extern C int recvmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen,
+                      int flags, struct timespec *timeout);
+
 /**
  * @}
  * @}
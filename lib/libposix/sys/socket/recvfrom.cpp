@@ -15,30 +15,33 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <stdlib.h>
-#include <unistd.h>
-#include <string.h>
 #include <NetworkClient.h>
+#include <unistd.h>
 #include <sys/socket.h>
 #include <errno.h>
 
 extern C int recvfrom(int sockfd, void *buf, size_t len, int flags,
                       struct sockaddr *addr, socklen_t addrlen)
 {
-    char packet[2048];
-    NetworkClient::SocketInfo info;
+    u8 packet[sizeof(NetworkClient::SocketInfo) + sizeof(NetworkClient::BatchPacket)];
+    NetworkClient::SocketInfo *info = (NetworkClient::SocketInfo *) packet;
+    NetworkClient::BatchPacket *pkt = (NetworkClient::BatchPacket *) (info + 1);
 
-    if (len > sizeof(packet) - addrlen)
-        return ERANGE;
+    info->address = 0;
+    info->port = 0;
+    info->action = NetworkClient::ReceiveBatch;
 
-    Error r = ::read(sockfd, packet, sizeof(packet));
+    // The payload is written directly to the caller, thus any size fits
+    pkt->buffer = (Address) buf;
+    pkt->size = len;
+    pkt->address = 0;
+    pkt->port = 0;
+
+    const int r = ::write(sockfd, packet, sizeof(packet));
     if (r < 0)
         return r;
 
-    memcpy(&info, packet, sizeof(info));
-    addr->addr = info.address;
-    addr->port = info.port;
-
-    memcpy(buf, packet + sizeof(info), r - sizeof(info));
-    return r - sizeof(info);
+    addr->addr = pkt->address;
+    addr->port = pkt->port;
+    return pkt->size;
 }
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <NetworkClient.h>
+#include <NetworkQueue.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <errno.h>
+
+extern C int recvmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen,
+                      int flags, struct timespec *timeout)
+{
+    static u8 buf[sizeof(NetworkClient::SocketInfo) +
+                 (sizeof(NetworkClient::BatchPacket) * NetworkQueue::BatchPackets)];
+    NetworkClient::SocketInfo *info = (NetworkClient::SocketInfo *) buf;
+    NetworkClient::BatchPacket *pkt = (NetworkClient::BatchPacket *) (info + 1);
+    const Size count = vlen > NetworkQueue::BatchPackets ? NetworkQueue::BatchPackets : vlen;
+
+    if (timeout != ZERO)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    info->address = 0;
+    info->port = 0;
+    info->action = NetworkClient::ReceiveBatch;
+
+    // Describe the buffer for each datagram
+    for (Size i = 0; i < count; i++)
+    {
+        const struct msghdr *msg = &msgvec[i].msg_hdr;
+
+        if (msg->msg_iovlen != 1 || msg->msg_namelen != sizeof(struct sockaddr))
+        {
+            errno = EINVAL;
+            return -1;
+        }
+
+        pkt[i].buffer = (Address) msg->msg_iov[0].iov_base;
+        pkt[i].size = msg->msg_iov[0].iov_len;
+        pkt[i].address = 0;
+        pkt[i].port = 0;
+    }
+
+    // The socket fills in the payloads and updates the descriptors
+    const int r = ::write(sockfd, buf, sizeof(*info) + (count * sizeof(*pkt)));
+    if (r < 0)
+    {
+        return r;
+    }
+
+    const Size received = (r - sizeof(*info)) / sizeof(*pkt);
+    for (Size i = 0; i < received; i++)
+    {
+        struct sockaddr *addr = (struct sockaddr *) msgvec[i].msg_hdr.msg_name;
+
+        addr->addr = pkt[i].address;
+        addr->port = pkt[i].port;
+        msgvec[i].msg_len = pkt[i].size;
+    }
+
+    return received;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <NetworkClient.h>
+#include <NetworkQueue.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <errno.h>
+
+extern C int sendmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+    static u8 buf[sizeof(NetworkClient::SocketInfo) +
+                 (sizeof(NetworkClient::BatchPacket) * NetworkQueue::BatchPackets)];
+    NetworkClient::SocketInfo *info = (NetworkClient::SocketInfo *) buf;
+    NetworkClient::BatchPacket *pkt = (NetworkClient::BatchPacket *) (info + 1);
+    const Size count = vlen > NetworkQueue::BatchPackets ? NetworkQueue::BatchPackets : vlen;
+
+    info->address = 0;
+    info->port = 0;
+    info->action = NetworkClient::SendBatch;
+
+    // Describe each datagram with its own destination and payload
+    for (Size i = 0; i < count; i++)
+    {
+        const struct msghdr *msg = &msgvec[i].msg_hdr;
+        const struct sockaddr *addr = (const struct sockaddr *) msg->msg_name;
+
+        if (msg->msg_iovlen != 1 || msg->msg_namelen != sizeof(struct sockaddr))
+        {
+            errno = EINVAL;
+            return -1;
+        }
+
+        pkt[i].buffer = (Address) msg->msg_iov[0].iov_base;
+        pkt[i].size = msg->msg_iov[0].iov_len;
+        pkt[i].address = addr->addr;
+        pkt[i].port = addr->port;
+    }
+
+    const int r = ::write(sockfd, buf, sizeof(*info) + (count * sizeof(*pkt)));
+    if (r < 0)
+    {
+        return r;
+    }
+
+    // The number of bytes written gives the number of datagrams sent
+    const Size sent = (r - sizeof(*info)) / sizeof(*pkt);
+    for (Size i = 0; i < sent; i++)
+    {
+        msgvec[i].msg_len = pkt[i].size;
+    }
+
+    return sent;
+}
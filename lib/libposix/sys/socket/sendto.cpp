@@ -16,27 +16,30 @@
  */
 
 #include <NetworkClient.h>
-#include <stdlib.h>
 #include <unistd.h>
-#include <string.h>
 #include <sys/socket.h>
 #include <errno.h>
 
 extern C int sendto(int sockfd, const void *buf, size_t len, int flags,
                     const struct sockaddr *addr, socklen_t addrlen)
 {
-    char packet[2048];
-    NetworkClient::SocketInfo info;
+    u8 packet[sizeof(NetworkClient::SocketInfo) + sizeof(NetworkClient::BatchPacket)];
+    NetworkClient::SocketInfo *info = (NetworkClient::SocketInfo *) packet;
+    NetworkClient::BatchPacket *pkt = (NetworkClient::BatchPacket *) (info + 1);
 
-    if (len > sizeof(packet) - addrlen)
-        return ERANGE;
+    info->address = 0;
+    info->port = 0;
+    info->action = NetworkClient::SendBatch;
 
-    info.address = addr->addr;
-    info.port = addr->port;
-    info.action = NetworkClient::SendSingle;
+    // The payload is read directly from the caller, thus any size fits
+    pkt->buffer = (Address) buf;
+    pkt->size = len;
+    pkt->address = addr->addr;
+    pkt->port = addr->port;
 
-    memcpy(packet, &info, sizeof(info));
-    memcpy(packet + sizeof(info), buf, len);
+    const int r = ::write(sockfd, packet, sizeof(packet));
+    if (r < 0)
+        return r;
 
-    return ::write(sockfd, packet, len + sizeof(info));
+    return pkt->size;
 }
@@ -16,12 +16,22 @@
  */
 
 #include <FreeNOS/User.h>
+#include <KernelTimer.h>
 #include <sys/time.h>
 #include <errno.h>
 
 int gettimeofday(struct timeval *tv, struct timezone *tz)
 {
     Timer::Info timer;
+    u64 nanoseconds;
+
+    // Read the ClockPage without entering the kernel, if possible
+    if (KernelTimer::getClock(&nanoseconds) == Timer::Success)
+    {
+        tv->tv_sec  = nanoseconds / 1000000000U;
+        tv->tv_usec = (nanoseconds % 1000000000U) / 1000U;
+        return 0;
+    }
 
     // Get current system timer info
     ProcessCtl(SELF, InfoTimer, (Address) &timer);
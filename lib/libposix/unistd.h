@@ -107,6 +107,50 @@ extern C ssize_t write(int fildes, const void *buf, size_t nbyte);
  */
 extern C int close(int fildes);
 
+/**
+ * @brief Create an interprocess channel.
+ *
+ * The pipe() function shall create a pipe and place two file descriptors,
+ * one each into the arguments fildes[0] and fildes[1], that refer to the
+ * open file descriptions for the read and write ends of the pipe.
+ * Processes started afterwards inherit both ends.
+ *
+ * @param fildes Receives the read end and the write end.
+ *
+ * @return Upon successful completion, 0 shall be returned; otherwise, -1 shall
+ *         be returned and errno set to indicate the error.
+ */
+extern C int pipe(int fildes[2]);
+
+/**
+ * @brief Duplicate an open file descriptor.
+ *
+ * The dup() function shall return the lowest numbered available
+ * file descriptor, which refers to the same open file as fildes.
+ *
+ * @param fildes File descriptor to duplicate.
+ *
+ * @return Upon successful completion a non-negative integer, namely the file
+ *         descriptor, shall be returned; otherwise, -1 shall be returned and
+ *         errno set to indicate the error.
+ */
+extern C int dup(int fildes);
+
+/**
+ * @brief Duplicate an open file descriptor to a given number.
+ *
+ * The dup2() function shall cause the file descriptor fildes2 to refer
+ * to the same open file as fildes. If fildes2 is already open,
+ * it shall be closed first.
+ *
+ * @param fildes File descriptor to duplicate.
+ * @param fildes2 File descriptor number of the copy.
+ *
+ * @return Upon successful completion, fildes2 shall be returned; otherwise,
+ *         -1 shall be returned and errno set to indicate the error.
+ */
+extern C int dup2(int fildes, int fildes2);
+
 /**
  * @brief Move the read/write file offset.
  *
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBPOSIX_PROGRAMIMAGE_H
+#define __LIBPOSIX_PROGRAMIMAGE_H
+
+#include <Types.h>
+#include <Memory.h>
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libposix
+ * @{
+ */
+
+/** Maximum number of memory regions in a program image. */
+#define PROGRAM_IMAGE_REGIONS 16
+
+/**
+ * Program loaded in the local address space.
+ *
+ * The regions can be mapped copy-on-write into any number of new
+ * processes. The local mappings must not be modified after loading.
+ * Only the pages with data from the program file are loaded. The
+ * remaining zero-filled pages of a region, such as the BSS, are
+ * backed on demand in each new process.
+ */
+typedef struct ProgramImage
+{
+    /** Program entry point. */
+    Address entry;
+
+    /** Number of loaded regions. */
+    Size count;
+
+    /** Virtual address of each region in the new process. */
+    Address virt[PROGRAM_IMAGE_REGIONS];
+
+    /** Size of each region in the new process, in whole pages. */
+    Size size[PROGRAM_IMAGE_REGIONS];
+
+    /** Local mapping of each region. Has zero size if the region has no data. */
+    Memory::Range local[PROGRAM_IMAGE_REGIONS];
+}
+ProgramImage;
+
+/**
+ * Load an in-memory executable into the local address space.
+ *
+ * @param program In-memory executable to load
+ * @param programSize Number of bytes of the executable
+ * @param image Receives the loaded program on output
+ *
+ * @return Zero on success and -1 on failure.
+ * @note  Errno is set with the appropriate error code on failure.
+ */
+extern int loadImage(Address program, Size programSize, ProgramImage *image);
+
+/**
+ * Use the pages of an in-memory executable as program image.
+ *
+ * Avoids copying the program data if each region starts at a page
+ * boundary in the executable. The pages which are not used by any region,
+ * such as the executable headers, are released.
+ *
+ * @param program Local mapping of the executable. Must be physically
+ *                contiguous and have a whole number of pages.
+ * @param programSize Number of bytes of the executable
+ * @param image Receives the loaded program on output
+ *
+ * @return Zero on success and -1 on failure. On failure the
+ *         executable is not modified.
+ * @note  Errno is set to ENOTSUP if the regions are not page aligned.
+ */
+extern int adoptImage(Memory::Range *program, Size programSize, ProgramImage *image);
+
+/**
+ * Create a new process from a loaded program image.
+ *
+ * @param image Loaded program image
+ * @param argv Argument list pointer.
+ *
+ * @return New process ID on success and -1 on failure.
+ * @note  Errno is set with the appropriate error code on failure.
+ */
+extern int spawnImage(const ProgramImage *image, const char *argv[]);
+
+/**
+ * Release the local mappings of a loaded program image.
+ *
+ * @param image Loaded program image
+ */
+extern void releaseImage(ProgramImage *image);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBPOSIX_PROGRAMIMAGE_H */
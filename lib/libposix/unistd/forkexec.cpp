@@ -16,60 +16,223 @@
  */
 
 #include <FreeNOS/User.h>
+#include <FileSystemClient.h>
 #include <Lz4Decompressor.h>
 #include <Types.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include "unistd.h"
+#include "ProgramImage.h"
 
-int forkexec(const char *path, const char *argv[])
+/** Number of loaded programs kept for later forkexec() calls. */
+#define FORKEXEC_CACHE_SIZE 8
+
+/**
+ * Loaded program, identified by its path and file.
+ */
+typedef struct CachedProgram
 {
-    int fd, ret = 0;
-    struct stat st;
+    /** Program path as given to forkexec(). */
+    char path[PATH_MAX];
 
-    // Find program image
-    if (stat(path, &st) != 0)
-        return -1;
+    /** Inode number of the program file. */
+    ino_t inode;
+
+    /** Size of the program file in bytes. */
+    off_t size;
+
+    /** Loaded program image. */
+    ProgramImage image;
+}
+CachedProgram;
+
+/** Programs loaded by earlier forkexec() calls, most recently used first. */
+static CachedProgram cachedPrograms[FORKEXEC_CACHE_SIZE];
+
+/** Number of valid entries in cachedPrograms. */
+static Size cachedCount = 0;
+
+/**
+ * Move a cached program to the front of the cache.
+ *
+ * @param index Index of the entry to move
+ *
+ * @return Pointer to the front entry
+ */
+static CachedProgram * touchProgram(const Size index)
+{
+    if (index != 0)
+    {
+        const CachedProgram entry = cachedPrograms[index];
+
+        memmove(&cachedPrograms[1], &cachedPrograms[0], sizeof(CachedProgram) * index);
+        cachedPrograms[0] = entry;
+    }
+
+    return &cachedPrograms[0];
+}
+
+/**
+ * Keep a loaded program image for later use.
+ *
+ * @param path Program path
+ * @param st File status of the program
+ * @param image Loaded program image
+ *
+ * @return Pointer to the cached program image
+ */
+static const ProgramImage * cacheProgram(const char *path,
+                                         const struct stat *st,
+                                         const ProgramImage *image)
+{
+    CachedProgram *entry;
+
+    // Replace the least recently used program when full
+    if (cachedCount < FORKEXEC_CACHE_SIZE)
+        cachedCount++;
+    else
+        releaseImage(&cachedPrograms[cachedCount - 1].image);
+
+    entry = touchProgram(cachedCount - 1);
+
+    strlcpy(entry->path, path, PATH_MAX);
+    entry->inode = st->st_ino;
+    entry->size  = st->st_size;
+    entry->image = *image;
+    return &entry->image;
+}
+
+/**
+ * Retrieve the contents of a program file.
+ *
+ * The file is mapped if supported by its file system and
+ * otherwise read into newly allocated memory.
+ *
+ * @param path Program path
+ * @param st File status of the program
+ * @param range On output, memory range with the file contents
+ * @param mapped On output, true if the file is mapped with FileSystemClient::mapFile()
+ *
+ * @return Zero on success and -1 on failure
+ */
+static int readProgram(const char *path,
+                       const struct stat *st,
+                       Memory::Range *range,
+                       bool *mapped)
+{
+    const FileSystemClient filesystem;
+    const void *data;
+    Size size;
+    int fd, ret;
+
+    // Prefer to use the file system buffer directly
+    if (filesystem.mapFile(path, &data, &size) == FileSystem::Success)
+    {
+        if (size != (Size) st->st_size)
+        {
+            filesystem.unmapFile(data);
+            errno = EIO;
+            return -1;
+        }
+        range->virt = (Address) data;
+        range->size = size;
+        *mapped = true;
+        return 0;
+    }
+    *mapped = false;
 
     // Open program image
     if ((fd = open(path, O_RDONLY)) < 0)
         return -1;
 
-    // Map memory buffer for the compressed program image
-    Memory::Range compressed;
-    compressed.virt   = ZERO;
-    compressed.phys   = ZERO;
-    compressed.size   = st.st_size;
-    compressed.access = Memory::User|Memory::Readable|Memory::Writable;
+    // Allocate memory for the program image
+    range->virt   = ZERO;
+    range->phys   = ZERO;
+    range->size   = st->st_size;
+    range->access = Memory::User|Memory::Readable|Memory::Writable;
 
     // Create mapping
-    if (VMCtl(SELF, MapContiguous, &compressed) != API::Success)
+    if (VMCtl(SELF, MapContiguous, range) != API::Success)
     {
+        close(fd);
         errno = EFAULT;
         return -1;
     }
 
     // Read the program image
-    ret = read(fd, (void *) compressed.virt, st.st_size);
+    ret = read(fd, (void *) range->virt, st->st_size);
 
     // Close file handle
     close(fd);
 
-    if (ret != st.st_size)
+    if (ret != st->st_size)
     {
-        VMCtl(SELF, Release, &compressed);
+        VMCtl(SELF, Release, range);
         errno = EIO;
         return -1;
     }
 
+    return 0;
+}
+
+/**
+ * Release the contents of a program file.
+ *
+ * @param range Memory range with the file contents
+ * @param mapped True if the file is mapped with FileSystemClient::mapFile()
+ *
+ * @return Zero on success and -1 on failure
+ */
+static int releaseProgram(Memory::Range *range, const bool mapped)
+{
+    if (mapped)
+    {
+        const FileSystemClient filesystem;
+        return filesystem.unmapFile((const void *) range->virt) == FileSystem::Success ? 0 : -1;
+    }
+    else
+    {
+        return VMCtl(SELF, Release, range) == API::Success ? 0 : -1;
+    }
+}
+
+int forkexec(const char *path, const char *argv[])
+{
+    int ret = 0;
+    bool mapped;
+    struct stat st;
+    ProgramImage image;
+
+    // Find program image
+    if (stat(path, &st) != 0)
+        return -1;
+
+    // Share the pages of an already loaded program
+    for (Size i = 0; i < cachedCount; i++)
+    {
+        const CachedProgram & entry = cachedPrograms[i];
+
+        if (entry.inode == st.st_ino && entry.size == st.st_size &&
+            strcmp(entry.path, path) == 0)
+        {
+            return spawnImage(&touchProgram(i)->image, argv);
+        }
+    }
+
+    // Retrieve the compressed program image
+    Memory::Range compressed;
+    if (readProgram(path, &st, &compressed, &mapped) != 0)
+        return -1;
+
     // Initialize decompressor
     Lz4Decompressor lz4((const void *)compressed.virt, st.st_size);
     const Lz4Decompressor::Result result = lz4.initialize();
     if (result != Lz4Decompressor::Success)
     {
-        VMCtl(SELF, Release, &compressed);
+        releaseProgram(&compressed, mapped);
         errno = EFAULT;
         return -1;
     }
@@ -78,13 +241,13 @@ int forkexec(const char *path, const char *argv[])
     Memory::Range uncompressed;
     uncompressed.virt   = ZERO;
     uncompressed.phys   = ZERO;
-    uncompressed.size   = lz4.getUncompressedSize();
+    uncompressed.size   = (lz4.getUncompressedSize() + PAGESIZE - 1) & PAGEMASK;
     uncompressed.access = Memory::User|Memory::Readable|Memory::Writable;
 
     // Create mapping
     if (VMCtl(SELF, MapContiguous, &uncompressed) != API::Success)
     {
-        VMCtl(SELF, Release, &compressed);
+        releaseProgram(&compressed, mapped);
         errno = EFAULT;
         return -1;
     }
@@ -93,29 +256,39 @@ int forkexec(const char *path, const char *argv[])
     const Lz4Decompressor::Result readResult = lz4.read((void *)uncompressed.virt, lz4.getUncompressedSize());
     if (readResult != Lz4Decompressor::Success)
     {
-        VMCtl(SELF, Release, &compressed);
+        releaseProgram(&compressed, mapped);
         VMCtl(SELF, Release, &uncompressed);
         errno = EFAULT;
         return -1;
     }
 
     // Cleanup compressed program buffer
-    if (VMCtl(SELF, Release, &compressed) != API::Success)
+    if (releaseProgram(&compressed, mapped) != 0)
     {
         VMCtl(SELF, Release, &uncompressed);
         errno = EFAULT;
         return -1;
     }
 
-    // Spawn the new program
-    ret = spawn(uncompressed.virt, lz4.getUncompressedSize(), argv);
+    // Use the decompressed pages directly as program image if possible
+    if (adoptImage(&uncompressed, lz4.getUncompressedSize(), &image) == 0)
+        return spawnImage(cacheProgram(path, &st, &image), argv);
+
+    // Otherwise copy the program regions
+    ret = loadImage(uncompressed.virt, lz4.getUncompressedSize(), &image);
 
     // Cleanup uncompressed program buffer
     if (VMCtl(SELF, Release, &uncompressed) != API::Success)
     {
+        if (ret == 0)
+            releaseImage(&image);
         errno = EFAULT;
         return -1;
     }
 
-    return ret;
+    if (ret != 0)
+        return -1;
+
+    // Spawn the new program, keeping the image for the next time
+    return spawnImage(cacheProgram(path, &st, &image), argv);
 }
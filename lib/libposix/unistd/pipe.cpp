@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FileSystemClient.h>
+#include "errno.h"
+#include "unistd.h"
+
+int pipe(int fildes[2])
+{
+    const FileSystemClient filesystem;
+    Size readEnd, writeEnd;
+
+    const FileSystem::Result result = filesystem.createPipe(readEnd, writeEnd);
+    if (result != FileSystem::Success)
+    {
+        errno = EMFILE;
+        return -1;
+    }
+
+    fildes[0] = readEnd;
+    fildes[1] = writeEnd;
+    return 0;
+}
@@ -17,10 +17,15 @@
 
 #include <FileSystemClient.h>
 #include "errno.h"
+#include "stdio.h"
 #include "unistd.h"
 
 ssize_t read(int fildes, void *buf, size_t nbyte)
 {
+    // Show pending output, such as a prompt, before waiting for input
+    if (fildes == stdin->fd)
+        fflush(stdout);
+
     // Read the file.
     const FileSystemClient filesystem;
     const FileSystem::Result result = filesystem.readFile(fildes,
@@ -25,18 +25,38 @@
 #include "string.h"
 #include "errno.h"
 #include "unistd.h"
+#include "ProgramImage.h"
 
-int spawn(Address program, Size programSize, const char *argv[])
+/**
+ * Round up to a whole number of pages.
+ *
+ * @param size Number of bytes
+ *
+ * @return Size in bytes of the pages which contain the given bytes
+ */
+static inline Size pageAlign(const Size size)
+{
+    return (size + PAGESIZE - 1) & PAGEMASK;
+}
+
+/**
+ * Read the entry point and memory regions of an in-memory executable.
+ *
+ * @param program In-memory executable
+ * @param programSize Number of bytes of the executable
+ * @param image Receives the entry point on output
+ * @param regions Receives the memory regions on output
+ * @param count On output contains the number of memory regions
+ *
+ * @return Zero on success and -1 on failure.
+ */
+static int readRegions(const Address program,
+                       const Size programSize,
+                       ProgramImage *image,
+                       ExecutableFormat::Region *regions,
+                       Size *count)
 {
-    const FileSystemClient filesystem;
     ExecutableFormat *fmt;
-    ExecutableFormat::Region regions[16];
-    Arch::MemoryMap map;
-    Memory::Range range;
-    uint count = 0;
-    pid_t pid = 0;
-    Size numRegions = 16;
-    Address entry;
 
     // Attempt to read executable format
     if (ExecutableFormat::find((u8 *) program, programSize, &fmt) != ExecutableFormat::Success)
@@ -45,84 +65,215 @@ int spawn(Address program, Size programSize, const char *argv[])
         return -1;
     }
 
-    // Find entry point
-    if (fmt->entry(&entry) != ExecutableFormat::Success)
+    // Find entry point and memory regions
+    *count = PROGRAM_IMAGE_REGIONS;
+    if (fmt->entry(&image->entry) != ExecutableFormat::Success ||
+        fmt->regions(regions, count) != ExecutableFormat::Success)
     {
         delete fmt;
         errno = ENOEXEC;
         return -1;
     }
+    // Release buffers
+    delete fmt;
 
-    // Create new process
-    const ulong result = ProcessCtl(ANY, Spawn, entry);
-    if ((result & 0xffff) != API::Success)
+    for (image->count = 0; image->count < *count; image->count++)
     {
-        delete fmt;
-        errno = EIO;
-        return -1;
+        const ExecutableFormat::Region & region = regions[image->count];
+        Memory::Range & range = image->local[image->count];
+
+        // Only the pages with data are loaded, the others are demand-zero
+        range.virt   = ZERO;
+        range.phys   = ZERO;
+        range.size   = pageAlign(region.dataSize);
+        range.access = region.access;
+        image->virt[image->count] = region.virt;
+        image->size[image->count] = pageAlign(region.memorySize);
     }
-    pid = (result >> 16);
 
-    // Retrieve memory regions
-    if (fmt->regions(regions, &numRegions) != ExecutableFormat::Success)
-    {
-        delete fmt;
-        errno = ENOEXEC;
-        ProcessCtl(pid, KillPID);
+    return 0;
+}
+
+int loadImage(Address program, Size programSize, ProgramImage *image)
+{
+    ExecutableFormat::Region regions[PROGRAM_IMAGE_REGIONS];
+    Size numRegions;
+
+    if (readRegions(program, programSize, image, regions, &numRegions) != 0)
         return -1;
-    }
-    // Release buffers
-    delete fmt;
 
-    // Map program regions into virtual memory of the new process
+    // Load program regions into our own virtual memory
     for (Size i = 0; i < numRegions; i++)
     {
-        // Setup memory range to copy region data
-        range.virt   = regions[i].virt;
-        range.phys   = ZERO;
-        range.size   = regions[i].memorySize;
-        range.access = regions[i].access;
+        const ExecutableFormat::Region & region = regions[i];
+        Memory::Range & range = image->local[i];
+
+        if (range.size == 0)
+            continue;
 
-        // Create mapping first in the new process
-        if (VMCtl(pid, MapContiguous, &range) != API::Success)
+        // The local mapping must be writable to fill it
+        range.access = region.access | Memory::Writable;
+
+        if (VMCtl(SELF, MapContiguous, &range) != API::Success)
         {
+            image->count = i;
+            releaseImage(image);
             errno = EFAULT;
-            ProcessCtl(pid, KillPID);
             return -1;
         }
 
-        // Map inside our process
-        range.virt = ZERO;
-        if (VMCtl(SELF, MapContiguous, &range) != API::Success)
+        // Copy data bytes
+        MemoryBlock::copy((void *)range.virt, (const void *)(program + region.dataOffset),
+                          region.dataSize);
+
+        // Nulify remaining space of the last page
+        MemoryBlock::set((void *)(range.virt + region.dataSize), 0,
+                         range.size - region.dataSize);
+
+        // New processes receive the access of the region
+        range.access = region.access;
+    }
+
+    return 0;
+}
+
+int adoptImage(Memory::Range *program, Size programSize, ProgramImage *image)
+{
+    ExecutableFormat::Region regions[PROGRAM_IMAGE_REGIONS];
+    Size numRegions;
+
+    if (readRegions(program->virt, programSize, image, regions, &numRegions) != 0)
+        return -1;
+
+    // Each region must have its own pages inside the executable
+    for (Size i = 0; i < numRegions; i++)
+    {
+        const ExecutableFormat::Region & region = regions[i];
+
+        if (image->local[i].size == 0)
+            continue;
+
+        if ((region.dataOffset & ~PAGEMASK) || (region.virt & ~PAGEMASK) ||
+            region.dataOffset + image->local[i].size > program->size)
         {
-            errno = EFAULT;
-            ProcessCtl(pid, KillPID);
+            errno = ENOTSUP;
             return -1;
         }
 
-        // Copy data bytes
-        MemoryBlock::copy((void *)range.virt, (const void *)(program + regions[i].dataOffset),
-                          regions[i].dataSize);
+        for (Size j = 0; j < i; j++)
+        {
+            if (image->local[j].size != 0 &&
+                region.dataOffset < regions[j].dataOffset + image->local[j].size &&
+                regions[j].dataOffset < region.dataOffset + image->local[i].size)
+            {
+                errno = ENOTSUP;
+                return -1;
+            }
+        }
+    }
+
+    // The pages of each region become its local mapping
+    for (Size i = 0; i < numRegions; i++)
+    {
+        const ExecutableFormat::Region & region = regions[i];
+        Memory::Range & range = image->local[i];
+
+        if (range.size == 0)
+            continue;
+
+        range.virt = program->virt + region.dataOffset;
+        range.phys = program->phys + region.dataOffset;
+
+        // Clear the bytes after the data, which belong to other parts of the executable
+        MemoryBlock::set((void *)(range.virt + region.dataSize), 0,
+                         range.size - region.dataSize);
+    }
+
+    // Release the pages which are not used by any region
+    Memory::Range unused = { program->virt, ZERO, 0, program->access };
+
+    for (Address page = program->virt; page <= program->virt + program->size; page += PAGESIZE)
+    {
+        bool used = page == program->virt + program->size;
+
+        for (Size i = 0; i < numRegions && !used; i++)
+            used = page >= image->local[i].virt && page < image->local[i].virt + image->local[i].size;
+
+        if (!used)
+        {
+            if (unused.size == 0)
+                unused.virt = page;
 
-        // Nulify remaining space
-        if (regions[i].memorySize > regions[i].dataSize)
+            unused.size += PAGESIZE;
+        }
+        else if (unused.size != 0)
         {
-            MemoryBlock::set((void *)(range.virt + regions[i].dataSize), 0,
-                             regions[i].memorySize - regions[i].dataSize);
+            VMCtl(SELF, Release, &unused);
+            unused.size = 0;
         }
+    }
+
+    return 0;
+}
+
+void releaseImage(ProgramImage *image)
+{
+    for (Size i = 0; i < image->count; i++)
+        if (image->local[i].size != 0)
+            VMCtl(SELF, Release, &image->local[i]);
+
+    image->count = 0;
+}
+
+int spawnImage(const ProgramImage *image, const char *argv[])
+{
+    const FileSystemClient filesystem;
+    Arch::MemoryMap map;
+    Memory::Range range;
+    uint count = 0;
+    pid_t pid = 0;
+
+    // Create new process
+    const ulong result = ProcessCtl(ANY, Spawn, image->entry);
+    if ((result & 0xffff) != API::Success)
+    {
+        errno = EIO;
+        return -1;
+    }
+    pid = (result >> 16);
+
+    // Share program regions copy-on-write with the new process
+    for (Size i = 0; i < image->count; i++)
+    {
+        range.virt   = image->virt[i];
+        range.phys   = image->local[i].phys;
+        range.size   = image->local[i].size;
+        range.access = image->local[i].access;
 
-        // Remove temporary mapping
-        if (VMCtl(SELF, UnMap, &range) != API::Success)
+        if (range.size != 0 && VMCtl(pid, MapCopyOnWrite, &range) != API::Success)
         {
             errno = EFAULT;
             ProcessCtl(pid, KillPID);
             return -1;
         }
+
+        // The remaining pages are backed on first use
+        range.virt += range.size;
+        range.size  = image->size[i] - range.size;
+        range.phys  = ZERO;
+
+        if (range.size != 0 && VMCtl(pid, MapDemand, &range) != API::Success)
+        {
+            errno = ENOMEM;
+            ProcessCtl(pid, KillPID);
+            return -1;
+        }
     }
 
     // Create mapping for command-line arguments
     range = map.range(MemoryMap::UserArgs);
     range.phys = ZERO;
+    range.size = PAGESIZE * 2;
     range.access = Memory::User | Memory::Readable | Memory::Writable;
     if (VMCtl(pid, MapContiguous, &range) != API::Success)
     {
@@ -131,6 +282,19 @@ int spawn(Address program, Size programSize, const char *argv[])
         return -1;
     }
 
+    // The file descriptors table is backed on demand
+    Memory::Range table = map.range(MemoryMap::UserArgs);
+    table.virt += PAGESIZE * 2;
+    table.size -= PAGESIZE * 2;
+    table.phys = ZERO;
+    table.access = range.access;
+    if (VMCtl(pid, MapDemand, &table) != API::Success)
+    {
+        errno = EFAULT;
+        ProcessCtl(pid, KillPID);
+        return -1;
+    }
+
     // Allocate arguments and current working directory
     char *arguments = new char[PAGESIZE*2];
     memset(arguments, 0, PAGESIZE*2);
@@ -145,6 +309,10 @@ int spawn(Address program, Size programSize, const char *argv[])
     // Fill in the current working directory
     strlcpy(arguments + PAGESIZE, **filesystem.getCurrentDirectory(), PATH_MAX);
 
+    // Fill in the number of file descriptor entries to inherit
+    const FileDescriptor::Entry *files = FileDescriptor::instance()->getArray(count);
+    *(Size *) (arguments + ARGV_FILES) = count;
+
     // Copy argc/argv into the new process
     if (VMCopy(pid, API::Write, (Address) arguments, range.virt, PAGESIZE * 2) != API::Success)
     {
@@ -154,9 +322,18 @@ int spawn(Address program, Size programSize, const char *argv[])
         return -1;
     }
 
-    // Copy fds into the new process.
-    if (VMCopy(pid, API::Write, (Address) FileDescriptor::instance()->getArray(count),
-               range.virt + (PAGESIZE * 2), range.size - (PAGESIZE * 2)) != API::Success)
+    // Pipe ends stay open until the new process closes them
+    if (filesystem.inheritFiles(pid) != FileSystem::Success)
+    {
+        delete[] arguments;
+        errno = ENOMEM;
+        ProcessCtl(pid, KillPID);
+        return -1;
+    }
+
+    // Copy fds in use into the new process.
+    if (count != 0 && VMCopy(pid, API::Write, (Address) files, table.virt,
+                             count * sizeof(FileDescriptor::Entry)) != API::Success)
     {
         delete[] arguments;
         errno = EFAULT;
@@ -177,3 +354,16 @@ int spawn(Address program, Size programSize, const char *argv[])
     delete[] arguments;
     return pid;
 }
+
+int spawn(Address program, Size programSize, const char *argv[])
+{
+    ProgramImage image;
+
+    if (loadImage(program, programSize, &image) != 0)
+        return -1;
+
+    // The new process keeps the pages after our mappings are released
+    const int pid = spawnImage(&image, argv);
+    releaseImage(&image);
+    return pid;
+}
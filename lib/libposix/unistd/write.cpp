@@ -17,10 +17,15 @@
 
 #include <FileSystemClient.h>
 #include "errno.h"
+#include "stdio.h"
 #include "unistd.h"
 
 ssize_t write(int fildes, const void *buf, size_t nbyte)
 {
+    // Keep the output ordered with pending buffered standard output
+    if (fildes == stdout->fd)
+        fflush(stdout);
+
     // Write the file.
     const FileSystemClient filesystem;
     const FileSystem::Result result = filesystem.writeFile(fildes,
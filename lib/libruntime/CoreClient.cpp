@@ -51,18 +51,72 @@ Core::Result CoreClient::getCoreCount(Size &coreCount) const
     return result;
 }
 
+Core::Result CoreClient::getClockPage(const Size coreId, Address &address) const
+{
+    CoreMessage msg;
+    msg.type       = ChannelMessage::Request;
+    msg.action     = Core::GetClockPage;
+    msg.coreNumber = coreId;
+
+    const Core::Result result = request(msg);
+    if (result == Core::Success)
+    {
+        address = msg.clockPage;
+    }
+
+    return result;
+}
+
 Core::Result CoreClient::createProcess(const Size coreId,
                                        const Address programAddr,
                                        const Size programSize,
-                                       const char *programCmd) const
+                                       const char *programCmd,
+                                       const Size coreMask) const
 {
     CoreMessage msg;
     msg.type        = ChannelMessage::Request;
     msg.action      = Core::CreateProcess;
     msg.coreNumber  = coreId;
+    msg.coreMask    = coreMask;
     msg.programAddr = programAddr;
     msg.programSize = programSize;
     msg.programCmd  = programCmd;
 
     return request(msg);
 }
+
+Core::Result CoreClient::createProcesses(const Size count,
+                                         const Size *coreIds,
+                                         const Address programAddr,
+                                         const Size programSize,
+                                         const char **programCmds) const
+{
+    CoreMessage *msgs = new CoreMessage[count];
+    Core::Result result = Core::Success;
+
+    for (Size i = 0; i < count; i++)
+    {
+        msgs[i].type        = ChannelMessage::Request;
+        msgs[i].action      = Core::CreateProcess;
+        msgs[i].coreNumber  = coreIds[i];
+        msgs[i].coreMask    = Core::AllCores;
+        msgs[i].programAddr = programAddr;
+        msgs[i].programSize = programSize;
+        msgs[i].programCmd  = programCmds[i];
+    }
+
+    if (ChannelClient::instance()->syncSendReceiveBatch(msgs, count, sizeof(CoreMessage), m_pid) != ChannelClient::Success)
+    {
+        result = Core::IpcError;
+    }
+    else
+    {
+        for (Size i = 0; i < count && result == Core::Success; i++)
+        {
+            result = msgs[i].result;
+        }
+    }
+
+    delete[] msgs;
+    return result;
+}
@@ -57,20 +57,56 @@ class CoreClient
      */
     Core::Result getCoreCount(Size &numCores) const;
 
+    /**
+     * Get the physical address of the ClockPage of a core.
+     *
+     * The ClockPage of a core contains its timer ticks and busy ticks.
+     *
+     * @param coreId Core identifier
+     * @param address On output, contains the physical address of the ClockPage
+     *
+     * @return Result code
+     */
+    Core::Result getClockPage(const Size coreId, Address &address) const;
+
     /**
      * Create a new process on a different core.
      *
-     * @param coreId Specifies the core on which the process will be created.
+     * @param coreId Specifies the core on which the process will be created,
+     *               or Core::AnyCore to select the least loaded core.
      * @param programAddr Virtual address of the loaded program to start.
      * @param programSize Size of the loaded program in bytes.
      * @param programCmd Command-line string for starting the program.
+     * @param coreMask Affinity mask of cores on which the process may be created.
+     *                 With Core::AnyCore the least loaded core in the mask is selected.
      *
      * @return Result code
      */
     Core::Result createProcess(const Size coreId,
                                const Address programAddr,
                                const Size programSize,
-                               const char *programCmd) const;
+                               const char *programCmd,
+                               const Size coreMask = Core::AllCores) const;
+
+    /**
+     * Create new processes on different cores at once.
+     *
+     * All requests are sent before waiting for the replies,
+     * such that the CoreServer creates the processes in parallel.
+     *
+     * @param count Number of processes to create.
+     * @param coreIds Core for each process, or Core::AnyCore.
+     * @param programAddr Virtual address of the loaded program to start.
+     * @param programSize Size of the loaded program in bytes.
+     * @param programCmds Command-line string for each process.
+     *
+     * @return Result code of the first process which failed, or Core::Success.
+     */
+    Core::Result createProcesses(const Size count,
+                                 const Size *coreIds,
+                                 const Address programAddr,
+                                 const Size programSize,
+                                 const char **programCmds) const;
 
   private:
 
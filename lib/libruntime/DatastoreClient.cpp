@@ -15,11 +15,17 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <FreeNOS/User.h>
+#include <Atomic.h>
 #include <MemoryBlock.h>
 #include <ChannelClient.h>
 #include <DatastoreMessage.h>
 #include "DatastoreClient.h"
 
+const Datastore::ValueTable * DatastoreClient::m_values = ZERO;
+
+ProcessID DatastoreClient::m_valuesPid = ANY;
+
 DatastoreClient::DatastoreClient(const ProcessID pid)
     : m_pid(pid)
 {
@@ -45,3 +51,178 @@ Datastore::Result DatastoreClient::registerBuffer(const char *key,
         return Datastore::IpcError;
     }
 }
+
+Datastore::Result DatastoreClient::setValue(const char *key,
+                                            const void *value,
+                                            const Size size) const
+{
+    if (size > Datastore::MaximumValueSize)
+    {
+        return Datastore::InvalidArgument;
+    }
+
+    DatastoreMessage msg;
+    msg.type   = ChannelMessage::Request;
+    msg.action = Datastore::SetValue;
+    msg.size   = size;
+    MemoryBlock::copy(msg.key, (char *) key, sizeof(msg.key));
+    MemoryBlock::copy(msg.value, value, size);
+
+    if (ChannelClient::instance()->syncSendReceive(&msg, sizeof(msg), m_pid) == ChannelClient::Success)
+    {
+        return msg.result;
+    }
+    else
+    {
+        return Datastore::IpcError;
+    }
+}
+
+Datastore::Result DatastoreClient::getValue(const char *key,
+                                            void *value,
+                                            Size & size) const
+{
+    const Datastore::ValueTable *table = mapValues();
+
+    if (!table)
+    {
+        return Datastore::IpcError;
+    }
+
+    for (Size i = 0; i < Datastore::MaximumValues; i++)
+    {
+        const Datastore::Value *entry = &table->values[i];
+        u32 sequence, bytes;
+        bool found;
+
+        // Retry if the server updated the value while reading it
+        do
+        {
+            sequence = entry->sequence;
+            memoryFence(MemoryAcquire);
+
+            found = MemoryBlock::compare(entry->key, key, sizeof(entry->key));
+            bytes = entry->size;
+
+            if (found && bytes <= size)
+            {
+                MemoryBlock::copy(value, entry->data, bytes);
+            }
+
+            memoryFence(MemoryAcquire);
+        }
+        while ((sequence & 1) || sequence != entry->sequence);
+
+        // Used entries come before unused entries
+        if (sequence == 0)
+        {
+            break;
+        }
+        else if (found)
+        {
+            const bool fits = bytes <= size;
+            size = bytes;
+            return fits ? Datastore::Success : Datastore::InvalidArgument;
+        }
+    }
+
+    return Datastore::NotFound;
+}
+
+Datastore::Result DatastoreClient::createSegment(const char *key,
+                                                 const Size size,
+                                                 const Memory::Access access,
+                                                 Address & address) const
+{
+    DatastoreMessage msg;
+    msg.type   = ChannelMessage::Request;
+    msg.action = Datastore::CreateSegment;
+    msg.size   = size;
+    msg.access = access;
+    MemoryBlock::copy(msg.key, key, sizeof(msg.key));
+
+    if (ChannelClient::instance()->syncSendReceive(&msg, sizeof(msg), m_pid) == ChannelClient::Success)
+    {
+        address = msg.address;
+        return msg.result;
+    }
+    else
+    {
+        return Datastore::IpcError;
+    }
+}
+
+Datastore::Result DatastoreClient::attachSegment(const char *key,
+                                                 const Memory::Access access,
+                                                 Address & address,
+                                                 Size & size) const
+{
+    DatastoreMessage msg;
+    msg.type   = ChannelMessage::Request;
+    msg.action = Datastore::AttachSegment;
+    msg.access = access;
+    MemoryBlock::copy(msg.key, key, sizeof(msg.key));
+
+    if (ChannelClient::instance()->syncSendReceive(&msg, sizeof(msg), m_pid) == ChannelClient::Success)
+    {
+        address = msg.address;
+        size    = msg.size;
+        return msg.result;
+    }
+    else
+    {
+        return Datastore::IpcError;
+    }
+}
+
+Datastore::Result DatastoreClient::detachSegment(const Address address,
+                                                 const Size size) const
+{
+    Memory::Range range;
+    range.virt   = address;
+    range.phys   = 0;
+    range.size   = size;
+    range.access = Memory::None;
+
+    return VMCtl(SELF, Release, &range) == API::Success ?
+        Datastore::Success : Datastore::InvalidArgument;
+}
+
+Datastore::Result DatastoreClient::removeSegment(const char *key) const
+{
+    DatastoreMessage msg;
+    msg.type   = ChannelMessage::Request;
+    msg.action = Datastore::RemoveSegment;
+    MemoryBlock::copy(msg.key, key, sizeof(msg.key));
+
+    if (ChannelClient::instance()->syncSendReceive(&msg, sizeof(msg), m_pid) == ChannelClient::Success)
+    {
+        return msg.result;
+    }
+    else
+    {
+        return Datastore::IpcError;
+    }
+}
+
+const Datastore::ValueTable * DatastoreClient::mapValues() const
+{
+    if (m_values && m_valuesPid == m_pid)
+    {
+        return m_values;
+    }
+
+    DatastoreMessage msg;
+    msg.type   = ChannelMessage::Request;
+    msg.action = Datastore::MapValues;
+
+    if (ChannelClient::instance()->syncSendReceive(&msg, sizeof(msg), m_pid) == ChannelClient::Success &&
+        msg.result == Datastore::Success)
+    {
+        m_values = (const Datastore::ValueTable *) msg.address;
+        m_valuesPid = m_pid;
+        return m_values;
+    }
+
+    return ZERO;
+}
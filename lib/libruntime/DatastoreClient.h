@@ -35,6 +35,9 @@
  * Datastore client
  *
  * Provides a simple interface to the datastore server
+ *
+ * Shared values are read directly from the shared value table, which
+ * is mapped on first use. Only updates are sent to the server.
  */
 class DatastoreClient
 {
@@ -56,10 +59,108 @@ class DatastoreClient
                                      void *buffer,
                                      const Size size) const;
 
+    /**
+     * Add or update a shared value.
+     *
+     * @param key Key of the value
+     * @param value Data of the value
+     * @param size Number of bytes of data
+     *
+     * @return Result code
+     */
+    Datastore::Result setValue(const char *key,
+                               const void *value,
+                               const Size size) const;
+
+    /**
+     * Read a shared value without contacting the server.
+     *
+     * @param key Key of the value
+     * @param value Output buffer for the data
+     * @param size Size of the output buffer on input.
+     *             On output, the number of bytes of the value.
+     *
+     * @return Result code
+     */
+    Datastore::Result getValue(const char *key,
+                               void *value,
+                               Size & size) const;
+
+    /**
+     * Create a shared memory segment and attach it.
+     *
+     * @param key Name of the segment
+     * @param size Number of bytes in the segment
+     * @param access Access of other processes to the segment
+     * @param address On output, the address of the segment
+     *
+     * @return Result code
+     */
+    Datastore::Result createSegment(const char *key,
+                                    const Size size,
+                                    const Memory::Access access,
+                                    Address & address) const;
+
+    /**
+     * Attach an existing shared memory segment.
+     *
+     * @param key Name of the segment
+     * @param access Access to the segment, must include Memory::Readable
+     * @param address On output, the address of the segment
+     * @param size On output, the number of bytes in the segment
+     *
+     * @return Result code
+     */
+    Datastore::Result attachSegment(const char *key,
+                                    const Memory::Access access,
+                                    Address & address,
+                                    Size & size) const;
+
+    /**
+     * Detach a shared memory segment.
+     *
+     * The memory is freed after the last process detached
+     * and the segment is removed.
+     *
+     * @param address Address of the segment
+     * @param size Number of bytes in the segment
+     *
+     * @return Result code
+     */
+    Datastore::Result detachSegment(const Address address,
+                                    const Size size) const;
+
+    /**
+     * Remove a shared memory segment.
+     *
+     * Only the creator can remove a segment. Processes which
+     * attached the segment can still use it until they detach.
+     *
+     * @param key Name of the segment
+     *
+     * @return Result code
+     */
+    Datastore::Result removeSegment(const char *key) const;
+
+  private:
+
+    /**
+     * Map the shared value table of the server.
+     *
+     * @return Pointer to the table on success, ZERO on failure.
+     */
+    const Datastore::ValueTable * mapValues() const;
+
   private:
 
     /** Process identifier of the datastore server */
     const ProcessID m_pid;
+
+    /** Shared value table, mapped once per process */
+    static const Datastore::ValueTable *m_values;
+
+    /** Process identifier of the server of the mapped table */
+    static ProcessID m_valuesPid;
 };
 
 /**
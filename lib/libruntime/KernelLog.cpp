@@ -21,6 +21,8 @@
 KernelLog::KernelLog()
     : Log()
 {
+    // Each write is a system call. Servers flush before sleeping
+    setBatched(true);
 }
 
 void KernelLog::write(const char *str)
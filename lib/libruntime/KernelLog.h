@@ -30,6 +30,9 @@
 
 /**
  * Log to the kernel using PrivExec().
+ *
+ * Lines are batched to save system calls. ChannelServer and ChannelClient
+ * flush them before the process sleeps.
  */
 class KernelLog : public Log
 {
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include <String.h>
+#include <ChannelClient.h>
+#include <KeyValueMessage.h>
+#include "DatastoreClient.h"
+#include "KeyValueClient.h"
+
+ProcessID KeyValueClient::m_pid = ANY;
+
+KeyValueClient::KeyValueClient()
+{
+}
+
+KeyValue::Result KeyValueClient::get(const char *key,
+                                     void *value,
+                                     Size & size) const
+{
+    return request(KeyValue::Get, key, value, size);
+}
+
+KeyValue::Result KeyValueClient::put(const char *key,
+                                     const void *value,
+                                     const Size size) const
+{
+    Size sz = size;
+
+    if (size > KeyValue::MaximumValueSize)
+    {
+        return KeyValue::InvalidArgument;
+    }
+
+    return request(KeyValue::Put, key, (void *) value, sz);
+}
+
+KeyValue::Result KeyValueClient::remove(const char *key) const
+{
+    Size size = 0;
+
+    return request(KeyValue::Delete, key, ZERO, size);
+}
+
+KeyValue::Result KeyValueClient::sync() const
+{
+    Size size = 0;
+
+    return request(KeyValue::Sync, ZERO, ZERO, size);
+}
+
+KeyValue::Result KeyValueClient::request(const KeyValue::Action action,
+                                         const char *key,
+                                         void *value,
+                                         Size & size) const
+{
+    const ProcessID pid = getServer();
+    KeyValueMessage msg;
+
+    if (pid == ANY)
+    {
+        return KeyValue::IpcError;
+    }
+
+    if (key != ZERO && String::length(key) >= sizeof(msg.key))
+    {
+        return KeyValue::InvalidArgument;
+    }
+
+    msg.type   = ChannelMessage::Request;
+    msg.action = action;
+    msg.size   = action == KeyValue::Put ? size : 0;
+    MemoryBlock::set(msg.key, 0, sizeof(msg.key));
+
+    if (key != ZERO)
+    {
+        MemoryBlock::copy(msg.key, key, String::length(key));
+    }
+
+    if (action == KeyValue::Put)
+    {
+        MemoryBlock::copy(msg.value, value, size);
+    }
+
+    if (ChannelClient::instance()->syncSendReceive(&msg, sizeof(msg), pid) != ChannelClient::Success)
+    {
+        return KeyValue::IpcError;
+    }
+
+    // Only copy the value if it fits
+    if (action == KeyValue::Get && msg.result == KeyValue::Success)
+    {
+        if (msg.size > size)
+        {
+            size = msg.size;
+            return KeyValue::InvalidArgument;
+        }
+
+        MemoryBlock::copy(value, msg.value, msg.size);
+        size = msg.size;
+    }
+    else if (action == KeyValue::Get && msg.result == KeyValue::InvalidArgument)
+    {
+        size = msg.size;
+    }
+
+    return msg.result;
+}
+
+ProcessID KeyValueClient::getServer() const
+{
+    ProcessID pid;
+    Size size = sizeof(pid);
+
+    if (m_pid != ANY)
+    {
+        return m_pid;
+    }
+
+    if (DatastoreClient().getValue(KeyValue::ServerKey, &pid, size) == Datastore::Success &&
+        size == sizeof(pid))
+    {
+        m_pid = pid;
+    }
+
+    return m_pid;
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBRUNTIME_KEYVALUECLIENT_H
+#define __LIB_LIBRUNTIME_KEYVALUECLIENT_H
+
+#include <FreeNOS/API/ProcessID.h>
+#include <Types.h>
+#include <KeyValue.h>
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libruntime
+ * @{
+ */
+
+/**
+ * Key-value store client
+ *
+ * Provides a simple interface to the key-value store server.
+ *
+ * The ProcessID of the server is read from the shared Datastore value
+ * KeyValue::ServerKey on first use. Updates return once they are durable.
+ */
+class KeyValueClient
+{
+  public:
+
+    /**
+     * Class constructor function.
+     */
+    KeyValueClient();
+
+    /**
+     * Read a value.
+     *
+     * @param key Key of the value
+     * @param value Output buffer for the data
+     * @param size Size of the output buffer on input.
+     *             On output, the number of bytes of the value.
+     *
+     * @return Result code
+     */
+    KeyValue::Result get(const char *key,
+                         void *value,
+                         Size & size) const;
+
+    /**
+     * Add or update a value.
+     *
+     * @param key Key of the value
+     * @param value Data of the value
+     * @param size Number of bytes of data
+     *
+     * @return Result code
+     */
+    KeyValue::Result put(const char *key,
+                         const void *value,
+                         const Size size) const;
+
+    /**
+     * Delete a value.
+     *
+     * @param key Key of the value
+     *
+     * @return Result code
+     */
+    KeyValue::Result remove(const char *key) const;
+
+    /**
+     * Wait until all updates sent before are durable.
+     *
+     * @return Result code
+     */
+    KeyValue::Result sync() const;
+
+  private:
+
+    /**
+     * Send a request and wait for the reply.
+     *
+     * @param action Action to perform
+     * @param key Key of the value or ZERO
+     * @param value Data of the value, output buffer, or ZERO
+     * @param size Number of bytes of the value. On output,
+     *             the number of bytes of the value in the reply.
+     *
+     * @return Result code
+     */
+    KeyValue::Result request(const KeyValue::Action action,
+                             const char *key,
+                             void *value,
+                             Size & size) const;
+
+    /**
+     * Find the ProcessID of the server.
+     *
+     * @return ProcessID or ANY if not running
+     */
+    ProcessID getServer() const;
+
+  private:
+
+    /** Process identifier of the server, found once per process */
+    static ProcessID m_pid;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBRUNTIME_KEYVALUECLIENT_H */
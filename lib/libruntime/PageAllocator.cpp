@@ -55,7 +55,7 @@ Allocator::Result PageAllocator::allocate(Allocator::Range & args)
     range.access = Memory::User | Memory::Readable | Memory::Writable;
     range.virt   = base() + m_allocated;
     range.phys   = ZERO;
-    const API::Result r = VMCtl(SELF, MapSparse, &range);
+    const API::Result r = VMCtl(SELF, MapDemand, &range);
     if (r != API::Success)
     {
         ERROR("failed to allocate memory using VMCtl(): " << (int)r);
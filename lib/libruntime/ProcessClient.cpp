@@ -20,35 +20,39 @@
 #include <Macros.h>
 #include "ProcessClient.h"
 
-const ProcessID ProcessClient::m_pid = ProcessCtl(SELF, GetPID, 0);
+ProcessID ProcessClient::m_pid = ANY;
 
-const ProcessID ProcessClient::m_parent = ProcessCtl(SELF, GetParent, 0);
+ProcessID ProcessClient::m_parent = ANY;
 
 ProcessID ProcessClient::getProcessID() const
 {
+    if (m_pid == ANY)
+        m_pid = ProcessCtl(SELF, GetPID, 0);
+
     return m_pid;
 }
 
 ProcessID ProcessClient::getParentID() const
 {
+    if (m_parent == ANY)
+        m_parent = ProcessCtl(SELF, GetParent, 0);
+
     return m_parent;
 }
 
+void ProcessClient::setProcessIDs(const ProcessID pid, const ProcessID parent)
+{
+    m_pid = pid;
+    m_parent = parent;
+}
+
 ProcessClient::Result ProcessClient::processInfo(const ProcessID pid,
                                                  ProcessClient::Info &info) const
 {
 #ifndef __HOST__
-    const char * textStates[] = {
-        "Ready",
-        "Sleeping",
-        "Waiting",
-        "Stopped"
-    };
-    const Arch::MemoryMap map;
-    const Memory::Range range = map.range(MemoryMap::UserArgs);
-    char cmd[128];
+    ProcessInfo state;
 
-    const API::Result result = ProcessCtl(pid, InfoPID, (Address) &info.kernelState);
+    const API::Result result = ProcessCtl(pid, InfoPID, (Address) &state);
     switch (result)
     {
         case API::Success:
@@ -59,15 +63,55 @@ ProcessClient::Result ProcessClient::processInfo(const ProcessID pid,
             return IOError;
     }
 
+    return processInfo(state, info);
+#else
+    return Success;
+#endif /* __HOST__ */
+}
+
+ProcessClient::Result ProcessClient::processInfo(const ProcessInfo &state,
+                                                 ProcessClient::Info &info) const
+{
+#ifndef __HOST__
+    const char * textStates[] = {
+        "Ready",
+        "Sleeping",
+        "Waiting",
+        "Stopped"
+    };
+    const Arch::MemoryMap map;
+    const Memory::Range range = map.range(MemoryMap::UserArgs);
+    char cmd[128];
+
     // Read the full command
-    if (VMCopy(pid, API::Read, (Address) cmd, range.virt, sizeof(cmd)) != API::Success)
+    if (VMCopy(state.id, API::Read, (Address) cmd, range.virt, sizeof(cmd)) != API::Success)
     {
         return IOError;
     }
 
     // Fill output
+    info.kernelState = state;
     info.command = cmd;
-    info.textState = (pid == m_pid ? "Running" : textStates[info.kernelState.state]);
+    info.textState = (state.id == m_pid ? "Running" : textStates[state.state]);
+#endif /* __HOST__ */
+
+    return Success;
+}
+
+ProcessClient::Result ProcessClient::listProcesses(ProcessInfo *states,
+                                                   Size &count) const
+{
+#ifndef __HOST__
+    const API::Result result = ProcessCtl(SELF, ListPIDs, (Address) states, count);
+
+    if ((result & 0xffff) != API::Success)
+    {
+        return IOError;
+    }
+
+    count = result >> 16;
+#else
+    count = 0;
 #endif /* __HOST__ */
 
     return Success;
@@ -76,17 +120,30 @@ ProcessClient::Result ProcessClient::processInfo(const ProcessID pid,
 ProcessClient::Result ProcessClient::processInfo(const String program,
                                                  ProcessClient::Info &info) const
 {
+    ProcessInfo *states = new ProcessInfo[MaximumProcesses];
+    Size count = MaximumProcesses;
+    Result result = NotFound;
+
+    if (!states)
+    {
+        return IOError;
+    }
+
     // Loop processes
-    for (ProcessID i = 0; i < MaximumProcesses; i++)
+    if (listProcesses(states, count) == Success)
     {
-        const Result result = processInfo(i, info);
-        if (result == Success && info.command.equals(program))
+        for (Size i = 0; i < count; i++)
         {
-            return result;
+            if (processInfo(states[i], info) == Success && info.command.equals(program))
+            {
+                result = Success;
+                break;
+            }
         }
     }
 
-    return NotFound;
+    delete[] states;
+    return result;
 }
 
 ProcessID ProcessClient::findProcess(const String program) const
@@ -103,3 +160,40 @@ ProcessID ProcessClient::findProcess(const String program) const
         return ANY;
     }
 }
+
+Address ProcessClient::heapProfileAddress()
+{
+#ifndef __HOST__
+    const Arch::MemoryMap map;
+    const Memory::Range heap = map.range(MemoryMap::UserHeap);
+
+    return heap.virt + PAGESIZE - sizeof(ProfileAllocator::Profile);
+#else
+    return ZERO;
+#endif /* __HOST__ */
+}
+
+ProcessClient::Result ProcessClient::heapProfile(const ProcessID pid,
+                                                 ProfileAllocator::Profile &profile) const
+{
+#ifndef __HOST__
+    const API::Result result = VMCopy(pid, API::Read, (Address) &profile,
+                                      heapProfileAddress(), sizeof(profile));
+    switch (result)
+    {
+        case API::Success:
+            break;
+        case API::NotFound:
+            return NotFound;
+        default:
+            return IOError;
+    }
+
+    if (profile.signature != ProfileAllocator::ProfileSignature)
+    {
+        return NotFound;
+    }
+#endif /* __HOST__ */
+
+    return Success;
+}
@@ -22,6 +22,7 @@
 #include <FreeNOS/ProcessManager.h>
 #include <Types.h>
 #include <String.h>
+#include <ProfileAllocator.h>
 
 /**
  * @addtogroup lib
@@ -85,6 +86,17 @@ class ProcessClient
      */
     ProcessID getParentID() const;
 
+    /**
+     * Set the cached process identifiers
+     *
+     * Used by the runtime which retrieves them together with
+     * other kernel calls at startup.
+     *
+     * @param pid Current Process ID
+     * @param parent Parent Process ID
+     */
+    static void setProcessIDs(const ProcessID pid, const ProcessID parent);
+
     /**
      * Get process information by its ID.
      *
@@ -95,6 +107,33 @@ class ProcessClient
      */
     Result processInfo(const ProcessID pid, Info &info) const;
 
+    /**
+     * Get process information from a kernel state.
+     *
+     * Completes the information returned by listProcesses()
+     * with the command and textual state of the process.
+     *
+     * @param state Process state retrieved from the kernel
+     * @param info Process information output
+     *
+     * @return Result code
+     */
+    Result processInfo(const ProcessInfo &state, Info &info) const;
+
+    /**
+     * Get the kernel state of all processes at once.
+     *
+     * Uses a single kernel call instead of one for each possible
+     * process identifier. The states are ordered by process identifier.
+     *
+     * @param states Output array of process states
+     * @param count On input the number of entries in the array.
+     *              On output the number of processes found.
+     *
+     * @return Result code
+     */
+    Result listProcesses(ProcessInfo *states, Size &count) const;
+
     /**
      * Get process information by its program name
      *
@@ -121,13 +160,35 @@ class ProcessClient
      */
     ProcessID findProcess(const String program) const;
 
+    /**
+     * Get the address of the heap profile in every process.
+     *
+     * The profile is stored at the end of the first heap page,
+     * which also holds the heap allocators.
+     *
+     * @return Virtual address
+     */
+    static Address heapProfileAddress();
+
+    /**
+     * Read the heap profile of a process.
+     *
+     * Only programs built with HEAPPROF=True have a heap profile.
+     *
+     * @param pid Process identifier of the process.
+     * @param profile Heap profile output
+     *
+     * @return Result code. NotFound if the process has no heap profile.
+     */
+    Result heapProfile(const ProcessID pid, ProfileAllocator::Profile &profile) const;
+
   private:
 
-    /** Our own process identifier */
-    static const ProcessID m_pid;
+    /** Our own process identifier, retrieved on first use */
+    static ProcessID m_pid;
 
-    /** Our parent process identifier */
-    static const ProcessID m_parent;
+    /** Our parent process identifier, retrieved on first use */
+    static ProcessID m_parent;
 };
 
 /**
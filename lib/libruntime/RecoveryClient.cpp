@@ -45,3 +45,15 @@ Recovery::Result RecoveryClient::restartProcess(const ProcessID pid) const
 
     return request(msg);
 }
+
+Recovery::Result RecoveryClient::checkpoint(const void *address,
+                                            const Size size) const
+{
+    RecoveryMessage msg;
+    msg.type        = ChannelMessage::Request;
+    msg.action      = Recovery::Checkpoint;
+    msg.address     = (Address) address;
+    msg.size        = size;
+
+    return request(msg);
+}
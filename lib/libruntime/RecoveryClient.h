@@ -57,6 +57,21 @@ class RecoveryClient
      */
     Recovery::Result restartProcess(const ProcessID pid) const;
 
+    /**
+     * Take a snapshot of a region of static data in this process.
+     *
+     * The last snapshot of each region is restored when the
+     * process is restarted. Taking another snapshot of the same
+     * region replaces it.
+     *
+     * @param address Start of the region
+     * @param size Number of bytes in the region
+     *
+     * @return Result code
+     */
+    Recovery::Result checkpoint(const void *address,
+                                const Size size) const;
+
   private:
 
     /**
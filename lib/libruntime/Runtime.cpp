@@ -21,10 +21,12 @@
 #include <Array.h>
 #include <FileSystemClient.h>
 #include <PoolAllocator.h>
+#include <ProfileAllocator.h>
 #include <FileSystemMount.h>
 #include <FileDescriptor.h>
 #include <MemoryMap.h>
 #include <Memory.h>
+#include <ClockPage.h>
 #include <Randomizer.h>
 #include "ProcessClient.h"
 #include "PageAllocator.h"
@@ -113,23 +115,46 @@ void setupHeap()
     range.access = Memory::User | Memory::Readable | Memory::Writable;
     range.virt   = heap.virt;
     range.phys   = ZERO;
-    const API::Result result = VMCtl(SELF, MapContiguous, &range);
-    if (result != API::Success)
+
+    // Retrieve the process identifiers in the same kernel call
+    MultiCallEntry calls[] =
+    {
+        { API::VMCtlNumber, { SELF, MapContiguous, (Address) &range, 0, 0 }, 0, API::InvalidArgument },
+        { API::ProcessCtlNumber, { SELF, GetPID, 0, 0, 0 }, MULTICALL_IGNORE_ERROR, ANY },
+        { API::ProcessCtlNumber, { SELF, GetParent, 0, 0, 0 }, MULTICALL_IGNORE_ERROR, ANY }
+    };
+    MultiCall(calls, 3);
+
+    if (calls[0].result != API::Success)
     {
         PrivExec(WriteConsole, (Address) ("failed to allocate pages for heap: terminating"));
         ProcessCtl(SELF, KillPID);
     }
+    ProcessClient::setProcessIDs(calls[1].result, calls[2].result);
 
     // Allocate instance copy on vm pages itself
     pageAlloc = new (heap.virt) PageAllocator(pageRange);
     poolAlloc = new (heap.virt + sizeof(PageAllocator)) PoolAllocator(pageAlloc);
 
+#ifdef __HEAPPROF__
+    // The profile is stored at the end of the same page, where other processes can read it
+    static_assert(sizeof(PageAllocator) + sizeof(PoolAllocator) + sizeof(ProfileAllocator) +
+                  sizeof(ProfileAllocator::Profile) <= PAGESIZE, "heap allocators must fit in one page");
+
+    ProfileAllocator *profileAlloc = new (heap.virt + sizeof(PageAllocator) + sizeof(PoolAllocator))
+        ProfileAllocator(poolAlloc, (ProfileAllocator::Profile *) ProcessClient::heapProfileAddress());
+
+    // Set default allocator
+    Allocator::setDefault(profileAlloc);
+#else
     // Set default allocator
     Allocator::setDefault(poolAlloc);
+#endif /* __HEAPPROF__ */
 }
 
 void setupMappings()
 {
+    const ProcessClient proc;
     FileSystemClient filesystem;
 
     // Map user program arguments
@@ -140,18 +165,17 @@ void setupMappings()
     // Second page is the current working directory
     filesystem.setCurrentDirectory(new String((char *) argRange.virt + PAGESIZE, false));
 
-    // Third page and above contain the file descriptors table
+    // Third page and above contain the file descriptors table, which is
+    // backed on demand. Inherit the entries in use by the parent (if any).
+    // Without a parent, the table is cleared by the kernel.
+    const Size inherited = proc.getParentID() != 0 ? *(Size *) (argRange.virt + ARGV_FILES) : 0;
+
     FileDescriptor::instance()->setArray((FileDescriptor::Entry *) (argRange.virt + (PAGESIZE * 2)),
-                                         (argRange.size - (PAGESIZE * 2)) / sizeof(FileDescriptor::Entry));
+                                         (argRange.size - (PAGESIZE * 2)) / sizeof(FileDescriptor::Entry),
+                                         inherited);
 
-    // Inherit file descriptors table from parent (if any).
-    // Without a parent, just clear the file descriptors
-    if (ProcessCtl(SELF, GetParent) == 0)
+    if (proc.getParentID() == 0)
     {
-        Size count = 0;
-        FileDescriptor::Entry *array = FileDescriptor::instance()->getArray(count);
-
-        MemoryBlock::set(array, 0, count * sizeof(FileDescriptor::Entry));
         filesystem.setCurrentDirectory(String("/"));
     }
 }
@@ -161,11 +185,12 @@ void setupRandomizer()
     const ProcessClient proc;
     const ProcessID pid = proc.getProcessID();
 
-    Timer::Info timer;
-    ProcessCtl(SELF, InfoTimer, (Address) &timer);
+    // Read the timer from the clock page, which needs no kernel call
+    const Arch::MemoryMap map;
+    const ClockPage *clock = (const ClockPage *) map.range(MemoryMap::UserClock).virt;
 
     Randomizer rand;
-    rand.seed(pid + timer.ticks);
+    rand.seed(pid + clock->ticks + (ulong) clock->timestamp);
 }
 
 extern C void SECTION(".entry") _entry()
@@ -203,5 +228,6 @@ extern C void SECTION(".entry") _entry()
 
     // Terminate execution
     runDestructors();
+    FileSystemClient().closeFiles();
     ProcessCtl(SELF, KillPID, ret);
 }
@@ -35,6 +35,9 @@
 /** Number of arguments at maximum. */
 #define ARGV_COUNT (PAGESIZE / ARGV_SIZE)
 
+/** Offset in the arguments region of the number of inherited file descriptor entries. */
+#define ARGV_FILES ((PAGESIZE * 2) - sizeof(Size))
+
 /**
  * Program entry point.
  *
@@ -17,6 +17,7 @@
 
 #include "Assert.h"
 #include "BitArray.h"
+#include "BitOperations.h"
 #include "MemoryBlock.h"
 
 BitArray::BitArray(const Size bitCount, u8 *array)
@@ -25,6 +26,7 @@ BitArray::BitArray(const Size bitCount, u8 *array)
     m_allocated = (array == ZERO);
     m_bitCount  = bitCount;
     m_set = 0;
+    m_rangeWords = 1;
 
     clear();
 }
@@ -61,14 +63,22 @@ void BitArray::set(const Size bit, const bool value)
     // Update the bit only if needed (and update administration)
     if (current != value)
     {
+        const Size range = (bit / WordBits) / m_rangeWords;
+
         if (value)
         {
             m_array[bit / 8] |= 1 << (bit % 8);
             m_set++;
+
+            if (readWord(bit / WordBits) == 0xffffffff)
+            {
+                updateSummary(range);
+            }
         }
         else
         {
             m_array[bit / 8] &= ~(1 << (bit % 8));
+            m_summary[range / WordBits] &= ~(1U << (range % WordBits));
             m_set--;
         }
     }
@@ -99,65 +109,37 @@ BitArray::Result BitArray::setNext(Size *bit,
                                    const Size start,
                                    const Size boundary)
 {
-    Size from = 0, found = 0;
+    const Size num = count ? count : 1;
+    const Size align = boundary ? boundary : 1;
 
-    // Loop BitArray for unset bits
-    for (Size i = start; i < m_bitCount;)
+    // Try each unset bit on the boundary as the start of a free run
+    for (Size i = findUnset(start); i < m_bitCount; i = findUnset(i))
     {
-        // Try to fast-forward 32 bits to search
-        if (m_bitCount > 32 && i < m_bitCount - 32 && ((u32 *)m_array)[i / 32] == 0xffffffff)
+        if (i % align)
         {
-            from = found = 0;
-
-            if (i & 31)
-                i += (32 - (i % 32));
-            else
-                i += 32;
+            i += align - (i % align);
             continue;
         }
-        // Try to fast-forward 8 bits to search
-        else if (m_bitCount > 8 && i < m_bitCount - 8 && m_array[i / 8] == 0xff)
-        {
-            from = found = 0;
 
-            if (i & 7)
-                i += (8 - (i % 8));
-            else
-                i += 8;
-            continue;
-        }
-        else if (!isSet(i))
+        // The run may not extend beyond the end of the array
+        if (num > m_bitCount - i)
         {
-            // Remember this bit
-            if (!found)
-            {
-                if (!(i % boundary))
-                {
-                    from  = i;
-                    found = 1;
-                }
-            }
-            else
-            {
-                found++;
-            }
-
-            // Are there enough contigious bits?
-            if (found >= count)
-            {
-                setRange(from, i);
-                *bit = from;
-                return Success;
-            }
+            break;
         }
-        else
+
+        // Are there enough contigious bits?
+        const Size used = findSet(i, i + num);
+        if (used == i + num)
         {
-            from = found = 0;
+            setRange(i, i + num - 1);
+            *bit = i;
+            return Success;
         }
 
-        // Move to the next bit
-        i++;
+        // Continue after the set bit which ended the run
+        i = used + 1;
     }
+
     // No unset bits left!
     return OutOfMemory;
 }
@@ -194,6 +176,8 @@ void BitArray::setArray(u8 *map, const Size bitCount)
             m_set++;
         }
     }
+
+    resetSummary();
 }
 
 void BitArray::clear()
@@ -203,6 +187,8 @@ void BitArray::clear()
 
     // Reset set count
     m_set = 0;
+
+    resetSummary();
 }
 
 bool BitArray::operator[](const Size bit) const
@@ -224,3 +210,116 @@ inline Size BitArray::calculateBitmapSize(const Size bitCount) const
     else
         return bytes;
 }
+
+u32 BitArray::readWord(const Size word) const
+{
+    const Size bytes = calculateBitmapSize(m_bitCount);
+    const Size first = word * sizeof(u32);
+    const Size last = word * WordBits;
+    u32 value = 0;
+
+    // Assemble from bytes, as the array may be unaligned or end inside the word
+    for (Size i = 0; i < sizeof(u32) && first + i < bytes; i++)
+    {
+        value |= (u32) m_array[first + i] << (i * 8);
+    }
+
+    // Bits beyond the end of the array read as set
+    if (m_bitCount - last < WordBits)
+    {
+        value |= 0xffffffff << (m_bitCount - last);
+    }
+
+    return value;
+}
+
+Size BitArray::findUnset(const Size from) const
+{
+    const Size words = (m_bitCount + WordBits - 1) / WordBits;
+    Size word = from / WordBits;
+    u32 mask = 0xffffffff << (from % WordBits);
+
+    while (word < words)
+    {
+        const Size range = word / m_rangeWords;
+
+        // Skip over ranges of words which are completely set
+        if (m_summary[range / WordBits] & (1U << (range % WordBits)))
+        {
+            const u32 ranges = ~m_summary[range / WordBits] & (0xffffffff << (range % WordBits));
+            const Size next = ranges ? (range - (range % WordBits)) + countTrailingZeros(ranges)
+                                     : (range - (range % WordBits)) + WordBits;
+
+            word = next * m_rangeWords;
+            mask = 0xffffffff;
+            continue;
+        }
+
+        const u32 unset = ~readWord(word) & mask;
+        if (unset)
+        {
+            return (word * WordBits) + countTrailingZeros(unset);
+        }
+
+        word++;
+        mask = 0xffffffff;
+    }
+
+    return m_bitCount;
+}
+
+Size BitArray::findSet(const Size from, const Size to) const
+{
+    Size word = from / WordBits;
+    u32 mask = 0xffffffff << (from % WordBits);
+
+    while (word * WordBits < to)
+    {
+        const u32 set = readWord(word) & mask;
+        if (set)
+        {
+            const Size bit = (word * WordBits) + countTrailingZeros(set);
+            return bit < to ? bit : to;
+        }
+
+        word++;
+        mask = 0xffffffff;
+    }
+
+    return to;
+}
+
+void BitArray::updateSummary(const Size range)
+{
+    const Size words = (m_bitCount + WordBits - 1) / WordBits;
+    const Size first = range * m_rangeWords;
+    const Size last = first + m_rangeWords < words ? first + m_rangeWords : words;
+
+    for (Size i = first; i < last; i++)
+    {
+        if (readWord(i) != 0xffffffff)
+        {
+            return;
+        }
+    }
+
+    m_summary[range / WordBits] |= 1U << (range % WordBits);
+}
+
+void BitArray::resetSummary()
+{
+    const Size words = (m_bitCount + WordBits - 1) / WordBits;
+
+    m_rangeWords = (words + SummaryBits - 1) / SummaryBits;
+    if (!m_rangeWords)
+    {
+        m_rangeWords = 1;
+    }
+
+    MemoryBlock::set(m_summary, 0, sizeof(m_summary));
+
+    for (Size i = 0; i * m_rangeWords < words; i++)
+    {
+        updateSummary(i);
+    }
+}
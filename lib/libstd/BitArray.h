@@ -32,9 +32,21 @@
 
 /**
  * Represents an array of bits.
+ *
+ * Searches for unset bits examine a 32-bit word at a time. For large arrays,
+ * a summary bitmap with one bit per range of words marks the ranges in
+ * which all bits are set, such that these are skipped entirely.
  */
 class BitArray
 {
+  private:
+
+    /** Number of bits in a bitmap word */
+    static const Size WordBits = sizeof(u32) * 8;
+
+    /** Maximum number of word ranges in the summary bitmap */
+    static const Size SummaryBits = 256;
+
   public:
 
     /**
@@ -174,6 +186,48 @@ class BitArray
      */
     Size calculateBitmapSize(const Size bitCount) const;
 
+    /**
+     * Read a word of the array.
+     *
+     * Bits beyond the end of the array read as set.
+     *
+     * @param word Word number to read.
+     *
+     * @return Word value.
+     */
+    u32 readWord(const Size word) const;
+
+    /**
+     * Find the first unset bit.
+     *
+     * @param from Bit number to start searching at.
+     *
+     * @return Bit number of the first unset bit or the number of bits if none.
+     */
+    Size findUnset(const Size from) const;
+
+    /**
+     * Find the first set bit in a range.
+     *
+     * @param from Bit number to start searching at.
+     * @param to End bit number (exclusive).
+     *
+     * @return Bit number of the first set bit or the end bit number if none.
+     */
+    Size findSet(const Size from, const Size to) const;
+
+    /**
+     * Update the summary bit of a range of words.
+     *
+     * @param range Number of the word range.
+     */
+    void updateSummary(const Size range);
+
+    /**
+     * Recalculate the summary bitmap for the whole array.
+     */
+    void resetSummary();
+
   private:
 
     /** Total number of bits in the array. */
@@ -187,6 +241,12 @@ class BitArray
 
     /** True if m_array was allocated interally. */
     bool m_allocated;
+
+    /** Number of words covered by a single summary bit. */
+    Size m_rangeWords;
+
+    /** Summary bitmap with a bit set for each range of words that is completely set. */
+    u32 m_summary[SummaryBits / WordBits];
 };
 
 /**
@@ -18,6 +18,8 @@
 #ifndef __BIT_OPERATIONS_H
 #define __BIT_OPERATIONS_H
 
+#include "Types.h"
+
 /**
  * @addtogroup lib
  * @{
@@ -34,6 +36,30 @@ template<class T> inline T& operator|= (T& a, T b) { return (T&)((int&)a |= (int
 template<class T> inline T& operator&= (T& a, T b) { return (T&)((int&)a &= (int)b); }
 template<class T> inline T& operator^= (T& a, T b) { return (T&)((int&)a ^= (int)b); }
 
+/**
+ * Count the number of trailing zero bits.
+ *
+ * @param value Input value, which must not be zero.
+ *
+ * @return Position of the lowest bit which is set.
+ */
+inline Size countTrailingZeros(const u32 value)
+{
+    return __builtin_ctz(value);
+}
+
+/**
+ * Count the number of leading zero bits.
+ *
+ * @param value Input value, which must not be zero.
+ *
+ * @return Number of bits above the highest bit which is set.
+ */
+inline Size countLeadingZeros(const u32 value)
+{
+    return __builtin_clz(value);
+}
+
 /**
  * @}
  * @}
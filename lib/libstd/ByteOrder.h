@@ -43,6 +43,10 @@
 
 /**
  * Byte swap functions
+ *
+ * The compiler evaluates these for constant input and otherwise
+ * emits a single byte swap instruction, such as bswap or rev.
+ *
  * @{
  */
 
@@ -53,9 +57,7 @@
  *
  * @return Byte-swapped integer value
  */
-#define SWAP16(x) ((u16)(                   \
-        (((u16)(x) & (u16)0x00ffU) << 8) |  \
-        (((u16)(x) & (u16)0xff00U) >> 8)))
+#define SWAP16(x) ((u16) __builtin_bswap16((u16)(x)))
 
 /**
  * Byte swap a 32-bit integer
@@ -64,12 +66,7 @@
  *
  * @return Byte-swapped integer value
  */
-
-#define SWAP32(x) ((u32)(                          \
-        (((u32)(x) & (u32)0x000000ffUL) << 24) |   \
-        (((u32)(x) & (u32)0x0000ff00UL) <<  8) |   \
-        (((u32)(x) & (u32)0x00ff0000UL) >>  8) |   \
-        (((u32)(x) & (u32)0xff000000UL) >> 24)))
+#define SWAP32(x) ((u32) __builtin_bswap32((u32)(x)))
 
 /**
  * Byte swap a 64-bit integer
@@ -78,16 +75,7 @@
  *
  * @return Byte-swapped integer value
  */
-
-#define SWAP64(x) ((u64)(                          \
-        (((u64)(x) & (u64)0x00000000000000ffUL) << 56) |   \
-        (((u64)(x) & (u64)0x000000000000ff00UL) << 40) |   \
-        (((u64)(x) & (u64)0x0000000000ff0000UL) << 24) |   \
-        (((u64)(x) & (u64)0x00000000ff000000UL) <<  8) |   \
-        (((u64)(x) & (u64)0x000000ff00000000UL) >>  8) |   \
-        (((u64)(x) & (u64)0x0000ff0000000000UL) >> 24) |   \
-        (((u64)(x) & (u64)0x00ff000000000000UL) >> 40) |   \
-        (((u64)(x) & (u64)0xff00000000000000UL) >> 56)))
+#define SWAP64(x) ((u64) __builtin_bswap64((u64)(x)))
 
 /**
  * @}
@@ -210,6 +198,76 @@
  * @}
  */
 
+/**
+ * Integer stored in big endian byte order.
+ *
+ * Converts implicitly from and to the CPU byte order, such that
+ * header fields of this type are read and written as plain integers.
+ * Each conversion is a single byte swap and constants are converted
+ * at compile time.
+ *
+ * @note The layout is that of T, so it can be used in packed headers.
+ */
+template <typename T> class BigEndian
+{
+  public:
+
+    /**
+     * Default constructor, leaves the value uninitialized.
+     */
+    BigEndian() = default;
+
+    /**
+     * Constructor
+     *
+     * @param value Integer in CPU byte order
+     */
+    constexpr BigEndian(const T value)
+        : m_value(swap(value))
+    {
+    }
+
+    /**
+     * Get the value in CPU byte order.
+     *
+     * @return Integer in CPU byte order
+     */
+    constexpr operator T() const
+    {
+        return swap(m_value);
+    }
+
+  private:
+
+    /**
+     * Byte swap an integer of type T.
+     *
+     * @param value Integer input
+     *
+     * @return Byte-swapped integer value
+     */
+    static constexpr T swap(const T value)
+    {
+        return sizeof(T) == sizeof(u16) ? (T) SWAP16(value) :
+               sizeof(T) == sizeof(u32) ? (T) SWAP32(value) :
+                                          (T) SWAP64(value);
+    }
+
+  private:
+
+    /** Integer in big endian byte order */
+    T m_value;
+};
+
+/** Unsigned 16-bit big endian integer. */
+typedef BigEndian<u16> be16_t;
+
+/** Unsigned 32-bit big endian integer. */
+typedef BigEndian<u32> be32_t;
+
+/** Unsigned 64-bit big endian integer. */
+typedef BigEndian<u64> be64_t;
+
 /**
  * Memory read/write functions
  *
@@ -218,6 +276,19 @@
  * @{
  */
 
+/**
+ * Integer at an unaligned address.
+ *
+ * The packed attribute lowers the alignment to a single byte, such that
+ * the compiler emits a plain load or store on CPUs which allow unaligned
+ * access and byte accesses otherwise. The may_alias attribute allows
+ * accessing memory of any type through it.
+ */
+template <typename T> struct __attribute__((__packed__, __may_alias__)) Unaligned
+{
+    T value;
+};
+
 /**
  * Read 64-bit integer (no conversion)
  *
@@ -227,9 +298,7 @@
  */
 inline const u64 read64(const void *data)
 {
-    u64 value;
-    MemoryBlock::copy(&value, data, sizeof(value));
-    return value;
+    return ((const Unaligned<u64> *) data)->value;
 }
 
 /**
@@ -241,9 +310,7 @@ inline const u64 read64(const void *data)
  */
 inline const u32 read32(const void *data)
 {
-    u32 value;
-    MemoryBlock::copy(&value, data, sizeof(value));
-    return value;
+    return ((const Unaligned<u32> *) data)->value;
 }
 
 /**
@@ -255,9 +322,7 @@ inline const u32 read32(const void *data)
  */
 inline const u16 read16(const void *data)
 {
-    u16 value;
-    MemoryBlock::copy(&value, data, sizeof(value));
-    return value;
+    return ((const Unaligned<u16> *) data)->value;
 }
 
 /**
@@ -269,9 +334,7 @@ inline const u16 read16(const void *data)
  */
 inline const u8 read8(const void *data)
 {
-    u8 value;
-    MemoryBlock::copy(&value, data, sizeof(value));
-    return value;
+    return ((const Unaligned<u8> *) data)->value;
 }
 
 /**
@@ -282,7 +345,7 @@ inline const u8 read8(const void *data)
  */
 inline void write64(void *data, const u64 input)
 {
-    MemoryBlock::copy(data, &input, sizeof(input));
+    ((Unaligned<u64> *) data)->value = input;
 }
 
 /**
@@ -293,7 +356,7 @@ inline void write64(void *data, const u64 input)
  */
 inline void write32(void *data, const u32 input)
 {
-    MemoryBlock::copy(data, &input, sizeof(input));
+    ((Unaligned<u32> *) data)->value = input;
 }
 
 /**
@@ -304,7 +367,7 @@ inline void write32(void *data, const u32 input)
  */
 inline void write16(void *data, const u16 input)
 {
-    MemoryBlock::copy(data, &input, sizeof(input));
+    ((Unaligned<u16> *) data)->value = input;
 }
 
 /**
@@ -315,7 +378,7 @@ inline void write16(void *data, const u16 input)
  */
 inline void write8(void *data, const u8 input)
 {
-    MemoryBlock::copy(data, &input, sizeof(input));
+    ((Unaligned<u8> *) data)->value = input;
 }
 
 /**
@@ -327,9 +390,7 @@ inline void write8(void *data, const u8 input)
  */
 inline const u64 readLe64(const void *data)
 {
-    u64 value;
-    MemoryBlock::copy(&value, data, sizeof(value));
-    return le64_to_cpu(value);
+    return le64_to_cpu(((const Unaligned<u64> *) data)->value);
 }
 
 /**
@@ -341,9 +402,7 @@ inline const u64 readLe64(const void *data)
  */
 inline const u32 readLe32(const void *data)
 {
-    u32 value;
-    MemoryBlock::copy(&value, data, sizeof(value));
-    return le32_to_cpu(value);
+    return le32_to_cpu(((const Unaligned<u32> *) data)->value);
 }
 
 /**
@@ -355,9 +414,7 @@ inline const u32 readLe32(const void *data)
  */
 inline const u16 readLe16(const void *data)
 {
-    u16 value;
-    MemoryBlock::copy(&value, data, sizeof(value));
-    return le16_to_cpu(value);
+    return le16_to_cpu(((const Unaligned<u16> *) data)->value);
 }
 
 /**
@@ -369,9 +426,7 @@ inline const u16 readLe16(const void *data)
  */
 inline const u64 readBe64(const void *data)
 {
-    u64 value;
-    MemoryBlock::copy(&value, data, sizeof(value));
-    return be64_to_cpu(value);
+    return be64_to_cpu(((const Unaligned<u64> *) data)->value);
 }
 
 /**
@@ -383,9 +438,7 @@ inline const u64 readBe64(const void *data)
  */
 inline const u32 readBe32(const void *data)
 {
-    u32 value;
-    MemoryBlock::copy(&value, data, sizeof(value));
-    return be32_to_cpu(value);
+    return be32_to_cpu(((const Unaligned<u32> *) data)->value);
 }
 
 /**
@@ -397,9 +450,7 @@ inline const u32 readBe32(const void *data)
  */
 inline const u16 readBe16(const void *data)
 {
-    u16 value;
-    MemoryBlock::copy(&value, data, sizeof(value));
-    return be16_to_cpu(value);
+    return be16_to_cpu(((const Unaligned<u16> *) data)->value);
 }
 
 /**
@@ -410,8 +461,7 @@ inline const u16 readBe16(const void *data)
  */
 inline void writeLe64(void *data, const u64 input)
 {
-    const u64 value = cpu_to_le64(input);
-    MemoryBlock::copy(data, &value, sizeof(value));
+    ((Unaligned<u64> *) data)->value = cpu_to_le64(input);
 }
 
 /**
@@ -422,8 +472,7 @@ inline void writeLe64(void *data, const u64 input)
  */
 inline void writeLe32(void *data, const u32 input)
 {
-    const u32 value = cpu_to_le32(input);
-    MemoryBlock::copy(data, &value, sizeof(value));
+    ((Unaligned<u32> *) data)->value = cpu_to_le32(input);
 }
 
 /**
@@ -434,8 +483,7 @@ inline void writeLe32(void *data, const u32 input)
  */
 inline void writeLe16(void *data, const u16 input)
 {
-    const u16 value = cpu_to_le16(input);
-    MemoryBlock::copy(data, &value, sizeof(value));
+    ((Unaligned<u16> *) data)->value = cpu_to_le16(input);
 }
 
 /**
@@ -446,8 +494,7 @@ inline void writeLe16(void *data, const u16 input)
  */
 inline void writeBe64(void *data, const u64 input)
 {
-    const u64 value = cpu_to_be64(input);
-    MemoryBlock::copy(data, &value, sizeof(value));
+    ((Unaligned<u64> *) data)->value = cpu_to_be64(input);
 }
 
 /**
@@ -458,8 +505,7 @@ inline void writeBe64(void *data, const u64 input)
  */
 inline void writeBe32(void *data, const u32 input)
 {
-    const u32 value = cpu_to_be32(input);
-    MemoryBlock::copy(data, &value, sizeof(value));
+    ((Unaligned<u32> *) data)->value = cpu_to_be32(input);
 }
 
 /**
@@ -470,8 +516,7 @@ inline void writeBe32(void *data, const u32 input)
  */
 inline void writeBe16(void *data, const u16 input)
 {
-    const u16 value = cpu_to_be16(input);
-    MemoryBlock::copy(data, &value, sizeof(value));
+    ((Unaligned<u16> *) data)->value = cpu_to_be16(input);
 }
 
 /**
@@ -18,31 +18,77 @@
 #include "Assert.h"
 #include "HashFunction.h"
 
-Size hash(const String & key, Size mod)
+/**
+ * Rotate a 32-bit value to the left.
+ */
+static inline u32 rotate(const u32 value, const Size bits)
 {
-    Size ret  = FNV_INIT;
-    Size size = key.length();
+    return (value << bits) | (value >> (32 - bits));
+}
 
-    assert(mod > 0);
+/**
+ * Mix a single input word.
+ */
+static inline u32 mix(u32 word)
+{
+    word *= 0xcc9e2d51;
+    word  = rotate(word, 15);
+    return word * 0x1b873593;
+}
 
-    for (Size i = 0; i < size; i++)
+Size hash(const String & key)
+{
+    const Size length = key.length();
+    const u8 *data = (const u8 *) *key;
+    u32 ret = HASH_SEED ^ length;
+    u32 word = 0;
+
+    // Whole words first
+    for (Size i = 0; i < length / sizeof(u32); i++, data += sizeof(u32))
+    {
+        word = data[0] | (data[1] << 8) | (data[2] << 16) | ((u32) data[3] << 24);
+        ret ^= mix(word);
+        ret  = rotate(ret, 13) * 5 + 0xe6546b64;
+    }
+
+    // Remaining bytes
+    if (length % sizeof(u32))
     {
-        ret *= FNV_PRIME;
-        ret ^= key[i];
+        word = 0;
+
+        for (Size i = 0; i < length % sizeof(u32); i++)
+            word |= data[i] << (i * 8);
+
+        ret ^= mix(word);
     }
-    return (ret % mod);
+
+    // Spread all input bits over the low bits
+    ret ^= ret >> 16;
+    ret *= 0x85ebca6b;
+    ret ^= ret >> 13;
+    ret *= 0xc2b2ae35;
+    ret ^= ret >> 16;
+    return ret;
 }
 
-Size hash(int key, Size mod)
+Size hash(int key)
 {
-    Size ret = FNV_INIT;
+    u32 ret = (u32) key;
 
+    ret ^= ret >> 16;
+    ret *= HASH_INT_MULTIPLIER;
+    ret ^= ret >> 16;
+    return ret;
+}
+
+Size hash(const String & key, Size mod)
+{
     assert(mod > 0);
+    return hash(key) % mod;
+}
 
-    for (Size i = 0; i < 4; i++)
-    {
-        ret *= FNV_PRIME;
-        ret ^= (((uint) key) >> (i*8)) & 0xff;
-    }
-    return (ret % mod);
+Size hash(int key, Size mod)
+{
+    assert(mod > 0);
+    return hash(key) % mod;
 }
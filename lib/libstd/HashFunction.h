@@ -35,8 +35,36 @@
 /** Initial value of the FNV internal state. */
 #define FNV_INIT  0x811c9dc5
 
+/** Initial value of the string hash state. */
+#define HASH_SEED 0x9747b28c
+
+/** Multiplier used for mixing integer keys. */
+#define HASH_INT_MULTIPLIER 0x45d9f3b
+
+/**
+ * Compute a hash of a string.
+ *
+ * The string is consumed four bytes at a time with a
+ * multiply-rotate mix per word and a final avalanche step,
+ * such that the low bits are suitable for masking.
+ *
+ * @param key Key string to hash.
+ *
+ * @return Computed hash.
+ */
+Size hash(const String & key);
+
+/**
+ * Compute a hash of an integer.
+ *
+ * @param key Integer key to hash.
+ *
+ * @return Computed hash.
+ */
+Size hash(int key);
+
 /**
- * Compute a hash using the FNV algorithm.
+ * Compute a hash of a string within a range.
  *
  * @param key Key string to hash.
  * @param mod Modulo value.
@@ -46,7 +74,7 @@
 Size hash(const String & key, Size mod);
 
 /**
- * Compute a hash using the FNV algorithm.
+ * Compute a hash of an integer within a range.
  *
  * @param key Integer key to hash.
  * @param mod Modulo value.
@@ -20,7 +20,6 @@
 
 #include "Types.h"
 #include "Macros.h"
-#include "Vector.h"
 #include "List.h"
 #include "ListIterator.h"
 #include "HashFunction.h"
@@ -30,6 +29,9 @@
 /** Default size of the HashTable internal table. */
 #define HASHTABLE_DEFAULT_SIZE    64
 
+/** Maximum percentage of used slots before the HashTable grows. */
+#define HASHTABLE_MAXIMUM_LOAD    75
+
 /**
  * @addtogroup lib
  * @{
@@ -40,13 +42,21 @@
 
 /**
  * Efficient key -> value lookups.
+ *
+ * Items are stored inline in a single array of slots using open addressing
+ * with linear probing. The table doubles in size when it becomes too full.
+ * Removal shifts the following items of the probe sequence backwards,
+ * thus no tombstones are needed and lookups stop at the first free slot.
+ * Multiple values for the same key are kept in the order they were added.
+ * The number of slots is always a power of two, such that hashes are
+ * mapped to slots with a mask instead of a division.
  */
 template <class K, class V> class HashTable : public Associative<K,V>
 {
   public:
 
     /**
-     * Describes a bucket in the HashTable, for collision avoidance.
+     * Describes a slot in the HashTable.
      */
     class Bucket
     {
@@ -56,6 +66,7 @@ template <class K, class V> class HashTable : public Associative<K,V>
          * Default constructor.
          */
         Bucket()
+            : home(0), used(false)
         {
         }
 
@@ -66,7 +77,7 @@ template <class K, class V> class HashTable : public Associative<K,V>
          * @param v V of the bucket.
          */
         Bucket(K k, V v)
-            : key(k), value(v)
+            : key(k), value(v), home(0), used(false)
         {
         }
 
@@ -74,7 +85,7 @@ template <class K, class V> class HashTable : public Associative<K,V>
          * Copy constructor.
          */
         Bucket(const Bucket & b)
-            : key(b.key), value(b.value)
+            : key(b.key), value(b.value), home(b.home), used(b.used)
         {
         }
 
@@ -101,23 +112,70 @@ template <class K, class V> class HashTable : public Associative<K,V>
 
         /** Value of the item. */
         V value;
+
+        /** Slot index where the probe sequence of the key starts. */
+        Size home;
+
+        /** True if the slot contains an item. */
+        bool used;
     };
 
     /**
      * Class constructor.
      *
-     * @param size Initial size of the internal table.
+     * @param size Initial size of the internal table, rounded up to a power of two.
      */
     HashTable(Size size = HASHTABLE_DEFAULT_SIZE)
-        : m_table(size)
+        : m_table(ZERO)
+        , m_size(1)
+        , m_count(0)
+    {
+        while (m_size < size)
+            m_size <<= 1;
+
+        m_table = new Bucket[m_size];
+    }
+
+    /**
+     * Copy constructor.
+     *
+     * @param table HashTable to copy.
+     */
+    HashTable(const HashTable<K,V> & table)
+        : m_table(new Bucket[table.m_size])
+        , m_size(table.m_size)
+        , m_count(table.m_count)
+    {
+        for (Size i = 0; i < m_size; i++)
+            m_table[i] = table.m_table[i];
+    }
+
+    /**
+     * Destructor.
+     */
+    virtual ~HashTable()
     {
-        assert(size > 0);
+        delete[] m_table;
+    }
 
-        m_count = ZERO;
+    /**
+     * Assignment operator.
+     *
+     * @param table HashTable to copy.
+     */
+    HashTable<K,V> & operator = (const HashTable<K,V> & table)
+    {
+        if (this != &table)
+        {
+            delete[] m_table;
+            m_table = new Bucket[table.m_size];
+            m_size = table.m_size;
+            m_count = table.m_count;
 
-        // Fill the Vector with empty Bucket Lists.
-        for (Size i = 0; i < m_table.size(); i++)
-            m_table.insert(List<Bucket>());
+            for (Size i = 0; i < m_size; i++)
+                m_table[i] = table.m_table[i];
+        }
+        return *this;
     }
 
     /**
@@ -132,23 +190,17 @@ template <class K, class V> class HashTable : public Associative<K,V>
      */
     virtual bool insert(const K & key, const V & value)
     {
-
-        Size idx = hash(key, m_table.size());
+        const Size idx = find(key);
 
         // See if the given key exists. Overwrite if so.
-        for (ListIterator<Bucket> i(m_table[idx]); i.hasCurrent(); i++)
+        if (idx != m_size)
         {
-            if (i.current().key == key)
-            {
-                i.current().value = value;
-                return true;
-            }
+            m_table[idx].value = value;
+            return true;
         }
 
-        // Key does not exist. Append it.
-        m_table[idx].append(Bucket(key, value));
-        m_count++;
-        return true;
+        // Key does not exist. Add it.
+        return append(key, value);
     }
 
     /**
@@ -161,9 +213,11 @@ template <class K, class V> class HashTable : public Associative<K,V>
      */
     virtual bool append(const K & key, const V & value)
     {
+        // Grow before the probe sequences become long
+        if ((m_count + 1) * 100 > m_size * HASHTABLE_MAXIMUM_LOAD && !resize(m_size * 2))
+            return false;
 
-        // Always append
-        m_table[hash(key, m_table.size())].append(Bucket(key, value));
+        place(Bucket(key, value), hash(key) & (m_size - 1));
         m_count++;
         return true;
     }
@@ -179,28 +233,33 @@ template <class K, class V> class HashTable : public Associative<K,V>
     {
         int removed = 0;
 
-        for (ListIterator<Bucket> i(m_table[hash(key, m_table.size())]); i.hasCurrent(); )
+        for (Size idx = find(key); idx != m_size; idx = find(key))
         {
-            if (i.current().key == key)
-            {
-                i.remove();
-                m_count--;
-                removed++;
-            }
-            else
-                i++;
+            erase(idx);
+            removed++;
         }
         return removed;
     }
 
+    /**
+     * Removes all items from the HashTable.
+     */
+    virtual void clear()
+    {
+        for (Size i = 0; i < m_size; i++)
+            m_table[i] = Bucket();
+
+        m_count = 0;
+    }
+
     /**
      * Get the size of the HashTable.
      *
-     * @return Size of the internal array.
+     * @return Number of slots in the internal array.
      */
     virtual Size size() const
     {
-        return m_table.size();
+        return m_size;
     }
 
     /**
@@ -222,10 +281,10 @@ template <class K, class V> class HashTable : public Associative<K,V>
     {
         List<K> lst;
 
-        for (Size i = 0; i < m_table.count(); i++)
-            for (ListIterator<Bucket> j(m_table[i]); j.hasCurrent(); j++)
-                if (!lst.contains(j.current().key))
-                    lst << j.current().key;
+        // Report each key only at its first slot
+        for (Size i = 0; i < m_size; i++)
+            if (m_table[i].used && find(m_table[i].key) == i)
+                lst << m_table[i].key;
 
         return lst;
     }
@@ -237,10 +296,9 @@ template <class K, class V> class HashTable : public Associative<K,V>
     {
         List<K> lst;
 
-        for (Size i = 0; i < m_table.count(); i++)
-            for (ListIterator<Bucket> j(m_table[i]); j.hasCurrent(); j++)
-                if (j.current().value == value && !lst.contains(j.current().key))
-                    lst << j.current().key;
+        for (Size i = 0; i < m_size; i++)
+            if (m_table[i].used && m_table[i].value == value && !lst.contains(m_table[i].key))
+                lst << m_table[i].key;
 
         return lst;
     }
@@ -254,9 +312,9 @@ template <class K, class V> class HashTable : public Associative<K,V>
     {
         List<V> lst;
 
-        for (Size i = 0; i < m_table.count(); i++)
-            for (ListIterator<Bucket> j(m_table[i]); j.hasCurrent(); j++)
-                lst << j.current().value;
+        for (Size i = 0; i < m_size; i++)
+            if (m_table[i].used)
+                lst << m_table[i].value;
 
         return lst;
     }
@@ -268,11 +326,12 @@ template <class K, class V> class HashTable : public Associative<K,V>
      */
     virtual List<V> values(const K & key) const
     {
+        const Size home = hash(key) & (m_size - 1);
         List<V> lst;
 
-        for (ListIterator<Bucket> i(m_table[hash(key, m_table.size())]); i.hasCurrent(); i++)
-            if (i.current().key == key)
-                lst << i.current().value;
+        for (Size i = home; m_table[i].used; i = (i + 1) & (m_size - 1))
+            if (m_table[i].home == home && m_table[i].key == key)
+                lst << m_table[i].value;
 
         return lst;
     }
@@ -286,13 +345,9 @@ template <class K, class V> class HashTable : public Associative<K,V>
      */
     virtual const V * get(const K & key) const
     {
-        const List<Bucket> & lst = m_table[hash(key, m_table.size())];
+        const Size idx = find(key);
 
-        for (ListIterator<Bucket> i(lst); i.hasCurrent(); i++)
-            if (i.current().key == key)
-                return &i.current().value;
-
-        return ZERO;
+        return idx != m_size ? &m_table[idx].value : ZERO;
     }
 
     /**
@@ -306,13 +361,9 @@ template <class K, class V> class HashTable : public Associative<K,V>
      */
     virtual const V & at(const K & key) const
     {
-        const List<Bucket> & lst = m_table[hash(key, m_table.size())];
-
-        for (ListIterator<Bucket> i(lst); i.hasCurrent(); i++)
-            if (i.current().key == key)
-                return i.current().value;
+        const Size idx = find(key);
 
-        return m_table[0].head()->data.value;
+        return m_table[idx != m_size ? idx : 0].value;
     }
 
     /**
@@ -324,47 +375,136 @@ template <class K, class V> class HashTable : public Associative<K,V>
      */
     virtual const V value(const K & key, const V defaultValue = V()) const
     {
-        const List<Bucket> & lst = m_table[hash(key, m_table.size())];
+        const Size idx = find(key);
+
+        return idx != m_size ? m_table[idx].value : defaultValue;
+    }
+
+    /**
+     * Modifiable index operator.
+     */
+    V & operator[](const K & key)
+    {
+        return (V &) at(key);
+    }
+
+    /**
+     * Constant index operator.
+     */
+    const V & operator[](const K & key) const
+    {
+        return (const V &) at(key);
+    }
+
+  private:
+
+    /**
+     * Find the first slot of a key.
+     *
+     * @param key Key to find.
+     *
+     * @return Slot index or the table size if not found.
+     */
+    Size find(const K & key) const
+    {
+        const Size home = hash(key) & (m_size - 1);
 
-        for (ListIterator<Bucket> i(lst); i.hasCurrent(); i++)
-            if (i.current().key == key)
-                return i.current().value;
+        // Comparing the home slot first avoids most key comparisons
+        for (Size i = home; m_table[i].used; i = (i + 1) & (m_size - 1))
+            if (m_table[i].home == home && m_table[i].key == key)
+                return i;
 
-        return defaultValue;
+        return m_size;
     }
 
     /**
-     * Get the internal Vector with Buckets.
+     * Store an item in the first free slot of its probe sequence.
      *
-     * @return Reference to the Vector with Buckets.
+     * @param bucket Item to store.
+     * @param home Slot index where the probe sequence starts.
      */
-    Vector<List<Bucket> > & table()
+    void place(const Bucket & bucket, const Size home)
     {
-        return m_table;
+        Size i = home;
+
+        while (m_table[i].used)
+            i = (i + 1) & (m_size - 1);
+
+        m_table[i] = bucket;
+        m_table[i].home = home;
+        m_table[i].used = true;
     }
 
     /**
-     * Modifiable index operator.
+     * Remove the item in a slot.
+     *
+     * Items after it in the same run move back into the free slot when
+     * their probe sequence covers it, such that all items stay reachable.
+     *
+     * @param idx Slot index.
      */
-    V & operator[](const K & key)
+    void erase(Size idx)
     {
-        return (V &) at(key);
+        for (Size next = (idx + 1) & (m_size - 1); m_table[next].used; next = (next + 1) & (m_size - 1))
+        {
+            const Size distance = (next - m_table[next].home) & (m_size - 1);
+
+            if (distance >= ((next - idx) & (m_size - 1)))
+            {
+                m_table[idx] = m_table[next];
+                idx = next;
+            }
+        }
+
+        m_table[idx] = Bucket();
+        m_count--;
     }
 
     /**
-     * Constant index operator.
+     * Move all items to a table of a different size.
+     *
+     * @param size New number of slots.
+     *
+     * @return True on success, false otherwise.
      */
-    const V & operator[](const K & key) const
+    bool resize(const Size size)
     {
-        return (const V &) at(key);
+        Bucket *old = m_table;
+        const Size oldSize = m_size;
+        Size start = 0;
+
+        if ((m_table = new Bucket[size]) == ZERO)
+        {
+            m_table = old;
+            return false;
+        }
+        m_size = size;
+
+        // Start at a free slot, such that each run is moved in order
+        while (old[start].used)
+            start++;
+
+        for (Size i = 0; i < oldSize; i++)
+        {
+            const Bucket & bucket = old[(start + i) & (oldSize - 1)];
+
+            if (bucket.used)
+                place(bucket, hash(bucket.key) & (m_size - 1));
+        }
+
+        delete[] old;
+        return true;
     }
 
   private:
 
     /** Internal table. */
-    Vector<List<Bucket> > m_table;
+    Bucket *m_table;
+
+    /** Number of slots in the table. */
+    Size m_size;
 
-    /** Number of values in the buckets. */
+    /** Number of values in the table. */
     Size m_count;
 };
 
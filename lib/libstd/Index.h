@@ -21,6 +21,7 @@
 #include "Assert.h"
 #include "Types.h"
 #include "Macros.h"
+#include "BitOperations.h"
 
 /**
  * @addtogroup lib
@@ -32,9 +33,24 @@
 
 /**
  * Index is a N-sized array of pointers to items of type T.
+ *
+ * Free positions are tracked in a bitmap with one summary bit per
+ * bitmap word, such that the lowest free position is found without
+ * scanning the array.
  */
 template <class T, const Size N> class Index
 {
+  private:
+
+    /** Number of positions tracked by a single bitmap word */
+    static const Size WordBits = sizeof(u32) * 8;
+
+    /** Number of words in the bitmap of free positions */
+    static const Size FreeWords = (N + WordBits - 1) / WordBits;
+
+    /** Number of words in the summary bitmap */
+    static const Size SummaryWords = (FreeWords + WordBits - 1) / WordBits;
+
   public:
 
     /**
@@ -47,6 +63,21 @@ template <class T, const Size N> class Index
         {
             m_array[i] = ZERO;
         }
+
+        for (Size i = 0; i < FreeWords; i++)
+        {
+            m_free[i] = 0;
+        }
+
+        for (Size i = 0; i < SummaryWords; i++)
+        {
+            m_summary[i] = 0;
+        }
+
+        for (Size i = 0; i < N; i++)
+        {
+            markFree(i);
+        }
     }
 
     /**
@@ -70,21 +101,16 @@ template <class T, const Size N> class Index
             return false;
         }
 
-        // There is space, add the item.
-        for (Size i = 0; i < N; i++)
-        {
-            if (m_array[i] == ZERO)
-            {
-                m_array[i] = item;
-                m_count++;
-                position = i;
-                return true;
-            }
-        }
+        // There is space, take the lowest free position
+        const Size pos = findFree();
+        assert(pos < N);
+        assert(m_array[pos] == ZERO);
 
-        // Should not be reached
-        assert(false);
-        return false;
+        m_array[pos] = item;
+        markUsed(pos);
+        m_count++;
+        position = pos;
+        return true;
     }
 
     /**
@@ -126,6 +152,7 @@ template <class T, const Size N> class Index
         // Increment counter only when needed
         if (m_array[position] == ZERO)
         {
+            markUsed(position);
             m_count++;
         }
 
@@ -155,6 +182,7 @@ template <class T, const Size N> class Index
         }
 
         m_array[position] = ZERO;
+        markFree(position);
         assert(m_count >= 1);
         m_count--;
         return true;
@@ -171,6 +199,7 @@ template <class T, const Size N> class Index
             {
                 delete m_array[i];
                 m_array[i] = ZERO;
+                markFree(i);
             }
         }
 
@@ -239,11 +268,68 @@ template <class T, const Size N> class Index
         return get(i);
     }
 
+  private:
+
+    /**
+     * Find the lowest free position.
+     *
+     * @return Free position or N if the Index is full.
+     */
+    Size findFree() const
+    {
+        for (Size i = 0; i < SummaryWords; i++)
+        {
+            if (m_summary[i] != 0)
+            {
+                const Size word = (i * WordBits) + countTrailingZeros(m_summary[i]);
+                return (word * WordBits) + countTrailingZeros(m_free[word]);
+            }
+        }
+
+        return N;
+    }
+
+    /**
+     * Mark a position as free.
+     *
+     * @param position The position to mark.
+     */
+    void markFree(const Size position)
+    {
+        const Size word = position / WordBits;
+
+        m_free[word] |= 1U << (position % WordBits);
+        m_summary[word / WordBits] |= 1U << (word % WordBits);
+    }
+
+    /**
+     * Mark a position as used.
+     *
+     * @param position The position to mark.
+     */
+    void markUsed(const Size position)
+    {
+        const Size word = position / WordBits;
+
+        m_free[word] &= ~(1U << (position % WordBits));
+
+        if (m_free[word] == 0)
+        {
+            m_summary[word / WordBits] &= ~(1U << (word % WordBits));
+        }
+    }
+
   private:
 
     /** Array of pointers to items. */
     T* m_array[N];
 
+    /** Bitmap with a bit set for each free position. */
+    u32 m_free[FreeWords];
+
+    /** Bitmap with a bit set for each word in m_free with a free position. */
+    u32 m_summary[SummaryWords];
+
     /** Amount of valid pointers in the array. */
     Size m_count;
 };
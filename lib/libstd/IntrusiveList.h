@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBSTD_INTRUSIVELIST_H
+#define __LIB_LIBSTD_INTRUSIVELIST_H
+
+#include "Types.h"
+#include "Macros.h"
+#include "Assert.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libstd
+ * @{
+ */
+
+/**
+ * Links an object into an IntrusiveList.
+ *
+ * An object can be on one IntrusiveList per ListHook member at a time.
+ */
+template <class T> class ListHook
+{
+  public:
+
+    /**
+     * Constructor.
+     */
+    ListHook()
+        : prev(ZERO), next(ZERO), linked(false)
+    {
+    }
+
+    /** Previous object */
+    T *prev;
+
+    /** Next object */
+    T *next;
+
+    /** True if the object is on a list */
+    bool linked;
+};
+
+/**
+ * Doubly linked list of objects which contain their own links.
+ *
+ * Inserting and removing never allocates memory: the list only
+ * connects the ListHook members of the objects.
+ */
+template <class T, ListHook<T> T::*Hook> class IntrusiveList
+{
+  public:
+
+    /**
+     * Constructor.
+     */
+    IntrusiveList()
+        : m_head(ZERO), m_tail(ZERO), m_count(0)
+    {
+    }
+
+    /**
+     * Destructor.
+     *
+     * Unlinks all objects, which remain owned by the caller.
+     */
+    ~IntrusiveList()
+    {
+        clear();
+    }
+
+    /**
+     * Insert an object at the start of the list.
+     *
+     * @param item Object which is not on a list yet.
+     */
+    void prepend(T *item)
+    {
+        ListHook<T> & hook = item->*Hook;
+
+        assert(!hook.linked);
+        hook.prev = ZERO;
+        hook.next = m_head;
+        hook.linked = true;
+
+        if (m_head)
+            (m_head->*Hook).prev = item;
+        else
+            m_tail = item;
+
+        m_head = item;
+        m_count++;
+    }
+
+    /**
+     * Insert an object at the end of the list.
+     *
+     * @param item Object which is not on a list yet.
+     */
+    void append(T *item)
+    {
+        ListHook<T> & hook = item->*Hook;
+
+        assert(!hook.linked);
+        hook.prev = m_tail;
+        hook.next = ZERO;
+        hook.linked = true;
+
+        if (m_tail)
+            (m_tail->*Hook).next = item;
+        else
+            m_head = item;
+
+        m_tail = item;
+        m_count++;
+    }
+
+    /**
+     * Remove an object from the list.
+     *
+     * @param item Object on this list.
+     */
+    void remove(T *item)
+    {
+        ListHook<T> & hook = item->*Hook;
+
+        assert(hook.linked);
+
+        if (hook.prev)
+            (hook.prev->*Hook).next = hook.next;
+        else
+            m_head = hook.next;
+
+        if (hook.next)
+            (hook.next->*Hook).prev = hook.prev;
+        else
+            m_tail = hook.prev;
+
+        hook.prev = ZERO;
+        hook.next = ZERO;
+        hook.linked = false;
+        m_count--;
+    }
+
+    /**
+     * Remove and return the first object.
+     *
+     * @return First object or ZERO if the list is empty.
+     */
+    T * pop()
+    {
+        T *item = m_head;
+
+        if (item)
+            remove(item);
+
+        return item;
+    }
+
+    /**
+     * Check whether an object is on the list.
+     *
+     * @param item Object to find.
+     *
+     * @return True if found, false otherwise.
+     */
+    bool contains(const T *item) const
+    {
+        for (const T *i = m_head; i; i = (i->*Hook).next)
+            if (i == item)
+                return true;
+
+        return false;
+    }
+
+    /**
+     * Unlink all objects.
+     */
+    void clear()
+    {
+        while (m_head)
+            remove(m_head);
+    }
+
+    /**
+     * Get the first object.
+     *
+     * @return First object or ZERO if empty.
+     */
+    T * head() const
+    {
+        return m_head;
+    }
+
+    /**
+     * Get the last object.
+     *
+     * @return Last object or ZERO if empty.
+     */
+    T * tail() const
+    {
+        return m_tail;
+    }
+
+    /**
+     * Get the object after the given object.
+     *
+     * @param item Object on this list.
+     *
+     * @return Next object or ZERO if the given object is the last.
+     */
+    T * next(const T *item) const
+    {
+        return (item->*Hook).next;
+    }
+
+    /**
+     * Get the object before the given object.
+     *
+     * @param item Object on this list.
+     *
+     * @return Previous object or ZERO if the given object is the first.
+     */
+    T * prev(const T *item) const
+    {
+        return (item->*Hook).prev;
+    }
+
+    /**
+     * Check if the list is empty.
+     *
+     * @return True if empty, false otherwise.
+     */
+    bool isEmpty() const
+    {
+        return m_head == ZERO;
+    }
+
+    /**
+     * Get the number of objects on the list.
+     *
+     * @return Number of objects.
+     */
+    Size count() const
+    {
+        return m_count;
+    }
+
+  private:
+
+    /**
+     * Copying would link objects into two lists.
+     */
+    IntrusiveList(const IntrusiveList & list);
+
+    /**
+     * Copying would link objects into two lists.
+     */
+    IntrusiveList & operator = (const IntrusiveList & list);
+
+  private:
+
+    /** First object. */
+    T *m_head;
+
+    /** Last object. */
+    T *m_tail;
+
+    /** Number of objects on the list. */
+    Size m_count;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBSTD_INTRUSIVELIST_H */
@@ -32,6 +32,9 @@
 
 /**
  * Simple linked list template class.
+ *
+ * Each item is stored in a Node, which is allocated on the heap or
+ * taken from a NodePool given to the constructor.
  */
 template <class T> class List : public Sequence<T>
 {
@@ -44,6 +47,15 @@ template <class T> class List : public Sequence<T>
     {
       public:
 
+        /**
+         * Default constructor.
+         */
+        Node() : data()
+        {
+            prev = ZERO;
+            next = ZERO;
+        }
+
         /**
          * Constructor.
          */
@@ -63,14 +75,111 @@ template <class T> class List : public Sequence<T>
         Node *next;
     };
 
+    /**
+     * Preallocated Nodes which can be shared by Lists.
+     *
+     * Nodes are taken from the pool while available and only
+     * then allocated on the heap. The pool must outlive its Lists.
+     */
+    class NodePool
+    {
+      public:
+
+        /**
+         * Constructor.
+         *
+         * @param capacity Number of Nodes to preallocate.
+         */
+        NodePool(const Size capacity)
+            : m_nodes(new Node[capacity])
+            , m_capacity(capacity)
+            , m_free(ZERO)
+        {
+            for (Size i = 0; i < capacity; i++)
+            {
+                m_nodes[i].next = m_free;
+                m_free = &m_nodes[i];
+            }
+        }
+
+        /**
+         * Destructor.
+         */
+        ~NodePool()
+        {
+            delete[] m_nodes;
+        }
+
+        /**
+         * Get a Node for an item.
+         *
+         * @param t Item to store.
+         *
+         * @return Node pointer
+         */
+        Node * allocate(const T & t)
+        {
+            Node *node = m_free;
+
+            if (!node)
+                return new Node(t);
+
+            m_free = node->next;
+            node->data = t;
+            node->next = ZERO;
+            return node;
+        }
+
+        /**
+         * Give back a Node.
+         *
+         * @param node Node returned by allocate().
+         */
+        void release(Node *node)
+        {
+            if (node < m_nodes || node >= m_nodes + m_capacity)
+            {
+                delete node;
+                return;
+            }
+
+            // Drop the item now, instead of when the Node is reused
+            node->data = T();
+            node->prev = ZERO;
+            node->next = m_free;
+            m_free = node;
+        }
+
+      private:
+
+        /**
+         * Copying would release Nodes twice.
+         */
+        NodePool(const NodePool & pool);
+
+      private:
+
+        /** Preallocated Nodes. */
+        Node *m_nodes;
+
+        /** Number of preallocated Nodes. */
+        const Size m_capacity;
+
+        /** First unused Node. */
+        Node *m_free;
+    };
+
     /**
      * Class constructor.
+     *
+     * @param pool Optional pool to take Nodes from.
      */
-    List()
+    List(NodePool *pool = ZERO)
     {
         m_head  = ZERO;
         m_tail  = ZERO;
         m_count = 0;
+        m_pool  = pool;
     }
 
     /**
@@ -83,6 +192,7 @@ template <class T> class List : public Sequence<T>
         m_head  = ZERO;
         m_tail  = ZERO;
         m_count = 0;
+        m_pool  = ZERO;
 
         for (Node *node = lst.m_head; node; node = node->next)
             append(node->data);
@@ -99,7 +209,7 @@ template <class T> class List : public Sequence<T>
         {
             Node *tmp = node;
             node = node->next;
-            delete tmp;
+            destroyNode(tmp);
         }
     }
 
@@ -112,7 +222,7 @@ template <class T> class List : public Sequence<T>
     {
 
         // Create a new node with the item.
-        Node *node = new Node(t);
+        Node *node = createNode(t);
 
         // Connect the item to the list head, if set
         if (m_head)
@@ -138,7 +248,7 @@ template <class T> class List : public Sequence<T>
      */
     void append(T t)
     {
-        Node *node = new Node(t);
+        Node *node = createNode(t);
         node->prev = m_tail;
 
         // Connect the item with the tail, if any.
@@ -205,7 +315,7 @@ template <class T> class List : public Sequence<T>
             m_tail = node->prev;
 
         m_count--;
-        delete node;
+        destroyNode(node);
         return true;
     }
 
@@ -237,7 +347,7 @@ template <class T> class List : public Sequence<T>
         while (node)
         {
             next = node->next;
-            delete node;
+            destroyNode(node);
             node = next;
         }
         // Clear administration
@@ -443,6 +553,27 @@ template <class T> class List : public Sequence<T>
         return false;
     }
 
+  private:
+
+    /**
+     * Get a Node for an item.
+     */
+    Node * createNode(const T & t)
+    {
+        return m_pool ? m_pool->allocate(t) : new Node(t);
+    }
+
+    /**
+     * Give back a Node of this List.
+     */
+    void destroyNode(Node *node)
+    {
+        if (m_pool)
+            m_pool->release(node);
+        else
+            delete node;
+    }
+
   private:
 
     /** Head of the List. */
@@ -453,6 +584,9 @@ template <class T> class List : public Sequence<T>
 
     /** Number of items currently in the List. */
     Size m_count;
+
+    /** Pool to take Nodes from, or ZERO to use the heap. */
+    NodePool *m_pool;
 };
 
 /**
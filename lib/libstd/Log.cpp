@@ -22,6 +22,7 @@ Log::Log()
     : WeakSingleton<Log>(this)
     , m_minimumLogLevel(Notice)
     , m_ident(ZERO)
+    , m_batched(false)
     , m_outputBufferWritten(0)
 {
 }
@@ -50,6 +51,11 @@ void Log::setIdent(const char *ident)
     m_ident = ident;
 }
 
+void Log::setBatched(const bool batched)
+{
+    m_batched = batched;
+}
+
 void Log::append(const char *str)
 {
     // Copy input. Note that we need to reserve 1 byte for the NULL-terminator
@@ -66,7 +72,10 @@ void Log::append(const char *str)
         }
     }
 
-    flush();
+    if (!m_batched || m_outputBufferWritten >= LogBufferSize / 2)
+    {
+        flush();
+    }
 }
 
 void Log::flush(const bool force)
@@ -29,6 +29,16 @@
  * @{
  */
 
+/**
+ * Most verbose log level compiled into the program.
+ *
+ * Log statements of less severe levels are removed by the compiler,
+ * including their message arguments. Set with the LOGLEVEL build variable.
+ */
+#ifndef __LOGLEVEL__
+#define __LOGLEVEL__ 7
+#endif /* __LOGLEVEL__ */
+
 /**
  * Output a log line to the system log (syslog).
  *
@@ -38,7 +48,7 @@
  */
 #define MAKE_LOG(type, typestr, msg) \
     {\
-     if (Log::instance() && type <= Log::instance()->getMinimumLogLevel())  \
+     if (type <= __LOGLEVEL__ && Log::instance() && type <= Log::instance()->getMinimumLogLevel())  \
         (*Log::instance()) << "[" typestr "] " << __FILE__ ":" <<  __LINE__ << " " << __FUNCTION__ << " -- " << msg << "\r\n"; \
     }
 
@@ -50,7 +60,7 @@
 #define FATAL(msg) \
     { \
         MAKE_LOG(Log::Emergency, "Emergency", msg); \
-        if (Log::instance()) Log::instance()->terminate(); \
+        if (Log::instance()) { Log::instance()->flush(true); Log::instance()->terminate(); } \
     }
 
 /**
@@ -91,6 +101,10 @@
 /**
  * Logging class.
  *
+ * Output is collected per line and written once the line is complete.
+ * In batched mode, complete lines are collected until the buffer is half
+ * full or flush() is called, which saves a write for every line.
+ *
  * @note This class is a singleton
  */
 class Log : public WeakSingleton<Log>
@@ -98,7 +112,7 @@ class Log : public WeakSingleton<Log>
   private:
 
     /** Size of the log buffer in bytes */
-    static const Size LogBufferSize = 512;
+    static const Size LogBufferSize = 1024;
 
   public:
 
@@ -139,6 +153,13 @@ class Log : public WeakSingleton<Log>
      */
     void setMinimumLogLevel(Level level);
 
+    /**
+     * Enable or disable batching of lines.
+     *
+     * @param batched True to collect multiple lines per write
+     */
+    void setBatched(const bool batched);
+
     /**
      * Append to buffered output.
      *
@@ -146,6 +167,20 @@ class Log : public WeakSingleton<Log>
      */
     void append(const char *str);
 
+    /**
+     * Flush internal buffer.
+     *
+     * This function reads the contents of the internal
+     * buffer and writes all available bytes to the actual
+     * output device using write().
+     *
+     * @param force True to always flush, even without newline
+     *              at the end of the buffer.
+     *
+     * @see write
+     */
+    void flush(const bool force = false);
+
     /**
      * Set log identity.
      *
@@ -172,22 +207,6 @@ class Log : public WeakSingleton<Log>
      */
     virtual void write(const char *str) = 0;
 
-  private:
-
-    /**
-     * Flush internal buffer.
-     *
-     * This function reads the contents of the internal
-     * buffer and writes all available bytes to the actual
-     * output device using write().
-     *
-     * @param force True to always flush, even without newline
-     *              at the end of the buffer.
-     *
-     * @see write
-     */
-    void flush(const bool force = false);
-
   private:
 
     /** Minimum log level required to log. */
@@ -196,6 +215,9 @@ class Log : public WeakSingleton<Log>
     /** Identity */
     const char *m_ident;
 
+    /** True if multiple lines are collected per write */
+    bool m_batched;
+
     /** Output line is stored here until written using write() */
     char m_outputBuffer[LogBufferSize];
 
@@ -151,6 +151,12 @@ inline bool doubleEquals(double a, double b, double epsilon)
 #define USED \
     __attribute__((__used__))
 
+/**
+ * Declares a symbol which may be overridden by a non-weak definition.
+ */
+#define WEAK \
+    __attribute__((__weak__))
+
 /**
  * Ensures strict minimum memory requirements.
  *
@@ -167,6 +173,24 @@ inline bool doubleEquals(double a, double b, double epsilon)
 #define ALIGN(n) \
     __attribute__((aligned(n)))
 
+/**
+ * Disables the address sanitizer for a function.
+ *
+ * For functions which read whole aligned words beyond the end of
+ * a buffer on purpose. Aligned loads never cross a page.
+ */
+#define NO_SANITIZE_ADDRESS \
+    __attribute__((__no_sanitize_address__))
+
+/**
+ * Lets the compiler check the arguments of a printf() style function.
+ *
+ * @param fmt Position of the format string argument.
+ * @param first Position of the first variable argument, or zero for a va_list.
+ */
+#define FORMAT(fmt, first) \
+    __attribute__((__format__(__printf__, fmt, first)))
+
 /**
  * @}
  * @}
@@ -24,22 +24,124 @@
 
 void * MemoryBlock::set(void *dest, int ch, unsigned count)
 {
-    char *temp;
+    u8 *dp = (u8 *) dest;
+    const ulong pattern = ((ulong) ~0UL / 0xff) * (u8) ch;
+
+#if defined(__i386__)
+    // Fill whole words with rep stosl, followed by the remaining bytes
+    ulong words = count / sizeof(u32);
+    ulong bytes = count % sizeof(u32);
+
+    asm volatile ("rep stosl\n"
+                  "movl %3, %%ecx\n"
+                  "rep stosb\n"
+                  : "+D" (dp), "+c" (words)
+                  : "a" (pattern), "r" (bytes)
+                  : "memory");
+#else
+    // Fill bytes until the destination is word aligned
+    for (; count != 0 && ((Address) dp % sizeof(ulong)) != 0; count--)
+    {
+        *dp++ = ch;
+    }
+
+    // Fill four words per iteration
+    ulong *wp = (ulong *) dp;
+
+    for (; count >= sizeof(ulong) * 4; count -= sizeof(ulong) * 4)
+    {
+        wp[0] = pattern;
+        wp[1] = pattern;
+        wp[2] = pattern;
+        wp[3] = pattern;
+        wp += 4;
+    }
+
+    for (; count >= sizeof(ulong); count -= sizeof(ulong))
+    {
+        *wp++ = pattern;
+    }
 
-    for(temp = (char *) dest; count != 0; count--)
+    // Fill the remaining bytes
+    for (dp = (u8 *) wp; count != 0; count--)
     {
-        *temp++ = ch;
+        *dp++ = ch;
     }
+#endif /* __i386__ */
+
     return (dest);
 }
 
 Size MemoryBlock::copy(void *dest, const void *src, Size count)
 {
-    const char *sp = (const char *)src;
-    char *dp = (char *)dest;
+    const u8 *sp = (const u8 *) src;
+    u8 *dp = (u8 *) dest;
+
+#if defined(__i386__)
+    // Copy whole words with rep movsl, followed by the remaining bytes
+    ulong words = count / sizeof(u32);
+    ulong bytes = count % sizeof(u32);
+
+    asm volatile ("rep movsl\n"
+                  "movl %3, %%ecx\n"
+                  "rep movsb\n"
+                  : "+D" (dp), "+S" (sp), "+c" (words)
+                  : "r" (bytes)
+                  : "memory");
+#else
+    Size remaining = count;
+
+    // Word copies are only possible if both pointers have the same alignment
+    if (((Address) sp % sizeof(ulong)) == ((Address) dp % sizeof(ulong)))
+    {
+        for (; remaining != 0 && ((Address) dp % sizeof(ulong)) != 0; remaining--)
+        {
+            *dp++ = *sp++;
+        }
 
-    for(Size i = count; i != 0; i--)
+#if defined(__arm__)
+        // Copy 32 bytes per iteration with load/store multiple
+        for (; remaining >= 32; remaining -= 32)
+        {
+            asm volatile ("ldmia %0!, {r3, r4, r5, r6}\n"
+                          "stmia %1!, {r3, r4, r5, r6}\n"
+                          "ldmia %0!, {r3, r4, r5, r6}\n"
+                          "stmia %1!, {r3, r4, r5, r6}\n"
+                          : "+r" (sp), "+r" (dp)
+                          :
+                          : "r3", "r4", "r5", "r6", "memory");
+        }
+#endif /* __arm__ */
+
+        // Copy four words per iteration
+        const ulong *sw = (const ulong *) sp;
+        ulong *dw = (ulong *) dp;
+
+        for (; remaining >= sizeof(ulong) * 4; remaining -= sizeof(ulong) * 4)
+        {
+            dw[0] = sw[0];
+            dw[1] = sw[1];
+            dw[2] = sw[2];
+            dw[3] = sw[3];
+            sw += 4;
+            dw += 4;
+        }
+
+        for (; remaining >= sizeof(ulong); remaining -= sizeof(ulong))
+        {
+            *dw++ = *sw++;
+        }
+
+        sp = (const u8 *) sw;
+        dp = (u8 *) dw;
+    }
+
+    // Copy the remaining bytes
+    for (; remaining != 0; remaining--)
+    {
         *dp++ = *sp++;
+    }
+#endif /* __i386__ */
 
     return (count);
 }
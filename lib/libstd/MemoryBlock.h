@@ -31,9 +31,9 @@
 /**
  * Memory block operations class
  *
- * @todo Add architecture specific implementations for extra speed. The alternative
- *       implementations should be placed in libarch without creating a new dependency in libstd,
- *       for example using weak symbols.
+ * The fill and copy operations work on whole words where possible. An architecture
+ * specific implementation is selected at compile time using the compiler provided
+ * architecture macros: rep stosl/movsl on Intel and load/store multiple on ARM.
  */
 class MemoryBlock
 {
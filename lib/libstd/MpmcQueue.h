@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBSTD_MPMCQUEUE_H
+#define __LIBSTD_MPMCQUEUE_H
+
+#include <Atomic.h>
+#include "Types.h"
+#include "Macros.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libstd
+ * @{
+ */
+
+/**
+ * Bounded lock-free queue for multiple producers and multiple consumers.
+ *
+ * Each cell carries a sequence number which tells whether it is ready
+ * to be written or read for the current position. Producers and consumers
+ * claim a position with a single compare-and-swap on their own index,
+ * which are kept on separate cache lines. The queue may be placed in
+ * memory shared between processes and cores, but must be constructed by
+ * exactly one side before use.
+ *
+ * @note N must be a power of two.
+ */
+template <class T, const Size N> class MpmcQueue
+{
+  private:
+
+    /** Size of a cache line in bytes, used for padding the indices. */
+    static const Size CacheLineSize = 64U;
+
+    static_assert(N > 1 && (N & (N - 1)) == 0, "MpmcQueue size must be a power of two");
+
+    /**
+     * Queue cell.
+     */
+    typedef struct Cell
+    {
+        /** Position for which the cell can be written or read. */
+        Atomic<Size> sequence;
+
+        /** The item. */
+        T item;
+    }
+    Cell;
+
+    /**
+     * Index on its own cache line.
+     */
+    typedef struct Index
+    {
+        /** Next position. */
+        Atomic<Size> position;
+
+        /** Padding to keep the index on a separate cache line. */
+        u8 padding[CacheLineSize - sizeof(Size)];
+    }
+    Index;
+
+  public:
+
+    /**
+     * Constructor.
+     */
+    MpmcQueue()
+    {
+        for (Size i = 0; i < N; i++)
+        {
+            m_cells[i].sequence.store(i, MemoryRelaxed);
+        }
+
+        m_enqueue.position.store(0, MemoryRelaxed);
+        m_dequeue.position.store(0, MemoryRelease);
+    }
+
+    /**
+     * Add an item to the queue.
+     *
+     * @param item The item to add.
+     *
+     * @return True if successful, false if the queue is full.
+     */
+    bool push(const T & item)
+    {
+        Size pos = m_enqueue.position.load(MemoryRelaxed);
+        Cell *cell;
+
+        while (true)
+        {
+            cell = &m_cells[pos & (N - 1)];
+
+            const s32 diff = (s32) (cell->sequence.load(MemoryAcquire) - pos);
+
+            // Cell is free for this position: try to claim it
+            if (diff == 0)
+            {
+                if (m_enqueue.position.compareExchange(pos, pos + 1, MemoryRelaxed))
+                    break;
+            }
+            // Cell still holds the item of the previous round
+            else if (diff < 0)
+            {
+                return false;
+            }
+            // Another producer claimed the position
+            else
+            {
+                pos = m_enqueue.position.load(MemoryRelaxed);
+            }
+        }
+
+        cell->item = item;
+        cell->sequence.store(pos + 1, MemoryRelease);
+        return true;
+    }
+
+    /**
+     * Remove the oldest item from the queue.
+     *
+     * @param item Receives the removed item.
+     *
+     * @return True if successful, false if the queue is empty.
+     */
+    bool pop(T & item)
+    {
+        Size pos = m_dequeue.position.load(MemoryRelaxed);
+        Cell *cell;
+
+        while (true)
+        {
+            cell = &m_cells[pos & (N - 1)];
+
+            const s32 diff = (s32) (cell->sequence.load(MemoryAcquire) - (pos + 1));
+
+            // Cell holds the item for this position: try to claim it
+            if (diff == 0)
+            {
+                if (m_dequeue.position.compareExchange(pos, pos + 1, MemoryRelaxed))
+                    break;
+            }
+            // Cell is not yet written
+            else if (diff < 0)
+            {
+                return false;
+            }
+            // Another consumer claimed the position
+            else
+            {
+                pos = m_dequeue.position.load(MemoryRelaxed);
+            }
+        }
+
+        item = cell->item;
+        cell->sequence.store(pos + N, MemoryRelease);
+        return true;
+    }
+
+    /**
+     * Get the number of items in the queue.
+     *
+     * The result is only a snapshot when other cores are active.
+     *
+     * @return Number of items.
+     */
+    Size count() const
+    {
+        const Size head = m_dequeue.position.load(MemoryAcquire);
+        const Size tail = m_enqueue.position.load(MemoryAcquire);
+
+        return tail - head < N ? tail - head : N;
+    }
+
+    /**
+     * Check if the queue is empty.
+     *
+     * @return True if empty, false otherwise.
+     */
+    bool isEmpty() const
+    {
+        return count() == 0;
+    }
+
+    /**
+     * Get the maximum number of items in the queue.
+     *
+     * @return Size of the queue.
+     */
+    Size size() const
+    {
+        return N;
+    }
+
+  private:
+
+    /** Claimed by producers. */
+    Index m_enqueue;
+
+    /** Claimed by consumers. */
+    Index m_dequeue;
+
+    /** Cells of the queue. */
+    Cell m_cells[N];
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBSTD_MPMCQUEUE_H */
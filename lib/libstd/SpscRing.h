@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBSTD_SPSCRING_H
+#define __LIBSTD_SPSCRING_H
+
+#include <Atomic.h>
+#include "Types.h"
+#include "Macros.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libstd
+ * @{
+ */
+
+/**
+ * Lock-free ring of items for a single producer and a single consumer.
+ *
+ * The producer and consumer may run on different cores, and the ring
+ * may be placed in memory shared between processes. A ring of zeroed
+ * memory is empty, thus only one side needs to construct it.
+ * The producer and consumer indices are on separate cache lines,
+ * and each side keeps a cached copy of the other index such that the
+ * shared index is only read when the ring seems full or empty.
+ *
+ * @note N must be a power of two.
+ */
+template <class T, const Size N> class SpscRing
+{
+  private:
+
+    /** Size of a cache line in bytes, used for padding the indices. */
+    static const Size CacheLineSize = 64U;
+
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+    /**
+     * Index of one side with its cached copy of the index of the other side.
+     */
+    typedef struct Side
+    {
+        /** Index written by this side. */
+        Atomic<Size> index;
+
+        /** Last seen index of the other side. */
+        Size cached;
+
+        /** Padding to keep both sides on a separate cache line. */
+        u8 padding[CacheLineSize - (sizeof(Size) * 2)];
+    }
+    Side;
+
+  public:
+
+    /**
+     * Constructor.
+     */
+    SpscRing()
+    {
+        m_producer.index.store(0, MemoryRelaxed);
+        m_producer.cached = 0;
+        m_consumer.index.store(0, MemoryRelaxed);
+        m_consumer.cached = 0;
+    }
+
+    /**
+     * Add an item to the ring.
+     *
+     * Only called by the producer.
+     *
+     * @param item The item to add.
+     *
+     * @return True if successful, false if the ring is full.
+     */
+    bool push(const T & item)
+    {
+        const Size tail = m_producer.index.load(MemoryRelaxed);
+
+        if (tail - m_producer.cached >= N)
+        {
+            m_producer.cached = m_consumer.index.load(MemoryAcquire);
+
+            if (tail - m_producer.cached >= N)
+            {
+                return false;
+            }
+        }
+
+        m_items[tail & (N - 1)] = item;
+        m_producer.index.store(tail + 1, MemoryRelease);
+        return true;
+    }
+
+    /**
+     * Remove the oldest item from the ring.
+     *
+     * Only called by the consumer.
+     *
+     * @param item Receives the removed item.
+     *
+     * @return True if successful, false if the ring is empty.
+     */
+    bool pop(T & item)
+    {
+        const Size head = m_consumer.index.load(MemoryRelaxed);
+
+        if (head == m_consumer.cached)
+        {
+            m_consumer.cached = m_producer.index.load(MemoryAcquire);
+
+            if (head == m_consumer.cached)
+            {
+                return false;
+            }
+        }
+
+        item = m_items[head & (N - 1)];
+        m_consumer.index.store(head + 1, MemoryRelease);
+        return true;
+    }
+
+    /**
+     * Get the number of items in the ring.
+     *
+     * The result is only a snapshot when the other side is active.
+     *
+     * @return Number of items.
+     */
+    Size count() const
+    {
+        const Size head = m_consumer.index.load(MemoryAcquire);
+        const Size tail = m_producer.index.load(MemoryAcquire);
+
+        return tail - head < N ? tail - head : N;
+    }
+
+    /**
+     * Check if the ring is empty.
+     *
+     * @return True if empty, false otherwise.
+     */
+    bool isEmpty() const
+    {
+        return count() == 0;
+    }
+
+    /**
+     * Get the maximum number of items in the ring.
+     *
+     * @return Size of the ring.
+     */
+    Size size() const
+    {
+        return N;
+    }
+
+  private:
+
+    /** Written by the producer. */
+    Side m_producer;
+
+    /** Written by the consumer. */
+    Side m_consumer;
+
+    /** Ring of items. */
+    T m_items[N];
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBSTD_SPSCRING_H */
@@ -19,64 +19,104 @@
 #include "MemoryBlock.h"
 #include "String.h"
 
+/**
+ * Machine word which may alias the characters of a string.
+ */
+typedef ulong __attribute__((__may_alias__)) StringWord;
+
+/**
+ * Check if any byte of a word is ZERO.
+ *
+ * Subtracting one from each byte only borrows into the high bit
+ * of a byte which was ZERO or had its high bit set already.
+ */
+static inline bool hasZeroByte(const ulong word)
+{
+    const ulong low = (ulong) ~0UL / 0xff;
+
+    return ((word - low) & ~word & (low << 7)) != 0;
+}
+
 String::String()
 {
-    m_string    = new char[STRING_DEFAULT_SIZE];
+    m_string    = m_inline;
     m_string[0] = ZERO;
     m_allocated = true;
-    m_size      = STRING_DEFAULT_SIZE;
+    m_size      = STRING_INLINE_SIZE;
     m_count     = 0;
     m_base      = Number::Dec;
 }
 
 String::String(const String & str)
 {
-    m_size      = str.m_size;
     m_count     = str.m_count;
     m_base      = str.m_base;
-    m_string    = new char[m_size];
+    m_size      = m_count < STRING_INLINE_SIZE ? STRING_INLINE_SIZE : m_count + 1;
+    m_string    = allocate(m_size);
     m_allocated = true;
     MemoryBlock::copy(m_string, str.m_string, m_count + 1);
 }
 
+String::String(String && str)
+{
+    take(str);
+}
+
+String::String(const StringView & view)
+{
+    m_count     = view.length();
+    m_base      = Number::Dec;
+    m_size      = m_count < STRING_INLINE_SIZE ? STRING_INLINE_SIZE : m_count + 1;
+    m_string    = allocate(m_size);
+    m_allocated = true;
+    MemoryBlock::copy(m_string, view.data(), m_count);
+    m_string[m_count] = ZERO;
+}
+
 String::String(char *str, const bool copy)
 {
     m_count     = length(str);
-    m_size      = m_count ? m_count + 1 : STRING_DEFAULT_SIZE;
     m_allocated = copy;
     m_base      = Number::Dec;
 
     if (copy)
     {
-        m_string = new char[m_size];
+        m_size   = m_count < STRING_INLINE_SIZE ? STRING_INLINE_SIZE : m_count + 1;
+        m_string = allocate(m_size);
         MemoryBlock::copy(m_string, str, m_count + 1);
     }
     else
+    {
+        m_size   = m_count ? m_count + 1 : STRING_DEFAULT_SIZE;
         m_string = str;
+    }
 }
 
 String::String(const char *str, const bool copy)
 {
     m_count     = length(str);
-    m_size      = m_count ? m_count + 1 : STRING_DEFAULT_SIZE;
     m_allocated = copy;
     m_base      = Number::Dec;
 
     if (copy)
     {
-        m_string = new char[m_size];
+        m_size   = m_count < STRING_INLINE_SIZE ? STRING_INLINE_SIZE : m_count + 1;
+        m_string = allocate(m_size);
         MemoryBlock::copy(m_string, str, m_count + 1);
     }
     else
+    {
+        m_size   = m_count ? m_count + 1 : STRING_DEFAULT_SIZE;
         m_string = (char *) str;
+    }
 }
 
 String::String(const int number)
 {
-    m_string    = new char[STRING_DEFAULT_SIZE];
+    m_string    = m_inline;
     m_string[0] = ZERO;
     m_allocated = true;
-    m_size      = STRING_DEFAULT_SIZE;
+    m_size      = STRING_INLINE_SIZE;
     m_count     = 0;
     m_base      = Number::Dec;
 
@@ -85,11 +125,11 @@ String::String(const int number)
 
 String::~String()
 {
-    if (m_allocated)
+    if (m_allocated && !isInline())
     {
         delete[] m_string;
-        m_allocated = false;
     }
+    m_allocated = false;
 }
 
 Size String::size() const
@@ -112,14 +152,95 @@ Size String::length(char *str)
     return length((const char *) str);
 }
 
-Size String::length(const char *str)
+NO_SANITIZE_ADDRESS Size String::length(const char *str)
+{
+    const char *s = str;
+
+    // Check bytes until the string is word aligned
+    for (; ((Address) s % sizeof(ulong)) != 0; s++)
+    {
+        if (!*s)
+            return s - str;
+    }
+
+    // Check a whole word per iteration. Aligned loads never cross a page.
+    const StringWord *w = (const StringWord *) s;
+
+    while (!hasZeroByte(*w))
+        w++;
+
+    // Find the ZERO byte inside the last word
+    for (s = (const char *) w; *s; s++)
+        ;
+
+    return s - str;
+}
+
+NO_SANITIZE_ADDRESS int String::compare(const char *str1, const char *str2, const Size count)
+{
+    const u8 *s1 = (const u8 *) str1, *s2 = (const u8 *) str2;
+    Size n = count ? count : ~((Size) 0);
+
+    // Word compares are only possible if both strings have the same alignment
+    if (((Address) s1 % sizeof(ulong)) == ((Address) s2 % sizeof(ulong)))
+    {
+        for (; n != 0 && ((Address) s1 % sizeof(ulong)) != 0; n--, s1++, s2++)
+        {
+            if (*s1 != *s2 || !*s1)
+                return *s1 - *s2;
+        }
+
+        // Skip equal words which do not contain the end of the strings
+        const StringWord *w1 = (const StringWord *) s1, *w2 = (const StringWord *) s2;
+
+        for (; n >= sizeof(ulong) && *w1 == *w2 && !hasZeroByte(*w1); n -= sizeof(ulong))
+        {
+            w1++, w2++;
+        }
+
+        s1 = (const u8 *) w1;
+        s2 = (const u8 *) w2;
+    }
+
+    // Compare the remaining bytes
+    for (; n != 0; n--, s1++, s2++)
+    {
+        if (*s1 != *s2 || !*s1)
+            return *s1 - *s2;
+    }
+
+    return 0;
+}
+
+NO_SANITIZE_ADDRESS const char * String::find(const char *str, const char character)
 {
-    Size len = 0;
+    const u8 *s = (const u8 *) str;
+    const u8 ch = character;
+    const ulong pattern = ((ulong) ~0UL / 0xff) * ch;
+
+    // Check bytes until the string is word aligned
+    for (; ((Address) s % sizeof(ulong)) != 0; s++)
+    {
+        if (*s == ch)
+            return (const char *) s;
+        else if (!*s)
+            return ZERO;
+    }
 
-    while (*str++)
-        len++;
+    // Skip words without the character and the end of the string
+    const StringWord *w = (const StringWord *) s;
 
-    return len;
+    while (!hasZeroByte(*w) && !hasZeroByte(*w ^ pattern))
+        w++;
+
+    // Find the byte inside the last word
+    for (s = (const u8 *) w; ; s++)
+    {
+        if (*s == ch)
+            return (const char *) s;
+        else if (!*s)
+            return ZERO;
+    }
 }
 
 bool String::resize(const Size size)
@@ -135,22 +256,24 @@ bool String::resize(const Size size)
         m_count = size - 1;
 
     // Allocate buffer
-    buffer = new char[size];
+    buffer = allocate(size);
     if (!buffer)
         return false;
 
     // Copy the contents of the old buffer, if any.
-    MemoryBlock::copy(buffer, m_string, m_count + 1);
+    if (buffer != m_string)
+        MemoryBlock::copy(buffer, m_string, m_count + 1);
+
     buffer[m_count] = ZERO;
 
     // Only cleanup the old buffer if it was previously allocated
-    if (m_allocated)
+    if (m_allocated && !isInline())
         delete[] m_string;
 
     // Update administration
     m_string = buffer;
     m_allocated = true;
-    m_size = size;
+    m_size = isInline() ? STRING_INLINE_SIZE : size;
     return true;
 }
 
@@ -245,14 +368,16 @@ int String::compareTo(const char *str,
     const char *dest = m_string, *src = str;
     Size n = count;
 
+    if (caseSensitive)
+        return compare(dest, src, count);
+
     while (*dest && *src)
     {
         if (count && n-1 == 0)
             break;
 
-        if (( caseSensitive && *dest != *src) ||
-            (!caseSensitive && Character::lower(*dest) != Character::lower(*src)))
-                break;
+        if (Character::lower(*dest) != Character::lower(*src))
+            break;
 
         dest++, src++, n--;
     }
@@ -540,25 +665,17 @@ Size String::setUnsigned(const ulong number,
                          char *string,
                          const bool sign)
 {
-    char *p, *p1, *p2, *saved, tmp;
-    unsigned long ud = number;
-    int remainder, divisor = 10;
+    char digits[24], *p, *first;
+    ulong ud = number;
     Size written = 0;
 
     // If needed, make sure enough allocated space is available.
     if (!string)
-        reserve(STRING_DEFAULT_SIZE - 1);
+        reserve(STRING_INLINE_SIZE - 1);
 
     // Set target buffer
     p = string ? string : m_string;
 
-    // Set divider according to the number system base.
-    switch (base)
-    {
-        case Number::Dec: divisor = 10; break;
-        case Number::Hex: divisor = 16; break;
-    };
-
     // Negative prefix.
     if (sign && (long)number < 0)
     {
@@ -573,33 +690,19 @@ Size String::setUnsigned(const ulong number,
         *p++ = 'x';
         written += 2;
     }
-    saved = p;
 
-    // Divide ud by the divisor, until ud == 0
-    do
+    // Convert and copy the digits in order
+    first = formatNumber(ud, base, digits + sizeof(digits));
+
+    while (first < digits + sizeof(digits))
     {
-        remainder = ud % divisor;
-        *p++ = (remainder < 10) ? remainder + '0' : remainder + 'a' - 10;
+        *p++ = *first++;
+        written++;
     }
-    while (ud /= divisor);
 
     // Terminate buffer
     *p = 0;
 
-    // Initialize pointers
-    p1 = saved;
-    p2 = p - 1;
-    written += p2-p1+1;
-
-    // Reverse buf
-    while (p1 < p2)
-    {
-        tmp = *p1;
-        *p1 = *p2;
-        *p2 = tmp;
-        p1++;
-        p2--;
-    }
     // Update String administration, if needed.
     if (!string)
         m_count = written;
@@ -607,6 +710,70 @@ Size String::setUnsigned(const ulong number,
     return written;
 }
 
+char * String::formatNumber(const u64 number,
+                            const Number::Base base,
+                            char *end)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    static const char decimalPairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+    char *p = end;
+    u64 value = number;
+
+    if (base == Number::Hex)
+    {
+        do
+        {
+            *--p = hexDigits[value & 0xf];
+            value >>= 4;
+        }
+        while (value);
+
+        return p;
+    }
+
+    // Use 64-bit divisions only while the number does not fit in a word
+    while ((ulong) value != value)
+    {
+        const Size pair = (Size) (value % 100) * 2;
+        value /= 100;
+        *--p = decimalPairs[pair + 1];
+        *--p = decimalPairs[pair];
+    }
+
+    // Convert two digits per step
+    ulong n = (ulong) value;
+
+    while (n >= 100)
+    {
+        const Size pair = (n % 100) * 2;
+        n /= 100;
+        *--p = decimalPairs[pair + 1];
+        *--p = decimalPairs[pair];
+    }
+
+    if (n >= 10)
+    {
+        *--p = decimalPairs[(n * 2) + 1];
+        *--p = decimalPairs[n * 2];
+    }
+    else
+    {
+        *--p = '0' + n;
+    }
+
+    return p;
+}
+
 void String::operator = (const char *s)
 {
     Size len = length(s);
@@ -631,6 +798,17 @@ void String::operator = (const String & str)
     }
 }
 
+void String::operator = (String && str)
+{
+    if (&str != this)
+    {
+        if (m_allocated && !isInline())
+            delete[] m_string;
+
+        take(str);
+    }
+}
+
 bool String::operator == (const String & str) const
 {
     return compareTo(str, true) == 0;
@@ -699,3 +877,36 @@ String & String::operator << (const Number::Base base)
     m_base = base;
     return (*this);
 }
+
+bool String::isInline() const
+{
+    return m_string == m_inline;
+}
+
+char * String::allocate(const Size size)
+{
+    return size <= STRING_INLINE_SIZE ? m_inline : new char[size];
+}
+
+void String::take(String & str)
+{
+    m_count     = str.m_count;
+    m_size      = str.m_size;
+    m_base      = str.m_base;
+    m_allocated = str.m_allocated;
+
+    // Inline values are copied, other buffers change owner
+    if (str.isInline())
+    {
+        m_string = m_inline;
+        MemoryBlock::copy(m_inline, str.m_inline, m_count + 1);
+    }
+    else
+        m_string = str.m_string;
+
+    str.m_string    = str.m_inline;
+    str.m_string[0] = ZERO;
+    str.m_allocated = true;
+    str.m_size      = STRING_INLINE_SIZE;
+    str.m_count     = 0;
+}
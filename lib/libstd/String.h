@@ -23,6 +23,7 @@
 #include "Assert.h"
 #include "Sequence.h"
 #include "List.h"
+#include "StringView.h"
 
 /**
  * @addtogroup lib
@@ -35,8 +36,14 @@
 /** Default maximum length of a String's value. */
 #define STRING_DEFAULT_SIZE 64
 
+/** Size of the buffer inside each String, including the NULL byte. */
+#define STRING_INLINE_SIZE 24
+
 /**
  * Abstraction of strings.
+ *
+ * Owned values which fit in STRING_INLINE_SIZE are stored inside the
+ * String object itself and only longer values are allocated on the heap.
  */
 class String : public Sequence<char>
 {
@@ -59,6 +66,22 @@ class String : public Sequence<char>
      */
     String(const String & str);
 
+    /**
+     * Move constructor.
+     *
+     * Takes over the buffer of the given String, which becomes empty.
+     *
+     * @param str String to move from.
+     */
+    String(String && str);
+
+    /**
+     * Construct a copy of a range of characters.
+     *
+     * @param view Characters to copy.
+     */
+    explicit String(const StringView & view);
+
     /**
      * Constructor.
      *
@@ -129,6 +152,29 @@ class String : public Sequence<char>
      */
     static Size length(const char *str);
 
+    /**
+     * Compare two constant character strings.
+     *
+     * @param str1 First input string
+     * @param str2 Second input string
+     * @param count Maximum number of characters to compare or zero to
+     *              continue until a ZERO byte.
+     *
+     * @return int < 0, 0, > 0 if str1 is less than, equal to
+     *         or greater than str2, comparing unsigned characters.
+     */
+    static int compare(const char *str1, const char *str2, const Size count = 0);
+
+    /**
+     * Find the first occurrence of a character in a constant character string.
+     *
+     * @param str Input string
+     * @param character Character to find. The ZERO byte matches the end of the string.
+     *
+     * @return Pointer to the character or ZERO if not found
+     */
+    static const char * find(const char *str, const char character);
+
     /**
      * Change the size of the String buffer.
      *
@@ -350,6 +396,24 @@ class String : public Sequence<char>
      */
     String & upper();
 
+    /**
+     * Write the digits of an unsigned number.
+     *
+     * Decimal numbers are converted two digits per step using a lookup
+     * table and hexadecimal numbers with shifts only. The digits are
+     * written backwards, without sign, prefix or ZERO terminator.
+     *
+     * @param number Number value to use
+     * @param base Numeric base of the given value
+     * @param end Position after the last digit. At least 20 bytes
+     *            before it must be available.
+     *
+     * @return Pointer to the first digit
+     */
+    static char * formatNumber(const u64 number,
+                               const Number::Base base,
+                               char *end);
+
     /**
      * Set text-representation of a signed number.
      *
@@ -388,6 +452,13 @@ class String : public Sequence<char>
      */
     void operator = (const String & str);
 
+    /**
+     * Move assignment operator.
+     *
+     * @param str Input string, which becomes empty.
+     */
+    void operator = (String && str);
+
     /**
      * Comparision operator.
      *
@@ -442,6 +513,31 @@ class String : public Sequence<char>
      */
     String & operator << (const Number::Base format);
 
+  private:
+
+    /**
+     * Check if the value is stored inside the String object.
+     *
+     * @return True if inline, false otherwise.
+     */
+    bool isInline() const;
+
+    /**
+     * Get a buffer for a value.
+     *
+     * @param size Number of bytes needed, including the NULL byte.
+     *
+     * @return The inline buffer if large enough, otherwise a new heap buffer.
+     */
+    char * allocate(const Size size);
+
+    /**
+     * Take over the value of another String.
+     *
+     * @param str String to move from, which becomes empty.
+     */
+    void take(String & str);
+
   private:
 
     /** Current value of the String. */
@@ -456,6 +552,9 @@ class String : public Sequence<char>
     /** True if the string buffer is a deep copy, false otherwise. */
     bool m_allocated;
 
+    /** Buffer for short values. */
+    char m_inline[STRING_INLINE_SIZE];
+
     /** Number format to use for convertions. */
     Number::Base m_base;
 };
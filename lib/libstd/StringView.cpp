@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MemoryBlock.h"
+#include "String.h"
+#include "StringView.h"
+
+StringView::StringView()
+    : m_string("")
+    , m_length(0)
+{
+}
+
+StringView::StringView(const char *str)
+    : m_string(str)
+    , m_length(String::length(str))
+{
+}
+
+StringView::StringView(const char *str, const Size length)
+    : m_string(str)
+    , m_length(length)
+{
+}
+
+StringView::StringView(const String & str)
+    : m_string(*str)
+    , m_length(str.length())
+{
+}
+
+const char * StringView::data() const
+{
+    return m_string;
+}
+
+Size StringView::length() const
+{
+    return m_length;
+}
+
+bool StringView::isEmpty() const
+{
+    return m_length == 0;
+}
+
+StringView StringView::substring(const Size index, const Size size) const
+{
+    const Size from = index >= m_length ? m_length : index;
+    const Size remaining = m_length - from;
+
+    return StringView(m_string + from, size && size < remaining ? size : remaining);
+}
+
+int StringView::compareTo(const StringView & view) const
+{
+    const Size count = m_length < view.m_length ? m_length : view.m_length;
+
+    for (Size i = 0; i < count; i++)
+        if (m_string[i] != view.m_string[i])
+            return (u8) m_string[i] - (u8) view.m_string[i];
+
+    return m_length == view.m_length ? 0 : (m_length < view.m_length ? -1 : 1);
+}
+
+bool StringView::startsWith(const StringView & prefix) const
+{
+    return prefix.m_length <= m_length &&
+           MemoryBlock::compare((const void *) m_string, prefix.m_string, prefix.m_length);
+}
+
+char StringView::operator [] (const Size position) const
+{
+    return m_string[position];
+}
+
+bool StringView::operator == (const StringView & view) const
+{
+    return m_length == view.m_length &&
+           MemoryBlock::compare((const void *) m_string, view.m_string, m_length);
+}
+
+bool StringView::operator != (const StringView & view) const
+{
+    return !(*this == view);
+}
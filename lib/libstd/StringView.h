@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBSTD_STRINGVIEW_H
+#define __LIBSTD_STRINGVIEW_H
+
+#include "Types.h"
+#include "Macros.h"
+
+class String;
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libstd
+ * @{
+ */
+
+/**
+ * Non-owning reference to a range of characters.
+ *
+ * The characters are not copied and need not be null-terminated.
+ * The referenced memory must remain valid while the view is used.
+ */
+class StringView
+{
+  public:
+
+    /**
+     * Default constructor.
+     *
+     * Constructs an empty view.
+     */
+    StringView();
+
+    /**
+     * Construct from a null-terminated character string.
+     *
+     * @param str Character string.
+     */
+    StringView(const char *str);
+
+    /**
+     * Construct from a range of characters.
+     *
+     * @param str First character.
+     * @param length Number of characters.
+     */
+    StringView(const char *str, const Size length);
+
+    /**
+     * Construct from a String.
+     *
+     * @param str String to refer to.
+     */
+    StringView(const String & str);
+
+    /**
+     * Get the first character.
+     *
+     * @return Pointer to the first character, which is not null-terminated.
+     */
+    const char * data() const;
+
+    /**
+     * Get the number of characters.
+     *
+     * @return Length in bytes
+     */
+    Size length() const;
+
+    /**
+     * Check if the view has no characters.
+     *
+     * @return True if empty, false otherwise.
+     */
+    bool isEmpty() const;
+
+    /**
+     * Get a part of the view.
+     *
+     * @param index The begin index of the part.
+     * @param size The maximum size of the part or zero for the remainder.
+     *
+     * @return StringView of the part.
+     */
+    StringView substring(const Size index, const Size size = 0) const;
+
+    /**
+     * Compare with another view.
+     *
+     * @param view View to compare against.
+     *
+     * @return Zero if equal, negative if smaller or positive if greater.
+     */
+    int compareTo(const StringView & view) const;
+
+    /**
+     * Tests if the view starts with the given prefix.
+     *
+     * @param prefix Prefix to match.
+     *
+     * @return True if matched, false otherwise.
+     */
+    bool startsWith(const StringView & prefix) const;
+
+    /**
+     * Character at the given position.
+     *
+     * @param position Valid index inside the view.
+     */
+    char operator [] (const Size position) const;
+
+    /**
+     * Comparision operator.
+     */
+    bool operator == (const StringView & view) const;
+
+    /**
+     * Inequal operator.
+     */
+    bool operator != (const StringView & view) const;
+
+  private:
+
+    /** First character. */
+    const char *m_string;
+
+    /** Number of characters. */
+    Size m_length;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBSTD_STRINGVIEW_H */
@@ -24,6 +24,25 @@
 #include "Macros.h"
 #include "MemoryBlock.h"
 
+#ifdef __HOST__
+#include <new>
+#else
+
+/**
+ * Construct an object at the given memory address.
+ *
+ * @param sz Size of the object (ignored).
+ * @param addr Memory address of the object.
+ *
+ * @return The given memory address.
+ */
+inline void * operator new(__SIZE_TYPE__ sz, void *addr)
+{
+    return addr;
+}
+
+#endif /* __HOST__ */
+
 /**
  * @addtogroup lib
  * @{
@@ -37,9 +56,18 @@
 
 /**
  * Vectors are dynamically resizeable Arrays.
+ *
+ * Storage is allocated uninitialized, such that only the used items are
+ * constructed. Items which are trivially copyable are copied with
+ * MemoryBlock::copy() when growing, others are move constructed.
  */
 template <class T> class Vector : public Sequence<T>
 {
+  private:
+
+    /** True if items can be copied bytewise */
+    static const bool TriviallyCopyable = __is_trivially_copyable(T);
+
   public:
 
     /**
@@ -55,7 +83,7 @@ template <class T> class Vector : public Sequence<T>
 
         m_size  = size;
         m_count = 0;
-        m_array = new T[m_size];
+        m_array = allocate(m_size);
     }
 
     /**
@@ -69,10 +97,17 @@ template <class T> class Vector : public Sequence<T>
 
         m_size  = a.m_size;
         m_count = a.m_count;
-        m_array = new T[m_size];
+        m_array = allocate(m_size);
 
-        for (Size i = 0; i < m_size; i++)
-            m_array[i] = a.m_array[i];
+        if (TriviallyCopyable)
+        {
+            MemoryBlock::copy(m_array, a.m_array, m_count * sizeof(T));
+        }
+        else
+        {
+            for (Size i = 0; i < m_count; i++)
+                new (&m_array[i]) T(a.m_array[i]);
+        }
     }
 
     /**
@@ -80,7 +115,8 @@ template <class T> class Vector : public Sequence<T>
      */
     virtual ~Vector()
     {
-        delete[] m_array;
+        destroy(m_array, 0, m_count);
+        release(m_array);
     }
 
     /**
@@ -96,14 +132,16 @@ template <class T> class Vector : public Sequence<T>
             if (!resize(m_size*2))
                 return -1;
 
-        m_array[m_count++] = item;
-        return m_count-1;
+        new (&m_array[m_count]) T(item);
+        return m_count++;
     }
 
     /**
      * Inserts the given item at the given position.
      *
      * If an item exists at the given position, it will be replaced by the given item.
+     * Positions between the last item and the given position are filled with
+     * default constructed items.
      *
      * @param position The position to insert the item.
      * @param item The item to insert
@@ -120,12 +158,19 @@ template <class T> class Vector : public Sequence<T>
             if (!resize(m_size+increase))
                 return false;
         }
-        // Update the item count if needed
-        if (position >= m_count)
-            m_count += (position+1) - m_count;
 
-        // Assign the item
-        m_array[position] = item;
+        // Replace an existing item
+        if (position < m_count)
+        {
+            m_array[position] = item;
+            return true;
+        }
+
+        // Construct the items up to the given position
+        for (; m_count < position; m_count++)
+            new (&m_array[m_count]) T();
+
+        new (&m_array[m_count++]) T(item);
         return true;
     }
 
@@ -155,11 +200,28 @@ template <class T> class Vector : public Sequence<T>
         return m_array[position];
     }
 
+    /**
+     * Check if the given item is stored in this Vector.
+     *
+     * @param value The item to find.
+     *
+     * @return True if found, false otherwise.
+     */
+    virtual bool contains(const T value) const
+    {
+        for (Size i = 0; i < m_count; i++)
+            if (m_array[i] == value)
+                return true;
+
+        return false;
+    }
+
     /**
      * Remove all items from the vector.
      */
     virtual void clear()
     {
+        destroy(m_array, 0, m_count);
         m_count = 0;
     }
 
@@ -180,8 +242,9 @@ template <class T> class Vector : public Sequence<T>
         // Move all consequetive items
         for (Size i = position; i < m_count-1; i++)
         {
-            m_array[i] = m_array[i+1];
+            m_array[i] = static_cast<T &&>(m_array[i+1]);
         }
+        destroy(m_array, m_count-1, m_count);
         m_count--;
         return true;
     }
@@ -219,28 +282,101 @@ template <class T> class Vector : public Sequence<T>
     /**
      * Resize the Vector.
      *
+     * Items beyond the new size are removed.
+     *
      * @param size New size of the Vector
      */
     virtual bool resize(Size size)
     {
         assert(size > 0);
 
-        T *arr = new T[size];
+        T *arr = allocate(size);
         if (!arr)
             return false;
 
-        // Copy the old array in the new one
-        for (Size i = 0; i < m_size; i++)
+        const Size keep = m_count < size ? m_count : size;
+
+        // Move the old items into the new array
+        if (TriviallyCopyable)
         {
-            arr[i] = m_array[i];
+            MemoryBlock::copy(arr, m_array, keep * sizeof(T));
         }
+        else
+        {
+            for (Size i = 0; i < keep; i++)
+                new (&arr[i]) T(static_cast<T &&>(m_array[i]));
+        }
+
         // Clean up the old array and set the new one
-        delete[] m_array;
+        destroy(m_array, 0, m_count);
+        release(m_array);
         m_array = arr;
         m_size  = size;
+        m_count = keep;
         return true;
     }
 
+    /**
+     * Ensure the Vector can hold the given number of items without growing.
+     *
+     * @param size Minimum size of the Vector
+     *
+     * @return True on success, false otherwise.
+     */
+    bool reserve(Size size)
+    {
+        return size <= m_size ? true : resize(size);
+    }
+
+    /**
+     * Reduce the size of the Vector to the number of items inside.
+     *
+     * @return True on success, false otherwise.
+     */
+    bool shrinkToFit()
+    {
+        const Size size = m_count ? m_count : 1;
+
+        return size == m_size ? true : resize(size);
+    }
+
+  private:
+
+    /**
+     * Allocate uninitialized storage.
+     *
+     * @param size Number of items to allocate storage for.
+     *
+     * @return Pointer to the storage or ZERO on failure.
+     */
+    static T * allocate(const Size size)
+    {
+        return (T *) new u8[size * sizeof(T)];
+    }
+
+    /**
+     * Release storage from allocate().
+     *
+     * @param array Pointer to the storage.
+     */
+    static void release(T *array)
+    {
+        delete[] (u8 *) array;
+    }
+
+    /**
+     * Destruct a range of items.
+     *
+     * @param array Array of items.
+     * @param from First item to destruct.
+     * @param to End item to destruct (exclusive).
+     */
+    static void destroy(T *array, const Size from, const Size to)
+    {
+        for (Size i = from; i < to; i++)
+            array[i].~T();
+    }
+
   private:
 
     /** The actual array where the data is stored. */
@@ -285,13 +285,70 @@ teken_input_byte(teken_t *t, unsigned char c)
 #endif /* TEKEN_UTF8 */
 }
 
+/*
+ * Fast path for runs of printable ASCII outside of escape sequences.
+ * Prints the part of the run which fits on the cursor row with a single
+ * tf_putstr() call and updates the cursor once. Returns the number of
+ * bytes processed, or zero if the next byte needs the regular path.
+ */
+static size_t
+teken_input_run(teken_t *t, const char *c, size_t len)
+{
+	teken_pos_t tp = t->t_cursor;
+	size_t n, room;
+
+	if (t->t_funcs->tf_putstr == NULL ||
+	    t->t_nextstate != teken_state_init ||
+	    t->t_stateflags & (TS_INSERT|TS_WRAPPED))
+		return (0);
+#ifdef TEKEN_UTF8
+	if (t->t_utf8_left != 0)
+		return (0);
+#endif /* TEKEN_UTF8 */
+#if defined(TEKEN_XTERM) && defined(TEKEN_UTF8)
+	if (t->t_scs[t->t_curscs] != teken_scs_us_ascii)
+		return (0);
+#endif /* TEKEN_XTERM && TEKEN_UTF8 */
+
+	/* Without xterm wrapping, leave the last column to the regular path. */
+	room = t->t_winsize.tp_col - t->t_cursor.tp_col;
+#ifndef TEKEN_XTERM
+	room--;
+#endif /* !TEKEN_XTERM */
+
+	for (n = 0; n < len && n < room && c[n] >= 0x20 && c[n] < 0x7f; n++)
+		;
+	if (n == 0)
+		return (0);
+
+	t->t_funcs->tf_putstr(t->t_softc, &tp, c, n, &t->t_curattr);
+	t->t_cursor.tp_col += n;
+
+#ifdef TEKEN_XTERM
+	if (t->t_cursor.tp_col >= t->t_winsize.tp_col) {
+		t->t_stateflags |= TS_WRAPPED;
+		t->t_cursor.tp_col = t->t_winsize.tp_col - 1;
+	}
+#endif /* TEKEN_XTERM */
+
+	teken_funcs_cursor(t);
+	return (n);
+}
+
 void
 teken_input(teken_t *t, const void *buf, size_t len)
 {
 	const char *c = (const char *)buf;
+	size_t n;
 
-	while (len-- > 0)
-		teken_input_byte(t, *c++);
+	while (len > 0) {
+		if ((n = teken_input_run(t, c, len)) == 0) {
+			teken_input_byte(t, *c);
+			n = 1;
+		}
+		c += n;
+		len -= n;
+	}
 }
 
 void
@@ -95,6 +95,9 @@ typedef void tf_bell_t(void *);
 typedef void tf_cursor_t(void *, const teken_pos_t *);
 typedef void tf_putchar_t(void *, const teken_pos_t *, teken_char_t,
     const teken_attr_t *);
+/* Optional: print a run of ASCII characters on a single row. */
+typedef void tf_putstr_t(void *, const teken_pos_t *, const char *, size_t,
+    const teken_attr_t *);
 typedef void tf_fill_t(void *, const teken_rect_t *, teken_char_t,
     const teken_attr_t *);
 typedef void tf_copy_t(void *, const teken_rect_t *, const teken_pos_t *);
@@ -118,6 +121,7 @@ typedef struct {
 	tf_copy_t	*tf_copy;
 	tf_param_t	*tf_param;
 	tf_respond_t	*tf_respond;
+	tf_putstr_t	*tf_putstr;
 } teken_funcs_t;
 
 #if defined(TEKEN_XTERM) && defined(TEKEN_UTF8)
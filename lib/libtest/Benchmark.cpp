@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkSuite.h"
+#include "Benchmark.h"
+
+Benchmark::Benchmark(const char *name, BenchmarkFunction func)
+    : m_name(name, true)
+    , m_func(func)
+{
+    BenchmarkSuite::instance()->addBenchmark(this);
+}
+
+const String & Benchmark::getName() const
+{
+    return m_name;
+}
+
+void Benchmark::run(const Size iterations) const
+{
+    m_func(iterations);
+}
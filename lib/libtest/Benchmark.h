@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBTEST_BENCHMARK_H
+#define __LIBTEST_BENCHMARK_H
+
+#include <Types.h>
+#include <Macros.h>
+#include <String.h>
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libtest
+ * @{
+ */
+
+typedef void BenchmarkFunction(const Size iterations);
+
+/**
+ * Define a benchmark.
+ *
+ * The body runs the measured operation the given number of iterations.
+ * Setup done by the body is included in the measurement, so it should
+ * be cheap or amortized over all iterations.
+ */
+#define BenchmarkCase(name) \
+    void name (const Size iterations); \
+    Benchmark benchmark_##name (QUOTE(name), name); \
+    void name (const Size iterations)
+
+/**
+ * Prevent the compiler from optimizing away the computation of a value.
+ *
+ * @param value Result of the measured operation
+ */
+#define benchmarkUse(value) \
+    asm volatile ("" : : "g" (value) : "memory")
+
+/**
+ * Represents a micro-benchmark inside the same process
+ */
+class Benchmark
+{
+  public:
+
+    /**
+     * Class constructor
+     *
+     * @param name Name of the benchmark
+     * @param func Benchmark function to run
+     */
+    Benchmark(const char *name, BenchmarkFunction func);
+
+    /**
+     * Retrieve benchmark name
+     *
+     * @return Benchmark name
+     */
+    const String & getName() const;
+
+    /**
+     * Run the benchmark function
+     *
+     * @param iterations Number of times to run the measured operation
+     */
+    void run(const Size iterations) const;
+
+  private:
+
+    /** Name of the benchmark */
+    String m_name;
+
+    /** Contains the benchmark to run */
+    BenchmarkFunction *m_func;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBTEST_BENCHMARK_H */
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBTEST_BENCHMARKMAIN_H
+#define __LIBTEST_BENCHMARKMAIN_H
+
+#include <StdioLog.h>
+#include "BenchmarkRunner.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libtest
+ * @{
+ */
+
+/**
+ * Default benchmark program main function
+ *
+ * @param argc Argument count
+ * @param argv Argument values
+ *
+ * @return Zero on success or number of regressions
+ */
+int main(int argc, char **argv)
+{
+    StdioLog log;
+    BenchmarkRunner benchmarks(argc, argv);
+    return benchmarks.run();
+}
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBTEST_BENCHMARKMAIN_H */
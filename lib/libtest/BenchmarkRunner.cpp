@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <libgen.h>
+#ifdef __HOST__
+#include <time.h>
+#else
+#include <sys/time.h>
+#endif
+#include <ListIterator.h>
+#include <TerminalCodes.h>
+#include "Benchmark.h"
+#include "BenchmarkSuite.h"
+#include "BenchmarkRunner.h"
+
+BenchmarkRunner::BenchmarkRunner(int argc, char **argv)
+{
+    // Set member default values.
+    m_argc = argc;
+    m_argv = argv;
+    m_filter = ZERO;
+    m_baselinePath = ZERO;
+    m_savePath = ZERO;
+    m_samples = DefaultSamples;
+    m_threshold = DefaultThreshold;
+
+    // Check for command-line specified arguments.
+    for (int i = 1; i < argc - 1; i++)
+    {
+        if (strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--filter") == 0)
+            m_filter = argv[++i];
+        else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--baseline") == 0)
+            m_baselinePath = argv[++i];
+        else if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--save") == 0)
+            m_savePath = argv[++i];
+        else if (strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--samples") == 0)
+        {
+            const int samples = atoi(argv[++i]);
+            m_samples = samples > 1 ? samples : 1;
+        }
+        else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threshold") == 0)
+        {
+            const int threshold = atoi(argv[++i]);
+            m_threshold = threshold > 0 ? threshold : 0;
+        }
+    }
+}
+
+int BenchmarkRunner::run(void)
+{
+    List<Benchmark *> *benchmarks = BenchmarkSuite::instance()->getBenchmarks();
+    u64 *samples = new u64[m_samples];
+    String results;
+    char line[128];
+    int regressions = 0;
+
+    if (m_baselinePath && !loadBaseline(m_baselinePath))
+    {
+        printf("%s: failed to read baseline '%s'\r\n", basename(m_argv[0]), m_baselinePath);
+        delete[] samples;
+        return EXIT_FAILURE;
+    }
+
+    for (ListIterator<Benchmark *> i(benchmarks); i.hasCurrent(); i++)
+    {
+        const Benchmark *benchmark = i.current();
+        const String & name = benchmark->getName();
+
+        if (m_filter && !name.match(m_filter))
+            continue;
+
+        printf("%s%s: %s .. ", WHITE, basename(m_argv[0]), *name);
+        fflush(stdout);
+
+        // Collect samples in picoseconds per operation
+        const Size iterations = calibrate(*benchmark);
+
+        for (Size j = 0; j < m_samples; j++)
+            samples[j] = (measure(*benchmark, iterations) * 1000) / iterations;
+
+        const u64 result = median(samples, m_samples);
+        const u64 fastest = samples[0];
+
+        // Median absolute deviation relative to the median in tenths of a percent
+        for (Size j = 0; j < m_samples; j++)
+            samples[j] = samples[j] > result ? samples[j] - result : result - samples[j];
+
+        const u64 deviation = result ? (median(samples, m_samples) * 1000) / result : 0;
+
+        printf("%s ns/op (min %s, mad %u.%u%%)", *formatTime(result), *formatTime(fastest),
+               (uint) (deviation / 10), (uint) (deviation % 10));
+
+        // Compare against the baseline
+        const u64 *baseline = m_baseline.get(name);
+
+        if (baseline && *baseline)
+        {
+            const bool slower = result > *baseline;
+            const u64 change = ((slower ? result - *baseline : *baseline - result) * 1000) / *baseline;
+
+            printf(" baseline %s %c%u.%u%%", *formatTime(*baseline), slower ? '+' : '-',
+                   (uint) (change / 10), (uint) (change % 10));
+
+            if (slower && change > m_threshold * 10)
+            {
+                printf(" %sREGRESSION%s", RED, WHITE);
+                regressions++;
+            }
+        }
+        printf("\r\n");
+        fflush(stdout);
+
+        snprintf(line, sizeof(line), "%s %llu\n", *name, (unsigned long long) result);
+        results << line;
+    }
+    delete[] samples;
+
+    if (m_savePath && !saveBaseline(m_savePath, results))
+    {
+        printf("%s: failed to write baseline '%s'\r\n", basename(m_argv[0]), m_savePath);
+        return EXIT_FAILURE;
+    }
+
+    return regressions;
+}
+
+u64 BenchmarkRunner::timestamp() const
+{
+#ifdef __HOST__
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((u64) now.tv_sec * 1000000000ULL) + now.tv_nsec;
+#else
+    struct timeval now;
+    gettimeofday(&now, ZERO);
+    return ((u64) now.tv_sec * 1000000000ULL) + ((u64) now.tv_usec * 1000ULL);
+#endif
+}
+
+u64 BenchmarkRunner::measure(const Benchmark & benchmark, const Size iterations) const
+{
+    const u64 start = timestamp();
+    benchmark.run(iterations);
+    return timestamp() - start;
+}
+
+Size BenchmarkRunner::calibrate(const Benchmark & benchmark) const
+{
+    Size iterations = 1;
+
+    // The calibration runs also warm up the caches and the allocator
+    while (iterations < MaximumIterations)
+    {
+        const u64 elapsed = measure(benchmark, iterations);
+
+        if (elapsed >= MinimumSampleTime)
+            break;
+
+        // Grow towards the minimum sample time, at most ten times per step
+        if (elapsed == 0 || elapsed * 10 < MinimumSampleTime)
+            iterations *= 10;
+        else
+            iterations = (Size) ((iterations * MinimumSampleTime * 11) / (elapsed * 10)) + 1;
+    }
+
+    return iterations < MaximumIterations ? iterations : MaximumIterations;
+}
+
+u64 BenchmarkRunner::median(u64 *values, const Size count)
+{
+    // Insertion sort is sufficient for the small number of samples
+    for (Size i = 1; i < count; i++)
+    {
+        const u64 value = values[i];
+        Size j = i;
+
+        for (; j > 0 && values[j - 1] > value; j--)
+            values[j] = values[j - 1];
+
+        values[j] = value;
+    }
+
+    if (count % 2)
+        return values[count / 2];
+    else
+        return (values[(count / 2) - 1] + values[count / 2]) / 2;
+}
+
+String BenchmarkRunner::formatTime(const u64 picoseconds)
+{
+    char buf[32];
+
+    snprintf(buf, sizeof(buf), "%llu.%03u",
+             (unsigned long long) (picoseconds / 1000), (uint) (picoseconds % 1000));
+
+    return String(buf);
+}
+
+bool BenchmarkRunner::loadBaseline(const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    String contents;
+    char buf[256];
+    Size bytes;
+
+    if (!fp)
+        return false;
+
+    while ((bytes = fread(buf, 1, sizeof(buf) - 1, fp)) > 0)
+    {
+        buf[bytes] = 0;
+        contents << buf;
+    }
+    fclose(fp);
+
+    // Each line contains the benchmark name and picoseconds per operation
+    const List<String> lines = contents.split('\n');
+
+    for (ListIterator<String> i(lines); i.hasCurrent(); i++)
+    {
+        const List<String> fields = i.current().split(' ');
+        u64 value = 0;
+
+        if (fields.count() != 2)
+            continue;
+
+        for (const char *c = *fields[1]; *c >= '0' && *c <= '9'; c++)
+            value = (value * 10) + (*c - '0');
+
+        m_baseline.insert(fields[0], value);
+    }
+
+    return true;
+}
+
+bool BenchmarkRunner::saveBaseline(const char *path, const String & results) const
+{
+    FILE *fp = fopen(path, "w");
+
+    if (!fp)
+        return false;
+
+    const bool written = fwrite(*results, 1, results.length(), fp) == results.length();
+    return fclose(fp) == 0 && written;
+}
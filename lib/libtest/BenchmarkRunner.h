@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBTEST_BENCHMARKRUNNER_H
+#define __LIBTEST_BENCHMARKRUNNER_H
+
+#include <Types.h>
+#include <String.h>
+#include <HashTable.h>
+
+class Benchmark;
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libtest
+ * @{
+ */
+
+/**
+ * Runs micro-benchmarks and reports the time per operation
+ *
+ * Each benchmark is first calibrated to the number of iterations that
+ * takes at least MinimumSampleTime. It then runs for a number of samples,
+ * of which the median time per operation is reported together with the
+ * fastest sample and the median absolute deviation.
+ *
+ * The results can be saved as a baseline file with --save and compared
+ * against a baseline with --baseline. Benchmarks which are slower than
+ * the baseline by more than the threshold are reported as a regression.
+ */
+class BenchmarkRunner
+{
+  private:
+
+    /** Minimum duration of a single sample in nanoseconds */
+    static const u64 MinimumSampleTime = 10000000;
+
+    /** Maximum number of iterations of a single sample */
+    static const Size MaximumIterations = 1 << 30;
+
+    /** Default number of samples per benchmark */
+    static const Size DefaultSamples = 11;
+
+    /** Default regression threshold in percent */
+    static const Size DefaultThreshold = 10;
+
+  public:
+
+    /**
+     * Class constructor
+     *
+     * @param argc Program argument count
+     * @param argv Program argument values
+     */
+    BenchmarkRunner(int argc, char **argv);
+
+    /**
+     * Run all benchmarks
+     *
+     * @return Number of regressions. Zero if none.
+     */
+    int run(void);
+
+  private:
+
+    /**
+     * Get current time
+     *
+     * @return Monotonic time in nanoseconds
+     */
+    u64 timestamp() const;
+
+    /**
+     * Measure a single run of a benchmark
+     *
+     * @param benchmark Benchmark to run
+     * @param iterations Number of iterations to run
+     *
+     * @return Duration in nanoseconds
+     */
+    u64 measure(const Benchmark & benchmark, const Size iterations) const;
+
+    /**
+     * Find the number of iterations for a single sample
+     *
+     * @param benchmark Benchmark to run
+     *
+     * @return Number of iterations
+     */
+    Size calibrate(const Benchmark & benchmark) const;
+
+    /**
+     * Get the median of a list of values
+     *
+     * @param values Values to sort in place
+     * @param count Number of values
+     *
+     * @return Median value
+     */
+    static u64 median(u64 *values, const Size count);
+
+    /**
+     * Format a duration in picoseconds as nanoseconds
+     *
+     * @param picoseconds Duration in picoseconds
+     *
+     * @return Nanoseconds with three decimals
+     */
+    static String formatTime(const u64 picoseconds);
+
+    /**
+     * Read the baseline file
+     *
+     * @param path Path to the baseline file
+     *
+     * @return True on success, false otherwise
+     */
+    bool loadBaseline(const char *path);
+
+    /**
+     * Write the results to a baseline file
+     *
+     * @param path Path to the baseline file
+     * @param results Lines with the name and picoseconds per operation
+     *
+     * @return True on success, false otherwise
+     */
+    bool saveBaseline(const char *path, const String & results) const;
+
+  private:
+
+    /** Program argument count */
+    int m_argc;
+
+    /** Program argument values */
+    char **m_argv;
+
+    /** Only run benchmarks which match this mask */
+    const char *m_filter;
+
+    /** Baseline file to compare against */
+    const char *m_baselinePath;
+
+    /** Baseline file to save the results to */
+    const char *m_savePath;
+
+    /** Number of samples per benchmark */
+    Size m_samples;
+
+    /** Regression threshold in percent */
+    Size m_threshold;
+
+    /** Baseline picoseconds per operation by benchmark name */
+    HashTable<String, u64> m_baseline;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBTEST_BENCHMARKRUNNER_H */
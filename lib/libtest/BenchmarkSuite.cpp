@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkSuite.h"
+
+BenchmarkSuite::BenchmarkSuite()
+    : StrictSingleton<BenchmarkSuite>()
+{
+}
+
+void BenchmarkSuite::addBenchmark(Benchmark *benchmark)
+{
+    m_benchmarks.append(benchmark);
+}
+
+List<Benchmark *> * BenchmarkSuite::getBenchmarks()
+{
+    return & m_benchmarks;
+}
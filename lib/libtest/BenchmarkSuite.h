@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBTEST_BENCHMARKSUITE_H
+#define __LIBTEST_BENCHMARKSUITE_H
+
+#include <Singleton.h>
+#include <List.h>
+
+class Benchmark;
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libtest
+ * @{
+ */
+
+/**
+ * Contains all benchmarks of a benchmark program
+ */
+class BenchmarkSuite : public StrictSingleton<BenchmarkSuite>
+{
+  public:
+
+    /**
+     * Class constructor
+     */
+    BenchmarkSuite();
+
+    /**
+     * Add a benchmark
+     *
+     * @param benchmark Benchmark to add
+     */
+    void addBenchmark(Benchmark *benchmark);
+
+    /**
+     * Retrieve a list of all benchmarks
+     *
+     * @return List of Benchmarks
+     */
+    List<Benchmark *> * getBenchmarks();
+
+  private:
+
+    /** List of Benchmarks in the suite */
+    List<Benchmark *> m_benchmarks;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBTEST_BENCHMARKSUITE_H */
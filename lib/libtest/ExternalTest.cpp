@@ -23,6 +23,10 @@
 #include <libgen.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <fcntl.h>
+#ifndef __HOST__
+#include <FileSystemClient.h>
+#endif /* __HOST__ */
 #include "ExternalTest.h"
 
 ExternalTest::ExternalTest(const char *name, int argc, char **argv)
@@ -30,6 +34,7 @@ ExternalTest::ExternalTest(const char *name, int argc, char **argv)
 {
     m_argc = argc;
     m_argv = argv;
+    m_pid  = -1;
 }
 
 ExternalTest::~ExternalTest()
@@ -39,24 +44,116 @@ ExternalTest::~ExternalTest()
 TestResult ExternalTest::run()
 {
     int status;
-    pid_t pid;
+    char **argv = arguments();
+
+    const pid_t pid = spawn(argv, -1);
+    waitpid(pid, &status, 0);
+    delete[] argv;
+
+    return status == 0 ? OK : FAIL;
+}
+
+bool ExternalTest::start(const char *outputPath)
+{
+    char **argv = arguments();
+    int fd;
+
+    // Create an empty file for the output
+#ifdef __HOST__
+    fd = open(outputPath, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+#else
+    const FileSystemClient filesystem;
+
+    filesystem.deleteFile(outputPath);
+    if (filesystem.createFile(outputPath, FileSystem::RegularFile, FileSystem::OwnerRW) == FileSystem::Success)
+        fd = open(outputPath, O_WRONLY);
+    else
+        fd = -1;
+#endif /* __HOST__ */
+
+    if (fd < 0)
+    {
+        delete[] argv;
+        return false;
+    }
+
+    m_pid = spawn(argv, fd);
+    m_output = outputPath;
+    close(fd);
+    delete[] argv;
+
+    return m_pid > 0;
+}
+
+TestResult ExternalTest::wait()
+{
+    char buf[512];
+    int status, fd;
+    ssize_t bytes;
+
+    waitpid(m_pid, &status, 0);
+    m_pid = -1;
+
+    // Copy the output of the test to our own output
+    if ((fd = open(*m_output, O_RDONLY)) >= 0)
+    {
+        fflush(stdout);
+
+        while ((bytes = read(fd, buf, sizeof(buf))) > 0)
+            write(1, buf, bytes);
+
+        close(fd);
+    }
+    unlink(*m_output);
+
+    return status == 0 ? OK : FAIL;
+}
+
+char ** ExternalTest::arguments() const
+{
     char **argv = new char * [m_argc + 2];
 
     for (int i = 1; i < m_argc; i++)
         argv[i] = m_argv[i];
 
-    argv[0]        = *m_name;
+    argv[0]        = (char *) *m_name;
     argv[m_argc]   = (char *) "-n";
     argv[m_argc+1] = 0;
 
+    return argv;
+}
+
+int ExternalTest::spawn(char **argv, const int output) const
+{
+    pid_t pid;
+
+    // Pending output must not end up in the output of the test
+    fflush(stdout);
+
 #ifdef __HOST__
     if ((pid = fork()) == 0)
+    {
+        if (output >= 0)
+            dup2(output, 1);
+
         execv(argv[0], argv);
+        _exit(EXIT_FAILURE);
+    }
 #else
+    // The test program inherits our file descriptors
+    const int saved = output >= 0 ? dup(1) : -1;
+
+    if (saved >= 0)
+        dup2(output, 1);
+
     pid = forkexec(*m_name, (const char **) argv);
-#endif
-    waitpid(pid, &status, 0);
-    delete[] argv;
 
-    return status == 0 ? OK : FAIL;
+    if (saved >= 0)
+    {
+        dup2(saved, 1);
+        close(saved);
+    }
+#endif /* __HOST__ */
+
+    return pid;
 }
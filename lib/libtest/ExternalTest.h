@@ -56,6 +56,41 @@ class ExternalTest : public TestInstance
      */
     virtual TestResult run();
 
+    /**
+     * Start the external test in the background
+     *
+     * @param outputPath File to store the standard output of the test in
+     *
+     * @return True if started, false otherwise
+     */
+    virtual bool start(const char *outputPath);
+
+    /**
+     * Wait for the external test started in the background
+     *
+     * @return TestResult
+     */
+    virtual TestResult wait();
+
+  private:
+
+    /**
+     * Create the argument list of the test program
+     *
+     * @return Argument values terminated by ZERO, to be released with delete[]
+     */
+    char ** arguments() const;
+
+    /**
+     * Start the test program
+     *
+     * @param argv Argument values
+     * @param output File descriptor for standard output or -1 to keep ours
+     *
+     * @return Process identifier of the test program or -1 on failure
+     */
+    int spawn(char **argv, const int output) const;
+
   private:
 
     /** Program argument count */
@@ -63,6 +98,12 @@ class ExternalTest : public TestInstance
 
     /** Program argument values */
     char ** m_argv;
+
+    /** Process identifier of the test program started in the background */
+    int m_pid;
+
+    /** File with the standard output of the test program started in the background */
+    String m_output;
 };
 
 /**
@@ -34,9 +34,7 @@ void StdoutReporter::reportBegin(List<TestInstance *> & tests)
     if (m_multiline)
         printf("%s%s: running %d tests\r\n", WHITE, basename(m_argv[0]), tests.count());
 
-#ifdef __HOST__
     fflush(stdout);
-#endif /* __HOST__ */
 }
 
 void StdoutReporter::reportBefore(TestInstance & test)
@@ -48,9 +46,7 @@ void StdoutReporter::reportBefore(TestInstance & test)
     else
         printf(" .. ");
 
-#ifdef __HOST__
     fflush(stdout);
-#endif /* __HOST__ */
 }
 
 void StdoutReporter::reportAfter(TestInstance & test, TestResult & result)
@@ -69,9 +65,7 @@ void StdoutReporter::reportAfter(TestInstance & test, TestResult & result)
     if (m_multiline)
         printf("\r\n");
 
-#ifdef __HOST__
     fflush(stdout);
-#endif /* __HOST__ */
 }
 
 void StdoutReporter::reportFinish(List<TestInstance *> & tests)
@@ -84,7 +78,5 @@ void StdoutReporter::reportFinish(List<TestInstance *> & tests)
     printf("(%d passed %d failed %d skipped %d total)\r\n",
             m_ok, m_fail, m_skip, (m_ok + m_fail + m_skip));
 
-#ifdef __HOST__
     fflush(stdout);
-#endif /* __HOST__ */
 }
@@ -32,3 +32,13 @@ const String & TestInstance::getName() const
 {
     return m_name;
 }
+
+bool TestInstance::start(const char *outputPath)
+{
+    return false;
+}
+
+TestResult TestInstance::wait()
+{
+    return FAIL;
+}
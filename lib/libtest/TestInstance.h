@@ -62,6 +62,24 @@ class TestInstance
      */
     virtual TestResult run() = 0;
 
+    /**
+     * Start the test instance in the background
+     *
+     * @param outputPath File to store the output of the test in
+     *
+     * @return True if started, false if the test can only run with run()
+     */
+    virtual bool start(const char *outputPath);
+
+    /**
+     * Wait for a test instance started in the background
+     *
+     * Writes the stored output of the test to standard output.
+     *
+     * @return TestResult
+     */
+    virtual TestResult wait();
+
   protected:
 
     /** Name of the test instance */
@@ -15,7 +15,10 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include <ListIterator.h>
 #include "TestCase.h"
 #include "TestSuite.h"
@@ -30,6 +33,17 @@ TestRunner::TestRunner(int argc, char **argv)
     m_argc = argc;
     m_argv = argv;
     m_reporter = new StdoutReporter(argc, argv);
+    m_jobs = 1;
+
+    // Number of tests to run at the same time
+    for (int i = 0; i < argc - 1; i++)
+    {
+        if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0)
+        {
+            const int jobs = atoi(argv[i + 1]);
+            m_jobs = jobs > 1 ? jobs : 1;
+        }
+    }
 
     // Check for command-line specified arguments.
     for (int i = 0; i < argc; i++)
@@ -74,17 +88,63 @@ int TestRunner::run(void)
     m_reporter->begin(*tests);
 
     // Execute tests. Report per-test stats.
-    for (ListIterator<TestInstance *> i(tests); i.hasCurrent(); i++)
+    if (m_jobs > 1)
     {
-        TestInstance *test = i.current();
-        if (!test)
-            break;
+        runParallel(*tests);
+    }
+    else
+    {
+        for (ListIterator<TestInstance *> i(tests); i.hasCurrent(); i++)
+        {
+            TestInstance *test = i.current();
+            if (!test)
+                break;
 
-        m_reporter->prepare(*test);
-        TestResult result = test->run();
-        m_reporter->collect(*test, result);
+            m_reporter->prepare(*test);
+            TestResult result = test->run();
+            m_reporter->collect(*test, result);
+        }
     }
     // Finish testing. Report final stats.
     m_reporter->finish(*tests);
     return m_reporter->getFailed();
 }
+
+void TestRunner::runParallel(List<TestInstance *> & tests)
+{
+    const Size count = tests.count();
+    TestInstance **list = new TestInstance * [count];
+    bool *started = new bool[count];
+    char outputPath[64];
+    Size num = 0, next = 0, running = 0;
+
+    for (ListIterator<TestInstance *> i(tests); i.hasCurrent() && i.current(); i++)
+    {
+        list[num] = i.current();
+        started[num++] = false;
+    }
+
+    for (Size i = 0; i < num; i++)
+    {
+        // Keep the maximum number of test programs running ahead
+        for (; next < num && running < m_jobs; next++)
+        {
+            snprintf(outputPath, sizeof(outputPath), "/tmp/testrunner.%u.%u.out",
+                     (uint) getpid(), (uint) next);
+
+            if ((started[next] = list[next]->start(outputPath)))
+                running++;
+        }
+
+        // Report in order of the tests. Other tests run directly.
+        m_reporter->prepare(*list[i]);
+        TestResult result = started[i] ? list[i]->wait() : list[i]->run();
+        m_reporter->collect(*list[i], result);
+
+        if (started[i])
+            running--;
+    }
+
+    delete[] list;
+    delete[] started;
+}
@@ -32,6 +32,9 @@ class TestReporter;
 
 /**
  * Reponsible for discovering and running tests
+ *
+ * With the -j or --jobs argument, multiple test programs run at the same
+ * time. Their output is stored and reported in the order of the tests.
  */
 class TestRunner
 {
@@ -64,6 +67,18 @@ class TestRunner
      */
     int run(void);
 
+  private:
+
+    /**
+     * Run tests with multiple test programs at the same time
+     *
+     * Test programs are started in the background ahead of the test
+     * which is reported, such that the output remains in test order.
+     *
+     * @param tests Tests to run
+     */
+    void runParallel(List<TestInstance *> & tests);
+
   protected:
 
     /** Program argument count */
@@ -74,6 +89,9 @@ class TestRunner
 
     /** Reports test results */
     TestReporter *m_reporter;
+
+    /** Maximum number of tests to run at the same time */
+    Size m_jobs;
 };
 
 /**
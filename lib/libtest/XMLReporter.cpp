@@ -45,9 +45,7 @@ void XMLReporter::reportBegin(List<TestInstance *> & tests)
                 m_argv[0], m_argv[0], tests.count());
     }
 
-#ifdef __HOST__
     fflush(stdout);
-#endif /* __HOST__ */
 }
 
 void XMLReporter::reportBefore(TestInstance & test)
@@ -63,9 +61,7 @@ void XMLReporter::reportBefore(TestInstance & test)
                 m_argv[0], *test.m_name);
     }
 
-#ifdef __HOST__
     fflush(stdout);
-#endif /* __HOST__ */
 }
 
 void XMLReporter::reportAfter(TestInstance & test, TestResult & result)
@@ -100,9 +96,7 @@ void XMLReporter::reportAfter(TestInstance & test, TestResult & result)
         printf("   </testcase>\r\n");
     }
 
-#ifdef __HOST__
     fflush(stdout);
-#endif /* __HOST__ */
 }
 
 void XMLReporter::reportFinish(List<TestInstance *> & tests)
@@ -118,7 +112,5 @@ void XMLReporter::reportFinish(List<TestInstance *> & tests)
     printf("%s (%d passed %d failed %d skipped %d total) -->\r\n",
             m_fail == 0 ? "OK" : "FAIL", m_ok, m_fail, m_skip, (m_ok + m_fail + m_skip));
 
-#ifdef __HOST__
     fflush(stdout);
-#endif /* __HOST__ */
 }
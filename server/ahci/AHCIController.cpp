@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Log.h>
+#include <String.h>
+#include "AHCIDrive.h"
+#include "AHCIController.h"
+
+AHCIController::AHCIController(DeviceServer &server)
+    : m_server(server)
+    , m_irq(0)
+    , m_capabilities(0)
+{
+}
+
+FileSystem::Result AHCIController::initialize()
+{
+    Size count = 0;
+
+    const FileSystem::Result detectResult = detect();
+    if (detectResult != FileSystem::Success)
+    {
+        return detectResult;
+    }
+
+    const FileSystem::Result resetResult = reset();
+    if (resetResult != FileSystem::Success)
+    {
+        ERROR("hardware reset failed: result = " << (int) resetResult);
+        return resetResult;
+    }
+
+    // Register a drive for each implemented port with a SATA drive attached
+    const u32 ports = m_io.read(PortsImplemented);
+
+    for (Size port = 0; port < MaximumPorts; port++)
+    {
+        if (!(ports & (1U << port)))
+        {
+            continue;
+        }
+
+        if (!AHCIDrive::isPresent(m_io, port))
+        {
+            continue;
+        }
+
+        String name;
+        name << "sata" << count++;
+
+        AHCIDrive *drive = new AHCIDrive(m_server.getNextInode(), *this, port, *name);
+        m_server.registerDevice(drive, *name);
+        m_server.registerInterrupt(drive, m_irq);
+
+        NOTICE("drive " << *name << " on port " << port);
+    }
+
+    if (count == 0)
+    {
+        NOTICE("no SATA drives attached");
+        return FileSystem::NotFound;
+    }
+
+    // Interrupts are enabled per port by each drive
+    m_io.set(GlobalControl, ControlInterrupts);
+    return FileSystem::Success;
+}
+
+Arch::IO & AHCIController::getIO()
+{
+    return m_io;
+}
+
+Size AHCIController::getSlots() const
+{
+    return ((m_capabilities & CapSlotsMask) >> CapSlotsShift) + 1;
+}
+
+bool AHCIController::hasNativeQueuing() const
+{
+    return m_capabilities & CapNativeQueuing;
+}
+
+Size AHCIController::getInterrupt() const
+{
+    return m_irq;
+}
+
+void AHCIController::acknowledge(const Size port)
+{
+    m_io.write(InterruptStatus, 1U << port);
+}
+
+u32 AHCIController::readPCI(const uint bus, const uint slot, const uint func, const uint reg)
+{
+    m_pci.outl(PciConfigAddress, (1U << 31) | (bus << 16) | (slot << 11) | (func << 8) | (reg & 0xfc));
+    return m_pci.inl(PciConfigData);
+}
+
+void AHCIController::writePCI(const uint bus, const uint slot, const uint func,
+                              const uint reg, const u32 value)
+{
+    m_pci.outl(PciConfigAddress, (1U << 31) | (bus << 16) | (slot << 11) | (func << 8) | (reg & 0xfc));
+    m_pci.outl(PciConfigData, value);
+}
+
+FileSystem::Result AHCIController::detect()
+{
+    // Search the PCI bus for an AHCI controller
+    for (uint bus = 0; bus < 256; bus++)
+    {
+        for (uint slot = 0; slot < 32; slot++)
+        {
+            for (uint func = 0; func < 8; func++)
+            {
+                const u32 id = readPCI(bus, slot, func, PciIdentifier);
+
+                if ((id & 0xffff) == 0xffff || (readPCI(bus, slot, func, PciClass) >> 8) != PciClassAHCI)
+                {
+                    continue;
+                }
+
+                // The registers are memory mapped by BAR5
+                const u32 bar = readPCI(bus, slot, func, PciBar5);
+                if (bar & 1)
+                {
+                    ERROR("BAR5 is not a memory range: bar = " << (void *) bar);
+                    return FileSystem::NotFound;
+                }
+
+                const u32 cmd = readPCI(bus, slot, func, PciCommand);
+                writePCI(bus, slot, func, PciCommand,
+                        (cmd | PciCommandMemory | PciCommandMaster) & ~PciCommandIntDisable);
+
+                m_irq = readPCI(bus, slot, func, PciInterrupt) & 0xff;
+
+                const IO::Result mapResult = m_io.map(bar & ~0xfU, RegisterSpaceSize,
+                                                      Memory::User | Memory::Readable |
+                                                      Memory::Writable | Memory::Device);
+                if (mapResult != IO::Success)
+                {
+                    ERROR("failed to map hardware registers: result = " << (int) mapResult);
+                    return FileSystem::IOError;
+                }
+
+                NOTICE("found device " << (void *) (id >> 16) << " at " << bus << ":" << slot <<
+                       "." << func << " abar = " << (void *) (bar & ~0xfU) << " irq = " << m_irq);
+                return FileSystem::Success;
+            }
+        }
+    }
+
+    ERROR("no AHCI controller found");
+    return FileSystem::NotFound;
+}
+
+FileSystem::Result AHCIController::reset()
+{
+    DEBUG("");
+
+    // Switch to AHCI mode and reset the controller
+    m_io.set(GlobalControl, ControlAHCIEnable);
+    m_io.set(GlobalControl, ControlReset);
+
+    for (Size i = 0; i < MaximumResetPoll && (m_io.read(GlobalControl) & ControlReset); i++)
+        ;
+
+    if (m_io.read(GlobalControl) & ControlReset)
+    {
+        ERROR("reset timed out");
+        return FileSystem::IOError;
+    }
+
+    // The reset clears AHCI mode
+    m_io.set(GlobalControl, ControlAHCIEnable);
+    m_io.write(InterruptStatus, 0xffffffff);
+    m_capabilities = m_io.read(Capabilities);
+
+    NOTICE("version " << (void *) m_io.read(Version) << " slots = " << getSlots() <<
+           " ncq = " << (hasNativeQueuing() ? "yes" : "no"));
+    return FileSystem::Success;
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVER_AHCI_AHCICONTROLLER_H
+#define __SERVER_AHCI_AHCICONTROLLER_H
+
+#include <FreeNOS/System.h>
+#include <Types.h>
+#include <DeviceServer.h>
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup ahci
+ * @{
+ */
+
+/**
+ * Advanced Host Controller Interface (AHCI) SATA host bus adapter.
+ *
+ * Finds the controller on the PCI bus, maps its registers and registers
+ * an AHCIDrive device for each port which has a SATA drive attached.
+ */
+class AHCIController
+{
+  public:
+
+    /** Offset of the registers of the first port */
+    static const Size PortBase = 0x100;
+
+    /** Size of the registers of a single port */
+    static const Size PortSize = 0x80;
+
+  private:
+
+    /** Maximum number of ports */
+    static const Size MaximumPorts = 32;
+
+    /** Size of the memory mapped register space, including all ports */
+    static const Size RegisterSpaceSize = 0x2000;
+
+    /** Maximum number of polling reset iterations */
+    static const Size MaximumResetPoll = 1000000;
+
+    /** PCI class, subclass and programming interface of AHCI controllers */
+    static const u32 PciClassAHCI = 0x010601;
+
+    /**
+     * PCI configuration space
+     */
+    enum PciRegisters
+    {
+        PciConfigAddress = 0xcf8, /**@< Configuration address I/O port */
+        PciConfigData    = 0xcfc, /**@< Configuration data I/O port */
+        PciIdentifier    = 0x00,  /**@< Vendor and device identifier */
+        PciCommand       = 0x04,  /**@< Command register */
+        PciClass         = 0x08,  /**@< Class code and revision */
+        PciBar5          = 0x24,  /**@< Base address register 5 (ABAR) */
+        PciInterrupt     = 0x3c   /**@< Interrupt line */
+    };
+
+    /**
+     * PCI command register flags
+     */
+    enum PciCommandFlags
+    {
+        PciCommandMemory     = (1 << 1),
+        PciCommandMaster     = (1 << 2),
+        PciCommandIntDisable = (1 << 10)
+    };
+
+    /**
+     * Generic host control registers
+     */
+    enum Registers
+    {
+        Capabilities     = 0x00, /**@< Host Capabilities */
+        GlobalControl    = 0x04, /**@< Global Host Control */
+        InterruptStatus  = 0x08, /**@< Interrupt Status, one bit per port */
+        PortsImplemented = 0x0c, /**@< Ports Implemented */
+        Version          = 0x10  /**@< AHCI Version */
+    };
+
+    /**
+     * Generic host control register flags
+     */
+    enum RegisterFlags
+    {
+        CapSlotsShift       = 8,
+        CapSlotsMask        = (0x1f << 8),
+        CapNativeQueuing    = (1 << 30),
+        ControlReset        = (1 << 0),
+        ControlInterrupts   = (1 << 1),
+        ControlAHCIEnable   = (1U << 31)
+    };
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param server DeviceServer which serves the drives
+     */
+    AHCIController(DeviceServer &server);
+
+    /**
+     * Find and reset the controller and register its drives.
+     *
+     * @return Result code
+     */
+    FileSystem::Result initialize();
+
+    /**
+     * Get the memory mapped registers.
+     *
+     * @return IO object with all registers mapped
+     */
+    Arch::IO & getIO();
+
+    /**
+     * Get the number of command slots per port.
+     *
+     * @return Number of command slots
+     */
+    Size getSlots() const;
+
+    /**
+     * Check for native command queuing support.
+     *
+     * @return True if the controller supports NCQ
+     */
+    bool hasNativeQueuing() const;
+
+    /**
+     * Get the interrupt vector.
+     *
+     * @return Interrupt vector of the controller
+     */
+    Size getInterrupt() const;
+
+    /**
+     * Acknowledge the interrupt of a port.
+     *
+     * @param port Port number
+     */
+    void acknowledge(const Size port);
+
+  private:
+
+    /**
+     * Read a 32-bit register from PCI configuration space.
+     *
+     * @param bus PCI bus number
+     * @param slot PCI slot number
+     * @param func PCI function number
+     * @param reg Register offset
+     *
+     * @return Register value
+     */
+    u32 readPCI(const uint bus, const uint slot, const uint func, const uint reg);
+
+    /**
+     * Write a 32-bit register in PCI configuration space.
+     *
+     * @param bus PCI bus number
+     * @param slot PCI slot number
+     * @param func PCI function number
+     * @param reg Register offset
+     * @param value Value to write
+     */
+    void writePCI(const uint bus, const uint slot, const uint func, const uint reg, const u32 value);
+
+    /**
+     * Find the controller on the PCI bus and map its registers.
+     *
+     * @return Result code
+     */
+    FileSystem::Result detect();
+
+    /**
+     * Reset the controller and enable AHCI mode.
+     *
+     * @return Result code
+     */
+    FileSystem::Result reset();
+
+  private:
+
+    /** Server to register the drives */
+    DeviceServer &m_server;
+
+    /** Configuration space I/O ports */
+    Arch::IO m_pci;
+
+    /** Memory mapped registers */
+    Arch::IO m_io;
+
+    /** Interrupt vector */
+    Size m_irq;
+
+    /** Host capabilities */
+    u32 m_capabilities;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_AHCI_AHCICONTROLLER_H */
@@ -0,0 +1,563 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Log.h>
+#include <MemoryBlock.h>
+#include "AHCIController.h"
+#include "AHCIDrive.h"
+
+bool AHCIDrive::isPresent(const Arch::IO & io, const Size port)
+{
+    const Address base = AHCIController::PortBase + (port * AHCIController::PortSize);
+
+    // The link comes up shortly after the controller reset
+    for (Size i = 0; i < MaximumLinkPoll; i++)
+    {
+        if ((io.read(base + SataStatus) & StatusDetectMask) == StatusDetectPresent)
+        {
+            // The signature is not known until the drive sent its first FIS
+            const u32 signature = io.read(base + Signature);
+            return signature == SignatureSATA || signature == SignatureNone;
+        }
+    }
+
+    return false;
+}
+
+AHCIDrive::AHCIDrive(const u32 inode,
+                     AHCIController &controller,
+                     const Size port,
+                     const char *name)
+    : Device(inode, FileSystem::BlockDeviceFile)
+    , m_controller(controller)
+    , m_port(port)
+    , m_base(AHCIController::PortBase + (port * AHCIController::PortSize))
+    , m_depth(1)
+    , m_queuing(false)
+    , m_sectors(0)
+    , m_list(ZERO)
+    , m_tables(ZERO)
+    , m_issued(0)
+    , m_completions(0)
+{
+    m_identifier << name;
+    MemoryBlock::set(&m_listRange, 0, sizeof(m_listRange));
+    MemoryBlock::set(&m_tableRange, 0, sizeof(m_tableRange));
+    MemoryBlock::set(m_slots, 0, sizeof(m_slots));
+}
+
+FileSystem::Result AHCIDrive::initialize()
+{
+    DEBUG("port = " << m_port);
+
+    // The port must be idle while its memory is changed
+    FileSystem::Result result = stop();
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to stop port " << m_port << ": result = " << (int) result);
+        return result;
+    }
+
+    result = allocate();
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+
+    // The received FIS area follows the command list
+    writePort(CommandListLow, m_listRange.phys);
+    writePort(CommandListHigh, 0);
+    writePort(FisBaseLow, m_listRange.phys + (sizeof(CommandHeader) * MaximumSlots));
+    writePort(FisBaseHigh, 0);
+    writePort(SataError, 0xffffffff);
+    writePort(InterruptStatus, 0xffffffff);
+    m_controller.getIO().set(m_base + Command, CommandSpinUp | CommandPowerOn);
+
+    result = start();
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to start port " << m_port << ": result = " << (int) result);
+        return result;
+    }
+
+    result = identify();
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to identify drive on port " << m_port << ": result = " << (int) result);
+        return result;
+    }
+
+    result = allocateBuffers();
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+
+    // Commands complete with a register FIS, or a set device bits FIS with NCQ
+    writePort(InterruptStatus, 0xffffffff);
+    writePort(InterruptEnable, IntDeviceToHost | IntSetDeviceBits | IntErrors);
+    return FileSystem::Success;
+}
+
+FileSystem::Result AHCIDrive::read(IOBuffer & buffer,
+                                   Size & size,
+                                   const Size offset)
+{
+    const u64 driveSize = m_sectors * SectorSize;
+
+    if (offset / SectorSize >= m_sectors)
+    {
+        return FileSystem::IOError;
+    }
+
+    // Do not read beyond the end of the drive
+    if (offset + (u64) size > driveSize)
+    {
+        size = driveSize - offset;
+    }
+
+    // A single command transfers at most one slot buffer
+    if ((offset % SectorSize) + size > SlotBufferSize)
+    {
+        size = SlotBufferSize - (offset % SectorSize);
+    }
+
+    return transfer(buffer, size, offset, false);
+}
+
+FileSystem::Result AHCIDrive::write(IOBuffer & buffer,
+                                    Size & size,
+                                    const Size offset)
+{
+    const u64 driveSize = m_sectors * SectorSize;
+
+    // Partial sectors would need a read-modify-write cycle
+    if (offset % SectorSize || size % SectorSize || !size)
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    if (offset / SectorSize >= m_sectors)
+    {
+        return FileSystem::IOError;
+    }
+
+    // Do not write beyond the end of the drive
+    if (offset + (u64) size > driveSize)
+    {
+        size = driveSize - offset;
+    }
+
+    if (size > SlotBufferSize)
+    {
+        size = SlotBufferSize;
+    }
+
+    return transfer(buffer, size, offset, true);
+}
+
+FileSystem::Result AHCIDrive::interrupt(const Size vector)
+{
+    const u32 status = readPort(InterruptStatus);
+
+    DEBUG("vector = " << vector << " status = " << (void *) status);
+
+    // Clear the port interrupt before the controller interrupt
+    writePort(InterruptStatus, status);
+    m_controller.acknowledge(m_port);
+
+    if (status & IntErrors)
+    {
+        ERROR("port " << m_port << " error: status = " << (void *) status <<
+              " taskfile = " << (void *) readPort(TaskFileData) <<
+              " serror = " << (void *) readPort(SataError));
+        recover();
+    }
+    else
+    {
+        // Commands are done once the controller and drive both cleared their bit
+        complete(m_issued & ~(readPort(SataActive) | readPort(CommandIssue)), SlotDone);
+    }
+
+    // Re-enable the interrupt line on the interrupt controller
+    ProcessCtl(SELF, EnableIRQ, vector);
+    return FileSystem::Success;
+}
+
+u32 AHCIDrive::readPort(const Registers reg) const
+{
+    return m_controller.getIO().read(m_base + reg);
+}
+
+void AHCIDrive::writePort(const Registers reg, const u32 value)
+{
+    m_controller.getIO().write(m_base + reg, value);
+}
+
+FileSystem::Result AHCIDrive::stop()
+{
+    Arch::IO & io = m_controller.getIO();
+
+    io.unset(m_base + Command, CommandStart);
+
+    for (Size i = 0; i < MaximumPoll && (readPort(Command) & CommandListRunning); i++)
+        ;
+
+    io.unset(m_base + Command, CommandFisReceive);
+
+    for (Size i = 0; i < MaximumPoll && (readPort(Command) & CommandFisRunning); i++)
+        ;
+
+    if (readPort(Command) & (CommandListRunning | CommandFisRunning))
+    {
+        return FileSystem::IOError;
+    }
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result AHCIDrive::start()
+{
+    Arch::IO & io = m_controller.getIO();
+
+    io.set(m_base + Command, CommandFisReceive);
+
+    // Commands can only be started once the drive is ready
+    for (Size i = 0; i < MaximumPoll && (readPort(TaskFileData) & (TaskFileBusy | TaskFileDataRequest)); i++)
+        ;
+
+    if (readPort(TaskFileData) & (TaskFileBusy | TaskFileDataRequest))
+    {
+        return FileSystem::IOError;
+    }
+
+    io.set(m_base + Command, CommandStart);
+    return FileSystem::Success;
+}
+
+FileSystem::Result AHCIDrive::allocate()
+{
+    // Command list of 1KiB followed by the received FIS area of 256 bytes
+    m_listRange.size = PAGESIZE;
+    m_listRange.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    API::Result vmResult = VMCtl(SELF, MapContiguous, &m_listRange);
+    if (vmResult != API::Success)
+    {
+        ERROR("failed to allocate command list: result = " << (int) vmResult);
+        return FileSystem::IOError;
+    }
+
+    m_tableRange.size = sizeof(CommandTable) * MaximumSlots;
+    m_tableRange.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    vmResult = VMCtl(SELF, MapContiguous, &m_tableRange);
+    if (vmResult != API::Success)
+    {
+        ERROR("failed to allocate command tables: result = " << (int) vmResult);
+        return FileSystem::IOError;
+    }
+
+    MemoryBlock::set((void *) m_listRange.virt, 0, m_listRange.size);
+    MemoryBlock::set((void *) m_tableRange.virt, 0, m_tableRange.size);
+
+    m_list = (volatile CommandHeader *) m_listRange.virt;
+    m_tables = (volatile CommandTable *) m_tableRange.virt;
+
+    for (Size i = 0; i < MaximumSlots; i++)
+    {
+        m_list[i].tableLow = m_tableRange.phys + (i * sizeof(CommandTable));
+        m_list[i].tableHigh = 0;
+    }
+
+    return allocateBuffers();
+}
+
+FileSystem::Result AHCIDrive::allocateBuffers()
+{
+    for (Size i = 0; i < m_depth; i++)
+    {
+        Memory::Range & range = m_slots[i].buffer;
+
+        if (range.virt != 0)
+        {
+            continue;
+        }
+
+        range.size = SlotBufferSize;
+        range.access = Memory::User | Memory::Readable | Memory::Writable;
+
+        const API::Result vmResult = VMCtl(SELF, MapContiguous, &range);
+        if (vmResult != API::Success)
+        {
+            ERROR("failed to allocate buffer for slot " << i << ": result = " << (int) vmResult);
+            range.virt = 0;
+            return FileSystem::IOError;
+        }
+    }
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result AHCIDrive::identify()
+{
+    char model[41];
+
+    prepare(0, CommandIdentify, 0, 1, false);
+    writePort(CommandIssue, 1);
+
+    for (Size i = 0; i < MaximumPoll && (readPort(CommandIssue) & 1) &&
+                     !(readPort(InterruptStatus) & IntErrors); i++)
+        ;
+
+    if ((readPort(CommandIssue) & 1) || (readPort(TaskFileData) & TaskFileError))
+    {
+        return FileSystem::IOError;
+    }
+
+    const u16 *words = (const u16 *) m_slots[0].buffer.virt;
+
+    if (!(words[IdentifyCommandSet] & IdentifyLBA48))
+    {
+        ERROR("48-bit addressing not supported");
+        return FileSystem::NotSupported;
+    }
+
+    m_sectors = (u64) words[IdentifySectors48] |
+               ((u64) words[IdentifySectors48 + 1] << 16) |
+               ((u64) words[IdentifySectors48 + 2] << 32) |
+               ((u64) words[IdentifySectors48 + 3] << 48);
+
+    // Text is stored as big endian words
+    for (Size i = 0; i < sizeof(model) - 1; i += 2)
+    {
+        model[i]     = words[IdentifyModel + (i / 2)] >> 8;
+        model[i + 1] = words[IdentifyModel + (i / 2)] & 0xff;
+    }
+    model[sizeof(model) - 1] = 0;
+
+    // Queue as many commands as both the controller and the drive support
+    m_queuing = m_controller.hasNativeQueuing() && (words[IdentifySataCaps] & IdentifyNativeQueuing);
+
+    if (m_queuing)
+    {
+        const Size driveDepth = (words[IdentifyQueueDepth] & 0x1f) + 1;
+        const Size slots = m_controller.getSlots();
+
+        m_depth = driveDepth < slots ? driveDepth : slots;
+    }
+
+    NOTICE(*m_identifier << ": MODEL=" << model << " SECTORS=" << (Size) m_sectors <<
+           " NCQ=" << (m_queuing ? "yes" : "no") << " DEPTH=" << m_depth);
+    return FileSystem::Success;
+}
+
+void AHCIDrive::prepare(const Size index,
+                        const u8 command,
+                        const u64 lba,
+                        const Size sectors,
+                        const bool write)
+{
+    volatile CommandHeader *header = &m_list[index];
+    volatile CommandTable *table = &m_tables[index];
+    RegisterFis *fis = (RegisterFis *) table->fis;
+    const Size bytes = sectors * SectorSize;
+    const Size regions = CEIL(bytes, PAGESIZE);
+
+    MemoryBlock::set(fis, 0, sizeof(RegisterFis));
+    fis->type    = FisTypeHostToDevice;
+    fis->flags   = FisCommand;
+    fis->command = command;
+    fis->device  = FisDeviceLBA;
+    fis->lba0    = (lba) & 0xff;
+    fis->lba1    = (lba >> 8) & 0xff;
+    fis->lba2    = (lba >> 16) & 0xff;
+    fis->lba3    = (lba >> 24) & 0xff;
+    fis->lba4    = (lba >> 32) & 0xff;
+    fis->lba5    = (lba >> 40) & 0xff;
+
+    // Queued commands pass the sector count in the features and the tag in the count
+    if (command == CommandReadQueued || command == CommandWriteQueued)
+    {
+        fis->featureLow  = sectors & 0xff;
+        fis->featureHigh = (sectors >> 8) & 0xff;
+        fis->countLow    = index << 3;
+
+        if (write)
+            fis->device |= FisDeviceForceUnit;
+    }
+    else
+    {
+        fis->countLow  = sectors & 0xff;
+        fis->countHigh = (sectors >> 8) & 0xff;
+    }
+
+    // Scatter the transfer over the pages of the slot buffer
+    for (Size i = 0; i < regions; i++)
+    {
+        const Size chunk = bytes - (i * PAGESIZE) < PAGESIZE ? bytes - (i * PAGESIZE) : PAGESIZE;
+
+        table->regions[i].addressLow  = m_slots[index].buffer.phys + (i * PAGESIZE);
+        table->regions[i].addressHigh = 0;
+        table->regions[i].reserved    = 0;
+        table->regions[i].count       = chunk - 1;
+    }
+
+    header->flags       = HeaderFisLength | (write ? HeaderWrite : 0);
+    header->regions     = regions;
+    header->transferred = 0;
+}
+
+FileSystem::Result AHCIDrive::transfer(IOBuffer & buffer,
+                                       Size & size,
+                                       const Size offset,
+                                       const bool write)
+{
+    const ProcessID pid = buffer.getMessage()->from;
+    Size index;
+
+    // Find the slot of an earlier attempt of this request
+    for (index = 0; index < m_depth; index++)
+    {
+        const Slot *s = &m_slots[index];
+
+        if (s->state != SlotFree && s->pid == pid && s->offset == offset &&
+            s->size == size && s->write == write)
+        {
+            break;
+        }
+    }
+
+    // Start a new command
+    if (index == m_depth)
+    {
+        index = allocateSlot();
+        if (index == MaximumSlots)
+        {
+            return FileSystem::RetryAgain;
+        }
+
+        Slot *slot = &m_slots[index];
+        slot->pid    = pid;
+        slot->offset = offset;
+        slot->size   = size;
+        slot->write  = write;
+
+        if (write && buffer.read((void *) slot->buffer.virt, size) != FileSystem::Success)
+        {
+            slot->state = SlotFree;
+            return FileSystem::IOError;
+        }
+
+        const u8 command = m_queuing ? (write ? CommandWriteQueued : CommandReadQueued) :
+                                       (write ? CommandWriteForced : CommandReadDMA);
+
+        prepare(index, command, offset / SectorSize,
+                CEIL((offset % SectorSize) + size, SectorSize), write);
+        issue(index);
+        return FileSystem::RetryAgain;
+    }
+
+    Slot *slot = &m_slots[index];
+
+    if (slot->state == SlotBusy)
+    {
+        return FileSystem::RetryAgain;
+    }
+
+    const bool failed = slot->state == SlotFailed;
+    slot->state = SlotFree;
+
+    if (failed)
+    {
+        ERROR("failed to " << (write ? "write" : "read") << " " << size <<
+              " bytes at offset " << offset);
+        return FileSystem::IOError;
+    }
+
+    // Copy the sectors from the slot buffer to the requesting process
+    if (!write)
+    {
+        return buffer.write(((u8 *) slot->buffer.virt) + (offset % SectorSize), size);
+    }
+
+    return FileSystem::Success;
+}
+
+Size AHCIDrive::allocateSlot()
+{
+    Size oldest = MaximumSlots;
+
+    for (Size i = 0; i < m_depth; i++)
+    {
+        const Slot *s = &m_slots[i];
+
+        if (s->state == SlotFree)
+        {
+            return i;
+        }
+        else if (s->state != SlotBusy &&
+                (oldest == MaximumSlots || s->completion < m_slots[oldest].completion))
+        {
+            oldest = i;
+        }
+    }
+
+    return oldest;
+}
+
+void AHCIDrive::issue(const Size index)
+{
+    m_slots[index].state = SlotBusy;
+    m_issued |= (1U << index);
+
+    if (m_queuing)
+    {
+        writePort(SataActive, 1U << index);
+    }
+
+    writePort(CommandIssue, 1U << index);
+}
+
+void AHCIDrive::complete(const u32 done, const SlotState state)
+{
+    for (Size i = 0; i < m_depth; i++)
+    {
+        if (done & (1U << i))
+        {
+            m_slots[i].state = state;
+            m_slots[i].completion = m_completions++;
+        }
+    }
+
+    m_issued &= ~done;
+}
+
+void AHCIDrive::recover()
+{
+    // All outstanding commands are aborted by the error
+    complete(m_issued, SlotFailed);
+
+    stop();
+    writePort(SataError, 0xffffffff);
+    writePort(InterruptStatus, 0xffffffff);
+
+    if (start() != FileSystem::Success)
+    {
+        ERROR("failed to restart port " << m_port);
+    }
+}
@@ -0,0 +1,498 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVER_AHCI_AHCIDRIVE_H
+#define __SERVER_AHCI_AHCIDRIVE_H
+
+#include <FreeNOS/System.h>
+#include <Types.h>
+#include <Device.h>
+#include <Memory.h>
+
+class AHCIController;
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup ahci
+ * @{
+ */
+
+/**
+ * SATA drive attached to a port of an AHCI controller.
+ *
+ * Every command slot of the port has its own command table and DMA buffer.
+ * Requests are matched to slots by requesting process, offset and size, such
+ * that requests of different processes are queued to the drive at the same
+ * time. With native command queuing (NCQ) the drive may complete them in any
+ * order. The physical region table of each command scatters the transfer over
+ * the pages of the slot buffer, and completed reads are copied from there to
+ * the requesting process in a single copy.
+ */
+class AHCIDrive : public Device
+{
+  private:
+
+    /** Size of a sector in bytes */
+    static const Size SectorSize = 512;
+
+    /** Maximum number of command slots */
+    static const Size MaximumSlots = 32;
+
+    /** Size of the DMA buffer of each command slot */
+    static const Size SlotBufferSize = PAGESIZE * 16;
+
+    /** Number of physical region entries per command table, one per page */
+    static const Size RegionCount = SlotBufferSize / PAGESIZE;
+
+    /** Maximum number of polling iterations while waiting for the port */
+    static const Size MaximumPoll = 1000000;
+
+    /** Maximum number of polling iterations while waiting for the link */
+    static const Size MaximumLinkPoll = 10000;
+
+    /**
+     * Port registers, relative to the start of the port
+     */
+    enum Registers
+    {
+        CommandListLow    = 0x00, /**@< Command List Base Address */
+        CommandListHigh   = 0x04, /**@< Command List Base Address Upper 32-bits */
+        FisBaseLow        = 0x08, /**@< FIS Base Address */
+        FisBaseHigh       = 0x0c, /**@< FIS Base Address Upper 32-bits */
+        InterruptStatus   = 0x10, /**@< Interrupt Status */
+        InterruptEnable   = 0x14, /**@< Interrupt Enable */
+        Command           = 0x18, /**@< Command and Status */
+        TaskFileData      = 0x20, /**@< Task File Data */
+        Signature         = 0x24, /**@< Signature of the attached device */
+        SataStatus        = 0x28, /**@< Serial ATA Status */
+        SataControl       = 0x2c, /**@< Serial ATA Control */
+        SataError         = 0x30, /**@< Serial ATA Error */
+        SataActive        = 0x34, /**@< Serial ATA Active, one bit per queued command */
+        CommandIssue      = 0x38  /**@< Command Issue, one bit per command slot */
+    };
+
+    /**
+     * Port register flags
+     */
+    enum RegisterFlags
+    {
+        CommandStart        = (1 << 0),
+        CommandSpinUp       = (1 << 1),
+        CommandPowerOn      = (1 << 2),
+        CommandFisReceive   = (1 << 4),
+        CommandFisRunning   = (1 << 14),
+        CommandListRunning  = (1 << 15),
+        IntDeviceToHost     = (1 << 0),
+        IntPioSetup         = (1 << 1),
+        IntDmaSetup         = (1 << 2),
+        IntSetDeviceBits    = (1 << 3),
+        IntInterfaceFatal   = (1 << 27),
+        IntHostBusData      = (1 << 28),
+        IntHostBusFatal     = (1 << 29),
+        IntTaskFileError    = (1 << 30),
+        IntErrors           = (IntInterfaceFatal | IntHostBusData | IntHostBusFatal | IntTaskFileError),
+        TaskFileError       = (1 << 0),
+        TaskFileDataRequest = (1 << 3),
+        TaskFileBusy        = (1 << 7),
+        StatusDetectMask    = 0xf,
+        StatusDetectPresent = 3
+    };
+
+    /**
+     * Device signatures
+     */
+    enum Signatures
+    {
+        SignatureSATA       = 0x00000101,
+        SignatureNone       = 0xffffffff
+    };
+
+    /**
+     * ATA commands
+     */
+    enum Commands
+    {
+        CommandIdentify     = 0xec,
+        CommandReadDMA      = 0x25,
+        CommandWriteForced  = 0x3d,
+        CommandReadQueued   = 0x60,
+        CommandWriteQueued  = 0x61
+    };
+
+    /**
+     * Words of the IDENTIFY DEVICE data
+     */
+    enum IdentifyWords
+    {
+        IdentifyModel       = 27,
+        IdentifySectors28   = 60,
+        IdentifyQueueDepth  = 75,
+        IdentifySataCaps    = 76,
+        IdentifyCommandSet  = 83,
+        IdentifySectors48   = 100,
+        IdentifyWordCount   = 256
+    };
+
+    /**
+     * IDENTIFY DEVICE data flags
+     */
+    enum IdentifyFlags
+    {
+        IdentifyNativeQueuing = (1 << 8),
+        IdentifyLBA48         = (1 << 10)
+    };
+
+    /**
+     * Command header in the command list
+     */
+    typedef struct CommandHeader
+    {
+        u16 flags;          /**< Command FIS length in dwords and HeaderFlags */
+        u16 regions;        /**< Number of physical region entries */
+        u32 transferred;    /**< Number of bytes transferred, updated by the controller */
+        u32 tableLow;       /**< Physical address of the command table */
+        u32 tableHigh;      /**< Upper 32-bits of the command table address */
+        u32 reserved[4];
+    }
+    CommandHeader;
+
+    /**
+     * Command header flags
+     */
+    enum HeaderFlags
+    {
+        HeaderFisLength  = 5,       /**< Length of a RegisterFis in dwords */
+        HeaderWrite      = (1 << 6),
+        HeaderClearBusy  = (1 << 10)
+    };
+
+    /**
+     * Physical region entry of a command table
+     */
+    typedef struct PhysicalRegion
+    {
+        u32 addressLow;     /**< Physical address of the data */
+        u32 addressHigh;    /**< Upper 32-bits of the data address */
+        u32 reserved;
+        u32 count;          /**< Number of bytes minus one and RegionInterrupt */
+    }
+    PhysicalRegion;
+
+    /** Interrupt when the region is done */
+    static const u32 RegionInterrupt = (1U << 31);
+
+    /**
+     * Host to device register FIS
+     */
+    typedef struct RegisterFis
+    {
+        u8 type;
+        u8 flags;
+        u8 command;
+        u8 featureLow;
+        u8 lba0, lba1, lba2;
+        u8 device;
+        u8 lba3, lba4, lba5;
+        u8 featureHigh;
+        u8 countLow;
+        u8 countHigh;
+        u8 icc;
+        u8 control;
+        u8 reserved[4];
+    }
+    RegisterFis;
+
+    /**
+     * Register FIS values
+     */
+    enum FisValues
+    {
+        FisTypeHostToDevice = 0x27,
+        FisCommand          = 0x80,
+        FisDeviceLBA        = (1 << 6),
+        FisDeviceForceUnit  = (1 << 7)
+    };
+
+    /**
+     * Command table of a command slot
+     */
+    typedef struct CommandTable
+    {
+        u8 fis[64];                             /**< Command FIS */
+        u8 atapi[16];                           /**< ATAPI command, unused */
+        u8 reserved[48];
+        PhysicalRegion regions[RegionCount];    /**< Physical region table */
+    }
+    CommandTable;
+
+    /**
+     * State of a command slot
+     */
+    enum SlotState
+    {
+        SlotFree,
+        SlotBusy,
+        SlotDone,
+        SlotFailed
+    };
+
+    /**
+     * Command slot
+     */
+    typedef struct Slot
+    {
+        SlotState state;        /**< Current state */
+        bool write;             /**< True for writes */
+        ProcessID pid;          /**< Process which requested the transfer */
+        Size offset;            /**< Byte offset of the request */
+        Size size;              /**< Number of bytes of the request */
+        Size completion;        /**< Completion number, for reclaiming the oldest */
+        Memory::Range buffer;   /**< DMA buffer */
+    }
+    Slot;
+
+  public:
+
+    /**
+     * Check if a SATA drive is attached to a port.
+     *
+     * @param io Memory mapped controller registers
+     * @param port Port number
+     *
+     * @return True if a SATA drive is attached and the link is up
+     */
+    static bool isPresent(const Arch::IO & io, const Size port);
+
+    /**
+     * Constructor
+     *
+     * @param inode Inode number
+     * @param controller Controller of the drive
+     * @param port Port number of the drive
+     * @param name Device name
+     */
+    AHCIDrive(const u32 inode,
+              AHCIController &controller,
+              const Size port,
+              const char *name);
+
+    /**
+     * Initialize the port and identify the drive.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result initialize();
+
+    /**
+     * Read bytes from the drive.
+     *
+     * @param buffer Output buffer.
+     * @param size Maximum number of bytes to read on input. On output, the actual number of bytes read.
+     * @param offset Offset inside the drive to start reading.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result read(IOBuffer & buffer,
+                                    Size & size,
+                                    const Size offset);
+
+    /**
+     * Write whole sectors to the drive.
+     *
+     * @param buffer Input buffer.
+     * @param size Number of bytes to write on input. On output, the actual number of bytes written.
+     * @param offset Offset inside the drive to start writing.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result write(IOBuffer & buffer,
+                                     Size & size,
+                                     const Size offset);
+
+    /**
+     * Process completed commands.
+     *
+     * @param vector Interrupt vector.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result interrupt(const Size vector);
+
+  private:
+
+    /**
+     * Read a port register.
+     *
+     * @param reg Register offset
+     *
+     * @return Register value
+     */
+    u32 readPort(const Registers reg) const;
+
+    /**
+     * Write a port register.
+     *
+     * @param reg Register offset
+     * @param value Value to write
+     */
+    void writePort(const Registers reg, const u32 value);
+
+    /**
+     * Stop processing of the command list and received FISes.
+     *
+     * @return Result code
+     */
+    FileSystem::Result stop();
+
+    /**
+     * Start processing of the command list and received FISes.
+     *
+     * @return Result code
+     */
+    FileSystem::Result start();
+
+    /**
+     * Allocate the command list, received FIS area and command tables.
+     *
+     * @return Result code
+     */
+    FileSystem::Result allocate();
+
+    /**
+     * Allocate the DMA buffers of all usable command slots.
+     *
+     * @return Result code
+     */
+    FileSystem::Result allocateBuffers();
+
+    /**
+     * Read the IDENTIFY DEVICE data by polling.
+     *
+     * @return Result code
+     */
+    FileSystem::Result identify();
+
+    /**
+     * Fill the command table of a slot.
+     *
+     * @param index Slot number
+     * @param command ATA command
+     * @param lba First sector
+     * @param sectors Number of sectors
+     * @param write True if the command writes to the drive
+     */
+    void prepare(const Size index,
+                 const u8 command,
+                 const u64 lba,
+                 const Size sectors,
+                 const bool write);
+
+    /**
+     * Read or write through a command slot.
+     *
+     * @param buffer I/O buffer of the request
+     * @param size Number of bytes of the request
+     * @param offset Byte offset of the request
+     * @param write True for writes
+     *
+     * @return Result code
+     */
+    FileSystem::Result transfer(IOBuffer & buffer,
+                                Size & size,
+                                const Size offset,
+                                const bool write);
+
+    /**
+     * Find a free command slot.
+     *
+     * Reclaims the oldest completed slot if none is free, which
+     * releases results of requests that are no longer pending.
+     *
+     * @return Slot number or MaximumSlots if all slots are busy
+     */
+    Size allocateSlot();
+
+    /**
+     * Issue the command of a slot.
+     *
+     * @param index Slot number
+     */
+    void issue(const Size index);
+
+    /**
+     * Mark completed commands.
+     *
+     * @param done Slots which completed
+     * @param state SlotDone or SlotFailed
+     */
+    void complete(const u32 done, const SlotState state);
+
+    /**
+     * Recover the port after an error.
+     */
+    void recover();
+
+  private:
+
+    /** Controller of the drive */
+    AHCIController &m_controller;
+
+    /** Port number */
+    const Size m_port;
+
+    /** Offset of the port registers */
+    const Address m_base;
+
+    /** Number of usable command slots */
+    Size m_depth;
+
+    /** True if commands are queued with NCQ */
+    bool m_queuing;
+
+    /** Number of sectors */
+    u64 m_sectors;
+
+    /** Command list and received FIS area */
+    Memory::Range m_listRange;
+
+    /** Command tables */
+    Memory::Range m_tableRange;
+
+    /** Command list */
+    volatile CommandHeader *m_list;
+
+    /** Command table of each slot */
+    volatile CommandTable *m_tables;
+
+    /** Command slots */
+    Slot m_slots[MaximumSlots];
+
+    /** Slots which are issued to the controller */
+    u32 m_issued;
+
+    /** Number of completed commands */
+    Size m_completions;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_AHCI_AHCIDRIVE_H */
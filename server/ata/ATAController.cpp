@@ -24,7 +24,9 @@ int main(int argc, char **argv)
 {
     KernelLog log;
     DeviceServer server("/dev/ata");
-    server.registerDevice(new ATAController(server.getNextInode()), "ata0");
+    ATAController *ata = new ATAController(server.getNextInode());
+    server.registerDevice(ata, "ata0");
+    server.registerInterrupt(ata, ATA_IRQ0);
 
     // Initialize
     const FileSystem::Result result = server.initialize();
@@ -40,6 +42,13 @@ int main(int argc, char **argv)
 
 ATAController::ATAController(const u32 inode)
     : Device(inode, FileSystem::BlockDeviceFile)
+    , m_busMaster(ZERO)
+    , m_dmaState(DMAIdle)
+    , m_dmaPid(ZERO)
+    , m_dmaOffset(ZERO)
+    , m_dmaSize(ZERO)
+    , m_dmaProgress(ZERO)
+    , m_dmaSectors(ZERO)
 {
     m_identifier << "ata0";
 }
@@ -75,26 +84,150 @@ FileSystem::Result ATAController::initialize()
         drives.append(drive);
 
         // Read IDENTIFY data
-        for (int i = 0; i < 256; i++)
-        {
-            ((u16 *) &drive->identity)[i] = m_io.inw(ATA_BASE_CMD0 + ATA_REG_DATA);
-        }
+        m_io.insw(ATA_BASE_CMD0 + ATA_REG_DATA, &drive->identity, 256);
 
         // Fixup ASCII bytes
         IDENTIFY_TEXT_SWAP(drive->identity.firmware, 8);
         IDENTIFY_TEXT_SWAP(drive->identity.serial, 20);
         IDENTIFY_TEXT_SWAP(drive->identity.model, 40);
 
+        // Determine drive capabilities
+        drive->lba48 = drive->identity.supported[1] & IDENTIFY_CMD_LBA48;
+        drive->dma   = drive->identity.capabilities[0] & IDENTIFY_CAP_DMA;
+
+        if (drive->lba48 && drive->identity.sectors48 > drive->identity.sectors28)
+        {
+            drive->sectors = drive->identity.sectors48 > (u64) (~0U) ?
+                             (~0U) : (Size) drive->identity.sectors48;
+        }
+        else
+        {
+            drive->sectors = drive->identity.sectors28;
+        }
+
         // Print out information
         NOTICE("ATA drive detected: SERIAL=" << drive->identity.serial <<
                " FIRMWARE=" << drive->identity.firmware <<
                " MODEL=" << drive->identity.model <<
                " MAJOR=" << drive->identity.majorRevision <<
                " MINOR=" << drive->identity.minorRevision <<
-               " SECTORS=" << drive->identity.sectors28);
+               " SECTORS=" << drive->sectors <<
+               " LBA48=" << (drive->lba48 ? "yes" : "no") <<
+               " DMA=" << (drive->dma ? "yes" : "no"));
         break;
     }
 
+    // Use bus master DMA if possible, otherwise fallback to PIO
+    if (!drives.isEmpty() && drives.first()->dma)
+    {
+        const FileSystem::Result result = initializeDMA();
+        if (result != FileSystem::Success)
+        {
+            NOTICE("bus master DMA not available: result = " << (int) result);
+        }
+    }
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result ATAController::initializeDMA()
+{
+    // Search the PCI bus for an IDE controller
+    for (uint bus = 0; bus < 256; bus++)
+    {
+        for (uint slot = 0; slot < 32; slot++)
+        {
+            for (uint func = 0; func < 8; func++)
+            {
+                if ((readPCI(bus, slot, func, PCI_REG_ID) & 0xffff) == 0xffff)
+                {
+                    continue;
+                }
+
+                const u32 classCode = readPCI(bus, slot, func, PCI_REG_CLASS);
+                const u8 progIf = (classCode >> 8) & 0xff;
+
+                if ((classCode >> 16) != PCI_CLASS_IDE)
+                {
+                    continue;
+                }
+
+                // The primary channel must use the legacy I/O ports
+                if (!(progIf & PCI_IDE_BUS_MASTER) || (progIf & PCI_IDE_PRIMARY_NATIVE))
+                {
+                    return FileSystem::NotSupported;
+                }
+
+                const u32 bar4 = readPCI(bus, slot, func, PCI_REG_BAR4);
+                if (!(bar4 & 1))
+                {
+                    return FileSystem::NotSupported;
+                }
+                m_busMaster = bar4 & 0xfffc;
+
+                // Enable bus mastering
+                const u32 cmd = readPCI(bus, slot, func, PCI_REG_COMMAND);
+                writePCI(bus, slot, func, PCI_REG_COMMAND,
+                         cmd | PCI_COMMAND_IO | PCI_COMMAND_MASTER);
+                break;
+            }
+
+            if (m_busMaster)
+                break;
+        }
+
+        if (m_busMaster)
+            break;
+    }
+
+    if (!m_busMaster)
+    {
+        return FileSystem::NotFound;
+    }
+
+    // Allocate the PRD table
+    m_prdRange.phys = 0;
+    m_prdRange.virt = 0;
+    m_prdRange.size = PAGESIZE;
+    m_prdRange.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    API::Result vmResult = VMCtl(SELF, MapContiguous, &m_prdRange);
+    if (vmResult != API::Success)
+    {
+        ERROR("failed to allocate PRD table: result = " << (int) vmResult);
+        m_busMaster = ZERO;
+        return FileSystem::IOError;
+    }
+
+    // Allocate physically contiguous transfer buffer
+    m_dmaRange.phys = 0;
+    m_dmaRange.virt = 0;
+    m_dmaRange.size = ATA_DMA_SIZE;
+    m_dmaRange.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    vmResult = VMCtl(SELF, MapContiguous, &m_dmaRange);
+    if (vmResult != API::Success)
+    {
+        ERROR("failed to allocate DMA buffer: result = " << (int) vmResult);
+        m_busMaster = ZERO;
+        return FileSystem::IOError;
+    }
+
+    // Fill the PRD table with one entry per page, such that
+    // no entry crosses a 64KiB boundary
+    ATAPhysicalRegion *prd = (ATAPhysicalRegion *) m_prdRange.virt;
+
+    for (Size i = 0; i < ATA_DMA_SIZE / PAGESIZE; i++)
+    {
+        prd[i].address = m_dmaRange.phys + (i * PAGESIZE);
+        prd[i].size    = PAGESIZE;
+        prd[i].flags   = (i == (ATA_DMA_SIZE / PAGESIZE) - 1) ? ATA_PRD_END : 0;
+    }
+
+    m_io.outl(m_busMaster + ATA_BM_PRDT, m_prdRange.phys);
+    m_io.outb(ATA_BASE_CTL0, 0);
+
+    NOTICE("bus master DMA at I/O base " << (void *) (Address) m_busMaster);
     return FileSystem::Success;
 }
 
@@ -102,25 +235,45 @@ FileSystem::Result ATAController::read(IOBuffer & buffer,
                                        Size & size,
                                        const Size offset)
 {
-    u8 sectors = CEIL(size, 512);
+    // Verify LBA
+    if (drives.isEmpty() || drives.first()->sectors <= offset / ATA_SECTOR_SIZE)
+    {
+        return FileSystem::IOError;
+    }
+
+    // Do not read beyond the end of the drive
+    const u64 driveSize = (u64) drives.first()->sectors * ATA_SECTOR_SIZE;
+    if (offset + (u64) size > driveSize)
+    {
+        size = driveSize - offset;
+    }
+
+    if (m_busMaster)
+        return readDMA(buffer, size, offset);
+    else
+        return readPIO(buffer, size, offset);
+}
+
+FileSystem::Result ATAController::readPIO(IOBuffer & buffer,
+                                          Size & size,
+                                          const Size offset)
+{
+    const u64 lba = offset / ATA_SECTOR_SIZE;
+    const Size limit = drives.first()->lba48 ? ATA_MAX_SECTORS_48 : ATA_MAX_SECTORS_28;
+    Size sectors = CEIL((offset % ATA_SECTOR_SIZE) + size, ATA_SECTOR_SIZE);
     u16 block[256];
-    u32 lba     = offset / 512;
     Size result = 0;
     Size off = offset;
 
-    // Verify LBA
-    if (drives.isEmpty() || drives.first()->identity.sectors28 < lba)
+    // Limit to the maximum sectors of a single command
+    if (sectors > limit)
     {
-        return FileSystem::IOError;
+        sectors = limit;
+        size = (sectors * ATA_SECTOR_SIZE) - (offset % ATA_SECTOR_SIZE);
     }
 
     // Perform ATA Read Command
-    m_io.outb(ATA_BASE_CMD0 + ATA_REG_SELECT, ATA_SEL_MASTER_28);
-    m_io.outb(ATA_BASE_CMD0 + ATA_REG_COUNT,  sectors);
-    m_io.outb(ATA_BASE_CMD0 + ATA_REG_ADDR0,  (lba) & 0xff);
-    m_io.outb(ATA_BASE_CMD0 + ATA_REG_ADDR1,  (lba >> 8) & 0xff);
-    m_io.outb(ATA_BASE_CMD0 + ATA_REG_ADDR2,  (lba >> 16) & 0xff);
-    m_io.outb(ATA_BASE_CMD0 + ATA_REG_CMD,    ATA_CMD_READ);
+    command(lba, sectors, false);
 
     // Read out all requested sectors
     while(result < size)
@@ -129,17 +282,14 @@ FileSystem::Result ATAController::read(IOBuffer & buffer,
         pollReady(true);
 
         // Read out bytes
-        for (int i = 0; i < 256; i++)
-        {
-            block[i] = m_io.inw(ATA_BASE_CMD0 + ATA_REG_DATA);
-        }
+        m_io.insw(ATA_BASE_CMD0 + ATA_REG_DATA, block, 256);
 
         // Calculate maximum bytes
-        Size bytes = (size - result) < 512 - (off % 512) ?
-                     (size - result) : 512 - (off % 512);
+        Size bytes = (size - result) < ATA_SECTOR_SIZE - (off % ATA_SECTOR_SIZE) ?
+                     (size - result) : ATA_SECTOR_SIZE - (off % ATA_SECTOR_SIZE);
 
         // Copy to buffer
-        buffer.bufferedWrite(((u8 *)block) + (off % 512), bytes);
+        buffer.bufferedWrite(((u8 *)block) + (off % ATA_SECTOR_SIZE), bytes);
 
         // Update state
         result += bytes;
@@ -150,12 +300,229 @@ FileSystem::Result ATAController::read(IOBuffer & buffer,
     return FileSystem::Success;
 }
 
+FileSystem::Result ATAController::readDMA(IOBuffer & buffer,
+                                          Size & size,
+                                          const Size offset)
+{
+    const ProcessID pid = buffer.getMessage()->from;
+    const bool current = m_dmaPid == pid && m_dmaOffset == offset && m_dmaSize == size;
+
+    // Wait until the ongoing transfer is finished
+    if (m_dmaState == DMABusy)
+    {
+        return FileSystem::RetryAgain;
+    }
+
+    // Start a new request. This also reclaims results of
+    // requests which are no longer pending, e.g. if the process terminated.
+    if (!current || m_dmaState == DMAIdle)
+    {
+        m_dmaPid      = pid;
+        m_dmaOffset   = offset;
+        m_dmaSize     = size;
+        m_dmaProgress = 0;
+        startDMA();
+        return FileSystem::RetryAgain;
+    }
+
+    if (m_dmaState == DMAFailed)
+    {
+        ERROR("DMA transfer failed at offset " << (m_dmaOffset + m_dmaProgress));
+        m_dmaState = DMAIdle;
+        m_dmaPid   = ZERO;
+        return FileSystem::IOError;
+    }
+
+    // Copy the transferred sectors to the I/O buffer
+    const Size position = m_dmaOffset + m_dmaProgress;
+    const Size skip = position % ATA_SECTOR_SIZE;
+    const Size available = (m_dmaSectors * ATA_SECTOR_SIZE) - skip;
+    const Size bytes = m_dmaSize - m_dmaProgress < available ?
+                       m_dmaSize - m_dmaProgress : available;
+
+    buffer.bufferedWrite(((u8 *) m_dmaRange.virt) + skip, bytes);
+    m_dmaProgress += bytes;
+
+    // Continue with the next part, if any
+    if (m_dmaProgress < m_dmaSize)
+    {
+        startDMA();
+        return FileSystem::RetryAgain;
+    }
+
+    m_dmaState = DMAIdle;
+    m_dmaPid   = ZERO;
+    size = m_dmaSize;
+    return FileSystem::Success;
+}
+
+void ATAController::startDMA()
+{
+    const Size position = m_dmaOffset + m_dmaProgress;
+    const Size remaining = m_dmaSize - m_dmaProgress;
+    Size sectors = CEIL((position % ATA_SECTOR_SIZE) + remaining, ATA_SECTOR_SIZE);
+
+    if (sectors > ATA_DMA_SIZE / ATA_SECTOR_SIZE)
+    {
+        sectors = ATA_DMA_SIZE / ATA_SECTOR_SIZE;
+    }
+    m_dmaSectors = sectors;
+    m_dmaState   = DMABusy;
+
+    // Prepare bus master: stop, clear status bits and set direction
+    m_io.outb(m_busMaster + ATA_BM_CMD, 0);
+    m_io.outb(m_busMaster + ATA_BM_STATUS, m_io.inb(m_busMaster + ATA_BM_STATUS) |
+                                           ATA_BM_STATUS_ERROR | ATA_BM_STATUS_IRQ);
+    m_io.outl(m_busMaster + ATA_BM_PRDT, m_prdRange.phys);
+    m_io.outb(m_busMaster + ATA_BM_CMD, ATA_BM_CMD_READ);
+
+    // Issue the read command and start the transfer
+    command(position / ATA_SECTOR_SIZE, sectors, true);
+    m_io.outb(m_busMaster + ATA_BM_CMD, ATA_BM_CMD_READ | ATA_BM_CMD_START);
+}
+
+FileSystem::Result ATAController::write(IOBuffer & buffer,
+                                        Size & size,
+                                        const Size offset)
+{
+    const Size limit = drives.isEmpty() || !drives.first()->lba48 ?
+                       ATA_MAX_SECTORS_28 : ATA_MAX_SECTORS_48;
+    const u64 lba = offset / ATA_SECTOR_SIZE;
+    const u16 *data = (const u16 *) buffer.getBuffer();
+    Size sectors = size / ATA_SECTOR_SIZE;
+
+    // Verify LBA
+    if (drives.isEmpty() || drives.first()->sectors <= lba)
+    {
+        return FileSystem::IOError;
+    }
+
+    // Partial sectors would need a read-modify-write cycle
+    if (offset % ATA_SECTOR_SIZE || size % ATA_SECTOR_SIZE || !sectors)
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    // The drive cannot accept commands during a DMA transfer
+    if (m_dmaState == DMABusy)
+    {
+        return FileSystem::RetryAgain;
+    }
+
+    // Do not write beyond the end of the drive
+    if (lba + sectors > drives.first()->sectors)
+    {
+        sectors = drives.first()->sectors - lba;
+    }
+
+    // Limit to the maximum sectors of a single command
+    if (sectors > limit)
+    {
+        sectors = limit;
+    }
+
+    // Perform ATA Write Command
+    command(lba, sectors, false, true);
+
+    // Write out all sectors, each after the drive requests data
+    for (Size i = 0; i < sectors; i++)
+    {
+        pollReady();
+        m_io.outsw(ATA_BASE_CMD0 + ATA_REG_DATA, data + (i * 256), 256);
+    }
+
+    // Ensure the data reaches the medium
+    pollReady(true);
+    m_io.outb(ATA_BASE_CMD0 + ATA_REG_CMD,
+              drives.first()->lba48 ? ATA_CMD_FLUSH_EXT : ATA_CMD_FLUSH);
+    pollReady(true);
+
+    if (m_io.inb(ATA_BASE_CMD0 + ATA_REG_STATUS) & ATA_STATUS_ERROR)
+    {
+        ERROR("failed to write " << sectors << " sectors at LBA " << (Size) lba);
+        return FileSystem::IOError;
+    }
+
+    size = sectors * ATA_SECTOR_SIZE;
+    return FileSystem::Success;
+}
+
+void ATAController::command(const u64 lba, const Size sectors, const bool dma, const bool write)
+{
+    pollReady(true);
+
+    if (drives.first()->lba48 && (lba + sectors > ATA_MAX_LBA_28 || sectors > ATA_MAX_SECTORS_28))
+    {
+        // High order bytes are written first
+        m_io.outb(ATA_BASE_CMD0 + ATA_REG_SELECT, ATA_SEL_MASTER_48);
+        m_io.outb(ATA_BASE_CMD0 + ATA_REG_COUNT,  (sectors >> 8) & 0xff);
+        m_io.outb(ATA_BASE_CMD0 + ATA_REG_ADDR0,  (lba >> 24) & 0xff);
+        m_io.outb(ATA_BASE_CMD0 + ATA_REG_ADDR1,  (lba >> 32) & 0xff);
+        m_io.outb(ATA_BASE_CMD0 + ATA_REG_ADDR2,  (lba >> 40) & 0xff);
+        m_io.outb(ATA_BASE_CMD0 + ATA_REG_COUNT,  sectors & 0xff);
+        m_io.outb(ATA_BASE_CMD0 + ATA_REG_ADDR0,  (lba) & 0xff);
+        m_io.outb(ATA_BASE_CMD0 + ATA_REG_ADDR1,  (lba >> 8) & 0xff);
+        m_io.outb(ATA_BASE_CMD0 + ATA_REG_ADDR2,  (lba >> 16) & 0xff);
+        m_io.outb(ATA_BASE_CMD0 + ATA_REG_CMD,    write ? ATA_CMD_WRITE_EXT :
+                                                  dma ? ATA_CMD_READ_DMA_EXT : ATA_CMD_READ_EXT);
+    }
+    else
+    {
+        m_io.outb(ATA_BASE_CMD0 + ATA_REG_SELECT, ATA_SEL_MASTER_28 | ((lba >> 24) & 0xf));
+        m_io.outb(ATA_BASE_CMD0 + ATA_REG_COUNT,  sectors & 0xff);
+        m_io.outb(ATA_BASE_CMD0 + ATA_REG_ADDR0,  (lba) & 0xff);
+        m_io.outb(ATA_BASE_CMD0 + ATA_REG_ADDR1,  (lba >> 8) & 0xff);
+        m_io.outb(ATA_BASE_CMD0 + ATA_REG_ADDR2,  (lba >> 16) & 0xff);
+        m_io.outb(ATA_BASE_CMD0 + ATA_REG_CMD,    write ? ATA_CMD_WRITE :
+                                                  dma ? ATA_CMD_READ_DMA : ATA_CMD_READ);
+    }
+}
+
 FileSystem::Result ATAController::interrupt(const Size vector)
 {
-    INFO("ATA interrupted on IRQ " << vector);
+    DEBUG("ATA interrupted on IRQ " << vector);
+
+    if (m_busMaster)
+    {
+        const u8 status = m_io.inb(m_busMaster + ATA_BM_STATUS);
+
+        if (m_dmaState == DMABusy && (status & ATA_BM_STATUS_IRQ))
+        {
+            // Stop the bus master and acknowledge the drive interrupt
+            m_io.outb(m_busMaster + ATA_BM_CMD, 0);
+            const u8 driveStatus = m_io.inb(ATA_BASE_CMD0 + ATA_REG_STATUS);
+
+            if ((status & ATA_BM_STATUS_ERROR) || (driveStatus & ATA_STATUS_ERROR))
+                m_dmaState = DMAFailed;
+            else
+                m_dmaState = DMADone;
+        }
+
+        // Clear the interrupt and error bits
+        m_io.outb(m_busMaster + ATA_BM_STATUS, status | ATA_BM_STATUS_ERROR | ATA_BM_STATUS_IRQ);
+    }
+    else
+    {
+        m_io.inb(ATA_BASE_CMD0 + ATA_REG_STATUS);
+    }
+
+    ProcessCtl(SELF, EnableIRQ, ATA_IRQ0);
     return FileSystem::Success;
 }
 
+u32 ATAController::readPCI(const uint bus, const uint slot, const uint func, const uint reg)
+{
+    m_io.outl(PCI_CONFIG_ADDRESS, (1U << 31) | (bus << 16) | (slot << 11) | (func << 8) | (reg & 0xfc));
+    return m_io.inl(PCI_CONFIG_DATA);
+}
+
+void ATAController::writePCI(const uint bus, const uint slot, const uint func,
+                             const uint reg, const u32 value)
+{
+    m_io.outl(PCI_CONFIG_ADDRESS, (1U << 31) | (bus << 16) | (slot << 11) | (func << 8) | (reg & 0xfc));
+    m_io.outl(PCI_CONFIG_DATA, value);
+}
+
 void ATAController::pollReady(bool noData)
 {
     while (true)
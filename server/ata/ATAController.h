@@ -21,6 +21,7 @@
 #include <FreeNOS/User.h>
 #include <List.h>
 #include <Device.h>
+#include <Memory.h>
 
 /**
  * @addtogroup server
@@ -47,6 +48,9 @@
 /** @brief Second ATA Bus Control I/O Base. */
 #define ATA_BASE_CTL1   0x376
 
+/** @brief Interrupt vector of the first ATA Bus. */
+#define ATA_IRQ0        14
+
 /**
  * @}
  */
@@ -192,6 +196,127 @@
 /** @brief Reads sectors from an ATA device. */
 #define ATA_CMD_READ     0x20
 
+/** @brief Reads sectors from an ATA device using 48-bit LBA. */
+#define ATA_CMD_READ_EXT 0x24
+
+/** @brief Reads sectors from an ATA device using DMA. */
+#define ATA_CMD_READ_DMA 0xc8
+
+/** @brief Reads sectors from an ATA device using DMA and 48-bit LBA. */
+#define ATA_CMD_READ_DMA_EXT 0x25
+
+/** @brief Writes sectors to an ATA device. */
+#define ATA_CMD_WRITE    0x30
+
+/** @brief Writes sectors to an ATA device using 48-bit LBA. */
+#define ATA_CMD_WRITE_EXT 0x34
+
+/** @brief Writes the volatile write cache of an ATA device to the medium. */
+#define ATA_CMD_FLUSH    0xe7
+
+/** @brief Writes the volatile write cache of an ATA device using 48-bit LBA. */
+#define ATA_CMD_FLUSH_EXT 0xea
+
+/**
+ * @}
+ */
+
+/**
+ * @name ATA Transfer Limits.
+ * @{
+ */
+
+/** @brief Size of a single sector in bytes. */
+#define ATA_SECTOR_SIZE     512
+
+/** @brief Maximum number of sectors in a single 28-bit LBA command. */
+#define ATA_MAX_SECTORS_28  256
+
+/** @brief Maximum number of sectors in a single 48-bit LBA command. */
+#define ATA_MAX_SECTORS_48  65536
+
+/** @brief Highest sector which is addressable using 28-bit LBA. */
+#define ATA_MAX_LBA_28      0x0fffffff
+
+/** @brief Size of the DMA transfer buffer in bytes. */
+#define ATA_DMA_SIZE        (PAGESIZE * 16)
+
+/**
+ * @}
+ */
+
+/**
+ * @name PCI IDE Bus Master Registers.
+ * @see http://wiki.osdev.org/ATA/ATAPI_using_DMA
+ * @{
+ */
+
+/** @brief Bus Master Command register (offset from BAR4). */
+#define ATA_BM_CMD          0
+
+/** @brief Bus Master Status register (offset from BAR4). */
+#define ATA_BM_STATUS       2
+
+/** @brief Bus Master PRD Table Address register (offset from BAR4). */
+#define ATA_BM_PRDT         4
+
+/** @brief Start/Stop the Bus Master. */
+#define ATA_BM_CMD_START    0x01
+
+/** @brief Transfer from the drive to memory. */
+#define ATA_BM_CMD_READ     0x08
+
+/** @brief DMA transfer failed. */
+#define ATA_BM_STATUS_ERROR 0x02
+
+/** @brief Drive raised the interrupt. */
+#define ATA_BM_STATUS_IRQ   0x04
+
+/** @brief Marks the last entry in the PRD table. */
+#define ATA_PRD_END         0x8000
+
+/**
+ * @}
+ */
+
+/**
+ * @name PCI Configuration Space.
+ * @{
+ */
+
+/** @brief PCI configuration address I/O port. */
+#define PCI_CONFIG_ADDRESS  0xcf8
+
+/** @brief PCI configuration data I/O port. */
+#define PCI_CONFIG_DATA     0xcfc
+
+/** @brief Register with the vendor and device identifier. */
+#define PCI_REG_ID          0x00
+
+/** @brief Register with the command and status fields. */
+#define PCI_REG_COMMAND     0x04
+
+/** @brief Register with the class, subclass and programming interface. */
+#define PCI_REG_CLASS       0x08
+
+/** @brief Register with the fifth base address (Bus Master I/O base for IDE). */
+#define PCI_REG_BAR4        0x20
+
+/** @brief Enable I/O space access. */
+#define PCI_COMMAND_IO      0x01
+
+/** @brief Enable Bus Mastering. */
+#define PCI_COMMAND_MASTER  0x04
+
+/** @brief Class and subclass of IDE controllers. */
+#define PCI_CLASS_IDE       0x0101
+
+/** @brief IDE programming interface: primary channel in native mode. */
+#define PCI_IDE_PRIMARY_NATIVE 0x01
+
+/** @brief IDE programming interface: supports bus mastering. */
+#define PCI_IDE_BUS_MASTER  0x80
+
 /**
  * @}
  */
@@ -230,7 +355,7 @@ typedef struct IdentifyData
     u16 maxTransfer;
     u16 trustedFeatures;
     u16 capabilities[2];
-    u16 reserved3[8];
+    u16 reserved3[9];
     u32 sectors28;
     u16 reserved4[18];
     u16 majorRevision;
@@ -243,6 +368,23 @@ typedef struct IdentifyData
 }
 IdentifyData;
 
+/** @brief IDENTIFY capabilities: DMA is supported. */
+#define IDENTIFY_CAP_DMA    (1 << 8)
+
+/** @brief IDENTIFY supported commands: 48-bit LBA is supported. */
+#define IDENTIFY_CMD_LBA48  (1 << 10)
+
+/**
+ * @brief Physical Region Descriptor for bus master DMA.
+ */
+typedef struct ATAPhysicalRegion
+{
+    u32 address;    /**< Physical address of the memory region */
+    u16 size;       /**< Size of the memory region in bytes (0 = 64KiB) */
+    u16 flags;      /**< Flags, such as ATA_PRD_END */
+}
+ATAPhysicalRegion;
+
 /**
  * @brief Represents a Drive on the ATA bus.
  */
@@ -253,6 +395,12 @@ typedef struct ATADrive
 
     /** Number of sectors. */
     Size sectors;
+
+    /** True if the drive supports 48-bit LBA. */
+    bool lba48;
+
+    /** True if the drive supports DMA transfers. */
+    bool dma;
 }
 ATADrive;
 
@@ -291,6 +439,24 @@ class ATAController : public Device
                                     Size & size,
                                     const Size offset);
 
+    /**
+     * Write bytes to a drive attached to the ATA controller
+     *
+     * Sectors are written using PIO, followed by a cache flush. Only
+     * whole sectors can be written, which the block cache of a file
+     * system does naturally.
+     *
+     * @param buffer Input/Output buffer to input bytes from.
+     * @param size Maximum number of bytes to write on input.
+     *             On output, the actual number of bytes written.
+     * @param offset Offset inside the file to start writing.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result write(IOBuffer & buffer,
+                                     Size & size,
+                                     const Size offset);
+
     /**
      * Process ATA interrupts.
      *
@@ -300,6 +466,19 @@ class ATAController : public Device
      */
     virtual FileSystem::Result interrupt(const Size vector);
 
+  private:
+
+    /**
+     * State of the DMA engine.
+     */
+    enum DMAState
+    {
+        DMAIdle,
+        DMABusy,
+        DMADone,
+        DMAFailed
+    };
+
   private:
 
     /**
@@ -309,6 +488,82 @@ class ATAController : public Device
      */
     void pollReady(bool noData = false);
 
+    /**
+     * Read a 32-bit register from PCI configuration space.
+     *
+     * @param bus PCI bus number
+     * @param slot PCI slot number
+     * @param func PCI function number
+     * @param reg Register offset
+     *
+     * @return Register value
+     */
+    u32 readPCI(const uint bus, const uint slot, const uint func, const uint reg);
+
+    /**
+     * Write a 32-bit register in PCI configuration space.
+     *
+     * @param bus PCI bus number
+     * @param slot PCI slot number
+     * @param func PCI function number
+     * @param reg Register offset
+     * @param value Register value to write
+     */
+    void writePCI(const uint bus, const uint slot, const uint func, const uint reg, const u32 value);
+
+    /**
+     * Detect the PCI IDE controller and prepare bus master DMA.
+     *
+     * @return Result code, NotSupported if no bus master capable controller exists.
+     */
+    FileSystem::Result initializeDMA();
+
+    /**
+     * Send a read or write command to the drive.
+     *
+     * @param lba First sector to transfer
+     * @param sectors Number of sectors to transfer
+     * @param dma True to use the DMA variant of the read command
+     * @param write True to send a PIO write command instead of a read
+     */
+    void command(const u64 lba, const Size sectors, const bool dma, const bool write = false);
+
+    /**
+     * Read bytes from the drive using PIO.
+     *
+     * @param buffer Input/Output buffer to output bytes to.
+     * @param size Maximum number of bytes to read on input.
+     *             On output, the actual number of bytes read.
+     * @param offset Offset inside the drive to start reading.
+     *
+     * @return Result code
+     */
+    FileSystem::Result readPIO(IOBuffer & buffer,
+                               Size & size,
+                               const Size offset);
+
+    /**
+     * Read bytes from the drive using bus master DMA.
+     *
+     * The transfer completes in the interrupt handler. RetryAgain is
+     * returned until all bytes of the request are transferred.
+     *
+     * @param buffer Input/Output buffer to output bytes to.
+     * @param size Maximum number of bytes to read on input.
+     *             On output, the actual number of bytes read.
+     * @param offset Offset inside the drive to start reading.
+     *
+     * @return Result code
+     */
+    FileSystem::Result readDMA(IOBuffer & buffer,
+                               Size & size,
+                               const Size offset);
+
+    /**
+     * Start the DMA transfer of the next part of the current request.
+     */
+    void startDMA();
+
   private:
 
     /** @brief Drives detected on the ATA bus. */
@@ -316,6 +571,33 @@ class ATAController : public Device
 
     /** Port I/O object. */
     Arch::IO m_io;
+
+    /** I/O base of the bus master registers or ZERO if DMA is not available. */
+    u16 m_busMaster;
+
+    /** Memory range of the PRD table. */
+    Memory::Range m_prdRange;
+
+    /** Memory range of the DMA transfer buffer. */
+    Memory::Range m_dmaRange;
+
+    /** Current state of the DMA engine. */
+    DMAState m_dmaState;
+
+    /** Process identifier of the current DMA request. */
+    ProcessID m_dmaPid;
+
+    /** Drive offset in bytes of the current DMA request. */
+    Size m_dmaOffset;
+
+    /** Total number of bytes of the current DMA request. */
+    Size m_dmaSize;
+
+    /** Number of bytes transferred for the current DMA request. */
+    Size m_dmaProgress;
+
+    /** Number of sectors in the ongoing DMA transfer. */
+    Size m_dmaSectors;
 };
 
 /**
@@ -38,7 +38,8 @@ namespace Core
         GetCoreCount = 0,
         CreateProcess,
         PingRequest,
-        PongResponse
+        PongResponse,
+        GetClockPage
     };
 
     /**
@@ -56,6 +57,35 @@ namespace Core
         MemoryError,
         IpcError
     };
+
+    /** Core number to let the CoreServer pick the least loaded core */
+    const Size AnyCore = ~0U;
+
+    /**
+     * Affinity mask which allows every core.
+     *
+     * Bit N of an affinity mask allows core N. Cores beyond the
+     * width of the mask are only allowed by this value.
+     */
+    const Size AllCores = ~0U;
+
+    /**
+     * Load information which each core publishes in shared memory.
+     *
+     * @see CoreServer
+     */
+    typedef struct Load
+    {
+        /** Number of processes ready to run on the core */
+        Size runQueueSize;
+
+        /** Number of processes created by the CoreServer which are still running */
+        Size processes;
+
+        /** Physical address of the ClockPage of the core */
+        Address clockPage;
+    }
+    Load;
 };
 
 /**
@@ -40,9 +40,11 @@ typedef struct CoreMessage : public ChannelMessage
     Core::Action action;    /**< Action to perform. */
     Core::Result result;    /**< Result code. */
     Size coreNumber;        /**< Indicates a number of cores or a specific coreId. */
+    Size coreMask;          /**< Affinity mask of cores allowed for the new process. */
     Address programAddr;    /**< Contains the virtual address of a loaded program. */
     Size programSize;       /**< Contains the size of a loaded program. */
     const char *programCmd; /**< Command-line string for a loaded program. */
+    Address clockPage;      /**< Physical address of the ClockPage of a core. */
 }
 CoreMessage;
 
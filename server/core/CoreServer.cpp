@@ -18,10 +18,10 @@
 #include <FreeNOS/User.h>
 #include <ExecutableFormat.h>
 #include <Lz4Decompressor.h>
+#include <Timer.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
-#include <sys/wait.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include "CoreServer.h"
@@ -30,6 +30,7 @@ const char * CoreServer::kernelPath = "/boot/kernel";
 
 CoreServer::CoreServer()
     : ChannelServer<CoreServer, CoreMessage>(this)
+    , m_notify(MaxCores)
 {
     m_numRegions = 0;
     m_kernel = ZERO;
@@ -41,11 +42,17 @@ CoreServer::CoreServer()
     m_fromMaster = ZERO;
     m_toSlave = ZERO;
     m_fromSlave = ZERO;
+    m_coreLoad = ZERO;
+    m_localLoad = ZERO;
+    m_lastClient = 0;
+    m_lastCore = 0;
+    MemoryBlock::set(m_bootTimeline, 0, sizeof(m_bootTimeline));
 
     // Register IPC handlers
     addIPCHandler(Core::GetCoreCount,  &CoreServer::getCoreCount);
+    addIPCHandler(Core::GetClockPage,  &CoreServer::getClockPage);
 
-    // Because of waitpid() we must send the reply manually before waitpid().
+    // Requests forwarded to a slave core are completed later by retryRequests().
     addIPCHandler(Core::CreateProcess, &CoreServer::createProcess, false);
 }
 
@@ -61,22 +68,34 @@ int CoreServer::runCore()
         // wait from a message of the master core
         receiveFromMaster(&msg);
 
-        const MessageHandler<IPCHandlerFunction> *h = m_ipcHandlers.get(msg.action);
-        if (h)
+        // Serve all requests queued by the master and complete them at once
+        do
         {
-            const bool sendReply = h->sendReply;
-            (this->*h->exec) (&msg);
-
-            if (sendReply)
-            {
-                sendToMaster(&msg);
-            }
+            dispatchFromMaster(&msg);
         }
-        else
+        while (m_fromMaster->read(&msg) == Channel::Success);
+
+        flushToMaster();
+    }
+}
+
+void CoreServer::dispatchFromMaster(CoreMessage *msg)
+{
+    const MessageHandler<IPCHandlerFunction> *h = m_ipcHandlers.get(msg->action);
+    if (h)
+    {
+        const bool sendReply = h->sendReply;
+        (this->*h->exec) (msg);
+
+        if (sendReply)
         {
-            ERROR("invalid action " << (int)msg.action << " from master");
+            sendToMaster(msg);
         }
     }
+    else
+    {
+        ERROR("invalid action " << (int)msg->action << " from master");
+    }
 }
 
 void CoreServer::createProcess(CoreMessage *msg)
@@ -89,6 +108,27 @@ void CoreServer::createProcess(CoreMessage *msg)
 
     if (m_info.coreId == 0)
     {
+        // Place the process on the least loaded core, if requested
+        if (msg->coreNumber == Core::AnyCore)
+        {
+            msg->coreNumber = selectCore(msg->coreMask, msg->from);
+            if (msg->coreNumber == 0)
+            {
+                ERROR("no secondary core available for new process");
+                msg->result = Core::NotFound;
+                ChannelClient::instance()->syncSendTo(msg, sizeof(*msg), msg->from);
+                return;
+            }
+        }
+        else if (!isAllowedCore(msg->coreMask, msg->coreNumber))
+        {
+            ERROR("core" << msg->coreNumber << " not allowed by affinity mask " <<
+                  Number::Hex << msg->coreMask);
+            msg->result = Core::InvalidArgument;
+            ChannelClient::instance()->syncSendTo(msg, sizeof(*msg), msg->from);
+            return;
+        }
+
         // Find physical address for program buffer
         range.virt = msg->programAddr;
         if ((result = VMCtl(msg->from, LookupVirtual, &range)) != API::Success)
@@ -96,6 +136,7 @@ void CoreServer::createProcess(CoreMessage *msg)
             ERROR("failed to lookup virtual address at " <<
                   (void *) msg->programAddr << ": " << (int)result);
             msg->result = Core::InvalidArgument;
+            ChannelClient::instance()->syncSendTo(msg, sizeof(*msg), msg->from);
             return;
         }
         msg->programAddr = range.phys;
@@ -107,28 +148,45 @@ void CoreServer::createProcess(CoreMessage *msg)
             ERROR("failed to lookup virtual address at " <<
                   (void *) msg->programCmd << ": " << (int)result);
             msg->result = Core::InvalidArgument;
+            ChannelClient::instance()->syncSendTo(msg, sizeof(*msg), msg->from);
             return;
         }
         msg->programCmd = (char *) range.phys;
 
-        // Forward message to slave core
-        if (sendToSlave(msg->coreNumber, msg) != Core::Success)
+        // Remember the client, such that the slave can complete the request later
+        PendingRequest *request = new PendingRequest;
+        Size requestId;
+        request->from = msg->from;
+        request->identifier = msg->identifier;
+        request->coreId = msg->coreNumber;
+
+        if (!m_pending.insert(requestId, request))
         {
-            ERROR("failed to write channel on core"<<msg->coreNumber);
-            msg->result = Core::IOError;
+            ERROR("too many pending requests for slave cores");
+            delete request;
+            msg->result = Core::OutOfMemory;
+            ChannelClient::instance()->syncSendTo(msg, sizeof(*msg), msg->from);
             return;
         }
-        DEBUG("creating program at phys " << (void *) msg->programAddr << " on core" << msg->coreNumber);
 
-        // Wait until the slave created the program
-        if (receiveFromSlave(msg->coreNumber, msg) != Core::Success)
+        // Forward message to slave core
+        msg->identifier = requestId;
+
+        if (sendToSlave(msg->coreNumber, msg) != Core::Success)
         {
-            ERROR("failed to read channel on core" << msg->coreNumber);
+            ERROR("failed to write channel on core"<<msg->coreNumber);
+            msg->identifier = request->identifier;
+            m_pending.remove(requestId);
+            delete request;
             msg->result = Core::IOError;
+            ChannelClient::instance()->syncSendTo(msg, sizeof(*msg), msg->from);
             return;
         }
-        DEBUG("program created with result " << (int)msg->result << " at core" << msg->coreNumber);
-        ChannelClient::instance()->syncSendTo(msg, sizeof(*msg), msg->from);
+        DEBUG("creating program at phys " << (void *) msg->programAddr << " on core" <<
+              msg->coreNumber << " as request " << requestId);
+
+        m_lastClient = msg->from;
+        m_lastCore = msg->coreNumber;
     }
     else
     {
@@ -185,7 +243,10 @@ void CoreServer::createProcess(CoreMessage *msg)
         }
         else
         {
-            // reply to master before calling waitpid()
+            // publish the new load and reply to master
+            m_processes.append(pid);
+            m_localLoad->processes++;
+            publishLoad();
             msg->result = Core::Success;
             sendToMaster(msg);
         }
@@ -194,13 +255,6 @@ void CoreServer::createProcess(CoreMessage *msg)
         {
             ERROR("failed to unmap program data: " << (int)result);
         }
-
-        // Wait until the spawned process completes
-        if (pid != -1)
-        {
-            int status;
-            waitpid((pid_t)pid, &status, 0);
-        }
     }
 }
 
@@ -221,6 +275,36 @@ void CoreServer::getCoreCount(CoreMessage *msg)
         msg->result = Core::InvalidArgument;
 }
 
+void CoreServer::getClockPage(CoreMessage *msg)
+{
+    DEBUG("core = " << msg->coreNumber);
+
+    if (m_info.coreId != 0)
+    {
+        msg->result = Core::InvalidArgument;
+    }
+    else if (msg->coreNumber == 0)
+    {
+        const SystemInformation info;
+
+        msg->clockPage = info.clockPageAddress;
+        msg->result = Core::Success;
+    }
+    else
+    {
+        const Core::Load *load = m_coreLoad ? m_coreLoad->get(msg->coreNumber) : ZERO;
+
+        // The core publishes the address once it is running
+        if (load && load->clockPage)
+        {
+            msg->clockPage = load->clockPage;
+            msg->result = Core::Success;
+        }
+        else
+            msg->result = Core::NotFound;
+    }
+}
+
 Core::Result CoreServer::test()
 {
     const Size pingPongNumber = 0x12345678;
@@ -233,6 +317,7 @@ Core::Result CoreServer::test()
         msg.coreNumber = pingPongNumber;
 
         sendToMaster(&msg);
+        flushToMaster();
     }
     else if (m_cores != NULL)
     {
@@ -267,6 +352,11 @@ CoreServer::Result CoreServer::initialize()
             ERROR("failed to setup IPC channels");
             return IOError;
         }
+        else if (setupLoad() != Core::Success)
+        {
+            ERROR("failed to setup core load information");
+            return IOError;
+        }
         else
         {
             return Success;
@@ -297,6 +387,12 @@ CoreServer::Result CoreServer::initialize()
         return IOError;
     }
 
+    if (setupLoad() != Core::Success)
+    {
+        ERROR("failed to setup core load information");
+        return IOError;
+    }
+
     if (bootAll() != Core::Success)
     {
         ERROR("failed to boot all cores");
@@ -585,12 +681,36 @@ Core::Result CoreServer::prepareCoreInfo()
 
             info->coreChannelAddress = info->heapAddress + info->heapSize;
             info->coreChannelAddress += PAGESIZE - (info->heapSize % PAGESIZE);
-            info->coreChannelSize    = PAGESIZE * 4;
+            info->coreChannelSize    = PAGESIZE * 5;
             clearPages(info->coreChannelAddress, info->coreChannelSize);
 
+            const CoreManager::Topology *topology = m_cores->getTopology(coreId);
+            if (topology)
+            {
+                info->package = topology->package;
+                info->cache   = topology->cache;
+                info->node    = topology->node;
+            }
+
             m_kernel->entry(&info->kernelEntry);
             info->timerCounter = sysInfo.timerCounter;
+            info->timestampFrequency = sysInfo.timestampFrequency;
             strlcpy(info->kernelCommand, kernelPath, KERNEL_PATHLEN);
+
+            // Pass the options of the boot core command line, such as the idle policy
+            for (Size j = 0; j < sizeof(sysInfo.cmdline) && sysInfo.cmdline[j]; j++)
+            {
+                if (sysInfo.cmdline[j] == ' ')
+                {
+                    const Size length = strlen(info->kernelCommand);
+                    const Size options = sizeof(sysInfo.cmdline) - j;
+                    const Size space = KERNEL_PATHLEN - 1 - length;
+
+                    MemoryBlock::copy((void *) (info->kernelCommand + length), sysInfo.cmdline + j,
+                                      options < space ? options : space);
+                    break;
+                }
+            }
         }
     }
 
@@ -600,27 +720,116 @@ Core::Result CoreServer::prepareCoreInfo()
 Core::Result CoreServer::bootAll()
 {
     List<uint> & cores = m_cores->getCores();
+    const u32 start = currentTicks();
+    uint previous = 0;
+    Core::Result result;
+
     if (cores.count() == 0)
     {
         ERROR("no cores found");
         return Core::NotFound;
     }
 
-    // Boot each core
+    // Cores share the startup code and CoreInfo location, thus only
+    // one core boots at a time. Overlap its boot with copying the kernel
+    // and BootImage for the next core, which uses separate memory.
     for (ListIterator<uint> i(cores); i.hasCurrent(); i++)
     {
-        uint coreId = i.current();
+        const uint coreId = i.current();
 
         if (coreId != 0)
         {
-            prepareCore(coreId, (CoreInfo *)m_coreInfo->get(coreId), m_regions);
-            bootCore(coreId, (CoreInfo *)m_coreInfo->get(coreId));
+            CoreInfo *info = (CoreInfo *) m_coreInfo->get(coreId);
+
+            m_bootTimeline[coreId].prepare = currentTicks();
+
+            if ((result = prepareCore(coreId, info, m_regions)) != Core::Success)
+            {
+                return result;
+            }
+
+            if (previous != 0)
+            {
+                if ((result = waitCore(previous, (CoreInfo *) m_coreInfo->get(previous))) != Core::Success)
+                {
+                    return result;
+                }
+                m_bootTimeline[previous].booted = currentTicks();
+                BootMark(BootCoreOnline, previous);
+            }
+
+            m_bootTimeline[coreId].start = currentTicks();
+            BootMark(BootCoreStarted, coreId);
+
+            if ((result = bootCore(coreId, info)) != Core::Success)
+            {
+                return result;
+            }
+            previous = coreId;
         }
     }
 
+    // Wait for the last core
+    if (previous != 0)
+    {
+        if ((result = waitCore(previous, (CoreInfo *) m_coreInfo->get(previous))) != Core::Success)
+        {
+            return result;
+        }
+        m_bootTimeline[previous].booted = currentTicks();
+        BootMark(BootCoreOnline, previous);
+    }
+
+    reportBoot(start);
     return Core::Success;
 }
 
+Core::Result CoreServer::waitCore(uint coreId, CoreInfo *info)
+{
+    return Core::Success;
+}
+
+u32 CoreServer::currentTicks() const
+{
+    Timer::Info timer;
+
+    if (ProcessCtl(SELF, InfoTimer, (Address) &timer) != API::Success)
+    {
+        return 0;
+    }
+
+    return timer.ticks;
+}
+
+void CoreServer::reportBoot(const u32 start) const
+{
+    List<uint> & cores = m_cores->getCores();
+    Timer::Info timer;
+
+    if (ProcessCtl(SELF, InfoTimer, (Address) &timer) != API::Success || timer.frequency == 0)
+    {
+        return;
+    }
+
+    // Report in milliseconds relative to the start of booting
+    for (ListIterator<uint> i(cores); i.hasCurrent(); i++)
+    {
+        const uint coreId = i.current();
+        const BootTimeline & t = m_bootTimeline[coreId];
+
+        if (coreId != 0)
+        {
+            NOTICE("core" << coreId <<
+                   ": prepare at " << (((t.prepare - start) * 1000) / timer.frequency) << "ms" <<
+                   ", start at " << (((t.start - start) * 1000) / timer.frequency) << "ms" <<
+                   ", booted at " << (((t.booted - start) * 1000) / timer.frequency) << "ms");
+        }
+    }
+
+    NOTICE("booted " << (cores.count() - 1) << " cores in " <<
+           (((timer.ticks - start) * 1000) / timer.frequency) << "ms");
+}
+
 Core::Result CoreServer::clearPages(Address addr, Size size)
 {
     Memory::Range range;
@@ -680,6 +889,117 @@ Core::Result CoreServer::setupChannels()
     return Core::Success;
 }
 
+Core::Result CoreServer::setupLoad()
+{
+    SystemInformation info;
+    Memory::Range range;
+    API::Result result;
+
+    DEBUG("");
+
+    // The load page is placed directly after the channel pages
+    range.virt   = ZERO;
+    range.size   = PAGESIZE;
+    range.access = Memory::User | Memory::Readable | Memory::Writable | Memory::Uncached;
+
+    if (info.coreId == 0)
+    {
+        Size numCores = m_cores->getCores().count();
+
+        m_coreLoad = new Index<Core::Load, MaxCores>();
+
+        for (Size i = 1; i < numCores; i++)
+        {
+            range.virt = ZERO;
+            range.phys = m_coreInfo->get(i)->coreChannelAddress + (PAGESIZE * 4);
+
+            if ((result = VMCtl(SELF, MapContiguous, &range)) != API::Success)
+            {
+                ERROR("failed to map load page of core" << i << ": result = " << (int) result);
+                return Core::MemoryError;
+            }
+
+            m_coreLoad->insertAt(i, (Core::Load *) range.virt);
+        }
+    }
+    else
+    {
+        range.phys = info.coreChannelAddress + (PAGESIZE * 4);
+
+        if ((result = VMCtl(SELF, MapContiguous, &range)) != API::Success)
+        {
+            ERROR("failed to map load page: result = " << (int) result);
+            return Core::MemoryError;
+        }
+
+        m_localLoad = (Core::Load *) range.virt;
+        m_localLoad->processes = 0;
+        m_localLoad->clockPage = info.clockPageAddress;
+        publishLoad();
+    }
+
+    return Core::Success;
+}
+
+void CoreServer::publishLoad()
+{
+    const SystemInformation info;
+
+    m_localLoad->runQueueSize = info.runQueueSize;
+}
+
+uint CoreServer::selectCore(const Size coreMask, const ProcessID client) const
+{
+    const Size numCores = m_cores->getCores().count();
+    const uint previous = client == m_lastClient ? m_lastCore : 0;
+    CoreManager::Distance minimumDistance = CoreManager::Remote;
+    Size minimumLoad = ~0U;
+    uint coreId = 0;
+
+    for (Size i = 1; i < numCores; i++)
+    {
+        const Core::Load *load = m_coreLoad->get(i);
+
+        if (load && isAllowedCore(coreMask, i))
+        {
+            // Processes which the core is still creating are not yet published
+            Size coreLoad = load->runQueueSize + load->processes;
+
+            for (Size j = 0; j < MaxPendingRequests; j++)
+            {
+                const PendingRequest *request = m_pending.get(j);
+                if (request && request->coreId == i)
+                    coreLoad++;
+            }
+
+            // Among equally loaded cores, prefer the one closest to the previous process of the client
+            const CoreManager::Distance distance = previous != 0 ?
+                m_cores->getDistance(previous, i) : CoreManager::Remote;
+
+            if (coreLoad < minimumLoad || (coreLoad == minimumLoad && distance < minimumDistance))
+            {
+                minimumLoad = coreLoad;
+                minimumDistance = distance;
+                coreId = i;
+            }
+        }
+    }
+
+    DEBUG("selected core" << coreId << " with load " << minimumLoad);
+    return coreId;
+}
+
+bool CoreServer::isAllowedCore(const Size coreMask, const Size coreId) const
+{
+    if (coreMask == Core::AllCores)
+        return true;
+
+    if (coreId >= sizeof(coreMask) * 8)
+        return false;
+
+    return (coreMask & (1U << coreId)) != 0;
+}
+
 Core::Result CoreServer::receiveFromMaster(CoreMessage *msg)
 {
     Channel::Result result = Channel::NotFound;
@@ -692,8 +1012,25 @@ Core::Result CoreServer::receiveFromMaster(CoreMessage *msg)
             result = m_fromMaster->read(msg);
         }
 
-        // Wait for IPI which will wake us
-        waitIPI();
+        if (result != Channel::Success)
+        {
+            reapProcesses();
+
+            // Wait for IPI which will wake us, or check on the running processes again later
+            if (m_processes.count() > 0)
+            {
+                Timer::Info expiry;
+
+                if (ProcessCtl(SELF, InfoTimer, (Address) &expiry) == API::Success)
+                {
+                    expiry.ticks += ((ReapInterval * expiry.frequency) / 1000) + 1;
+                    waitIPI(&expiry);
+                    continue;
+                }
+            }
+
+            waitIPI(ZERO);
+        }
     }
 
     return Core::Success;
@@ -704,17 +1041,44 @@ Core::Result CoreServer::sendToMaster(CoreMessage *msg)
     while (m_toMaster->write(msg) != Channel::Success)
         ;
 
+    return Core::Success;
+}
+
+Core::Result CoreServer::flushToMaster()
+{
     const MemoryChannel::Result result = m_toMaster->flush();
     if (result != Channel::Success)
     {
         ERROR("failed to flush master channel: result = " << (int) result);
-        msg->result = Core::IOError;
         return Core::IOError;
     }
 
     return Core::Success;
 }
 
+void CoreServer::reapProcesses()
+{
+    ListIterator<ProcessID> i(m_processes);
+
+    while (i.hasCurrent())
+    {
+        ProcessInfo info;
+
+        // Terminated processes are removed at once, but the ProcessID may be reused
+        if (ProcessCtl(i.current(), InfoPID, (Address) &info) != API::Success ||
+            info.parent != m_self)
+        {
+            i.remove();
+            m_localLoad->processes--;
+            publishLoad();
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
 Core::Result CoreServer::receiveFromSlave(uint coreId, CoreMessage *msg)
 {
     MemoryChannel *ch = m_fromSlave->get(coreId);
@@ -745,20 +1109,105 @@ Core::Result CoreServer::sendToSlave(uint coreId, CoreMessage *msg)
         return Core::IOError;
     }
 
-    result = ch->flush();
-    if (result != Channel::Success)
+    m_notify.set(coreId);
+    return Core::Success;
+}
+
+void CoreServer::notifySlaves()
+{
+    const Size numCores = m_cores->getCores().count();
+
+    for (Size i = 1; i < numCores; i++)
     {
-        ERROR("failed to flush channel on core" << coreId << ": result = " << (int)result);
-        msg->result = Core::IOError;
-        return Core::IOError;
+        if (!m_notify.isSet(i))
+            continue;
+
+        m_notify.unset(i);
+
+        const MemoryChannel::Result result = m_toSlave->get(i)->flush();
+        if (result != Channel::Success)
+        {
+            ERROR("failed to flush channel on core" << i << ": result = " << (int)result);
+        }
+
+        // Send IPI to ensure the slave wakes up for the messages
+        if (sendIPI(i) != Core::Success)
+        {
+            ERROR("failed to send IPI to core" << i);
+        }
+    }
+}
+
+Size CoreServer::completeRequests()
+{
+    const Size numCores = m_cores->getCores().count();
+    List<ProcessID> clients;
+    CoreMessage msg;
+    Size completed = 0;
+
+    for (Size i = 1; i < numCores; i++)
+    {
+        MemoryChannel *ch = m_fromSlave->get(i);
+
+        while (ch && ch->read(&msg) == Channel::Success)
+        {
+            const Size requestId = msg.identifier;
+            PendingRequest *request = m_pending.get(requestId);
+
+            if (!request)
+            {
+                ERROR("unknown request " << requestId << " completed by core" << i);
+                continue;
+            }
+
+            DEBUG("request " << requestId << " completed with result " <<
+                  (int)msg.result << " at core" << i);
+
+            // Queue the reply, such that each client is woken up only once
+            msg.identifier = request->identifier;
+            Channel *reply = m_registry.getProducer(request->from);
+
+            if (reply && reply->write(&msg) == Channel::Success)
+            {
+                if (!clients.contains(request->from))
+                    clients.append(request->from);
+            }
+            else
+            {
+                ChannelClient::instance()->syncSendTo(&msg, sizeof(msg), request->from);
+            }
+
+            m_pending.remove(requestId);
+            delete request;
+            completed++;
+        }
     }
 
-    // Send IPI to ensure the slave wakes up for the message
-    if (sendIPI(coreId) != Core::Success)
+    for (ListIterator<ProcessID> i(clients); i.hasCurrent(); i++)
     {
-        ERROR("failed to send IPI to core" << coreId);
-        return Core::IOError;
+        ProcessCtl(i.current(), Wakeup, InheritPriority);
     }
 
-    return Core::Success;
+    return completed;
+}
+
+bool CoreServer::retryRequests()
+{
+    if (m_info.coreId != 0 || m_pending.count() == 0)
+        return false;
+
+    notifySlaves();
+
+    // Let other processes run while the slaves are busy
+    if (completeRequests() == 0)
+    {
+        ProcessCtl(SELF, Schedule, 0);
+    }
+
+    return false;
+}
+
+bool CoreServer::isPolling() const
+{
+    return m_pending.count() > 0;
 }
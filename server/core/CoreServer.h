@@ -24,6 +24,7 @@
 #include <Types.h>
 #include <Macros.h>
 #include <Index.h>
+#include <BitArray.h>
 #include <ExecutableFormat.h>
 #include <MemoryChannel.h>
 #include <CoreInfo.h>
@@ -57,6 +58,34 @@ class CoreServer : public ChannelServer<CoreServer, CoreMessage>
     /** Number of times to busy wait on receiving a message */
     static const Size MaxMessageRetry = 128;
 
+    /** Maximum number of requests forwarded to the slave cores at once */
+    static const Size MaxPendingRequests = 64;
+
+    /** Milliseconds between checks for terminated processes on a slave core */
+    static const Size ReapInterval = 100;
+
+    /**
+     * Request forwarded to a slave core which is not yet completed
+     */
+    typedef struct PendingRequest
+    {
+        ProcessID from;     /**< Client which sent the request */
+        Size identifier;    /**< Request identifier of the client */
+        Size coreId;        /**< Slave core which serves the request */
+    }
+    PendingRequest;
+
+    /**
+     * Timer ticks at each step of booting a secondary core
+     */
+    typedef struct BootTimeline
+    {
+        u32 prepare; /**< Start of copying the kernel and BootImage */
+        u32 start;   /**< Core was started */
+        u32 booted;  /**< Core has booted */
+    }
+    BootTimeline;
+
     /** The default kernel for starting new cores. */
     static const char *kernelPath;
 
@@ -88,11 +117,31 @@ class CoreServer : public ChannelServer<CoreServer, CoreMessage>
      */
     virtual Result initialize();
 
+    /**
+     * Complete requests of the slave cores
+     *
+     * Wakes up each slave core once for the requests forwarded to
+     * it since the last call and replies to clients of completed requests.
+     *
+     * @return True if retry is needed again, false if all requests processed
+     */
+    virtual bool retryRequests();
+
+    /**
+     * Keep running while requests are forwarded to the slave cores
+     *
+     * @return True if requests are pending
+     */
+    virtual bool isPolling() const;
+
   private:
 
     /**
      * Boot a processor core
      *
+     * Implementations may return before the core has booted,
+     * in which case waitCore() must wait for it.
+     *
      * @param coreId Core identifier number
      * @param info CoreInfo pointer containing specific core information
      *
@@ -100,6 +149,16 @@ class CoreServer : public ChannelServer<CoreServer, CoreMessage>
      */
     virtual Core::Result bootCore(uint coreId, CoreInfo *info) = 0;
 
+    /**
+     * Wait until a processor core started by bootCore() has booted
+     *
+     * @param coreId Core identifier number
+     * @param info CoreInfo pointer containing specific core information
+     *
+     * @return Result code
+     */
+    virtual Core::Result waitCore(uint coreId, CoreInfo *info);
+
     /**
      * Discover processor cores
      *
@@ -109,8 +168,10 @@ class CoreServer : public ChannelServer<CoreServer, CoreMessage>
 
     /**
      * Wait for Inter-Processor-Interrupt
+     *
+     * @param expiry Optional timer ticks at which to stop waiting
      */
-    virtual void waitIPI() const = 0;
+    virtual void waitIPI(const Timer::Info *expiry) const = 0;
 
     /**
      * Send Inter-Processor-Interrupt
@@ -162,6 +223,20 @@ class CoreServer : public ChannelServer<CoreServer, CoreMessage>
      */
     Core::Result bootAll();
 
+    /**
+     * Get the current timer ticks
+     *
+     * @return Timer ticks or zero if not available
+     */
+    u32 currentTicks() const;
+
+    /**
+     * Report the time spent booting each secondary core
+     *
+     * @param start Timer ticks when booting started
+     */
+    void reportBoot(const u32 start) const;
+
     /**
      * Setup communication channels between CoreServers
      *
@@ -169,6 +244,42 @@ class CoreServer : public ChannelServer<CoreServer, CoreMessage>
      */
     Core::Result setupChannels();
 
+    /**
+     * Map the shared memory load information of the cores
+     *
+     * @return Result code
+     */
+    Core::Result setupLoad();
+
+    /**
+     * Publish the load of the current processor core
+     */
+    void publishLoad();
+
+    /**
+     * Find the least loaded secondary processor core
+     *
+     * Among equally loaded cores, the core which is closest in the
+     * processor topology to the previous process of the same client is
+     * selected. Processes which communicate, such as MPI ranks, then share caches.
+     *
+     * @param coreMask Affinity mask of cores which may be selected
+     * @param client Process which requests the new process
+     *
+     * @return Core identifier or zero if no secondary core is available
+     */
+    uint selectCore(const Size coreMask, const ProcessID client) const;
+
+    /**
+     * Check if an affinity mask allows a processor core
+     *
+     * @param coreMask Affinity mask
+     * @param coreId Core identifier
+     *
+     * @return True if the core is allowed by the mask
+     */
+    bool isAllowedCore(const Size coreMask, const Size coreId) const;
+
     /**
      * Clear memory pages with zeroes
      *
@@ -188,6 +299,15 @@ class CoreServer : public ChannelServer<CoreServer, CoreMessage>
      */
     void getCoreCount(CoreMessage *msg);
 
+    /**
+     * Get the physical address of the ClockPage of a core
+     *
+     * Processes map the ClockPage of other cores to read their load.
+     *
+     * @param msg CoreMessage with the core number and to fill in the address
+     */
+    void getClockPage(CoreMessage *msg);
+
     /**
      * Create a process on the current processor core
      *
@@ -197,9 +317,18 @@ class CoreServer : public ChannelServer<CoreServer, CoreMessage>
      */
     void createProcess(CoreMessage *msg);
 
+    /**
+     * Dispatch a request from the master to its handler
+     *
+     * @param msg CoreMessage pointer
+     */
+    void dispatchFromMaster(CoreMessage *msg);
+
     /**
      * Receive message from master
      *
+     * Terminated processes are reaped while waiting.
+     *
      * @param msg CoreMessage pointer
      *
      * @return Result code
@@ -209,12 +338,26 @@ class CoreServer : public ChannelServer<CoreServer, CoreMessage>
     /**
      * Send message to master
      *
+     * The message is only visible to the master after flushToMaster().
+     *
      * @param msg CoreMessage pointer
      *
      * @return Result code
      */
     Core::Result sendToMaster(CoreMessage *msg);
 
+    /**
+     * Flush all messages sent to the master
+     *
+     * @return Result code
+     */
+    Core::Result flushToMaster();
+
+    /**
+     * Forget processes created by this core which have terminated
+     */
+    void reapProcesses();
+
     /**
      * Receive message from slave
      *
@@ -228,6 +371,8 @@ class CoreServer : public ChannelServer<CoreServer, CoreMessage>
     /**
      * Send message to slave
      *
+     * The slave is woken up for the message by notifySlaves().
+     *
      * @param coreId Core identifier
      * @param msg CoreMessage pointer
      *
@@ -235,6 +380,18 @@ class CoreServer : public ChannelServer<CoreServer, CoreMessage>
      */
     Core::Result sendToSlave(uint coreId, CoreMessage *msg);
 
+    /**
+     * Flush the channels and send one IPI to each slave with new messages
+     */
+    void notifySlaves();
+
+    /**
+     * Reply to the clients of all requests completed by slave cores
+     *
+     * @return Number of completed requests
+     */
+    Size completeRequests();
+
   protected:
 
     CoreManager *m_cores;
@@ -256,6 +413,30 @@ class CoreServer : public ChannelServer<CoreServer, CoreMessage>
 
     MemoryChannel *m_toMaster;
     MemoryChannel *m_fromMaster;
+
+    /** Published load of each secondary core (master only) */
+    Index<Core::Load, MaxCores> *m_coreLoad;
+
+    /** Published load of the current core (slave only) */
+    Core::Load *m_localLoad;
+
+    /** Requests forwarded to slave cores, by request identifier (master only) */
+    Index<PendingRequest, MaxPendingRequests> m_pending;
+
+    /** Slave cores with messages which are not yet notified (master only) */
+    BitArray m_notify;
+
+    /** Processes created on the current core which are still running (slave only) */
+    List<ProcessID> m_processes;
+
+    /** Client of the most recently placed process (master only) */
+    ProcessID m_lastClient;
+
+    /** Core of the most recently placed process (master only) */
+    uint m_lastCore;
+
+    /** Boot timeline of each secondary core (master only) */
+    BootTimeline m_bootTimeline[MaxCores];
 };
 
 /**
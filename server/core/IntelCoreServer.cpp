@@ -55,6 +55,17 @@ Core::Result IntelCoreServer::bootCore(uint coreId, CoreInfo *info)
         return Core::BootError;
     }
 
+    return Core::Success;
+}
+
+Core::Result IntelCoreServer::waitCore(uint coreId, CoreInfo *info)
+{
+    if (m_mp.waitBooted() != IntelMP::Success)
+    {
+        ERROR("failed to wait for core" << coreId);
+        return Core::BootError;
+    }
+
     NOTICE("core" << coreId << " started");
     return Core::Success;
 }
@@ -83,11 +94,11 @@ Core::Result IntelCoreServer::discoverCores()
     return Core::Success;
 }
 
-void IntelCoreServer::waitIPI() const
+void IntelCoreServer::waitIPI(const Timer::Info *expiry) const
 {
     // Wait for IPI which will wake us
     ProcessCtl(SELF, EnableIRQ, IPIVector);
-    ProcessCtl(SELF, EnterSleep, 0, 0);
+    ProcessCtl(SELF, EnterSleep, (Address) expiry, 0);
 }
 
 Core::Result IntelCoreServer::sendIPI(uint coreId)
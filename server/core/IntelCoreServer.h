@@ -70,6 +70,16 @@ class IntelCoreServer : public CoreServer
      */
     virtual Core::Result bootCore(uint coreId, CoreInfo *info);
 
+    /**
+     * Wait until a processor core has booted
+     *
+     * @param coreId Core identifier number
+     * @param info CoreInfo pointer containing specific core information
+     *
+     * @return Result code
+     */
+    virtual Core::Result waitCore(uint coreId, CoreInfo *info);
+
     /**
      * Discover processor cores
      *
@@ -79,8 +89,10 @@ class IntelCoreServer : public CoreServer
 
     /**
      * Wait for Inter-Processor-Interrupt
+     *
+     * @param expiry Optional timer ticks at which to stop waiting
      */
-    virtual void waitIPI() const;
+    virtual void waitIPI(const Timer::Info *expiry) const;
 
     /**
      * Send Inter-Processor-Interrupt
@@ -46,7 +46,7 @@ Core::Result SingleCoreServer::discoverCores()
     return Core::Success;
 }
 
-void SingleCoreServer::waitIPI() const
+void SingleCoreServer::waitIPI(const Timer::Info *expiry) const
 {
 }
 
@@ -67,8 +67,10 @@ class SingleCoreServer : public CoreServer
 
     /**
      * Wait for Inter-Processor-Interrupt
+     *
+     * @param expiry Optional timer ticks at which to stop waiting
      */
-    virtual void waitIPI() const;
+    virtual void waitIPI(const Timer::Info *expiry) const;
 
     /**
      * Send Inter-Processor-Interrupt
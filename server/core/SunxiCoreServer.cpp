@@ -85,6 +85,13 @@ Core::Result SunxiCoreServer::bootCore(uint coreId, CoreInfo *info)
         return Core::BootError;
     }
 
+    return Core::Success;
+}
+
+Core::Result SunxiCoreServer::waitCore(uint coreId, CoreInfo *info)
+{
+    const Address secondaryCoreInfoRelAddr = info->memory.phys + SecondaryCoreInfoOffset;
+
     // Wait until the core raises the 'booted' flag in CoreInfo
     while (1)
     {
@@ -110,11 +117,11 @@ Core::Result SunxiCoreServer::discoverCores()
     return Core::Success;
 }
 
-void SunxiCoreServer::waitIPI() const
+void SunxiCoreServer::waitIPI(const Timer::Info *expiry) const
 {
     // Wait for IPI which will wake us
     ProcessCtl(SELF, EnableIRQ, SoftwareInterruptNumber);
-    ProcessCtl(SELF, EnterSleep, 0, 0);
+    ProcessCtl(SELF, EnterSleep, (Address) expiry, 0);
 }
 
 Core::Result SunxiCoreServer::sendIPI(uint coreId)
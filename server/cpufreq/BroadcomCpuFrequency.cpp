@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Log.h>
+#include "BroadcomCpuFrequency.h"
+
+template<> CpuFrequency* AbstractFactory<CpuFrequency>::create()
+{
+    return new BroadcomCpuFrequency();
+}
+
+FileSystem::Result BroadcomCpuFrequency::initialize()
+{
+    if (m_mailbox.initialize() != BroadcomMailbox::Success)
+    {
+        ERROR("failed to initialize mailbox");
+        return FileSystem::IOError;
+    }
+
+    // The firmware reads the property buffer from memory directly
+    m_buffer.phys = 0;
+    m_buffer.virt = 0;
+    m_buffer.size = PAGESIZE;
+    m_buffer.access = Memory::User | Memory::Readable | Memory::Writable | Memory::Uncached;
+
+    const API::Result vmResult = VMCtl(SELF, MapContiguous, &m_buffer);
+    if (vmResult != API::Success)
+    {
+        ERROR("failed to allocate property buffer: result = " << (int) vmResult);
+        return FileSystem::IOError;
+    }
+
+    const Size minimum = clockProperty(GetMinClockRate, 0);
+    const Size maximum = clockProperty(GetMaxClockRate, 0);
+    m_frequency = clockProperty(GetClockRate, 0);
+
+    if (minimum == 0 || maximum < minimum)
+    {
+        ERROR("failed to read the ARM clock range");
+        return FileSystem::IOError;
+    }
+
+    for (Size hertz = minimum; hertz < maximum; hertz += LevelStep)
+        addLevel(hertz);
+
+    addLevel(maximum);
+
+    NOTICE("boot frequency " << (m_frequency / 1000000) << "MHz, range " <<
+           (minimum / 1000000) << "-" << (maximum / 1000000) << "MHz");
+    return FileSystem::Success;
+}
+
+FileSystem::Result BroadcomCpuFrequency::apply(const Size hertz)
+{
+    return clockProperty(SetClockRate, hertz) != 0 ? FileSystem::Success : FileSystem::IOError;
+}
+
+Size BroadcomCpuFrequency::clockProperty(const Tag tag, const Size hertz)
+{
+    volatile u32 *buffer = (volatile u32 *) m_buffer.virt;
+    u32 response;
+
+    buffer[0] = 9 * sizeof(u32);    // Buffer size
+    buffer[1] = 0;                  // Request
+    buffer[2] = tag;
+    buffer[3] = 3 * sizeof(u32);    // Value buffer size
+    buffer[4] = 0;                  // Request length
+    buffer[5] = ArmClock;
+    buffer[6] = hertz;
+    buffer[7] = 0;                  // Allow turbo settings
+    buffer[8] = 0;                  // End tag
+
+    // The channel uses the low four bits, thus the buffer is 16 byte aligned
+    m_mailbox.write(BroadcomMailbox::VCProperty, (BusAlias | m_buffer.phys) >> 4);
+    m_mailbox.read(BroadcomMailbox::VCProperty, &response);
+
+    if (buffer[1] != ResponseSuccess || buffer[5] != ArmClock)
+        return 0;
+
+    return buffer[6];
+}
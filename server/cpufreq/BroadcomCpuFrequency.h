@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVER_CPUFREQ_BROADCOMCPUFREQUENCY_H
+#define __SERVER_CPUFREQ_BROADCOMCPUFREQUENCY_H
+
+#include <FreeNOS/System.h>
+#include <Types.h>
+#include <Memory.h>
+#include <arm/broadcom/BroadcomMailbox.h>
+#include "CpuFrequency.h"
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup cpufreq
+ * @{
+ */
+
+/**
+ * Raspberry Pi CPU frequency control through the firmware.
+ *
+ * The clock rate of the ARM is changed with the clock tags of the
+ * mailbox property interface. The firmware adjusts the supply
+ * voltage to the rate.
+ *
+ * @see https://github.com/raspberrypi/firmware/wiki/Mailbox-property-interface
+ */
+class BroadcomCpuFrequency : public CpuFrequency
+{
+  private:
+
+    /** Distance between frequency levels in hertz */
+    static const Size LevelStep = 100000000;
+
+    /** Bus address of uncached memory as seen by the firmware */
+    static const Address BusAlias = 0xC0000000;
+
+    /** Clock identifier of the ARM */
+    static const u32 ArmClock = 3;
+
+    /**
+     * Property tags
+     */
+    enum Tag
+    {
+        GetClockRate    = 0x00030002,
+        GetMaxClockRate = 0x00030004,
+        GetMinClockRate = 0x00030007,
+        SetClockRate    = 0x00038002
+    };
+
+    /** Property buffer response code for success */
+    static const u32 ResponseSuccess = 0x80000000;
+
+  public:
+
+    /**
+     * Initialize the hardware and find the frequency levels.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result initialize();
+
+  protected:
+
+    /**
+     * Program the hardware for a frequency level.
+     *
+     * @param hertz Frequency in hertz of one of the levels
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result apply(const Size hertz);
+
+  private:
+
+    /**
+     * Send a clock tag to the firmware.
+     *
+     * @param tag Property tag
+     * @param hertz Rate to set, or zero for get tags
+     *
+     * @return Rate in hertz from the response or zero on failure
+     */
+    Size clockProperty(const Tag tag, const Size hertz);
+
+  private:
+
+    /** Mailbox to the firmware */
+    BroadcomMailbox m_mailbox;
+
+    /** Uncached property buffer */
+    Memory::Range m_buffer;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_CPUFREQ_BROADCOMCPUFREQUENCY_H */
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Log.h>
+#include "CpuFrequency.h"
+
+CpuFrequency::CpuFrequency()
+    : m_frequency(0)
+    , m_count(0)
+{
+}
+
+CpuFrequency::~CpuFrequency()
+{
+}
+
+Size CpuFrequency::getMinimum() const
+{
+    return m_count ? m_levels[0] : m_frequency;
+}
+
+Size CpuFrequency::getMaximum() const
+{
+    return m_count ? m_levels[m_count - 1] : m_frequency;
+}
+
+Size CpuFrequency::getFrequency() const
+{
+    return m_frequency;
+}
+
+FileSystem::Result CpuFrequency::setFrequency(const Size hertz)
+{
+    Size level = 0;
+
+    if (m_count == 0)
+        return FileSystem::NotSupported;
+
+    while (level < m_count - 1 && m_levels[level] < hertz)
+        level++;
+
+    if (m_levels[level] == m_frequency)
+        return FileSystem::Success;
+
+    DEBUG("frequency = " << m_levels[level]);
+
+    const FileSystem::Result result = apply(m_levels[level]);
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to set frequency to " << m_levels[level] << ": result = " << (int) result);
+        return result;
+    }
+
+    m_frequency = m_levels[level];
+    return FileSystem::Success;
+}
+
+void CpuFrequency::addLevel(const Size hertz)
+{
+    if (m_count < MaximumLevels)
+        m_levels[m_count++] = hertz;
+}
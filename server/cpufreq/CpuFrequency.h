@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVER_CPUFREQ_CPUFREQUENCY_H
+#define __SERVER_CPUFREQ_CPUFREQUENCY_H
+
+#include <FreeNOS/System.h>
+#include <Types.h>
+#include <Factory.h>
+#include <FileSystem.h>
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup cpufreq
+ * @{
+ */
+
+/**
+ * Clock frequency control of the processor cores.
+ *
+ * All cores share a single clock. Each board provides its
+ * implementation through AbstractFactory<CpuFrequency>::create(),
+ * which fills the supported frequency levels on initialize().
+ */
+class CpuFrequency : public AbstractFactory<CpuFrequency>
+{
+  public:
+
+    /** Maximum number of frequency levels */
+    static const Size MaximumLevels = 16;
+
+  public:
+
+    /**
+     * Constructor
+     */
+    CpuFrequency();
+
+    /**
+     * Destructor
+     */
+    virtual ~CpuFrequency();
+
+    /**
+     * Initialize the hardware and find the frequency levels.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result initialize() = 0;
+
+    /**
+     * Get the lowest supported frequency.
+     *
+     * @return Frequency in hertz
+     */
+    Size getMinimum() const;
+
+    /**
+     * Get the highest supported frequency.
+     *
+     * @return Frequency in hertz
+     */
+    Size getMaximum() const;
+
+    /**
+     * Get the current frequency.
+     *
+     * @return Frequency in hertz
+     */
+    Size getFrequency() const;
+
+    /**
+     * Change the frequency.
+     *
+     * Selects the lowest level at or above the requested frequency,
+     * or the highest level if the request is above all levels.
+     *
+     * @param hertz Requested frequency in hertz
+     *
+     * @return Result code
+     */
+    FileSystem::Result setFrequency(const Size hertz);
+
+  protected:
+
+    /**
+     * Add a supported frequency level.
+     *
+     * Levels must be added in increasing order.
+     *
+     * @param hertz Frequency in hertz
+     */
+    void addLevel(const Size hertz);
+
+    /**
+     * Program the hardware for a frequency level.
+     *
+     * @param hertz Frequency in hertz of one of the levels
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result apply(const Size hertz) = 0;
+
+  protected:
+
+    /** Current frequency in hertz */
+    Size m_frequency;
+
+  private:
+
+    /** Supported frequencies in hertz, in increasing order */
+    Size m_levels[MaximumLevels];
+
+    /** Number of supported frequencies */
+    Size m_count;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_CPUFREQ_CPUFREQUENCY_H */
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CpuFrequencyServer.h"
+
+CpuFrequencyServer::CpuFrequencyServer(const char *path)
+    : DeviceServer(path)
+{
+    m_governor = new CpuGovernor(getNextInode(), CpuFrequency::create());
+    registerDevice(m_governor, "governor");
+}
+
+FileSystem::Result CpuFrequencyServer::initialize()
+{
+    const FileSystem::Result result = DeviceServer::initialize();
+
+    if (result == FileSystem::Success)
+        setTimeout(CpuGovernor::SampleInterval, CpuGovernor::SampleSlack);
+
+    return result;
+}
+
+void CpuFrequencyServer::timeout()
+{
+    DeviceServer::timeout();
+
+    m_governor->sample();
+    setTimeout(CpuGovernor::SampleInterval, CpuGovernor::SampleSlack);
+}
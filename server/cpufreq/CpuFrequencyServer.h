@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVER_CPUFREQ_CPUFREQUENCYSERVER_H
+#define __SERVER_CPUFREQ_CPUFREQUENCYSERVER_H
+
+#include <DeviceServer.h>
+#include "CpuGovernor.h"
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup cpufreq
+ * @{
+ */
+
+/**
+ * Serves the CPU governor and samples the load periodically.
+ */
+class CpuFrequencyServer : public DeviceServer
+{
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param path Mount path of the server
+     */
+    CpuFrequencyServer(const char *path);
+
+    /**
+     * Initialize the server and start sampling.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result initialize();
+
+  protected:
+
+    /**
+     * Called when the sample interval expired.
+     */
+    virtual void timeout();
+
+  private:
+
+    /** Governor of the CPU frequency */
+    CpuGovernor *m_governor;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_CPUFREQ_CPUFREQUENCYSERVER_H */
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Log.h>
+#include <Atomic.h>
+#include <String.h>
+#include <CoreClient.h>
+#include <IOBuffer.h>
+#include "CpuGovernor.h"
+
+CpuGovernor::CpuGovernor(const u32 inode, CpuFrequency *frequency)
+    : Device(inode, FileSystem::CharacterDeviceFile)
+    , m_frequency(frequency)
+    , m_mode(OnDemand)
+    , m_load(0)
+    , m_cores(0)
+{
+    m_identifier << "governor";
+    m_access = FileSystem::OwnerRW | FileSystem::GroupR | FileSystem::OtherR;
+}
+
+FileSystem::Result CpuGovernor::initialize()
+{
+    const CoreClient coreClient;
+    Size numCores = 1;
+
+    const FileSystem::Result result = m_frequency->initialize();
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to initialize frequency control: result = " << (int) result);
+        return result;
+    }
+
+    if (coreClient.getCoreCount(numCores) != Core::Success)
+        numCores = 1;
+
+    // Map the ClockPage of each running core read-only
+    for (Size i = 0; i < numCores && i < MaximumCores; i++)
+    {
+        Memory::Range range;
+
+        if (coreClient.getClockPage(i, range.phys) != Core::Success)
+        {
+            ERROR("failed to find ClockPage of core" << i);
+            break;
+        }
+
+        range.virt   = ZERO;
+        range.size   = PAGESIZE;
+        range.access = Memory::User | Memory::Readable;
+
+        if (VMCtl(SELF, MapContiguous, &range) != API::Success)
+        {
+            ERROR("failed to map ClockPage of core" << i);
+            break;
+        }
+
+        m_clocks[m_cores] = (const ClockPage *) range.virt;
+        m_ticks[m_cores] = 0;
+        m_busyTicks[m_cores] = 0;
+        m_cores++;
+    }
+
+    measureLoad();
+    return FileSystem::Success;
+}
+
+FileSystem::Result CpuGovernor::read(IOBuffer & buffer,
+                                     Size & size,
+                                     const Size offset)
+{
+    String tmp;
+
+    tmp << (m_mode == Performance ? "performance" : "ondemand");
+    tmp << " " << m_frequency->getFrequency() << " " << m_load << "\n";
+
+    // Bounds checking
+    if (offset >= tmp.length())
+    {
+        size = 0;
+        return FileSystem::Success;
+    }
+
+    // How much bytes to copy?
+    const Size bytes = tmp.length() - offset > size ? size : tmp.length() - offset;
+    size = bytes;
+
+    return buffer.write(*tmp + offset, bytes);
+}
+
+FileSystem::Result CpuGovernor::write(IOBuffer & buffer,
+                                      Size & size,
+                                      const Size offset)
+{
+    char tmp[16];
+    const Size bytes = size < sizeof(tmp) - 1 ? size : sizeof(tmp) - 1;
+
+    const FileSystem::Result result = buffer.read(tmp, bytes);
+    if (result != FileSystem::Success)
+        return result;
+
+    tmp[bytes] = 0;
+
+    const String input(tmp);
+    if (input.startsWith("performance"))
+        m_mode = Performance;
+    else if (input.startsWith("ondemand"))
+        m_mode = OnDemand;
+    else
+        return FileSystem::InvalidArgument;
+
+    // Apply the new mode immediately
+    sample();
+    return FileSystem::Success;
+}
+
+void CpuGovernor::sample()
+{
+    m_load = measureLoad();
+
+    if (m_mode == Performance || m_load >= UpThreshold)
+    {
+        m_frequency->setFrequency(m_frequency->getMaximum());
+    }
+    else
+    {
+        const Size minimum = m_frequency->getMinimum();
+        const Size range = m_frequency->getMaximum() - minimum;
+
+        // Frequency proportional to the load, in MHz to avoid overflows
+        m_frequency->setFrequency(minimum + (((range / 1000000) * m_load) / 100) * 1000000);
+    }
+}
+
+Size CpuGovernor::measureLoad()
+{
+    Size load = 0;
+
+    for (Size i = 0; i < m_cores; i++)
+    {
+        const ClockPage *page = m_clocks[i];
+        u32 sequence, ticks, busyTicks;
+
+        // Retry if the kernel updated the page while reading it
+        do
+        {
+            sequence = page->sequence;
+            memoryFence(MemoryAcquire);
+
+            ticks     = page->ticks;
+            busyTicks = page->busyTicks;
+
+            memoryFence(MemoryAcquire);
+        }
+        while ((sequence & 1) || sequence != page->sequence);
+
+        // An idle core without periodic ticks does not update its page
+        const u32 elapsed = ticks - m_ticks[i];
+        const u32 busy = busyTicks - m_busyTicks[i];
+
+        if (elapsed != 0)
+        {
+            const Size coreLoad = busy >= elapsed ? 100 : (busy * 100) / elapsed;
+
+            if (coreLoad > load)
+                load = coreLoad;
+        }
+
+        m_ticks[i] = ticks;
+        m_busyTicks[i] = busyTicks;
+    }
+
+    return load;
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVER_CPUFREQ_CPUGOVERNOR_H
+#define __SERVER_CPUFREQ_CPUGOVERNOR_H
+
+#include <FreeNOS/System.h>
+#include <Types.h>
+#include <Device.h>
+#include <ClockPage.h>
+#include "CpuFrequency.h"
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup cpufreq
+ * @{
+ */
+
+/**
+ * Selects the CPU frequency from the load of the cores.
+ *
+ * The load of a core is the fraction of its timer ticks in which it did not
+ * run the idle process, as published by its kernel in the ClockPage. The
+ * shared clock follows the busiest core.
+ *
+ * Reading the device file gives the mode, the frequency in hertz and the
+ * load in percent. Writing "ondemand" or "performance" selects the mode.
+ */
+class CpuGovernor : public Device
+{
+  public:
+
+    /** Milliseconds between load samples */
+    static const Size SampleInterval = 100;
+
+    /** Milliseconds a sample may be delayed to coalesce wakeups */
+    static const Size SampleSlack = 50;
+
+  private:
+
+    /** Load in percent above which the maximum frequency is used */
+    static const Size UpThreshold = 80;
+
+    /** Maximum number of cores to sample */
+    static const Size MaximumCores = 16;
+
+  public:
+
+    /**
+     * Governor modes
+     */
+    enum Mode
+    {
+        OnDemand,
+        Performance
+    };
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param inode Inode number
+     * @param frequency Frequency control of the board
+     */
+    CpuGovernor(const u32 inode, CpuFrequency *frequency);
+
+    /**
+     * Initialize the frequency control and map the ClockPage of each core.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result initialize();
+
+    /**
+     * Read the mode, frequency and load.
+     *
+     * @param buffer Input/Output buffer to output bytes to.
+     * @param size Maximum number of bytes to read on input.
+     *             On output, the actual number of bytes read.
+     * @param offset Offset inside the file to start reading.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result read(IOBuffer & buffer,
+                                    Size & size,
+                                    const Size offset);
+
+    /**
+     * Select the mode.
+     *
+     * @param buffer Input/Output buffer to input bytes from.
+     * @param size Maximum number of bytes to write on input.
+     *             On output, the actual number of bytes written.
+     * @param offset Offset inside the file to start writing.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result write(IOBuffer & buffer,
+                                     Size & size,
+                                     const Size offset);
+
+    /**
+     * Sample the load and adjust the frequency.
+     */
+    void sample();
+
+  private:
+
+    /**
+     * Get the load of the busiest core since the previous sample.
+     *
+     * @return Load in percent
+     */
+    Size measureLoad();
+
+  private:
+
+    /** Frequency control */
+    CpuFrequency *m_frequency;
+
+    /** Current mode */
+    Mode m_mode;
+
+    /** Load in percent of the last sample */
+    Size m_load;
+
+    /** ClockPage of each core */
+    const ClockPage *m_clocks[MaximumCores];
+
+    /** Ticks of each core at the previous sample */
+    u32 m_ticks[MaximumCores];
+
+    /** Busy ticks of each core at the previous sample */
+    u32 m_busyTicks[MaximumCores];
+
+    /** Number of sampled cores */
+    Size m_cores;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_CPUFREQ_CPUGOVERNOR_H */
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Log.h>
+#include "SunxiCpuFrequency.h"
+
+template<> CpuFrequency* AbstractFactory<CpuFrequency>::create()
+{
+    return new SunxiCpuFrequency();
+}
+
+const SunxiCpuFrequency::OperatingPoint SunxiCpuFrequency::OperatingPoints[] =
+{
+    {  240000000, 1040 },
+    {  480000000, 1040 },
+    {  648000000, 1040 },
+    {  816000000, 1100 },
+    { 1008000000, 1200 }
+};
+
+const Size SunxiCpuFrequency::OperatingPointCount =
+    sizeof(SunxiCpuFrequency::OperatingPoints) / sizeof(SunxiCpuFrequency::OperatingPoint);
+
+FileSystem::Result SunxiCpuFrequency::initialize()
+{
+    Size voltage = OperatingPoints[0].voltage;
+
+    if (m_clocks.initialize() != SunxiClockControl::Success)
+    {
+        ERROR("failed to initialize clock control");
+        return FileSystem::IOError;
+    }
+
+    m_frequency = m_clocks.getRate(SunxiClockControl::ClockCpu);
+
+    // The supply voltage is at least that of the boot frequency
+    for (Size i = 0; i < OperatingPointCount; i++)
+    {
+        if (OperatingPoints[i].frequency <= m_frequency)
+            voltage = OperatingPoints[i].voltage;
+    }
+
+    for (Size i = 0; i < OperatingPointCount && OperatingPoints[i].voltage <= voltage; i++)
+        addLevel(OperatingPoints[i].frequency);
+
+    NOTICE("boot frequency " << (m_frequency / 1000000) << "MHz, maximum " <<
+           (getMaximum() / 1000000) << "MHz at " << voltage << "mV");
+    return FileSystem::Success;
+}
+
+FileSystem::Result SunxiCpuFrequency::apply(const Size hertz)
+{
+    if (m_clocks.setRate(SunxiClockControl::ClockCpu, hertz) != SunxiClockControl::Success)
+        return FileSystem::IOError;
+
+    return FileSystem::Success;
+}
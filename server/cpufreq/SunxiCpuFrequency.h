@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVER_CPUFREQ_SUNXICPUFREQUENCY_H
+#define __SERVER_CPUFREQ_SUNXICPUFREQUENCY_H
+
+#include <FreeNOS/System.h>
+#include <Types.h>
+#include <arm/sunxi/SunxiClockControl.h>
+#include "CpuFrequency.h"
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup cpufreq
+ * @{
+ */
+
+/**
+ * Allwinner H3 CPU frequency control through PLL_CPUX.
+ *
+ * Each operating point needs a minimum CPU supply voltage. There is
+ * no driver for the board regulator, thus only the operating points
+ * at or below the voltage of the boot frequency are used.
+ */
+class SunxiCpuFrequency : public CpuFrequency
+{
+  private:
+
+    /**
+     * Operating point
+     */
+    typedef struct OperatingPoint
+    {
+        /** Frequency in hertz */
+        Size frequency;
+
+        /** Minimum supply voltage in millivolts */
+        Size voltage;
+    }
+    OperatingPoint;
+
+    /** Operating points of the H3, in increasing order */
+    static const OperatingPoint OperatingPoints[];
+
+    /** Number of operating points */
+    static const Size OperatingPointCount;
+
+  public:
+
+    /**
+     * Initialize the hardware and find the frequency levels.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result initialize();
+
+  protected:
+
+    /**
+     * Program the hardware for a frequency level.
+     *
+     * @param hertz Frequency in hertz of one of the levels
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result apply(const Size hertz);
+
+  private:
+
+    /** Clock Control Unit */
+    SunxiClockControl m_clocks;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_CPUFREQ_SUNXICPUFREQUENCY_H */
@@ -18,6 +18,8 @@
 #ifndef __SERVER_DATASTORE_DATASTORE_H
 #define __SERVER_DATASTORE_DATASTORE_H
 
+#include <Types.h>
+
 /**
  * @addtogroup server
  * @{
@@ -33,7 +35,12 @@ namespace Datastore
      */
     enum Action
     {
-        RegisterBuffer = 1
+        RegisterBuffer = 1,
+        MapValues,
+        SetValue,
+        CreateSegment,
+        AttachSegment,
+        RemoveSegment
     };
 
     /**
@@ -44,8 +51,45 @@ namespace Datastore
         Success = 0,
         IOError,
         InvalidArgument,
-        IpcError
+        IpcError,
+        NotFound,
+        AlreadyExists,
+        PermissionDenied
     };
+
+    /** Maximum number of shared values */
+    static const Size MaximumValues = 64;
+
+    /** Maximum size of a shared value in bytes */
+    static const Size MaximumValueSize = 48;
+
+    /**
+     * Shared value.
+     *
+     * The sequence number is odd while the server updates the value.
+     * Readers retry until they observe the same even sequence number
+     * before and after reading the other fields.
+     */
+    typedef struct Value
+    {
+        volatile u32 sequence;          /**< Incremented before and after each update */
+        u32 size;                       /**< Number of bytes in the data */
+        char key[32];                   /**< Key of the value or empty if unused */
+        u8 data[MaximumValueSize];      /**< Value data */
+    }
+    Value;
+
+    /**
+     * Table of shared values.
+     *
+     * Written only by the server and mapped read-only in readers.
+     * Used entries are never released and come before unused entries.
+     */
+    typedef struct ValueTable
+    {
+        Value values[MaximumValues];
+    }
+    ValueTable;
 }
 
 /**
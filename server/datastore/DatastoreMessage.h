@@ -20,6 +20,7 @@
 
 #include <Types.h>
 #include <ChannelMessage.h>
+#include <Memory.h>
 #include "Datastore.h"
 
 /**
@@ -41,6 +42,8 @@ typedef struct DatastoreMessage : public ChannelMessage
     char key[32];             /**< Key specifies the buffer to use */
     Size size;                /**< Size of the buffer */
     Address address;          /**< Address of mapped buffer inside client process */
+    Memory::Access access;    /**< Access to a shared memory segment */
+    u8 value[Datastore::MaximumValueSize]; /**< Data of a shared value */
 }
 DatastoreMessage;
 
@@ -16,13 +16,23 @@
  */
 
 #include <Assert.h>
+#include <Atomic.h>
+#include <MemoryBlock.h>
 #include "DatastoreServer.h"
 
 DatastoreServer::DatastoreServer()
     : ChannelServer<DatastoreServer, DatastoreMessage>(this)
     , m_buffers()
+    , m_values(ZERO)
+    , m_valuesPhys(0)
+    , m_segments()
 {
     addIPCHandler(Datastore::RegisterBuffer, &DatastoreServer::registerBuffer);
+    addIPCHandler(Datastore::MapValues, &DatastoreServer::mapValues);
+    addIPCHandler(Datastore::SetValue, &DatastoreServer::setValue);
+    addIPCHandler(Datastore::CreateSegment, &DatastoreServer::createSegment);
+    addIPCHandler(Datastore::AttachSegment, &DatastoreServer::attachSegment);
+    addIPCHandler(Datastore::RemoveSegment, &DatastoreServer::removeSegment);
 }
 
 HashTable<String, Address> * DatastoreServer::getBufferTable(const ProcessID pid)
@@ -111,3 +121,245 @@ void DatastoreServer::registerBuffer(DatastoreMessage *msg)
     DEBUG("mapped `" << msg->key << "' for PID " << msg->from << " at " <<
            (void *) msg->address << " / " << (void *) range.phys);
 }
+
+Datastore::ValueTable * DatastoreServer::getValueTable()
+{
+    if (m_values != ZERO)
+    {
+        return m_values;
+    }
+
+    Memory::Range range;
+    range.virt = 0;
+    range.phys = 0;
+    range.size = sizeof(Datastore::ValueTable);
+    range.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    const API::Result mapResult = VMCtl(SELF, MapContiguous, &range);
+    if (mapResult != API::Success)
+    {
+        ERROR("failed to allocate shared value table: " << (int) mapResult);
+        return ZERO;
+    }
+
+    m_values = (Datastore::ValueTable *) range.virt;
+    m_valuesPhys = range.phys;
+    MemoryBlock::set(m_values, 0, sizeof(Datastore::ValueTable));
+
+    return m_values;
+}
+
+void DatastoreServer::mapValues(DatastoreMessage *msg)
+{
+    if (!getValueTable())
+    {
+        msg->result = Datastore::IOError;
+        return;
+    }
+
+    Memory::Range range;
+    range.virt = 0;
+    range.phys = m_valuesPhys;
+    range.size = sizeof(Datastore::ValueTable);
+    range.access = Memory::User | Memory::Readable;
+
+    const API::Result mapResult = VMCtl(msg->from, MapContiguous, &range);
+    if (mapResult != API::Success)
+    {
+        ERROR("failed to map shared value table in PID " << msg->from << ": " << (int) mapResult);
+        msg->result = Datastore::IOError;
+        return;
+    }
+
+    msg->address = range.virt;
+    msg->result  = Datastore::Success;
+}
+
+void DatastoreServer::setValue(DatastoreMessage *msg)
+{
+    Datastore::ValueTable *table = getValueTable();
+    Datastore::Value *value = ZERO;
+
+    if (!table)
+    {
+        msg->result = Datastore::IOError;
+        return;
+    }
+
+    // Enforce NULL-terminated string for the key
+    msg->key[sizeof(msg->key) - 1] = 0;
+
+    if (msg->key[0] == 0 || msg->size > Datastore::MaximumValueSize)
+    {
+        msg->result = Datastore::InvalidArgument;
+        return;
+    }
+
+    // Find the existing entry or the first unused one
+    for (Size i = 0; i < Datastore::MaximumValues; i++)
+    {
+        Datastore::Value *entry = &table->values[i];
+
+        if (entry->key[0] == 0 || MemoryBlock::compare(entry->key, msg->key))
+        {
+            value = entry;
+            break;
+        }
+    }
+
+    if (!value)
+    {
+        ERROR("no free entry for value `" << msg->key << "'");
+        msg->result = Datastore::IOError;
+        return;
+    }
+
+    // Readers retry while the sequence number is odd or changed
+    value->sequence++;
+    memoryFence(MemoryRelease);
+
+    MemoryBlock::copy(value->key, msg->key, sizeof(value->key));
+    MemoryBlock::copy(value->data, msg->value, msg->size);
+    value->size = msg->size;
+
+    memoryFence(MemoryRelease);
+    value->sequence++;
+
+    msg->result = Datastore::Success;
+}
+
+void DatastoreServer::createSegment(DatastoreMessage *msg)
+{
+    // Enforce NULL-terminated string for the key
+    msg->key[sizeof(msg->key) - 1] = 0;
+
+    if (msg->key[0] == 0 || msg->size == 0 || msg->size > MaximumSegmentSize)
+    {
+        msg->result = Datastore::InvalidArgument;
+        return;
+    }
+
+    if (m_segments.get(msg->key) != ZERO)
+    {
+        msg->result = Datastore::AlreadyExists;
+        return;
+    }
+
+    Segment *segment = new Segment;
+    if (!segment)
+    {
+        msg->result = Datastore::IOError;
+        return;
+    }
+
+    segment->owner = msg->from;
+    segment->access = (Memory::Access) (msg->access & (Memory::Readable | Memory::Writable));
+    segment->range.virt = 0;
+    segment->range.phys = 0;
+    segment->range.size = (msg->size + PAGESIZE - 1) & PAGEMASK;
+    segment->range.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    // The server keeps a mapping, such that the segment lives until removed
+    const API::Result mapResult = VMCtl(SELF, MapContiguous, &segment->range);
+    if (mapResult != API::Success)
+    {
+        ERROR("failed to allocate segment `" << msg->key << "' of " <<
+               segment->range.size << " bytes: " << (int) mapResult);
+        delete segment;
+        msg->result = Datastore::IOError;
+        return;
+    }
+
+    MemoryBlock::set((void *) segment->range.virt, 0, segment->range.size);
+
+    if (!m_segments.insert(msg->key, segment))
+    {
+        ERROR("failed to add segment `" << msg->key << "'");
+        VMCtl(SELF, Release, &segment->range);
+        delete segment;
+        msg->result = Datastore::IOError;
+        return;
+    }
+
+    mapSegment(msg, segment, (Memory::Access) (Memory::Readable | Memory::Writable));
+}
+
+void DatastoreServer::attachSegment(DatastoreMessage *msg)
+{
+    const Memory::Access access = (Memory::Access) (msg->access & (Memory::Readable | Memory::Writable));
+
+    // Enforce NULL-terminated string for the key
+    msg->key[sizeof(msg->key) - 1] = 0;
+
+    Segment * const *segment = m_segments.get(msg->key);
+    if (segment == ZERO)
+    {
+        msg->result = Datastore::NotFound;
+        return;
+    }
+
+    if (!(access & Memory::Readable))
+    {
+        msg->result = Datastore::InvalidArgument;
+        return;
+    }
+
+    if (msg->from != (*segment)->owner && (access & ~(*segment)->access))
+    {
+        msg->result = Datastore::PermissionDenied;
+        return;
+    }
+
+    mapSegment(msg, *segment, access);
+}
+
+void DatastoreServer::removeSegment(DatastoreMessage *msg)
+{
+    // Enforce NULL-terminated string for the key
+    msg->key[sizeof(msg->key) - 1] = 0;
+
+    Segment * const *entry = m_segments.get(msg->key);
+    if (entry == ZERO)
+    {
+        msg->result = Datastore::NotFound;
+        return;
+    }
+
+    Segment *segment = *entry;
+    if (msg->from != segment->owner)
+    {
+        msg->result = Datastore::PermissionDenied;
+        return;
+    }
+
+    // Attached processes keep their own reference to the memory
+    VMCtl(SELF, Release, &segment->range);
+    m_segments.remove(msg->key);
+    delete segment;
+
+    msg->result = Datastore::Success;
+}
+
+void DatastoreServer::mapSegment(DatastoreMessage *msg,
+                                 const Segment *segment,
+                                 const Memory::Access access)
+{
+    Memory::Range range;
+    range.virt = 0;
+    range.phys = segment->range.phys;
+    range.size = segment->range.size;
+    range.access = Memory::User | access;
+
+    const API::Result mapResult = VMCtl(msg->from, MapShared, &range);
+    if (mapResult != API::Success)
+    {
+        ERROR("failed to map segment `" << msg->key << "' in PID " << msg->from <<
+              ": " << (int) mapResult);
+        msg->result = Datastore::IOError;
+        return;
+    }
+
+    msg->address = range.virt;
+    msg->size    = range.size;
+    msg->result  = Datastore::Success;
+}
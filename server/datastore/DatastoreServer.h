@@ -38,6 +38,16 @@
  * Datastore Server
  *
  * Provides a key/value in-memory based data storage that can be used system wide.
+ *
+ * Small values which are read often are kept in a shared table instead.
+ * Readers map the table once and read values without IPC, while
+ * the server performs all updates.
+ *
+ * Named shared memory segments are physically contiguous and mapped with
+ * large pages where the size allows. Any process may attach a segment
+ * with the access its creator granted. Each mapping holds a reference to
+ * the memory, such that a removed segment stays valid for the processes
+ * which attached it until they detach.
  */
 class DatastoreServer : public ChannelServer<DatastoreServer, DatastoreMessage>
 {
@@ -46,6 +56,19 @@ class DatastoreServer : public ChannelServer<DatastoreServer, DatastoreMessage>
     /** Maximum size of a single buffer */
     static const Size MaximumBufferSize = KiloByte(256);
 
+    /** Maximum size of a shared memory segment */
+    static const Size MaximumSegmentSize = MegaByte(64);
+
+    /**
+     * Named shared memory segment.
+     */
+    struct Segment
+    {
+        ProcessID owner;        /**< Process which created the segment */
+        Memory::Access access;  /**< Access granted to other processes */
+        Memory::Range range;    /**< Mapping of the segment in the server */
+    };
+
   public:
 
     /**
@@ -71,10 +94,72 @@ class DatastoreServer : public ChannelServer<DatastoreServer, DatastoreMessage>
      */
     void registerBuffer(DatastoreMessage *msg);
 
+    /**
+     * Retrieve the shared value table.
+     *
+     * @return Pointer to the table on success, ZERO on failure.
+     */
+    Datastore::ValueTable * getValueTable();
+
+    /**
+     * Map the shared value table read-only in the client.
+     *
+     * @param msg DatastoreMessage pointer
+     */
+    void mapValues(DatastoreMessage *msg);
+
+    /**
+     * Add or update a shared value.
+     *
+     * @param msg DatastoreMessage pointer
+     */
+    void setValue(DatastoreMessage *msg);
+
+    /**
+     * Create a shared memory segment and attach it to the creator.
+     *
+     * @param msg DatastoreMessage pointer
+     */
+    void createSegment(DatastoreMessage *msg);
+
+    /**
+     * Attach a shared memory segment.
+     *
+     * @param msg DatastoreMessage pointer
+     */
+    void attachSegment(DatastoreMessage *msg);
+
+    /**
+     * Remove a shared memory segment.
+     *
+     * @param msg DatastoreMessage pointer
+     */
+    void removeSegment(DatastoreMessage *msg);
+
+    /**
+     * Map a shared memory segment in the client.
+     *
+     * @param msg DatastoreMessage pointer
+     * @param segment Segment to map
+     * @param access Access of the client to the segment
+     */
+    void mapSegment(DatastoreMessage *msg,
+                    const Segment *segment,
+                    const Memory::Access access);
+
   private:
 
     /** Per-process hash table with key to buffers mapping. */
     HashTable<ProcessID, HashTable<String, Address> *> m_buffers;
+
+    /** Shared value table */
+    Datastore::ValueTable *m_values;
+
+    /** Physical address of the shared value table */
+    Address m_valuesPhys;
+
+    /** Shared memory segments by name */
+    HashTable<String, Segment *> m_segments;
 };
 
 /**
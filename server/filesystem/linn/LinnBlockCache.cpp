@@ -0,0 +1,640 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Assert.h>
+#include <Log.h>
+#include <MemoryBlock.h>
+#include "LinnBlockCache.h"
+
+LinnBlockCache::LinnBlockCache(Storage *storage,
+                               const Size blockSize,
+                               const Size cacheSize)
+    : m_storage(storage)
+    , m_blockSize(blockSize)
+    , m_count(cacheSize / blockSize)
+    , m_queue(storage)
+    , m_pending(0)
+    , m_fetchCallback(this, &LinnBlockCache::fetchDone)
+    , m_readyCallback(ZERO)
+    , m_writeCallback(this, &LinnBlockCache::writeDone)
+    , m_dirty(0)
+    , m_written(0)
+    , m_map(cacheSize / blockSize)
+    , m_head(ZERO)
+    , m_tail(ZERO)
+    , m_hits(0)
+    , m_misses(0)
+    , m_readAhead(0)
+{
+    assert(m_count > 0);
+
+    m_blocks = new Block[m_count];
+    assert(m_blocks != NULL);
+
+    m_data = new u8[m_count * m_blockSize];
+    assert(m_data != NULL);
+
+    m_readBuffer = new u8[MaximumReadAhead * m_blockSize];
+    assert(m_readBuffer != NULL);
+
+    m_fetchData = new u8[MaximumFetches * MaximumReadAhead * m_blockSize];
+    assert(m_fetchData != NULL);
+
+    m_writes = new Storage::Request[m_count];
+    assert(m_writes != NULL);
+
+    // Initially all blocks are unused and linked in the LRU list
+    for (Size i = 0; i < m_count; i++)
+    {
+        m_blocks[i].number  = 0;
+        m_blocks[i].valid   = false;
+        m_blocks[i].pending = false;
+        m_blocks[i].dirty   = false;
+        m_blocks[i].data    = m_data + (i * m_blockSize);
+        m_blocks[i].prev    = i > 0 ? &m_blocks[i - 1] : ZERO;
+        m_blocks[i].next    = i < m_count - 1 ? &m_blocks[i + 1] : ZERO;
+    }
+
+    m_head = &m_blocks[0];
+    m_tail = &m_blocks[m_count - 1];
+
+    for (Size i = 0; i < MaximumFetches; i++)
+    {
+        m_fetches[i].active = false;
+        m_fetches[i].count  = 0;
+        m_fetches[i].request.buffer = m_fetchData + (i * MaximumReadAhead * m_blockSize);
+    }
+}
+
+LinnBlockCache::~LinnBlockCache()
+{
+    flush();
+    m_queue.wait();
+
+    delete[] m_writes;
+    delete[] m_fetchData;
+    delete[] m_readBuffer;
+    delete[] m_data;
+    delete[] m_blocks;
+}
+
+FileSystem::Result LinnBlockCache::read(const u64 offset,
+                                        void *buffer,
+                                        const Size size,
+                                        const Size readAhead)
+{
+    u8 *dst = (u8 *) buffer;
+    u64 current = offset;
+    Size remaining = size;
+    Size ahead = readAhead;
+
+    while (remaining > 0)
+    {
+        const u32 number = current / m_blockSize;
+        const Size blockOffset = current % m_blockSize;
+        const Size bytes = remaining < m_blockSize - blockOffset ?
+                           remaining : m_blockSize - blockOffset;
+        Block *block = ZERO;
+
+        Block * const *cached = m_map.get(number);
+        if (cached != ZERO && (*cached)->pending)
+        {
+            // Complete the asynchronous fetch first
+            if (m_queue.wait() != FileSystem::Success)
+            {
+                return FileSystem::IOError;
+            }
+            continue;
+        }
+        else if (cached != ZERO && (*cached)->valid)
+        {
+            block = *cached;
+            touch(block);
+            m_hits++;
+        }
+        else
+        {
+            // Fetch at least the blocks needed to complete this read
+            const Size needed = (blockOffset + remaining + m_blockSize - 1) / m_blockSize;
+
+            block = fetch(number, ahead > needed ? ahead : needed);
+            if (block == ZERO)
+            {
+                return FileSystem::IOError;
+            }
+            m_misses++;
+        }
+
+        MemoryBlock::copy(dst, block->data + blockOffset, bytes);
+
+        dst       += bytes;
+        current   += bytes;
+        remaining -= bytes;
+        ahead      = ahead > 1 ? ahead - 1 : 1;
+    }
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result LinnBlockCache::tryRead(const u64 offset,
+                                           void *buffer,
+                                           Size & size,
+                                           const Size readAhead)
+{
+    u8 *dst = (u8 *) buffer;
+    u64 current = offset;
+    Size copied = 0;
+    Size ahead = readAhead;
+
+    while (copied < size)
+    {
+        const u32 number = current / m_blockSize;
+        const Size blockOffset = current % m_blockSize;
+        const Size bytes = size - copied < m_blockSize - blockOffset ?
+                           size - copied : m_blockSize - blockOffset;
+
+        Block * const *cached = m_map.get(number);
+        if (cached == ZERO)
+        {
+            const Size needed = (blockOffset + (size - copied) + m_blockSize - 1) / m_blockSize;
+            const Size wanted = ahead > needed ? ahead : needed;
+            Size fetched = 0;
+            const FileSystem::Result result = startFetch(number, wanted, fetched);
+            m_misses++;
+
+            if (result == FileSystem::RetryAgain)
+            {
+                // Fetch the rest of the run too, which the StorageQueue merges into large transfers
+                Size done = fetched, more = 0;
+
+                while (fetched > 0 && done < wanted && m_map.get(number + done) == ZERO &&
+                       startFetch(number + done, wanted - done, more) == FileSystem::RetryAgain &&
+                       more > 0)
+                {
+                    done += more;
+                }
+            }
+
+            if (result != FileSystem::Success)
+            {
+                size = copied;
+                return result;
+            }
+            cached = m_map.get(number);
+            assert(cached != ZERO);
+        }
+        else if ((*cached)->pending)
+        {
+            size = copied;
+            return FileSystem::RetryAgain;
+        }
+        else if (!(*cached)->valid)
+        {
+            // Report the failed fetch once, the next read tries again
+            m_map.remove(number);
+            size = copied;
+            return FileSystem::IOError;
+        }
+        else
+        {
+            m_hits++;
+        }
+
+        Block *block = *cached;
+        touch(block);
+        MemoryBlock::copy(dst, block->data + blockOffset, bytes);
+
+        dst     += bytes;
+        current += bytes;
+        copied  += bytes;
+        ahead    = ahead > 1 ? ahead - 1 : 1;
+    }
+
+    size = copied;
+    return FileSystem::Success;
+}
+
+FileSystem::Result LinnBlockCache::write(const u64 offset,
+                                         const void *buffer,
+                                         const Size size)
+{
+    const u8 *src = (const u8 *) buffer;
+    u64 current = offset;
+    Size remaining = size;
+
+    while (remaining > 0)
+    {
+        const u32 number = current / m_blockSize;
+        const Size blockOffset = current % m_blockSize;
+        const Size bytes = remaining < m_blockSize - blockOffset ?
+                           remaining : m_blockSize - blockOffset;
+        Block *block = ZERO;
+
+        // Keep most of the cache available for reading
+        if (m_dirty >= m_count / 4 && flush() != FileSystem::Success)
+        {
+            return FileSystem::IOError;
+        }
+
+        Block * const *cached = m_map.get(number);
+        if (cached != ZERO && (*cached)->pending)
+        {
+            // The fetched data must not overwrite the new data
+            if (m_queue.wait() != FileSystem::Success)
+            {
+                return FileSystem::IOError;
+            }
+            continue;
+        }
+        else if (cached != ZERO && (*cached)->valid)
+        {
+            block = *cached;
+            touch(block);
+        }
+        else if (bytes == m_blockSize)
+        {
+            // Blocks which are overwritten completely need not be read first
+            if ((u64) (number + 1) * m_blockSize > m_storage->capacity())
+            {
+                ERROR("block " << number << " is outside storage capacity");
+                return FileSystem::IOError;
+            }
+            block = allocate(number);
+            block->valid = true;
+        }
+        else
+        {
+            block = fetch(number, 1);
+            if (block == ZERO)
+            {
+                return FileSystem::IOError;
+            }
+            m_misses++;
+        }
+
+        MemoryBlock::copy(block->data + blockOffset, src, bytes);
+
+        if (!block->dirty)
+        {
+            block->dirty = true;
+            m_dirty++;
+        }
+
+        src       += bytes;
+        current   += bytes;
+        remaining -= bytes;
+    }
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result LinnBlockCache::flush()
+{
+    const u64 capacity = m_storage->capacity();
+
+    if (m_dirty == 0)
+    {
+        return FileSystem::Success;
+    }
+
+    // Submit all dirty blocks at once, such that the queue can sort and merge them
+    for (Size i = 0; i < m_count; i++)
+    {
+        Block *block = &m_blocks[i];
+        Storage::Request *req = &m_writes[i];
+        const u64 offset = (u64) block->number * m_blockSize;
+
+        if (!block->dirty)
+        {
+            continue;
+        }
+
+        req->operation = Storage::Write;
+        req->offset    = offset;
+        req->buffer    = block->data;
+        req->size      = offset + m_blockSize > capacity ? capacity - offset : m_blockSize;
+        req->result    = FileSystem::Success;
+        req->callback  = &m_writeCallback;
+
+        const FileSystem::Result result = m_queue.submit(req);
+        if (result != FileSystem::Success)
+        {
+            ERROR("failed to submit write of block " << block->number << ": result = " << (int) result);
+            break;
+        }
+    }
+
+    // Dirty blocks are referenced by the requests until written
+    const FileSystem::Result result = m_queue.wait();
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+
+    return m_dirty == 0 ? FileSystem::Success : FileSystem::IOError;
+}
+
+void LinnBlockCache::setReadyCallback(CallbackFunction *callback)
+{
+    m_readyCallback = callback;
+}
+
+Size LinnBlockCache::getHits() const
+{
+    return m_hits;
+}
+
+Size LinnBlockCache::getMisses() const
+{
+    return m_misses;
+}
+
+Size LinnBlockCache::getReadAhead() const
+{
+    return m_readAhead;
+}
+
+Size LinnBlockCache::getMerged() const
+{
+    return m_queue.getMerged();
+}
+
+Size LinnBlockCache::getDirty() const
+{
+    return m_dirty;
+}
+
+Size LinnBlockCache::getWritten() const
+{
+    return m_written;
+}
+
+LinnBlockCache::Block * LinnBlockCache::fetch(const u32 number, const Size count)
+{
+    u64 bytes = 0;
+    const Size num = fetchCount(number, count, bytes);
+    if (num == 0)
+    {
+        ERROR("block " << number << " is outside storage capacity");
+        return ZERO;
+    }
+
+    // Synchronous transfers must not overlap with asynchronous requests
+    if (m_queue.isBusy() && m_queue.wait() != FileSystem::Success)
+    {
+        return ZERO;
+    }
+
+    const FileSystem::Result result = m_storage->read((u64) number * m_blockSize,
+                                                      m_readBuffer, bytes);
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to read block " << number << ": result = " << (int) result);
+        return ZERO;
+    }
+
+    // Store the blocks in the least recently used entries.
+    // Insert in reverse, such that the requested block ends up most recently used.
+    for (Size i = num; i > 0; i--)
+    {
+        Block *block = allocate(number + i - 1);
+
+        MemoryBlock::copy(block->data, m_readBuffer + ((i - 1) * m_blockSize), m_blockSize);
+        block->valid = true;
+    }
+
+    m_readAhead += num - 1;
+    return m_head;
+}
+
+FileSystem::Result LinnBlockCache::startFetch(const u32 number,
+                                              const Size count,
+                                              Size & fetched)
+{
+    Fetch *fetch = ZERO;
+    u64 bytes = 0;
+
+    fetched = 0;
+
+    for (Size i = 0; i < MaximumFetches && fetch == ZERO; i++)
+    {
+        if (!m_fetches[i].active)
+        {
+            fetch = &m_fetches[i];
+        }
+    }
+
+    // Keep at least half of the cache available for other blocks
+    const Size available = m_count / 2 > m_pending ? (m_count / 2) - m_pending : 0;
+    if (fetch == ZERO || available == 0)
+    {
+        return FileSystem::RetryAgain;
+    }
+
+    const Size num = fetchCount(number, count < available ? count : available, bytes);
+    if (num == 0)
+    {
+        ERROR("block " << number << " is outside storage capacity");
+        return FileSystem::IOError;
+    }
+
+    // Reserve the blocks. Insert in reverse, such that the requested block ends up most recently used.
+    for (Size i = num; i > 0; i--)
+    {
+        Block *block = allocate(number + i - 1);
+        block->pending = true;
+        fetch->blocks[i - 1] = block;
+    }
+
+    fetched                  = num;
+    fetch->active            = true;
+    fetch->count             = num;
+    fetch->request.operation = Storage::Read;
+    fetch->request.offset    = (u64) number * m_blockSize;
+    fetch->request.size      = bytes;
+    fetch->request.result    = FileSystem::Success;
+    fetch->request.callback  = &m_fetchCallback;
+    m_pending += num;
+
+    const FileSystem::Result result = m_queue.submit(&fetch->request);
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to submit read of block " << number << ": result = " << (int) result);
+        fetch->request.result = result;
+        fetchDone(&fetch->request);
+    }
+
+    // The fetch may have completed already
+    if (fetch->active)
+    {
+        return FileSystem::RetryAgain;
+    }
+    else if (fetch->request.result != FileSystem::Success)
+    {
+        for (Size i = 0; i < num; i++)
+        {
+            m_map.remove(fetch->blocks[i]->number);
+        }
+    }
+    return fetch->request.result;
+}
+
+void LinnBlockCache::fetchDone(Storage::Request *req)
+{
+    Fetch *fetch = ZERO;
+
+    for (Size i = 0; i < MaximumFetches && fetch == ZERO; i++)
+    {
+        if (m_fetches[i].active && &m_fetches[i].request == req)
+        {
+            fetch = &m_fetches[i];
+        }
+    }
+    assert(fetch != ZERO);
+
+    if (req->result != FileSystem::Success)
+    {
+        ERROR("failed to read block " << (Size) (req->offset / m_blockSize) <<
+              ": result = " << (int) req->result);
+    }
+    else
+    {
+        m_readAhead += fetch->count - 1;
+    }
+
+    // Failed blocks stay invalid in the map, such that tryRead() reports the error
+    for (Size i = 0; i < fetch->count; i++)
+    {
+        Block *block = fetch->blocks[i];
+
+        if (req->result == FileSystem::Success)
+        {
+            MemoryBlock::copy(block->data, req->buffer + (i * m_blockSize), m_blockSize);
+            block->valid = true;
+        }
+        block->pending = false;
+    }
+
+    m_pending -= fetch->count;
+    fetch->active = false;
+
+    if (m_readyCallback)
+    {
+        m_readyCallback->execute(this);
+    }
+}
+
+void LinnBlockCache::writeDone(Storage::Request *req)
+{
+    Block *block = &m_blocks[req - m_writes];
+
+    // Failed blocks stay dirty, such that the next flush tries again
+    if (req->result != FileSystem::Success)
+    {
+        ERROR("failed to write block " << block->number << ": result = " << (int) req->result);
+        return;
+    }
+
+    block->dirty = false;
+    m_dirty--;
+    m_written++;
+}
+
+Size LinnBlockCache::fetchCount(const u32 number, const Size count, u64 & bytes) const
+{
+    const u64 capacity = m_storage->capacity();
+    Size num = 1;
+
+    if ((u64) number * m_blockSize >= capacity)
+    {
+        return 0;
+    }
+
+    // Limit to blocks not yet cached and inside the storage capacity
+    while (num < count && num < MaximumReadAhead && num < m_count &&
+           ((u64) (number + num + 1) * m_blockSize) <= capacity &&
+           m_map.get(number + num) == ZERO)
+    {
+        num++;
+    }
+
+    // The last block in storage may be partial
+    bytes = (u64) num * m_blockSize;
+    if ((u64) number * m_blockSize + bytes > capacity)
+    {
+        bytes = capacity - ((u64) number * m_blockSize);
+    }
+
+    return num;
+}
+
+LinnBlockCache::Block * LinnBlockCache::allocate(const u32 number)
+{
+    Block *block = m_tail;
+
+    // Blocks of fetches in flight and modified blocks cannot be replaced
+    while (block->pending || block->dirty)
+    {
+        block = block->prev;
+        assert(block != ZERO);
+    }
+
+    // Remove the previous mapping, unless it was replaced already
+    Block * const *mapped = m_map.get(block->number);
+    if (mapped != ZERO && *mapped == block)
+    {
+        m_map.remove(block->number);
+    }
+
+    block->number = number;
+    block->valid  = false;
+
+    m_map.insert(number, block);
+    touch(block);
+    return block;
+}
+
+void LinnBlockCache::touch(Block *block)
+{
+    if (block == m_head)
+    {
+        return;
+    }
+
+    unlink(block);
+
+    block->prev = ZERO;
+    block->next = m_head;
+    m_head->prev = block;
+    m_head = block;
+}
+
+void LinnBlockCache::unlink(Block *block)
+{
+    if (block->prev)
+        block->prev->next = block->next;
+    else
+        m_head = block->next;
+
+    if (block->next)
+        block->next->prev = block->prev;
+    else
+        m_tail = block->prev;
+
+    block->prev = ZERO;
+    block->next = ZERO;
+}
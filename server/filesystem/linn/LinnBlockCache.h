@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FILESYSTEM_LINN_BLOCKCACHE_H
+#define __FILESYSTEM_LINN_BLOCKCACHE_H
+
+#include <Types.h>
+#include <Callback.h>
+#include <HashTable.h>
+#include <Storage.h>
+#include <StorageQueue.h>
+#include <FileSystem.h>
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup linnfs
+ * @{
+ */
+
+/**
+ * @brief Bounded LRU cache of storage blocks for LinnFS.
+ *
+ * All data and metadata reads of the LinnFileSystem are done through
+ * the block cache. On a miss, the cache can read ahead a number of following
+ * blocks using a single sequential Storage read, which is typically much cheaper
+ * than reading each block separately (e.g. on ATA PIO devices).
+ *
+ * Misses of tryRead() are fetched asynchronously through a StorageQueue,
+ * such that the file system can continue serving cached blocks while
+ * the storage transfers are in flight.
+ *
+ * Writes modify the cached blocks only. Dirty blocks stay in the cache
+ * until flush() writes them back at once, which lets the StorageQueue
+ * merge neighbouring blocks into large transfers.
+ */
+class LinnBlockCache
+{
+  private:
+
+    /** Maximum number of blocks to read from Storage in a single request */
+    static const Size MaximumReadAhead = 16;
+
+    /** Maximum number of asynchronous fetches in flight */
+    static const Size MaximumFetches = 4;
+
+    /**
+     * Cached block of storage.
+     */
+    struct Block
+    {
+        u32 number;     /**@< Block number in storage */
+        bool valid;     /**@< True if the block data is valid */
+        bool pending;   /**@< True while the block is fetched asynchronously */
+        bool dirty;     /**@< True if the block is modified and not yet written back */
+        u8 *data;       /**@< Block data */
+        Block *prev;    /**@< More recently used block */
+        Block *next;    /**@< Less recently used block */
+    };
+
+    /**
+     * Asynchronous fetch of contiguous blocks.
+     */
+    struct Fetch
+    {
+        bool active;                        /**@< True while the request is in flight */
+        Storage::Request request;           /**@< Storage request */
+        Size count;                         /**@< Number of blocks fetched */
+        Block *blocks[MaximumReadAhead];    /**@< Reserved blocks, in storage order */
+    };
+
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param storage Storage to read blocks from.
+     * @param blockSize Size of each block in bytes.
+     * @param cacheSize Total size of the cache in bytes.
+     */
+    LinnBlockCache(Storage *storage,
+                   const Size blockSize,
+                   const Size cacheSize);
+
+    /**
+     * Destructor.
+     */
+    ~LinnBlockCache();
+
+    /**
+     * Read a contiguous set of data.
+     *
+     * @param offset Offset in storage to start reading from.
+     * @param buffer Output buffer.
+     * @param size Number of bytes to copy.
+     * @param readAhead Number of contiguous blocks in storage starting at
+     *                  the given offset which belong to the same object.
+     *                  On a miss, these blocks are fetched into the cache at once.
+     *
+     * @return Result code
+     */
+    FileSystem::Result read(const u64 offset,
+                            void *buffer,
+                            const Size size,
+                            const Size readAhead = 1);
+
+    /**
+     * Read a contiguous set of data without blocking.
+     *
+     * Copies data until the first block which is not cached. That
+     * block is fetched asynchronously, together with the read-ahead
+     * blocks, and the ready callback is executed once it arrives.
+     *
+     * @param offset Offset in storage to start reading from.
+     * @param buffer Output buffer.
+     * @param size Number of bytes to copy on input, number of bytes copied on output.
+     * @param readAhead Number of contiguous blocks in storage starting at
+     *                  the given offset which belong to the same object.
+     *
+     * @return Result code, where RetryAgain indicates that not all data was copied yet
+     */
+    FileSystem::Result tryRead(const u64 offset,
+                               void *buffer,
+                               Size & size,
+                               const Size readAhead = 1);
+
+    /**
+     * Write a contiguous set of data.
+     *
+     * The data is written back to storage later by flush(). Blocks
+     * which are overwritten completely are not read from storage. When
+     * too many blocks are dirty, they are flushed first.
+     *
+     * @param offset Offset in storage to start writing to.
+     * @param buffer Input buffer.
+     * @param size Number of bytes to write.
+     *
+     * @return Result code
+     */
+    FileSystem::Result write(const u64 offset,
+                             const void *buffer,
+                             const Size size);
+
+    /**
+     * Write all dirty blocks back to storage.
+     *
+     * @return Result code
+     */
+    FileSystem::Result flush();
+
+    /**
+     * Set the callback for completed asynchronous fetches.
+     *
+     * @param callback Executed with the LinnBlockCache as parameter
+     */
+    void setReadyCallback(CallbackFunction *callback);
+
+    /**
+     * Get number of cache hits.
+     *
+     * @return Number of blocks found in the cache
+     */
+    Size getHits() const;
+
+    /**
+     * Get number of cache misses.
+     *
+     * @return Number of blocks not found in the cache
+     */
+    Size getMisses() const;
+
+    /**
+     * Get number of blocks read ahead.
+     *
+     * @return Number of blocks fetched before they were requested
+     */
+    Size getReadAhead() const;
+
+    /**
+     * Get number of storage requests merged by the StorageQueue.
+     *
+     * @return Number of merged requests
+     */
+    Size getMerged() const;
+
+    /**
+     * Get number of dirty blocks.
+     *
+     * @return Number of modified blocks not yet written back
+     */
+    Size getDirty() const;
+
+    /**
+     * Get number of blocks written back.
+     *
+     * @return Number of blocks written to storage
+     */
+    Size getWritten() const;
+
+  private:
+
+    /**
+     * Fetch blocks from storage into the cache.
+     *
+     * @param number First block number to fetch
+     * @param count Number of contiguous blocks to fetch
+     *
+     * @return Block pointer of the first block or ZERO on failure
+     */
+    Block * fetch(const u32 number, const Size count);
+
+    /**
+     * Start fetching blocks from storage asynchronously.
+     *
+     * @param number First block number to fetch
+     * @param count Number of contiguous blocks to fetch
+     * @param fetched Number of blocks of the started fetch on output, or zero
+     *
+     * @return Success if the blocks were fetched immediately, RetryAgain
+     *         if the fetch is in flight or cannot start yet, or an error code
+     */
+    FileSystem::Result startFetch(const u32 number, const Size count, Size & fetched);
+
+    /**
+     * Called when an asynchronous fetch is completed.
+     *
+     * @param req Storage request of the fetch
+     */
+    void fetchDone(Storage::Request *req);
+
+    /**
+     * Called when a dirty block is written back.
+     *
+     * @param req Storage request of the block
+     */
+    void writeDone(Storage::Request *req);
+
+    /**
+     * Count the blocks to fetch at once.
+     *
+     * @param number First block number to fetch
+     * @param count Number of contiguous blocks requested
+     * @param bytes Number of bytes to read from storage on output
+     *
+     * @return Number of blocks to fetch or zero if outside storage capacity
+     */
+    Size fetchCount(const u32 number, const Size count, u64 & bytes) const;
+
+    /**
+     * Take the least recently used block which is not pending or dirty.
+     *
+     * @param number Block number to assign to the block
+     *
+     * @return Block pointer, which is most recently used but not yet valid
+     */
+    Block * allocate(const u32 number);
+
+    /**
+     * Mark a block as most recently used.
+     *
+     * @param block Block pointer
+     */
+    void touch(Block *block);
+
+    /**
+     * Remove a block from the LRU list.
+     *
+     * @param block Block pointer
+     */
+    void unlink(Block *block);
+
+  private:
+
+    /** Storage to read blocks from */
+    Storage *m_storage;
+
+    /** Size of each block in bytes */
+    const Size m_blockSize;
+
+    /** Number of blocks in the cache */
+    const Size m_count;
+
+    /** Array with all blocks */
+    Block *m_blocks;
+
+    /** Memory for block data */
+    u8 *m_data;
+
+    /** Temporary buffer for reading multiple blocks at once */
+    u8 *m_readBuffer;
+
+    /** Queue of asynchronous storage requests */
+    StorageQueue m_queue;
+
+    /** Asynchronous fetches */
+    Fetch m_fetches[MaximumFetches];
+
+    /** Memory for the data of asynchronous fetches */
+    u8 *m_fetchData;
+
+    /** Number of blocks pending in asynchronous fetches */
+    Size m_pending;
+
+    /** Executes fetchDone() */
+    Callback<LinnBlockCache, Storage::Request> m_fetchCallback;
+
+    /** Executed when an asynchronous fetch completes */
+    CallbackFunction *m_readyCallback;
+
+    /** Write back requests for each block */
+    Storage::Request *m_writes;
+
+    /** Executes writeDone() */
+    Callback<LinnBlockCache, Storage::Request> m_writeCallback;
+
+    /** Number of dirty blocks */
+    Size m_dirty;
+
+    /** Number of blocks written back */
+    Size m_written;
+
+    /** Maps block number to cached blocks */
+    HashTable<u32, Block *> m_map;
+
+    /** Most recently used block */
+    Block *m_head;
+
+    /** Least recently used block */
+    Block *m_tail;
+
+    /** Number of cache hits */
+    Size m_hits;
+
+    /** Number of cache misses */
+    Size m_misses;
+
+    /** Number of blocks read ahead */
+    Size m_readAhead;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __FILESYSTEM_LINN_BLOCKCACHE_H */
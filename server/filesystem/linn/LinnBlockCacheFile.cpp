@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <String.h>
+#include "LinnBlockCacheFile.h"
+
+LinnBlockCacheFile::LinnBlockCacheFile(const u32 inode, const LinnBlockCache *cache)
+    : File(inode)
+    , m_cache(cache)
+{
+    m_access = FileSystem::OwnerR | FileSystem::GroupR | FileSystem::OtherR;
+}
+
+LinnBlockCacheFile::~LinnBlockCacheFile()
+{
+}
+
+FileSystem::Result LinnBlockCacheFile::read(IOBuffer & buffer,
+                                            Size & size,
+                                            const Size offset)
+{
+    // Format the current counters
+    String tmp;
+    tmp << "hits " << (uint) m_cache->getHits() << "\n";
+    tmp << "misses " << (uint) m_cache->getMisses() << "\n";
+    tmp << "readahead " << (uint) m_cache->getReadAhead() << "\n";
+    tmp << "merged " << (uint) m_cache->getMerged() << "\n";
+    tmp << "dirty " << (uint) m_cache->getDirty() << "\n";
+    tmp << "written " << (uint) m_cache->getWritten() << "\n";
+
+    // Bounds checking
+    if (offset >= tmp.length())
+    {
+        size = 0;
+        return FileSystem::Success;
+    }
+
+    // How much bytes to copy?
+    const Size bytes = tmp.length() - offset > size ? size : tmp.length() - offset;
+    size = bytes;
+
+    return buffer.write(*tmp + offset, bytes);
+}
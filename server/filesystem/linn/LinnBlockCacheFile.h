@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FILESYSTEM_LINN_BLOCKCACHEFILE_H
+#define __FILESYSTEM_LINN_BLOCKCACHEFILE_H
+
+#include <File.h>
+#include <IOBuffer.h>
+#include <Types.h>
+#include "LinnBlockCache.h"
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup linnfs
+ * @{
+ */
+
+/**
+ * Provides the LinnBlockCache counters as a text file.
+ */
+class LinnBlockCacheFile : public File
+{
+  public:
+
+    /**
+     * Constructor function.
+     *
+     * @param inode Inode number for this File
+     * @param cache Block cache to report counters of
+     */
+    LinnBlockCacheFile(const u32 inode, const LinnBlockCache *cache);
+
+    /**
+     * Destructor function.
+     */
+    virtual ~LinnBlockCacheFile();
+
+    /**
+     * @brief Read bytes from the file.
+     *
+     * @param buffer Input/Output buffer to output bytes to.
+     * @param size Maximum number of bytes to read on input.
+     *             On output, the actual number of bytes read.
+     * @param offset Offset inside the file to start reading.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result read(IOBuffer & buffer,
+                                    Size & size,
+                                    const Size offset);
+
+  private:
+
+    /** Block cache to report counters of */
+    const LinnBlockCache *m_cache;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __FILESYSTEM_LINN_BLOCKCACHEFILE_H */
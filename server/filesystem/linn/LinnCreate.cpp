@@ -22,11 +22,13 @@
 #include <Types.h>
 #include <Macros.h>
 #include <FileSystem.h>
+#include <Lz4Compressor.h>
 #include "LinnCreate.h"
 #include "LinnSuperBlock.h"
 #include "LinnGroup.h"
 #include "LinnInode.h"
 #include "LinnDirectoryEntry.h"
+#include "LinnDirectoryIndex.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <dirent.h>
@@ -38,6 +40,7 @@
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 
 LinnCreate::LinnCreate()
 {
@@ -46,6 +49,13 @@ LinnCreate::LinnCreate()
     super     = ZERO;
     input     = ZERO;
     verbose   = false;
+    extents   = true;
+    full      = false;
+    compress  = false;
+    map       = false;
+    statistics = false;
+    imageFd   = -1;
+    savedBlocks = 0;
 }
 
 LinnInode * LinnCreate::createInode(le32 inodeNum, FileSystem::FileType type,
@@ -74,6 +84,7 @@ LinnInode * LinnCreate::createInode(le32 inodeNum, FileSystem::FileType type,
     inode->modifyTime = inode->createTime;
     inode->changeTime = inode->createTime;
     inode->links = 1;
+    inode->flags = ZERO;
 
     // Update inode BitArray, if needed
     inodeMap.setArray(BLOCKPTR(u8, group->inodeMap),
@@ -176,6 +187,38 @@ le32 LinnCreate::insertIndirect(le32 *ptr, const le32 blockIndexNumber, const Si
     }
 }
 
+le32 LinnCreate::getBlock(LinnInode *inode, const le32 blockIndexNumber)
+{
+    const Size ptrs = LINN_SUPER_NUM_PTRS(super);
+    const le32 index = blockIndexNumber - LINN_INODE_DIR_BLOCKS;
+
+    if (blockIndexNumber < LINN_INODE_DIR_BLOCKS)
+        return inode->block[blockIndexNumber];
+    else if (index < ptrs)
+        return getIndirect(inode->block[LINN_INODE_IND_BLOCKS-1], index, 1);
+    else if (index < ptrs * ptrs)
+        return getIndirect(inode->block[LINN_INODE_DIND_BLOCKS-1], index, 2);
+    else
+        return getIndirect(inode->block[LINN_INODE_TIND_BLOCKS-1], index, 3);
+}
+
+le32 LinnCreate::getIndirect(le32 block, const le32 blockIndexNumber, const Size depth)
+{
+    const le32 *ptr = BLOCKPTR(le32, block);
+    Size remain = 1;
+
+    // Calculate the number of blocks remaining per entry, like insertIndirect()
+    for (Size i = 0; i < depth - 1; i++)
+    {
+        remain *= LINN_SUPER_NUM_PTRS(super);
+    }
+
+    if (remain == 1)
+        return ptr[blockIndexNumber % LINN_SUPER_NUM_PTRS(super)];
+    else
+        return getIndirect(ptr[blockIndexNumber / remain], blockIndexNumber, depth - 1);
+}
+
 void LinnCreate::insertFile(char *inputFile, LinnInode *inode,
                             struct stat *st)
 {
@@ -190,6 +233,17 @@ void LinnCreate::insertFile(char *inputFile, LinnInode *inode,
         exit(EXIT_FAILURE);
     }
 
+    // Store the file contiguously, such that it is mapped with one extent
+    if (extents && st->st_size > 0)
+    {
+        if (!compress || !insertCompressed(inputFile, fd, inode, st))
+        {
+            insertExtent(inputFile, fd, inode, st);
+        }
+        close(fd);
+        return;
+    }
+
     // Read blocks from the file
     while (inode->size < st->st_size)
     {
@@ -250,6 +304,135 @@ void LinnCreate::insertFile(char *inputFile, LinnInode *inode,
     close(fd);
 }
 
+void LinnCreate::insertExtent(char *inputFile, int fd, LinnInode *inode,
+                              struct stat *st)
+{
+    const le32 count = (st->st_size + super->blockSize - 1) / super->blockSize;
+    const le32 first = BLOCKS(super, count);
+    const Size capacity = count * super->blockSize;
+    LinnExtent *extent = LINN_INODE_EXTENT_LIST(inode);
+    u8 *data = BLOCKPTR(u8, first);
+    int bytes;
+
+    extent->block = first;
+    extent->count = count;
+    inode->block[LINN_INODE_EXTENT_COUNT] = 1;
+    inode->flags |= LINN_INODE_EXTENTS;
+
+    // Read the file contents into the extent
+    while (inode->size < capacity)
+    {
+        if ((bytes = read(fd, data + inode->size, capacity - inode->size)) < 0)
+        {
+            printf("%s: failed to read() `%s': %s\n",
+                    prog, inputFile, strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+        else if (bytes == 0)
+        {
+            break;
+        }
+
+        // Increment size appropriately
+        inode->size += bytes;
+    }
+}
+
+bool LinnCreate::insertCompressed(char *inputFile, int fd, LinnInode *inode,
+                                  struct stat *st)
+{
+    const Size numChunks = (st->st_size + LINN_COMPRESS_CHUNK_SIZE - 1) / LINN_COMPRESS_CHUNK_SIZE;
+    const Size tableSize = (numChunks + 1) * sizeof(le32);
+    const Size minimumFrame = 27;
+    const le32 count = (st->st_size + super->blockSize - 1) / super->blockSize;
+    const Size limit = (count - 1) * super->blockSize;
+    Size total = tableSize;
+    ssize_t bytes;
+
+    // Compression must save at least one block
+    if (tableSize + minimumFrame > limit)
+    {
+        return false;
+    }
+
+    // Reserve the blocks of the uncompressed file and stream the frames into them
+    const le32 first = BLOCKS(super, count);
+    u8 *data = BLOCKPTR(u8, first);
+    le32 *table = (le32 *) data;
+    u8 *input = new u8[LINN_COMPRESS_CHUNK_SIZE];
+    u8 *frame = new u8[Lz4Compressor(input, LINN_COMPRESS_CHUNK_SIZE).getMaximumSize()];
+
+    // Compress each chunk into a separate frame
+    for (Size i = 0; i < numChunks && total <= limit; i++)
+    {
+        const Size offset = i * LINN_COMPRESS_CHUNK_SIZE;
+        const Size chunkSize = st->st_size - offset < LINN_COMPRESS_CHUNK_SIZE ?
+                               st->st_size - offset : LINN_COMPRESS_CHUNK_SIZE;
+
+        // Read the next chunk
+        for (Size done = 0; done < chunkSize; done += bytes)
+        {
+            if ((bytes = read(fd, input + done, chunkSize - done)) <= 0)
+            {
+                printf("%s: failed to read() `%s': %s\n",
+                        prog, inputFile, strerror(errno));
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        Lz4Compressor lz4(input, chunkSize);
+        Size frameSize = lz4.getMaximumSize();
+
+        if (lz4.compress(frame, frameSize) != Lz4Compressor::Success ||
+            frameSize > LINN_COMPRESS_FRAME_SIZE)
+        {
+            printf("%s: failed to compress `%s'\n", prog, inputFile);
+            exit(EXIT_FAILURE);
+        }
+
+        // The decompressor needs a minimum input size, pad small frames
+        const Size stored = frameSize > minimumFrame ? frameSize : minimumFrame;
+        table[i] = total;
+
+        if (total + stored <= limit)
+        {
+            memcpy(data + total, frame, frameSize);
+        }
+        total += stored;
+    }
+    delete[] input;
+    delete[] frame;
+
+    // Give back the reserved blocks if compression saves no blocks
+    if (total > limit)
+    {
+        memset(data, 0, count * super->blockSize);
+        super->freeBlocksCount += count;
+        lseek(fd, 0, SEEK_SET);
+        return false;
+    }
+    table[numChunks] = total;
+
+    // Release the blocks which the frames do not use
+    const le32 used = (total + super->blockSize - 1) / super->blockSize;
+    super->freeBlocksCount += count - used;
+    savedBlocks += count - used;
+
+    // Store the chunk table and frames in a single extent
+    LinnExtent *extent = LINN_INODE_EXTENT_LIST(inode);
+    extent->block = first;
+    extent->count = used;
+    inode->block[LINN_INODE_EXTENT_COUNT] = 1;
+    inode->flags |= LINN_INODE_EXTENTS | LINN_INODE_COMPRESSED;
+    inode->size = st->st_size;
+
+    if (verbose)
+    {
+        printf("%s compressed %u to %u bytes\n", inputFile, (uint) st->st_size, (uint) total);
+    }
+    return true;
+}
+
 void LinnCreate::insertEntry(le32 dirInode, le32 entryInode,
                              const char *name, FileSystem::FileType type)
 {
@@ -283,7 +466,7 @@ void LinnCreate::insertEntry(le32 dirInode, le32 entryInode,
         }
         // Point to the fresh entry
         entry = BLOCKPTR(LinnDirectoryEntry, inode->block[blockNum]) +
-                        (entryNum % super->blockSize);
+                        (entryNum % LINN_DIRENT_PER_BLOCK(super));
         // Fill it
         entry->inode = entryInode;
         entry->type  = type;
@@ -367,12 +550,197 @@ void LinnCreate::insertDirectory(char *inputDir, le32 inodeNum, le32 parentNum)
     }
     // All done
     closedir(dir);
+
+    // Index the directory if a lookup would scan multiple blocks
+    insertIndex(inodeNum);
+}
+
+void LinnCreate::insertIndex(le32 dirInode)
+{
+    LinnGroup *group;
+    LinnInode *inode;
+    LinnDirectoryEntry *entry;
+    LinnDirectoryIndex *index;
+    Size entries, slots;
+
+    // Point to the correct group
+    group = BLOCKPTR(LinnGroup, super->groupsTable);
+    if (dirInode != ZERO)
+    {
+        group += (dirInode / super->inodesPerGroup);
+    }
+    // Fetch inode
+    inode = BLOCKPTR(LinnInode, group->inodeTable) +
+                    (dirInode % super->inodesPerGroup);
+
+    // Small directories are scanned just as fast without an index
+    entries = inode->size / sizeof(LinnDirectoryEntry);
+    if (entries <= LINN_DIRENT_PER_BLOCK(super))
+    {
+        return;
+    }
+    slots = LINN_DIRINDEX_PER_BLOCK(super);
+
+    // Keep at least half of the slots free for short probe sequences
+    if (entries > slots / 2)
+    {
+        return;
+    }
+    // Allocate the index block
+    inode->block[LINN_INODE_INDEX_BLOCK] = BLOCK(super);
+    index = BLOCKPTR(LinnDirectoryIndex, inode->block[LINN_INODE_INDEX_BLOCK]);
+
+    // Insert all entries
+    for (Size i = 0; i < entries; i++)
+    {
+        entry = BLOCKPTR(LinnDirectoryEntry,
+                         inode->block[i / LINN_DIRENT_PER_BLOCK(super)]) +
+                        (i % LINN_DIRENT_PER_BLOCK(super));
+
+        const u32 hash = linnDirectoryHash(entry->name);
+        Size slot = hash % slots;
+
+        // Probe for a free slot
+        while (index[slot].entry != ZERO)
+        {
+            slot = (slot + 1) % slots;
+        }
+        index[slot].hash  = hash;
+        index[slot].entry = i + 1;
+    }
+
+    // Debug out
+    if (verbose)
+    {
+        printf("directory inode=%u indexed entries=%u\n",
+                dirInode, (uint) entries);
+    }
+}
+
+Size LinnCreate::countExtents(LinnInode *inode)
+{
+    const Size numBlocks = LINN_INODE_NUM_BLOCKS(super, inode);
+    Size count = 0;
+    le32 previous = 0;
+
+    // Extents are stored as runs already, count those which are not adjacent
+    if (inode->flags & LINN_INODE_EXTENTS)
+    {
+        const LinnExtent *extents = LINN_INODE_EXTENT_LIST(inode);
+        const Size numExtents = inode->block[LINN_INODE_EXTENT_COUNT];
+
+        for (Size i = 0; i < numExtents; i++)
+        {
+            const LinnExtent *extent = i < LINN_INODE_INLINE_EXTENTS ? &extents[i] :
+                BLOCKPTR(LinnExtent, inode->block[LINN_INODE_EXTENT_BLOCK]) + (i - LINN_INODE_INLINE_EXTENTS);
+
+            if (!count || extent->block != previous)
+                count++;
+
+            previous = extent->block + extent->count;
+        }
+        return count;
+    }
+
+    // Follow the block pointers
+    for (Size i = 0; i < numBlocks; i++)
+    {
+        const le32 block = getBlock(inode, i);
+
+        if (!count || block != previous + 1)
+            count++;
+
+        previous = block;
+    }
+    return count;
+}
+
+void LinnCreate::printStatistics()
+{
+    BitArray inodeMap(super->inodesPerGroup);
+    const Size usedBlocks = super->blocksCount - super->freeBlocksCount;
+    Size files = 0, directories = 0, fragmented = 0;
+    Size totalExtents = 0, maximumExtents = 0, compressed = 0;
+
+    // Walk all inodes in use
+    for (Size gn = 0; gn < LINN_GROUP_COUNT(super); gn++)
+    {
+        LinnGroup *group = BLOCKPTR(LinnGroup, super->groupsTable) + gn;
+        inodeMap.setArray(BLOCKPTR(u8, group->inodeMap), super->inodesPerGroup);
+
+        for (Size in = 0; in < super->inodesPerGroup; in++)
+        {
+            if (!inodeMap.isSet(in))
+                continue;
+
+            LinnInode *inode = BLOCKPTR(LinnInode, group->inodeTable) + in;
+            const Size count = countExtents(inode);
+
+            if (inode->type == FileSystem::DirectoryFile)
+                directories++;
+            else
+                files++;
+
+            if (inode->flags & LINN_INODE_COMPRESSED)
+                compressed++;
+
+            if (count > 1)
+                fragmented++;
+
+            if (count > maximumExtents)
+                maximumExtents = count;
+
+            totalExtents += count;
+        }
+    }
+    const Size inodes = files + directories;
+
+    printf("%s: %u files and %u directories in %u of %u blocks (%u%% used)\n",
+            prog, (uint) files, (uint) directories, (uint) usedBlocks,
+            (uint) super->blocksCount, (uint) (usedBlocks * 100 / super->blocksCount));
+    printf("%s: %u extents, %u.%02u per inode, at most %u\n",
+            prog, (uint) totalExtents, (uint) (totalExtents / inodes),
+            (uint) ((totalExtents * 100 / inodes) % 100), (uint) maximumExtents);
+    printf("%s: %u fragmented inodes (%u%%)\n",
+            prog, (uint) fragmented, (uint) (fragmented * 100 / inodes));
+    printf("%s: %u compressed files saving %u blocks\n",
+            prog, (uint) compressed, (uint) savedBlocks);
+}
+
+int LinnCreate::mapImage(Size size)
+{
+    void *ptr;
+
+    // Create the output image with its full size
+    if ((imageFd = open(image, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0)
+    {
+        printf("%s: failed to open() `%s' for writing: %s\r\n",
+                prog, image, strerror(errno));
+        return EXIT_FAILURE;
+    }
+    if (ftruncate(imageFd, size) != 0)
+    {
+        printf("%s: failed to ftruncate() `%s': %s\r\n",
+                prog, image, strerror(errno));
+        close(imageFd);
+        return EXIT_FAILURE;
+    }
+    // Map it. The new file reads as zeroes and unused blocks stay sparse.
+    if ((ptr = mmap(ZERO, size, PROT_READ | PROT_WRITE, MAP_SHARED, imageFd, 0)) == MAP_FAILED)
+    {
+        printf("%s: failed to mmap() `%s': %s\r\n",
+                prog, image, strerror(errno));
+        close(imageFd);
+        return EXIT_FAILURE;
+    }
+    blocks = (u8 *) ptr;
+    return EXIT_SUCCESS;
 }
 
 int LinnCreate::create(Size blockSize, Size blockNum, Size inodeNum)
 {
     LinnGroup *group;
-    BitArray map(128);
+    BitArray blockMap(128);
 
     assert(image != ZERO);
     assert(prog  != ZERO);
@@ -380,8 +748,18 @@ int LinnCreate::create(Size blockSize, Size blockNum, Size inodeNum)
     assert(inodeNum > 0);
 
     // Allocate blocks
-    blocks = new u8[blockSize * blockNum];
-    memset(blocks, 0, blockSize * blockNum);
+    if (map)
+    {
+        if (mapImage(blockSize * blockNum) != EXIT_SUCCESS)
+        {
+            return EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        blocks = new u8[blockSize * blockNum];
+        memset(blocks, 0, blockSize * blockNum);
+    }
 
     // Create a superblock
     super = (LinnSuperBlock *) (blocks + LINN_SUPER_OFFSET);
@@ -428,7 +806,7 @@ int LinnCreate::create(Size blockSize, Size blockNum, Size inodeNum)
                                LINN_INODE_ROOT);
     }
     // Mark blocks used
-    for (le32 block = 0; block < super->freeBlocksCount; block++)
+    for (le32 block = 0; block < super->blocksCount - super->freeBlocksCount; block++)
     {
         // Point to group
         group = BLOCKPTR(LinnGroup, super->groupsTable) +
@@ -436,9 +814,14 @@ int LinnCreate::create(Size blockSize, Size blockNum, Size inodeNum)
         group->freeBlocksCount--;
 
         // Mark the block used
-        map.setArray(BLOCKPTR(u8, group->blockMap),
-                   super->blocksPerGroup);
-        map.set(block % super->blocksPerGroup);
+        blockMap.setArray(BLOCKPTR(u8, group->blockMap),
+                          super->blocksPerGroup);
+        blockMap.set(block % super->blocksPerGroup);
+    }
+    // Report the layout
+    if (statistics)
+    {
+        printStatistics();
     }
     // Write the final image
     return writeImage();
@@ -448,6 +831,26 @@ int LinnCreate::writeImage()
 {
     FILE *fp;
 
+    // Write all blocks at once. Free blocks are only needed for writing at runtime.
+    const Size count = full ? super->blocksCount : super->blocksCount - super->freeBlocksCount;
+
+    // The mapped image only needs to be cut to size
+    if (map)
+    {
+        const Size size = super->blockSize * super->blocksCount;
+        const Size used = super->blockSize * count;
+
+        if (munmap(blocks, size) != 0 || ftruncate(imageFd, used) != 0)
+        {
+            printf("%s: failed to write `%s': %s\r\n",
+                    prog, image, strerror(errno));
+            close(imageFd);
+            return EXIT_FAILURE;
+        }
+        close(imageFd);
+        return EXIT_SUCCESS;
+    }
+
     // Open output image
     if ((fp = fopen(image, "w")) == NULL)
     {
@@ -456,9 +859,7 @@ int LinnCreate::writeImage()
         return EXIT_FAILURE;
     }
 
-    // Write all blocks at once
-    if (fwrite(blocks, super->blockSize *
-                      (super->blocksCount - super->freeBlocksCount), 1, fp) != 1)
+    if (fwrite(blocks, super->blockSize * count, 1, fp) != 1)
     {
         printf("%s: failed to fwrite() `%s': %s\r\n",
                 prog, image, strerror(errno));
@@ -495,6 +896,31 @@ void LinnCreate::setVerbose(bool newVerbose)
     this->verbose = newVerbose;
 }
 
+void LinnCreate::setExtents(bool newExtents)
+{
+    this->extents = newExtents;
+}
+
+void LinnCreate::setFull(bool newFull)
+{
+    this->full = newFull;
+}
+
+void LinnCreate::setCompress(bool newCompress)
+{
+    this->compress = newCompress;
+}
+
+void LinnCreate::setMap(bool newMap)
+{
+    this->map = newMap;
+}
+
+void LinnCreate::setStatistics(bool newStatistics)
+{
+    this->statistics = newStatistics;
+}
+
 int main(int argc, char **argv)
 {
     LinnCreate fs;
@@ -514,7 +940,12 @@ int main(int argc, char **argv)
                " -e PATTERN   Exclude matching files from the created filesystem\r\n"
                " -b SIZE      Specifies the blocksize in bytes.\r\n"
                " -n COUNT     Specifies the maximum number of blocks.\r\n"
-               " -i COUNT     Specifies the number of inodes to allocate.\r\n",
+               " -i COUNT     Specifies the number of inodes to allocate.\r\n"
+               " -p           Store files with block pointers instead of extents.\r\n"
+               " -f           Include the free blocks in the image, for writing at runtime.\r\n"
+               " -c           Store files as LZ4 compressed chunks, if that saves blocks.\r\n"
+               " -m           Build the image in a memory mapping of the output file.\r\n"
+               " -s           Print layout statistics of the created filesystem.\r\n",
                 argv[0]);
         return EXIT_FAILURE;
     }
@@ -536,6 +967,31 @@ int main(int argc, char **argv)
         {
             fs.setVerbose(true);
         }
+        // Block pointers
+        else if (!strcmp(argv[i + 2], "-p"))
+        {
+            fs.setExtents(false);
+        }
+        // Full image
+        else if (!strcmp(argv[i + 2], "-f"))
+        {
+            fs.setFull(true);
+        }
+        // Compressed files
+        else if (!strcmp(argv[i + 2], "-c"))
+        {
+            fs.setCompress(true);
+        }
+        // Memory mapped image
+        else if (!strcmp(argv[i + 2], "-m"))
+        {
+            fs.setMap(true);
+        }
+        // Layout statistics
+        else if (!strcmp(argv[i + 2], "-s"))
+        {
+            fs.setStatistics(true);
+        }
         // Input directory
         else if (!strcmp(argv[i + 2], "-d") && i < argc - 3)
         {
@@ -184,6 +184,41 @@ class LinnCreate
      */
     void setVerbose(bool newVerbose);
 
+    /**
+     * Store the blocks of files as extents or with block pointers.
+     *
+     * @param newExtents True to use extents, false to use block pointers.
+     */
+    void setExtents(bool newExtents);
+
+    /**
+     * Write all blocks to the image, including the free blocks.
+     *
+     * @param newFull True to write all blocks, false to write only the used blocks.
+     */
+    void setFull(bool newFull);
+
+    /**
+     * Store regular files compressed, if that saves blocks.
+     *
+     * @param newCompress True to compress files, false to store them as-is.
+     */
+    void setCompress(bool newCompress);
+
+    /**
+     * Build the image directly in a shared memory mapping of the output file.
+     *
+     * @param newMap True to map the image file, false to build it in memory and write it at once.
+     */
+    void setMap(bool newMap);
+
+    /**
+     * Print layout statistics of the created filesystem.
+     *
+     * @param newStatistics True to print statistics, false to stay silent.
+     */
+    void setStatistics(bool newStatistics);
+
   private:
 
     /**
@@ -232,6 +267,14 @@ class LinnCreate
      */
     void insertDirectory(char *inputFile, le32 inodeNum, le32 parentNum);
 
+    /**
+     * Creates the hashed index for a large directory.
+     * @param dirInode Inode number of the directory.
+     * @note The index is only created for directories spanning more than one block.
+     * @see LinnDirectoryIndex
+     */
+    void insertIndex(le32 dirInode);
+
     /**
      * Inserts the contents of a local file into an LinnInode.
      *
@@ -242,6 +285,30 @@ class LinnCreate
     void insertFile(char *inputFile, LinnInode *inode,
                     struct stat *st);
 
+    /**
+     * Inserts the contents of a local file as a single extent.
+     *
+     * @param inputFile Path to the local file.
+     * @param fd File descriptor of the opened local file.
+     * @param inode Pointer to the inode to fill.
+     * @param st POSIX stats structure of inputFile.
+     */
+    void insertExtent(char *inputFile, int fd, LinnInode *inode,
+                      struct stat *st);
+
+    /**
+     * Inserts the contents of a local file as LZ4 compressed chunks.
+     *
+     * @param inputFile Path to the local file.
+     * @param fd File descriptor of the opened local file.
+     * @param inode Pointer to the inode to fill.
+     * @param st POSIX stats structure of inputFile.
+     *
+     * @return True if stored compressed, false if compression saves no blocks.
+     */
+    bool insertCompressed(char *inputFile, int fd, LinnInode *inode,
+                          struct stat *st);
+
     /**
      * Inserts an indirect block address.
      *
@@ -254,6 +321,50 @@ class LinnCreate
      */
     le32 insertIndirect(le32 *ptr, const le32 blockIndexNumber, const Size depth);
 
+    /**
+     * Lookup the block number of a file block.
+     *
+     * @param inode Pointer to an inode using block pointers.
+     * @param blockIndexNumber Index of the block in the file.
+     *
+     * @return Block number in the filesystem.
+     */
+    le32 getBlock(LinnInode *inode, const le32 blockIndexNumber);
+
+    /**
+     * Lookup a block number through indirect blocks.
+     *
+     * @param block Block number of the block map.
+     * @param blockIndexNumber Block index number, minus LINN_INODE_DIR_BLOCKS
+     * @param depth Level of indirection.
+     *
+     * @return Block number in the filesystem.
+     */
+    le32 getIndirect(le32 block, const le32 blockIndexNumber, const Size depth);
+
+    /**
+     * Count the number of contiguous runs of blocks in an inode.
+     *
+     * @param inode Pointer to the inode.
+     *
+     * @return Number of extents needed to map the inode.
+     */
+    Size countExtents(LinnInode *inode);
+
+    /**
+     * Print layout statistics of all inodes in the filesystem.
+     */
+    void printStatistics();
+
+    /**
+     * Create the output image file and map it into memory.
+     *
+     * @param size Size of the image in bytes.
+     *
+     * @return EXIT_SUCCESS if successful and EXIT_FAILURE otherwise.
+     */
+    int mapImage(Size size);
+
     /**
      * Writes the final image to disk.
      *
@@ -275,6 +386,27 @@ class LinnCreate
     /** Output verbose messages. */
     bool verbose;
 
+    /** Store the blocks of files as extents. */
+    bool extents;
+
+    /** Write the free blocks to the image too. */
+    bool full;
+
+    /** Store regular files as LZ4 compressed chunks. */
+    bool compress;
+
+    /** Build the image in a memory mapping of the output file. */
+    bool map;
+
+    /** Print layout statistics. */
+    bool statistics;
+
+    /** File descriptor of the mapped output image. */
+    int imageFd;
+
+    /** Number of blocks saved by compressing files. */
+    Size savedBlocks;
+
     /** List of file patterns to ignore. */
     List<String *> excludes;
 
@@ -58,8 +58,8 @@ FileSystem::Result LinnDirectory::read(IOBuffer & buffer,
                       (ent * sizeof(LinnDirectoryEntry));
 
         // Get the next entry.
-        if (m_fs->getStorage()->read(off, &dent,
-                                   sizeof(LinnDirectoryEntry)) != FileSystem::Success)
+        if (m_fs->getBlockCache()->read(off, &dent,
+                                        sizeof(LinnDirectoryEntry)) != FileSystem::Success)
         {
             return FileSystem::PermissionDenied;
         }
@@ -93,6 +93,51 @@ FileSystem::Result LinnDirectory::read(IOBuffer & buffer,
     return FileSystem::Success;
 }
 
+FileSystem::Result LinnDirectory::getEntries(Dirent *output,
+                                             Size & count,
+                                             const Size index)
+{
+    LinnSuperBlock *sb = m_fs->getSuperBlock();
+    const Size total = m_inodeData->size / sizeof(LinnDirectoryEntry);
+    LinnDirectoryEntry dent;
+    LinnInode *dInode;
+    Size num = 0;
+
+    for (Size ent = index; ent < total && num < count; ent++)
+    {
+        // Point to correct (direct) block
+        const Size blk = ent / LINN_DIRENT_PER_BLOCK(sb);
+        if (blk >= LINN_INODE_DIR_BLOCKS)
+        {
+            break;
+        }
+
+        // Calculate offset to read.
+        const u64 off = ((u64) m_inodeData->block[blk] * sb->blockSize) +
+                        (sizeof(LinnDirectoryEntry) * (ent % LINN_DIRENT_PER_BLOCK(sb)));
+
+        // Get the next entry.
+        if (m_fs->getBlockCache()->read(off, &dent,
+                                        sizeof(LinnDirectoryEntry)) != FileSystem::Success)
+        {
+            return FileSystem::IOError;
+        }
+
+        // Fill in the Dirent.
+        if (!(dInode = m_fs->getInode(dent.inode)))
+        {
+            return FileSystem::NotFound;
+        }
+        MemoryBlock::copy(output[num].name, dent.name, LINN_DIRENT_NAME_LEN);
+        output[num].type = (FileSystem::FileType) dInode->type;
+        num++;
+    }
+
+    // All done.
+    count = num;
+    return FileSystem::Success;
+}
+
 File * LinnDirectory::lookup(const char *name)
 {
     LinnDirectoryEntry entry;
@@ -133,6 +178,22 @@ bool LinnDirectory::getLinnDirectoryEntry(LinnDirectoryEntry *dent,
     LinnSuperBlock *sb = m_fs->getSuperBlock();
     u64 offset;
 
+    // Use the hashed index if available.
+    if (m_inodeData->block[LINN_INODE_INDEX_BLOCK] != ZERO)
+    {
+        switch (lookupIndex(dent, name))
+        {
+            case FileSystem::Success:
+                return true;
+
+            case FileSystem::NotFound:
+                return false;
+
+            default:
+                break;
+        }
+    }
+
     // Loop all blocks.
     for (u32 blk = 0; blk < LINN_INODE_NUM_BLOCKS(sb, m_inodeData); blk++)
     {
@@ -144,8 +205,8 @@ bool LinnDirectory::getLinnDirectoryEntry(LinnDirectoryEntry *dent,
                      (sizeof(LinnDirectoryEntry) * ent);
 
             // Get the next entry.
-            if (m_fs->getStorage()->read(offset, dent,
-                                         sizeof(LinnDirectoryEntry)) != FileSystem::Success)
+            if (m_fs->getBlockCache()->read(offset, dent,
+                                            sizeof(LinnDirectoryEntry)) != FileSystem::Success)
             {
                 return false;
             }
@@ -161,3 +222,62 @@ bool LinnDirectory::getLinnDirectoryEntry(LinnDirectoryEntry *dent,
     // Not found.
     return false;
 }
+
+FileSystem::Result LinnDirectory::lookupIndex(LinnDirectoryEntry *dent,
+                                              const char *name)
+{
+    const String nameStr(name, false);
+    LinnSuperBlock *sb = m_fs->getSuperBlock();
+    const Size slots = LINN_DIRINDEX_PER_BLOCK(sb);
+    const Size entries = m_inodeData->size / sizeof(LinnDirectoryEntry);
+    const u64 base = (u64) m_inodeData->block[LINN_INODE_INDEX_BLOCK] * sb->blockSize;
+    const u32 hash = linnDirectoryHash(name);
+    LinnDirectoryIndex slot;
+    Size entry, blk;
+
+    // Walk the probe sequence until a free slot.
+    for (Size i = 0, pos = hash % slots; i < slots; i++, pos = (pos + 1) % slots)
+    {
+        if (m_fs->getBlockCache()->read(base + (pos * sizeof(LinnDirectoryIndex)),
+                                        &slot, sizeof(slot)) != FileSystem::Success)
+        {
+            return FileSystem::IOError;
+        }
+
+        // Free slot ends the probe sequence.
+        if (slot.entry == ZERO)
+        {
+            return FileSystem::NotFound;
+        }
+        else if (slot.hash != hash)
+        {
+            continue;
+        }
+
+        // Validate the referenced entry.
+        entry = slot.entry - 1;
+        blk   = entry / LINN_DIRENT_PER_BLOCK(sb);
+
+        if (entry >= entries || blk >= LINN_INODE_DIR_BLOCKS)
+        {
+            return FileSystem::IOError;
+        }
+
+        // Read the entry and compare its name.
+        const u64 offset = ((u64) m_inodeData->block[blk] * sb->blockSize) +
+                           (sizeof(LinnDirectoryEntry) * (entry % LINN_DIRENT_PER_BLOCK(sb)));
+
+        if (m_fs->getBlockCache()->read(offset, dent,
+                                        sizeof(LinnDirectoryEntry)) != FileSystem::Success)
+        {
+            return FileSystem::IOError;
+        }
+        else if (nameStr.equals(dent->name))
+        {
+            return FileSystem::Success;
+        }
+    }
+
+    // Index is full without a free slot.
+    return FileSystem::IOError;
+}
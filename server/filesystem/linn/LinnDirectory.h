@@ -22,6 +22,7 @@
 #include <Directory.h>
 #include <Types.h>
 #include "LinnDirectoryEntry.h"
+#include "LinnDirectoryIndex.h"
 #include "LinnFileSystem.h"
 #include "LinnInode.h"
 #include "IOBuffer.h"
@@ -73,6 +74,18 @@ class LinnDirectory : public Directory
                                     Size & size,
                                     const Size offset);
 
+    /**
+     * Retrieve directory entries
+     * @param output Output array of Dirent entries.
+     * @param count Maximum number of entries on input.
+     *              On output, the actual number of entries retrieved.
+     * @param index Index of the first entry to retrieve.
+     * @return Result code
+     */
+    virtual FileSystem::Result getEntries(Dirent *output,
+                                          Size & count,
+                                          const Size index);
+
     /**
      * @brief Retrieves a File pointer for the given entry name.
      *
@@ -102,6 +115,16 @@ class LinnDirectory : public Directory
     bool getLinnDirectoryEntry(LinnDirectoryEntry *dent,
                                const char *name);
 
+    /**
+     * Retrieve a directory entry using the hashed index.
+     * @param dent LinnDirectoryEntry buffer pointer.
+     * @param name Unique name of the entry.
+     * @return Success if found, NotFound if not found or IOError if the index is unusable.
+     * @see LinnDirectoryIndex
+     */
+    FileSystem::Result lookupIndex(LinnDirectoryEntry *dent,
+                                   const char *name);
+
   private:
 
     /** Filesystem pointer. */
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FILESYSTEM_LINN_DIRECTORY_INDEX_H
+#define __FILESYSTEM_LINN_DIRECTORY_INDEX_H
+
+#include <Types.h>
+#include <HashFunction.h>
+#include "LinnDirectoryEntry.h"
+#include "LinnInode.h"
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup linnfs
+ * @{
+ */
+
+/**
+ * Block pointer of a directory LinnInode which holds the hashed index.
+ *
+ * Directories only use direct blocks, which leaves the last block
+ * pointer free. A zero value means the directory has no index and
+ * must be searched linearly.
+ */
+#define LINN_INODE_INDEX_BLOCK  (LINN_INODE_BLOCKS - 1)
+
+/**
+ * Calculates the number of LinnDirectoryIndex slots fitting in one block.
+ * @return Number of slots.
+ */
+#define LINN_DIRINDEX_PER_BLOCK(sb) \
+    ((sb)->blockSize / sizeof(LinnDirectoryIndex))
+
+/**
+ * Slot in the hashed index of a LinnFS directory.
+ *
+ * The index is a single block of slots using open addressing with
+ * linear probing. Each used slot refers to the LinnDirectoryEntry
+ * with the same name hash. Slots with a zero entry field are free
+ * and terminate the probe sequence.
+ */
+typedef struct LinnDirectoryIndex
+{
+    /** Hash of the entry name. */
+    le32 hash;
+
+    /** Entry number inside the directory plus one, or zero if free. */
+    le32 entry;
+}
+LinnDirectoryIndex;
+
+/**
+ * Compute the index hash of a directory entry name.
+ *
+ * @param name Null terminated entry name.
+ *
+ * @return FNV-1a hash of the name.
+ */
+inline u32 linnDirectoryHash(const char *name)
+{
+    u32 hash = FNV_INIT;
+
+    for (Size i = 0; i < LINN_DIRENT_NAME_LEN && name[i]; i++)
+    {
+        hash ^= (u8) name[i];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __FILESYSTEM_LINN_DIRECTORY_INDEX_H */
@@ -16,6 +16,8 @@
  */
 
 #include <FreeNOS/User.h>
+#include <MemoryBlock.h>
+#include <HashIterator.h>
 #include "LinnFileSystem.h"
 #include "LinnFile.h"
 
@@ -32,6 +34,12 @@ LinnFile::LinnFile(LinnFileSystem *fs,
 
 LinnFile::~LinnFile()
 {
+    m_fs->flushFile(this);
+
+    for (HashIterator<u32, u8 *> i(m_delayed); i.hasCurrent(); i++)
+    {
+        delete[] i.current();
+    }
 }
 
 FileSystem::Result LinnFile::read(IOBuffer & buffer,
@@ -40,57 +48,348 @@ FileSystem::Result LinnFile::read(IOBuffer & buffer,
 {
     const LinnSuperBlock *sb = m_fs->getSuperBlock();
     const Size inodeNumBlocks = LINN_INODE_NUM_BLOCKS(sb, m_inodeData);
-    Size bytes = 0, blockNr = 0, blockCount;
-    u64 storageOffset, copyOffset = offset;
-    Size total = 0;
+    Size blockCount;
+    u64 storageOffset;
+
+    // Continue after the data copied before a RetryAgain
+    Size total = buffer.getCount();
 
     assert(sb->blockSize <= LINN_MAX_BLOCK_SIZE);
 
-    // Skip ahead blocks.
-    while ((sb->blockSize * (blockNr + 1)) <= copyOffset)
+    if (m_inodeData->flags & LINN_INODE_COMPRESSED)
     {
-        blockNr++;
+        return readCompressed(buffer, size, offset);
     }
 
-    // Adjust the copy offset within this block.
-    copyOffset -= sb->blockSize * blockNr;
-
-    // Loop all blocks.
-    while (blockNr < inodeNumBlocks && total < size && m_inodeData->size - (offset + total) > 0)
+    // Loop all blocks. The file size includes data which is not yet written back.
+    while (total < size && offset + total < m_size)
     {
+        const Size position = offset + total;
+        const u32 blockNr = position / sb->blockSize;
+        const Size copyOffset = position % sb->blockSize;
+
+        // Respect the file size and the remote process buffer.
+        Size bytes = m_size - position < size - total ? m_size - position : size - total;
+
+        // Blocks which are not yet allocated contain delayed data or zeroes
+        if (blockNr >= inodeNumBlocks)
+        {
+            u8 * const *data = m_delayed.get(blockNr);
+
+            if (bytes > sb->blockSize - copyOffset)
+            {
+                bytes = sb->blockSize - copyOffset;
+            }
+
+            if (data)
+                MemoryBlock::copy(buffer.getBuffer() + total, *data + copyOffset, bytes);
+            else
+                MemoryBlock::set(buffer.getBuffer() + total, 0, bytes);
+
+            buffer.addCount(bytes);
+            total += bytes;
+            continue;
+        }
+
         // Calculate the offset in storage for this block.
         storageOffset = m_fs->getOffsetRange(m_inodeData, blockNr, blockCount);
 
         // Calculate the number of bytes to copy.
-        bytes = (blockCount * sb->blockSize) - copyOffset;
+        if (bytes > (blockCount * sb->blockSize) - copyOffset)
+        {
+            bytes = (blockCount * sb->blockSize) - copyOffset;
+        }
 
-        // Respect the inode size.
-        if (bytes > m_inodeData->size - (offset + total))
+        // Fetch the next block(s). The contiguous run is used for read-ahead.
+        // Misses are fetched in the background while other requests are served.
+        const FileSystem::Result result =
+            m_fs->getBlockCache()->tryRead(storageOffset + copyOffset,
+                                           buffer.getBuffer() + total, bytes,
+                                           blockCount);
+        buffer.addCount(bytes);
+        total += bytes;
+
+        if (result == FileSystem::RetryAgain)
+        {
+            return result;
+        }
+        else if (result != FileSystem::Success)
         {
-            bytes = m_inodeData->size - (offset + total);
+            return FileSystem::IOError;
         }
+    }
+
+    // Success.
+    size = total;
+    return FileSystem::Success;
+}
+
+FileSystem::Result LinnFile::readCompressed(IOBuffer & buffer,
+                                            Size & size,
+                                            const Size offset)
+{
+    Size total = buffer.getCount();
 
-        // Respect the remote process buffer.
+    while (total < size && offset + total < m_size)
+    {
+        const Size position = offset + total;
+        const Size chunkOffset = position % LINN_COMPRESS_CHUNK_SIZE;
+        const u8 *data;
+
+        // Decompress the chunk. The compressed data is fetched in the background.
+        const FileSystem::Result result =
+            m_fs->readChunk(getInode(), m_inodeData, position / LINN_COMPRESS_CHUNK_SIZE, data);
+        if (result == FileSystem::RetryAgain)
+        {
+            return result;
+        }
+        else if (result != FileSystem::Success)
+        {
+            return FileSystem::IOError;
+        }
+
+        // Copy up to the end of the chunk
+        Size bytes = LINN_COMPRESS_CHUNK_SIZE - chunkOffset;
+        if (bytes > m_size - position)
+        {
+            bytes = m_size - position;
+        }
         if (bytes > size - total)
         {
             bytes = size - total;
         }
 
-        // Fetch the next block.
-        if (m_fs->getStorage()->read(storageOffset + copyOffset,
-                                     buffer.getBuffer() + total, bytes) != FileSystem::Success)
+        MemoryBlock::copy(buffer.getBuffer() + total, data + chunkOffset, bytes);
+        buffer.addCount(bytes);
+        total += bytes;
+    }
+
+    size = total;
+    return FileSystem::Success;
+}
+
+FileSystem::Result LinnFile::write(IOBuffer & buffer,
+                                   Size & size,
+                                   const Size offset)
+{
+    const LinnSuperBlock *sb = m_fs->getSuperBlock();
+    const Size inodeNumBlocks = LINN_INODE_NUM_BLOCKS(sb, m_inodeData);
+    const u8 *src = buffer.getBuffer();
+    Size total = 0, blockCount;
+
+    if (!m_fs->isWritable())
+    {
+        return FileSystem::PermissionDenied;
+    }
+
+    // Compressed chunks cannot be modified in place
+    if (m_inodeData->flags & LINN_INODE_COMPRESSED)
+    {
+        return FileSystem::NotSupported;
+    }
+
+    // Only extents can grow without allocating indirect blocks
+    if (offset + size > inodeNumBlocks * sb->blockSize && inodeNumBlocks > 0 &&
+        !(m_inodeData->flags & LINN_INODE_EXTENTS))
+    {
+        return FileSystem::NotSupported;
+    }
+
+    while (total < size)
+    {
+        const Size position = offset + total;
+        const u32 blockNr = position / sb->blockSize;
+        const Size blockOffset = position % sb->blockSize;
+        Size bytes = size - total;
+
+        // Allocated blocks are modified in the block cache
+        if (blockNr < inodeNumBlocks)
         {
-            return FileSystem::IOError;
+            const u64 storageOffset = m_fs->getOffsetRange(m_inodeData, blockNr, blockCount);
+
+            if (bytes > (blockCount * sb->blockSize) - blockOffset)
+            {
+                bytes = (blockCount * sb->blockSize) - blockOffset;
+            }
+
+            if (storageOffset == 0 ||
+                m_fs->getBlockCache()->write(storageOffset + blockOffset, src + total, bytes) != FileSystem::Success)
+            {
+                return FileSystem::IOError;
+            }
+        }
+        // New blocks are allocated when flushed
+        else
+        {
+            u8 * const *delayed = m_delayed.get(blockNr);
+            u8 *data = delayed ? *delayed : ZERO;
+
+            if (bytes > sb->blockSize - blockOffset)
+            {
+                bytes = sb->blockSize - blockOffset;
+            }
+
+            if (data == ZERO)
+            {
+                data = new u8[sb->blockSize];
+                assert(data != NULL);
+                MemoryBlock::set(data, 0, sb->blockSize);
+                m_delayed.insert(blockNr, data);
+            }
+            MemoryBlock::copy(data + blockOffset, src + total, bytes);
         }
-        buffer.addCount(bytes);
 
-        // Update state.
         total += bytes;
-        copyOffset = 0;
-        blockNr += blockCount;
     }
 
-    // Success.
+    if (offset + total > m_size)
+    {
+        m_size = offset + total;
+    }
+    m_fs->fileModified(this);
+
     size = total;
     return FileSystem::Success;
 }
+
+FileSystem::Result LinnFile::flush()
+{
+    static u8 zeroes[LINN_MAX_BLOCK_SIZE];
+    const LinnSuperBlock *sb = m_fs->getSuperBlock();
+    const Size numBlocks = m_size % sb->blockSize ? m_size / sb->blockSize + 1 :
+                                                    m_size / sb->blockSize;
+    Size allocated = LINN_INODE_NUM_BLOCKS(sb, m_inodeData);
+    u32 goal = 0;
+
+    // Continue after the last block of the file
+    if (allocated > 0)
+    {
+        Size count;
+        goal = (m_fs->getOffsetRange(m_inodeData, allocated - 1, count) / sb->blockSize) + 1;
+    }
+
+    // Allocate all new blocks at once, which gives the fewest extents
+    while (allocated < numBlocks)
+    {
+        u32 block;
+        Size count;
+
+        FileSystem::Result result = m_fs->allocateBlocks(goal, numBlocks - allocated, block, count);
+        if (result == FileSystem::Success)
+        {
+            result = appendExtent(block, count);
+        }
+        if (result != FileSystem::Success)
+        {
+            return result;
+        }
+
+        // Move the delayed data to the allocated blocks. Holes are filled with zeroes.
+        for (Size i = 0; i < count; i++)
+        {
+            u8 * const *delayed = m_delayed.get(allocated + i);
+
+            result = m_fs->getBlockCache()->write((u64) (block + i) * sb->blockSize,
+                                                  delayed ? *delayed : zeroes, sb->blockSize);
+            if (delayed)
+            {
+                delete[] *delayed;
+                m_delayed.remove(allocated + i);
+            }
+            if (result != FileSystem::Success)
+            {
+                return result;
+            }
+        }
+
+        allocated += count;
+        goal = block + count;
+        m_inodeData->size = allocated * sb->blockSize < m_size ? allocated * sb->blockSize : m_size;
+    }
+
+    // Update the inode
+    m_inodeData->size = m_size;
+    return m_fs->writeInode(getInode());
+}
+
+FileSystem::Result LinnFile::appendExtent(const u32 block, const Size count)
+{
+    static LinnExtent extents[LINN_MAX_BLOCK_SIZE / sizeof(LinnExtent)];
+    const LinnSuperBlock *sb = m_fs->getSuperBlock();
+    LinnBlockCache *cache = m_fs->getBlockCache();
+    LinnExtent *inlineExtents = LINN_INODE_EXTENT_LIST(m_inodeData);
+    Size num = m_inodeData->block[LINN_INODE_EXTENT_COUNT];
+    LinnExtent *last = ZERO;
+
+    // Files without blocks switch to extents
+    if (!(m_inodeData->flags & LINN_INODE_EXTENTS))
+    {
+        MemoryBlock::set(m_inodeData->block, 0, sizeof(m_inodeData->block));
+        m_inodeData->flags |= LINN_INODE_EXTENTS;
+        num = 0;
+    }
+
+    // Read the extent block, if any
+    const u64 extentOffset = (u64) m_inodeData->block[LINN_INODE_EXTENT_BLOCK] * sb->blockSize;
+    if (num > LINN_INODE_INLINE_EXTENTS)
+    {
+        if (cache->read(extentOffset, extents, sb->blockSize) != FileSystem::Success)
+        {
+            return FileSystem::IOError;
+        }
+        last = &extents[num - LINN_INODE_INLINE_EXTENTS - 1];
+    }
+    else if (num > 0)
+    {
+        last = &inlineExtents[num - 1];
+    }
+
+    // Grow the last extent if the blocks follow it
+    if (last != ZERO && (last->count == 0 || last->block + last->count == block))
+    {
+        if (last->count == 0)
+        {
+            last->block = block;
+        }
+        last->count += count;
+
+        return num > LINN_INODE_INLINE_EXTENTS ?
+            cache->write(extentOffset, extents, sb->blockSize) : FileSystem::Success;
+    }
+
+    // Add a new extent in the inode
+    if (num < LINN_INODE_INLINE_EXTENTS)
+    {
+        inlineExtents[num].block = block;
+        inlineExtents[num].count = count;
+        m_inodeData->block[LINN_INODE_EXTENT_COUNT] = num + 1;
+        return FileSystem::Success;
+    }
+
+    // Add a new extent in the extent block
+    if (num - LINN_INODE_INLINE_EXTENTS >= LINN_EXTENTS_PER_BLOCK(sb))
+    {
+        ERROR("inode " << getInode() << " has too many extents");
+        return FileSystem::NotSupported;
+    }
+    else if (num == LINN_INODE_INLINE_EXTENTS)
+    {
+        u32 extentBlock;
+        Size allocated;
+
+        const FileSystem::Result result = m_fs->allocateBlocks(block + count, 1, extentBlock, allocated);
+        if (result != FileSystem::Success)
+        {
+            return result;
+        }
+        MemoryBlock::set(extents, 0, sizeof(extents));
+        m_inodeData->block[LINN_INODE_EXTENT_BLOCK] = extentBlock;
+    }
+
+    extents[num - LINN_INODE_INLINE_EXTENTS].block = block;
+    extents[num - LINN_INODE_INLINE_EXTENTS].count = count;
+    m_inodeData->block[LINN_INODE_EXTENT_COUNT] = num + 1;
+
+    return cache->write((u64) m_inodeData->block[LINN_INODE_EXTENT_BLOCK] * sb->blockSize,
+                        extents, sb->blockSize);
+}
@@ -20,6 +20,7 @@
 
 #include <File.h>
 #include <Types.h>
+#include <HashTable.h>
 #include "LinnFileSystem.h"
 #include "LinnInode.h"
 #include "IOBuffer.h"
@@ -34,6 +35,10 @@
 
 /**
  * Represents a file on a mounted LinnFS filesystem.
+ *
+ * Data written inside the allocated blocks goes to the block cache. Data
+ * written beyond them is kept in delayed blocks, which are allocated at once
+ * when the file is flushed.
  */
 class LinnFile : public File
 {
@@ -69,6 +74,56 @@ class LinnFile : public File
                                     Size & size,
                                     const Size offset);
 
+    /**
+     * @brief Write bytes to the file.
+     *
+     * @param buffer Input/Output buffer to input bytes from.
+     * @param size Maximum number of bytes to write on input.
+     *             On output, the actual number of bytes written.
+     * @param offset Offset inside the file to start writing.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result write(IOBuffer & buffer,
+                                     Size & size,
+                                     const Size offset);
+
+    /**
+     * Allocate the delayed blocks and update the inode.
+     *
+     * The data is written to the block cache, which the
+     * LinnFileSystem writes back to storage.
+     *
+     * @return Result code
+     */
+    FileSystem::Result flush();
+
+  private:
+
+    /**
+     * Read bytes from a compressed file.
+     *
+     * @param buffer Input/Output buffer to output bytes to.
+     * @param size Maximum number of bytes to read on input.
+     *             On output, the actual number of bytes read.
+     * @param offset Offset inside the file to start reading.
+     *
+     * @return Result code
+     */
+    FileSystem::Result readCompressed(IOBuffer & buffer,
+                                      Size & size,
+                                      const Size offset);
+
+    /**
+     * Append allocated blocks to the extents of the inode.
+     *
+     * @param block First block number
+     * @param count Number of contiguous blocks
+     *
+     * @return Result code
+     */
+    FileSystem::Result appendExtent(const u32 block, const Size count);
+
   private:
 
     /** Filesystem pointer. */
@@ -76,6 +131,9 @@ class LinnFile : public File
 
     /** Inode pointer. */
     LinnInode *m_inodeData;
+
+    /** Data of written blocks which are not yet allocated, by block number in the file. */
+    HashTable<u32, u8 *> m_delayed;
 };
 
 /**
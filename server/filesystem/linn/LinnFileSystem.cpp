@@ -17,13 +17,21 @@
 
 #include <Types.h>
 #include <Assert.h>
+#include <MemoryBlock.h>
+#include <ListIterator.h>
+#include <TraceFile.h>
+#include <Lz4Decompressor.h>
 #include "LinnFileSystem.h"
 #include "LinnInode.h"
 #include "LinnFile.h"
 #include "LinnDirectory.h"
+#include "LinnBlockCacheFile.h"
 
 LinnFileSystem::LinnFileSystem(const char *p, Storage *s)
-    : FileSystemServer(ZERO, p), storage(s), groups(ZERO)
+    : FileSystemServer(ZERO, p), storage(s), groups(ZERO), cache(ZERO)
+    , blocksReadyCallback(this, &LinnFileSystem::blocksReady), writable(false)
+    , blockMaps(ZERO), chunkInput(ZERO), chunkData(ZERO), chunkInode(0), chunkIndex(0)
+    , nextInode(0)
 {
     LinnInode *rootInode;
     LinnGroup *group;
@@ -42,6 +50,15 @@ LinnFileSystem::LinnFileSystem(const char *p, Storage *s)
     {
         FATAL("magic mismatch");
     }
+    // Create the block buffer cache.
+    if (super.blockSize < LINN_MIN_BLOCK_SIZE || super.blockSize > LINN_MAX_BLOCK_SIZE)
+    {
+        FATAL("unsupported block size: " << super.blockSize);
+    }
+    cache = new LinnBlockCache(s, super.blockSize, LINN_CACHE_SIZE);
+    assert(cache != NULL);
+    cache->setReadyCallback(&blocksReadyCallback);
+
     // Create groups vector.
     groups = new Vector<LinnGroup *>(LINN_GROUP_COUNT(&super));
     assert(groups != NULL);
@@ -64,8 +81,34 @@ LinnFileSystem::LinnFileSystem(const char *p, Storage *s)
         // Insert in the groups vector.
         groups->insert(i, group);
     }
-    // Print out superblock information.
+    // Block bitmaps are read on the first allocation
+    blockMaps = new Vector<BitArray *>(LINN_GROUP_COUNT(&super));
+    assert(blockMaps != NULL);
+    blockMaps->fill(ZERO);
+
+    // Mount for writing if the storage accepts the updated superblock.
+    // Older revisions did not maintain the block bitmaps correctly.
+    // Storage may only accept whole blocks, thus write the block containing the superblock.
+    if (super.minorRevision >= LINN_SUPER_MINOR_WRITE)
+    {
+        static u8 block[LINN_MAX_BLOCK_SIZE];
+        const u64 superOffset = LINN_SUPER_OFFSET - (LINN_SUPER_OFFSET % super.blockSize);
+
+        super.mountCount++;
 
+        if (cache->read(superOffset, block, super.blockSize) == FileSystem::Success)
+        {
+            MemoryBlock::copy(block + (LINN_SUPER_OFFSET % super.blockSize), &super, sizeof(super));
+            writable = s->write(superOffset, block, super.blockSize) == FileSystem::Success;
+        }
+
+        if (!writable)
+        {
+            super.mountCount--;
+        }
+    }
+
+    // Print out superblock information.
     INFO(LINN_GROUP_COUNT(&super) << " group descriptors");
     INFO(super.inodesCount - super.freeInodesCount << " inodes, " <<
          super.blocksCount - super.freeBlocksCount << " blocks");
@@ -76,8 +119,35 @@ LinnFileSystem::LinnFileSystem(const char *p, Storage *s)
     assert(dir != NULL);
     setRoot(dir);
 
+    // Publish block cache counters. Use inode numbers outside the on-disk inode range.
+    Directory *sys = new Directory(super.inodesCount);
+    assert(sys != NULL);
+
+    if (registerDirectory(sys, "sys") != FileSystem::Success ||
+        registerFile(new LinnBlockCacheFile(super.inodesCount + 1, cache),
+                     "sys/blockcache") != FileSystem::Success)
+    {
+        ERROR("failed to register block cache counters");
+    }
+
+    // Publish the kernel event trace
+    if (registerFile(new TraceFile(super.inodesCount + 2), "sys/trace") != FileSystem::Success)
+    {
+        ERROR("failed to register kernel trace");
+    }
+    nextInode = super.inodesCount + 3;
+
     // Done.
-    NOTICE("mounted at " << p);
+    NOTICE("mounted at " << p << (writable ? " read-write" : " read-only"));
+}
+
+u32 LinnFileSystem::getNextInode()
+{
+    // Ensure that the inode is not already used
+    while (m_inodeMap.get(nextInode) != ZERO)
+        nextInode++;
+
+    return nextInode++;
 }
 
 LinnInode * LinnFileSystem::getInode(u32 inodeNum)
@@ -105,11 +175,10 @@ LinnInode * LinnFileSystem::getInode(u32 inodeNum)
     // Allocate inode buffer.
     inode  = new LinnInode;
     assert(inode != NULL);
-    offset = (group->inodeTable * super.blockSize) +
-                ((inodeNum % super.inodesPerGroup) * sizeof(LinnInode));
+    offset = getInodeOffset(group, inodeNum);
 
     // Read inode from storage.
-    if ((e = storage->read(offset, inode, sizeof(LinnInode))) != FileSystem::Success)
+    if ((e = cache->read(offset, inode, sizeof(LinnInode))) != FileSystem::Success)
     {
         ERROR("reading inode failed: result = " << (int) e);
         return ZERO;
@@ -119,6 +188,25 @@ LinnInode * LinnFileSystem::getInode(u32 inodeNum)
     return inode;
 }
 
+FileSystem::Result LinnFileSystem::writeInode(const u32 inodeNum)
+{
+    LinnInode * const *inode = inodes.get(inodeNum);
+    LinnGroup *group = getGroupByInode(inodeNum);
+
+    if (inode == ZERO || group == ZERO)
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    return cache->write(getInodeOffset(group, inodeNum), *inode, sizeof(LinnInode));
+}
+
+u64 LinnFileSystem::getInodeOffset(const LinnGroup *group, const u32 inodeNum) const
+{
+    return ((u64) group->inodeTable * super.blockSize) +
+           ((inodeNum % super.inodesPerGroup) * sizeof(LinnInode));
+}
+
 LinnGroup * LinnFileSystem::getGroup(u32 groupNum)
 {
     return (*groups)[groupNum];
@@ -141,6 +229,12 @@ u64 LinnFileSystem::getOffsetRange(const LinnInode *inode,
 
     assert(LINN_SUPER_NUM_PTRS(&super) <= sizeof(block) / sizeof(u32));
 
+    // Extents map whole runs of blocks at once.
+    if (inode->flags & LINN_INODE_EXTENTS)
+    {
+        return getExtentRange(inode, blk, numContiguous);
+    }
+
     // Direct blocks.
     if (blk < LINN_INODE_DIR_BLOCKS)
     {
@@ -181,7 +275,7 @@ u64 LinnFileSystem::getOffsetRange(const LinnInode *inode,
     while (true)
     {
         // Fetch block.
-        if (storage->read(offset, block, super.blockSize) != FileSystem::Success)
+        if (cache->read(offset, block, super.blockSize) != FileSystem::Success)
         {
             return 0;
         }
@@ -220,8 +314,366 @@ u64 LinnFileSystem::getOffsetRange(const LinnInode *inode,
     return offsetBlock * super.blockSize;
 }
 
+u64 LinnFileSystem::getExtentRange(const LinnInode *inode,
+                                   const u32 blk,
+                                   Size & numContiguous)
+{
+    static LinnExtent extents[LINN_MAX_BLOCK_SIZE / sizeof(LinnExtent)];
+    const LinnExtent *inlineExtents = LINN_INODE_EXTENT_LIST(inode);
+    const Size count = inode->block[LINN_INODE_EXTENT_COUNT];
+    const LinnExtent *extent = ZERO;
+    u32 first = 0;
+
+    // Search the extents stored in the inode.
+    for (Size i = 0; i < count && i < LINN_INODE_INLINE_EXTENTS; i++)
+    {
+        if (blk < first + inlineExtents[i].count)
+        {
+            extent = &inlineExtents[i];
+            break;
+        }
+        first += inlineExtents[i].count;
+    }
+
+    // Search the extent block.
+    if (extent == ZERO && count > LINN_INODE_INLINE_EXTENTS)
+    {
+        const Size numExtents = count - LINN_INODE_INLINE_EXTENTS;
+        const u64 offset = (u64) inode->block[LINN_INODE_EXTENT_BLOCK] * super.blockSize;
+
+        if (numExtents > LINN_EXTENTS_PER_BLOCK(&super) ||
+            cache->read(offset, extents, super.blockSize) != FileSystem::Success)
+        {
+            ERROR("failed to read extent block " << inode->block[LINN_INODE_EXTENT_BLOCK]);
+            numContiguous = 1;
+            return 0;
+        }
+
+        for (Size i = 0; i < numExtents; i++)
+        {
+            if (blk < first + extents[i].count)
+            {
+                extent = &extents[i];
+                break;
+            }
+            first += extents[i].count;
+        }
+    }
+
+    if (extent == ZERO)
+    {
+        ERROR("block " << blk << " is outside the extents");
+        numContiguous = 1;
+        return 0;
+    }
+
+    // The remainder of the extent is contiguous in storage.
+    numContiguous = extent->count - (blk - first);
+    return (u64) (extent->block + (blk - first)) * super.blockSize;
+}
+
+FileSystem::Result LinnFileSystem::readChunk(const u32 inodeNum,
+                                             const LinnInode *inode,
+                                             const Size chunk,
+                                             const u8 * & data)
+{
+    const Size chunkOffset = chunk * LINN_COMPRESS_CHUNK_SIZE;
+    const Size chunkSize = inode->size - chunkOffset < LINN_COMPRESS_CHUNK_SIZE ?
+                           inode->size - chunkOffset : LINN_COMPRESS_CHUNK_SIZE;
+    le32 range[2];
+
+    // Reuse the last decompressed chunk
+    if (chunkInode == inodeNum && chunkIndex == chunk && chunkData != ZERO)
+    {
+        data = chunkData;
+        return FileSystem::Success;
+    }
+
+    if (chunkData == ZERO)
+    {
+        chunkInput = new u8[LINN_COMPRESS_FRAME_SIZE];
+        assert(chunkInput != NULL);
+        chunkData = new u8[LINN_COMPRESS_CHUNK_SIZE];
+        assert(chunkData != NULL);
+    }
+
+    // Find the frame in the chunk table
+    FileSystem::Result result = readStored(inode, chunk * sizeof(le32), range, sizeof(range));
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+
+    if (range[1] <= range[0] || range[1] - range[0] > LINN_COMPRESS_FRAME_SIZE)
+    {
+        ERROR("invalid chunk " << chunk << " of inode " << inodeNum);
+        return FileSystem::IOError;
+    }
+
+    // Read the compressed data through the block cache
+    result = readStored(inode, range[0], chunkInput, range[1] - range[0]);
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+
+    // The buffer no longer contains the previous chunk
+    chunkInode = 0;
+
+    Lz4Decompressor lz4(chunkInput, range[1] - range[0]);
+    if (lz4.initialize() != Lz4Decompressor::Success ||
+        lz4.getUncompressedSize() != chunkSize ||
+        lz4.read(chunkData, chunkSize) != Lz4Decompressor::Success)
+    {
+        ERROR("failed to decompress chunk " << chunk << " of inode " << inodeNum);
+        return FileSystem::IOError;
+    }
+
+    chunkInode = inodeNum;
+    chunkIndex = chunk;
+    data = chunkData;
+    return FileSystem::Success;
+}
+
+FileSystem::Result LinnFileSystem::readStored(const LinnInode *inode,
+                                              const u64 offset,
+                                              void *buffer,
+                                              const Size size)
+{
+    u8 *dst = (u8 *) buffer;
+    Size copied = 0;
+
+    while (copied < size)
+    {
+        const u64 position = offset + copied;
+        const Size blockOffset = position % super.blockSize;
+        Size blockCount;
+
+        const u64 storageOffset = getExtentRange(inode, position / super.blockSize, blockCount);
+        if (storageOffset == 0)
+        {
+            return FileSystem::IOError;
+        }
+
+        // Copy up to the end of the extent, which is also read ahead
+        Size bytes = (blockCount * super.blockSize) - blockOffset;
+        if (bytes > size - copied)
+        {
+            bytes = size - copied;
+        }
+
+        const FileSystem::Result result = cache->tryRead(storageOffset + blockOffset,
+                                                         dst + copied, bytes, blockCount);
+        copied += bytes;
+
+        if (result != FileSystem::Success)
+        {
+            return result;
+        }
+    }
+
+    return FileSystem::Success;
+}
+
+bool LinnFileSystem::isWritable() const
+{
+    return writable;
+}
+
+FileSystem::Result LinnFileSystem::allocateBlocks(const u32 goal,
+                                                  const Size count,
+                                                  u32 & block,
+                                                  Size & allocated)
+{
+    const u64 storageBlocks = storage->capacity() / super.blockSize;
+    u64 limit = (u64) LINN_GROUP_COUNT(&super) * super.blocksPerGroup;
+    bool found = false;
+
+    // Only use blocks which exist in the groups and in storage
+    if (limit > super.blocksCount)
+        limit = super.blocksCount;
+    if (limit > storageBlocks)
+        limit = storageBlocks;
+
+    if (!writable)
+    {
+        return FileSystem::PermissionDenied;
+    }
+
+    // Search the first free block, starting at the goal
+    for (u64 i = 0; i < limit && !found; i++)
+    {
+        const u32 number = (goal + i) % limit;
+        const BitArray *map = getBlockMap(number / super.blocksPerGroup);
+
+        if (map == ZERO)
+        {
+            return FileSystem::IOError;
+        }
+        else if (!map->isSet(number % super.blocksPerGroup))
+        {
+            block = number;
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        ERROR("no free blocks remaining");
+        return FileSystem::IOError;
+    }
+
+    // Take the free blocks following it. The bitmaps are written on the next flush.
+    for (allocated = 0; allocated < count && block + allocated < limit; allocated++)
+    {
+        const u32 number = block + allocated;
+        const u32 groupNum = number / super.blocksPerGroup;
+        BitArray *map = getBlockMap(groupNum);
+
+        if (map == ZERO || map->isSet(number % super.blocksPerGroup))
+        {
+            break;
+        }
+
+        map->set(number % super.blocksPerGroup);
+        getGroup(groupNum)->freeBlocksCount--;
+        super.freeBlocksCount--;
+
+        if (!dirtyGroups.contains(groupNum))
+        {
+            dirtyGroups.append(groupNum);
+        }
+    }
+
+    return FileSystem::Success;
+}
+
+BitArray * LinnFileSystem::getBlockMap(const u32 groupNum)
+{
+    BitArray *map = (*blockMaps)[groupNum];
+
+    if (map == ZERO)
+    {
+        const LinnGroup *group = getGroup(groupNum);
+        const Size bytes = (super.blocksPerGroup + 7) / 8;
+
+        map = new BitArray(super.blocksPerGroup);
+        assert(map != NULL);
+
+        const FileSystem::Result result =
+            cache->read((u64) group->blockMap * super.blockSize, map->array(), bytes);
+        if (result != FileSystem::Success)
+        {
+            ERROR("failed to read block bitmap of group " << groupNum << ": result = " << (int) result);
+            delete map;
+            return ZERO;
+        }
+        blockMaps->insert(groupNum, map);
+    }
+
+    return map;
+}
+
+void LinnFileSystem::fileModified(LinnFile *file)
+{
+    if (!dirtyFiles.contains(file))
+    {
+        dirtyFiles.append(file);
+    }
+
+    // An earlier timeout flushes as well
+    if (!hasTimeout())
+    {
+        setTimeout(LINN_FLUSH_INTERVAL, LINN_FLUSH_INTERVAL / 2);
+    }
+}
+
+FileSystem::Result LinnFileSystem::flushFile(LinnFile *file)
+{
+    if (!dirtyFiles.contains(file))
+    {
+        return FileSystem::Success;
+    }
+
+    dirtyFiles.remove(file);
+    return file->flush();
+}
+
+FileSystem::Result LinnFileSystem::flush()
+{
+    FileSystem::Result result = FileSystem::Success;
+
+    // Allocate the delayed blocks of the modified files
+    for (ListIterator<LinnFile *> i(dirtyFiles); i.hasCurrent(); i++)
+    {
+        const FileSystem::Result fileResult = i.current()->flush();
+        if (fileResult != FileSystem::Success)
+        {
+            ERROR("failed to flush inode " << i.current()->getInode() <<
+                  ": result = " << (int) fileResult);
+            result = fileResult;
+        }
+    }
+    dirtyFiles.clear();
+
+    // Update the block bitmaps and group descriptors of all allocations at once
+    if (dirtyGroups.count() > 0)
+    {
+        for (ListIterator<u32> i(dirtyGroups); i.hasCurrent(); i++)
+        {
+            const u32 groupNum = i.current();
+            const LinnGroup *group = getGroup(groupNum);
+            const BitArray *map = (*blockMaps)[groupNum];
+
+            if (cache->write((u64) group->blockMap * super.blockSize, map->array(),
+                             (super.blocksPerGroup + 7) / 8) != FileSystem::Success ||
+                cache->write(((u64) super.groupsTable * super.blockSize) +
+                             (sizeof(LinnGroup) * groupNum), group,
+                             sizeof(LinnGroup)) != FileSystem::Success)
+            {
+                ERROR("failed to write group descriptor " << groupNum);
+                result = FileSystem::IOError;
+            }
+        }
+        dirtyGroups.clear();
+
+        if (cache->write(LINN_SUPER_OFFSET, &super, sizeof(super)) != FileSystem::Success)
+        {
+            ERROR("failed to write superblock");
+            result = FileSystem::IOError;
+        }
+    }
+
+    // Write back all dirty blocks
+    const FileSystem::Result cacheResult = cache->flush();
+    if (cacheResult != FileSystem::Success)
+    {
+        ERROR("failed to write back block cache: result = " << (int) cacheResult);
+        result = cacheResult;
+    }
+
+    return result;
+}
+
+void LinnFileSystem::timeout()
+{
+    FileSystemServer::timeout();
+
+    // Try again later if not all data could be written
+    if (flush() != FileSystem::Success && !hasTimeout())
+    {
+        setTimeout(LINN_FLUSH_INTERVAL, LINN_FLUSH_INTERVAL / 2);
+    }
+}
+
 void LinnFileSystem::notSupportedHandler(FileSystemMessage *msg)
 {
     msg->result = FileSystem::NotSupported;
     sendResponse(msg);
 }
+
+void LinnFileSystem::blocksReady(LinnBlockCache *blockCache)
+{
+    // Retry the reads which wait for blocks
+    notifyAllFiles();
+}
@@ -22,11 +22,15 @@
 #include <FileSystemMessage.h>
 #include <Storage.h>
 #include <Types.h>
+#include <Callback.h>
 #include <Vector.h>
+#include <List.h>
 #include <HashTable.h>
+#include <BitArray.h>
 #include "LinnSuperBlock.h"
 #include "LinnInode.h"
 #include "LinnGroup.h"
+#include "LinnBlockCache.h"
 
 /**
  * @addtogroup server
@@ -50,12 +54,21 @@
 /** Maximum blocksize. */
 #define LINN_MAX_BLOCK_SIZE 4096
 
+/** Size in bytes of the block buffer cache. */
+#define LINN_CACHE_SIZE (512 * 1024)
+
+/** Milliseconds after a write before modified data is written back to storage. */
+#define LINN_FLUSH_INTERVAL 5000
+
 /**
  * @}
  */
 
 #ifndef __HOST__
 
+/* Forward declarations */
+class LinnFile;
+
 /**
  * @brief Linnenbank FileSystem (LinnFS).
  *
@@ -65,7 +78,13 @@
  * static in size, i.e. 64-bytes. Those changes make it easier to program
  * the FileSystem implementation, thus easier to understand and learn from.
  *
- * @todo Currently the LinnFileSystem is read-only and does not support writing.
+ * Existing files can be written when the storage accepts writes. Writes
+ * are buffered: new blocks of a file are only allocated when it is flushed,
+ * such that data written in pieces ends up in a single contiguous extent.
+ * Modified blocks, bitmaps and group descriptors are written back to storage
+ * together, after LINN_FLUSH_INTERVAL or once the block cache fills up.
+ *
+ * @todo Creating and removing files is not supported.
  *
  * @see FileSystemServer
  * @see Ext2FileSystem
@@ -94,6 +113,15 @@ class LinnFileSystem : public FileSystemServer
         return &super;
     }
 
+    /**
+     * Get next unused inode
+     *
+     * Pseudo files use inode numbers beyond the on-disk inodes.
+     *
+     * @return Inode number
+     */
+    virtual u32 getNextInode();
+
     /**
      * Get the underlying Storage object.
      *
@@ -106,6 +134,18 @@ class LinnFileSystem : public FileSystemServer
         return storage;
     }
 
+    /**
+     * Get the block buffer cache.
+     *
+     * @return LinnBlockCache pointer.
+     *
+     * @see LinnBlockCache
+     */
+    LinnBlockCache * getBlockCache()
+    {
+        return cache;
+    }
+
     /**
      * Read an inode from the filesystem.
      *
@@ -156,6 +196,98 @@ class LinnFileSystem : public FileSystemServer
                        const u32 blk,
                        Size & numContiguous);
 
+    /**
+     * Get a decompressed chunk of a compressed inode.
+     *
+     * The compressed data is read through the block cache without
+     * blocking. The last decompressed chunk is kept, such that
+     * sequential reads decompress each chunk only once.
+     *
+     * @param inodeNum Inode number.
+     * @param inode LinnInode pointer with the LINN_INODE_COMPRESSED flag.
+     * @param chunk Chunk number.
+     * @param data Pointer to the uncompressed chunk data on output.
+     *
+     * @return Result code, where RetryAgain indicates that the compressed data is being fetched
+     */
+    FileSystem::Result readChunk(const u32 inodeNum,
+                                 const LinnInode *inode,
+                                 const Size chunk,
+                                 const u8 * & data);
+
+    /**
+     * Check if the filesystem is mounted for writing.
+     *
+     * @return True if files can be written
+     */
+    bool isWritable() const;
+
+    /**
+     * Allocate contiguous free blocks.
+     *
+     * Searches for a free block starting at the given goal and
+     * allocates as many free blocks following it as possible. The block
+     * bitmaps are written back to storage on the next flush().
+     *
+     * @param goal Preferred first block number, e.g. following the last block of a file
+     * @param count Maximum number of blocks to allocate
+     * @param block Number of the first allocated block on output
+     * @param allocated Number of allocated blocks on output, at least one on success
+     *
+     * @return Result code
+     */
+    FileSystem::Result allocateBlocks(const u32 goal,
+                                      const Size count,
+                                      u32 & block,
+                                      Size & allocated);
+
+    /**
+     * Write a cached inode to the block cache.
+     *
+     * @param inodeNum Inode number.
+     *
+     * @return Result code
+     */
+    FileSystem::Result writeInode(const u32 inodeNum);
+
+    /**
+     * Register a file with data which is not yet written back.
+     *
+     * Schedules a flush after LINN_FLUSH_INTERVAL.
+     *
+     * @param file LinnFile pointer
+     */
+    void fileModified(LinnFile *file);
+
+    /**
+     * Write back a single file, if modified.
+     *
+     * @param file LinnFile pointer
+     *
+     * @return Result code
+     */
+    FileSystem::Result flushFile(LinnFile *file);
+
+    /**
+     * Write back all modified data to storage.
+     *
+     * Allocates the delayed blocks of all modified files, then writes
+     * the block bitmaps, group descriptors, superblock and all dirty
+     * blocks in the cache.
+     *
+     * @return Result code
+     */
+    FileSystem::Result flush();
+
+  protected:
+
+    /**
+     * Called when the sleep timeout is reached.
+     *
+     * Writes back modified data in addition to retrying requests.
+     */
+    virtual void timeout();
+
   private:
 
     /**
@@ -165,6 +297,61 @@ class LinnFileSystem : public FileSystemServer
      */
     void notSupportedHandler(FileSystemMessage *msg);
 
+    /**
+     * Called when the block cache completed an asynchronous fetch
+     *
+     * @param blockCache LinnBlockCache pointer
+     */
+    void blocksReady(LinnBlockCache *blockCache);
+
+    /**
+     * Calculates the offset inside storage for a block of an extent inode.
+     *
+     * @param inode LinnInode pointer with the LINN_INODE_EXTENTS flag.
+     * @param blk Calculate the offset for this block.
+     * @param numContiguous Number of contiguous blocks in the same extent
+     *                      starting at the given offset.
+     *
+     * @return Offset in bytes in storage.
+     */
+    u64 getExtentRange(const LinnInode *inode,
+                       const u32 blk,
+                       Size & numContiguous);
+
+    /**
+     * Read the stored data of an extent inode without blocking.
+     *
+     * @param inode LinnInode pointer with the LINN_INODE_EXTENTS flag.
+     * @param offset Offset in the stored data.
+     * @param buffer Output buffer.
+     * @param size Number of bytes to read.
+     *
+     * @return Result code, where RetryAgain indicates that the data is being fetched
+     */
+    FileSystem::Result readStored(const LinnInode *inode,
+                                  const u64 offset,
+                                  void *buffer,
+                                  const Size size);
+
+    /**
+     * Get the block bitmap of a group, reading it on first use.
+     *
+     * @param groupNum Group descriptor number.
+     *
+     * @return BitArray pointer on success, ZERO on failure.
+     */
+    BitArray * getBlockMap(const u32 groupNum);
+
+    /**
+     * Calculate the offset of an inode in storage.
+     *
+     * @param group Group descriptor of the inode.
+     * @param inodeNum Inode number.
+     *
+     * @return Offset in bytes in storage.
+     */
+    u64 getInodeOffset(const LinnGroup *group, const u32 inodeNum) const;
+
   private:
 
     /** Provides storage. */
@@ -178,6 +365,39 @@ class LinnFileSystem : public FileSystemServer
 
     /** Inode cache. */
     HashTable<u32, LinnInode *> inodes;
+
+    /** Block buffer cache. */
+    LinnBlockCache *cache;
+
+    /** Executes blocksReady() */
+    Callback<LinnFileSystem, LinnBlockCache> blocksReadyCallback;
+
+    /** True if the storage accepts writes. */
+    bool writable;
+
+    /** Block bitmaps per group, ZERO until used. */
+    Vector<BitArray *> *blockMaps;
+
+    /** Groups with modified block bitmaps. */
+    List<u32> dirtyGroups;
+
+    /** Files with data which is not yet written back. */
+    List<LinnFile *> dirtyFiles;
+
+    /** LZ4 frame of the chunk to decompress. */
+    u8 *chunkInput;
+
+    /** Last decompressed chunk, ZERO until used. */
+    u8 *chunkData;
+
+    /** Inode number of the decompressed chunk, or zero (the root directory) if none. */
+    u32 chunkInode;
+
+    /** Chunk number of the decompressed chunk. */
+    Size chunkIndex;
+
+    /** Next inode number to try for pseudo files. */
+    u32 nextInode;
 };
 
 #endif /* __HOST__ */
@@ -60,6 +60,97 @@
 /** Total number of block pointers in an LinnInode. */
 #define LINN_INODE_BLOCKS       (LINN_INODE_TIND_BLOCKS + 1)
 
+/**
+ * @}
+ */
+
+/**
+ * @name Inode flags.
+ * @{
+ */
+
+/** The block pointers of the inode hold extents. */
+#define LINN_INODE_EXTENTS      (1 << 0)
+
+/** The data is stored as LZ4 compressed chunks. Requires LINN_INODE_EXTENTS. */
+#define LINN_INODE_COMPRESSED   (1 << 1)
+
+/**
+ * @}
+ */
+
+/**
+ * @name Inode extents.
+ *
+ * Inodes with the LINN_INODE_EXTENTS flag describe their blocks
+ * with a list of extents in file order. The first extents are
+ * stored in the inode itself, any following extents in a single
+ * extent block.
+ *
+ * @{
+ */
+
+/** Number of extents stored in the inode. */
+#define LINN_INODE_INLINE_EXTENTS   3
+
+/** Index of the block pointer with the extent block. */
+#define LINN_INODE_EXTENT_BLOCK     6
+
+/** Index of the block pointer with the total number of extents. */
+#define LINN_INODE_EXTENT_COUNT     7
+
+/**
+ * Calculate the number of extents which fit in an extent block.
+ *
+ * @param super LinnSuperBlock pointer.
+ *
+ * @return Number of extents.
+ */
+#define LINN_EXTENTS_PER_BLOCK(super) \
+    ((super)->blockSize / sizeof(LinnExtent))
+
+/**
+ * Get the inline extents of an LinnInode.
+ *
+ * @param inode LinnInode pointer.
+ *
+ * @return LinnExtent pointer.
+ */
+#define LINN_INODE_EXTENT_LIST(inode) \
+    ((LinnExtent *) (inode)->block)
+
+/**
+ * @}
+ */
+
+/**
+ * @name Compressed inodes.
+ *
+ * Inodes with the LINN_INODE_COMPRESSED flag store their data in chunks
+ * of LINN_COMPRESS_CHUNK_SIZE bytes, each compressed into a separate LZ4 frame.
+ * The stored data starts with a table of LINN_INODE_NUM_CHUNKS() + 1 offsets,
+ * which gives the start of each frame and the end of the last frame. The
+ * size of the inode is the uncompressed size.
+ *
+ * @{
+ */
+
+/** Number of uncompressed bytes per chunk. */
+#define LINN_COMPRESS_CHUNK_SIZE    (32 * 1024)
+
+/** Maximum size of the LZ4 frame of a chunk. Chunks which do not compress are stored as-is. */
+#define LINN_COMPRESS_FRAME_SIZE    (LINN_COMPRESS_CHUNK_SIZE + 64)
+
+/**
+ * Calculate the number of chunks of a compressed LinnInode.
+ *
+ * @param inode LinnInode pointer.
+ *
+ * @return Number of chunks.
+ */
+#define LINN_INODE_NUM_CHUNKS(inode) \
+    (((inode)->size + LINN_COMPRESS_CHUNK_SIZE - 1) / LINN_COMPRESS_CHUNK_SIZE)
+
 /**
  * @}
  */
@@ -86,6 +177,16 @@
  * @}
  */
 
+/**
+ * Contiguous run of blocks of an inode.
+ */
+typedef struct LinnExtent
+{
+    le32 block;         /**< First block number in storage. */
+    le32 count;         /**< Number of contiguous blocks. */
+}
+LinnExtent;
+
 /**
  * Structure of an inode on the disk in the LinnFS filesystem.
  */
@@ -101,6 +202,7 @@ typedef struct LinnInode
     le32 modifyTime;    /**< Modification time. */
     le32 changeTime;    /**< Status change timestamp. */
     le16 links;         /**< Links count. */
+    le16 flags;         /**< Inode flags. */
     le32 block[LINN_INODE_BLOCKS]; /**< Pointers to blocks. */
 }
 LinnInode;
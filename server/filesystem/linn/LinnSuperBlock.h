@@ -51,8 +51,15 @@
 /** Current major revision number. */
 #define LINN_SUPER_MAJOR        1
 
-/** Current minor revision number. */
-#define LINN_SUPER_MINOR        0
+/**
+ * Current minor revision number. Revision 1 adds hashed directory indexes,
+ * revision 2 extent inodes, revision 3 correct block bitmaps, which are required
+ * for writing, and revision 4 compressed inodes.
+ */
+#define LINN_SUPER_MINOR        4
+
+/** First minor revision which can be mounted for writing. */
+#define LINN_SUPER_MINOR_WRITE  3
 
 /**
  * @}
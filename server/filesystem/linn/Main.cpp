@@ -30,8 +30,8 @@ int main(int argc, char **argv)
     const char *path = "/";
     SystemInformation info;
 
-    // Only run on core0
-    if (info.coreId != 0)
+    // Secondary cores only run a replica of the BootImage embedded rootfs
+    if (info.coreId != 0 && argc > 3)
         return 0;
 
     // Mount the given file, or try to use the BootImage embedded rootfs
@@ -43,6 +43,13 @@ int main(int argc, char **argv)
         storage = new FileStorage(argv[1], offset);
         assert(storage != NULL);
         path = argv[3];
+
+        const FileSystem::Result fileResult = storage->initialize();
+        if (fileResult != FileSystem::Success)
+        {
+            FATAL("unable to open file storage '" << argv[1] <<
+                  "': result = " << (int) fileResult);
+        }
     }
     else
     {
@@ -77,6 +84,16 @@ int main(int argc, char **argv)
     if (storage)
     {
         LinnFileSystem server(path, storage);
+
+        // Each secondary core has its own copy of the BootImage. Serve it
+        // read-only, such that local processes can read files without
+        // crossing cores and the replicas cannot diverge.
+        if (info.coreId != 0)
+        {
+            NOTICE("read-only replica on core" << info.coreId);
+            server.setReadOnly(true);
+        }
+
         server.mount();
         return server.run();
     }
@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include <IOBuffer.h>
+#include "TmpFile.h"
+
+TmpFile::TmpFile(const u32 inode)
+    : File(inode, FileSystem::RegularFile)
+    , m_root(ZERO)
+    , m_height(0)
+    , m_pageCount(0)
+{
+    m_access = FileSystem::OwnerRW;
+}
+
+TmpFile::~TmpFile()
+{
+    releasePages(&m_root, m_height, 0, 0);
+}
+
+Size TmpFile::getPageCount() const
+{
+    return m_pageCount;
+}
+
+FileSystem::Result TmpFile::read(IOBuffer & buffer,
+                                 Size & size,
+                                 const Size offset)
+{
+    static const u8 zeroPage[PageSize] = { 0 };
+    IOBuffer::Segment segments[IOBuffer::MaximumSegments];
+    Size count = 0;
+
+    // Bounds checking
+    if (offset >= m_size)
+    {
+        size = 0;
+        return FileSystem::Success;
+    }
+
+    // How much bytes to copy?
+    const Size bytes = m_size - offset > size ? size : m_size - offset;
+
+    // Collect the pages to copy, where holes read as zeroes
+    for (Size copied = 0; copied < bytes;)
+    {
+        const Size position = offset + copied;
+        const Size pageOffset = position % PageSize;
+        const Size chunk = PageSize - pageOffset < bytes - copied ?
+                           PageSize - pageOffset : bytes - copied;
+        const u8 *page = findPage(position / PageSize);
+
+        segments[count].buffer = page ? (Address) (page + pageOffset) : (Address) zeroPage;
+        segments[count].size   = chunk;
+        segments[count].offset = copied;
+        copied += chunk;
+
+        // Write the collected pages at once
+        if (++count == IOBuffer::MaximumSegments)
+        {
+            const FileSystem::Result result = buffer.writeVector(segments, count);
+            if (result != FileSystem::Success)
+                return result;
+            count = 0;
+        }
+    }
+
+    size = bytes;
+    return count ? buffer.writeVector(segments, count) : FileSystem::Success;
+}
+
+FileSystem::Result TmpFile::write(IOBuffer & buffer,
+                                  Size & size,
+                                  const Size offset)
+{
+    IOBuffer::Segment segments[IOBuffer::MaximumSegments];
+    Size count = 0;
+
+    // The end of the write must be representable
+    if (offset + size < offset)
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    // Collect the pages to fill, allocating them as needed
+    for (Size copied = 0; copied < size;)
+    {
+        const Size position = offset + copied;
+        const Size pageOffset = position % PageSize;
+        const Size chunk = PageSize - pageOffset < size - copied ?
+                           PageSize - pageOffset : size - copied;
+        u8 *page = allocatePage(position / PageSize);
+
+        if (!page)
+        {
+            return FileSystem::IOError;
+        }
+
+        segments[count].buffer = (Address) (page + pageOffset);
+        segments[count].size   = chunk;
+        segments[count].offset = copied;
+        copied += chunk;
+
+        // Read the collected pages at once
+        if (++count == IOBuffer::MaximumSegments)
+        {
+            const FileSystem::Result result = buffer.readVector(segments, count);
+            if (result != FileSystem::Success)
+                return result;
+            count = 0;
+        }
+    }
+
+    if (count)
+    {
+        const FileSystem::Result result = buffer.readVector(segments, count);
+        if (result != FileSystem::Success)
+            return result;
+    }
+
+    // Extend the file, if needed
+    if (offset + size > m_size)
+    {
+        m_size = offset + size;
+    }
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result TmpFile::truncate(const Size size)
+{
+    if (size < m_size)
+    {
+        const Size pageOffset = size % PageSize;
+
+        releasePages(&m_root, m_height, 0, (size + PageSize - 1) / PageSize);
+
+        // Clear the end of the last page, such that growing the file reads zeroes
+        if (pageOffset)
+        {
+            u8 *page = findPage(size / PageSize);
+            if (page)
+            {
+                MemoryBlock::set(page + pageOffset, 0, PageSize - pageOffset);
+            }
+        }
+    }
+
+    m_size = size;
+    return FileSystem::Success;
+}
+
+u8 * TmpFile::findPage(const Size index) const
+{
+    void *slot = m_root;
+
+    // Pages beyond the tree are not allocated
+    if (index >> (m_height * NodeShift))
+    {
+        return ZERO;
+    }
+
+    for (Size level = m_height; level > 0 && slot != ZERO; level--)
+    {
+        const Size shift = (level - 1) * NodeShift;
+        slot = static_cast<Node *>(slot)->slots[(index >> shift) & (NodeSize - 1)];
+    }
+
+    return static_cast<u8 *>(slot);
+}
+
+u8 * TmpFile::allocatePage(const Size index)
+{
+    void **slot = &m_root;
+
+    // Add levels on top of the tree until it covers the page
+    while (index >> (m_height * NodeShift))
+    {
+        if (m_root)
+        {
+            Node *node = new Node;
+            if (!node)
+            {
+                return ZERO;
+            }
+            MemoryBlock::set(node, 0, sizeof(Node));
+            node->slots[0] = m_root;
+            m_root = node;
+        }
+        m_height++;
+    }
+
+    // Walk down the tree, adding missing nodes
+    for (Size level = m_height; level > 0; level--)
+    {
+        const Size shift = (level - 1) * NodeShift;
+
+        if (!*slot)
+        {
+            Node *node = new Node;
+            if (!node)
+            {
+                return ZERO;
+            }
+            MemoryBlock::set(node, 0, sizeof(Node));
+            *slot = node;
+        }
+        slot = &static_cast<Node *>(*slot)->slots[(index >> shift) & (NodeSize - 1)];
+    }
+
+    // Allocate the page itself
+    if (!*slot)
+    {
+        u8 *page = new u8[PageSize];
+        if (!page)
+        {
+            return ZERO;
+        }
+        MemoryBlock::set(page, 0, PageSize);
+        *slot = page;
+        m_pageCount++;
+    }
+
+    return static_cast<u8 *>(*slot);
+}
+
+void TmpFile::releasePages(void **slot,
+                           const Size height,
+                           const Size base,
+                           const Size first)
+{
+    if (!*slot)
+    {
+        return;
+    }
+
+    // Release the page itself
+    if (height == 0)
+    {
+        if (base >= first)
+        {
+            delete[] static_cast<u8 *>(*slot);
+            *slot = ZERO;
+            m_pageCount--;
+        }
+        return;
+    }
+
+    // Release pages of the children which are (partly) after the first page
+    Node *node = static_cast<Node *>(*slot);
+    const Size span = (Size) 1 << ((height - 1) * NodeShift);
+
+    for (Size i = 0; i < NodeSize; i++)
+    {
+        if (base + ((i + 1) * span) > first)
+        {
+            releasePages(&node->slots[i], height - 1, base + (i * span), first);
+        }
+    }
+
+    // Release the node when all of its pages are released
+    if (base >= first)
+    {
+        delete node;
+        *slot = ZERO;
+    }
+}
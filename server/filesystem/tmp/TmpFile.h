@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FILESYSTEM_TMPFILE_H
+#define __FILESYSTEM_TMPFILE_H
+
+#include <File.h>
+#include <Types.h>
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup tmpfs
+ * @{
+ */
+
+/**
+ * Regular file in the TmpFileSystem.
+ *
+ * File contents are stored in page sized chunks, which are kept in
+ * a radix tree indexed by page number. Writes only allocate the pages
+ * they touch, such that appending never copies existing contents.
+ * Pages which were never written are not allocated and read as zeroes.
+ */
+class TmpFile : public File
+{
+  private:
+
+    /** Size of a single chunk of file data. */
+    static const Size PageSize = 4096U;
+
+    /** Number of bits of the page number resolved per tree level. */
+    static const Size NodeShift = 6U;
+
+    /** Number of child pointers in each tree node. */
+    static const Size NodeSize = (1U << NodeShift);
+
+    /**
+     * Interior node of the radix tree.
+     */
+    typedef struct Node
+    {
+        /** Child nodes, or pages on the lowest level. */
+        void *slots[NodeSize];
+    }
+    Node;
+
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param inode Inode number for this File
+     */
+    TmpFile(const u32 inode);
+
+    /**
+     * Destructor.
+     */
+    virtual ~TmpFile();
+
+    /**
+     * Get the number of allocated pages.
+     *
+     * @return Number of pages holding file data
+     */
+    Size getPageCount() const;
+
+    /**
+     * Read bytes from the file.
+     *
+     * @param buffer Input/Output buffer to output bytes to.
+     * @param size Maximum number of bytes to read on input.
+     *             On output, the actual number of bytes read.
+     * @param offset Offset inside the file to start reading.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result read(IOBuffer & buffer,
+                                    Size & size,
+                                    const Size offset);
+
+    /**
+     * Write bytes to the file.
+     *
+     * @param buffer Input/Output buffer to input bytes from.
+     * @param size Maximum number of bytes to write on input.
+     *             On output, the actual number of bytes written.
+     * @param offset Offset inside the file to start writing.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result write(IOBuffer & buffer,
+                                     Size & size,
+                                     const Size offset);
+
+    /**
+     * Change the size of the file.
+     *
+     * Pages beyond the new size are released. Growing the file
+     * does not allocate pages, its new contents read as zeroes.
+     *
+     * @param size New size of the file in bytes
+     *
+     * @return Result code
+     */
+    FileSystem::Result truncate(const Size size);
+
+  private:
+
+    /**
+     * Find an allocated page.
+     *
+     * @param index Page number inside the file
+     *
+     * @return Page pointer or ZERO if not allocated
+     */
+    u8 * findPage(const Size index) const;
+
+    /**
+     * Find or allocate a page.
+     *
+     * @param index Page number inside the file
+     *
+     * @return Page pointer or ZERO if out of memory
+     */
+    u8 * allocatePage(const Size index);
+
+    /**
+     * Release pages from a subtree.
+     *
+     * @param slot Pointer to the subtree root
+     * @param height Number of node levels in the subtree
+     * @param base Page number of the first page in the subtree
+     * @param first Page number of the first page to release
+     */
+    void releasePages(void **slot,
+                      const Size height,
+                      const Size base,
+                      const Size first);
+
+  private:
+
+    /** Root of the radix tree, which is a page if the height is zero. */
+    void *m_root;
+
+    /** Number of node levels in the radix tree. */
+    Size m_height;
+
+    /** Number of allocated pages. */
+    Size m_pageCount;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __FILESYSTEM_TMPFILE_H */
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/System.h>
+#include <Atomic.h>
+#include <string.h>
+#include "IdlePolicy.h"
+
+#if defined(__i386__)
+/** Memory address monitored by MWAIT. Never written. */
+static volatile u32 monitorAddress;
+#endif
+
+IdlePolicy::IdlePolicy(const char *cmdline, const uint coreId)
+    : m_state(IdleHalt)
+    , m_deepHint(0)
+{
+    IdleState global = IdleHalt, local = IdleHalt;
+    bool hasLocal = false;
+
+    // Options are separated by spaces. Per-core options take precedence.
+    for (const char *option = cmdline; *option; )
+    {
+        while (*option == ' ')
+            option++;
+
+        if (strncmp(option, "idle", 4) == 0)
+        {
+            const char *value = option + 4;
+            bool forCore = false;
+            uint core = 0;
+
+            while (*value >= '0' && *value <= '9')
+            {
+                core = (core * 10) + (*value++ - '0');
+                forCore = true;
+            }
+
+            if (*value == '=')
+            {
+                if (!forCore)
+                    parseState(value + 1, &global);
+                else if (core == coreId && parseState(value + 1, &local))
+                    hasLocal = true;
+            }
+        }
+
+        while (*option && *option != ' ')
+            option++;
+    }
+
+    m_state = hasLocal ? local : global;
+
+    // Fall back to halting if the core has no deep idle state
+    if (m_state == IdleDeep && !detectDeep())
+        m_state = IdleHalt;
+}
+
+IdleState IdlePolicy::getState() const
+{
+    return m_state;
+}
+
+void IdlePolicy::enter() const
+{
+    switch (m_state)
+    {
+        case IdlePoll:
+            for (Size i = 0; i < PollIterations; i++)
+                cpuRelax();
+            break;
+
+#if defined(__i386__)
+        case IdleDeep:
+            cpuMwait(&monitorAddress, m_deepHint);
+            break;
+#endif
+
+        default:
+            idle();
+            break;
+    }
+}
+
+bool IdlePolicy::parseState(const char *value, IdleState *state)
+{
+    static const struct
+    {
+        const char *name;
+        IdleState state;
+    }
+    states[] =
+    {
+        { "halt", IdleHalt },
+        { "poll", IdlePoll },
+        { "deep", IdleDeep }
+    };
+
+    for (Size i = 0; i < sizeof(states) / sizeof(states[0]); i++)
+    {
+        const Size length = strlen(states[i].name);
+
+        if (strncmp(value, states[i].name, length) == 0 &&
+           (value[length] == ' ' || value[length] == '\0'))
+        {
+            *state = states[i].state;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool IdlePolicy::detectDeep()
+{
+#if defined(__i386__)
+    const u32 states = cpuMwaitStates();
+
+    // Use the deepest C-state above C1 which has sub-states
+    for (Size cstate = 7; cstate >= 2; cstate--)
+    {
+        if ((states >> (cstate * 4)) & 0xf)
+        {
+            m_deepHint = (cstate - 1) << 4;
+            return true;
+        }
+    }
+#endif
+
+    // Deeper states on ARM are entered with PSCI calls,
+    // which are not available to the unprivileged idle process
+    return false;
+}
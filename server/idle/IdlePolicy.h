@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVER_IDLE_IDLEPOLICY_H
+#define __SERVER_IDLE_IDLEPOLICY_H
+
+#include <FreeNOS/System.h>
+#include <Types.h>
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup idle
+ * @{
+ */
+
+/**
+ * Selects how the idle process of a core waits for interrupts.
+ *
+ * The policy is read from the kernel command line. The option idle=<state>
+ * applies to all cores and idle<N>=<state> to core N only, where state is
+ * one of:
+ *
+ *  - halt: stop the core until the next interrupt (default)
+ *  - poll: spin on the core, for the lowest wakeup latency on dedicated cores
+ *  - deep: enter the deepest processor C-state with MWAIT if available
+ *
+ * The kernel accounts the residency and wakeup latency of each state,
+ * which are reported by SystemInfo().
+ */
+class IdlePolicy
+{
+  private:
+
+    /** Number of cpuRelax() iterations per poll */
+    static const Size PollIterations = 1024;
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param cmdline Kernel command line
+     * @param coreId Core identifier of this core
+     */
+    IdlePolicy(const char *cmdline, const uint coreId);
+
+    /**
+     * Get the selected idle state.
+     *
+     * @return IdleState of the policy. May be a shallower state
+     *         than requested if the core does not support it.
+     */
+    IdleState getState() const;
+
+    /**
+     * Wait until the next interrupt or a short while.
+     */
+    void enter() const;
+
+  private:
+
+    /**
+     * Parse the idle state of an option value.
+     *
+     * @param value Option value
+     * @param state Receives the idle state on success
+     *
+     * @return True if the value is a known state
+     */
+    static bool parseState(const char *value, IdleState *state);
+
+    /**
+     * Detect support for the deep idle state.
+     *
+     * @return True if supported
+     */
+    bool detectDeep();
+
+  private:
+
+    /** Selected idle state */
+    IdleState m_state;
+
+    /** Processor specific hint for the deep idle state */
+    ulong m_deepHint;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_IDLE_IDLEPOLICY_H */
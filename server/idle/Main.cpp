@@ -16,14 +16,30 @@
  */
 
 #include <FreeNOS/System.h>
+#include <MemoryBlock.h>
+#include "IdlePolicy.h"
+
+/** Number of free pages to clear per ZeroPages call. */
+#define IdleZeroBatch 8
 
 int main(int argc, char **argv)
 {
-    PrivExec(Idle);
+    const SystemInformation info;
+    char cmdline[sizeof(info.cmdline) + 1];
+
+    // The kernel command line is not terminated if it fills the buffer
+    MemoryBlock::copy((void *) cmdline, info.cmdline, sizeof(info.cmdline));
+    cmdline[sizeof(info.cmdline)] = '\0';
+
+    const IdlePolicy policy(cmdline, info.coreId);
+
+    PrivExec(Idle, policy.getState());
     ProcessCtl(SELF, Schedule);
 
+    // Clear free pages in the background, wait for interrupts when there is nothing to clear
     while (true)
     {
-        idle();
+        if (PrivExec(ZeroPages, IdleZeroBatch) != API::Success)
+            policy.enter();
     }
 }
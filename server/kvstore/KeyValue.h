@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVER_KVSTORE_KEYVALUE_H
+#define __SERVER_KVSTORE_KEYVALUE_H
+
+#include <Types.h>
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup kvstore
+ * @{
+ */
+
+namespace KeyValue
+{
+    /**
+     * Actions which may be performed on the key-value store.
+     */
+    enum Action
+    {
+        Get = 1,
+        Put,
+        Delete,
+        Sync
+    };
+
+    /**
+     * Result codes.
+     */
+    enum Result
+    {
+        Success = 0,
+        IOError,
+        InvalidArgument,
+        IpcError,
+        NotFound,
+        NoSpace
+    };
+
+    /** Maximum size of a key in bytes, including the terminating zero */
+    static const Size MaximumKeySize = 32;
+
+    /** Maximum size of a value in bytes */
+    static const Size MaximumValueSize = 128;
+
+    /** Key of the shared Datastore value with the ProcessID of the server */
+    static const char ServerKey[] = "kvstore";
+}
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_KVSTORE_KEYVALUE_H */
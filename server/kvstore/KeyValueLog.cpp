@@ -0,0 +1,537 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <HashFunction.h>
+#include <MemoryBlock.h>
+#include "KeyValueLog.h"
+
+KeyValueLog::KeyValueLog(Storage *storage)
+    : m_storage(storage)
+    , m_segmentSize(0)
+    , m_active(0)
+    , m_generation(0)
+    , m_tail(0)
+    , m_live(0)
+    , m_batchOffset(0)
+    , m_batchUsed(0)
+    , m_windowOffset(0)
+    , m_windowSize(0)
+    , m_compacting(false)
+    , m_compactOffset(0)
+    , m_compactEnd(0)
+    , m_compactGeneration(0)
+{
+}
+
+KeyValue::Result KeyValueLog::initialize()
+{
+    const u64 capacity = m_storage->capacity() < MaximumCapacity ?
+                         m_storage->capacity() : MaximumCapacity;
+    SegmentHeader headers[2];
+    u32 generations[2];
+    KeyValue::Result result;
+
+    m_segmentSize = (capacity / 2) & ~(RecordAlignment - 1);
+
+    if (m_segmentSize < sizeof(SegmentHeader) + MaximumRecordSize)
+    {
+        return KeyValue::InvalidArgument;
+    }
+
+    for (Size i = 0; i < 2; i++)
+    {
+        if (m_storage->read(getSegmentBase(i), &headers[i], sizeof(SegmentHeader)) != FileSystem::Success)
+        {
+            return KeyValue::IOError;
+        }
+
+        generations[i] = headers[i].magic == SegmentMagic ? headers[i].generation : 0;
+    }
+
+    // Format empty storage
+    if (generations[0] == 0 && generations[1] == 0)
+    {
+        m_active = 0;
+        m_generation = 1;
+        m_tail = getSegmentBase(m_active) + sizeof(SegmentHeader);
+        m_batchOffset = m_tail;
+        return writeHeader(m_active, m_generation);
+    }
+
+    m_active = generations[1] > generations[0] ? 1 : 0;
+    m_generation = generations[m_active];
+
+    // Both segments are valid during a compaction: the old one goes first
+    if (generations[m_active ^ 1] != 0)
+    {
+        m_compacting = true;
+        m_compactGeneration = generations[m_active ^ 1];
+        m_compactOffset = getSegmentBase(m_active ^ 1) + sizeof(SegmentHeader);
+
+        if ((result = replay(m_active ^ 1, m_compactGeneration, m_compactEnd)) != KeyValue::Success)
+        {
+            return result;
+        }
+    }
+
+    if ((result = replay(m_active, m_generation, m_tail)) != KeyValue::Success)
+    {
+        return result;
+    }
+
+    m_batchOffset = m_tail;
+    return KeyValue::Success;
+}
+
+KeyValue::Result KeyValueLog::get(const char *key, void *value, Size & size) const
+{
+    u8 buffer[MaximumRecordSize] ALIGN(8);
+    const Record *record = (const Record *) buffer;
+
+    if (key == ZERO)
+    {
+        return KeyValue::InvalidArgument;
+    }
+
+    const Entry *entry = m_index.get(String(key));
+    if (entry == ZERO)
+    {
+        return KeyValue::NotFound;
+    }
+
+    // Records which are not flushed yet are only in the batch
+    if (entry->offset >= m_batchOffset && entry->offset < m_batchOffset + m_batchUsed)
+    {
+        MemoryBlock::copy(buffer, m_batch + (entry->offset - m_batchOffset), entry->size);
+    }
+    else if (m_storage->read(entry->offset, buffer, entry->size) != FileSystem::Success)
+    {
+        return KeyValue::IOError;
+    }
+
+    const Size bytes = record->valueSize;
+    const bool fits = bytes <= size;
+
+    if (fits)
+    {
+        MemoryBlock::copy(value, buffer + sizeof(Record) + record->keySize, bytes);
+    }
+
+    size = bytes;
+    return fits ? KeyValue::Success : KeyValue::InvalidArgument;
+}
+
+KeyValue::Result KeyValueLog::put(const char *key, const void *value, const Size size)
+{
+    const Size keySize = key ? String::length(key) : 0;
+    KeyValue::Result result;
+
+    if (keySize == 0 || keySize >= KeyValue::MaximumKeySize || size > KeyValue::MaximumValueSize)
+    {
+        return KeyValue::InvalidArgument;
+    }
+
+    if ((result = reserve(getRecordSize(keySize, size))) != KeyValue::Success)
+    {
+        return result;
+    }
+
+    return append(key, keySize, value, size);
+}
+
+KeyValue::Result KeyValueLog::remove(const char *key)
+{
+    KeyValue::Result result;
+
+    if (key == ZERO)
+    {
+        return KeyValue::InvalidArgument;
+    }
+
+    if (m_index.get(String(key)) == ZERO)
+    {
+        return KeyValue::NotFound;
+    }
+
+    const Size keySize = String::length(key);
+
+    if ((result = reserve(getRecordSize(keySize, 0))) != KeyValue::Success)
+    {
+        return result;
+    }
+
+    return append(key, keySize, ZERO, 0);
+}
+
+KeyValue::Result KeyValueLog::flush()
+{
+    if (m_batchUsed == 0)
+    {
+        return KeyValue::Success;
+    }
+
+    if (m_storage->write(m_batchOffset, m_batch, m_batchUsed) != FileSystem::Success)
+    {
+        return KeyValue::IOError;
+    }
+
+    m_batchOffset += m_batchUsed;
+    m_batchUsed = 0;
+    return KeyValue::Success;
+}
+
+bool KeyValueLog::isDirty() const
+{
+    return m_batchUsed != 0;
+}
+
+bool KeyValueLog::needsCompaction() const
+{
+    const Size used = getUsed();
+
+    // Compact once the segment is half full and at least half of it is garbage
+    return !m_compacting && used >= m_segmentSize / 2 &&
+           m_live <= (used - sizeof(SegmentHeader)) / 2;
+}
+
+bool KeyValueLog::isCompacting() const
+{
+    return m_compacting;
+}
+
+KeyValue::Result KeyValueLog::compact(const Size budget)
+{
+    char key[KeyValue::MaximumKeySize];
+    const Record *record;
+    KeyValue::Result result;
+    Size processed = 0;
+
+    if (!m_compacting && (result = startCompaction()) != KeyValue::Success)
+    {
+        return result;
+    }
+
+    const Size limit = getSegmentBase(m_active) + m_segmentSize;
+
+    while (m_compactOffset < m_compactEnd && processed < budget)
+    {
+        if ((result = readRecord(m_compactOffset, m_compactGeneration,
+                                 m_compactEnd, &record)) != KeyValue::Success)
+        {
+            return result;
+        }
+        else if (record == ZERO)
+        {
+            return KeyValue::IOError;
+        }
+
+        const Size size = getRecordSize(record);
+        MemoryBlock::copy(key, (const void *) (record + 1), record->keySize);
+        key[record->keySize] = ZERO;
+
+        // Only the latest record of each key is copied
+        const Entry *entry = m_index.get(String(key));
+        if (entry != ZERO && entry->offset == m_compactOffset)
+        {
+            if (m_tail + size > limit)
+            {
+                return KeyValue::NoSpace;
+            }
+
+            result = append(key, record->keySize,
+                            ((const u8 *) (record + 1)) + record->keySize, record->valueSize);
+            if (result != KeyValue::Success)
+            {
+                return result;
+            }
+        }
+
+        m_compactOffset += size;
+        processed += size;
+    }
+
+    if (m_compactOffset >= m_compactEnd)
+    {
+        return finishCompaction();
+    }
+
+    return KeyValue::Success;
+}
+
+Size KeyValueLog::count() const
+{
+    return m_index.count();
+}
+
+Size KeyValueLog::getUsed() const
+{
+    return m_tail - getSegmentBase(m_active);
+}
+
+Size KeyValueLog::getLive() const
+{
+    return m_live;
+}
+
+Size KeyValueLog::getSegmentBase(const Size segment) const
+{
+    return segment * m_segmentSize;
+}
+
+KeyValue::Result KeyValueLog::writeHeader(const Size segment, const u32 generation)
+{
+    SegmentHeader header;
+
+    MemoryBlock::set(&header, 0, sizeof(header));
+
+    if (generation != 0)
+    {
+        header.magic = SegmentMagic;
+        header.generation = generation;
+    }
+
+    if (m_storage->write(getSegmentBase(segment), &header, sizeof(header)) != FileSystem::Success)
+    {
+        return KeyValue::IOError;
+    }
+
+    return KeyValue::Success;
+}
+
+KeyValue::Result KeyValueLog::replay(const Size segment, const u32 generation, Size & end)
+{
+    const Size limit = getSegmentBase(segment) + m_segmentSize;
+    Size offset = getSegmentBase(segment) + sizeof(SegmentHeader);
+    char key[KeyValue::MaximumKeySize];
+    const Record *record;
+    KeyValue::Result result;
+
+    // The log ends at the first record which is not valid
+    while ((result = readRecord(offset, generation, limit, &record)) == KeyValue::Success && record)
+    {
+        const Size size = getRecordSize(record);
+
+        MemoryBlock::copy(key, (const void *) (record + 1), record->keySize);
+        key[record->keySize] = ZERO;
+
+        index(String(key), record->valueSize == Tombstone ? 0 : offset, size);
+        offset += size;
+    }
+
+    end = offset;
+    return result;
+}
+
+KeyValue::Result KeyValueLog::readRecord(const Size offset,
+                                         const u32 generation,
+                                         const Size limit,
+                                         const Record **record)
+{
+    const Size available = limit > offset ? limit - offset : 0;
+    const Size needed = available < MaximumRecordSize ? available : MaximumRecordSize;
+
+    *record = ZERO;
+
+    if (available < sizeof(Record))
+    {
+        return KeyValue::Success;
+    }
+
+    // Refill the window if the largest possible record is not inside
+    if (offset < m_windowOffset || offset + needed > m_windowOffset + m_windowSize)
+    {
+        const Size size = available < BatchSize ? available : BatchSize;
+
+        if (m_storage->read(offset, m_window, size) != FileSystem::Success)
+        {
+            m_windowSize = 0;
+            return KeyValue::IOError;
+        }
+
+        m_windowOffset = offset;
+        m_windowSize = size;
+    }
+
+    const Record *r = (const Record *) (m_window + (offset - m_windowOffset));
+
+    if (r->magic == RecordMagic && r->generation == generation &&
+        r->keySize != 0 && r->keySize < KeyValue::MaximumKeySize &&
+        (r->valueSize == Tombstone || r->valueSize <= KeyValue::MaximumValueSize) &&
+        getRecordSize(r) <= available && checksum(r) == r->checksum)
+    {
+        *record = r;
+    }
+
+    return KeyValue::Success;
+}
+
+KeyValue::Result KeyValueLog::append(const char *key,
+                                     const Size keySize,
+                                     const void *value,
+                                     const Size valueSize)
+{
+    const Size size = getRecordSize(keySize, value ? valueSize : 0);
+    KeyValue::Result result;
+
+    if (m_batchUsed + size > BatchSize && (result = flush()) != KeyValue::Success)
+    {
+        return result;
+    }
+
+    Record *record = (Record *) (m_batch + m_batchUsed);
+    u8 *data = (u8 *) (record + 1);
+
+    MemoryBlock::set(record, 0, size);
+    record->magic = RecordMagic;
+    record->generation = m_generation;
+    record->keySize = keySize;
+    record->valueSize = value ? valueSize : Tombstone;
+    MemoryBlock::copy(data, key, keySize);
+
+    if (value)
+    {
+        MemoryBlock::copy(data + keySize, value, valueSize);
+    }
+
+    record->checksum = checksum(record);
+
+    index(String(key), value ? m_tail : 0, size);
+    m_batchUsed += size;
+    m_tail += size;
+    return KeyValue::Success;
+}
+
+KeyValue::Result KeyValueLog::reserve(const Size size)
+{
+    KeyValue::Result result;
+
+    // A compaction in progress is finished first, then another may free more space
+    for (Size i = 0; i < 2 && m_tail + size > getSegmentBase(m_active) + m_segmentSize; i++)
+    {
+        if ((result = compact(m_segmentSize)) != KeyValue::Success)
+        {
+            return result;
+        }
+    }
+
+    if (m_tail + size > getSegmentBase(m_active) + m_segmentSize)
+    {
+        return KeyValue::NoSpace;
+    }
+
+    return KeyValue::Success;
+}
+
+KeyValue::Result KeyValueLog::startCompaction()
+{
+    const Size next = m_active ^ 1;
+    KeyValue::Result result;
+
+    // Records of the old segment must be durable before the new segment is valid
+    if ((result = flush()) != KeyValue::Success ||
+        (result = writeHeader(next, m_generation + 1)) != KeyValue::Success)
+    {
+        return result;
+    }
+
+    m_compacting = true;
+    m_compactGeneration = m_generation;
+    m_compactOffset = getSegmentBase(m_active) + sizeof(SegmentHeader);
+    m_compactEnd = m_tail;
+
+    m_active = next;
+    m_generation++;
+    m_tail = getSegmentBase(m_active) + sizeof(SegmentHeader);
+    m_batchOffset = m_tail;
+    m_windowSize = 0;
+    return KeyValue::Success;
+}
+
+KeyValue::Result KeyValueLog::finishCompaction()
+{
+    KeyValue::Result result;
+
+    // Copied records must be durable before the old segment is cleared
+    if ((result = flush()) != KeyValue::Success ||
+        (result = writeHeader(m_active ^ 1, 0)) != KeyValue::Success)
+    {
+        return result;
+    }
+
+    m_compacting = false;
+    return KeyValue::Success;
+}
+
+void KeyValueLog::index(const String & key, const Size offset, const Size size)
+{
+    const Entry *old = m_index.get(key);
+
+    if (old != ZERO)
+    {
+        m_live -= old->size;
+    }
+
+    if (offset != 0)
+    {
+        Entry entry;
+        entry.offset = offset;
+        entry.size = size;
+
+        m_index.insert(key, entry);
+        m_live += size;
+    }
+    else if (old != ZERO)
+    {
+        m_index.remove(key);
+    }
+}
+
+u32 KeyValueLog::checksum(const Record *record)
+{
+    Record header = *record;
+    const u8 *data = (const u8 *) &header;
+    const Size size = record->keySize + (record->valueSize == Tombstone ? 0 : record->valueSize);
+    u32 hash = FNV_INIT;
+
+    header.checksum = 0;
+
+    for (Size i = 0; i < sizeof(Record); i++)
+    {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+
+    data = (const u8 *) (record + 1);
+
+    for (Size i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+Size KeyValueLog::getRecordSize(const Record *record)
+{
+    return getRecordSize(record->keySize, record->valueSize == Tombstone ? 0 : record->valueSize);
+}
+
+Size KeyValueLog::getRecordSize(const Size keySize, const Size valueSize)
+{
+    return (sizeof(Record) + keySize + valueSize + RecordAlignment - 1) & ~(RecordAlignment - 1);
+}
@@ -0,0 +1,427 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVER_KVSTORE_KEYVALUELOG_H
+#define __SERVER_KVSTORE_KEYVALUELOG_H
+
+#include <Types.h>
+#include <Macros.h>
+#include <HashTable.h>
+#include <String.h>
+#include <Storage.h>
+#include "KeyValue.h"
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup kvstore
+ * @{
+ */
+
+/**
+ * Log-structured key-value store on a Storage device.
+ *
+ * The storage is divided into two segments. Updates are appended as
+ * records to the active segment and deletes append a tombstone record.
+ * An in-memory index maps each key to its latest record and is rebuilt
+ * by replaying the log on initialize().
+ *
+ * Appended records are collected in a batch, which flush() writes with
+ * a single Storage write. The server flushes once per round of requests,
+ * such that all updates received in the round share one write.
+ *
+ * Compaction copies the live records of the active segment into the other
+ * segment in steps, while new updates are appended after them. Each segment
+ * starts with a header with its generation, which is written before its
+ * records. Once all live records are copied and flushed, the header of the
+ * old segment is cleared. If both segments are valid on initialize(),
+ * the older one is replayed first and compaction continues.
+ */
+class KeyValueLog
+{
+  private:
+
+    /** Identifies a segment header */
+    static const u32 SegmentMagic = 0x4b564c47;
+
+    /** Identifies a record */
+    static const u32 RecordMagic = 0x4b565243;
+
+    /** Value size of a tombstone record */
+    static const u16 Tombstone = 0xffff;
+
+    /** Alignment of records in bytes */
+    static const Size RecordAlignment = 8;
+
+    /** Size of the batch of appended records in bytes */
+    static const Size BatchSize = 4096;
+
+    /** Maximum storage capacity used */
+    static const u64 MaximumCapacity = 0x40000000;
+
+    /**
+     * Header at the start of each segment.
+     */
+    typedef struct SegmentHeader
+    {
+        u32 magic;          /**< SegmentMagic or zero if unused */
+        u32 generation;     /**< Increased for each new active segment */
+        u32 reserved[2];    /**< Unused, zero */
+    }
+    SegmentHeader;
+
+    /**
+     * Header of a record, followed by the key and the value.
+     */
+    typedef struct Record
+    {
+        u32 magic;          /**< RecordMagic */
+        u32 generation;     /**< Generation of the segment */
+        u32 checksum;       /**< FNV-1a hash of the record with a zero checksum */
+        u16 keySize;        /**< Number of bytes of the key */
+        u16 valueSize;      /**< Number of bytes of the value or Tombstone */
+    }
+    Record;
+
+    /** Size of the largest record in bytes */
+    static const Size MaximumRecordSize =
+        (sizeof(Record) + KeyValue::MaximumKeySize + KeyValue::MaximumValueSize +
+         RecordAlignment - 1) & ~(RecordAlignment - 1);
+
+    /**
+     * Location of the latest record of a key.
+     */
+    struct Entry
+    {
+        Size offset;        /**< Offset of the record in storage */
+        Size size;          /**< Size of the record in bytes */
+
+        bool operator == (const Entry & e) const
+        {
+            return offset == e.offset && size == e.size;
+        }
+
+        bool operator != (const Entry & e) const
+        {
+            return !(*this == e);
+        }
+    };
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param storage Storage device for the log
+     */
+    KeyValueLog(Storage *storage);
+
+    /**
+     * Initialize the log.
+     *
+     * Formats empty storage and replays the log of formatted storage.
+     *
+     * @return Result code
+     */
+    KeyValue::Result initialize();
+
+    /**
+     * Read a value.
+     *
+     * @param key Key of the value
+     * @param value Output buffer for the data
+     * @param size Size of the output buffer on input.
+     *             On output, the number of bytes of the value.
+     *
+     * @return Result code
+     */
+    KeyValue::Result get(const char *key, void *value, Size & size) const;
+
+    /**
+     * Add or update a value.
+     *
+     * The value is durable after the next flush().
+     *
+     * @param key Key of the value
+     * @param value Data of the value
+     * @param size Number of bytes of data
+     *
+     * @return Result code
+     */
+    KeyValue::Result put(const char *key, const void *value, const Size size);
+
+    /**
+     * Delete a value.
+     *
+     * The delete is durable after the next flush().
+     *
+     * @param key Key of the value
+     *
+     * @return Result code
+     */
+    KeyValue::Result remove(const char *key);
+
+    /**
+     * Write all appended records to storage.
+     *
+     * @return Result code
+     */
+    KeyValue::Result flush();
+
+    /**
+     * Check for appended records which are not written yet.
+     *
+     * @return True if flush() has records to write
+     */
+    bool isDirty() const;
+
+    /**
+     * Check if the active segment has enough garbage to compact.
+     *
+     * @return True if compaction should start
+     */
+    bool needsCompaction() const;
+
+    /**
+     * Check if a compaction is in progress.
+     *
+     * @return True while compacting
+     */
+    bool isCompacting() const;
+
+    /**
+     * Perform a step of compaction.
+     *
+     * Starts a compaction if none is in progress.
+     *
+     * @param budget Maximum number of bytes of the old segment to process
+     *
+     * @return Result code
+     */
+    KeyValue::Result compact(const Size budget);
+
+    /**
+     * Get the number of keys.
+     *
+     * @return Number of keys
+     */
+    Size count() const;
+
+    /**
+     * Get the number of bytes used in the active segment.
+     *
+     * @return Used bytes, including the header
+     */
+    Size getUsed() const;
+
+    /**
+     * Get the number of bytes in live records.
+     *
+     * @return Live bytes
+     */
+    Size getLive() const;
+
+  private:
+
+    /**
+     * Get the start of a segment.
+     *
+     * @param segment Segment number
+     *
+     * @return Offset in storage
+     */
+    Size getSegmentBase(const Size segment) const;
+
+    /**
+     * Write the header of a segment.
+     *
+     * @param segment Segment number
+     * @param generation Generation or zero to clear the header
+     *
+     * @return Result code
+     */
+    KeyValue::Result writeHeader(const Size segment, const u32 generation);
+
+    /**
+     * Replay the records of a segment into the index.
+     *
+     * @param segment Segment number
+     * @param generation Generation of the segment
+     * @param end Outputs the offset after the last valid record
+     *
+     * @return Result code
+     */
+    KeyValue::Result replay(const Size segment, const u32 generation, Size & end);
+
+    /**
+     * Read and verify a record for sequential processing.
+     *
+     * Records are read through a window of BatchSize bytes, such that
+     * many consecutive records are read with a single Storage read.
+     *
+     * @param offset Offset of the record in storage
+     * @param generation Expected generation
+     * @param limit End of the valid data
+     * @param record Outputs the record or ZERO if not valid
+     *
+     * @return Result code
+     */
+    KeyValue::Result readRecord(const Size offset,
+                                const u32 generation,
+                                const Size limit,
+                                const Record **record);
+
+    /**
+     * Append a record to the batch and update the index.
+     *
+     * The record must fit in the active segment.
+     *
+     * @param key Zero terminated key of the record
+     * @param keySize Number of bytes of the key
+     * @param value Data of the value or ZERO for a tombstone
+     * @param valueSize Number of bytes of the value
+     *
+     * @return Result code
+     */
+    KeyValue::Result append(const char *key,
+                            const Size keySize,
+                            const void *value,
+                            const Size valueSize);
+
+    /**
+     * Make room in the active segment.
+     *
+     * Finishes or performs a compaction if the record does not fit.
+     *
+     * @param size Size of the record in bytes
+     *
+     * @return Result code
+     */
+    KeyValue::Result reserve(const Size size);
+
+    /**
+     * Start a compaction into the other segment.
+     *
+     * @return Result code
+     */
+    KeyValue::Result startCompaction();
+
+    /**
+     * Finish a compaction once all live records are copied.
+     *
+     * @return Result code
+     */
+    KeyValue::Result finishCompaction();
+
+    /**
+     * Update the index for a new record.
+     *
+     * @param key Key of the record
+     * @param offset Offset of the record or ZERO for a tombstone
+     * @param size Size of the record
+     */
+    void index(const String & key, const Size offset, const Size size);
+
+    /**
+     * Get the size of a record.
+     *
+     * @param record Record header
+     *
+     * @return Aligned size in bytes
+     */
+    static Size getRecordSize(const Record *record);
+
+    /**
+     * Calculate the checksum of a record.
+     *
+     * @param record Record header followed by its key and value
+     *
+     * @return FNV-1a hash
+     */
+    static u32 checksum(const Record *record);
+
+    /**
+     * Get the size of a record.
+     *
+     * @param keySize Number of bytes of the key
+     * @param valueSize Number of bytes of the value
+     *
+     * @return Aligned size in bytes
+     */
+    static Size getRecordSize(const Size keySize, const Size valueSize);
+
+  private:
+
+    /** Storage device */
+    Storage *m_storage;
+
+    /** Size of each segment in bytes */
+    Size m_segmentSize;
+
+    /** Active segment number */
+    Size m_active;
+
+    /** Generation of the active segment */
+    u32 m_generation;
+
+    /** Offset after the last appended record */
+    Size m_tail;
+
+    /** Maps each key to its latest record */
+    HashTable<String, Entry> m_index;
+
+    /** Number of bytes in live records */
+    Size m_live;
+
+    /** Appended records which are not written yet */
+    u8 m_batch[BatchSize] ALIGN(8);
+
+    /** Offset in storage of the batch */
+    Size m_batchOffset;
+
+    /** Number of bytes in the batch */
+    Size m_batchUsed;
+
+    /** Records read by readRecord() */
+    u8 m_window[BatchSize] ALIGN(8);
+
+    /** Offset in storage of the window */
+    Size m_windowOffset;
+
+    /** Number of valid bytes in the window */
+    Size m_windowSize;
+
+    /** True while compacting */
+    bool m_compacting;
+
+    /** Offset of the next record to process in the old segment */
+    Size m_compactOffset;
+
+    /** Offset after the last record in the old segment */
+    Size m_compactEnd;
+
+    /** Generation of the old segment */
+    u32 m_compactGeneration;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_KVSTORE_KEYVALUELOG_H */
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVER_KVSTORE_KEYVALUEMESSAGE_H
+#define __SERVER_KVSTORE_KEYVALUEMESSAGE_H
+
+#include <Types.h>
+#include <ChannelMessage.h>
+#include "KeyValue.h"
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup kvstore
+ * @{
+ */
+
+/**
+ * Key-value store IPC message.
+ */
+typedef struct KeyValueMessage : public ChannelMessage
+{
+    KeyValue::Action action;                /**< Action to perform. */
+    KeyValue::Result result;                /**< Result of action. */
+    char key[KeyValue::MaximumKeySize];     /**< Key of the value */
+    Size size;                              /**< Number of bytes of the value */
+    u8 value[KeyValue::MaximumValueSize];   /**< Data of the value */
+}
+KeyValueMessage;
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_KVSTORE_KEYVALUEMESSAGE_H */
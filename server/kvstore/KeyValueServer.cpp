@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include <DatastoreClient.h>
+#include <MemoryBlock.h>
+#include "KeyValueServer.h"
+
+KeyValueServer::KeyValueServer(Storage *storage)
+    : ChannelServer<KeyValueServer, KeyValueMessage>(this)
+    , m_log(storage)
+    , m_commitCount(0)
+{
+    addIPCHandler(KeyValue::Get, &KeyValueServer::getHandler);
+    addIPCHandler(KeyValue::Put, &KeyValueServer::putHandler, false);
+    addIPCHandler(KeyValue::Delete, &KeyValueServer::deleteHandler, false);
+    addIPCHandler(KeyValue::Sync, &KeyValueServer::syncHandler, false);
+}
+
+KeyValue::Result KeyValueServer::initialize()
+{
+    const KeyValue::Result result = m_log.initialize();
+    if (result != KeyValue::Success)
+    {
+        ERROR("failed to initialize log: result = " << (int) result);
+        return result;
+    }
+
+    NOTICE(m_log.count() << " keys, " << m_log.getLive() << " live bytes");
+
+    // Continue a compaction which was interrupted
+    if (m_log.isCompacting())
+    {
+        setTimeout(CompactionInterval, CompactionSlack);
+    }
+
+    const Datastore::Result publishResult =
+        DatastoreClient().setValue(KeyValue::ServerKey, &m_self, sizeof(m_self));
+    if (publishResult != Datastore::Success)
+    {
+        ERROR("failed to publish ProcessID: result = " << (int) publishResult);
+        return KeyValue::IpcError;
+    }
+
+    return KeyValue::Success;
+}
+
+bool KeyValueServer::retryRequests()
+{
+    if (m_commitCount > 0 || m_log.isDirty())
+    {
+        commit();
+    }
+
+    if (m_log.needsCompaction())
+    {
+        compact();
+    }
+
+    return false;
+}
+
+void KeyValueServer::timeout()
+{
+    ChannelServer<KeyValueServer, KeyValueMessage>::timeout();
+
+    if (m_log.isCompacting())
+    {
+        compact();
+    }
+}
+
+void KeyValueServer::getHandler(KeyValueMessage *msg)
+{
+    msg->key[sizeof(msg->key) - 1] = ZERO;
+    msg->size = sizeof(msg->value);
+    msg->result = m_log.get(msg->key, msg->value, msg->size);
+}
+
+void KeyValueServer::putHandler(KeyValueMessage *msg)
+{
+    msg->key[sizeof(msg->key) - 1] = ZERO;
+    msg->result = m_log.put(msg->key, msg->value, msg->size);
+    defer(msg);
+}
+
+void KeyValueServer::deleteHandler(KeyValueMessage *msg)
+{
+    msg->key[sizeof(msg->key) - 1] = ZERO;
+    msg->result = m_log.remove(msg->key);
+    defer(msg);
+}
+
+void KeyValueServer::syncHandler(KeyValueMessage *msg)
+{
+    msg->result = KeyValue::Success;
+    defer(msg);
+}
+
+void KeyValueServer::defer(KeyValueMessage *msg)
+{
+    if (msg->result != KeyValue::Success)
+    {
+        sendResponse(msg);
+        return;
+    }
+
+    if (m_commitCount == MaximumCommits)
+    {
+        commit();
+    }
+
+    MemoryBlock::copy(&m_commits[m_commitCount++], msg, sizeof(*msg));
+}
+
+void KeyValueServer::commit()
+{
+    const KeyValue::Result result = m_log.flush();
+
+    if (result != KeyValue::Success)
+    {
+        ERROR("failed to write log: result = " << (int) result);
+    }
+
+    for (Size i = 0; i < m_commitCount; i++)
+    {
+        m_commits[i].result = result;
+        sendResponse(&m_commits[i]);
+    }
+
+    m_commitCount = 0;
+}
+
+void KeyValueServer::compact()
+{
+    const KeyValue::Result result = m_log.compact(CompactionBudget);
+
+    if (result != KeyValue::Success)
+    {
+        ERROR("failed to compact log: result = " << (int) result);
+    }
+    else if (m_log.isCompacting() && !hasTimeout())
+    {
+        setTimeout(CompactionInterval, CompactionSlack);
+    }
+}
+
+void KeyValueServer::sendResponse(KeyValueMessage *msg)
+{
+    msg->type = ChannelMessage::Response;
+
+    Channel *channel = m_registry.getProducer(msg->from);
+    if (channel == ZERO)
+    {
+        ERROR("failed to retrieve channel for PID " << msg->from);
+        return;
+    }
+
+    if (channel->write(msg) != Channel::Success)
+    {
+        ERROR("failed to write channel for PID " << msg->from);
+        return;
+    }
+
+    ProcessCtl(msg->from, Wakeup, 0);
+}
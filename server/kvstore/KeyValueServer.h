@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVER_KVSTORE_KEYVALUESERVER_H
+#define __SERVER_KVSTORE_KEYVALUESERVER_H
+
+#include <ChannelServer.h>
+#include <Storage.h>
+#include <Types.h>
+#include "KeyValue.h"
+#include "KeyValueLog.h"
+#include "KeyValueMessage.h"
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup kvstore
+ * @{
+ */
+
+/**
+ * Key-value store server
+ *
+ * Provides durable key-value storage on a Storage device using a KeyValueLog.
+ *
+ * Updates are committed in groups: the replies to all updates received
+ * in a round of requests are sent after a single write of their records.
+ * Reads are served from the log directly. Compaction runs in steps
+ * between rounds, such that requests are not blocked by it.
+ *
+ * The server publishes its ProcessID in the shared Datastore value
+ * KeyValue::ServerKey, where the KeyValueClient finds it.
+ */
+class KeyValueServer : public ChannelServer<KeyValueServer, KeyValueMessage>
+{
+  private:
+
+    /** Maximum number of updates waiting for a commit */
+    static const Size MaximumCommits = 32;
+
+    /** Maximum number of bytes processed in one step of compaction */
+    static const Size CompactionBudget = KiloByte(16);
+
+    /** Time between steps of compaction in milliseconds */
+    static const Size CompactionInterval = 10;
+
+    /** Allowed delay of a step of compaction in milliseconds */
+    static const Size CompactionSlack = 10;
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param storage Storage device for the log
+     */
+    KeyValueServer(Storage *storage);
+
+    /**
+     * Initialize the server.
+     *
+     * Replays the log and publishes the ProcessID of the server.
+     *
+     * @return Result code
+     */
+    KeyValue::Result initialize();
+
+    /**
+     * Commit the updates received in this round.
+     *
+     * @return Always false
+     */
+    virtual bool retryRequests();
+
+  protected:
+
+    /**
+     * Called when the sleep timeout is reached.
+     *
+     * Performs a step of compaction.
+     */
+    virtual void timeout();
+
+  private:
+
+    /**
+     * Read a value.
+     *
+     * @param msg KeyValueMessage pointer
+     */
+    void getHandler(KeyValueMessage *msg);
+
+    /**
+     * Add or update a value.
+     *
+     * @param msg KeyValueMessage pointer
+     */
+    void putHandler(KeyValueMessage *msg);
+
+    /**
+     * Delete a value.
+     *
+     * @param msg KeyValueMessage pointer
+     */
+    void deleteHandler(KeyValueMessage *msg);
+
+    /**
+     * Wait until all previous updates are durable.
+     *
+     * @param msg KeyValueMessage pointer
+     */
+    void syncHandler(KeyValueMessage *msg);
+
+    /**
+     * Reply to an update once it is committed.
+     *
+     * Failed updates are replied to immediately.
+     *
+     * @param msg KeyValueMessage pointer
+     */
+    void defer(KeyValueMessage *msg);
+
+    /**
+     * Write all updates and reply to them.
+     */
+    void commit();
+
+    /**
+     * Perform a step of compaction and schedule the next step.
+     */
+    void compact();
+
+    /**
+     * Send a reply message.
+     *
+     * @param msg KeyValueMessage pointer
+     */
+    void sendResponse(KeyValueMessage *msg);
+
+  private:
+
+    /** Log of the key-value pairs */
+    KeyValueLog m_log;
+
+    /** Updates waiting for a commit */
+    KeyValueMessage m_commits[MaximumCommits];
+
+    /** Number of updates waiting for a commit */
+    Size m_commitCount;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_KVSTORE_KEYVALUESERVER_H */
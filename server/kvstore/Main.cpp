@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include <Assert.h>
+#include <KernelLog.h>
+#include <FileStorage.h>
+#include <String.h>
+#include "KeyValueServer.h"
+
+int main(int argc, char **argv)
+{
+    KernelLog log;
+
+    if (argc < 2)
+    {
+        ERROR("usage: " << argv[0] << " FILE [OFFSET]");
+        return 1;
+    }
+
+    // The log is kept in the given file or device
+    const Size offset = argc > 2 ? String(argv[2], false).toLong() : 0;
+    FileStorage storage(argv[1], offset);
+
+    const FileSystem::Result storageResult = storage.initialize();
+    if (storageResult != FileSystem::Success)
+    {
+        ERROR("unable to open file storage '" << argv[1] <<
+              "': result = " << (int) storageResult);
+        return 1;
+    }
+
+    // The batch buffers of the log do not fit on the stack
+    KeyValueServer *server = new KeyValueServer(&storage);
+    assert(server != NULL);
+
+    const KeyValue::Result result = server->initialize();
+    if (result != KeyValue::Success)
+    {
+        return 1;
+    }
+
+    return server->run();
+}
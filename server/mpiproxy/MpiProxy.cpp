@@ -18,6 +18,7 @@
 #include <FreeNOS/System.h>
 #include <Log.h>
 #include <IPV4.h>
+#include <UDP.h>
 #include <errno.h>
 #include <string.h>
 #include <sys/socket.h>
@@ -29,6 +30,8 @@
 #include <NetworkQueue.h>
 #include <BufferedFile.h>
 #include <MPIMessage.h>
+#include <MpiStream.h>
+#include <MpiDatatype.h>
 #include <ApplicationLauncher.h>
 #include <Lz4Decompressor.h>
 #include <CoreClient.h>
@@ -43,8 +46,10 @@ MpiProxy::MpiProxy(int argc, char **argv)
     : POSIXApplication(argc, argv)
     , m_sock(-1)
     , m_client(ZERO)
+    , m_packetSize(DefaultPacketSize)
 {
     MemoryBlock::set(&m_memChannelBase, 0, sizeof(m_memChannelBase));
+    MemoryBlock::set(m_transfers, 0, sizeof(m_transfers));
     m_pids.fill(ANY);
 
     parser().setDescription("Message Passing Interface (MPI) proxy server");
@@ -85,6 +90,16 @@ MpiProxy::Result MpiProxy::initialize()
         return IOError;
     }
 
+    // Fill each packet up to the MTU of the device
+    Size mtu = 0;
+    if (m_client->getMTU(&mtu) == NetworkClient::Success &&
+        mtu > sizeof(IPV4::Header) + sizeof(UDP::Header) + sizeof(Header))
+    {
+        const Size packetSize = mtu - sizeof(IPV4::Header) - sizeof(UDP::Header);
+        m_packetSize = packetSize < MaximumPacketSize ? packetSize : MaximumPacketSize;
+    }
+    NOTICE("packet size = " << m_packetSize << " for MTU " << mtu);
+
     // Create an UDP socket
     result = m_client->createSocket(NetworkClient::UDP, &m_sock);
     if (result != NetworkClient::Success)
@@ -103,6 +118,15 @@ MpiProxy::Result MpiProxy::initialize()
         return IOError;
     }
 
+    // Enlarge the receive queue to accept bursts of data packets
+    result = m_client->setQueueSize(m_sock, ReceiveQueueSize);
+    if (result != NetworkClient::Success)
+    {
+        ERROR("failed to set receive queue size of UDP socket on device " << device <<
+              ": result = " << (int) result);
+        return IOError;
+    }
+
     return Success;
 }
 
@@ -110,29 +134,47 @@ MpiProxy::Result MpiProxy::exec()
 {
     DEBUG("");
 
+    static u8 packets[ReceiveBatchSize][MaximumPacketSize];
+    static struct iovec vec[ReceiveBatchSize];
+    static struct sockaddr addrs[ReceiveBatchSize];
+    static struct mmsghdr msgs[ReceiveBatchSize];
+
+    // Prepare a message header for each receive buffer
+    for (Size i = 0; i < ReceiveBatchSize; i++)
+    {
+        vec[i].iov_base = packets[i];
+        vec[i].iov_len = sizeof(packets[i]);
+
+        MemoryBlock::set(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_name = &addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        msgs[i].msg_hdr.msg_iov = &vec[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
     while (true)
     {
-        static u8 packet[MaximumPacketSize];
-        Size packetSize = sizeof(packet);
-        struct sockaddr addr;
+        Size count = ReceiveBatchSize;
 
-        // Wait for UDP packet
-        const Result recvResult = udpReceive(packet, packetSize, addr);
+        // Wait for UDP packets
+        const Result recvResult = udpReceiveMultiple(msgs, count);
         if (recvResult != Success)
         {
             if (recvResult != TimedOut)
             {
-                ERROR("failed to receive UDP packet: result = " << (int) recvResult);
+                ERROR("failed to receive UDP packets: result = " << (int) recvResult);
             }
             continue;
         }
 
-        // Process the packet
-        const Result procResult = processRequest(packet, packetSize, addr);
-        if (procResult != Success)
+        // Process the packets in order of arrival
+        for (Size i = 0; i < count; i++)
         {
-            ERROR("failed to process UDP packet: result = " << (int) procResult);
-            continue;
+            const Result procResult = processRequest(packets[i], msgs[i].msg_len, addrs[i]);
+            if (procResult != Success)
+            {
+                ERROR("failed to process UDP packet: result = " << (int) procResult);
+            }
         }
     }
 
@@ -161,32 +203,41 @@ MpiProxy::Result MpiProxy::udpSendMultiple(const struct iovec *vec,
                                            const Size count,
                                            const struct sockaddr & addr) const
 {
-    struct msghdr msg;
+    struct mmsghdr msgs[NetworkQueue::BatchPackets];
+    const Size total = count < NetworkQueue::BatchPackets ? count : NetworkQueue::BatchPackets;
+    Size sent = 0;
 
     DEBUG("count = " << count);
 
-    // Prepare the message header
-    msg.msg_name = (void *) &addr;
-    msg.msg_namelen = sizeof(addr);
-    msg.msg_iov = (struct iovec *) vec;
-    msg.msg_iovlen = count;
+    // Prepare a message header for each datagram
+    for (Size i = 0; i < total; i++)
+    {
+        MemoryBlock::set(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_name = (void *) &addr;
+        msgs[i].msg_hdr.msg_namelen = sizeof(addr);
+        msgs[i].msg_hdr.msg_iov = (struct iovec *) &vec[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
 
-    // Send the packet
-    int result = ::sendmsg(m_sock, &msg, 0);
-    if (result <= 0)
+    // Send the datagrams in batches, until all are accepted
+    while (sent < total)
     {
-        ERROR("failed to send multiple UDP datagrams: " << strerror(errno));
-        return IOError;
+        const int result = ::sendmmsg(m_sock, msgs + sent, total - sent, 0);
+        if (result <= 0)
+        {
+            ERROR("failed to send multiple UDP datagrams: " << strerror(errno));
+            return IOError;
+        }
+        sent += result;
     }
 
     return Success;
 }
 
-MpiProxy::Result MpiProxy::udpReceive(void *packet,
-                                      Size & size,
-                                      struct sockaddr & addr) const
+MpiProxy::Result MpiProxy::udpReceiveMultiple(struct mmsghdr *msgs,
+                                              Size & count) const
 {
-    DEBUG("");
+    DEBUG("count = " << count);
 
     // Wait for a packet in the UDP socket
     const NetworkClient::Result result = m_client->waitSocket(NetworkClient::UDP, m_sock, ReceiveTimeoutMs);
@@ -203,18 +254,16 @@ MpiProxy::Result MpiProxy::udpReceive(void *packet,
         }
     }
 
-    // Receive UDP datagram
-    int r = recvfrom(m_sock, packet, size, 0,
-                     &addr, sizeof(addr));
+    // Receive all queued UDP datagrams at once
+    int r = recvmmsg(m_sock, msgs, count, 0, ZERO);
     if (r < 0)
     {
-        ERROR("failed to receive UDP datagram: " << strerror(errno));
+        ERROR("failed to receive UDP datagrams: " << strerror(errno));
         return IOError;
     }
 
-    size = r;
-    DEBUG("received " << r << " bytes from " << *IPV4::toString(addr.addr) <<
-          " at port " << addr.port);
+    count = r;
+    DEBUG("received " << r << " datagrams");
 
     return Success;
 }
@@ -230,11 +279,14 @@ MpiProxy::Result MpiProxy::processRequest(const u8 *packet,
     switch (hdr->operation)
     {
         case MpiOpSend:
-            return processSend(hdr, packet, size);
+            return processSend(hdr, packet, size, addr);
 
         case MpiOpRecv:
             return processRecv(hdr, packet, size, addr);
 
+        case MpiOpResend:
+            return processResend(hdr, packet, size, addr);
+
         case MpiOpExec:
             return processExec(hdr, packet, size, addr);
 
@@ -251,14 +303,14 @@ MpiProxy::Result MpiProxy::processRequest(const u8 *packet,
 
 MpiProxy::Result MpiProxy::processSend(const Header *header,
                                        const u8 *packet,
-                                       const Size size)
+                                       const Size size,
+                                       const struct sockaddr & addr)
 {
-    MPIMessage msg;
+    const Size elementSize = MpiDatatype::getSize((MPI_Datatype) header->datatype);
     MemoryChannel *ch;
-    const u8 *buf = (packet + sizeof(*header));
 
-    NOTICE("rankId = " << header->rankId << " datatype = " <<
-           header->datatype << " datacount = " << header->datacount);
+    DEBUG("rankId = " << header->rankId << " datatype = " << header->datatype <<
+          " datacount = " << header->datacount << " sequence = " << header->sequence);
 
     if (!(ch = m_writeChannels.get(header->rankId)))
     {
@@ -266,30 +318,68 @@ MpiProxy::Result MpiProxy::processSend(const Header *header,
         return NotFound;
     }
 
-    for (Size i = 0; i < header->datacount; i++)
+    if (elementSize == 0)
     {
-        switch (header->datatype)
-        {
-            case MPI_INT:
-                msg.integer = *(((int *) buf) + i);
-                break;
+        ERROR("unsupported datatype = " << header->datatype);
+        return NotFound;
+    }
+
+    if (sizeof(*header) + (header->datacount * elementSize) > size)
+    {
+        ERROR("datacount " << header->datacount << " exceeds packet size " << size);
+        return InvalidArgument;
+    }
 
-            case MPI_UNSIGNED_CHAR:
-                msg.uchar = *(((u8 *) buf) + i);
-                break;
+    Transfer & xfer = m_transfers[header->rankId];
+    const u32 offset = header->sequence - xfer.sendSequence;
 
-            default:
-            {
-                ERROR("unsupported datatype = " << header->datatype);
-                return NotFound;
-            }
+    // Fragments beyond the window are dropped and retransmitted by the host later
+    if ((s32) offset >= (s32) FragmentWindow)
+    {
+        DEBUG("dropped fragment " << header->sequence << " outside window at " << xfer.sendSequence);
+        return Success;
+    }
+
+    // Deliver the fragment and any buffered fragments that follow it in order
+    if (offset == 0)
+    {
+        MpiStream::write(ch, header + 1, header->datacount * elementSize);
+        xfer.sendSequence++;
+
+        for (u8 *buf; (buf = xfer.pending[xfer.sendSequence % FragmentWindow]) != ZERO; xfer.sendSequence++)
+        {
+            const Header *hdr = (const Header *) buf;
+            MpiStream::write(ch, hdr + 1, hdr->datacount *
+                             MpiDatatype::getSize((MPI_Datatype) hdr->datatype));
+            xfer.pending[xfer.sendSequence % FragmentWindow] = ZERO;
+            delete[] buf;
+        }
+    }
+    // Buffer out-of-order fragments inside the window
+    else if ((s32) offset > 0 && xfer.pending[header->sequence % FragmentWindow] == ZERO)
+    {
+        u8 *buf = new u8[size];
+        if (!buf)
+        {
+            ERROR("failed to allocate buffer for fragment " << header->sequence);
+            return OutOfMemory;
         }
 
-        while (ch->write(&msg) != Channel::Success)
-            ;
+        MemoryBlock::copy(buf, packet, size);
+        xfer.pending[header->sequence % FragmentWindow] = buf;
     }
 
-    return Success;
+    // Acknowledge the fragment, also when it is a duplicate
+    Header ack;
+    ack.operation = MpiOpAck;
+    ack.result = MPI_SUCCESS;
+    ack.rankId = header->rankId;
+    ack.coreId = header->coreId;
+    ack.datatype = header->datatype;
+    ack.datacount = xfer.sendSequence;
+    ack.sequence = header->sequence;
+
+    return udpSend(&ack, sizeof(ack), addr);
 }
 
 MpiProxy::Result MpiProxy::processRecv(const Header *header,
@@ -297,15 +387,11 @@ MpiProxy::Result MpiProxy::processRecv(const Header *header,
                                        const Size size,
                                        const struct sockaddr & addr)
 {
+    const Size elementSize = MpiDatatype::getSize((MPI_Datatype) header->datatype);
     MemoryChannel *ch;
-    static u8 pkts[NetworkQueue::MaxPackets][NetworkQueue::PayloadBufferSize];
-    static struct iovec vec[NetworkQueue::MaxPackets];
-    Size packetCount = 0;
-
-    assert(NetworkQueue::PayloadBufferSize >= MaximumPacketSize);
 
-    NOTICE("rankId = " << header->rankId << " datatype = " <<
-           header->datatype << " datacount = " << header->datacount);
+    NOTICE("rankId = " << header->rankId << " datatype = " << header->datatype <<
+           " datacount = " << header->datacount << " sequence = " << header->sequence);
 
     if (!(ch = m_readChannels.get(header->rankId)))
     {
@@ -313,59 +399,131 @@ MpiProxy::Result MpiProxy::processRecv(const Header *header,
         return NotFound;
     }
 
-    // Read from the channel and send out packet(s)
-    for (Size i = 0; i < header->datacount;)
+    if (elementSize == 0)
+    {
+        ERROR("unsupported datatype = " << header->datatype);
+        return NotFound;
+    }
+
+    const Size packetElements = (m_packetSize - sizeof(Header)) / elementSize;
+    const Size fragments = (header->datacount + packetElements - 1) / packetElements;
+    Transfer & xfer = m_transfers[header->rankId];
+
+    // A repeated request means the response was lost: send it again from the retained copy
+    if (xfer.response != ZERO && xfer.recvSequence == header->sequence &&
+        xfer.datacount == header->datacount && xfer.datatype == header->datatype)
+    {
+        return sendFragments(header, 0, fragments, addr);
+    }
+
+    // Retain the new response until the next request
+    if (xfer.response != ZERO)
+    {
+        delete[] xfer.response;
+    }
+
+    xfer.response = new u8[header->datacount * elementSize];
+    if (!xfer.response)
+    {
+        ERROR("failed to allocate response buffer for rankId " << header->rankId);
+        return OutOfMemory;
+    }
+    xfer.recvSequence = header->sequence;
+    xfer.datacount = header->datacount;
+    xfer.datatype = header->datatype;
+
+    // Read from the channel and send out packets in batches
+    for (Size i = 0; i < fragments; i += NetworkQueue::BatchPackets)
+    {
+        const Size count = fragments - i < NetworkQueue::BatchPackets ?
+                           fragments - i : NetworkQueue::BatchPackets;
+        const Size offset = i * packetElements;
+        const Size end = (i + count) * packetElements;
+
+        m_readStreams[header->rankId].read(ch, xfer.response + (offset * elementSize),
+            ((end < xfer.datacount ? end : xfer.datacount) - offset) * elementSize);
+
+        const Result sendResult = sendFragments(header, i, count, addr);
+        if (sendResult != Success)
+        {
+            return sendResult;
+        }
+    }
+
+    return Success;
+}
+
+MpiProxy::Result MpiProxy::processResend(const Header *header,
+                                         const u8 *packet,
+                                         const Size size,
+                                         const struct sockaddr & addr)
+{
+    DEBUG("rankId = " << header->rankId << " sequence = " << header->sequence);
+
+    if (header->rankId >= MaximumChannels)
+    {
+        ERROR("rankId " << header->rankId << " not found");
+        return NotFound;
+    }
+
+    const Transfer & xfer = m_transfers[header->rankId];
+    const Size elementSize = MpiDatatype::getSize((MPI_Datatype) xfer.datatype);
+
+    // Ignore requests for fragments of a response which is no longer retained
+    if (xfer.response == ZERO || elementSize == 0)
+    {
+        return Success;
+    }
+
+    const Size packetElements = (m_packetSize - sizeof(Header)) / elementSize;
+    const Size fragments = (xfer.datacount + packetElements - 1) / packetElements;
+    const u32 index = header->sequence - xfer.recvSequence;
+
+    if (index >= fragments)
+    {
+        DEBUG("fragment " << header->sequence << " is not retained");
+        return Success;
+    }
+
+    return sendFragments(header, index, 1, addr);
+}
+
+MpiProxy::Result MpiProxy::sendFragments(const Header *request,
+                                         const Size first,
+                                         const Size count,
+                                         const struct sockaddr & addr)
+{
+    const Transfer & xfer = m_transfers[request->rankId];
+    const Size elementSize = MpiDatatype::getSize((MPI_Datatype) xfer.datatype);
+    const Size packetElements = (m_packetSize - sizeof(Header)) / elementSize;
+    static u8 pkts[NetworkQueue::BatchPackets][MaximumPacketSize];
+    static struct iovec vec[NetworkQueue::BatchPackets];
+    Size packetCount = 0;
+
+    for (Size i = first; i < first + count; i++)
     {
-        MPIMessage msg;
         Header *hdr = (Header *) pkts[packetCount];
-        u8 *buf = (u8 *)(hdr + 1);
-        Size pktSize = sizeof(Header);
+        const Size offset = i * packetElements;
+        const Size remaining = xfer.datacount - offset;
 
         // Prepare header
         hdr->operation = MpiOpRecv;
         hdr->result = MPI_SUCCESS;
-        hdr->coreId = header->coreId;
-        hdr->rankId = header->rankId;
-        hdr->datatype = header->datatype;
-        hdr->datacount = 0;
+        hdr->coreId = request->coreId;
+        hdr->rankId = request->rankId;
+        hdr->datatype = xfer.datatype;
+        hdr->datacount = remaining < packetElements ? remaining : packetElements;
+        hdr->sequence = xfer.recvSequence + i;
 
-        while (pktSize < MaximumPacketSize && i < header->datacount)
-        {
-            while (ch->read(&msg) != Channel::Success)
-            {
-                ProcessCtl(SELF, Schedule, 0);
-            }
-
-            switch (header->datatype)
-            {
-                case MPI_INT:
-                    *(((int *) buf) + hdr->datacount) = msg.integer;
-                    pktSize += sizeof(int);
-                    break;
-
-                case MPI_UNSIGNED_CHAR:
-                    *(((u8 *) buf) + hdr->datacount) = msg.uchar;
-                    pktSize += sizeof(u8);
-                    break;
-
-                default:
-                {
-                    ERROR("unsupported datatype = " << header->datatype);
-                    return NotFound;
-                }
-            }
-            // Move to the next data item
-            i++;
-            pktSize++;
-            hdr->datacount++;
-        }
+        // Fill the packet with the retained elements
+        MemoryBlock::copy(hdr + 1, xfer.response + (offset * elementSize), hdr->datacount * elementSize);
 
         // Fill the I/O vector struct
         vec[packetCount].iov_base = (void *) hdr;
-        vec[packetCount].iov_len = pktSize;
+        vec[packetCount].iov_len = sizeof(Header) + (hdr->datacount * elementSize);
         packetCount++;
 
-        if (hdr->datacount != 0 && (packetCount == NetworkQueue::MaxPackets || i >= header->datacount))
+        if (packetCount == NetworkQueue::BatchPackets || i + 1 >= first + count)
         {
             // UDP send
             const Result sendResult = udpSendMultiple(vec, packetCount, addr);
@@ -404,7 +562,13 @@ MpiProxy::Result MpiProxy::processExec(const Header *header,
         return chanResult;
     }
 
-    if (header->coreId == 0)
+    // Pin each rank to a distinct core
+    if (header->coreId >= m_pids.size() || m_pids[header->coreId] != ANY)
+    {
+        ERROR("core" << header->coreId << " is not available for rankId = " << header->rankId);
+        result = InvalidArgument;
+    }
+    else if (header->coreId == 0)
     {
         result = startLocalProcess(cmd, header->rankId, header->coreCount);
     }
@@ -420,6 +584,7 @@ MpiProxy::Result MpiProxy::processExec(const Header *header,
     hdr->result = result == Success ? MPI_SUCCESS : MPI_ERR_IO;
     hdr->coreId = header->coreId;
     hdr->rankId = header->rankId;
+    hdr->datacount = m_packetSize;
     Size pktSize = sizeof(*hdr);
 
     const Result sendResult = udpSend(pkt, pktSize, addr);
@@ -542,6 +707,8 @@ MpiProxy::Result MpiProxy::createChannels(const Size rankId,
 
     const Address readMemoryBase = m_memChannelBase.phys + (PAGESIZE * 2 * rankId);
     m_readChannels.get(rankId)->setPhysical(readMemoryBase, readMemoryBase + PAGESIZE);
+    m_readStreams[rankId].reset();
+    resetTransfer(rankId);
 
     NOTICE("readChannel: rank" << rankId << ": data = " << (void *) readMemoryBase <<
           " feedback = " << (void *) (readMemoryBase + PAGESIZE));
@@ -577,6 +744,26 @@ MpiProxy::Result MpiProxy::createChannels(const Size rankId,
     return Success;
 }
 
+void MpiProxy::resetTransfer(const Size rankId)
+{
+    Transfer & xfer = m_transfers[rankId];
+
+    for (Size i = 0; i < FragmentWindow; i++)
+    {
+        if (xfer.pending[i] != ZERO)
+        {
+            delete[] xfer.pending[i];
+        }
+    }
+
+    if (xfer.response != ZERO)
+    {
+        delete[] xfer.response;
+    }
+
+    MemoryBlock::set(&xfer, 0, sizeof(xfer));
+}
+
 MpiProxy::Result MpiProxy::startLocalProcess(const char *command,
                                              const Size rankId,
                                              const Size coreCount)
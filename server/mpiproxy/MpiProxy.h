@@ -23,6 +23,7 @@
 #include <Memory.h>
 #include <Array.h>
 #include <POSIXApplication.h>
+#include <MpiStream.h>
 #include <sys/socket.h>
 
 class NetworkClient;
@@ -44,8 +45,8 @@ class MemoryChannel;
  *
  * @todo This server might be able re-use the MpiTarget class by inheritance or as a member instance
  *
- * @todo MpiProxy protocol currently uses UDP which does not protect against packet loss or corruption.
- *       A simple solution can be implemented by using retransmissions and acknowledge packets
+ * @todo Only MpiOpSend and MpiOpRecv data is protected against packet loss. The
+ *       MpiOpExec and MpiOpTerminate requests are not retransmitted.
  */
 class MpiProxy : public POSIXApplication
 {
@@ -57,13 +58,25 @@ class MpiProxy : public POSIXApplication
     /** Timeout in milliseconds to wait for packet receive */
     static const Size ReceiveTimeoutMs = 500;
 
+    /** Number of packets queued by the UDP socket for receiving bursts */
+    static const Size ReceiveQueueSize = 256;
+
+    /** Maximum number of packets received with a single request */
+    static const Size ReceiveBatchSize = 16;
+
     /** Maximum number of supported MPI channels */
     static const Size MaximumChannels = 128u;
 
   public:
 
-    /** Maximum size of packet payload */
-    static const Size MaximumPacketSize = 1448;
+    /** Size of packet payload which fits in the default MTU */
+    static const Size DefaultPacketSize = 1448;
+
+    /** Maximum size of packet payload, which fits in a 9000 byte jumbo frame MTU */
+    static const Size MaximumPacketSize = 8972;
+
+    /** Maximum number of unacknowledged data fragments in flight per rank */
+    static const Size FragmentWindow = 32;
 
     /**
      * Encodes various MPI operations
@@ -73,11 +86,20 @@ class MpiProxy : public POSIXApplication
         MpiOpSend = 0,
         MpiOpRecv,
         MpiOpExec,
-        MpiOpTerminate
+        MpiOpTerminate,
+        MpiOpAck,
+        MpiOpResend
     };
 
     /**
      * Packet payload header for MPI messages via IP/UDP
+     *
+     * Large messages are split into fragments of at most the packet size of the proxy,
+     * which follows from the MTU of its network device. The proxy reports its packet
+     * size in the datacount field of the MpiOpExec acknowledge.
+     * Each fragment carries a sequence number which increments continuously per rank
+     * and per direction. For MpiOpAck the sequence is the fragment acknowledged and
+     * the datacount is the next in-order sequence expected by the receiver.
      */
     struct Header
     {
@@ -92,6 +114,22 @@ class MpiProxy : public POSIXApplication
             u16 datatype;
         };
         u32 datacount;
+        u32 sequence;
+    };
+
+  private:
+
+    /**
+     * Reliable transfer state of a single rank
+     */
+    struct Transfer
+    {
+        u32 sendSequence;               /**< Next in-order MpiOpSend fragment expected */
+        u8 *pending[FragmentWindow];    /**< Out-of-order MpiOpSend fragments */
+        u32 recvSequence;               /**< Sequence number of the first MpiOpRecv response fragment */
+        u8 *response;                   /**< Data of the last MpiOpRecv response for retransmission */
+        Size datacount;                 /**< Number of elements in the response */
+        u16 datatype;                   /**< Datatype of the response elements */
     };
 
   public:
@@ -141,6 +179,8 @@ class MpiProxy : public POSIXApplication
     /**
      * Send multiple UDP packets
      *
+     * The packets are submitted in batches with sendmmsg().
+     *
      * @param vec I/O vector with multiple packets
      * @param count Number of entries in the I/O vector
      * @param addr The destination IP and port
@@ -152,17 +192,20 @@ class MpiProxy : public POSIXApplication
                            const struct sockaddr & addr) const;
 
     /**
-     * Receive UDP packet
+     * Receive multiple UDP packets
+     *
+     * Waits for the first packet and then receives all
+     * queued packets which fit with a single recvmmsg().
      *
-     * @param packet Payload output
-     * @param size Output for number of bytes received
-     * @param addr Output for the source IP and port
+     * @param msgs Message headers with the payload buffers and source addresses.
+     *             On output msg_len contains the number of bytes received.
+     * @param count Number of message headers on input.
+     *              On output, the number of packets received.
      *
      * @return Result code
      */
-    Result udpReceive(void *packet,
-                      Size & size,
-                      struct sockaddr & addr) const;
+    Result udpReceiveMultiple(struct mmsghdr *msgs,
+                              Size & count) const;
 
     /**
      * Process incoming packet
@@ -180,15 +223,21 @@ class MpiProxy : public POSIXApplication
     /**
      * Process MPI send request
      *
+     * Fragments are written to the channel in sequence order. Fragments which
+     * arrive ahead of a missing fragment are buffered inside the window.
+     * Every fragment is acknowledged, including duplicates.
+     *
      * @param header Packet header pointer
      * @param packet Full packet input
      * @param size Number of bytes received
+     * @param addr Source IP and port of the packet
      *
      * @return Result code
      */
     Result processSend(const Header *header,
                        const u8 *packet,
-                       const Size size);
+                       const Size size,
+                       const struct sockaddr & addr);
 
     /**
      * Process MPI recv request
@@ -205,6 +254,38 @@ class MpiProxy : public POSIXApplication
                        const Size size,
                        const struct sockaddr & addr);
 
+    /**
+     * Process MPI resend request
+     *
+     * Retransmits a single fragment of the last MpiOpRecv response.
+     *
+     * @param header Packet header pointer
+     * @param packet Full packet input
+     * @param size Number of bytes received
+     * @param addr Source IP and port of the packet
+     *
+     * @return Result code
+     */
+    Result processResend(const Header *header,
+                         const u8 *packet,
+                         const Size size,
+                         const struct sockaddr & addr);
+
+    /**
+     * Send fragments of the last MpiOpRecv response
+     *
+     * @param request Header of the request packet
+     * @param first Index of the first fragment to send
+     * @param count Number of fragments to send
+     * @param addr The destination IP and port
+     *
+     * @return Result code
+     */
+    Result sendFragments(const Header *request,
+                         const Size first,
+                         const Size count,
+                         const struct sockaddr & addr);
+
     /**
      * Process execute request
      *
@@ -248,6 +329,13 @@ class MpiProxy : public POSIXApplication
     Result createChannels(const Size rankId,
                           const Size coreCount);
 
+    /**
+     * Discard reliable transfer state of a rank
+     *
+     * @param rankId Rank identifier
+     */
+    void resetTransfer(const Size rankId);
+
     /**
      * Start a process on the local processor
      *
@@ -284,6 +372,9 @@ class MpiProxy : public POSIXApplication
     /** Networking client object */
     NetworkClient *m_client;
 
+    /** Size of the payload of each packet, including the Header */
+    Size m_packetSize;
+
     /** Memory base address for local MPI communication */
     Memory::Range m_memChannelBase;
 
@@ -293,6 +384,12 @@ class MpiProxy : public POSIXApplication
     /** Stores all channels for sending data to processes */
     Index<MemoryChannel, MaximumChannels> m_writeChannels;
 
+    /** Partially received messages from each process */
+    MpiStream m_readStreams[MaximumChannels];
+
+    /** Fragment sequencing and retransmission state of each rank */
+    Transfer m_transfers[MaximumChannels];
+
     /** Records the PID of each process participating in the computation */
     Array<ProcessID, MaximumChannels> m_pids;
 };
@@ -0,0 +1,618 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Log.h>
+#include <ByteOrder.h>
+#include <MemoryBlock.h>
+#include <InternetChecksum.h>
+#include <IPV4.h>
+#include <TCP.h>
+#include <UDP.h>
+#include <ICMP.h>
+#include "E1000.h"
+
+E1000::E1000(const u32 inode,
+             NetworkServer &server)
+    : NetworkDevice(inode, server, RingSize + NetworkQueue::SharedPackets, RingSize, MaximumMTU)
+    , m_irq(0)
+    , m_receiveDesc(ZERO)
+    , m_receiveIndex(0)
+    , m_transmitDesc(ZERO)
+    , m_transmitIndex(0)
+    , m_transmitClean(0)
+    , m_transmitCount(0)
+    , m_transmitContext(0)
+{
+    DEBUG("");
+
+    m_capabilities = TransmitChecksum | ReceiveChecksum;
+    MemoryBlock::set(&m_receiveDescRange, 0, sizeof(m_receiveDescRange));
+    MemoryBlock::set(&m_transmitDescRange, 0, sizeof(m_transmitDescRange));
+}
+
+E1000::~E1000()
+{
+    DEBUG("");
+}
+
+FileSystem::Result E1000::initialize()
+{
+    DEBUG("");
+
+    const FileSystem::Result detectResult = detect();
+    if (detectResult != FileSystem::Success)
+    {
+        return detectResult;
+    }
+
+    // Allocate descriptor rings
+    m_receiveDescRange.size = sizeof(ReceiveDescriptor) * RingSize;
+    m_receiveDescRange.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    API::Result vmResult = VMCtl(SELF, MapContiguous, &m_receiveDescRange);
+    if (vmResult != API::Success)
+    {
+        ERROR("failed to allocate receive descriptors: result = " << (int) vmResult);
+        return FileSystem::IOError;
+    }
+
+    m_transmitDescRange.size = sizeof(DataDescriptor) * RingSize;
+    m_transmitDescRange.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    vmResult = VMCtl(SELF, MapContiguous, &m_transmitDescRange);
+    if (vmResult != API::Success)
+    {
+        ERROR("failed to allocate transmit descriptors: result = " << (int) vmResult);
+        return FileSystem::IOError;
+    }
+
+    m_receiveDesc = (volatile ReceiveDescriptor *) m_receiveDescRange.virt;
+    m_transmitDesc = (volatile DataDescriptor *) m_transmitDescRange.virt;
+
+    // Reset the controller and setup both rings
+    const FileSystem::Result resetResult = reset();
+    if (resetResult != FileSystem::Success)
+    {
+        ERROR("hardware reset failed: result = " << (int) resetResult);
+        return resetResult;
+    }
+
+    // Initialize network protocols stack
+    const FileSystem::Result result = NetworkDevice::initialize();
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to initialize NetworkDevice: result = " << (int) result);
+        return FileSystem::IOError;
+    }
+
+    // Enable interrupts
+    m_io.write(Throttling, InterruptThrottle);
+    m_io.write(InterruptMaskSet, IntReceive | IntTransmitDone | IntLinkStatus);
+    m_server.registerInterrupt(this, m_irq);
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result E1000::getAddress(Ethernet::Address *address)
+{
+    const u32 low = m_io.read(ReceiveAddrLow);
+    const u32 high = m_io.read(ReceiveAddrHigh);
+
+    for (Size i = 0; i < 4; i++)
+    {
+        address->addr[i] = (low >> (i * 8)) & 0xff;
+    }
+    address->addr[4] = high & 0xff;
+    address->addr[5] = (high >> 8) & 0xff;
+
+    DEBUG("address = " << *address);
+    return FileSystem::Success;
+}
+
+FileSystem::Result E1000::setAddress(const Ethernet::Address *address)
+{
+    DEBUG("address = " << *address);
+
+    m_io.write(ReceiveAddrLow, address->addr[0] | (address->addr[1] << 8) |
+                               (address->addr[2] << 16) | (address->addr[3] << 24));
+    m_io.write(ReceiveAddrHigh, address->addr[4] | (address->addr[5] << 8) | ReceiveAddrValid);
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result E1000::interrupt(const Size vector)
+{
+    // Reading the cause clears it
+    const u32 cause = m_io.read(InterruptCause);
+
+    DEBUG("vector = " << vector << " cause = " << (void *) cause);
+
+    // Received frames are polled with the receive interrupt masked until the ring is empty
+    if (cause & IntReceive)
+    {
+        m_io.write(InterruptMaskClear, IntReceive);
+        m_polling = true;
+    }
+
+    if (cause & IntLinkStatus)
+    {
+        NOTICE("link " << ((m_io.read(Status) & StatusLinkUp) ? "up" : "down"));
+    }
+
+    if (cause & IntTransmitDone)
+    {
+        reclaimTransmit();
+    }
+
+    // Re-enable the interrupt line on the interrupt controller
+    ProcessCtl(SELF, EnableIRQ, m_irq);
+    return FileSystem::Success;
+}
+
+FileSystem::Result E1000::poll()
+{
+    Size count = 0;
+
+    // Receive the next batch of frames
+    receive(ReceiveBudget, count);
+    if (count == ReceiveBudget)
+    {
+        return FileSystem::RetryAgain;
+    }
+
+    // The ring is empty: re-arm the receive interrupt
+    m_io.write(InterruptMaskSet, IntReceive);
+
+    // Frames received before the interrupt was unmasked may not raise an interrupt
+    if (receivePending())
+    {
+        m_io.write(InterruptMaskClear, IntReceive);
+        return FileSystem::RetryAgain;
+    }
+
+    m_polling = false;
+    return FileSystem::Success;
+}
+
+FileSystem::Result E1000::transmit(NetworkQueue::Packet *pkt)
+{
+    DEBUG("size = " << pkt->size);
+
+    if (!m_transmitPending.push(pkt))
+    {
+        ERROR("transmit queue full");
+        return FileSystem::IOError;
+    }
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result E1000::startDMA()
+{
+    DEBUG("");
+
+    const Size previous = m_transmitIndex;
+
+    reclaimTransmit();
+
+    // Each packet needs a data descriptor and possibly a context descriptor.
+    // One descriptor stays unused, such that a full ring differs from an empty ring.
+    while (m_transmitPending.count() > 0 && m_transmitCount + 2 < RingSize)
+    {
+        NetworkQueue::Packet *pkt = m_transmitPending.pop();
+        const bool offload = (pkt->flags & NetworkQueue::ChecksumOffload) && prepareChecksum(pkt);
+        volatile DataDescriptor *desc = &m_transmitDesc[m_transmitIndex];
+
+        desc->address = m_transmit.getPhysicalAddress(pkt);
+        desc->command = pkt->size | TransmitDescData | TransmitDescExtended |
+                        TransmitDescEnd | TransmitDescInsertFCS | TransmitDescReport;
+        desc->status = 0;
+        desc->options = offload ? (TransmitDescIPSum | TransmitDescPayloadSum) : 0;
+        desc->special = 0;
+
+        m_transmitPackets.insertAt(m_transmitIndex, pkt);
+        m_transmitIndex = (m_transmitIndex + 1) % RingSize;
+        m_transmitCount++;
+    }
+
+    // Pass the whole batch to the controller at once
+    if (m_transmitIndex != previous)
+    {
+        m_io.write(TransmitDescTail, m_transmitIndex);
+    }
+
+    return FileSystem::Success;
+}
+
+u32 E1000::readPCI(const uint bus, const uint slot, const uint func, const uint reg)
+{
+    m_pci.outl(PciConfigAddress, (1U << 31) | (bus << 16) | (slot << 11) | (func << 8) | (reg & 0xfc));
+    return m_pci.inl(PciConfigData);
+}
+
+void E1000::writePCI(const uint bus, const uint slot, const uint func,
+                     const uint reg, const u32 value)
+{
+    m_pci.outl(PciConfigAddress, (1U << 31) | (bus << 16) | (slot << 11) | (func << 8) | (reg & 0xfc));
+    m_pci.outl(PciConfigData, value);
+}
+
+bool E1000::isSupported(const u16 deviceId) const
+{
+    switch (deviceId)
+    {
+        case 0x100E: // 82540EM
+        case 0x100F: // 82545EM
+        case 0x1004: // 82543GC
+        case 0x10D3: // 82574L
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+FileSystem::Result E1000::detect()
+{
+    // Search the PCI bus for a supported controller
+    for (uint bus = 0; bus < 256; bus++)
+    {
+        for (uint slot = 0; slot < 32; slot++)
+        {
+            for (uint func = 0; func < 8; func++)
+            {
+                const u32 id = readPCI(bus, slot, func, PciIdentifier);
+
+                if ((id & 0xffff) != VendorId || !isSupported(id >> 16))
+                {
+                    continue;
+                }
+
+                // The registers are memory mapped by BAR0
+                const u32 bar = readPCI(bus, slot, func, PciBar0);
+                if (bar & 1)
+                {
+                    ERROR("BAR0 is not a memory range: bar = " << (void *) bar);
+                    return FileSystem::NotFound;
+                }
+
+                const u32 cmd = readPCI(bus, slot, func, PciCommand);
+                writePCI(bus, slot, func, PciCommand, cmd | PciCommandMemory | PciCommandMaster);
+
+                m_irq = readPCI(bus, slot, func, PciInterrupt) & 0xff;
+
+                const IO::Result mapResult = m_io.map(bar & ~0xfU, RegisterSpaceSize,
+                                                      Memory::User | Memory::Readable |
+                                                      Memory::Writable | Memory::Device);
+                if (mapResult != IO::Success)
+                {
+                    ERROR("failed to map hardware registers: result = " << (int) mapResult);
+                    return FileSystem::IOError;
+                }
+
+                NOTICE("found device " << (void *) (id >> 16) << " at " << bus << ":" << slot <<
+                       "." << func << " mmio = " << (void *) (bar & ~0xfU) << " irq = " << m_irq);
+                return FileSystem::Success;
+            }
+        }
+    }
+
+    ERROR("no e1000 network controller found");
+    return FileSystem::NotFound;
+}
+
+FileSystem::Result E1000::reset()
+{
+    DEBUG("");
+
+    Ethernet::Address mac;
+    getAddress(&mac);
+
+    // Mask all interrupts and reset the controller
+    m_io.write(InterruptMaskClear, 0xffffffff);
+    m_io.set(Control, ControlReset);
+
+    for (Size i = 0; i < MaximumResetPoll && (m_io.read(Control) & ControlReset); i++)
+        ;
+
+    if (m_io.read(Control) & ControlReset)
+    {
+        ERROR("reset timed out");
+        return FileSystem::IOError;
+    }
+
+    m_io.write(InterruptMaskClear, 0xffffffff);
+    m_io.read(InterruptCause);
+
+    // The controller loads its ethernet address from the EEPROM on reset
+    if (!(m_io.read(ReceiveAddrHigh) & ReceiveAddrValid))
+    {
+        setAddress(&mac);
+    }
+
+    // Let the link come up with auto-negotiated speed
+    m_io.set(Control, ControlSetLinkUp | ControlAutoSpeed);
+
+    // Only accept multicast frames for which the stack asks
+    for (Size i = 0; i < MulticastTableSize; i++)
+    {
+        m_io.write(MulticastTable + (i * sizeof(u32)), 0);
+    }
+
+    const FileSystem::Result rxResult = resetReceive();
+    if (rxResult != FileSystem::Success)
+    {
+        ERROR("failed to reset receive control: result = " << (int) rxResult);
+        return rxResult;
+    }
+
+    const FileSystem::Result txResult = resetTransmit();
+    if (txResult != FileSystem::Success)
+    {
+        ERROR("failed to reset transmit control: result = " << (int) txResult);
+        return txResult;
+    }
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result E1000::resetReceive()
+{
+    DEBUG("");
+
+    for (Size i = 0; i < RingSize; i++)
+    {
+        NetworkQueue::Packet *pkt = m_receivePackets.get(i);
+
+        if (pkt == ZERO)
+        {
+            pkt = m_receive.get();
+            if (pkt == ZERO)
+            {
+                ERROR("failed to get receive packet buffer");
+                return FileSystem::IOError;
+            }
+            m_receivePackets.insertAt(i, pkt);
+        }
+
+        m_receiveDesc[i].address = m_receive.getPhysicalAddress(pkt);
+        m_receiveDesc[i].status = 0;
+    }
+
+    m_receiveIndex = 0;
+
+    // The controller owns all descriptors from the head up to the tail
+    m_io.write(ReceiveDescLow, m_receiveDescRange.phys);
+    m_io.write(ReceiveDescHigh, 0);
+    m_io.write(ReceiveDescLength, m_receiveDescRange.size);
+    m_io.write(ReceiveDescHead, 0);
+    m_io.write(ReceiveDescTail, RingSize - 1);
+    m_io.write(ReceiveCsumCtl, ReceiveCsumIP | ReceiveCsumTCPUDP);
+
+    // Program the buffer size of the receive queue and accept long packets
+    u32 control = ReceiveCtlEnable | ReceiveCtlBroadcast | ReceiveCtlStripCRC;
+
+    switch (m_receive.getBufferSize())
+    {
+        case 4096:  control |= ReceiveCtlLongPacket | ReceiveCtlSizeExtend | ReceiveCtlSize4K; break;
+        case 8192:  control |= ReceiveCtlLongPacket | ReceiveCtlSizeExtend | ReceiveCtlSize8K; break;
+        case 16384: control |= ReceiveCtlLongPacket | ReceiveCtlSizeExtend | ReceiveCtlSize16K; break;
+        default:    break;
+    }
+    m_io.write(ReceiveCtl, control);
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result E1000::resetTransmit()
+{
+    DEBUG("");
+
+    // Release packets which were still pending
+    while (m_transmitCount > 0)
+    {
+        NetworkQueue::Packet *pkt = m_transmitPackets.get(m_transmitClean);
+        if (pkt != ZERO)
+        {
+            m_transmitPackets.remove(m_transmitClean);
+            m_transmit.release(pkt);
+        }
+
+        m_transmitClean = (m_transmitClean + 1) % RingSize;
+        m_transmitCount--;
+    }
+
+    MemoryBlock::set((void *) m_transmitDescRange.virt, 0, m_transmitDescRange.size);
+
+    m_transmitIndex = 0;
+    m_transmitClean = 0;
+    m_transmitContext = 0;
+
+    m_io.write(TransmitDescLow, m_transmitDescRange.phys);
+    m_io.write(TransmitDescHigh, 0);
+    m_io.write(TransmitDescLength, m_transmitDescRange.size);
+    m_io.write(TransmitDescHead, 0);
+    m_io.write(TransmitDescTail, 0);
+    m_io.write(TransmitIPG, TransmitIPGDefault);
+    m_io.write(TransmitCtl, TransmitCtlEnable | TransmitCtlPadShort |
+                            TransmitCtlCollision | TransmitCtlCollDist);
+
+    return FileSystem::Success;
+}
+
+void E1000::receive(const Size budget, Size & count)
+{
+    DEBUG("budget = " << budget);
+
+    Size last = RingSize;
+
+    for (count = 0; count < budget && receivePending(); count++)
+    {
+        volatile ReceiveDescriptor *desc = &m_receiveDesc[m_receiveIndex];
+        NetworkQueue::Packet *pkt = m_receivePackets.get(m_receiveIndex);
+        const u8 status = desc->status;
+        const u8 errors = desc->errors;
+
+        if (!(status & ReceiveDescEnd))
+        {
+            ERROR("frame does not fit in one buffer: skipping packet");
+        }
+        else
+        {
+            pkt->size = desc->length;
+
+            // The controller verified the IP header and payload checksums
+            pkt->flags = ((status & ReceiveDescIPChecked) &&
+                          (status & (ReceiveDescTCPChecked | ReceiveDescUDPChecked)) &&
+                         !(status & ReceiveDescIgnoreSum) &&
+                         !(errors & (ReceiveDescIPError | ReceiveDescTCPUDPError))) ?
+                          NetworkQueue::ChecksumVerified : 0;
+            process(pkt);
+
+            // Receive the next frame in a fresh buffer if the packet was queued to a socket
+            NetworkQueue::Packet *next = m_receive.recycle(pkt);
+            if (next != pkt)
+            {
+                m_receivePackets.insertAt(m_receiveIndex, next);
+                desc->address = m_receive.getPhysicalAddress(next);
+            }
+        }
+
+        // The packet buffer is reused for the next frame
+        desc->status = 0;
+        last = m_receiveIndex;
+        m_receiveIndex = (m_receiveIndex + 1) % RingSize;
+    }
+
+    // Return all processed descriptors to the controller at once
+    if (last != RingSize)
+    {
+        m_io.write(ReceiveDescTail, last);
+    }
+}
+
+bool E1000::receivePending() const
+{
+    return (m_receiveDesc[m_receiveIndex].status & ReceiveDescDone) != 0;
+}
+
+bool E1000::prepareChecksum(NetworkQueue::Packet *pkt)
+{
+    const Ethernet::Header *ether = (const Ethernet::Header *) pkt->data;
+    IPV4::Header *ip = (IPV4::Header *) (ether + 1);
+
+    if (readBe16(&ether->type) != Ethernet::IPV4)
+    {
+        return false;
+    }
+
+    const Size ipStart = sizeof(Ethernet::Header);
+    const Size ipSize = (ip->versionIHL & 0xf) * sizeof(u32);
+    const Size payloadStart = ipStart + ipSize;
+    u8 *payload = pkt->data + payloadStart;
+    u16 *checksum = ZERO;
+    u32 command = TransmitDescContext | TransmitDescExtended | TransmitDescIPV4;
+
+    // The controller sums the payload from the start of the transport header,
+    // which must already contain the sum of the pseudo header for TCP and UDP.
+    switch (ip->protocol)
+    {
+        case IPV4::ICMP:
+            checksum = &((ICMP::Header *) payload)->checksum;
+            break;
+
+        case IPV4::UDP:
+            checksum = &((UDP::Header *) payload)->checksum;
+            break;
+
+        case IPV4::TCP:
+            checksum = &((TCP::Header *) payload)->checksum;
+            command |= TransmitDescTCP;
+            break;
+
+        default:
+            return false;
+    }
+
+    if (ip->protocol != IPV4::ICMP)
+    {
+        const u32 pseudo = InternetChecksum::pseudoHeader(read32(&ip->source),
+                                                          read32(&ip->destination),
+                                                          ip->protocol,
+                                                          readBe16(&ip->length) - ipSize);
+        write16(checksum, InternetChecksum::sum(ZERO, 0, pseudo));
+    }
+
+    // Packets of the same protocol use the same offsets: keep the loaded context
+    const Size payloadOffset = (u8 *) checksum - pkt->data;
+    const u32 context = ipSize | (payloadOffset << 8) | (ip->protocol << 16);
+
+    if (context != m_transmitContext)
+    {
+        volatile ContextDescriptor *ctx = (volatile ContextDescriptor *) &m_transmitDesc[m_transmitIndex];
+
+        ctx->ipStart = ipStart;
+        ctx->ipOffset = ipStart + 10;
+        ctx->ipEnd = payloadStart - 1;
+        ctx->payloadStart = payloadStart;
+        ctx->payloadOffset = payloadOffset;
+        ctx->payloadEnd = 0;
+        ctx->command = command;
+        ctx->status = 0;
+        ctx->headerLength = 0;
+        ctx->segmentSize = 0;
+
+        m_transmitPackets.remove(m_transmitIndex);
+        m_transmitIndex = (m_transmitIndex + 1) % RingSize;
+        m_transmitCount++;
+        m_transmitContext = context;
+    }
+
+    return true;
+}
+
+void E1000::reclaimTransmit()
+{
+    while (m_transmitCount > 0)
+    {
+        NetworkQueue::Packet *pkt = m_transmitPackets.get(m_transmitClean);
+
+        // A context descriptor is done once the data descriptor after it is done
+        if (pkt == ZERO)
+        {
+            if (m_transmitCount < 2 ||
+                !(m_transmitDesc[(m_transmitClean + 1) % RingSize].status & TransmitDescDone))
+            {
+                break;
+            }
+        }
+        else if (!(m_transmitDesc[m_transmitClean].status & TransmitDescDone))
+        {
+            break;
+        }
+        else
+        {
+            DEBUG("releasing tx:pkt = " << (void *) pkt);
+
+            m_transmitPackets.remove(m_transmitClean);
+            m_transmit.release(pkt);
+        }
+
+        m_transmitClean = (m_transmitClean + 1) % RingSize;
+        m_transmitCount--;
+    }
+}
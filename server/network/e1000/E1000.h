@@ -0,0 +1,458 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVER_NETWORK_E1000_E1000_H
+#define __SERVER_NETWORK_E1000_E1000_H
+
+#include <FreeNOS/System.h>
+#include <Types.h>
+#include <Index.h>
+#include <Queue.h>
+#include <NetworkServer.h>
+#include <NetworkDevice.h>
+#include <Ethernet.h>
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup e1000
+ * @{
+ */
+
+/**
+ * Intel 8254x (e1000) and 82574 (e1000e) gigabit network controllers.
+ *
+ * Both families are driven through the same descriptor rings. Received frames
+ * are polled with the receive interrupt masked and the receive descriptors are
+ * returned to the controller in bulk after each batch. Transmitted frames are
+ * written as a batch of descriptors followed by a single tail update. The
+ * interrupt rate is limited by the interrupt throttling register (ITR).
+ */
+class E1000 : public NetworkDevice
+{
+  private:
+
+    /** PCI vendor identifier of Intel */
+    static const u16 VendorId = 0x8086;
+
+    /** Size of the memory mapped register space */
+    static const Size RegisterSpaceSize = 0x20000;
+
+    /** Number of receive and transmit descriptors, which fill one page each */
+    static const Size RingSize = 256;
+
+    /** Maximum number of frames received per poll */
+    static const Size ReceiveBudget = 32;
+
+    /** Largest supported MTU, which enables jumbo frames */
+    static const Size MaximumMTU = 9000;
+
+    /** Minimum interval between interrupts in units of 256ns: about 8000 interrupts per second */
+    static const u32 InterruptThrottle = 488;
+
+    /** Maximum number of polling reset iterations */
+    static const Size MaximumResetPoll = 100000;
+
+    /** Number of entries in the multicast table array */
+    static const Size MulticastTableSize = 128;
+
+    /**
+     * PCI configuration space
+     */
+    enum PciRegisters
+    {
+        PciConfigAddress = 0xcf8, /**@< Configuration address I/O port */
+        PciConfigData    = 0xcfc, /**@< Configuration data I/O port */
+        PciIdentifier    = 0x00,  /**@< Vendor and device identifier */
+        PciCommand       = 0x04,  /**@< Command register */
+        PciBar0          = 0x10,  /**@< Base address register 0 */
+        PciInterrupt     = 0x3c   /**@< Interrupt line */
+    };
+
+    /**
+     * PCI command register flags
+     */
+    enum PciCommandFlags
+    {
+        PciCommandMemory = (1 << 1),
+        PciCommandMaster = (1 << 2)
+    };
+
+    /**
+     * Hardware registers
+     */
+    enum Registers
+    {
+        Control            = 0x0000, /**@< Device Control */
+        Status             = 0x0008, /**@< Device Status */
+        InterruptCause     = 0x00C0, /**@< Interrupt Cause Read, cleared on read */
+        Throttling         = 0x00C4, /**@< Interrupt Throttling */
+        InterruptMaskSet   = 0x00D0, /**@< Interrupt Mask Set */
+        InterruptMaskClear = 0x00D8, /**@< Interrupt Mask Clear */
+        ReceiveCtl         = 0x0100, /**@< Receive Control */
+        TransmitCtl        = 0x0400, /**@< Transmit Control */
+        TransmitIPG        = 0x0410, /**@< Transmit Inter Packet Gap */
+        ReceiveDescLow     = 0x2800, /**@< Receive Descriptor Base Address Low */
+        ReceiveDescHigh    = 0x2804, /**@< Receive Descriptor Base Address High */
+        ReceiveDescLength  = 0x2808, /**@< Receive Descriptor Length */
+        ReceiveDescHead    = 0x2810, /**@< Receive Descriptor Head */
+        ReceiveDescTail    = 0x2818, /**@< Receive Descriptor Tail */
+        TransmitDescLow    = 0x3800, /**@< Transmit Descriptor Base Address Low */
+        TransmitDescHigh   = 0x3804, /**@< Transmit Descriptor Base Address High */
+        TransmitDescLength = 0x3808, /**@< Transmit Descriptor Length */
+        TransmitDescHead   = 0x3810, /**@< Transmit Descriptor Head */
+        TransmitDescTail   = 0x3818, /**@< Transmit Descriptor Tail */
+        ReceiveCsumCtl     = 0x5000, /**@< Receive Checksum Control */
+        MulticastTable     = 0x5200, /**@< Multicast Table Array */
+        ReceiveAddrLow     = 0x5400, /**@< Receive Address Low */
+        ReceiveAddrHigh    = 0x5404  /**@< Receive Address High */
+    };
+
+    /**
+     * Hardware register flags
+     */
+    enum RegisterFlags
+    {
+        ControlAutoSpeed      = (1 << 5),
+        ControlSetLinkUp      = (1 << 6),
+        ControlReset          = (1 << 26),
+        StatusLinkUp          = (1 << 1),
+        IntTransmitDone       = (1 << 0),
+        IntLinkStatus         = (1 << 2),
+        IntReceiveMinimum     = (1 << 4),
+        IntReceiveOverrun     = (1 << 6),
+        IntReceiveTimer       = (1 << 7),
+        IntReceive            = (IntReceiveMinimum | IntReceiveOverrun | IntReceiveTimer),
+        ReceiveCtlEnable      = (1 << 1),
+        ReceiveCtlLongPacket  = (1 << 5),
+        ReceiveCtlBroadcast   = (1 << 15),
+        ReceiveCtlSize16K     = (1 << 16),
+        ReceiveCtlSize8K      = (2 << 16),
+        ReceiveCtlSize4K      = (3 << 16),
+        ReceiveCtlSizeExtend  = (1 << 25),
+        ReceiveCtlStripCRC    = (1 << 26),
+        TransmitCtlEnable     = (1 << 1),
+        TransmitCtlPadShort   = (1 << 3),
+        TransmitCtlCollision  = (0x0f << 4),
+        TransmitCtlCollDist   = (0x40 << 12),
+        TransmitIPGDefault    = 0x0060200a,
+        ReceiveCsumIP         = (1 << 8),
+        ReceiveCsumTCPUDP     = (1 << 9),
+        ReceiveAddrValid      = (1U << 31)
+    };
+
+    /**
+     * Receive descriptor
+     */
+    typedef struct ReceiveDescriptor
+    {
+        u64 address;
+        u16 length;
+        u16 checksum;
+        u8 status;
+        u8 errors;
+        u16 special;
+    }
+    ReceiveDescriptor;
+
+    /**
+     * Receive descriptor status and error flags
+     */
+    enum ReceiveDescFlags
+    {
+        ReceiveDescDone        = (1 << 0),
+        ReceiveDescEnd         = (1 << 1),
+        ReceiveDescIgnoreSum   = (1 << 2),
+        ReceiveDescUDPChecked  = (1 << 4),
+        ReceiveDescTCPChecked  = (1 << 5),
+        ReceiveDescIPChecked   = (1 << 6),
+        ReceiveDescTCPUDPError = (1 << 5),
+        ReceiveDescIPError     = (1 << 6)
+    };
+
+    /**
+     * Transmit context descriptor, which selects the checksums to insert
+     */
+    typedef struct ContextDescriptor
+    {
+        u8 ipStart;
+        u8 ipOffset;
+        u16 ipEnd;
+        u8 payloadStart;
+        u8 payloadOffset;
+        u16 payloadEnd;
+        u32 command;
+        u8 status;
+        u8 headerLength;
+        u16 segmentSize;
+    }
+    ContextDescriptor;
+
+    /**
+     * Transmit data descriptor, in the extended format
+     */
+    typedef struct DataDescriptor
+    {
+        u64 address;
+        u32 command;
+        u8 status;
+        u8 options;
+        u16 special;
+    }
+    DataDescriptor;
+
+    /**
+     * Transmit descriptor command, status and option flags
+     */
+    enum TransmitDescFlags
+    {
+        TransmitDescContext   = (0 << 20),
+        TransmitDescData      = (1 << 20),
+        TransmitDescEnd       = (1 << 24),
+        TransmitDescInsertFCS = (1 << 25),
+        TransmitDescReport    = (1 << 27),
+        TransmitDescExtended  = (1 << 29),
+        TransmitDescIPV4      = (1 << 25),
+        TransmitDescTCP       = (1 << 24),
+        TransmitDescDone      = (1 << 0),
+        TransmitDescIPSum     = (1 << 0),
+        TransmitDescPayloadSum = (1 << 1)
+    };
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param inode Inode number
+     * @param server NetworkServer reference
+     */
+    E1000(const u32 inode,
+          NetworkServer &server);
+
+    /**
+     * Destructor
+     */
+    virtual ~E1000();
+
+    /**
+     * Initialize the device
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result initialize();
+
+    /**
+     * Read ethernet address.
+     *
+     * @param address Ethernet address reference for output
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result getAddress(Ethernet::Address *address);
+
+    /**
+     * Set ethernet address
+     *
+     * @param address New ethernet address to set
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result setAddress(const Ethernet::Address *address);
+
+    /**
+     * Called when an interrupt has been triggered for this device.
+     *
+     * @param vector Vector number of the interrupt.
+     *
+     * @return Result code.
+     */
+    virtual FileSystem::Result interrupt(const Size vector);
+
+    /**
+     * Receive a batch of frames while in polling mode.
+     *
+     * Re-enables the receive interrupt once the receive ring is empty.
+     *
+     * @return Success if no more frames are pending or RetryAgain otherwise
+     */
+    virtual FileSystem::Result poll();
+
+    /**
+     * Add a network packet to the transmit queue.
+     *
+     * @param pkt Network packet to transmit
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result transmit(NetworkQueue::Packet *pkt);
+
+    /**
+     * Pass pending packets to the transmit ring.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result startDMA();
+
+  private:
+
+    /**
+     * Read a 32-bit register from PCI configuration space.
+     *
+     * @param bus PCI bus number
+     * @param slot PCI slot number
+     * @param func PCI function number
+     * @param reg Register offset
+     *
+     * @return Register value
+     */
+    u32 readPCI(const uint bus, const uint slot, const uint func, const uint reg);
+
+    /**
+     * Write a 32-bit register in PCI configuration space.
+     *
+     * @param bus PCI bus number
+     * @param slot PCI slot number
+     * @param func PCI function number
+     * @param reg Register offset
+     * @param value Value to write
+     */
+    void writePCI(const uint bus, const uint slot, const uint func, const uint reg, const u32 value);
+
+    /**
+     * Check if a PCI device identifier is a supported controller.
+     *
+     * @param deviceId PCI device identifier
+     *
+     * @return True if supported
+     */
+    bool isSupported(const u16 deviceId) const;
+
+    /**
+     * Find the controller on the PCI bus and map its registers.
+     *
+     * @return Result code
+     */
+    FileSystem::Result detect();
+
+    /**
+     * Reset the controller.
+     *
+     * @return Result code
+     */
+    FileSystem::Result reset();
+
+    /**
+     * Setup the receive ring.
+     *
+     * @return Result code
+     */
+    FileSystem::Result resetReceive();
+
+    /**
+     * Setup the transmit ring.
+     *
+     * @return Result code
+     */
+    FileSystem::Result resetTransmit();
+
+    /**
+     * Receive frames from the receive ring.
+     *
+     * @param budget Maximum number of frames to receive
+     * @param count Number of frames received on output
+     */
+    void receive(const Size budget, Size & count);
+
+    /**
+     * Check if the controller has received a frame.
+     *
+     * @return True if a frame is ready
+     */
+    bool receivePending() const;
+
+    /**
+     * Prepare checksum insertion for a packet.
+     *
+     * Loads a new context descriptor if the offsets differ from the previous packet.
+     *
+     * @param pkt Packet flagged with ChecksumOffload
+     *
+     * @return True if the checksums are inserted by the controller
+     */
+    bool prepareChecksum(NetworkQueue::Packet *pkt);
+
+    /**
+     * Release packets which the controller has transmitted.
+     */
+    void reclaimTransmit();
+
+  private:
+
+    /** Configuration space I/O ports */
+    Arch::IO m_pci;
+
+    /** Memory mapped registers */
+    Arch::IO m_io;
+
+    /** Legacy interrupt line of the controller */
+    Size m_irq;
+
+    /** Memory range for receive descriptors */
+    Memory::Range m_receiveDescRange;
+
+    /** Receive descriptor ring */
+    volatile ReceiveDescriptor *m_receiveDesc;
+
+    /** Packets of each receive descriptor */
+    Index<NetworkQueue::Packet, RingSize> m_receivePackets;
+
+    /** Next receive descriptor to check */
+    Size m_receiveIndex;
+
+    /** Memory range for transmit descriptors */
+    Memory::Range m_transmitDescRange;
+
+    /** Transmit descriptor ring */
+    volatile DataDescriptor *m_transmitDesc;
+
+    /** Packets of each transmit data descriptor */
+    Index<NetworkQueue::Packet, RingSize> m_transmitPackets;
+
+    /** List of pointers to packets pending transmission */
+    Queue<NetworkQueue::Packet *, RingSize> m_transmitPending;
+
+    /** Next transmit descriptor to fill */
+    Size m_transmitIndex;
+
+    /** Oldest transmit descriptor in use by the controller */
+    Size m_transmitClean;
+
+    /** Number of transmit descriptors in use by the controller */
+    Size m_transmitCount;
+
+    /** Checksum offsets of the last loaded context descriptor, or zero if none */
+    u32 m_transmitContext;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_NETWORK_E1000_E1000_H */
@@ -32,6 +32,10 @@
 
 /**
  * Loopback network device implementation.
+ *
+ * Transmitted packets are processed as received packets right away.
+ * The device does not need ARP to resolve addresses, and skips the
+ * generation and verification of checksums.
  */
 class Loopback : public NetworkDevice
 {
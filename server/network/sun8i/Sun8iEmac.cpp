@@ -25,10 +25,12 @@
 
 Sun8iEmac::Sun8iEmac(const u32 inode,
                      NetworkServer &server)
-    : NetworkDevice(inode, server)
+    : NetworkDevice(inode, server, RingSize + NetworkQueue::SharedPackets, RingSize, MaximumMTU)
     , m_receiveIndex(0)
 {
     DEBUG("");
+
+    m_capabilities = TransmitChecksum | ReceiveChecksum;
 }
 
 Sun8iEmac::~Sun8iEmac()
@@ -67,7 +69,7 @@ FileSystem::Result Sun8iEmac::initialize()
     }
 
     // Allocate receive descriptors
-    assert(sizeof(Sun8iEmac::FrameDescriptor) * NetworkQueue::MaxPackets < PAGESIZE);
+    assert(sizeof(Sun8iEmac::FrameDescriptor) * RingSize <= PAGESIZE);
     m_receiveDescRange.phys = 0;
     m_receiveDescRange.virt = 0;
     m_receiveDescRange.access = Memory::User | Memory::Readable | Memory::Writable | Memory::Device;
@@ -178,9 +180,15 @@ FileSystem::Result Sun8iEmac::interrupt(const Size vector)
     const u32 status = m_io.read(IntStatus);
     m_io.write(IntStatus, status);
 
+    // Received frames are polled with the receive interrupt masked until the ring is empty
+    if (status & IntStatusReceive)
+    {
+        m_polling = true;
+    }
+
     // Re-enable interrupts
     m_io.write(IntEnable, 0);
-    m_io.write(IntEnable, IntEnableTransmit | IntEnableReceive);
+    m_io.write(IntEnable, IntEnableTransmit | (m_polling ? 0 : IntEnableReceive));
 
     DEBUG("vector = " << vector << " status = " << (void *) status);
     DEBUG("receivectl1 = " << (void *) m_io.read(ReceiveCtl1) <<
@@ -199,15 +207,38 @@ FileSystem::Result Sun8iEmac::interrupt(const Size vector)
         }
     }
 
-    // Check if packets are received
-    const FileSystem::Result result = receive();
+    // Re-enable the interrupt line on the interrupt controller
+    ProcessCtl(SELF, EnableIRQ, InterruptNumber);
+    return FileSystem::Success;
+}
+
+FileSystem::Result Sun8iEmac::poll()
+{
+    Size count = 0;
+
+    // Receive the next batch of frames
+    const FileSystem::Result result = receive(ReceiveBudget, count);
     if (result != FileSystem::Success)
     {
-        ERROR("failed to receive packets");
+        ERROR("failed to receive packets: result = " << (int) result);
+    }
+    else if (count == ReceiveBudget)
+    {
+        return FileSystem::RetryAgain;
     }
 
-    // Re-enable the interrupt line on the interrupt controller
-    ProcessCtl(SELF, EnableIRQ, InterruptNumber);
+    // The ring is empty: re-arm the receive interrupt
+    m_io.write(IntStatus, IntStatusReceive);
+    m_io.write(IntEnable, IntEnableTransmit | IntEnableReceive);
+
+    // Frames completed before the interrupt flag was cleared did not raise an interrupt
+    if (receivePending())
+    {
+        m_io.write(IntEnable, IntEnableTransmit);
+        return FileSystem::RetryAgain;
+    }
+
+    m_polling = false;
     return FileSystem::Success;
 }
 
@@ -215,7 +246,7 @@ FileSystem::Result Sun8iEmac::transmit(NetworkQueue::Packet *pkt)
 {
     DEBUG("size = " << pkt->size);
 
-    if (m_transmitPending.count() == NetworkQueue::MaxPackets)
+    if (m_transmitPending.count() == RingSize)
     {
         ERROR("transmit queue full");
         return FileSystem::IOError;
@@ -253,6 +284,7 @@ FileSystem::Result Sun8iEmac::startDMA()
         }
 
         // Clean cache for packet payload memory
+        range.size = pkt->size;
         const API::Result ccResult = VMCtl(SELF, CacheClean, &range);
         if (ccResult != API::Success)
         {
@@ -263,9 +295,22 @@ FileSystem::Result Sun8iEmac::startDMA()
 
         m_transmitPackets.push(pkt);
 
+        // Only the last frame of the batch raises the transmit interrupt,
+        // which releases the packets of the whole batch.
         FrameDescriptor *desc = m_transmitDesc[m_transmitIndex];
-        desc->bufsize = pkt->size | (TransmitDescFirst | TransmitDescLast |
-                                     TransmitDescRaiseInt | TransmitDescChained);
+        desc->bufsize = pkt->size | (TransmitDescFirst | TransmitDescLast | TransmitDescChained);
+
+        if (m_transmitPending.count() == 0)
+        {
+            desc->bufsize |= TransmitDescRaiseInt;
+        }
+
+        // Insert the IP header and payload checksums, including the pseudo header
+        if (pkt->flags & NetworkQueue::ChecksumOffload)
+        {
+            desc->bufsize |= TransmitDescChecksum;
+        }
+
         desc->bufaddr = range.phys;
         desc->status = FrameDescriptorCtl;
         dsb();
@@ -273,7 +318,7 @@ FileSystem::Result Sun8iEmac::startDMA()
         DEBUG("tx:index = " << m_transmitIndex << " tx:desc.status = " << (void *) desc->status <<
               " tx:size = " << pkt->size << " tx:payload = " << *pkt);
 
-        m_transmitIndex = (m_transmitIndex + 1) % NetworkQueue::MaxPackets;
+        m_transmitIndex = (m_transmitIndex + 1) % RingSize;
     }
 
     // Start transmitter DMA engine
@@ -287,64 +332,78 @@ FileSystem::Result Sun8iEmac::startDMA()
     return FileSystem::Success;
 }
 
-FileSystem::Result Sun8iEmac::receive()
+FileSystem::Result Sun8iEmac::receive(const Size budget, Size & count)
 {
-    DEBUG("");
+    DEBUG("budget = " << budget);
 
     printRx();
 
-    while (true)
+    for (count = 0; count < budget && receivePending(); count++)
     {
         FrameDescriptor *desc = m_receiveDesc[m_receiveIndex];
-        assert(desc);
-
-        if (desc->status & FrameDescriptorCtl)
-        {
-            break;
-        }
-
         NetworkQueue::Packet *pkt = m_receivePackets[m_receiveIndex];
         assert(pkt != ZERO);
 
         if (!(desc->status & ReceiveDescLast))
         {
             ERROR("last flag not set: skipping packet");
-            continue;
         }
-
-        const Size bytes = (desc->status >> ReceiveDescFrmShift) & ReceiveDescFrmMask;
-        DEBUG("packet: index = " << m_receiveIndex << " bytes = " << bytes);
-
-        // invalidate cache lines here for the payload
-        Memory::Range range;
-        range.virt = (Address) pkt->data;
-        range.size = PAGESIZE;
-        assert(pkt->size <= PAGESIZE);
-
-        const API::Result result = VMCtl(SELF, CacheInvalidate, &range);
-        if (result != API::Success)
+        else
         {
-            ERROR("failed to invalidate cache lines for packet: result = " << (int) result);
-            return FileSystem::IOError;
+            const Size bytes = (desc->status >> ReceiveDescFrmShift) & ReceiveDescFrmMask;
+            DEBUG("packet: index = " << m_receiveIndex << " bytes = " << bytes);
+
+            // invalidate cache lines here for the payload
+            Memory::Range range;
+            range.virt = (Address) pkt->data;
+            range.size = bytes;
+            assert(pkt->size <= PAGESIZE);
+
+            const API::Result result = VMCtl(SELF, CacheInvalidate, &range);
+            if (result != API::Success)
+            {
+                ERROR("failed to invalidate cache lines for packet: result = " << (int) result);
+                return FileSystem::IOError;
+            }
+
+            // Process the packet with networking protocols.
+            // Note that we need to remove the Ethernet Frame Check Sequence (FCS)
+            // which is a 4-bytes field padded at the end of each packet.
+            pkt->size = bytes - sizeof(u32);
+
+            // The device checked the IP header and payload checksums
+            pkt->flags = (desc->status & (ReceiveDescHeaderErr | ReceiveDescDataErr)) ?
+                          0 : NetworkQueue::ChecksumVerified;
+            process(pkt);
+
+            // Receive the next frame in a fresh buffer if the packet was queued to a socket
+            NetworkQueue::Packet *next = m_receive.recycle(pkt);
+            if (next != pkt)
+            {
+                m_receivePackets.insertAt(m_receiveIndex, next);
+                desc->bufaddr = m_receive.getPhysicalAddress(next);
+            }
         }
 
-        // Process the packet with networking protocols.
-        // Note that we need to remove the Ethernet Frame Check Sequence (FCS)
-        // which is a 4-bytes field padded at the end of each packet.
-        pkt->size = bytes - sizeof(u32);
-        process(pkt);
-
         // Return descriptor back to the device
         desc->status = FrameDescriptorCtl;
         dsb();
 
         // Move to the next descriptor
-        m_receiveIndex = (m_receiveIndex + 1) % NetworkQueue::MaxPackets;
+        m_receiveIndex = (m_receiveIndex + 1) % RingSize;
     }
 
     return FileSystem::Success;
 }
 
+bool Sun8iEmac::receivePending() const
+{
+    const FrameDescriptor *desc = m_receiveDesc.get(m_receiveIndex);
+    assert(desc);
+
+    return (desc->status & FrameDescriptorCtl) == 0;
+}
+
 bool Sun8iEmac::miiBusyWait() const
 {
     DEBUG("");
@@ -520,9 +579,9 @@ FileSystem::Result Sun8iEmac::resetReceive()
     Address descPhys = m_receiveDescRange.phys;
 
     // Reconstruct receive descriptor list
-    for (Size i = 0; i < NetworkQueue::MaxPackets; i++)
+    for (Size i = 0; i < RingSize; i++)
     {
-        const bool last = (i == NetworkQueue::MaxPackets - 1);
+        const bool last = (i == RingSize - 1);
 
         NetworkQueue::Packet *pkt = m_receive.get();
         assert(pkt != ZERO);
@@ -540,7 +599,8 @@ FileSystem::Result Sun8iEmac::resetReceive()
 
         // Prepare receive descriptor
         desc->status  = FrameDescriptorCtl;
-        desc->bufsize = m_maximumPacketSize;
+        desc->bufsize = m_receive.getBufferSize() < MaximumBufferSize ?
+                        m_receive.getBufferSize() : MaximumBufferSize;
         desc->bufaddr = range.phys;
         desc->next    = last ? m_receiveDescRange.phys : descPhys + sizeof(FrameDescriptor);
 
@@ -556,7 +616,7 @@ FileSystem::Result Sun8iEmac::resetReceive()
     // Finalize receive administration
     m_receiveIndex = 0;
     m_io.write(ReceiveDescList, m_receiveDescRange.phys);
-    m_io.write(ReceiveCtl0, ReceiveCtl0Enable);
+    m_io.write(ReceiveCtl0, ReceiveCtl0Enable | ReceiveCtl0Jumbo | ReceiveCtl0Checksum);
     m_io.write(ReceiveCtl1, ReceiveCtl1DmaEnable | ReceiveCtl1DmaStart |
                             ReceiveCtl1ErrorFrame | ReceiveCtl1UnderFrame | ReceiveCtl1FullFrame);
 
@@ -571,9 +631,9 @@ FileSystem::Result Sun8iEmac::resetTransmit()
     Address descPhys = m_transmitDescRange.phys;
 
     // Reconstruct transmit descriptor list
-    for (Size i = 0; i < NetworkQueue::MaxPackets; i++)
+    for (Size i = 0; i < RingSize; i++)
     {
-        const bool last = (i == NetworkQueue::MaxPackets - 1);
+        const bool last = (i == RingSize - 1);
 
         // Prepare transmit descriptor
         desc->status  = 0;
@@ -59,6 +59,18 @@ class Sun8iEmac : public NetworkDevice
     /** Maximum number of polling reset iterations */
     static const Size MaximumResetPoll = 100000;
 
+    /** Number of receive and transmit descriptors, which fill one page each */
+    static const Size RingSize = 256;
+
+    /** Maximum number of frames received per poll */
+    static const Size ReceiveBudget = 32;
+
+    /** Largest supported MTU: a frame must fit in the 11-bit buffer size of one descriptor */
+    static const Size MaximumMTU = 2000;
+
+    /** Largest buffer size of a descriptor */
+    static const Size MaximumBufferSize = 0x7ff;
+
     /**
      * Hardware registers
      */
@@ -212,7 +224,9 @@ class Sun8iEmac : public NetworkDevice
      */
     enum ReceiveCtl0Flags
     {
-        ReceiveCtl0Enable = (1 << 31)
+        ReceiveCtl0Enable   = (1 << 31),
+        ReceiveCtl0Jumbo    = (1 << 29),
+        ReceiveCtl0Checksum = (1 << 27)
     };
 
     /**
@@ -248,7 +262,10 @@ class Sun8iEmac : public NetworkDevice
         TransmitDescFirst    = (1 << 29),
         TransmitDescLast     = (1 << 30),
         TransmitDescChained  = (1 << 24),
+        TransmitDescChecksum = (3 << 27),
         ReceiveDescLast      = (1 << 8),
+        ReceiveDescHeaderErr = (1 << 7),
+        ReceiveDescDataErr   = (1 << 0),
         ReceiveDescFrmShift  = 16,
         ReceiveDescFrmMask   = (0x3fff)
     };
@@ -303,6 +320,15 @@ class Sun8iEmac : public NetworkDevice
      */
     virtual FileSystem::Result interrupt(const Size vector);
 
+    /**
+     * Receive a batch of frames while in polling mode.
+     *
+     * Re-enables the receive interrupt once the receive ring is empty.
+     *
+     * @return Success if the ring is empty or RetryAgain if more frames are pending
+     */
+    virtual FileSystem::Result poll();
+
     /**
      * Add a network packet to the transmit queue
      *
@@ -324,9 +350,19 @@ class Sun8iEmac : public NetworkDevice
     /**
      * Receive packets.
      *
+     * @param budget Maximum number of frames to receive
+     * @param count On output, the number of frames received
+     *
      * @return Result code
      */
-    FileSystem::Result receive();
+    FileSystem::Result receive(const Size budget, Size & count);
+
+    /**
+     * Check if the device has completed a frame in the receive ring.
+     *
+     * @return True if a frame is ready to be received
+     */
+    bool receivePending() const;
 
     /**
      * Wait until the PHY comes out of busy state.
@@ -417,10 +453,10 @@ class Sun8iEmac : public NetworkDevice
     Memory::Range m_receiveDescRange;
 
     /** List of pointers to receive descriptors */
-    Index<FrameDescriptor, NetworkQueue::MaxPackets> m_receiveDesc;
+    Index<FrameDescriptor, RingSize> m_receiveDesc;
 
     /** List of pointers to receive packets */
-    Index<NetworkQueue::Packet, NetworkQueue::MaxPackets> m_receivePackets;
+    Index<NetworkQueue::Packet, RingSize> m_receivePackets;
 
     /** Current receive packet index */
     Size m_receiveIndex;
@@ -429,13 +465,13 @@ class Sun8iEmac : public NetworkDevice
     Memory::Range m_transmitDescRange;
 
     /** List of pointers to transmit descriptors */
-    Index<FrameDescriptor, NetworkQueue::MaxPackets> m_transmitDesc;
+    Index<FrameDescriptor, RingSize> m_transmitDesc;
 
     /** List of pointers to packets pending transmission */
-    Queue<NetworkQueue::Packet *, NetworkQueue::MaxPackets> m_transmitPending;
+    Queue<NetworkQueue::Packet *, RingSize> m_transmitPending;
 
     /** List of pointers to packets that the driver has submitted for transmission */
-    Queue<NetworkQueue::Packet *, NetworkQueue::MaxPackets> m_transmitPackets;
+    Queue<NetworkQueue::Packet *, RingSize> m_transmitPackets;
 
     /** Current transmit packet index */
     Size m_transmitIndex;
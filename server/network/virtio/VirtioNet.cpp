@@ -0,0 +1,427 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/System.h>
+#include <Log.h>
+#include <MemoryBlock.h>
+#include "VirtioNet.h"
+
+VirtioNet::VirtioNet(const u32 inode,
+                     NetworkServer &server)
+    : NetworkDevice(inode, server, RingSlots + NetworkQueue::SharedPackets, RingSlots, MaximumMTU)
+    , m_irq(0)
+    , m_eventIndex(false)
+    , m_receiveSlots(0)
+    , m_transmitSlots(0)
+{
+    MemoryBlock::set(&m_headerRange, 0, sizeof(m_headerRange));
+}
+
+VirtioNet::~VirtioNet()
+{
+}
+
+FileSystem::Result VirtioNet::initialize()
+{
+    DEBUG("");
+
+    const FileSystem::Result detectResult = detect();
+    if (detectResult != FileSystem::Success)
+    {
+        return detectResult;
+    }
+
+    // Reset the device and tell it that we can drive it
+    m_io.outb(DeviceStatus, 0);
+    m_io.outb(DeviceStatus, StatusAcknowledge);
+    m_io.outb(DeviceStatus, StatusAcknowledge | StatusDriver);
+
+    // Checksum offload is not negotiated: the IP header checksum is computed by the stack
+    const u32 features = m_io.inl(DeviceFeatures) & (FeatureMac | FeatureEventIndex);
+    m_io.outl(GuestFeatures, features);
+    m_eventIndex = (features & FeatureEventIndex) != 0;
+
+    DEBUG("features = " << (void *) features);
+
+    // Setup virtqueues
+    FileSystem::Result result = setupQueue(ReceiveQueue, m_receiveQueue, m_receiveSlots);
+    if (result == FileSystem::Success)
+    {
+        result = setupQueue(TransmitQueue, m_transmitQueue, m_transmitSlots);
+    }
+    if (result == FileSystem::Success)
+    {
+        result = setupSlots();
+    }
+    if (result != FileSystem::Success)
+    {
+        m_io.outb(DeviceStatus, StatusFailed);
+        return result;
+    }
+
+    // Use a locally administered address if the device has none
+    if (!(features & FeatureMac))
+    {
+        Ethernet::Address mac;
+        mac.addr[0] = 0x52;
+        mac.addr[1] = 0x54;
+        mac.addr[2] = 0x00;
+        mac.addr[3] = 0x12;
+        mac.addr[4] = 0x34;
+        mac.addr[5] = 0x56;
+        setAddress(&mac);
+    }
+
+    // Start the device
+    m_io.outb(DeviceStatus, StatusAcknowledge | StatusDriver | StatusDriverOk);
+
+    // Give the receive buffers to the device
+    if (m_receiveQueue.publish())
+    {
+        m_io.outw(QueueNotify, ReceiveQueue);
+    }
+
+    result = NetworkDevice::initialize();
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to initialize NetworkDevice: result = " << (int) result);
+        return FileSystem::IOError;
+    }
+
+    m_server.registerInterrupt(this, m_irq);
+    return FileSystem::Success;
+}
+
+FileSystem::Result VirtioNet::getAddress(Ethernet::Address *address)
+{
+    for (Size i = 0; i < sizeof(address->addr); i++)
+    {
+        address->addr[i] = m_io.inb(MacAddress + i);
+    }
+
+    DEBUG("address = " << *address);
+    return FileSystem::Success;
+}
+
+FileSystem::Result VirtioNet::setAddress(const Ethernet::Address *address)
+{
+    DEBUG("address = " << *address);
+
+    for (Size i = 0; i < sizeof(address->addr); i++)
+    {
+        m_io.outb(MacAddress + i, address->addr[i]);
+    }
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result VirtioNet::interrupt(const Size vector)
+{
+    // Reading the status clears the interrupt
+    const u8 status = m_io.inb(IsrStatus);
+
+    DEBUG("vector = " << vector << " status = " << (void *) (Address) status);
+
+    // Received frames are polled with the receive interrupt suppressed until the queue is empty
+    if (m_receiveQueue.hasUsed())
+    {
+        m_receiveQueue.disableInterrupt();
+        m_polling = true;
+    }
+
+    reclaimTransmit();
+
+    // Re-enable the interrupt line on the interrupt controller
+    ProcessCtl(SELF, EnableIRQ, m_irq);
+    return FileSystem::Success;
+}
+
+FileSystem::Result VirtioNet::poll()
+{
+    Size count = 0;
+
+    // Receive the next batch of frames and return their buffers back to the device
+    for (; count < ReceiveBudget && m_receiveQueue.hasUsed(); count++)
+    {
+        const VirtioQueue::UsedElement used = m_receiveQueue.getUsed();
+        const Size slot = used.id / 2;
+        NetworkQueue::Packet *pkt = m_receivePackets.get(slot);
+
+        if (pkt == ZERO || used.length < HeaderSize)
+        {
+            ERROR("invalid used buffer: id = " << used.id << " length = " << used.length);
+            continue;
+        }
+
+        pkt->size = used.length - HeaderSize;
+        pkt->flags = 0;
+        process(pkt);
+
+        // Receive the next frame in a fresh buffer if the packet was queued to a socket
+        NetworkQueue::Packet *next = m_receive.recycle(pkt);
+        if (next != pkt)
+        {
+            m_receivePackets.insertAt(slot, next);
+            m_receiveQueue.getDescriptor((slot * 2) + 1)->address = m_receive.getPhysicalAddress(next);
+        }
+
+        m_receiveQueue.add(slot * 2);
+    }
+
+    if (m_receiveQueue.publish())
+    {
+        m_io.outw(QueueNotify, ReceiveQueue);
+    }
+
+    if (count == ReceiveBudget)
+    {
+        return FileSystem::RetryAgain;
+    }
+
+    // The queue is empty: re-arm the receive interrupt
+    m_receiveQueue.enableInterrupt();
+
+    // Frames received before the interrupt was enabled did not raise an interrupt
+    if (m_receiveQueue.hasUsed())
+    {
+        m_receiveQueue.disableInterrupt();
+        return FileSystem::RetryAgain;
+    }
+
+    m_polling = false;
+    return FileSystem::Success;
+}
+
+FileSystem::Result VirtioNet::transmit(NetworkQueue::Packet *pkt)
+{
+    DEBUG("size = " << pkt->size);
+
+    if (!m_transmitPending.push(pkt))
+    {
+        ERROR("transmit queue full");
+        return FileSystem::IOError;
+    }
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result VirtioNet::startDMA()
+{
+    DEBUG("");
+
+    reclaimTransmit();
+
+    // Fill the free transmit slots with pending packets
+    while (m_transmitPending.count() > 0 && m_transmitFree.count() > 0)
+    {
+        NetworkQueue::Packet *pkt = m_transmitPending.pop();
+        const Size slot = m_transmitFree.pop();
+        volatile VirtioQueue::Descriptor *desc = m_transmitQueue.getDescriptor((slot * 2) + 1);
+
+        desc->address = m_transmit.getPhysicalAddress(pkt);
+        desc->length = pkt->size;
+
+        m_transmitPackets.insertAt(slot, pkt);
+        m_transmitQueue.add(slot * 2);
+    }
+
+    // Only the last packet of the batch interrupts, which reclaims the whole batch
+    m_transmitQueue.enableInterrupt(true);
+
+    if (m_transmitQueue.publish())
+    {
+        m_io.outw(QueueNotify, TransmitQueue);
+    }
+
+    return FileSystem::Success;
+}
+
+u32 VirtioNet::readPCI(const uint bus, const uint slot, const uint func, const uint reg)
+{
+    m_pci.outl(PciConfigAddress, (1U << 31) | (bus << 16) | (slot << 11) | (func << 8) | (reg & 0xfc));
+    return m_pci.inl(PciConfigData);
+}
+
+void VirtioNet::writePCI(const uint bus, const uint slot, const uint func,
+                         const uint reg, const u32 value)
+{
+    m_pci.outl(PciConfigAddress, (1U << 31) | (bus << 16) | (slot << 11) | (func << 8) | (reg & 0xfc));
+    m_pci.outl(PciConfigData, value);
+}
+
+FileSystem::Result VirtioNet::detect()
+{
+    // Search the PCI bus for a virtio network device
+    for (uint bus = 0; bus < 256; bus++)
+    {
+        for (uint slot = 0; slot < 32; slot++)
+        {
+            for (uint func = 0; func < 8; func++)
+            {
+                const u32 id = readPCI(bus, slot, func, PciIdentifier);
+
+                if ((id & 0xffff) != VendorId || (id >> 16) != DeviceId)
+                {
+                    continue;
+                }
+
+                // The legacy interface is in the I/O space of BAR0
+                const u32 bar = readPCI(bus, slot, func, PciBar0);
+                if (!(bar & 1))
+                {
+                    ERROR("BAR0 is not an I/O port range: bar = " << (void *) bar);
+                    return FileSystem::NotFound;
+                }
+
+                const u32 cmd = readPCI(bus, slot, func, PciCommand);
+                writePCI(bus, slot, func, PciCommand, cmd | PciCommandIO | PciCommandMaster);
+
+                m_io.setPortBase(bar & 0xfffc);
+                m_irq = readPCI(bus, slot, func, PciInterrupt) & 0xff;
+
+                NOTICE("found device at " << bus << ":" << slot << "." << func <<
+                       " io = " << (void *) (bar & 0xfffc) << " irq = " << m_irq);
+                return FileSystem::Success;
+            }
+        }
+    }
+
+    ERROR("no virtio network device found");
+    return FileSystem::NotFound;
+}
+
+FileSystem::Result VirtioNet::setupQueue(const u16 index,
+                                         VirtioQueue & queue,
+                                         Size & slots)
+{
+    m_io.outw(QueueSelect, index);
+
+    const Size size = m_io.inw(QueueSize);
+    if (size < 2)
+    {
+        ERROR("queue " << index << " not available: size = " << size);
+        return FileSystem::IOError;
+    }
+
+    const FileSystem::Result result = queue.initialize(size, m_eventIndex);
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+
+    // Each slot uses a chain of two descriptors
+    slots = size / 2;
+    if (slots > RingSlots)
+    {
+        slots = RingSlots;
+    }
+
+    m_io.outl(QueueAddress, queue.getPhysicalAddress() / PAGESIZE);
+
+    DEBUG("queue = " << index << " size = " << size << " slots = " << slots);
+    return FileSystem::Success;
+}
+
+FileSystem::Result VirtioNet::setupSlots()
+{
+    // One page holds the headers of all receive slots and the shared transmit header
+    m_headerRange.phys = 0;
+    m_headerRange.virt = 0;
+    m_headerRange.size = PAGESIZE;
+    m_headerRange.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    const API::Result vmResult = VMCtl(SELF, MapContiguous, &m_headerRange);
+    if (vmResult != API::Success)
+    {
+        ERROR("failed to allocate virtio-net headers: result = " << (int) vmResult);
+        return FileSystem::IOError;
+    }
+
+    MemoryBlock::set((void *) m_headerRange.virt, 0, m_headerRange.size);
+
+    const Address transmitHeader = m_headerRange.phys + (RingSlots * HeaderSlotSize);
+
+    // Receive slots: a device-written header followed by a packet buffer
+    for (Size i = 0; i < m_receiveSlots; i++)
+    {
+        NetworkQueue::Packet *pkt = m_receive.get();
+        if (pkt == ZERO)
+        {
+            ERROR("failed to get receive packet buffer");
+            return FileSystem::IOError;
+        }
+
+        volatile VirtioQueue::Descriptor *header = m_receiveQueue.getDescriptor(i * 2);
+        volatile VirtioQueue::Descriptor *data = m_receiveQueue.getDescriptor((i * 2) + 1);
+
+        header->address = m_headerRange.phys + (i * HeaderSlotSize);
+        header->length = HeaderSize;
+        header->flags = VirtioQueue::DescriptorNext | VirtioQueue::DescriptorWrite;
+        header->next = (i * 2) + 1;
+
+        data->address = m_receive.getPhysicalAddress(pkt);
+        data->length = m_receive.getBufferSize();
+        data->flags = VirtioQueue::DescriptorWrite;
+        data->next = 0;
+
+        m_receivePackets.insertAt(i, pkt);
+        m_receiveQueue.add(i * 2);
+    }
+
+    // Transmit slots: the shared zero header followed by the packet payload
+    for (Size i = 0; i < m_transmitSlots; i++)
+    {
+        volatile VirtioQueue::Descriptor *header = m_transmitQueue.getDescriptor(i * 2);
+        volatile VirtioQueue::Descriptor *data = m_transmitQueue.getDescriptor((i * 2) + 1);
+
+        header->address = transmitHeader;
+        header->length = HeaderSize;
+        header->flags = VirtioQueue::DescriptorNext;
+        header->next = (i * 2) + 1;
+
+        data->address = 0;
+        data->length = 0;
+        data->flags = 0;
+        data->next = 0;
+
+        m_transmitFree.push(i);
+    }
+
+    return FileSystem::Success;
+}
+
+void VirtioNet::reclaimTransmit()
+{
+    while (m_transmitQueue.hasUsed())
+    {
+        const VirtioQueue::UsedElement used = m_transmitQueue.getUsed();
+        const Size slot = used.id / 2;
+        NetworkQueue::Packet *pkt = m_transmitPackets.get(slot);
+
+        if (pkt == ZERO)
+        {
+            ERROR("invalid used buffer: id = " << used.id);
+            continue;
+        }
+
+        DEBUG("releasing tx:pkt = " << (void *) pkt);
+
+        m_transmitPackets.remove(slot);
+        m_transmitFree.push(slot);
+        m_transmit.release(pkt);
+    }
+}
@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVER_NETWORK_VIRTIO_VIRTIONET_H
+#define __SERVER_NETWORK_VIRTIO_VIRTIONET_H
+
+#include <FreeNOS/User.h>
+#include <Types.h>
+#include <Index.h>
+#include <Queue.h>
+#include <NetworkServer.h>
+#include <NetworkDevice.h>
+#include "VirtioQueue.h"
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup virtionet
+ * @{
+ */
+
+/**
+ * Virtio network device on the PCI bus.
+ *
+ * Uses the legacy I/O port interface, which is offered by transitional
+ * virtio-net devices, such as the default virtio-net-pci device of QEMU.
+ *
+ * Each receive and transmit slot is a fixed chain of two descriptors: the
+ * virtio-net header followed by the packet payload, which the device reads
+ * and writes directly in the physically contiguous NetworkQueue memory.
+ * Received frames are polled with the receive interrupt suppressed, and a
+ * batch of transmitted frames only interrupts once the last one is sent.
+ */
+class VirtioNet : public NetworkDevice
+{
+  private:
+
+    /** PCI vendor identifier of virtio devices */
+    static const u16 VendorId = 0x1af4;
+
+    /** PCI device identifier of a transitional virtio network device */
+    static const u16 DeviceId = 0x1000;
+
+    /** Index of the receive virtqueue */
+    static const u16 ReceiveQueue = 0;
+
+    /** Index of the transmit virtqueue */
+    static const u16 TransmitQueue = 1;
+
+    /** Maximum number of receive and transmit slots */
+    static const Size RingSlots = 128;
+
+    /** Maximum number of frames received per poll */
+    static const Size ReceiveBudget = 32;
+
+    /** Largest supported MTU, which enables jumbo frames */
+    static const Size MaximumMTU = 9000;
+
+    /** Size of the virtio-net header before each frame */
+    static const Size HeaderSize = 10;
+
+    /** Space reserved for each virtio-net header in the header page */
+    static const Size HeaderSlotSize = 16;
+
+    /**
+     * PCI configuration space
+     */
+    enum PciRegisters
+    {
+        PciConfigAddress = 0xcf8, /**@< Configuration address I/O port */
+        PciConfigData    = 0xcfc, /**@< Configuration data I/O port */
+        PciIdentifier    = 0x00,  /**@< Vendor and device identifier */
+        PciCommand       = 0x04,  /**@< Command register */
+        PciBar0          = 0x10,  /**@< Base address register 0 */
+        PciInterrupt     = 0x3c   /**@< Interrupt line */
+    };
+
+    /**
+     * PCI command register flags
+     */
+    enum PciCommandFlags
+    {
+        PciCommandIO     = (1 << 0),
+        PciCommandMaster = (1 << 2)
+    };
+
+    /**
+     * Legacy virtio registers, relative to the I/O base address
+     */
+    enum Registers
+    {
+        DeviceFeatures = 0x00, /**@< Features offered by the device */
+        GuestFeatures  = 0x04, /**@< Features accepted by the driver */
+        QueueAddress   = 0x08, /**@< Page frame number of the selected queue */
+        QueueSize      = 0x0c, /**@< Number of descriptors of the selected queue */
+        QueueSelect    = 0x0e, /**@< Selected queue */
+        QueueNotify    = 0x10, /**@< Notifies the device of new buffers in a queue */
+        DeviceStatus   = 0x12, /**@< Device status */
+        IsrStatus      = 0x13, /**@< Interrupt status, cleared on read */
+        MacAddress     = 0x14  /**@< Ethernet address in the device configuration */
+    };
+
+    /**
+     * Device status flags
+     */
+    enum DeviceStatusFlags
+    {
+        StatusAcknowledge = (1 << 0),
+        StatusDriver      = (1 << 1),
+        StatusDriverOk    = (1 << 2),
+        StatusFailed      = (1 << 7)
+    };
+
+    /**
+     * Device features
+     */
+    enum Features
+    {
+        FeatureMac        = (1 << 5),  /**@< Device has an ethernet address */
+        FeatureEventIndex = (1 << 29)  /**@< Device and driver suppress notifications with event indices */
+    };
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param inode Inode number
+     * @param server NetworkServer reference
+     */
+    VirtioNet(const u32 inode,
+              NetworkServer &server);
+
+    /**
+     * Destructor
+     */
+    virtual ~VirtioNet();
+
+    /**
+     * Initialize the device
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result initialize();
+
+    /**
+     * Read ethernet address.
+     *
+     * @param address Ethernet address reference for output
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result getAddress(Ethernet::Address *address);
+
+    /**
+     * Set ethernet address
+     *
+     * @param address New ethernet address to set
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result setAddress(const Ethernet::Address *address);
+
+    /**
+     * Called when an interrupt has been triggered for this device.
+     *
+     * @param vector Vector number of the interrupt.
+     *
+     * @return Result code.
+     */
+    virtual FileSystem::Result interrupt(const Size vector);
+
+    /**
+     * Receive a batch of frames while in polling mode.
+     *
+     * Re-enables the receive interrupt once the receive queue is empty.
+     *
+     * @return Success if no more frames are pending or RetryAgain otherwise
+     */
+    virtual FileSystem::Result poll();
+
+    /**
+     * Add a network packet to the transmit queue.
+     *
+     * @param pkt Network packet to transmit
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result transmit(NetworkQueue::Packet *pkt);
+
+    /**
+     * Pass pending packets to the device.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result startDMA();
+
+  private:
+
+    /**
+     * Read a 32-bit register from PCI configuration space.
+     *
+     * @param bus PCI bus number
+     * @param slot PCI slot number
+     * @param func PCI function number
+     * @param reg Register offset
+     *
+     * @return Register value
+     */
+    u32 readPCI(const uint bus, const uint slot, const uint func, const uint reg);
+
+    /**
+     * Write a 32-bit register in PCI configuration space.
+     *
+     * @param bus PCI bus number
+     * @param slot PCI slot number
+     * @param func PCI function number
+     * @param reg Register offset
+     * @param value Value to write
+     */
+    void writePCI(const uint bus, const uint slot, const uint func, const uint reg, const u32 value);
+
+    /**
+     * Find the device on the PCI bus and enable its I/O ports and DMA.
+     *
+     * @return Result code
+     */
+    FileSystem::Result detect();
+
+    /**
+     * Allocate a virtqueue and pass it to the device.
+     *
+     * @param index Index of the virtqueue
+     * @param queue Virtqueue to allocate
+     * @param slots Number of slots output
+     *
+     * @return Result code
+     */
+    FileSystem::Result setupQueue(const u16 index,
+                                  VirtioQueue & queue,
+                                  Size & slots);
+
+    /**
+     * Prepare the receive and transmit slots.
+     *
+     * @return Result code
+     */
+    FileSystem::Result setupSlots();
+
+    /**
+     * Release packets which the device has transmitted.
+     */
+    void reclaimTransmit();
+
+  private:
+
+    /** Configuration space I/O ports */
+    Arch::IO m_pci;
+
+    /** Device I/O ports */
+    Arch::IO m_io;
+
+    /** Legacy interrupt line of the device */
+    Size m_irq;
+
+    /** True if event indices are negotiated */
+    bool m_eventIndex;
+
+    /** Receive virtqueue */
+    VirtioQueue m_receiveQueue;
+
+    /** Transmit virtqueue */
+    VirtioQueue m_transmitQueue;
+
+    /** Memory range for the virtio-net headers */
+    Memory::Range m_headerRange;
+
+    /** Number of receive slots */
+    Size m_receiveSlots;
+
+    /** Number of transmit slots */
+    Size m_transmitSlots;
+
+    /** Packets given to the device for each receive slot */
+    Index<NetworkQueue::Packet, RingSlots> m_receivePackets;
+
+    /** Packets given to the device for each transmit slot */
+    Index<NetworkQueue::Packet, RingSlots> m_transmitPackets;
+
+    /** Transmit slots which are not in use by the device */
+    Queue<Size, RingSlots> m_transmitFree;
+
+    /** List of pointers to packets pending transmission */
+    Queue<NetworkQueue::Packet *, RingSlots> m_transmitPending;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_NETWORK_VIRTIO_VIRTIONET_H */
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/System.h>
+#include <Log.h>
+#include <MemoryBlock.h>
+#include "VirtioQueue.h"
+
+VirtioQueue::VirtioQueue()
+    : m_size(0)
+    , m_eventIndex(false)
+    , m_descriptors(ZERO)
+    , m_available(ZERO)
+    , m_used(ZERO)
+    , m_usedRing(ZERO)
+    , m_availableEvent(ZERO)
+    , m_availableIndex(0)
+    , m_publishedIndex(0)
+    , m_usedIndex(0)
+{
+    MemoryBlock::set(&m_range, 0, sizeof(m_range));
+}
+
+FileSystem::Result VirtioQueue::initialize(const Size size,
+                                           const bool eventIndex)
+{
+    DEBUG("size = " << size << " eventIndex = " << eventIndex);
+
+    // The legacy layout places the used ring at the next aligned address
+    const Size availableSize = sizeof(u16) * (3 + size);
+    const Size usedOffset = ((sizeof(Descriptor) * size) + availableSize + UsedAlignment - 1) &
+                            ~(UsedAlignment - 1);
+    const Size usedSize = (sizeof(u16) * 3) + (sizeof(UsedElement) * size);
+
+    m_range.phys = 0;
+    m_range.virt = 0;
+    m_range.size = (usedOffset + usedSize + PAGESIZE - 1) & PAGEMASK;
+    m_range.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    const API::Result result = VMCtl(SELF, MapContiguous, &m_range);
+    if (result != API::Success)
+    {
+        ERROR("failed to allocate virtqueue memory: result = " << (int) result);
+        return FileSystem::IOError;
+    }
+
+    MemoryBlock::set((void *) m_range.virt, 0, m_range.size);
+
+    m_size           = size;
+    m_eventIndex     = eventIndex;
+    m_descriptors    = (volatile Descriptor *) m_range.virt;
+    m_available      = (volatile u16 *) (m_range.virt + (sizeof(Descriptor) * size));
+    m_used           = (volatile u16 *) (m_range.virt + usedOffset);
+    m_usedRing       = (volatile UsedElement *) (m_used + 2);
+    m_availableEvent = (volatile u16 *) (m_usedRing + size);
+    m_availableIndex = 0;
+    m_publishedIndex = 0;
+    m_usedIndex      = 0;
+
+    return FileSystem::Success;
+}
+
+Address VirtioQueue::getPhysicalAddress() const
+{
+    return m_range.phys;
+}
+
+Size VirtioQueue::getSize() const
+{
+    return m_size;
+}
+
+volatile VirtioQueue::Descriptor * VirtioQueue::getDescriptor(const Size index)
+{
+    return &m_descriptors[index];
+}
+
+void VirtioQueue::add(const u16 head)
+{
+    m_available[2 + (m_availableIndex % m_size)] = head;
+    m_availableIndex++;
+}
+
+bool VirtioQueue::publish()
+{
+    const u16 previous = m_publishedIndex;
+
+    if (previous == m_availableIndex)
+    {
+        return false;
+    }
+
+    // The ring entries are written before the index
+    m_available[1] = m_availableIndex;
+    m_publishedIndex = m_availableIndex;
+
+    // The index must be visible before reading whether to notify
+    mfence();
+
+    if (m_eventIndex)
+    {
+        const u16 event = *m_availableEvent;
+        return (u16) (m_availableIndex - event - 1) < (u16) (m_availableIndex - previous);
+    }
+    else
+    {
+        return !(m_used[0] & UsedNoNotify);
+    }
+}
+
+bool VirtioQueue::hasUsed() const
+{
+    return m_used[1] != m_usedIndex;
+}
+
+VirtioQueue::UsedElement VirtioQueue::getUsed()
+{
+    UsedElement elem;
+    const volatile UsedElement *used = &m_usedRing[m_usedIndex % m_size];
+
+    elem.id     = used->id;
+    elem.length = used->length;
+    m_usedIndex++;
+
+    return elem;
+}
+
+void VirtioQueue::enableInterrupt(const bool lastOnly)
+{
+    if (m_eventIndex)
+    {
+        // The device interrupts once it has used the buffer at this index
+        m_available[2 + m_size] = lastOnly ? (u16) (m_availableIndex - 1) : m_usedIndex;
+    }
+    else
+    {
+        m_available[0] = 0;
+    }
+
+    // The event must be visible before the caller checks for used buffers
+    mfence();
+}
+
+void VirtioQueue::disableInterrupt()
+{
+    // With event indices, the device stops interrupting once it passes the used event
+    if (!m_eventIndex)
+    {
+        m_available[0] = AvailableNoInterrupt;
+    }
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVER_NETWORK_VIRTIO_VIRTIOQUEUE_H
+#define __SERVER_NETWORK_VIRTIO_VIRTIOQUEUE_H
+
+#include <FreeNOS/User.h>
+#include <FileSystem.h>
+#include <Types.h>
+#include <Memory.h>
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup virtionet
+ * @{
+ */
+
+/**
+ * Split virtqueue of a legacy virtio device.
+ *
+ * The descriptor table, available ring and used ring are allocated
+ * in physically contiguous memory with the legacy layout, such that
+ * the device only needs the page frame number of the queue.
+ *
+ * Buffers added by the driver become visible to the device with a single
+ * update of the available index in publish(). If the device supports
+ * event indices, the driver only notifies the device when it asks for it
+ * and the device only interrupts the driver at the requested used index.
+ */
+class VirtioQueue
+{
+  public:
+
+    /** Alignment of the used ring in the legacy layout */
+    static const Size UsedAlignment = 4096;
+
+    /**
+     * Buffer descriptor
+     */
+    struct Descriptor
+    {
+        u64 address;
+        u32 length;
+        u16 flags;
+        u16 next;
+    };
+
+    /**
+     * Flags for buffer descriptors
+     */
+    enum DescriptorFlags
+    {
+        DescriptorNext  = (1 << 0),
+        DescriptorWrite = (1 << 1)
+    };
+
+    /**
+     * Buffer returned by the device in the used ring
+     */
+    struct UsedElement
+    {
+        u32 id;
+        u32 length;
+    };
+
+  private:
+
+    /**
+     * Flags in the available and used rings
+     */
+    enum RingFlags
+    {
+        AvailableNoInterrupt = (1 << 0),
+        UsedNoNotify         = (1 << 0)
+    };
+
+  public:
+
+    /**
+     * Constructor
+     */
+    VirtioQueue();
+
+    /**
+     * Allocate the queue memory.
+     *
+     * @param size Number of descriptors, as given by the device
+     * @param eventIndex True if the device supports event indices
+     *
+     * @return Result code
+     */
+    FileSystem::Result initialize(const Size size,
+                                  const bool eventIndex);
+
+    /**
+     * Get the physical address of the queue memory.
+     *
+     * @return Physical address
+     */
+    Address getPhysicalAddress() const;
+
+    /**
+     * Get the number of descriptors.
+     *
+     * @return Number of descriptors
+     */
+    Size getSize() const;
+
+    /**
+     * Get a descriptor from the table.
+     *
+     * @param index Descriptor index
+     *
+     * @return Descriptor pointer
+     */
+    volatile Descriptor * getDescriptor(const Size index);
+
+    /**
+     * Add a descriptor chain to the available ring.
+     *
+     * The chain becomes visible to the device with publish().
+     *
+     * @param head Index of the first descriptor of the chain
+     */
+    void add(const u16 head);
+
+    /**
+     * Make all added descriptor chains visible to the device.
+     *
+     * @return True if the device must be notified
+     */
+    bool publish();
+
+    /**
+     * Check if the device returned a used buffer.
+     *
+     * @return Boolean
+     */
+    bool hasUsed() const;
+
+    /**
+     * Take the next used buffer.
+     *
+     * @return Used element; only valid if hasUsed() returned true
+     */
+    UsedElement getUsed();
+
+    /**
+     * Let the device interrupt when it returns buffers.
+     *
+     * The caller must check hasUsed() afterwards, for buffers
+     * returned before the interrupt was enabled.
+     *
+     * @param lastOnly True to only interrupt once all added
+     *                 buffers are used, if the device supports it
+     */
+    void enableInterrupt(const bool lastOnly = false);
+
+    /**
+     * Stop interrupts of the device for returned buffers.
+     */
+    void disableInterrupt();
+
+  private:
+
+    /** Memory range of the queue */
+    Memory::Range m_range;
+
+    /** Number of descriptors */
+    Size m_size;
+
+    /** True if event indices are used */
+    bool m_eventIndex;
+
+    /** Descriptor table */
+    volatile Descriptor *m_descriptors;
+
+    /** Available ring: flags, index, ring entries and used event */
+    volatile u16 *m_available;
+
+    /** Used ring: flags and index */
+    volatile u16 *m_used;
+
+    /** Used ring entries */
+    volatile UsedElement *m_usedRing;
+
+    /** Available event, written by the device */
+    volatile u16 *m_availableEvent;
+
+    /** Next available index to fill */
+    u16 m_availableIndex;
+
+    /** Available index last made visible to the device */
+    u16 m_publishedIndex;
+
+    /** Next used index to take */
+    u16 m_usedIndex;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_NETWORK_VIRTIO_VIRTIOQUEUE_H */
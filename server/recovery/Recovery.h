@@ -33,7 +33,8 @@ namespace Recovery
      */
     enum Action
     {
-        RestartProcess = 1
+        RestartProcess = 1,
+        Checkpoint
     };
 
     /**
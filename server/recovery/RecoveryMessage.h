@@ -39,6 +39,8 @@ typedef struct RecoveryMessage : public ChannelMessage
     Recovery::Action action; /**< Action to perform. */
     Recovery::Result result; /**< Result of action. */
     ProcessID pid;           /**< Process identifier of target process. */
+    Address address;         /**< Start of the region to checkpoint. */
+    Size size;               /**< Number of bytes in the region to checkpoint. */
 }
 RecoveryMessage;
 
@@ -26,6 +26,7 @@ RecoveryServer::RecoveryServer()
     : ChannelServer<RecoveryServer, RecoveryMessage>(this)
 {
     addIPCHandler(Recovery::RestartProcess, &RecoveryServer::restartProcess);
+    addIPCHandler(Recovery::Checkpoint, &RecoveryServer::checkpoint);
 }
 
 void RecoveryServer::restartProcess(RecoveryMessage *msg)
@@ -97,6 +98,14 @@ void RecoveryServer::restartProcess(RecoveryMessage *msg)
         return;
     }
 
+    // Put back the state saved by the program
+    if (!restoreCheckpoints(msg->pid))
+    {
+        ERROR("failed to restore checkpoints of PID " << msg->pid);
+        msg->result = Recovery::IOError;
+        return;
+    }
+
     // Continue program
     result = ProcessCtl(msg->pid, Resume);
     if (result != API::Success)
@@ -111,15 +120,182 @@ void RecoveryServer::restartProcess(RecoveryMessage *msg)
     msg->result = Recovery::Success;
 }
 
+void RecoveryServer::checkpoint(RecoveryMessage *msg)
+{
+    const Arch::MemoryMap map;
+    const Memory::Range data = map.range(MemoryMap::UserData);
+    Checkpoint *checkpoints = ZERO;
+    Checkpoint *cp = ZERO;
+
+    DEBUG("pid = " << msg->from << " address = " << (void *) msg->address << " size = " << msg->size);
+
+    // Only static data is at the same address after a restart
+    if (msg->size == 0 || msg->size > MaximumCheckpointSize ||
+        msg->address < data.virt || msg->address + msg->size > data.virt + data.size)
+    {
+        ERROR("invalid checkpoint region " << (void *) msg->address << " of " << msg->size << " bytes");
+        msg->result = Recovery::InvalidArgument;
+        return;
+    }
+
+    // Retrieve the checkpoint table of the process
+    Checkpoint * const *table = m_checkpoints.get(msg->from);
+    if (table != ZERO)
+    {
+        checkpoints = *table;
+    }
+    else
+    {
+        checkpoints = new Checkpoint[MaximumCheckpoints];
+        if (!checkpoints)
+        {
+            msg->result = Recovery::IOError;
+            return;
+        }
+        MemoryBlock::set(checkpoints, 0, sizeof(Checkpoint) * MaximumCheckpoints);
+        m_checkpoints.insert(msg->from, checkpoints);
+    }
+
+    // Find the snapshot of the region or an unused one
+    for (Size i = 0; i < MaximumCheckpoints; i++)
+    {
+        if (checkpoints[i].virt == msg->address || (!cp && checkpoints[i].virt == 0))
+        {
+            cp = &checkpoints[i];
+
+            if (checkpoints[i].virt == msg->address)
+                break;
+        }
+    }
+
+    if (!cp)
+    {
+        ERROR("no free checkpoint for PID " << msg->from);
+        msg->result = Recovery::IOError;
+        return;
+    }
+
+    // Allocate memory for the snapshot if the region is new or resized
+    if (cp->virt != msg->address || cp->copy.size != msg->size)
+    {
+        if (cp->virt != 0)
+        {
+            VMCtl(SELF, Release, &cp->copy);
+            cp->virt = 0;
+        }
+
+        cp->copy.virt   = ZERO;
+        cp->copy.phys   = ZERO;
+        cp->copy.size   = msg->size;
+        cp->copy.access = Memory::User|Memory::Readable|Memory::Writable;
+
+        const API::Result mapResult = VMCtl(SELF, MapContiguous, &cp->copy);
+        if (mapResult != API::Success)
+        {
+            ERROR("failed to map checkpoint memory: result = " << (int) mapResult);
+            msg->result = Recovery::IOError;
+            return;
+        }
+        cp->virt = msg->address;
+    }
+
+    // Take the snapshot
+    const API::Result copyResult = VMCopy(msg->from, API::Read, cp->copy.virt, cp->virt, cp->copy.size);
+    if (copyResult != API::Success)
+    {
+        ERROR("failed to read checkpoint region from PID " << msg->from <<
+              ": result = " << (int) copyResult);
+        msg->result = Recovery::IOError;
+        return;
+    }
+
+    msg->result = Recovery::Success;
+}
+
+bool RecoveryServer::restoreCheckpoints(const ProcessID pid) const
+{
+    Checkpoint * const *table = m_checkpoints.get(pid);
+
+    if (table == ZERO)
+    {
+        return true;
+    }
+
+    for (Size i = 0; i < MaximumCheckpoints; i++)
+    {
+        const Checkpoint *cp = &(*table)[i];
+
+        if (cp->virt == 0)
+            continue;
+
+        const API::Result copyResult = VMCopy(pid, API::Write, cp->copy.virt, cp->virt, cp->copy.size);
+        if (copyResult != API::Success)
+        {
+            ERROR("failed to write checkpoint region to PID " << pid <<
+                  ": result = " << (int) copyResult);
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool RecoveryServer::reloadProgram(const ProcessID pid,
-                                   const char *path) const
+                                   const char *path)
+{
+    DEBUG("pid = " << pid << " path = " << path);
+
+    // Read the program only on the first restart
+    Memory::Range * const *cached = m_images.get(path);
+    const Memory::Range *image = cached ? *cached : ZERO;
+
+    if (image == ZERO)
+    {
+        Memory::Range *loaded = new Memory::Range;
+
+        if (!loaded || !loadProgram(path, *loaded))
+        {
+            delete loaded;
+            return false;
+        }
+
+        if (!m_images.insert(path, loaded))
+        {
+            ERROR("failed to cache program image for " << path);
+            VMCtl(SELF, Release, loaded);
+            delete loaded;
+            return false;
+        }
+
+        image = loaded;
+    }
+
+    // Release current memory pages
+    if (!cleanupProgram(pid))
+    {
+        ERROR("failed to cleanup program data for PID " << pid);
+        return false;
+    }
+
+    // Write to program
+    if (!rewriteProgram(pid, image->virt, image->size))
+    {
+        ERROR("failed to reset data for PID " << pid);
+        return false;
+    }
+
+    // Success
+    return true;
+}
+
+bool RecoveryServer::loadProgram(const char *path,
+                                 Memory::Range & image) const
 {
     const FileSystemClient fs;
     FileSystem::FileStat st;
     Size fd;
 
-    DEBUG("pid = " << pid << " path = " << path);
-
+    DEBUG("path = " << path);
     // Retrieve file information
     const FileSystem::Result statResult = fs.statFile(path, &st);
     if (statResult != FileSystem::Success)
@@ -210,26 +386,8 @@ bool RecoveryServer::reloadProgram(const ProcessID pid,
         return false;
     }
 
-    // Release current memory pages
-    if (!cleanupProgram(pid))
-    {
-        ERROR("failed to cleanup program data for PID " << pid);
-        VMCtl(SELF, Release, &compressed);
-        VMCtl(SELF, Release, &uncompressed);
-        return false;
-    }
-
-    // Write to program
-    if (!rewriteProgram(pid, uncompressed.virt, num))
-    {
-        ERROR("failed to reset data for PID " << pid);
-        VMCtl(SELF, Release, &compressed);
-        VMCtl(SELF, Release, &uncompressed);
-        return false;
-    }
-
-    // Cleanup program buffers
-    API::Result releaseResult = VMCtl(SELF, Release, &compressed);
+    // Cleanup compressed program buffer
+    const API::Result releaseResult = VMCtl(SELF, Release, &compressed);
     if (releaseResult != API::Success)
     {
         DEBUG("failed to release compressed memory: result = " << (int) releaseResult);
@@ -237,14 +395,8 @@ bool RecoveryServer::reloadProgram(const ProcessID pid,
         return false;
     }
 
-    releaseResult = VMCtl(SELF, Release, &uncompressed);
-    if (releaseResult != API::Success)
-    {
-        DEBUG("failed to release uncompressed memory: result = " << (int) releaseResult);
-        return false;
-    }
-
     // Success
+    image = uncompressed;
     return true;
 }
 
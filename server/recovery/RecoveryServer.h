@@ -19,6 +19,8 @@
 #define __SERVER_RECOVERY_RECOVERYSERVER_H
 
 #include <ChannelServer.h>
+#include <HashTable.h>
+#include <String.h>
 #include <Types.h>
 #include "Recovery.h"
 #include "RecoveryMessage.h"
@@ -36,6 +38,12 @@
  *
  * Provides fault tolerance to servers by restarting on errors (recovery)
  *
+ * Program images are kept decompressed after the first restart, so that
+ * further restarts do not read the filesystem. Processes can checkpoint
+ * regions of their static data. After a restart, the last snapshot of
+ * each region is written back before the process resumes, such that
+ * it does not need to rebuild that state.
+ *
  * @todo Support automatic restart of a process when a CPU exception occurs
  *
  * @todo Pro-actively send ping/pong requests to processes to verify they
@@ -54,6 +62,21 @@ class RecoveryServer : public ChannelServer<RecoveryServer, RecoveryMessage>
 {
   private:
 
+    /** Maximum number of checkpointed regions per process */
+    static const Size MaximumCheckpoints = 4;
+
+    /** Maximum size of a checkpointed region */
+    static const Size MaximumCheckpointSize = KiloByte(256);
+
+    /**
+     * Snapshot of a memory region in a process
+     */
+    struct Checkpoint
+    {
+        Address virt;       /**< Start of the region in the process, or zero if unused */
+        Memory::Range copy; /**< Our mapping of the snapshot */
+    };
+
   public:
 
     /**
@@ -70,6 +93,33 @@ class RecoveryServer : public ChannelServer<RecoveryServer, RecoveryMessage>
      */
     void restartProcess(RecoveryMessage *msg);
 
+    /**
+     * Take a snapshot of a memory region in the calling process.
+     *
+     * @param msg RecoveryMessage pointer
+     */
+    void checkpoint(RecoveryMessage *msg);
+
+    /**
+     * Write back all snapshots of a process.
+     *
+     * @param pid Process identifier
+     *
+     * @return True if success, false otherwise
+     */
+    bool restoreCheckpoints(const ProcessID pid) const;
+
+    /**
+     * Read and decompress a program image.
+     *
+     * @param path Path to the program data to use
+     * @param image Receives our mapping of the uncompressed program
+     *
+     * @return True if success, false otherwise
+     */
+    bool loadProgram(const char *path,
+                     Memory::Range & image) const;
+
     /**
      * Overwrite the given process by fetching a fresh program data copy.
      *
@@ -79,7 +129,7 @@ class RecoveryServer : public ChannelServer<RecoveryServer, RecoveryMessage>
      * @return True if success, false otherwise
      */
     bool reloadProgram(const ProcessID pid,
-                       const char *path) const;
+                       const char *path);
 
     /**
      * Release and unmap program data
@@ -102,6 +152,14 @@ class RecoveryServer : public ChannelServer<RecoveryServer, RecoveryMessage>
     bool rewriteProgram(const ProcessID pid,
                         const Address program,
                         const Size size) const;
+
+  private:
+
+    /** Uncompressed program images by path */
+    HashTable<String, Memory::Range *> m_images;
+
+    /** Checkpointed regions by process */
+    HashTable<ProcessID, Checkpoint *> m_checkpoints;
 };
 
 /**
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Log.h>
+#include "BroadcomSDHost.h"
+
+template<> SDHost* AbstractFactory<SDHost>::create()
+{
+    return new BroadcomSDHost();
+}
+
+BroadcomSDHost::BroadcomSDHost()
+    : SDHost()
+    , m_blockSize(0)
+    , m_transferBytes(0)
+    , m_transferred(0)
+    , m_transferWrite(false)
+{
+}
+
+Size BroadcomSDHost::getInterrupt() const
+{
+    return InterruptNumber;
+}
+
+FileSystem::Result BroadcomSDHost::initialize()
+{
+    DEBUG("");
+
+    // Map hardware registers
+    const IO::Result mapResult = m_io.map(IO_BASE + IOBase, PAGESIZE,
+                                          Memory::User | Memory::Readable |
+                                          Memory::Writable | Memory::Device);
+    if (mapResult != IO::Success)
+    {
+        ERROR("failed to map hardware registers: result = " << (int) mapResult);
+        return FileSystem::IOError;
+    }
+
+    const FileSystem::Result bufferResult = allocateBuffer();
+    if (bufferResult != FileSystem::Success)
+    {
+        return bufferResult;
+    }
+
+    const FileSystem::Result resetResult = reset(Control1ResetHost);
+    if (resetResult != FileSystem::Success)
+    {
+        ERROR("failed to reset controller: result = " << (int) resetResult);
+        return resetResult;
+    }
+
+    // All events are visible in the status, only transfers raise interrupts
+    m_io.write(Control2, 0);
+    m_io.write(InterruptMask, 0xffffffff);
+    m_io.write(InterruptEnable, 0);
+    m_io.write(Interrupt, 0xffffffff);
+
+    const FileSystem::Result clockResult = setClock(400000);
+    if (clockResult != FileSystem::Success)
+    {
+        return clockResult;
+    }
+
+    return setBusWidth(1);
+}
+
+FileSystem::Result BroadcomSDHost::setClock(const Size hertz)
+{
+    DEBUG("hertz = " << hertz);
+
+    // The clock is the base clock divided by twice the 10-bit divider
+    Size divider = hertz >= BaseClock ? 0 : CEIL(BaseClock, hertz * 2);
+
+    if (divider > 0x3ff)
+    {
+        divider = 0x3ff;
+    }
+
+    m_io.unset(Control1, Control1CardClock);
+    m_io.write(Control1, (m_io.read(Control1) & ~(Control1DividerMask | (0xf << 16))) |
+                         ((divider & 0xff) << 8) | (((divider >> 8) & 0x3) << 6) |
+                         Control1TimeoutMax | Control1ClockEnable);
+
+    for (Size i = 0; i < MaximumPoll; i++)
+    {
+        if (m_io.read(Control1) & Control1ClockStable)
+        {
+            if (hertz > 25000000)
+                m_io.set(Control0, Control0HighSpeed);
+            else
+                m_io.unset(Control0, Control0HighSpeed);
+
+            m_io.set(Control1, Control1CardClock);
+            return FileSystem::Success;
+        }
+    }
+
+    ERROR("clock not stable");
+    return FileSystem::TimedOut;
+}
+
+FileSystem::Result BroadcomSDHost::setBusWidth(const Size bits)
+{
+    DEBUG("bits = " << bits);
+
+    if (bits == 4)
+        m_io.set(Control0, Control0DataWidth4);
+    else
+        m_io.unset(Control0, Control0DataWidth4);
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result BroadcomSDHost::command(SDHost::Command & cmd)
+{
+    DEBUG("index = " << cmd.index << " argument = " << (void *) cmd.argument);
+
+    const FileSystem::Result readyResult = waitReady(StatusCommandInhibit | StatusDataInhibit);
+    if (readyResult != FileSystem::Success)
+    {
+        return readyResult;
+    }
+
+    m_io.write(Interrupt, 0xffffffff);
+    m_io.write(Argument, cmd.argument);
+    m_io.write(CommandTransfer, commandFlags(cmd));
+
+    u32 status = 0;
+
+    for (Size i = 0; i < MaximumPoll; i++)
+    {
+        status = m_io.read(Interrupt);
+
+        if (status & (IntCommandDone | IntError))
+            break;
+    }
+
+    m_io.write(Interrupt, status);
+
+    if (status & IntError)
+    {
+        reset(Control1ResetCommand);
+
+        if (status & IntCommandTimeout)
+            return FileSystem::TimedOut;
+
+        ERROR("command " << cmd.index << " failed: status = " << (void *) status);
+        return FileSystem::IOError;
+    }
+    else if (!(status & IntCommandDone))
+    {
+        return FileSystem::TimedOut;
+    }
+
+    // The controller strips the CRC from long responses
+    if (cmd.type == ResponseLong)
+    {
+        for (Size i = 0; i < 4; i++)
+        {
+            cmd.response[i] = (m_io.read(Response0 + (i * sizeof(u32))) << 8) |
+                              (i ? (m_io.read(Response0 + ((i - 1) * sizeof(u32))) >> 24) : 0);
+        }
+    }
+    else
+    {
+        cmd.response[0] = m_io.read(Response0);
+    }
+
+    return cmd.type == ResponseBusy ? waitReady(StatusDataInhibit) : FileSystem::Success;
+}
+
+FileSystem::Result BroadcomSDHost::startTransfer(SDHost::Command & cmd,
+                                                 const Size blockSize,
+                                                 const Size blocks,
+                                                 const bool write)
+{
+    DEBUG("index = " << cmd.index << " blocks = " << blocks << " write = " << write);
+
+    if (blockSize * blocks > BufferSize || blocks == 0 || blockSize % sizeof(u32))
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    const FileSystem::Result readyResult = waitReady(StatusCommandInhibit | StatusDataInhibit);
+    if (readyResult != FileSystem::Success)
+    {
+        return readyResult;
+    }
+
+    m_blockSize = blockSize;
+    m_transferBytes = blockSize * blocks;
+    m_transferred = 0;
+    m_transferWrite = write;
+
+    m_io.write(BlockSizeCount, blockSize | (blocks << 16));
+    m_io.write(Interrupt, 0xffffffff);
+    m_io.write(InterruptEnable, IntDataDone | IntErrors |
+                                (write ? IntWriteReady : IntReadReady));
+    m_io.write(Argument, cmd.argument);
+    m_io.write(CommandTransfer, commandFlags(cmd) | CommandData | TransferBlockCount |
+                                (write ? 0 : TransferRead) |
+                                (blocks > 1 ? TransferMultiple | TransferAutoStop : 0));
+    return FileSystem::Success;
+}
+
+FileSystem::Result BroadcomSDHost::checkTransfer()
+{
+    const u32 ready = m_transferWrite ? IntWriteReady : IntReadReady;
+    u32 status = m_io.read(Interrupt);
+
+    // Move each block which the controller is ready for
+    while ((status & ready) && !(status & IntError) && m_transferred < m_transferBytes)
+    {
+        u32 *block = (u32 *) (m_buffer.virt + m_transferred);
+
+        m_io.write(Interrupt, ready);
+
+        if (m_transferWrite)
+            m_io.writeFifo(Data, m_blockSize, block);
+        else
+            m_io.readFifo(Data, m_blockSize, block);
+
+        m_transferred += m_blockSize;
+        status = m_io.read(Interrupt);
+    }
+
+    if (status & IntError)
+    {
+        ERROR("transfer failed: status = " << (void *) status <<
+              " transferred = " << m_transferred);
+
+        m_io.write(InterruptEnable, 0);
+        m_io.write(Interrupt, 0xffffffff);
+        reset(Control1ResetCommand | Control1ResetData);
+        return FileSystem::IOError;
+    }
+
+    if (!(status & IntDataDone))
+    {
+        return FileSystem::RetryAgain;
+    }
+
+    m_io.write(InterruptEnable, 0);
+    m_io.write(Interrupt, 0xffffffff);
+    return FileSystem::Success;
+}
+
+FileSystem::Result BroadcomSDHost::reset(const u32 flags)
+{
+    m_io.set(Control1, flags);
+
+    for (Size i = 0; i < MaximumPoll; i++)
+    {
+        if (!(m_io.read(Control1) & flags))
+            return FileSystem::Success;
+    }
+
+    return FileSystem::TimedOut;
+}
+
+FileSystem::Result BroadcomSDHost::waitReady(const u32 flags)
+{
+    for (Size i = 0; i < MaximumPoll; i++)
+    {
+        if (!(m_io.read(Status) & flags))
+            return FileSystem::Success;
+    }
+
+    ERROR("controller remains busy");
+    return FileSystem::TimedOut;
+}
+
+u32 BroadcomSDHost::commandFlags(const SDHost::Command & cmd) const
+{
+    u32 flags = cmd.index << CommandIndexShift;
+
+    // Only short responses with a CRC carry the command index
+    switch (cmd.type)
+    {
+        case ResponseNone:  break;
+        case ResponseNoCRC: flags |= CommandResponse; break;
+        case ResponseLong:  flags |= CommandResponseLong | CommandCheckCRC; break;
+        case ResponseBusy:  flags |= CommandResponseBusy | CommandCheckCRC | CommandCheckIndex; break;
+        default:            flags |= CommandResponse | CommandCheckCRC | CommandCheckIndex; break;
+    }
+
+    return flags;
+}
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __SERVER_SDMMC_BROADCOMSDHOST_H
+#define __SERVER_SDMMC_BROADCOMSDHOST_H
+
+#include <FreeNOS/System.h>
+#include <Types.h>
+#include "SDHost.h"
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup sdmmc
+ * @{
+ */
+
+/**
+ * Broadcom BCM2835/BCM2836 External Mass Media Controller (EMMC).
+ *
+ * The controller follows the SD Host Controller specification, but has
+ * no DMA engine of its own. Data moves through the data port one block
+ * at a time when the controller signals that a block is ready.
+ */
+class BroadcomSDHost : public SDHost
+{
+  private:
+
+    /** Offset of the controller from the I/O base address */
+    static const Address IOBase = 0x300000;
+
+    /** Interrupt vector of the controller */
+    static const Size InterruptNumber = 62;
+
+    /** Base clock of the controller as configured by the firmware */
+    static const Size BaseClock = 250000000;
+
+    /**
+     * Hardware registers
+     */
+    enum Registers
+    {
+        BlockSizeCount  = 0x04,
+        Argument        = 0x08,
+        CommandTransfer = 0x0c,
+        Response0       = 0x10,
+        Data            = 0x20,
+        Status          = 0x24,
+        Control0        = 0x28,
+        Control1        = 0x2c,
+        Interrupt       = 0x30,
+        InterruptMask   = 0x34,
+        InterruptEnable = 0x38,
+        Control2        = 0x3c
+    };
+
+    /**
+     * Command and transfer mode register flags
+     */
+    enum CommandFlags
+    {
+        TransferBlockCount  = (1 << 1),
+        TransferAutoStop    = (1 << 2),
+        TransferRead        = (1 << 4),
+        TransferMultiple    = (1 << 5),
+        CommandResponseLong = (1 << 16),
+        CommandResponse     = (2 << 16),
+        CommandResponseBusy = (3 << 16),
+        CommandCheckCRC     = (1 << 19),
+        CommandCheckIndex   = (1 << 20),
+        CommandData         = (1 << 21),
+        CommandIndexShift   = 24
+    };
+
+    /**
+     * Status register flags
+     */
+    enum StatusFlags
+    {
+        StatusCommandInhibit = (1 << 0),
+        StatusDataInhibit    = (1 << 1)
+    };
+
+    /**
+     * Control register flags
+     */
+    enum ControlFlags
+    {
+        Control0DataWidth4   = (1 << 1),
+        Control0HighSpeed    = (1 << 2),
+        Control1ClockEnable  = (1 << 0),
+        Control1ClockStable  = (1 << 1),
+        Control1CardClock    = (1 << 2),
+        Control1DividerMask  = 0xffe0,
+        Control1TimeoutMax   = (0xe << 16),
+        Control1ResetHost    = (1 << 24),
+        Control1ResetCommand = (1 << 25),
+        Control1ResetData    = (1 << 26)
+    };
+
+    /**
+     * Interrupt flags
+     */
+    enum InterruptFlags
+    {
+        IntCommandDone      = (1 << 0),
+        IntDataDone         = (1 << 1),
+        IntWriteReady       = (1 << 4),
+        IntReadReady        = (1 << 5),
+        IntError            = (1 << 15),
+        IntCommandTimeout   = (1 << 16),
+        IntErrors           = 0xffff8000
+    };
+
+  public:
+
+    /**
+     * Constructor
+     */
+    BroadcomSDHost();
+
+    /**
+     * Get the interrupt vector of the controller.
+     *
+     * @return Interrupt vector
+     */
+    virtual Size getInterrupt() const;
+
+    /**
+     * Reset the controller and select the identification clock and 1-bit bus.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result initialize();
+
+    /**
+     * Set the card clock.
+     *
+     * @param hertz Maximum clock rate in hertz
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result setClock(const Size hertz);
+
+    /**
+     * Set the data bus width.
+     *
+     * @param bits Number of data lines, either 1 or 4
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result setBusWidth(const Size bits);
+
+    /**
+     * Send a command without data and wait for its response.
+     *
+     * @param cmd Command to send, receives the response
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result command(Command & cmd);
+
+    /**
+     * Start a command which transfers data blocks.
+     *
+     * @param cmd Command to send
+     * @param blockSize Size of each block in bytes
+     * @param blocks Number of blocks
+     * @param write True to write to the card, false to read
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result startTransfer(Command & cmd,
+                                             const Size blockSize,
+                                             const Size blocks,
+                                             const bool write);
+
+    /**
+     * Process progress of the current transfer.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result checkTransfer();
+
+  private:
+
+    /**
+     * Reset parts of the controller.
+     *
+     * @param flags Control1 reset flags
+     *
+     * @return Result code
+     */
+    FileSystem::Result reset(const u32 flags);
+
+    /**
+     * Wait until the controller accepts a new command.
+     *
+     * @param flags StatusFlags which must be cleared
+     *
+     * @return Result code
+     */
+    FileSystem::Result waitReady(const u32 flags);
+
+    /**
+     * Get the command register value for a command.
+     *
+     * @param cmd Command to send
+     *
+     * @return Command register value
+     */
+    u32 commandFlags(const Command & cmd) const;
+
+  private:
+
+    /** Memory I/O object */
+    Arch::IO m_io;
+
+    /** Size of each block in the current transfer */
+    Size m_blockSize;
+
+    /** Number of bytes in the current transfer */
+    Size m_transferBytes;
+
+    /** Number of bytes moved through the data port */
+    Size m_transferred;
+
+    /** True if the current transfer writes to the card */
+    bool m_transferWrite;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_SDMMC_BROADCOMSDHOST_H */
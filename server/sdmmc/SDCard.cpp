@@ -0,0 +1,408 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Log.h>
+#include "SDCard.h"
+
+SDCard::SDCard(const u32 inode, SDHost & host)
+    : Device(inode, FileSystem::BlockDeviceFile)
+    , m_host(host)
+    , m_address(0)
+    , m_highCapacity(false)
+    , m_capacity(0)
+    , m_state(Idle)
+    , m_pid(ANY)
+    , m_offset(0)
+    , m_size(0)
+    , m_write(false)
+    , m_transferSize(0)
+    , m_bufferOffset(0)
+    , m_bufferValid(0)
+{
+    m_identifier << "mmc0";
+}
+
+FileSystem::Result SDCard::initialize()
+{
+    u32 response = 0;
+
+    DEBUG("");
+
+    FileSystem::Result result = m_host.initialize();
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to initialize host controller: result = " << (int) result);
+        return result;
+    }
+
+    result = command(GoIdle, 0, SDHost::ResponseNone);
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to reset card: result = " << (int) result);
+        return result;
+    }
+
+    // Version 2.00 cards echo the check pattern, older cards do not respond
+    result = command(SendInterface, InterfaceCheck, SDHost::ResponseShort, &response);
+    if (result != FileSystem::Success && result != FileSystem::TimedOut)
+    {
+        return result;
+    }
+    const bool version2 = result == FileSystem::Success && (response & 0xfff) == InterfaceCheck;
+
+    // Wait until the card finished its power up
+    for (Size i = 0; i < MaximumInitPoll && !(response & OperatingReady); i++)
+    {
+        result = applicationCommand(SendOperatingCond,
+                                    OperatingVoltage | (version2 ? (u32) OperatingHighCap : 0U),
+                                    SDHost::ResponseNoCRC, &response);
+        if (result != FileSystem::Success)
+        {
+            ERROR("no card found: result = " << (int) result);
+            return FileSystem::NotFound;
+        }
+    }
+
+    if (!(response & OperatingReady))
+    {
+        ERROR("card remains busy");
+        return FileSystem::TimedOut;
+    }
+    m_highCapacity = (response & OperatingHighCap) != 0;
+
+    // Assign an address to the card
+    if ((result = command(AllSendIdentifier, 0, SDHost::ResponseLong)) != FileSystem::Success ||
+        (result = command(SendRelativeAddress, 0, SDHost::ResponseShort, &response)) != FileSystem::Success)
+    {
+        ERROR("failed to assign card address: result = " << (int) result);
+        return result;
+    }
+    m_address = response >> AddressShift;
+
+    result = readCapacity();
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+
+    // Enter the transfer state with the 4-bit bus, which all SD memory cards support
+    if ((result = command(SelectCard, m_address << AddressShift, SDHost::ResponseBusy)) != FileSystem::Success ||
+        (result = applicationCommand(SetBusWidth, BusWidth4, SDHost::ResponseShort)) != FileSystem::Success ||
+        (result = m_host.setBusWidth(4)) != FileSystem::Success)
+    {
+        ERROR("failed to select card: result = " << (int) result);
+        return result;
+    }
+
+    // Standard capacity cards are addressed in bytes, with a configurable block length
+    if (!m_highCapacity)
+    {
+        result = command(SetBlockLength, BlockSize, SDHost::ResponseShort);
+        if (result != FileSystem::Success)
+        {
+            ERROR("failed to set block length: result = " << (int) result);
+            return result;
+        }
+    }
+
+    const bool highSpeed = switchHighSpeed();
+
+    result = m_host.setClock(highSpeed ? 50000000 : 25000000);
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to set card clock: result = " << (int) result);
+        return result;
+    }
+
+    NOTICE("capacity = " << (Size) (m_capacity / 1024 / 1024) << "MiB" <<
+           " highcap = " << (m_highCapacity ? "yes" : "no") <<
+           " highspeed = " << (highSpeed ? "yes" : "no"));
+    return FileSystem::Success;
+}
+
+FileSystem::Result SDCard::read(IOBuffer & buffer,
+                                Size & size,
+                                const Size offset)
+{
+    if (offset >= m_capacity)
+    {
+        return FileSystem::IOError;
+    }
+
+    // Do not read beyond the end of the card
+    if (offset + (u64) size > m_capacity)
+    {
+        size = m_capacity - offset;
+    }
+
+    // A single command transfers at most the transfer buffer
+    if ((offset % BlockSize) + size > SDHost::BufferSize)
+    {
+        size = SDHost::BufferSize - (offset % BlockSize);
+    }
+
+    return transfer(buffer, size, offset, false);
+}
+
+FileSystem::Result SDCard::write(IOBuffer & buffer,
+                                 Size & size,
+                                 const Size offset)
+{
+    // Partial blocks would need a read-modify-write cycle
+    if (offset % BlockSize || size % BlockSize || !size)
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    if (offset >= m_capacity)
+    {
+        return FileSystem::IOError;
+    }
+
+    // Do not write beyond the end of the card
+    if (offset + (u64) size > m_capacity)
+    {
+        size = m_capacity - offset;
+    }
+
+    if (size > SDHost::BufferSize)
+    {
+        size = SDHost::BufferSize;
+    }
+
+    return transfer(buffer, size, offset, true);
+}
+
+FileSystem::Result SDCard::interrupt(const Size vector)
+{
+    if (m_state == Busy)
+    {
+        const FileSystem::Result result = m_host.checkTransfer();
+
+        if (result == FileSystem::Success)
+        {
+            m_state = Done;
+
+            if (!m_write)
+                m_bufferValid = m_transferSize;
+        }
+        else if (result != FileSystem::RetryAgain)
+        {
+            m_state = Failed;
+        }
+    }
+
+    // Re-enable the interrupt line on the interrupt controller
+    ProcessCtl(SELF, EnableIRQ, vector);
+    return FileSystem::Success;
+}
+
+FileSystem::Result SDCard::command(const u8 index,
+                                   const u32 argument,
+                                   const SDHost::ResponseType type,
+                                   u32 *response)
+{
+    SDHost::Command cmd;
+
+    cmd.index = index;
+    cmd.argument = argument;
+    cmd.type = type;
+
+    const FileSystem::Result result = m_host.command(cmd);
+    if (result == FileSystem::Success && response)
+    {
+        *response = cmd.response[0];
+    }
+
+    return result;
+}
+
+FileSystem::Result SDCard::applicationCommand(const u8 index,
+                                              const u32 argument,
+                                              const SDHost::ResponseType type,
+                                              u32 *response)
+{
+    const FileSystem::Result result = command(ApplicationCommand, m_address << AddressShift,
+                                              SDHost::ResponseShort);
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+
+    return command(index, argument, type, response);
+}
+
+FileSystem::Result SDCard::readCapacity()
+{
+    SDHost::Command cmd;
+
+    cmd.index = SendSpecificData;
+    cmd.argument = m_address << AddressShift;
+    cmd.type = SDHost::ResponseLong;
+
+    const FileSystem::Result result = m_host.command(cmd);
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to read card specific data: result = " << (int) result);
+        return result;
+    }
+
+    // Version 2.0 data counts the capacity in units of 512KiB
+    if (bits(cmd.response, 126, 2) == 1)
+    {
+        m_capacity = ((u64) bits(cmd.response, 48, 22) + 1) * 512 * 1024;
+    }
+    else
+    {
+        const u32 size = bits(cmd.response, 62, 12);
+        const u32 multiplier = bits(cmd.response, 47, 3);
+        const u32 blockLength = bits(cmd.response, 80, 4);
+
+        m_capacity = ((u64) size + 1) << (multiplier + 2 + blockLength);
+    }
+
+    return FileSystem::Success;
+}
+
+bool SDCard::switchHighSpeed()
+{
+    SDHost::Command cmd;
+
+    cmd.index = SwitchFunction;
+    cmd.argument = SwitchHighSpeed;
+    cmd.type = SDHost::ResponseShort;
+
+    // Cards older than version 1.10 reject the command
+    if (m_host.startTransfer(cmd, SwitchStatusSize, 1, false) != FileSystem::Success ||
+        m_host.waitTransfer() != FileSystem::Success)
+    {
+        return false;
+    }
+
+    // Bits 379:376 of the status hold the selected function of group 1
+    const u8 *status = (const u8 *) m_host.getBuffer().virt;
+    return (status[16] & 0xf) == 1;
+}
+
+u32 SDCard::bits(const u32 *response, const Size start, const Size count)
+{
+    u32 value = 0;
+
+    for (Size i = 0; i < count; i++)
+    {
+        const Size bit = start + i;
+
+        if (response[bit / 32] & (1U << (bit % 32)))
+            value |= (1U << i);
+    }
+
+    return value;
+}
+
+FileSystem::Result SDCard::transfer(IOBuffer & buffer,
+                                    const Size size,
+                                    const Size offset,
+                                    const bool write)
+{
+    const ProcessID pid = buffer.getMessage()->from;
+    const Address data = m_host.getBuffer().virt;
+
+    // Complete the transfer started by an earlier attempt of this request
+    if (m_state != Idle && m_pid == pid && m_offset == offset &&
+        m_size == size && m_write == write)
+    {
+        const State state = m_state;
+
+        if (state == Busy)
+        {
+            return FileSystem::RetryAgain;
+        }
+
+        m_state = Idle;
+
+        if (state == Failed)
+        {
+            ERROR("failed to " << (write ? "write" : "read") << " " << size <<
+                  " bytes at offset " << offset);
+            return FileSystem::IOError;
+        }
+        else if (write)
+        {
+            return FileSystem::Success;
+        }
+    }
+
+    // Serve reads from blocks which an earlier read fetched ahead
+    if (!write && offset >= m_bufferOffset &&
+        offset + size <= m_bufferOffset + m_bufferValid)
+    {
+        return buffer.write((void *) (data + (offset - m_bufferOffset)), size);
+    }
+
+    // The transfer buffer is used by one command at a time
+    if (m_state == Busy)
+    {
+        return FileSystem::RetryAgain;
+    }
+
+    const Size first = offset / BlockSize;
+    Size bytes = CEIL((offset % BlockSize) + size, BlockSize) * BlockSize;
+
+    if (!write && bytes < ReadAheadSize)
+    {
+        bytes = ReadAheadSize;
+    }
+
+    if ((first * BlockSize) + (u64) bytes > m_capacity)
+    {
+        bytes = m_capacity - (first * BlockSize);
+    }
+
+    const Size blocks = bytes / BlockSize;
+    m_bufferValid = 0;
+
+    if (write)
+    {
+        const FileSystem::Result readResult = buffer.read((void *) data, size);
+        if (readResult != FileSystem::Success)
+        {
+            return readResult;
+        }
+    }
+
+    SDHost::Command cmd;
+    cmd.index = write ? (blocks > 1 ? WriteMultipleBlock : WriteSingleBlock) :
+                        (blocks > 1 ? ReadMultipleBlock : ReadSingleBlock);
+    cmd.argument = m_highCapacity ? first : first * BlockSize;
+    cmd.type = SDHost::ResponseShort;
+
+    const FileSystem::Result result = m_host.startTransfer(cmd, BlockSize, blocks, write);
+    if (result != FileSystem::Success)
+    {
+        ERROR("failed to start transfer: result = " << (int) result);
+        return FileSystem::IOError;
+    }
+
+    m_state = Busy;
+    m_pid = pid;
+    m_offset = offset;
+    m_size = size;
+    m_write = write;
+    m_transferSize = bytes;
+    m_bufferOffset = first * BlockSize;
+    return FileSystem::RetryAgain;
+}
@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __SERVER_SDMMC_SDCARD_H
+#define __SERVER_SDMMC_SDCARD_H
+
+#include <FreeNOS/System.h>
+#include <Types.h>
+#include <Device.h>
+#include "SDHost.h"
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup sdmmc
+ * @{
+ */
+
+/**
+ * SD memory card block device.
+ *
+ * Identifies the card in 1-bit mode at 400kHz, then switches to the
+ * 4-bit bus and high speed timing when the card supports it. Each read
+ * and write is a single multiple block command through the transfer buffer
+ * of the SDHost. Reads fetch at least ReadAheadSize bytes, such that
+ * sequential reads are mostly served from the transfer buffer.
+ */
+class SDCard : public Device
+{
+  private:
+
+    /** Size of a data block */
+    static const Size BlockSize = 512;
+
+    /** Minimum number of bytes fetched by a read */
+    static const Size ReadAheadSize = SDHost::BufferSize;
+
+    /** Maximum number of card initialization attempts */
+    static const Size MaximumInitPoll = 10000;
+
+    /** Relative card address shift in the command argument */
+    static const Size AddressShift = 16;
+
+    /**
+     * SD commands
+     */
+    enum Commands
+    {
+        GoIdle              = 0,
+        AllSendIdentifier   = 2,
+        SendRelativeAddress = 3,
+        SwitchFunction      = 6,
+        SelectCard          = 7,
+        SendInterface       = 8,
+        SendSpecificData    = 9,
+        SetBlockLength      = 16,
+        ReadSingleBlock     = 17,
+        ReadMultipleBlock   = 18,
+        WriteSingleBlock    = 24,
+        WriteMultipleBlock  = 25,
+        ApplicationCommand  = 55,
+        SetBusWidth         = 6,
+        SendOperatingCond   = 41
+    };
+
+    /**
+     * Command argument and response values
+     */
+    enum CommandValues
+    {
+        InterfaceCheck      = 0x1aa,
+        OperatingVoltage    = 0x00ff8000,
+        OperatingHighCap    = (1 << 30),
+        OperatingReady      = (1U << 31),
+        BusWidth4           = 2,
+        SwitchHighSpeed     = 0x80fffff1,
+        SwitchStatusSize    = 64
+    };
+
+    /**
+     * Transfer states
+     */
+    enum State
+    {
+        Idle,
+        Busy,
+        Done,
+        Failed
+    };
+
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param inode Inode number
+     * @param host Host controller connected to the card
+     */
+    SDCard(const u32 inode, SDHost & host);
+
+    /**
+     * Initialize the controller and the card.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result initialize();
+
+    /**
+     * Read bytes from the card.
+     *
+     * @param buffer Output buffer
+     * @param size Number of bytes to read, may be reduced on output
+     * @param offset Offset on the card
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result read(IOBuffer & buffer,
+                                    Size & size,
+                                    const Size offset);
+
+    /**
+     * Write whole blocks to the card.
+     *
+     * @param buffer Input buffer
+     * @param size Number of bytes to write, may be reduced on output
+     * @param offset Offset on the card
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result write(IOBuffer & buffer,
+                                     Size & size,
+                                     const Size offset);
+
+    /**
+     * Process a controller interrupt.
+     *
+     * @param vector Interrupt vector
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result interrupt(const Size vector);
+
+  private:
+
+    /**
+     * Send a command without data.
+     *
+     * @param index Command index
+     * @param argument Command argument
+     * @param type Response type
+     * @param response Receives the first response word if not ZERO
+     *
+     * @return Result code
+     */
+    FileSystem::Result command(const u8 index,
+                               const u32 argument,
+                               const SDHost::ResponseType type,
+                               u32 *response = ZERO);
+
+    /**
+     * Send an application specific command.
+     *
+     * @param index Command index
+     * @param argument Command argument
+     * @param type Response type
+     * @param response Receives the first response word if not ZERO
+     *
+     * @return Result code
+     */
+    FileSystem::Result applicationCommand(const u8 index,
+                                          const u32 argument,
+                                          const SDHost::ResponseType type,
+                                          u32 *response = ZERO);
+
+    /**
+     * Read the capacity from the card specific data.
+     *
+     * @return Result code
+     */
+    FileSystem::Result readCapacity();
+
+    /**
+     * Switch the card to high speed timing.
+     *
+     * @return True if the card switched to high speed
+     */
+    bool switchHighSpeed();
+
+    /**
+     * Extract a field from a long response.
+     *
+     * @param response Long response with bits 31:0 in the first word
+     * @param start First bit of the field
+     * @param count Number of bits in the field, at most 32
+     *
+     * @return Field value
+     */
+    static u32 bits(const u32 *response, const Size start, const Size count);
+
+    /**
+     * Start or complete a transfer.
+     *
+     * @param buffer Buffer of the request
+     * @param size Number of bytes in the request
+     * @param offset Offset on the card
+     * @param write True to write to the card
+     *
+     * @return Result code
+     */
+    FileSystem::Result transfer(IOBuffer & buffer,
+                                const Size size,
+                                const Size offset,
+                                const bool write);
+
+  private:
+
+    /** Host controller */
+    SDHost & m_host;
+
+    /** Relative card address */
+    u32 m_address;
+
+    /** True if the card is addressed by block instead of byte */
+    bool m_highCapacity;
+
+    /** Capacity in bytes */
+    u64 m_capacity;
+
+    /** State of the current transfer */
+    State m_state;
+
+    /** Process which requested the current transfer */
+    ProcessID m_pid;
+
+    /** Offset of the current request */
+    Size m_offset;
+
+    /** Size of the current request */
+    Size m_size;
+
+    /** True if the current transfer writes to the card */
+    bool m_write;
+
+    /** Number of bytes in the current transfer */
+    Size m_transferSize;
+
+    /** Offset of the first block in the transfer buffer */
+    Size m_bufferOffset;
+
+    /** Number of valid bytes in the transfer buffer from a completed read */
+    Size m_bufferValid;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_SDMMC_SDCARD_H */
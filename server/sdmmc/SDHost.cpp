@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Log.h>
+#include <MemoryBlock.h>
+#include "SDHost.h"
+
+SDHost::SDHost()
+{
+    MemoryBlock::set(&m_buffer, 0, sizeof(m_buffer));
+}
+
+SDHost::~SDHost()
+{
+}
+
+const Memory::Range & SDHost::getBuffer() const
+{
+    return m_buffer;
+}
+
+FileSystem::Result SDHost::waitTransfer()
+{
+    for (Size i = 0; i < MaximumPoll; i++)
+    {
+        const FileSystem::Result result = checkTransfer();
+        if (result != FileSystem::RetryAgain)
+        {
+            return result;
+        }
+    }
+
+    return FileSystem::TimedOut;
+}
+
+FileSystem::Result SDHost::allocateBuffer()
+{
+    // Cached memory, such that copies to and from clients are fast
+    m_buffer.phys = 0;
+    m_buffer.virt = 0;
+    m_buffer.size = BufferSize;
+    m_buffer.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    const API::Result vmResult = VMCtl(SELF, MapContiguous, &m_buffer);
+    if (vmResult != API::Success)
+    {
+        ERROR("failed to allocate transfer buffer: result = " << (int) vmResult);
+        return FileSystem::IOError;
+    }
+
+    return FileSystem::Success;
+}
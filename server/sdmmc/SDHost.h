@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __SERVER_SDMMC_SDHOST_H
+#define __SERVER_SDMMC_SDHOST_H
+
+#include <FreeNOS/System.h>
+#include <Types.h>
+#include <Factory.h>
+#include <FileSystem.h>
+#include <Memory.h>
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup sdmmc
+ * @{
+ */
+
+/**
+ * SD/MMC host controller.
+ *
+ * Sends commands to the card and moves data blocks between the card
+ * and a physically contiguous transfer buffer. The card protocol itself
+ * is implemented by SDCard. Each board provides its implementation
+ * through AbstractFactory<SDHost>::create().
+ */
+class SDHost : public AbstractFactory<SDHost>
+{
+  public:
+
+    /** Size of the transfer buffer in bytes */
+    static const Size BufferSize = PAGESIZE * 64;
+
+    /**
+     * Card response types
+     */
+    enum ResponseType
+    {
+        ResponseNone,       /**< No response */
+        ResponseShort,      /**< 48-bit response with CRC */
+        ResponseNoCRC,      /**< 48-bit response without CRC */
+        ResponseLong,       /**< 136-bit response with CRC */
+        ResponseBusy        /**< 48-bit response followed by busy signal */
+    };
+
+    /**
+     * Command to the card
+     */
+    struct Command
+    {
+        u8 index;               /**< Command index */
+        u32 argument;           /**< Command argument */
+        ResponseType type;      /**< Type of response */
+        u32 response[4];        /**< Response with bits 31:0 in the first word */
+    };
+
+  public:
+
+    /**
+     * Constructor
+     */
+    SDHost();
+
+    /**
+     * Destructor
+     */
+    virtual ~SDHost();
+
+    /**
+     * Get the transfer buffer.
+     *
+     * @return Memory range of the transfer buffer
+     */
+    const Memory::Range & getBuffer() const;
+
+    /**
+     * Get the interrupt vector of the controller.
+     *
+     * @return Interrupt vector
+     */
+    virtual Size getInterrupt() const = 0;
+
+    /**
+     * Reset the controller and select the identification clock and 1-bit bus.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result initialize() = 0;
+
+    /**
+     * Set the card clock.
+     *
+     * Rates above 25MHz also select high speed timing.
+     *
+     * @param hertz Maximum clock rate in hertz
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result setClock(const Size hertz) = 0;
+
+    /**
+     * Set the data bus width.
+     *
+     * @param bits Number of data lines, either 1 or 4
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result setBusWidth(const Size bits) = 0;
+
+    /**
+     * Send a command without data and wait for its response.
+     *
+     * @param cmd Command to send, receives the response
+     *
+     * @return Result code, TimedOut if the card did not respond
+     */
+    virtual FileSystem::Result command(Command & cmd) = 0;
+
+    /**
+     * Start a command which transfers data blocks.
+     *
+     * Multiple block transfers are stopped automatically by the controller.
+     * Data is read into or written from the start of the transfer buffer.
+     *
+     * @param cmd Command to send
+     * @param blockSize Size of each block in bytes
+     * @param blocks Number of blocks
+     * @param write True to write to the card, false to read
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result startTransfer(Command & cmd,
+                                             const Size blockSize,
+                                             const Size blocks,
+                                             const bool write) = 0;
+
+    /**
+     * Process progress of the current transfer.
+     *
+     * Called on each interrupt, or repeatedly to poll for completion.
+     *
+     * @return RetryAgain while in progress, Success when done or IOError on failure
+     */
+    virtual FileSystem::Result checkTransfer() = 0;
+
+    /**
+     * Wait for the current transfer to complete.
+     *
+     * @return Result code
+     */
+    FileSystem::Result waitTransfer();
+
+  protected:
+
+    /**
+     * Allocate the transfer buffer.
+     *
+     * @return Result code
+     */
+    FileSystem::Result allocateBuffer();
+
+  protected:
+
+    /** Maximum number of polling iterations */
+    static const Size MaximumPoll = 1000000;
+
+    /** Transfer buffer */
+    Memory::Range m_buffer;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_SDMMC_SDHOST_H */
@@ -0,0 +1,355 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Log.h>
+#include <MemoryBlock.h>
+#include "SunxiSDHost.h"
+
+template<> SDHost* AbstractFactory<SDHost>::create()
+{
+    return new SunxiSDHost();
+}
+
+SunxiSDHost::SunxiSDHost()
+    : SDHost()
+    , m_descriptors(ZERO)
+    , m_transferDone(0)
+    , m_transferBytes(0)
+    , m_transferWrite(false)
+{
+    MemoryBlock::set(&m_descriptorRange, 0, sizeof(m_descriptorRange));
+}
+
+Size SunxiSDHost::getInterrupt() const
+{
+    return InterruptNumber;
+}
+
+FileSystem::Result SunxiSDHost::initialize()
+{
+    DEBUG("");
+
+    // Initialize clock subsystem
+    if (m_ccu.initialize() != SunxiClockControl::Success ||
+        m_ccu.enable(SunxiClockControl::ClockMmc0) != SunxiClockControl::Success ||
+        m_ccu.deassert(SunxiClockControl::ResetMmc0) != SunxiClockControl::Success)
+    {
+        ERROR("failed to enable controller clock");
+        return FileSystem::IOError;
+    }
+
+    // Map hardware registers
+    const IO::Result mapResult = m_io.map(IOBase, PAGESIZE,
+                                          Memory::User | Memory::Readable |
+                                          Memory::Writable | Memory::Device);
+    if (mapResult != IO::Success)
+    {
+        ERROR("failed to map hardware registers: result = " << (int) mapResult);
+        return FileSystem::IOError;
+    }
+
+    // Allocate DMA descriptors
+    m_descriptorRange.phys = 0;
+    m_descriptorRange.virt = 0;
+    m_descriptorRange.size = PAGESIZE;
+    m_descriptorRange.access = Memory::User | Memory::Readable | Memory::Writable | Memory::Device;
+
+    const API::Result vmResult = VMCtl(SELF, MapContiguous, &m_descriptorRange);
+    if (vmResult != API::Success)
+    {
+        ERROR("failed to allocate DMA descriptors: result = " << (int) vmResult);
+        return FileSystem::IOError;
+    }
+
+    const FileSystem::Result bufferResult = allocateBuffer();
+    if (bufferResult != FileSystem::Success)
+    {
+        return bufferResult;
+    }
+
+    // Chain the descriptors over the pages of the transfer buffer
+    m_descriptors = (volatile Descriptor *) m_descriptorRange.virt;
+
+    for (Size i = 0; i < DescriptorCount; i++)
+    {
+        m_descriptors[i].config = 0;
+        m_descriptors[i].size = DescriptorBytes;
+        m_descriptors[i].buffer = m_buffer.phys + (i * DescriptorBytes);
+        m_descriptors[i].next = m_descriptorRange.phys + ((i + 1) * sizeof(Descriptor));
+    }
+
+    const FileSystem::Result resetResult = reset(SoftReset | FifoReset | DmaReset);
+    if (resetResult != FileSystem::Success)
+    {
+        ERROR("failed to reset controller: result = " << (int) resetResult);
+        return resetResult;
+    }
+
+    // Interrupts are raised by transfers only, commands are polled
+    m_io.write(Timeout, 0xffffffff);
+    m_io.write(InterruptMask, 0);
+    m_io.write(RawStatus, 0xffffffff);
+    m_io.write(FifoThreshold, 0x20070008);
+    m_io.write(DmaControl, DmaSoftReset);
+    m_io.write(DescriptorBase, m_descriptorRange.phys);
+    m_io.write(DmaInterruptEnable, 0);
+    m_io.unset(GlobalControl, AccessByAHB);
+    m_io.set(GlobalControl, InterruptEnable | DmaEnable);
+
+    const FileSystem::Result clockResult = setClock(400000);
+    if (clockResult != FileSystem::Success)
+    {
+        return clockResult;
+    }
+
+    return setBusWidth(1);
+}
+
+FileSystem::Result SunxiSDHost::setClock(const Size hertz)
+{
+    DEBUG("hertz = " << hertz);
+
+    // The card clock must be off while changing the module clock
+    m_io.unset(ClockControl, CardClockOn);
+
+    FileSystem::Result result = updateClock();
+    if (result != FileSystem::Success)
+    {
+        return result;
+    }
+
+    if (m_ccu.setRate(SunxiClockControl::ClockMmc0, hertz) != SunxiClockControl::Success)
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    m_io.unset(ClockControl, ClockDivider);
+    m_io.set(ClockControl, CardClockOn);
+    return updateClock();
+}
+
+FileSystem::Result SunxiSDHost::setBusWidth(const Size bits)
+{
+    DEBUG("bits = " << bits);
+
+    m_io.write(BusWidth, bits == 4 ? 1 : 0);
+    return FileSystem::Success;
+}
+
+FileSystem::Result SunxiSDHost::command(SDHost::Command & cmd)
+{
+    DEBUG("index = " << cmd.index << " argument = " << (void *) cmd.argument);
+
+    const FileSystem::Result readyResult = waitCardReady();
+    if (readyResult != FileSystem::Success)
+    {
+        return readyResult;
+    }
+
+    m_io.write(RawStatus, 0xffffffff);
+    m_io.write(Argument, cmd.argument);
+    m_io.write(CommandRegister, commandFlags(cmd));
+
+    u32 status = 0;
+
+    for (Size i = 0; i < MaximumPoll; i++)
+    {
+        status = m_io.read(RawStatus);
+
+        if (status & (IntCommandDone | IntErrors))
+            break;
+    }
+
+    m_io.write(RawStatus, status);
+
+    if (status & IntResponseTimeout)
+    {
+        return FileSystem::TimedOut;
+    }
+    else if ((status & IntErrors) || !(status & IntCommandDone))
+    {
+        ERROR("command " << cmd.index << " failed: status = " << (void *) status);
+        return FileSystem::IOError;
+    }
+
+    for (Size i = 0; i < 4; i++)
+    {
+        cmd.response[i] = m_io.read(Response0 + (i * sizeof(u32)));
+    }
+
+    return cmd.type == ResponseBusy ? waitCardReady() : FileSystem::Success;
+}
+
+FileSystem::Result SunxiSDHost::startTransfer(SDHost::Command & cmd,
+                                              const Size blockSize,
+                                              const Size blocks,
+                                              const bool write)
+{
+    const Size bytes = blockSize * blocks;
+    const Size count = CEIL(bytes, DescriptorBytes);
+    Memory::Range range = m_buffer;
+
+    DEBUG("index = " << cmd.index << " blocks = " << blocks << " write = " << write);
+
+    if (bytes > BufferSize || bytes == 0)
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    const FileSystem::Result readyResult = waitCardReady();
+    if (readyResult != FileSystem::Success)
+    {
+        return readyResult;
+    }
+
+    // Written data must be in memory, and no dirty lines may overwrite read data
+    range.size = bytes;
+    VMCtl(SELF, write ? CacheClean : CacheInvalidate, &range);
+
+    // Give the descriptors covering the transfer to the DMA controller
+    for (Size i = 0; i < count; i++)
+    {
+        const Size remaining = bytes - (i * DescriptorBytes);
+
+        m_descriptors[i].size = remaining < DescriptorBytes ? remaining : DescriptorBytes;
+        m_descriptors[i].config = DescriptorOwn | DescriptorChained |
+                                  (i == 0 ? (u32) DescriptorFirst : 0U) |
+                                  (i == count - 1 ? DescriptorLast : DescriptorNoInterrupt);
+    }
+
+    const FileSystem::Result resetResult = reset(FifoReset | DmaReset);
+    if (resetResult != FileSystem::Success)
+    {
+        return resetResult;
+    }
+
+    m_io.write(DmaControl, DmaSoftReset);
+    m_io.write(DmaControl, DmaFixedBurst | DmaOn);
+    m_io.write(DescriptorBase, m_descriptorRange.phys);
+    m_io.write(BlockSize, blockSize);
+    m_io.write(ByteCount, bytes);
+
+    // Multiple block transfers are done once the stop command completed
+    m_transferDone = IntDataOver | (blocks > 1 ? (u32) IntAutoStopDone : 0U);
+    m_transferBytes = bytes;
+    m_transferWrite = write;
+
+    m_io.write(RawStatus, 0xffffffff);
+    m_io.write(InterruptMask, m_transferDone | IntErrors);
+    m_io.write(Argument, cmd.argument);
+    m_io.write(CommandRegister, commandFlags(cmd) | DataExpected |
+                                (write ? (u32) DataWrite : 0U) |
+                                (blocks > 1 ? (u32) AutoStop : 0U));
+    return FileSystem::Success;
+}
+
+FileSystem::Result SunxiSDHost::checkTransfer()
+{
+    const u32 status = m_io.read(RawStatus);
+
+    if (status & IntErrors)
+    {
+        ERROR("transfer failed: status = " << (void *) status <<
+              " dma = " << (void *) m_io.read(DmaStatus));
+
+        m_io.write(InterruptMask, 0);
+        m_io.write(RawStatus, 0xffffffff);
+        m_io.write(DmaStatus, 0xffffffff);
+        reset(FifoReset | DmaReset);
+        return FileSystem::IOError;
+    }
+
+    if ((status & m_transferDone) != m_transferDone)
+    {
+        return FileSystem::RetryAgain;
+    }
+
+    m_io.write(InterruptMask, 0);
+    m_io.write(RawStatus, 0xffffffff);
+    m_io.write(DmaStatus, 0xffffffff);
+
+    // Drop lines which were speculatively loaded during the transfer
+    if (!m_transferWrite)
+    {
+        Memory::Range range = m_buffer;
+        range.size = m_transferBytes;
+        VMCtl(SELF, CacheInvalidate, &range);
+    }
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result SunxiSDHost::reset(const u32 flags)
+{
+    m_io.set(GlobalControl, flags);
+
+    for (Size i = 0; i < MaximumPoll; i++)
+    {
+        if (!(m_io.read(GlobalControl) & flags))
+            return FileSystem::Success;
+    }
+
+    return FileSystem::TimedOut;
+}
+
+FileSystem::Result SunxiSDHost::updateClock()
+{
+    m_io.write(CommandRegister, CommandStart | UpdateClock | WaitPrevious);
+
+    for (Size i = 0; i < MaximumPoll; i++)
+    {
+        if (!(m_io.read(CommandRegister) & CommandStart))
+        {
+            m_io.write(RawStatus, 0xffffffff);
+            return FileSystem::Success;
+        }
+    }
+
+    ERROR("failed to update card clock");
+    return FileSystem::TimedOut;
+}
+
+FileSystem::Result SunxiSDHost::waitCardReady()
+{
+    for (Size i = 0; i < MaximumPoll; i++)
+    {
+        if (!(m_io.read(Status) & StatusCardBusy))
+            return FileSystem::Success;
+    }
+
+    ERROR("card remains busy");
+    return FileSystem::TimedOut;
+}
+
+u32 SunxiSDHost::commandFlags(const SDHost::Command & cmd) const
+{
+    u32 flags = CommandStart | WaitPrevious | cmd.index;
+
+    switch (cmd.type)
+    {
+        case ResponseNone:  break;
+        case ResponseNoCRC: flags |= ResponseExpected; break;
+        case ResponseLong:  flags |= ResponseExpected | LongResponse | CheckResponseCRC; break;
+        default:            flags |= ResponseExpected | CheckResponseCRC; break;
+    }
+
+    // The card needs 74 clock cycles before the first command
+    if (cmd.index == 0)
+        flags |= SendInitSequence;
+
+    return flags;
+}
@@ -0,0 +1,318 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __SERVER_SDMMC_SUNXISDHOST_H
+#define __SERVER_SDMMC_SUNXISDHOST_H
+
+#include <FreeNOS/System.h>
+#include <Types.h>
+#include <arm/sunxi/SunxiClockControl.h>
+#include "SDHost.h"
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup sdmmc
+ * @{
+ */
+
+/**
+ * Allwinner H3 SD/MMC host controller (SMHC).
+ *
+ * Data moves with the internal DMA controller (IDMAC), which follows a
+ * chain of descriptors over the pages of the transfer buffer. The pins
+ * of the card slot are configured by the bootloader.
+ */
+class SunxiSDHost : public SDHost
+{
+  private:
+
+    /** Physical base address of the first controller */
+    static const Address IOBase = 0x01C0F000;
+
+    /** Interrupt vector of the first controller */
+    static const Size InterruptNumber = 92;
+
+    /** Number of bytes transferred by a single DMA descriptor */
+    static const Size DescriptorBytes = PAGESIZE * 8;
+
+    /** Number of DMA descriptors */
+    static const Size DescriptorCount = BufferSize / DescriptorBytes;
+
+    /**
+     * Hardware registers
+     */
+    enum Registers
+    {
+        GlobalControl       = 0x00,
+        ClockControl        = 0x04,
+        Timeout             = 0x08,
+        BusWidth            = 0x0c,
+        BlockSize           = 0x10,
+        ByteCount           = 0x14,
+        CommandRegister     = 0x18,
+        Argument            = 0x1c,
+        Response0           = 0x20,
+        InterruptMask       = 0x30,
+        MaskedStatus        = 0x34,
+        RawStatus           = 0x38,
+        Status              = 0x3c,
+        FifoThreshold       = 0x40,
+        DmaControl          = 0x80,
+        DescriptorBase      = 0x84,
+        DmaStatus           = 0x88,
+        DmaInterruptEnable  = 0x8c
+    };
+
+    /**
+     * Global control register flags
+     */
+    enum GlobalControlFlags
+    {
+        SoftReset       = (1 << 0),
+        FifoReset       = (1 << 1),
+        DmaReset        = (1 << 2),
+        InterruptEnable = (1 << 4),
+        DmaEnable       = (1 << 5),
+        AccessByAHB     = (1 << 31)
+    };
+
+    /**
+     * Clock control register flags
+     */
+    enum ClockControlFlags
+    {
+        CardClockOn     = (1 << 16),
+        ClockDivider    = 0xff
+    };
+
+    /**
+     * Command register flags
+     */
+    enum CommandFlags
+    {
+        ResponseExpected = (1 << 6),
+        LongResponse     = (1 << 7),
+        CheckResponseCRC = (1 << 8),
+        DataExpected     = (1 << 9),
+        DataWrite        = (1 << 10),
+        AutoStop         = (1 << 12),
+        WaitPrevious     = (1 << 13),
+        SendInitSequence = (1 << 15),
+        UpdateClock      = (1 << 21),
+        CommandStart     = (1U << 31)
+    };
+
+    /**
+     * Interrupt status flags
+     */
+    enum InterruptFlags
+    {
+        IntResponseError   = (1 << 1),
+        IntCommandDone     = (1 << 2),
+        IntDataOver        = (1 << 3),
+        IntResponseCRC     = (1 << 6),
+        IntDataCRC         = (1 << 7),
+        IntResponseTimeout = (1 << 8),
+        IntDataTimeout     = (1 << 9),
+        IntFifoError       = (1 << 11),
+        IntHardwareLocked  = (1 << 12),
+        IntStartBitError   = (1 << 13),
+        IntAutoStopDone    = (1 << 14),
+        IntEndBitError     = (1 << 15),
+        IntErrors          = IntResponseError | IntResponseCRC | IntDataCRC |
+                             IntResponseTimeout | IntDataTimeout | IntFifoError |
+                             IntHardwareLocked | IntStartBitError | IntEndBitError
+    };
+
+    /**
+     * Status register flags
+     */
+    enum StatusFlags
+    {
+        StatusCardBusy  = (1 << 9)
+    };
+
+    /**
+     * DMA control register flags
+     */
+    enum DmaControlFlags
+    {
+        DmaSoftReset    = (1 << 0),
+        DmaFixedBurst   = (1 << 1),
+        DmaOn           = (1 << 7)
+    };
+
+    /**
+     * DMA descriptor
+     */
+    typedef struct Descriptor
+    {
+        u32 config;     /**< DescriptorFlags */
+        u32 size;       /**< Number of bytes in the buffer */
+        u32 buffer;     /**< Physical address of the buffer */
+        u32 next;       /**< Physical address of the next descriptor */
+    }
+    Descriptor;
+
+    /**
+     * DMA descriptor flags
+     */
+    enum DescriptorFlags
+    {
+        DescriptorNoInterrupt = (1 << 1),
+        DescriptorLast        = (1 << 2),
+        DescriptorFirst       = (1 << 3),
+        DescriptorChained     = (1 << 4),
+        DescriptorError       = (1 << 30),
+        DescriptorOwn         = (1U << 31)
+    };
+
+  public:
+
+    /**
+     * Constructor
+     */
+    SunxiSDHost();
+
+    /**
+     * Get the interrupt vector of the controller.
+     *
+     * @return Interrupt vector
+     */
+    virtual Size getInterrupt() const;
+
+    /**
+     * Reset the controller and select the identification clock and 1-bit bus.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result initialize();
+
+    /**
+     * Set the card clock.
+     *
+     * @param hertz Maximum clock rate in hertz
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result setClock(const Size hertz);
+
+    /**
+     * Set the data bus width.
+     *
+     * @param bits Number of data lines, either 1 or 4
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result setBusWidth(const Size bits);
+
+    /**
+     * Send a command without data and wait for its response.
+     *
+     * @param cmd Command to send, receives the response
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result command(Command & cmd);
+
+    /**
+     * Start a command which transfers data blocks.
+     *
+     * @param cmd Command to send
+     * @param blockSize Size of each block in bytes
+     * @param blocks Number of blocks
+     * @param write True to write to the card, false to read
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result startTransfer(Command & cmd,
+                                             const Size blockSize,
+                                             const Size blocks,
+                                             const bool write);
+
+    /**
+     * Process progress of the current transfer.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result checkTransfer();
+
+  private:
+
+    /**
+     * Reset parts of the controller.
+     *
+     * @param flags GlobalControlFlags of the parts to reset
+     *
+     * @return Result code
+     */
+    FileSystem::Result reset(const u32 flags);
+
+    /**
+     * Let the controller apply a new card clock setting.
+     *
+     * @return Result code
+     */
+    FileSystem::Result updateClock();
+
+    /**
+     * Wait until the card finished programming.
+     *
+     * @return Result code
+     */
+    FileSystem::Result waitCardReady();
+
+    /**
+     * Get the command register value for a command.
+     *
+     * @param cmd Command to send
+     *
+     * @return Command register value
+     */
+    u32 commandFlags(const Command & cmd) const;
+
+  private:
+
+    /** Memory I/O object */
+    Arch::IO m_io;
+
+    /** Clock Control Unit */
+    SunxiClockControl m_ccu;
+
+    /** Memory range of the DMA descriptors */
+    Memory::Range m_descriptorRange;
+
+    /** DMA descriptors */
+    volatile Descriptor *m_descriptors;
+
+    /** Interrupt flags which complete the current transfer */
+    u32 m_transferDone;
+
+    /** Number of bytes in the current transfer */
+    Size m_transferBytes;
+
+    /** True if the current transfer writes to the card */
+    bool m_transferWrite;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_SDMMC_SUNXISDHOST_H */
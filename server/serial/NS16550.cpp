@@ -66,8 +66,10 @@ FileSystem::Result NS16550::initialize()
     }
     else
     {
-        // Enable Rx/Tx interrupts and FIFOs
-        m_io.write(FifoControl, FifoControlTrigger1 | FifoControlEnable);
+        // Enable and clear the FIFOs, interrupt when the receive FIFO is half full.
+        // Transmit interrupts are enabled when data is queued.
+        m_io.write(FifoControl, FifoControlTriggerHalf | FifoControlEnable |
+                                FifoControlResetRx | FifoControlResetTx);
         m_io.write(InterruptEnable, ReceiveDataInterrupt);
         ProcessCtl(SELF, EnableIRQ, m_irq);
     }
@@ -75,75 +77,47 @@ FileSystem::Result NS16550::initialize()
     return FileSystem::Success;
 }
 
-FileSystem::Result NS16550::interrupt(const Size vector)
+bool NS16550::receiveByte(u8 & byte)
 {
-    // Mask interrupt until FIFOs are empty
-    m_io.write(InterruptEnable, 0);
-    return FileSystem::Success;
+    if (!(m_io.read(LineStatus) & LineStatusDataReady))
+        return false;
+
+    byte = m_io.read(ReceiveBuffer);
+    return true;
 }
 
-FileSystem::Result NS16550::read(IOBuffer & buffer,
-                                 Size & size,
-                                 const Size offset)
+Size NS16550::transmitRoom()
 {
-    Size bytes = 0;
+    // The kernel writes before the FIFOs are enabled
+    if (isKernel)
+        return (m_io.read(LineStatus) & LineStatusTxEmpty) ? 1 : 0;
 
-    // Read as much bytes as possible
-    while ((m_io.read(LineStatus) & LineStatusDataReady) && bytes < size)
-    {
-        u8 byte = m_io.read(ReceiveBuffer);
-        buffer.bufferedWrite(&byte, 1);
-        bytes++;
-    }
+    return TransmitFifoSize - m_io.read(TransmitFifoLvl);
+}
 
-    // Re-enable interrupts
-    if (!isKernel)
-    {
-        if (!(m_io.read(InterruptEnable) & ReceiveDataInterrupt))
-        {
-            m_io.write(InterruptEnable, ReceiveDataInterrupt);
-            ProcessCtl(SELF, EnableIRQ, m_irq);
-        }
-    }
+void NS16550::transmitByte(const u8 byte)
+{
+    m_io.write(TransmitHolding, byte);
+}
 
-    if (buffer.getCount())
-    {
-        size = buffer.getCount();
-        return FileSystem::Success;
-    }
-    else
-    {
-        return FileSystem::RetryAgain;
-    }
+void NS16550::setTransmitInterrupt(const bool enabled)
+{
+    m_io.write(InterruptEnable, enabled ? ReceiveDataInterrupt | TransmitEmptyInterrupt
+                                        : ReceiveDataInterrupt);
 }
 
-FileSystem::Result NS16550::write(IOBuffer & buffer,
-                                  Size & size,
-                                  const Size offset)
+bool NS16550::acknowledgeInterrupt()
 {
-    Size bytes = 0;
+    // Reading the identity clears a pending transmit interrupt
+    const u32 identity = m_io.read(InterruptIdentity) & InterruptIdentityMask;
 
-    // Write as much bytes as possible
-    while (bytes < size)
+    // Busy detect is cleared by reading the status
+    if (identity == InterruptIdentityBusy)
     {
-        // Wait until TX fifo is empty
-        while (!(m_io.read(LineStatus) & LineStatusTxEmpty))
-        {
-            ;
-        }
-
-        m_io.write(TransmitHolding, buffer[bytes++]);
+        m_io.read(UartStatus);
     }
 
-    if (bytes)
-    {
-        size = bytes;
-        return FileSystem::Success;
-    }
-    else
-    {
-        return FileSystem::RetryAgain;
-    }
+    return identity != InterruptIdentityNone;
 }
 
 void NS16550::setDivisorLatch(bool enabled)
@@ -60,20 +60,30 @@ class NS16550 : public SerialDevice
         TransmitFifoLvl   = 0x80
     };
 
+    /** Size of the transmit FIFO in bytes */
+    static const Size TransmitFifoSize = 64;
+
     enum InterruptEnableFlags
     {
-        ReceiveDataInterrupt = (1 << 0)
+        ReceiveDataInterrupt   = (1 << 0),
+        TransmitEmptyInterrupt = (1 << 1)
     };
 
     enum InterruptIdentityFlags
     {
-        InterruptIdentityFifoEnable = (0x3 << 6)
+        InterruptIdentityFifoEnable = (0x3 << 6),
+        InterruptIdentityMask       = (0xf),
+        InterruptIdentityNone       = (0x1),
+        InterruptIdentityBusy       = (0x7)
     };
 
     enum FifoControlFlags
     {
-        FifoControlTrigger1 = (0),
-        FifoControlEnable   = (1 << 0)
+        FifoControlTrigger1    = (0),
+        FifoControlTriggerHalf = (0x2 << 6),
+        FifoControlEnable      = (1 << 0),
+        FifoControlResetRx     = (1 << 1),
+        FifoControlResetTx     = (1 << 2)
     };
 
     enum LineControlFlags
@@ -109,42 +119,44 @@ class NS16550 : public SerialDevice
      */
     virtual FileSystem::Result initialize();
 
+  protected:
+
     /**
-     * Called when an interrupt has been triggered for this device.
+     * Read a byte from the receive FIFO.
      *
-     * @param vector Vector number of the interrupt.
+     * @param byte Receives the byte
      *
-     * @return Result code
+     * @return True if a byte was read, false if the FIFO is empty
      */
-    virtual FileSystem::Result interrupt(const Size vector);
+    virtual bool receiveByte(u8 & byte);
 
     /**
-     * Read bytes from the device
+     * Get the number of bytes the transmit FIFO accepts without waiting.
      *
-     * @param buffer Input/Output buffer to output bytes to.
-     * @param size Maximum number of bytes to read on input.
-     *             On output, the actual number of bytes read.
-     * @param offset Offset inside the file to start reading.
+     * @return Number of bytes, which may be less than the free space
+     */
+    virtual Size transmitRoom();
+
+    /**
+     * Write a byte to the transmit FIFO.
      *
-     * @return Result code
+     * @param byte Byte to transmit
      */
-    virtual FileSystem::Result read(IOBuffer & buffer,
-                                    Size & size,
-                                    const Size offset);
+    virtual void transmitByte(const u8 byte);
 
     /**
-     * Write bytes to the device
+     * Enable or disable the transmit interrupt.
      *
-     * @param buffer Input/Output buffer to input bytes from.
-     * @param size Maximum number of bytes to write on input.
-     *             On output, the actual number of bytes written.
-     * @param offset Offset inside the file to start writing.
+     * @param enabled True to enable, false to disable
+     */
+    virtual void setTransmitInterrupt(const bool enabled);
+
+    /**
+     * Acknowledge the interrupt sources of the UART.
      *
-     * @return Result code
+     * @return True if the UART still has an interrupt pending
      */
-    virtual FileSystem::Result write(IOBuffer & buffer,
-                                     Size & size,
-                                     const Size offset);
+    virtual bool acknowledgeInterrupt();
 
   private:
 
@@ -61,11 +61,11 @@ FileSystem::Result PL011::initialize()
     m_io.write(PL011_IBRD, 26);
     m_io.write(PL011_FBRD, 3);
 
-    // Disable FIFO, use 8 bit data transmission, 1 stop bit, no parity
-    m_io.write(PL011_LCRH, PL011_LCRH_WLEN_8BIT);
-
     if (isKernel)
     {
+        // Disable FIFO, use 8 bit data transmission, 1 stop bit, no parity
+        m_io.write(PL011_LCRH, PL011_LCRH_WLEN_8BIT);
+
         // Mask all interrupts.
         m_io.write(PL011_IMSC, (1 << 1) | (1 << 4) | (1 << 5) |
                                (1 << 6) | (1 << 7) | (1 << 8) |
@@ -73,8 +73,13 @@ FileSystem::Result PL011::initialize()
     }
     else
     {
-        // Enable Rx/Tx interrupts
-        m_io.write(PL011_IMSC, PL011_IMSC_RXIM);
+        // Enable FIFOs, use 8 bit data transmission, 1 stop bit, no parity
+        m_io.write(PL011_LCRH, PL011_LCRH_FEN | PL011_LCRH_WLEN_8BIT);
+
+        // Interrupt when the receive FIFO is half full or idle with data in it.
+        // Transmit interrupts are enabled when data is queued.
+        m_io.write(PL011_IFLS, PL011_IFLS_TX_QUARTER | PL011_IFLS_RX_HALF);
+        m_io.write(PL011_IMSC, PL011_IMSC_RXIM | PL011_IMSC_RTIM);
         ProcessCtl(SELF, EnableIRQ, m_irq);
     }
 
@@ -84,85 +89,37 @@ FileSystem::Result PL011::initialize()
     return FileSystem::Success;
 }
 
-FileSystem::Result PL011::interrupt(const Size vector)
+bool PL011::receiveByte(u8 & byte)
 {
-    // Clear Receive Interrupts
-    u32 mis = m_io.read(PL011_MIS);
-    if (mis & PL011_MIS_RXMIS)
-        m_io.write(PL011_ICR, PL011_ICR_RXIC);
-
-    // Clear Transmit Interrupts
-    mis = m_io.read(PL011_MIS);
-    if (mis & PL011_MIS_TXMIS)
-        m_io.write(PL011_ICR, PL011_ICR_TXIC);
-
-    // Re-enable interrupts
-    if (!isKernel)
-    {
-        ProcessCtl(SELF, EnableIRQ, m_irq);
-    }
+    if (m_io.read(PL011_FR) & PL011_FR_RXFE)
+        return false;
 
-    return FileSystem::Success;
+    byte = m_io.read(PL011_DR);
+    return true;
 }
 
-FileSystem::Result PL011::read(IOBuffer & buffer,
-                               Size & size,
-                               const Size offset)
+Size PL011::transmitRoom()
 {
-    Size bytes = 0;
-
-    // Clear Receive Interrupts
-    u32 mis = m_io.read(PL011_MIS);
-    if (mis & PL011_MIS_RXMIS)
-        m_io.write(PL011_ICR, PL011_ICR_RXIC);
-
-    // Read as much bytes as possible
-    while (!(m_io.read(PL011_FR) & PL011_FR_RXFE) && bytes < size)
-    {
-        //buffer[bytes++] = m_io.read(PL011_DR);
-        u8 byte = m_io.read(PL011_DR);
-        buffer.bufferedWrite(&byte, 1);
-        bytes++;
-    }
-
-    if (buffer.getCount())
-    {
-        size = buffer.getCount();
-        return FileSystem::Success;
-    }
-    else
-    {
-        return FileSystem::RetryAgain;
-    }
+    // The flags do not tell the FIFO level, only whether it is full
+    return (m_io.read(PL011_FR) & PL011_FR_TXFF) ? 0 : 1;
 }
 
-FileSystem::Result PL011::write(IOBuffer & buffer,
-                                Size & size,
-                                const Size offset)
+void PL011::transmitByte(const u8 byte)
 {
-    Size bytes = 0;
+    m_io.write(PL011_DR, byte);
+}
 
-    // Clear Transmit Interrupts
-    u32 mis = m_io.read(PL011_MIS);
-    if (mis & PL011_MIS_TXMIS)
-        m_io.write(PL011_ICR, PL011_ICR_TXIC);
+void PL011::setTransmitInterrupt(const bool enabled)
+{
+    m_io.write(PL011_IMSC, enabled ? PL011_IMSC_RXIM | PL011_IMSC_RTIM | PL011_IMSC_TXIM
+                                   : PL011_IMSC_RXIM | PL011_IMSC_RTIM);
+}
 
-    // Write as much bytes as possible
-    while (bytes < size)
-    {
-        if (m_io.read(PL011_FR) & PL011_FR_TXFE)
-        {
-            m_io.write(PL011_DR, buffer[bytes++]);
-        }
-    }
+bool PL011::acknowledgeInterrupt()
+{
+    // Interrupts only trigger again on the next FIFO level crossing
+    m_io.write(PL011_ICR, m_io.read(PL011_MIS));
 
-    if (bytes)
-    {
-        size = bytes;
-        return FileSystem::Success;
-    }
-    else
-    {
-        return FileSystem::RetryAgain;
-    }
+    // Collect data which arrived while servicing
+    return !(m_io.read(PL011_FR) & PL011_FR_RXFE);
 }
@@ -49,6 +49,7 @@ class PL011 : public SerialDevice
 
         PL011_FR        = (0x18),
         PL011_FR_RXFE   = (1 << 4),
+        PL011_FR_TXFF   = (1 << 5),
         PL011_FR_TXFE   = (1 << 7),
 
         PL011_ILPR      = (0x20),
@@ -56,14 +57,18 @@ class PL011 : public SerialDevice
         PL011_FBRD      = (0x28),
 
         PL011_LCRH      = (0x2C),
+        PL011_LCRH_FEN  = (1 << 4),
         PL011_LCRH_WLEN_8BIT = (0b11<<5),
 
         PL011_CR        = (0x30),
         PL011_IFLS      = (0x34),
+        PL011_IFLS_TX_QUARTER = (0b001 << 0),
+        PL011_IFLS_RX_HALF    = (0b010 << 3),
 
         PL011_IMSC      = (0x38),
         PL011_IMSC_RXIM = (1 << 4),
         PL011_IMSC_TXIM = (1 << 5),
+        PL011_IMSC_RTIM = (1 << 6),
 
         PL011_RIS       = (0x3C),
 
@@ -96,42 +101,44 @@ class PL011 : public SerialDevice
      */
     virtual FileSystem::Result initialize();
 
+  protected:
+
     /**
-     * Called when an interrupt has been triggered for this device.
+     * Read a byte from the receive FIFO.
      *
-     * @param vector Vector number of the interrupt.
+     * @param byte Receives the byte
      *
-     * @return Result code
+     * @return True if a byte was read, false if the FIFO is empty
      */
-    virtual FileSystem::Result interrupt(const Size vector);
+    virtual bool receiveByte(u8 & byte);
 
     /**
-     * Read bytes from the device
+     * Get the number of bytes the transmit FIFO accepts without waiting.
      *
-     * @param buffer Input/Output buffer to output bytes to.
-     * @param size Maximum number of bytes to read on input.
-     *             On output, the actual number of bytes read.
-     * @param offset Offset inside the file to start reading.
+     * @return Number of bytes, which may be less than the free space
+     */
+    virtual Size transmitRoom();
+
+    /**
+     * Write a byte to the transmit FIFO.
      *
-     * @return Result code
+     * @param byte Byte to transmit
      */
-    virtual FileSystem::Result read(IOBuffer & buffer,
-                                    Size & size,
-                                    const Size offset);
+    virtual void transmitByte(const u8 byte);
 
     /**
-     * Write bytes to the device
+     * Enable or disable the transmit interrupt.
      *
-     * @param buffer Input/Output buffer to input bytes from.
-     * @param size Maximum number of bytes to write on input.
-     *             On output, the actual number of bytes written.
-     * @param offset Offset inside the file to start writing.
+     * @param enabled True to enable, false to disable
+     */
+    virtual void setTransmitInterrupt(const bool enabled);
+
+    /**
+     * Acknowledge the interrupt sources of the UART.
      *
-     * @return Result code
+     * @return True if the UART still has an interrupt pending
      */
-    virtual FileSystem::Result write(IOBuffer & buffer,
-                                     Size & size,
-                                     const Size offset);
+    virtual bool acknowledgeInterrupt();
 };
 
 /**
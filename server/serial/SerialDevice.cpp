@@ -15,6 +15,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <FreeNOS/User.h>
 #include "SerialDevice.h"
 
 u32 SerialDevice::inodeNumber = 2;
@@ -30,3 +31,110 @@ u32 SerialDevice::getIrq() const
 {
     return m_irq;
 }
+
+FileSystem::Result SerialDevice::interrupt(const Size vector)
+{
+    // Empty and refill the FIFOs until the UART has no more work
+    do
+    {
+        receive();
+        transmit();
+    }
+    while (acknowledgeInterrupt());
+
+    if (!isKernel)
+    {
+        ProcessCtl(SELF, EnableIRQ, m_irq);
+    }
+    return FileSystem::Success;
+}
+
+FileSystem::Result SerialDevice::read(IOBuffer & buffer,
+                                      Size & size,
+                                      const Size offset)
+{
+    Size bytes = 0;
+
+    // Pick up bytes which arrived below the FIFO trigger level
+    receive();
+
+    while (m_receive.count() > 0 && bytes < size)
+    {
+        const u8 byte = m_receive.pop();
+        buffer.bufferedWrite(&byte, 1);
+        bytes++;
+    }
+
+    if (bytes)
+    {
+        size = bytes;
+        return FileSystem::Success;
+    }
+    else
+    {
+        return FileSystem::RetryAgain;
+    }
+}
+
+FileSystem::Result SerialDevice::write(IOBuffer & buffer,
+                                       Size & size,
+                                       const Size offset)
+{
+    Size bytes = 0;
+
+    // The kernel has no interrupts to wait for
+    if (isKernel)
+    {
+        while (bytes < size)
+        {
+            if (transmitRoom() > 0)
+                transmitByte(buffer[bytes++]);
+        }
+        return FileSystem::Success;
+    }
+
+    // Wait until the whole write fits, unless it is larger than the ring
+    if (m_transmit.count() > 0 && m_transmit.count() + size > TransmitBufferSize)
+    {
+        return FileSystem::RetryAgain;
+    }
+
+    while (bytes < size && m_transmit.push(buffer[bytes]))
+    {
+        bytes++;
+    }
+
+    transmit();
+    size = bytes;
+    return FileSystem::Success;
+}
+
+void SerialDevice::receive()
+{
+    u8 byte;
+
+    // Bytes which do not fit in the ring are dropped
+    while (receiveByte(byte))
+    {
+        m_receive.push(byte);
+    }
+}
+
+void SerialDevice::transmit()
+{
+    Size room = 0;
+
+    while (m_transmit.count() > 0)
+    {
+        if (room == 0 && (room = transmitRoom()) == 0)
+            break;
+
+        transmitByte(m_transmit.pop());
+        room--;
+    }
+
+    if (!isKernel)
+    {
+        setTransmitInterrupt(m_transmit.count() > 0);
+    }
+}
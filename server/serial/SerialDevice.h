@@ -22,6 +22,7 @@
 #include <Types.h>
 #include <Device.h>
 #include <Factory.h>
+#include <Queue.h>
 
 /**
  * @addtogroup server
@@ -33,10 +34,25 @@
 
 /**
  * Provides sequential byte stream of incoming (RX) and outgoing (TX) data.
+ *
+ * Outside the kernel, data is buffered in software rings. Each interrupt
+ * empties the receive FIFO of the UART into the receive ring and refills
+ * the transmit FIFO from the transmit ring. Writes return as soon as
+ * their data is queued. The transmit interrupt is only enabled while
+ * the transmit ring has data. Inside the kernel, writes wait for the
+ * UART to transmit all bytes.
  */
 class SerialDevice : public Device,
                      public AbstractFactory<SerialDevice>
 {
+  public:
+
+    /** Size of the transmit ring in bytes */
+    static const Size TransmitBufferSize = 4096;
+
+    /** Size of the receive ring in bytes */
+    static const Size ReceiveBufferSize = 1024;
+
   public:
 
     /**
@@ -53,9 +69,97 @@ class SerialDevice : public Device,
      */
     u32 getIrq() const;
 
+    /**
+     * Called when an interrupt has been triggered for this device.
+     *
+     * @param vector Vector number of the interrupt.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result interrupt(const Size vector);
+
+    /**
+     * Read bytes from the device
+     *
+     * @param buffer Input/Output buffer to output bytes to.
+     * @param size Maximum number of bytes to read on input.
+     *             On output, the actual number of bytes read.
+     * @param offset Offset inside the file to start reading.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result read(IOBuffer & buffer,
+                                    Size & size,
+                                    const Size offset);
+
+    /**
+     * Write bytes to the device
+     *
+     * @param buffer Input/Output buffer to input bytes from.
+     * @param size Maximum number of bytes to write on input.
+     *             On output, the actual number of bytes written.
+     * @param offset Offset inside the file to start writing.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result write(IOBuffer & buffer,
+                                     Size & size,
+                                     const Size offset);
+
     /** Keeps track of inode number for SerialDevices */
     static u32 inodeNumber;
 
+  protected:
+
+    /**
+     * Read a byte from the receive FIFO.
+     *
+     * @param byte Receives the byte
+     *
+     * @return True if a byte was read, false if the FIFO is empty
+     */
+    virtual bool receiveByte(u8 & byte) = 0;
+
+    /**
+     * Get the number of bytes the transmit FIFO accepts without waiting.
+     *
+     * @return Number of bytes, which may be less than the free space
+     */
+    virtual Size transmitRoom() = 0;
+
+    /**
+     * Write a byte to the transmit FIFO.
+     *
+     * @param byte Byte to transmit
+     */
+    virtual void transmitByte(const u8 byte) = 0;
+
+    /**
+     * Enable or disable the transmit interrupt.
+     *
+     * @param enabled True to enable, false to disable
+     */
+    virtual void setTransmitInterrupt(const bool enabled) = 0;
+
+    /**
+     * Acknowledge the interrupt sources of the UART.
+     *
+     * @return True if the UART still has an interrupt pending
+     */
+    virtual bool acknowledgeInterrupt() = 0;
+
+  private:
+
+    /**
+     * Move received bytes from the receive FIFO to the receive ring.
+     */
+    void receive();
+
+    /**
+     * Move bytes from the transmit ring to the transmit FIFO.
+     */
+    void transmit();
+
   protected:
 
     /** interrupt vector */
@@ -63,6 +167,14 @@ class SerialDevice : public Device,
 
     /** I/O instance */
     Arch::IO m_io;
+
+  private:
+
+    /** Bytes waiting to be transmitted */
+    Queue<u8, TransmitBufferSize> m_transmit;
+
+    /** Bytes received but not read yet */
+    Queue<u8, ReceiveBufferSize> m_receive;
 };
 
 /**
@@ -44,11 +44,11 @@ FileSystem::Result i8250::initialize()
     // 8bit Words, no parity
     m_io.outb(LINECONTROL, 3);
 
-    // Enable interrupts
-    m_io.outb(IRQCONTROL, 1);
+    // Receive interrupts. Transmit interrupts are enabled when data is queued
+    m_io.outb(IRQCONTROL, IRQRECEIVE);
 
-    // No FIFO
-    m_io.outb(FIFOCONTROL, 0);
+    // Enable and clear the FIFOs, interrupt at 8 received bytes
+    m_io.outb(FIFOCONTROL, FIFOENABLE);
 
     // Data Ready, Request to Send
     m_io.outb(MODEMCONTROL, 3);
@@ -69,57 +69,33 @@ FileSystem::Result i8250::initialize()
     return FileSystem::Success;
 }
 
-FileSystem::Result i8250::interrupt(const Size vector)
+bool i8250::receiveByte(u8 & byte)
 {
-    ProcessCtl(SELF, EnableIRQ, m_irq);
-    return FileSystem::Success;
+    if (!(m_io.inb(LINESTATUS) & RXREADY))
+        return false;
+
+    byte = m_io.inb(RECEIVE);
+    return true;
 }
 
-FileSystem::Result i8250::read(IOBuffer & buffer,
-                               Size & size,
-                               const Size offset)
+Size i8250::transmitRoom()
 {
-    Size bytes = 0;
-    u8 byte;
-
-    // Read as much bytes as possible
-    while (m_io.inb(LINESTATUS) & RXREADY && bytes < size)
-    {
-        byte = m_io.inb(RECEIVE);
-        buffer.bufferedWrite(&byte, 1);
-        bytes++;
-    }
-
-    if (bytes)
-    {
-        size = bytes;
-        return FileSystem::Success;
-    }
-    else
-    {
-        return FileSystem::RetryAgain;
-    }
+    // The transmit holding register is empty when the whole FIFO is
+    return (m_io.inb(LINESTATUS) & TXREADY) ? FIFOSIZE : 0;
 }
 
-FileSystem::Result i8250::write(IOBuffer & buffer,
-                                Size & size,
-                                const Size offset)
+void i8250::transmitByte(const u8 byte)
 {
-    Size bytes = 0;
+    m_io.outb(TRANSMIT, byte);
+}
 
-    // Write as much bytes as possible
-    while (m_io.inb(LINESTATUS) & TXREADY && bytes < size)
-    {
-        m_io.outb(TRANSMIT, buffer[bytes++]);
-    }
+void i8250::setTransmitInterrupt(const bool enabled)
+{
+    m_io.outb(IRQCONTROL, enabled ? IRQRECEIVE | IRQTRANSMIT : IRQRECEIVE);
+}
 
-    if (bytes)
-    {
-        size = bytes;
-        return FileSystem::Success;
-    }
-    else
-    {
-        return FileSystem::RetryAgain;
-    }
+bool i8250::acknowledgeInterrupt()
+{
+    // Reading the status clears a pending transmit interrupt
+    return !(m_io.inb(IRQSTATUS) & IRQNONE);
 }
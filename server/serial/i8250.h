@@ -32,6 +32,9 @@
 
 /**
  * i8250 serial UART.
+ *
+ * Assumes the 16 byte FIFOs of the 16550A, which every PC and emulator
+ * provides. The FIFO control register has no effect on an original i8250.
  */
 class i8250 : public SerialDevice
 {
@@ -56,6 +59,11 @@ class i8250 : public SerialDevice
         TXREADY      = 0x20,
         DLAB         = 0x80,
         BAUDRATE     = 9600,
+        FIFOSIZE     = 16,
+        FIFOENABLE   = 0x87,
+        IRQRECEIVE   = 0x1,
+        IRQTRANSMIT  = 0x2,
+        IRQNONE      = 0x1
     };
 
   public:
@@ -75,42 +83,44 @@ class i8250 : public SerialDevice
      */
     virtual FileSystem::Result initialize();
 
+  protected:
+
     /**
-     * Called when an interrupt has been triggered for this device.
+     * Read a byte from the receive FIFO.
      *
-     * @param vector Vector number of the interrupt.
+     * @param byte Receives the byte
      *
-     * @return Result code
+     * @return True if a byte was read, false if the FIFO is empty
      */
-    virtual FileSystem::Result interrupt(const Size vector);
+    virtual bool receiveByte(u8 & byte);
 
     /**
-     * Read bytes from the device
+     * Get the number of bytes the transmit FIFO accepts without waiting.
      *
-     * @param buffer Input/Output buffer to output bytes to.
-     * @param size Maximum number of bytes to read on input.
-     *             On output, the actual number of bytes read.
-     * @param offset Offset inside the file to start reading.
+     * @return Number of bytes, which may be less than the free space
+     */
+    virtual Size transmitRoom();
+
+    /**
+     * Write a byte to the transmit FIFO.
      *
-     * @return Result code
+     * @param byte Byte to transmit
      */
-    virtual FileSystem::Result read(IOBuffer & buffer,
-                                    Size & size,
-                                    const Size offset);
+    virtual void transmitByte(const u8 byte);
 
     /**
-     * Write bytes to the device
+     * Enable or disable the transmit interrupt.
      *
-     * @param buffer Input/Output buffer to input bytes from.
-     * @param size Maximum number of bytes to write on input.
-     *             On output, the actual number of bytes written.
-     * @param offset Offset inside the file to start writing.
+     * @param enabled True to enable, false to disable
+     */
+    virtual void setTransmitInterrupt(const bool enabled);
+
+    /**
+     * Acknowledge the interrupt sources of the UART.
      *
-     * @return Result code
+     * @return True if the UART still has an interrupt pending
      */
-    virtual FileSystem::Result write(IOBuffer & buffer,
-                                     Size & size,
-                                     const Size offset);
+    virtual bool acknowledgeInterrupt();
 };
 
 /**
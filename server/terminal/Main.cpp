@@ -34,7 +34,8 @@ int main(int argc, char **argv)
     DeviceServer server("/console");
     server.registerDevice(new Terminal(server.getNextInode(),
                                        "/dev/ps2/keyboard0",
-                                       "/dev/video/vga0"), "tty0");
+                                       "/dev/video/vga0",
+                                       "/dev/video/vga0scroll"), "tty0");
 
     // Initialize
     const FileSystem::Result result = server.initialize();
@@ -42,13 +42,19 @@ u8 tekenToVGA[] =
 Terminal::Terminal(const u32 inode,
                    const char *in,
                    const char *out,
+                   const char *scr,
                    const Size w,
                    const Size h)
     : Device(inode, FileSystem::CharacterDeviceFile)
     , inputFile(in)
     , outputFile(out)
+    , scrollFile(scr)
     , width(w)
     , height(h)
+    , dirtyBegin(h)
+    , dirtyEnd(0)
+    , pendingScroll(0)
+    , scroll(-1)
 {
     m_identifier << "tty0";
     buffer = new u16[width * height];
@@ -78,10 +84,21 @@ FileSystem::Result Terminal::initialize()
         return FileSystem::IOError;
     }
 
+    // Scrolling the output device is optional
+    if (scrollFile != ZERO)
+    {
+        scroll = ::open(scrollFile, O_WRONLY);
+    }
+
+    // The local buffer starts with the current screen and
+    // is kept up-to-date by the terminal callbacks from now on
+    ::read(output, this->buffer, width * height * 2);
+
     // Fill in function pointers
     funcs.tf_bell    = (tf_bell_t *)    bell;
     funcs.tf_cursor  = (tf_cursor_t *)  cursor;
     funcs.tf_putchar = (tf_putchar_t *) putchar;
+    funcs.tf_putstr  = (tf_putstr_t *)  putstr;
     funcs.tf_fill    = (tf_fill_t *)    fill;
     funcs.tf_copy    = (tf_copy_t *)    copy;
     funcs.tf_param   = (tf_param_t *)   param;
@@ -110,6 +127,9 @@ Terminal::~Terminal()
     delete buffer;
     ::close(input);
     ::close(output);
+
+    if (scroll >= 0)
+        ::close(scroll);
 }
 
 Size Terminal::getWidth()
@@ -173,32 +193,76 @@ FileSystem::Result Terminal::write(IOBuffer & buffer,
 FileSystem::Result Terminal::writeTerminal(const u8 *bytes,
                                            const Size size)
 {
-    char cr = '\r', ch;
+    char cr = '\r';
+    Size start = 0;
 
-    // Initialize buffer with the current screen first
-    ::lseek(output, 0, SEEK_SET);
-    ::read(output, this->buffer, width * height * 2);
-
-    // Loop all input characters. Add an additional carriage return
-    // whenever a linefeed is detected.
+    // Pass the input in runs up to each linefeed, which
+    // is preceded by an additional carriage return.
     for (Size i = 0; i < size; i++)
     {
         if (bytes[i] == '\n')
         {
+            teken_input(&state, bytes + start, i - start);
             teken_input(&state, &cr, 1);
+            start = i;
         }
-        ch = bytes[i];
-        teken_input(&state, &ch, 1);
     }
+    teken_input(&state, bytes + start, size - start);
 
     // Flush changes back to our output device
-    ::lseek(output, 0, SEEK_SET);
-    ::write(output, this->buffer, width * height * 2);
+    flush();
 
     // Done
     return FileSystem::Success;
 }
 
+void Terminal::markDirty(const Size firstRow, const Size lastRow)
+{
+    if (firstRow < dirtyBegin)
+        dirtyBegin = firstRow;
+
+    if (lastRow + 1 > dirtyEnd)
+        dirtyEnd = lastRow + 1;
+}
+
+bool Terminal::scrollOutput(const Size rows)
+{
+    if (scroll < 0)
+        return false;
+
+    // Rows which were not flushed yet move up as well
+    dirtyBegin = dirtyBegin > rows ? dirtyBegin - rows : 0;
+    dirtyEnd   = dirtyEnd > rows ? dirtyEnd - rows : 0;
+    markDirty(rows < height ? height - rows : 0, height - 1);
+
+    pendingScroll += rows;
+    return true;
+}
+
+void Terminal::flush()
+{
+    if (pendingScroll != 0)
+    {
+        const u32 rows = pendingScroll;
+        pendingScroll = 0;
+
+        // Rewrite the whole screen if the output device did not scroll
+        if (::write(scroll, &rows, sizeof(rows)) != sizeof(rows))
+            markDirty(0, height - 1);
+    }
+
+    if (dirtyBegin >= dirtyEnd)
+        return;
+
+    // Only write the changed rows
+    ::lseek(output, dirtyBegin * width * sizeof(u16), SEEK_SET);
+    ::write(output, this->buffer + (dirtyBegin * width),
+            (dirtyEnd - dirtyBegin) * width * sizeof(u16));
+
+    dirtyBegin = height;
+    dirtyEnd   = 0;
+}
+
 void Terminal::hideCursor()
 {
     u16 index = cursorPos.tp_col + (cursorPos.tp_row * width);
@@ -206,6 +270,7 @@ void Terminal::hideCursor()
     // Restore old attributes
     buffer[index] &= 0xff;
     buffer[index] |= (cursorValue & 0xff00);
+    markDirty(cursorPos.tp_row, cursorPos.tp_row);
 }
 
 void Terminal::setCursor(const teken_pos_t *pos)
@@ -225,6 +290,7 @@ void Terminal::showCursor()
     // Write cursor
     buffer[index] &= 0xff;
     buffer[index] |= VGA_ATTR(LIGHTGREY, LIGHTGREY) << 8;
+    markDirty(cursorPos.tp_row, cursorPos.tp_row);
 }
 
 void bell(Terminal *term)
@@ -245,6 +311,26 @@ void putchar(Terminal *term, const teken_pos_t *pos,
     // Write the buffer
     buffer[pos->tp_col + (pos->tp_row * width)] =
         VGA_CHAR(ch, tekenToVGA[attr->ta_fgcolor], BLACK);
+    term->markDirty(pos->tp_row, pos->tp_row);
+
+    // Show cursor again
+    term->showCursor();
+}
+
+void putstr(Terminal *term, const teken_pos_t *pos,
+            const char *str, size_t len, const teken_attr_t *attr)
+{
+    u16 *buffer = term->getBuffer() + pos->tp_col + (pos->tp_row * term->getWidth());
+    const u16 vgaAttr = VGA_CHAR(0, tekenToVGA[attr->ta_fgcolor], BLACK);
+
+    // Make sure to don't overwrite cursor
+    term->hideCursor();
+
+    for (Size i = 0; i < len; i++)
+    {
+        buffer[i] = vgaAttr | (u8) str[i];
+    }
+    term->markDirty(pos->tp_row, pos->tp_row);
 
     // Show cursor again
     term->showCursor();
@@ -275,6 +361,10 @@ void fill(Terminal *term, const teken_rect_t *rect,
                 VGA_CHAR(ch, tekenToVGA[attr->ta_fgcolor], BLACK);
         }
     }
+
+    if (rect->tr_end.tp_row > rect->tr_begin.tp_row)
+        term->markDirty(rect->tr_begin.tp_row, rect->tr_end.tp_row - 1);
+
     // Show cursor again
     term->showCursor();
 }
@@ -293,10 +383,26 @@ void copy(Terminal *term, const teken_rect_t *rect,
     // Hide cursor first
     term->hideCursor();
 
-    // Copy video memory
-    memcpy(buffer + pos->tp_col + (pos->tp_row * width),
-           buffer + rect->tr_begin.tp_col + (rect->tr_begin.tp_row * width),
-           numCols + (numRows * width) * sizeof(u16));
+    // Copy video memory one row at a time. Start at the bottom
+    // when moving down, such that overlapping rows are not overwritten.
+    for (Size i = 0; i < numRows; i++)
+    {
+        Size row = pos->tp_row > rect->tr_begin.tp_row ? numRows - 1 - i : i;
+
+        memmove(buffer + pos->tp_col + ((pos->tp_row + row) * width),
+                buffer + rect->tr_begin.tp_col + ((rect->tr_begin.tp_row + row) * width),
+                numCols * sizeof(u16));
+    }
+
+    // Scrolling the whole screen up only writes the new rows
+    const bool scrolled = pos->tp_row == 0 && pos->tp_col == 0 &&
+                          rect->tr_begin.tp_row > 0 &&
+                          rect->tr_begin.tp_col == 0 && numCols == width &&
+                          rect->tr_end.tp_row == term->getHeight() &&
+                          term->scrollOutput(rect->tr_begin.tp_row);
+
+    if (!scrolled && numRows > 0)
+        term->markDirty(pos->tp_row, pos->tp_row + numRows - 1);
 
     // Show cursor again
     term->showCursor();
@@ -52,12 +52,15 @@ class Terminal : public Device
      * @param inputFile Path to the (device) file to use as input source.
      * @param outputFile Path to the (device) file to use as
      *                   an output source.
+     * @param scrollFile Path to the (device) file which scrolls the
+     *                   output source, or ZERO if not available.
      * @param width Width of the Terminal.
      * @param height Height of the Terminal.
      */
     Terminal(const u32 inode,
              const char *inputFile,
              const char *outputFile,
+             const char *scrollFile,
              const Size width = 80,
              const Size height = 25);
 
@@ -125,6 +128,26 @@ class Terminal : public Device
      */
     void showCursor();
 
+    /**
+     * Mark rows of the local buffer as changed.
+     *
+     * @param firstRow First changed row.
+     * @param lastRow Last changed row.
+     */
+    void markDirty(const Size firstRow, const Size lastRow);
+
+    /**
+     * Scroll the output device up with the local buffer.
+     *
+     * The local buffer must already be scrolled. The output device
+     * scrolls on the next flush, after which only the new rows are written.
+     *
+     * @param rows Number of rows scrolled.
+     *
+     * @return True if the output device can scroll, false otherwise.
+     */
+    bool scrollOutput(const Size rows);
+
     /**
      * Initialize the Terminal.
      *
@@ -173,6 +196,11 @@ class Terminal : public Device
     FileSystem::Result writeTerminal(const u8 *bytes,
                                      const Size size);
 
+    /**
+     * Write the changed rows of the local buffer to the output device.
+     */
+    void flush();
+
   private:
 
     /** Terminal state. */
@@ -193,15 +221,21 @@ class Terminal : public Device
     /**
      * @brief Path to the input and output files.
      */
-    const char *inputFile, *outputFile;
+    const char *inputFile, *outputFile, *scrollFile;
 
     /**
      * @brief Width and height of the Terminal.
      */
     const Size width, height;
 
-    /** Input and output file descriptors. */
-    int input, output;
+    /** Rows of the local buffer changed since the last flush. */
+    Size dirtyBegin, dirtyEnd;
+
+    /** Rows to scroll the output device up on the next flush. */
+    Size pendingScroll;
+
+    /** Input, output and scroll file descriptors. */
+    int input, output, scroll;
 };
 
 /**
@@ -222,6 +256,18 @@ void bell(Terminal *term);
 void putchar(Terminal *term, const teken_pos_t *pos,
          teken_char_t ch, const teken_attr_t *attr);
 
+/**
+ * Output a run of characters on a single row.
+ *
+ * @param term Terminal object pointer.
+ * @param pos Terminal position of the first character.
+ * @param str Characters to output.
+ * @param len Number of characters.
+ * @param attr Attributes for the characters.
+ */
+void putstr(Terminal *term, const teken_pos_t *pos,
+            const char *str, size_t len, const teken_attr_t *attr);
+
 /**
  * Sets the Terminal cursor.
  *
@@ -18,13 +18,16 @@
 #include <KernelLog.h>
 #include <DeviceServer.h>
 #include "VGA.h"
+#include "VGAScroll.h"
 
 int main(int argc, char **argv)
 {
     KernelLog log;
     DeviceServer server("/dev/video");
 
-    server.registerDevice(new VGA(server.getNextInode()), "vga0");
+    VGA *vga = new VGA(server.getNextInode());
+    server.registerDevice(vga, "vga0");
+    server.registerDevice(new VGAScroll(server.getNextInode(), *vga), "vga0scroll");
 
     // Initialize
     const FileSystem::Result result = server.initialize();
@@ -24,6 +24,7 @@ VGA::VGA(const u32 inode,
          const Size w,
          const Size h)
     : Device(inode, FileSystem::BlockDeviceFile)
+    , start(0)
     , width(w)
     , height(h)
 {
@@ -35,7 +36,7 @@ FileSystem::Result VGA::initialize()
     Memory::Range range;
 
     // Request VGA memory
-    range.size   = PAGESIZE;
+    range.size   = VGA_MEMSIZE;
     range.access = Memory::User     |
                    Memory::Readable |
                    Memory::Writable;
@@ -47,10 +48,8 @@ FileSystem::Result VGA::initialize()
     vga = (u16 *) range.virt;
 
     // Clear screen
-    for (uint i = 0; i < width * height; i++)
-    {
-        vga[i] = VGA_CHAR(' ', LIGHTGREY, BLACK);
-    }
+    clear(0, width * height);
+    setStart();
 
     // Disable hardware cursor
     m_io.outb(VGA_IOADDR, 0x0a);
@@ -69,7 +68,7 @@ FileSystem::Result VGA::read(IOBuffer & buffer,
         return FileSystem::InvalidArgument;
     }
 
-    buffer.write(vga + (offset / sizeof(u16)), size);
+    buffer.write(vga + start + (offset / sizeof(u16)), size);
     return FileSystem::Success;
 }
 
@@ -82,6 +81,53 @@ FileSystem::Result VGA::write(IOBuffer & buffer,
         return FileSystem::InvalidArgument;
     }
 
-    MemoryBlock::copy(vga + (offset / sizeof(u16)), buffer.getBuffer(), size);
+    MemoryBlock::copy(vga + start + (offset / sizeof(u16)), buffer.getBuffer(), size);
+    return FileSystem::Success;
+}
+
+FileSystem::Result VGA::scroll(const Size rows)
+{
+    const Size memoryChars = VGA_MEMSIZE / sizeof(u16);
+    const Size screenChars = width * height;
+
+    if (rows >= height)
+    {
+        clear(0, screenChars);
+        return FileSystem::Success;
+    }
+
+    const Size moved = (height - rows) * width;
+    const Size next = start + (rows * width);
+
+    // Move the remaining rows back to the start of video memory
+    // if the screen no longer fits behind the current one
+    if (next + screenChars > memoryChars)
+    {
+        MemoryBlock::copy(vga, vga + next, moved * sizeof(u16));
+        start = 0;
+    }
+    else
+    {
+        start = next;
+    }
+
+    clear(moved, screenChars - moved);
+    setStart();
     return FileSystem::Success;
 }
+
+void VGA::clear(const Size first, const Size count)
+{
+    for (Size i = first; i < first + count; i++)
+    {
+        vga[start + i] = VGA_CHAR(' ', LIGHTGREY, BLACK);
+    }
+}
+
+void VGA::setStart()
+{
+    m_io.outb(VGA_IOADDR, VGA_START_HIGH);
+    m_io.outb(VGA_IODATA, (start >> 8) & 0xff);
+    m_io.outb(VGA_IOADDR, VGA_START_LOW);
+    m_io.outb(VGA_IODATA, start & 0xff);
+}
@@ -39,6 +39,15 @@
 /** VGA I/O data port. */
 #define VGA_IODATA 0x3d5
 
+/** Size of the VGA text mode video memory in bytes. */
+#define VGA_MEMSIZE (32 * 1024)
+
+/** CRT controller register with the high byte of the screen start address. */
+#define VGA_START_HIGH 0x0c
+
+/** CRT controller register with the low byte of the screen start address. */
+#define VGA_START_LOW 0x0d
+
 /**
  * Encodes VGA attributes.
  *
@@ -89,6 +98,11 @@ enum Colors
  * Currently the Terminal driver uses the /dev/vga device file to implement
  * the system console in FreeNOS.
  *
+ * The screen is a window in the video memory, which moves down when
+ * scrolling by changing its start address in the CRT controller. Only
+ * when the window reaches the end of video memory the screen is copied
+ * back to the start.
+ *
  * @see Terminal
  */
 class VGA : public Device
@@ -145,11 +159,40 @@ class VGA : public Device
                                      Size & size,
                                      const Size offset);
 
+    /**
+     * Scroll the screen up.
+     *
+     * The new rows at the bottom of the screen are cleared.
+     *
+     * @param rows Number of rows to scroll
+     *
+     * @return Result code
+     */
+    FileSystem::Result scroll(const Size rows);
+
+  private:
+
+    /**
+     * Clear characters on the screen.
+     *
+     * @param first Index of the first character on the screen
+     * @param count Number of characters to clear
+     */
+    void clear(const Size first, const Size count);
+
+    /**
+     * Program the screen start address in the CRT controller.
+     */
+    void setStart();
+
   private:
 
     /** @brief VGA video memory address. */
     u16 *vga;
 
+    /** Index of the first character of the screen in video memory. */
+    Size start;
+
     /** @brief Number of characters horizontally. */
     Size width;
 
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include "VGA.h"
+#include "VGAScroll.h"
+
+VGAScroll::VGAScroll(const u32 inode, VGA & vga)
+    : Device(inode, FileSystem::CharacterDeviceFile)
+    , m_vga(vga)
+{
+    m_identifier << "vga0scroll";
+}
+
+FileSystem::Result VGAScroll::write(IOBuffer & buffer,
+                                    Size & size,
+                                    const Size offset)
+{
+    u32 rows;
+
+    if (size != sizeof(rows))
+    {
+        return FileSystem::InvalidArgument;
+    }
+
+    MemoryBlock::copy(&rows, buffer.getBuffer(), sizeof(rows));
+    return m_vga.scroll(rows);
+}
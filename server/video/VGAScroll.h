@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVER_VIDEO_VGASCROLL_H
+#define __SERVER_VIDEO_VGASCROLL_H
+
+#include <Device.h>
+#include <Types.h>
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup video
+ * @{
+ */
+
+class VGA;
+
+/**
+ * Scroll control file of a VGA device.
+ *
+ * Writing a u32 with a number of rows to the file scrolls the screen
+ * up by that many rows, without rewriting the screen contents.
+ *
+ * @see VGA
+ */
+class VGAScroll : public Device
+{
+  public:
+
+    /**
+     * Constructor function.
+     *
+     * @param inode Inode number
+     * @param vga VGA device to scroll
+     */
+    VGAScroll(const u32 inode, VGA & vga);
+
+    /**
+     * Scroll the screen.
+     *
+     * @param buffer Input/Output buffer with the number of rows as u32.
+     * @param size Number of bytes to write.
+     * @param offset Offset inside the file to start writing.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result write(IOBuffer & buffer,
+                                     Size & size,
+                                     const Size offset);
+
+  private:
+
+    /** VGA device to scroll */
+    VGA & m_vga;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __SERVER_VIDEO_VGASCROLL_H */
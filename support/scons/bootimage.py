@@ -61,6 +61,7 @@ def boot_image_func(target, source, env):
 
     img_cmd = "'" + build.host['BUILDROOT'] + "/bin/img/img' '" \
                   + "--prefix=" + env['BUILDROOT'] + "' '" \
+                  + ("--compress' '" if env.get('BOOTIMAGE_COMPRESS', False) else "") \
                   + str(source[0]) + "' '" \
                   + str(target[0]) + "'"
 
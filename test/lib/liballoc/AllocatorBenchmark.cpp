@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/Constant.h>
+#include <BenchmarkMain.h>
+#include <Benchmark.h>
+#include <Assert.h>
+#include <MemoryBlock.h>
+#include <PoolAllocator.h>
+#include <BitAllocator.h>
+
+/** Number of objects allocated at the same time */
+#define OBJECTS 64
+
+/**
+ * Simple wrapper around the default new/delete operators.
+ */
+class DummyParent : public Allocator
+{
+    virtual Result allocate(Range & args)
+    {
+        u8 *buf = new u8[args.size];
+        assert(buf != ZERO);
+        MemoryBlock::set(buf, 0, args.size);
+        args.address = (Address) buf;
+        return args.address != ZERO ? Success : OutOfMemory;
+    }
+
+    virtual Result release(const Address addr)
+    {
+        delete[] (u8 *) addr;
+        return Success;
+    }
+};
+
+/**
+ * Allocate and release batches of objects of the given size.
+ */
+static void poolAllocate(const Size iterations, const Size objectSize)
+{
+    DummyParent parent;
+    PoolAllocator pool(&parent);
+    Address objects[OBJECTS];
+
+    for (Size i = 0; i < iterations; i++)
+    {
+        Allocator::Range range = { 0, objectSize, 0 };
+
+        pool.allocate(range);
+        objects[i % OBJECTS] = range.address;
+
+        if (i % OBJECTS == OBJECTS - 1)
+        {
+            for (Size j = 0; j < OBJECTS; j++)
+                pool.release(objects[j]);
+        }
+    }
+
+    for (Size i = 0; i < iterations % OBJECTS; i++)
+        pool.release(objects[i]);
+}
+
+BenchmarkCase(PoolAllocateSmall)
+{
+    poolAllocate(iterations, 32);
+}
+
+BenchmarkCase(PoolAllocateLarge)
+{
+    poolAllocate(iterations, 2048);
+}
+
+BenchmarkCase(BitAllocate)
+{
+    const Size chunkSize = PAGESIZE;
+    const Allocator::Range range = { 0x100000, chunkSize * OBJECTS * 4, sizeof(u32) };
+    BitAllocator bits(range, chunkSize);
+    Address objects[OBJECTS];
+
+    for (Size i = 0; i < iterations; i++)
+    {
+        Allocator::Range args = { 0, chunkSize, chunkSize };
+
+        bits.allocate(args);
+        objects[i % OBJECTS] = args.address;
+
+        if (i % OBJECTS == OBJECTS - 1)
+        {
+            for (Size j = 0; j < OBJECTS; j++)
+                bits.release(objects[j]);
+        }
+    }
+    benchmarkUse(bits.available());
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <Assert.h>
+#include <ArenaAllocator.h>
+
+/**
+ * Parent which allocates from the host and counts the chunks in use.
+ */
+class ChunkParent : public Allocator
+{
+  public:
+
+    ChunkParent() : chunks(0) {}
+
+    virtual Result allocate(Range & args)
+    {
+        u8 *buf = new u8[args.size];
+        assert(buf != ZERO);
+        args.address = (Address) buf;
+        chunks++;
+        return Success;
+    }
+
+    virtual Result release(const Address addr)
+    {
+        delete[] (u8 *) addr;
+        chunks--;
+        return Success;
+    }
+
+    Size chunks;
+};
+
+TestCase(ArenaConstruct)
+{
+    ChunkParent parent;
+    ArenaAllocator arena(&parent, 1024);
+
+    // No chunks are allocated until needed
+    testAssert(arena.parent() == &parent);
+    testAssert(arena.m_chunk == ZERO);
+    testAssert(arena.size() == 0);
+    testAssert(arena.available() == 0);
+    testAssert(parent.chunks == 0);
+    return OK;
+}
+
+TestCase(ArenaAllocate)
+{
+    ChunkParent parent;
+    ArenaAllocator arena(&parent, 1024);
+    Allocator::Range args = { 0, 100, 0 };
+    Address prev;
+
+    // First allocation starts a chunk
+    testAssert(arena.allocate(args) == Allocator::Success);
+    testAssert((args.address % sizeof(u64)) == 0);
+    testAssert(parent.chunks == 1);
+    testAssert(arena.size() == 1024);
+    prev = args.address;
+
+    // Next allocations follow directly, aligned
+    args.size = 3;
+    testAssert(arena.allocate(args) == Allocator::Success);
+    testAssert(args.address == prev + 104);
+    prev = args.address;
+
+    args.size = 8;
+    args.alignment = 64;
+    testAssert(arena.allocate(args) == Allocator::Success);
+    testAssert(args.address > prev);
+    testAssert((args.address % 64) == 0);
+    testAssert(parent.chunks == 1);
+
+    // Allocations larger than a chunk get their own chunk
+    args.size = 4000;
+    args.alignment = 0;
+    testAssert(arena.allocate(args) == Allocator::Success);
+    testAssert(parent.chunks == 2);
+    testAssert(arena.size() > 1024 + 4000);
+
+    // Releasing single allocations has no effect
+    testAssert(arena.release(args.address) == Allocator::Success);
+    testAssert(parent.chunks == 2);
+    return OK;
+}
+
+TestCase(ArenaReset)
+{
+    ChunkParent parent;
+    Allocator::Range args = { 0, 400, 0 };
+
+    {
+        ArenaAllocator arena(&parent, 1024);
+        ArenaAllocator::Mark start;
+
+        testAssert(arena.allocate(args) == Allocator::Success);
+        const Address first = args.address;
+        start = arena.mark();
+
+        // Fill a few more chunks, which hold two allocations each
+        for (Size i = 0; i < 5; i++)
+            testAssert(arena.allocate(args) == Allocator::Success);
+        testAssert(parent.chunks == 3);
+
+        // Resetting to the mark returns the later chunks
+        arena.reset(start);
+        testAssert(parent.chunks == 1);
+        testAssert(arena.size() == 1024);
+        testAssert(arena.allocate(args) == Allocator::Success);
+        testAssert(args.address > first);
+
+        // Full reset keeps only the first chunk
+        testAssert(arena.allocate(args) == Allocator::Success);
+        testAssert(parent.chunks == 2);
+        arena.reset();
+        testAssert(parent.chunks == 1);
+        testAssert(arena.allocate(args) == Allocator::Success);
+        testAssert(args.address == first);
+    }
+
+    // Destruction returns all chunks
+    testAssert(parent.chunks == 0);
+    return OK;
+}
+
+TestCase(ArenaScope)
+{
+    ChunkParent parent;
+    ArenaAllocator arena(&parent, 1024);
+    Allocator *previous = Allocator::getDefault();
+    Allocator::Range args = { 0, 600, 0 };
+
+    {
+        ArenaAllocator::Scope outer(&arena, true);
+        testAssert(Allocator::getDefault() == &arena);
+        testAssert(arena.allocate(args) == Allocator::Success);
+
+        {
+            // Nested scopes release only their own allocations
+            ArenaAllocator::Scope inner(&arena);
+            testAssert(arena.allocate(args) == Allocator::Success);
+            testAssert(arena.allocate(args) == Allocator::Success);
+            testAssert(parent.chunks == 3);
+        }
+        testAssert(parent.chunks == 1);
+        testAssert(Allocator::getDefault() == &arena);
+    }
+
+    // The default allocator is restored
+    testAssert(Allocator::getDefault() == previous);
+    testAssert(arena.m_offset == 0);
+    testAssert(parent.chunks == 0);
+    return OK;
+}
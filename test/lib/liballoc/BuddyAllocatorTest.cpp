@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/Constant.h>
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <BuddyAllocator.h>
+
+TestCase(BuddyConstruct)
+{
+    TestInt<uint> addresses(UINT_MIN, UINT_MAX / 2);
+
+    const Size chunkSize = PAGESIZE;
+    const Size rangeSize = chunkSize * 1029;
+    const Address allocBase = addresses.random() & PAGEMASK;
+    const Allocator::Range range = { allocBase, rangeSize, sizeof(u32) };
+
+    BuddyAllocator ba(range, chunkSize);
+
+    // Verify initial state of the object
+    testAssert(ba.chunkSize() == chunkSize);
+    testAssert(ba.available() == rangeSize);
+    testAssert(ba.base() == allocBase);
+    testAssert(ba.size() == rangeSize);
+    testAssert(!ba.isAllocated(allocBase));
+
+    // The range is divided in the largest aligned blocks: 1024 + 4 + 1
+    testAssert(ba.freeBlocks(BuddyAllocator::MaximumOrder) == 1);
+    testAssert(ba.freeBlocks(2) == 1);
+    testAssert(ba.freeBlocks(0) == 1);
+    testAssert(ba.freeBlocks(1) == 0);
+
+    return OK;
+}
+
+TestCase(BuddyAllocateChunks)
+{
+    TestInt<uint> addresses(UINT_MIN, UINT_MAX / 2);
+
+    const Size chunkSize = 32;
+    const Size rangeSize = chunkSize * 64;
+    const Address allocBase = addresses.random() & PAGEMASK;
+    const Allocator::Range range = { allocBase, rangeSize, sizeof(u32) };
+
+    BuddyAllocator ba(range, chunkSize);
+
+    // Allocate ten chunks. The buddy halves are used in ascending order.
+    for (Size i = 0; i < 10; i++)
+    {
+        Allocator::Range args = { 0, chunkSize, 0 };
+
+        testAssert(ba.allocate(args) == Allocator::Success);
+        testAssert(args.address == allocBase + (chunkSize * i));
+        testAssert(ba.isAllocated(allocBase + (chunkSize * i)));
+    }
+
+    // The ten chunks are allocated, the rest is free
+    for (Size i = 0; i < rangeSize; i += chunkSize)
+    {
+        testAssert(ba.isAllocated(allocBase + i) == (i < (chunkSize * 10)));
+    }
+
+    testAssert(ba.available() == rangeSize - (chunkSize * 10));
+    return OK;
+}
+
+TestCase(BuddyAllocateContiguous)
+{
+    TestInt<uint> addresses(UINT_MIN, UINT_MAX / 2);
+
+    const Size chunkSize = 32;
+    const Size rangeSize = chunkSize * 64;
+    const Address allocBase = addresses.random() & PAGEMASK;
+    const Allocator::Range range = { allocBase, rangeSize, sizeof(u32) };
+
+    BuddyAllocator ba(range, chunkSize);
+    Allocator::Range args = { 0, chunkSize * 5, 0 };
+
+    // Five chunks use an eight chunk block. The tail of three is returned.
+    testAssert(ba.allocate(args) == Allocator::Success);
+    testAssert(args.address == allocBase);
+    testAssert(ba.available() == rangeSize - (chunkSize * 5));
+
+    for (Size i = 0; i < 8; i++)
+    {
+        testAssert(ba.isAllocated(allocBase + (chunkSize * i)) == (i < 5));
+    }
+
+    // Release the chunks one-by-one. All blocks coalesce again.
+    for (Size i = 0; i < 5; i++)
+    {
+        testAssert(ba.release(allocBase + (chunkSize * i)) == Allocator::Success);
+    }
+
+    testAssert(ba.available() == rangeSize);
+    testAssert(ba.freeBlocks(6) == 1);
+    testAssert(ba.freeBlocks(0) == 0);
+
+    // Releasing a free chunk fails
+    testAssert(ba.release(allocBase) == Allocator::InvalidAddress);
+    return OK;
+}
+
+TestCase(BuddyAllocateAlignment)
+{
+    TestInt<uint> addresses(UINT_MIN, UINT_MAX / 2);
+
+    const Size chunkSize = 32;
+    const Size rangeSize = chunkSize * 64;
+    const Address allocBase = addresses.random() & PAGEMASK;
+    const Allocator::Range range = { allocBase, rangeSize, sizeof(u32) };
+
+    BuddyAllocator ba(range, chunkSize);
+    Allocator::Range args = { 0, chunkSize, 0 };
+
+    // Occupy the first chunk
+    testAssert(ba.allocate(args) == Allocator::Success);
+    testAssert(args.address == allocBase);
+
+    // Allocate one chunk aligned to sixteen chunks
+    args.alignment = chunkSize * 16;
+    testAssert(ba.allocate(args) == Allocator::Success);
+    testAssert(args.address == allocBase + (chunkSize * 16));
+
+    // Alignment must be a power of two multiple of the chunk size
+    args.alignment = chunkSize * 3;
+    testAssert(ba.allocate(args) == Allocator::InvalidAlignment);
+    args.alignment = chunkSize + 1;
+    testAssert(ba.allocate(args) == Allocator::InvalidAlignment);
+
+    return OK;
+}
+
+TestCase(BuddyAllocateLarge)
+{
+    TestInt<uint> addresses(UINT_MIN, UINT_MAX / 2);
+
+    const Size chunkSize = PAGESIZE;
+    const Size blockSize = chunkSize << BuddyAllocator::MaximumOrder;
+    const Size rangeSize = blockSize * 4;
+    const Address allocBase = addresses.random() & PAGEMASK;
+    const Allocator::Range range = { allocBase, rangeSize, sizeof(u32) };
+
+    BuddyAllocator ba(range, chunkSize);
+    Allocator::Range args = { 0, chunkSize, 0 };
+
+    // Break up the first block
+    testAssert(ba.allocate(args) == Allocator::Success);
+    testAssert(args.address == allocBase);
+
+    // Allocate more than two blocks. The tail is returned.
+    args.size = (blockSize * 2) + chunkSize;
+    testAssert(ba.allocate(args) == Allocator::Success);
+    testAssert(args.address == allocBase + blockSize);
+    testAssert(ba.available() == rangeSize - (blockSize * 2) - (chunkSize * 2));
+
+    // No room for another two blocks
+    args.size = blockSize * 2;
+    testAssert(ba.allocate(args) == Allocator::OutOfMemory);
+
+    return OK;
+}
+
+TestCase(BuddyAllocateSpecific)
+{
+    TestInt<uint> addresses(UINT_MIN, UINT_MAX / 2);
+
+    const Size chunkSize = 32;
+    const Size rangeSize = chunkSize * 64;
+    const Address allocBase = addresses.random() & PAGEMASK;
+    const Allocator::Range range = { allocBase, rangeSize, sizeof(u32) };
+
+    BuddyAllocator ba(range, chunkSize);
+
+    // Allocate a chunk in the middle of the range
+    testAssert(ba.allocateAt(allocBase + (chunkSize * 37)) == Allocator::Success);
+    testAssert(ba.isAllocated(allocBase + (chunkSize * 37)));
+    testAssert(ba.available() == rangeSize - chunkSize);
+
+    for (Size i = 0; i < 64; i++)
+    {
+        testAssert(ba.isAllocated(allocBase + (chunkSize * i)) == (i == 37));
+    }
+
+    // The rest of the range is split in one block per order
+    for (Size i = 0; i < 6; i++)
+    {
+        testAssert(ba.freeBlocks(i) == 1);
+    }
+
+    // Release coalesces back into a single block
+    testAssert(ba.release(allocBase + (chunkSize * 37)) == Allocator::Success);
+    testAssert(ba.freeBlocks(6) == 1);
+    testAssert(ba.available() == rangeSize);
+
+    return OK;
+}
+
+TestCase(BuddyAllocateFull)
+{
+    TestInt<uint> addresses(UINT_MIN, UINT_MAX / 2);
+
+    const Size chunkSize = 32;
+    const Size rangeSize = chunkSize * 24;
+    const Address allocBase = addresses.random() & PAGEMASK;
+    const Allocator::Range range = { allocBase, rangeSize, sizeof(u32) };
+
+    BuddyAllocator ba(range, chunkSize);
+    Allocator::Range args = { 0, chunkSize, 0 };
+
+    // Allocate all chunks
+    for (Size i = 0; i < 24; i++)
+    {
+        testAssert(ba.allocate(args) == Allocator::Success);
+    }
+
+    // Now we are full. Allocation should fail
+    testAssert(ba.available() == 0);
+    testAssert(ba.allocate(args) == Allocator::OutOfMemory);
+
+    // Release and allocate the same chunk again
+    testAssert(ba.release(allocBase + (chunkSize * 5)) == Allocator::Success);
+    testAssert(ba.allocate(args) == Allocator::Success);
+    testAssert(args.address == allocBase + (chunkSize * 5));
+
+    return OK;
+}
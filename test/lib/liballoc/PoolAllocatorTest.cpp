@@ -288,6 +288,43 @@ TestCase(PoolPrevNext)
     return OK;
 }
 
+TestCase(PoolMagazine)
+{
+    DummyParent parent;
+    PoolAllocator pa(&parent);
+    Allocator::Range first = { 0, 64, 0 };
+    Allocator::Range second = { 0, 64, 0 };
+
+    // Allocate two objects from the same Pool
+    testAssert(pa.allocate(first) == Allocator::Success);
+    testAssert(pa.allocate(second) == Allocator::Success);
+    testAssert(pa.m_magazines[7].count == 0);
+
+    const Size availableBefore = pa.available();
+
+    // Released object is kept in the magazine and counted as available
+    testAssert(pa.release(second.address) == Allocator::Success);
+    testAssert(pa.m_magazines[7].count == 1);
+    testAssert(pa.m_pools[7]->cached == 1);
+    testAssert(pa.available() == availableBefore + pa.m_pools[7]->chunkSize());
+
+    // Next allocation of the same size class re-uses the object from the magazine
+    Allocator::Range args = { 0, 60, 0 };
+    testAssert(pa.allocate(args) == Allocator::Success);
+    testAssert(args.address == second.address);
+    testAssert(pa.m_magazines[7].count == 0);
+    testAssert(pa.m_pools[7]->cached == 0);
+
+    // Releasing the last objects drains the magazine and the Pool
+    testAssert(pa.release(args.address) == Allocator::Success);
+    testAssert(pa.release(first.address) == Allocator::Success);
+    testAssert(pa.m_magazines[7].count == 0);
+    testAssert(pa.m_pools[7] == ZERO);
+    testAssert(pa.size() == 0);
+
+    return OK;
+}
+
 TestCase(PoolObjectSize)
 {
     DummyParent parent;
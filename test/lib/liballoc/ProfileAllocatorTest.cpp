@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/Constant.h>
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <Assert.h>
+#include <MemoryBlock.h>
+#include <PoolAllocator.h>
+#include <ProfileAllocator.h>
+
+/**
+ * Simple wrapper around the default new/delete operators.
+ */
+class ProfileParent : public Allocator
+{
+    virtual Result allocate(Range & args)
+    {
+        u8 *buf = new u8[args.size];
+        assert(buf != ZERO);
+        MemoryBlock::set(buf, 0, args.size);
+        args.address = (Address) buf;
+        return args.address != ZERO ? Success : OutOfMemory;
+    }
+
+    virtual Result release(const Address addr)
+    {
+        delete[] (u8 *) addr;
+        return Success;
+    }
+};
+
+TestCase(ProfileCounters)
+{
+    ProfileParent parent;
+    PoolAllocator pool(&parent);
+    ProfileAllocator::Profile profile;
+    ProfileAllocator alloc(&pool, &profile);
+    Allocator::Range args;
+    Address small[4], large;
+
+    testAssert(profile.signature == ProfileAllocator::ProfileSignature);
+    testAssert(profile.sampleInterval == ProfileAllocator::DefaultSampleInterval);
+    testAssert(profile.allocations == 0);
+
+    // Objects are counted in the size of their class
+    const Size smallClass = pool.sizeClass(20);
+    const Size smallSize = 1 << smallClass;
+    const Size largeSize = 1 << pool.sizeClass(1000);
+
+    for (Size i = 0; i < 4; i++)
+    {
+        args.size = 20;
+        args.alignment = 0;
+        testAssert(alloc.allocate(args) == Allocator::Success);
+        testAssert(pool.objectClass(args.address) == smallClass);
+        small[i] = args.address;
+    }
+
+    args.size = 1000;
+    args.alignment = 0;
+    testAssert(alloc.allocate(args) == Allocator::Success);
+    large = args.address;
+
+    testAssert(profile.allocations == 5);
+    testAssert(profile.requestedBytes == (4 * 20) + 1000);
+    testAssert(profile.currentBytes == (4 * smallSize) + largeSize);
+    testAssert(profile.peakBytes == profile.currentBytes);
+    testAssert(profile.classes[smallClass].allocations == 4);
+    testAssert(profile.classes[smallClass].currentBytes == 4 * smallSize);
+    testAssert(profile.classes[pool.sizeClass(1000)].allocations == 1);
+
+    // Releasing lowers the current bytes, but not the peak
+    for (Size i = 0; i < 4; i++)
+    {
+        testAssert(alloc.release(small[i]) == Allocator::Success);
+    }
+    testAssert(alloc.release(large) == Allocator::Success);
+
+    testAssert(profile.releases == 5);
+    testAssert(profile.currentBytes == 0);
+    testAssert(profile.peakBytes == (4 * smallSize) + largeSize);
+    testAssert(profile.classes[smallClass].releases == 4);
+    testAssert(profile.classes[smallClass].currentBytes == 0);
+    testAssert(profile.classes[smallClass].peakBytes == 4 * smallSize);
+
+    // Too large allocations fail
+    args.size = 0x7fffffff;
+    args.alignment = 0;
+    testAssert(alloc.allocate(args) != Allocator::Success);
+    testAssert(profile.failures == 1);
+    testAssert(profile.allocations == 5);
+
+    return OK;
+}
+
+TestCase(ProfileSamples)
+{
+    ProfileParent parent;
+    PoolAllocator pool(&parent);
+    ProfileAllocator::Profile profile;
+    ProfileAllocator alloc(&pool, &profile, 2);
+    Allocator::Range args;
+    Address objects[ProfileAllocator::MaximumSamples * 4];
+
+    // Every second allocation is sampled
+    for (Size i = 0; i < ProfileAllocator::MaximumSamples * 4; i++)
+    {
+        args.size = 8 + i;
+        args.alignment = 0;
+        testAssert(alloc.allocate(args) == Allocator::Success);
+        objects[i] = args.address;
+    }
+
+    testAssert(profile.samples == ProfileAllocator::MaximumSamples * 2);
+
+    // The ring holds the most recent samples, with the caller as site
+    for (Size i = 0; i < ProfileAllocator::MaximumSamples; i++)
+    {
+        const ProfileAllocator::Sample & s = profile.recent[i];
+        const Size n = (ProfileAllocator::MaximumSamples + i) * 2 + 1;
+
+        testAssert(s.size == 8 + n);
+        testAssert(s.site != 0);
+    }
+
+    // Samples also refresh the pool usage of each size class
+    Size pools, bytes;
+    pool.poolUsage(pool.sizeClass(8), pools, bytes);
+    testAssert(pools > 0);
+    testAssert(profile.classes[pool.sizeClass(8)].pools == pools);
+    testAssert(profile.classes[pool.sizeClass(8)].poolBytes == bytes);
+
+    for (Size i = 0; i < ProfileAllocator::MaximumSamples * 4; i++)
+    {
+        testAssert(alloc.release(objects[i]) == Allocator::Success);
+    }
+    testAssert(profile.currentBytes == 0);
+
+    return OK;
+}
@@ -20,6 +20,7 @@
 #include <TestRunner.h>
 #include <TestInt.h>
 #include <TestMain.h>
+#include <MemoryBlock.h>
 #include <SplitAllocator.h>
 
 TestCase(SplitConstruct)
@@ -115,11 +116,11 @@ TestCase(SplitAllocateFull)
     SplitAllocator sa(physRange, virtRange, PAGESIZE);
     Allocator::Range args = { 0, PAGESIZE, 0 };
 
-    // Allocate ten pages
+    // Allocate ten pages. The two page block is used before the eight page block.
     for (Size i = 0; i < 10; i++)
     {
         testAssert(sa.allocate(args) == Allocator::Success);
-        testAssert(args.address == physBase + (i * PAGESIZE));
+        testAssert(args.address == physBase + (((i + 8) % 10) * PAGESIZE));
         testAssert(args.size == PAGESIZE);
     }
 
@@ -143,11 +144,11 @@ TestCase(SplitAllocateRelease)
     SplitAllocator sa(physRange, virtRange, PAGESIZE);
     Allocator::Range args = { 0, PAGESIZE, 0 };
 
-    // Allocate ten pages
+    // Allocate ten pages. The two page block is used before the eight page block.
     for (Size i = 0; i < 10; i++)
     {
         testAssert(sa.allocate(args) == Allocator::Success);
-        testAssert(args.address == physBase + (i * PAGESIZE));
+        testAssert(args.address == physBase + (((i + 8) % 10) * PAGESIZE));
         testAssert(args.size == PAGESIZE);
     }
 
@@ -163,9 +164,124 @@ TestCase(SplitAllocateRelease)
     testAssert(sa.allocate(args) == Allocator::Success);
     testAssert(args.size == PAGESIZE);
 
-    // With the BitAllocator, the search for the allocation address
-    // begins at the last succesfully allocated address. In this case,
-    // that is the last page.
-    testAssert(args.address == physBase + allocSize - PAGESIZE);
+    // With the BuddyAllocator, the released pages are coalesced again
+    // into an eight and a two page block. The smallest block is used first.
+    testAssert(args.address == physBase + (8 * PAGESIZE));
+    return OK;
+}
+
+TestCase(SplitZeroPool)
+{
+    TestInt<uint> physAddresses((UINT_MAX/2) + 1, UINT_MAX);
+    const Address physBase = physAddresses.random() & PAGEMASK;
+    const Size allocSize = 8 * PAGESIZE;
+    u8 *buf = new u8[allocSize];
+
+    const Allocator::Range physRange = { physBase, allocSize, PAGESIZE };
+    const Allocator::Range virtRange = { (Address) buf, allocSize, PAGESIZE };
+    SplitAllocator sa(physRange, virtRange, PAGESIZE);
+    Allocator::Range phys = { 0, PAGESIZE, 0 }, virt;
+
+    // Dirty the memory, then clear four pages into the zero pool
+    MemoryBlock::set(buf, 0xff, allocSize);
+    testAssert(sa.fillZeroed(4) == 4);
+    testAssert(sa.zeroPoolCount() == 4);
+    testAssert(sa.available() == allocSize);
+
+    // A single page allocation is served from the pool
+    testAssert(sa.allocateZeroed(phys, virt) == Allocator::Success);
+    testAssert(sa.zeroPoolCount() == 3);
+    testAssert(sa.zeroPoolHits() == 1);
+    testAssert(sa.zeroPoolMisses() == 0);
+    testAssert(virt.address == (Address) buf + (phys.address - physBase));
+    testAssert(((u8 *) virt.address)[0] == 0);
+    testAssert(((u8 *) virt.address)[PAGESIZE - 1] == 0);
+
+    // A larger allocation is cleared synchronously
+    phys.size = PAGESIZE * 2;
+    testAssert(sa.allocateZeroed(phys, virt) == Allocator::Success);
+    testAssert(sa.zeroPoolMisses() == 1);
+    testAssert(((u8 *) virt.address)[PAGESIZE + 1] == 0);
+
+    // The pool never grows beyond the free memory
+    testAssert(sa.fillZeroed(SplitAllocator::ZeroPoolSize) == 2);
+    testAssert(sa.fillZeroed(1) == 0);
+    testAssert(sa.available() == 5 * PAGESIZE);
+
+    // Regular allocations take pages back from the pool when memory runs out
+    phys.size = PAGESIZE * 2;
+    phys.alignment = 0;
+    testAssert(sa.allocate(phys) == Allocator::Success);
+    testAssert(sa.zeroPoolCount() == 0);
+
+    delete[] buf;
+    return OK;
+}
+
+TestCase(SplitSharePages)
+{
+    TestInt<uint> physAddresses((UINT_MAX/2) + 1, UINT_MAX);
+    TestInt<uint> virtAddresses(UINT_MAX/4, UINT_MAX/2);
+    const Address physBase = physAddresses.random() & PAGEMASK;
+    const Address virtBase = virtAddresses.random() & PAGEMASK;
+    const Size allocSize = 16 * PAGESIZE;
+
+    const Allocator::Range physRange = { physBase, allocSize, PAGESIZE };
+    const Allocator::Range virtRange = { virtBase, allocSize, PAGESIZE };
+    SplitAllocator sa(physRange, virtRange, PAGESIZE);
+    Allocator::Range args = { 0, PAGESIZE, 0 };
+
+    // Only allocated pages can be shared
+    testAssert(sa.references(physBase) == 0);
+    testAssert(sa.share(physBase) == Allocator::InvalidAddress);
+
+    testAssert(sa.allocate(args) == Allocator::Success);
+    testAssert(sa.references(args.address) == 1);
+
+    // Add two more references
+    testAssert(sa.share(args.address) == Allocator::Success);
+    testAssert(sa.share(args.address) == Allocator::Success);
+    testAssert(sa.references(args.address) == 3);
+
+    // The page stays allocated until the last reference is released
+    testAssert(sa.release(args.address) == Allocator::Success);
+    testAssert(sa.references(args.address) == 2);
+    testAssert(sa.release(args.address) == Allocator::Success);
+    testAssert(sa.references(args.address) == 1);
+    testAssert(sa.isAllocated(args.address));
+    testAssert(sa.release(args.address) == Allocator::Success);
+    testAssert(!sa.isAllocated(args.address));
+    testAssert(sa.available() == allocSize);
+    return OK;
+}
+
+TestCase(SplitShareCollisions)
+{
+    TestInt<uint> physAddresses((UINT_MAX/2) + 1, UINT_MAX);
+    TestInt<uint> virtAddresses(UINT_MAX/4, UINT_MAX/2);
+    const Address physBase = physAddresses.random() & PAGEMASK;
+    const Address virtBase = virtAddresses.random() & PAGEMASK;
+    const Size stride = SplitAllocator::MaximumSharedPages * PAGESIZE;
+    const Size allocSize = 4 * stride;
+
+    const Allocator::Range physRange = { physBase & ~(stride - 1), allocSize, PAGESIZE };
+    const Allocator::Range virtRange = { virtBase, allocSize, PAGESIZE };
+    SplitAllocator sa(physRange, virtRange, PAGESIZE);
+    const Address base = physRange.address;
+
+    // Share pages which have the same slot in the shared page table
+    for (Size i = 0; i < 4; i++)
+    {
+        testAssert(sa.allocate(base + (i * stride)) == Allocator::Success);
+        testAssert(sa.share(base + (i * stride)) == Allocator::Success);
+    }
+
+    // Removing the first entry must keep the others reachable
+    testAssert(sa.release(base) == Allocator::Success);
+    testAssert(sa.references(base) == 1);
+
+    for (Size i = 1; i < 4; i++)
+        testAssert(sa.references(base + (i * stride)) == 2);
+
     return OK;
 }
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestRunner.h>
+#include <TestCase.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <String.h>
+#include <ELF.h>
+#include <ELFHeader.h>
+
+/** Offsets of the parts of the generated test image */
+#define TEST_SYMBOLS_OFFSET  64
+#define TEST_STRINGS_OFFSET  128
+#define TEST_SECTIONS_OFFSET 192
+#define TEST_IMAGE_SIZE      (TEST_SECTIONS_OFFSET + (sizeof(ELFSection) * 3))
+
+/**
+ * Fill a minimal ELF image with a symbol table.
+ *
+ * Contains the functions 'main' at 0x1000 of 0x100 bytes, 'helper' at
+ * 0x1200 without a size and a data object 'table' at 0x1100.
+ */
+static void fillImage(u8 *image)
+{
+    const char strings[] = "\0main\0helper\0table";
+    ELFHeader *header = (ELFHeader *) image;
+    ELFSymbol *symbols = (ELFSymbol *) (image + TEST_SYMBOLS_OFFSET);
+    ELFSection *sections = (ELFSection *) (image + TEST_SECTIONS_OFFSET);
+
+    MemoryBlock::set(image, 0, TEST_IMAGE_SIZE);
+    MemoryBlock::copy(image + TEST_STRINGS_OFFSET, strings, sizeof(strings));
+
+    header->ident[ELF_INDEX_MAGIC0] = ELF_MAGIC0;
+    header->ident[ELF_INDEX_MAGIC1] = ELF_MAGIC1;
+    header->ident[ELF_INDEX_MAGIC2] = ELF_MAGIC2;
+    header->ident[ELF_INDEX_MAGIC3] = ELF_MAGIC3;
+    header->ident[ELF_INDEX_CLASS]  = ELF_CLASS_32;
+    header->type    = ELF_TYPE_EXEC;
+    header->version = ELF_VERSION_CURRENT;
+    header->sectionHeaderOffset     = TEST_SECTIONS_OFFSET;
+    header->sectionHeaderEntrySize  = sizeof(ELFSection);
+    header->sectionHeaderEntryCount = 3;
+
+    symbols[1].name  = 1;
+    symbols[1].value = 0x1000;
+    symbols[1].size  = 0x100;
+    symbols[1].info  = ELF_SYMBOL_FUNC;
+    symbols[2].name  = 6;
+    symbols[2].value = 0x1200;
+    symbols[2].info  = ELF_SYMBOL_FUNC;
+    symbols[3].name  = 13;
+    symbols[3].value = 0x1100;
+    symbols[3].size  = 0x10;
+    symbols[3].info  = ELF_SYMBOL_OBJECT;
+
+    sections[1].type   = ELF_SECTION_SYMTAB;
+    sections[1].offset = TEST_SYMBOLS_OFFSET;
+    sections[1].size   = sizeof(ELFSymbol) * 4;
+    sections[1].link   = 2;
+    sections[2].type   = ELF_SECTION_STRTAB;
+    sections[2].offset = TEST_STRINGS_OFFSET;
+    sections[2].size   = sizeof(strings);
+}
+
+TestCase(ELFSymbolLookup)
+{
+    u8 image[TEST_IMAGE_SIZE];
+    const char *name = ZERO;
+    Address start = 0;
+
+    fillImage(image);
+    ELF elf(image, sizeof(image));
+
+    // Address inside a sized function
+    testAssert(elf.symbol(0x1080, &name, &start) == ELF::Success);
+    testAssert(String(name).equals("main"));
+    testAssert(start == 0x1000);
+
+    // Functions without size extend up to any higher address
+    testAssert(elf.symbol(0x1300, &name, &start) == ELF::Success);
+    testAssert(String(name).equals("helper"));
+    testAssert(start == 0x1200);
+
+    // Data objects and addresses outside of functions are not found
+    testAssert(elf.symbol(0x1104, &name, &start) == ELF::NotFound);
+    testAssert(elf.symbol(0x0800, &name, &start) == ELF::NotFound);
+
+    return OK;
+}
+
+TestCase(ELFSymbolIndex)
+{
+    u8 image[TEST_IMAGE_SIZE];
+    ELFSymbol *symbols = (ELFSymbol *) (image + TEST_SYMBOLS_OFFSET);
+    const char *name = ZERO;
+    Address start = 0;
+
+    // Put 'helper' before 'main' in the table and give 'main' an alias
+    fillImage(image);
+    symbols[0] = symbols[1];
+    symbols[1] = symbols[2];
+    symbols[2] = symbols[0];
+    symbols[3].name = 1;
+    symbols[3].value = 0x1000;
+    symbols[3].size = 0;
+    symbols[3].info = ELF_SYMBOL_FUNC;
+    MemoryBlock::set(&symbols[0], 0, sizeof(ELFSymbol));
+    ELF elf(image, sizeof(image));
+
+    // Lookups give the same result in any order
+    for (Size i = 0; i < 2; i++)
+    {
+        testAssert(elf.symbol(0x1200, &name, &start) == ELF::Success);
+        testAssert(String(name).equals("helper"));
+        testAssert(start == 0x1200);
+
+        testAssert(elf.symbol(0x1000, &name, &start) == ELF::Success);
+        testAssert(start == 0x1000);
+
+        // The alias without size extends up to the next function
+        testAssert(elf.symbol(0x1180, &name, &start) == ELF::Success);
+        testAssert(String(name).equals("main"));
+        testAssert(start == 0x1000);
+
+        testAssert(elf.symbol(0x0fff, &name, &start) == ELF::NotFound);
+    }
+
+    return OK;
+}
+
+TestCase(ELFSymbolInvalid)
+{
+    u8 image[TEST_IMAGE_SIZE];
+    const char *name = ZERO;
+    Address start = 0;
+
+    // Section header table beyond the end of the image
+    fillImage(image);
+    ((ELFHeader *) image)->sectionHeaderOffset = TEST_IMAGE_SIZE;
+    ELF outside(image, sizeof(image));
+    testAssert(outside.symbol(0x1080, &name, &start) == ELF::InvalidFormat);
+
+    // Unterminated string table is ignored
+    fillImage(image);
+    ((ELFSection *) (image + TEST_SECTIONS_OFFSET))[2].size = 4;
+    ELF unterminated(image, sizeof(image));
+    testAssert(unterminated.symbol(0x1080, &name, &start) == ELF::NotFound);
+
+    return OK;
+}
+
+TestCase(ELFRegionAccess)
+{
+    u8 image[TEST_IMAGE_SIZE];
+    ExecutableFormat::Region regions[4];
+    Size count = 4;
+
+    // Replace the sections with a text, data and non-loadable segment
+    fillImage(image);
+    ELFHeader *header = (ELFHeader *) image;
+    ELFSegment *segments = (ELFSegment *) (image + TEST_SECTIONS_OFFSET);
+    header->sectionHeaderEntryCount = 0;
+    header->programHeaderOffset     = TEST_SECTIONS_OFFSET;
+    header->programHeaderEntrySize  = sizeof(ELFSegment);
+    header->programHeaderEntryCount = 3;
+    MemoryBlock::set(segments, 0, sizeof(ELFSegment) * 3);
+
+    segments[0].type           = ELF_SEGMENT_LOAD;
+    segments[0].virtualAddress = 0x1000;
+    segments[0].fileSize       = 0x200;
+    segments[0].memorySize     = 0x200;
+    segments[0].flags          = ELF_SEGMENT_FLAG_READ | ELF_SEGMENT_FLAG_EXEC;
+    segments[1].type           = ELF_SEGMENT_NOTE;
+    segments[2].type           = ELF_SEGMENT_LOAD;
+    segments[2].virtualAddress = 0x2000;
+    segments[2].fileSize       = 0x100;
+    segments[2].memorySize     = 0x1000;
+    segments[2].flags          = ELF_SEGMENT_FLAG_READ | ELF_SEGMENT_FLAG_WRITE;
+
+    ELF elf(image, sizeof(image));
+    testAssert(elf.regions(regions, &count) == ELF::Success);
+    testAssert(count == 2);
+
+    // Read-only text can be shared in place
+    testAssert(regions[0].virt == 0x1000);
+    testAssert(regions[0].access == (Memory::User | Memory::Readable | Memory::Executable));
+
+    // Writable data is never executable
+    testAssert(regions[1].virt == 0x2000);
+    testAssert(regions[1].dataSize == 0x100);
+    testAssert(regions[1].memorySize == 0x1000);
+    testAssert(regions[1].access == (Memory::User | Memory::Readable | Memory::Writable));
+
+    return OK;
+}
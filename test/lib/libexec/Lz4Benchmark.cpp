@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <BenchmarkMain.h>
+#include <Benchmark.h>
+#include <Lz4Compressor.h>
+#include <Lz4Decompressor.h>
+
+/** Size of the uncompressed input */
+#define INPUT_SIZE (64 * 1024)
+
+/**
+ * Compressed input shared by the benchmarks
+ */
+class Lz4Input
+{
+  public:
+
+    Lz4Input()
+    {
+        u32 seed = 1;
+
+        // Text-like data with repeated words and some noise
+        for (Size i = 0; i < INPUT_SIZE; i++)
+        {
+            seed = (seed * 1103515245) + 12345;
+            data[i] = (seed >> 24) < 32 ? (u8) (seed >> 16) : "lorem ipsum dolor sit amet "[i % 27];
+        }
+
+        Lz4Compressor compressor(data, INPUT_SIZE);
+        maximumSize = compressor.getMaximumSize();
+        frameSize = maximumSize;
+        frame = new u8[maximumSize];
+        compressor.compress(frame, frameSize);
+    }
+
+    ~Lz4Input()
+    {
+        delete[] frame;
+    }
+
+    u8 data[INPUT_SIZE];
+    u8 output[INPUT_SIZE];
+    u8 *frame;
+    Size frameSize;
+    Size maximumSize;
+};
+
+static Lz4Input input;
+
+BenchmarkCase(Lz4Decompress)
+{
+    for (Size i = 0; i < iterations; i++)
+    {
+        Lz4Decompressor lz4(input.frame, input.frameSize);
+        lz4.initialize();
+        lz4.read(input.output, INPUT_SIZE);
+    }
+    benchmarkUse(input.output[0]);
+}
+
+BenchmarkCase(Lz4Compress)
+{
+    for (Size i = 0; i < iterations; i++)
+    {
+        Lz4Compressor lz4(input.data, INPUT_SIZE);
+        Size size = input.maximumSize;
+        lz4.compress(input.frame, size);
+    }
+    benchmarkUse(input.frame[0]);
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestCase.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <Lz4Compressor.h>
+#include <Lz4Decompressor.h>
+
+/**
+ * Compress the given data and verify it decompresses to the same data.
+ */
+static bool roundTrip(const u8 *data, const Size size, Size *compressedSize)
+{
+    Lz4Compressor compressor(data, size);
+    Size frameSize = compressor.getMaximumSize();
+    u8 *frame = new u8[frameSize];
+    u8 *output = new u8[size];
+    bool equal = false;
+
+    if (compressor.compress(frame, frameSize) == Lz4Compressor::Success)
+    {
+        Lz4Decompressor decompressor(frame, frameSize);
+
+        if (decompressor.initialize() == Lz4Decompressor::Success &&
+            decompressor.getUncompressedSize() == size &&
+            decompressor.read(output, size) == Lz4Decompressor::Success)
+        {
+            equal = MemoryBlock::compare(output, data, size);
+        }
+    }
+
+    *compressedSize = frameSize;
+    delete[] frame;
+    delete[] output;
+    return equal;
+}
+
+TestCase(Lz4CompressInvalid)
+{
+    u8 data[64], frame[64];
+    Size frameSize = sizeof(frame);
+
+    MemoryBlock::set(data, 0, sizeof(data));
+
+    // Empty input cannot be compressed
+    Lz4Compressor empty(data, 0);
+    testAssert(empty.compress(frame, frameSize) == Lz4Compressor::InvalidArgument);
+
+    // Output buffer must fit the maximum size
+    Lz4Compressor small(data, sizeof(data));
+    testAssert(small.getMaximumSize() > sizeof(frame));
+    testAssert(small.compress(frame, frameSize) == Lz4Compressor::InvalidArgument);
+    testAssert(frameSize == sizeof(frame));
+
+    return OK;
+}
+
+TestCase(Lz4CompressZeroes)
+{
+    static u8 data[4096 * 4];
+    Size compressedSize = 0;
+
+    MemoryBlock::set(data, 0, sizeof(data));
+
+    // Zeroes compress through overlapping matches
+    testAssert(roundTrip(data, sizeof(data), &compressedSize));
+    testAssert(compressedSize < 256);
+
+    return OK;
+}
+
+TestCase(Lz4CompressPattern)
+{
+    static u8 data[4096 * 4];
+    Size compressedSize = 0;
+    TestInt<uint> values(0, 255);
+
+    // Repeat a random sequence of bytes, followed by random bytes
+    for (Size i = 0; i < 512; i++)
+    {
+        data[i] = values.random();
+    }
+    for (Size i = 512; i < sizeof(data) / 2; i++)
+    {
+        data[i] = data[i % 512];
+    }
+    for (Size i = sizeof(data) / 2; i < sizeof(data); i++)
+    {
+        data[i] = values.random();
+    }
+
+    testAssert(roundTrip(data, sizeof(data), &compressedSize));
+    testAssert(compressedSize < sizeof(data));
+
+    return OK;
+}
+
+TestCase(Lz4CompressRandom)
+{
+    static u8 data[4096];
+    Size compressedSize = 0;
+    TestInt<uint> values(0, 255);
+
+    for (Size i = 0; i < sizeof(data); i++)
+    {
+        data[i] = values.random();
+    }
+
+    // Incompressible blocks are stored as-is
+    testAssert(roundTrip(data, sizeof(data), &compressedSize));
+    testAssert(compressedSize <= sizeof(data) + 23);
+
+    return OK;
+}
+
+TestCase(Lz4CompressMultipleBlocks)
+{
+    static u8 data[(64 * 1024 * 3) + 123];
+    Size compressedSize = 0;
+
+    for (Size i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (i / 7) ^ (i >> 11);
+    }
+
+    testAssert(roundTrip(data, sizeof(data), &compressedSize));
+    testAssert(compressedSize < sizeof(data));
+
+    return OK;
+}
+
+TestCase(Lz4CompressSmall)
+{
+    const u8 data[] = { 'a', 'b', 'c', 'a', 'b', 'c', 'a', 'b', 'c', 'a', 'b', 'c', 'x' };
+    Size compressedSize = 0;
+
+    testAssert(roundTrip(data, sizeof(data), &compressedSize));
+
+    return OK;
+}
+
+TestCase(Lz4CompressShortOffsets)
+{
+    static u8 data[4096];
+    Size compressedSize = 0;
+
+    // Short repeating patterns produce matches which overlap themselves
+    for (Size period = 1; period <= 9; period++)
+    {
+        for (Size i = 0; i < sizeof(data); i++)
+        {
+            data[i] = 'a' + (i % period);
+        }
+
+        testAssert(roundTrip(data, sizeof(data), &compressedSize));
+        testAssert(compressedSize < 256);
+    }
+
+    return OK;
+}
+
+TestCase(Lz4DecompressBlocks)
+{
+    static u8 data[(64 * 1024 * 3) + 123];
+    static u8 output[sizeof(data)];
+    TestInt<uint> values(0, 255);
+
+    // Mix compressible and incompressible blocks
+    for (Size i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (i / (64 * 1024)) == 1 ? values.random() : (i / 7);
+    }
+
+    Lz4Compressor compressor(data, sizeof(data));
+    Size frameSize = compressor.getMaximumSize();
+    u8 *frame = new u8[frameSize];
+    testAssert(compressor.compress(frame, frameSize) == Lz4Compressor::Success);
+
+    Lz4Decompressor decompressor(frame, frameSize);
+    testAssert(decompressor.initialize() == Lz4Decompressor::Success);
+    testAssert(decompressor.getBlockCount() == 4);
+
+    // Decompress the blocks out of order
+    MemoryBlock::set(output, 0, sizeof(output));
+    testAssert(decompressor.readBlocks(output, sizeof(output), 2, 2) == Lz4Decompressor::Success);
+    testAssert(decompressor.readBlocks(output, sizeof(output), 0, 1) == Lz4Decompressor::Success);
+    testAssert(decompressor.readBlocks(output, sizeof(output), 1, 1) == Lz4Decompressor::Success);
+    testAssert(MemoryBlock::compare(output, data, sizeof(data)));
+
+    // Blocks beyond the end of the frame
+    testAssert(decompressor.readBlocks(output, sizeof(output), 3, 2) == Lz4Decompressor::InvalidArgument);
+
+    delete[] frame;
+    return OK;
+}
+
+TestCase(Lz4DecompressStream)
+{
+    static u8 data[(64 * 1024 * 2) + 321];
+    static u8 output[sizeof(data)];
+    static u8 block[64 * 1024];
+    TestInt<uint> values(0, 255);
+    Size position = 0, offset = 0, size = 0;
+
+    // Mix compressible and incompressible blocks
+    for (Size i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (i / (64 * 1024)) == 0 ? values.random() : (i / 5);
+    }
+
+    Lz4Compressor compressor(data, sizeof(data));
+    Size frameSize = compressor.getMaximumSize();
+    u8 *frame = new u8[frameSize];
+    testAssert(compressor.compress(frame, frameSize) == Lz4Compressor::Success);
+
+    Lz4Decompressor decompressor(frame, frameSize);
+    testAssert(decompressor.initialize() == Lz4Decompressor::Success);
+    testAssert(decompressor.getBlockMaximumSize() == sizeof(block));
+
+    // Decompress one block at a time until the end of the frame
+    do
+    {
+        testAssert(decompressor.readBlock(position, block, size) == Lz4Decompressor::Success);
+        testAssert(offset + size <= sizeof(output));
+        MemoryBlock::copy(output + offset, block, size);
+        offset += size;
+    }
+    while (size != 0);
+
+    testAssert(offset == sizeof(data));
+    testAssert(MemoryBlock::compare(output, data, sizeof(data)));
+
+    // Reading past the end of the input fails
+    position = frameSize;
+    testAssert(decompressor.readBlock(position, block, size) == Lz4Decompressor::InvalidArgument);
+    testAssert(size == 0);
+
+    delete[] frame;
+    return OK;
+}
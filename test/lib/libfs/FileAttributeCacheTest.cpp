@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestCase.h>
+#include <TestMain.h>
+#include <FileAttributeCache.h>
+
+static FileSystem::FileStat makeStat(const u32 inode, const ProcessID pid)
+{
+    FileSystem::FileStat st;
+
+    MemoryBlock::set(&st, 0, sizeof(st));
+    st.type  = FileSystem::RegularFile;
+    st.inode = inode;
+    st.pid   = pid;
+    st.size  = inode * 10;
+    return st;
+}
+
+TestCase(FileAttributeCacheLookup)
+{
+    FileAttributeCache cache;
+    FileSystem::FileStat st;
+
+    cache.setLease(10);
+    testAssert(cache.count() == 0);
+    testAssert(!cache.lookup("/etc/passwd", 100, st));
+
+    cache.insert("/etc/passwd", makeStat(5, 2), 1, 100);
+    testAssert(cache.count() == 1);
+
+    // Found while the lease is valid
+    MemoryBlock::set(&st, 0, sizeof(st));
+    testAssert(cache.lookup("/etc/passwd", 109, st));
+    testAssert(st.inode == 5);
+    testAssert(st.pid == 2);
+    testAssert(st.size == 50);
+    testAssert(!cache.lookup("/etc/passw", 109, st));
+    testAssert(!cache.lookup("/etc/passwd2", 109, st));
+
+    // Expired when the lease ends
+    testAssert(!cache.lookup("/etc/passwd", 110, st));
+    testAssert(cache.count() == 0);
+    return OK;
+}
+
+TestCase(FileAttributeCacheGeneration)
+{
+    FileAttributeCache cache;
+    FileSystem::FileStat st;
+
+    cache.setLease(10);
+    cache.insert("/etc/a", makeStat(1, 2), 7, 0);
+    cache.insert("/etc/b", makeStat(2, 2), 7, 0);
+    cache.insert("/dev/c", makeStat(3, 4), 1, 0);
+    testAssert(cache.count() == 3);
+
+    // Unchanged file system keeps its entries
+    cache.update(2, 7);
+    testAssert(cache.count() == 3);
+
+    // Changed file system drops only its own entries
+    cache.update(2, 8);
+    testAssert(cache.count() == 1);
+    testAssert(!cache.lookup("/etc/a", 1, st));
+    testAssert(cache.lookup("/dev/c", 1, st));
+    testAssert(st.inode == 3);
+
+    // Explicit invalidation
+    cache.invalidate("/dev/c");
+    testAssert(cache.count() == 0);
+    return OK;
+}
+
+TestCase(FileAttributeCacheReplace)
+{
+    FileAttributeCache cache;
+    FileSystem::FileStat st;
+    char path[16];
+
+    cache.setLease(100);
+
+    // Fill all entries, where the first inserted is the oldest
+    for (Size i = 0; i < FileAttributeCache::MaximumEntries; i++)
+    {
+        MemoryBlock::copy(path, (char *) "/bin/a", sizeof(path));
+        path[5] = 'a' + i;
+        cache.insert(path, makeStat(i + 1, 2), 1, i);
+    }
+    testAssert(cache.count() == FileAttributeCache::MaximumEntries);
+
+    // Same path replaces the existing entry
+    cache.insert("/bin/b", makeStat(99, 2), 1, 20);
+    testAssert(cache.count() == FileAttributeCache::MaximumEntries);
+    testAssert(cache.lookup("/bin/b", 21, st));
+    testAssert(st.inode == 99);
+
+    // New path replaces the oldest entry
+    cache.insert("/bin/new", makeStat(100, 2), 1, 21);
+    testAssert(cache.count() == FileAttributeCache::MaximumEntries);
+    testAssert(!cache.lookup("/bin/a", 21, st));
+    testAssert(cache.lookup("/bin/c", 21, st));
+    testAssert(cache.lookup("/bin/new", 21, st));
+    testAssert(st.inode == 100);
+
+    // Too long paths are not cached
+    cache.clear();
+    char longPath[FileSystemPath::MaximumLength + 1];
+    MemoryBlock::set(longPath, 'x', sizeof(longPath) - 1);
+    longPath[sizeof(longPath) - 1] = ZERO;
+    cache.insert(longPath, makeStat(1, 2), 1, 0);
+    testAssert(cache.count() == 0);
+    return OK;
+}
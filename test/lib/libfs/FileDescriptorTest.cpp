@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <FileDescriptor.h>
+
+/** Number of entries in the test tables */
+#define ENTRIES 100
+
+TestCase(FileDescriptorLowestFree)
+{
+    FileDescriptor::Entry entries[ENTRIES];
+    FileDescriptor *fd = FileDescriptor::instance();
+    Size index, count;
+
+    MemoryBlock::set(entries, 0, sizeof(entries));
+    fd->setArray(entries, ENTRIES);
+    testAssert(fd->getArray(count) == entries);
+    testAssert(count == 0);
+
+    // Entries are opened from the lowest index, across bitmap words
+    for (Size i = 0; i < 40; i++)
+    {
+        testAssert(fd->openEntry(i, 1, index) == FileDescriptor::Success);
+        testAssert(index == i);
+        testAssert(entries[i].open);
+        testAssert(entries[i].inode == i);
+    }
+    fd->getArray(count);
+    testAssert(count == 40);
+
+    // A closed entry is re-used first
+    testAssert(fd->closeEntry(3) == FileDescriptor::Success);
+    testAssert(fd->closeEntry(35) == FileDescriptor::Success);
+    testAssert(fd->findFree(index) == FileDescriptor::Success);
+    testAssert(index == 3);
+    testAssert(fd->openEntry(0, 1, index) == FileDescriptor::Success);
+    testAssert(index == 3);
+    testAssert(fd->openEntry(0, 1, index) == FileDescriptor::Success);
+    testAssert(index == 35);
+    testAssert(fd->openEntry(0, 1, index) == FileDescriptor::Success);
+    testAssert(index == 40);
+
+    fd->setArray(ZERO, 0);
+    return OK;
+}
+
+TestCase(FileDescriptorHighest)
+{
+    FileDescriptor::Entry entries[ENTRIES];
+    FileDescriptor *fd = FileDescriptor::instance();
+    Size index, count;
+
+    MemoryBlock::set(entries, 0, sizeof(entries));
+    fd->setArray(entries, ENTRIES);
+
+    for (Size i = 0; i < 3; i++)
+        testAssert(fd->openEntry(0, 1, index) == FileDescriptor::Success);
+
+    // Copying beyond the highest entry raises the count
+    testAssert(fd->copyEntry(1, 70) == FileDescriptor::Success);
+    testAssert(entries[70].open);
+    fd->getArray(count);
+    testAssert(count == 71);
+
+    // Only open entries can be copied
+    testAssert(fd->copyEntry(50, 60) == FileDescriptor::InvalidArgument);
+    testAssert(fd->copyEntry(1, ENTRIES) == FileDescriptor::InvalidArgument);
+
+    // Closing the highest entry lowers the count to the next open entry
+    testAssert(fd->closeEntry(70) == FileDescriptor::Success);
+    fd->getArray(count);
+    testAssert(count == 3);
+
+    testAssert(fd->closeEntry(0) == FileDescriptor::Success);
+    testAssert(fd->closeEntry(2) == FileDescriptor::Success);
+    fd->getArray(count);
+    testAssert(count == 2);
+
+    testAssert(fd->closeEntry(1) == FileDescriptor::Success);
+    fd->getArray(count);
+    testAssert(count == 0);
+
+    fd->setArray(ZERO, 0);
+    return OK;
+}
+
+TestCase(FileDescriptorInherit)
+{
+    FileDescriptor::Entry entries[ENTRIES];
+    FileDescriptor *fd = FileDescriptor::instance();
+    Size index, count;
+
+    MemoryBlock::set(entries, 0, sizeof(entries));
+    entries[0].open = true;
+    entries[2].open = true;
+    entries[50].open = true;
+
+    // Only the given number of entries is read
+    fd->setArray(entries, ENTRIES, 3);
+    fd->getArray(count);
+    testAssert(count == 3);
+    testAssert(fd->openEntry(0, 1, index) == FileDescriptor::Success);
+    testAssert(index == 1);
+    testAssert(fd->openEntry(0, 1, index) == FileDescriptor::Success);
+    testAssert(index == 3);
+
+    // By default all entries are read
+    fd->setArray(entries, ENTRIES);
+    fd->getArray(count);
+    testAssert(count == 51);
+
+    fd->setArray(ZERO, 0);
+    return OK;
+}
+
+TestCase(FileDescriptorOutOfFiles)
+{
+    FileDescriptor::Entry entries[ENTRIES];
+    FileDescriptor *fd = FileDescriptor::instance();
+    Size index;
+
+    MemoryBlock::set(entries, 0, sizeof(entries));
+    fd->setArray(entries, ENTRIES);
+
+    for (Size i = 0; i < ENTRIES; i++)
+        testAssert(fd->openEntry(0, 1, index) == FileDescriptor::Success);
+
+    testAssert(fd->openEntry(0, 1, index) == FileDescriptor::OutOfFiles);
+    testAssert(fd->findFree(index) == FileDescriptor::OutOfFiles);
+    testAssert(fd->getEntry(ENTRIES) == ZERO);
+    testAssert(fd->closeEntry(ENTRIES) == FileDescriptor::InvalidArgument);
+
+    testAssert(fd->closeEntry(64) == FileDescriptor::Success);
+    testAssert(fd->openEntry(0, 1, index) == FileDescriptor::Success);
+    testAssert(index == 64);
+
+    fd->setArray(ZERO, 0);
+    return OK;
+}
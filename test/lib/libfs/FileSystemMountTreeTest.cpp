@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestCase.h>
+#include <TestMain.h>
+#include <FileSystemMountTree.h>
+
+TestCase(FileSystemMountTreeLongestPrefix)
+{
+    FileSystemMountTree tree;
+    ProcessID pid = ZERO;
+
+    testAssert(tree.count() == 1);
+    testAssert(!tree.find("/dev/null", pid));
+
+    testAssert(tree.insert("/", 1));
+    testAssert(tree.insert("/dev", 10));
+    testAssert(tree.insert("/dev/pci", 11));
+    testAssert(tree.insert("/network", 12));
+
+    // Longest matching mount path wins
+    testAssert(tree.find("/dev/null", pid));
+    testAssert(pid == 10);
+    testAssert(tree.find("/dev/pci/0", pid));
+    testAssert(pid == 11);
+    testAssert(tree.find("/dev/pc", pid));
+    testAssert(pid == 10);
+    testAssert(tree.find("/net", pid));
+    testAssert(pid == 1);
+    testAssert(tree.find("/network/loopback", pid));
+    testAssert(pid == 12);
+    testAssert(tree.find("/", pid));
+    testAssert(pid == 1);
+    return OK;
+}
+
+TestCase(FileSystemMountTreeSplit)
+{
+    FileSystemMountTree tree;
+    ProcessID pid = ZERO;
+
+    // Inserting a shorter path splits the existing node
+    testAssert(tree.insert("/network", 12));
+    testAssert(tree.insert("/net", 13));
+    testAssert(tree.insert("/nexus", 14));
+    testAssert(tree.count() == 5);
+
+    testAssert(tree.find("/network", pid));
+    testAssert(pid == 12);
+    testAssert(tree.find("/nett", pid));
+    testAssert(pid == 13);
+    testAssert(tree.find("/nexus/a", pid));
+    testAssert(pid == 14);
+    testAssert(!tree.find("/ne", pid));
+    testAssert(!tree.find("/tmp", pid));
+
+    // First mount on the same path is kept
+    testAssert(tree.insert("/net", 15));
+    testAssert(tree.find("/net", pid));
+    testAssert(pid == 13);
+    return OK;
+}
+
+TestCase(FileSystemMountTreeCursor)
+{
+    FileSystemMountTree tree;
+    FileSystemMountTree::Cursor dir, cursor;
+
+    testAssert(tree.insert("/", 1));
+    testAssert(tree.insert("/dev/pci", 11));
+
+    // Resume a walk from a resolved prefix
+    tree.begin(dir);
+    tree.walk(dir, "/dev/", FileSystemPath::MaximumLength);
+    testAssert(dir.found);
+    testAssert(dir.pid == 1);
+
+    cursor = dir;
+    tree.walk(cursor, "pci/0", FileSystemPath::MaximumLength);
+    testAssert(cursor.found);
+    testAssert(cursor.pid == 11);
+
+    cursor = dir;
+    tree.walk(cursor, "tty0", FileSystemPath::MaximumLength);
+    testAssert(cursor.stopped);
+    testAssert(cursor.pid == 1);
+    return OK;
+}
+
+TestCase(FileSystemMountTreeRebuild)
+{
+    FileSystemMountTree tree;
+    FileSystemMount mounts[3];
+    ProcessID pid = ZERO;
+
+    MemoryBlock::set(mounts, 0, sizeof(mounts));
+    MemoryBlock::copy(mounts[0].path, (char *) "/dev", sizeof(mounts[0].path));
+    mounts[0].procID = 10;
+    MemoryBlock::copy(mounts[2].path, (char *) "/tmp", sizeof(mounts[2].path));
+    mounts[2].procID = 16;
+
+    testAssert(tree.insert("/old", 2));
+    testAssert(tree.rebuild(mounts, 3));
+    testAssert(!tree.find("/old", pid));
+    testAssert(tree.find("/dev/null", pid));
+    testAssert(pid == 10);
+    testAssert(tree.find("/tmp/file", pid));
+    testAssert(pid == 16);
+    return OK;
+}
+
+TestCase(FileSystemMountTreeFull)
+{
+    FileSystemMountTree tree;
+    char paths[FileSystemMountTree::MaximumMounts][8];
+    ProcessID pid = ZERO;
+
+    // Fill the tree with mounts sharing a common prefix
+    for (Size i = 0; i < FileSystemMountTree::MaximumMounts; i++)
+    {
+        MemoryBlock::copy(paths[i], (char *) "/aaaaa", sizeof(paths[i]));
+        paths[i][1] = 'a' + i;
+        paths[i][2] = 'x';
+        testAssert(tree.insert(paths[i], 20 + i));
+    }
+    testAssert(tree.count() <= FileSystemMountTree::MaximumNodes);
+
+    for (Size i = 0; i < FileSystemMountTree::MaximumMounts; i++)
+    {
+        testAssert(tree.find(paths[i], pid));
+        testAssert(pid == (ProcessID) (20 + i));
+    }
+    return OK;
+}
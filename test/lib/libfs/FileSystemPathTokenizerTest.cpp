@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestCase.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <String.h>
+#include <FileSystemPathTokenizer.h>
+
+TestCase(FileSystemPathTokenizerSplit)
+{
+    FileSystemPathTokenizer tokens("//mnt/to//file.txt/");
+
+    testAssert(tokens.next());
+    testAssert(tokens.length() == 3);
+    testAssert(MemoryBlock::compare(tokens.current(), "mnt", 3));
+    testAssert(tokens.hasNext());
+
+    testAssert(tokens.next());
+    testAssert(tokens.length() == 2);
+    testAssert(MemoryBlock::compare(tokens.current(), "to", 2));
+    testAssert(tokens.hasNext());
+
+    testAssert(tokens.next());
+    testAssert(tokens.length() == 8);
+    testAssert(MemoryBlock::compare(tokens.current(), "file.txt", 8));
+    testAssert(!tokens.hasNext());
+
+    testAssert(!tokens.next());
+    testAssert(tokens.length() == 0);
+    testAssert(!tokens.next());
+
+    return OK;
+}
+
+TestCase(FileSystemPathTokenizerEmpty)
+{
+    FileSystemPathTokenizer empty("");
+    testAssert(!empty.hasNext());
+    testAssert(!empty.next());
+
+    FileSystemPathTokenizer root("/");
+    testAssert(!root.hasNext());
+    testAssert(!root.next());
+
+    return OK;
+}
+
+TestCase(FileSystemPathTokenizerMaximumLength)
+{
+    // The path is not null-terminated within the maximum length
+    const char path[] = { 'a', '/', 'b', 'c', 'd' };
+    FileSystemPathTokenizer tokens(path, 4);
+
+    testAssert(tokens.next());
+    testAssert(tokens.length() == 1);
+    testAssert(tokens.next());
+    testAssert(tokens.length() == 2);
+    testAssert(MemoryBlock::compare(tokens.current(), "bc", 2));
+    testAssert(!tokens.next());
+
+    return OK;
+}
+
+TestCase(FileSystemPathTokenizerHash)
+{
+    FileSystemPathTokenizer tokens("first/second/first");
+    const String first("first");
+
+    testAssert(tokens.next());
+    const u32 hash = tokens.hash();
+    testAssert(hash == FileSystemPathTokenizer::hash(*first, first.length()));
+
+    testAssert(tokens.next());
+    testAssert(tokens.hash() != hash);
+
+    testAssert(tokens.next());
+    testAssert(tokens.hash() == hash);
+
+    return OK;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <FileSystemRequestPool.h>
+
+TestCase(FileSystemRequestPoolAllocate)
+{
+    FileSystemRequestPool pool;
+    FileSystemMessage msg;
+    char remote[64 + 1];
+
+    // Unaligned remote buffer, which is buffered
+    MemoryBlock::set(&msg, 0, sizeof(msg));
+    msg.from   = SELF;
+    msg.action = FileSystem::ReadFile;
+    msg.buffer = remote + 1;
+    msg.size   = 64;
+
+    FileSystemRequest *req = pool.allocate(&msg);
+    testAssert(req != ZERO);
+    testAssert(req->getMessage()->size == 64);
+    testAssert(req->getBuffer().getBuffer() != ZERO);
+    testAssert(((Address) req->getBuffer().getBuffer() & (PAGESIZE - 1)) == 0);
+    testAssert(pool.getCount() == 1);
+    testAssert(pool.getHighWaterMark() == 1);
+
+    // Released requests are reused
+    u8 *buffer = req->getBuffer().getBuffer();
+    pool.release(req);
+    testAssert(pool.getCount() == 0);
+    testAssert(pool.allocate(&msg) == req);
+    testAssert(req->getBuffer().getBuffer() == buffer);
+    pool.release(req);
+    testAssert(pool.getHighWaterMark() == 1);
+
+    return OK;
+}
+
+TestCase(FileSystemRequestPoolExhausted)
+{
+    FileSystemRequestPool pool;
+    FileSystemRequest *requests[FileSystemRequestPool::MaximumRequests + 2];
+    FileSystemMessage msg;
+    char remote[PAGESIZE * 2];
+
+    MemoryBlock::set(&msg, 0, sizeof(msg));
+    msg.from   = SELF;
+    msg.action = FileSystem::WriteFile;
+    msg.buffer = remote + 1;
+    msg.size   = 128;
+
+    // Allocate more requests than preallocated
+    for (Size i = 0; i < FileSystemRequestPool::MaximumRequests + 2; i++)
+    {
+        requests[i] = pool.allocate(&msg);
+        testAssert(requests[i] != ZERO);
+
+        for (Size j = 0; j < i; j++)
+            testAssert(requests[i]->getBuffer().getBuffer() != requests[j]->getBuffer().getBuffer());
+    }
+    testAssert(pool.getCount() == FileSystemRequestPool::MaximumRequests + 2);
+    testAssert(pool.getHighWaterMark() == FileSystemRequestPool::MaximumRequests + 2);
+
+    // Messages larger than the preallocated buffer are still buffered
+    msg.size = PAGESIZE + 1;
+    requests[0]->setMessage(&msg);
+    testAssert(requests[0]->getBuffer().getBuffer() != ZERO);
+
+    for (Size i = 0; i < FileSystemRequestPool::MaximumRequests + 2; i++)
+        pool.release(requests[i]);
+
+    testAssert(pool.getCount() == 0);
+    testAssert(pool.getHighWaterMark() == FileSystemRequestPool::MaximumRequests + 2);
+    return OK;
+}
@@ -89,6 +89,33 @@ class DummyFileSystem : public FileSystemServer
 
 u8 DummyFileSystem::m_pages[PAGESIZE * 2 * 4];
 
+/**
+ * File which blocks reads until data is available
+ */
+class BlockingFile : public File
+{
+  public:
+
+    BlockingFile(const u32 inode)
+        : File(inode)
+        , m_available(false)
+    {
+    }
+
+    virtual FileSystem::Result read(IOBuffer & buffer,
+                                    Size & size,
+                                    const Size offset)
+    {
+        if (!m_available)
+            return FileSystem::RetryAgain;
+
+        size = 0;
+        return FileSystem::Success;
+    }
+
+    bool m_available;
+};
+
 TestCase(FileSystemServerConstruct)
 {
     Directory *root = new Directory(1);
@@ -99,7 +126,7 @@ TestCase(FileSystemServerConstruct)
     testAssert(fs.m_root->file == root);
     testString(*fs.m_root->name, "/");
     testAssert(fs.m_mounts == ZERO);
-    testAssert(fs.m_requests != ZERO);
+    testAssert(fs.m_requests.isEmpty());
     testString(fs.getMountPath(), "/mnt");
 
     return OK;
@@ -141,6 +168,82 @@ TestCase(FileSystemServerRegisterFile)
     return OK;
 }
 
+TestCase(FileSystemServerFindNested)
+{
+    FileSystemServer fs(new Directory(1), "/mnt");
+    Directory *dir = new Directory(fs.getNextInode());
+    Directory *sub = new Directory(fs.getNextInode());
+    File *file = new File(fs.getNextInode());
+
+    testAssert(fs.registerDirectory(dir, "dir") == FileSystem::Success);
+    testAssert(fs.registerDirectory(sub, "dir/sub") == FileSystem::Success);
+    testAssert(fs.registerFile(file, "dir/sub/file") == FileSystem::Success);
+
+    // Each component is found in the dentry hash
+    testAssert(fs.findFileCache("") == fs.m_root);
+    testAssert(fs.findFileCache("/") == fs.m_root);
+    testAssert(fs.findFileCache("/dir")->file == dir);
+    testAssert(fs.findFileCache("dir/sub")->file == sub);
+    testAssert(fs.findFileCache("//dir//sub/file")->file == file);
+    testAssert(fs.findFileCache("dir/sub/.")->file == sub);
+    testAssert(fs.findFileCache("dir/sub/..")->file == dir);
+    testAssert(fs.findFileCache("dir/sub/file/none") == ZERO);
+    testAssert(fs.findFileCache("dir/su") == ZERO);
+    testAssert(fs.findFileCache("sub") == ZERO);
+
+    // Removed entries are no longer found
+    testAssert(fs.unregisterFile("dir/sub/file") == FileSystem::Success);
+    testAssert(fs.findFileCache("dir/sub/file") == ZERO);
+    testAssert(fs.findFileCache("dir/sub")->file == sub);
+
+    return OK;
+}
+
+/**
+ * Directory which counts lookups of uncached entries
+ */
+class CountingDirectory : public Directory
+{
+  public:
+
+    CountingDirectory(const u32 inode)
+        : Directory(inode)
+        , m_lookups(0)
+    {
+    }
+
+    virtual File * lookup(const char *name)
+    {
+        m_lookups++;
+        return ZERO;
+    }
+
+    Size m_lookups;
+};
+
+TestCase(FileSystemServerNegativeLookup)
+{
+    CountingDirectory *root = new CountingDirectory(1);
+    FileSystemServer fs(root, "/mnt");
+
+    // Repeated misses only reach the directory once
+    testAssert(fs.lookupFile("/bin/missing") == ZERO);
+    testAssert(root->m_lookups == 1);
+    testAssert(fs.lookupFile("/bin/missing") == ZERO);
+    testAssert(fs.lookupFile("bin") == ZERO);
+    testAssert(root->m_lookups == 1);
+    testAssert(fs.m_negative.count() == 1);
+
+    // Registering the entry invalidates the miss
+    Directory *bin = new Directory(fs.getNextInode());
+    testAssert(fs.registerDirectory(bin, "bin") == FileSystem::Success);
+    testAssert(fs.m_negative.count() == 0);
+    testAssert(fs.lookupFile("/bin")->file == bin);
+    testAssert(root->m_lookups == 1);
+
+    return OK;
+}
+
 TestCase(FileSystemServerStatFile)
 {
     DummyFileSystem fs(new Directory(1), "/mnt");
@@ -224,6 +327,80 @@ TestCase(FileSystemServerReadFile)
     return OK;
 }
 
+TestCase(FileSystemServerMapFile)
+{
+    DummyFileSystem fs(new Directory(1), "/mnt");
+    const u32 inode = fs.getNextInode();
+    testAssert(fs.registerFile(new PseudoFile(inode, "mydata"), "myfile.txt") == FileSystem::Success);
+
+    // Mappings must use a file mapping share tag
+    FileSystemMessage msg;
+    msg.from   = fs.m_pid;
+    msg.action = FileSystem::MapFile;
+    msg.inode  = inode;
+    msg.buffer = (char *) FileSystem::BulkShareTag;
+    msg.size   = 6;
+    msg.offset = 0;
+    fs.pathHandler(&msg);
+
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::InvalidArgument);
+
+    msg.buffer = (char *) (FileSystem::MapShareTag + FileSystem::MaximumFileMappings);
+    fs.pathHandler(&msg);
+
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::InvalidArgument);
+
+    return OK;
+}
+
+TestCase(FileSystemServerSpliceFile)
+{
+    DummyFileSystem fs(new Directory(1), "/mnt");
+    const u32 inode = fs.getNextInode();
+    testAssert(fs.registerFile(new PseudoFile(inode, "mydata"), "myfile.txt") == FileSystem::Success);
+
+    // The target file must be served by another file system
+    FileSystem::SpliceInfo info;
+    info.pid        = fs.m_pid;
+    info.inode      = 1;
+    info.offset     = 0;
+    info.chunkSize  = 0;
+    info.headerSize = 0;
+
+    FileSystemMessage msg;
+    msg.from   = fs.m_pid;
+    msg.action = FileSystem::SpliceFile;
+    msg.inode  = inode;
+    msg.buffer = (char *) &info;
+    msg.size   = 6;
+    msg.offset = 0;
+    fs.pathHandler(&msg);
+
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::InvalidArgument);
+
+    // Headers cannot exceed the maximum header size
+    info.pid        = ROOTFS_PID;
+    info.headerSize = FileSystem::SpliceHeaderSize + 1;
+    msg.size        = 6;
+    fs.pathHandler(&msg);
+
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::InvalidArgument);
+
+    // The host has no bulk buffers to splice through
+    info.headerSize = 0;
+    msg.size        = 6;
+    fs.pathHandler(&msg);
+
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::NotSupported);
+
+    return OK;
+}
+
 TestCase(FileSystemServerWriteFile)
 {
     DummyFileSystem fs(new Directory(1), "/mnt");
@@ -295,6 +472,7 @@ TestCase(FileSystemServerDeleteFile)
     // Receive response
     testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
     testAssert(msg.result == FileSystem::NotFound);
+    const u32 generation = msg.generation;
 
     // Add the file
     const u32 inode = fs.getNextInode();
@@ -304,9 +482,10 @@ TestCase(FileSystemServerDeleteFile)
     // Send another request
     fs.pathHandler(&msg);
 
-    // Receive response
+    // Receive response, which reports the change
     testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
     testAssert(msg.result == FileSystem::Success);
+    testAssert(msg.generation == generation + 1);
 
     // Read out the file again (should be removed)
     msg.action = FileSystem::ReadFile;
@@ -321,3 +500,199 @@ TestCase(FileSystemServerDeleteFile)
 
     return OK;
 }
+
+TestCase(FileSystemServerReadOnly)
+{
+    DummyFileSystem fs(new Directory(1), "/mnt");
+    String path("/mnt/myfile.txt");
+    String buf("something");
+    char buf2[128];
+    FileSystemMessage msg;
+
+    // Add the file
+    const u32 inode = fs.getNextInode();
+    File *file = new PseudoFile(inode, "original");
+    testAssert(fs.registerFile(file, "myfile.txt") == FileSystem::Success);
+    fs.setReadOnly(true);
+
+    // Writing is refused
+    msg.from   = fs.m_pid;
+    msg.action = FileSystem::WriteFile;
+    msg.inode  = inode;
+    msg.buffer = *buf;
+    msg.size   = buf.length();
+    msg.offset = 0;
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::PermissionDenied);
+
+    // Deleting is refused
+    msg.action = FileSystem::DeleteFile;
+    msg.buffer = *path;
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::PermissionDenied);
+
+    // Reading still works and returns the unmodified content
+    msg.action = FileSystem::ReadFile;
+    msg.inode  = inode;
+    msg.buffer = buf2;
+    msg.size   = sizeof(buf2);
+    msg.offset = 0;
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(msg.size == 8);
+    buf2[msg.size] = 0;
+    testString(buf2, "original");
+
+    return OK;
+}
+
+/**
+ * Find a record in a ReadDirectory response.
+ */
+static const FileSystem::DirectoryRecord * findRecord(const u8 *buf, const Size size, const char *name)
+{
+    for (Size pos = 0; pos < size; pos += ((const FileSystem::DirectoryRecord *) (buf + pos))->length)
+    {
+        const FileSystem::DirectoryRecord *record = (const FileSystem::DirectoryRecord *) (buf + pos);
+        const char *recordName = (const char *) (record + 1) +
+                                 (record->flags & FileSystem::RecordStat ? sizeof(FileSystem::FileStat) : 0);
+
+        if (MemoryBlock::compare(recordName, name))
+        {
+            return record;
+        }
+    }
+
+    return ZERO;
+}
+
+TestCase(FileSystemServerReadDirectory)
+{
+    DummyFileSystem fs(new Directory(1), "/mnt");
+    u8 buf[FileSystem::DirectoryBufferSize];
+    const FileSystem::DirectoryRecord *record;
+    FileSystemMessage msg;
+
+    testAssert(fs.registerFile(new File(fs.getNextInode(), FileSystem::RegularFile, 1, 2), "a.txt") == FileSystem::Success);
+    testAssert(fs.registerFile(new File(fs.getNextInode(), FileSystem::RegularFile, 3, 4), "b.txt") == FileSystem::Success);
+    testAssert(fs.registerDirectory(new Directory(fs.getNextInode()), "sub") == FileSystem::Success);
+
+    // Read all entries including their status
+    MemoryBlock::copy(buf, "/mnt", 5);
+    msg.from   = fs.m_pid;
+    msg.action = FileSystem::ReadDirectoryPlus;
+    msg.buffer = (char *) buf;
+    msg.size   = sizeof(buf);
+    msg.offset = 0;
+    fs.pathHandler(&msg);
+
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(msg.offset == 0);
+    testAssert(findRecord(buf, msg.size, ".") != ZERO);
+    testAssert(findRecord(buf, msg.size, "..") != ZERO);
+    testAssert(findRecord(buf, msg.size, "sub")->type == FileSystem::DirectoryFile);
+
+    record = findRecord(buf, msg.size, "b.txt");
+    testAssert(record != ZERO);
+    testAssert(record->type == FileSystem::RegularFile);
+    testAssert(record->nameLength == 5);
+    testAssert(record->flags & FileSystem::RecordStat);
+    testAssert(((const FileSystem::FileStat *) (record + 1))->userID == 3);
+    testAssert(((const FileSystem::FileStat *) (record + 1))->pid == fs.m_self);
+
+    // Read entries without status, two records at a time
+    Size total = 0, requests = 0;
+    msg.offset = 0;
+
+    do
+    {
+        MemoryBlock::copy(buf, "/mnt", 5);
+        msg.action = FileSystem::ReadDirectory;
+        msg.buffer = (char *) buf;
+        msg.size   = sizeof(FileSystem::DirectoryRecord) * 4;
+        fs.pathHandler(&msg);
+
+        testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+        testAssert(msg.result == FileSystem::Success);
+
+        for (Size pos = 0; pos < msg.size; pos += ((FileSystem::DirectoryRecord *) (buf + pos))->length)
+        {
+            testAssert(!(((FileSystem::DirectoryRecord *) (buf + pos))->flags & FileSystem::RecordStat));
+            total++;
+        }
+        requests++;
+    }
+    while (msg.offset != 0 && requests < 10);
+
+    testAssert(total == 5);
+    testAssert(requests == 3);
+
+    // Files are not directories
+    MemoryBlock::copy(buf, "/mnt/a.txt", 11);
+    msg.action = FileSystem::ReadDirectory;
+    msg.size   = sizeof(buf);
+    msg.offset = 0;
+    fs.pathHandler(&msg);
+
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::NotSupported);
+
+    return OK;
+}
+
+TestCase(FileSystemServerRetryFile)
+{
+    DummyFileSystem fs(new Directory(1), "/mnt");
+    BlockingFile *first = new BlockingFile(fs.getNextInode());
+    BlockingFile *second = new BlockingFile(fs.getNextInode());
+    testAssert(fs.registerFile(first, "first") == FileSystem::Success);
+    testAssert(fs.registerFile(second, "second") == FileSystem::Success);
+
+    // Read both files, which blocks
+    char buf[16];
+    FileSystemMessage msg;
+    msg.from   = fs.m_pid;
+    msg.action = FileSystem::ReadFile;
+    msg.inode  = first->getInode();
+    msg.buffer = buf;
+    msg.size   = sizeof(buf);
+    msg.offset = 0;
+    fs.pathHandler(&msg);
+    msg.inode  = second->getInode();
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::NotFound);
+    testAssert(fs.m_requests.count() == 0);
+    testAssert(fs.m_waiters.count() == 2);
+
+    // Data on the second file does not complete requests without notification
+    second->m_available = true;
+    testAssert(fs.retryRequests() == false);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::NotFound);
+
+    // Only the requests of the notified file are retried
+    first->m_available = true;
+    first->notifyReady();
+    testAssert(fs.m_readyFiles.count() == 1);
+    testAssert(fs.retryRequests() == false);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(msg.inode == first->getInode());
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::NotFound);
+    testAssert(fs.m_waiters.count() == 1);
+    testAssert(fs.m_waiters.contains(second->getInode()));
+
+    // Notify all files
+    fs.notifyAllFiles();
+    testAssert(fs.retryRequests() == false);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(msg.inode == second->getInode());
+    testAssert(fs.m_waiters.count() == 0);
+    testAssert(fs.m_readyFiles.count() == 0);
+
+    return OK;
+}
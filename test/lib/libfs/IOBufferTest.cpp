@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <IOBuffer.h>
+
+TestCase(IOBufferWriteVector)
+{
+    char remote[64 + 1];
+    const char *header = "head", *payload = "payload";
+    FileSystemMessage msg;
+    IOBuffer::Segment segments[2];
+
+    MemoryBlock::set(remote, 0, sizeof(remote));
+
+    // Use an unaligned remote buffer, which is copied with VMCopyVector()
+    msg.from   = SELF;
+    msg.action = FileSystem::ReadFile;
+    msg.buffer = remote + 1;
+    msg.size   = 64;
+    IOBuffer io(&msg);
+
+    segments[0].buffer = (Address) header;
+    segments[0].size   = 4;
+    segments[0].offset = 0;
+    segments[1].buffer = (Address) payload;
+    segments[1].size   = 7;
+    segments[1].offset = 8;
+
+    testAssert(io.writeVector(segments, 2) == FileSystem::Success);
+    testAssert(MemoryBlock::compare(remote + 1, "head", 4));
+    testAssert(remote[5] == 0);
+    testAssert(MemoryBlock::compare(remote + 9, "payload", 7));
+    return OK;
+}
+
+TestCase(IOBufferReadVector)
+{
+    char remote[64 + 1] = "xheadXXXXpayload";
+    char first[4], second[7];
+    FileSystemMessage msg;
+    IOBuffer::Segment segments[IOBuffer::MaximumSegments + 1];
+
+    msg.from   = SELF;
+    msg.action = FileSystem::WriteFile;
+    msg.buffer = remote + 1;
+    msg.size   = 64;
+    IOBuffer io(&msg);
+
+    // More segments than a single VMCopyVector() call takes
+    for (Size i = 0; i < IOBuffer::MaximumSegments; i++)
+    {
+        segments[i].buffer = (Address) first;
+        segments[i].size   = 4;
+        segments[i].offset = 0;
+    }
+    segments[IOBuffer::MaximumSegments].buffer = (Address) second;
+    segments[IOBuffer::MaximumSegments].size   = 7;
+    segments[IOBuffer::MaximumSegments].offset = 8;
+
+    testAssert(io.readVector(segments, IOBuffer::MaximumSegments + 1) == FileSystem::Success);
+    testAssert(MemoryBlock::compare(first, "head", 4));
+    testAssert(MemoryBlock::compare(second, "payload", 7));
+    return OK;
+}
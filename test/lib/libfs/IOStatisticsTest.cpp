@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestCase.h>
+#include <TestMain.h>
+#include <IOStatistics.h>
+
+TestCase(IOStatisticsRecord)
+{
+    static IOStatistics stats;
+    stats.reset();
+
+    // Service times go into log2 buckets per operation
+    stats.record(FileSystem::ReadFile, FileSystem::Success, 512, 1, false);
+    stats.record(FileSystem::ReadFileBulk, FileSystem::Success, 1024, 1000, true);
+    stats.record(FileSystem::WriteFile, FileSystem::Success, 100, 1023, false);
+
+    const IOStatistics::Counters *r = &stats.operations[IOStatistics::Read];
+    testAssert(r->requests == 2);
+    testAssert(r->errors == 0);
+    testAssert(r->retried == 1);
+    testAssert(r->bytes == 1536);
+    testAssert(r->cycles == 1001);
+    testAssert(r->histogram[0] == 1);
+    testAssert(r->histogram[9] == 1);
+    testAssert(stats.operations[IOStatistics::Write].bytes == 100);
+    testAssert(stats.operations[IOStatistics::Write].histogram[9] == 1);
+
+    // Failed requests do not count transferred bytes
+    stats.record(FileSystem::ReadFile, FileSystem::IOError, 4096, 10, false);
+    testAssert(r->requests == 3);
+    testAssert(r->errors == 1);
+    testAssert(r->bytes == 1536);
+
+    // Very long service times are counted in the last bucket
+    stats.record(FileSystem::StatFile, FileSystem::Success, 0, ~0ULL, false);
+    testAssert(stats.operations[IOStatistics::Stat].histogram[IOStatistics::HistogramBuckets - 1] == 1);
+
+    // Redirected requests complete at another file system
+    stats.record(FileSystem::StatFile, FileSystem::RedirectRequest, 0, 10, false);
+    testAssert(stats.redirects == 1);
+    testAssert(stats.operations[IOStatistics::Stat].requests == 1);
+
+    stats.reset();
+    testAssert(stats.operations[IOStatistics::Read].requests == 0);
+    testAssert(stats.redirects == 0);
+
+    return OK;
+}
+
+TestCase(IOStatisticsOperation)
+{
+    testAssert(IOStatistics::getOperation(FileSystem::ReadFile) == IOStatistics::Read);
+    testAssert(IOStatistics::getOperation(FileSystem::SpliceFile) == IOStatistics::Read);
+    testAssert(IOStatistics::getOperation(FileSystem::WriteFileBulk) == IOStatistics::Write);
+    testAssert(IOStatistics::getOperation(FileSystem::StatFile) == IOStatistics::Stat);
+    testAssert(IOStatistics::getOperation(FileSystem::ReadDirectoryPlus) == IOStatistics::Readdir);
+    testAssert(IOStatistics::getOperation(FileSystem::CreateFile) == IOStatistics::Create);
+    testAssert(IOStatistics::getOperation(FileSystem::DeleteFile) == IOStatistics::Delete);
+    testAssert(IOStatistics::getOperation(FileSystem::WaitFileSystem) == IOStatistics::Other);
+
+    return OK;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestCase.h>
+#include <TestMain.h>
+#include <Directory.h>
+#include <NegativeLookupCache.h>
+#include <FileSystemPathTokenizer.h>
+
+static u32 nameHash(const char *name)
+{
+    return FileSystemPathTokenizer::hash(name, String::length(name));
+}
+
+TestCase(NegativeLookupCacheInsert)
+{
+    NegativeLookupCache cache;
+    FileCache dir(new Directory(1), "/", ZERO);
+    FileCache other(new Directory(2), "/", ZERO);
+
+    testAssert(cache.count() == 0);
+    testAssert(!cache.contains(&dir, "missing", 7, nameHash("missing")));
+
+    // Missing entries are remembered per directory
+    cache.insert(&dir, "missing", 7, nameHash("missing"));
+    testAssert(cache.count() == 1);
+    testAssert(cache.contains(&dir, "missing", 7, nameHash("missing")));
+    testAssert(!cache.contains(&dir, "missin", 6, nameHash("missin")));
+    testAssert(!cache.contains(&other, "missing", 7, nameHash("missing")));
+
+    // Inserting again does not add another entry
+    cache.insert(&dir, "missing", 7, nameHash("missing"));
+    testAssert(cache.count() == 1);
+
+    delete dir.file;
+    delete other.file;
+    return OK;
+}
+
+TestCase(NegativeLookupCacheInvalidate)
+{
+    NegativeLookupCache cache;
+    FileCache dir(new Directory(1), "/", ZERO);
+    FileCache other(new Directory(2), "/", ZERO);
+
+    cache.insert(&dir, "first", 5, nameHash("first"));
+    cache.insert(&dir, "second", 6, nameHash("second"));
+    cache.insert(&other, "first", 5, nameHash("first"));
+    testAssert(cache.count() == 3);
+
+    // Created entry
+    cache.invalidate(&dir, "first", 5, nameHash("first"));
+    testAssert(cache.count() == 2);
+    testAssert(!cache.contains(&dir, "first", 5, nameHash("first")));
+    testAssert(cache.contains(&other, "first", 5, nameHash("first")));
+
+    // Removed directory
+    cache.invalidate(&dir);
+    testAssert(cache.count() == 1);
+    testAssert(!cache.contains(&dir, "second", 6, nameHash("second")));
+    testAssert(cache.contains(&other, "first", 5, nameHash("first")));
+
+    delete dir.file;
+    delete other.file;
+    return OK;
+}
+
+TestCase(NegativeLookupCacheLRU)
+{
+    NegativeLookupCache cache;
+    FileCache dir(new Directory(1), "/", ZERO);
+    char names[NegativeLookupCache::MaximumEntries + 1][3];
+
+    for (Size i = 0; i < NegativeLookupCache::MaximumEntries + 1; i++)
+    {
+        names[i][0] = 'a' + (i / 26);
+        names[i][1] = 'a' + (i % 26);
+        names[i][2] = 0;
+    }
+
+    // Fill the cache
+    for (Size i = 0; i < NegativeLookupCache::MaximumEntries; i++)
+        cache.insert(&dir, names[i], 2, nameHash(names[i]));
+    testAssert(cache.count() == NegativeLookupCache::MaximumEntries);
+
+    // Use the oldest entry, such that the second oldest is replaced
+    testAssert(cache.contains(&dir, names[0], 2, nameHash(names[0])));
+    cache.insert(&dir, names[NegativeLookupCache::MaximumEntries], 2,
+                 nameHash(names[NegativeLookupCache::MaximumEntries]));
+
+    testAssert(cache.count() == NegativeLookupCache::MaximumEntries);
+    testAssert(cache.contains(&dir, names[0], 2, nameHash(names[0])));
+    testAssert(!cache.contains(&dir, names[1], 2, nameHash(names[1])));
+    testAssert(cache.contains(&dir, names[2], 2, nameHash(names[2])));
+    testAssert(cache.contains(&dir, names[NegativeLookupCache::MaximumEntries], 2,
+                              nameHash(names[NegativeLookupCache::MaximumEntries])));
+
+    delete dir.file;
+    return OK;
+}
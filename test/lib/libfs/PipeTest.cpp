@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <FileDescriptor.h>
+#include <FileSystemClient.h>
+#include <Pipe.h>
+
+TestCase(PipeTransfer)
+{
+    Address buffer;
+    char data[16];
+    Size size;
+
+    testAssert(Pipe::create(buffer) == FileSystem::Success);
+    Pipe pipe(buffer);
+
+    size = 5;
+    testAssert(pipe.write("hello", &size) == FileSystem::Success);
+    testAssert(size == 5);
+
+    // Reads return the available bytes without waiting for more
+    size = sizeof(data);
+    testAssert(pipe.read(data, &size) == FileSystem::Success);
+    testAssert(size == 5);
+    testAssert(MemoryBlock::compare(data, "hello", 5));
+
+    pipe.release();
+    return OK;
+}
+
+TestCase(PipeWrapAround)
+{
+    Address buffer;
+    static u8 input[Pipe::DataSize], output[Pipe::DataSize];
+    Size size;
+
+    testAssert(Pipe::create(buffer) == FileSystem::Success);
+    Pipe pipe(buffer);
+
+    for (Size i = 0; i < sizeof(input); i++)
+        input[i] = i * 7;
+
+    // Move the indices near the end of the data
+    size = Pipe::DataSize - 10;
+    testAssert(pipe.write(input, &size) == FileSystem::Success);
+    testAssert(pipe.read(output, &size) == FileSystem::Success);
+    testAssert(size == Pipe::DataSize - 10);
+
+    // Fill the whole buffer, wrapping around its end
+    size = Pipe::DataSize;
+    testAssert(pipe.write(input, &size) == FileSystem::Success);
+    testAssert(size == Pipe::DataSize);
+
+    size = Pipe::DataSize;
+    testAssert(pipe.read(output, &size) == FileSystem::Success);
+    testAssert(size == Pipe::DataSize);
+    testAssert(MemoryBlock::compare(input, output, Pipe::DataSize));
+
+    pipe.release();
+    return OK;
+}
+
+TestCase(PipeClosedEnds)
+{
+    Address buffer;
+    char data[16];
+    Size size;
+
+    testAssert(Pipe::create(buffer) == FileSystem::Success);
+    Pipe pipe(buffer);
+
+    // Pending data is read before end-of-file
+    size = 3;
+    testAssert(pipe.write("abc", &size) == FileSystem::Success);
+    pipe.detach(true);
+
+    size = sizeof(data);
+    testAssert(pipe.read(data, &size) == FileSystem::Success);
+    testAssert(size == 3);
+    size = sizeof(data);
+    testAssert(pipe.read(data, &size) == FileSystem::Success);
+    testAssert(size == 0);
+
+    // Writing without any read end fails
+    pipe.attach(true);
+    pipe.detach(false);
+    size = 3;
+    testAssert(pipe.write("abc", &size) == FileSystem::IOError);
+
+    pipe.release();
+    return OK;
+}
+
+TestCase(PipeDescriptors)
+{
+    FileDescriptor::Entry entries[8];
+    const FileSystemClient filesystem;
+    Size readEnd, writeEnd;
+    char data[16];
+    Size size;
+
+    MemoryBlock::set(entries, 0, sizeof(entries));
+    FileDescriptor::instance()->setArray(entries, 8);
+
+    testAssert(filesystem.createPipe(readEnd, writeEnd) == FileSystem::Success);
+    testAssert(entries[readEnd].pipe == entries[writeEnd].pipe);
+    testAssert(!entries[readEnd].writer);
+    testAssert(entries[writeEnd].writer);
+
+    // Each end only transfers in its own direction
+    size = 4;
+    testAssert(filesystem.writeFile(writeEnd, "pipe", &size) == FileSystem::Success);
+    testAssert(filesystem.writeFile(readEnd, "pipe", &size) == FileSystem::InvalidArgument);
+
+    // A duplicated write end keeps the pipe open
+    testAssert(filesystem.duplicateFile(writeEnd, 5) == FileSystem::Success);
+    testAssert(filesystem.closeFile(writeEnd) == FileSystem::Success);
+
+    size = sizeof(data);
+    testAssert(filesystem.readFile(readEnd, data, &size) == FileSystem::Success);
+    testAssert(size == 4);
+
+    testAssert(filesystem.closeFile(5) == FileSystem::Success);
+    size = sizeof(data);
+    testAssert(filesystem.readFile(readEnd, data, &size) == FileSystem::Success);
+    testAssert(size == 0);
+
+    filesystem.closeFiles();
+    for (Size i = 0; i < 8; i++)
+    {
+        testAssert(!entries[i].open);
+    }
+
+    FileDescriptor::instance()->setArray(ZERO, 0);
+    return OK;
+}
@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <Callback.h>
+#include <StorageQueue.h>
+
+/**
+ * Storage in memory, which completes requests only when asked to.
+ */
+class MemoryStorage : public Storage
+{
+  public:
+
+    MemoryStorage(const bool async)
+        : m_async(async)
+        , m_inflight(ZERO)
+        , m_transfers(0)
+    {
+        for (Size i = 0; i < sizeof(m_data); i++)
+            m_data[i] = i & 0xff;
+    }
+
+    virtual FileSystem::Result initialize()
+    {
+        return FileSystem::Success;
+    }
+
+    virtual FileSystem::Result read(const u64 offset, void *buffer, const Size size) const
+    {
+        MemoryBlock::copy(buffer, m_data + offset, size);
+        return FileSystem::Success;
+    }
+
+    virtual FileSystem::Result write(const u64 offset, void *buffer, const Size size)
+    {
+        MemoryBlock::copy(m_data + offset, buffer, size);
+        return FileSystem::Success;
+    }
+
+    virtual FileSystem::Result submit(Request *req)
+    {
+        m_offsets[m_transfers] = req->offset;
+        m_sizes[m_transfers]   = req->size;
+        m_transfers++;
+
+        if (!m_async)
+            return Storage::submit(req);
+
+        m_inflight = req;
+        return FileSystem::Success;
+    }
+
+    virtual FileSystem::Result wait()
+    {
+        while (m_inflight)
+            completeNext();
+
+        return FileSystem::Success;
+    }
+
+    virtual u64 capacity() const
+    {
+        return sizeof(m_data);
+    }
+
+    void completeNext()
+    {
+        Request *req = m_inflight;
+        m_inflight = ZERO;
+
+        if (req->operation == Read)
+            req->result = read(req->offset, req->buffer, req->size);
+        else
+            req->result = write(req->offset, req->buffer, req->size);
+
+        complete(req);
+    }
+
+    bool m_async;
+    Request *m_inflight;
+    Size m_transfers;
+    u64 m_offsets[16];
+    Size m_sizes[16];
+    u8 m_data[16 * 1024];
+};
+
+/**
+ * Counts completed requests.
+ */
+class Completion
+{
+  public:
+
+    Completion()
+        : callback(this, &Completion::done)
+        , count(0)
+    {
+    }
+
+    void done(Storage::Request *req)
+    {
+        count++;
+    }
+
+    void prepare(Storage::Request *req, const Storage::Operation operation,
+                 const u64 offset, u8 *buffer, const Size size)
+    {
+        req->operation = operation;
+        req->offset    = offset;
+        req->buffer    = buffer;
+        req->size      = size;
+        req->result    = FileSystem::IOError;
+        req->callback  = &callback;
+        req->next      = ZERO;
+    }
+
+    Callback<Completion, Storage::Request> callback;
+    Size count;
+};
+
+TestCase(StorageQueueSynchronous)
+{
+    MemoryStorage storage(false);
+    StorageQueue queue(&storage);
+    Completion completion;
+    Storage::Request req;
+    u8 buffer[64];
+
+    // Storage which completes inside submit()
+    completion.prepare(&req, Storage::Read, 128, buffer, sizeof(buffer));
+    testAssert(queue.submit(&req) == FileSystem::Success);
+    testAssert(completion.count == 1);
+    testAssert(req.result == FileSystem::Success);
+    testAssert(buffer[0] == 128 && buffer[63] == 191);
+    testAssert(!queue.isBusy());
+    testAssert(queue.wait() == FileSystem::Success);
+
+    // Empty requests are rejected
+    completion.prepare(&req, Storage::Read, 0, buffer, 0);
+    testAssert(queue.submit(&req) == FileSystem::InvalidArgument);
+    testAssert(completion.count == 1);
+    return OK;
+}
+
+TestCase(StorageQueueMerge)
+{
+    MemoryStorage storage(true);
+    StorageQueue queue(&storage);
+    Completion completion;
+    Storage::Request req[5];
+    u8 buffers[5][1024];
+
+    // The first request goes to the storage directly
+    completion.prepare(&req[0], Storage::Read, 0, buffers[0], 1024);
+    testAssert(queue.submit(&req[0]) == FileSystem::Success);
+    testAssert(storage.m_transfers == 1);
+
+    // Queue out of order, while the storage is busy
+    completion.prepare(&req[1], Storage::Read, 8192, buffers[1], 1024);
+    completion.prepare(&req[2], Storage::Read, 5120, buffers[2], 1024);
+    completion.prepare(&req[3], Storage::Read, 4096, buffers[3], 1024);
+    completion.prepare(&req[4], Storage::Read, 6144, buffers[4], 1024);
+    for (Size i = 1; i < 5; i++)
+        testAssert(queue.submit(&req[i]) == FileSystem::Success);
+    testAssert(storage.m_transfers == 1);
+    testAssert(queue.isBusy());
+
+    // Contiguous requests are merged into a single transfer
+    storage.completeNext();
+    testAssert(completion.count == 1);
+    testAssert(storage.m_transfers == 2);
+    testAssert(storage.m_offsets[1] == 4096);
+    testAssert(storage.m_sizes[1] == 3072);
+    testAssert(queue.getMerged() == 2);
+
+    storage.completeNext();
+    testAssert(completion.count == 4);
+    testAssert(buffers[3][0] == 0 && buffers[3][1] == 1);
+    testAssert(buffers[2][0] == 0 && buffers[2][255] == 255);
+    testAssert(buffers[4][0] == 0 && buffers[4][1023] == 255);
+    for (Size i = 0; i < 5; i++)
+        testAssert(i == 1 || req[i].result == FileSystem::Success);
+
+    storage.completeNext();
+    testAssert(completion.count == 5);
+    testAssert(storage.m_transfers == 3);
+    testAssert(storage.m_offsets[2] == 8192);
+    testAssert(req[1].result == FileSystem::Success);
+    testAssert(!queue.isBusy());
+    return OK;
+}
+
+TestCase(StorageQueueElevator)
+{
+    MemoryStorage storage(true);
+    StorageQueue queue(&storage);
+    Completion completion;
+    Storage::Request req[4];
+    u8 buffers[4][512];
+
+    completion.prepare(&req[0], Storage::Read, 8192, buffers[0], 512);
+    completion.prepare(&req[1], Storage::Read, 1024, buffers[1], 512);
+    completion.prepare(&req[2], Storage::Read, 12288, buffers[2], 512);
+    completion.prepare(&req[3], Storage::Write, 10240, buffers[3], 512);
+    MemoryBlock::set(buffers[3], 0xaa, sizeof(buffers[3]));
+
+    for (Size i = 0; i < 4; i++)
+        testAssert(queue.submit(&req[i]) == FileSystem::Success);
+
+    // Continue upwards from the previous transfer, then wrap around
+    testAssert(queue.wait() == FileSystem::Success);
+    testAssert(completion.count == 4);
+    testAssert(storage.m_transfers == 4);
+    testAssert(storage.m_offsets[0] == 8192);
+    testAssert(storage.m_offsets[1] == 10240);
+    testAssert(storage.m_offsets[2] == 12288);
+    testAssert(storage.m_offsets[3] == 1024);
+    testAssert(storage.m_data[10240] == 0xaa && storage.m_data[10751] == 0xaa);
+    testAssert(queue.getMerged() == 0);
+    testAssert(!queue.isBusy());
+    return OK;
+}
+
+TestCase(StorageQueueMergeWrite)
+{
+    MemoryStorage storage(true);
+    StorageQueue queue(&storage);
+    Completion completion;
+    Storage::Request blocker, req[3];
+    u8 data[512], buffers[3][256];
+
+    completion.prepare(&blocker, Storage::Read, 0, data, sizeof(data));
+    testAssert(queue.submit(&blocker) == FileSystem::Success);
+
+    // Writes are merged with writes only
+    for (Size i = 0; i < 3; i++)
+    {
+        MemoryBlock::set(buffers[i], 0x10 + i, sizeof(buffers[i]));
+        completion.prepare(&req[i], i == 2 ? Storage::Read : Storage::Write,
+                           1024 + (i * 256), buffers[i], 256);
+        testAssert(queue.submit(&req[i]) == FileSystem::Success);
+    }
+
+    testAssert(queue.wait() == FileSystem::Success);
+    testAssert(completion.count == 4);
+    testAssert(storage.m_transfers == 3);
+    testAssert(storage.m_offsets[1] == 1024 && storage.m_sizes[1] == 512);
+    testAssert(storage.m_offsets[2] == 1536 && storage.m_sizes[2] == 256);
+    testAssert(storage.m_data[1024] == 0x10 && storage.m_data[1279] == 0x10);
+    testAssert(storage.m_data[1280] == 0x11 && storage.m_data[1535] == 0x11);
+    testAssert(buffers[2][0] == 0 && buffers[2][255] == 255);
+    return OK;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/Constant.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestCase.h>
+#include <TestMain.h>
+#include <MemoryChannel.h>
+#include <AdaptiveSpin.h>
+
+TestCase(AdaptiveSpinConstruct)
+{
+    AdaptiveSpin spin(1000);
+
+    testAssert(spin.m_limit == 1000);
+    testAssert(spin.getAverage() == 500);
+    testAssert(spin.getBudget() == 1000);
+
+    return OK;
+}
+
+TestCase(AdaptiveSpinFastMessages)
+{
+    AdaptiveSpin spin(1000);
+
+    // Budget converges to twice the latency of fast messages
+    for (Size i = 0; i < 100; i++)
+        spin.update(100);
+
+    testAssert(spin.getAverage() >= 100 && spin.getAverage() < 110);
+    testAssert(spin.getBudget() == spin.getAverage() * 2);
+
+    return OK;
+}
+
+TestCase(AdaptiveSpinSlowMessages)
+{
+    AdaptiveSpin spin(1000);
+
+    // Slow messages disable spinning
+    for (Size i = 0; i < 100; i++)
+        spin.update(1000000);
+
+    testAssert(spin.getAverage() > 500);
+    testAssert(spin.getBudget() == 0);
+
+    // Spinning resumes once messages are fast again
+    for (Size i = 0; i < 200; i++)
+        spin.update(10);
+
+    testAssert(spin.getBudget() > 0);
+    testAssert(spin.getBudget() <= 1000);
+
+    // A lower limit disables spinning again
+    spin.setLimit(spin.getAverage());
+    testAssert(spin.getBudget() == 0);
+
+    return OK;
+}
+
+TestCase(AdaptiveSpinRead)
+{
+    static u32 dataPage[PAGESIZE / sizeof(u32)] = { 0 };
+    static u32 feedbackPage[PAGESIZE / sizeof(u32)] = { 0 };
+    const u32 writeVal = 0x12345678;
+    u32 readVal = 0;
+
+    MemoryChannel prod(Channel::Producer, sizeof(u32));
+    MemoryChannel cons(Channel::Consumer, sizeof(u32));
+    AdaptiveSpin spin(1000);
+
+    testAssert(prod.setVirtual((const Address) &dataPage, (const Address) &feedbackPage) == MemoryChannel::Success);
+    testAssert(cons.setVirtual((const Address) &dataPage, (const Address) &feedbackPage) == MemoryChannel::Success);
+
+    // Empty channel is polled until the budget expires
+    testAssert(spin.read(&cons, &readVal) == Channel::NotFound);
+
+    // Available message is read directly and recorded
+    testAssert(prod.write(&writeVal) == Channel::Success);
+    testAssert(spin.read(&cons, &readVal) == Channel::Success);
+    testAssert(readVal == writeVal);
+    testAssert(spin.getBudget() == (spin.getAverage() <= 500 ? spin.getAverage() * 2 : 0));
+
+    return OK;
+}
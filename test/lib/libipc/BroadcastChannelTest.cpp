@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/Constant.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestCase.h>
+#include <TestMain.h>
+#include <BroadcastChannel.h>
+
+TestCase(BroadcastChannelSetVirtual)
+{
+    static u32 dataPage[PAGESIZE / sizeof(u32)];
+    BroadcastChannel prod(Channel::Producer, sizeof(u32));
+    BroadcastChannel cons(Channel::Consumer, sizeof(u32));
+    BroadcastChannel::BroadcastHead *head = (BroadcastChannel::BroadcastHead *) dataPage;
+
+    testAssert(sizeof(BroadcastChannel::BroadcastHead) == BroadcastChannel::CacheLineSize);
+
+    // Hard reset of the producer restarts the sequence
+    head->sequence = 123;
+    testAssert(prod.setVirtual((Address) dataPage) == Channel::Success);
+    testAssert(head->sequence == 0);
+    testAssert(prod.m_maximumMessages == (PAGESIZE - sizeof(*head)) / sizeof(u32));
+
+    // Soft reset continues at the published sequence
+    head->sequence = 456;
+    testAssert(prod.setVirtual((Address) dataPage, PAGESIZE, false) == Channel::Success);
+    testAssert(prod.m_cursor == 456);
+
+    // Consumers start at the published sequence
+    testAssert(cons.setVirtual((Address) dataPage) == Channel::Success);
+    testAssert(cons.m_cursor == 456);
+
+    // Data pages must hold at least two messages
+    testAssert(prod.setVirtual((Address) dataPage, sizeof(*head) + sizeof(u32)) == Channel::InvalidSize);
+
+    return OK;
+}
+
+TestCase(BroadcastChannelFanOut)
+{
+    static u32 dataPage[PAGESIZE / sizeof(u32)];
+    TestInt<uint> writeValues(UINT_MIN, UINT_MAX);
+    BroadcastChannel prod(Channel::Producer, sizeof(u32));
+    BroadcastChannel cons1(Channel::Consumer, sizeof(u32));
+    BroadcastChannel cons2(Channel::Consumer, sizeof(u32));
+    u32 values[16], readVal;
+    Size written;
+
+    testAssert(prod.setVirtual((Address) dataPage) == Channel::Success);
+    testAssert(cons1.setVirtual((Address) dataPage) == Channel::Success);
+    testAssert(cons2.setVirtual((Address) dataPage) == Channel::Success);
+
+    // Nothing published yet
+    testAssert(cons1.read(&readVal) == Channel::NotFound);
+    testAssert(cons1.write(&readVal) == Channel::InvalidMode);
+    testAssert(prod.read(&readVal) == Channel::InvalidMode);
+
+    // Publish once, both consumers receive all messages
+    for (Size i = 0; i < 16; i++)
+        values[i] = writeValues.random();
+    testAssert(prod.writeBatch(values, 16, written) == Channel::Success);
+    testAssert(written == 16);
+
+    for (Size i = 0; i < 16; i++)
+    {
+        testAssert(cons1.read(&readVal) == Channel::Success);
+        testAssert(readVal == values[i]);
+    }
+    testAssert(cons1.read(&readVal) == Channel::NotFound);
+
+    for (Size i = 0; i < 16; i++)
+    {
+        testAssert(cons2.read(&readVal) == Channel::Success);
+        testAssert(readVal == values[i]);
+    }
+    testAssert(cons2.read(&readVal) == Channel::NotFound);
+    testAssert(cons1.getLost() == 0);
+    testAssert(cons2.getLost() == 0);
+
+    // A late subscriber only sees new messages
+    BroadcastChannel cons3(Channel::Consumer, sizeof(u32));
+    testAssert(cons3.setVirtual((Address) dataPage) == Channel::Success);
+    testAssert(cons3.read(&readVal) == Channel::NotFound);
+    testAssert(prod.write(&values[0]) == Channel::Success);
+    testAssert(cons3.read(&readVal) == Channel::Success);
+    testAssert(readVal == values[0]);
+
+    return OK;
+}
+
+TestCase(BroadcastChannelOverrun)
+{
+    static u32 dataPage[PAGESIZE / sizeof(u32)];
+    BroadcastChannel prod(Channel::Producer, sizeof(u32));
+    BroadcastChannel cons(Channel::Consumer, sizeof(u32));
+    u32 readVal;
+
+    testAssert(prod.setVirtual((Address) dataPage) == Channel::Success);
+    testAssert(cons.setVirtual((Address) dataPage) == Channel::Success);
+
+    // The producer never waits for a slow consumer
+    const Size maximum = prod.m_maximumMessages;
+    for (u32 i = 0; i < maximum + 10; i++)
+        testAssert(prod.write(&i) == Channel::Success);
+
+    // Oldest messages are skipped, the last maximum minus one remain readable
+    for (u32 i = 11; i < maximum + 10; i++)
+    {
+        testAssert(cons.read(&readVal) == Channel::Success);
+        testAssert(readVal == i);
+    }
+    testAssert(cons.read(&readVal) == Channel::NotFound);
+    testAssert(cons.getLost() == 11);
+
+    return OK;
+}
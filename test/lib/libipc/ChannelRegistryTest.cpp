@@ -133,3 +133,28 @@ TestCase(ChannelRegistryProducer)
 
     return OK;
 }
+
+TestCase(ChannelRegistryBroadcast)
+{
+    ChannelRegistry reg;
+    Channel *bcast = new Channel(Channel::Producer, sizeof(u32));
+
+    // Initially we should be empty
+    testAssert(reg.getBroadcasts().count() == 0);
+    testAssert(reg.getBroadcast(1) == NULL);
+
+    // Broadcast channels are kept apart from the point-to-point channels
+    testAssert(reg.registerBroadcast(1, bcast) == ChannelRegistry::Success);
+    testAssert(reg.getBroadcast(1) == bcast);
+    testAssert(reg.getProducer(1) == NULL);
+    testAssert(reg.getConsumer(1) == NULL);
+    testAssert(reg.getBroadcasts().count() == 1);
+
+    // Remove the broadcast channel
+    testAssert(reg.unregisterBroadcast(2) == ChannelRegistry::NotFound);
+    testAssert(reg.unregisterBroadcast(1) == ChannelRegistry::Success);
+    testAssert(reg.getBroadcast(1) == NULL);
+    testAssert(reg.getBroadcasts().count() == 0);
+
+    return OK;
+}
@@ -192,6 +192,7 @@ TestCase(ChannelServerReadChannels)
     ProcessEvent event;
     event.type = ShareCreated;
     event.share.pid = pid;
+    event.share.tagId = 0;
     event.share.range.virt = (Address) &pages;
     testAssert(server.m_kernelProducer.write(&event) == MemoryChannel::Success);
     testAssert(server.m_kernelProducer.flush() == MemoryChannel::Success);
@@ -274,6 +275,7 @@ TestCase(ChannelServerShareCreated)
     ProcessEvent event;
     event.type = ShareCreated;
     event.share.pid = pid;
+    event.share.tagId = 0;
     event.share.range.virt = addr;
     testAssert(server.m_kernelProducer.write(&event) == MemoryChannel::Success);
     testAssert(server.m_kernelProducer.flush() == MemoryChannel::Success);
@@ -307,6 +309,30 @@ TestCase(ChannelServerShareCreated)
     return OK;
 }
 
+TestCase(ChannelServerShareCreatedTagged)
+{
+    DummyServer server;
+    const ProcessID pid = MAX_PROCS + 1234u;
+
+    // Raise event with a newly created share which is not a channel
+    ProcessEvent event;
+    event.type = ShareCreated;
+    event.share.pid = pid;
+    event.share.tagId = 1;
+    event.share.range.virt = 0x12340000;
+    testAssert(server.m_kernelProducer.write(&event) == MemoryChannel::Success);
+    testAssert(server.m_kernelProducer.flush() == MemoryChannel::Success);
+
+    // Process the event
+    server.readKernelEvents();
+
+    // No channels should be created
+    testAssert(ChannelClient::instance()->getRegistry().getProducer(pid) == ZERO);
+    testAssert(ChannelClient::instance()->getRegistry().getConsumer(pid) == ZERO);
+
+    return OK;
+}
+
 TestCase(ChannelServerInterruptEvent)
 {
     DummyServer server;
@@ -331,6 +357,7 @@ TestCase(ChannelServerInterruptEvent)
 
     // Now raise the registered IRQ once.
     event.number = DummyServer::DummyIrqVector;
+    event.timestamp = timestamp();
     testAssert(server.m_kernelProducer.write(&event) == MemoryChannel::Success);
     testAssert(server.m_kernelProducer.flush() == MemoryChannel::Success);
 
@@ -351,6 +378,9 @@ TestCase(ChannelServerInterruptEvent)
     testAssert(server.m_irqCount == 11);
     testAssert(server.m_irqValue == DummyServer::DummyIrqVector);
 
+    // The latency of each handled IRQ is recorded
+    testAssert(server.m_stats->interrupts.handled == 11);
+
     return OK;
 }
 
@@ -364,6 +394,7 @@ TestCase(ChannelServerProcessTerminated)
     ProcessEvent event;
     event.type = ShareCreated;
     event.share.pid = pid;
+    event.share.tagId = 0;
     event.share.range.virt = addr;
     testAssert(server.m_kernelProducer.write(&event) == MemoryChannel::Success);
     testAssert(server.m_kernelProducer.flush() == MemoryChannel::Success);
@@ -386,3 +417,112 @@ TestCase(ChannelServerProcessTerminated)
 
     return OK;
 }
+
+TestCase(ChannelServerFairness)
+{
+    DummyServer server;
+    const ProcessID chatty = MAX_PROCS + 2000u, quiet = MAX_PROCS + 2001u;
+    static u8 chattyPages[PAGESIZE * 4], quietPages[PAGESIZE * 4];
+    MemoryChannel chattyProducer(Channel::Producer, sizeof(DummyMessage));
+    MemoryChannel quietProducer(Channel::Producer, sizeof(DummyMessage));
+    Memory::Range range;
+
+    // Determine the producer pages of the clients by the PIDs
+    const Size offset = server.m_self < chatty ? PAGESIZE * 2 : 0;
+    MemoryBlock::set(chattyPages, 0, sizeof(chattyPages));
+    MemoryBlock::set(quietPages, 0, sizeof(quietPages));
+    chattyProducer.setVirtual((Address) chattyPages + offset, (Address) chattyPages + offset + PAGESIZE);
+    quietProducer.setVirtual((Address) quietPages + offset, (Address) quietPages + offset + PAGESIZE);
+
+    range.size = PAGESIZE * 4;
+    range.virt = (Address) chattyPages;
+    testAssert(server.accept(chatty, range) == DummyServer::Success);
+    range.virt = (Address) quietPages;
+    testAssert(server.accept(quiet, range) == DummyServer::Success);
+
+    // The chatty client queues more than two budgets of messages
+    DummyMessage msg;
+    msg.type   = ChannelMessage::Request;
+    msg.action = DummyServer::DummyIpcAction;
+    msg.value  = 1;
+    for (Size i = 0; i < (DummyServer::MessageBudget * 2) + 4; i++)
+        testAssert(chattyProducer.write(&msg) == MemoryChannel::Success);
+
+    // The quiet client is served in the first round
+    msg.value = 2;
+    testAssert(quietProducer.write(&msg) == MemoryChannel::Success);
+    server.readChannels();
+    testAssert(server.m_msgCount == DummyServer::MessageBudget + 1);
+    testAssert(server.m_ready.count() == 1);
+    testAssert(server.m_ready.contains(chatty));
+
+    // Remaining messages are read in later rounds
+    server.readChannels();
+    testAssert(server.m_msgCount == (DummyServer::MessageBudget * 2) + 1);
+    server.readChannels();
+    testAssert(server.m_msgCount == (DummyServer::MessageBudget * 2) + 5);
+    testAssert(server.m_ready.count() == 0);
+
+    // Statistics are kept per action
+    testAssert(server.m_stats->handlers[DummyServer::DummyIpcAction].handled == server.m_msgCount);
+    testAssert(server.m_stats->handlers[DummyServer::DummyIpcAction].maxDepth ==
+               (DummyServer::MessageBudget * 2) + 4);
+
+    ChannelClient::instance()->getRegistry().unregisterConsumer(chatty);
+    ChannelClient::instance()->getRegistry().unregisterProducer(chatty);
+    ChannelClient::instance()->getRegistry().unregisterConsumer(quiet);
+    ChannelClient::instance()->getRegistry().unregisterProducer(quiet);
+    return OK;
+}
+
+TestCase(ChannelServerTimeouts)
+{
+    DummyServer server;
+    Timer::Info expiry;
+    expiry.frequency = 100;
+
+    testAssert(!server.hasTimeout());
+
+    // Timeouts are kept sorted on their expiry
+    expiry.ticks = 200;
+    server.setExpiry(expiry);
+    expiry.ticks = 100;
+    server.setExpiry(expiry);
+    testAssert(server.hasTimeout());
+    testAssert(server.m_timeoutCount == 2);
+    testAssert(server.m_timeouts[0].expiry.ticks == 100);
+    testAssert(server.m_timeouts[1].expiry.ticks == 200);
+
+    // An overlapping window is merged into the intersection
+    expiry.ticks = 90;
+    server.setExpiry(expiry, 20);
+    testAssert(server.m_timeoutCount == 2);
+    testAssert(server.m_timeouts[0].expiry.ticks == 100);
+    testAssert(server.m_timeouts[0].slack == 0);
+
+    expiry.ticks = 150;
+    server.setExpiry(expiry, 30);
+    expiry.ticks = 170;
+    server.setExpiry(expiry, 30);
+    testAssert(server.m_timeoutCount == 3);
+    testAssert(server.m_timeouts[1].expiry.ticks == 170);
+    testAssert(server.m_timeouts[1].slack == 10);
+
+    // When full, a later timeout is absorbed by the earlier ones
+    for (Size i = 0; i < DummyServer::MaximumTimeouts; i++)
+    {
+        expiry.ticks = 300 + (i * 10);
+        server.setExpiry(expiry);
+    }
+    testAssert(server.m_timeoutCount == DummyServer::MaximumTimeouts);
+    testAssert(server.m_timeouts[DummyServer::MaximumTimeouts - 1].expiry.ticks == 340);
+
+    // An earlier timeout replaces the latest when full
+    expiry.ticks = 50;
+    server.setExpiry(expiry);
+    testAssert(server.m_timeoutCount == DummyServer::MaximumTimeouts);
+    testAssert(server.m_timeouts[0].expiry.ticks == 50);
+    testAssert(server.m_timeouts[DummyServer::MaximumTimeouts - 1].expiry.ticks == 330);
+
+    return OK;
+}
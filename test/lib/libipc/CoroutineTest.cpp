@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestCase.h>
+#include <TestMain.h>
+#include <Coroutine.h>
+#include <CoroutineScheduler.h>
+
+/**
+ * Simulated asynchronous read which completes after notify.
+ */
+static bool readDone = false;
+
+/**
+ * Reads twice and yields once in between.
+ */
+class ReadCoroutine : public Coroutine
+{
+  public:
+
+    ReadCoroutine(Size *steps, bool *deleted)
+        : m_steps(steps), m_deleted(deleted), m_count(0)
+    {
+    }
+
+    virtual ~ReadCoroutine()
+    {
+        *m_deleted = true;
+    }
+
+  protected:
+
+    virtual State run()
+    {
+        CO_BEGIN;
+
+        for (m_count = 0; m_count < 2; m_count++)
+        {
+            (*m_steps)++;
+            CO_AWAIT(&readDone, readDone);
+            readDone = false;
+        }
+
+        (*m_steps)++;
+        CO_YIELD();
+        (*m_steps)++;
+
+        CO_END;
+    }
+
+  private:
+
+    Size *m_steps;
+    bool *m_deleted;
+    Size m_count;
+};
+
+TestCase(CoroutineImmediate)
+{
+    Size steps = 0;
+    bool deleted = false;
+    ReadCoroutine co(&steps, &deleted);
+
+    // Condition already true: the await does not suspend
+    readDone = true;
+    testAssert(co.resume() == Coroutine::Waiting);
+    testAssert(steps == 2);
+    testAssert(co.getEvent() == (Address) &readDone);
+
+    readDone = true;
+    testAssert(co.resume() == Coroutine::Ready);
+    testAssert(steps == 3);
+    testAssert(co.getEvent() == 0);
+
+    testAssert(co.resume() == Coroutine::Finished);
+    testAssert(steps == 4);
+    testAssert(co.getState() == Coroutine::Finished);
+
+    return OK;
+}
+
+TestCase(CoroutineSchedulerNotify)
+{
+    CoroutineScheduler scheduler;
+    Size steps = 0;
+    bool deleted = false;
+    int other;
+
+    readDone = false;
+    scheduler.start(new ReadCoroutine(&steps, &deleted));
+    testAssert(steps == 1);
+    testAssert(scheduler.count() == 1);
+    testAssert(!scheduler.hasReady());
+
+    // Other events do not resume the coroutine
+    testAssert(scheduler.notify((Address) &other) == 0);
+    testAssert(!scheduler.hasReady());
+
+    // Notify without completion: resumes and waits again
+    testAssert(scheduler.notify((Address) &readDone) == 1);
+    testAssert(scheduler.runReady() == 1);
+    testAssert(steps == 1);
+    testAssert(!scheduler.hasReady());
+
+    readDone = true;
+    scheduler.notify((Address) &readDone);
+    testAssert(scheduler.runReady() == 1);
+    testAssert(steps == 2);
+
+    readDone = true;
+    scheduler.notifyAll();
+    testAssert(scheduler.runReady() == 1);
+    testAssert(steps == 3);
+
+    // Yielded coroutine runs once per round and is deleted when finished
+    testAssert(scheduler.hasReady());
+    testAssert(!deleted);
+    testAssert(scheduler.runReady() == 1);
+    testAssert(steps == 4);
+    testAssert(deleted);
+    testAssert(scheduler.count() == 0);
+
+    return OK;
+}
+
+TestCase(CoroutineSchedulerDestroy)
+{
+    Size steps = 0;
+    bool deleted = false;
+
+    readDone = false;
+    {
+        CoroutineScheduler scheduler;
+        scheduler.start(new ReadCoroutine(&steps, &deleted));
+        testAssert(scheduler.count() == 1);
+    }
+    testAssert(deleted);
+
+    return OK;
+}
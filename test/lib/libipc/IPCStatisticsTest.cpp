@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/Constant.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestCase.h>
+#include <TestMain.h>
+#include <IPCStatistics.h>
+
+TestCase(IPCStatisticsRecord)
+{
+    static IPCStatistics stats;
+    stats.reset();
+
+    // Service times go into log2 buckets
+    stats.record(2, 1, 1);
+    stats.record(2, 1000, 3);
+    stats.record(2, 1023, 2);
+
+    const IPCStatistics::Handler *h = &stats.handlers[2];
+    testAssert(h->handled == 3);
+    testAssert(h->cycles == 2024);
+    testAssert(h->totalDepth == 6);
+    testAssert(h->maxDepth == 3);
+    testAssert(h->histogram[0] == 1);
+    testAssert(h->histogram[9] == 2);
+
+    // Very long service times are counted in the last bucket
+    stats.record(3, ~0ULL, 1);
+    testAssert(stats.handlers[3].histogram[IPCStatistics::HistogramBuckets - 1] == 1);
+
+    // Unknown actions are counted separately
+    stats.record(IPCStatistics::MaximumActions, 10, 1);
+    testAssert(stats.unknown == 1);
+
+    // Interrupt latencies are counted separately from the actions
+    stats.recordInterrupt(100);
+    stats.recordInterrupt(150);
+    testAssert(stats.interrupts.handled == 2);
+    testAssert(stats.interrupts.cycles == 250);
+    testAssert(stats.interrupts.histogram[6] == 1);
+    testAssert(stats.interrupts.histogram[7] == 1);
+    testAssert(stats.handlers[2].handled == 3);
+
+    // Statistics must fit in the page shared with the root file system
+    testAssert(sizeof(IPCStatistics) <= PAGESIZE);
+
+    stats.reset();
+    testAssert(stats.handlers[2].handled == 0);
+    testAssert(stats.unknown == 0);
+    testAssert(stats.interrupts.handled == 0);
+
+    return OK;
+}
@@ -87,17 +87,20 @@ TestCase(MemoryChannelReadWriteSingle)
     // Write a single message
     testAssert(prod.write(&writeVal) == MemoryChannel::Success);
 
-    // Verify data page contents. First slot has the RingHead.
+    // Verify data page contents. First cache line has the RingHead.
     const MemoryChannel::RingHead *dataHead = (const MemoryChannel::RingHead *) &dataPage[0];
+    const Size firstSlot = sizeof(MemoryChannel::RingHead) / sizeof(u32);
+    testAssert(sizeof(MemoryChannel::RingHead) == MemoryChannel::CacheLineSize);
     testAssert(dataHead->index == 1);
 
-    // Actual message is saved starting at position 1.
-    testAssert(dataPage[1] == writeVal);
+    // Actual message is saved directly after the RingHead.
+    testAssert(dataPage[firstSlot] == writeVal);
 
     // Rest of the data page is still zero
-    for (Size i = 2; i < sizeof(dataPage) / sizeof(u32); i++)
+    for (Size i = 1; i < sizeof(dataPage) / sizeof(u32); i++)
     {
-        testAssert(dataPage[i] == 0);
+        if (i != firstSlot)
+            testAssert(dataPage[i] == 0);
     }
 
     // Verify feedback page, which should be unchanged at this point
@@ -189,8 +192,9 @@ TestCase(MemoryChannelReadWriteFull)
     MemoryChannel prod(Channel::Producer, sizeof(u32));
     MemoryChannel cons(Channel::Consumer, sizeof(u32));
 
-    // Maximum messages is minus 2, for the ringhead and index mechanism
-    const Size maxMessages = (sizeof(dataPage) / sizeof(u32)) - 2U;
+    // Maximum messages excludes the ringhead and one slot for the index mechanism
+    const Size firstSlot = sizeof(MemoryChannel::RingHead) / sizeof(u32);
+    const Size maxMessages = (sizeof(dataPage) / sizeof(u32)) - firstSlot - 1U;
 
     // First assign pages
     testAssert(prod.setVirtual((const Address) &dataPage, (const Address) &feedbackPage) == MemoryChannel::Success);
@@ -206,9 +210,9 @@ TestCase(MemoryChannelReadWriteFull)
         u32 writeVal = writeValues.random();
         testAssert(prod.write(&writeVal) == MemoryChannel::Success);
 
-        // Verify data page contents. First slot has the RingHead.
+        // Verify data page contents. First cache line has the RingHead.
         testAssert(dataHead->index == i + 1);
-        testAssert(dataPage[i + 1] == writeVal);
+        testAssert(dataPage[firstSlot + i] == writeVal);
     }
 
     // Attempt to write another message (must fail)
@@ -217,12 +221,17 @@ TestCase(MemoryChannelReadWriteFull)
     // Verify feedback page, which should be unchanged at this point
     testAssert(feedbackHead->index == 0);
 
+    // Both sides see all messages pending
+    testAssert(prod.pending() == maxMessages);
+    testAssert(cons.pending() == maxMessages);
+
     // Now start reading out all messages until empty
     for (Size i = 0; i < maxMessages; i++)
     {
         testAssert(cons.read(&readVal) == MemoryChannel::Success);
         testAssert(readVal == writeValues[i]);
         testAssert(feedbackHead->index == i + 1);
+        testAssert(cons.pending() == maxMessages - i - 1);
     }
 
     // Channel is now empty again
@@ -232,6 +241,61 @@ TestCase(MemoryChannelReadWriteFull)
     return OK;
 }
 
+TestCase(MemoryChannelWriteBatch)
+{
+    static u32 dataPage[PAGESIZE / sizeof(u32)] = { 0 };
+    static u32 feedbackPage[PAGESIZE / sizeof(u32)] = { 0 };
+    static u32 writeVals[PAGESIZE / sizeof(u32)];
+    TestInt<uint> writeValues(UINT_MIN, UINT_MAX);
+    const Size firstSlot = sizeof(MemoryChannel::RingHead) / sizeof(u32);
+    const Size maxMessages = (sizeof(dataPage) / sizeof(u32)) - firstSlot - 1U;
+    Size written = 0;
+    u32 readVal;
+
+    MemoryChannel prod(Channel::Producer, sizeof(u32));
+    MemoryChannel cons(Channel::Consumer, sizeof(u32));
+
+    // First assign pages
+    testAssert(prod.setVirtual((const Address) &dataPage, (const Address) &feedbackPage) == MemoryChannel::Success);
+    testAssert(cons.setVirtual((const Address) &dataPage, (const Address) &feedbackPage) == MemoryChannel::Success);
+
+    const MemoryChannel::RingHead *dataHead = (const MemoryChannel::RingHead *) &dataPage[0];
+
+    for (Size i = 0; i < maxMessages + 8U; i++)
+    {
+        writeVals[i] = writeValues.random();
+    }
+
+    // Write a small batch
+    testAssert(prod.writeBatch(writeVals, 8, written) == MemoryChannel::Success);
+    testAssert(written == 8);
+    testAssert(dataHead->index == 8);
+
+    for (Size i = 0; i < 8; i++)
+    {
+        testAssert(dataPage[firstSlot + i] == writeVals[i]);
+        testAssert(cons.read(&readVal) == MemoryChannel::Success);
+        testAssert(readVal == writeVals[i]);
+    }
+    testAssert(cons.read(&readVal) == MemoryChannel::NotFound);
+
+    // Write a batch larger than the channel can hold
+    testAssert(prod.writeBatch(writeVals + 8, maxMessages + 1U, written) == MemoryChannel::Success);
+    testAssert(written == maxMessages);
+    testAssert(prod.writeBatch(writeVals, 1, written) == MemoryChannel::ChannelFull);
+    testAssert(written == 0);
+
+    // Messages wrap around the end of the ring in order
+    for (Size i = 0; i < maxMessages; i++)
+    {
+        testAssert(cons.read(&readVal) == MemoryChannel::Success);
+        testAssert(readVal == writeVals[8 + i]);
+    }
+    testAssert(cons.read(&readVal) == MemoryChannel::NotFound);
+
+    return OK;
+}
+
 TestCase(MemoryChannelFlush)
 {
     static u32 dataPage[PAGESIZE / sizeof(u32)] = { 0 };
@@ -247,5 +311,10 @@ TestCase(MemoryChannelFlush)
     // Flushing must always succeed
     testAssert(cons.flush() == MemoryChannel::Success);
     testAssert(prod.flush() == MemoryChannel::Success);
+
+    // Coherent channels skip cache maintenance
+    MemoryChannel coherent(Channel::Producer, sizeof(u32), true);
+    testAssert(coherent.setVirtual((const Address) &dataPage, (const Address) &feedbackPage) == MemoryChannel::Success);
+    testAssert(coherent.flush() == MemoryChannel::Success);
     return OK;
 }
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/Constant.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestCase.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <RecordChannel.h>
+
+TestCase(RecordChannelSetVirtual)
+{
+    static u8 dataPage[PAGESIZE];
+    static u8 feedbackPage[PAGESIZE];
+    RecordChannel prod(Channel::Producer, 128);
+    RecordChannel large(Channel::Producer, PAGESIZE);
+
+    // Default data size is a single page
+    testAssert(prod.setVirtual((Address) dataPage, (Address) feedbackPage) == Channel::Success);
+    testAssert(prod.m_ringSize == PAGESIZE - sizeof(RecordChannel::RecordHead));
+    testAssert(sizeof(RecordChannel::RecordHead) == RecordChannel::CacheLineSize);
+
+    // Inline records up to a page need a larger data area
+    testAssert(large.setVirtual((Address) dataPage, (Address) feedbackPage) == Channel::InvalidSize);
+
+    // Soft reset restores the RecordHead from the data page for the producer
+    ((RecordChannel::RecordHead *) dataPage)->index = 64;
+    ((RecordChannel::RecordHead *) dataPage)->overflow = 3;
+    testAssert(prod.setVirtual((Address) dataPage, (Address) feedbackPage, PAGESIZE, false) == Channel::Success);
+    testAssert(prod.m_head.index == 64);
+    testAssert(prod.m_head.overflow == 3);
+
+    return OK;
+}
+
+TestCase(RecordChannelVariableLength)
+{
+    static u8 dataPage[PAGESIZE * 3];
+    static u8 feedbackPage[PAGESIZE];
+    static u8 writeBuf[PAGESIZE], readBuf[PAGESIZE];
+    TestInt<uint> lengths(1, PAGESIZE - 16);
+    Size length;
+
+    RecordChannel prod(Channel::Producer, PAGESIZE);
+    RecordChannel cons(Channel::Consumer, PAGESIZE);
+    MemoryBlock::set(dataPage, 0, sizeof(dataPage));
+    MemoryBlock::set(feedbackPage, 0, sizeof(feedbackPage));
+
+    testAssert(prod.setVirtual((Address) dataPage, (Address) feedbackPage, sizeof(dataPage)) == Channel::Success);
+    testAssert(cons.setVirtual((Address) dataPage, (Address) feedbackPage, sizeof(dataPage)) == Channel::Success);
+
+    for (Size i = 0; i < sizeof(writeBuf); i++)
+        writeBuf[i] = i * 7;
+
+    // Initially the channel is empty
+    testAssert(cons.readRecord(readBuf, sizeof(readBuf), length) == Channel::NotFound);
+
+    // Transfer records of random sizes, which wraps the ring several times
+    for (Size i = 0; i < 64; i++)
+    {
+        const Size len = lengths.random();
+        const Size offset = i % 16;
+
+        testAssert(prod.writeRecord(writeBuf + offset, len) == Channel::Success);
+        testAssert(cons.readRecord(readBuf, sizeof(readBuf), length) == Channel::Success);
+        testAssert(length == len);
+        testAssert(MemoryBlock::compare(readBuf, writeBuf + offset, length));
+        testAssert(cons.readRecord(readBuf, sizeof(readBuf), length) == Channel::NotFound);
+    }
+
+    return OK;
+}
+
+TestCase(RecordChannelFull)
+{
+    static u8 dataPage[PAGESIZE];
+    static u8 feedbackPage[PAGESIZE];
+    u8 record[56], readBuf[56];
+    Size length, count = 0;
+
+    RecordChannel prod(Channel::Producer, sizeof(record));
+    RecordChannel cons(Channel::Consumer, sizeof(record));
+    MemoryBlock::set(dataPage, 0, sizeof(dataPage));
+    MemoryBlock::set(feedbackPage, 0, sizeof(feedbackPage));
+
+    testAssert(prod.setVirtual((Address) dataPage, (Address) feedbackPage) == Channel::Success);
+    testAssert(cons.setVirtual((Address) dataPage, (Address) feedbackPage) == Channel::Success);
+
+    // Each record takes 64 bytes including the header, one alignment unit stays free
+    while (prod.writeRecord(record, sizeof(record)) == Channel::Success)
+        count++;
+    testAssert(count == ((PAGESIZE - sizeof(RecordChannel::RecordHead) - 8) / 64));
+
+    // The producer may continue after the consumer frees a record
+    testAssert(cons.read(readBuf) == Channel::Success);
+    testAssert(prod.write(record) == Channel::Success);
+    testAssert(prod.write(record) == Channel::ChannelFull);
+
+    // Records larger than the buffer are not consumed
+    testAssert(cons.readRecord(readBuf, 8, length) == Channel::InvalidSize);
+    testAssert(length == sizeof(record));
+    testAssert(cons.readRecord(readBuf, sizeof(readBuf), length) == Channel::Success);
+
+    // Larger records need overflow pages
+    u8 large[128];
+    testAssert(prod.writeRecord(large, sizeof(large)) == Channel::InvalidSize);
+
+    return OK;
+}
+
+TestCase(RecordChannelOverflow)
+{
+    static u8 dataPage[PAGESIZE];
+    static u8 feedbackPage[PAGESIZE];
+    static u8 overflowPages[PAGESIZE * 4];
+    static u8 writeBuf[PAGESIZE * 4], readBuf[PAGESIZE * 4];
+    u8 small[16];
+    Size length;
+
+    RecordChannel prod(Channel::Producer, sizeof(small));
+    RecordChannel cons(Channel::Consumer, sizeof(small));
+    MemoryBlock::set(dataPage, 0, sizeof(dataPage));
+    MemoryBlock::set(feedbackPage, 0, sizeof(feedbackPage));
+
+    testAssert(prod.setVirtual((Address) dataPage, (Address) feedbackPage) == Channel::Success);
+    testAssert(cons.setVirtual((Address) dataPage, (Address) feedbackPage) == Channel::Success);
+    testAssert(prod.setOverflow((Address) overflowPages, sizeof(overflowPages)) == Channel::Success);
+    testAssert(cons.setOverflow((Address) overflowPages, sizeof(overflowPages)) == Channel::Success);
+
+    for (Size i = 0; i < sizeof(writeBuf); i++)
+        writeBuf[i] = i * 3;
+    MemoryBlock::set(small, 0xaa, sizeof(small));
+
+    // Large record goes through the overflow pages, small records stay inline
+    testAssert(prod.writeRecord(writeBuf, sizeof(writeBuf)) == Channel::Success);
+    testAssert(prod.writeRecord(small, sizeof(small)) == Channel::Success);
+
+    // Only one overflow record can be pending
+    testAssert(prod.writeRecord(writeBuf, PAGESIZE) == Channel::ChannelFull);
+    testAssert(prod.writeRecord(writeBuf, sizeof(writeBuf) + 1) == Channel::InvalidSize);
+
+    testAssert(cons.readRecord(readBuf, sizeof(readBuf), length) == Channel::Success);
+    testAssert(length == sizeof(writeBuf));
+    testAssert(MemoryBlock::compare(readBuf, writeBuf, length));
+    testAssert(cons.m_head.overflow == 1);
+
+    // After acknowledgement the overflow pages are available again
+    testAssert(prod.writeRecord(writeBuf + 1, PAGESIZE) == Channel::Success);
+
+    testAssert(cons.readRecord(readBuf, sizeof(readBuf), length) == Channel::Success);
+    testAssert(length == sizeof(small));
+    testAssert(MemoryBlock::compare(readBuf, small, length));
+
+    testAssert(cons.readRecord(readBuf, sizeof(readBuf), length) == Channel::Success);
+    testAssert(length == PAGESIZE);
+    testAssert(MemoryBlock::compare(readBuf, writeBuf + 1, length));
+    testAssert(cons.readRecord(readBuf, sizeof(readBuf), length) == Channel::NotFound);
+
+    return OK;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <BenchmarkMain.h>
+#include <Benchmark.h>
+#include <InternetChecksum.h>
+
+/** Size of an Ethernet payload */
+#define PACKET_SIZE 1500
+
+static u8 packet[PACKET_SIZE + 1];
+
+/**
+ * Checksum of a full size packet at the given alignment.
+ */
+static void checksumPacket(const Size iterations, const Size offset)
+{
+    u16 result = 0;
+
+    for (Size i = 0; i < PACKET_SIZE; i++)
+        packet[i] = i * 7;
+
+    for (Size i = 0; i < iterations; i++)
+    {
+        benchmarkUse(packet);
+        result ^= InternetChecksum::checksum(packet + offset, PACKET_SIZE);
+    }
+    benchmarkUse(result);
+}
+
+BenchmarkCase(ChecksumAligned)
+{
+    checksumPacket(iterations, 0);
+}
+
+BenchmarkCase(ChecksumUnaligned)
+{
+    checksumPacket(iterations, 1);
+}
+
+BenchmarkCase(ChecksumUpdate)
+{
+    u16 result = 0xabcd;
+
+    for (Size i = 0; i < iterations; i++)
+        result = InternetChecksum::update(result, i, i + 1);
+
+    benchmarkUse(result);
+}
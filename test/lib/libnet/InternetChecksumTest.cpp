@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestCase.h>
+#include <TestMain.h>
+#include <ByteOrder.h>
+#include <InternetChecksum.h>
+
+/**
+ * Straightforward RFC 1071 checksum on big-endian words, as reference.
+ */
+static u16 referenceChecksum(const u8 *data, const Size length, u32 sum = 0)
+{
+    for (Size i = 0; i < length; i += 2)
+    {
+        sum += data[i] << 8;
+
+        if (i + 1 < length)
+            sum += data[i + 1];
+    }
+
+    while (sum >> 16)
+        sum = (sum & 0xffff) + (sum >> 16);
+
+    return ~sum;
+}
+
+TestCase(InternetChecksumHeader)
+{
+    // IPV4 header example with a known checksum of 0xb861
+    static const u8 header[] =
+    {
+        0x45, 0x00, 0x00, 0x73, 0x00, 0x00, 0x40, 0x00,
+        0x40, 0x11, 0x00, 0x00, 0xc0, 0xa8, 0x00, 0x01,
+        0xc0, 0xa8, 0x00, 0xc7
+    };
+    u8 buffer[sizeof(header)];
+
+    MemoryBlock::copy(buffer, header, sizeof(header));
+    const u16 sum = InternetChecksum::checksum(buffer, sizeof(buffer));
+    testAssert(readBe16(&sum) == 0xb861);
+
+    // Verifying a header including its checksum gives zero
+    write16(buffer + 10, sum);
+    testAssert(InternetChecksum::checksum(buffer, sizeof(buffer)) == 0);
+
+    return OK;
+}
+
+TestCase(InternetChecksumAlignment)
+{
+    static u8 buffer[1600];
+    TestInt<uint> bytes(0, 0xff);
+
+    for (Size i = 0; i < sizeof(buffer); i++)
+        buffer[i] = bytes.random();
+
+    // Compare against the reference for all alignments and odd lengths
+    for (Size offset = 0; offset < 8; offset++)
+    {
+        for (Size length = 0; length < 100; length++)
+        {
+            const u16 sum = InternetChecksum::checksum(buffer + offset, length);
+            testAssert(readBe16(&sum) == referenceChecksum(buffer + offset, length));
+        }
+
+        const Size length = sizeof(buffer) - offset;
+        const u16 sum = InternetChecksum::checksum(buffer + offset, length);
+        testAssert(readBe16(&sum) == referenceChecksum(buffer + offset, length));
+    }
+
+    return OK;
+}
+
+TestCase(InternetChecksumPseudoHeader)
+{
+    static u8 buffer[64];
+    static u8 pseudo[12] =
+    {
+        10, 0, 0, 1, 10, 0, 0, 2, 0, 17, 0, sizeof(buffer)
+    };
+    TestInt<uint> bytes(0, 0xff);
+
+    for (Size i = 0; i < sizeof(buffer); i++)
+        buffer[i] = bytes.random();
+
+    u32 partial = 0;
+    for (Size i = 0; i < sizeof(pseudo); i += 2)
+        partial += (pseudo[i] << 8) | pseudo[i + 1];
+
+    const u32 initial = InternetChecksum::pseudoHeader(read32(pseudo), read32(pseudo + 4),
+                                                       17, sizeof(buffer));
+    const u16 sum = InternetChecksum::checksum(buffer, sizeof(buffer), initial);
+    testAssert(readBe16(&sum) == referenceChecksum(buffer, sizeof(buffer), partial));
+
+    return OK;
+}
+
+TestCase(InternetChecksumFragments)
+{
+    static u8 buffer[3000];
+    TestInt<uint> bytes(0, 0xff);
+
+    for (Size i = 0; i < sizeof(buffer); i++)
+        buffer[i] = bytes.random();
+
+    // Chaining the sums of even sized chunks gives the sum of the whole, as for fragments
+    const u32 initial = InternetChecksum::pseudoHeader(0x0100000a, 0x0200000a, 17, sizeof(buffer) - 1);
+    u32 sum = initial;
+
+    for (Size offset = 0; offset < sizeof(buffer) - 1; offset += 1480)
+    {
+        const Size length = sizeof(buffer) - 1 - offset < 1480 ? sizeof(buffer) - 1 - offset : 1480;
+        sum = InternetChecksum::sum(buffer + offset, length, sum);
+    }
+
+    testAssert((u16) ~sum == InternetChecksum::checksum(buffer, sizeof(buffer) - 1, initial));
+
+    return OK;
+}
+
+TestCase(InternetChecksumUpdate)
+{
+    static u8 buffer[20];
+    TestInt<uint> bytes(0, 0xff);
+
+    for (Size i = 0; i < sizeof(buffer); i++)
+        buffer[i] = bytes.random();
+
+    // Checksum field at offset 10
+    write16(buffer + 10, 0);
+    u16 sum = InternetChecksum::checksum(buffer, sizeof(buffer));
+    write16(buffer + 10, sum);
+
+    // Change a 16-bit field, including to and from zero
+    static const u16 values[] = { 0x0000, 0x1234, 0xffff, 0x0000, 0xabcd };
+
+    for (Size i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+    {
+        const u16 previous = read16(buffer + 8);
+        write16(buffer + 8, values[i]);
+        sum = InternetChecksum::update(sum, previous, read16(buffer + 8));
+        write16(buffer + 10, sum);
+        testAssert(InternetChecksum::checksum(buffer, sizeof(buffer)) == 0);
+    }
+
+    // Change a 32-bit address field
+    const u32 previous = read32(buffer + 12);
+    write32(buffer + 12, 0xc0a80001);
+    sum = InternetChecksum::update32(sum, previous, read32(buffer + 12));
+    write16(buffer + 10, sum);
+    testAssert(InternetChecksum::checksum(buffer, sizeof(buffer)) == 0);
+
+    return OK;
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestCase.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <SocketRing.h>
+
+TestCase(SocketRingSetBase)
+{
+    static u8 memory[SocketRing::SlotSize * 4];
+    SocketRing ring;
+
+    // Too small for the header and minimum number of slots
+    testAssert(!ring.setBase((Address) memory, SocketRing::SlotSize * 2, true));
+    testAssert(!ring.isValid());
+    testAssert(!ring.setBase(0, sizeof(memory), true));
+    testAssert(ring.reserve() == ZERO);
+
+    // The first slot holds the indices
+    MemoryBlock::set(memory, 0xff, sizeof(memory));
+    testAssert(ring.setBase((Address) memory, sizeof(memory), true));
+    testAssert(ring.isValid());
+    testAssert(ring.getSlots() == 3);
+    testAssert(ring.getPayloadSize() == SocketRing::SlotSize - sizeof(SocketRing::Slot));
+    testAssert(ring.getDrops() == 0);
+    testAssert(!ring.hasData());
+    return OK;
+}
+
+TestCase(SocketRingProduceConsume)
+{
+    static u8 memory[SocketRing::SlotSize * 4];
+    SocketRing producer, consumer;
+
+    testAssert(consumer.setBase((Address) memory, sizeof(memory), true));
+    testAssert(producer.setBase((Address) memory, sizeof(memory), false));
+    testAssert(consumer.front() == ZERO);
+
+    // Fill the ring
+    for (u16 i = 0; i < 3; i++)
+    {
+        SocketRing::Slot *slot = producer.reserve();
+        testAssert(slot != ZERO);
+        slot->address = 0x0a000001;
+        slot->port    = 1000 + i;
+        slot->size    = i + 1;
+        MemoryBlock::set(slot + 1, 'a' + i, slot->size);
+        producer.push();
+    }
+
+    // Full ring drops datagrams
+    testAssert(producer.reserve() == ZERO);
+    testAssert(consumer.getDrops() == 1);
+
+    // Consume in order and reuse slots
+    for (u16 i = 0; i < 5; i++)
+    {
+        const SocketRing::Slot *slot = consumer.front();
+        testAssert(consumer.hasData());
+        testAssert(slot != ZERO);
+        testAssert(slot->port == 1000 + i);
+        testAssert(slot->size == i + 1);
+        testAssert(((const u8 *) (slot + 1))[i] == 'a' + i);
+        consumer.pop();
+
+        SocketRing::Slot *next = producer.reserve();
+        testAssert(next != ZERO);
+        next->address = 0x0a000001;
+        next->port    = 1003 + i;
+        next->size    = i + 4;
+        MemoryBlock::set(next + 1, 'd' + i, next->size);
+        producer.push();
+    }
+
+    testAssert(consumer.hasData());
+    testAssert(consumer.getDrops() == 1);
+    return OK;
+}
+
+TestCase(SocketRingSlotSize)
+{
+    static u8 memory[SocketRing::SlotSize * 8];
+    SocketRing producer, consumer;
+
+    // Slot sizes out of range or unaligned are rejected
+    testAssert(!consumer.setBase((Address) memory, sizeof(memory), true, SocketRing::SlotSize - 4));
+    testAssert(!consumer.setBase((Address) memory, sizeof(memory), true, SocketRing::SlotSize + 2));
+    testAssert(!consumer.setBase((Address) memory, sizeof(memory), true, SocketRing::MaximumSlotSize * 2));
+
+    // The producer uses the slot size chosen by the consumer
+    testAssert(consumer.setBase((Address) memory, sizeof(memory), true, SocketRing::SlotSize * 2));
+    testAssert(producer.setBase((Address) memory, sizeof(memory), false));
+    testAssert(producer.getSlots() == 3);
+    testAssert(producer.getPayloadSize() == (SocketRing::SlotSize * 2) - sizeof(SocketRing::Slot));
+
+    SocketRing::Slot *slot = producer.reserve();
+    testAssert(slot != ZERO);
+    testAssert((u8 *) slot == memory + (SocketRing::SlotSize * 2));
+    slot->size = producer.getPayloadSize();
+    producer.push();
+
+    testAssert(consumer.front() == slot);
+    testAssert(consumer.front()->size == consumer.getPayloadSize());
+
+    // A corrupted slot size is rejected by the producer
+    MemoryBlock::set(memory + 12, 0xff, sizeof(u32));
+    testAssert(!producer.setBase((Address) memory, sizeof(memory), false));
+    testAssert(!producer.isValid());
+    return OK;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <FileSystemClient.h>
+#include <errno.h>
+#include <poll.h>
+
+TestCase(PollInvalidDescriptor)
+{
+    struct pollfd fds[2];
+
+    fds[0].fd = -1;
+    fds[0].events = POLLIN;
+    fds[0].revents = POLLIN;
+    fds[1].fd = 1000;
+    fds[1].events = POLLIN;
+    fds[1].revents = 0;
+
+    // Invalid descriptors are reported without waiting
+    testAssert(poll(fds, 2, -1) == 1);
+    testAssert(fds[0].revents == 0);
+    testAssert(fds[1].revents == POLLNVAL);
+    return OK;
+}
+
+TestCase(PollTooManyDescriptors)
+{
+    static struct pollfd fds[FileSystemClient::MaximumWaitDescriptors + 1];
+
+    for (Size i = 0; i < FileSystemClient::MaximumWaitDescriptors + 1; i++)
+    {
+        fds[i].fd = -1;
+        fds[i].events = POLLIN;
+    }
+
+    errno = 0;
+    testAssert(poll(fds, FileSystemClient::MaximumWaitDescriptors + 1, 0) == -1);
+    testAssert(errno == EINVAL);
+
+    // Entries with negative descriptors are ignored
+    testAssert(poll(fds, FileSystemClient::MaximumWaitDescriptors, 0) == 0);
+    return OK;
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <FileSystemClient.h>
+#include <MemoryBlock.h>
+#include <String.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/** File used by the tests. */
+#define STDIO_TEST_FILE "/tmp/stdiotest.txt"
+
+/**
+ * Create an empty file and open it as a stream.
+ */
+static FILE * createStream()
+{
+    const FileSystemClient fs;
+
+    fs.deleteFile(STDIO_TEST_FILE);
+    if (fs.createFile(STDIO_TEST_FILE, FileSystem::RegularFile, FileSystem::OwnerRW) != FileSystem::Success)
+        return ZERO;
+
+    return fopen(STDIO_TEST_FILE, "r");
+}
+
+/**
+ * Get the current size of the test file.
+ */
+static off_t fileSize()
+{
+    struct stat st;
+
+    if (stat(STDIO_TEST_FILE, &st) != 0)
+        return -1;
+
+    return st.st_size;
+}
+
+TestCase(StdioSetvbufInvalid)
+{
+    FILE *fp = createStream();
+    char buf[16];
+
+    testAssert(fp != ZERO);
+    testAssert(setvbuf(fp, buf, 12345, sizeof(buf)) != 0);
+    testAssert(setvbuf(fp, buf, _IOFBF, 0) != 0);
+    testAssert(setvbuf(fp, buf, _IOFBF, sizeof(buf)) == 0);
+    testAssert(fclose(fp) == 0);
+    return OK;
+}
+
+TestCase(StdioFullyBuffered)
+{
+    FILE *fp = createStream();
+    char buf[16], output[32];
+
+    testAssert(fp != ZERO);
+    testAssert(setvbuf(fp, buf, _IOFBF, sizeof(buf)) == 0);
+
+    // Small writes stay in the buffer until it is flushed
+    testAssert(fwrite("0123456789", 1, 10, fp) == 10);
+    testAssert(fileSize() == 0);
+    testAssert(fflush(fp) == 0);
+    testAssert(fileSize() == 10);
+
+    // Writes which do not fit write out the buffer first
+    testAssert(fwrite("abcdefgh", 1, 8, fp) == 8);
+    testAssert(fwrite("ijklmnop", 1, 8, fp) == 8);
+    testAssert(fileSize() == 18);
+    testAssert(fflush(fp) == 0);
+    testAssert(fileSize() == 26);
+
+    // Read back the contents through the buffer
+    testAssert(lseek(fp->fd, 0, SEEK_SET) == 0);
+    testAssert(fread(output, 1, 26, fp) == 26);
+    testAssert(MemoryBlock::compare(output, "0123456789abcdefghijklmnop", 26));
+    testAssert(fread(output, 1, 1, fp) == 0);
+
+    testAssert(fclose(fp) == 0);
+    return OK;
+}
+
+TestCase(StdioLineBuffered)
+{
+    FILE *fp = createStream();
+
+    testAssert(fp != ZERO);
+    testAssert(setvbuf(fp, ZERO, _IOLBF, 64) == 0);
+
+    // Output is written on each newline
+    testAssert(fwrite("first ", 1, 6, fp) == 6);
+    testAssert(fileSize() == 0);
+    testAssert(fwrite("line\n", 1, 5, fp) == 5);
+    testAssert(fileSize() == 11);
+
+    // Closing the stream writes out pending output
+    testAssert(fwrite("partial", 1, 7, fp) == 7);
+    testAssert(fileSize() == 11);
+    testAssert(fclose(fp) == 0);
+    testAssert(fileSize() == 18);
+    return OK;
+}
+
+TestCase(StdioUnbuffered)
+{
+    FILE *fp = createStream();
+
+    testAssert(fp != ZERO);
+    testAssert(setvbuf(fp, ZERO, _IONBF, 0) == 0);
+    testAssert(fwrite("abc", 1, 3, fp) == 3);
+    testAssert(fileSize() == 3);
+    testAssert(fclose(fp) == 0);
+    return OK;
+}
+
+TestCase(StdioFormat)
+{
+    char buf[64];
+
+    // Numbers, including 64-bit numbers and the most negative number
+    testAssert(snprintf(buf, sizeof(buf), "%d %u %i", -12345, 4000000000U, 0) == 19);
+    testAssert(String::compare(buf, "-12345 4000000000 0") == 0);
+    testAssert(snprintf(buf, sizeof(buf), "%lld %llu", -9000000000LL, 18446744073709551615ULL) > 0);
+    testAssert(String::compare(buf, "-9000000000 18446744073709551615") == 0);
+    testAssert(snprintf(buf, sizeof(buf), "%ld %lu", (long) INT_MIN, 99UL) > 0);
+    testAssert(String::compare(buf, "-2147483647 99") == 0);
+
+    // Hexadecimal numbers have a prefix
+    testAssert(snprintf(buf, sizeof(buf), "%x %x %p", 0xabc, 0, (void *) 0x1f) > 0);
+    testAssert(String::compare(buf, "0xabc 0x0 0x1f") == 0);
+
+    // Field widths pad after the value, or with zeros before numbers
+    testAssert(snprintf(buf, sizeof(buf), "[%4u][%02u][%-4s][%3c][%%]", 7, 5, "ab", 'x') > 0);
+    testAssert(String::compare(buf, "[7   ][05][ab  ][x  ][%]") == 0);
+
+    // A field width limits the length of strings
+    testAssert(snprintf(buf, sizeof(buf), "%3s|%s", "abcdef", "") > 0);
+    testAssert(String::compare(buf, "abc|") == 0);
+    return OK;
+}
+
+TestCase(StdioFormatTruncate)
+{
+    char buf[8];
+
+    // Output is cut off and always terminated within the buffer
+    testAssert(snprintf(buf, sizeof(buf), "%s %u", "abcdef", 12345) == 7);
+    testAssert(String::compare(buf, "abcdef ") == 0);
+    testAssert(snprintf(buf, 1, "abc") == 0);
+    testAssert(buf[0] == ZERO);
+    return OK;
+}
+
+TestCase(StdioFormatStream)
+{
+    FILE *fp = createStream();
+    char buf[16], output[64];
+
+    testAssert(fp != ZERO);
+    testAssert(setvbuf(fp, buf, _IOFBF, sizeof(buf)) == 0);
+
+    // Output larger than the buffer is written out while formatting
+    testAssert(fprintf(fp, "%s-%u-%s", "0123456789", 1234567890, "abcdefghij") == 32);
+    testAssert(fileSize() == 16);
+    testAssert(fflush(fp) == 0);
+    testAssert(fileSize() == 32);
+
+    // Read back the contents
+    testAssert(lseek(fp->fd, 0, SEEK_SET) == 0);
+    testAssert(fread(output, 1, 32, fp) == 32);
+    testAssert(MemoryBlock::compare(output, "0123456789-1234567890-abcdefghij", 32));
+
+    testAssert(fclose(fp) == 0);
+    return OK;
+}
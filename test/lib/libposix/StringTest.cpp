@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <string.h>
+
+/** Size of the test buffers, spanning several words */
+#define BUFFER_SIZE 64
+
+/**
+ * Fill a buffer with a string at the given offset.
+ *
+ * The bytes around the string are non-ZERO, such that
+ * a word-at-a-time scan which misses the end is detected.
+ */
+static char * fill(char *buffer, const Size offset, const Size length)
+{
+    for (Size i = 0; i < BUFFER_SIZE; i++)
+        buffer[i] = 'x';
+
+    for (Size i = 0; i < length; i++)
+        buffer[offset + i] = 'a' + (i % 26);
+
+    buffer[offset + length] = ZERO;
+    return buffer + offset;
+}
+
+TestCase(StrlenAlignment)
+{
+    char buffer[BUFFER_SIZE];
+
+    // Every combination of alignment and length within a few words
+    for (Size offset = 0; offset < 8; offset++)
+    {
+        for (Size length = 0; length < 32; length++)
+        {
+            testAssert(strlen(fill(buffer, offset, length)) == length);
+        }
+    }
+
+    return OK;
+}
+
+TestCase(StrcmpAlignment)
+{
+    char buffer1[BUFFER_SIZE], buffer2[BUFFER_SIZE];
+
+    // Strings at the same and at different alignments
+    for (Size offset1 = 0; offset1 < 8; offset1++)
+    {
+        for (Size offset2 = 0; offset2 < 8; offset2++)
+        {
+            for (Size length = 0; length < 24; length++)
+            {
+                char *s1 = fill(buffer1, offset1, length);
+                char *s2 = fill(buffer2, offset2, length);
+
+                testAssert(strcmp(s1, s2) == 0);
+
+                if (length > 0)
+                {
+                    // Differ in the last character
+                    s2[length - 1] = 'Z';
+                    testAssert(strcmp(s1, s2) > 0);
+                    testAssert(strcmp(s2, s1) < 0);
+
+                    // One string is a prefix of the other
+                    s2[length - 1] = ZERO;
+                    testAssert(strcmp(s1, s2) > 0);
+                    testAssert(strcmp(s2, s1) < 0);
+                }
+            }
+        }
+    }
+
+    return OK;
+}
+
+TestCase(StrcmpUnsigned)
+{
+    // Characters compare as unsigned char
+    testAssert(strcmp("a\x80", "a\x7f") > 0);
+    testAssert(strcmp("a\x7f", "a\x80") < 0);
+    testAssert(strcmp("", "") == 0);
+    return OK;
+}
+
+TestCase(StrncmpCount)
+{
+    char buffer1[BUFFER_SIZE], buffer2[BUFFER_SIZE];
+
+    for (Size offset = 0; offset < 8; offset++)
+    {
+        char *s1 = fill(buffer1, offset, 20);
+        char *s2 = fill(buffer2, offset, 20);
+
+        // Only the first count characters are compared
+        s2[12] = 'Z';
+        testAssert(strncmp(s1, s2, 0) == 0);
+        testAssert(strncmp(s1, s2, 12) == 0);
+        testAssert(strncmp(s1, s2, 13) > 0);
+        testAssert(strncmp(s1, s2, 100) > 0);
+    }
+
+    testAssert(strncmp("abc", "abd", 2) == 0);
+    testAssert(strncmp("abc", "abd", 3) < 0);
+    testAssert(strncmp("ab", "abc", 5) < 0);
+    return OK;
+}
+
+TestCase(StrchrAlignment)
+{
+    char buffer[BUFFER_SIZE];
+
+    for (Size offset = 0; offset < 8; offset++)
+    {
+        for (Size length = 1; length < 24; length++)
+        {
+            char *s = fill(buffer, offset, length);
+
+            // Each character is found at its own position
+            for (Size i = 0; i < length; i++)
+                testAssert(strchr(s, 'a' + i) == s + i);
+
+            // Characters after the end are not found
+            testAssert(strchr(s, 'x') == NULL);
+            testAssert(strchr(s, 'a' + length) == NULL);
+
+            // The ZERO byte matches the end of the string
+            testAssert(strchr(s, ZERO) == s + length);
+        }
+    }
+
+    testAssert(strchr("a\x80", 0x80) != NULL);
+    return OK;
+}
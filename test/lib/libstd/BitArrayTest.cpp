@@ -267,6 +267,55 @@ TestCase(BitArraySetNextExact)
     return OK;
 }
 
+TestCase(BitArraySetNextBoundary)
+{
+    BitArray ba(128);
+    Size bit;
+
+    // Leave a free run which is not aligned and one which is
+    ba.setRange(0, 127);
+    for (Size i = 36; i < 44; i++)
+        ba.unset(i);
+    for (Size i = 64; i < 72; i++)
+        ba.unset(i);
+
+    // Only the aligned run satisfies the boundary
+    testAssert(ba.setNext(&bit, 8, 0, 16) == BitArray::Success);
+    testAssert(bit == 64);
+
+    // Without boundary the first run with enough bits is taken
+    testAssert(ba.setNext(&bit, 4, 0, 1) == BitArray::Success);
+    testAssert(bit == 36);
+    testAssert(ba.setNext(&bit, 8, 0, 1) == BitArray::OutOfMemory);
+    return OK;
+}
+
+TestCase(BitArraySetNextLarge)
+{
+    const Size bits = 100000;
+    BitArray ba(bits);
+    Size bit;
+
+    // Fill the array completely
+    for (Size i = 0; i < bits; i++)
+    {
+        testAssert(ba.setNext(&bit) == BitArray::Success);
+        testAssert(bit == i);
+    }
+    testAssert(ba.count(false) == 0);
+    testAssert(ba.setNext(&bit) == BitArray::OutOfMemory);
+
+    // A freed bit is found behind ranges of words which are completely set
+    ba.unset(bits - 3);
+    ba.unset(77777);
+    testAssert(ba.setNext(&bit) == BitArray::Success);
+    testAssert(bit == 77777);
+    testAssert(ba.setNext(&bit) == BitArray::Success);
+    testAssert(bit == bits - 3);
+    testAssert(ba.setNext(&bit) == BitArray::OutOfMemory);
+    return OK;
+}
+
 TestCase(BitArraySetNextOutOfMemory)
 {
     BitArray ba(128);
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <ByteOrder.h>
+
+TestCase(ByteOrderSwap)
+{
+    testAssert(SWAP16(0x1234) == 0x3412);
+    testAssert(SWAP32(0x12345678) == 0x78563412);
+    testAssert(SWAP64(0x0123456789abcdefULL) == 0xefcdab8967452301ULL);
+    testAssert(be16_to_cpu(cpu_to_be16(0xabcd)) == 0xabcd);
+    testAssert(be32_to_cpu(cpu_to_be32(0xabcdef01)) == 0xabcdef01);
+    return OK;
+}
+
+TestCase(ByteOrderBigEndian)
+{
+    const u8 bytes[] = { 0x12, 0x34, 0x56, 0x78 };
+    be16_t port = 0x1234;
+    be32_t address;
+
+    // Stored in network byte order
+    testAssert(sizeof(port) == sizeof(u16));
+    testAssert(MemoryBlock::compare(&port, bytes, sizeof(port)));
+    testAssert(port == 0x1234);
+
+    // Read from network byte order
+    MemoryBlock::copy(&address, bytes, sizeof(address));
+    testAssert(address == 0x12345678);
+
+    // Constants are converted at compile time
+    static_assert(be16_t(0x1234) == 0x1234, "be16_t must convert at compile time");
+    return OK;
+}
+
+TestCase(ByteOrderUnaligned)
+{
+    u8 buffer[16];
+
+    MemoryBlock::set(buffer, 0, sizeof(buffer));
+
+    // Write and read back at odd addresses
+    writeBe32(buffer + 1, 0x12345678);
+    testAssert(buffer[1] == 0x12 && buffer[2] == 0x34 && buffer[3] == 0x56 && buffer[4] == 0x78);
+    testAssert(readBe32(buffer + 1) == 0x12345678);
+    testAssert(readLe32(buffer + 1) == 0x78563412);
+
+    writeBe16(buffer + 5, 0xabcd);
+    testAssert(buffer[5] == 0xab && buffer[6] == 0xcd);
+    testAssert(readBe16(buffer + 5) == 0xabcd);
+
+    writeLe64(buffer + 7, 0x0123456789abcdefULL);
+    testAssert(buffer[7] == 0xef && buffer[14] == 0x01);
+    testAssert(readLe64(buffer + 7) == 0x0123456789abcdefULL);
+    testAssert(readBe64(buffer + 7) == 0xefcdab8967452301ULL);
+    return OK;
+}
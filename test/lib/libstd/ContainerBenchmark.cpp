@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <BenchmarkMain.h>
+#include <Benchmark.h>
+#include <HashTable.h>
+#include <List.h>
+#include <Vector.h>
+#include <BitArray.h>
+
+/** Number of items used by each container operation */
+#define ITEMS 64
+
+BenchmarkCase(HashTableInsert)
+{
+    HashTable<int, int> table;
+
+    for (Size i = 0; i < iterations; i++)
+    {
+        table.insert(i % ITEMS, i);
+
+        if (i % ITEMS == ITEMS - 1)
+            table.clear();
+    }
+    benchmarkUse(table.count());
+}
+
+BenchmarkCase(HashTableLookup)
+{
+    HashTable<int, int> table;
+    int sum = 0;
+
+    for (Size i = 0; i < ITEMS; i++)
+        table.insert(i, i);
+
+    for (Size i = 0; i < iterations; i++)
+        sum += *table.get(i % ITEMS);
+
+    benchmarkUse(sum);
+}
+
+BenchmarkCase(HashTableStringLookup)
+{
+    HashTable<String, int> table;
+    String keys[ITEMS];
+    int sum = 0;
+
+    for (Size i = 0; i < ITEMS; i++)
+    {
+        keys[i] << "key" << (int) i;
+        table.insert(keys[i], i);
+    }
+
+    for (Size i = 0; i < iterations; i++)
+        sum += *table.get(keys[i % ITEMS]);
+
+    benchmarkUse(sum);
+}
+
+BenchmarkCase(ListAppendRemove)
+{
+    List<int> list;
+
+    for (Size i = 0; i < iterations; i++)
+    {
+        list.append(i % ITEMS);
+
+        if (i % ITEMS == ITEMS - 1)
+            list.clear();
+    }
+    benchmarkUse(list.count());
+}
+
+BenchmarkCase(ListContains)
+{
+    List<int> list;
+    Size found = 0;
+
+    for (Size i = 0; i < ITEMS; i++)
+        list.append(i);
+
+    for (Size i = 0; i < iterations; i++)
+        found += list.contains(i % ITEMS);
+
+    benchmarkUse(found);
+}
+
+BenchmarkCase(VectorInsert)
+{
+    Vector<int> vector;
+
+    for (Size i = 0; i < iterations; i++)
+    {
+        vector.insert(i);
+
+        if (i % ITEMS == ITEMS - 1)
+            vector.clear();
+    }
+    benchmarkUse(vector.count());
+}
+
+BenchmarkCase(VectorAccess)
+{
+    Vector<int> vector;
+    int sum = 0;
+
+    for (Size i = 0; i < ITEMS; i++)
+        vector.insert(i);
+
+    for (Size i = 0; i < iterations; i++)
+        sum += vector.at(i % ITEMS);
+
+    benchmarkUse(sum);
+}
+
+BenchmarkCase(BitArraySetUnset)
+{
+    BitArray bits(ITEMS * 8);
+
+    for (Size i = 0; i < iterations; i++)
+    {
+        bits.set(i % (ITEMS * 8));
+        bits.unset((i + 1) % (ITEMS * 8));
+    }
+    benchmarkUse(bits.count(true));
+}
+
+BenchmarkCase(BitArraySetNext)
+{
+    BitArray bits(ITEMS * 8);
+    Size bit = 0;
+
+    for (Size i = 0; i < iterations; i++)
+    {
+        if (bits.setNext(&bit) != BitArray::Success)
+            bits.clear();
+    }
+    benchmarkUse(bit);
+}
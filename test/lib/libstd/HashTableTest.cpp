@@ -47,6 +47,16 @@ TestCase(HashTableConstructInts)
     return OK;
 }
 
+TestCase(HashTableConstructRounded)
+{
+    HashTable<int, int> h(100);
+
+    // The size is rounded up to a power of two
+    testAssert(h.size() == 128U);
+    testAssert(h.count() == 0);
+    return OK;
+}
+
 TestCase(HashTableInsert)
 {
     HashTable<String, int> h;
@@ -151,7 +161,7 @@ TestCase(HashTableAppend)
     }
     // Check administration
     testAssert(h.count() == size);
-    testAssert(h.size() == HASHTABLE_DEFAULT_SIZE);
+    testAssert(h.size() * HASHTABLE_MAXIMUM_LOAD >= h.count() * 100);
     return OK;
 }
 
@@ -192,7 +202,7 @@ TestCase(HashTableRemove)
 
     // Check administration
     testAssert(h.count() == size - 1);
-    testAssert(h.size() == HASHTABLE_DEFAULT_SIZE);
+    testAssert(h.size() * HASHTABLE_MAXIMUM_LOAD >= h.count() * 100);
     testAssert(!h.keys().contains(strings.get(0)));
     testAssert(h.get(strings.get(0)) == ZERO);
     return OK;
@@ -239,12 +249,50 @@ TestCase(HashTableRemoveMultiple)
 
     // Check administration
     testAssert(h.count() == size - 1);
-    testAssert(h.size() == HASHTABLE_DEFAULT_SIZE);
+    testAssert(h.size() * HASHTABLE_MAXIMUM_LOAD >= h.count() * 100);
     testAssert(!h.keys().contains(strings.get(0)));
     testAssert(h.get(strings.get(0)) == ZERO);
     return OK;
 }
 
+TestCase(HashTableGrow)
+{
+    HashTable<int, int> h;
+    TestInt<int> ints(INT_MIN, INT_MAX);
+    Size size = HASHTABLE_DEFAULT_SIZE * 8;
+
+    // Generate unique keys
+    ints.unique(size);
+
+    // Insert many more values than the initial table size
+    for (Size i = 0; i < size; i++)
+        testAssert(h.insert(ints.get(i), i));
+
+    // Check the table has grown
+    testAssert(h.count() == size);
+    testAssert(h.size() > HASHTABLE_DEFAULT_SIZE);
+    testAssert(h.size() * HASHTABLE_MAXIMUM_LOAD >= h.count() * 100);
+
+    // Remove every other key
+    for (Size i = 0; i < size; i += 2)
+        testAssert(h.remove(ints.get(i)) == 1);
+
+    // Check the remaining keys are still reachable
+    for (Size i = 0; i < size; i++)
+    {
+        if (i % 2)
+        {
+            testAssert(h.get(ints.get(i)) != ZERO);
+            testAssert(h.value(ints.get(i)) == (int) i);
+        }
+        else
+            testAssert(h.get(ints.get(i)) == ZERO);
+    }
+    testAssert(h.count() == size / 2);
+    testAssert(h.keys().count() == size / 2);
+    return OK;
+}
+
 TestCase(HashTableGet)
 {
     HashTable<String, int> h;
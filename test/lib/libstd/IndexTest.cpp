@@ -164,3 +164,38 @@ TestCase(IndexContains)
     testAssert(index.contains(&otherstring) == false);
     return OK;
 }
+
+TestCase(IndexReuse)
+{
+    const Size sz = 100;
+    Index<String, sz> index;
+    String mystring("test");
+    Size idx = 0;
+
+    // Fill the Index completely
+    for (Size i = 0; i < sz; i++)
+    {
+        testAssert(index.insert(idx, &mystring) == true);
+        testAssert(idx == i);
+    }
+    testAssert(index.count() == sz);
+    testAssert(index.insert(idx, &mystring) == false);
+
+    // Free positions in different words of the bitmap
+    testAssert(index.remove(70) == true);
+    testAssert(index.remove(33) == true);
+    testAssert(index.remove(99) == true);
+    testAssert(index.count() == sz - 3);
+
+    // The lowest free position is always taken first
+    testAssert(index.insert(idx, &mystring) == true);
+    testAssert(idx == 33);
+    testAssert(index.insert(idx, &mystring) == true);
+    testAssert(idx == 70);
+
+    // Filling a position directly also claims it
+    testAssert(index.insertAt(99, &mystring) == true);
+    testAssert(index.count() == sz);
+    testAssert(index.insert(idx, &mystring) == false);
+    return OK;
+}
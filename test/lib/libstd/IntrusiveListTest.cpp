@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <IntrusiveList.h>
+
+/**
+ * Object which can be linked into two lists at once.
+ */
+struct Item
+{
+    Item(int v) : value(v) {}
+
+    int value;
+    ListHook<Item> first;
+    ListHook<Item> second;
+};
+
+typedef IntrusiveList<Item, &Item::first> FirstList;
+typedef IntrusiveList<Item, &Item::second> SecondList;
+
+TestCase(IntrusiveListConstruct)
+{
+    FirstList lst;
+
+    // The list should be empty
+    testAssert(lst.count() == 0);
+    testAssert(lst.isEmpty());
+    testAssert(lst.head() == ZERO);
+    testAssert(lst.tail() == ZERO);
+    testAssert(lst.pop() == ZERO);
+    return OK;
+}
+
+TestCase(IntrusiveListAppendPrepend)
+{
+    Item a(1), b(2), c(3);
+    FirstList lst;
+
+    lst.append(&b);
+    lst.append(&c);
+    lst.prepend(&a);
+
+    // Check order and links
+    testAssert(lst.count() == 3);
+    testAssert(lst.head() == &a);
+    testAssert(lst.tail() == &c);
+    testAssert(lst.next(&a) == &b);
+    testAssert(lst.next(&b) == &c);
+    testAssert(lst.next(&c) == ZERO);
+    testAssert(lst.prev(&c) == &b);
+    testAssert(lst.prev(&a) == ZERO);
+    testAssert(lst.contains(&b));
+    testAssert(a.first.linked);
+    return OK;
+}
+
+TestCase(IntrusiveListRemove)
+{
+    Item a(1), b(2), c(3), d(4);
+    FirstList lst;
+
+    lst.append(&a);
+    lst.append(&b);
+    lst.append(&c);
+
+    // Remove from the middle
+    lst.remove(&b);
+    testAssert(lst.count() == 2);
+    testAssert(lst.next(&a) == &c);
+    testAssert(lst.prev(&c) == &a);
+    testAssert(!lst.contains(&b));
+    testAssert(!b.first.linked);
+
+    // Remove the head and tail
+    testAssert(lst.pop() == &a);
+    lst.remove(&c);
+    testAssert(lst.isEmpty());
+    testAssert(lst.head() == ZERO);
+    testAssert(lst.tail() == ZERO);
+
+    // Removed objects can be linked again
+    lst.append(&b);
+    lst.append(&d);
+    testAssert(lst.head() == &b);
+    testAssert(lst.tail() == &d);
+    testAssert(lst.count() == 2);
+    return OK;
+}
+
+TestCase(IntrusiveListTwoHooks)
+{
+    Item a(1), b(2);
+    FirstList first;
+    SecondList second;
+
+    // The same objects in a different order on each list
+    first.append(&a);
+    first.append(&b);
+    second.append(&b);
+    second.append(&a);
+
+    testAssert(first.head() == &a);
+    testAssert(second.head() == &b);
+
+    // Removing from one list keeps the other intact
+    first.remove(&a);
+    testAssert(first.head() == &b);
+    testAssert(second.count() == 2);
+    testAssert(second.tail() == &a);
+
+    // Clearing unlinks all objects
+    second.clear();
+    testAssert(second.isEmpty());
+    testAssert(!a.second.linked);
+    testAssert(!b.second.linked);
+    testAssert(first.contains(&b));
+    return OK;
+}
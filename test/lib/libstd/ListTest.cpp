@@ -517,3 +517,39 @@ TestCase(ListClear)
     testAssert(lst.isEmpty());
     return OK;
 }
+
+TestCase(ListNodePool)
+{
+    List<int>::NodePool pool(4);
+    List<int> lst(&pool);
+
+    // The first Nodes come from the pool
+    for (int i = 0; i < 4; i++)
+        lst.append(i);
+
+    testAssert(lst.head() >= pool.m_nodes);
+    testAssert(lst.tail() < pool.m_nodes + 4);
+    testAssert(pool.m_free == ZERO);
+
+    // Further Nodes are allocated on the heap
+    lst.append(4);
+    testAssert(lst.tail() < pool.m_nodes || lst.tail() >= pool.m_nodes + 4);
+    testAssert(lst.count() == 5);
+
+    // Removed Nodes return to the pool
+    List<int>::Node *head = lst.head();
+    lst.remove(head);
+    testAssert(pool.m_free == head);
+    testAssert(lst.first() == 1);
+
+    // Clearing returns the remaining pool Nodes
+    lst.clear();
+    testAssert(lst.isEmpty());
+
+    Size free = 0;
+    for (List<int>::Node *n = pool.m_free; n; n = n->next)
+        free++;
+
+    testAssert(free == 4);
+    return OK;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <Log.h>
+
+/**
+ * Log which counts writes and keeps the last one
+ */
+class DummyLog : public Log
+{
+  public:
+    DummyLog() : writes(0)
+    {
+        last[0] = 0;
+    }
+
+    virtual void write(const char *str)
+    {
+        MemoryBlock::copy(last, str, sizeof(last));
+        writes++;
+    }
+
+    Size writes;
+    char last[64];
+};
+
+TestCase(LogWritesEachLine)
+{
+    DummyLog log;
+
+    log << "first ";
+    testAssert(log.writes == 0);
+
+    log << "line\n";
+    testAssert(log.writes == 1);
+    testAssert(MemoryBlock::compare(log.last, "first line\n"));
+
+    log << "second line\n";
+    testAssert(log.writes == 2);
+    testAssert(MemoryBlock::compare(log.last, "second line\n"));
+
+    return OK;
+}
+
+TestCase(LogBatchedFlush)
+{
+    DummyLog log;
+    log.setBatched(true);
+
+    // Complete lines are kept until flushed
+    log << "first line\n" << "second ";
+    testAssert(log.writes == 0);
+
+    // Partial lines are not written by a regular flush
+    log.flush();
+    testAssert(log.writes == 0);
+
+    log << "line\n";
+    log.flush();
+    testAssert(log.writes == 1);
+    testAssert(MemoryBlock::compare(log.last, "first line\nsecond line\n"));
+
+    // Nothing left to write
+    log.flush();
+    testAssert(log.writes == 1);
+
+    return OK;
+}
+
+TestCase(LogBatchedFull)
+{
+    DummyLog log;
+    log.setBatched(true);
+
+    // Lines are written once the buffer is half full
+    for (Size i = 0; i < Log::LogBufferSize / 2 / 8; i++)
+    {
+        testAssert(log.writes == 0);
+        log << "1234567\n";
+    }
+
+    testAssert(log.writes == 1);
+    return OK;
+}
+
+TestCase(LogCompileLevel)
+{
+    DummyLog log;
+    log.setMinimumLogLevel(Log::Debug);
+
+    // Levels above the compiled level are never evaluated
+    Size evaluated = 0;
+    MAKE_LOG((Log::Level) (__LOGLEVEL__ + 1), "Test", (evaluated++, "message"));
+    testAssert(evaluated == 0);
+    testAssert(log.writes == 0);
+
+    MAKE_LOG(Log::Error, "Error", (evaluated++, "message"));
+    testAssert(evaluated == 1);
+    testAssert(log.writes == 1);
+
+    return OK;
+}
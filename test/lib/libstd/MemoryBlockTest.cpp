@@ -67,6 +67,67 @@ TestCase(CopyData)
     return OK;
 }
 
+TestCase(InitUnaligned)
+{
+    u8 array1[128];
+
+    // Fill ranges with every combination of start offset and length
+    for (Size offset = 0; offset < 8; offset++)
+    {
+        for (Size count = 0; count < sizeof(array1) - 8; count += 7)
+        {
+            MemoryBlock::set(array1, 0, sizeof(array1));
+            MemoryBlock::set(array1 + offset, 0xa5, count);
+
+            for (Size i = 0; i < sizeof(array1); i++)
+            {
+                const bool inside = i >= offset && i < offset + count;
+                testAssert(array1[i] == (inside ? 0xa5 : 0));
+            }
+        }
+    }
+
+    return OK;
+}
+
+TestCase(CopyUnaligned)
+{
+    TestInt<uint> ints(0, 0xff);
+    u8 array1[128];
+    u8 array2[128];
+
+    for (Size i = 0; i < sizeof(array1); i++)
+    {
+        array1[i] = ints.random();
+    }
+
+    // Copy with both equal and different source and destination alignment
+    for (Size srcOffset = 0; srcOffset < 8; srcOffset++)
+    {
+        for (Size dstOffset = 0; dstOffset < 8; dstOffset++)
+        {
+            const Size count = sizeof(array1) - 8 - srcOffset;
+
+            MemoryBlock::set(array2, 0, sizeof(array2));
+            testAssert(MemoryBlock::copy(array2 + dstOffset, array1 + srcOffset, count) == count);
+
+            for (Size i = 0; i < sizeof(array2); i++)
+            {
+                if (i >= dstOffset && i < dstOffset + count)
+                {
+                    testAssert(array2[i] == array1[i - dstOffset + srcOffset]);
+                }
+                else
+                {
+                    testAssert(array2[i] == 0);
+                }
+            }
+        }
+    }
+
+    return OK;
+}
+
 TestCase(CopyString)
 {
     char str[128];
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <MpmcQueue.h>
+#include <String.h>
+
+TestCase(MpmcQueueConstruct)
+{
+    MpmcQueue<int, 64> q;
+
+    // Check the queue has the correct size and count
+    testAssert(q.size() == 64);
+    testAssert(q.count() == 0);
+    testAssert(q.isEmpty());
+
+    // Each cell is ready for writing at its own position
+    for (Size i = 0; i < 64; i++)
+    {
+        testAssert(q.m_cells[i].sequence.load() == i);
+    }
+    return OK;
+}
+
+TestCase(MpmcQueuePushPop)
+{
+    MpmcQueue<int, 64> q;
+    TestInt<int> ints(INT_MIN, INT_MAX);
+    int n;
+
+    // Nothing to remove yet
+    testAssert(!q.pop(n));
+
+    // Fill the queue completely
+    for (Size i = 0; i < 64; i++)
+    {
+        testAssert(q.push(ints.random()));
+        testAssert(q.count() == i + 1);
+    }
+    testAssert(!q.push(ints.random()));
+
+    // Items come out in the same order
+    for (Size i = 0; i < 64; i++)
+    {
+        testAssert(q.pop(n));
+        testAssert(n == ints[i]);
+    }
+    testAssert(!q.pop(n));
+    testAssert(q.isEmpty());
+    return OK;
+}
+
+TestCase(MpmcQueueReuse)
+{
+    MpmcQueue<String, 4> q;
+    String str;
+
+    // Cells are reused in later rounds
+    for (Size i = 0; i < 10; i++)
+    {
+        testAssert(q.push(String("one")));
+        testAssert(q.push(String("two")));
+        testAssert(q.pop(str));
+        testAssert(str.equals("one"));
+        testAssert(q.pop(str));
+        testAssert(str.equals("two"));
+    }
+
+    // The sequence of a cell advances by the size of the queue each round
+    testAssert(q.m_cells[0].sequence.load() == 20);
+    testAssert(q.isEmpty());
+    return OK;
+}
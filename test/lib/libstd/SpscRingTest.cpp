@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <SpscRing.h>
+
+TestCase(SpscRingConstruct)
+{
+    SpscRing<int, 64> r;
+
+    // Check the ring has the correct size and count
+    testAssert(r.size() == 64);
+    testAssert(r.count() == 0);
+    testAssert(r.isEmpty());
+    return OK;
+}
+
+TestCase(SpscRingPushPop)
+{
+    SpscRing<int, 64> r;
+    TestInt<int> ints(INT_MIN, INT_MAX);
+    int n;
+
+    // Nothing to remove yet
+    testAssert(!r.pop(n));
+
+    // Fill the ring completely
+    for (Size i = 0; i < 64; i++)
+    {
+        testAssert(r.push(ints.random()));
+        testAssert(r.count() == i + 1);
+    }
+    testAssert(!r.push(ints.random()));
+
+    // Items come out in the same order
+    for (Size i = 0; i < 64; i++)
+    {
+        testAssert(r.pop(n));
+        testAssert(n == ints[i]);
+    }
+    testAssert(!r.pop(n));
+    testAssert(r.isEmpty());
+    return OK;
+}
+
+TestCase(SpscRingWrapAround)
+{
+    SpscRing<Size, 8> r;
+    Size n;
+
+    // Start just below the overflow of the indices
+    r.m_producer.index.store(~0U - 3);
+    r.m_producer.cached = ~0U - 3;
+    r.m_consumer.index.store(~0U - 3);
+    r.m_consumer.cached = ~0U - 3;
+
+    // Items pass the index overflow in order
+    for (Size i = 0; i < 100; i++)
+    {
+        testAssert(r.push(i));
+        testAssert(r.push(i + 1000));
+        testAssert(r.count() == 2);
+        testAssert(r.pop(n));
+        testAssert(n == i);
+        testAssert(r.pop(n));
+        testAssert(n == i + 1000);
+    }
+    testAssert(r.isEmpty());
+    return OK;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <BenchmarkMain.h>
+#include <Benchmark.h>
+#include <String.h>
+
+BenchmarkCase(StringConstruct)
+{
+    Size total = 0;
+
+    for (Size i = 0; i < iterations; i++)
+    {
+        String str("a string which does not fit inline in the String object", true);
+        total += str.length();
+    }
+    benchmarkUse(total);
+}
+
+BenchmarkCase(StringLength)
+{
+    const char *text = "a string which is longer than a few machine words";
+    Size total = 0;
+
+    for (Size i = 0; i < iterations; i++)
+    {
+        benchmarkUse(text);
+        total += String::length(text);
+    }
+    benchmarkUse(total);
+}
+
+BenchmarkCase(StringCompare)
+{
+    const String a("/server/filesystem/path/to/file");
+    const String b("/server/filesystem/path/to/files");
+    Size equal = 0;
+
+    for (Size i = 0; i < iterations; i++)
+        equal += a.equals(b) + (a.compareTo(b, true) < 0);
+
+    benchmarkUse(equal);
+}
+
+BenchmarkCase(StringFormatNumber)
+{
+    String str;
+
+    for (Size i = 0; i < iterations; i++)
+        str.setUnsigned(i * 2654435761U);
+
+    benchmarkUse(str.length());
+}
+
+BenchmarkCase(StringSplit)
+{
+    const String path("/usr/local/share/doc/freenos/README");
+    Size total = 0;
+
+    for (Size i = 0; i < iterations; i++)
+        total += path.split('/').count();
+
+    benchmarkUse(total);
+}
@@ -25,9 +25,10 @@ TestCase(StringConstructEmpty)
 {
     String s;
 
-    // The string should allocated, empty, default sized.
+    // The string should be empty and stored inline.
     testString(s.m_string, "");
-    testAssert(s.m_size == STRING_DEFAULT_SIZE);
+    testAssert(s.m_string == s.m_inline);
+    testAssert(s.m_size == STRING_INLINE_SIZE);
     testAssert(s.m_count == 0);
     testAssert(s.m_allocated);
     testAssert(s.m_base == Number::Dec);
@@ -41,7 +42,7 @@ TestCase(StringConstructAlloc)
     // The String should be allocated
     testString(s.m_string, "Test data");
     testAssert(s.m_allocated);
-    testAssert(s.m_size == 10);
+    testAssert(s.m_size == STRING_INLINE_SIZE);
     testAssert(s.m_count == 9);
     testAssert(s.m_base == Number::Dec);
     return OK;
@@ -69,7 +70,7 @@ TestCase(StringConstructRandom)
     testString(s.m_string, strings.get(0));
     testAssert(s.m_allocated);
     testAssert(s.m_count == String::length(strings.get(0)));
-    testAssert(s.m_size == s.m_count + 1);
+    testAssert(s.m_size == (s.m_count < STRING_INLINE_SIZE ? STRING_INLINE_SIZE : s.m_count + 1));
     testAssert(s.m_base == Number::Dec);
     return OK;
 }
@@ -83,12 +84,81 @@ TestCase(StringConstructCopy)
     testString(s2.m_string, s1.m_string);
     testString(s2.m_string, "Hello");
     testAssert(s2.m_allocated);
-    testAssert(s2.m_size == 6);
+    testAssert(s2.m_size == STRING_INLINE_SIZE);
     testAssert(s2.m_count == 5);
     testAssert(s2.m_base == Number::Dec);
     return OK;
 }
 
+TestCase(StringConstructLong)
+{
+    TestChar<char *> strings(STRING_INLINE_SIZE, STRING_INLINE_SIZE * 4);
+    String s = strings.random();
+    String s2(s);
+
+    // Values which do not fit inline are allocated on the heap.
+    testString(s2.m_string, strings.get(0));
+    testAssert(s2.m_string != s2.m_inline);
+    testAssert(s2.m_allocated);
+    testAssert(s2.m_size == s2.m_count + 1);
+    return OK;
+}
+
+TestCase(StringConstructMove)
+{
+    TestChar<char *> strings(STRING_INLINE_SIZE, STRING_INLINE_SIZE * 4);
+    String s1 = strings.random();
+    char *buffer = s1.m_string;
+    String s2(static_cast<String &&>(s1));
+
+    // The heap buffer should change owner
+    testAssert(s2.m_string == buffer);
+    testString(s2.m_string, strings.get(0));
+    testAssert(s2.m_count == strings.length(0));
+
+    // The source should be empty
+    testString(s1.m_string, "");
+    testAssert(s1.m_string == s1.m_inline);
+    testAssert(s1.m_count == 0);
+
+    // Inline values are copied
+    String s3("short", true);
+    String s4(static_cast<String &&>(s3));
+    testString(s4.m_string, "short");
+    testAssert(s4.m_string == s4.m_inline);
+    testString(s3.m_string, "");
+    return OK;
+}
+
+TestCase(StringAssignMove)
+{
+    String s1("first value", true);
+    String s2;
+
+    // Assign by moving
+    s2 = static_cast<String &&>(s1);
+    testString(s2.m_string, "first value");
+    testAssert(s2.m_count == 11);
+    testAssert(s2.m_string == s2.m_inline);
+    testString(s1.m_string, "");
+    testAssert(s1.m_count == 0);
+    return OK;
+}
+
+TestCase(StringConstructView)
+{
+    const char *path = "/usr/share/component";
+    const StringView view(path + 5, 5);
+    String s(view);
+
+    // Only the characters of the view are copied
+    testString(s.m_string, "share");
+    testAssert(s.m_count == 5);
+    testAssert(s.m_string == s.m_inline);
+    testAssert(s.m_allocated);
+    return OK;
+}
+
 TestCase(StringConstructInt)
 {
     String s = 123456;
@@ -96,7 +166,7 @@ TestCase(StringConstructInt)
     // The String should match the integer in text.
     testString(s.m_string, "123456");
     testAssert(s.m_allocated);
-    testAssert(s.m_size == STRING_DEFAULT_SIZE);
+    testAssert(s.m_size == STRING_INLINE_SIZE);
     testAssert(s.m_count == 6);
     testAssert(s.m_base == Number::Dec);
     return OK;
@@ -111,7 +181,7 @@ TestCase(StringLength)
     testAssert(s.length() == strings.length(0));
     testAssert(String::length(strings[0]) == strings.length(0));
     testAssert(s.m_count == strings.length(0));
-    testAssert(s.m_size == s.m_count + 1);
+    testAssert(s.m_size == (s.m_count < STRING_INLINE_SIZE ? STRING_INLINE_SIZE : s.m_count + 1));
     return OK;
 }
 
@@ -150,7 +220,7 @@ TestCase(StringResizeChop)
     // Check the resized String
     testString(s.m_string, "1234");
     testAssert(s.m_count == 4);
-    testAssert(s.m_size == 5);
+    testAssert(s.m_size == STRING_INLINE_SIZE);
     testAssert(s.m_allocated);
     testAssert(s.m_base == Number::Dec);
     return OK;
@@ -208,6 +278,21 @@ TestCase(StringContains)
     return OK;
 }
 
+TestCase(StringFind)
+{
+    const char *str = "testing1234 with a long tail";
+
+    // Characters are found at their first occurrence
+    testAssert(String::find(str, 't') == str);
+    testAssert(String::find(str, '1') == str + 7);
+    testAssert(String::find(str, 'l') == str + 19);
+
+    // The ZERO byte matches the end of the string
+    testAssert(String::find(str, ZERO) == str + String::length(str));
+    testAssert(String::find(str, 'z') == ZERO);
+    return OK;
+}
+
 TestCase(StringStartsWith)
 {
     String s = "testing1234";
@@ -281,6 +366,12 @@ TestCase(StringCompare)
     testAssert(s.compareTo("TeStInG1234", false) == 0);
     testAssert(s.compareTo("TeStInG1234", true) != 0);
 
+    // Check compare() on character strings
+    testAssert(String::compare("testing1234", "testing1234") == 0);
+    testAssert(String::compare("testing1234", "testing1235") < 0);
+    testAssert(String::compare("testing12345", "testing1234") > 0);
+    testAssert(String::compare("testing1234", "testing1235", 10) == 0);
+
     // Check the comparison operators != and ==
     testAssert(s == "testing1234");
     testAssert(s != "Testing1234");
@@ -337,25 +428,25 @@ TestCase(StringSub)
     // Index only
     testString(s1.m_string, "sting1234");
     testAssert(s1.m_count == 9);
-    testAssert(s1.m_size == 10);
+    testAssert(s1.m_size == STRING_INLINE_SIZE);
 
     // Index with size
     String s2 = s.substring(3, 4);
     testString(s2.m_string, "ting");
     testAssert(s2.m_count == 4);
-    testAssert(s2.m_size == 9);
+    testAssert(s2.m_size == STRING_INLINE_SIZE);
 
     // Too large index
     String s3 = s.substring(100);
     testString(s3.m_string, "");
     testAssert(s3.m_count == 0);
-    testAssert(s3.m_size == STRING_DEFAULT_SIZE);
+    testAssert(s3.m_size == STRING_INLINE_SIZE);
 
     // Too large size
     String s4 = s.substring(3, 100);
     testString(s4.m_string, "ting1234");
     testAssert(s4.m_count == 8);
-    testAssert(s4.m_size == 9);
+    testAssert(s4.m_size == STRING_INLINE_SIZE);
     return OK;
 }
 
@@ -368,7 +459,7 @@ TestCase(StringPad)
 
     testString(s.m_string, "hello\nthis      ");
     testAssert(s.m_count == 16);
-    testAssert(s.m_size == 17);
+    testAssert(s.m_size == STRING_INLINE_SIZE);
     return OK;
 }
 
@@ -394,7 +485,7 @@ TestCase(StringUpper)
 
     testString(s.m_string, "TESTING1234");
     testAssert(s.m_count == 11);
-    testAssert(s.m_size == 12);
+    testAssert(s.m_size == STRING_INLINE_SIZE);
     return OK;
 }
 
@@ -407,7 +498,7 @@ TestCase(StringLower)
 
     testString(s.m_string, "testing1234");
     testAssert(s.m_count == 11);
-    testAssert(s.m_size == 12);
+    testAssert(s.m_size == STRING_INLINE_SIZE);
     return OK;
 }
 
@@ -492,25 +583,25 @@ TestCase(StringSetSigned)
     testAssert(s.set(12345) == 5);
     testString(s.m_string, "12345");
     testAssert(s.m_count == 5);
-    testAssert(s.m_size == STRING_DEFAULT_SIZE);
+    testAssert(s.m_size == STRING_INLINE_SIZE);
 
     // Hexadecimal number
     testAssert(s.set(12345, Number::Hex) == 6);
     testString(s.m_string, "0x3039");
     testAssert(s.m_count == 6);
-    testAssert(s.m_size == STRING_DEFAULT_SIZE);
+    testAssert(s.m_size == STRING_INLINE_SIZE);
 
     // Negative decimal
     testAssert(s.set(-678910) == 7);
     testString(s.m_string, "-678910");
     testAssert(s.m_count == 7);
-    testAssert(s.m_size == STRING_DEFAULT_SIZE);
+    testAssert(s.m_size == STRING_INLINE_SIZE);
 
     // Negative hexadecimal
     testAssert(s.set(-0xabcdef, Number::Hex) == 9);
     testString(s.m_string, "-0xabcdef");
     testAssert(s.m_count == 9);
-    testAssert(s.m_size == STRING_DEFAULT_SIZE);
+    testAssert(s.m_size == STRING_INLINE_SIZE);
 
     // External buffer
     testAssert(s.setUnsigned(12345, Number::Hex, buf) == 6);
@@ -527,19 +618,19 @@ TestCase(StringSetUnsigned)
     testAssert(s.setUnsigned(4294967286U) == 10);
     testString(s.m_string, "4294967286");
     testAssert(s.m_count == 10);
-    testAssert(s.m_size == STRING_DEFAULT_SIZE);
+    testAssert(s.m_size == STRING_INLINE_SIZE);
 
     // Hexadecimal number
     testAssert(s.setUnsigned(0xffaabbcc, Number::Hex) == 10);
     testString(s.m_string, "0xffaabbcc");
     testAssert(s.m_count == 10);
-    testAssert(s.m_size == STRING_DEFAULT_SIZE);
+    testAssert(s.m_size == STRING_INLINE_SIZE);
 
     // Hexadecimal number, from large unsigned decimal
     testAssert(s.setUnsigned(2147523736U, Number::Hex) == 10);
     testString(s.m_string, "0x80009c98");
     testAssert(s.m_count == 10);
-    testAssert(s.m_size == STRING_DEFAULT_SIZE);
+    testAssert(s.m_size == STRING_INLINE_SIZE);
 
     // External buffer
     testAssert(s.setUnsigned(12345, Number::Hex, buf) == 6);
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <String.h>
+#include <StringView.h>
+
+TestCase(StringViewConstruct)
+{
+    const char *text = "hello world";
+    StringView empty;
+    StringView full(text);
+    StringView part(text + 6, 5);
+
+    // Views refer to the input without copying
+    testAssert(empty.isEmpty());
+    testAssert(empty.length() == 0);
+    testAssert(full.data() == text);
+    testAssert(full.length() == 11);
+    testAssert(part.data() == text + 6);
+    testAssert(part.length() == 5);
+    return OK;
+}
+
+TestCase(StringViewFromString)
+{
+    String s("component", true);
+    StringView view(s);
+
+    testAssert(view.data() == *s);
+    testAssert(view.length() == s.length());
+    testAssert(view == "component");
+    return OK;
+}
+
+TestCase(StringViewSubstring)
+{
+    StringView view("/usr/share/doc");
+
+    testAssert(view.substring(5, 5) == "share");
+    testAssert(view.substring(11) == "doc");
+    testAssert(view.substring(100).isEmpty());
+    testAssert(view.substring(11, 100) == "doc");
+    return OK;
+}
+
+TestCase(StringViewCompare)
+{
+    const char *text = "abcabd";
+    StringView first(text, 3);
+    StringView second(text + 3, 3);
+
+    // Only the characters inside the views are compared
+    testAssert(first == "abc");
+    testAssert(first != second);
+    testAssert(first.compareTo(second) < 0);
+    testAssert(second.compareTo(first) > 0);
+    testAssert(first.compareTo("ab") > 0);
+    testAssert(first.compareTo("abc") == 0);
+    testAssert(StringView("abcdef").startsWith(first));
+    testAssert(!first.startsWith("abcd"));
+    return OK;
+}
@@ -23,6 +23,29 @@
 #include <String.h>
 #include <Vector.h>
 
+/**
+ * Item which counts its constructions.
+ */
+class VectorItem
+{
+  public:
+
+    VectorItem() : value(0) { constructed++; }
+    VectorItem(const int v) : value(v) { constructed++; }
+    VectorItem(const VectorItem & item) : value(item.value) { copied++; }
+    VectorItem(VectorItem && item) : value(item.value) { moved++; }
+    ~VectorItem() { destructed++; }
+    void operator=(const VectorItem & item) { value = item.value; }
+    bool operator==(const VectorItem & item) const { return value == item.value; }
+    bool operator!=(const VectorItem & item) const { return value != item.value; }
+
+    int value;
+
+    static Size constructed, copied, moved, destructed;
+};
+
+Size VectorItem::constructed, VectorItem::copied, VectorItem::moved, VectorItem::destructed;
+
 TestCase(VectorConstruct)
 {
     TestInt<uint> sizes(16, 64);
@@ -280,3 +303,69 @@ TestCase(VectorCompare)
     testAssert(a1.count() != a2.count());
     return OK;
 }
+
+TestCase(VectorUninitialized)
+{
+    VectorItem::constructed = VectorItem::copied = VectorItem::moved = VectorItem::destructed = 0;
+
+    {
+        Vector<VectorItem> a(16);
+
+        // Unused storage is not constructed
+        testAssert(VectorItem::constructed == 0);
+
+        // Growing moves the items instead of copying them
+        for (int i = 0; i < 17; i++)
+            testAssert(a.insert(VectorItem(i)) == i);
+        testAssert(a.size() == 32);
+        testAssert(VectorItem::copied == 17);
+        testAssert(VectorItem::moved == 16);
+
+        // Inserting beyond the last item constructs the gap
+        testAssert(a.insert(19, VectorItem(19)));
+        testAssert(a.count() == 20);
+        testAssert(a[17].value == 0);
+        testAssert(a[18].value == 0);
+        testAssert(a[19].value == 19);
+        testAssert(a.contains(VectorItem(19)));
+        testAssert(!a.contains(VectorItem(20)));
+    }
+
+    // All constructed items are destructed
+    testAssert(VectorItem::constructed + VectorItem::copied + VectorItem::moved ==
+               VectorItem::destructed);
+    return OK;
+}
+
+TestCase(VectorReserve)
+{
+    Vector<String> a(4);
+
+    a.insert("one");
+    a.insert("two");
+    a.insert("three");
+
+    // Reserve only grows the Vector
+    testAssert(a.reserve(2));
+    testAssert(a.size() == 4);
+    testAssert(a.reserve(100));
+    testAssert(a.size() == 100);
+    testAssert(a.count() == 3);
+    testAssert(a[0].equals("one"));
+    testAssert(a[2].equals("three"));
+
+    // Shrinking keeps all items
+    testAssert(a.shrinkToFit());
+    testAssert(a.size() == 3);
+    testAssert(a.count() == 3);
+    testAssert(a[0].equals("one"));
+    testAssert(a[1].equals("two"));
+    testAssert(a[2].equals("three"));
+
+    // Removing an item moves the next ones
+    testAssert(a.removeAt(0));
+    testAssert(a.count() == 2);
+    testAssert(a[0].equals("two"));
+    testAssert(a[1].equals("three"));
+    return OK;
+}
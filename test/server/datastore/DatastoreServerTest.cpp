@@ -47,3 +47,78 @@ TestCase(DatastoreServerRegisterBuffer)
 
     return OK;
 }
+
+TestCase(DatastoreServerSharedValue)
+{
+    const char *args[] = { "launcher", ZERO };
+    ApplicationLauncher datastore(TESTROOT "/server/datastore/server", args);
+
+    // Start the DatastoreServer
+    const ApplicationLauncher::Result resultCode = datastore.exec();
+    testAssert(resultCode == ApplicationLauncher::Success);
+
+    DatastoreClient datastoreClient(datastore.getPid());
+    u32 input = 1234, output = 0;
+    Size size = sizeof(output);
+
+    // Unknown keys are not found
+    testAssert(datastoreClient.getValue("myvalue", &output, size) == Datastore::NotFound);
+
+    // Values are readable after setting them
+    testAssert(datastoreClient.setValue("myvalue", &input, sizeof(input)) == Datastore::Success);
+    testAssert(datastoreClient.getValue("myvalue", &output, size) == Datastore::Success);
+    testAssert(size == sizeof(input));
+    testAssert(output == 1234);
+
+    // Updates replace the value
+    input = 5678;
+    testAssert(datastoreClient.setValue("myvalue", &input, sizeof(input)) == Datastore::Success);
+    testAssert(datastoreClient.getValue("myvalue", &output, size) == Datastore::Success);
+    testAssert(output == 5678);
+
+    // Terminate the DatastoreServer
+    const ApplicationLauncher::Result terminateResult = datastore.terminate();
+    testAssert(terminateResult == ApplicationLauncher::Success);
+
+    return OK;
+}
+
+TestCase(DatastoreServerSegment)
+{
+    const char *args[] = { "launcher", ZERO };
+    ApplicationLauncher datastore(TESTROOT "/server/datastore/server", args);
+
+    // Start the DatastoreServer
+    const ApplicationLauncher::Result resultCode = datastore.exec();
+    testAssert(resultCode == ApplicationLauncher::Success);
+
+    DatastoreClient datastoreClient(datastore.getPid());
+    Address address = 0, attached = 0;
+    Size size = 0;
+
+    // Create a segment which other processes can read
+    testAssert(datastoreClient.createSegment("mysegment", 8192, Memory::Readable, address) == Datastore::Success);
+    testAssert(address != 0);
+
+    // Names are unique
+    testAssert(datastoreClient.createSegment("mysegment", 4096, Memory::Readable, address) == Datastore::AlreadyExists);
+
+    // Attaching returns the size of the segment
+    testAssert(datastoreClient.attachSegment("mysegment", Memory::Readable, attached, size) == Datastore::Success);
+    testAssert(attached != 0);
+    testAssert(size == 8192);
+
+    // Unknown segments are not found
+    testAssert(datastoreClient.attachSegment("other", Memory::Readable, attached, size) == Datastore::NotFound);
+
+    // Removed segments can no longer be attached
+    testAssert(datastoreClient.removeSegment("mysegment") == Datastore::Success);
+    testAssert(datastoreClient.attachSegment("mysegment", Memory::Readable, attached, size) == Datastore::NotFound);
+    testAssert(datastoreClient.removeSegment("mysegment") == Datastore::NotFound);
+
+    // Terminate the DatastoreServer
+    const ApplicationLauncher::Result terminateResult = datastore.terminate();
+    testAssert(terminateResult == ApplicationLauncher::Success);
+
+    return OK;
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include "LinnBlockCache.h"
+
+/** Block size used by the tests */
+#define BLOCK_SIZE 1024
+
+/**
+ * Storage in memory with a range of unreadable blocks.
+ */
+class MemoryStorage : public Storage
+{
+  public:
+
+    MemoryStorage()
+        : m_badBlock(~0U)
+        , m_writes(0)
+    {
+        for (Size i = 0; i < sizeof(m_data); i++)
+            m_data[i] = i & 0xff;
+    }
+
+    virtual FileSystem::Result initialize()
+    {
+        return FileSystem::Success;
+    }
+
+    virtual FileSystem::Result read(const u64 offset, void *buffer, const Size size) const
+    {
+        if (offset / BLOCK_SIZE <= m_badBlock && (offset + size - 1) / BLOCK_SIZE >= m_badBlock)
+            return FileSystem::IOError;
+
+        MemoryBlock::copy(buffer, m_data + offset, size);
+        return FileSystem::Success;
+    }
+
+    virtual FileSystem::Result write(const u64 offset, void *buffer, const Size size)
+    {
+        MemoryBlock::copy(m_data + offset, buffer, size);
+        m_writes++;
+        return FileSystem::Success;
+    }
+
+    virtual u64 capacity() const
+    {
+        return sizeof(m_data);
+    }
+
+    u32 m_badBlock;
+    Size m_writes;
+    u8 m_data[32 * BLOCK_SIZE];
+};
+
+TestCase(LinnBlockCacheWriteBack)
+{
+    MemoryStorage storage;
+    LinnBlockCache cache(&storage, BLOCK_SIZE, 8 * BLOCK_SIZE);
+    u8 data[16], out[16];
+
+    MemoryBlock::set(data, 0xaa, sizeof(data));
+
+    // Writes only modify the cache
+    testAssert(cache.write(BLOCK_SIZE + 8, data, sizeof(data)) == FileSystem::Success);
+    testAssert(cache.getDirty() == 1);
+    testAssert(storage.m_writes == 0);
+    testAssert(storage.m_data[BLOCK_SIZE + 8] == 8);
+
+    // Reads see the modified data
+    testAssert(cache.read(BLOCK_SIZE + 4, out, sizeof(out)) == FileSystem::Success);
+    testAssert(out[3] == 7 && out[4] == 0xaa && out[15] == 0xaa);
+
+    // Flush writes the whole block, including the unmodified bytes
+    testAssert(cache.flush() == FileSystem::Success);
+    testAssert(cache.getDirty() == 0);
+    testAssert(cache.getWritten() == 1);
+    testAssert(storage.m_writes == 1);
+    testAssert(storage.m_data[BLOCK_SIZE + 7] == 7);
+    testAssert(storage.m_data[BLOCK_SIZE + 8] == 0xaa);
+    testAssert(storage.m_data[BLOCK_SIZE + 23] == 0xaa);
+    testAssert(storage.m_data[BLOCK_SIZE + 24] == 24);
+
+    // Nothing left to write
+    testAssert(cache.flush() == FileSystem::Success);
+    testAssert(storage.m_writes == 1);
+    return OK;
+}
+
+TestCase(LinnBlockCacheOverwrite)
+{
+    MemoryStorage storage;
+    LinnBlockCache cache(&storage, BLOCK_SIZE, 8 * BLOCK_SIZE);
+    u8 data[BLOCK_SIZE];
+
+    MemoryBlock::set(data, 0x55, sizeof(data));
+    storage.m_badBlock = 3;
+
+    // Partial writes need to read the block first
+    testAssert(cache.write(3 * BLOCK_SIZE + 1, data, 16) == FileSystem::IOError);
+    testAssert(cache.getDirty() == 0);
+
+    // Whole blocks are written without reading them
+    testAssert(cache.write(3 * BLOCK_SIZE, data, sizeof(data)) == FileSystem::Success);
+    testAssert(cache.getDirty() == 1);
+    testAssert(cache.flush() == FileSystem::Success);
+    testAssert(storage.m_data[3 * BLOCK_SIZE] == 0x55);
+    testAssert(storage.m_data[4 * BLOCK_SIZE - 1] == 0x55);
+
+    // Outside the storage capacity
+    testAssert(cache.write(32 * BLOCK_SIZE, data, sizeof(data)) == FileSystem::IOError);
+    return OK;
+}
+
+TestCase(LinnBlockCacheDirtyLimit)
+{
+    MemoryStorage storage;
+    LinnBlockCache cache(&storage, BLOCK_SIZE, 8 * BLOCK_SIZE);
+    u8 data[BLOCK_SIZE], out[8 * BLOCK_SIZE];
+
+    MemoryBlock::set(data, 0x11, sizeof(data));
+
+    // Dirty blocks stay cached while other blocks are read
+    testAssert(cache.write(0, data, sizeof(data)) == FileSystem::Success);
+    testAssert(cache.read(8 * BLOCK_SIZE, out, sizeof(out), 8) == FileSystem::Success);
+    testAssert(cache.read(16 * BLOCK_SIZE, out, sizeof(out), 8) == FileSystem::Success);
+    testAssert(cache.getDirty() == 1);
+    testAssert(storage.m_writes == 0);
+    testAssert(cache.read(0, out, 1) == FileSystem::Success);
+    testAssert(out[0] == 0x11);
+
+    // A quarter of the cache may be dirty before it is written back
+    testAssert(cache.write(BLOCK_SIZE, data, sizeof(data)) == FileSystem::Success);
+    testAssert(cache.getDirty() == 2);
+    testAssert(cache.write(2 * BLOCK_SIZE, data, sizeof(data)) == FileSystem::Success);
+    testAssert(cache.getDirty() == 1);
+    testAssert(cache.getWritten() == 2);
+    testAssert(storage.m_data[0] == 0x11 && storage.m_data[2 * BLOCK_SIZE - 1] == 0x11);
+    testAssert(storage.m_data[2 * BLOCK_SIZE] == 0);
+
+    // The destructor writes back the remaining blocks
+    return OK;
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <IOBuffer.h>
+#include "TmpFile.h"
+
+/**
+ * Write to a TmpFile from a local buffer.
+ */
+static FileSystem::Result writeFile(TmpFile & file, const void *data, Size size, const Size offset)
+{
+    FileSystemMessage msg;
+    msg.from   = SELF;
+    msg.action = FileSystem::WriteFile;
+    msg.buffer = (char *) data;
+    msg.size   = size;
+    IOBuffer io(&msg);
+
+    return file.write(io, size, offset);
+}
+
+/**
+ * Read from a TmpFile into a local buffer.
+ */
+static FileSystem::Result readFile(TmpFile & file, void *data, Size & size, const Size offset)
+{
+    FileSystemMessage msg;
+    msg.from   = SELF;
+    msg.action = FileSystem::ReadFile;
+    msg.buffer = (char *) data;
+    msg.size   = size;
+    IOBuffer io(&msg);
+
+    return file.read(io, size, offset);
+}
+
+TestCase(TmpFileAppend)
+{
+    static u8 output[4096 * 3];
+    TmpFile file(2);
+    const char *line = "append a line to the log\n";
+    const Size length = String::length(line);
+    Size offset = 0;
+
+    // Append lines, crossing page boundaries
+    while (offset + length <= sizeof(output))
+    {
+        testAssert(writeFile(file, line, length, offset) == FileSystem::Success);
+        offset += length;
+    }
+    testAssert(file.getPageCount() == 3);
+
+    FileSystem::FileStat st;
+    testAssert(file.status(st) == FileSystem::Success);
+    testAssert(st.size == offset);
+
+    // Read all lines back at once
+    Size size = sizeof(output);
+    testAssert(readFile(file, output, size, 0) == FileSystem::Success);
+    testAssert(size == offset);
+
+    for (Size i = 0; i < offset; i += length)
+    {
+        testAssert(MemoryBlock::compare(output + i, line, length));
+    }
+
+    // Reads beyond the end return nothing
+    size = sizeof(output);
+    testAssert(readFile(file, output, size, offset) == FileSystem::Success);
+    testAssert(size == 0);
+
+    return OK;
+}
+
+TestCase(TmpFileSparse)
+{
+    static u8 output[4096 * 2];
+    const Size offset = 4096 * 100000;
+    TmpFile file(2);
+    Size size;
+
+    // Writing far beyond the end only allocates the written page
+    testAssert(writeFile(file, "end", 3, offset) == FileSystem::Success);
+    testAssert(file.getPageCount() == 1);
+
+    // Holes read as zeroes
+    MemoryBlock::set(output, 0xff, sizeof(output));
+    size = sizeof(output);
+    testAssert(readFile(file, output, size, 4096 * 50) == FileSystem::Success);
+    testAssert(size == sizeof(output));
+    for (Size i = 0; i < sizeof(output); i++)
+    {
+        testAssert(output[i] == 0);
+    }
+
+    // The start of the file is still a hole as well
+    size = 4;
+    testAssert(readFile(file, output, size, 0) == FileSystem::Success);
+    testAssert(size == 4);
+    testAssert(output[0] == 0);
+
+    size = sizeof(output);
+    testAssert(readFile(file, output, size, offset) == FileSystem::Success);
+    testAssert(size == 3);
+    testAssert(MemoryBlock::compare(output, "end", 3));
+
+    return OK;
+}
+
+TestCase(TmpFileTruncate)
+{
+    static u8 data[4096 * 3];
+    static u8 output[4096 * 3];
+    TmpFile file(2);
+    Size size;
+
+    MemoryBlock::set(data, 'x', sizeof(data));
+    testAssert(writeFile(file, data, sizeof(data), 0) == FileSystem::Success);
+    testAssert(file.getPageCount() == 3);
+
+    // Shrinking releases the pages beyond the new size
+    testAssert(file.truncate(4096 + 10) == FileSystem::Success);
+    testAssert(file.getPageCount() == 2);
+
+    size = sizeof(output);
+    testAssert(readFile(file, output, size, 0) == FileSystem::Success);
+    testAssert(size == 4096 + 10);
+
+    // Growing the file again reads zeroes beyond the old size
+    testAssert(file.truncate(sizeof(data)) == FileSystem::Success);
+    testAssert(file.getPageCount() == 2);
+
+    size = sizeof(output);
+    testAssert(readFile(file, output, size, 0) == FileSystem::Success);
+    testAssert(size == sizeof(data));
+    testAssert(output[4096 + 9] == 'x');
+    testAssert(output[4096 + 10] == 0);
+    testAssert(output[sizeof(output) - 1] == 0);
+
+    // Truncate to zero releases everything
+    testAssert(file.truncate(0) == FileSystem::Success);
+    testAssert(file.getPageCount() == 0);
+
+    return OK;
+}
@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2026 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <stdio.h>
+#include "KeyValueLog.h"
+
+/** Size of the test storage in bytes */
+#define STORAGE_SIZE (16 * 1024)
+
+/**
+ * Storage in memory which counts writes.
+ */
+class MemoryStorage : public Storage
+{
+  public:
+
+    MemoryStorage()
+        : m_writes(0)
+    {
+        MemoryBlock::set(m_data, 0, sizeof(m_data));
+    }
+
+    virtual FileSystem::Result initialize()
+    {
+        return FileSystem::Success;
+    }
+
+    virtual FileSystem::Result read(const u64 offset, void *buffer, const Size size) const
+    {
+        MemoryBlock::copy(buffer, m_data + offset, size);
+        return FileSystem::Success;
+    }
+
+    virtual FileSystem::Result write(const u64 offset, void *buffer, const Size size)
+    {
+        MemoryBlock::copy(m_data + offset, buffer, size);
+        m_writes++;
+        return FileSystem::Success;
+    }
+
+    virtual u64 capacity() const
+    {
+        return sizeof(m_data);
+    }
+
+    Size m_writes;
+    u8 m_data[STORAGE_SIZE];
+};
+
+TestCase(KeyValueLogGroupCommit)
+{
+    MemoryStorage storage;
+    KeyValueLog log(&storage);
+    char value[16];
+    Size size = sizeof(value);
+
+    testAssert(log.initialize() == KeyValue::Success);
+    testAssert(storage.m_writes == 1);
+
+    // Updates are visible before they are written
+    testAssert(log.put("one", "first", 6) == KeyValue::Success);
+    testAssert(log.put("two", "second", 7) == KeyValue::Success);
+    testAssert(log.put("one", "third", 6) == KeyValue::Success);
+    testAssert(log.isDirty());
+    testAssert(storage.m_writes == 1);
+    testAssert(log.get("one", value, size) == KeyValue::Success);
+    testAssert(size == 6);
+    testAssert(MemoryBlock::compare(value, "third", 6));
+
+    // All records are written at once
+    testAssert(log.flush() == KeyValue::Success);
+    testAssert(!log.isDirty());
+    testAssert(storage.m_writes == 2);
+    testAssert(log.count() == 2);
+
+    size = sizeof(value);
+    testAssert(log.get("two", value, size) == KeyValue::Success);
+    testAssert(MemoryBlock::compare(value, "second", 7));
+
+    // Small output buffers get the required size
+    size = 2;
+    testAssert(log.get("two", value, size) == KeyValue::InvalidArgument);
+    testAssert(size == 7);
+
+    return OK;
+}
+
+TestCase(KeyValueLogInvalid)
+{
+    MemoryStorage storage;
+    KeyValueLog log(&storage);
+    char value[KeyValue::MaximumValueSize + 1];
+    Size size = sizeof(value);
+
+    testAssert(log.initialize() == KeyValue::Success);
+    testAssert(log.put("", value, 1) == KeyValue::InvalidArgument);
+    testAssert(log.put("0123456789012345678901234567890123", value, 1) == KeyValue::InvalidArgument);
+    testAssert(log.put("key", value, sizeof(value)) == KeyValue::InvalidArgument);
+    testAssert(log.get("key", value, size) == KeyValue::NotFound);
+    testAssert(log.remove("key") == KeyValue::NotFound);
+
+    return OK;
+}
+
+TestCase(KeyValueLogReplay)
+{
+    MemoryStorage storage;
+    char value[16];
+    Size size;
+
+    {
+        KeyValueLog log(&storage);
+        testAssert(log.initialize() == KeyValue::Success);
+        testAssert(log.put("kept", "a", 2) == KeyValue::Success);
+        testAssert(log.put("gone", "b", 2) == KeyValue::Success);
+        testAssert(log.put("kept", "c", 2) == KeyValue::Success);
+        testAssert(log.remove("gone") == KeyValue::Success);
+        testAssert(log.flush() == KeyValue::Success);
+
+        // Lost on a crash: never flushed
+        testAssert(log.put("lost", "d", 2) == KeyValue::Success);
+    }
+
+    KeyValueLog log(&storage);
+    testAssert(log.initialize() == KeyValue::Success);
+    testAssert(log.count() == 1);
+
+    size = sizeof(value);
+    testAssert(log.get("kept", value, size) == KeyValue::Success);
+    testAssert(value[0] == 'c');
+    testAssert(log.get("gone", value, size) == KeyValue::NotFound);
+    testAssert(log.get("lost", value, size) == KeyValue::NotFound);
+
+    // A torn record ends the log
+    const Size used = log.getUsed();
+    testAssert(log.put("torn", "e", 2) == KeyValue::Success);
+    testAssert(log.flush() == KeyValue::Success);
+    storage.m_data[used + 20] ^= 0xff;
+
+    KeyValueLog again(&storage);
+    testAssert(again.initialize() == KeyValue::Success);
+    testAssert(again.count() == 1);
+    testAssert(again.getUsed() == used);
+    testAssert(again.get("torn", value, size) == KeyValue::NotFound);
+
+    return OK;
+}
+
+TestCase(KeyValueLogCompaction)
+{
+    MemoryStorage storage;
+    KeyValueLog log(&storage);
+    char key[KeyValue::MaximumKeySize];
+    u32 value = 0;
+    Size size;
+
+    testAssert(log.initialize() == KeyValue::Success);
+
+    // Overwrite a few keys until compaction is needed
+    for (u32 i = 0; !log.needsCompaction(); i++)
+    {
+        snprintf(key, sizeof(key), "key%u", i % 4);
+        testAssert(log.put(key, &i, sizeof(i)) == KeyValue::Success);
+    }
+    const Size used = log.getUsed();
+
+    // Updates between steps of compaction take precedence
+    testAssert(log.compact(64) == KeyValue::Success);
+    testAssert(log.isCompacting());
+    value = 1000;
+    testAssert(log.put("key3", &value, sizeof(value)) == KeyValue::Success);
+
+    while (log.isCompacting())
+        testAssert(log.compact(64) == KeyValue::Success);
+
+    testAssert(log.count() == 4);
+    testAssert(log.getUsed() < used / 4);
+    testAssert(log.getUsed() == log.getLive() + 16);
+
+    size = sizeof(value);
+    testAssert(log.get("key3", &value, size) == KeyValue::Success);
+    testAssert(value == 1000);
+
+    // The compacted segment is replayed alone
+    KeyValueLog replayed(&storage);
+    testAssert(replayed.initialize() == KeyValue::Success);
+    testAssert(!replayed.isCompacting());
+    testAssert(replayed.count() == 4);
+    testAssert(replayed.get("key3", &value, size) == KeyValue::Success);
+    testAssert(value == 1000);
+
+    return OK;
+}
+
+TestCase(KeyValueLogInterruptedCompaction)
+{
+    MemoryStorage storage;
+    char key[KeyValue::MaximumKeySize];
+    u32 value;
+    Size size = sizeof(value);
+
+    {
+        KeyValueLog log(&storage);
+        testAssert(log.initialize() == KeyValue::Success);
+
+        for (u32 i = 0; i < 40; i++)
+        {
+            snprintf(key, sizeof(key), "key%u", i % 10);
+            testAssert(log.put(key, &i, sizeof(i)) == KeyValue::Success);
+        }
+        testAssert(log.remove("key0") == KeyValue::Success);
+
+        // Crash after a part of the live records is copied
+        testAssert(log.compact(256) == KeyValue::Success);
+        testAssert(log.isCompacting());
+        testAssert(log.flush() == KeyValue::Success);
+    }
+
+    KeyValueLog log(&storage);
+    testAssert(log.initialize() == KeyValue::Success);
+    testAssert(log.isCompacting());
+    testAssert(log.count() == 9);
+
+    while (log.isCompacting())
+        testAssert(log.compact(256) == KeyValue::Success);
+
+    testAssert(log.count() == 9);
+    testAssert(log.get("key0", &value, size) == KeyValue::NotFound);
+
+    for (u32 i = 1; i < 10; i++)
+    {
+        snprintf(key, sizeof(key), "key%u", i);
+        size = sizeof(value);
+        testAssert(log.get(key, &value, size) == KeyValue::Success);
+        testAssert(value == 30 + i);
+    }
+
+    return OK;
+}
+
+TestCase(KeyValueLogFull)
+{
+    MemoryStorage storage;
+    KeyValueLog log(&storage);
+    char key[KeyValue::MaximumKeySize];
+    u8 value[KeyValue::MaximumValueSize];
+    KeyValue::Result result = KeyValue::Success;
+    Size count = 0;
+
+    MemoryBlock::set(value, 0x55, sizeof(value));
+    testAssert(log.initialize() == KeyValue::Success);
+
+    // Overwrites never run out of space
+    for (Size i = 0; i < 1000; i++)
+    {
+        testAssert(log.put("same", value, sizeof(value)) == KeyValue::Success);
+    }
+    testAssert(log.count() == 1);
+
+    // Distinct keys eventually do
+    while (result == KeyValue::Success)
+    {
+        snprintf(key, sizeof(key), "key%u", count++);
+        result = log.put(key, value, sizeof(value));
+    }
+    testAssert(result == KeyValue::NoSpace);
+    testAssert(log.count() == count);
+    testAssert(log.getLive() <= (STORAGE_SIZE / 2) - 16);
+
+    return OK;
+}
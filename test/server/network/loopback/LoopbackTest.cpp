@@ -25,6 +25,7 @@
 #include <ApplicationLauncher.h>
 #include <NetworkServer.h>
 #include <Loopback.h>
+#include <TCPSocket.h>
 
 class DummyChannel : public Channel
 {
@@ -148,6 +149,20 @@ TestCase(LoopbackUdpPing)
     server.pathHandler(&msg);
     testAssert(msg.result == FileSystem::Success);
 
+    // Enlarge the receive queue of the first socket
+    UDPSocket *sock0 = loop->m_udp->m_sockets[0];
+    info->address = 128;
+    info->port = 0;
+    info->action = NetworkClient::SetQueueSize;
+    server.pathHandler(&msg);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(sock0->m_queue.getSize() == 128);
+
+    // Queue sizes beyond the maximum are rejected
+    info->address = NetworkQueue::MaximumPackets + 1;
+    server.pathHandler(&msg);
+    testAssert(sock0->m_queue.getSize() == 128);
+
     // Create a second UDP socket
     msg.from = server.m_pid;
     msg.action = FileSystem::ReadFile;
@@ -205,11 +220,11 @@ TestCase(LoopbackUdpPing)
     info->action = NetworkClient::SendSingle;
     MemoryBlock::copy(info + 1, payload, String::length(payload));
 
-    // Process the message two times: first for ARP lookup, second for actual packet
+    // The packet is delivered right away, without an ARP lookup
     server.pathHandler(&msg);
     testAssert(msg.result == FileSystem::Success);
-    server.retryRequests();
-    testAssert(msg.result == FileSystem::Success);
+    testAssert(sock0->m_queue.hasData());
+    testAssert(loop->m_arp->m_cache.count() == 0);
 
     // Receive the packet
     MemoryBlock::set(buf, 0, sizeof(buf));
@@ -227,6 +242,202 @@ TestCase(LoopbackUdpPing)
     testAssert(info->port == 54321);
     testAssert(MemoryBlock::compare(info + 1, payload, String::length(payload)));
 
+    // The socket queue counted the packet
+    const NetworkQueue::Statistics & stats = sock0->m_queue.getStatistics();
+    testAssert(stats.packets == 1);
+    testAssert(stats.drops == 0);
+    testAssert(stats.highWater == 1);
+
+    // Send a batch of datagrams, each with its own buffer
+    static char payloads[2][16] = { "first datagram", "second one" };
+    NetworkClient::BatchPacket *batch = (NetworkClient::BatchPacket *) (info + 1);
+    msg.action = FileSystem::WriteFile;
+    msg.inode = udp1;
+    msg.buffer = buf;
+    msg.size = sizeof(*info) + (2 * sizeof(*batch));
+    info->address = IPV4::toAddress("127.0.0.1");
+    info->port = 12345;
+    info->action = NetworkClient::SendBatch;
+
+    for (Size i = 0; i < 2; i++)
+    {
+        batch[i].buffer = (Address) payloads[i];
+        batch[i].size = String::length(payloads[i]);
+        batch[i].address = 0;
+        batch[i].port = 0;
+    }
+    server.pathHandler(&msg);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(sock0->m_queue.hasData());
+
+    // Receive both datagrams with a single request
+    static char received[2][16];
+    MemoryBlock::set(received, 0, sizeof(received));
+    msg.inode = udp0;
+    info->action = NetworkClient::ReceiveBatch;
+
+    for (Size i = 0; i < 2; i++)
+    {
+        batch[i].buffer = (Address) received[i];
+        batch[i].size = sizeof(received[i]);
+    }
+    server.pathHandler(&msg);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(!sock0->m_queue.hasData());
+
+    for (Size i = 0; i < 2; i++)
+    {
+        testAssert(batch[i].size == String::length(payloads[i]));
+        testAssert(batch[i].address == IPV4::toAddress("127.0.0.1"));
+        testAssert(batch[i].port == 54321);
+        testAssert(MemoryBlock::compare(received[i], payloads[i], sizeof(payloads[i])));
+    }
+
+    return OK;
+}
+
+TestCase(LoopbackTcpStream)
+{
+    const char *mountPath = "/networktest/loopback";
+    NetworkServer server(mountPath);
+    Loopback *loop = new Loopback(server.getNextInode(), server);
+
+    // Register dummy channels
+    server.m_registry.registerProducer(server.m_pid, new DummyChannel(Channel::Producer, sizeof(FileSystemMessage)));
+    server.m_registry.registerConsumer(server.m_pid, new DummyChannel(Channel::Consumer, sizeof(FileSystemMessage)));
+
+#ifdef __HOST__
+    server.m_registry.registerProducer(ROOTFS_PID, new DummyChannel(Channel::Producer, sizeof(FileSystemMessage)));
+    server.m_registry.registerConsumer(ROOTFS_PID, new DummyChannel(Channel::Consumer, sizeof(FileSystemMessage)));
+#endif /* __HOST__ */
+
+    // Initialize the server
+    server.registerNetworkDevice(loop);
+    server.m_mountPath = ZERO;
+    testAssert(server.initialize() == FileSystem::Success);
+    server.m_mountPath = mountPath;
+
+    // Stat the TCP socket factory
+    FileSystem::FileStat st;
+    FileSystemMessage msg;
+    MemoryBlock::set(&msg, 0, sizeof(msg));
+    MemoryBlock::set(&st, 0, sizeof(st));
+    msg.from = server.m_pid;
+    msg.action = FileSystem::StatFile;
+    msg.buffer = (char *) "/networktest/loopback/tcp/factory";
+    msg.stat = &st;
+    msg.size = sizeof(st);
+    server.pathHandler(&msg);
+    const u32 factoryInode = st.inode;
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(factoryInode != 0);
+
+    // Create two TCP sockets
+    static char buf[65536 + sizeof(NetworkClient::SocketInfo)];
+    u32 inodes[2];
+
+    for (Size i = 0; i < 2; i++)
+    {
+        msg.action = FileSystem::ReadFile;
+        msg.buffer = buf;
+        msg.inode = factoryInode;
+        msg.size = 128;
+        msg.offset = 0;
+        server.pathHandler(&msg);
+        testAssert(msg.result == FileSystem::Success);
+
+        MemoryBlock::set(&st, 0, sizeof(st));
+        msg.action = FileSystem::StatFile;
+        msg.stat = &st;
+        msg.size = sizeof(st);
+        server.pathHandler(&msg);
+        testAssert(msg.result == FileSystem::Success);
+        inodes[i] = st.inode;
+    }
+    testAssert(loop->m_tcp->m_sockets.count() == 2);
+    TCPSocket *server0 = loop->m_tcp->m_sockets[0];
+    TCPSocket *client1 = loop->m_tcp->m_sockets[1];
+
+    // Listen on the first socket
+    NetworkClient::SocketInfo *info = (NetworkClient::SocketInfo *) &buf;
+    msg.action = FileSystem::WriteFile;
+    msg.buffer = buf;
+    msg.size = sizeof(NetworkClient::SocketInfo);
+    msg.inode = inodes[0];
+    info->address = IPV4::toAddress("127.0.0.1");
+    info->port = 8080;
+    info->action = NetworkClient::Listen;
+    server.pathHandler(&msg);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(server0->getState() == TCPSocket::Listen);
+
+    // Connect the second socket. The handshake completes directly on loopback.
+    msg.inode = inodes[1];
+    msg.size = sizeof(NetworkClient::SocketInfo);
+    info->port = 8080;
+    info->action = NetworkClient::Connect;
+    server.pathHandler(&msg);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(client1->getState() == TCPSocket::Established);
+    testAssert(server0->getState() == TCPSocket::Established);
+    testAssert(client1->getPort() >= 49152);
+
+    // Segments from other peers do not belong to the connection
+    testAssert(server0->accepts(IPV4::toAddress("127.0.0.1"), client1->getPort()));
+    testAssert(!server0->accepts(IPV4::toAddress("127.0.0.1"), client1->getPort() + 1));
+
+    // Send a stream of data which needs many segments
+    u8 *payload = (u8 *) (info + 1);
+    for (Size i = 0; i < 65536; i++)
+    {
+        payload[i] = i * 7;
+    }
+    info->address = 1;
+    info->action = NetworkClient::SetNoDelay;
+    server.pathHandler(&msg);
+    testAssert(msg.result == FileSystem::Success);
+
+    msg.size = sizeof(buf);
+    info->action = NetworkClient::SendSingle;
+    server.pathHandler(&msg);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(client1->m_sendCount == 0);
+    testAssert(server0->m_receiveCount == 65536);
+
+    // Receive all data in order
+    static u8 received[65536];
+    msg.action = FileSystem::ReadFile;
+    msg.inode = inodes[0];
+    msg.buffer = (char *) received;
+    msg.size = sizeof(received);
+    msg.offset = 0;
+    server.pathHandler(&msg);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(server0->m_receiveCount == 0);
+    testAssert(MemoryBlock::compare(received, payload, sizeof(received)));
+
+    // Close both directions
+    msg.action = FileSystem::WriteFile;
+    msg.buffer = buf;
+    msg.size = sizeof(NetworkClient::SocketInfo);
+    msg.inode = inodes[1];
+    info->action = NetworkClient::Shutdown;
+    server.pathHandler(&msg);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(client1->getState() == TCPSocket::FinWait2);
+    testAssert(server0->getState() == TCPSocket::CloseWait);
+
+    // The end of stream makes the socket readable
+    testAssert(server0->canRead());
+    testAssert(server0->m_peerFinished);
+
+    msg.inode = inodes[0];
+    info->action = NetworkClient::Shutdown;
+    server.pathHandler(&msg);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(server0->getState() == TCPSocket::Closed);
+    testAssert(client1->getState() == TCPSocket::TimeWait);
+
     return OK;
 }
 